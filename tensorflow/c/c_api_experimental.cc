@@ -315,6 +315,116 @@ void TF_EnqueueNamedTensor(TF_Session* session, int tensor_id,
   VLOG(1) << "Enqueuing is done.";
 }
 
+struct TF_SessionCallable {
+  tensorflow::Session::CallableHandle handle;
+  int ninputs;
+  int noutputs;
+};
+
+TF_SessionCallable* TF_SessionMakeCallable(
+    TF_Session* session, const TF_Output* inputs, int ninputs,
+    const TF_Output* outputs, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets, TF_Status* status) {
+  if (session->extend_before_run &&
+      !tensorflow::ExtendSessionGraphHelper(session, status)) {
+    return nullptr;
+  }
+
+  tensorflow::CallableOptions callable_options;
+  for (int i = 0; i < ninputs; ++i) {
+    callable_options.add_feed(tensorflow::strings::StrCat(
+        inputs[i].oper->node.name(), ":", inputs[i].index));
+  }
+  for (int i = 0; i < noutputs; ++i) {
+    callable_options.add_fetch(tensorflow::strings::StrCat(
+        outputs[i].oper->node.name(), ":", outputs[i].index));
+  }
+  for (int i = 0; i < ntargets; ++i) {
+    callable_options.add_target(target_opers[i]->node.name());
+  }
+
+  tensorflow::Session::CallableHandle handle;
+  status->status = session->session->MakeCallable(callable_options, &handle);
+  if (!status->status.ok()) return nullptr;
+  return new TF_SessionCallable{handle, ninputs, noutputs};
+}
+
+namespace {
+
+// Writes `src` into the buffer of the caller-provided tensor `dst`.
+Status CopyToPreallocatedOutput(const tensorflow::Tensor& src, TF_Tensor* dst) {
+  if (!src.IsInitialized()) {
+    return tensorflow::errors::FailedPrecondition(
+        "attempt to use a tensor with an uninitialized value");
+  }
+  if (src.dtype() == tensorflow::DT_STRING ||
+      src.dtype() == tensorflow::DT_RESOURCE ||
+      src.dtype() == tensorflow::DT_VARIANT) {
+    return InvalidArgument("Preallocated outputs of type ",
+                           tensorflow::DataTypeString(src.dtype()),
+                           " are not supported");
+  }
+  if (static_cast<tensorflow::DataType>(TF_TensorType(dst)) != src.dtype()) {
+    return InvalidArgument(
+        "Preallocated output has type ",
+        tensorflow::DataTypeString(
+            static_cast<tensorflow::DataType>(TF_TensorType(dst))),
+        " but the fetched tensor has type ",
+        tensorflow::DataTypeString(src.dtype()));
+  }
+  bool same_shape = TF_NumDims(dst) == src.dims();
+  for (int i = 0; same_shape && i < src.dims(); ++i) {
+    same_shape = TF_Dim(dst, i) == src.dim_size(i);
+  }
+  if (!same_shape) {
+    return InvalidArgument(
+        "Preallocated output does not have the shape of the fetched tensor ",
+        src.shape().DebugString());
+  }
+  const tensorflow::StringPiece data = src.tensor_data();
+  // The fetched tensor may be the preallocated one when an input is fetched.
+  if (data.data() != TF_TensorData(dst)) {
+    std::memcpy(TF_TensorData(dst), data.data(), data.size());
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+void TF_SessionRunCallable(TF_Session* session, TF_SessionCallable* callable,
+                           TF_Tensor* const* input_values,
+                           TF_Tensor** output_values, TF_Status* status) {
+  // Feeds share the buffers of `input_values`.
+  std::vector<tensorflow::Tensor> feeds(callable->ninputs);
+  for (int i = 0; i < callable->ninputs; ++i) {
+    status->status = tensorflow::TF_TensorToTensor(input_values[i], &feeds[i]);
+    if (!status->status.ok()) return;
+  }
+
+  std::vector<tensorflow::Tensor> fetches;
+  fetches.reserve(callable->noutputs);
+  status->status = session->session->RunCallable(callable->handle, feeds,
+                                                 &fetches, nullptr);
+  if (!status->status.ok()) return;
+
+  for (int i = 0; i < callable->noutputs; ++i) {
+    if (output_values[i] == nullptr) {
+      output_values[i] =
+          tensorflow::TF_TensorFromTensor(fetches[i], &status->status);
+    } else {
+      status->status = CopyToPreallocatedOutput(fetches[i], output_values[i]);
+    }
+    if (!status->status.ok()) return;
+  }
+}
+
+void TF_SessionReleaseCallable(TF_Session* session,
+                               TF_SessionCallable* callable,
+                               TF_Status* status) {
+  status->status = session->session->ReleaseCallable(callable->handle);
+  delete callable;
+}
+
 TF_Buffer* TFE_GetServerDef(const char* text_proto, TF_Status* status) {
   tensorflow::ServerDef server_def;
   if (!tensorflow::protobuf::TextFormat::ParseFromString(text_proto,
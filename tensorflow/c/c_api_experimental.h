@@ -143,6 +143,40 @@ TF_CAPI_EXPORT extern void TF_EnqueueNamedTensor(TF_Session* session,
                                                  int tensor_id,
                                                  TF_Tensor* tensor,
                                                  TF_Status* status);
+// A subgraph of a session with fixed feeds, fetches and targets, created with
+// TF_SessionMakeCallable(). Running it skips the per-call name handling and
+// subgraph lookup of TF_SessionRun().
+typedef struct TF_SessionCallable TF_SessionCallable;
+
+// Prepares `session` to repeatedly feed `inputs`, fetch `outputs` and run
+// `target_opers`. Returns nullptr and sets `status` on failure. The callable
+// must be released with TF_SessionReleaseCallable() before `session` is
+// deleted.
+TF_CAPI_EXPORT extern TF_SessionCallable* TF_SessionMakeCallable(
+    TF_Session* session, const TF_Output* inputs, int ninputs,
+    const TF_Output* outputs, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets, TF_Status* status);
+
+// Runs `callable` with one tensor per input in `input_values`, which are not
+// copied and remain owned by the caller.
+//
+// For each output, if `output_values[i]` is nullptr, a new tensor is returned
+// in it and the caller takes ownership of it, like TF_SessionRun(). Otherwise
+// `output_values[i]` is a caller-owned tensor whose type and shape must match
+// the fetched tensor, and the result is written into its buffer; this lets the
+// caller reuse output buffers across runs. Preallocated outputs are not
+// supported for TF_STRING, TF_RESOURCE and TF_VARIANT tensors.
+//
+// May be called concurrently for the same callable.
+TF_CAPI_EXPORT extern void TF_SessionRunCallable(
+    TF_Session* session, TF_SessionCallable* callable,
+    TF_Tensor* const* input_values, TF_Tensor** output_values,
+    TF_Status* status);
+
+// Releases the resources held by `callable` and deletes it.
+TF_CAPI_EXPORT extern void TF_SessionReleaseCallable(
+    TF_Session* session, TF_SessionCallable* callable, TF_Status* status);
+
 // Create a serialized tensorflow.ServerDef proto.
 TF_Buffer* TFE_GetServerDef(const char* text_proto, TF_Status* status);
 
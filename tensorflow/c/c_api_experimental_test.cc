@@ -85,6 +85,61 @@ TEST(CAPI_EXPERIMENTAL, IsStateful) {
   EXPECT_EQ(id, 0);
 }
 
+TEST(CAPI_EXPERIMENTAL, SessionCallable) {
+  TF_Status* s = TF_NewStatus();
+  TF_Graph* graph = TF_NewGraph();
+  TF_Operation* feed = Placeholder(graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* two = ScalarConst(2, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* add = Add(feed, two, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_SessionOptions* opts = TF_NewSessionOptions();
+  TF_Session* session = TF_NewSession(graph, opts, s);
+  TF_DeleteSessionOptions(opts);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_Output input{feed, 0};
+  TF_Output output{add, 0};
+  TF_SessionCallable* callable = TF_SessionMakeCallable(
+      session, &input, 1, &output, 1, nullptr, 0, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  // A new output tensor is returned.
+  TF_Tensor* input_value = Int32Tensor(3);
+  TF_Tensor* output_value = nullptr;
+  TF_SessionRunCallable(session, callable, &input_value, &output_value, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  ASSERT_NE(output_value, nullptr);
+  EXPECT_EQ(5, *static_cast<int32_t*>(TF_TensorData(output_value)));
+
+  // The result is written into the preallocated output tensor.
+  TF_Tensor* preallocated = Int32Tensor(0);
+  void* preallocated_data = TF_TensorData(preallocated);
+  *static_cast<int32_t*>(TF_TensorData(input_value)) = 40;
+  TF_SessionRunCallable(session, callable, &input_value, &preallocated, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  EXPECT_EQ(preallocated_data, TF_TensorData(preallocated));
+  EXPECT_EQ(42, *static_cast<int32_t*>(preallocated_data));
+
+  // Preallocated outputs must have the fetched shape.
+  TF_Tensor* wrong_shape = Int32Tensor(std::vector<int32_t>{1, 2});
+  TF_SessionRunCallable(session, callable, &input_value, &wrong_shape, s);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(s)) << TF_Message(s);
+
+  TF_SessionReleaseCallable(session, callable, s);
+  EXPECT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_DeleteTensor(wrong_shape);
+  TF_DeleteTensor(preallocated);
+  TF_DeleteTensor(output_value);
+  TF_DeleteTensor(input_value);
+  TF_DeleteSession(session, s);
+  TF_DeleteGraph(graph);
+  TF_DeleteStatus(s);
+}
+
 class ShapeInferenceTest : public ::testing::Test {
  protected:
   ShapeInferenceTest()
@@ -21,9 +21,11 @@ limitations under the License.
 #include "tensorflow/c/eager/tfe_tensorhandle_internal.h"
 #include "tensorflow/c/tf_status_internal.h"
 #include "tensorflow/core/common_runtime/eager/tensor_handle.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_reference.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mem.h"
 
 namespace tensorflow {
 
@@ -225,17 +227,27 @@ void DeallocatorWrapperFunc(void* data, size_t len, void* dlmt_vptr) {
   TFE_CallDLManagedTensorDeleter(dlmt_vptr);
 }
 
+// Frees a buffer allocated with port::AlignedMalloc, for
+// TFE_NewTensorHandleFromDeviceMemory.
+void AlignedFreeFunc(void* data, size_t len, void* arg) {
+  tensorflow::port::AlignedFree(data);
+}
+
 // Checks whether the stride array matches the layout of compact, row-majored
-// data.
+// data. As in other frameworks, the strides of dimensions of size 1 are
+// ignored since they do not affect the layout, and so are all strides of
+// tensors with no elements.
 bool IsValidStrideCompactRowMajorData(int64_t* shape_arr, int64_t* stride_arr,
                                       int ndim) {
-  if (ndim >= 1 && stride_arr[ndim - 1] != 1) {
-    return false;
+  for (int i = 0; i < ndim; ++i) {
+    if (shape_arr[i] == 0) return true;
   }
-  for (int i = ndim - 2; i >= 0; --i) {
-    if (stride_arr[i] != shape_arr[i + 1] * stride_arr[i + 1]) {
+  int64_t expected_stride = 1;
+  for (int i = ndim - 1; i >= 0; --i) {
+    if (shape_arr[i] != 1 && stride_arr[i] != expected_stride) {
       return false;
     }
+    expected_stride *= shape_arr[i];
   }
   return true;
 }
@@ -260,6 +272,9 @@ void* TFE_HandleToDLPack(TFE_TensorHandle* h, TF_Status* status) {
   }
 
   const Tensor* tensor = GetTensorFromHandle(h, status);
+  if (!status->status.ok()) {
+    return nullptr;
+  }
   TF_DataType data_type = static_cast<TF_DataType>(tensor->dtype());
 
   auto tf_dlm_type = GetDlDataType(data_type, status);
@@ -323,7 +338,7 @@ TFE_TensorHandle* TFE_HandleFromDLPack(void* dlm, TF_Status* status,
   }
   int num_dims = dl_tensor->ndim;
   const int64_t* dims = dl_tensor->shape;
-  void* data = dl_tensor->data;
+  void* data = static_cast<char*>(dl_tensor->data) + dl_tensor->byte_offset;
 
   size_t total_bytes = dl_tensor->dtype.bits / 8;
   for (int i = 0; i < num_dims; i++) {
@@ -338,6 +353,27 @@ TFE_TensorHandle* TFE_HandleFromDLPack(void* dlm, TF_Status* status,
     return nullptr;
   }
 
+  // TF CPU kernels map tensors with aligned Eigen maps, so a CPU buffer that
+  // is not aligned (e.g. a slice exported with a byte_offset) is copied into
+  // one that is. All other buffers are shared without a copy, and released
+  // through the DLPack deleter once the tensor is destroyed.
+  if (dl_tensor->ctx.device_type == DLDeviceType::kDLCPU &&
+      reinterpret_cast<uintptr_t>(data) % Allocator::kAllocatorAlignment !=
+          0) {
+    void* aligned_data = tensorflow::port::AlignedMalloc(
+        std::max<size_t>(total_bytes, 1), Allocator::kAllocatorAlignment);
+    if (aligned_data == nullptr) {
+      status->status = tensorflow::errors::ResourceExhausted(
+          "Failed to allocate ", total_bytes, " bytes for DLPack tensor");
+      return nullptr;
+    }
+    memcpy(aligned_data, data, total_bytes);
+    TFE_CallDLManagedTensorDeleter(dlmt);
+    return TFE_NewTensorHandleFromDeviceMemory(
+        ctx, device_name.value().c_str(), dtype, dims, num_dims, aligned_data,
+        total_bytes, &AlignedFreeFunc, nullptr, status);
+  }
+
   TFE_TensorHandle* handle = TFE_NewTensorHandleFromDeviceMemory(
       ctx, device_name.value().c_str(), dtype, dims, num_dims, data,
       total_bytes, &DeallocatorWrapperFunc, dlmt, status);
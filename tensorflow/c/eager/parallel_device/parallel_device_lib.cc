@@ -80,6 +80,10 @@ class DeviceThread {
   void StartExecute(TFE_Context* context, const char* operation_name,
                     std::vector<TFE_TensorHandle*> inputs,
                     const TFE_OpAttrs* attributes, int expected_max_outputs);
+  // Requests that the worker thread copy `tensor` to the thread's device. Like
+  // `StartExecute`, blocks until the previously pending operation has finished
+  // and must be followed by `Join`, which returns the copy.
+  void StartCopyToDevice(TFE_Context* context, TFE_TensorHandle* tensor);
   // Block until the previous `StartExecute` operation has executed. Forwards
   // the status from `TFE_Execute` and returns outputs if the status is OK.
   std::vector<TensorHandlePtr> Join(TF_Status* status);
@@ -93,6 +97,15 @@ class DeviceThread {
                std::vector<TensorHandlePtr>* outputs, TF_Status* status) const
       TF_EXCLUSIVE_LOCKS_REQUIRED(execution_mutex_);
 
+  void CopyToDevice(TFE_Context* context, TFE_TensorHandle* tensor,
+                    std::vector<TensorHandlePtr>* outputs,
+                    TF_Status* status) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(execution_mutex_);
+
+  // Waits until `Join` has consumed the result of the previous operation.
+  void WaitUntilIdle(tensorflow::mutex_lock* l)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(execution_mutex_);
+
   enum class ExecutionState {
     kReadyToExecute,
     kHasResult,
@@ -117,6 +130,9 @@ class DeviceThread {
   std::vector<TFE_TensorHandle*> op_inputs_ TF_GUARDED_BY(execution_mutex_);
   const TFE_OpAttrs* attributes_ TF_GUARDED_BY(execution_mutex_);
   int expected_max_outputs_ TF_GUARDED_BY(execution_mutex_);
+  // If not null, the pending operation copies this tensor instead of executing
+  // `operation_name_`.
+  TFE_TensorHandle* copy_source_ TF_GUARDED_BY(execution_mutex_) = nullptr;
   //   Outputs
   std::vector<TensorHandlePtr> op_outputs_ TF_GUARDED_BY(execution_mutex_);
   // TF_Status is an incomplete type and so can't be stack allocated. To avoid
@@ -151,8 +167,13 @@ void DeviceThread::Run() {
       } else if (execution_state_ == ExecutionState::kReadyToExecute) {
         // op_outputs_ may have been std::moved
         op_outputs_ = std::vector<TensorHandlePtr>();
-        Execute(context_, operation_name_, std::move(op_inputs_), attributes_,
-                expected_max_outputs_, &op_outputs_, status_.get());
+        if (copy_source_ != nullptr) {
+          CopyToDevice(context_, copy_source_, &op_outputs_, status_.get());
+        } else {
+          Execute(context_, operation_name_, std::move(op_inputs_),
+                  attributes_, expected_max_outputs_, &op_outputs_,
+                  status_.get());
+        }
         execution_state_ = ExecutionState::kHasResult;
       }
     }
@@ -167,21 +188,38 @@ void DeviceThread::StartExecute(TFE_Context* context,
                                 int expected_max_outputs) {
   {
     tensorflow::mutex_lock l(execution_mutex_);
-    while (execution_state_ != ExecutionState::kIdle) {
-      // If there's already a pending execution, wait until Join finishes before
-      // starting on the next operation.
-      finished_join_.wait(l);
-    }
+    WaitUntilIdle(&l);
     context_ = context;
     operation_name_ = operation_name;
-    op_inputs_ = inputs;
+    op_inputs_ = std::move(inputs);
     attributes_ = attributes;
     expected_max_outputs_ = expected_max_outputs;
+    copy_source_ = nullptr;
     execution_state_ = ExecutionState::kReadyToExecute;
   }
   start_execute_.notify_one();
 }
 
+void DeviceThread::StartCopyToDevice(TFE_Context* context,
+                                     TFE_TensorHandle* tensor) {
+  {
+    tensorflow::mutex_lock l(execution_mutex_);
+    WaitUntilIdle(&l);
+    context_ = context;
+    copy_source_ = tensor;
+    execution_state_ = ExecutionState::kReadyToExecute;
+  }
+  start_execute_.notify_one();
+}
+
+void DeviceThread::WaitUntilIdle(tensorflow::mutex_lock* l) {
+  while (execution_state_ != ExecutionState::kIdle) {
+    // If there's already a pending execution, wait until Join finishes before
+    // starting on the next operation.
+    finished_join_.wait(*l);
+  }
+}
+
 std::vector<TensorHandlePtr> DeviceThread::Join(TF_Status* status) {
   std::vector<TensorHandlePtr> result;
   {
@@ -236,6 +274,16 @@ void DeviceThread::Execute(TFE_Context* context, const char* operation_name,
   }
 }
 
+void DeviceThread::CopyToDevice(TFE_Context* context, TFE_TensorHandle* tensor,
+                                std::vector<TensorHandlePtr>* outputs,
+                                TF_Status* status) const {
+  TFE_ContextSetExecutorForThread(context, executor_.get());
+  TFE_TensorHandle* copy =
+      TFE_TensorHandleCopyToDevice(tensor, context, device_.c_str(), status);
+  if (TF_GetCode(status) != TF_OK) return;
+  outputs->emplace_back(copy);
+}
+
 ParallelDevice::ParallelDevice(const std::vector<std::string>& devices,
                                const bool is_async)
     : underlying_devices_(devices) {
@@ -251,13 +299,36 @@ ParallelDevice::~ParallelDevice() = default;
 
 std::unique_ptr<ParallelTensor> ParallelDevice::CopyToParallelDevice(
     TFE_Context* context, TFE_TensorHandle* tensor, TF_Status* status) const {
+  // Copies to all devices are issued concurrently, rather than waiting for
+  // each one before starting the next.
+  for (int device_index = 0; device_index < underlying_devices_.size();
+       ++device_index) {
+    device_threads_[device_index]->StartCopyToDevice(context, tensor);
+  }
   std::vector<TensorHandlePtr> components;
   components.reserve(underlying_devices_.size());
-  for (const std::string& underlying_device_name : underlying_devices_) {
-    TFE_TensorHandle* t = TFE_TensorHandleCopyToDevice(
-        tensor, context, underlying_device_name.c_str(), status);
-    if (TF_GetCode(status) != TF_OK) return nullptr;
-    components.emplace_back(t);
+  StatusPtr first_bad_status(nullptr);
+  for (int device_index = 0; device_index < underlying_devices_.size();
+       ++device_index) {
+    // Every Join runs even after a bad status, so that the threads are ready
+    // for the next operation.
+    std::vector<TensorHandlePtr> copy =
+        device_threads_[device_index]->Join(status);
+    if (TF_GetCode(status) != TF_OK) {
+      if (first_bad_status == nullptr) {
+        first_bad_status.reset(TF_NewStatus());
+        TF_SetStatus(first_bad_status.get(), TF_GetCode(status),
+                     TF_Message(status));
+      }
+      TF_SetStatus(status, TF_OK, "");
+      continue;
+    }
+    components.push_back(std::move(copy[0]));
+  }
+  if (first_bad_status != nullptr) {
+    TF_SetStatus(status, TF_GetCode(first_bad_status.get()),
+                 TF_Message(first_bad_status.get()));
+    return nullptr;
   }
   return ParallelTensor::FromTensorHandles(*this, std::move(components),
                                            status);
@@ -348,7 +419,7 @@ ParallelDevice::Execute(
        ++device_index) {
     DeviceThread* device_thread = device_threads_[device_index].get();
     std::vector<TFE_TensorHandle*> device_inputs;
-    device_inputs.reserve(device_inputs.size());
+    device_inputs.reserve(inputs.size());
     for (int input_index = 0; input_index < inputs.size(); ++input_index) {
       // Parallel tensors are divided between operations by device.
       device_inputs.push_back(inputs[input_index]->tensor(device_index));
@@ -116,5 +116,51 @@ TEST(PARALLEL_DEVICE_LIB, TestExplicitOutputShape) {
   EXPECT_EQ(0, handles[0]->shape().size());
 }
 
+TEST(PARALLEL_DEVICE_LIB, TestCopyToParallelDevice) {
+  std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)> status(
+      TF_NewStatus(), TF_DeleteStatus);
+  std::unique_ptr<TFE_ContextOptions, decltype(&TFE_DeleteContextOptions)> opts(
+      TFE_NewContextOptions(), TFE_DeleteContextOptions);
+  std::unique_ptr<TF_Buffer, decltype(&TF_DeleteBuffer)> config(
+      TF_CreateConfig(
+          /*xla*/ false,
+          /* gpu_memory_allow_growth */ true, /* num_cpu_devices */
+          2),
+      TF_DeleteBuffer);
+  TFE_ContextOptionsSetConfig(opts.get(), config->data, config->length,
+                              status.get());
+  std::unique_ptr<TFE_Context, decltype(&TFE_DeleteContext)> context(
+      TFE_NewContext(opts.get(), status.get()), TFE_DeleteContext);
+  ASSERT_TRUE(TF_GetCode(status.get()) == TF_OK) << TF_Message(status.get());
+
+  std::vector<std::string> devices{
+      "/job:localhost/replica:0/task:0/device:CPU:0",
+      "/job:localhost/replica:0/task:0/device:CPU:1"};
+  ParallelDevice parallel_device(devices);
+  std::unique_ptr<TF_Tensor, decltype(&TF_DeleteTensor)> value(
+      TF_AllocateTensor(TF_FLOAT, /*dims=*/nullptr, /*num_dims=*/0,
+                        sizeof(float)),
+      TF_DeleteTensor);
+  *static_cast<float*>(TF_TensorData(value.get())) = 3.f;
+  TensorHandlePtr handle(TFE_NewTensorHandle(value.get(), status.get()));
+  ASSERT_TRUE(TF_GetCode(status.get()) == TF_OK) << TF_Message(status.get());
+
+  std::unique_ptr<ParallelTensor> parallel_tensor =
+      parallel_device.CopyToParallelDevice(context.get(), handle.get(),
+                                           status.get());
+  ASSERT_TRUE(TF_GetCode(status.get()) == TF_OK) << TF_Message(status.get());
+  ASSERT_EQ(devices.size(), parallel_tensor->num_tensors());
+  for (int i = 0; i < 2; ++i) {
+    TFE_TensorHandle* component = parallel_tensor->tensor(i);
+    EXPECT_EQ(devices[i],
+              TFE_TensorHandleDeviceName(component, status.get()));
+    ASSERT_TRUE(TF_GetCode(status.get()) == TF_OK) << TF_Message(status.get());
+    std::unique_ptr<TF_Tensor, decltype(&TF_DeleteTensor)> resolved(
+        TFE_TensorHandleResolve(component, status.get()), TF_DeleteTensor);
+    ASSERT_TRUE(TF_GetCode(status.get()) == TF_OK) << TF_Message(status.get());
+    EXPECT_EQ(3.f, *static_cast<float*>(TF_TensorData(resolved.get())));
+  }
+}
+
 }  // namespace parallel_device
 }  // namespace tensorflow
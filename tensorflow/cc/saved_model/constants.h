@@ -24,6 +24,12 @@ constexpr char kSavedModelAssetsDirectory[] = "assets";
 /// SavedModel assets.extra directory.
 constexpr char kSavedModelAssetsExtraDirectory[] = "assets.extra";
 
+/// SavedModel warmup requests filename, in the assets.extra directory. The file
+/// is a TFRecord file of serialized RunStepRequest protos, of which only the
+/// `feed`, `fetch` and `target` fields are used.
+constexpr char kSavedModelWarmupRequestsFilename[] =
+    "saved_model_warmup_requests";
+
 /// SavedModel assets key for graph collection-def.
 constexpr char kSavedModelAssetsKey[] = "saved_model_assets";
 
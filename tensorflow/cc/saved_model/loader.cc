@@ -24,18 +24,24 @@ limitations under the License.
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/protobuf/graph_debug_info.pb.h"
+#include "tensorflow/core/protobuf/master.pb.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/protobuf/saver.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 
 namespace tensorflow {
@@ -64,6 +70,9 @@ auto* load_latency_by_stage = monitoring::Sampler<2>::New(
 constexpr char kLoadAttemptFail[] = "fail";
 constexpr char kLoadAttemptSuccess[] = "success";
 
+// Maximum number of warmup requests read from the warmup requests file.
+constexpr int kMaxWarmupRequests = 1000;
+
 uint64 GetLatencyMicroseconds(const uint64 start_microseconds) {
   const uint64 end_microseconds = EnvTime::NowMicros();
   // Avoid clock skew.
@@ -235,6 +244,188 @@ Status RunRestore(const RunOptions& run_options, const string& export_dir,
                  nullptr /* outputs */, &run_metadata, session);
 }
 
+// Adds to `feeds` zero-filled tensors for the inputs of `signature_def`, with
+// unknown dimensions set to 1. Returns an error if an input cannot be
+// synthesized, e.g. a sparse input or one of unknown rank.
+Status MakeZeroFeeds(const SignatureDef& signature_def,
+                     std::vector<std::pair<string, Tensor>>* feeds) {
+  for (const auto& input : signature_def.inputs()) {
+    const TensorInfo& tensor_info = input.second;
+    if (tensor_info.name().empty()) {
+      return errors::Unimplemented("Input ", input.first,
+                                   " is not a dense tensor");
+    }
+    if (tensor_info.tensor_shape().unknown_rank()) {
+      return errors::Unimplemented("Input ", input.first,
+                                   " has an unknown rank");
+    }
+    std::vector<int64> dims;
+    for (const auto& dim : tensor_info.tensor_shape().dim()) {
+      dims.push_back(dim.size() < 0 ? 1 : dim.size());
+    }
+    TensorShape shape;
+    TF_RETURN_IF_ERROR(TensorShapeUtils::MakeShape(dims, &shape));
+    const DataType dtype = tensor_info.dtype();
+    if (!DataTypeCanUseMemcpy(dtype) && dtype != DT_STRING) {
+      return errors::Unimplemented("Input ", input.first, " has type ",
+                                   DataTypeString(dtype));
+    }
+    // String tensors are created with empty strings.
+    Tensor tensor(dtype, shape);
+    if (DataTypeCanUseMemcpy(dtype)) {
+      memset(tensor.data(), 0, tensor.TotalBytes());
+    }
+    feeds->emplace_back(tensor_info.name(), std::move(tensor));
+  }
+  return Status::OK();
+}
+
+// Reads the warmup requests recorded in the assets.extra directory of
+// `export_dir`, if any.
+Status ReadWarmupRequests(const string& export_dir,
+                          std::vector<RunStepRequest>* requests) {
+  const string path =
+      io::JoinPath(export_dir, kSavedModelAssetsExtraDirectory,
+                   kSavedModelWarmupRequestsFilename);
+  if (!Env::Default()->FileExists(path).ok()) {
+    return Status::OK();
+  }
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(path, &file));
+  io::RecordReader reader(file.get());
+  uint64 offset = 0;
+  tstring record;
+  while (true) {
+    const Status status = reader.ReadRecord(&offset, &record);
+    if (errors::IsOutOfRange(status)) break;
+    TF_RETURN_IF_ERROR(status);
+    if (requests->size() >= kMaxWarmupRequests) {
+      return errors::InvalidArgument("Too many warmup requests in ", path,
+                                     ", at most ", kMaxWarmupRequests,
+                                     " are allowed");
+    }
+    RunStepRequest request;
+    if (!request.ParseFromArray(record.data(), record.size())) {
+      return errors::DataLoss("Cannot parse warmup request ", requests->size(),
+                              " in ", path);
+    }
+    requests->push_back(std::move(request));
+  }
+  return Status::OK();
+}
+
+// Runs the feeds, fetches and targets of a recorded warmup request.
+Status ReplayWarmupRequest(const RunOptions& run_options,
+                           const RunStepRequest& request, Session* session) {
+  std::vector<std::pair<string, Tensor>> inputs;
+  for (const NamedTensorProto& feed : request.feed()) {
+    Tensor tensor;
+    if (!tensor.FromProto(feed.tensor())) {
+      return errors::InvalidArgument("Invalid tensor for warmup feed ",
+                                     feed.name());
+    }
+    inputs.emplace_back(feed.name(), std::move(tensor));
+  }
+  const std::vector<string> output_tensor_names(request.fetch().begin(),
+                                                request.fetch().end());
+  const std::vector<string> target_node_names(request.target().begin(),
+                                              request.target().end());
+  std::vector<Tensor> outputs;
+  RunMetadata run_metadata;
+  return session->Run(run_options, inputs, output_tensor_names,
+                      target_node_names, &outputs, &run_metadata);
+}
+
+// If TF_SAVED_MODEL_WARMUP is set, warms up `session` before the model is
+// reported as loaded, so that the first requests do not pay for kernel
+// instantiation, graph optimization, autotuning and allocator growth:
+//
+// - every signature of `meta_graph` is run once with zero-filled inputs, which
+//   instantiates its executors and kernels even if the run itself fails on
+//   the synthesized inputs;
+// - the requests recorded in assets.extra/saved_model_warmup_requests are
+//   replayed, and any failure fails the load.
+//
+// Runs are spread over TF_SAVED_MODEL_WARMUP_THREADS threads.
+Status WarmupSession(const RunOptions& run_options, const string& export_dir,
+                     const MetaGraphDef& meta_graph, Session* session) {
+  bool warmup;
+  TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_SAVED_MODEL_WARMUP",
+                                        /*default_val=*/false, &warmup));
+  if (!warmup) return Status::OK();
+  int64 num_threads;
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar("TF_SAVED_MODEL_WARMUP_THREADS",
+                                         /*default_val=*/4, &num_threads));
+  if (num_threads < 1) {
+    return errors::InvalidArgument(
+        "TF_SAVED_MODEL_WARMUP_THREADS must be positive, got ", num_threads);
+  }
+
+  const uint64 warmup_start_microseconds = Env::Default()->NowMicros();
+  std::vector<RunStepRequest> requests;
+  TF_RETURN_IF_ERROR(ReadWarmupRequests(export_dir, &requests));
+  LOG(INFO) << "Warming up SavedModel bundle with "
+            << meta_graph.signature_def_size() << " signatures and "
+            << requests.size() << " recorded requests.";
+
+  mutex mu;
+  Status status;
+  {
+    thread::ThreadPool pool(Env::Default(), "saved_model_warmup", num_threads);
+    for (const auto& signature : meta_graph.signature_def()) {
+      const string& key = signature.first;
+      if (key == kSavedModelInitOpSignatureKey ||
+          key == kSavedModelTrainOpSignatureKey) {
+        continue;
+      }
+      std::vector<std::pair<string, Tensor>> inputs;
+      const Status feeds_status = MakeZeroFeeds(signature.second, &inputs);
+      if (!feeds_status.ok()) {
+        VLOG(1) << "Not pre-instantiating signature " << key << ": "
+                << feeds_status;
+        continue;
+      }
+      std::vector<string> output_tensor_names;
+      for (const auto& output : signature.second.outputs()) {
+        if (!output.second.name().empty()) {
+          output_tensor_names.push_back(output.second.name());
+        }
+      }
+      pool.Schedule([&run_options, &key, inputs = std::move(inputs),
+                     output_tensor_names = std::move(output_tensor_names),
+                     session]() {
+        std::vector<Tensor> outputs;
+        RunMetadata run_metadata;
+        const Status run_status =
+            session->Run(run_options, inputs, output_tensor_names, {},
+                         &outputs, &run_metadata);
+        if (!run_status.ok()) {
+          VLOG(1) << "Pre-instantiation run of signature " << key
+                  << " failed: " << run_status;
+        }
+      });
+    }
+    for (const RunStepRequest& request : requests) {
+      pool.Schedule([&run_options, &request, &mu, &status, session]() {
+        const Status run_status =
+            ReplayWarmupRequest(run_options, request, session);
+        if (!run_status.ok()) {
+          mutex_lock lock(mu);
+          status.Update(run_status);
+        }
+      });
+    }
+    // The pool waits for all runs when it goes out of scope.
+  }
+  load_latency_by_stage->GetCell(export_dir, "warmup")
+      ->Add(GetLatencyMicroseconds(warmup_start_microseconds));
+  if (!status.ok()) {
+    return Status(status.code(), strings::StrCat("SavedModel warmup failed: ",
+                                                 status.error_message()));
+  }
+  return Status::OK();
+}
+
 }  // namespace
 
 SavedModelBundleInterface::~SavedModelBundleInterface() {}
@@ -262,6 +453,9 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
       session_options, bundle->meta_graph_def, &bundle->session));
   TF_RETURN_IF_ERROR(RestoreSession(run_options, bundle->meta_graph_def,
                                     export_dir, &bundle->session));
+  TF_RETURN_IF_ERROR(WarmupSession(run_options, export_dir,
+                                   bundle->meta_graph_def,
+                                   bundle->session.get()));
   return Status::OK();
 }
 
@@ -24,8 +24,10 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/master.pb.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 
 namespace tensorflow {
@@ -76,6 +78,50 @@ class LoaderTest : public ::testing::Test {
         test::AsTensor<tstring>({"foo.txt"}, TensorShape({})), path_outputs[0]);
   }
 
+  // Copies the half_plus_two model to a temporary directory `name`, with
+  // `requests` recorded as warmup requests, and returns the new export dir.
+  string MakeExportDirWithWarmup(const string& name,
+                                 const std::vector<RunStepRequest>& requests) {
+    Env* env = Env::Default();
+    const string source_dir =
+        io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+    const string export_dir = io::JoinPath(testing::TmpDir(), name);
+    for (const string& file :
+         {string(kSavedModelFilenamePb), string("assets/foo.txt"),
+          string("variables/variables.index"),
+          string("variables/variables.data-00000-of-00001")}) {
+      const string target = io::JoinPath(export_dir, file);
+      TF_CHECK_OK(env->RecursivelyCreateDir(string(io::Dirname(target))));
+      TF_CHECK_OK(env->CopyFile(io::JoinPath(source_dir, file), target));
+    }
+
+    const string warmup_dir =
+        io::JoinPath(export_dir, kSavedModelAssetsExtraDirectory);
+    TF_CHECK_OK(env->RecursivelyCreateDir(warmup_dir));
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(
+        io::JoinPath(warmup_dir, kSavedModelWarmupRequestsFilename), &file));
+    io::RecordWriter writer(file.get());
+    for (const RunStepRequest& request : requests) {
+      TF_CHECK_OK(writer.WriteRecord(request.SerializeAsString()));
+    }
+    TF_CHECK_OK(writer.Close());
+    TF_CHECK_OK(file->Close());
+    return export_dir;
+  }
+
+  // Returns a warmup request running the regression signature of
+  // half_plus_two and fetching `output_name`.
+  RunStepRequest MakeWarmupRequest(const string& output_name) {
+    RunStepRequest request;
+    NamedTensorProto* feed = request.add_feed();
+    feed->set_name("tf_example:0");
+    test::AsTensor<tstring>({MakeSerializedExample(1)}, TensorShape({1}))
+        .AsProtoTensorContent(feed->mutable_tensor());
+    request.add_fetch(output_name);
+    return request;
+  }
+
   void CheckSavedModelBundle(const string& export_dir,
                              const SavedModelBundle& bundle) {
     ValidateAssets(export_dir, bundle);
@@ -345,5 +391,43 @@ TEST_F(LoaderTest, BadNodeAttr) {
       std::string::npos);
 }
 
+TEST_F(LoaderTest, WarmupReplaysRecordedRequests) {
+  const string export_dir = MakeExportDirWithWarmup(
+      "half_plus_two_warmup", {MakeWarmupRequest("y:0"),
+                               MakeWarmupRequest("y:0")});
+  setenv("TF_SAVED_MODEL_WARMUP", "true", /*overwrite=*/1);
+  SavedModelBundle bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+  const Status status = LoadSavedModel(session_options, run_options,
+                                       export_dir, {kSavedModelTagServe},
+                                       &bundle);
+  unsetenv("TF_SAVED_MODEL_WARMUP");
+  TF_ASSERT_OK(status);
+  CheckSavedModelBundle(export_dir, bundle);
+}
+
+TEST_F(LoaderTest, FailedWarmupRequestFailsLoad) {
+  const string export_dir = MakeExportDirWithWarmup(
+      "half_plus_two_bad_warmup", {MakeWarmupRequest("no_such_tensor:0")});
+  SavedModelBundle bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+
+  // Warmup requests are ignored unless warmup is enabled.
+  TF_ASSERT_OK(LoadSavedModel(session_options, run_options, export_dir,
+                              {kSavedModelTagServe}, &bundle));
+
+  setenv("TF_SAVED_MODEL_WARMUP", "true", /*overwrite=*/1);
+  const Status status = LoadSavedModel(session_options, run_options,
+                                       export_dir, {kSavedModelTagServe},
+                                       &bundle);
+  unsetenv("TF_SAVED_MODEL_WARMUP");
+  EXPECT_FALSE(status.ok());
+  EXPECT_NE(status.error_message().find("SavedModel warmup failed"),
+            std::string::npos)
+      << status;
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -730,6 +730,130 @@ class {{CLASS}} final : public tensorflow::XlaCompiledCpuFunction {
   return Status::OK();
 }
 
+string BatchVariantClassName(const string& class_name, int64 batch_size) {
+  return absl::StrCat(class_name, "_b", batch_size);
+}
+
+Status GenerateDispatcherHeader(const CodegenOpts& opts,
+                                const tf2xla::Config& config,
+                                const CompileResult& compile_result,
+                                const std::vector<int64>& batch_sizes,
+                                const std::vector<int>& batched_feeds,
+                                string* header) {
+  TF_RETURN_IF_ERROR(ValidateConfig(config));
+  TF_RETURN_IF_ERROR(ValidateFeedFetchCppNames(config));
+  if (batch_sizes.empty()) {
+    return errors::InvalidArgument("dispatcher requires a batch size");
+  }
+  const xla::ProgramShapeProto& ps = compile_result.program_shape;
+  string methods_arg, methods_result, methods_variable;
+  TF_RETURN_IF_ERROR(GenArgMethods(config, ps, compile_result, &methods_arg));
+  TF_RETURN_IF_ERROR(GenResultMethods(config, ps, &methods_result));
+  TF_RETURN_IF_ERROR(GenVariableMethods(config, ps, &methods_variable));
+
+  std::vector<string> variants;
+  for (int64 batch_size : batch_sizes) {
+    variants.push_back(
+        absl::StrCat("{", batch_size, ", &Create<",
+                     BatchVariantClassName(opts.class_name, batch_size), ">}"));
+  }
+
+  string ns_start;
+  for (const string& n : opts.namespaces) {
+    ns_start += absl::StrCat("namespace ", n, " {\n");
+  }
+  ns_start += "\n";
+  string ns_end("\n");
+  for (int i = opts.namespaces.size() - 1; i >= 0; --i) {
+    const string& n = opts.namespaces[i];
+    ns_end += absl::StrCat("}  // end namespace ", n, "\n");
+  }
+
+  *header =
+      R"(// Generated by tfcompile, the TensorFlow graph compiler.  DO NOT EDIT!
+//
+// clang-format off
+
+#ifndef TFCOMPILE_DISPATCHER_{{ENTRY}}_H_  // NOLINT(build/header_guard)
+#define TFCOMPILE_DISPATCHER_{{ENTRY}}_H_  // NOLINT(build/header_guard)
+
+#include <memory>
+
+#include "tensorflow/compiler/tf2xla/xla_compiled_cpu_function_dispatcher.h"
+
+{{NS_START}}
+// {{CLASS}} represents a computation previously specified in a TensorFlow
+// graph, compiled into a variant for each of the batch sizes {{BATCH_SIZES}}.
+// Run executes the smallest variant that fits batch_size(), padding the batched
+// args. Usage example:
+//
+//   {{CLASS}} computation;
+//   // ...set the first n rows of the args using computation.argN methods
+//   CHECK(computation.set_batch_size(n));
+//   CHECK(computation.Run());
+//   // ...inspect the first n rows of the results using computation.resultN
+//   // methods
+//
+// The arg, result and variable methods are those of the largest variant, with
+// the batch dimension leading; see {{MAX_BATCH_CLASS}} for their
+// documentation. Only the first batch_size() rows of batched results are
+// meaningful after Run.
+//
+// The logical function signature of the largest variant is:
+//   {{PROGRAM_SHAPE}}
+class {{CLASS}} final : public tensorflow::XlaCompiledCpuFunctionDispatcher {
+ public:
+  // Number of input arguments for the compiled computation.
+  static constexpr size_t kNumArgs = {{ARG_NUM}};
+
+  // Number of variables for the compiled computation.
+  static constexpr size_t kNumVariables = {{VARIABLE_NUM}};
+
+  {{CLASS}}()
+      : XlaCompiledCpuFunctionDispatcher(
+            {{{VARIANTS}}},
+            {{{BATCHED_ARG_INDICES}}}) {}
+
+  {{CLASS}}(const {{CLASS}}&) = delete;
+  {{CLASS}}& operator=(const {{CLASS}}&) = delete;
+{{METHODS_ARG}}
+{{METHODS_RESULT}}
+{{METHODS_VARIABLE}}
+ private:
+  // Creates the variant T, reading args from the dispatcher's buffers.
+  template <typename T>
+  static std::unique_ptr<tensorflow::XlaCompiledCpuFunction> Create() {
+    return std::unique_ptr<tensorflow::XlaCompiledCpuFunction>(
+        new T(T::AllocMode::RESULTS_PROFILES_AND_TEMPS_ONLY));
+  }
+};
+{{NS_END}}
+
+#endif  // TFCOMPILE_DISPATCHER_{{ENTRY}}_H_
+
+// clang-format on
+)";
+  const std::vector<std::pair<string, string>> rewrites = {
+      {"{{ARG_NUM}}", absl::StrCat(ps.parameters_size())},
+      {"{{BATCH_SIZES}}", absl::StrJoin(batch_sizes, ", ")},
+      {"{{{BATCHED_ARG_INDICES}}}",
+       absl::StrCat("{", absl::StrJoin(batched_feeds, ", "), "}")},
+      {"{{CLASS}}", opts.class_name},
+      {"{{ENTRY}}", compile_result.entry_point},
+      {"{{MAX_BATCH_CLASS}}",
+       BatchVariantClassName(opts.class_name, batch_sizes.back())},
+      {"{{METHODS_ARG}}\n", methods_arg},
+      {"{{METHODS_RESULT}}\n", methods_result},
+      {"{{METHODS_VARIABLE}}\n", methods_variable},
+      {"{{NS_END}}\n", ns_end},
+      {"{{NS_START}}\n", ns_start},
+      {"{{PROGRAM_SHAPE}}", xla::ShapeUtil::HumanString(xla::ProgramShape(ps))},
+      {"{{{VARIANTS}}}", absl::StrCat("{", absl::StrJoin(variants, ", "), "}")},
+      {"{{VARIABLE_NUM}}", absl::StrCat(config.variable_size())}};
+  absl::StrReplaceAll(rewrites, header);
+  return Status::OK();
+}
+
 static string CreateUniqueIdentifier(const CodegenOpts& opts,
                                      absl::string_view suffix) {
   string result = "__tfcompile";
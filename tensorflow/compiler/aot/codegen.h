@@ -87,6 +87,25 @@ Status GenerateHeader(const CodegenOpts& opts, const tf2xla::Config& config,
                       const CompileResult& compile_result,
                       const MetadataResult& metadata_result, string* header);
 
+// Returns the name of the class generated for the variant of `class_name`
+// compiled for `batch_size`.
+string BatchVariantClassName(const string& class_name, int64 batch_size);
+
+// GenerateDispatcherHeader generates a C++ header declaring the class
+// opts.class_name, which runs the variant of the computation compiled for the
+// smallest of `batch_sizes` that fits the batch.  The variant classes, named by
+// BatchVariantClassName, must be declared before the generated code.
+//
+// `config` and `compile_result` are those of the largest variant, and
+// `batched_feeds` are the indices of the feeds whose leading dimension is the
+// batch dimension.
+Status GenerateDispatcherHeader(const CodegenOpts& opts,
+                                const tf2xla::Config& config,
+                                const CompileResult& compile_result,
+                                const std::vector<int64>& batch_sizes,
+                                const std::vector<int>& batched_feeds,
+                                string* header);
+
 // ParseCppClass parses `cpp_class` into its `class_name` and `namespaces`
 // components.  The syntax is [[<optional_namespace>::],...]<class_name>.  This
 // mirrors the C++ syntax for referring to a class, where multiple namespaces
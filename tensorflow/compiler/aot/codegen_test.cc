@@ -264,6 +264,57 @@ TEST(CodegenTest, Golden) {
   CompareWithGoldenFile("tensorflow/compiler/aot/codegen_test_h.golden", header,
                         true);
 }
+
+TEST(CodegenTest, Dispatcher) {
+  CodegenOpts opts;
+  opts.class_name = "MyClass";
+  opts.namespaces = {"foo"};
+  tf2xla::Config config;
+  tf2xla::Feed* feed = config.add_feed();
+  feed->mutable_id()->set_node_name("feed0");
+  feed->set_name("myfeed");
+  TensorShapeProto* shape = feed->mutable_shape();
+  shape->add_dim()->set_size(8);
+  shape->add_dim()->set_size(3);
+  feed = config.add_feed();
+  feed->mutable_id()->set_node_name("feed1");
+  tf2xla::Fetch* fetch = config.add_fetch();
+  fetch->mutable_id()->set_node_name("fetch0");
+  CompileResult compile_result;
+  compile_result.aot.reset(new xla::cpu::CpuAotCompilationResult(
+      {},
+      {BufferInfo::MakeEntryParameter(/*size=*/96, /*param_number=*/0),
+       BufferInfo::MakeEntryParameter(/*size=*/4, /*param_number=*/1),
+       BufferInfo::MakeTempBuffer(96)},
+      2, {}));
+  compile_result.program_shape =
+      xla::ShapeUtil::MakeProgramShape(
+          {
+              xla::ShapeUtil::MakeShape(xla::F32, {8, 3}),
+              xla::ShapeUtil::MakeShape(xla::F32, {}),
+          },
+          xla::ShapeUtil::MakeTupleShape({
+              xla::ShapeUtil::MakeShape(xla::F32, {8, 3}),
+          }))
+          .ToProto();
+  compile_result.entry_point = "entry_point_b8";
+
+  string header;
+  TF_ASSERT_OK(GenerateDispatcherHeader(opts, config, compile_result,
+                                        /*batch_sizes=*/{1, 8},
+                                        /*batched_feeds=*/{0}, &header));
+  EXPECT_TRUE(absl::StrContains(
+      header,
+      "class MyClass final : public "
+      "tensorflow::XlaCompiledCpuFunctionDispatcher"));
+  EXPECT_TRUE(absl::StrContains(
+      header, "{{1, &Create<MyClass_b1>}, {8, &Create<MyClass_b8>}},\n"
+              "            {0}) {}"));
+  EXPECT_TRUE(absl::StrContains(header, "float* arg_myfeed_data()"));
+  EXPECT_TRUE(absl::StrContains(header, "float& result0(size_t dim0, "));
+  EXPECT_TRUE(
+      absl::StrContains(header, "MyClass(const MyClass&) = delete;"));
+}
 }  // namespace
 }  // namespace tfcompile
 }  // namespace tensorflow
@@ -15,12 +15,17 @@ limitations under the License.
 
 #include "tensorflow/compiler/aot/compile.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/base/call_once.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "llvm-c/Target.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "tensorflow/compiler/aot/codegen.h"
@@ -206,6 +211,148 @@ static std::string InterpolateErrorMessage(std::string message) {
   return message;
 }
 
+// Parses the comma-separated --batch_sizes flag into increasing batch sizes.
+static Status ParseBatchSizes(const string& flag,
+                              std::vector<int64>* batch_sizes) {
+  for (absl::string_view size : absl::StrSplit(flag, ',', absl::SkipEmpty())) {
+    int64 batch_size;
+    if (!absl::SimpleAtoi(size, &batch_size) || batch_size < 1) {
+      return errors::InvalidArgument("Invalid --batch_sizes entry: ", size);
+    }
+    batch_sizes->push_back(batch_size);
+  }
+  absl::c_sort(*batch_sizes);
+  batch_sizes->erase(std::unique(batch_sizes->begin(), batch_sizes->end()),
+                     batch_sizes->end());
+  return Status::OK();
+}
+
+// Returns `config` with the batch dimension, a leading feed dimension of size
+// -1, set to `batch_size`. The indices of the batched feeds are returned in
+// `batched_feeds`.
+static tf2xla::Config ConfigForBatchSize(const tf2xla::Config& config,
+                                         int64 batch_size,
+                                         std::vector<int>* batched_feeds) {
+  tf2xla::Config batch_config = config;
+  batched_feeds->clear();
+  for (int i = 0; i < batch_config.feed_size(); ++i) {
+    TensorShapeProto* shape = batch_config.mutable_feed(i)->mutable_shape();
+    if (shape->dim_size() > 0 && shape->dim(0).size() == -1) {
+      shape->mutable_dim(0)->set_size(batch_size);
+      batched_feeds->push_back(i);
+    }
+  }
+  return batch_config;
+}
+
+// Returns `path` with "_b<batch_size>" inserted before its extension.
+static string PathForBatchSize(const string& path, int64 batch_size) {
+  const size_t basename_start = path.find_last_of('/') + 1;
+  size_t extension_start = path.find_last_of('.');
+  if (extension_start == string::npos || extension_start < basename_start) {
+    extension_start = path.size();
+  }
+  return absl::StrCat(path.substr(0, extension_start), "_b", batch_size,
+                      path.substr(extension_start));
+}
+
+static Status MakeCodegenOpts(const MainFlags& flags,
+                              CodegenOpts* codegen_opts) {
+  codegen_opts->gen_name_to_index = flags.gen_name_to_index;
+  codegen_opts->gen_program_shape = flags.gen_program_shape;
+  codegen_opts->target_triple = flags.target_triple;
+  if (flags.cpp_class.empty()) {
+    return errors::InvalidArgument("Must specify --cpp_class");
+  }
+  codegen_opts->gen_hlo_profile_printer_data =
+      xla::GetDebugOptionsFromFlags().xla_hlo_profile();
+  return ParseCppClass(flags.cpp_class, &codegen_opts->class_name,
+                       &codegen_opts->namespaces);
+}
+
+// Compiles a variant of the graph for each of `batch_sizes`, and generates a
+// header with a class per variant and a dispatcher class named by --cpp_class.
+//
+// Constants folded into the computation are compiled into each variant; large
+// weights should be fed as (readonly) variables instead, whose buffers the
+// dispatcher shares across variants.
+static Status CompileBatchSizeVariants(const MainFlags& flags,
+                                       const tf2xla::Config& config,
+                                       const std::vector<int64>& batch_sizes) {
+  std::vector<int> batched_feeds;
+  const tf2xla::Config max_batch_config =
+      ConfigForBatchSize(config, batch_sizes.back(), &batched_feeds);
+  TF_RETURN_IF_ERROR(ValidateConfig(max_batch_config));
+  if (batched_feeds.empty()) {
+    return errors::InvalidArgument(
+        "--batch_sizes requires a feed whose leading dimension has size -1");
+  }
+  if (flags.dump_fetch_nodes) {
+    std::set<string> nodes;
+    for (const tf2xla::Fetch& fetch : config.fetch()) {
+      nodes.insert(fetch.id().node_name());
+    }
+    std::cout << absl::StrJoin(nodes, ",");
+    return Status::OK();
+  }
+
+  if (flags.graph.empty()) {
+    return errors::InvalidArgument("Must specify --graph");
+  }
+  GraphDef graph_def;
+  TF_RETURN_IF_ERROR(ReadProtoFile(flags.graph, &graph_def));
+  CodegenOpts codegen_opts;
+  TF_RETURN_IF_ERROR(MakeCodegenOpts(flags, &codegen_opts));
+
+  Env* env = Env::Default();
+  string header;
+  CompileResult max_batch_result;
+  for (int64 batch_size : batch_sizes) {
+    const tf2xla::Config batch_config =
+        ConfigForBatchSize(config, batch_size, &batched_feeds);
+    MainFlags batch_flags = flags;
+    batch_flags.entry_point = absl::StrCat(flags.entry_point, "_b", batch_size);
+    if (batch_size != batch_sizes.back()) {
+      batch_flags.out_session_module.clear();
+    }
+    CompileResult compile_result;
+    Status status =
+        CompileGraph(graph_def, batch_config, batch_flags, &compile_result);
+    if (!status.ok()) {
+      return Status(status.code(),
+                    InterpolateErrorMessage(status.error_message()));
+    }
+
+    const std::vector<char>& obj = compile_result.aot->object_file_data();
+    TF_RETURN_IF_ERROR(WriteStringToFile(
+        env, PathForBatchSize(flags.out_function_object, batch_size),
+        absl::string_view(obj.data(), obj.size())));
+    CodegenOpts batch_opts = codegen_opts;
+    batch_opts.class_name =
+        BatchVariantClassName(codegen_opts.class_name, batch_size);
+    MetadataResult metadata_result;
+    TF_RETURN_IF_ERROR(
+        GenerateMetadata(batch_opts, compile_result, &metadata_result));
+    TF_RETURN_IF_ERROR(WriteStringToFile(
+        env, PathForBatchSize(flags.out_metadata_object, batch_size),
+        metadata_result.object_file_data));
+    string batch_header;
+    TF_RETURN_IF_ERROR(GenerateHeader(batch_opts, batch_config, compile_result,
+                                      metadata_result, &batch_header));
+    absl::StrAppend(&header, batch_header, "\n");
+    if (batch_size == batch_sizes.back()) {
+      max_batch_result = std::move(compile_result);
+    }
+  }
+
+  string dispatcher_header;
+  TF_RETURN_IF_ERROR(GenerateDispatcherHeader(
+      codegen_opts, max_batch_config, max_batch_result, batch_sizes,
+      batched_feeds, &dispatcher_header));
+  absl::StrAppend(&header, dispatcher_header);
+  return WriteStringToFile(env, flags.out_header, header);
+}
+
 Status Main(const MainFlags& flags) {
   absl::call_once(targets_init, &InitializeTargets);
 
@@ -215,6 +362,11 @@ Status Main(const MainFlags& flags) {
     return errors::InvalidArgument("Must specify --config");
   }
   TF_RETURN_IF_ERROR(ReadProtoFile(flags.config, &config));
+  std::vector<int64> batch_sizes;
+  TF_RETURN_IF_ERROR(ParseBatchSizes(flags.batch_sizes, &batch_sizes));
+  if (!batch_sizes.empty()) {
+    return CompileBatchSizeVariants(flags, config, batch_sizes);
+  }
   TF_RETURN_IF_ERROR(ValidateConfig(config));
   if (flags.dump_fetch_nodes) {
     std::set<string> nodes;
@@ -247,16 +399,7 @@ Status Main(const MainFlags& flags) {
       WriteStringToFile(env, flags.out_function_object,
                         absl::string_view(obj.data(), obj.size())));
   CodegenOpts codegen_opts;
-  codegen_opts.gen_name_to_index = flags.gen_name_to_index;
-  codegen_opts.gen_program_shape = flags.gen_program_shape;
-  codegen_opts.target_triple = flags.target_triple;
-  if (flags.cpp_class.empty()) {
-    return errors::InvalidArgument("Must specify --cpp_class");
-  }
-  codegen_opts.gen_hlo_profile_printer_data =
-      xla::GetDebugOptionsFromFlags().xla_hlo_profile();
-  TF_RETURN_IF_ERROR(ParseCppClass(flags.cpp_class, &codegen_opts.class_name,
-                                   &codegen_opts.namespaces));
+  TF_RETURN_IF_ERROR(MakeCodegenOpts(flags, &codegen_opts));
 
   MetadataResult metadata_result;
   TF_RETURN_IF_ERROR(
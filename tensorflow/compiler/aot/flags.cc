@@ -80,6 +80,14 @@ void AppendMainFlags(std::vector<Flag>* flag_list, MainFlags* flags) {
       {"experimental_quantize", &flags->experimental_quantize,
        "If set, quantization passes will run and dump the result before HLO "
        "code generation."},
+      {"batch_sizes", &flags->batch_sizes,
+       "Comma-separated batch sizes, e.g. 1,8,32.  If set, the leading "
+       "dimension of each feed with a shape dim of size -1 is the batch "
+       "dimension, and a variant of the function is compiled for each batch "
+       "size.  --cpp_class then names a dispatcher class running the "
+       "smallest variant that fits the batch, and --out_function_object and "
+       "--out_metadata_object name one object file per batch size B, with "
+       "_b<B> inserted before the extension."},
       {"gen_name_to_index", &flags->gen_name_to_index,
        "Generate name-to-index data for Lookup{Arg,Result}Index methods."},
       {"gen_program_shape", &flags->gen_program_shape,
@@ -51,6 +51,7 @@ limitations under the License.
 #include "tensorflow/compiler/aot/tests/test_graph_tffunction.h"
 #include "tensorflow/compiler/aot/tests/test_graph_tfgather.h"
 #include "tensorflow/compiler/aot/tests/test_graph_tfmatmul.h"
+#include "tensorflow/compiler/aot/tests/test_graph_tfmatmul_batched.h"
 #include "tensorflow/compiler/aot/tests/test_graph_tfmatmulandadd.h"
 #include "tensorflow/compiler/aot/tests/test_graph_tfmatmulandadd_with_profiling.h"
 #include "tensorflow/compiler/aot/tests/test_graph_tfsplits.h"
@@ -339,6 +340,44 @@ TEST(TFCompileTest, MatMul2_SetArg) {
   EXPECT_EQ(matmul.result0_data(), matmul.results()[0]);
 }
 
+#if !defined(ENABLE_MLIR_BRIDGE_TEST)
+TEST(TFCompileTest, MatMulBatched) {
+  Eigen::ThreadPool tp(2);
+  Eigen::ThreadPoolDevice device(&tp, tp.NumThreads());
+
+  foo::bar::BatchedMatMulComp matmul;
+  matmul.set_thread_pool(&device);
+  EXPECT_EQ(matmul.max_batch_size(), 4);
+  EXPECT_EQ(matmul.arg0_data(), matmul.arg_data(0));
+  EXPECT_EQ(matmul.arg1_data(), matmul.arg_data(1));
+  EXPECT_FALSE(matmul.set_batch_size(0));
+  EXPECT_FALSE(matmul.set_batch_size(5));
+
+  const float arg0[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  const float arg1[6] = {7, 8, 9, 10, 11, 12};
+  std::copy(arg1 + 0, arg1 + 6, matmul.arg1_data());
+
+  // A batch of 3 runs the variant for 4, with a padding row.
+  std::copy(arg0 + 0, arg0 + 9, matmul.arg0_data());
+  matmul.arg0(3, 0) = 100;
+  ASSERT_TRUE(matmul.set_batch_size(3));
+  EXPECT_TRUE(matmul.Run());
+  EXPECT_EQ(matmul.last_run_batch_size(), 4);
+  const float results[6] = {58, 64, 139, 154, 220, 244};
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(matmul.result0(i / 2, i % 2), results[i]);
+  }
+  EXPECT_EQ(matmul.arg0(3, 0), 0);
+
+  // A batch of 1 runs the variant for 1.
+  ASSERT_TRUE(matmul.set_batch_size(1));
+  EXPECT_TRUE(matmul.Run());
+  EXPECT_EQ(matmul.last_run_batch_size(), 1);
+  EXPECT_EQ(matmul.result0(0, 0), 58);
+  EXPECT_EQ(matmul.result0(0, 1), 64);
+}
+#endif
+
 TEST(TFCompileTest, MatMulAndAdd1) {
   Eigen::ThreadPool tp(1);
   Eigen::ThreadPoolDevice device(&tp, tp.NumThreads());
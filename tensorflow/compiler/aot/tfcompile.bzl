@@ -40,6 +40,7 @@ def tf_library(
         enable_xla_hlo_profiling = False,
         enable_tracemes = False,
         mlir_components = "None",
+        batch_sizes = None,
         deps = None,
         tags = []):
     """Runs tfcompile to compile a TensorFlow graph into executable code with fast
@@ -96,6 +97,11 @@ def tf_library(
         Xprof to construct profiler timelines.
       mlir_components: When the value is "None", no components use MLIR. When
         the value is "Bridge", use MLIR to translate GraphDef to HLO.
+      batch_sizes: If provided, a list of batch sizes to compile a variant of
+        the graph for.  Feeds whose leading dimension has size -1 in config
+        are batched.  cpp_class then names a dispatcher class running the
+        smallest variant that fits the batch, and each variant is generated as
+        cpp_class + "_b<batch size>".
       deps: a list of deps to include on the build rules for the generated
         library, added to the standard deps if standard_runtime_deps is True.
       tags: tags to apply to subsidiary build rules.
@@ -171,6 +177,21 @@ def tf_library(
     header_file = name + ".h"
     metadata_object_file = name + "_tfcompile_metadata.o"
     function_object_file = name + "_tfcompile_function.o"
+    if batch_sizes:
+        # tfcompile writes an object file per batch size, with "_b<batch size>"
+        # inserted before the extension.
+        object_files = []
+        for batch_size in batch_sizes:
+            object_files += [
+                name + "_tfcompile_metadata_b%d.o" % batch_size,
+                name + "_tfcompile_function_b%d.o" % batch_size,
+            ]
+        batch_sizes_flag = " --batch_sizes=" + ",".join(
+            [str(batch_size) for batch_size in batch_sizes],
+        )
+    else:
+        object_files = [metadata_object_file, function_object_file]
+        batch_sizes_flag = ""
 
     # The XLA backends morph kernal name prefix __ that is not in the form of
     # __xla_.
@@ -222,11 +243,7 @@ def tf_library(
     native.genrule(
         name = ("gen_" + name),
         srcs = srcs,
-        outs = [
-            header_file,
-            metadata_object_file,
-            function_object_file,
-        ],
+        outs = [header_file] + object_files,
         cmd = (
             default_fast_math_xla_flags +
             "CUDA_VISIBLE_DEVICES='' " +
@@ -240,6 +257,7 @@ def tf_library(
             " --out_header=$(@D)/" + header_file +
             " --out_metadata_object=$(@D)/" + metadata_object_file +
             " --out_function_object=$(@D)/" + function_object_file +
+            batch_sizes_flag +
             " " + flags + " " + profiling_flag + " " + mlir_flag + " " + traceme_flag
         ),
         tools = [tfcompile_tool],
@@ -279,6 +297,7 @@ def tf_library(
             " --cpp_class=" + cpp_class +
             " --target_triple=" + target_llvm_triple() +
             " --out_session_module=$(@D)/" + session_module_pb +
+            batch_sizes_flag +
             " " + flags
         ),
         tools = [tfcompile_tool],
@@ -292,7 +311,7 @@ def tf_library(
     # kernel implementations.
     native.cc_library(
         name = name,
-        srcs = [function_object_file, metadata_object_file],
+        srcs = object_files,
         hdrs = [header_file],
         visibility = visibility,
         testonly = testonly,
@@ -302,7 +321,9 @@ def tf_library(
             # generated code will fail to compile.
             "//tensorflow/compiler/tf2xla:xla_compiled_cpu_function",
             "//tensorflow/core:framework_lite",
-        ] + (need_xla_data_proto and [
+        ] + (batch_sizes and [
+            "//tensorflow/compiler/tf2xla:xla_compiled_cpu_function_dispatcher",
+        ] or []) + (need_xla_data_proto and [
             # If we're generating the program shape, we must depend on the
             # proto.
             "//tensorflow/compiler/xla:xla_data_proto_cc",
@@ -321,15 +342,20 @@ def tf_library(
         tags = tags,
     )
 
-    # Variables used for gen_test and gen_benchmark.
-    cpp_class_split = cpp_class.rsplit("::", 2)
+    # Variables used for gen_test and gen_benchmark.  These exercise the largest
+    # variant when compiling for several batch sizes, as they expect an
+    # XlaCompiledCpuFunction.
+    test_cpp_class = cpp_class
+    if batch_sizes:
+        test_cpp_class += "_b%d" % max(batch_sizes)
+    cpp_class_split = test_cpp_class.rsplit("::", 2)
     if len(cpp_class_split) == 1:
         no_ns_name = cpp_class_split[0]
     else:
         no_ns_name = cpp_class_split[1]
     sed_replace = (
         "-e \"s|{{TFCOMPILE_HEADER}}|$(location " + header_file + ")|g\" " +
-        "-e \"s|{{TFCOMPILE_CPP_CLASS}}|" + cpp_class + "|g\" " +
+        "-e \"s|{{TFCOMPILE_CPP_CLASS}}|" + test_cpp_class + "|g\" " +
         "-e \"s|{{TFCOMPILE_NAME}}|" + no_ns_name + "|g\" "
     )
 
@@ -93,6 +93,11 @@ void AppendMarkForCompilationPassFlagsInternal(std::vector<Flag>* flag_list) {
       Flag("tf_xla_max_cluster_size",
            &mark_for_compilation_flags->tf_xla_max_cluster_size,
            "Maximum number of operators in an XLA compilation."),
+      Flag("tf_xla_cluster_cost_model",
+           &mark_for_compilation_flags->tf_xla_cluster_cost_model,
+           "(experimental) Do not compile clusters whose estimated benefit "
+           "is smaller than the cost of launching them and of moving their "
+           "inputs and outputs across devices."),
       Flag(
           "tf_xla_ops_to_cluster",
           &mark_for_compilation_flags->tf_xla_ops_to_cluster,
@@ -148,6 +153,7 @@ void AllocateAndParseFlags() {
   mark_for_compilation_flags->tf_xla_min_cluster_size = 4;
   mark_for_compilation_flags->tf_xla_max_cluster_size =
       std::numeric_limits<int32>::max();
+  mark_for_compilation_flags->tf_xla_cluster_cost_model = false;
   mark_for_compilation_flags->tf_xla_clustering_debug = false;
   mark_for_compilation_flags->tf_xla_cpu_global_jit = false;
   mark_for_compilation_flags->tf_xla_clustering_fuel =
@@ -163,6 +169,11 @@ void AllocateAndParseFlags() {
 
   ops_flags = new XlaOpsCommonFlags;
   ops_flags->tf_xla_always_defer_compilation = false;
+  ops_flags->tf_xla_persistent_cache_directory = "";
+  ops_flags->tf_xla_max_compiles_per_cluster = 0;
+  ops_flags->tf_xla_batch_buckets = "";
+  ops_flags->tf_xla_async_compilation_threads = 0;
+  ops_flags->tf_xla_max_pending_async_compiles = 8;
 
   jitter_flags = new IntroduceFloatingPointJitterPassFlags;
   jitter_flags->jitter_amount = 1e-5;
@@ -216,6 +227,31 @@ void AllocateAndParseFlags() {
 
        Flag("tf_xla_always_defer_compilation",
             &ops_flags->tf_xla_always_defer_compilation, ""),
+       Flag("tf_xla_persistent_cache_directory",
+            &ops_flags->tf_xla_persistent_cache_directory,
+            "If non-empty, JIT-compiled XLA clusters are serialized into this "
+            "directory and reloaded by later processes, which then skip "
+            "lowering the TensorFlow subgraph to HLO."),
+       Flag("tf_xla_max_compiles_per_cluster",
+            &ops_flags->tf_xla_max_compiles_per_cluster,
+            "If > 0, auto-clustered XLA clusters are compiled for at most this "
+            "many distinct input signatures; other signatures run in the TF "
+            "executor."),
+       Flag("tf_xla_batch_buckets", &ops_flags->tf_xla_batch_buckets,
+            "Comma-separated sizes, or \"pow2\". If set, XlaLaunch pads the "
+            "leading dimension of its inputs up to the next bucket size and "
+            "slices the outputs back, compiling once per bucket. Only valid "
+            "for computations that treat the leading dimension as an "
+            "independent batch dimension."),
+       Flag("tf_xla_async_compilation_threads",
+            &ops_flags->tf_xla_async_compilation_threads,
+            "If > 0, _XlaCompile compiles new signatures of a cluster on this "
+            "many background threads and runs the cluster in the TF executor "
+            "until the executable is ready."),
+       Flag("tf_xla_max_pending_async_compiles",
+            &ops_flags->tf_xla_max_pending_async_compiles,
+            "The maximum number of background XLA compilations queued or "
+            "running at once."),
 
        Flag("tf_introduce_floating_point_jitter_to_tensors",
             setter_for_jitter_tensor_names, "",
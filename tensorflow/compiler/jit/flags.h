@@ -56,6 +56,11 @@ struct MarkForCompilationPassFlags {
   // Maximum number of operators in an XLA compilation.
   int32 tf_xla_max_cluster_size;
 
+  // If true, clusters whose estimated benefit does not pay for the cluster
+  // launch and for the tensors crossing the cluster boundary are not
+  // compiled.  Ignored for operators explicitly marked for compilation.
+  bool tf_xla_cluster_cost_model;
+
   // If non-empty, limit XLA clustering to the following TF operations.
   string tf_xla_ops_to_cluster;
 
@@ -98,6 +103,27 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile always refuses to compile the cluster, which means the
   // XLA clusters always run in the TF executor.  Defaults to false.
   bool tf_xla_always_defer_compilation;
+
+  // If non-empty, the directory in which XLA compilation caches persist
+  // lowered clusters across process restarts.
+  string tf_xla_persistent_cache_directory;
+
+  // If > 0, the number of distinct signatures of a cluster that _XlaCompile
+  // compiles. Further signatures run the cluster in the TF executor.
+  int64 tf_xla_max_compiles_per_cluster;
+
+  // If non-empty, XlaLaunch pads the leading dimension of its batched inputs
+  // up to the next of these sizes and slices it off the outputs again, so that
+  // a cluster is compiled once per bucket instead of once per batch size.
+  // Either a comma-separated list of sizes or "pow2" for powers of two.
+  string tf_xla_batch_buckets;
+
+  // If > 0, _XlaCompile compiles new signatures on this many background
+  // threads and runs the cluster in the TF executor until they are ready.
+  int32 tf_xla_async_compilation_threads;
+
+  // The maximum number of background compilations queued or running at once.
+  int32 tf_xla_max_pending_async_compiles;
 };
 
 // Flags for the build_xla_ops pass.
@@ -15,8 +15,14 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/kernels/xla_ops.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 #include "tensorflow/compiler/jit/defs.h"
 #include "tensorflow/compiler/jit/encapsulate_subgraphs_pass.h"
 #include "tensorflow/compiler/jit/flags.h"
@@ -147,6 +153,124 @@ class XlaExecutableClosureStore {
   TF_DISALLOW_COPY_AND_ASSIGN(XlaExecutableClosureStore);
 };
 
+// Returns the bucket that a leading dimension of size `batch_size` is padded to
+// under --tf_xla_batch_buckets, or `batch_size` if it is larger than all
+// buckets.
+int64 BatchBucket(int64 batch_size) {
+  static const std::vector<int64>* buckets = [] {
+    auto* buckets = new std::vector<int64>;
+    const string& spec = GetXlaOpsCommonFlags().tf_xla_batch_buckets;
+    if (spec == "pow2") {
+      for (int64 bucket = 1; bucket <= (int64{1} << 40); bucket *= 2) {
+        buckets->push_back(bucket);
+      }
+      return buckets;
+    }
+    for (absl::string_view size :
+         absl::StrSplit(spec, ',', absl::SkipEmpty())) {
+      int64 bucket;
+      if (absl::SimpleAtoi(size, &bucket) && bucket > 0) {
+        buckets->push_back(bucket);
+      } else {
+        LOG(ERROR) << "Ignoring invalid --tf_xla_batch_buckets entry: " << size;
+      }
+    }
+    std::sort(buckets->begin(), buckets->end());
+    return buckets;
+  }();
+  auto it = std::lower_bound(buckets->begin(), buckets->end(), batch_size);
+  return it == buckets->end() ? batch_size : *it;
+}
+
+// Copies `input` into a new tensor whose leading dimension is `bucket`, with
+// zeros in the padding rows. The rows of a row-major tensor are contiguous, so
+// this is one copy of `input` and one memset.
+Status PadLeadingDimension(OpKernelContext* ctx, const Tensor& input,
+                           int64 bucket, Tensor* padded) {
+  TensorShape shape = input.shape();
+  shape.set_dim(0, bucket);
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(input.dtype(), shape, padded));
+  const uint64 size = input.TotalBytes();
+  const uint64 padding = padded->TotalBytes() - size;
+  char* dst = const_cast<char*>(padded->tensor_data().data());
+  se::Stream* stream =
+      ctx->op_device_context() ? ctx->op_device_context()->stream() : nullptr;
+  if (stream == nullptr) {
+    if (size > 0) std::memcpy(dst, input.tensor_data().data(), size);
+    std::memset(dst + size, 0, padding);
+    return Status::OK();
+  }
+  if (size > 0) {
+    se::DeviceMemoryBase src(const_cast<char*>(input.tensor_data().data()),
+                             size);
+    se::DeviceMemoryBase dst_mem(dst, size);
+    stream->ThenMemcpy(&dst_mem, src, size);
+  }
+  se::DeviceMemoryBase padding_mem(dst + size, padding);
+  stream->ThenMemZero(&padding_mem, padding);
+  return stream->ok() ? Status::OK()
+                      : errors::Internal("Failed to pad XlaLaunch input");
+}
+
+// Under --tf_xla_batch_buckets, replaces the batched inputs in `inputs` with
+// copies padded to the bucket of the batch size, which is the leading
+// dimension of the first non-constant, non-resource input. Every such input
+// with the same leading dimension is treated as batched. Sets `*batch_size`
+// and `*bucket`, which are equal if nothing was padded.
+Status PadBatchedInputs(OpKernelContext* ctx, absl::Span<const int> constants,
+                        absl::Span<const int> resources,
+                        std::vector<const Tensor*>* inputs,
+                        std::vector<Tensor>* padded_inputs, int64* batch_size,
+                        int64* bucket) {
+  *batch_size = *bucket = -1;
+  std::vector<int> batched;
+  for (int i = 0; i < inputs->size(); ++i) {
+    if (absl::c_linear_search(constants, i) ||
+        absl::c_linear_search(resources, i)) {
+      continue;
+    }
+    const Tensor& input = *(*inputs)[i];
+    if (input.dims() == 0) continue;
+    if (*batch_size < 0) *batch_size = input.dim_size(0);
+    if (input.dim_size(0) != *batch_size) continue;
+    // Only plain buffers can be padded with a copy.
+    if (!DataTypeCanUseMemcpy(input.dtype())) {
+      *bucket = *batch_size;
+      return Status::OK();
+    }
+    batched.push_back(i);
+  }
+  *bucket = *batch_size < 0 ? *batch_size : BatchBucket(*batch_size);
+  if (*bucket == *batch_size) return Status::OK();
+
+  VLOG(2) << "Padding XlaLaunch batch of " << *batch_size << " to " << *bucket;
+  padded_inputs->resize(batched.size());
+  for (int j = 0; j < batched.size(); ++j) {
+    const int i = batched[j];
+    TF_RETURN_IF_ERROR(PadLeadingDimension(ctx, *(*inputs)[i], *bucket,
+                                           &(*padded_inputs)[j]));
+    (*inputs)[i] = &(*padded_inputs)[j];
+  }
+  return Status::OK();
+}
+
+// Slices the padding rows of a bucketed batch off the outputs of `ctx`.
+void SliceBatchedOutputs(OpKernelContext* ctx, int64 batch_size,
+                         int64 bucket) {
+  for (int i = 0; i < ctx->num_outputs(); ++i) {
+    if (IsRefType(ctx->expected_output_dtype(i))) continue;
+    const Tensor* output = ctx->mutable_output(i);
+    if (output == nullptr || output->dims() == 0 ||
+        output->dim_size(0) != bucket) {
+      continue;
+    }
+    TensorValue value = ctx->release_output(i);
+    Tensor sliced = value.tensor->Slice(0, batch_size);
+    delete value.tensor;
+    ctx->set_output(i, std::move(sliced));
+  }
+}
+
 }  // namespace
 
 XlaLocalLaunchBase::XlaLocalLaunchBase(OpKernelConstruction* ctx,
@@ -166,7 +290,9 @@ static Status CompileToLocalExecutable(
     const XlaPlatformInfo& platform_info,
     absl::Span<const Tensor* const> inputs,
     absl::Span<VariableInfo const> variable_infos,
-    absl::Span<const int> constants, bool lazy, bool may_alias_resource_update,
+    absl::Span<const int> constants,
+    XlaCompilationCache::CompileMode compile_mode,
+    bool may_alias_resource_update,
     xla::LocalClient** client,
     const XlaCompiler::CompilationResult** compilation_result,
     xla::LocalExecutable** executable) {
@@ -211,9 +337,7 @@ static Status CompileToLocalExecutable(
           static_cast<Device*>(ctx->device()));
   TF_RETURN_IF_ERROR(args.status());
   return cache->Compile(options, function, *args, compile_options,
-                        lazy ? XlaCompilationCache::CompileMode::kLazy
-                             : XlaCompilationCache::CompileMode::kStrict,
-                        compilation_result, executable);
+                        compile_mode, compilation_result, executable);
 }
 
 void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
@@ -225,6 +349,16 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
   const XlaCompiler::CompilationResult* compilation_result;
   xla::LocalExecutable* executable;
 
+  // Padded copies of the batched inputs, under --tf_xla_batch_buckets.
+  std::vector<Tensor> padded_inputs;
+  int64 batch_size = -1;
+  int64 bucket = -1;
+  if (!GetXlaOpsCommonFlags().tf_xla_batch_buckets.empty() &&
+      !platform_info_.is_on_xla_device()) {
+    OP_REQUIRES_OK(ctx, PadBatchedInputs(ctx, constants_, resources_, &inputs,
+                                         &padded_inputs, &batch_size, &bucket));
+  }
+
   std::vector<VariableInfo> variable_infos;
   {
     OP_REQUIRES_OK(
@@ -233,7 +367,7 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
     OP_REQUIRES_OK(ctx, LockVariables(absl::MakeSpan(variable_infos)));
     Status s = CompileToLocalExecutable(
         ctx, function_, /*has_ref_vars=*/has_ref_vars_, platform_info_, inputs,
-        variable_infos, constants_, /*lazy=*/false,
+        variable_infos, constants_, XlaCompilationCache::CompileMode::kStrict,
         /*may_alias_resource_update=*/true, &client, &compilation_result,
         &executable);
     OP_REQUIRES_OK(ctx, s);
@@ -263,7 +397,7 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
   xla::StatusOr<std::vector<xla::ExecutionInput>> execution_inputs =
       launch_context.PopulateInputs(ctx, compilation_result, resource_var_ptrs,
                                     /*missing_ctx_input_prefix=*/0,
-                                    input_output_alias);
+                                    input_output_alias, inputs);
   OP_REQUIRES_OK(ctx, execution_inputs.status());
 
   // Execute the computation.
@@ -293,6 +427,9 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
                ctx, compilation_result, execution_output->ConsumeResult(),
                /*missing_ctx_input_prefix=*/0, absl::MakeSpan(variable_infos),
                input_output_alias, resource_var_ptrs));
+  if (bucket != batch_size) {
+    SliceBatchedOutputs(ctx, batch_size, bucket);
+  }
 
   VLOG(1) << "Done";
 }
@@ -392,12 +529,22 @@ void XlaCompileOp::Compute(OpKernelContext* ctx) {
                                         inputs, resources_, &variable_infos));
     OP_REQUIRES_OK(ctx, LockVariables(absl::MakeSpan(variable_infos)));
 
+    // With async compilation, new signatures compile in the background and the
+    // cluster runs in the TF executor until its executable is ready.
+    XlaCompilationCache::CompileMode compile_mode =
+        XlaCompilationCache::CompileMode::kStrict;
+    if (!must_compile_) {
+      compile_mode =
+          GetXlaOpsCommonFlags().tf_xla_async_compilation_threads > 0
+              ? XlaCompilationCache::CompileMode::kAsync
+              : XlaCompilationCache::CompileMode::kLazy;
+    }
+
     // Do not alias resource updates as locking variables in XlaCompile and
     // unlocking them in XlaRun may lead to deadlocks.
     Status status = CompileToLocalExecutable(
         ctx, function_, has_ref_vars_, platform_info_, inputs, variable_infos,
-        constants_,
-        /*lazy=*/!must_compile_,
+        constants_, compile_mode,
         /*may_alias_resource_update=*/false, &client, &kernel, &executable);
     OP_REQUIRES_OK(ctx, SnapshotResourceVariables(ctx, resources_,
                                                   variable_infos, &variables));
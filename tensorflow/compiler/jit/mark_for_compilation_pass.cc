@@ -31,6 +31,7 @@ limitations under the License.
 #include "tensorflow/compiler/jit/device_util.h"
 #include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/resource_operation_safety_analysis.h"
+#include "tensorflow/compiler/jit/xla_activity_listener.h"
 #include "tensorflow/compiler/jit/xla_cluster_util.h"
 #include "tensorflow/compiler/tf2xla/const_analysis.h"
 #include "tensorflow/compiler/tf2xla/resource_operation_table.h"
@@ -95,6 +96,10 @@ class MarkForCompilationPassImpl {
     int max_cluster_size;
     int min_cluster_size;
 
+    // If true, do not compile clusters that the cost model in
+    // `FindUnprofitableClusters` deems not worth their launch overhead.
+    bool use_cluster_cost_model;
+
     // Compiler fuel for the auto-clustering algorithm.
     //
     // We decrement this value by one on every time we choose a compilation
@@ -279,6 +284,17 @@ class MarkForCompilationPassImpl {
   // tf_xla_min_cluster_size, are applied here.
   Status CreateClusters();
 
+  // Returns the clusters whose estimated benefit from compilation is smaller
+  // than the overhead of launching them and of moving tensors across their
+  // boundary, and broadcasts an UNPROFITABLE_CLUSTER remark for each.
+  //
+  // The estimate is deliberately coarse: every clustered op saves one TF
+  // kernel launch, every data edge internal to the cluster saves half a
+  // launch worth of memory traffic, while the cluster itself costs a few
+  // launches plus one unit per data edge crossing its boundary and more if
+  // the edge also crosses devices.
+  absl::flat_hash_set<const Cluster*> FindUnprofitableClusters();
+
   Status DumpDebugInfo();
 
   bool IsCompilationCandidate(Node* n) const {
@@ -855,12 +871,17 @@ Status MarkForCompilationPassImpl::CreateClusters() {
     DumpGraphToFile("before_mark_for_compilation", *graph_, flib_def_);
   }
 
+  absl::flat_hash_set<const Cluster*> unprofitable_clusters;
+  if (debug_options_.use_cluster_cost_model) {
+    unprofitable_clusters = FindUnprofitableClusters();
+  }
+
   // Mark clusters for compilation that:
   // * are placed on a device that requires compilation (an XlaDevice),
   // * are explicitly marked for compilation (_XlaCompile=true), or
   // * have more than debug_options_.xla_min_cluster_size elements (applicable
   //   only if compilation is enabled, otherwise there will be no such
-  //   candidates).
+  //   candidates) and are not deemed unprofitable by the cluster cost model.
   for (Node* n : compilation_candidates_) {
     Cluster* cluster = GetClusterForNode(n);
     TF_ASSIGN_OR_RETURN(bool should_compile_cluster,
@@ -874,7 +895,8 @@ Status MarkForCompilationPassImpl::CreateClusters() {
     // to (recursively) verify this fact, but that's probably not worth the
     // trouble.
 
-    if (cluster->effective_cluster_size() >= debug_options_.min_cluster_size ||
+    if ((cluster->effective_cluster_size() >= debug_options_.min_cluster_size &&
+         !unprofitable_clusters.contains(cluster)) ||
         cluster->has_functional_control_flow() ||
         cluster->is_xla_compile_attr_true()) {
       string& name = cluster_names[cluster->cycles_graph_node_id()];
@@ -892,6 +914,78 @@ Status MarkForCompilationPassImpl::CreateClusters() {
   return Status::OK();
 }
 
+absl::flat_hash_set<const MarkForCompilationPassImpl::Cluster*>
+MarkForCompilationPassImpl::FindUnprofitableClusters() {
+  // Costs are in units of one TF kernel launch.
+  constexpr double kBenefitPerOp = 1.0;
+  constexpr double kBenefitPerInternalEdge = 0.5;
+  constexpr double kClusterLaunchCost = 3.0;
+  constexpr double kCostPerBoundaryEdge = 0.5;
+  constexpr double kCostPerCrossDeviceEdge = 2.0;
+
+  struct EdgeCounts {
+    int internal = 0;
+    int boundary = 0;
+    int cross_device = 0;
+  };
+  absl::flat_hash_map<const Cluster*, EdgeCounts> edge_counts;
+
+  for (const Edge* e : graph_->edges()) {
+    if (e->IsControlEdge()) {
+      continue;
+    }
+    Cluster* src_cluster = GetClusterForNode(e->src());
+    Cluster* dst_cluster = GetClusterForNode(e->dst());
+    if (src_cluster == dst_cluster) {
+      if (src_cluster != nullptr) {
+        edge_counts[src_cluster].internal++;
+      }
+      continue;
+    }
+    bool crosses_devices =
+        e->src()->assigned_device_name() != e->dst()->assigned_device_name();
+    for (Cluster* cluster : {src_cluster, dst_cluster}) {
+      if (cluster != nullptr) {
+        EdgeCounts& counts = edge_counts[cluster];
+        counts.boundary++;
+        counts.cross_device += crosses_devices;
+      }
+    }
+  }
+
+  absl::flat_hash_set<const Cluster*> unprofitable_clusters;
+  for (const auto& cluster_and_counts : edge_counts) {
+    const Cluster* cluster = cluster_and_counts.first;
+    const EdgeCounts& counts = cluster_and_counts.second;
+    if (cluster->has_functional_control_flow() ||
+        cluster->is_xla_compile_attr_true()) {
+      continue;
+    }
+
+    double benefit = kBenefitPerOp * (cluster->effective_cluster_size() - 1) +
+                     kBenefitPerInternalEdge * counts.internal;
+    double overhead = kClusterLaunchCost +
+                      kCostPerBoundaryEdge * counts.boundary +
+                      kCostPerCrossDeviceEdge * counts.cross_device;
+    if (benefit >= overhead) {
+      continue;
+    }
+
+    unprofitable_clusters.insert(cluster);
+    string details = absl::StrCat(
+        "Not compiling ", cluster->DebugString(*graph_),
+        ": estimated benefit ", benefit, " is below the estimated overhead ",
+        overhead, " (", counts.boundary, " boundary edges, ",
+        counts.cross_device, " crossing devices)");
+    VLOG(2) << details;
+    BroadcastOptimizationRemark(XlaOptimizationRemark::UNPROFITABLE_CLUSTER,
+                                std::move(details))
+        .IgnoreError();
+  }
+
+  return unprofitable_clusters;
+}
+
 Status MarkForCompilationPassImpl::DumpDebugInfo() {
   TF_RET_CHECK(initialized_ && edges_contracted_ && clusters_created_);
 
@@ -1734,6 +1828,7 @@ Status MarkForCompilationPass::Run(
   debug_options.ignore_xla_compile_attr = false;
   debug_options.max_cluster_size = flags->tf_xla_max_cluster_size;
   debug_options.min_cluster_size = flags->tf_xla_min_cluster_size;
+  debug_options.use_cluster_cost_model = flags->tf_xla_cluster_cost_model;
   debug_options.fuel = GetPointerToFuel(flags->tf_xla_clustering_fuel);
   debug_options.dump_graphs = flags->tf_xla_clustering_debug;
 
@@ -1752,6 +1847,7 @@ Status MarkForCompilationPass::RunForTest(
   debug_options.ignore_xla_compile_attr = true;
   debug_options.max_cluster_size = flags->tf_xla_max_cluster_size;
   debug_options.min_cluster_size = flags->tf_xla_min_cluster_size;
+  debug_options.use_cluster_cost_model = flags->tf_xla_cluster_cost_model;
   debug_options.fuel = GetPointerToFuel(flags->tf_xla_clustering_fuel);
   debug_options.dump_graphs = flags->tf_xla_clustering_debug;
 
@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/cc/ops/sendrecv_ops.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/compiler/jit/defs.h"
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/mark_for_compilation_pass_test_helper.h"
 #include "tensorflow/compiler/jit/node_matchers.h"
 #include "tensorflow/compiler/tf2xla/xla_op_kernel.h"
@@ -37,6 +38,7 @@ limitations under the License.
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph_def_builder.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/test.h"
 
 using ::tensorflow::testing::FindNodeByName;
@@ -115,6 +117,45 @@ TEST(XlaCompilationTest, Chains) {
   EXPECT_TRUE(clusters.find("D") == clusters.cend());
 }
 
+TEST(XlaCompilationTest, ClusterCostModel) {
+  std::unique_ptr<Graph> graph(new Graph(OpRegistry::Global()));
+  {
+    GraphDefBuilder builder(GraphDefBuilder::kFailImmediately);
+    // A chain with a single input and output is worth compiling.
+    Node* a =
+        ops::SourceOp("UncompilableNullary", builder.opts().WithName("A"));
+    Node* b = ops::UnaryOp("Relu", a, builder.opts().WithName("B"));
+    Node* c = ops::UnaryOp("Relu", b, builder.opts().WithName("C"));
+    Node* d = ops::UnaryOp("Relu", c, builder.opts().WithName("D"));
+    Node* e = ops::UnaryOp("Relu", d, builder.opts().WithName("E"));
+    Node* f = ops::UnaryOp("Relu", e, builder.opts().WithName("F"));
+    ops::UnaryOp("UncompilableUnary", f, builder.opts().WithName("G"));
+
+    // A cluster of similar size with many inputs is not.
+    Node* p =
+        ops::SourceOp("UncompilableNullary", builder.opts().WithName("P"));
+    Node* q = ops::BinaryOp("Add", p, p, builder.opts().WithName("Q"));
+    Node* r = ops::BinaryOp("Add", q, p, builder.opts().WithName("R"));
+    Node* s = ops::BinaryOp("Add", r, p, builder.opts().WithName("S"));
+    Node* t = ops::BinaryOp("Add", s, p, builder.opts().WithName("T"));
+    ops::UnaryOp("UncompilableUnary", t, builder.opts().WithName("U"));
+    TF_EXPECT_OK(GraphDefBuilderToGraph(builder, graph.get()));
+  }
+
+  MarkForCompilationPassFlags* flags = GetMarkForCompilationPassFlags();
+  const bool old_cluster_cost_model = flags->tf_xla_cluster_cost_model;
+  flags->tf_xla_cluster_cost_model = true;
+  auto restore_flag = gtl::MakeCleanup(
+      [&] { flags->tf_xla_cluster_cost_model = old_cluster_cost_model; });
+
+  TF_ASSERT_OK(MarkForCompilationPassTestHelper::MarkForCompilation(&graph));
+  auto clusters = GetClusters(*graph);
+  EXPECT_EQ(5, clusters.size());
+  EXPECT_EQ(clusters["B"], clusters["F"]);
+  EXPECT_TRUE(clusters.find("Q") == clusters.cend());
+  EXPECT_TRUE(clusters.find("T") == clusters.cend());
+}
+
 TEST(XlaCompilationTest, UncompilableCycles) {
   std::unique_ptr<Graph> graph(new Graph(OpRegistry::Global()));
   {
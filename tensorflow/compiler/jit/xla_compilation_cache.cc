@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/xla_compilation_cache.h"
 
+#include <map>
 #include <numeric>
 
 #include "tensorflow/compiler/mlir/mlir_bridge_rollout_policy.h"
@@ -24,6 +25,7 @@ limitations under the License.
 #include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/xla_activity.pb.h"
 #include "tensorflow/compiler/jit/xla_activity_listener.h"
+#include "tensorflow/compiler/jit/xla_compilation_cache.pb.h"
 #include "tensorflow/compiler/mlir/tensorflow/utils/compile_mlir_util.h"
 #include "tensorflow/compiler/mlir/utils/array_container_utils.h"
 #include "tensorflow/compiler/tf2xla/shape_util.h"
@@ -43,8 +45,11 @@ limitations under the License.
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/protobuf/graph_debug_info.pb.h"
 #include "tensorflow/core/public/version.h"
@@ -56,9 +61,23 @@ constexpr int64 XlaCompilationCache::kDefaultCompilationThreshold;
 
 XlaCompilationCache::XlaCompilationCache(xla::LocalClient* client,
                                          DeviceType device_type)
-    : client_(client), device_type_(std::move(device_type)) {}
+    : XlaCompilationCache(Config(), client, std::move(device_type)) {}
+
+XlaCompilationCache::XlaCompilationCache(Config config,
+                                         xla::LocalClient* client,
+                                         DeviceType device_type)
+    : config_(std::move(config)),
+      client_(client),
+      device_type_(std::move(device_type)) {
+  if (config_.async_compile_threads > 0) {
+    async_compile_pool_ = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "xla_async_compile", config_.async_compile_threads);
+  }
+}
 
 XlaCompilationCache::~XlaCompilationCache() {
+  // Wait for background compilations, which write into the cache entries.
+  async_compile_pool_.reset();
   // Ensure any use of our programs have completed by waiting for all stream
   // executors to complete.
   for (auto* executor : client_->backend().stream_executors()) {
@@ -182,6 +201,186 @@ Status XlaCompilationCache::BuildExecutable(
   return Status::OK();
 }
 
+namespace {
+
+XlaSerializedCompilationResult SerializeCompilationResult(
+    const string& signature, const XlaCompiler::CompilationResult& result) {
+  XlaSerializedCompilationResult proto;
+  proto.set_signature(signature);
+  for (int index : result.input_mapping) {
+    proto.add_input_mapping(index);
+  }
+  for (const xla::Shape& shape : result.xla_input_shapes) {
+    *proto.add_xla_input_shapes() = shape.ToProto();
+  }
+  *proto.mutable_xla_output_shape() = result.xla_output_shape.ToProto();
+  for (const XlaOutputDescription& output : result.outputs) {
+    auto* output_proto = proto.add_outputs();
+    output_proto->set_type(output.type);
+    output.shape.AsProto(output_proto->mutable_shape());
+    output_proto->set_is_constant(output.is_constant);
+    if (output.is_constant) {
+      output.constant_value.AsProtoTensorContent(
+          output_proto->mutable_constant_value());
+    }
+    output_proto->set_input_index(output.input_index);
+    output_proto->set_is_tensor_list(output.is_tensor_list);
+  }
+  *proto.mutable_host_compute_metadata() = result.host_compute_metadata;
+  for (const XlaResourceUpdate& update : result.resource_updates) {
+    auto* update_proto = proto.add_resource_updates();
+    update_proto->set_input_index(update.input_index);
+    update_proto->set_type(update.type);
+    update.shape.AsProto(update_proto->mutable_shape());
+    update_proto->set_modified(update.modified);
+    for (const string& gradient : update.tensor_array_gradients_accessed) {
+      update_proto->add_tensor_array_gradients_accessed(gradient);
+    }
+  }
+  *proto.mutable_computation() = result.computation->proto();
+  return proto;
+}
+
+Status DeserializeCompilationResult(const XlaSerializedCompilationResult& proto,
+                                    XlaCompiler::CompilationResult* result) {
+  result->input_mapping.assign(proto.input_mapping().begin(),
+                               proto.input_mapping().end());
+  result->xla_input_shapes.clear();
+  for (const xla::ShapeProto& shape : proto.xla_input_shapes()) {
+    result->xla_input_shapes.emplace_back(shape);
+  }
+  result->xla_output_shape = xla::Shape(proto.xla_output_shape());
+  result->outputs.clear();
+  for (const auto& output_proto : proto.outputs()) {
+    XlaOutputDescription output;
+    output.type = output_proto.type();
+    TF_RETURN_IF_ERROR(TensorShape::IsValidShape(output_proto.shape()));
+    output.shape = TensorShape(output_proto.shape());
+    output.is_constant = output_proto.is_constant();
+    if (output.is_constant &&
+        !output.constant_value.FromProto(output_proto.constant_value())) {
+      return errors::DataLoss("Invalid constant output in cache entry");
+    }
+    output.input_index = output_proto.input_index();
+    output.is_tensor_list = output_proto.is_tensor_list();
+    result->outputs.push_back(std::move(output));
+  }
+  result->host_compute_metadata = proto.host_compute_metadata();
+  result->resource_updates.clear();
+  for (const auto& update_proto : proto.resource_updates()) {
+    XlaResourceUpdate update;
+    update.input_index = update_proto.input_index();
+    update.type = update_proto.type();
+    TF_RETURN_IF_ERROR(TensorShape::IsValidShape(update_proto.shape()));
+    update.shape = TensorShape(update_proto.shape());
+    update.modified = update_proto.modified();
+    update.tensor_array_gradients_accessed.insert(
+        update_proto.tensor_array_gradients_accessed().begin(),
+        update_proto.tensor_array_gradients_accessed().end());
+    result->resource_updates.push_back(std::move(update));
+  }
+  result->computation =
+      std::make_shared<xla::XlaComputation>(proto.computation());
+  return Status::OK();
+}
+
+}  // namespace
+
+string XlaCompilationCache::GetPersistentCacheFilePath(
+    const XlaCompiler::Options& options,
+    const XlaCompiler::CompileOptions& compile_options,
+    const NameAttrList& function, const Signature& signature) const {
+  uint64 fingerprint = Fingerprint64(signature.name);
+  for (const auto& arg : signature.arg_shapes) {
+    fingerprint = FingerprintCat64(fingerprint, arg.first);
+    for (int64 dim : arg.second) {
+      fingerprint = FingerprintCat64(fingerprint, dim);
+    }
+  }
+  for (const Tensor& arg : signature.arg_values) {
+    fingerprint = FingerprintCat64(fingerprint, arg.dtype());
+    fingerprint =
+        FingerprintCat64(fingerprint, Fingerprint64(arg.shape().DebugString()));
+    fingerprint =
+        FingerprintCat64(fingerprint, Fingerprint64(arg.tensor_data()));
+  }
+
+  // The signature only names the function, so the key also has to cover its
+  // body and everything it calls. The library is keyed by function name to
+  // make the result independent of the library's iteration order.
+  const FunctionDef* fdef =
+      options.flib_def ? options.flib_def->Find(function.name()) : nullptr;
+  if (fdef != nullptr) {
+    std::map<string, const FunctionDef*> functions;
+    FunctionDefLibrary reachable =
+        options.flib_def->ReachableDefinitions(*fdef).ToProto();
+    for (const FunctionDef& f : reachable.function()) {
+      functions[f.signature().name()] = &f;
+    }
+    functions[function.name()] = fdef;
+    for (const auto& name_and_function : functions) {
+      string serialized;
+      SerializeToStringDeterministic(*name_and_function.second, &serialized);
+      fingerprint = FingerprintCat64(fingerprint, Fingerprint64(serialized));
+    }
+  }
+
+  fingerprint = FingerprintCat64(
+      fingerprint,
+      Fingerprint64(absl::StrCat(
+          device_type_.type_string(), ",", client_->platform()->Name(), ",",
+          TF_VERSION_STRING, ",", tf_git_version(), ",",
+          options.allow_cpu_custom_calls, options.alias_passthrough_params,
+          compile_options.use_tuple_arg,
+          compile_options.return_updated_values_for_all_resources,
+          compile_options.always_return_tuple,
+          compile_options.is_entry_computation,
+          compile_options.add_token_input_output,
+          compile_options.alias_resource_update)));
+
+  return io::JoinPath(
+      config_.persistent_cache_directory,
+      absl::StrCat(device_type_.type_string(), "_",
+                   absl::Hex(fingerprint, absl::kZeroPad16), ".pb"));
+}
+
+Status XlaCompilationCache::LoadFromPersistentCache(
+    const string& path, const Signature& signature,
+    XlaCompiler::CompilationResult* result) const {
+  Env* env = Env::Default();
+  if (!env->FileExists(path).ok()) {
+    return errors::NotFound("No persistent compilation cache entry at ", path);
+  }
+  XlaSerializedCompilationResult proto;
+  TF_RETURN_IF_ERROR(ReadBinaryProto(env, path, &proto));
+  if (proto.signature() != signature.HumanString()) {
+    return errors::DataLoss("Persistent compilation cache entry ", path,
+                            " does not match signature ",
+                            signature.HumanString());
+  }
+  return DeserializeCompilationResult(proto, result);
+}
+
+Status XlaCompilationCache::SaveToPersistentCache(
+    const string& path, const Signature& signature,
+    const XlaCompiler::CompilationResult& result) const {
+  if (result.computation == nullptr) {
+    return errors::FailedPrecondition("No XLA computation to serialize");
+  }
+  Env* env = Env::Default();
+  TF_RETURN_IF_ERROR(
+      env->RecursivelyCreateDir(config_.persistent_cache_directory));
+  string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return errors::Internal("Could not create a temporary file name for ",
+                            path);
+  }
+  TF_RETURN_IF_ERROR(WriteBinaryProto(
+      env, tmp_path,
+      SerializeCompilationResult(signature.HumanString(), result)));
+  return env->RenameFile(tmp_path, path);
+}
+
 Status XlaCompilationCache::Compile(
     const XlaCompiler::Options& options, const NameAttrList& function,
     absl::Span<const XlaCompiler::Argument> args,
@@ -190,15 +389,21 @@ Status XlaCompilationCache::Compile(
     const XlaCompiler::CompilationResult** out_compilation_result,
     xla::LocalExecutable** out_executable) {
   absl::optional<int64> compile_threshold;
-  if (compile_mode == CompileMode::kLazy) {
+  const bool compile_async =
+      compile_mode == CompileMode::kAsync && async_compile_pool_ != nullptr;
+  if (compile_async) {
+    // Background compilation does not stall the caller, so it can start on
+    // the first request.
+    compile_threshold = 1;
+  } else if (compile_mode != CompileMode::kStrict) {
     compile_threshold = kDefaultCompilationThreshold;
   }
   auto compile_fn = [&](XlaCompiler* compiler,
                         XlaCompiler::CompilationResult* result) {
     return compiler->CompileFunction(compile_options, function, args, result);
   };
-  return CompileImpl(options, function, args, compile_fn,
-                     /*compile_threshold=*/compile_threshold,
+  return CompileImpl(options, function, args, compile_options, compile_fn,
+                     /*compile_threshold=*/compile_threshold, compile_async,
                      out_compilation_result, out_executable);
 }
 
@@ -305,9 +510,10 @@ Status XlaCompilationCache::CompileSingleOp(
         options.device_type.type_string(), compile_options.use_tuple_arg,
         *options.flib_def, debug_info, options.shape_representation_fn, result);
   };
-  return CompileImpl(options, name, args, compile_op,
+  return CompileImpl(options, name, args, compile_options, compile_op,
                      /*compile_threshold=*/absl::nullopt,
-                     out_compilation_result, out_executable);
+                     /*compile_async=*/false, out_compilation_result,
+                     out_executable);
 }
 
 namespace {
@@ -327,9 +533,10 @@ void LogOnceXlaCompiledFirstCluster() {
 Status XlaCompilationCache::CompileImpl(
     const XlaCompiler::Options& options, const NameAttrList& function,
     absl::Span<const XlaCompiler::Argument> args,
+    const XlaCompiler::CompileOptions& compile_options,
     const std::function<Status(XlaCompiler* compiler,
                                XlaCompiler::CompilationResult*)>& compile_fn,
-    absl::optional<int64> compile_threshold,
+    absl::optional<int64> compile_threshold, bool compile_async,
     const XlaCompiler::CompilationResult** out_compilation_result,
     xla::LocalExecutable** out_executable) {
   if (FailOnXlaCompilation()) {
@@ -373,6 +580,9 @@ Status XlaCompilationCache::CompileImpl(
   // excessive amount of shape dynamism.
   bool is_megamorphic;
 
+  // Number of signatures of the cluster compiled so far.
+  int64 compile_count;
+
   {
     mutex_lock lock(cluster_compile_stats_mu_);
     auto it =
@@ -392,6 +602,7 @@ Status XlaCompilationCache::CompileImpl(
     }
 
     is_megamorphic = it->second.is_megamorphic;
+    compile_count = it->second.compile_count;
   }
 
   // Acquire the cache entry lock and compile, if necessary.
@@ -403,6 +614,19 @@ Status XlaCompilationCache::CompileImpl(
           << " signature: " << signature.HumanString() << " with request count "
           << current_request_count << " and compile threshold "
           << compile_threshold.value_or(0);
+  if (entry->compiling) {
+    if (compile_threshold.has_value()) {
+      VLOG(2) << "Signature is still compiling in the background: "
+              << signature.HumanString();
+      *out_compilation_result = nullptr;
+      *out_executable = nullptr;
+      return Status::OK();
+    }
+    // Strict compilation cannot fall back, so it waits for the result.
+    while (entry->compiling) {
+      entry->compiling_done.wait(entry_lock);
+    }
+  }
   if (!entry->compiled) {
     XLA_SCOPED_LOGGING_TIMER("Compilation of XLA executable");
     const bool should_compile = [&] {
@@ -420,6 +644,14 @@ Status XlaCompilationCache::CompileImpl(
         return false;
       }
 
+      if (config_.max_compiles_per_cluster > 0 &&
+          compile_count >= config_.max_compiles_per_cluster) {
+        VLOG(3) << "Not compiling cluster " << function.name()
+                << " because it has used its budget of "
+                << config_.max_compiles_per_cluster << " compilations.";
+        return false;
+      }
+
       if (is_first_execution) {
         return true;
       }
@@ -443,52 +675,24 @@ Status XlaCompilationCache::CompileImpl(
       return Status::OK();
     }
 
-    tensorflow::Env* env = tensorflow::Env::Default();
-    const uint64 compile_start_us = env->NowMicros();
-    // Do the actual JIT compilation without holding the lock (it can take
-    // a long time.)
+    if (compile_async) {
+      if (!ScheduleAsyncCompilation(options, function, args, compile_options,
+                                    signature, entry)) {
+        VLOG(2) << "Not compiling cluster " << function.name()
+                << " because too many compilations are pending.";
+      }
+      *out_compilation_result = nullptr;
+      *out_executable = nullptr;
+      return Status::OK();
+    }
 
-    XlaCompiler compiler(options);
+    const uint64 compile_start_us = Env::Default()->NowMicros();
     entry->compiled = true;
-
     entry->compilation_status =
-        compile_fn(&compiler, &entry->compilation_result);
-    TF_RETURN_IF_ERROR(entry->compilation_status);
-    CHECK_EQ(entry->executable.get(), nullptr);
-    entry->compilation_status =
-        BuildExecutable(options, entry->compilation_result, &entry->executable);
-
-    const uint64 compile_end_us = env->NowMicros();
-    const uint64 compile_time_us = compile_end_us - compile_start_us;
-    metrics::UpdateXlaCompilationTime(compile_time_us);
-    {
-      mutex_lock lock(cluster_compile_stats_mu_);
-      auto it = cluster_compile_stats_.find(function.name());
-      it->second.compile_count++;
-      it->second.cumulative_compile_time_us += compile_time_us;
-      LogOnceXlaCompiledFirstCluster();
-      VLOG(1) << "compiled " << function.name() << " "
-              << it->second.compile_count
-              << " times, compile time: " << compile_time_us
-              << " us, cumulative: " << it->second.cumulative_compile_time_us
-              << " us ("
-              << tensorflow::strings::HumanReadableElapsedTime(compile_time_us /
-                                                               1.0e6)
-              << " / "
-              << tensorflow::strings::HumanReadableElapsedTime(
-                     it->second.cumulative_compile_time_us / 1.0e6)
-              << ")";
-
-      XlaJitCompilationActivity jit_compilation_activity;
-      jit_compilation_activity.set_cluster_name(function.name());
-      jit_compilation_activity.set_compile_count(it->second.compile_count);
-      jit_compilation_activity.set_compile_time_us(compile_time_us);
-      jit_compilation_activity.set_cumulative_compile_time_us(
-          it->second.cumulative_compile_time_us);
-
-      TF_RETURN_IF_ERROR(
-          BroadcastXlaActivity(std::move(jit_compilation_activity)));
-    }
+        CompileAndBuild(options, function, signature, compile_options,
+                        compile_fn, &entry->compilation_result,
+                        &entry->executable);
+    TF_RETURN_IF_ERROR(RecordCompilation(function.name(), compile_start_us));
   }
   TF_RETURN_IF_ERROR(entry->compilation_status);
   *out_compilation_result = &entry->compilation_result;
@@ -496,4 +700,169 @@ Status XlaCompilationCache::CompileImpl(
   return Status::OK();
 }
 
+Status XlaCompilationCache::CompileAndBuild(
+    const XlaCompiler::Options& options, const NameAttrList& function,
+    const Signature& signature,
+    const XlaCompiler::CompileOptions& compile_options,
+    const std::function<Status(XlaCompiler* compiler,
+                               XlaCompiler::CompilationResult*)>& compile_fn,
+    XlaCompiler::CompilationResult* result,
+    std::unique_ptr<xla::LocalExecutable>* executable) {
+  XlaCompiler compiler(options);
+
+  // On a hit in the persistent cache only the XLA executable is rebuilt.
+  string persistent_cache_path;
+  bool loaded_from_persistent_cache = false;
+  if (!config_.persistent_cache_directory.empty()) {
+    persistent_cache_path = GetPersistentCacheFilePath(
+        options, compile_options, function, signature);
+    Status load_status =
+        LoadFromPersistentCache(persistent_cache_path, signature, result);
+    if (load_status.ok()) {
+      VLOG(1) << "Loaded " << function.name()
+              << " from persistent compilation cache entry "
+              << persistent_cache_path;
+      loaded_from_persistent_cache = true;
+    } else if (!errors::IsNotFound(load_status)) {
+      LOG(WARNING) << "Ignoring persistent compilation cache entry: "
+                   << load_status;
+      *result = XlaCompiler::CompilationResult();
+    }
+  }
+
+  if (!loaded_from_persistent_cache) {
+    TF_RETURN_IF_ERROR(compile_fn(&compiler, result));
+  }
+  CHECK_EQ(executable->get(), nullptr);
+  Status status = BuildExecutable(options, *result, executable);
+
+  if (!loaded_from_persistent_cache && !persistent_cache_path.empty() &&
+      status.ok()) {
+    Status save_status =
+        SaveToPersistentCache(persistent_cache_path, signature, *result);
+    if (!save_status.ok()) {
+      LOG(WARNING) << "Failed to write persistent compilation cache entry: "
+                   << save_status;
+    }
+  }
+  return status;
+}
+
+Status XlaCompilationCache::RecordCompilation(const string& function_name,
+                                              uint64 compile_start_us) {
+  const uint64 compile_end_us = Env::Default()->NowMicros();
+  const uint64 compile_time_us = compile_end_us - compile_start_us;
+  metrics::UpdateXlaCompilationTime(compile_time_us);
+
+  mutex_lock lock(cluster_compile_stats_mu_);
+  auto it = cluster_compile_stats_.find(function_name);
+  it->second.compile_count++;
+  it->second.cumulative_compile_time_us += compile_time_us;
+  LogOnceXlaCompiledFirstCluster();
+  VLOG(1) << "compiled " << function_name << " " << it->second.compile_count
+          << " times, compile time: " << compile_time_us
+          << " us, cumulative: " << it->second.cumulative_compile_time_us
+          << " us ("
+          << tensorflow::strings::HumanReadableElapsedTime(compile_time_us /
+                                                           1.0e6)
+          << " / "
+          << tensorflow::strings::HumanReadableElapsedTime(
+                 it->second.cumulative_compile_time_us / 1.0e6)
+          << ")";
+
+  XlaJitCompilationActivity jit_compilation_activity;
+  jit_compilation_activity.set_cluster_name(function_name);
+  jit_compilation_activity.set_compile_count(it->second.compile_count);
+  jit_compilation_activity.set_compile_time_us(compile_time_us);
+  jit_compilation_activity.set_cumulative_compile_time_us(
+      it->second.cumulative_compile_time_us);
+
+  return BroadcastXlaActivity(std::move(jit_compilation_activity));
+}
+
+struct XlaCompilationCache::AsyncCompileRequest {
+  XlaCompiler::Options options;
+  std::unique_ptr<FunctionLibraryDefinition> flib_def;
+  NameAttrList function;
+  std::vector<XlaCompiler::Argument> args;
+  XlaCompiler::CompileOptions compile_options;
+  Signature signature;
+  Entry* entry;
+};
+
+bool XlaCompilationCache::ScheduleAsyncCompilation(
+    const XlaCompiler::Options& options, const NameAttrList& function,
+    absl::Span<const XlaCompiler::Argument> args,
+    const XlaCompiler::CompileOptions& compile_options,
+    const Signature& signature, Entry* entry) {
+  {
+    mutex_lock lock(async_compile_mu_);
+    if (config_.max_pending_async_compiles > 0 &&
+        pending_async_compiles_ >= config_.max_pending_async_compiles) {
+      return false;
+    }
+    ++pending_async_compiles_;
+  }
+
+  // The caller does not wait for the compilation, so the request must not
+  // refer to anything owned by the caller's OpKernelContext. The function
+  // library is copied, and the device allocator, which is only used for
+  // scratch memory during autotuning, is replaced by the backend's.
+  auto request = std::make_shared<AsyncCompileRequest>();
+  request->options = options;
+  if (options.flib_def != nullptr) {
+    request->flib_def =
+        std::make_unique<FunctionLibraryDefinition>(*options.flib_def);
+    request->options.flib_def = request->flib_def.get();
+  }
+  request->options.device_allocator = nullptr;
+  request->options.populate_resource_manager = nullptr;
+  request->function = function;
+  request->args.assign(args.begin(), args.end());
+  request->compile_options = compile_options;
+  request->signature = signature;
+  request->entry = entry;
+
+  entry->compiling = true;
+  VLOG(2) << "Compiling in the background: " << signature.HumanString();
+  async_compile_pool_->Schedule(
+      [this, request]() { RunAsyncCompilation(request.get()); });
+  return true;
+}
+
+void XlaCompilationCache::RunAsyncCompilation(AsyncCompileRequest* request) {
+  const uint64 compile_start_us = Env::Default()->NowMicros();
+  XlaCompiler::CompilationResult result;
+  std::unique_ptr<xla::LocalExecutable> executable;
+  auto compile_fn = [&](XlaCompiler* compiler,
+                        XlaCompiler::CompilationResult* result) {
+    return compiler->CompileFunction(request->compile_options,
+                                     request->function, request->args, result);
+  };
+  Status status = CompileAndBuild(request->options, request->function,
+                                  request->signature, request->compile_options,
+                                  compile_fn, &result, &executable);
+  Status record_status =
+      RecordCompilation(request->function.name(), compile_start_us);
+  if (!record_status.ok()) {
+    LOG(WARNING) << "Failed to record background compilation of "
+                 << request->function.name() << ": " << record_status;
+  }
+
+  // Publish the result. Requests for the signature see it once `compiled` is
+  // set, and start running the executable instead of the fallback.
+  {
+    Entry* entry = request->entry;
+    mutex_lock lock(entry->mu);
+    entry->compilation_status = status;
+    entry->compilation_result = std::move(result);
+    entry->executable = std::move(executable);
+    entry->compiling = false;
+    entry->compiled = true;
+    entry->compiling_done.notify_all();
+  }
+  mutex_lock lock(async_compile_mu_);
+  --pending_async_compiles_;
+}
+
 }  // namespace tensorflow
@@ -44,12 +44,41 @@ namespace tensorflow {
 // bound.
 class XlaCompilationCache : public ResourceBase {
  public:
+  struct Config {
+    Config() = default;
+    explicit Config(string persistent_cache_directory)
+        : persistent_cache_directory(std::move(persistent_cache_directory)) {}
+
+    // If non-empty, compilation results are serialized into this directory
+    // after a successful compilation and are loaded from it on a cache miss,
+    // so that a restarted process only has to rebuild the XLA executable
+    // instead of re-lowering the TensorFlow subgraph.
+    string persistent_cache_directory;
+
+    // If > 0, lazy compilation compiles at most this many signatures of each
+    // cluster. Requests for further signatures are not compiled, so the
+    // caller falls back to the TF executor.
+    int64 max_compiles_per_cluster = 0;
+
+    // If > 0, the number of threads that run kAsync compilations. If 0,
+    // kAsync behaves like kLazy.
+    int async_compile_threads = 0;
+
+    // If > 0, the maximum number of kAsync compilations that may be queued or
+    // running at once. Further signatures are not compiled until one of them
+    // finishes.
+    int max_pending_async_compiles = 0;
+  };
+
   XlaCompilationCache(xla::LocalClient* client, DeviceType device_type);
+  XlaCompilationCache(Config config, xla::LocalClient* client,
+                      DeviceType device_type);
   ~XlaCompilationCache() override;
 
   enum class CompileMode {
     kLazy,
     kStrict,
+    kAsync,
   };
 
   // Compiles a function into a XlaCompiler::CompilationResult that can be used
@@ -62,7 +91,9 @@ class XlaCompilationCache : public ResourceBase {
   // heuristics, the compilation cache may decide not to compile the cluster at
   // this time.  In this case it returns null into both `out_compilation_result`
   // and `out_executable`.  If `compile_mode` is `kStrict` then the compilation
-  // cache always attempts the compilation on a cache miss.
+  // cache always attempts the compilation on a cache miss.  If `compile_mode`
+  // is `kAsync` then a cache miss starts the compilation on a background
+  // thread and returns null, like `kLazy`, until the compilation has finished.
   //
   // The result of compilation is written to `*out_compilation_result`, which
   // must be non-null. If `out_executable` is non-null, also builds an
@@ -127,9 +158,10 @@ class XlaCompilationCache : public ResourceBase {
   Status CompileImpl(
       const XlaCompiler::Options& options, const NameAttrList& function,
       absl::Span<const XlaCompiler::Argument> args,
+      const XlaCompiler::CompileOptions& compile_options,
       const std::function<Status(XlaCompiler* compiler,
                                  XlaCompiler::CompilationResult*)>& compile_fn,
-      absl::optional<int64> compile_threshold,
+      absl::optional<int64> compile_threshold, bool compile_async,
       const XlaCompiler::CompilationResult** out_compilation_result,
       xla::LocalExecutable** out_executable);
 
@@ -139,6 +171,44 @@ class XlaCompilationCache : public ResourceBase {
                          const XlaCompiler::CompilationResult& result,
                          std::unique_ptr<xla::LocalExecutable>* executable);
 
+  // Returns the path of the persistent cache file for `signature`, which is
+  // keyed by a fingerprint of the signature, the function definitions
+  // reachable from `function`, the device type and the TensorFlow version.
+  string GetPersistentCacheFilePath(
+      const XlaCompiler::Options& options,
+      const XlaCompiler::CompileOptions& compile_options,
+      const NameAttrList& function, const Signature& signature) const;
+
+  // Loads a compilation result previously written by SaveToPersistentCache.
+  // Returns NotFound if there is no entry for `signature`.
+  Status LoadFromPersistentCache(const string& path,
+                                 const Signature& signature,
+                                 XlaCompiler::CompilationResult* result) const;
+
+  // Serializes `result` to `path`. The file is written to a temporary
+  // location and renamed, so concurrent readers never observe partial
+  // entries.
+  Status SaveToPersistentCache(
+      const string& path, const Signature& signature,
+      const XlaCompiler::CompilationResult& result) const;
+
+  // Compiles `signature` with `compile_fn`, or loads it from the persistent
+  // cache, and builds its executable.
+  Status CompileAndBuild(
+      const XlaCompiler::Options& options, const NameAttrList& function,
+      const Signature& signature,
+      const XlaCompiler::CompileOptions& compile_options,
+      const std::function<Status(XlaCompiler* compiler,
+                                 XlaCompiler::CompilationResult*)>& compile_fn,
+      XlaCompiler::CompilationResult* result,
+      std::unique_ptr<xla::LocalExecutable>* executable);
+
+  // Adds a compilation of `function_name` that started at `compile_start_us`
+  // to the cluster statistics and broadcasts it to the activity listeners.
+  Status RecordCompilation(const string& function_name,
+                           uint64 compile_start_us);
+
+  const Config config_;
   xla::LocalClient* const client_;
   const DeviceType device_type_;
 
@@ -149,6 +219,11 @@ class XlaCompilationCache : public ResourceBase {
     // Have we tried compiling this entry?
     bool compiled = false;
 
+    // Is this entry being compiled on `async_compile_pool_`? Notifies
+    // `compiling_done` when it is reset.
+    bool compiling TF_GUARDED_BY(mu) = false;
+    condition_variable compiling_done;
+
     // The number of times a compilation with this signature has been requested.
     int64 request_count = 0;
 
@@ -163,6 +238,22 @@ class XlaCompilationCache : public ResourceBase {
     std::unique_ptr<xla::LocalExecutable> executable TF_GUARDED_BY(mu);
   };
 
+  // A kAsync compilation. Owns copies of everything the compilation reads,
+  // since the requesting op does not wait for it.
+  struct AsyncCompileRequest;
+
+  // Starts compiling `signature` on `async_compile_pool_` and marks `entry` as
+  // compiling. Returns false if too many compilations are already pending.
+  // Requires `entry->mu`.
+  bool ScheduleAsyncCompilation(
+      const XlaCompiler::Options& options, const NameAttrList& function,
+      absl::Span<const XlaCompiler::Argument> args,
+      const XlaCompiler::CompileOptions& compile_options,
+      const Signature& signature, Entry* entry);
+
+  // Runs `request` and publishes the result into its entry.
+  void RunAsyncCompilation(AsyncCompileRequest* request);
+
   mutex compile_cache_mu_;
   absl::flat_hash_map<Signature, std::unique_ptr<Entry>, Signature::Hash> cache_
       TF_GUARDED_BY(compile_cache_mu_);
@@ -189,6 +280,12 @@ class XlaCompilationCache : public ResourceBase {
   absl::flat_hash_map<string, ClusterCompileStats> cluster_compile_stats_
       TF_GUARDED_BY(cluster_compile_stats_mu_);
 
+  mutex async_compile_mu_;
+  int64 pending_async_compiles_ TF_GUARDED_BY(async_compile_mu_) = 0;
+
+  // Runs kAsync compilations. Null if they are disabled.
+  std::unique_ptr<thread::ThreadPool> async_compile_pool_;
+
   // The number of times a lazy compilation must be requested for a specific
   // signature before  we attempt to compile it.
   static constexpr int64 kDefaultCompilationThreshold = 2;
@@ -18,6 +18,10 @@ limitations under the License.
 #include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/tf2xla/shape_util.h"
 #include "tensorflow/compiler/xla/client/client_library.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 
@@ -54,6 +58,168 @@ TEST(XlaCompilationCacheTest, SignatureEquality) {
   }
 }
 
+// Must run before TestDisabledXlaCompilation, which disables compilation for
+// the rest of the process.
+TEST(XlaCompilationCacheTest, PersistentCache) {
+  FunctionDefLibrary flib;
+  *flib.add_function() = FunctionDefHelper::Define(
+      // Name
+      "AddTwice",
+      // Args
+      {"x: float"},
+      // Return values
+      {"y: float"},
+      // Attr def
+      {},
+      // Nodes
+      {{{"y"}, "Add", {"x", "x"}, {{"T", DT_FLOAT}}}});
+  FunctionLibraryDefinition flib_def(OpRegistry::Global(), flib);
+
+  xla::LocalClient* client = xla::ClientLibrary::LocalClientOrDie();
+  DeviceType device_type = DeviceType(DEVICE_CPU_XLA_JIT);
+  XlaCompiler::Options options;
+  options.device_type = device_type;
+  options.client = client;
+  options.flib_def = &flib_def;
+
+  NameAttrList fn;
+  fn.set_name("AddTwice");
+  std::vector<XlaCompiler::Argument> args(1);
+  args[0].kind = XlaCompiler::Argument::kParameter;
+  args[0].type = DT_FLOAT;
+  args[0].shape = TensorShape({2});
+
+  const string cache_dir =
+      io::JoinPath(testing::TmpDir(), "xla_persistent_compilation_cache");
+  // The first cache compiles and writes the entry, the second one (standing
+  // in for a restarted process) loads it.
+  for (int i = 0; i < 2; ++i) {
+    auto cache = new XlaCompilationCache(
+        XlaCompilationCache::Config(cache_dir), client, device_type);
+    core::ScopedUnref cache_ref(cache);
+
+    const XlaCompiler::CompilationResult* compilation_result;
+    xla::LocalExecutable* executable;
+    TF_ASSERT_OK(cache->Compile(options, fn, args,
+                                XlaCompiler::CompileOptions{},
+                                XlaCompilationCache::CompileMode::kStrict,
+                                &compilation_result, &executable));
+    ASSERT_NE(compilation_result, nullptr);
+    EXPECT_NE(executable, nullptr);
+    EXPECT_EQ(compilation_result->outputs.size(), 1);
+    EXPECT_EQ(compilation_result->input_mapping, std::vector<int>({0}));
+
+    std::vector<string> files;
+    TF_ASSERT_OK(Env::Default()->GetChildren(cache_dir, &files));
+    EXPECT_EQ(files.size(), 1);
+  }
+}
+
+TEST(XlaCompilationCacheTest, MaxCompilesPerCluster) {
+  FunctionDefLibrary flib;
+  *flib.add_function() = FunctionDefHelper::Define(
+      // Name
+      "AddTwice",
+      // Args
+      {"x: float"},
+      // Return values
+      {"y: float"},
+      // Attr def
+      {},
+      // Nodes
+      {{{"y"}, "Add", {"x", "x"}, {{"T", DT_FLOAT}}}});
+  FunctionLibraryDefinition flib_def(OpRegistry::Global(), flib);
+
+  xla::LocalClient* client = xla::ClientLibrary::LocalClientOrDie();
+  DeviceType device_type = DeviceType(DEVICE_CPU_XLA_JIT);
+  XlaCompiler::Options options;
+  options.device_type = device_type;
+  options.client = client;
+  options.flib_def = &flib_def;
+
+  NameAttrList fn;
+  fn.set_name("AddTwice");
+  std::vector<XlaCompiler::Argument> args(1);
+  args[0].kind = XlaCompiler::Argument::kParameter;
+  args[0].type = DT_FLOAT;
+
+  XlaCompilationCache::Config config;
+  config.max_compiles_per_cluster = 1;
+  auto cache = new XlaCompilationCache(config, client, device_type);
+  core::ScopedUnref cache_ref(cache);
+
+  auto compile = [&](int64 size, XlaCompilationCache::CompileMode mode) {
+    args[0].shape = TensorShape({size});
+    const XlaCompiler::CompilationResult* compilation_result;
+    xla::LocalExecutable* executable;
+    TF_EXPECT_OK(cache->Compile(options, fn, args,
+                                XlaCompiler::CompileOptions{}, mode,
+                                &compilation_result, &executable));
+    return executable;
+  };
+
+  // The first signature uses up the budget, so lazy compilation of a second
+  // one keeps falling back. Strict compilation ignores the budget.
+  EXPECT_NE(compile(2, XlaCompilationCache::CompileMode::kLazy), nullptr);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(compile(3, XlaCompilationCache::CompileMode::kLazy), nullptr);
+  }
+  EXPECT_NE(compile(2, XlaCompilationCache::CompileMode::kLazy), nullptr);
+  EXPECT_NE(compile(4, XlaCompilationCache::CompileMode::kStrict), nullptr);
+}
+
+TEST(XlaCompilationCacheTest, AsyncCompilation) {
+  FunctionDefLibrary flib;
+  *flib.add_function() = FunctionDefHelper::Define(
+      // Name
+      "AddTwice",
+      // Args
+      {"x: float"},
+      // Return values
+      {"y: float"},
+      // Attr def
+      {},
+      // Nodes
+      {{{"y"}, "Add", {"x", "x"}, {{"T", DT_FLOAT}}}});
+  FunctionLibraryDefinition flib_def(OpRegistry::Global(), flib);
+
+  xla::LocalClient* client = xla::ClientLibrary::LocalClientOrDie();
+  DeviceType device_type = DeviceType(DEVICE_CPU_XLA_JIT);
+  XlaCompiler::Options options;
+  options.device_type = device_type;
+  options.client = client;
+  options.flib_def = &flib_def;
+
+  NameAttrList fn;
+  fn.set_name("AddTwice");
+  std::vector<XlaCompiler::Argument> args(1);
+  args[0].kind = XlaCompiler::Argument::kParameter;
+  args[0].type = DT_FLOAT;
+  args[0].shape = TensorShape({2});
+
+  XlaCompilationCache::Config config;
+  config.async_compile_threads = 1;
+  auto cache = new XlaCompilationCache(config, client, device_type);
+  core::ScopedUnref cache_ref(cache);
+
+  auto compile = [&](XlaCompilationCache::CompileMode mode) {
+    const XlaCompiler::CompilationResult* compilation_result;
+    xla::LocalExecutable* executable;
+    TF_EXPECT_OK(cache->Compile(options, fn, args,
+                                XlaCompiler::CompileOptions{}, mode,
+                                &compilation_result, &executable));
+    return executable;
+  };
+
+  // The first request only starts the compilation. A strict request waits for
+  // it, after which async requests find the same executable.
+  EXPECT_EQ(compile(XlaCompilationCache::CompileMode::kAsync), nullptr);
+  xla::LocalExecutable* executable =
+      compile(XlaCompilationCache::CompileMode::kStrict);
+  EXPECT_NE(executable, nullptr);
+  EXPECT_EQ(compile(XlaCompilationCache::CompileMode::kAsync), executable);
+}
+
 TEST(XlaCompilationCacheTest, TestDisabledXlaCompilation) {
   NameAttrList fn;
   fn.set_name("afunction");
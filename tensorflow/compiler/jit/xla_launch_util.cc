@@ -206,7 +206,8 @@ XlaComputationLaunchContext::PopulateInputs(
     const XlaCompiler::CompilationResult* compilation_result,
     const std::map<int, const Tensor*>& resource_vars,
     int missing_ctx_input_prefix,
-    const xla::HloInputOutputAliasConfig& input_output_alias) {
+    const xla::HloInputOutputAliasConfig& input_output_alias,
+    absl::Span<const Tensor* const> inputs) {
   std::vector<xla::ExecutionInput> arguments;
   arguments.reserve(compilation_result->xla_input_shapes.size());
 
@@ -228,9 +229,12 @@ XlaComputationLaunchContext::PopulateInputs(
                          return update.input_index == i && update.modified;
                        });
 
-    const Tensor* t = is_resource_variable
-                          ? resource_vars.at(arg_num)
-                          : &(ctx->input(arg_num - missing_ctx_input_prefix));
+    const Tensor* t =
+        is_resource_variable
+            ? resource_vars.at(arg_num)
+            : !inputs.empty()
+                  ? inputs[arg_num - missing_ctx_input_prefix]
+                  : &(ctx->input(arg_num - missing_ctx_input_prefix));
     CHECK(t);
     bool donate_buffer =
         t->RefCountIsOne() && is_updated_resource_variable &&
@@ -15,15 +15,30 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/xla_platform_info.h"
 
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/xla/client/client_library.h"
 
 namespace tensorflow {
 
+namespace {
+
+XlaCompilationCache::Config CompilationCacheConfigFromFlags() {
+  const XlaOpsCommonFlags& flags = GetXlaOpsCommonFlags();
+  XlaCompilationCache::Config config(flags.tf_xla_persistent_cache_directory);
+  config.max_compiles_per_cluster = flags.tf_xla_max_compiles_per_cluster;
+  config.async_compile_threads = flags.tf_xla_async_compilation_threads;
+  config.max_pending_async_compiles = flags.tf_xla_max_pending_async_compiles;
+  return config;
+}
+
+}  // namespace
+
 Status BuildXlaCompilationCache(DeviceBase* device,
                                 const XlaPlatformInfo& platform_info,
                                 XlaCompilationCache** cache) {
   if (platform_info.xla_device_metadata()) {
     *cache = new XlaCompilationCache(
+        CompilationCacheConfigFromFlags(),
         platform_info.xla_device_metadata()->client(),
         platform_info.xla_device_metadata()->jit_device_type());
     return Status::OK();
@@ -71,7 +86,8 @@ Status BuildXlaCompilationCache(DeviceBase* device,
                                    platform_info.device_type().type());
   }
   *cache = new XlaCompilationCache(
-      client.ValueOrDie(), DeviceType(registration->compilation_device_name));
+      CompilationCacheConfigFromFlags(), client.ValueOrDie(),
+      DeviceType(registration->compilation_device_name));
   return Status::OK();
 }
 
@@ -36,7 +36,8 @@ struct PassConfig {
         unfold_batch_matmul(true),
         legalize_tf_while(true),
         shape_inference(true),
-        runtime_verification(true) {}
+        runtime_verification(true),
+        check_xnnpack_delegation(false) {}
 
   // If `emit_builtin_tflite_ops` is true, TF Lite legalization passes will be
   // added, which produces TF Lite ops.
@@ -62,6 +63,9 @@ struct PassConfig {
   bool shape_inference;
   // Whether to do TFLite runtime verification.
   bool runtime_verification;
+  // Whether to warn about the ops of the converted model that the XNNPACK
+  // delegate will not be able to run.
+  bool check_xnnpack_delegation;
 };
 
 }  // namespace TFL
@@ -0,0 +1,23 @@
+// RUN: tf-opt -tfl-check-xnnpack-delegation -verify-diagnostics %s
+
+// expected-remark@+1 {{2 of 2 ops can be delegated to XNNPACK}}
+func @delegated(%arg0: tensor<1x4xf32>) -> tensor<1x2xf32> {
+  %w = "tfl.pseudo_const"() {value = dense<1.0> : tensor<2x4xf16>} : () -> tensor<2x4xf16>
+  %0 = "tfl.dequantize"(%w) : (tensor<2x4xf16>) -> tensor<2x4xf32>
+  %b = "tfl.pseudo_const"() {value = dense<0.0> : tensor<2xf32>} : () -> tensor<2xf32>
+  %1 = "tfl.fully_connected"(%arg0, %0, %b) {fused_activation_function = "RELU", keep_num_dims = false, weights_format = "DEFAULT"} : (tensor<1x4xf32>, tensor<2x4xf32>, tensor<2xf32>) -> tensor<1x2xf32>
+  %2 = "tfl.logistic"(%1) : (tensor<1x2xf32>) -> tensor<1x2xf32>
+  return %2 : tensor<1x2xf32>
+}
+
+// expected-remark@+1 {{1 of 4 ops can be delegated to XNNPACK}}
+func @notDelegated(%arg0: tensor<1x4xf32>, %arg1: tensor<1x4x!quant.uniform<i8:f32, 0.1>>) -> tensor<1x4xf32> {
+  // expected-warning@+1 {{op will not be delegated to XNNPACK: unsupported op}}
+  %0 = "tfl.dequantize"(%arg1) : (tensor<1x4x!quant.uniform<i8:f32, 0.1>>) -> tensor<1x4xf32>
+  // expected-warning@+1 {{op will not be delegated to XNNPACK: unsupported fused activation}}
+  %1 = "tfl.add"(%arg0, %0) {fused_activation_function = "TANH"} : (tensor<1x4xf32>, tensor<1x4xf32>) -> tensor<1x4xf32>
+  // expected-warning@+1 {{op will not be delegated to XNNPACK: unsupported op}}
+  %2 = "tfl.tanh"(%1) : (tensor<1x4xf32>) -> tensor<1x4xf32>
+  %3 = "tfl.relu"(%2) : (tensor<1x4xf32>) -> tensor<1x4xf32>
+  return %3 : tensor<1x4xf32>
+}
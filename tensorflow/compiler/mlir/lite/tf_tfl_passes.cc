@@ -236,6 +236,11 @@ void AddTFToTFLConversionPasses(const mlir::TFL::PassConfig& pass_config,
     pass_manager->addNestedPass<mlir::FuncOp>(
         mlir::TFL::CreateSplitMergedOperandsPass());
 
+    if (pass_config.check_xnnpack_delegation) {
+      pass_manager->addNestedPass<mlir::FuncOp>(
+          mlir::TFL::CreateCheckXnnpackDelegationPass());
+    }
+
     // Add CallOnceOp when there is a session initializer function in tf saved
     // model dialect.
     pass_manager->addPass(
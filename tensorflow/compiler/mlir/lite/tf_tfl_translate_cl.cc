@@ -109,3 +109,9 @@ opt<bool> convert_tf_while_to_tfl_while(
     "convert_tf_while_to_tfl_while",
     llvm::cl::desc("Whether to legalize TF While to TFL While."),
     llvm::cl::init(true));
+
+// NOLINTNEXTLINE
+opt<bool> check_xnnpack_delegation(
+    "check-xnnpack-delegation",
+    llvm::cl::desc("Warn about the ops the XNNPACK delegate will not run"),
+    llvm::cl::init(false));
@@ -39,6 +39,7 @@ extern llvm::cl::list<std::string> custom_opdefs;
 extern llvm::cl::opt<bool> emit_quant_adaptor_ops;
 extern llvm::cl::opt<std::string> quant_stats_file_name;
 extern llvm::cl::opt<bool> convert_tf_while_to_tfl_while;
+extern llvm::cl::opt<bool> check_xnnpack_delegation;
 
 // Import saved model.
 extern llvm::cl::opt<bool> import_saved_model_object_graph;
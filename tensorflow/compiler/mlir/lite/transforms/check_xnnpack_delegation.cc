@@ -0,0 +1,137 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// This pass reports, at conversion time, which TFLite ops the XNNPACK delegate
+// will not be able to run. Those ops fall back to the TFLite kernels and split
+// the delegated graph into several partitions.
+
+#include <string>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Casting.h"
+#include "mlir/IR/Attributes.h"  // from @llvm-project
+#include "mlir/IR/BuiltinOps.h"  // from @llvm-project
+#include "mlir/IR/BuiltinTypes.h"  // from @llvm-project
+#include "mlir/IR/Operation.h"  // from @llvm-project
+#include "mlir/Pass/Pass.h"  // from @llvm-project
+#include "tensorflow/compiler/mlir/lite/ir/tfl_ops.h"
+#include "tensorflow/compiler/mlir/lite/transforms/passes.h"
+
+namespace mlir {
+namespace TFL {
+namespace {
+
+// Returns true if `op` is one of the builtin ops the XNNPACK delegate can run.
+// This mirrors the builtin codes handled by
+// tensorflow/lite/delegates/xnnpack/xnnpack_delegate.cc.
+bool IsSupportedByXnnpack(Operation* op) {
+  return llvm::isa<AbsOp, AddOp, AveragePool2DOp, CeilOp, Conv2DOp,
+                   DepthToSpaceOp, DepthwiseConv2DOp, DivOp, EluOp, FloorOp,
+                   FullyConnectedOp, HardSwishOp, LeakyReluOp, LogisticOp,
+                   MaxPool2DOp, MaximumOp, MeanOp, MinimumOp, MulOp, NegOp,
+                   PadOp, PReluOp, Relu1Op, Relu6Op, ReluOp, ReshapeOp,
+                   ResizeBilinearOp, RoundOp, SoftmaxOp, SqrtOp, SquareOp,
+                   SquaredDifferenceOp, SubOp>(op);
+}
+
+// Returns true if `value` is a float16 constant, which the XNNPACK delegate
+// unpacks to float32 when it is dequantized.
+bool IsFloat16Constant(Value value) {
+  Operation* def = value.getDefiningOp();
+  if (!def || !llvm::isa<ConstOp>(def)) return false;
+  auto type = value.getType().dyn_cast<ShapedType>();
+  return type && type.getElementType().isF16();
+}
+
+// Returns the reason why the XNNPACK delegate cannot run `op`, or an empty
+// string if it can.
+std::string GetUndelegatedReason(Operation* op) {
+  if (!IsSupportedByXnnpack(op)) return "unsupported op";
+
+  for (Type type : op->getOperandTypes()) {
+    if (type.isa<NoneType>()) continue;
+    auto shaped_type = type.dyn_cast<ShapedType>();
+    if (!shaped_type || !shaped_type.getElementType().isF32()) {
+      // XNNPACK only runs float32 ops. Quantized weights should instead be
+      // stored as float16 constants followed by a dequantize op.
+      return "non-float32 operand";
+    }
+  }
+  for (Type type : op->getResultTypes()) {
+    auto shaped_type = type.dyn_cast<ShapedType>();
+    if (!shaped_type || !shaped_type.getElementType().isF32()) {
+      return "non-float32 result";
+    }
+  }
+
+  if (auto activation =
+          op->getAttrOfType<StringAttr>("fused_activation_function")) {
+    if (activation.getValue() == "TANH" ||
+        activation.getValue() == "SIGN_BIT") {
+      return "unsupported fused activation";
+    }
+  }
+  return "";
+}
+
+class CheckXnnpackDelegationPass
+    : public mlir::PassWrapper<CheckXnnpackDelegationPass, FunctionPass> {
+ private:
+  void runOnFunction() override;
+};
+
+void CheckXnnpackDelegationPass::runOnFunction() {
+  FuncOp func = getFunction();
+  int num_ops = 0;
+  int num_delegated_ops = 0;
+  func.walk([&](Operation* op) {
+    Dialect* dialect = op->getDialect();
+    if (!dialect ||
+        dialect->getNamespace() != TensorFlowLiteDialect::getDialectNamespace())
+      return;
+    if (llvm::isa<ConstOp, QConstOp, SparseConstOp, SparseQConstOp>(op))
+      return;
+    // Dequantized float16 weights are unpacked by the delegate ahead of time.
+    if (llvm::isa<DequantizeOp>(op) && IsFloat16Constant(op->getOperand(0)))
+      return;
+
+    ++num_ops;
+    std::string reason = GetUndelegatedReason(op);
+    if (reason.empty()) {
+      ++num_delegated_ops;
+      return;
+    }
+    op->emitWarning() << "op will not be delegated to XNNPACK: " << reason;
+  });
+
+  if (num_ops > 0) {
+    func.emitRemark() << num_delegated_ops << " of " << num_ops
+                      << " ops can be delegated to XNNPACK";
+  }
+}
+
+}  // namespace
+
+// Creates an instance of the XNNPACK delegation check pass.
+std::unique_ptr<OperationPass<FuncOp>> CreateCheckXnnpackDelegationPass() {
+  return std::make_unique<CheckXnnpackDelegationPass>();
+}
+
+static PassRegistration<CheckXnnpackDelegationPass> pass(
+    "tfl-check-xnnpack-delegation",
+    "Report the ops the XNNPACK delegate will not run");
+
+}  // namespace TFL
+}  // namespace mlir
@@ -92,6 +92,9 @@ std::unique_ptr<OperationPass<ModuleOp>> CreateWhileOutlinePass();
 // Verifies runtime constraints.
 std::unique_ptr<OperationPass<FuncOp>> CreateRuntimeVerifyPass();
 
+// Reports the ops that the XNNPACK delegate will not be able to run.
+std::unique_ptr<OperationPass<FuncOp>> CreateCheckXnnpackDelegationPass();
+
 // Creates raise custom ops pass, which legalize custom ops to TFL::CustomOp
 std::unique_ptr<OperationPass<FuncOp>> CreateRaiseCustomOpsPass();
 
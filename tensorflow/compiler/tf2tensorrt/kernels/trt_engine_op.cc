@@ -18,12 +18,14 @@ limitations under the License.
 
 #include "absl/memory/memory.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "tensorflow/compiler/tf2tensorrt/common/utils.h"
 #include "tensorflow/compiler/tf2tensorrt/convert/convert_nodes.h"
 #include "tensorflow/compiler/tf2tensorrt/convert/utils.h"
 #include "tensorflow/compiler/tf2tensorrt/utils/trt_allocator.h"
+#include "tensorflow/compiler/tf2tensorrt/utils/trt_engine_store.h"
 #include "tensorflow/compiler/tf2tensorrt/utils/trt_engine_utils.h"
 #include "tensorflow/compiler/tf2tensorrt/utils/trt_logger.h"
 #include "tensorflow/compiler/tf2tensorrt/utils/trt_lru_cache.h"
@@ -38,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
@@ -144,6 +147,25 @@ class TRTEngineOp : public AsyncOpKernel {
       bool use_calibration, TRTInt8Calibrator* calibrator,
       TRTEngineCacheResource* cache_resource);
 
+  // Returns the key of the engine for the input shapes in the
+  // TrtEngineStore.
+  StatusOr<string> GetEngineStoreKey(
+      const std::vector<TensorShape>& input_concrete_shapes,
+      OpKernelContext* ctx, TRTEngineCacheResource* cache_resource);
+
+  // Deserializes the engine stored under 'key', if any. Returns nullptr if
+  // there is none or it cannot be deserialized.
+  TrtUniquePtrType<nvinfer1::ICudaEngine> LoadStoredEngine(
+      TrtEngineStore* store, const string& key,
+      TRTEngineCacheResource* cache_resource);
+
+  // Builds, in the background, an engine with the profiles learned by
+  // profile_learner_ and swaps it in for the current engine once built.
+  void StartLearnedProfilesBuild(
+      const std::vector<TensorShape>& input_concrete_shapes,
+      OpKernelContext* ctx, TRTEngineCacheResource* cache_res)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(engine_mutex_);
+
   // Verify that the input shapes are consistent and can be handled by this op.
   Status VerifyInputShapes(const std::vector<TensorShape>& shapes);
 
@@ -188,6 +210,12 @@ class TRTEngineOp : public AsyncOpKernel {
 
   int64 workspace_size_;
   mutex engine_mutex_;
+
+  // Learns optimization profiles from the input shapes seen in explicit batch
+  // mode, if enabled with TF_TRT_PROFILE_LEARNING_MIN_SHAPES.
+  std::unique_ptr<TrtProfileLearner> profile_learner_
+      TF_GUARDED_BY(engine_mutex_);
+
   FunctionLibraryRuntime::Handle native_execution_func_handle_;
 
   // The finalized calibrator for inference.
@@ -429,6 +457,22 @@ TRTEngineOp::TRTEngineOp(OpKernelConstruction* context)
     OP_REQUIRES(context, !calibration_mode_,
                 errors::InvalidArgument(
                     "Explicit batch mode does not support calibration"));
+
+    int64 profile_learning_min_shapes;
+    OP_REQUIRES_OK(context,
+                   ReadInt64FromEnvVar("TF_TRT_PROFILE_LEARNING_MIN_SHAPES",
+                                       /*default_val=*/0,
+                                       &profile_learning_min_shapes));
+    int64 profile_learning_max_profiles;
+    OP_REQUIRES_OK(context,
+                   ReadInt64FromEnvVar("TF_TRT_PROFILE_LEARNING_MAX_PROFILES",
+                                       /*default_val=*/8,
+                                       &profile_learning_max_profiles));
+    if (profile_learning_min_shapes > 0 && !static_engine_) {
+      mutex_lock lock(engine_mutex_);
+      profile_learner_ = absl::make_unique<TrtProfileLearner>(
+          profile_learning_min_shapes, profile_learning_max_profiles);
+    }
   }
 }
 
@@ -675,9 +719,13 @@ void TRTEngineOp::ComputeAsync(OpKernelContext* ctx,
       VLOG(1) << "Native segment is used during collecting shapes for profiles";
       ExecuteNativeSegment(ctx, helper);
       return;
-    } else if (cache_res->profiles_.GetNumProfiles() == 0) {
-      // Create profiles out of collected shapes during profile generation.
-      cache_res->profiles_.InitProfiles();
+    } else {
+      // Profiles may be swapped by a learned profiles build.
+      mutex_lock lock(engine_mutex_);
+      if (cache_res->profiles_.GetNumProfiles() == 0) {
+        // Create profiles out of collected shapes during profile generation.
+        cache_res->profiles_.InitProfiles();
+      }
     }
   }
   StatusOr<std::pair<EngineContext*, int>> status =
@@ -937,8 +985,14 @@ StatusOr<std::pair<EngineContext*, int>> TRTEngineOp::GetEngine(
   int profile_id = -1;
   if (!use_implicit_batch_) {
     profile_id = cache_res->profiles_.GetProfileNumber(input_concrete_shapes);
+    if (profile_learner_ != nullptr &&
+        profile_learner_->RecordShapes(input_concrete_shapes,
+                                       /*matched=*/profile_id != -1)) {
+      StartLearnedProfilesBuild(input_concrete_shapes, ctx, cache_res);
+    }
     // Since all profiles are already created at this point, finding no
-    // compatible profiles results in falling back to native TF.
+    // compatible profiles results in falling back to native TF, until a
+    // learned profiles build covers the input shapes.
     if (profile_id == -1) {
       return std::pair<EngineContext*, int>(&empty_context, 0);
     }
@@ -951,29 +1005,57 @@ StatusOr<std::pair<EngineContext*, int>> TRTEngineOp::GetEngine(
     engine_contexts = cache_res->GetEngineContext(profile_id);
   }
 
-  // If cache does not have a compatible engine then create a new engine.
+  // If cache does not have a compatible engine then create a new engine, or
+  // load it from the engine store if an identical segment built it before.
   if (engine_contexts == nullptr) {
-    if (!allow_build_at_runtime_) {
-      LOG_FIRST_FEW_WARNING_WITH_PREFIX
-          << "Found no engine in cache matching input shapes. "
-          << "Not building a new engine because "
-          << "allow_build_at_runtime=False. "
-          << "The native segment will be used instead.";
-      // Store an empty engine in the cache for these input shapes so we don't
-      // try to build the same failing engine again.
-      cache.emplace(input_concrete_shapes, absl::make_unique<EngineContext>());
-      return std::pair<EngineContext*, int>(&empty_context, 0);
+    TrtEngineStore* store = TrtEngineStore::Global();
+    string store_key;
+    TrtUniquePtrType<nvinfer1::ICudaEngine> engine;
+    if (store != nullptr) {
+      StatusOr<string> key =
+          GetEngineStoreKey(input_concrete_shapes, ctx, cache_res);
+      if (key.ok()) {
+        store_key = key.ValueOrDie();
+        engine = LoadStoredEngine(store, store_key, cache_res);
+      } else {
+        LOG_FIRST_FEW_WARNING_WITH_PREFIX
+            << "Not using the engine store for " << name() << ": "
+            << key.status();
+        store = nullptr;
+      }
     }
 
-    // Up to this point, calibrator_ can never be empty, since otherwise it
-    // means calibration_mode_ is true and this path won't get executed.
-    auto result = BuildEngine(input_concrete_shapes, batch_size,
-                              use_calibration_, calibrator_.get(), cache_res);
-    if (!result.ok()) {
-      return std::pair<EngineContext*, int>(&empty_context, 0);
+    if (!engine) {
+      if (!allow_build_at_runtime_) {
+        LOG_FIRST_FEW_WARNING_WITH_PREFIX
+            << "Found no engine in cache matching input shapes. "
+            << "Not building a new engine because "
+            << "allow_build_at_runtime=False. "
+            << "The native segment will be used instead.";
+        // Store an empty engine in the cache for these input shapes so we
+        // don't try to build the same failing engine again.
+        cache.emplace(input_concrete_shapes,
+                      absl::make_unique<EngineContext>());
+        return std::pair<EngineContext*, int>(&empty_context, 0);
+      }
+
+      // Up to this point, calibrator_ can never be empty, since otherwise it
+      // means calibration_mode_ is true and this path won't get executed.
+      auto result = BuildEngine(input_concrete_shapes, batch_size,
+                                use_calibration_, calibrator_.get(), cache_res);
+      if (!result.ok()) {
+        return std::pair<EngineContext*, int>(&empty_context, 0);
+      }
+      engine = std::move(result.ValueOrDie());
+      if (store != nullptr) {
+        TrtUniquePtrType<nvinfer1::IHostMemory> engine_data(
+            engine->serialize());
+        store->Insert(store_key,
+                      string(static_cast<const char*>(engine_data->data()),
+                             engine_data->size()),
+                      TrtEngineStore::GlobalDirectory());
+      }
     }
-    TrtUniquePtrType<nvinfer1::ICudaEngine> engine =
-        std::move(result.ValueOrDie());
     std::vector<TrtUniquePtrType<nvinfer1::IExecutionContext>> exec_context;
     TF_RETURN_IF_ERROR(cache_res->profiles_.CreateExecutionContexts(
         engine.get(), exec_context));
@@ -988,6 +1070,145 @@ StatusOr<std::pair<EngineContext*, int>> TRTEngineOp::GetEngine(
                                         use_implicit_batch_ ? 0 : profile_id);
 }
 
+StatusOr<string> TRTEngineOp::GetEngineStoreKey(
+    const std::vector<TensorShape>& input_concrete_shapes,
+    OpKernelContext* ctx, TRTEngineCacheResource* cache_resource) {
+  // Identical segments in different functions only differ in the devices they
+  // are placed on, which the engine does not depend on.
+  GraphDef segment = segment_graph_def_;
+  for (NodeDef& node : *segment.mutable_node()) {
+    node.clear_device();
+  }
+  string serialized_segment;
+  if (!SerializeToStringDeterministic(segment, &serialized_segment)) {
+    return errors::Internal("Failed to serialize the segment of ", name());
+  }
+
+  const int platform_gpu_id =
+      ctx->device()->tensorflow_gpu_device_info()->gpu_id;
+  cudaDeviceProp device_properties;
+  cudaError_t err =
+      cudaGetDeviceProperties(&device_properties, platform_gpu_id);
+  if (err != cudaSuccess) {
+    return errors::Internal("Failed to get the properties of GPU ",
+                            platform_gpu_id, ": ", cudaGetErrorString(err));
+  }
+
+  const string calibration_table =
+      use_calibration_ && calibrator_ != nullptr
+          ? calibrator_->getCalibrationTableAsString()
+          : "";
+  return TrtEngineStore::Key({
+      serialized_segment,
+      StrCat(static_cast<int>(precision_mode_), ",", workspace_size_, ",",
+             use_implicit_batch_, ",", use_calibration_),
+      calibration_table,
+      use_implicit_batch_
+          ? TensorShapeUtils::ShapeListString(input_concrete_shapes)
+          : cache_resource->profiles_.ProfilesDebugString(),
+      StrCat(absl::StrJoin(GetLinkedTensorRTVersion(), "."), ",",
+             absl::StrJoin(GetLoadedTensorRTVersion(), ".")),
+      StrCat(device_properties.name, ",", device_properties.major, ".",
+             device_properties.minor),
+  });
+}
+
+TrtUniquePtrType<nvinfer1::ICudaEngine> TRTEngineOp::LoadStoredEngine(
+    TrtEngineStore* store, const string& key,
+    TRTEngineCacheResource* cache_resource) {
+  absl::optional<string> serialized_engine =
+      store->Lookup(key, TrtEngineStore::GlobalDirectory());
+  if (!serialized_engine.has_value()) {
+    return nullptr;
+  }
+  TrtUniquePtrType<IRuntime> infer(nvinfer1::createInferRuntime(logger));
+  infer->setGpuAllocator(cache_resource->allocator_.get());
+  // Need to initialize plugins in order to deserialize engines that contain
+  // plugins.
+  MaybeInitializeTrtPlugins(&logger);
+  TrtUniquePtrType<nvinfer1::ICudaEngine> engine(infer->deserializeCudaEngine(
+      serialized_engine->data(), serialized_engine->size(), nullptr));
+  if (!engine) {
+    LOG_FIRST_FEW_WARNING_WITH_PREFIX << "Failed to deserialize stored engine "
+                                      << key << " for " << name();
+    return nullptr;
+  }
+  VLOG(1) << "Loaded stored engine " << key << " for " << name();
+  return engine;
+}
+
+void TRTEngineOp::StartLearnedProfilesBuild(
+    const std::vector<TensorShape>& input_concrete_shapes,
+    OpKernelContext* ctx, TRTEngineCacheResource* cache_res) {
+  auto profiles = std::make_shared<TrtShapeOptimizationProfile>(
+      profile_learner_->LearnedProfiles());
+  VLOG(1) << "Building an engine with " << profiles->GetNumProfiles()
+          << " learned profiles for " << name();
+  const int platform_gpu_id =
+      ctx->device()->tensorflow_gpu_device_info()->gpu_id;
+
+  // Like the calibration thread, the build refers to the op, which outlives
+  // the executions that start builds.
+  cache_res->Ref();
+  ctx->env()->SchedClosure([this, cache_res, profiles, platform_gpu_id,
+                            input_concrete_shapes]() {
+    core::ScopedUnref sc(cache_res);
+    tensorflow::profiler::TraceMe activity(
+        "TRTEngineOp::LearnedProfilesBuild",
+        tensorflow::profiler::TraceMeLevel::kInfo);
+    auto build_finished = [this]() {
+      mutex_lock lock(engine_mutex_);
+      profile_learner_->BuildFinished();
+    };
+    cudaError_t err = cudaSetDevice(platform_gpu_id);
+    if (err != cudaSuccess) {
+      LOG(ERROR) << "Couldn't set cuda device to " << platform_gpu_id
+                 << " to build learned profiles for " << name();
+      build_finished();
+      return;
+    }
+
+    // The batch size is not used in explicit batch mode.
+    TrtUniquePtrType<nvinfer1::ICudaEngine> engine;
+    Status status = convert::ConvertGraphDefToEngine(
+        segment_graph_def_, precision_mode_,
+        input_concrete_shapes[0].dim_size(0), workspace_size_,
+        input_partial_shapes_, &logger, cache_res->allocator_.get(),
+        calibrator_.get(), &engine, use_calibration_, use_implicit_batch_,
+        /*convert_successfully=*/nullptr, profiles.get());
+    std::vector<TrtUniquePtrType<nvinfer1::IExecutionContext>> exec_context;
+    if (status.ok()) {
+      status = profiles->CreateExecutionContexts(engine.get(), exec_context);
+    }
+    if (!status.ok()) {
+      LOG_FIRST_FEW_WARNING_WITH_PREFIX
+          << "Building an engine with learned profiles for " << name()
+          << " failed, keeping the current engine. Reason: " << status;
+      build_finished();
+      return;
+    }
+
+    auto engine_context = absl::make_unique<EngineContext>(
+        std::move(engine), std::move(exec_context));
+    mutex_lock lock(engine_mutex_);
+    cache_res->profiles_ = std::move(*profiles);
+    auto& cache = cache_res->cache_;
+    if (cache.size() == 0) {
+      cache.emplace(input_concrete_shapes, std::move(engine_context));
+    } else {
+      // There is at most one engine in explicit batch mode; retire it rather
+      // than destroying it, since other executions may still be using it.
+      std::unique_ptr<EngineContext>& current = cache.begin()->second;
+      cache_res->retired_engine_contexts_.push_back(std::move(current));
+      current = std::move(engine_context);
+    }
+    profile_learner_->BuildFinished();
+    VLOG(1) << "Swapped in an engine with "
+            << cache_res->profiles_.GetNumProfiles()
+            << " learned profiles for " << name();
+  });
+}
+
 // TODO(hinsu): Move this allocation to CalibrationContext constructor, if
 // possible.
 Status TRTEngineOp::AllocateCalibrationResources(
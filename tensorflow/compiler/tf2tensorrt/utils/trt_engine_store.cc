@@ -0,0 +1,174 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/tf2tensorrt/utils/trt_engine_store.h"
+
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace tensorrt {
+namespace {
+
+// Bumped whenever the key or the on-disk format changes, so stale engines are
+// never read back.
+const char* const kStoreFormatVersion = "1";
+
+const char* const kEngineFileSuffix = ".trt_engine";
+
+// Limit of the engines the process-wide store keeps in memory.
+const int64 kMaxInMemoryBytes = 1LL << 30;
+
+string EngineFilePath(const string& directory, const string& key) {
+  return io::JoinPath(directory, absl::StrCat(key, kEngineFileSuffix));
+}
+
+}  // namespace
+
+/*static*/ const string& TrtEngineStore::GlobalDirectory() {
+  static const string* directory = [] {
+    string value;
+    Status status = ReadStringFromEnvVar("TF_TRT_ENGINE_CACHE_DIR",
+                                         /*default_val=*/"", &value);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+    }
+    return new string(std::move(value));
+  }();
+  return *directory;
+}
+
+/*static*/ TrtEngineStore* TrtEngineStore::Global() {
+  static TrtEngineStore* store = []() -> TrtEngineStore* {
+    bool share_engines;
+    Status status = ReadBoolFromEnvVar("TF_TRT_SHARE_ENGINES",
+                                       /*default_val=*/false, &share_engines);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+    }
+    if (!share_engines && GlobalDirectory().empty()) {
+      return nullptr;
+    }
+    return new TrtEngineStore(kMaxInMemoryBytes);
+  }();
+  return store;
+}
+
+/*static*/ string TrtEngineStore::Key(const std::vector<string>& components) {
+  string key_material = kStoreFormatVersion;
+  for (const string& component : components) {
+    // Prefix each component with its size so that different splits of the
+    // same bytes have different keys.
+    absl::StrAppend(&key_material, ";", component.size(), ":", component);
+  }
+  Fprint128 fingerprint = Fingerprint128(key_material);
+  return absl::StrCat(absl::Hex(fingerprint.high64, absl::kZeroPad16),
+                      absl::Hex(fingerprint.low64, absl::kZeroPad16));
+}
+
+absl::optional<string> TrtEngineStore::Lookup(const string& key,
+                                              const string& directory) {
+  {
+    mutex_lock lock(mu_);
+    auto it = engines_.find(key);
+    if (it != engines_.end()) {
+      return it->second;
+    }
+  }
+  if (directory.empty()) {
+    return absl::nullopt;
+  }
+
+  Env* env = Env::Default();
+  const string path = EngineFilePath(directory, key);
+  string serialized_engine;
+  if (!env->FileExists(path).ok()) {
+    return absl::nullopt;
+  }
+  Status status = ReadFileToString(env, path, &serialized_engine);
+  if (!status.ok() || serialized_engine.empty()) {
+    LOG(WARNING) << "Ignoring unreadable TensorRT engine file " << path << ": "
+                 << status;
+    return absl::nullopt;
+  }
+  VLOG(1) << "Read TensorRT engine " << key << " from " << path;
+  mutex_lock lock(mu_);
+  InsertInMemory(key, serialized_engine);
+  return serialized_engine;
+}
+
+void TrtEngineStore::Insert(const string& key, const string& serialized_engine,
+                            const string& directory) {
+  if (!directory.empty()) {
+    // Write to a temporary file first so that concurrent readers, possibly in
+    // other processes, never see a partially written engine.
+    Env* env = Env::Default();
+    const string path = EngineFilePath(directory, key);
+    string temp_path;
+    Status status = env->RecursivelyCreateDir(directory);
+    if (status.ok()) {
+      string unique_path = path;
+      if (env->CreateUniqueFileName(&unique_path, ".tmp")) {
+        temp_path = std::move(unique_path);
+      } else {
+        status = errors::Internal("Cannot create a unique file name");
+      }
+    }
+    if (status.ok()) {
+      status = WriteStringToFile(env, temp_path, serialized_engine);
+    }
+    if (status.ok()) {
+      status = env->RenameFile(temp_path, path);
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to write TensorRT engine to " << path << ": "
+                   << status;
+      if (!temp_path.empty()) {
+        env->DeleteFile(temp_path).IgnoreError();
+      }
+    }
+  }
+
+  mutex_lock lock(mu_);
+  InsertInMemory(key, serialized_engine);
+}
+
+void TrtEngineStore::InsertInMemory(const string& key,
+                                    const string& serialized_engine) {
+  const int64 size = serialized_engine.size();
+  if (size > max_in_memory_bytes_ ||
+      !engines_.emplace(key, serialized_engine).second) {
+    return;
+  }
+  insertion_order_.push_back(key);
+  in_memory_bytes_ += size;
+
+  while (in_memory_bytes_ > max_in_memory_bytes_) {
+    auto it = engines_.find(insertion_order_.front());
+    in_memory_bytes_ -= it->second.size();
+    engines_.erase(it);
+    insertion_order_.pop_front();
+  }
+}
+
+}  // namespace tensorrt
+}  // namespace tensorflow
@@ -0,0 +1,89 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_TF2TENSORRT_UTILS_TRT_ENGINE_STORE_H_
+#define TENSORFLOW_COMPILER_TF2TENSORRT_UTILS_TRT_ENGINE_STORE_H_
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace tensorrt {
+
+// Stores serialized TensorRT engines built at runtime by TRTEngineOps, so that
+// an identical segment, in the same process or in a later one, can deserialize
+// the engine instead of building it again.
+//
+// Entries are keyed by a fingerprint of everything the engine depends on: the
+// segment, the build options, the input shapes or optimization profiles, the
+// TensorRT version and the GPU model. Unlike TRTEngineCacheResource, which is
+// per op name, the store is shared by all TRTEngineOps of the process.
+//
+// Entries are kept in memory, up to a size limit, and optionally in a
+// directory so that they survive process restarts.
+//
+// Thread-safe.
+class TrtEngineStore {
+ public:
+  // 'max_in_memory_bytes': entries are evicted from memory, oldest first, once
+  // the engines held exceed this size.
+  explicit TrtEngineStore(int64 max_in_memory_bytes)
+      : max_in_memory_bytes_(max_in_memory_bytes) {}
+
+  // Returns the process-wide store used by TRTEngineOp, or nullptr if storing
+  // engines is disabled, see TF_TRT_SHARE_ENGINES and TF_TRT_ENGINE_CACHE_DIR.
+  static TrtEngineStore* Global();
+
+  // Returns the directory the process-wide store persists engines in, or an
+  // empty string if engines are only kept in memory.
+  static const string& GlobalDirectory();
+
+  // Returns the key of an engine, given the strings that identify it.
+  static string Key(const std::vector<string>& components);
+
+  // Returns the engine stored under 'key', or nullopt if there is none. On a
+  // miss in memory, looks for the engine in 'directory' (if not empty) and
+  // keeps it in memory if found.
+  absl::optional<string> Lookup(const string& key, const string& directory);
+
+  // Stores 'serialized_engine' under 'key', and writes it to 'directory' if
+  // not empty. Failing to write to 'directory' is logged but not an error.
+  void Insert(const string& key, const string& serialized_engine,
+              const string& directory);
+
+ private:
+  void InsertInMemory(const string& key, const string& serialized_engine)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64 max_in_memory_bytes_;
+
+  mutex mu_;
+  std::unordered_map<string, string> engines_ TF_GUARDED_BY(mu_);
+  // Keys of 'engines_' in insertion order, for eviction.
+  std::deque<string> insertion_order_ TF_GUARDED_BY(mu_);
+  int64 in_memory_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace tensorrt
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_COMPILER_TF2TENSORRT_UTILS_TRT_ENGINE_STORE_H_
@@ -0,0 +1,69 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/tf2tensorrt/utils/trt_engine_store.h"
+
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace tensorrt {
+
+TEST(TrtEngineStoreTest, KeyDependsOnAllComponents) {
+  EXPECT_EQ(TrtEngineStore::Key({"segment", "shapes"}),
+            TrtEngineStore::Key({"segment", "shapes"}));
+  EXPECT_NE(TrtEngineStore::Key({"segment", "shapes"}),
+            TrtEngineStore::Key({"segment", "other_shapes"}));
+  EXPECT_NE(TrtEngineStore::Key({"ab", "c"}), TrtEngineStore::Key({"a", "bc"}));
+}
+
+TEST(TrtEngineStoreTest, LookupReturnsInsertedEngine) {
+  TrtEngineStore store(/*max_in_memory_bytes=*/1 << 20);
+  EXPECT_FALSE(store.Lookup("key", /*directory=*/"").has_value());
+
+  store.Insert("key", "engine", /*directory=*/"");
+  absl::optional<string> engine = store.Lookup("key", /*directory=*/"");
+  ASSERT_TRUE(engine.has_value());
+  EXPECT_EQ(*engine, "engine");
+  EXPECT_FALSE(store.Lookup("other_key", /*directory=*/"").has_value());
+}
+
+TEST(TrtEngineStoreTest, OldestEnginesAreEvicted) {
+  TrtEngineStore store(/*max_in_memory_bytes=*/10);
+  store.Insert("a", "aaaaaa", /*directory=*/"");
+  store.Insert("b", "bbbbbb", /*directory=*/"");
+
+  EXPECT_FALSE(store.Lookup("a", /*directory=*/"").has_value());
+  EXPECT_TRUE(store.Lookup("b", /*directory=*/"").has_value());
+}
+
+TEST(TrtEngineStoreTest, EnginesPersistInDirectory) {
+  const string directory = io::JoinPath(testing::TmpDir(), "trt_engines");
+  {
+    TrtEngineStore store(/*max_in_memory_bytes=*/1 << 20);
+    store.Insert("key", "engine", directory);
+  }
+
+  // A new store, as in a new process, reads the engine back from disk.
+  TrtEngineStore store(/*max_in_memory_bytes=*/1 << 20);
+  EXPECT_FALSE(store.Lookup("key", /*directory=*/"").has_value());
+  absl::optional<string> engine = store.Lookup("key", directory);
+  ASSERT_TRUE(engine.has_value());
+  EXPECT_EQ(*engine, "engine");
+  EXPECT_TRUE(store.Lookup("key", /*directory=*/"").has_value());
+}
+
+}  // namespace tensorrt
+}  // namespace tensorflow
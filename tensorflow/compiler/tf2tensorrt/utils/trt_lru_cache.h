@@ -212,6 +212,11 @@ class TRTEngineCacheResource : public ResourceBase {
            VectorTensorShapeHasher>
       cache_;
 
+  // Engines replaced in 'cache_' by an engine with learned optimization
+  // profiles. They are kept alive with the resource since TRTEngineOps may
+  // still be executing them.
+  std::vector<std::unique_ptr<EngineContext>> retired_engine_contexts_;
+
   // TODO(hinsu): Use different calibration context for the available shapes and
   // attach it to each item of the cache.
   std::unique_ptr<CalibrationContext> calib_ctx_;
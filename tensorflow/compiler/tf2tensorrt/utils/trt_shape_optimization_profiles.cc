@@ -183,6 +183,43 @@ int TrtShapeOptimizationProfile::GetNumProfiles() const {
   return profiles_.size();
 }
 
+bool TrtProfileLearner::RecordShapes(const std::vector<TensorShape>& shapes,
+                                     bool matched) {
+  ++shape_counts_[shapes];
+  if (!matched) {
+    ++unmatched_shapes_since_build_;
+  }
+  if (build_in_progress_ ||
+      unmatched_shapes_since_build_ < min_unmatched_shapes_) {
+    return false;
+  }
+  build_in_progress_ = true;
+  unmatched_shapes_since_build_ = 0;
+  return true;
+}
+
+TrtShapeOptimizationProfile TrtProfileLearner::LearnedProfiles() const {
+  std::vector<std::pair<int64, const std::vector<TensorShape>*>> by_count;
+  by_count.reserve(shape_counts_.size());
+  for (const auto& shape_count : shape_counts_) {
+    by_count.emplace_back(shape_count.second, &shape_count.first);
+  }
+  const int num_profiles = std::min<int>(max_profiles_, by_count.size());
+  std::partial_sort(
+      by_count.begin(), by_count.begin() + num_profiles, by_count.end(),
+      [](const std::pair<int64, const std::vector<TensorShape>*>& a,
+         const std::pair<int64, const std::vector<TensorShape>*>& b) {
+        return a.first > b.first;
+      });
+
+  TrtShapeOptimizationProfile profiles;
+  for (int i = 0; i < num_profiles; ++i) {
+    profiles.AddShape(*by_count[i].second);
+  }
+  profiles.InitProfiles();
+  return profiles;
+}
+
 }  // namespace tensorrt
 }  // namespace tensorflow
 #endif  // GOOGLE_CUDA && GOOGLE_TENSORRT
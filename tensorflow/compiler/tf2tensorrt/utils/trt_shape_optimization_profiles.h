@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <list>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -153,6 +154,16 @@ class TrtShapeOptimizationProfile {
   // Restores profiles from the engine (used after deserialization)
   Status RestoreProfiles(const nvinfer1::ICudaEngine* engine);
 
+  // Returns a description of all profiles, which identifies the profiles an
+  // engine is built with.
+  string ProfilesDebugString() const {
+    string result;
+    for (const OptimizationProfileConfig& profile : profiles_) {
+      absl::StrAppend(&result, profile.DebugString());
+    }
+    return result;
+  }
+
  private:
   // Set of input shape vetors that we collect during profile_generation_mode
   std::unordered_set<std::vector<TensorShape>, VectorTensorShapeHasher>
@@ -169,6 +180,43 @@ class TrtShapeOptimizationProfile {
 #endif
 };
 
+// Learns optimization profiles online, from the input shapes a TRTEngineOp
+// sees while serving in explicit batch mode.
+//
+// Every input shape vector is recorded with whether a profile of the current
+// engine covered it. Once enough uncovered shapes were seen since the last
+// build, a new engine is due, with one profile for each of the most frequent
+// shape vectors seen so far.
+//
+// This class is thread-compatible.
+class TrtProfileLearner {
+ public:
+  // 'min_unmatched_shapes': number of uncovered shape vectors to see between
+  // builds. 'max_profiles': maximum number of profiles of a learned engine.
+  TrtProfileLearner(int64 min_unmatched_shapes, int max_profiles)
+      : min_unmatched_shapes_(min_unmatched_shapes),
+        max_profiles_(max_profiles) {}
+
+  // Records 'shapes', which a profile covers if 'matched'. Returns true if a
+  // new engine should be built now; the caller must then call BuildFinished
+  // once the build is over.
+  bool RecordShapes(const std::vector<TensorShape>& shapes, bool matched);
+
+  // Returns profiles covering the most frequent shape vectors seen so far.
+  TrtShapeOptimizationProfile LearnedProfiles() const;
+
+  void BuildFinished() { build_in_progress_ = false; }
+
+ private:
+  const int64 min_unmatched_shapes_;
+  const int max_profiles_;
+
+  std::unordered_map<std::vector<TensorShape>, int64, VectorTensorShapeHasher>
+      shape_counts_;
+  int64 unmatched_shapes_since_build_ = 0;
+  bool build_in_progress_ = false;
+};
+
 }  // namespace tensorrt
 }  // namespace tensorflow
 
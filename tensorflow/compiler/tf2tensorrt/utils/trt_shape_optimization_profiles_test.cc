@@ -210,6 +210,33 @@ TEST_F(TrtShapeOptimizationProfileTest, Dynamic) {
 }
 #endif
 
+TEST(TrtProfileLearnerTest, LearnsMostFrequentShapes) {
+  TrtProfileLearner learner(/*min_unmatched_shapes=*/3, /*max_profiles=*/2);
+  std::vector<TensorShape> frequent = DimVecToShapeVec({{1, 2, 10}});
+  std::vector<TensorShape> common = DimVecToShapeVec({{4, 2, 10}});
+  std::vector<TensorShape> rare = DimVecToShapeVec({{8, 2, 10}});
+
+  EXPECT_FALSE(learner.RecordShapes(frequent, /*matched=*/true));
+  EXPECT_FALSE(learner.RecordShapes(frequent, /*matched=*/true));
+  EXPECT_FALSE(learner.RecordShapes(rare, /*matched=*/false));
+  EXPECT_FALSE(learner.RecordShapes(common, /*matched=*/false));
+  // The third uncovered shape vector triggers a build.
+  EXPECT_TRUE(learner.RecordShapes(common, /*matched=*/false));
+
+  TrtShapeOptimizationProfile profiles = learner.LearnedProfiles();
+  EXPECT_EQ(2, profiles.GetNumProfiles());
+  EXPECT_NE(-1, profiles.GetProfileNumber(frequent));
+  EXPECT_NE(-1, profiles.GetProfileNumber(common));
+  EXPECT_EQ(-1, profiles.GetProfileNumber(rare));
+
+  // No other build starts before the current one finishes.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_FALSE(learner.RecordShapes(rare, /*matched=*/false));
+  }
+  learner.BuildFinished();
+  EXPECT_TRUE(learner.RecordShapes(rare, /*matched=*/false));
+}
+
 }  // namespace tensorrt
 }  // namespace tensorflow
 
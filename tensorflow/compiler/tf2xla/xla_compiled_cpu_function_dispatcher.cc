@@ -0,0 +1,108 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/tf2xla/xla_compiled_cpu_function_dispatcher.h"
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include "tensorflow/compiler/xla/cpu_function_runtime.h"
+
+namespace tensorflow {
+
+XlaCompiledCpuFunctionDispatcher::XlaCompiledCpuFunctionDispatcher(
+    std::vector<Variant> variants, std::vector<int> batched_arg_indices)
+    : variants_(std::move(variants)),
+      batched_arg_indices_(std::move(batched_arg_indices)),
+      instances_(variants_.size()) {
+  assert(!variants_.empty());
+  largest_ = GetOrCreateVariant(variants_.size() - 1);
+  last_run_ = largest_;
+  batch_size_ = max_batch_size();
+
+  // Allocate the arg buffers once, for the largest variant; the arg shapes of
+  // the smaller variants are prefixes of these.
+  using BufferInfo = xla::cpu_function_runtime::BufferInfo;
+  std::vector<BufferInfo> arg_infos;
+  for (int i = 0; i < largest_->num_args(); ++i) {
+    arg_infos.push_back(
+        BufferInfo::MakeEntryParameter(largest_->arg_size(i), i));
+  }
+  args_.resize(arg_infos.size());
+  alloc_args_ = xla::cpu_function_runtime::MallocContiguousBuffers(
+      arg_infos.data(), arg_infos.size(), /*allocate_entry_params=*/true,
+      args_.data(), /*annotate_initialized=*/true);
+}
+
+XlaCompiledCpuFunctionDispatcher::~XlaCompiledCpuFunctionDispatcher() {
+  xla::cpu_function_runtime::FreeContiguous(alloc_args_);
+}
+
+bool XlaCompiledCpuFunctionDispatcher::set_batch_size(int64 batch_size) {
+  if (batch_size < 1 || batch_size > max_batch_size()) {
+    return false;
+  }
+  batch_size_ = batch_size;
+  return true;
+}
+
+void XlaCompiledCpuFunctionDispatcher::set_thread_pool(
+    const Eigen::ThreadPoolDevice* pool) {
+  thread_pool_ = pool;
+  for (const auto& instance : instances_) {
+    if (instance != nullptr) {
+      instance->set_thread_pool(pool);
+    }
+  }
+}
+
+XlaCompiledCpuFunction* XlaCompiledCpuFunctionDispatcher::GetOrCreateVariant(
+    size_t index) {
+  std::unique_ptr<XlaCompiledCpuFunction>& instance = instances_[index];
+  if (instance == nullptr) {
+    instance = variants_[index].create();
+    if (thread_pool_ != nullptr) {
+      instance->set_thread_pool(thread_pool_);
+    }
+  }
+  return instance.get();
+}
+
+bool XlaCompiledCpuFunctionDispatcher::Run() {
+  size_t index = 0;
+  while (variants_[index].batch_size < batch_size_) {
+    ++index;
+  }
+  const int64 variant_batch_size = variants_[index].batch_size;
+  XlaCompiledCpuFunction* variant = GetOrCreateVariant(index);
+
+  // Rows past batch_size_ only feed padding rows of the results, but zero them
+  // so that stale data (e.g. NaNs or denormals) cannot slow the variant down.
+  for (int i : batched_arg_indices_) {
+    const size_t row_bytes = largest_->arg_size(i) / max_batch_size();
+    std::memset(static_cast<char*>(args_[i]) + batch_size_ * row_bytes, 0,
+                (variant_batch_size - batch_size_) * row_bytes);
+  }
+  for (int i = 0; i < variant->num_args(); ++i) {
+    variant->set_arg_data(i, args_[i]);
+  }
+
+  last_run_ = variant;
+  last_run_batch_size_ = variant_batch_size;
+  return variant->Run();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,133 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_TF2XLA_XLA_COMPILED_CPU_FUNCTION_DISPATCHER_H_
+#define TENSORFLOW_COMPILER_TF2XLA_XLA_COMPILED_CPU_FUNCTION_DISPATCHER_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/compiler/tf2xla/xla_compiled_cpu_function.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Runs one of several variants of a function compiled ahead-of-time for
+// different batch sizes, produced by tfcompile --batch_sizes.
+//
+// The variants only differ in the leading (batch) dimension of some of their
+// args, and of the results computed from them. The dispatcher owns one set of
+// arg and variable buffers, sized for the largest variant, which every variant
+// reads from. Run executes the smallest variant whose batch size is at least
+// batch_size(), after zeroing the padding rows of the batched args.
+//
+// Results are read from the variant that ran last. Only the first batch_size()
+// rows of batched results are meaningful.
+//
+// This class is thread-compatible, like XlaCompiledCpuFunction.
+class XlaCompiledCpuFunctionDispatcher {
+ public:
+  struct Variant {
+    int64 batch_size;
+    // Creates the variant in AllocMode::RESULTS_PROFILES_AND_TEMPS_ONLY.
+    std::unique_ptr<XlaCompiledCpuFunction> (*create)();
+  };
+
+  // 'variants' must be sorted by increasing batch size. 'batched_arg_indices'
+  // are the args whose leading dimension is the batch dimension. The largest
+  // variant is created eagerly, the others on their first Run.
+  XlaCompiledCpuFunctionDispatcher(std::vector<Variant> variants,
+                                   std::vector<int> batched_arg_indices);
+  virtual ~XlaCompiledCpuFunctionDispatcher();
+
+  XlaCompiledCpuFunctionDispatcher(const XlaCompiledCpuFunctionDispatcher&) =
+      delete;
+  XlaCompiledCpuFunctionDispatcher& operator=(
+      const XlaCompiledCpuFunctionDispatcher&) = delete;
+
+  // Sets the number of rows of the batched args to compute on, in
+  // [1, max_batch_size()]. Returns false, and leaves the batch size unchanged,
+  // if 'batch_size' is out of range. Defaults to max_batch_size().
+  bool set_batch_size(int64 batch_size);
+  int64 batch_size() const { return batch_size_; }
+  int64 max_batch_size() const { return variants_.back().batch_size; }
+
+  // Sets the intra-op thread pool of every variant.
+  void set_thread_pool(const Eigen::ThreadPoolDevice* pool);
+
+  // Runs the smallest variant that fits batch_size(). Returns true on success
+  // and false on failure.
+  bool Run();
+
+  // Returns the batch size of the variant run by the last Run call, or 0 if
+  // Run was not called yet.
+  int64 last_run_batch_size() const { return last_run_batch_size_; }
+
+  string error_msg() const { return {}; }
+
+  // ------------------------------
+  // Arg methods, as in XlaCompiledCpuFunction. Buffers hold max_batch_size()
+  // rows for batched args.
+
+  void* arg_data(size_t index) { return args_[index]; }
+  const void* arg_data(size_t index) const { return args_[index]; }
+
+  int num_args() const { return largest_->num_args(); }
+
+  int num_variables() const { return largest_->num_variables(); }
+
+  int arg_size(int idx) const { return largest_->arg_size(idx); }
+
+  // Replaces the buffer of the arg at 'index'. The buffer must be aligned as
+  // for XlaCompiledCpuFunction::set_arg_data and be of arg_size(index) bytes.
+  // Run overwrites the padding rows of batched args, so their buffers must be
+  // writable.
+  void set_arg_data(size_t index, const void* data) {
+    args_[index] = const_cast<void*>(data);
+  }
+
+  // ------------------------------
+  // Result methods, as in XlaCompiledCpuFunction. Must only be called after a
+  // successful Run call.
+
+  void* result_data(size_t index) { return last_run_->result_data(index); }
+  const void* result_data(size_t index) const {
+    return last_run_->result_data(index);
+  }
+
+ private:
+  // Returns the variant at 'index' in 'variants_', creating it if needed.
+  XlaCompiledCpuFunction* GetOrCreateVariant(size_t index);
+
+  const std::vector<Variant> variants_;
+  const std::vector<int> batched_arg_indices_;
+
+  // The instances of 'variants_', created on first use.
+  std::vector<std::unique_ptr<XlaCompiledCpuFunction>> instances_;
+  XlaCompiledCpuFunction* largest_ = nullptr;
+  XlaCompiledCpuFunction* last_run_ = nullptr;
+  const Eigen::ThreadPoolDevice* thread_pool_ = nullptr;
+
+  int64 batch_size_;
+  int64 last_run_batch_size_ = 0;
+
+  // Arg buffers shared by all variants, and their backing memory.
+  std::vector<void*> args_;
+  void* alloc_args_ = nullptr;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_COMPILER_TF2XLA_XLA_COMPILED_CPU_FUNCTION_DISPATCHER_H_
@@ -24,6 +24,7 @@ limitations under the License.
 #include "absl/strings/str_split.h"
 #include "tensorflow/compiler/xla/debug_options_parsers.h"
 #include "tensorflow/compiler/xla/parse_flags_from_env.h"
+#include "tensorflow/core/platform/protobuf.h"
 
 namespace xla {
 
@@ -76,6 +77,8 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_gpu_unsafe_fallback_to_driver_on_ptxas_not_found(false);
   opts.set_xla_multiheap_size_constraint_per_heap(-1);
   opts.set_xla_detailed_logging(true);
+  opts.set_xla_gpu_enable_llvm_module_compilation_parallelism(true);
+  opts.set_xla_gpu_enable_async_collectives(true);
   return opts;
 }
 
@@ -139,6 +142,14 @@ static void AllocateFlags() {
     };
   };
 
+  auto int64_setter_for =
+      [](void (DebugOptions::*member_setter)(tensorflow::protobuf_int64)) {
+        return [member_setter](int64 value) {
+          (flag_values->*member_setter)(value);
+          return true;
+        };
+      };
+
   auto string_setter_for =
       [](void (DebugOptions::*member_setter)(const string& value)) {
         return [member_setter](const string& value) {
@@ -600,11 +611,65 @@ static void AllocateFlags() {
       flag_values->xla_gpu_force_compilation_parallelism(),
       "Overrides normal multi-threaded compilation settting to use this many "
       "threads. Setting to 0 (the default value) means no enforcement."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_enable_llvm_module_compilation_parallelism",
+      bool_setter_for(
+          &DebugOptions::
+              set_xla_gpu_enable_llvm_module_compilation_parallelism),
+      flag_values->xla_gpu_enable_llvm_module_compilation_parallelism(),
+      "Split LLVM modules with many kernels and compile the pieces to PTX "
+      "and cubin in parallel on a process-wide thread pool when the caller "
+      "does not provide one."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_enable_cuda_graphs",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_cuda_graphs),
+      flag_values->xla_gpu_enable_cuda_graphs(),
+      "Replay runs of capturable thunks as CUDA graphs to save kernel launch "
+      "overhead. Graphs are captured on the second run of an executable with "
+      "a given set of buffer addresses."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_enable_async_collectives",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_async_collectives),
+      flag_values->xla_gpu_enable_async_collectives(),
+      "Run NCCL collectives on a dedicated stream and overlap them with "
+      "independent compute."));
   flag_objects->push_back(tensorflow::Flag(
       "xla_gpu_deterministic_ops",
       bool_setter_for(&DebugOptions::set_xla_gpu_deterministic_ops),
       flag_values->xla_gpu_deterministic_ops(),
       "Guarantees run-to-run determinism on GPU."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_hlo_pass_pipeline_parallelism",
+      int32_setter_for(&DebugOptions::set_xla_hlo_pass_pipeline_parallelism),
+      flag_values->xla_hlo_pass_pipeline_parallelism(),
+      "Number of threads used to run computation passes of HLO pass "
+      "pipelines over the computations of a module. Values below 2 (the "
+      "default) run all passes serially."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_autotune_database_path",
+      string_setter_for(&DebugOptions::set_xla_gpu_autotune_database_path),
+      flag_values->xla_gpu_autotune_database_path(),
+      "An AutotuneDatabaseProto file holding convolution and gemm autotuning "
+      "results. It is read when first needed and new results are appended "
+      "to it, so that processes on the same machine share their results. "
+      "Files ending in .pbtxt are written in text format."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_fusion_profile_path",
+      string_setter_for(&DebugOptions::set_xla_gpu_fusion_profile_path),
+      flag_values->xla_gpu_fusion_profile_path(),
+      "A FusionProfileProto file. Runs with --xla_hlo_profile record the "
+      "timings of their fusions into it, and later compilations use them to "
+      "revisit fusion decisions. Files ending in .pbtxt are written in text "
+      "format."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_host_offload_device_memory_limit_bytes",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_host_offload_device_memory_limit_bytes),
+      static_cast<int64>(
+          flag_values->xla_gpu_host_offload_device_memory_limit_bytes()),
+      "If positive, at most this many bytes of intermediate buffers live in "
+      "device memory at a time; the others are offloaded to pinned host "
+      "memory and copied in before their uses."));
 
   ParseFlagsFromEnvAndDieIfUnknown("XLA_FLAGS", *flag_objects);
 }
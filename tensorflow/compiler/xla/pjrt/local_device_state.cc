@@ -15,9 +15,12 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/pjrt/local_device_state.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorflow/compiler/xla/util.h"
@@ -25,6 +28,14 @@ limitations under the License.
 #include "tensorflow/stream_executor/stream.h"
 
 namespace xla {
+namespace {
+
+// Host-to-device transfers staged through pinned memory are split into chunks
+// of this size, with up to kNumStagingBuffers chunks in flight.
+constexpr int kNumStagingBuffers = 2;
+constexpr int64 kStagingBufferBytes = 8 << 20;
+
+}  // namespace
 
 LocalDeviceState::LocalDeviceState(se::StreamExecutor* executor,
                                    LocalClient* client,
@@ -67,6 +78,10 @@ LocalDeviceState::~LocalDeviceState() {
   if (!status.ok()) {
     LOG(ERROR) << "Error when closing device: " << status;
   }
+  absl::MutexLock lock(&staging_mu_);
+  for (void* staging_buffer : staging_buffers_) {
+    executor_->HostMemoryDeallocate(staging_buffer);
+  }
 }
 
 Status LocalDeviceState::SynchronizeAllActivity() {
@@ -95,6 +110,54 @@ Status LocalDeviceState::ThenMemcpyDeviceToDevice(
   return Status::OK();
 }
 
+Status LocalDeviceState::ThenStagedMemcpyHostToDevice(
+    const void* src, int64 size, se::DeviceMemoryBase dst) {
+  for (int64 offset = 0; offset < size; offset += kStagingBufferBytes) {
+    const int64 chunk_size = std::min(kStagingBufferBytes, size - offset);
+    int buffer;
+    void* staging_buffer;
+    {
+      absl::MutexLock lock(&staging_mu_);
+      if (staging_buffers_.empty()) {
+        for (int i = 0; i < kNumStagingBuffers; ++i) {
+          void* ptr = executor_->HostMemoryAllocate(kStagingBufferBytes);
+          if (ptr == nullptr) {
+            for (void* allocated : staging_buffers_) {
+              executor_->HostMemoryDeallocate(allocated);
+            }
+            staging_buffers_.clear();
+            return ResourceExhausted(
+                "Failed to allocate %d bytes of pinned host memory for "
+                "staging host-to-device transfers.",
+                kStagingBufferBytes);
+          }
+          staging_buffers_.push_back(ptr);
+        }
+        staging_buffer_in_flight_.assign(kNumStagingBuffers, false);
+      }
+      auto it = absl::c_find(staging_buffer_in_flight_, false);
+      while (it == staging_buffer_in_flight_.end()) {
+        staging_buffer_released_.Wait(&staging_mu_);
+        it = absl::c_find(staging_buffer_in_flight_, false);
+      }
+      buffer = it - staging_buffer_in_flight_.begin();
+      staging_buffer_in_flight_[buffer] = true;
+      staging_buffer = staging_buffers_[buffer];
+    }
+    std::memcpy(staging_buffer, static_cast<const char*>(src) + offset,
+                chunk_size);
+    se::DeviceMemoryBase dst_chunk(static_cast<char*>(dst.opaque()) + offset,
+                                   chunk_size);
+    host_to_device_stream_->ThenMemcpy(&dst_chunk, staging_buffer, chunk_size);
+    ThenExecuteOnCallbackThread(host_to_device_stream_.get(), [this, buffer]() {
+      absl::MutexLock lock(&staging_mu_);
+      staging_buffer_in_flight_[buffer] = false;
+      staging_buffer_released_.Signal();
+    });
+  }
+  return Status::OK();
+}
+
 void LocalDeviceState::ThenExecuteOnCallbackThread(
     se::Stream* stream, std::function<void()> callback) const {
   stream->ThenDoHostCallback([this, callback]() mutable {
@@ -129,6 +129,14 @@ class LocalDeviceState {
                                           se::DeviceMemoryBase src_buffer,
                                           se::DeviceMemoryBase dst_buffer);
 
+  // Enqueues a copy of `size` bytes at `src` to `dst` onto the host-to-device
+  // stream. DMAs need pinned host memory, so the bytes are staged in chunks
+  // through a pair of pinned buffers: the next chunk is copied into one while
+  // the other is transferred. Returns once every chunk is staged, after which
+  // `src` may be reused. Blocks while both buffers are in flight.
+  Status ThenStagedMemcpyHostToDevice(const void* src, int64 size,
+                                      se::DeviceMemoryBase dst);
+
   WorkerThread* execute_thread() const { return execute_thread_.get(); }
 
   // Enqueues a host callback on 'stream', to be executed by callback_thread_.
@@ -186,6 +194,14 @@ class LocalDeviceState {
   int next_device_to_device_stream_ TF_GUARDED_BY(mu_) = 0;
   std::stack<std::unique_ptr<se::Stream>> usage_stream_pool_ TF_GUARDED_BY(mu_);
 
+  // Pinned buffers for ThenStagedMemcpyHostToDevice, allocated on first use.
+  // A buffer is in flight from when a chunk is copied into it until its
+  // transfer completes.
+  absl::Mutex staging_mu_;
+  absl::CondVar staging_buffer_released_;
+  std::vector<void*> staging_buffers_ TF_GUARDED_BY(staging_mu_);
+  std::vector<bool> staging_buffer_in_flight_ TF_GUARDED_BY(staging_mu_);
+
   std::random_device prng_seed_device_ TF_GUARDED_BY(mu_);
   std::mt19937 prng_seed_generator_ TF_GUARDED_BY(mu_);
   std::uniform_int_distribution<> prng_seed_distribution_ TF_GUARDED_BY(mu_);
@@ -84,6 +84,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/cpu_function_runtime.h"
 #include "tensorflow/compiler/xla/executable_run_options.h"
 #include "tensorflow/compiler/xla/layout.h"
+#include "tensorflow/compiler/xla/layout_util.h"
 #include "tensorflow/compiler/xla/literal.h"
 #include "tensorflow/compiler/xla/literal_util.h"
 #include "tensorflow/compiler/xla/pjrt/distributed/protocol.pb.h"
@@ -600,6 +601,40 @@ PjRtStreamExecutorBuffer::ReleaseDeviceMemoryOwnership(
       [tracked_device_buffer = std::move(tracked_device_buffer)](void*) {});
 }
 
+StatusOr<std::shared_ptr<void>>
+PjRtStreamExecutorClient::AllocatePinnedHostBuffer(int64 size) {
+  void* ptr = host_memory_allocator()->AllocateRaw(
+      tensorflow::Allocator::kAllocatorAlignment, size);
+  if (ptr == nullptr) {
+    return ResourceExhausted(
+        "Failed to allocate %d bytes of pinned host memory.", size);
+  }
+  {
+    absl::MutexLock lock(&pinned_host_buffers_mu_);
+    pinned_host_buffers_[absl::bit_cast<std::uintptr_t>(ptr)] = size;
+  }
+  return std::shared_ptr<void>(ptr, [this](void* ptr) {
+    {
+      absl::MutexLock lock(&pinned_host_buffers_mu_);
+      pinned_host_buffers_.erase(absl::bit_cast<std::uintptr_t>(ptr));
+    }
+    host_memory_allocator()->DeallocateRaw(ptr);
+  });
+}
+
+bool PjRtStreamExecutorClient::IsPinnedHostBuffer(const void* data,
+                                                  int64 size) const {
+  const std::uintptr_t start = absl::bit_cast<std::uintptr_t>(data);
+  absl::MutexLock lock(&pinned_host_buffers_mu_);
+  // The last buffer starting at or before `data`.
+  auto it = pinned_host_buffers_.upper_bound(start);
+  if (it == pinned_host_buffers_.begin()) {
+    return false;
+  }
+  --it;
+  return start + size <= it->first + it->second;
+}
+
 StatusOr<std::unique_ptr<PjRtBuffer>>
 PjRtStreamExecutorClient::BufferFromHostBuffer(
     const void* data, const Shape& shape,
@@ -683,11 +718,25 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
       py_buffer->GetBufferWithUsageHold());
   CHECK(device_buffer.ok());
 
+  // A transfer of bytes already in the on-device layout needs no
+  // linearization. If it may read the input after the call returns, the
+  // input is transferred directly from pinned memory, or otherwise staged in
+  // chunks through the pinned buffers of the device. Copying the next chunk
+  // overlaps the transfer of the previous one.
+  const bool is_byte_copy =
+      shape.is_static() && shape.has_layout() &&
+      LayoutUtil::Equal(shape.layout(), compact_shape.layout()) &&
+      host_buffer_semantics != HostBufferSemantics::kImmutableOnlyDuringCall;
+  const bool is_pinned = is_byte_copy && IsPinnedHostBuffer(data, size);
+  const bool stage_in_chunks = is_byte_copy && !is_pinned &&
+                               should_stage_host_to_device_transfers();
+
   // If necessary, allocate a host-side buffer for staging host-to-device
   // transfers. On GPU this is a buffer in pinned memory.
   std::shared_ptr<void> staging_buffer;
   if (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall ||
-      should_stage_host_to_device_transfers()) {
+      (should_stage_host_to_device_transfers() && !is_pinned &&
+       !stage_in_chunks)) {
     void* ptr = host_memory_allocator()->AllocateRaw(
         tensorflow::Allocator::kAllocatorAlignment, size);
     staging_buffer = std::shared_ptr<void>(
@@ -719,7 +768,7 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
                        on_device_shape{py_buffer->on_device_shape()},
                        staging_buffer{std::move(staging_buffer)},
                        buffer_reference{std::move(buffer_reference)},
-                       host_buffer_semantics]() {
+                       host_buffer_semantics, stage_in_chunks]() {
     PjRtStreamExecutorBuffer::ScopedHold device_buffer(movable_device_buffer);
     // This function uses TF_CHECK_OK and ValueOrDie() since we have no way
     // to report failures from a callback. However, the operations here are
@@ -743,6 +792,9 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
                                shape);
       TF_CHECK_OK(transfer_manager->TransferLiteralToDeviceAsync(
           local_device->host_to_device_stream(), literal, buffer));
+    } else if (stage_in_chunks) {
+      TF_CHECK_OK(local_device->ThenStagedMemcpyHostToDevice(
+          data, size, buffer.root_buffer()));
     } else {
       BorrowingLiteral literal(static_cast<const char*>(data), shape);
       // Otherwise, just transfer the literal.
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_PJRT_PJRT_STREAM_EXECUTOR_CLIENT_H_
 #define TENSORFLOW_COMPILER_XLA_PJRT_PJRT_STREAM_EXECUTOR_CLIENT_H_
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -219,6 +221,16 @@ class PjRtStreamExecutorClient : public PjRtClient {
     return should_stage_host_to_device_transfers_;
   }
 
+  // Allocates `size` bytes on host_memory_allocator(), which is pinned memory
+  // on GPU. Unless the semantics are kImmutableOnlyDuringCall,
+  // BufferFromHostBuffer transfers from such buffers directly instead of
+  // staging them. The buffer must be freed before the client is destroyed.
+  StatusOr<std::shared_ptr<void>> AllocatePinnedHostBuffer(int64 size);
+
+  // Returns true if [data, data + size) lies within a live buffer returned by
+  // AllocatePinnedHostBuffer.
+  bool IsPinnedHostBuffer(const void* data, int64 size) const;
+
   gpu::GpuExecutableRunOptions* gpu_run_options() const {
     return gpu_run_options_.get();
   }
@@ -246,6 +258,12 @@ class PjRtStreamExecutorClient : public PjRtClient {
   // Allocator to be used for staging memory transfers to devices.
   std::unique_ptr<tensorflow::Allocator> host_memory_allocator_;
 
+  // Sizes of the live buffers returned by AllocatePinnedHostBuffer, keyed by
+  // address.
+  mutable absl::Mutex pinned_host_buffers_mu_;
+  std::map<std::uintptr_t, int64> pinned_host_buffers_
+      TF_GUARDED_BY(pinned_host_buffers_mu_);
+
   // Includes all devices, including non-local devices on multi-host platforms.
   std::vector<std::unique_ptr<PjRtStreamExecutorDevice>> owned_devices_;
   // Pointers to `owned_devices_`.
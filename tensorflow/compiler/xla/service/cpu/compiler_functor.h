@@ -54,6 +54,21 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
   llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(
       llvm::Module& module) override;
 
+  // The steps of operator(), for callers that split code generation.
+
+  // Runs the IR optimization pipeline on 'module', invoking the pre- and
+  // post-optimization hooks.
+  void OptimizeModule(llvm::Module& module) const;
+
+  // Generates an object file for the optimized 'module' with
+  // 'target_machine'. Does not invoke the post-codegen hook, so that it can be
+  // called concurrently for different modules and target machines.
+  std::unique_ptr<llvm::MemoryBuffer> EmitObject(
+      llvm::Module& module, llvm::TargetMachine* target_machine) const;
+
+  // Invokes the post-codegen hook, if any, on 'object'.
+  void RunPostCodegenHook(const llvm::MemoryBuffer& object) const;
+
  private:
   // Populates the given pass manager with TargetLibraryInfo and
   // TargetTransformInfo passes.
@@ -77,6 +77,8 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/cpu/dot_op_emitter.h"
 #include "tensorflow/compiler/xla/service/cpu/ir_emission_utils.h"
 #include "tensorflow/compiler/xla/service/cpu/ir_emitter.h"
+#include "tensorflow/compiler/xla/service/cpu/jit_object_cache.h"
+#include "tensorflow/compiler/xla/service/cpu/parallel_branch_outliner.h"
 #include "tensorflow/compiler/xla/service/cpu/parallel_task_assignment.h"
 #include "tensorflow/compiler/xla/service/cpu/simple_orc_jit.h"
 #include "tensorflow/compiler/xla/service/dfs_hlo_visitor_with_default.h"
@@ -419,6 +421,12 @@ Status CpuCompiler::RunHloPassesAfterLayoutAssn(
     // and thread synchronization dependencies which would likely increase
     // binary size (and most AOT applications are single-threaded).
     // TODO(b/29630486) Support multi-threaded AOT.
+    if (options::ParallelBranchesEnabled(module->config())) {
+      // Outline independent branches of the entry computation first, so that
+      // ParallelTaskAssigner can still partition the ops within them.
+      pipeline.AddPass<ParallelBranchOutliner>(max_parallelism,
+                                               ShapeSizeBytesFunction());
+    }
     pipeline.AddPass<ParallelTaskAssigner>(
         max_parallelism, ShapeSizeBytesFunction(), target_machine_features);
   }
@@ -450,6 +458,17 @@ int64 memory_alignment(LogicalBuffer::Color) {
   return cpu_function_runtime::kMinAlign;
 }
 
+// Returns the ordering buffer assignment uses for 'module'. Modules with
+// parallel branches need an ordering under which the branches run
+// concurrently.
+std::unique_ptr<HloOrdering> CreateHloOrdering(const HloModule& module,
+                                               const HloSchedule& schedule) {
+  if (options::ParallelBranchesEnabled(module.config())) {
+    return absl::make_unique<ParallelBranchHloOrdering>(schedule);
+  }
+  return absl::make_unique<SequentialHloOrdering>(schedule);
+}
+
 llvm::TargetOptions CompilerTargetOptions(
     const HloModuleConfig& module_config) {
   llvm::TargetOptions target_options;
@@ -588,8 +607,7 @@ CpuCompiler::RunHloPassesAndBufferAssignement(std::unique_ptr<HloModule> module,
   // Run buffer allocation on the HLO graph.
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<BufferAssignment> assignment,
-      BufferAssigner::Run(module.get(),
-                          absl::make_unique<SequentialHloOrdering>(schedule),
+      BufferAssigner::Run(module.get(), CreateHloOrdering(*module, schedule),
                           BufferSizeBytesFunction(), memory_alignment,
                           /*allocate_buffers_for_constants=*/true));
 
@@ -660,6 +678,15 @@ StatusOr<std::unique_ptr<Executable>> CpuCompiler::RunBackend(
   auto llvm_module =
       absl::make_unique<llvm::Module>("__compute_module", *llvm_context);
 
+  // Modules found in the object cache are not compiled, so the cache is not
+  // used when the IR or the objects are to be dumped or inspected.
+  JitObjectCache* object_cache = nullptr;
+  if (options::JitObjectCacheEnabled(module->config()) &&
+      !DumpingEnabledForHloModule(*module) && !user_pre_optimization_hook_ &&
+      !user_post_optimization_hook_) {
+    object_cache = JitObjectCache::Global();
+  }
+
   auto jit = SimpleOrcJIT::Create(
       CompilerTargetOptions(module->config()),
       CodeGenOptLevel(module->config()),
@@ -667,7 +694,9 @@ StatusOr<std::unique_ptr<Executable>> CpuCompiler::RunBackend(
       module->config().debug_options().xla_llvm_disable_expensive_passes(),
       llvm_ir::GetCpuFastMathFlags(module->config()), pre_optimization_ir_hook,
       post_optimization_ir_hook,
-      OrcJITPostCompilationHook::Create(module.get()));
+      OrcJITPostCompilationHook::Create(module.get()),
+      options::JitCompileParallelism(module->config()).value_or(1),
+      object_cache, options::JitObjectCacheDirectory(module->config()));
   if (!jit) {
     return InternalError("Creating JIT failed: %s",
                          llvm::toString(jit.takeError()));
@@ -704,8 +733,7 @@ StatusOr<std::unique_ptr<Executable>> CpuCompiler::RunBackend(
   // Run buffer allocation on the HLO graph.
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<BufferAssignment> assignment,
-      BufferAssigner::Run(module.get(),
-                          absl::make_unique<SequentialHloOrdering>(schedule),
+      BufferAssigner::Run(module.get(), CreateHloOrdering(*module, schedule),
                           BufferSizeBytesFunction(), memory_alignment,
                           /*allocate_buffers_for_constants=*/true));
   DumpHloModuleIfEnabled(*module, *assignment, "after_optimizations");
@@ -26,6 +26,12 @@ const char* const kLlvmIrDotTilingFactor = "xla_llvm_dot_tiling_factor";
 const char* const kXlaForceEnableExperimentalLlvmIrGemm =
     "xla_force_enable_experimental_llvm_ir_gemm";
 const char* const kLlvmIrGemmTileSize = "xla_llvm_ir_gemm_tile_size";
+const char* const kXlaCpuParallelBranches = "xla_cpu_parallel_branches";
+const char* const kXlaCpuJitCompileParallelism =
+    "xla_cpu_jit_compile_parallelism";
+const char* const kXlaCpuJitObjectCache = "xla_cpu_jit_object_cache";
+const char* const kXlaCpuJitObjectCacheDir = "xla_cpu_jit_object_cache_dir";
+const char* const kXlaCpuPrepackDotConstants = "xla_cpu_prepack_dot_constants";
 
 }  // namespace
 
@@ -63,6 +69,47 @@ bool ForceEnableExperimentalLlvmIrGemm(const HloModuleConfig& config) {
   return extra_options_map.count(kXlaForceEnableExperimentalLlvmIrGemm) > 0;
 }
 
+bool ParallelBranchesEnabled(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  return extra_options_map.count(kXlaCpuParallelBranches) > 0;
+}
+
+absl::optional<int64> JitCompileParallelism(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  auto it = extra_options_map.find(kXlaCpuJitCompileParallelism);
+  int64 parallelism;
+  if (it != extra_options_map.end() &&
+      absl::SimpleAtoi(it->second, &parallelism)) {
+    return parallelism;
+  }
+  return absl::nullopt;
+}
+
+bool JitObjectCacheEnabled(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  return extra_options_map.count(kXlaCpuJitObjectCache) > 0 ||
+         !JitObjectCacheDirectory(config).empty();
+}
+
+string JitObjectCacheDirectory(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  auto it = extra_options_map.find(kXlaCpuJitObjectCacheDir);
+  if (it == extra_options_map.end()) {
+    return "";
+  }
+  return it->second;
+}
+
+bool DotConstantPrepackingEnabled(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  return extra_options_map.count(kXlaCpuPrepackDotConstants) > 0;
+}
+
 static absl::string_view RemoveSuffix(absl::string_view str,
                                       absl::string_view suffix) {
   CHECK_GE(str.size(), suffix.size());
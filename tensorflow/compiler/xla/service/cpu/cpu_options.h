@@ -27,6 +27,11 @@ namespace options {
 bool OptimizeForSizeRequested(const HloModuleConfig& config);
 bool VectorizedReduceDisabled(const HloModuleConfig& config);
 bool ForceEnableExperimentalLlvmIrGemm(const HloModuleConfig& config);
+bool ParallelBranchesEnabled(const HloModuleConfig& config);
+absl::optional<int64> JitCompileParallelism(const HloModuleConfig& config);
+bool JitObjectCacheEnabled(const HloModuleConfig& config);
+string JitObjectCacheDirectory(const HloModuleConfig& config);
+bool DotConstantPrepackingEnabled(const HloModuleConfig& config);
 absl::optional<int64> LlvmIrGemvTilingFactor(const HloModuleConfig& config);
 absl::optional<std::tuple<int64, int64, int64>> LlvmIrGemmTileSize(
     const HloModuleConfig& config);
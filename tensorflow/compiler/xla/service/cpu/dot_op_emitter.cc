@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "absl/strings/str_cat.h"
 #include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Value.h"
@@ -70,6 +71,10 @@ struct DotInfo {
   Shape rhs_shape;
   Shape result_shape;
   DotDimensionNumbers dim_nums;
+  // Whether the operands are constants, whose contents never change between
+  // runs.
+  bool lhs_is_constant = false;
+  bool rhs_is_constant = false;
 
   DotInfo() = default;
 
@@ -79,6 +84,8 @@ struct DotInfo {
     rhs_shape = instr.operand(1)->shape();
     result_shape = instr.shape();
     dim_nums = instr.dot_dimension_numbers();
+    lhs_is_constant = instr.operand(0)->opcode() == HloOpcode::kConstant;
+    rhs_is_constant = instr.operand(1)->opcode() == HloOpcode::kConstant;
   }
 };
 
@@ -172,6 +179,14 @@ class DotOpEmitter {
   // of rank 2 as well).
   MatMultDims GetMatMultDims() const;
 
+  // Emits a call to the Eigen matmul runtime that packs the constant (Eigen)
+  // lhs of the product once and reuses it on later runs.
+  Status EmitCallToPrepackedRuntime(const MatMultDims& mat_mult_dims,
+                                    const llvm_ir::IrArray& lhs,
+                                    const llvm_ir::IrArray& rhs,
+                                    bool transpose_lhs, bool transpose_rhs,
+                                    bool multi_threaded);
+
   // Lowers the dot operation as a tiled Matrix*Vector loop.
   void EmitTiledLlvmIrGemv();
 
@@ -735,6 +750,11 @@ Status DotOpEmitter::EmitCallToRuntime() {
   //          int32 transpose_rhs);
   // The two transpose_... parameters are actually booleans, but we use int32
   // to avoid target-dependent calling convention details.
+  //
+  // The prepacked variant, see EmitCallToPrepackedRuntime, takes two more
+  // parameters:
+  //
+  //   (float* packed_lhs, int32* packed_lhs_state)
 
   bool multi_threaded = ShouldUseMultiThreadedEigen(hlo_module_config_);
   bool use_mkl_dnn = hlo_module_config_.debug_options().xla_cpu_use_mkl_dnn();
@@ -829,10 +849,30 @@ Status DotOpEmitter::EmitCallToRuntime() {
   bool transpose_lhs = !mat_mult_dims.lhs_canonical;
   bool transpose_rhs = !mat_mult_dims.rhs_canonical;
 
+  bool lhs_is_constant = dot_info_.lhs_is_constant;
+
   if (!mat_mult_dims.lhs_column_major) {
     std::swap(mat_mult_dims.m, mat_mult_dims.n);
     std::swap(lhs, rhs);
     std::swap(transpose_lhs, transpose_rhs);
+    lhs_is_constant = dot_info_.rhs_is_constant;
+  }
+
+  // Eigen repacks both operands into the layout of its GEBP kernel on every
+  // call, which dominates skinny products, e.g. a constant weight matrix times
+  // a small batch of activations. If the (Eigen) lhs is a constant, pack it
+  // once, on the first run, into a buffer owned by the module and skip its
+  // packing on later runs. Eigen's lhs is the XLA rhs for row-major layouts,
+  // which is where the weights of x * W are.
+  //
+  // The runtime does not block the contraction dimension, so limit this to
+  // small n, where the packed rhs panel stays in cache.
+  const int64 kMaxPrepackedN = 64;
+  if (type == F32 && !use_mkl_dnn && lhs_is_constant &&
+      mat_mult_dims.n <= kMaxPrepackedN &&
+      options::DotConstantPrepackingEnabled(hlo_module_config_)) {
+    return EmitCallToPrepackedRuntime(mat_mult_dims, *lhs, *rhs, transpose_lhs,
+                                      transpose_rhs, multi_threaded);
   }
 
   b_->CreateCall(
@@ -847,6 +887,68 @@ Status DotOpEmitter::EmitCallToRuntime() {
   return Status::OK();
 }
 
+Status DotOpEmitter::EmitCallToPrepackedRuntime(
+    const MatMultDims& mat_mult_dims, const llvm_ir::IrArray& lhs,
+    const llvm_ir::IrArray& rhs, bool transpose_lhs, bool transpose_rhs,
+    bool multi_threaded) {
+  llvm::Module* module = b_->GetInsertBlock()->getModule();
+  llvm::Type* float_type = b_->getFloatTy();
+  llvm::Type* float_ptr_type = float_type->getPointerTo();
+  llvm::Type* int64_type = b_->getInt64Ty();
+  llvm::Type* int32_type = b_->getInt32Ty();
+  llvm::Type* int8_ptr_type = b_->getInt8Ty()->getPointerTo();
+  llvm::FunctionType* matmul_type = llvm::FunctionType::get(
+      b_->getVoidTy(),
+      {int8_ptr_type, float_ptr_type, float_ptr_type, float_ptr_type,
+       int64_type, int64_type, int64_type, int32_type, int32_type,
+       float_ptr_type, int32_type->getPointerTo()},
+      /*isVarArg=*/false);
+
+  llvm::FunctionCallee matmul_func = module->getOrInsertFunction(
+      runtime::kEigenPrepackedMatMulF32SymbolName, matmul_type);
+  if (auto* fn = llvm::dyn_cast<llvm::Function>(matmul_func.getCallee())) {
+    fn->setCallingConv(llvm::CallingConv::C);
+    fn->setDoesNotThrow();
+    fn->setOnlyAccessesArgMemory();
+  }
+
+  // The packed lhs and its state live as long as the module, i.e. as long as
+  // the constant they are packed from. Both start out zeroed, which the
+  // runtime reads as "not packed yet".
+  llvm::ArrayType* packed_lhs_type =
+      llvm::ArrayType::get(float_type, mat_mult_dims.m * mat_mult_dims.k);
+  auto* packed_lhs = new llvm::GlobalVariable(
+      *module, packed_lhs_type, /*isConstant=*/false,
+      llvm::GlobalValue::InternalLinkage,
+      llvm::ConstantAggregateZero::get(packed_lhs_type),
+      llvm_ir::AsStringRef(absl::StrCat(dot_hlo_name_, ".packed_lhs")));
+  packed_lhs->setAlignment(llvm::Align(64));
+  auto* packed_lhs_state = new llvm::GlobalVariable(
+      *module, int32_type, /*isConstant=*/false,
+      llvm::GlobalValue::InternalLinkage, b_->getInt32(0),
+      llvm_ir::AsStringRef(absl::StrCat(dot_hlo_name_, ".packed_lhs_state")));
+
+  // A null run options pointer makes the runtime compute the product on the
+  // calling thread.
+  llvm::Value* run_options =
+      multi_threaded
+          ? b_->CreateBitCast(executable_run_options_value_, int8_ptr_type)
+          : llvm::ConstantPointerNull::get(
+                llvm::cast<llvm::PointerType>(int8_ptr_type));
+
+  b_->CreateCall(
+      matmul_func,
+      {run_options,
+       b_->CreateBitCast(target_array_.GetBasePointer(), float_ptr_type),
+       b_->CreateBitCast(lhs.GetBasePointer(), float_ptr_type),
+       b_->CreateBitCast(rhs.GetBasePointer(), float_ptr_type),
+       b_->getInt64(mat_mult_dims.m), b_->getInt64(mat_mult_dims.n),
+       b_->getInt64(mat_mult_dims.k), b_->getInt32(transpose_lhs),
+       b_->getInt32(transpose_rhs),
+       b_->CreateBitCast(packed_lhs, float_ptr_type), packed_lhs_state});
+  return Status::OK();
+}
+
 DotOpEmitter::MatMultDims DotOpEmitter::GetMatMultDims() const {
   CHECK_LE(dot_info_.result_shape.dimensions_size(), 2);
 
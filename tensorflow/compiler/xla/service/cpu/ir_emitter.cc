@@ -26,6 +26,7 @@ limitations under the License.
 #include <vector>
 
 // IWYU pragma: no_include "llvm/IR/Intrinsics.gen.inc"
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
@@ -53,6 +54,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/cpu/elemental_ir_emitter.h"
 #include "tensorflow/compiler/xla/service/cpu/ir_emission_utils.h"
 #include "tensorflow/compiler/xla/service/cpu/ir_function.h"
+#include "tensorflow/compiler/xla/service/cpu/parallel_branch_outliner.h"
 #include "tensorflow/compiler/xla/service/cpu/parallel_loop_emitter.h"
 #include "tensorflow/compiler/xla/service/cpu/shape_partition.h"
 #include "tensorflow/compiler/xla/service/cpu/simple_orc_jit.h"
@@ -1741,6 +1743,268 @@ IrEmitter::EmitInnerLoopForVectorizedReduction(
   return result_ssa;
 }
 
+StatusOr<bool> IrEmitter::EmitVectorizedReduceOverMinorDimension(
+    HloInstruction* reduce, HloInstruction* arg, HloInstruction* init_value,
+    absl::Span<const int64> dimensions,
+    const ReductionGenerator& reduction_generator, int vectorization_factor,
+    unsigned element_alignment, string* failure_reason) {
+  const Shape& arg_shape = arg->shape();
+  const int64 minor_dimension = LayoutUtil::Minor(arg_shape.layout(), 0);
+  const int64 minor_dimension_size = arg_shape.dimensions(minor_dimension);
+  if (minor_dimension_size < vectorization_factor) {
+    *failure_reason = "reduced minor dimension is too small to vectorize";
+    return false;
+  }
+
+  TF_RETURN_IF_ERROR(EmitTargetAddressForOp(reduce));
+
+  // We're reducing over the most minor dimension R0 of the input, and possibly
+  // some other dimensions R1.  We keep a vector accumulator that is strided
+  // along R0 and only reduce its lanes once per output element:
+  //
+  //  for (d in D) {
+  //    vector_acc = init
+  //    scalar_acc = init
+  //    for (r1 in R1) {
+  //      for (r0 in R0 with stride VS) {
+  //        vector_acc = elementwise_reduce(vector_acc, input[d, r1, r0])
+  //      }
+  //      for (r0 in remainder of R0) {
+  //        scalar_acc = reduce(scalar_acc, input[d, r1, r0])
+  //      }
+  //    }
+  //    output[d] = horizontal_reduce(vector_acc, scalar_acc)
+  //  }
+
+  llvm_ir::ForLoopNest loop_nest(IrName(reduce), &b_);
+  std::vector<llvm::Value*> output_multi_index =
+      AddLoopsForVectorizedReduceOutput(
+          reduce, /*num_minor_dimensions_to_skip=*/0, &loop_nest);
+
+  if (llvm::BasicBlock* innermost_body_bb =
+          loop_nest.GetInnerLoopBodyBasicBlock()) {
+    SetToFirstInsertPoint(innermost_body_bb, &b_);
+  }
+
+  auto outermost_loop_exit_block = loop_nest.GetOuterLoopExitBasicBlock();
+
+  PrimitiveType element_type = reduce->shape().element_type();
+  ShardedVectorType vector_type =
+      CreateShardedVectorType(element_type, vectorization_factor);
+  ShardedVector vector_accumulator;
+  vector_accumulator.reserve(vector_type.size());
+  for (auto shard_type : vector_type) {
+    vector_accumulator.push_back(llvm_ir::EmitAllocaAtFunctionEntry(
+        shard_type, "vector_accumulator", &b_, 0));
+  }
+  llvm::Value* scalar_accumulator = llvm_ir::EmitAllocaAtFunctionEntry(
+      llvm_ir::PrimitiveTypeToIrType(element_type, module_),
+      "scalar_accumulator", &b_, 0);
+
+  llvm::Value* init_value_ssa = Load(GetEmittedValueFor(init_value));
+  for (int i = 0; i < vector_accumulator.size(); i++) {
+    llvm::Value* initial_value = init_value_ssa;
+    if (auto vector_shard_type =
+            llvm::dyn_cast<llvm::VectorType>(vector_type[i])) {
+      initial_value =
+          VectorSplat(vector_shard_type->getNumElements(), init_value_ssa);
+    }
+    AlignedStore(initial_value, vector_accumulator[i], element_alignment);
+  }
+  AlignedStore(init_value_ssa, scalar_accumulator, element_alignment);
+
+  std::vector<int64> outer_reduced_dimensions;
+  for (int64 dimension : dimensions) {
+    if (dimension != minor_dimension) {
+      outer_reduced_dimensions.push_back(dimension);
+    }
+  }
+
+  llvm_ir::ForLoopNest reduction_loop_nest(IrName(arg, "vectorized_inner"),
+                                           &b_);
+  std::vector<llvm::Value*> input_multi_index =
+      reduction_loop_nest.AddLoopsForShapeOnDimensions(
+          arg_shape, outer_reduced_dimensions, "reduction_dim");
+
+  if (llvm::BasicBlock* reduction_body_bb =
+          reduction_loop_nest.GetInnerLoopBodyBasicBlock()) {
+    SetToFirstInsertPoint(reduction_body_bb, &b_);
+  }
+
+  auto reduction_loop_exit_block =
+      reduction_loop_nest.GetOuterLoopExitBasicBlock();
+
+  auto it = output_multi_index.begin();
+  for (int64 i = 0; i < input_multi_index.size(); i++) {
+    if (!absl::c_linear_search(dimensions, i)) {
+      input_multi_index[i] = *it++;
+    }
+  }
+  CHECK(output_multi_index.end() == it);
+
+  llvm_ir::IrArray arg_array(GetIrArrayFor(arg));
+  const int64 vectorized_size =
+      (minor_dimension_size / vectorization_factor) * vectorization_factor;
+
+  {
+    llvm_ir::ForLoopNest vector_loop_nest(IrName(arg, "vectorized_minor"),
+                                          &b_);
+    std::unique_ptr<llvm_ir::ForLoop> loop = vector_loop_nest.AddLoop(
+        0, vectorized_size, vectorization_factor,
+        absl::StrFormat("dim.%d", minor_dimension));
+    input_multi_index[minor_dimension] = loop->GetIndVarValue();
+
+    SetToFirstInsertPoint(loop->GetBodyBasicBlock(), &b_);
+
+    llvm_ir::IrArray::Index input_index(input_multi_index, arg_shape,
+                                        b_.getInt64Ty());
+    llvm::Value* input_address = BitCast(
+        arg_array.EmitArrayElementAddress(input_index, &b_), b_.getInt8PtrTy());
+
+    for (int i = 0; i < vector_accumulator.size(); i++) {
+      auto input_address_typed =
+          BitCast(input_address, vector_accumulator[i]->getType());
+      auto current_accumulator_value =
+          AlignedLoad(vector_accumulator[i], element_alignment);
+      auto addend = AlignedLoad(input_address_typed, element_alignment);
+      arg_array.AnnotateLoadStoreInstructionWithMetadata(addend);
+
+      auto reduced_result =
+          reduction_generator(&b_, current_accumulator_value, addend);
+      AlignedStore(reduced_result, vector_accumulator[i], element_alignment);
+
+      if (i != (vector_accumulator.size() - 1)) {
+        input_address = ConstInBoundsGEP1_32(reduced_result->getType(),
+                                             input_address_typed, 1);
+      }
+    }
+
+    SetToFirstInsertPoint(loop->GetExitBasicBlock(), &b_);
+  }
+
+  if (vectorized_size != minor_dimension_size) {
+    llvm_ir::ForLoopNest epilogue_loop_nest(IrName(arg, "minor_epilogue"),
+                                            &b_);
+    std::unique_ptr<llvm_ir::ForLoop> loop = epilogue_loop_nest.AddLoop(
+        vectorized_size, minor_dimension_size,
+        absl::StrFormat("dim.%d", minor_dimension));
+    input_multi_index[minor_dimension] = loop->GetIndVarValue();
+
+    SetToFirstInsertPoint(loop->GetBodyBasicBlock(), &b_);
+
+    llvm_ir::IrArray::Index input_index(input_multi_index, arg_shape,
+                                        b_.getInt64Ty());
+    llvm::Value* element = arg_array.EmitReadArrayElement(input_index, &b_);
+    llvm::Value* reduced_result = reduction_generator(
+        &b_, AlignedLoad(scalar_accumulator, element_alignment), element);
+    AlignedStore(reduced_result, scalar_accumulator, element_alignment);
+
+    SetToFirstInsertPoint(loop->GetExitBasicBlock(), &b_);
+  }
+
+  if (reduction_loop_exit_block) {
+    SetToFirstInsertPoint(reduction_loop_exit_block, &b_);
+  }
+
+  ShardedVector vector_accumulator_ssa;
+  vector_accumulator_ssa.reserve(vector_accumulator.size());
+  for (auto accumulator_shard : vector_accumulator) {
+    vector_accumulator_ssa.push_back(
+        AlignedLoad(accumulator_shard, element_alignment));
+  }
+  llvm::Value* result = EmitHorizontalReduction(
+      reduction_generator, vector_accumulator_ssa,
+      AlignedLoad(scalar_accumulator, element_alignment));
+
+  llvm_ir::IrArray::Index output_index(output_multi_index, reduce->shape(),
+                                       b_.getInt64Ty());
+  GetIrArrayFor(reduce).EmitWriteArrayElement(output_index, result, &b_);
+
+  if (outermost_loop_exit_block) {
+    b_.SetInsertPoint(outermost_loop_exit_block);
+  }
+
+  return true;
+}
+
+std::vector<llvm::Value*> IrEmitter::AddLoopsForVectorizedReduceOutput(
+    HloInstruction* reduce, int64 num_minor_dimensions_to_skip,
+    llvm_ir::ForLoopNest* loop_nest) {
+  const Shape& shape = reduce->shape();
+  const int64 num_dims = shape.dimensions_size();
+  DynamicLoopBounds dynamic_loop_bounds;
+  if (ShouldEmitParallelLoopFor(*reduce)) {
+    dynamic_loop_bounds = compute_function_->GetDynamicLoopBounds();
+  }
+
+  // Add loops from the most major to the most minor dimension, same as
+  // ParallelLoopEmitter does.
+  std::vector<llvm::Value*> array_multi_index(num_dims);
+  for (int i = num_dims - 1; i >= num_minor_dimensions_to_skip; --i) {
+    const int64 dimension = LayoutUtil::Minor(shape.layout(), i);
+    const int bounds_index = num_dims - 1 - i;
+    std::unique_ptr<llvm_ir::ForLoop> loop;
+    if (bounds_index < dynamic_loop_bounds.size()) {
+      loop = loop_nest->AddLoop(
+          /*suffix=*/absl::StrFormat("dim.%d", dimension),
+          /*start_index=*/dynamic_loop_bounds[bounds_index].first,
+          /*end_index=*/dynamic_loop_bounds[bounds_index].second);
+    } else {
+      loop = loop_nest->AddLoop(
+          /*start_index=*/0, /*end_index=*/shape.dimensions(dimension),
+          /*suffix=*/absl::StrFormat("dim.%d", dimension));
+    }
+    array_multi_index[dimension] = loop->GetIndVarValue();
+  }
+  return array_multi_index;
+}
+
+llvm::Value* IrEmitter::EmitHorizontalReduction(
+    const ReductionGenerator& reduction_generator, const ShardedVector& vector,
+    llvm::Value* scalar) {
+  // Shards of the same type are first combined elementwise, so that we only
+  // need to reduce across the lanes of one vector of each width.
+  ShardedVector partial_results;
+  for (llvm::Value* shard : vector) {
+    auto it = absl::c_find_if(partial_results, [&](llvm::Value* partial) {
+      return partial->getType() == shard->getType();
+    });
+    if (it == partial_results.end()) {
+      partial_results.push_back(shard);
+    } else {
+      *it = reduction_generator(&b_, *it, shard);
+    }
+  }
+
+  llvm::Value* result = scalar;
+  for (llvm::Value* partial_result : partial_results) {
+    if (auto vector_type =
+            llvm::dyn_cast<llvm::VectorType>(partial_result->getType())) {
+      // Repeatedly fold the upper half of the remaining lanes onto the lower
+      // half.  Sharded vector types only have power of two widths.
+      const unsigned num_elements = vector_type->getNumElements();
+      llvm::SmallVector<llvm::Constant*, 32> mask(num_elements, nullptr);
+      for (unsigned i = num_elements; i != 1; i >>= 1) {
+        for (unsigned j = 0; j < num_elements; ++j) {
+          if (j < (i / 2)) {
+            mask[j] = b_.getInt32(i / 2 + j);
+          } else {
+            mask[j] = llvm::UndefValue::get(b_.getInt32Ty());
+          }
+        }
+        llvm::Value* half_remaining_lanes = b_.CreateShuffleVector(
+            partial_result, llvm::UndefValue::get(vector_type),
+            llvm::ConstantVector::get(mask));
+        partial_result =
+            reduction_generator(&b_, partial_result, half_remaining_lanes);
+      }
+      partial_result = b_.CreateExtractElement(partial_result, b_.getInt32(0));
+    }
+    result = reduction_generator(&b_, result, partial_result);
+  }
+  return result;
+}
+
 void IrEmitter::EmitShardedVectorStore(
     llvm::Value* store_address, const std::vector<llvm::Value*>& value_to_store,
     const int alignment, const llvm_ir::IrArray& containing_array) {
@@ -1806,8 +2070,16 @@ StatusOr<bool> IrEmitter::EmitVectorizedReduce(
       MinimumAlignmentForPrimitiveType(reduce->shape().element_type()));
 
   if (is_reduction_over_minor_dimension) {
-    // TODO(sanjoy): Implement vectorized reduction over the minor dimension.
-    *failure_reason = "reduction over minor dimension not implemented";
+    return EmitVectorizedReduceOverMinorDimension(
+        reduce, arg, init_value, dimensions, reduction_generator,
+        vectorization_factor, element_alignment, failure_reason);
+  }
+
+  if (ShouldEmitParallelLoopFor(*reduce) &&
+      num_dynamic_loop_bounds_ >= reduce->shape().dimensions_size()) {
+    // The innermost output dimension is strided by the vectorization factor
+    // below, which we can't do within the bounds of an arbitrary partition.
+    *failure_reason = "partitioned innermost output dimension not supported";
     return false;
   }
 
@@ -1835,17 +2107,9 @@ StatusOr<bool> IrEmitter::EmitVectorizedReduce(
   //  }
 
   llvm_ir::ForLoopNest loop_nest(IrName(reduce), &b_);
-  std::vector<llvm::Value*> array_multi_index(
-      reduce->shape().dimensions_size());
-  for (int i = LayoutUtil::MinorToMajor(reduce->shape()).size() - 1; i > 0;
-       --i) {
-    int64 dimension = LayoutUtil::Minor(reduce->shape().layout(), i);
-    int64 start_index = 0;
-    int64 end_index = reduce->shape().dimensions(dimension);
-    std::unique_ptr<llvm_ir::ForLoop> loop = loop_nest.AddLoop(
-        start_index, end_index, absl::StrFormat("dim.%d", dimension));
-    array_multi_index[dimension] = loop->GetIndVarValue();
-  }
+  std::vector<llvm::Value*> array_multi_index =
+      AddLoopsForVectorizedReduceOutput(
+          reduce, /*num_minor_dimensions_to_skip=*/1, &loop_nest);
 
   int64 innermost_dimension = LayoutUtil::Minor(reduce->shape().layout(), 0);
   int64 innermost_dimension_size =
@@ -2250,6 +2514,10 @@ Status IrEmitter::HandleFusion(HloInstruction* fusion) {
 }
 
 Status IrEmitter::HandleCall(HloInstruction* call) {
+  if (IsParallelBranchCall(*call)) {
+    return EmitParallelBranchCalls(call);
+  }
+
   HloComputation* computation = call->to_apply();
   llvm::Function* call_ir_function = FindOrDie(emitted_functions_, computation);
 
@@ -2276,6 +2544,29 @@ Status IrEmitter::HandleCall(HloInstruction* call) {
   return Status::OK();
 }
 
+Status IrEmitter::EmitParallelBranchCalls(HloInstruction* call) {
+  // All branches of the computation are dispatched together when the first of
+  // them is reached. Their operands are parameters and constants, so they are
+  // available at that point.
+  if (emitted_value_.contains(call)) {
+    return Status::OK();
+  }
+
+  std::vector<llvm::Function*> branch_functions;
+  for (HloInstruction* branch : call->parent()->instructions()) {
+    if (!IsParallelBranchCall(*branch)) {
+      continue;
+    }
+    TF_RETURN_IF_ERROR(EmitTargetAddressForOp(branch));
+    branch_functions.push_back(
+        FindOrDie(emitted_functions_, branch->to_apply()));
+  }
+  return EmitCallToParallelCalls(
+      GetExecutableRunOptionsArgument(), GetBufferTableArgument(),
+      GetProfileCountersArgument(), branch_functions, &b_,
+      absl::StrCat(call->parent()->name(), "_parallel_branches"));
+}
+
 Status IrEmitter::HandleSliceToDynamic(HloInstruction* hlo) {
   TF_RETURN_IF_ERROR(EmitTargetAddressForOp(hlo));
   std::vector<llvm::Value*> dynamic_dims;
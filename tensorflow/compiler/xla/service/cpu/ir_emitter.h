@@ -294,6 +294,10 @@ class IrEmitter : public DfsHloVisitorWithDefault,
   // to explicitly pass parameters or return results.
   void EmitGlobalCall(const HloComputation& callee, absl::string_view name);
 
+  // Emits a runtime call which runs all parallel branch calls of `call`'s
+  // computation concurrently, if they have not been emitted yet.
+  Status EmitParallelBranchCalls(HloInstruction* call);
+
   // Returns the buffer to which a global call to `callee` would have written
   // its result.
   llvm::Value* GetBufferForGlobalCallReturnValue(const HloComputation& callee);
@@ -408,6 +412,29 @@ class IrEmitter : public DfsHloVisitorWithDefault,
       HloInstruction* arg, absl::Span<const int64> dimensions,
       unsigned element_alignment);
 
+  // Emits a vectorized reduction over a set of dimensions that includes the
+  // most minor dimension of "arg".  Helper function for EmitVectorizedReduce.
+  StatusOr<bool> EmitVectorizedReduceOverMinorDimension(
+      HloInstruction* reduce, HloInstruction* arg, HloInstruction* init_value,
+      absl::Span<const int64> dimensions,
+      const ReductionGenerator& reduction_generator, int vectorization_factor,
+      unsigned element_alignment, string* failure_reason);
+
+  // Adds loops over the dimensions of the output of "reduce" to "loop_nest",
+  // from the most major one down to, but excluding, the
+  // "num_minor_dimensions_to_skip" most minor ones.  If "reduce" is emitted as
+  // a parallel loop, the loops over the partitioned dimensions only cover the
+  // current partition.  Returns the multi-index formed by the induction
+  // variables, with nullptr for the skipped dimensions.
+  std::vector<llvm::Value*> AddLoopsForVectorizedReduceOutput(
+      HloInstruction* reduce, int64 num_minor_dimensions_to_skip,
+      llvm_ir::ForLoopNest* loop_nest);
+
+  // Reduces all the elements of "vector" and "scalar" to a single scalar.
+  llvm::Value* EmitHorizontalReduction(
+      const ReductionGenerator& reduction_generator,
+      const ShardedVector& vector, llvm::Value* scalar);
+
   // Tries to emit a fast concatenate operation using memcpy.  Returns true if
   // successful, and false on failure.  On failure, sets "failure_reason" to a
   // string describing why it could not emit a fast concatenate.
@@ -337,5 +337,58 @@ Status EmitCallToParallelForkJoin(
   return Status::OK();
 }
 
+Status EmitCallToParallelCalls(llvm::Value* exec_run_options_arg,
+                               llvm::Value* buffer_table_arg,
+                               llvm::Value* profile_counters_arg,
+                               absl::Span<llvm::Function* const> functions,
+                               llvm::IRBuilder<>* b, const string& name) {
+  llvm::Module* module = b->GetInsertBlock()->getModule();
+  llvm::Type* i8_ptr_type = b->getInt8PtrTy();
+
+  // Build ParallelCalls function type.
+  llvm::FunctionType* parallel_calls_type = llvm::FunctionType::get(
+      /*Result=*/llvm::Type::getVoidTy(module->getContext()),
+      /*Params=*/
+      {i8_ptr_type, i8_ptr_type->getPointerTo(),
+       llvm::Type::getInt64PtrTy(module->getContext()), b->getInt32Ty(),
+       i8_ptr_type->getPointerTo()},
+      /*isVarArg=*/false);
+
+  llvm::Function* parallel_calls_func = llvm::dyn_cast<llvm::Function>(
+      module
+          ->getOrInsertFunction(runtime::kParallelCallsSymbolName,
+                                parallel_calls_type)
+          .getCallee());
+  parallel_calls_func->setCallingConv(llvm::CallingConv::C);
+  parallel_calls_func->setDoesNotThrow();
+
+  // Create global variable out of the compute function pointers.
+  std::vector<llvm::Constant*> function_ptrs;
+  function_ptrs.reserve(functions.size());
+  for (llvm::Function* function : functions) {
+    function_ptrs.push_back(
+        llvm::ConstantExpr::getBitCast(function, i8_ptr_type));
+  }
+  llvm::ArrayType* function_ptrs_array_type =
+      llvm::ArrayType::get(i8_ptr_type, function_ptrs.size());
+  llvm::GlobalVariable* global_function_ptrs_array = new llvm::GlobalVariable(
+      /*M=*/*module,
+      /*Ty=*/function_ptrs_array_type,
+      /*isConstant=*/true,
+      /*Linkage=*/llvm::GlobalValue::PrivateLinkage,
+      /*Initializer=*/
+      llvm::ConstantArray::get(function_ptrs_array_type, function_ptrs),
+      /*Name=*/absl::StrCat(name, "_parallel_functions"));
+
+  b->CreateCall(
+      parallel_calls_func,
+      {b->CreateBitCast(exec_run_options_arg, i8_ptr_type),
+       b->CreateBitCast(buffer_table_arg, i8_ptr_type->getPointerTo()),
+       profile_counters_arg, b->getInt32(functions.size()),
+       b->CreateBitCast(global_function_ptrs_array,
+                        i8_ptr_type->getPointerTo())});
+  return Status::OK();
+}
+
 }  // namespace cpu
 }  // namespace xla
@@ -134,6 +134,14 @@ Status EmitCallToParallelForkJoin(
     const std::vector<int64>& dimension_partition_counts, llvm::IRBuilder<>* b,
     llvm::Function* parallel_function, const string& name);
 
+// Emits a call to a runtime function which calls the embedded computation
+// functions 'functions' in parallel (and joins threads before returning).
+Status EmitCallToParallelCalls(llvm::Value* exec_run_options_arg,
+                               llvm::Value* buffer_table_arg,
+                               llvm::Value* profile_counters_arg,
+                               absl::Span<llvm::Function* const> functions,
+                               llvm::IRBuilder<>* b, const string& name);
+
 }  // namespace cpu
 }  // namespace xla
 
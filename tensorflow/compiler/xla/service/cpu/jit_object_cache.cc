@@ -0,0 +1,206 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/cpu/jit_object_cache.h"
+
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "llvm/Support/raw_ostream.h"
+#include "tensorflow/core/platform/coding.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/path.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+// Bumped whenever the key or the on-disk format changes, so stale entries are
+// never read back.
+const char* const kCacheFormatVersion = "1";
+
+const char* const kCacheFileSuffix = ".xla_objects";
+
+// Default limit of the objects the process-wide cache keeps in memory.
+const int64 kDefaultMaxInMemoryBytes = 256LL << 20;
+
+std::string CacheFilePath(const std::string& directory,
+                          const std::string& key) {
+  return tensorflow::io::JoinPath(directory,
+                                  absl::StrCat(key, kCacheFileSuffix));
+}
+
+// An entry is stored as the number of objects followed by each object's size
+// and bytes, with sizes as varints.
+std::string SerializeEntry(const std::vector<std::string>& entry) {
+  std::string serialized;
+  tensorflow::core::PutVarint64(&serialized, entry.size());
+  for (const std::string& object : entry) {
+    tensorflow::core::PutVarint64(&serialized, object.size());
+    serialized.append(object);
+  }
+  return serialized;
+}
+
+absl::optional<std::vector<std::string>> DeserializeEntry(
+    absl::string_view serialized) {
+  tensorflow::StringPiece input(serialized.data(), serialized.size());
+  uint64 num_objects;
+  if (!tensorflow::core::GetVarint64(&input, &num_objects)) {
+    return absl::nullopt;
+  }
+  std::vector<std::string> entry;
+  for (uint64 i = 0; i < num_objects; ++i) {
+    uint64 size;
+    if (!tensorflow::core::GetVarint64(&input, &size) || size > input.size()) {
+      return absl::nullopt;
+    }
+    entry.emplace_back(input.data(), size);
+    input.remove_prefix(size);
+  }
+  if (!input.empty()) {
+    return absl::nullopt;
+  }
+  return entry;
+}
+
+}  // namespace
+
+/*static*/ JitObjectCache* JitObjectCache::Global() {
+  static JitObjectCache* cache = new JitObjectCache(kDefaultMaxInMemoryBytes);
+  return cache;
+}
+
+/*static*/ std::string JitObjectCache::Key(const llvm::Module& module,
+                                           absl::string_view compile_options) {
+  std::string ir;
+  llvm::raw_string_ostream ostream(ir);
+  module.print(ostream, /*AAW=*/nullptr);
+  ostream.flush();
+  tensorflow::Fprint128 fingerprint = tensorflow::Fingerprint128(
+      absl::StrCat(kCacheFormatVersion, ";", compile_options, ";", ir));
+  return absl::StrCat(absl::Hex(fingerprint.high64, absl::kZeroPad16),
+                      absl::Hex(fingerprint.low64, absl::kZeroPad16));
+}
+
+absl::optional<JitObjectCache::Objects> JitObjectCache::Lookup(
+    const std::string& key, const std::string& directory) {
+  Entry entry;
+  {
+    tensorflow::mutex_lock lock(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      entry = it->second;
+    }
+  }
+
+  if (entry.empty() && !directory.empty()) {
+    std::string serialized;
+    tensorflow::Env* env = tensorflow::Env::Default();
+    const std::string path = CacheFilePath(directory, key);
+    if (env->FileExists(path).ok() &&
+        tensorflow::ReadFileToString(env, path, &serialized).ok()) {
+      absl::optional<Entry> deserialized = DeserializeEntry(serialized);
+      if (deserialized.has_value() && !deserialized->empty()) {
+        VLOG(1) << "Read JIT objects for " << key << " from " << path;
+        entry = std::move(*deserialized);
+        tensorflow::mutex_lock lock(mu_);
+        InsertInMemory(key, entry);
+      } else {
+        LOG(WARNING) << "Ignoring corrupt JIT object cache file " << path;
+      }
+    }
+  }
+
+  if (entry.empty()) {
+    return absl::nullopt;
+  }
+  Objects objects;
+  for (const std::string& object : entry) {
+    objects.push_back(llvm::MemoryBuffer::getMemBufferCopy(object, key));
+  }
+  return std::move(objects);
+}
+
+void JitObjectCache::Insert(const std::string& key, const Objects& objects,
+                            const std::string& directory) {
+  Entry entry;
+  for (const std::unique_ptr<llvm::MemoryBuffer>& object : objects) {
+    entry.emplace_back(object->getBufferStart(), object->getBufferSize());
+  }
+
+  if (!directory.empty()) {
+    // Write to a temporary file first so that concurrent readers, possibly in
+    // other processes, never see a partially written entry.
+    tensorflow::Env* env = tensorflow::Env::Default();
+    const std::string path = CacheFilePath(directory, key);
+    std::string temp_path;
+    tensorflow::Status status = env->RecursivelyCreateDir(directory);
+    if (status.ok()) {
+      std::string unique_path = path;
+      if (env->CreateUniqueFileName(&unique_path, ".tmp")) {
+        temp_path = std::move(unique_path);
+      } else {
+        status =
+            tensorflow::errors::Internal("Cannot create a unique file name");
+      }
+    }
+    if (status.ok()) {
+      status = tensorflow::WriteStringToFile(env, temp_path,
+                                             SerializeEntry(entry));
+    }
+    if (status.ok()) {
+      status = env->RenameFile(temp_path, path);
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to write JIT objects to " << path << ": "
+                   << status;
+      if (!temp_path.empty()) {
+        env->DeleteFile(temp_path).IgnoreError();
+      }
+    }
+  }
+
+  tensorflow::mutex_lock lock(mu_);
+  InsertInMemory(key, std::move(entry));
+}
+
+void JitObjectCache::InsertInMemory(const std::string& key, Entry entry) {
+  int64 size = 0;
+  for (const std::string& object : entry) {
+    size += object.size();
+  }
+  if (size > max_in_memory_bytes_ ||
+      !entries_.emplace(key, std::move(entry)).second) {
+    return;
+  }
+  insertion_order_.push_back(key);
+  in_memory_bytes_ += size;
+
+  while (in_memory_bytes_ > max_in_memory_bytes_) {
+    auto it = entries_.find(insertion_order_.front());
+    for (const std::string& object : it->second) {
+      in_memory_bytes_ -= object.size();
+    }
+    entries_.erase(it);
+    insertion_order_.pop_front();
+  }
+}
+
+}  // namespace cpu
+}  // namespace xla
@@ -0,0 +1,97 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_CPU_JIT_OBJECT_CACHE_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_CPU_JIT_OBJECT_CACHE_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace xla {
+namespace cpu {
+
+// Caches the object files SimpleOrcJIT generates for an LLVM module, so that
+// compiling an identical module again skips optimization and code generation.
+//
+// Entries are keyed by a fingerprint of the module's unoptimized IR and of the
+// options it is compiled with. A module may compile to several objects when its
+// code generation is split across threads; all of them are cached together.
+//
+// Entries are kept in memory, up to a size limit, and optionally in a
+// directory so that they survive process restarts. Objects on disk are only
+// valid for the binary that wrote them: processes built from different sources
+// must not share a cache directory.
+//
+// Thread-safe.
+class JitObjectCache {
+ public:
+  using Objects = std::vector<std::unique_ptr<llvm::MemoryBuffer>>;
+
+  // 'max_in_memory_bytes': entries are evicted from memory, oldest first, once
+  // the objects held exceed this size.
+  explicit JitObjectCache(int64 max_in_memory_bytes)
+      : max_in_memory_bytes_(max_in_memory_bytes) {}
+
+  // Returns the process-wide cache used by the CPU JIT.
+  static JitObjectCache* Global();
+
+  // Returns the key of 'module' compiled with 'compile_options', an opaque
+  // string which must capture every setting that affects the generated code
+  // but is not recorded in the module itself.
+  static std::string Key(const llvm::Module& module,
+                         absl::string_view compile_options);
+
+  // Returns copies of the objects cached under 'key', or nullopt if there are
+  // none. On a miss in memory, looks for the entry in 'directory' (if not
+  // empty) and keeps it in memory if found.
+  absl::optional<Objects> Lookup(const std::string& key,
+                                 const std::string& directory);
+
+  // Caches copies of 'objects' under 'key', and writes them to 'directory' if
+  // not empty. Failing to write to 'directory' is logged but not an error.
+  void Insert(const std::string& key, const Objects& objects,
+              const std::string& directory);
+
+ private:
+  // The bytes of the objects of one entry.
+  using Entry = std::vector<std::string>;
+
+  void InsertInMemory(const std::string& key, Entry entry)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64 max_in_memory_bytes_;
+
+  tensorflow::mutex mu_;
+  absl::flat_hash_map<std::string, Entry> entries_ TF_GUARDED_BY(mu_);
+  // Keys of 'entries_' in insertion order, for eviction.
+  std::deque<std::string> insertion_order_ TF_GUARDED_BY(mu_);
+  int64 in_memory_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_CPU_JIT_OBJECT_CACHE_H_
@@ -0,0 +1,108 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/cpu/jit_object_cache.h"
+
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "tensorflow/compiler/xla/test.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+JitObjectCache::Objects MakeObjects(const std::vector<std::string>& contents) {
+  JitObjectCache::Objects objects;
+  for (const std::string& content : contents) {
+    objects.push_back(llvm::MemoryBuffer::getMemBufferCopy(content));
+  }
+  return objects;
+}
+
+std::vector<std::string> ObjectContents(
+    const JitObjectCache::Objects& objects) {
+  std::vector<std::string> contents;
+  for (const auto& object : objects) {
+    contents.push_back(object->getBuffer().str());
+  }
+  return contents;
+}
+
+TEST(JitObjectCacheTest, KeyDependsOnModuleAndOptions) {
+  llvm::LLVMContext context;
+  llvm::FunctionType* function_type =
+      llvm::FunctionType::get(llvm::Type::getVoidTy(context), false);
+  llvm::Module a("module", context);
+  llvm::Function::Create(function_type, llvm::GlobalValue::ExternalLinkage,
+                         "f", &a);
+  llvm::Module b("module", context);
+  llvm::Function::Create(function_type, llvm::GlobalValue::ExternalLinkage,
+                         "g", &b);
+
+  EXPECT_EQ(JitObjectCache::Key(a, "options"),
+            JitObjectCache::Key(a, "options"));
+  EXPECT_NE(JitObjectCache::Key(a, "options"),
+            JitObjectCache::Key(b, "options"));
+  EXPECT_NE(JitObjectCache::Key(a, "options"),
+            JitObjectCache::Key(a, "other_options"));
+}
+
+TEST(JitObjectCacheTest, LookupReturnsInsertedObjects) {
+  JitObjectCache cache(/*max_in_memory_bytes=*/1 << 20);
+  EXPECT_FALSE(cache.Lookup("key", /*directory=*/"").has_value());
+
+  cache.Insert("key", MakeObjects({"object0", "object1"}), /*directory=*/"");
+  absl::optional<JitObjectCache::Objects> objects =
+      cache.Lookup("key", /*directory=*/"");
+  ASSERT_TRUE(objects.has_value());
+  EXPECT_THAT(ObjectContents(*objects),
+              ::testing::ElementsAre("object0", "object1"));
+  EXPECT_FALSE(cache.Lookup("other_key", /*directory=*/"").has_value());
+}
+
+TEST(JitObjectCacheTest, OldestEntriesAreEvicted) {
+  JitObjectCache cache(/*max_in_memory_bytes=*/10);
+  cache.Insert("a", MakeObjects({"aaaaaa"}), /*directory=*/"");
+  cache.Insert("b", MakeObjects({"bbbbbb"}), /*directory=*/"");
+
+  EXPECT_FALSE(cache.Lookup("a", /*directory=*/"").has_value());
+  EXPECT_TRUE(cache.Lookup("b", /*directory=*/"").has_value());
+}
+
+TEST(JitObjectCacheTest, EntriesPersistInDirectory) {
+  const std::string directory =
+      tensorflow::io::JoinPath(tensorflow::testing::TmpDir(), "jit_objects");
+  {
+    JitObjectCache cache(/*max_in_memory_bytes=*/1 << 20);
+    cache.Insert("key", MakeObjects({"object0", "", "object2"}), directory);
+  }
+
+  // A new cache, as in a new process, reads the entry back from disk.
+  JitObjectCache cache(/*max_in_memory_bytes=*/1 << 20);
+  EXPECT_FALSE(cache.Lookup("key", /*directory=*/"").has_value());
+  absl::optional<JitObjectCache::Objects> objects =
+      cache.Lookup("key", directory);
+  ASSERT_TRUE(objects.has_value());
+  EXPECT_THAT(ObjectContents(*objects),
+              ::testing::ElementsAre("object0", "", "object2"));
+  EXPECT_TRUE(cache.Lookup("key", /*directory=*/"").has_value());
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
@@ -0,0 +1,219 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/cpu/parallel_branch_outliner.h"
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "tensorflow/compiler/xla/service/hlo_computation.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/hlo_opcode.h"
+
+namespace xla {
+namespace cpu {
+
+namespace {
+
+const char* const kParallelBranchAttribute = "_xla_cpu_parallel_branch";
+
+// Minimum cost of a branch worth running on its own thread; 100us of work on a
+// 2GHz core, as in the parallel task cost model.
+const int64 kMinBranchCost = 100000;
+
+// A set of instructions computing one operand of the entry root, in
+// topological order.
+struct Branch {
+  std::vector<HloInstruction*> instructions;
+  int64 cost = 0;
+};
+
+// Parameters and constants are available before any branch runs, so branches
+// read them instead of outlining them.
+bool IsBranchInput(const HloInstruction* instruction) {
+  return instruction->opcode() == HloOpcode::kParameter ||
+         instruction->opcode() == HloOpcode::kConstant;
+}
+
+// Returns the branch computing 'output', or nullopt if part of it is used
+// outside of the branch or cannot be outlined. 'post_order' is the post order
+// of 'output's computation and 'root' its root.
+absl::optional<Branch> FindBranch(
+    HloInstruction* output, const HloInstruction* root,
+    const std::vector<HloInstruction*>& post_order,
+    const HloCostAnalysis& cost_analysis) {
+  for (const HloInstruction* user : output->users()) {
+    if (user != root) {
+      return absl::nullopt;
+    }
+  }
+
+  absl::flat_hash_set<HloInstruction*> members;
+  std::vector<HloInstruction*> worklist = {output};
+  while (!worklist.empty()) {
+    HloInstruction* instruction = worklist.back();
+    worklist.pop_back();
+    if (IsBranchInput(instruction) || !members.insert(instruction).second) {
+      continue;
+    }
+    if (instruction->HasSideEffect() ||
+        !instruction->control_predecessors().empty() ||
+        !instruction->control_successors().empty()) {
+      return absl::nullopt;
+    }
+    for (HloInstruction* operand : instruction->operands()) {
+      worklist.push_back(operand);
+    }
+  }
+
+  Branch branch;
+  for (HloInstruction* instruction : post_order) {
+    if (!members.contains(instruction)) {
+      continue;
+    }
+    if (instruction != output) {
+      for (const HloInstruction* user : instruction->users()) {
+        if (!members.contains(user)) {
+          return absl::nullopt;
+        }
+      }
+    }
+    branch.instructions.push_back(instruction);
+    branch.cost += cost_analysis.flop_count(*instruction) +
+                   2 * cost_analysis.transcendental_count(*instruction) +
+                   10 * cost_analysis.bytes_accessed(*instruction);
+  }
+  return branch;
+}
+
+}  // namespace
+
+bool IsParallelBranchCall(const HloInstruction& instruction) {
+  return instruction.opcode() == HloOpcode::kCall &&
+         instruction.frontend_attributes().map().count(
+             kParallelBranchAttribute) > 0;
+}
+
+StatusOr<bool> ParallelBranchOutliner::Run(HloModule* module) {
+  XLA_VLOG_LINES(3, "ParallelBranchOutliner ENTRY\n" + module->ToString());
+  if (max_parallelism_ < 2) {
+    return false;
+  }
+
+  HloComputation* computation = module->entry_computation();
+  HloInstruction* root = computation->root_instruction();
+  HloCostAnalysis cost_analysis(shape_size_function_);
+  Status status = root->Accept(&cost_analysis);
+  if (!status.ok()) {
+    // HloCostAnalysis does not support every HLO (e.g. some CustomCalls).
+    VLOG(2) << "Not outlining parallel branches: " << status;
+    return false;
+  }
+
+  const std::vector<HloInstruction*> post_order =
+      computation->MakeInstructionPostOrder();
+  std::vector<Branch> branches;
+  absl::flat_hash_set<const HloInstruction*> outputs;
+  for (HloInstruction* operand : root->operands()) {
+    if (IsBranchInput(operand) || !outputs.insert(operand).second) {
+      continue;
+    }
+    absl::optional<Branch> branch =
+        FindBranch(operand, root, post_order, cost_analysis);
+    if (branch.has_value() && branch->cost >= kMinBranchCost) {
+      branches.push_back(std::move(*branch));
+    }
+  }
+  if (branches.size() < 2) {
+    return false;
+  }
+
+  // Keep the most expensive branches if there are more than threads; the rest
+  // run in the entry computation as before.
+  absl::c_stable_sort(branches, [](const Branch& a, const Branch& b) {
+    return a.cost > b.cost;
+  });
+  if (static_cast<int64>(branches.size()) > max_parallelism_) {
+    branches.resize(max_parallelism_);
+  }
+
+  for (const Branch& branch : branches) {
+    HloInstruction* call = module->OutlineExpressionFromComputation(
+        branch.instructions,
+        absl::StrCat("parallel_branch_", branch.instructions.back()->name()),
+        computation);
+    FrontendAttributes attributes = call->frontend_attributes();
+    (*attributes.mutable_map())[kParallelBranchAttribute] = "true";
+    call->set_frontend_attributes(attributes);
+    VLOG(2) << "Outlined parallel branch " << call->to_apply()->name()
+            << " with cost " << branch.cost;
+  }
+
+  XLA_VLOG_LINES(3, "ParallelBranchOutliner EXIT\n" + module->ToString());
+  return true;
+}
+
+ParallelBranchHloOrdering::ParallelBranchHloOrdering(
+    const HloSchedule& schedule)
+    : SequentialHloOrdering(schedule) {
+  for (const auto& computation_sequence : schedule_.sequences()) {
+    for (const HloInstruction* instruction :
+         computation_sequence.second.instructions()) {
+      if (IsParallelBranchCall(*instruction)) {
+        branch_position_[instruction->parent()] =
+            order_position_.at(instruction);
+        break;
+      }
+    }
+  }
+}
+
+const HloInstructionSequence* ParallelBranchHloOrdering::SequentialOrder(
+    const HloComputation& computation) const {
+  if (branch_position_.contains(&computation)) {
+    return nullptr;
+  }
+  return SequentialHloOrdering::SequentialOrder(computation);
+}
+
+string ParallelBranchHloOrdering::ToString() const {
+  return absl::StrCat("ParallelBranchHloOrdering\n", schedule_.ToString());
+}
+
+bool ParallelBranchHloOrdering::ExecutesBeforeInSameComputation(
+    const HloInstruction* a, const HloInstruction* b) const {
+  CHECK_EQ(a->parent(), b->parent());
+  auto position =
+      [&](const HloInstruction* instruction) -> absl::optional<int> {
+    if (IsParallelBranchCall(*instruction)) {
+      return branch_position_.at(instruction->parent());
+    }
+    auto it = order_position_.find(instruction);
+    if (it == order_position_.end()) {
+      return absl::nullopt;
+    }
+    return it->second;
+  };
+  // If either instruction is not in the order, then 'a' and 'b' are unordered.
+  // Branch calls share a position, so they are unordered with each other.
+  absl::optional<int> a_position = position(a);
+  absl::optional<int> b_position = position(b);
+  return a_position.has_value() && b_position.has_value() &&
+         *a_position < *b_position;
+}
+
+}  // namespace cpu
+}  // namespace xla
@@ -0,0 +1,96 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_CPU_PARALLEL_BRANCH_OUTLINER_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_CPU_PARALLEL_BRANCH_OUTLINER_H_
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/compiler/xla/service/hlo_cost_analysis.h"
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/service/hlo_ordering.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
+
+namespace xla {
+namespace cpu {
+
+// Returns true if 'instruction' is a kCall created by ParallelBranchOutliner.
+// All such calls in a computation are run concurrently, at the position of the
+// first of them in the computation's schedule.
+bool IsParallelBranchCall(const HloInstruction& instruction);
+
+// ParallelBranchOutliner finds independent subgraphs ("branches") feeding the
+// root of the entry computation and outlines each of them into its own
+// embedded computation, invoked by a kCall that is lowered in codegen to a
+// single runtime call which runs all branches on the intra-op thread pool.
+//
+// A branch is the set of instructions that only the given root operand (and
+// transitively, only the branch) uses, stopping at parameters and constants.
+// Branches without side effects whose estimated cost exceeds a minimum are
+// outlined, up to 'max_parallelism' of them, if there are at least two.
+//
+// Because branches run concurrently, buffer assignment must use
+// ParallelBranchHloOrdering for modules this pass changed.
+class ParallelBranchOutliner : public HloModulePass {
+ public:
+  // 'max_parallelism': the maximum number of branches run concurrently.
+  // 'shape_size': shape size function used by HloCostAnalysis to estimate
+  //               branch costs.
+  ParallelBranchOutliner(const int64 max_parallelism,
+                         const HloCostAnalysis::ShapeSizeFunction& shape_size)
+      : max_parallelism_(max_parallelism), shape_size_function_(shape_size) {}
+  ~ParallelBranchOutliner() override {}
+
+  absl::string_view name() const override {
+    return "cpu-parallel-branch-outliner";
+  }
+
+  // Run parallel branch outliner on 'module'.
+  // Returns true if the computation was changed, false otherwise.
+  StatusOr<bool> Run(HloModule* module) override;
+
+ private:
+  int64 max_parallelism_;
+  HloCostAnalysis::ShapeSizeFunction shape_size_function_;
+};
+
+// A SequentialHloOrdering which accounts for parallel branch calls: all
+// branch calls of a computation execute at the position of the first of them,
+// and are unordered with respect to each other. Computations containing branch
+// calls have no sequential order, so buffer assignment checks their buffers
+// for interference pairwise and gives the branch computations disjoint
+// allocations.
+class ParallelBranchHloOrdering : public SequentialHloOrdering {
+ public:
+  explicit ParallelBranchHloOrdering(const HloSchedule& schedule);
+  ~ParallelBranchHloOrdering() override = default;
+
+  const HloInstructionSequence* SequentialOrder(
+      const HloComputation& computation) const override;
+
+  string ToString() const override;
+
+ protected:
+  bool ExecutesBeforeInSameComputation(const HloInstruction* a,
+                                       const HloInstruction* b) const override;
+
+ private:
+  // The position of the first branch call in each computation with branches.
+  absl::flat_hash_map<const HloComputation*, int> branch_position_;
+};
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_CPU_PARALLEL_BRANCH_OUTLINER_H_
@@ -0,0 +1,153 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/cpu/parallel_branch_outliner.h"
+
+#include "tensorflow/compiler/xla/service/cpu/cpu_executable.h"
+#include "tensorflow/compiler/xla/service/hlo_matchers.h"
+#include "tensorflow/compiler/xla/service/hlo_memory_scheduler.h"
+#include "tensorflow/compiler/xla/test.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace xla {
+namespace {
+
+namespace op = xla::testing::opcode_matchers;
+
+class ParallelBranchOutlinerTest : public HloTestBase {
+ protected:
+  const HloCostAnalysis::ShapeSizeFunction shape_size_func_ =
+      cpu::CpuExecutable::ShapeSizeBytes;
+
+  const int max_parallelism_ = 4;
+
+  StatusOr<bool> RunParallelBranchOutliner(HloModule* module) {
+    return cpu::ParallelBranchOutliner(max_parallelism_, shape_size_func_)
+        .Run(module);
+  }
+};
+
+TEST_F(ParallelBranchOutlinerTest, IndependentBranchesAreOutlined) {
+  const string hlo_string = R"(
+    HloModule TestParallelBranches
+    ENTRY Branches {
+      p0 = f32[1024,1024]{1,0} parameter(0)
+      p1 = f32[1024,1024]{1,0} parameter(1)
+      exp0 = f32[1024,1024]{1,0} exponential(p0)
+      a = f32[1024,1024]{1,0} add(exp0, p0)
+      exp1 = f32[1024,1024]{1,0} exponential(p1)
+      b = f32[1024,1024]{1,0} multiply(exp1, p1)
+      ROOT tuple = (f32[1024,1024]{1,0}, f32[1024,1024]{1,0}) tuple(a, b)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelBranchOutliner(m.get()));
+  EXPECT_TRUE(changed);
+
+  HloInstruction* root = m->entry_computation()->root_instruction();
+  EXPECT_THAT(root, op::Tuple(op::Call(op::Parameter(0)),
+                              op::Call(op::Parameter(1))));
+  EXPECT_TRUE(cpu::IsParallelBranchCall(*root->operand(0)));
+  EXPECT_TRUE(cpu::IsParallelBranchCall(*root->operand(1)));
+  EXPECT_THAT(root->operand(0)->to_apply()->root_instruction(),
+              op::Add(op::Exp(op::Parameter(0)), op::Parameter(0)));
+}
+
+TEST_F(ParallelBranchOutlinerTest, SharedInstructionsAreNotOutlined) {
+  const string hlo_string = R"(
+    HloModule TestParallelBranches
+    ENTRY Branches {
+      p0 = f32[1024,1024]{1,0} parameter(0)
+      p1 = f32[1024,1024]{1,0} parameter(1)
+      exp0 = f32[1024,1024]{1,0} exponential(p0)
+      a = f32[1024,1024]{1,0} add(exp0, p1)
+      b = f32[1024,1024]{1,0} multiply(exp0, p1)
+      ROOT tuple = (f32[1024,1024]{1,0}, f32[1024,1024]{1,0}) tuple(a, b)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelBranchOutliner(m.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(ParallelBranchOutlinerTest, CheapBranchesAreNotOutlined) {
+  const string hlo_string = R"(
+    HloModule TestParallelBranches
+    ENTRY Branches {
+      p0 = f32[16]{0} parameter(0)
+      p1 = f32[16]{0} parameter(1)
+      a = f32[16]{0} exponential(p0)
+      b = f32[16]{0} exponential(p1)
+      ROOT tuple = (f32[16]{0}, f32[16]{0}) tuple(a, b)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelBranchOutliner(m.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(ParallelBranchOutlinerTest, BranchesAreUnorderedWithEachOther) {
+  const string hlo_string = R"(
+    HloModule TestParallelBranches
+    ENTRY Branches {
+      p0 = f32[1024,1024]{1,0} parameter(0)
+      p1 = f32[1024,1024]{1,0} parameter(1)
+      a = f32[1024,1024]{1,0} exponential(p0)
+      b = f32[1024,1024]{1,0} exponential(p1)
+      ROOT tuple = (f32[1024,1024]{1,0}, f32[1024,1024]{1,0}) tuple(a, b)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelBranchOutliner(m.get()));
+  ASSERT_TRUE(changed);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      HloSchedule schedule,
+      ScheduleModule(m.get(), [](const BufferValue& buffer) {
+        return ShapeUtil::ByteSizeOf(buffer.shape(), sizeof(void*));
+      }));
+  cpu::ParallelBranchHloOrdering ordering(schedule);
+
+  const HloComputation* entry = m->entry_computation();
+  const HloInstruction* root = entry->root_instruction();
+  const HloInstruction* a = root->operand(0);
+  const HloInstruction* b = root->operand(1);
+  EXPECT_EQ(ordering.SequentialOrder(*entry), nullptr);
+  EXPECT_FALSE(ordering.ExecutesBefore(a, b));
+  EXPECT_FALSE(ordering.ExecutesBefore(b, a));
+  EXPECT_TRUE(ordering.ExecutesBefore(a, root));
+  EXPECT_TRUE(ordering.ExecutesBefore(b, root));
+
+  // Instructions of the branch computations are unordered, so their buffers
+  // may not share memory.
+  EXPECT_FALSE(
+      ordering.ExecutesBefore(a->to_apply()->root_instruction(),
+                              b->to_apply()->root_instruction()));
+  EXPECT_FALSE(
+      ordering.ExecutesBefore(b->to_apply()->root_instruction(),
+                              a->to_apply()->root_instruction()));
+}
+
+}  // namespace
+}  // namespace xla
@@ -79,7 +79,13 @@ class DefaultCostModel : public ParallelCostModel {
           max_parallelism_,
           std::ceil(std::sqrt(tensorflow::port::MaxParallelism())));
       // Use shape size instruction cost and L2 cache size min per-thread cost.
-      instruction_cost = shape_size_(instruction->shape());
+      // Reductions read much more than they write, so they are costed by the
+      // size of their input instead.
+      const HloOpcode opcode = instruction->opcode();
+      instruction_cost =
+          opcode == HloOpcode::kReduce || opcode == HloOpcode::kReduceWindow
+              ? shape_size_(instruction->operand(0)->shape())
+              : shape_size_(instruction->shape());
       min_cost_per_thread = 256LL << 10;  // 256KB L2 Cache size.
     } else {
       // Use max parallelism for compute bound instructions.
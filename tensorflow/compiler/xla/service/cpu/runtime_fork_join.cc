@@ -30,6 +30,8 @@ using tensorflow::uint64;
 
 using ComputeFunctionType = void (*)(void*, const void*, const void**, void**,
                                      int64*, uint64*);
+using GlobalComputeFunctionType = void (*)(void*, const void*, const void**,
+                                           void**, uint64*);
 
 // Dispatches 'num_partitions - 1' calls to 'function_ptr' in parallel.
 // Calls 'function_ptr' for first partition inline.
@@ -102,3 +104,50 @@ TF_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_ParallelForkJoin(
   bc.Wait();
   VLOG(2) << "ParallelForkJoin EXIT";
 }
+
+// Dispatches 'num_functions - 1' calls to the compute functions in
+// 'function_ptrs' in parallel and calls the first one inline, then waits for
+// all of them. The functions are embedded computations which communicate only
+// through 'buffer_table', so they receive no result or parameter pointers.
+//
+// Runs the functions one after the other if the run options have no intra-op
+// thread pool.
+TF_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_ParallelCalls(
+    const void* run_options_ptr, void** buffer_table, uint64* prof_counters,
+    int32 num_functions, void** function_ptrs) {
+  VLOG(2) << "ParallelCalls ENTRY num_functions: " << num_functions;
+  CHECK_GT(num_functions, 0);
+  CHECK_NE(function_ptrs, nullptr);
+  const xla::ExecutableRunOptions* run_options =
+      static_cast<const xla::ExecutableRunOptions*>(run_options_ptr);
+  CHECK_NE(run_options, nullptr);
+
+  auto call = [&](int32 i) {
+    GlobalComputeFunctionType function =
+        reinterpret_cast<GlobalComputeFunctionType>(function_ptrs[i]);
+    function(nullptr, run_options_ptr, nullptr, buffer_table, prof_counters);
+  };
+
+  if (run_options->intra_op_thread_pool() == nullptr) {
+    for (int32 i = 0; i < num_functions; ++i) {
+      call(i);
+    }
+    VLOG(2) << "ParallelCalls EXIT";
+    return;
+  }
+
+  tensorflow::BlockingCounter bc(num_functions - 1);
+  for (int32 i = 1; i < num_functions; ++i) {
+    run_options->intra_op_thread_pool()->enqueueNoNotification(
+        [i, &call, &bc]() {
+          call(i);
+          bc.DecrementCount();
+          VLOG(3) << "ParallelCalls function " << i << " done.";
+        });
+  }
+
+  call(0);
+  VLOG(3) << "ParallelCalls function 0 done.";
+  bc.Wait();
+  VLOG(2) << "ParallelCalls EXIT";
+}
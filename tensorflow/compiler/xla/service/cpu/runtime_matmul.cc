@@ -17,6 +17,10 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/compiler/xla/executable_run_options.h"
 #include "tensorflow/compiler/xla/service/cpu/runtime_lightweight_check.h"
@@ -89,6 +93,144 @@ void MatMulDispatch(const void* run_options_ptr, T* out, T* lhs, T* rhs,
                               transpose_lhs, transpose_rhs);
 }
 
+// States of a prepacked LHS buffer.
+enum PackedLhsState : tensorflow::int32 {
+  kUnpacked = 0,
+  kPacking = 1,
+  kPacked = 2,
+};
+
+struct AlignedFree {
+  void operator()(void* ptr) const { Eigen::internal::aligned_free(ptr); }
+};
+
+template <typename T>
+std::unique_ptr<T, AlignedFree> AlignedAlloc(tensorflow::int64 size) {
+  return std::unique_ptr<T, AlignedFree>(
+      static_cast<T*>(Eigen::internal::aligned_malloc(size * sizeof(T))));
+}
+
+// Packs the m x k matrix 'lhs', column-major or row-major as given by
+// StorageOrder, into the layout Eigen's GEBP kernel reads its LHS in.
+template <typename T, int StorageOrder>
+void PackLhs(const T* lhs, tensorflow::int64 m, tensorflow::int64 k,
+             T* packed) {
+  using Mapper =
+      Eigen::internal::const_blas_data_mapper<T, tensorflow::int64,
+                                              StorageOrder>;
+  using Traits = Eigen::internal::gebp_traits<T, T>;
+  Eigen::internal::gemm_pack_lhs<T, tensorflow::int64, Mapper, Traits::mr,
+                                 Traits::LhsProgress,
+                                 typename Traits::LhsPacket4Packing,
+                                 StorageOrder>
+      pack_lhs;
+  pack_lhs(packed, Mapper(lhs, StorageOrder == Eigen::ColMajor ? m : k), k, m);
+}
+
+// Packs the k x n matrix 'rhs', column-major or row-major as given by
+// StorageOrder, into the layout Eigen's GEBP kernel reads its RHS in.
+template <typename T, int StorageOrder>
+void PackRhs(const T* rhs, tensorflow::int64 k, tensorflow::int64 n,
+             T* packed) {
+  using Mapper =
+      Eigen::internal::const_blas_data_mapper<T, tensorflow::int64,
+                                              StorageOrder>;
+  using Traits = Eigen::internal::gebp_traits<T, T>;
+  Eigen::internal::gemm_pack_rhs<T, tensorflow::int64, Mapper, Traits::nr,
+                                 StorageOrder>
+      pack_rhs;
+  pack_rhs(packed, Mapper(rhs, StorageOrder == Eigen::ColMajor ? k : n), k, n);
+}
+
+// Computes out = lhs * rhs from packed operands. The product is not blocked
+// along k, so this is meant for a small n, where the packed RHS stays in cache.
+template <typename T>
+void PackedMatMul(const xla::ExecutableRunOptions* run_options, T* out,
+                  const T* packed_lhs, const T* packed_rhs, tensorflow::int64 m,
+                  tensorflow::int64 n, tensorflow::int64 k) {
+  using OutMapper =
+      Eigen::internal::blas_data_mapper<T, tensorflow::int64, Eigen::ColMajor>;
+  using Traits = Eigen::internal::gebp_traits<T, T>;
+  std::fill(out, out + m * n, T(0));
+
+  // The packed LHS is a sequence of panels of Traits::mr rows, with the last
+  // rows packed into narrower panels, so row blocks starting at a multiple of
+  // Traits::mr can be multiplied independently.
+  auto multiply_rows = [&](tensorflow::int64 begin, tensorflow::int64 end) {
+    Eigen::internal::gebp_kernel<T, T, tensorflow::int64, OutMapper,
+                                 Traits::mr, Traits::nr, false, false>
+        gebp;
+    gebp(OutMapper(out + begin, m), packed_lhs + begin * k, packed_rhs,
+         end - begin, k, n, T(1));
+  };
+
+  const Eigen::ThreadPoolDevice* thread_pool =
+      run_options == nullptr ? nullptr : run_options->intra_op_thread_pool();
+  if (thread_pool == nullptr) {
+    multiply_rows(0, m);
+    return;
+  }
+  const tensorflow::int64 num_panels = (m + Traits::mr - 1) / Traits::mr;
+  const Eigen::TensorOpCost panel_cost(
+      /*bytes_loaded=*/sizeof(T) * Traits::mr * (k + n),
+      /*bytes_stored=*/sizeof(T) * Traits::mr * n,
+      /*compute_cycles=*/2.0 * Traits::mr * k * n);
+  thread_pool->parallelFor(
+      num_panels, panel_cost,
+      [&](Eigen::Index first_panel, Eigen::Index last_panel) {
+        multiply_rows(first_panel * Traits::mr,
+                      std::min<tensorflow::int64>(last_panel * Traits::mr, m));
+      });
+}
+
+template <typename T>
+void PrepackedMatMul(const void* run_options_ptr, T* out, T* lhs, T* rhs,
+                     tensorflow::int64 m, tensorflow::int64 n,
+                     tensorflow::int64 k, tensorflow::int32 transpose_lhs,
+                     tensorflow::int32 transpose_rhs, T* packed_lhs,
+                     tensorflow::int32* packed_lhs_state) {
+  static_assert(sizeof(std::atomic<tensorflow::int32>) ==
+                    sizeof(tensorflow::int32),
+                "std::atomic<int32> must have the size of an int32");
+  auto* state =
+      reinterpret_cast<std::atomic<tensorflow::int32>*>(packed_lhs_state);
+  auto pack_lhs = [&](T* packed) {
+    if (transpose_lhs) {
+      PackLhs<T, Eigen::RowMajor>(lhs, m, k, packed);
+    } else {
+      PackLhs<T, Eigen::ColMajor>(lhs, m, k, packed);
+    }
+  };
+
+  // The first call packs 'lhs' into 'packed_lhs'. Calls racing with it pack a
+  // private copy rather than waiting.
+  const T* lhs_panels = packed_lhs;
+  std::unique_ptr<T, AlignedFree> private_lhs;
+  tensorflow::int32 expected = kUnpacked;
+  if (state->load(std::memory_order_acquire) != kPacked) {
+    if (state->compare_exchange_strong(expected, kPacking,
+                                       std::memory_order_acquire)) {
+      pack_lhs(packed_lhs);
+      state->store(kPacked, std::memory_order_release);
+    } else if (expected != kPacked) {
+      private_lhs = AlignedAlloc<T>(m * k);
+      pack_lhs(private_lhs.get());
+      lhs_panels = private_lhs.get();
+    }
+  }
+
+  std::unique_ptr<T, AlignedFree> packed_rhs = AlignedAlloc<T>(k * n);
+  if (transpose_rhs) {
+    PackRhs<T, Eigen::RowMajor>(rhs, k, n, packed_rhs.get());
+  } else {
+    PackRhs<T, Eigen::ColMajor>(rhs, k, n, packed_rhs.get());
+  }
+
+  PackedMatMul<T>(
+      static_cast<const xla::ExecutableRunOptions*>(run_options_ptr), out,
+      lhs_panels, packed_rhs.get(), m, n, k);
+}
+
 }  // namespace
 
 TF_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_EigenMatMulF16(
@@ -142,3 +284,13 @@ TF_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_EigenMatMulS32(
   MatMulDispatch<tensorflow::int32>(run_options_ptr, out, lhs, rhs, m, n, k,
                                     transpose_lhs, transpose_rhs);
 }
+
+TF_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_EigenPrepackedMatMulF32(
+    const void* run_options_ptr, float* out, float* lhs, float* rhs,
+    tensorflow::int64 m, tensorflow::int64 n, tensorflow::int64 k,
+    tensorflow::int32 transpose_lhs, tensorflow::int32 transpose_rhs,
+    float* packed_lhs, tensorflow::int32* packed_lhs_state) {
+  PrepackedMatMul<float>(run_options_ptr, out, lhs, rhs, m, n, k,
+                         transpose_lhs, transpose_rhs, packed_lhs,
+                         packed_lhs_state);
+}
@@ -64,6 +64,22 @@ extern void __xla_cpu_runtime_EigenMatMulS32(
     tensorflow::int64 m, tensorflow::int64 n, tensorflow::int64 k,
     tensorflow::int32 transpose_lhs, tensorflow::int32 transpose_rhs);
 
+// Like __xla_cpu_runtime_EigenMatMulF32, for an 'lhs' whose contents never
+// change, e.g. a constant. 'lhs' is packed into the panel layout of Eigen's
+// GEBP kernel once, into 'packed_lhs' (m * k floats, aligned for Eigen
+// packets), and later calls reuse the packed panels instead of repacking 'lhs'.
+// '*packed_lhs_state' must be zero-initialized together with 'packed_lhs', and
+// is otherwise owned by this function.
+//
+// If 'run_options_ptr' is null the product is computed on the calling thread,
+// otherwise on its intra-op thread pool.
+extern void __xla_cpu_runtime_EigenPrepackedMatMulF32(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, float* out,
+    float* lhs, float* rhs, tensorflow::int64 m, tensorflow::int64 n,
+    tensorflow::int64 k, tensorflow::int32 transpose_lhs,
+    tensorflow::int32 transpose_rhs, float* packed_lhs,
+    tensorflow::int32* packed_lhs_state);
+
 }  // extern "C"
 
 #endif  // TENSORFLOW_COMPILER_XLA_SERVICE_CPU_RUNTIME_MATMUL_H_
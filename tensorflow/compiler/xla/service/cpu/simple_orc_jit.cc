@@ -23,6 +23,9 @@ limitations under the License.
 #include <utility>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
@@ -30,6 +33,8 @@ limitations under the License.
 #include "llvm/IR/Operator.h"
 #include "llvm/Support/CodeGen.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "tensorflow/compiler/xla/service/cpu/cpu_runtime.h"
 #include "tensorflow/compiler/xla/service/cpu/orc_jit_memory_mapper.h"
 #include "tensorflow/compiler/xla/service/cpu/runtime_conv2d.h"
@@ -48,7 +53,10 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/cpu/windows_compatibility.h"
 #include "tensorflow/compiler/xla/service/custom_call_target_registry.h"
 #include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace xla {
 namespace cpu {
@@ -92,8 +100,18 @@ SimpleOrcJIT::SimpleOrcJIT(
     bool disable_expensive_passes, llvm::FastMathFlags fast_math_flags,
     LLVMCompiler::ModuleHook pre_optimization_hook,
     LLVMCompiler::ModuleHook post_optimization_hook,
-    std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook)
-    : target_machine_(InferTargetMachineForJIT(target_options, opt_level)),
+    std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+    int num_compile_threads, JitObjectCache* object_cache,
+    std::string object_cache_directory)
+    : target_options_(target_options),
+      opt_level_(opt_level),
+      optimize_for_size_(optimize_for_size),
+      disable_expensive_passes_(disable_expensive_passes),
+      fast_math_flags_(fast_math_flags),
+      num_compile_threads_(std::max(1, num_compile_threads)),
+      object_cache_(object_cache),
+      object_cache_directory_(std::move(object_cache_directory)),
+      target_machine_(InferTargetMachineForJIT(target_options, opt_level)),
       data_layout_(target_machine_->createDataLayout()),
       target_process_control_(std::move(target_process_control)),
       execution_session_(std::move(execution_session)),
@@ -102,13 +120,11 @@ SimpleOrcJIT::SimpleOrcJIT(
                       return std::make_unique<llvm::SectionMemoryManager>(
                           orc_jit_memory_mapper::GetInstance());
                     }),
-      compile_layer_(
-          *execution_session_, object_layer_,
-          std::make_unique<CompilerFunctor>(
-              target_machine_.get(), opt_level, optimize_for_size,
-              disable_expensive_passes, fast_math_flags,
-              std::move(pre_optimization_hook),
-              std::move(post_optimization_hook), std::move(post_codegen_hook))),
+      compiler_(target_machine_.get(), opt_level, optimize_for_size,
+                disable_expensive_passes, fast_math_flags,
+                std::move(pre_optimization_hook),
+                std::move(post_optimization_hook),
+                std::move(post_codegen_hook)),
       main_jit_dylib_(&execution_session_->createBareJITDylib("<main>")),
       gdb_jit_event_listener_(
           llvm::JITEventListener::createGDBRegistrationListener()) {
@@ -162,7 +178,9 @@ llvm::Expected<std::unique_ptr<SimpleOrcJIT>> SimpleOrcJIT::Create(
     bool disable_expensive_passes, llvm::FastMathFlags fast_math_flags,
     LLVMCompiler::ModuleHook pre_optimization_hook,
     LLVMCompiler::ModuleHook post_optimization_hook,
-    std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook) {
+    std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+    int num_compile_threads, JitObjectCache* object_cache,
+    std::string object_cache_directory) {
   auto SSP = std::make_shared<llvm::orc::SymbolStringPool>();
   auto target_process_control =
       llvm::orc::SelfTargetProcessControl::Create(std::move(SSP));
@@ -175,7 +193,8 @@ llvm::Expected<std::unique_ptr<SimpleOrcJIT>> SimpleOrcJIT::Create(
       std::move(*target_process_control), std::move(execution_session),
       target_options, opt_level, optimize_for_size, disable_expensive_passes,
       fast_math_flags, std::move(pre_optimization_hook),
-      std::move(post_optimization_hook), std::move(post_codegen_hook));
+      std::move(post_optimization_hook), std::move(post_codegen_hook),
+      num_compile_threads, object_cache, std::move(object_cache_directory));
 }
 
 llvm::JITEvaluatedSymbol SimpleOrcJIT::ResolveRuntimeSymbol(
@@ -218,7 +237,144 @@ void SimpleOrcJIT::notifyFreeingObject(llvm::JITEventListener::ObjectKey key) {
 }
 
 llvm::Error SimpleOrcJIT::AddModule(llvm::orc::ThreadSafeModule module) {
-  return compile_layer_.add(*main_jit_dylib_, std::move(module));
+  llvm::Expected<JitObjectCache::Objects> objects = module.withModuleDo(
+      [this](llvm::Module& m) -> llvm::Expected<JitObjectCache::Objects> {
+        std::string key;
+        if (object_cache_ != nullptr) {
+          key = JitObjectCache::Key(m, CompileOptionsFingerprint());
+          absl::optional<JitObjectCache::Objects> cached =
+              object_cache_->Lookup(key, object_cache_directory_);
+          if (cached.has_value()) {
+            VLOG(1) << "Found objects of " << m.getName().str()
+                    << " in the JIT object cache";
+            return std::move(*cached);
+          }
+        }
+        llvm::Expected<JitObjectCache::Objects> compiled = CompileModule(m);
+        if (compiled && object_cache_ != nullptr) {
+          object_cache_->Insert(key, *compiled, object_cache_directory_);
+        }
+        return compiled;
+      });
+  if (!objects) {
+    return objects.takeError();
+  }
+  for (std::unique_ptr<llvm::MemoryBuffer>& object : *objects) {
+    if (llvm::Error err =
+            object_layer_.add(*main_jit_dylib_, std::move(object))) {
+      return err;
+    }
+  }
+  return llvm::Error::success();
+}
+
+llvm::Expected<JitObjectCache::Objects> SimpleOrcJIT::CompileModule(
+    llvm::Module& module) {
+  compiler_.OptimizeModule(module);
+
+  int num_functions = 0;
+  for (const llvm::Function& function : module.functions()) {
+    if (!function.isDeclaration()) {
+      num_functions++;
+    }
+  }
+
+  JitObjectCache::Objects objects;
+  const int num_partitions = std::min(num_compile_threads_, num_functions);
+  if (num_partitions > 1) {
+    llvm::Expected<JitObjectCache::Objects> emitted =
+        EmitObjectsInParallel(module, num_partitions);
+    if (!emitted) {
+      return emitted.takeError();
+    }
+    objects = std::move(*emitted);
+  } else {
+    objects.push_back(compiler_.EmitObject(module, target_machine_.get()));
+  }
+
+  for (const std::unique_ptr<llvm::MemoryBuffer>& object : objects) {
+    compiler_.RunPostCodegenHook(*object);
+  }
+  return std::move(objects);
+}
+
+llvm::Expected<JitObjectCache::Objects> SimpleOrcJIT::EmitObjectsInParallel(
+    llvm::Module& module, int num_partitions) {
+  // The module is split after optimization, so that the split does not get in
+  // the way of inlining. Locals referenced across partitions are externalized
+  // with hidden visibility, and resolved when the objects are linked into the
+  // same JITDylib.
+  std::vector<std::string> bitcodes;
+  llvm::SplitModule(
+      llvm::CloneModule(module), num_partitions,
+      [&](std::unique_ptr<llvm::Module> partition) {
+        // Each thread needs its own context, so partitions are moved to new
+        // contexts by round-tripping them through bitcode.
+        bitcodes.emplace_back();
+        llvm::raw_string_ostream ostream(bitcodes.back());
+        llvm::WriteBitcodeToFile(*partition, ostream);
+      },
+      /*PreserveLocals=*/false);
+
+  // Target machines are not thread-safe, so each thread gets its own.
+  std::vector<std::unique_ptr<llvm::TargetMachine>> target_machines;
+  for (int i = 0; i < bitcodes.size(); ++i) {
+    target_machines.push_back(
+        InferTargetMachineForJIT(target_options_, opt_level_));
+  }
+
+  JitObjectCache::Objects objects(bitcodes.size());
+  std::vector<std::string> errors(bitcodes.size());
+  {
+    tensorflow::thread::ThreadPool thread_pool(
+        tensorflow::Env::Default(), "xla_cpu_codegen", bitcodes.size());
+    tensorflow::BlockingCounter counter(bitcodes.size());
+    for (int i = 0; i < bitcodes.size(); ++i) {
+      thread_pool.Schedule([&, i] {
+        llvm::LLVMContext context;
+        llvm::Expected<std::unique_ptr<llvm::Module>> partition =
+            llvm::parseBitcodeFile(
+                llvm::MemoryBufferRef(bitcodes[i], module.getName()), context);
+        if (partition) {
+          objects[i] =
+              compiler_.EmitObject(**partition, target_machines[i].get());
+        } else {
+          errors[i] = llvm::toString(partition.takeError());
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+
+  for (int i = 0; i < errors.size(); ++i) {
+    if (!errors[i].empty()) {
+      return llvm::make_error<llvm::StringError>(
+          absl::StrCat("Failed to move LLVM module partition ", i, ": ",
+                       errors[i]),
+          llvm::inconvertibleErrorCode());
+    }
+  }
+  return std::move(objects);
+}
+
+std::string SimpleOrcJIT::CompileOptionsFingerprint() const {
+  auto bit = [](bool value) { return value ? "1" : "0"; };
+  return absl::StrCat(
+      target_machine_->getTargetTriple().str(), ";",
+      target_machine_->getTargetCPU().str(), ";",
+      target_machine_->getTargetFeatureString().str(), ";",
+      static_cast<int>(opt_level_), ";", bit(optimize_for_size_),
+      bit(disable_expensive_passes_), ";", bit(fast_math_flags_.allowReassoc()),
+      bit(fast_math_flags_.noNaNs()), bit(fast_math_flags_.noInfs()),
+      bit(fast_math_flags_.noSignedZeros()),
+      bit(fast_math_flags_.allowReciprocal()),
+      bit(fast_math_flags_.allowContract()),
+      bit(fast_math_flags_.approxFunc()), ";",
+      static_cast<int>(target_options_.AllowFPOpFusion),
+      bit(target_options_.UnsafeFPMath), bit(target_options_.NoInfsFPMath),
+      bit(target_options_.NoNaNsFPMath),
+      bit(target_options_.NoSignedZerosFPMath));
 }
 
 llvm::Expected<llvm::JITEvaluatedSymbol> SimpleOrcJIT::FindCompiledSymbol(
@@ -261,6 +417,7 @@ bool RegisterKnownJITSymbols() {
   REGISTER_CPU_RUNTIME_SYMBOL(EigenFft);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulF16);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulF32);
+  REGISTER_CPU_RUNTIME_SYMBOL(EigenPrepackedMatMulF32);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulF64);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulC64);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulC128);
@@ -279,6 +436,7 @@ bool RegisterKnownJITSymbols() {
   REGISTER_CPU_RUNTIME_SYMBOL(EigenSingleThreadedMatMulC128);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenSingleThreadedMatMulS32);
   REGISTER_CPU_RUNTIME_SYMBOL(ParallelForkJoin);
+  REGISTER_CPU_RUNTIME_SYMBOL(ParallelCalls);
   REGISTER_CPU_RUNTIME_SYMBOL(ReleaseInfeedBufferAfterDequeue);
   REGISTER_CPU_RUNTIME_SYMBOL(ReleaseOutfeedBufferAfterPopulation);
   REGISTER_CPU_RUNTIME_SYMBOL(KeyValueSort);
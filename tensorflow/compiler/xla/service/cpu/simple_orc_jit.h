@@ -23,13 +23,14 @@ limitations under the License.
 #include "llvm/ADT/Triple.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/Orc/Core.h"
-#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/Orc/SymbolStringPool.h"
 #include "llvm/ExecutionEngine/Orc/TargetProcessControl.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Target/TargetMachine.h"
 #include "tensorflow/compiler/xla/service/cpu/compiler_functor.h"
+#include "tensorflow/compiler/xla/service/cpu/jit_object_cache.h"
 #include "tensorflow/compiler/xla/types.h"
 
 namespace xla {
@@ -43,16 +44,27 @@ namespace cpu {
 // Supports JIT-ing multiple modules but without cross-module linking.
 // Implements eager compilation - the module is lowered to binary as soon as
 // it's added to the JIT.
+//
+// Code generation of a module can be split across threads, and the generated
+// objects can be cached so that adding an identical module again skips
+// compilation altogether.
 class SimpleOrcJIT : public llvm::JITEventListener {
  public:
   using ObjLayerT = llvm::orc::RTDyldObjectLinkingLayer;
-  using CompileLayerT = llvm::orc::IRCompileLayer;
 
   // Create a new JIT, targeting the host architecture.
   //
   // {pre,post}_optimization_hook is invoked on the module before/after all
   // LLVM IR-level optimizations.  post_codegen_hook is invoked after
-  // compiling to machine code.
+  // compiling to machine code. None of them are invoked for modules found in
+  // the object cache.
+  //
+  // num_compile_threads is the number of threads machine code generation of a
+  // module is split across; 1 generates code on the calling thread.
+  //
+  // object_cache, if not null, caches the objects generated for modules, and
+  // must outlive the JIT. object_cache_directory, if not empty, is the
+  // directory the cache persists them in.
   SimpleOrcJIT(
       std::unique_ptr<llvm::orc::TargetProcessControl> target_process_control,
       std::unique_ptr<llvm::orc::ExecutionSession> execution_session,
@@ -61,7 +73,9 @@ class SimpleOrcJIT : public llvm::JITEventListener {
       bool disable_expensive_passes, llvm::FastMathFlags fast_math_flags,
       LLVMCompiler::ModuleHook pre_optimization_hook,
       LLVMCompiler::ModuleHook post_optimization_hook,
-      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook);
+      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+      int num_compile_threads, JitObjectCache* object_cache,
+      std::string object_cache_directory);
 
   static llvm::Expected<std::unique_ptr<SimpleOrcJIT>> Create(
       const llvm::TargetOptions& target_options,
@@ -69,7 +83,9 @@ class SimpleOrcJIT : public llvm::JITEventListener {
       bool disable_expensive_passes, llvm::FastMathFlags fast_math_flags,
       LLVMCompiler::ModuleHook pre_optimization_hook,
       LLVMCompiler::ModuleHook post_optimization_hook,
-      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook);
+      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+      int num_compile_threads, JitObjectCache* object_cache,
+      std::string object_cache_directory);
 
   ~SimpleOrcJIT() override;
 
@@ -79,6 +95,7 @@ class SimpleOrcJIT : public llvm::JITEventListener {
     return target_machine_->getTargetTriple();
   }
 
+  // Compiles 'module' and adds the resulting objects to the JIT.
   llvm::Error AddModule(llvm::orc::ThreadSafeModule module);
 
   // Get the runtime address of the compiled symbol whose name is given. Returns
@@ -101,18 +118,40 @@ class SimpleOrcJIT : public llvm::JITEventListener {
  private:
   llvm::JITEvaluatedSymbol ResolveRuntimeSymbol(llvm::StringRef name);
 
+  // Optimizes 'module' and generates its objects, splitting code generation
+  // across up to num_compile_threads_ threads.
+  llvm::Expected<JitObjectCache::Objects> CompileModule(llvm::Module& module);
+
+  // Splits the optimized 'module' into 'num_partitions' modules, generating
+  // code for each of them on its own thread.
+  llvm::Expected<JitObjectCache::Objects> EmitObjectsInParallel(
+      llvm::Module& module, int num_partitions);
+
+  // Returns a string describing the settings, other than the module itself,
+  // that determine the generated code. Part of the object cache keys.
+  std::string CompileOptionsFingerprint() const;
+
   void notifyObjectLoaded(
       llvm::JITEventListener::ObjectKey key,
       const llvm::object::ObjectFile& object,
       const llvm::RuntimeDyld::LoadedObjectInfo& object_info) override;
   void notifyFreeingObject(llvm::JITEventListener::ObjectKey key) override;
 
+  const llvm::TargetOptions target_options_;
+  const llvm::CodeGenOpt::Level opt_level_;
+  const bool optimize_for_size_;
+  const bool disable_expensive_passes_;
+  const llvm::FastMathFlags fast_math_flags_;
+  const int num_compile_threads_;
+  JitObjectCache* object_cache_;
+  const std::string object_cache_directory_;
+
   std::unique_ptr<llvm::TargetMachine> target_machine_;
   const llvm::DataLayout data_layout_;
   std::unique_ptr<llvm::orc::TargetProcessControl> target_process_control_;
   std::unique_ptr<llvm::orc::ExecutionSession> execution_session_;
   ObjLayerT object_layer_;
-  CompileLayerT compile_layer_;
+  CompilerFunctor compiler_;
   llvm::orc::JITDylib* main_jit_dylib_;
   int64 size_of_generated_code_in_bytes_ = 0;
 
@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 
 #include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/literal_util.h"
 #include "tensorflow/compiler/xla/service/cpu/cpu_compiler.h"
 #include "tensorflow/compiler/xla/service/cpu/test_target_triple_helper.h"
 #include "tensorflow/compiler/xla/service/cpu/tests/cpu_codegen_test.h"
@@ -108,6 +109,43 @@ INSTANTIATE_TEST_SUITE_P(CpuEigenDotOperationTestInstantiation,
                          ::testing::ValuesIn(GetDotTestCases()),
                          DotTestSpecToString);
 
+class CpuEigenPrepackedDotOperationTest : public CpuCodegenTest {
+ protected:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = CpuCodegenTest::GetDebugOptionsForTest();
+    (*debug_options.mutable_xla_backend_extra_options())
+        ["xla_cpu_prepack_dot_constants"] = "";
+    return debug_options;
+  }
+};
+
+TEST_F(CpuEigenPrepackedDotOperationTest, ConstantWeights) {
+  HloComputation::Builder builder(TestName());
+
+  auto input_shape = ShapeUtil::MakeShape(F32, {8, 256});
+  HloInstruction* input = builder.AddInstruction(
+      HloInstruction::CreateParameter(0, input_shape, "input"));
+  HloInstruction* weights = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR2F32Linspace(
+          /*from=*/-1.0f, /*to=*/1.0f, /*rows=*/256, /*cols=*/256)));
+
+  builder.AddInstruction(CreateCanonicalDot(input_shape, input, weights));
+
+  CpuAotCompilationOptions options{
+      /*triple=*/kTargetTripleForHost, /*cpu_name=*/kTargetCpuForHost,
+      /*features=*/"",
+      /*entry_point_name=*/"entry",
+      /*relocation_model=*/CpuAotCompilationOptions::RelocationModel::Static};
+
+  auto hlo_module = CreateNewVerifiedModule();
+  hlo_module->AddEntryComputation(builder.Build());
+
+  CompileAheadOfTimeAndVerifyIr(
+      std::move(hlo_module), options,
+      R"(CHECK: call void @__xla_cpu_runtime_EigenPrepackedMatMulF32)",
+      /*match_optimized_ir=*/true);
+}
+
 }  // namespace
 }  // namespace cpu
 }  // namespace xla
@@ -0,0 +1,85 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <utility>
+
+#include "tensorflow/compiler/xla/service/cpu/tests/cpu_codegen_test.h"
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/tests/filecheck.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+class CpuVectorizedReduceTest : public CpuCodegenTest {};
+
+// One of the reduced dimensions is smaller than the window size used by
+// TreeReductionRewriter, so this reduce reaches the IR emitter unchanged.
+const char* const kRowReductionHlo = R"(
+HloModule RowReduction
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY main {
+  input = f32[3,5,1001] parameter(0)
+  zero = f32[] constant(0)
+  ROOT reduce = f32[3] reduce(input, zero), dimensions={1,2}, to_apply=add
+}
+)";
+
+TEST_F(CpuVectorizedReduceTest, ReductionOverMinorDimensionIsVectorized) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(kRowReductionHlo));
+  CompileAndVerifyIr(std::move(module), R"(
+CHECK: %vector_accumulator = alloca <{{[0-9]+}} x float>
+CHECK: %scalar_accumulator = alloca float
+CHECK: shufflevector
+)",
+                     /*match_optimized_ir=*/false);
+}
+
+TEST_F(CpuVectorizedReduceTest, ReductionOverMinorDimension) {
+  EXPECT_TRUE(RunAndCompare(kRowReductionHlo, ErrorSpec{1e-3, 1e-3}));
+}
+
+TEST_F(CpuVectorizedReduceTest, ReductionOverMinorDimensionOnly) {
+  const char* const hlo_text = R"(
+HloModule RowReductionMax
+
+max {
+  lhs = s32[] parameter(0)
+  rhs = s32[] parameter(1)
+  ROOT max = s32[] maximum(lhs, rhs)
+}
+
+ENTRY main {
+  input = s32[7,70] parameter(0)
+  init = s32[] constant(-2147483648)
+  ROOT reduce = s32[7] reduce(input, init), dimensions={1}, to_apply=max
+}
+)";
+  EXPECT_TRUE(RunAndCompareNoHloPasses(hlo_text, ErrorSpec{0, 0}));
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
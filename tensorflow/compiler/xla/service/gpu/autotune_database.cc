@@ -0,0 +1,163 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/autotune_database.h"
+
+#include <memory>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+std::string DeviceFingerprint(const AutotuneDevice& device) {
+  return absl::StrCat(device.model(), "|", device.cc().major(), ".",
+                      device.cc().minor(), "|", device.driver_version(), "|",
+                      device.cudnn_version().major(), ".",
+                      device.cudnn_version().minor(), ".",
+                      device.cudnn_version().patch(), "|",
+                      device.blas_version());
+}
+
+tensorflow::mutex databases_mu(tensorflow::LINKER_INITIALIZED);
+auto& databases TF_GUARDED_BY(databases_mu) =
+    *new absl::flat_hash_map<std::string, std::unique_ptr<AutotuneDatabase>>();
+
+}  // namespace
+
+AutotuneDevice GetAutotuneDevice(se::StreamExecutor* stream_exec) {
+  AutotuneDevice device;
+  const se::DeviceDescription& desc = stream_exec->GetDeviceDescription();
+  device.set_model(desc.name());
+  device.set_driver_version(desc.driver_version());
+  int cc_major = 0, cc_minor = 0;
+  if (desc.cuda_compute_capability(&cc_major, &cc_minor)) {
+    device.mutable_cc()->set_major(cc_major);
+    device.mutable_cc()->set_minor(cc_minor);
+  }
+  if (auto* dnn = stream_exec->AsDnn()) {
+    StatusOr<se::dnn::VersionInfo> version_or = dnn->GetVersion();
+    if (version_or.ok()) {
+      const auto& version = version_or.ValueOrDie();
+      device.mutable_cudnn_version()->set_major(version.major_version());
+      device.mutable_cudnn_version()->set_minor(version.minor_version());
+      device.mutable_cudnn_version()->set_patch(version.patch());
+    }
+  }
+  if (auto* blas = stream_exec->AsBlas()) {
+    (void)blas->GetVersion(device.mutable_blas_version());
+  }
+  return device;
+}
+
+/*static*/ AutotuneDatabase* AutotuneDatabase::Get(const std::string& path) {
+  if (path.empty()) {
+    return nullptr;
+  }
+  tensorflow::mutex_lock lock(databases_mu);
+  std::unique_ptr<AutotuneDatabase>& database = databases[path];
+  if (database == nullptr) {
+    database = absl::make_unique<AutotuneDatabase>(path);
+  }
+  return database.get();
+}
+
+absl::optional<tensorflow::AutotuneResult> AutotuneDatabase::Lookup(
+    const AutotuneDevice& device, const std::string& key) {
+  tensorflow::mutex_lock lock(mu_);
+  if (!loaded_) {
+    loaded_ = true;
+    Status status = LoadLocked();
+    if (!status.ok()) {
+      LOG(WARNING) << "Ignoring autotune database " << path_ << ": " << status;
+    }
+  }
+  auto it = entries_.find({DeviceFingerprint(device), key});
+  if (it == entries_.end()) {
+    return absl::nullopt;
+  }
+  return it->second.result();
+}
+
+Status AutotuneDatabase::Insert(const AutotuneDevice& device,
+                                const std::string& key,
+                                const tensorflow::AutotuneResult& result) {
+  tensorflow::mutex_lock lock(mu_);
+  loaded_ = true;
+  Status status = LoadLocked();
+  if (!status.ok()) {
+    LOG(WARNING) << "Overwriting autotune database " << path_ << ": "
+                 << status;
+  }
+  AutotuneDatabaseEntry& entry = entries_[{DeviceFingerprint(device), key}];
+  *entry.mutable_device() = device;
+  entry.set_key(key);
+  *entry.mutable_result() = result;
+  return WriteLocked();
+}
+
+Status AutotuneDatabase::LoadLocked() {
+  tensorflow::Env* env = tensorflow::Env::Default();
+  if (!env->FileExists(path_).ok()) {
+    return Status::OK();
+  }
+  AutotuneDatabaseProto proto;
+  TF_RETURN_IF_ERROR(tensorflow::ReadTextOrBinaryProto(env, path_, &proto));
+  if (proto.version() != kAutotuneDatabaseVersion) {
+    return FailedPrecondition("Found version %d, expected %d.",
+                              proto.version(), kAutotuneDatabaseVersion);
+  }
+  for (AutotuneDatabaseEntry& entry : *proto.mutable_entries()) {
+    // Results of this process win over the ones read back from the file.
+    std::pair<std::string, std::string> key(DeviceFingerprint(entry.device()),
+                                            entry.key());
+    entries_.emplace(std::move(key), std::move(entry));
+  }
+  VLOG(1) << "Loaded autotune database " << path_ << " with "
+          << entries_.size() << " entries.";
+  return Status::OK();
+}
+
+Status AutotuneDatabase::WriteLocked() {
+  AutotuneDatabaseProto proto;
+  proto.set_version(kAutotuneDatabaseVersion);
+  for (const auto& it : entries_) {
+    *proto.add_entries() = it.second;
+  }
+
+  // Write to a temporary file first so that readers never see a partially
+  // written database.
+  tensorflow::Env* env = tensorflow::Env::Default();
+  std::string tmp_path = path_;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return Internal("Could not create a temporary file next to %s.", path_);
+  }
+  if (absl::EndsWith(path_, ".pbtxt")) {
+    TF_RETURN_IF_ERROR(tensorflow::WriteTextProto(env, tmp_path, proto));
+  } else {
+    TF_RETURN_IF_ERROR(tensorflow::WriteBinaryProto(env, tmp_path, proto));
+  }
+  return env->RenameFile(tmp_path, path_);
+}
+
+}  // namespace gpu
+}  // namespace xla
@@ -0,0 +1,89 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_DATABASE_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_DATABASE_H_
+
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_autotuning.pb.h"
+#include "tensorflow/compiler/xla/status.h"
+#include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/stream_executor_no_cuda.h"
+#include "tensorflow/core/protobuf/autotuning.pb.h"
+
+namespace xla {
+namespace gpu {
+
+// Version of the AutotuneDatabaseProto format written by this binary. Bump it
+// whenever the meaning of stored keys or results changes.
+constexpr int kAutotuneDatabaseVersion = 1;
+
+// Returns the device and library versions that autotuning results measured on
+// `stream_exec` depend on.
+AutotuneDevice GetAutotuneDevice(se::StreamExecutor* stream_exec);
+
+// A file-backed store of autotuning results that is shared by all processes
+// using the same file, so that a convolution or gemm is autotuned only once
+// per device and library versions rather than once per process.
+//
+// Results are keyed by an AutotuneDevice and the canonical text of the
+// autotuned instruction. The file is read when the database is first used.
+// Every Insert re-reads the file, merges in the results other processes added
+// in the meantime and atomically replaces it. Two processes inserting at the
+// same time may drop one another's new results; those are simply autotuned
+// again by a later process.
+class AutotuneDatabase {
+ public:
+  // Returns the database stored at `path`, or nullptr if `path` is empty.
+  // Databases are created on first use and live until the process exits.
+  static AutotuneDatabase* Get(const std::string& path);
+
+  explicit AutotuneDatabase(std::string path) : path_(std::move(path)) {}
+
+  // Returns the result stored for `key` on `device`, if any.
+  absl::optional<tensorflow::AutotuneResult> Lookup(
+      const AutotuneDevice& device, const std::string& key);
+
+  // Records `result` for `key` on `device` and writes the database back to
+  // its file.
+  Status Insert(const AutotuneDevice& device, const std::string& key,
+                const tensorflow::AutotuneResult& result);
+
+  const std::string& path() const { return path_; }
+
+ private:
+  // Adds the entries of the file that are not known yet. A missing file is
+  // treated as empty.
+  Status LoadLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  Status WriteLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const std::string path_;
+
+  tensorflow::mutex mu_;
+  bool loaded_ TF_GUARDED_BY(mu_) = false;
+  // Keyed by (fingerprint of the device, instruction key).
+  absl::flat_hash_map<std::pair<std::string, std::string>,
+                      AutotuneDatabaseEntry>
+      entries_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_DATABASE_H_
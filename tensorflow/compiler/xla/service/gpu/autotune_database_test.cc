@@ -0,0 +1,98 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/autotune_database.h"
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+AutotuneDevice MakeDevice(int cc_major) {
+  AutotuneDevice device;
+  device.set_model("Tesla V100-SXM2-16GB");
+  device.mutable_cc()->set_major(cc_major);
+  device.set_driver_version("450.80.2");
+  device.mutable_cudnn_version()->set_major(8);
+  device.set_blas_version("11000");
+  return device;
+}
+
+tensorflow::AutotuneResult MakeResult(int64 algorithm) {
+  tensorflow::AutotuneResult result;
+  result.mutable_conv()->set_algorithm(algorithm);
+  result.set_scratch_bytes(1024);
+  return result;
+}
+
+TEST(AutotuneDatabaseTest, GetReturnsNullForEmptyPath) {
+  EXPECT_EQ(AutotuneDatabase::Get(""), nullptr);
+  std::string path =
+      tensorflow::io::JoinPath(tensorflow::testing::TmpDir(), "get_db");
+  EXPECT_EQ(AutotuneDatabase::Get(path), AutotuneDatabase::Get(path));
+}
+
+TEST(AutotuneDatabaseTest, ResultsPersistAcrossInstances) {
+  for (const char* name : {"persist_db", "persist_db.pbtxt"}) {
+    std::string path =
+        tensorflow::io::JoinPath(tensorflow::testing::TmpDir(), name);
+    {
+      AutotuneDatabase database(path);
+      EXPECT_FALSE(database.Lookup(MakeDevice(7), "conv").has_value());
+      TF_ASSERT_OK(database.Insert(MakeDevice(7), "conv", MakeResult(3)));
+    }
+    {
+      // A second writer keeps the results of the first one.
+      AutotuneDatabase database(path);
+      TF_ASSERT_OK(database.Insert(MakeDevice(7), "gemm", MakeResult(5)));
+    }
+    AutotuneDatabase database(path);
+    absl::optional<tensorflow::AutotuneResult> conv =
+        database.Lookup(MakeDevice(7), "conv");
+    ASSERT_TRUE(conv.has_value());
+    EXPECT_EQ(conv->conv().algorithm(), 3);
+    EXPECT_EQ(conv->scratch_bytes(), 1024);
+    absl::optional<tensorflow::AutotuneResult> gemm =
+        database.Lookup(MakeDevice(7), "gemm");
+    ASSERT_TRUE(gemm.has_value());
+    EXPECT_EQ(gemm->conv().algorithm(), 5);
+    // Results are not reused on a different device.
+    EXPECT_FALSE(database.Lookup(MakeDevice(8), "conv").has_value());
+  }
+}
+
+TEST(AutotuneDatabaseTest, IgnoresOtherVersions) {
+  std::string path =
+      tensorflow::io::JoinPath(tensorflow::testing::TmpDir(), "version_db");
+  AutotuneDatabaseProto proto;
+  proto.set_version(kAutotuneDatabaseVersion + 1);
+  AutotuneDatabaseEntry* entry = proto.add_entries();
+  *entry->mutable_device() = MakeDevice(7);
+  entry->set_key("conv");
+  *entry->mutable_result() = MakeResult(3);
+  TF_ASSERT_OK(
+      tensorflow::WriteBinaryProto(tensorflow::Env::Default(), path, proto));
+
+  AutotuneDatabase database(path);
+  EXPECT_FALSE(database.Lookup(MakeDevice(7), "conv").has_value());
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "absl/algorithm/container.h"
 #include "absl/strings/str_join.h"
+#include "tensorflow/compiler/xla/service/gpu/fusion_profile.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_fusible.h"
 #include "tensorflow/compiler/xla/service/gpu/instruction_fusion.h"
 #include "tensorflow/compiler/xla/service/hlo_cost_analysis.h"
@@ -129,8 +130,10 @@ double GetMergedBytesTransferred(HloInstruction* fusion) {
 // Accumulates and reports stats on successful/failed merge attempts.
 class FusionInstructionMerger {
  public:
-  explicit FusionInstructionMerger(HloComputation* computation)
-      : computation_(computation) {}
+  // 'fusion_profile' may be null.
+  FusionInstructionMerger(HloComputation* computation,
+                          const FusionProfile* fusion_profile)
+      : computation_(computation), fusion_profile_(fusion_profile) {}
 
   Status Run();
 
@@ -140,6 +143,7 @@ class FusionInstructionMerger {
   Status HandleFusion(HloInstruction* fusion);
 
   HloComputation* computation_;
+  const FusionProfile* fusion_profile_;
   bool changed_ = false;
 
   // Fusion instruction merge stats.
@@ -148,6 +152,7 @@ class FusionInstructionMerger {
   int num_fail_no_users_ = 0;
   int num_fail_not_loop_fusion_ = 0;
   int num_fail_merge_all_users_ = 0;
+  int num_fail_slow_in_profile_ = 0;
   int num_fail_expensive_fused_instruction_ = 0;
   int num_fail_net_bytes_transferred_ratio_ = 0;
   int num_fail_inefficient_fusion_emitter_ = 0;
@@ -170,6 +175,7 @@ Status FusionInstructionMerger::Run() {
           << " no_users: " << num_fail_no_users_
           << " not_loop_fusion: " << num_fail_not_loop_fusion_
           << " merge_all_users: " << num_fail_merge_all_users_
+          << " slow_in_profile: " << num_fail_slow_in_profile_
           << " expensive_instruction: " << num_fail_expensive_fused_instruction_
           << " net_bytes_transferred: " << num_fail_net_bytes_transferred_ratio_
           << " inefficient_fusion_emitter: "
@@ -212,6 +218,26 @@ Status FusionInstructionMerger::HandleFusion(HloInstruction* fusion) {
     return Status::OK();
   }
 
+  // Skip 'fusion' instruction if merging it into one of its users was slow in
+  // a previous run. If merging it into all of its users was fast, trust that
+  // over the heuristics on bytes transferred and expensive instructions below.
+  bool fast_in_profile = false;
+  if (fusion_profile_ != nullptr) {
+    std::vector<FusionVerdict> verdicts;
+    for (const HloInstruction* user : fusion->users()) {
+      verdicts.push_back(fusion_profile_->GetVerdict(*fusion, *user));
+    }
+    if (absl::c_linear_search(verdicts, FusionVerdict::kSlow)) {
+      VLOG(3) << "Not merging " << fusion->name()
+              << ": Merging it into its users was slow in the profile.";
+      ++num_fail_slow_in_profile_;
+      return Status::OK();
+    }
+    fast_in_profile = absl::c_all_of(verdicts, [](FusionVerdict verdict) {
+      return verdict == FusionVerdict::kFast;
+    });
+  }
+
   // Skip 'fusion' instruction if merging it into all users would result in a
   // net increase in bytes transferred (currently allowing the net bytes
   // transferred to be exceeded up to ~10% in exchange for eliminating the
@@ -220,7 +246,7 @@ Status FusionInstructionMerger::HandleFusion(HloInstruction* fusion) {
   const double merged_bytes_transferred = GetMergedBytesTransferred(fusion);
   const double merged_to_current_bytes_ratio =
       merged_bytes_transferred / std::max(1.0, current_bytes_transferred);
-  if (merged_to_current_bytes_ratio > 1.10) {
+  if (!fast_in_profile && merged_to_current_bytes_ratio > 1.10) {
     VLOG(3) << "Not merging " << fusion->name()
             << ": merged-to-current-bytes-ratio of "
             << merged_to_current_bytes_ratio << " is not favorable.";
@@ -239,7 +265,7 @@ Status FusionInstructionMerger::HandleFusion(HloInstruction* fusion) {
   // trivial (above 1K).  This likely has room for improvement in the future.
 
   bool allow_expensive_ops =
-      fusion->user_count() == 1 ||
+      fast_in_profile || fusion->user_count() == 1 ||
       (merged_to_current_bytes_ratio < 0.3 && current_bytes_transferred > 1024);
 
   if (!allow_expensive_ops &&
@@ -313,12 +339,14 @@ Status FusionInstructionMerger::HandleFusion(HloInstruction* fusion) {
 StatusOr<bool> FusionMerger::Run(HloModule* module) {
   bool changed = false;
   VLOG(2) << "FusionMerger for module: " << module->name();
+  std::unique_ptr<FusionProfile> fusion_profile =
+      FusionProfile::LoadForModule(*module);
   for (auto* computation : module->MakeNonfusionComputations()) {
     VLOG(1) << "Before running FusionInstructionMerger for computation: "
             << computation->name();
     XLA_VLOG_LINES(3, computation->ToString());
 
-    FusionInstructionMerger fusion_merger(computation);
+    FusionInstructionMerger fusion_merger(computation, fusion_profile.get());
     TF_RETURN_IF_ERROR(fusion_merger.Run());
     changed |= fusion_merger.changed();
 
@@ -0,0 +1,244 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/fusion_profile.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/match.h"
+#include "absl/types/optional.h"
+#include "tensorflow/compiler/xla/service/hlo_computation.h"
+#include "tensorflow/compiler/xla/service/hlo_opcode.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// Returns the verdict on a fusion decision involving two sets of fused
+// instruction pairs with the given verdicts.
+FusionVerdict CombineVerdicts(FusionVerdict a, FusionVerdict b) {
+  if (a == FusionVerdict::kSlow || b == FusionVerdict::kSlow) {
+    return FusionVerdict::kSlow;
+  }
+  if (a == FusionVerdict::kFast && b == FusionVerdict::kFast) {
+    return FusionVerdict::kFast;
+  }
+  return FusionVerdict::kUnknown;
+}
+
+int64 BytesAccessed(const HloInstruction& hlo) {
+  int64 bytes = 0;
+  auto add_bytes = [&](const Shape& shape) {
+    ShapeUtil::ForEachSubshape(
+        shape, [&](const Shape& subshape, const ShapeIndex& /*index*/) {
+          if (subshape.IsArray()) {
+            bytes += ShapeUtil::ByteSizeOf(subshape);
+          }
+        });
+  };
+  add_bytes(hlo.shape());
+  for (const HloInstruction* operand : hlo.operands()) {
+    add_bytes(operand->shape());
+  }
+  return bytes;
+}
+
+}  // namespace
+
+constexpr double FusionProfile::kSlowFusionFactor;
+
+FusionProfile::FusionProfile(const FusionProfileProto& proto) {
+  for (const FusionProfileProto::Module& module : proto.modules()) {
+    // Fusions are compared to the other fusions of their module, so that the
+    // verdicts don't depend on the device the profile was taken on.
+    std::vector<double> cycles_per_byte;
+    for (const FusionTimingProto& fusion : module.fusions()) {
+      if (fusion.cycles() > 0 && fusion.bytes_accessed() > 0) {
+        cycles_per_byte.push_back(static_cast<double>(fusion.cycles()) /
+                                  fusion.bytes_accessed());
+      }
+    }
+    if (cycles_per_byte.empty()) {
+      continue;
+    }
+    auto median_it = cycles_per_byte.begin() + cycles_per_byte.size() / 2;
+    std::nth_element(cycles_per_byte.begin(), median_it,
+                     cycles_per_byte.end());
+    const double median_cycles_per_byte = *median_it;
+
+    for (const FusionTimingProto& fusion : module.fusions()) {
+      if (fusion.cycles() <= 0 || fusion.bytes_accessed() <= 0) {
+        continue;
+      }
+      const double fusion_cycles_per_byte =
+          static_cast<double>(fusion.cycles()) / fusion.bytes_accessed();
+      FusionVerdict verdict = FusionVerdict::kUnknown;
+      if (fusion_cycles_per_byte >=
+          kSlowFusionFactor * median_cycles_per_byte) {
+        verdict = FusionVerdict::kSlow;
+      } else if (fusion_cycles_per_byte <= median_cycles_per_byte) {
+        verdict = FusionVerdict::kFast;
+      }
+      for (const FusedEdgeProto& edge : fusion.edges()) {
+        auto inserted =
+            verdicts_.emplace(std::make_pair(edge.producer(), edge.consumer()),
+                              verdict);
+        if (!inserted.second) {
+          inserted.first->second =
+              CombineVerdicts(inserted.first->second, verdict);
+        }
+      }
+    }
+  }
+}
+
+/*static*/ std::unique_ptr<FusionProfile> FusionProfile::LoadForModule(
+    const HloModule& module) {
+  const std::string& path =
+      module.config().debug_options().xla_gpu_fusion_profile_path();
+  if (path.empty()) {
+    return nullptr;
+  }
+  tensorflow::Env* env = tensorflow::Env::Default();
+  if (!env->FileExists(path).ok()) {
+    VLOG(1) << "No fusion profile at " << path << " yet.";
+    return nullptr;
+  }
+  FusionProfileProto proto;
+  Status status = tensorflow::ReadTextOrBinaryProto(env, path, &proto);
+  if (!status.ok()) {
+    LOG(WARNING) << "Ignoring fusion profile " << path << ": " << status;
+    return nullptr;
+  }
+  return absl::make_unique<FusionProfile>(proto);
+}
+
+FusionVerdict FusionProfile::GetVerdict(const HloInstruction& producer,
+                                        const HloInstruction& consumer) const {
+  const HloInstruction* fused_producer =
+      producer.opcode() == HloOpcode::kFusion
+          ? producer.fused_expression_root()
+          : &producer;
+  std::vector<const HloInstruction*> fused_consumers;
+  if (consumer.opcode() == HloOpcode::kFusion) {
+    for (int64 i = 0; i < consumer.operand_count(); ++i) {
+      if (consumer.operand(i) == &producer) {
+        const auto& users = consumer.fused_parameter(i)->users();
+        fused_consumers.insert(fused_consumers.end(), users.begin(),
+                               users.end());
+      }
+    }
+  } else {
+    fused_consumers.push_back(&consumer);
+  }
+
+  const std::string producer_fingerprint =
+      InstructionFingerprint(*fused_producer);
+  absl::optional<FusionVerdict> result;
+  for (const HloInstruction* fused_consumer : fused_consumers) {
+    auto it = verdicts_.find(std::make_pair(
+        producer_fingerprint, InstructionFingerprint(*fused_consumer)));
+    FusionVerdict verdict =
+        it == verdicts_.end() ? FusionVerdict::kUnknown : it->second;
+    result = result ? CombineVerdicts(*result, verdict) : verdict;
+  }
+  return result.value_or(FusionVerdict::kUnknown);
+}
+
+/*static*/ Status FusionProfile::Record(
+    const HloModule& module, const HloExecutionProfile& profile,
+    const HloProfileIndexMap& profile_index_map, const std::string& path) {
+  FusionProfileProto::Module timings;
+  timings.set_name(module.name());
+  const auto& instruction_to_profile_idx =
+      profile_index_map.instruction_to_profile_idx();
+  for (const HloComputation* computation : module.MakeNonfusionComputations()) {
+    for (const HloInstruction* hlo : computation->instructions()) {
+      auto it = instruction_to_profile_idx.find(hlo);
+      if (hlo->opcode() != HloOpcode::kFusion ||
+          it == instruction_to_profile_idx.end()) {
+        continue;
+      }
+      FusionTimingProto* fusion = timings.add_fusions();
+      fusion->set_cycles(profile.GetCyclesTakenBy(it->second));
+      fusion->set_bytes_accessed(BytesAccessed(*hlo));
+      for (const HloInstruction* consumer : hlo->fused_instructions()) {
+        if (consumer->opcode() == HloOpcode::kParameter) {
+          continue;
+        }
+        const std::string consumer_fingerprint =
+            InstructionFingerprint(*consumer);
+        for (const HloInstruction* producer : consumer->unique_operands()) {
+          if (producer->opcode() == HloOpcode::kParameter) {
+            continue;
+          }
+          FusedEdgeProto* edge = fusion->add_edges();
+          edge->set_producer(InstructionFingerprint(*producer));
+          edge->set_consumer(consumer_fingerprint);
+        }
+      }
+    }
+  }
+
+  tensorflow::Env* env = tensorflow::Env::Default();
+  FusionProfileProto proto;
+  if (env->FileExists(path).ok()) {
+    Status status = tensorflow::ReadTextOrBinaryProto(env, path, &proto);
+    if (!status.ok()) {
+      LOG(WARNING) << "Overwriting fusion profile " << path << ": " << status;
+      proto.Clear();
+    }
+  }
+  auto it = absl::c_find_if(*proto.mutable_modules(),
+                            [&](const FusionProfileProto::Module& m) {
+                              return m.name() == module.name();
+                            });
+  if (it != proto.mutable_modules()->end()) {
+    *it = std::move(timings);
+  } else {
+    *proto.add_modules() = std::move(timings);
+  }
+
+  // Write to a temporary file first so that compilations never see a
+  // partially written profile.
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return Internal("Could not create a temporary file next to %s.", path);
+  }
+  if (absl::EndsWith(path, ".pbtxt")) {
+    TF_RETURN_IF_ERROR(tensorflow::WriteTextProto(env, tmp_path, proto));
+  } else {
+    TF_RETURN_IF_ERROR(tensorflow::WriteBinaryProto(env, tmp_path, proto));
+  }
+  return env->RenameFile(tmp_path, path);
+}
+
+/*static*/ std::string FusionProfile::InstructionFingerprint(
+    const HloInstruction& hlo) {
+  std::string text = hlo.ToString(HloPrintOptions::Fingerprint());
+  // Leave out the name of the instruction itself.
+  size_t pos = text.find(" = ");
+  return pos == std::string::npos ? text : text.substr(pos + 3);
+}
+
+}  // namespace gpu
+}  // namespace xla
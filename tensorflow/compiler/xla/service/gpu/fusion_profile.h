@@ -0,0 +1,85 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_FUSION_PROFILE_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_FUSION_PROFILE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/compiler/xla/service/gpu/fusion_profile.pb.h"
+#include "tensorflow/compiler/xla/service/hlo_execution_profile.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/status.h"
+
+namespace xla {
+namespace gpu {
+
+// What a previous profiled run says about fusing two instructions.
+enum class FusionVerdict {
+  // The instructions weren't fused in the profile.
+  kUnknown,
+  // A fusion containing them took much longer per byte accessed than the
+  // typical fusion of its module: its code is likely inefficient, e.g. because
+  // it recomputes expensive elements.
+  kSlow,
+  // All fusions containing them were at least as fast per byte accessed as the
+  // typical fusion of their module.
+  kFast,
+};
+
+// Fusion decisions of a previous run, read from the file named by
+// --xla_gpu_fusion_profile_path. GpuInstructionFusion and FusionMerger use it
+// to veto fusions that turned out slow and to merge fusions that turned out
+// fast even when their static heuristics advise against it.
+class FusionProfile {
+ public:
+  // A fusion taking at least this many times the median cycles per byte of
+  // its module is considered slow.
+  static constexpr double kSlowFusionFactor = 4.0;
+
+  explicit FusionProfile(const FusionProfileProto& proto);
+
+  // Loads the profile named by the debug options of `module`. Returns nullptr
+  // if there is no such profile, or if it can't be read.
+  static std::unique_ptr<FusionProfile> LoadForModule(const HloModule& module);
+
+  // Returns the verdict on fusing `producer` into `consumer`. Either of them
+  // may be a fusion instruction already.
+  FusionVerdict GetVerdict(const HloInstruction& producer,
+                           const HloInstruction& consumer) const;
+
+  // Records the timings of the fusions of `module` measured in `profile` into
+  // the profile at `path`, replacing earlier timings of the same module.
+  static Status Record(const HloModule& module,
+                       const HloExecutionProfile& profile,
+                       const HloProfileIndexMap& profile_index_map,
+                       const std::string& path);
+
+  // Returns a string identifying `hlo` across compilations.
+  static std::string InstructionFingerprint(const HloInstruction& hlo);
+
+ private:
+  absl::flat_hash_map<std::pair<std::string, std::string>, FusionVerdict>
+      verdicts_;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_FUSION_PROFILE_H_
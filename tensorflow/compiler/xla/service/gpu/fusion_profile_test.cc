@@ -0,0 +1,173 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/fusion_profile.h"
+
+#include "absl/algorithm/container.h"
+#include "tensorflow/compiler/xla/service/gpu/fusion_profile.pb.h"
+#include "tensorflow/compiler/xla/service/gpu/instruction_fusion.h"
+#include "tensorflow/compiler/xla/service/hlo_cost_analysis.h"
+#include "tensorflow/compiler/xla/service/hlo_execution_profile.h"
+#include "tensorflow/compiler/xla/service/hlo_matchers.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+
+namespace op = xla::testing::opcode_matchers;
+
+namespace xla {
+namespace gpu {
+namespace {
+
+constexpr char kHloText[] = R"(
+HloModule test_module
+
+ENTRY main {
+  p0 = f32[1024] parameter(0)
+  exp = f32[1024] exponential(p0)
+  neg = f32[1024] negate(exp)
+  ROOT add = f32[1024] add(neg, p0)
+}
+)";
+
+class FusionProfileTest : public HloTestBase {
+ protected:
+  // Adds a fusion of the instruction pairs in `edges` taking `cycles` to
+  // access `bytes_accessed` bytes to `module`.
+  static void AddFusion(
+      const std::vector<std::pair<const HloInstruction*,
+                                  const HloInstruction*>>& edges,
+      int64 cycles, int64 bytes_accessed,
+      FusionProfileProto::Module* module) {
+    FusionTimingProto* fusion = module->add_fusions();
+    for (const auto& edge : edges) {
+      FusedEdgeProto* edge_proto = fusion->add_edges();
+      edge_proto->set_producer(
+          FusionProfile::InstructionFingerprint(*edge.first));
+      edge_proto->set_consumer(
+          FusionProfile::InstructionFingerprint(*edge.second));
+    }
+    fusion->set_cycles(cycles);
+    fusion->set_bytes_accessed(bytes_accessed);
+  }
+};
+
+TEST_F(FusionProfileTest, Verdicts) {
+  auto module = ParseAndReturnVerifiedModule(kHloText).ValueOrDie();
+  const HloInstruction* p0 = FindInstruction(module.get(), "p0");
+  const HloInstruction* exp = FindInstruction(module.get(), "exp");
+  const HloInstruction* neg = FindInstruction(module.get(), "neg");
+  const HloInstruction* add = FindInstruction(module.get(), "add");
+
+  FusionProfileProto proto;
+  FusionProfileProto::Module* timings = proto.add_modules();
+  timings->set_name("test_module");
+  AddFusion({{exp, neg}}, /*cycles=*/1000, /*bytes_accessed=*/10, timings);
+  AddFusion({{neg, add}}, /*cycles=*/10, /*bytes_accessed=*/10, timings);
+  AddFusion({{neg, add}}, /*cycles=*/20, /*bytes_accessed=*/10, timings);
+  AddFusion({{p0, add}}, /*cycles=*/30, /*bytes_accessed=*/10, timings);
+  FusionProfile profile(proto);
+
+  EXPECT_EQ(profile.GetVerdict(*exp, *neg), FusionVerdict::kSlow);
+  EXPECT_EQ(profile.GetVerdict(*neg, *add), FusionVerdict::kFast);
+  // Neither much slower nor faster than the median.
+  EXPECT_EQ(profile.GetVerdict(*p0, *add), FusionVerdict::kUnknown);
+  // Never fused.
+  EXPECT_EQ(profile.GetVerdict(*p0, *exp), FusionVerdict::kUnknown);
+}
+
+TEST_F(FusionProfileTest, SlowFusionIsNotRepeated) {
+  auto module = ParseAndReturnVerifiedModule(kHloText).ValueOrDie();
+  FusionProfileProto proto;
+  FusionProfileProto::Module* timings = proto.add_modules();
+  timings->set_name("test_module");
+  AddFusion({{FindInstruction(module.get(), "exp"),
+              FindInstruction(module.get(), "neg")}},
+            /*cycles=*/1000, /*bytes_accessed=*/10, timings);
+  AddFusion({}, /*cycles=*/10, /*bytes_accessed=*/10, timings);
+  AddFusion({}, /*cycles=*/10, /*bytes_accessed=*/10, timings);
+
+  const std::string path =
+      tensorflow::io::JoinPath(tensorflow::testing::TmpDir(), "slow.pb");
+  TF_ASSERT_OK(
+      tensorflow::WriteBinaryProto(tensorflow::Env::Default(), path, proto));
+  HloModuleConfig config = module->config();
+  DebugOptions debug_options = config.debug_options();
+  debug_options.set_xla_gpu_fusion_profile_path(path);
+  config.set_debug_options(debug_options);
+  module->set_config(config);
+
+  EXPECT_TRUE(GpuInstructionFusion(/*may_duplicate=*/true)
+                  .Run(module.get())
+                  .ValueOrDie());
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  EXPECT_THAT(root, op::Fusion());
+  EXPECT_TRUE(absl::c_any_of(root->operands(), [](const HloInstruction* hlo) {
+    return hlo->opcode() == HloOpcode::kExp;
+  }));
+}
+
+TEST_F(FusionProfileTest, RecordAndLoad) {
+  auto module = ParseAndReturnVerifiedModule(kHloText).ValueOrDie();
+  EXPECT_TRUE(GpuInstructionFusion(/*may_duplicate=*/true)
+                  .Run(module.get())
+                  .ValueOrDie());
+  const HloInstruction* fusion =
+      module->entry_computation()->root_instruction();
+  ASSERT_THAT(fusion, op::Fusion());
+
+  HloCostAnalysis cost_analysis([](const Shape& shape) {
+    return ShapeUtil::ByteSizeOf(shape, /*pointer_size=*/8);
+  });
+  TF_ASSERT_OK(module->entry_computation()->Accept(&cost_analysis));
+  HloProfileIndexMap profile_index_map(*module);
+  auto printer_data =
+      CreateHloProfilePrinterData(profile_index_map, cost_analysis, "main");
+  HloExecutionProfile profile(printer_data.get(), &profile_index_map);
+  profile.SetCyclesTakenBy(fusion, 100);
+
+  const std::string path =
+      tensorflow::io::JoinPath(tensorflow::testing::TmpDir(), "record.pbtxt");
+  // Recording twice replaces the timings of the first run.
+  TF_ASSERT_OK(
+      FusionProfile::Record(*module, profile, profile_index_map, path));
+  TF_ASSERT_OK(
+      FusionProfile::Record(*module, profile, profile_index_map, path));
+
+  FusionProfileProto proto;
+  TF_ASSERT_OK(
+      tensorflow::ReadTextProto(tensorflow::Env::Default(), path, &proto));
+  ASSERT_EQ(proto.modules_size(), 1);
+  EXPECT_EQ(proto.modules(0).name(), "test_module");
+  ASSERT_EQ(proto.modules(0).fusions_size(), 1);
+  EXPECT_EQ(proto.modules(0).fusions(0).cycles(), 100);
+  EXPECT_EQ(proto.modules(0).fusions(0).bytes_accessed(),
+            2 * ShapeUtil::ByteSizeOf(fusion->shape()));
+  // exp -> neg and neg -> add.
+  EXPECT_EQ(proto.modules(0).fusions(0).edges_size(), 2);
+
+  // The only fusion is as fast as the median.
+  auto unfused = ParseAndReturnVerifiedModule(kHloText).ValueOrDie();
+  FusionProfile loaded(proto);
+  EXPECT_EQ(loaded.GetVerdict(*FindInstruction(unfused.get(), "neg"),
+                              *FindInstruction(unfused.get(), "add")),
+            FusionVerdict::kFast);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
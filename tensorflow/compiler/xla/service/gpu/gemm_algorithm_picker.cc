@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <limits>
 
+#include "tensorflow/compiler/xla/service/gpu/autotune_database.h"
 #include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
 #include "tensorflow/compiler/xla/service/gpu/buffer_comparator.h"
 #include "tensorflow/compiler/xla/service/gpu/gemm_thunk.h"
@@ -260,6 +261,34 @@ static StatusOr<absl::optional<se::blas::AlgorithmType>> DoGemmAutotune(
   cache_misses++;
   VLOG(4) << "Autotuning cache miss";
 
+  // Gemms autotuned by earlier processes on the same kind of device don't
+  // need to be autotuned again. A result without an algorithm stands for the
+  // generic one.
+  const DebugOptions& debug_options =
+      instr->GetModule()->config().debug_options();
+  AutotuneDatabase* database =
+      AutotuneDatabase::Get(debug_options.xla_gpu_autotune_database_path());
+  AutotuneDevice device;
+  std::string database_key;
+  if (database != nullptr) {
+    device = GetAutotuneDevice(stream->parent());
+    database_key = absl::StrCat(
+        lhs->shape().ToString(/*print_layout=*/true), " ",
+        rhs->shape().ToString(/*print_layout=*/true), " ",
+        instr->shape().ToString(/*print_layout=*/true), " ",
+        gemm_config.ShortDebugString());
+    if (absl::optional<AutotuneResult> stored =
+            database->Lookup(device, database_key)) {
+      absl::optional<se::blas::AlgorithmType> result;
+      if (stored->has_gemm()) {
+        result = stored->gemm().algorithm();
+      }
+      VLOG(4) << "Autotune database hit";
+      CHECK(autotune_cache.emplace(key, result).second);
+      return result;
+    }
+  }
+
   int64 batch_size = gemm_config.batch_size();
   absl::optional<se::blas::AlgorithmType> result;
   if (batch_size != 1) {
@@ -272,6 +301,17 @@ static StatusOr<absl::optional<se::blas::AlgorithmType>> DoGemmAutotune(
   }
 
   CHECK(autotune_cache.emplace(key, result).second);
+  if (database != nullptr) {
+    AutotuneResult stored;
+    if (result.has_value()) {
+      stored.mutable_gemm()->set_algorithm(*result);
+    }
+    Status status = database->Insert(device, database_key, stored);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to update autotune database "
+                   << database->path() << ": " << status;
+    }
+  }
   return result;
 }
 
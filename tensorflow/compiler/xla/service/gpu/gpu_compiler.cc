@@ -24,7 +24,6 @@ limitations under the License.
 #include "absl/memory/memory.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
-#include "llvm/AsmParser/Parser.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/DiagnosticInfo.h"
@@ -64,6 +63,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/gpu_layout_assignment.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_sanitize_constant_names.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_scatter_expander.h"
+#include "tensorflow/compiler/xla/service/gpu/host_offload.h"
 #include "tensorflow/compiler/xla/service/gpu/horizontal_input_fusion.h"
 #include "tensorflow/compiler/xla/service/gpu/horizontal_loop_fusion.h"
 #include "tensorflow/compiler/xla/service/gpu/instruction_fusion.h"
@@ -120,6 +120,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/regexp.h"
@@ -508,6 +509,9 @@ GpuCompiler::RunHloPassesAndBufferAssignement(
                         RunHloPasses(std::move(hlo_module), executor, options));
   }
 
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PresetAssignments> preset_assignments,
+                      RunHostOffload(hlo_module.get(), pointer_size_,
+                                     DummyCanShareBufferFunction));
   std::unique_ptr<StreamAssignment> stream_assignment =
       AssignStreams(*hlo_module);
   TF_ASSIGN_OR_RETURN(
@@ -528,7 +532,8 @@ GpuCompiler::RunHloPassesAndBufferAssignement(
           [](LogicalBuffer::Color) { return kXlaAllocatedBufferAlignBytes; },
           /*allocate_buffers_for_constants=*/true,
           /*colorer=*/BufferAssigner::DefaultColorer(),
-          /*must_not_live_out=*/{}, DummyCanShareBufferFunction));
+          /*must_not_live_out=*/{}, DummyCanShareBufferFunction,
+          std::move(preset_assignments)));
 
   return std::make_tuple(std::move(hlo_module), std::move(assignment));
 }
@@ -551,6 +556,9 @@ static Status CompileModuleToLlvmIrImpl(
   (*llvm_module)->setTargetTriple(target_triple);
   (*llvm_module)->setDataLayout(data_layout);
 
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<PresetAssignments> preset_assignments,
+      RunHostOffload(hlo_module, pointer_size, can_share_buffer_function));
   std::unique_ptr<StreamAssignment> stream_assignment =
       AssignStreams(*hlo_module);
   TF_ASSIGN_OR_RETURN(
@@ -571,7 +579,8 @@ static Status CompileModuleToLlvmIrImpl(
           [](LogicalBuffer::Color) { return kXlaAllocatedBufferAlignBytes; },
           /*allocate_buffers_for_constants=*/true,
           /*colorer=*/BufferAssigner::DefaultColorer(),
-          /*must_not_live_out=*/{}, can_share_buffer_function));
+          /*must_not_live_out=*/{}, can_share_buffer_function,
+          std::move(preset_assignments)));
 
   VLOG(1) << "Buffer Assignment Stats "
           << (*buffer_assignment)->GetStats().ToString();
@@ -652,6 +661,20 @@ static Status CompileModuleToLlvmIrImpl(
   return Status::OK();
 }
 
+// Modules with fewer kernels are not worth splitting: the cost of the extra
+// ptxas invocations and of linking outweighs the parallel speedup.
+static constexpr int kMinKernelsForParallelCompilation = 32;
+
+// Returns the pool used to compile modules in parallel when the caller didn't
+// provide one.
+static tensorflow::thread::ThreadPool* GetDefaultCompilationThreadPool() {
+  static tensorflow::thread::ThreadPool* pool =
+      new tensorflow::thread::ThreadPool(tensorflow::Env::Default(),
+                                         "xla_gpu_compilation",
+                                         tensorflow::port::MaxParallelism());
+  return pool;
+}
+
 StatusOr<std::pair<std::string, std::vector<uint8>>>
 GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
                                    std::unique_ptr<llvm::Module> llvm_module,
@@ -749,6 +772,21 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
     thread_pool = &*overriding_thread_pool;
   }
 
+  int num_functions = 0;
+  for (llvm::Function& func : llvm_module->functions()) {
+    if (!func.isDeclaration() &&
+        func.getLinkage() == llvm::GlobalValue::LinkageTypes::ExternalLinkage) {
+      num_functions++;
+    }
+  }
+
+  if (!thread_pool &&
+      module_config.debug_options()
+          .xla_gpu_enable_llvm_module_compilation_parallelism() &&
+      num_functions >= kMinKernelsForParallelCompilation) {
+    thread_pool = GetDefaultCompilationThreadPool();
+  }
+
   if (!thread_pool) {
     return compile_single_module(llvm_module.get(), /*relocatable=*/false,
                                  /*shard_number=*/absl::nullopt);
@@ -762,14 +800,6 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
   }
 
   std::vector<std::unique_ptr<llvm::Module>> llvm_modules;
-  int num_functions = 0;
-  for (llvm::Function& func : llvm_module->functions()) {
-    if (!func.isDeclaration() &&
-        func.getLinkage() == llvm::GlobalValue::LinkageTypes::ExternalLinkage) {
-      num_functions++;
-    }
-  }
-
   llvm::SplitModule(
       std::move(llvm_module),
       std::max<unsigned>(
@@ -797,21 +827,26 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
       };
       context.setDiagnosticHandlerCallBack(DiagnosticHandler, &printer);
 
-      std::unique_ptr<llvm::Module> new_llvm_module;
-      // Switch to a new context by dumping and re-parsing LLVM IR. Each thread
-      // has its own context to avoid race conditions.
+      // Switch to a new context by round-tripping the module through bitcode,
+      // which is much cheaper than printing and re-parsing textual IR. Each
+      // thread has its own context to avoid race conditions.
+      std::string bitcode;
       {
-        std::string ir;
-        {
-          llvm::raw_string_ostream os(ir);
-          original_module->print(os, nullptr);
-        }
-        llvm::SMDiagnostic err;
-        new_llvm_module = llvm::parseAssemblyString(ir, err, context);
+        llvm::raw_string_ostream os(bitcode);
+        llvm::WriteBitcodeToFile(*original_module, os);
+      }
+      llvm::Expected<std::unique_ptr<llvm::Module>> new_llvm_module =
+          llvm::parseBitcodeFile(
+              llvm::MemoryBufferRef(bitcode, original_module->getName()),
+              context);
+      if (new_llvm_module) {
+        compile_results[i] = compile_single_module(
+            new_llvm_module->get(), /*relocatable=*/true, /*shard_number=*/i);
+      } else {
+        compile_results[i] =
+            InternalError("Failed to move LLVM module shard %d: %s", i,
+                          llvm::toString(new_llvm_module.takeError()));
       }
-
-      compile_results[i] = compile_single_module(
-          new_llvm_module.get(), /*relocatable=*/true, /*shard_number=*/i);
       counter.DecrementCount();
     });
   }
@@ -32,5 +32,7 @@ const int64 kXlaAllocatedBufferAlignBytes =
 
 const int64 kConstantBufferAlignBytes = kXlaAllocatedBufferAlignBytes;
 
+const int64 kHostOffloadDeviceMemorySpace = 1;
+
 }  // namespace gpu
 }  // namespace xla
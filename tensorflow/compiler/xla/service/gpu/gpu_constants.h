@@ -31,6 +31,11 @@ extern const int64 kXlaAllocatedBufferAlignBytes;
 // Minimum alignment for constant buffers.
 extern const int64 kConstantBufferAlignBytes;
 
+// Memory space of the intermediate buffers that stay in device memory when
+// intermediate buffers are offloaded to host memory. The intermediate buffers
+// of the default memory space then live in pinned host memory.
+extern const int64 kHostOffloadDeviceMemorySpace;
+
 }  // namespace gpu
 }  // namespace xla
 
@@ -21,6 +21,7 @@ limitations under the License.
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "tensorflow/compiler/xla/literal_util.h"
+#include "tensorflow/compiler/xla/service/gpu/autotune_database.h"
 #include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
 #include "tensorflow/compiler/xla/service/gpu/convolution_thunk.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_autotuning.pb.h"
@@ -307,6 +308,24 @@ StatusOr<AutotuneResult> GpuConvAlgorithmPicker::PickBestAlgorithm(
     autotune_cache_stats.cache_misses++;
   }
 
+  // Results autotuned by earlier processes on the same kind of device are as
+  // good as our own.
+  const DebugOptions& debug_options =
+      instr->GetModule()->config().debug_options();
+  AutotuneDatabase* database =
+      AutotuneDatabase::Get(debug_options.xla_gpu_autotune_database_path());
+  AutotuneDevice device;
+  if (database != nullptr) {
+    device = GetAutotuneDevice(stream_exec_);
+    if (optional<AutotuneResult> result =
+            database->Lookup(device, std::get<1>(key))) {
+      VLOG(2) << "Using autotune database result for " << instr->ToString();
+      tensorflow::mutex_lock lock(autotune_cache_lock);
+      autotune_cache.insert({key, *result});
+      return *result;
+    }
+  }
+
   // Make sure any previous activity on this executor is done. We don't want to
   // interfere with programs that are still running on the GPU.
   if (!stream_exec_->SynchronizeAllActivity()) {
@@ -342,6 +361,14 @@ StatusOr<AutotuneResult> GpuConvAlgorithmPicker::PickBestAlgorithm(
     tensorflow::mutex_lock lock(autotune_cache_lock);
     CHECK(autotune_cache.insert({key, result_or.ValueOrDie()}).second);
   }
+  if (result_or.ok() && database != nullptr) {
+    Status status =
+        database->Insert(device, std::get<1>(key), result_or.ValueOrDie());
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to update autotune database "
+                   << database->path() << ": " << status;
+    }
+  }
   return result_or;
 }
 
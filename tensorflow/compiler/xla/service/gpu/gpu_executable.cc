@@ -19,15 +19,20 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
 #include "tensorflow/compiler/xla/map_util.h"
 #include "tensorflow/compiler/xla/service/gpu/buffer_allocations.h"
+#include "tensorflow/compiler/xla/service/gpu/copy_thunk.h"
+#include "tensorflow/compiler/xla/service/gpu/fusion_profile.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_constants.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_constants.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_debug_info_manager.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_executable_run_options.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_types.h"
 #include "tensorflow/compiler/xla/service/gpu/hlo_execution_profiler.h"
+#include "tensorflow/compiler/xla/service/gpu/sequential_thunk.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/llvm_ir/buffer_assignment_util.h"
 #include "tensorflow/compiler/xla/service/logical_buffer.h"
@@ -44,14 +49,120 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/traceme.h"
 #include "tensorflow/stream_executor/platform.h"
 
+#if GOOGLE_CUDA
+#include "tensorflow/stream_executor/gpu/gpu_driver.h"
+#include "tensorflow/stream_executor/gpu/gpu_stream.h"
+#endif
+
 namespace xla {
 namespace gpu {
 namespace {
 
 using ::tensorflow::profiler::ScopedAnnotation;
 
+// Runs of fewer capturable thunks are executed directly; replaying a graph
+// only pays off once it replaces several launches.
+constexpr int kMinThunksPerGraph = 2;
+
+// Bounds the number of buffer address sets graphs are kept for. The cache is
+// dropped entirely when it is full.
+constexpr int kMaxGraphCacheSize = 16;
+
+// Returns whether `thunk` only enqueues device work that is fully determined
+// by the buffer addresses, so that it can be recorded into a CUDA graph and
+// replayed. Thunks that read host memory, allocate scratch memory,
+// synchronize with the host or pick their work at run time (while loops,
+// conditionals, custom calls, collectives) are not.
+bool IsCapturable(const Thunk& thunk) {
+  switch (thunk.kind()) {
+    case Thunk::kKernel:
+    case Thunk::kGemm:
+    case Thunk::kMemset32BitValue:
+    case Thunk::kMemzero:
+      return true;
+    case Thunk::kCopy:
+      // Host to device copies read host memory when they are launched.
+      return dynamic_cast<const DeviceToDeviceCopyThunk*>(&thunk) != nullptr;
+    case Thunk::kSequential:
+      return absl::c_all_of(
+          static_cast<const SequentialThunk&>(thunk).thunks(),
+          [](const std::unique_ptr<Thunk>& t) { return IsCapturable(*t); });
+    default:
+      return false;
+  }
+}
+
+Status ExecuteThunk(Thunk* thunk, const Thunk::ExecuteParams& params) {
+  ScopedAnnotation annotation([&] { return thunk->profile_annotation(); });
+  VLOG(2) << "Executing the thunk for " << thunk->profile_annotation();
+  return thunk->ExecuteOnStream(params);
+}
+
 }  // namespace
 
+#if GOOGLE_CUDA && CUDA_VERSION >= 10000
+
+class GpuExecutable::CapturedGraph {
+ public:
+  CapturedGraph(se::gpu::GpuContext* context,
+                se::gpu::GpuGraphExecHandle graph_exec)
+      : context_(context), graph_exec_(graph_exec) {}
+  ~CapturedGraph() {
+    se::gpu::GpuDriver::DestroyGraphExec(context_, graph_exec_);
+  }
+
+  // Records the work `enqueue` adds to `stream` into a graph. The work is not
+  // executed.
+  static StatusOr<std::unique_ptr<CapturedGraph>> Capture(
+      se::Stream* stream, const std::function<Status()>& enqueue) {
+    auto* context = static_cast<se::gpu::GpuContext*>(
+        stream->parent()->implementation()->GpuContextHack());
+    se::gpu::GpuStreamHandle handle = se::gpu::AsGpuStreamValue(stream);
+    TF_RETURN_IF_ERROR(
+        se::gpu::GpuDriver::StreamBeginCapture(context, handle));
+    Status enqueue_status = enqueue();
+    se::gpu::GpuGraphHandle graph = nullptr;
+    Status end_status =
+        se::gpu::GpuDriver::StreamEndCapture(context, handle, &graph);
+    auto destroy_graph = MakeCleanup([&] {
+      if (graph != nullptr) {
+        se::gpu::GpuDriver::DestroyGraph(context, graph);
+      }
+    });
+    TF_RETURN_IF_ERROR(enqueue_status);
+    TF_RETURN_IF_ERROR(end_status);
+    se::gpu::GpuGraphExecHandle graph_exec;
+    TF_RETURN_IF_ERROR(
+        se::gpu::GpuDriver::GraphInstantiate(context, &graph_exec, graph));
+    return absl::make_unique<CapturedGraph>(context, graph_exec);
+  }
+
+  Status Launch(se::Stream* stream) const {
+    return se::gpu::GpuDriver::GraphLaunch(context_, graph_exec_,
+                                           se::gpu::AsGpuStreamValue(stream));
+  }
+
+ private:
+  se::gpu::GpuContext* context_;
+  se::gpu::GpuGraphExecHandle graph_exec_;
+};
+
+#else
+
+class GpuExecutable::CapturedGraph {
+ public:
+  static StatusOr<std::unique_ptr<CapturedGraph>> Capture(
+      se::Stream* stream, const std::function<Status()>& enqueue) {
+    return Unimplemented("CUDA graphs are only supported with CUDA 10+.");
+  }
+
+  Status Launch(se::Stream* stream) const {
+    return Unimplemented("CUDA graphs are only supported with CUDA 10+.");
+  }
+};
+
+#endif  // GOOGLE_CUDA && CUDA_VERSION >= 10000
+
 // Implementation note: HLO profiling is always enabled for GPU executables,
 // since we can use timers around thunks.
 GpuExecutable::GpuExecutable(GpuExecutable::Params params)
@@ -69,6 +180,10 @@ GpuExecutable::GpuExecutable(GpuExecutable::Params params)
       entry_computation_profile_index_(params.entry_computation_profile_index),
       constants_(std::move(params.constants)),
       output_info_(std::move(params.output_info)) {
+  host_offload_ = absl::c_any_of(
+      allocations_, [](const BufferAllocation& allocation) {
+        return allocation.color() == kHostOffloadDeviceMemorySpace;
+      });
   GpuDebugInfoManager::Get()->RegisterModule(module_name_, shared_module(),
                                              debug_buffer_assignment_);
 }
@@ -163,27 +278,11 @@ Status GpuExecutable::ExecuteThunks(
       [&] { return absl::StrCat(module_name_, ":XLA GPU module"); },
       tensorflow::profiler::TraceMeLevel::kInfo);
 
-  std::map<const Thunk*, std::unique_ptr<se::Event>> thunk_to_finish_event;
   std::vector<std::function<void()>> deferred_host_callbacks;
-  for (Thunk* thunk : thunk_schedule_->TotalOrder()) {
-    // Annotate execution of this op if tracing was enabled when we started
-    // running this module.  If tracing is enabled *while* we're running the
-    // module, we won't get any data, but that's probably an OK trade-off.
-    ScopedAnnotation annotation([&] { return thunk->profile_annotation(); });
-
-    int32 stream_no = thunk_schedule_->StreamNumberForThunk(thunk);
-    se::Stream* stream =
-        (stream_no == 0 ? main_stream : sub_streams[stream_no - 1].get());
-
-    for (const Thunk* dependency : thunk_schedule_->DependsOn(thunk)) {
-      stream->ThenWaitFor(FindOrDie(thunk_to_finish_event, dependency).get());
-    }
-
-    VLOG(2) << "Executing the thunk for " << thunk->profile_annotation()
-            << " on stream " << stream_no;
-    const GpuExecutableRunOptions* gpu_options =
-        run_options->run_options().gpu_executable_run_options();
-    Thunk::ExecuteParams thunk_params{
+  const GpuExecutableRunOptions* gpu_options =
+      run_options->run_options().gpu_executable_run_options();
+  auto thunk_params_for_stream = [&](se::Stream* stream) {
+    return Thunk::ExecuteParams{
         &buffer_allocations,
         stream,
         run_options->run_options().run_id(),
@@ -196,12 +295,37 @@ Status GpuExecutable::ExecuteThunks(
         gpu_options && gpu_options->nccl_unique_id_callback()
             ? &gpu_options->nccl_unique_id_callback()
             : nullptr};
-    TF_RETURN_IF_ERROR(thunk->ExecuteOnStream(thunk_params));
-    if (thunk_schedule_->Depended(thunk)) {
-      auto finish_event = absl::make_unique<se::Event>(main_stream->parent());
-      finish_event->Init();
-      stream->ThenRecordEvent(finish_event.get());
-      thunk_to_finish_event[thunk] = std::move(finish_event);
+  };
+
+  if (UseCudaGraphs(do_profile)) {
+    TF_RETURN_IF_ERROR(
+        ExecuteThunksWithGraphs(thunk_params_for_stream(main_stream)));
+  } else {
+    std::map<const Thunk*, std::unique_ptr<se::Event>> thunk_to_finish_event;
+    for (Thunk* thunk : thunk_schedule_->TotalOrder()) {
+      // Annotate execution of this op if tracing was enabled when we started
+      // running this module.  If tracing is enabled *while* we're running the
+      // module, we won't get any data, but that's probably an OK trade-off.
+      ScopedAnnotation annotation([&] { return thunk->profile_annotation(); });
+
+      int32 stream_no = thunk_schedule_->StreamNumberForThunk(thunk);
+      se::Stream* stream =
+          (stream_no == 0 ? main_stream : sub_streams[stream_no - 1].get());
+
+      for (const Thunk* dependency : thunk_schedule_->DependsOn(thunk)) {
+        stream->ThenWaitFor(FindOrDie(thunk_to_finish_event, dependency).get());
+      }
+
+      VLOG(2) << "Executing the thunk for " << thunk->profile_annotation()
+              << " on stream " << stream_no;
+      TF_RETURN_IF_ERROR(
+          thunk->ExecuteOnStream(thunk_params_for_stream(stream)));
+      if (thunk_schedule_->Depended(thunk)) {
+        auto finish_event = absl::make_unique<se::Event>(main_stream->parent());
+        finish_event->Init();
+        stream->ThenRecordEvent(finish_event.get());
+        thunk_to_finish_event[thunk] = std::move(finish_event);
+      }
     }
   }
 
@@ -250,6 +374,107 @@ Status GpuExecutable::ExecuteThunks(
     }
   }
 
+  if (do_profile && has_module()) {
+    const std::string& fusion_profile_path =
+        module_config().debug_options().xla_gpu_fusion_profile_path();
+    if (!fusion_profile_path.empty()) {
+      Status status =
+          FusionProfile::Record(module(), *hlo_execution_profile,
+                                hlo_profile_index_map(), fusion_profile_path);
+      if (!status.ok()) {
+        LOG(WARNING) << "Failed to record fusion profile to "
+                     << fusion_profile_path << ": " << status;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+bool GpuExecutable::UseCudaGraphs(bool do_profile) const {
+  return has_module() &&
+         module().config().debug_options().xla_gpu_enable_cuda_graphs() &&
+         thunk_schedule_->StreamCount() == 1 && !do_profile &&
+         !host_offload_ && !graph_capture_failed_;
+}
+
+Status GpuExecutable::ExecuteThunksWithGraphs(
+    const Thunk::ExecuteParams& params) {
+  se::Stream* stream = params.stream;
+  GraphCacheKey key;
+  key.first = stream->parent();
+  for (BufferAllocation::Index i = 0; i < allocations_.size(); ++i) {
+    key.second.push_back(
+        params.buffer_allocations->GetDeviceAddress(i).opaque());
+  }
+
+  // The first run with a set of addresses executes the thunks directly, which
+  // also takes care of lazy initialization that can't happen during capture.
+  std::shared_ptr<const CapturedGraphs> graphs;
+  bool capture = false;
+  {
+    tensorflow::mutex_lock lock(graph_cache_mutex_);
+    auto it = graph_cache_.find(key);
+    if (it == graph_cache_.end()) {
+      if (graph_cache_.size() >= kMaxGraphCacheSize) {
+        graph_cache_.clear();
+      }
+      graph_cache_.emplace(key, nullptr);
+    } else if (it->second == nullptr) {
+      capture = true;
+    } else {
+      graphs = it->second;
+    }
+  }
+
+  auto new_graphs = capture ? std::make_shared<CapturedGraphs>() : nullptr;
+  const std::vector<Thunk*>& order = thunk_schedule_->TotalOrder();
+  auto execute_range = [&](int begin, int end) -> Status {
+    for (int i = begin; i < end; ++i) {
+      TF_RETURN_IF_ERROR(ExecuteThunk(order[i], params));
+    }
+    return Status::OK();
+  };
+
+  int graph_index = 0;
+  for (int begin = 0; begin < order.size();) {
+    int end = begin;
+    while (end < order.size() && IsCapturable(*order[end])) {
+      ++end;
+    }
+    if (end - begin < kMinThunksPerGraph) {
+      end = std::max(end, begin + 1);
+      TF_RETURN_IF_ERROR(execute_range(begin, end));
+    } else if (graphs != nullptr) {
+      TF_RET_CHECK(graph_index < graphs->size());
+      TF_RETURN_IF_ERROR((*graphs)[graph_index++]->Launch(stream));
+    } else if (new_graphs != nullptr) {
+      StatusOr<std::unique_ptr<CapturedGraph>> graph_or =
+          CapturedGraph::Capture(
+              stream, [&] { return execute_range(begin, end); });
+      if (graph_or.ok()) {
+        TF_RETURN_IF_ERROR(graph_or.ValueOrDie()->Launch(stream));
+        new_graphs->push_back(std::move(graph_or).ValueOrDie());
+      } else {
+        LOG(WARNING) << "Failed to capture a CUDA graph for " << module_name_
+                     << ", executing its thunks directly from now on: "
+                     << graph_or.status();
+        graph_capture_failed_ = true;
+        new_graphs = nullptr;
+        TF_RETURN_IF_ERROR(execute_range(begin, end));
+      }
+    } else {
+      TF_RETURN_IF_ERROR(execute_range(begin, end));
+    }
+    begin = end;
+  }
+
+  if (new_graphs != nullptr) {
+    VLOG(2) << "Captured " << new_graphs->size() << " CUDA graphs for "
+            << module_name_;
+    tensorflow::mutex_lock lock(graph_cache_mutex_);
+    graph_cache_[key] = std::move(new_graphs);
+  }
   return Status::OK();
 }
 
@@ -303,8 +528,8 @@ StatusOr<se::DeviceMemoryBase> GpuExecutable::BufferForAllocation(
     VariantArguments arguments,
     const GpuExecutable::BufferAllocToDeviceMemoryMap* globals,
     const BufferAllocation& allocation,
-    se::DeviceMemoryAllocator* const memory_allocator, int device_ordinal,
-    int64 arg_idx) {
+    se::DeviceMemoryAllocator* const memory_allocator,
+    se::StreamExecutor* executor, int64 arg_idx) {
   if (allocation.is_thread_local()) {
     return se::DeviceMemoryBase{};
   } else if (allocation.is_entry_computation_parameter()) {
@@ -340,16 +565,30 @@ StatusOr<se::DeviceMemoryBase> GpuExecutable::BufferForAllocation(
     CHECK(allocation.maybe_live_out() || allocation.IsPreallocatedTempBuffer());
     const int64 buffer_size = allocation.size();
     se::DeviceMemoryBase buffer_address;
-    if (buffer_size > 0) {
+    if (buffer_size > 0 && IsInHostMemory(allocation)) {
+      void* host_buffer = executor->HostMemoryAllocate(buffer_size);
+      if (host_buffer == nullptr) {
+        return ResourceExhausted(
+            "Failed to allocate %d bytes of pinned host memory for offloaded "
+            "buffers.",
+            buffer_size);
+      }
+      buffer_address = se::DeviceMemoryBase(host_buffer, buffer_size);
+    } else if (buffer_size > 0) {
       TF_ASSIGN_OR_RETURN(
           se::OwningDeviceMemory buffer,
-          memory_allocator->Allocate(device_ordinal, buffer_size));
+          memory_allocator->Allocate(executor->device_ordinal(), buffer_size));
       buffer_address = buffer.Release();
     }
     return buffer_address;
   }
 }
 
+bool GpuExecutable::IsInHostMemory(const BufferAllocation& allocation) const {
+  return host_offload_ && allocation.IsPreallocatedTempBuffer() &&
+         allocation.color() != kHostOffloadDeviceMemorySpace;
+}
+
 static Status CheckAlignment(const BufferAllocation& allocation,
                              se::DeviceMemoryBase buffer, int arg_idx) {
   const int64 expected_alignment = [&] {
@@ -388,7 +627,7 @@ StatusOr<BufferAllocations> GpuExecutable::GenerateBufferAllocations(
     TF_ASSIGN_OR_RETURN(
         se::DeviceMemoryBase buffer,
         BufferForAllocation(arguments, globals, allocation, memory_allocator,
-                            executor->device_ordinal(), i));
+                            executor, i));
     buffers.push_back(buffer);
     TF_RETURN_IF_ERROR(CheckAlignment(allocation, buffer, i));
   }
@@ -419,9 +658,10 @@ StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStreamImpl(
   XLA_SCOPED_LOGGING_TIMER(absl::StrCat(
       "GpuExecutable::ExecuteAsyncOnStreamImpl(", module_name_, ")"));
   se::DeviceMemoryAllocator* const memory_allocator = run_options->allocator();
-  // Force synchronous execution if the allocator requires it.
+  // Force synchronous execution if the allocator requires it, or if pinned
+  // host buffers have to be freed after the execution.
   const bool block_host_until_done =
-      !memory_allocator->AllowsAsynchronousDeallocation();
+      !memory_allocator->AllowsAsynchronousDeallocation() || host_offload_;
 
   const GpuExecutable::BufferAllocToDeviceMemoryMap* globals;
   {
@@ -554,6 +794,16 @@ StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStreamImpl(
                                    hlo_execution_profile));
 
   // Free all temporary allocations.
+  for (const BufferAllocation& allocation : allocations_) {
+    if (IsInHostMemory(allocation)) {
+      se::DeviceMemoryBase& buffer =
+          buffer_allocations.GetMutableDeviceAddress(allocation.index());
+      if (!buffer.is_null()) {
+        executor->HostMemoryDeallocate(buffer.opaque());
+      }
+      buffer = se::DeviceMemoryBase();
+    }
+  }
   TF_RETURN_IF_ERROR(
       buffer_allocations.TearDown(buffers_in_result, allocations_));
 
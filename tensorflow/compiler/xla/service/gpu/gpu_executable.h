@@ -16,8 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_GPU_EXECUTABLE_H_
 #define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_GPU_EXECUTABLE_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
@@ -142,6 +145,26 @@ class GpuExecutable : public Executable {
                        bool block_host_until_done,
                        HloExecutionProfile* hlo_execution_profile);
 
+  // A CUDA graph recorded from a run of consecutive capturable thunks.
+  class CapturedGraph;
+
+  // Captured kernels refer to their buffers by address, so a set of graphs
+  // can only be replayed on the executor and with the buffer allocation
+  // addresses it was captured with.
+  using GraphCacheKey =
+      std::pair<se::StreamExecutor*, std::vector<const void*>>;
+  using CapturedGraphs = std::vector<std::unique_ptr<CapturedGraph>>;
+
+  // Returns whether the thunks should run as replayed CUDA graphs, which is
+  // enabled by --xla_gpu_enable_cuda_graphs for single-stream schedules.
+  bool UseCudaGraphs(bool do_profile) const;
+
+  // Executes the thunk schedule on `params.stream`. Runs of consecutive
+  // capturable thunks are captured into CUDA graphs the second time a set of
+  // buffer addresses is seen and replayed from then on; the other thunks are
+  // executed as usual.
+  Status ExecuteThunksWithGraphs(const Thunk::ExecuteParams& params);
+
   using BufferAllocToDeviceMemoryMap =
       absl::flat_hash_map<BufferAllocation::Index, se::DeviceMemoryBase>;
 
@@ -166,8 +189,11 @@ class GpuExecutable : public Executable {
       VariantArguments arguments,
       const GpuExecutable::BufferAllocToDeviceMemoryMap* globals,
       const BufferAllocation& allocation,
-      se::DeviceMemoryAllocator* const memory_allocator, int device_ordinal,
-      int64 arg_idx);
+      se::DeviceMemoryAllocator* const memory_allocator,
+      se::StreamExecutor* executor, int64 arg_idx);
+
+  // Returns whether the buffers of `allocation` live in pinned host memory.
+  bool IsInHostMemory(const BufferAllocation& allocation) const;
 
   // The LLVM IR, in string format, of the unoptimized module generated for
   // this GpuExecutable. We save a string instead of an llvm::Module* because
@@ -201,6 +227,10 @@ class GpuExecutable : public Executable {
   // memory for every output/temp buffers.
   const std::vector<BufferAllocation> allocations_;
 
+  // Whether intermediate buffers are offloaded to host memory, see
+  // host_offload.h.
+  bool host_offload_ = false;
+
   std::shared_ptr<BufferAssignmentProto> debug_buffer_assignment_;
 
   size_t entry_computation_profile_index_ = -1;
@@ -216,6 +246,14 @@ class GpuExecutable : public Executable {
   std::vector<ConstantInfo> constants_;
   const absl::flat_hash_map<ShapeIndex, OutputInfo> output_info_;
 
+  // Graphs used by ExecuteThunksWithGraphs. A null entry records that the key
+  // was seen once and should be captured when seen again.
+  tensorflow::mutex graph_cache_mutex_;
+  absl::flat_hash_map<GraphCacheKey, std::shared_ptr<const CapturedGraphs>>
+      graph_cache_ TF_GUARDED_BY(graph_cache_mutex_);
+  // Set once a capture failed; graphs are not used afterwards.
+  std::atomic<bool> graph_capture_failed_{false};
+
   TF_DISALLOW_COPY_AND_ASSIGN(GpuExecutable);
 };
 
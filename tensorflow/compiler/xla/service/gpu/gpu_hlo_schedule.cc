@@ -13,12 +13,19 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <deque>
+#include <limits>
 #include <memory>
+#include <set>
 #include <unordered_map>
+#include <utility>
 
 #include "tensorflow/compiler/xla/service/gpu/gpu_hlo_schedule.h"
 
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "tensorflow/compiler/xla/service/buffer_value.h"
 #include "tensorflow/compiler/xla/service/hlo_memory_scheduler.h"
@@ -184,6 +191,146 @@ void BFSLaunchOrder(const HloComputation* computation,
   }
 }
 
+// Rough GPU performance numbers used to estimate how much compute is needed to
+// hide the latency of a collective. Only their ratios matter.
+constexpr double kKernelOverheadNs = 2000;
+constexpr double kMemoryBandwidthBytesPerNs = 500;
+constexpr double kCollectiveOverheadNs = 10000;
+constexpr double kCollectiveBandwidthBytesPerNs = 10;
+
+int64 ArrayBytes(const Shape& shape, int64 pointer_size) {
+  int64 bytes = 0;
+  ShapeUtil::ForEachSubshape(
+      shape, [&](const Shape& subshape, const ShapeIndex& /*index*/) {
+        if (subshape.IsArray()) {
+          bytes += ShapeUtil::ByteSizeOf(subshape, pointer_size);
+        }
+      });
+  return bytes;
+}
+
+// Returns an estimate of the time it takes to run `hlo`, in nanoseconds, based
+// on the number of bytes it reads and writes.
+double EstimateRunTimeNs(const HloInstruction& hlo, int64 pointer_size) {
+  switch (hlo.opcode()) {
+    case HloOpcode::kBitcast:
+    case HloOpcode::kConstant:
+    case HloOpcode::kGetTupleElement:
+    case HloOpcode::kParameter:
+    case HloOpcode::kTuple:
+      return 0;
+    default:
+      break;
+  }
+  int64 bytes = ArrayBytes(hlo.shape(), pointer_size);
+  for (const HloInstruction* operand : hlo.operands()) {
+    bytes += ArrayBytes(operand->shape(), pointer_size);
+  }
+  if (IsAsyncCollective(hlo)) {
+    return kCollectiveOverheadNs + bytes / kCollectiveBandwidthBytesPerNs;
+  }
+  return kKernelOverheadNs + bytes / kMemoryBandwidthBytesPerNs;
+}
+
+// Reorders `launch_order` to hide the latency of async collectives: each
+// collective is launched as soon as its operands are, and its users are held
+// back until the independent compute launched meanwhile is estimated to cover
+// the run time of the collective. Otherwise, instructions keep their relative
+// order in `launch_order`.
+void LatencyHidingLaunchOrder(int64 pointer_size,
+                              std::vector<HloInstruction*>* launch_order) {
+  absl::flat_hash_map<const HloInstruction*, int64> position;
+  absl::flat_hash_map<const HloInstruction*, int64> pending_predecessors;
+  for (int64 i = 0; i < launch_order->size(); ++i) {
+    HloInstruction* hlo = (*launch_order)[i];
+    position[hlo] = i;
+    absl::flat_hash_set<const HloInstruction*> predecessors(
+        hlo->operands().begin(), hlo->operands().end());
+    predecessors.insert(hlo->control_predecessors().begin(),
+                        hlo->control_predecessors().end());
+    pending_predecessors[hlo] = predecessors.size();
+  }
+
+  // Ready instructions, ordered by their position in `launch_order`.
+  std::set<std::pair<int64, HloInstruction*>> ready_collectives;
+  std::set<std::pair<int64, HloInstruction*>> ready_compute;
+  auto make_ready = [&](HloInstruction* hlo) {
+    if (IsAsyncCollective(*hlo)) {
+      ready_collectives.emplace(position[hlo], hlo);
+    } else {
+      ready_compute.emplace(position[hlo], hlo);
+    }
+  };
+  for (HloInstruction* hlo : *launch_order) {
+    if (pending_predecessors[hlo] == 0) {
+      make_ready(hlo);
+    }
+  }
+
+  // Times are estimated on the clock of the compute streams, which we model as
+  // a single stream. Collectives run one after another on their own stream.
+  double compute_time = 0;
+  double collective_stream_time = 0;
+  absl::flat_hash_map<const HloInstruction*, double> collective_done_time;
+  // Returns when the collectives `hlo` uses are estimated to be done.
+  auto operands_done_time = [&](const HloInstruction* hlo) {
+    double time = 0;
+    for (const HloInstruction* operand : hlo->operands()) {
+      auto it = collective_done_time.find(operand);
+      if (it != collective_done_time.end()) {
+        time = std::max(time, it->second);
+      }
+    }
+    return time;
+  };
+
+  std::vector<HloInstruction*> new_launch_order;
+  new_launch_order.reserve(launch_order->size());
+  while (!ready_collectives.empty() || !ready_compute.empty()) {
+    HloInstruction* hlo;
+    if (!ready_collectives.empty()) {
+      hlo = ready_collectives.begin()->second;
+      ready_collectives.erase(ready_collectives.begin());
+      collective_stream_time =
+          std::max(compute_time, collective_stream_time) +
+          EstimateRunTimeNs(*hlo, pointer_size);
+      collective_done_time[hlo] = collective_stream_time;
+    } else {
+      // Pick the first instruction that doesn't have to wait for a collective,
+      // or else the one that waits the least.
+      auto chosen = ready_compute.end();
+      double earliest_start_time = std::numeric_limits<double>::infinity();
+      for (auto it = ready_compute.begin(); it != ready_compute.end(); ++it) {
+        double start_time = operands_done_time(it->second);
+        if (start_time < earliest_start_time) {
+          earliest_start_time = start_time;
+          chosen = it;
+        }
+        if (start_time <= compute_time) {
+          break;
+        }
+      }
+      hlo = chosen->second;
+      ready_compute.erase(chosen);
+      compute_time = std::max(compute_time, earliest_start_time) +
+                     EstimateRunTimeNs(*hlo, pointer_size);
+    }
+    new_launch_order.push_back(hlo);
+
+    absl::flat_hash_set<HloInstruction*> successors(hlo->users().begin(),
+                                                    hlo->users().end());
+    successors.insert(hlo->control_successors().begin(),
+                      hlo->control_successors().end());
+    for (HloInstruction* successor : successors) {
+      if (--pending_predecessors[successor] == 0) {
+        make_ready(successor);
+      }
+    }
+  }
+  CHECK_EQ(new_launch_order.size(), launch_order->size());
+  *launch_order = std::move(new_launch_order);
+}
+
 }  // end namespace
 
 GpuHloSchedule::GpuHloSchedule() {}
@@ -196,7 +343,26 @@ StatusOr<std::unique_ptr<GpuHloSchedule>> GpuHloSchedule::Build(
 
   // Initialize thunk_launch_order_, the total order of thunk launches.
   HloComputation* entry_computation = module.entry_computation();
-  if (stream_assignment.StreamCount() == 1) {
+  const bool has_async_collectives = absl::c_any_of(
+      entry_computation->instructions(),
+      [](const HloInstruction* hlo) { return IsAsyncCollective(*hlo); });
+  const bool has_copy_starts = absl::c_any_of(
+      entry_computation->instructions(), [](const HloInstruction* hlo) {
+        return hlo->opcode() == HloOpcode::kCopyStart;
+      });
+  // Async collectives and copies always get the last streams, so with them, a
+  // larger stream count still means that all the compute runs on a single
+  // stream.
+  const int compute_stream_count = stream_assignment.StreamCount() -
+                                   (has_async_collectives ? 1 : 0) -
+                                   (has_copy_starts ? 1 : 0);
+  if (module.has_schedule() &&
+      module.schedule().is_computation_scheduled(entry_computation)) {
+    // Host offload scheduled the module and placed its asynchronous copies in
+    // that schedule, so keep it.
+    schedule->thunk_launch_order_ =
+        module.schedule().sequence(entry_computation).instructions();
+  } else if (compute_stream_count == 1) {
     // All kernels are launched on a single stream, so there's no loss of
     // concurrency by optimizing for minimal memory usage.
     TF_ASSIGN_OR_RETURN(
@@ -210,6 +376,9 @@ StatusOr<std::unique_ptr<GpuHloSchedule>> GpuHloSchedule::Build(
     // BFS tends to increase concurrency, but also increases memory usage.
     BFSLaunchOrder(entry_computation, &schedule->thunk_launch_order_);
   }
+  if (has_async_collectives && !module.has_schedule()) {
+    LatencyHidingLaunchOrder(pointer_size, &schedule->thunk_launch_order_);
+  }
 
   schedule->hlo_ordering_ = absl::make_unique<GpuHloOrdering>(
       &module, stream_assignment, schedule->thunk_launch_order_);
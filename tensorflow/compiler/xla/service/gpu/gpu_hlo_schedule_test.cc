@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <unordered_set>
 
+#include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
 #include "tensorflow/compiler/xla/service/gpu/stream_assignment.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
@@ -27,6 +28,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/compiler/xla/tests/test_utils.h"
 #include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 
 namespace xla {
 namespace gpu {
@@ -401,5 +403,54 @@ TEST_F(GpuHloScheduleTest, LatticeMatMul) {
   }
 }
 
+// Test that independent compute is scheduled between an async all-reduce and
+// its user.
+TEST_F(GpuHloScheduleTest, AsyncAllReduceOverlapsWithCompute) {
+  const char* const hlo_text = R"(
+HloModule AsyncAllReduce
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY main {
+  p0 = f32[1024,1024] parameter(0)
+  p1 = f32[2,2] parameter(1)
+  all-reduce = f32[1024,1024] all-reduce(p0), replica_groups={}, to_apply=add
+  user = f32[1024,1024] negate(all-reduce)
+  neg0 = f32[2,2] negate(p1)
+  neg1 = f32[2,2] negate(neg0)
+  ROOT tuple = (f32[1024,1024], f32[2,2]) tuple(user, neg1)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(hlo_text, /*replica_count=*/2));
+  HloInstruction* all_reduce = FindInstruction(module.get(), "all-reduce");
+  HloInstruction* user = FindInstruction(module.get(), "user");
+  HloInstruction* neg0 = FindInstruction(module.get(), "neg0");
+  HloInstruction* neg1 = FindInstruction(module.get(), "neg1");
+
+  std::unique_ptr<StreamAssignment> streams = AssignStreams(*module);
+  EXPECT_EQ(streams->StreamCount(), 2);
+  EXPECT_NE(streams->StreamNumberForHlo(*all_reduce),
+            streams->StreamNumberForHlo(*user));
+
+  auto schedule = BuildGpuHloSchedule(*module, *streams);
+  const HloVec& launch_order = schedule->ThunkLaunchOrder();
+  auto position = [&](const HloInstruction* hlo) {
+    return absl::c_find(launch_order, hlo) - launch_order.begin();
+  };
+  EXPECT_LT(position(all_reduce), position(neg0));
+  EXPECT_LT(position(neg0), position(neg1));
+  EXPECT_LT(position(neg1), position(user));
+
+  auto order = schedule->ConsumeHloOrdering();
+  EXPECT_TRUE(order->ExecutesBefore(all_reduce, user));
+  EXPECT_FALSE(order->ExecutesBefore(all_reduce, neg0));
+  EXPECT_FALSE(order->ExecutesBefore(neg0, all_reduce));
+}
+
 }  // namespace gpu
 }  // namespace xla
@@ -0,0 +1,127 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/host_offload.h"
+
+#include "tensorflow/compiler/xla/service/flatten_call_graph.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_constants.h"
+#include "tensorflow/compiler/xla/service/hlo_alias_analysis.h"
+#include "tensorflow/compiler/xla/service/hlo_live_range.h"
+#include "tensorflow/compiler/xla/service/hlo_memory_scheduler.h"
+#include "tensorflow/compiler/xla/service/hlo_opcode.h"
+#include "tensorflow/compiler/xla/service/memory_space_assignment_utils.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// Bounds on the number of instructions a prefetch overlaps with.
+constexpr int64 kMinPrefetchInterval = 2;
+constexpr int64 kMaxPrefetchInterval = 30;
+
+// Copies run on a stream of their own. Makes each CopyStart of the entry
+// computation wait for the compute launched before it, which may still be
+// using the memory the copy overwrites.
+Status AddCopyStartDependencies(HloModule* module) {
+  const HloComputation* entry = module->entry_computation();
+  HloInstruction* last_compute = nullptr;
+  for (HloInstruction* hlo :
+       module->schedule().sequence(entry).instructions()) {
+    switch (hlo->opcode()) {
+      case HloOpcode::kCopyStart:
+        if (last_compute != nullptr) {
+          TF_RETURN_IF_ERROR(last_compute->AddControlDependencyTo(hlo));
+        }
+        break;
+      case HloOpcode::kBitcast:
+      case HloOpcode::kConstant:
+      case HloOpcode::kGetTupleElement:
+      case HloOpcode::kParameter:
+        break;
+      default:
+        last_compute = hlo;
+        break;
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<PresetAssignments>> RunHostOffload(
+    HloModule* module, int64 pointer_size,
+    const HloDataflowAnalysis::CanShareBuffer& can_share_buffer) {
+  const DebugOptions& debug_options = module->config().debug_options();
+  const int64 device_memory_limit =
+      debug_options.xla_gpu_host_offload_device_memory_limit_bytes();
+  if (device_memory_limit <= 0) {
+    return std::unique_ptr<PresetAssignments>();
+  }
+  if (!debug_options.xla_gpu_disable_multi_streaming()) {
+    // Memory space assignment needs the kernels to run in the order of the
+    // schedule.
+    LOG(WARNING) << "Not offloading buffers of " << module->name()
+                 << " to host memory: host offload requires "
+                    "--xla_gpu_disable_multi_streaming.";
+    return std::unique_ptr<PresetAssignments>();
+  }
+
+  auto size_fn = [pointer_size](const BufferValue& buffer) {
+    return ShapeUtil::ByteSizeOf(buffer.shape(), pointer_size);
+  };
+  TF_RETURN_IF_ERROR(FlattenCallGraph().Run(module).status());
+  TF_ASSIGN_OR_RETURN(HloSchedule schedule, ScheduleModule(module, size_fn));
+  TF_RETURN_IF_ERROR(module->set_schedule(std::move(schedule)));
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<HloAliasAnalysis> alias_analysis,
+                      HloAliasAnalysis::Run(module, can_share_buffer));
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<HloLiveRange> hlo_live_range,
+      HloLiveRange::Run(module->schedule(), *alias_analysis,
+                        module->entry_computation()));
+
+  InstructionCountPrefetchIntervalPicker prefetch_interval_picker(
+      kMinPrefetchInterval, kMaxPrefetchInterval);
+  MemorySpaceAssignment::Options options;
+  options.alternate_memory_space = kHostOffloadDeviceMemorySpace;
+  options.max_size_in_bytes = device_memory_limit;
+  options.alignment_in_bytes = kXlaAllocatedBufferAlignBytes;
+  options.prefetch_interval_picker = &prefetch_interval_picker;
+  options.size_fn = size_fn;
+  options.is_allowed_in_alternate_mem_fn = [](const HloValue& value) {
+    const HloInstruction* instruction = value.defining_instruction();
+    const HloComputation* computation = instruction->parent();
+    const bool is_entry_parameter =
+        instruction->opcode() == HloOpcode::kParameter &&
+        computation == computation->parent()->entry_computation();
+    return !is_entry_parameter &&
+           instruction->opcode() != HloOpcode::kConstant &&
+           !value.live_out_of_module() &&
+           MemorySpaceAssignmentUtils::IsValueAllowedInAlternateMemory(&value);
+  };
+  options.allocate_across_sequential_calls = true;
+  // Entry parameters are in device memory already.
+  options.enable_cross_program_prefetch = false;
+
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PresetAssignments> preset_assignments,
+                      MemorySpaceAssignment::Run(module, *hlo_live_range,
+                                                 *alias_analysis, options));
+  TF_RETURN_IF_ERROR(AddCopyStartDependencies(module));
+  return std::move(preset_assignments);
+}
+
+}  // namespace gpu
+}  // namespace xla
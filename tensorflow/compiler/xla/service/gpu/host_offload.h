@@ -0,0 +1,50 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_HOST_OFFLOAD_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_HOST_OFFLOAD_H_
+
+#include <memory>
+
+#include "tensorflow/compiler/xla/service/hlo_dataflow_analysis.h"
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/service/memory_space_assignment.h"
+#include "tensorflow/compiler/xla/statusor.h"
+
+namespace xla {
+namespace gpu {
+
+// Offloads intermediate buffers to pinned host memory if
+// --xla_gpu_host_offload_device_memory_limit_bytes is set.
+//
+// MemorySpaceAssignment models a large default memory and a small, fast
+// alternate memory. Here the default memory is pinned host memory and the
+// alternate memory is device memory, kHostOffloadDeviceMemorySpace, capped at
+// the limit. MemorySpaceAssignment keeps buffers in device memory while they
+// fit, and otherwise evicts them to host memory and prefetches them back with
+// CopyStart/CopyDone pairs scheduled around their uses. Entry parameters,
+// outputs and constants are allocated by the runtime in device memory, so they
+// are left alone.
+//
+// Schedules `module` and returns the device memory assignments to pass to the
+// BufferAssigner, or nullptr if host offload is disabled.
+StatusOr<std::unique_ptr<PresetAssignments>> RunHostOffload(
+    HloModule* module, int64 pointer_size,
+    const HloDataflowAnalysis::CanShareBuffer& can_share_buffer);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_HOST_OFFLOAD_H_
@@ -0,0 +1,119 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/host_offload.h"
+
+#include "tensorflow/compiler/xla/service/gpu/gpu_constants.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/hlo_opcode.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+constexpr int64 kPointerSize = 8;
+
+// Each value is 4KB and `a` stays live until the root.
+constexpr char kHloText[] = R"(
+HloModule Offload
+
+ENTRY main {
+  p0 = f32[1024] parameter(0)
+  a = f32[1024] negate(p0)
+  b = f32[1024] exponential(a)
+  c = f32[1024] negate(b)
+  d = f32[1024] exponential(c)
+  e = f32[1024] negate(d)
+  f = f32[1024] exponential(e)
+  g = f32[1024] negate(f)
+  h = f32[1024] exponential(g)
+  ROOT add = f32[1024] add(a, h)
+})";
+
+class HostOffloadTest : public HloTestBase {
+ protected:
+  HloModuleConfig ConfigWithLimit(int64 limit, bool multi_streaming = false) {
+    DebugOptions debug_options = GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_host_offload_device_memory_limit_bytes(limit);
+    debug_options.set_xla_gpu_disable_multi_streaming(!multi_streaming);
+    HloModuleConfig config;
+    config.set_debug_options(debug_options);
+    return config;
+  }
+};
+
+TEST_F(HostOffloadTest, DisabledByDefault) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(kHloText, ConfigWithLimit(0)));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PresetAssignments> preset_assignments,
+      RunHostOffload(module.get(), kPointerSize,
+                     /*can_share_buffer=*/nullptr));
+  EXPECT_EQ(preset_assignments, nullptr);
+  EXPECT_FALSE(module->has_schedule());
+}
+
+TEST_F(HostOffloadTest, RequiresSingleStream) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      ParseAndReturnVerifiedModule(
+          kHloText, ConfigWithLimit(8192, /*multi_streaming=*/true)));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PresetAssignments> preset_assignments,
+      RunHostOffload(module.get(), kPointerSize,
+                     /*can_share_buffer=*/nullptr));
+  EXPECT_EQ(preset_assignments, nullptr);
+}
+
+TEST_F(HostOffloadTest, DeviceMemoryStaysWithinLimit) {
+  const int64 limit = 8192;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      ParseAndReturnVerifiedModule(kHloText, ConfigWithLimit(limit)));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PresetAssignments> preset_assignments,
+      RunHostOffload(module.get(), kPointerSize,
+                     /*can_share_buffer=*/nullptr));
+  ASSERT_NE(preset_assignments, nullptr);
+  EXPECT_TRUE(module->has_schedule());
+  EXPECT_FALSE(preset_assignments->chunks().empty());
+  for (const auto& position_and_chunk : preset_assignments->chunks()) {
+    EXPECT_LE(position_and_chunk.second.chunk_end(), limit);
+  }
+
+  // The runtime allocates parameters and outputs in device memory.
+  const HloComputation* entry = module->entry_computation();
+  for (const HloInstruction* instruction : entry->instructions()) {
+    if (instruction->opcode() == HloOpcode::kParameter ||
+        instruction == entry->root_instruction()) {
+      EXPECT_NE(instruction->shape().layout().memory_space(),
+                kHostOffloadDeviceMemorySpace)
+          << instruction->ToString();
+    }
+    // Asynchronous copies wait for the compute scheduled before them.
+    if (instruction->opcode() == HloOpcode::kCopyStart) {
+      EXPECT_FALSE(instruction->control_predecessors().empty())
+          << instruction->ToString();
+    }
+  }
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
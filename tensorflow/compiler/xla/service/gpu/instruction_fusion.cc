@@ -97,6 +97,13 @@ bool GpuInstructionFusion::ShouldFuse(HloInstruction* consumer,
             << consumer->ToString() << ") would be too large";
     return false;
   }
+  if (fusion_profile_ != nullptr &&
+      fusion_profile_->GetVerdict(*producer, *consumer) ==
+          FusionVerdict::kSlow) {
+    VLOG(5) << "Not fusing " << producer->name() << " into "
+            << consumer->name() << ", the fusion was slow in the profile";
+    return false;
+  }
   if (consumer->opcode() != HloOpcode::kFusion) {
     return true;
   }
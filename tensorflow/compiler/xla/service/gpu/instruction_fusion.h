@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/compiler/xla/service/fusion_node_indexing_evaluation.h"
+#include "tensorflow/compiler/xla/service/gpu/fusion_profile.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/instruction_fusion.h"
 
@@ -41,6 +42,7 @@ class GpuInstructionFusion : public InstructionFusion {
 
   StatusOr<bool> Run(HloModule* module) override {
     fusion_node_evaluations_.clear();
+    fusion_profile_ = FusionProfile::LoadForModule(*module);
     return InstructionFusion::Run(module);
   }
 
@@ -57,6 +59,9 @@ class GpuInstructionFusion : public InstructionFusion {
   // indexed with different index vectors.
   absl::flat_hash_map<const HloInstruction*, FusionNodeIndexingEvaluation>
       fusion_node_evaluations_;
+
+  // Timings of a previous run, if --xla_gpu_fusion_profile_path names one.
+  std::unique_ptr<FusionProfile> fusion_profile_;
 };
 
 }  // namespace gpu
@@ -3262,6 +3262,28 @@ Status IrEmitterUnnested::HandleAfterAll(HloInstruction* after_all) {
   return Status::OK();
 }
 
+Status IrEmitterUnnested::HandleCopyStart(HloInstruction* copy_start) {
+  // Host offload moves buffers between device and host memory with these. Both
+  // are addressable by the device, so this is a plain memcpy, launched on a
+  // stream of its own.
+  const HloInstruction* operand = copy_start->operand(0);
+  AddThunkToThunkSequence(absl::make_unique<DeviceToDeviceCopyThunk>(
+      GetThunkInfo(copy_start),
+      /*source_address=*/GetAllocationSlice(*operand),
+      /*destination_buffer=*/GetAllocationSlice(*copy_start, {0}),
+      /*mem_size=*/ShapeUtil::ByteSizeOf(operand->shape())));
+  return Status::OK();
+}
+
+Status IrEmitterUnnested::HandleCopyDone(HloInstruction* copy_done) {
+  // The output aliases the destination of the copy. The empty thunk makes the
+  // compute stream wait for the copy at this point of the schedule, before
+  // the memory the copy reads from is reused.
+  AddThunkToThunkSequence(absl::make_unique<SequentialThunk>(
+      GetThunkInfo(copy_done), std::vector<std::unique_ptr<Thunk>>()));
+  return Status::OK();
+}
+
 // Figures out how to access the buffers for all subshapes of hlo's operands and
 // for hlo itself (i.e. all the buffers produced by HLO).
 //
@@ -3862,6 +3884,19 @@ Status CheckConditionalBuffersShareAllocation(
   return Status::OK();
 }
 
+// Emits the nested `computation` in the order of the module schedule, if there
+// is one: host offload places its asynchronous copies in that order.
+Status AcceptInScheduleOrder(HloComputation* computation,
+                             IrEmitterUnnested* ir_emitter) {
+  const HloModule* module = computation->parent();
+  if (module->has_schedule() &&
+      module->schedule().is_computation_scheduled(computation)) {
+    return computation->AcceptOrdered(
+        ir_emitter, module->schedule().sequence(computation).instructions());
+  }
+  return computation->Accept(ir_emitter);
+}
+
 }  // namespace
 
 StatusOr<std::unique_ptr<Thunk>> IrEmitterUnnested::BuildWhileThunk(
@@ -3875,14 +3910,15 @@ StatusOr<std::unique_ptr<Thunk>> IrEmitterUnnested::BuildWhileThunk(
   TF_ASSIGN_OR_RETURN(auto ir_emitter_condition,
                       IrEmitterUnnested::Create(hlo_module_config_, condition,
                                                 ir_emitter_context_));
-  TF_RETURN_IF_ERROR(condition->Accept(ir_emitter_condition.get()));
+  TF_RETURN_IF_ERROR(
+      AcceptInScheduleOrder(condition, ir_emitter_condition.get()));
 
   // Generate thunk sequence for while 'body'.
   HloComputation* body = hlo->while_body();
   TF_ASSIGN_OR_RETURN(
       auto ir_emitter_body,
       IrEmitterUnnested::Create(hlo_module_config_, body, ir_emitter_context_));
-  TF_RETURN_IF_ERROR(body->Accept(ir_emitter_body.get()));
+  TF_RETURN_IF_ERROR(AcceptInScheduleOrder(body, ir_emitter_body.get()));
 
   const auto* index_map = ir_emitter_context_->profile_index_map();
   absl::optional<size_t> condition_profile_index, body_profile_index;
@@ -3910,7 +3946,7 @@ StatusOr<std::unique_ptr<Thunk>> IrEmitterUnnested::BuildForThunk(
   TF_ASSIGN_OR_RETURN(
       auto ir_emitter_body,
       IrEmitterUnnested::Create(hlo_module_config_, body, ir_emitter_context_));
-  TF_RETURN_IF_ERROR(body->Accept(ir_emitter_body.get()));
+  TF_RETURN_IF_ERROR(AcceptInScheduleOrder(body, ir_emitter_body.get()));
 
   const auto* index_map = ir_emitter_context_->profile_index_map();
   absl::optional<size_t> body_profile_index;
@@ -3947,7 +3983,7 @@ StatusOr<std::unique_ptr<Thunk>> IrEmitterUnnested::BuildConditionalThunk(
         auto ir_emitter,
         IrEmitterUnnested::Create(hlo_module_config_, branch_computation,
                                   ir_emitter_context_));
-    TF_CHECK_OK(branch_computation->Accept(ir_emitter.get()));
+    TF_CHECK_OK(AcceptInScheduleOrder(branch_computation, ir_emitter.get()));
     branch_thunks.push_back(std::move(*ir_emitter->ConsumeThunkSequence()));
 
     absl::optional<size_t> profile_index;
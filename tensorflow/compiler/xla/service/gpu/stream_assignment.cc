@@ -44,6 +44,19 @@ void StreamAssignment::AssignStreamToHlo(const HloInstruction* hlo,
   VLOG(2) << "Assign stream #" << stream_num << " to " << hlo->ToString();
 }
 
+bool IsAsyncCollective(const HloInstruction& hlo) {
+  if (hlo.opcode() != HloOpcode::kAllReduce &&
+      hlo.opcode() != HloOpcode::kAllGather &&
+      hlo.opcode() != HloOpcode::kAllToAll) {
+    return false;
+  }
+  const HloModuleConfig& config = hlo.GetModule()->config();
+  const auto& debug_options = config.debug_options();
+  return debug_options.xla_gpu_enable_async_collectives() &&
+         !debug_options.xla_gpu_use_random_streams() &&
+         config.replica_count() * config.num_partitions() > 1;
+}
+
 namespace {
 
 // Returns whether the two HLOs can run concurrently, i.e., neither is a
@@ -137,7 +150,22 @@ std::unique_ptr<StreamAssignment> AssignStreams(const HloModule& module) {
   // TODO(b/111791052): If we remove such a common variable, we will need to
   // clean up the code here.
   int stream_num_for_rng = kInvalidStreamNum;
+  std::vector<const HloInstruction*> async_collectives;
+  std::vector<const HloInstruction*> copy_starts;
   for (const auto* hlo : computation.MakeInstructionPostOrder()) {
+    if (hlo->opcode() == HloOpcode::kCopyStart) {
+      // Like collectives below, the asynchronous copies of host offload get a
+      // stream of their own.
+      copy_starts.push_back(hlo);
+      continue;
+    }
+    if (IsAsyncCollective(*hlo)) {
+      // Collectives get a stream of their own below, once we know how many
+      // streams the rest of the computation uses. Their users are placed as
+      // if the collectives had no stream.
+      async_collectives.push_back(hlo);
+      continue;
+    }
     // If we ever enable fusion of RNG instructions, we will need to extend this
     // code to look inside a fused instruction.
     int stream_num = (hlo->opcode() == HloOpcode::kRng &&
@@ -156,6 +184,14 @@ std::unique_ptr<StreamAssignment> AssignStreams(const HloModule& module) {
       seen_gemms.push_back(hlo);
     }
   }
+  const int collective_stream_num = stream_assignment->StreamCount();
+  for (const auto* hlo : async_collectives) {
+    stream_assignment->AssignStreamToHlo(hlo, collective_stream_num);
+  }
+  const int copy_stream_num = stream_assignment->StreamCount();
+  for (const auto* hlo : copy_starts) {
+    stream_assignment->AssignStreamToHlo(hlo, copy_stream_num);
+  }
   return stream_assignment;
 }
 
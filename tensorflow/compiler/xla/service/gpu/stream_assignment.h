@@ -37,6 +37,10 @@ class StreamAssignment {
   absl::flat_hash_map<const HloInstruction*, int> hlo_to_stream_number_;
 };
 
+// Returns whether `hlo` is a collective that runs on a stream of its own, so
+// that it can overlap with the compute on the other streams.
+bool IsAsyncCollective(const HloInstruction& hlo);
+
 // Assigns GPU streams to instructions in `module`.
 std::unique_ptr<StreamAssignment> AssignStreams(const HloModule& module);
 
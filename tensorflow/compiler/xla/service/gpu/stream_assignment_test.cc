@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/compiler/xla/tests/test_utils.h"
 #include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 
 namespace xla {
 namespace gpu {
@@ -139,5 +140,48 @@ TEST_F(StreamAssignmentTest, LatticeMatMul) {
             assignment->StreamNumberForHlo(*d31));
 }
 
+TEST_F(StreamAssignmentTest, AsyncCollectiveGetsOwnStream) {
+  const char* const hlo_text = R"(
+HloModule AsyncCollective
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY main {
+  p0 = f32[1024,1024] parameter(0)
+  p1 = f32[2,2] parameter(1)
+  all-reduce = f32[1024,1024] all-reduce(p0), replica_groups={}, to_apply=add
+  user = f32[1024,1024] negate(all-reduce)
+  neg0 = f32[2,2] negate(p1)
+  neg1 = f32[2,2] negate(neg0)
+  ROOT tuple = (f32[1024,1024], f32[2,2]) tuple(user, neg1)
+}
+)";
+  HloModuleConfig config = GetModuleConfigForTest(/*replica_count=*/2);
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_text, config));
+  HloInstruction* all_reduce = FindInstruction(module.get(), "all-reduce");
+  HloInstruction* user = FindInstruction(module.get(), "user");
+  HloInstruction* neg0 = FindInstruction(module.get(), "neg0");
+
+  // Multi-streaming is disabled, yet the all-reduce gets a stream of its own.
+  std::unique_ptr<StreamAssignment> assignment = AssignStreams(*module);
+  EXPECT_EQ(assignment->StreamCount(), 2);
+  EXPECT_EQ(assignment->StreamNumberForHlo(*all_reduce), 1);
+  EXPECT_EQ(assignment->StreamNumberForHlo(*user), 0);
+  EXPECT_EQ(assignment->StreamNumberForHlo(*neg0), 0);
+
+  DebugOptions debug_options = config.debug_options();
+  debug_options.set_xla_gpu_enable_async_collectives(false);
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(module,
+                          ParseAndReturnVerifiedModule(hlo_text, config));
+  assignment = AssignStreams(*module);
+  EXPECT_EQ(assignment->StreamCount(), 1);
+}
+
 }  // namespace gpu
 }  // namespace xla
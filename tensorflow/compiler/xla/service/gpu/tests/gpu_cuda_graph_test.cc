@@ -0,0 +1,72 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <utility>
+
+#include "tensorflow/compiler/xla/service/gpu/tests/gpu_codegen_test.h"
+#include "tensorflow/compiler/xla/service/hlo_module_config.h"
+#include "tensorflow/compiler/xla/tests/literal_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+class GpuCudaGraphTest : public GpuCodegenTest {
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = GpuCodegenTest::GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_enable_cuda_graphs(true);
+    return debug_options;
+  }
+};
+
+// Runs the same executable several times so that its gemm and kernel thunks
+// are executed directly, captured and then replayed.
+TEST_F(GpuCudaGraphTest, ReplayedRunsMatchDirectExecution) {
+  const char* hlo_text = R"(
+HloModule CudaGraph
+
+ENTRY main {
+  iota = f32[32,32] iota(), iota_dimension=0
+  scale = f32[] constant(0.01)
+  scales = f32[32,32] broadcast(scale), dimensions={}
+  x = f32[32,32] multiply(iota, scales)
+  dot0 = f32[32,32] dot(x, x), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  add = f32[32,32] add(dot0, x)
+  ROOT dot1 = f32[32,32] dot(add, x), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo_text));
+  TF_ASSERT_OK_AND_ASSIGN(Literal expected, Execute(module->Clone(), {}));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Executable> executable,
+      test_runner_.CreateExecutable(std::move(module),
+                                    /*run_hlo_passes=*/true));
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, backend().BorrowStream(0));
+  for (int run = 0; run < 4; ++run) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        ExecutionOutput output,
+        test_runner_.ExecuteWithDeviceBuffers(executable.get(), {}));
+    TF_ASSERT_OK_AND_ASSIGN(
+        Literal result, backend().transfer_manager()->TransferLiteralFromDevice(
+                            stream.get(), output.Result()));
+    EXPECT_TRUE(LiteralTestUtil::Near(expected, result, ErrorSpec{1e-3, 1e-3}))
+        << "run " << run;
+  }
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
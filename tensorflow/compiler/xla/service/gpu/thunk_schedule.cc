@@ -69,6 +69,9 @@ ThunkSchedule::ThunkSchedule(
     for (const auto* src : dst->operands()) {
       AddDependenciesOnTransitiveOperands(*thunk, *src, hlo_to_thunk);
     }
+    for (const auto* src : dst->control_predecessors()) {
+      AddDependenciesOnTransitiveOperands(*thunk, *src, hlo_to_thunk);
+    }
   }
 
   RemoveRedundantDependencyEdges();
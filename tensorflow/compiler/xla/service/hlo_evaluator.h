@@ -18,6 +18,7 @@ limitations under the License.
 
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 
@@ -25,6 +26,7 @@ limitations under the License.
 #include "absl/memory/memory.h"
 #include "absl/types/span.h"
 #include "tensorflow/compiler/xla/array2d.h"
+#include "tensorflow/compiler/xla/layout_util.h"
 #include "tensorflow/compiler/xla/literal.h"
 #include "tensorflow/compiler/xla/service/dfs_hlo_visitor_with_default.h"
 #include "tensorflow/compiler/xla/service/dynamic_dimension_inference.h"
@@ -32,6 +34,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_module.h"
 #include "tensorflow/compiler/xla/service/shape_inference.h"
+#include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/statusor.h"
 #include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/compiler/xla/xla_data.pb.h"
@@ -328,6 +331,49 @@ class HloEvaluator : public DfsHloVisitorWithDefault {
   bool use_fast_path_ = false;
 
  private:
+  // Elementwise results with at least this many elements are computed on
+  // several threads, in chunks of kElementsPerEvaluationChunk elements.
+  static constexpr int64 kMinElementsForParallelEvaluation = 1 << 16;
+  static constexpr int64 kElementsPerEvaluationChunk = 1 << 14;
+
+  // Returns true if elements of `operand` and `result` with the same linear
+  // index have the same multi-dimensional index, so that an elementwise op
+  // can be evaluated directly on their buffers.
+  static bool HasLayoutOf(const Literal& operand, const Literal& result) {
+    return LayoutUtil::IsDenseArray(operand.shape()) &&
+           LayoutUtil::IsDenseArray(result.shape()) &&
+           ShapeUtil::SameDimensions(operand.shape(), result.shape()) &&
+           LayoutUtil::Equal(operand.shape().layout(), result.shape().layout());
+  }
+
+  // Sets element i of `result` to `generator(i)` for all linear indices i,
+  // without computing multi-dimensional indices. `generator` may be called
+  // concurrently.
+  template <typename NativeT, typename FnType>
+  static void PopulateLinear(Literal* result, const FnType& generator) {
+    absl::Span<NativeT> data = result->data<NativeT>();
+    const int64 num_elements = data.size();
+    if (num_elements < kMinElementsForParallelEvaluation) {
+      for (int64 i = 0; i < num_elements; ++i) {
+        data[i] = generator(i);
+      }
+      return;
+    }
+    const int64 num_chunks =
+        CeilOfRatio(num_elements, kElementsPerEvaluationChunk);
+    ShapeUtil::ForEachIndexParallel(
+        ShapeUtil::MakeShape(S64, {num_chunks}), /*base=*/{0},
+        /*count=*/{num_chunks}, /*incr=*/{1},
+        [&](absl::Span<const int64> chunk) {
+          const int64 begin = chunk[0] * kElementsPerEvaluationChunk;
+          const int64 end =
+              std::min(begin + kElementsPerEvaluationChunk, num_elements);
+          for (int64 i = begin; i < end; ++i) {
+            data[i] = generator(i);
+          }
+        });
+  }
+
   template <typename ReturnT, typename NativeT>
   static StatusOr<Literal> ElementWiseUnaryOpImpl(
       HloInstruction* instruction,
@@ -338,6 +384,12 @@ class HloEvaluator : public DfsHloVisitorWithDefault {
     TF_RET_CHECK(ShapeUtil::SameDimensions(shape, operand->shape()));
 
     Literal result(shape);
+    if (HasLayoutOf(operand_literal, result)) {
+      absl::Span<const NativeT> operand_data = operand_literal.data<NativeT>();
+      PopulateLinear<ReturnT>(
+          &result, [&](int64 i) { return unary_op(operand_data[i]); });
+      return std::move(result);
+    }
     TF_RETURN_IF_ERROR(
         result.Populate<ReturnT>([&](absl::Span<const int64> multi_index) {
           return unary_op(operand_literal.Get<NativeT>(multi_index));
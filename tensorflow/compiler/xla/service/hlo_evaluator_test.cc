@@ -23,7 +23,9 @@ limitations under the License.
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_format.h"
+#include "tensorflow/compiler/xla/array2d.h"
 #include "tensorflow/compiler/xla/client/xla_builder.h"
+#include "tensorflow/compiler/xla/layout_util.h"
 #include "tensorflow/compiler/xla/literal.h"
 #include "tensorflow/compiler/xla/reference_util.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
@@ -321,6 +323,45 @@ TEST_F(HloEvaluatorTest, DoesAdd) {
   TestBinaryOp(HloOpcode::kAdd, std::move(expected), std::move(lhs),
                std::move(rhs));
 }
+
+// Verifies that large element-wise ops, which are evaluated in parallel on the
+// operand buffers, give the same results as the per-index evaluation, also
+// when an operand has a different layout.
+TEST_F(HloEvaluatorTest, DoesLargeAdd) {
+  Array2D<int64> lhs_array(512, 256);
+  Array2D<int64> rhs_array(512, 256);
+  Array2D<int64> expected_array(512, 256);
+  for (int64 i = 0; i < 512; ++i) {
+    for (int64 j = 0; j < 256; ++j) {
+      lhs_array(i, j) = i * 256 + j;
+      rhs_array(i, j) = i - j;
+      expected_array(i, j) = lhs_array(i, j) + rhs_array(i, j);
+    }
+  }
+  TestBinaryOp(HloOpcode::kAdd,
+               LiteralUtil::CreateR2FromArray2D<int64>(expected_array),
+               LiteralUtil::CreateR2FromArray2D<int64>(lhs_array),
+               LiteralUtil::CreateR2FromArray2D<int64>(rhs_array));
+}
+
+TEST_F(HloEvaluatorTest, DoesLargeAddWithDifferentLayouts) {
+  Array2D<int64> lhs_array(512, 256);
+  Array2D<int64> rhs_array(512, 256);
+  Array2D<int64> expected_array(512, 256);
+  for (int64 i = 0; i < 512; ++i) {
+    for (int64 j = 0; j < 256; ++j) {
+      lhs_array(i, j) = i * 256 + j;
+      rhs_array(i, j) = i - j;
+      expected_array(i, j) = lhs_array(i, j) + rhs_array(i, j);
+    }
+  }
+  TestBinaryOp(
+      HloOpcode::kAdd, LiteralUtil::CreateR2FromArray2D<int64>(expected_array),
+      LiteralUtil::CreateR2FromArray2DWithLayout<int64>(
+          lhs_array, LayoutUtil::MakeLayout({0, 1})),
+      LiteralUtil::CreateR2FromArray2D<int64>(rhs_array));
+}
+
 // Verifies that HloEvaluator evaluates a HLO instruction that performs
 // element-wise and with 2 operands.
 TEST_P(HloEvaluatorBf16Test, DoesAnd) {
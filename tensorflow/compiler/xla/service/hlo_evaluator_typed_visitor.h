@@ -2982,6 +2982,16 @@ class HloEvaluatorTypedVisitor : public DfsHloVisitorWithDefault {
 
     Literal result(shape);
 
+    if (HloEvaluator::HasLayoutOf(lhs_literal, result) &&
+        HloEvaluator::HasLayoutOf(rhs_literal, result)) {
+      absl::Span<const ReturnT> lhs_data = lhs_literal.data<ReturnT>();
+      absl::Span<const ReturnT> rhs_data = rhs_literal.data<ReturnT>();
+      auto converted_op = ConvertBinaryFunction(binary_op);
+      HloEvaluator::PopulateLinear<ReturnT>(&result, [&](int64 i) {
+        return converted_op(lhs_data[i], rhs_data[i]);
+      });
+      return std::move(result);
+    }
     TF_RETURN_IF_ERROR(
         result.Populate<ReturnT>([&](absl::Span<const int64> multi_index) {
           return ConvertBinaryFunction(binary_op)(
@@ -3009,6 +3019,17 @@ class HloEvaluatorTypedVisitor : public DfsHloVisitorWithDefault {
 
     Literal result(shape);
 
+    if (HloEvaluator::HasLayoutOf(lhs_literal, result) &&
+        HloEvaluator::HasLayoutOf(rhs_literal, result) &&
+        HloEvaluator::HasLayoutOf(ehs_literal, result)) {
+      absl::Span<const LhsType> lhs_data = lhs_literal.data<LhsType>();
+      absl::Span<const RhsType> rhs_data = rhs_literal.data<RhsType>();
+      absl::Span<const EhsType> ehs_data = ehs_literal.data<EhsType>();
+      HloEvaluator::PopulateLinear<ReturnT>(&result, [&](int64 i) {
+        return ternary_op(lhs_data[i], rhs_data[i], ehs_data[i]);
+      });
+      return std::move(result);
+    }
     TF_RETURN_IF_ERROR(
         result.Populate<ReturnT>([&](absl::Span<const int64> multi_index) {
           return ternary_op(lhs_literal.Get<LhsType>(multi_index),
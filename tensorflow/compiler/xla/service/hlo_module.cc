@@ -768,6 +768,12 @@ HloComputation* HloModule::DeepCloneComputation(HloComputation* computation,
   return new_computation;
 }
 
+void HloModule::UniquifyInstruction(HloInstruction* instruction) {
+  tensorflow::mutex_lock lock(instruction_uniquer_mutex_);
+  instruction->UniquifyName(&instruction_name_uniquer_);
+  instruction->SetUniqueId(NewUniqueInstructionId());
+}
+
 uint64 HloModule::RandomNew64() const {
   tensorflow::mutex_lock l(rng_mutex_);
   return rng_();
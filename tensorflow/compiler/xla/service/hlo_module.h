@@ -270,6 +270,12 @@ class HloModule {
   // Returns the NameUniquer for uniquing instruction names in this module.
   NameUniquer& instruction_name_uniquer() { return instruction_name_uniquer_; }
 
+  // Gives the instruction a name and a dense id that are unique in this
+  // module. Unlike the non-thread-safe instruction_name_uniquer() and
+  // NewUniqueInstructionId(), this may be called concurrently, which lets
+  // computation passes add instructions to different computations in parallel.
+  void UniquifyInstruction(HloInstruction* instruction);
+
   // Assign a new unique dense id for an instruction
   int NewUniqueInstructionId() {
     int result = next_unique_id_;
@@ -401,6 +407,7 @@ class HloModule {
   NameUniquer computation_name_uniquer_{/*separator=*/"."};
   NameUniquer instruction_name_uniquer_{/*separator=*/"."};
   int next_unique_id_ = 0;
+  tensorflow::mutex instruction_uniquer_mutex_;
 
   // Used to keep track of the next unique module id that should be assigned.
   static std::atomic<int> next_unique_module_id_;
@@ -43,6 +43,9 @@ class HloPassInterface {
   virtual StatusOr<bool> RunOnModuleGroup(HloModuleGroup* module_group) = 0;
 
   virtual bool IsPassPipeline() { return false; }
+
+  // Whether the pass is an HloComputationPass.
+  virtual bool IsComputationPass() { return false; }
 };
 
 // Base class for passes which are module-scoped.
@@ -68,6 +71,30 @@ class HloModulePass : public HloPassInterface {
   virtual void UpdateLayout(Shape* shape) {}
 };
 
+// Base class for passes which transform each non-fusion computation of a module
+// independently: RunOnComputation may only read and modify the given
+// computation and must not add or remove computations. This lets
+// HloPassPipeline run these passes over the computations of a module in
+// parallel.
+class HloComputationPass : public HloModulePass {
+ public:
+  // Run the pass on the given computation. Returns whether it modified the
+  // computation.
+  virtual StatusOr<bool> RunOnComputation(HloComputation* computation) = 0;
+
+  StatusOr<bool> Run(HloModule* module) override {
+    bool changed = false;
+    for (HloComputation* computation : module->MakeNonfusionComputations()) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed,
+                          RunOnComputation(computation));
+      changed |= computation_changed;
+    }
+    return changed;
+  }
+
+  bool IsComputationPass() override { return true; }
+};
+
 // Base class for passes which are module-group scoped. These passes cannot run
 // on an HLO module.
 class HloModuleGroupPass : public HloPassInterface {
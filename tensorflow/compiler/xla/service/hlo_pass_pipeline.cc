@@ -27,6 +27,8 @@ limitations under the License.
 #include "tensorflow/compiler/xla/status_macros.h"
 #include "tensorflow/compiler/xla/types.h"
 #include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 
 namespace xla {
@@ -161,6 +163,21 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
 
   bool changed = false;
   for (int i = 0; i < passes.size(); i++) {
+    int num_parallel_passes =
+        NumParallelComputationPasses(hlo, passes.subspan(i));
+    if (num_parallel_passes > 0) {
+      int next = i + num_parallel_passes;
+      TF_ASSIGN_OR_RETURN(
+          bool passes_changed,
+          RunComputationPassesInParallel(
+              hlo, passes.subspan(i, num_parallel_passes),
+              /*before_pass_name=*/next >= passes.size()
+                  ? kPipelineEnd
+                  : passes[next]->name()));
+      changed |= passes_changed;
+      i = next - 1;
+      continue;
+    }
     HloPassInterface* pass = passes[i];
     XLA_SCOPED_LOGGING_TIMER(absl::StrCat("HLO pass: ", pass->name()));
     std::string pass_name = std::string(pass->name());
@@ -190,6 +207,95 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
   return changed;
 }
 
+int HloPassPipeline::NumParallelComputationPasses(
+    HloModule* module, absl::Span<HloPassInterface* const> passes) {
+  if (thread_pool_ == nullptr ||
+      module->config().debug_options().xla_hlo_pass_pipeline_parallelism() <
+          2) {
+    return 0;
+  }
+  int num_passes = 0;
+  while (num_passes < passes.size() &&
+         passes[num_passes]->IsComputationPass()) {
+    num_passes++;
+  }
+  return num_passes;
+}
+
+int HloPassPipeline::NumParallelComputationPasses(
+    HloModuleGroup* module_group, absl::Span<HloPassInterface* const> passes) {
+  return 0;
+}
+
+StatusOr<bool> HloPassPipeline::RunComputationPassesInParallel(
+    HloModule* module, absl::Span<HloPassInterface* const> passes,
+    absl::string_view before_pass_name) {
+  std::vector<std::string> pass_names;
+  for (HloPassInterface* pass : passes) {
+    pass_names.emplace_back(pass->name());
+  }
+  std::string passes_name = absl::StrJoin(pass_names, ",");
+  XLA_SCOPED_LOGGING_TIMER(absl::StrCat("HLO passes: ", passes_name));
+  VLOG(1) << "  HLO passes " << passes_name << " in parallel";
+  compilation_stats_->StartPass(passes_name);
+
+  // Every computation goes through all passes on its own: the passes only
+  // touch the computation they run on.
+  std::vector<HloComputation*> computations =
+      module->MakeNonfusionComputations();
+  std::vector<Status> statuses(computations.size());
+  std::vector<std::vector<char>> pass_changed(
+      computations.size(), std::vector<char>(passes.size(), false));
+  tensorflow::BlockingCounter counter(computations.size());
+  for (int i = 0; i < computations.size(); i++) {
+    thread_pool_->Schedule([&, i]() {
+      for (int j = 0; j < passes.size(); j++) {
+        StatusOr<bool> changed =
+            static_cast<HloComputationPass*>(passes[j])->RunOnComputation(
+                computations[i]);
+        if (!changed.ok()) {
+          statuses[i] = changed.status();
+          break;
+        }
+        pass_changed[i][j] = changed.ValueOrDie();
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  module->Cleanup();
+
+  std::string pipeline_name = std::string(name());
+  bool changed = false;
+  for (int j = 0; j < passes.size(); j++) {
+    bool changed_by_pass = false;
+    for (int i = 0; i < computations.size(); i++) {
+      changed_by_pass |= pass_changed[i][j];
+    }
+    RecordPassStartMetadata(*module, pass_names[j], pipeline_name);
+    SetInstructionMetadata(*module);
+    if (j + 1 == passes.size()) {
+      MaybeDumpHloAndSaveFilenames(*module, /*after_pass_name=*/pass_names[j],
+                                   before_pass_name);
+    }
+    RecordPassEndMetadata(*module, pass_names[j], changed_by_pass);
+    changed |= changed_by_pass;
+  }
+  TF_RETURN_IF_ERROR(RunInvariantCheckers(module, pass_names.back()));
+  compilation_stats_->EndPass(passes_name);
+  return changed;
+}
+
+StatusOr<bool> HloPassPipeline::RunComputationPassesInParallel(
+    HloModuleGroup* module_group, absl::Span<HloPassInterface* const> passes,
+    absl::string_view before_pass_name) {
+  return InternalError(
+      "Computation passes cannot run in parallel on a module group");
+}
+
 std::vector<HloPassInterface*> HloPassPipeline::GetEnabledPasses(
     const DebugOptions& debug_options) {
   if (debug_options.xla_disable_all_hlo_passes()) {
@@ -260,6 +366,14 @@ StatusOr<bool> HloPassPipeline::Run(HloModule* module) {
   VLOG(1) << "Running HLO pass pipeline on module " << module->name() << ": "
           << name();
 
+  int parallelism =
+      module->config().debug_options().xla_hlo_pass_pipeline_parallelism();
+  if (parallelism > 1 && (thread_pool_ == nullptr ||
+                          thread_pool_->NumThreads() != parallelism)) {
+    thread_pool_ = absl::make_unique<tensorflow::thread::ThreadPool>(
+        tensorflow::Env::Default(), "hlo_pass_pipeline", parallelism);
+  }
+
   return RunPassesInternal(module,
                            GetEnabledPasses(module->config().debug_options()));
 }
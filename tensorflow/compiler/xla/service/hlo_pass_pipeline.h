@@ -29,10 +29,18 @@ limitations under the License.
 #include "tensorflow/compiler/xla/statusor.h"
 #include "tensorflow/compiler/xla/types.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace xla {
 
 // Pipeline of HLO passes.
+//
+// If DebugOptions::xla_hlo_pass_pipeline_parallelism is at least 2, each run of
+// consecutive HloComputationPasses is applied to the non-fusion computations of
+// a module in parallel, every computation going through all passes of the run
+// on its own. Other passes act as barriers: they only start once all
+// computations have gone through the preceding computation passes. Invariant
+// checkers run and the HLO is dumped after the whole run of computation passes.
 class HloPassPipeline : public HloPassInterface {
  public:
   explicit HloPassPipeline(const string& name,
@@ -110,6 +118,24 @@ class HloPassPipeline : public HloPassInterface {
   StatusOr<bool> RunPassesInternal(HloT* hlo,
                                    absl::Span<HloPassInterface* const> passes);
 
+  // Returns how many of the leading passes are computation passes to run in
+  // parallel over the computations of the given HLO, or 0 if they run
+  // serially.
+  int NumParallelComputationPasses(HloModule* module,
+                                   absl::Span<HloPassInterface* const> passes);
+  int NumParallelComputationPasses(HloModuleGroup* module_group,
+                                   absl::Span<HloPassInterface* const> passes);
+
+  // Runs the given computation passes over the non-fusion computations of the
+  // given HLO on thread_pool_. `before_pass_name` names the pass that follows
+  // them, for dumping.
+  StatusOr<bool> RunComputationPassesInParallel(
+      HloModule* module, absl::Span<HloPassInterface* const> passes,
+      absl::string_view before_pass_name);
+  StatusOr<bool> RunComputationPassesInParallel(
+      HloModuleGroup* module_group, absl::Span<HloPassInterface* const> passes,
+      absl::string_view before_pass_name);
+
   // Helpers which run the given passes on the given HLO construct. These
   // helpers enable templating of the core of the pipeline logic by providing
   // HloModule and HloModuleGroup specific methods with the same name.
@@ -134,6 +160,10 @@ class HloPassPipeline : public HloPassInterface {
   // Default stats instance for when one is not passed in the constructor.
   // Use via compilation_stats_, not directly.
   std::unique_ptr<CompilationStats> empty_compilation_stats_;
+
+  // Runs computation passes in parallel. Created by Run according to the
+  // debug options of the module.
+  std::unique_ptr<tensorflow::thread::ThreadPool> thread_pool_;
 };
 
 }  // namespace xla
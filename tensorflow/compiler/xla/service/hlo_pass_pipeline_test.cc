@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/hlo_pass_pipeline.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_module.h"
@@ -62,6 +63,19 @@ class FooToBarModulePass : public HloModulePass {
   }
 };
 
+// A computation pass which negates the root of each computation.
+class NegateRootComputationPass : public HloComputationPass {
+  absl::string_view name() const override { return "negate-root"; }
+
+  StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    HloInstruction* root = computation->root_instruction();
+    computation->set_root_instruction(
+        computation->AddInstruction(HloInstruction::CreateUnary(
+            root->shape(), HloOpcode::kNegate, root)));
+    return true;
+  }
+};
+
 // A module group pass which renames instructions named 'baz' to 'qux'.
 class BazToQuxModuleGroupPass : public HloModuleGroupPass {
   absl::string_view name() const override { return "baz2qux"; }
@@ -142,6 +156,69 @@ ENTRY main {
   EXPECT_FALSE(changed);
 }
 
+TEST_F(HloPassPipelineTest, ComputationPassesInParallel) {
+  const string module_str = R"(
+HloModule ComputationPassesInParallel
+
+callee.0 {
+  ROOT p = f32[] parameter(0)
+}
+
+callee.1 {
+  ROOT p = f32[] parameter(0)
+}
+
+callee.2 {
+  ROOT p = f32[] parameter(0)
+}
+
+ENTRY main {
+  a = f32[] parameter(0)
+  call.0 = f32[] call(a), to_apply=callee.0
+  call.1 = f32[] call(call.0), to_apply=callee.1
+  ROOT foo = f32[] call(call.1), to_apply=callee.2
+}
+)";
+  HloModuleConfig config = GetModuleConfigForTest();
+  DebugOptions debug_options = GetDebugOptionsForTest();
+  debug_options.set_xla_hlo_pass_pipeline_parallelism(4);
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str, config));
+  HloPassPipeline pipeline(TestName());
+  pipeline.AddPass<NegateRootComputationPass>();
+  pipeline.AddPass<NegateRootComputationPass>();
+  pipeline.AddPass<FooToBarModulePass>();
+  pipeline.AddPass<NegateRootComputationPass>();
+
+  HloInstruction* foo = module->entry_computation()->root_instruction();
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, pipeline.Run(module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(foo->name(), "bar");
+
+  // Every computation went through all passes, and the instructions added
+  // concurrently still have unique names and ids.
+
+  absl::flat_hash_set<int> unique_ids;
+  absl::flat_hash_set<string> names;
+  int num_instructions = 0;
+  for (HloComputation* computation : module->computations()) {
+    HloInstruction* root = computation->root_instruction();
+    for (int i = 0; i < 3; i++) {
+      ASSERT_EQ(root->opcode(), HloOpcode::kNegate);
+      root = root->mutable_operand(0);
+    }
+    EXPECT_NE(root->opcode(), HloOpcode::kNegate);
+    for (HloInstruction* instruction : computation->instructions()) {
+      unique_ids.insert(instruction->unique_id());
+      names.insert(instruction->name());
+      num_instructions++;
+    }
+  }
+  EXPECT_EQ(unique_ids.size(), num_instructions);
+  EXPECT_EQ(names.size(), num_instructions);
+}
+
 TEST_F(HloPassPipelineTest, MixedPipeline) {
   // Test a pipeline with both a module pass and a module group pass.
   const string module_0_str = R"(
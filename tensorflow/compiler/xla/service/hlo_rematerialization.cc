@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <set>
 #include <string>
@@ -25,6 +26,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -33,6 +35,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/buffer_value.h"
 #include "tensorflow/compiler/xla/service/flatten_call_graph.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
+#include "tensorflow/compiler/xla/service/hlo_cost_analysis.h"
 #include "tensorflow/compiler/xla/service/hlo_dce.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_memory_scheduler.h"
@@ -477,7 +480,8 @@ class MemoryUsageTracker {
       const HloRematerialization::CompactShapeFunction& compact_shape_function,
       const TuplePointsToAnalysis& points_to_analysis,
       const InstructionList& instruction_list,
-      HloRematerialization::RematerializationMode mode);
+      HloRematerialization::RematerializationMode mode,
+      const HloCostAnalysis* cost_analysis);
 
   // Starts the placement of the given instruction. This adds the sizes of the
   // LogicalBuffers defined by the instruction to the current memory
@@ -507,8 +511,24 @@ class MemoryUsageTracker {
     }
 
     CHECK_GT(memory_reduced, 0);
-    // Return the inverse of the benefit of rematerialization.
-    return memory_limit_bytes / memory_reduced;
+    if (cost_analysis_ == nullptr) {
+      // Return the inverse of the benefit of rematerialization.
+      return memory_limit_bytes / memory_reduced;
+    }
+    // Weigh the inverse of the benefit by the work of recomputing the block, so
+    // that the cheapest of the blocks saving as much memory is picked.
+    // Instructions added by rematerialization are not in the analysis and
+    // count as free.
+    double recompute_cost = 1.0;
+    for (auto* item : items) {
+      recompute_cost += cost_analysis_->flop_count(*item->instruction) +
+                        cost_analysis_->bytes_accessed(*item->instruction);
+    }
+    const double cost = recompute_cost * memory_limit_bytes / memory_reduced;
+    if (cost >= static_cast<double>(std::numeric_limits<int64>::max())) {
+      return std::numeric_limits<int64>::max();
+    }
+    return static_cast<int64>(cost);
   }
 
   // Finishes the placement of the current instruction. This frees any dead
@@ -755,6 +775,11 @@ class MemoryUsageTracker {
   Item* in_progress_item_ = nullptr;
 
   HloRematerialization::RematerializationMode mode_;
+
+  // Estimates the work of recomputing instructions, or null if
+  // rematerialization candidates are picked on memory savings only.
+  const HloCostAnalysis* cost_analysis_;
+
   // All buffers in the computation.
   std::vector<Buffer> buffers_;
 };
@@ -765,12 +790,14 @@ MemoryUsageTracker::MemoryUsageTracker(
     const HloRematerialization::CompactShapeFunction& compact_shape_function,
     const TuplePointsToAnalysis& points_to_analysis,
     const InstructionList& instruction_list,
-    HloRematerialization::RematerializationMode mode)
+    HloRematerialization::RematerializationMode mode,
+    const HloCostAnalysis* cost_analysis)
     : computation_(computation),
       instruction_list_(instruction_list),
       size_function_(size_function),
       compact_shape_function_(compact_shape_function),
-      mode_(mode) {
+      mode_(mode),
+      cost_analysis_(cost_analysis) {
   PointsToSet::BufferSet live_out_set =
       points_to_analysis.GetPointsToSet(computation_->root_instruction())
           .CreateFlattenedSet();
@@ -1417,7 +1444,7 @@ MemoryUsageTracker::PickRematerializationCandidates(
       const int64 memory_reduced = MemoryReducedIfRematerialized(block);
 
       if (memory_reduced > 0) {
-        const int cost =
+        const int64 cost =
             RematerializationCost(block, memory_reduced, memory_limit_bytes);
 
         VLOG(5) << "Candidate block of size " << block.size()
@@ -1770,10 +1797,21 @@ StatusOr<bool> HloRematerialization::RematerializeComputation(
           << HumanReadableNumBytes(computation_peak_memory_.at(computation));
   CHECK(!ContainsKey(rematerialized_computations_, computation));
 
+  std::unique_ptr<HloCostAnalysis> cost_analysis;
+  if (use_recompute_cost_) {
+    cost_analysis = absl::make_unique<HloCostAnalysis>(size_function_);
+    Status status = computation->Accept(cost_analysis.get());
+    if (!status.ok()) {
+      VLOG(1) << "Picking rematerialization candidates on memory savings only: "
+              << status;
+      cost_analysis.reset();
+    }
+  }
+
   InstructionList instruction_list(schedule->sequence(computation));
   MemoryUsageTracker memory_tracker(
       computation, size_function_, compact_shape_function_,
-      *points_to_analysis_, instruction_list, mode_);
+      *points_to_analysis_, instruction_list, mode_, cost_analysis.get());
 
   instruction_list.PromoteNodesToSkip([&](Item* item) {
     return memory_tracker.AllocatedSize(item) >= min_remat_size;
@@ -80,13 +80,18 @@ class HloRematerialization : public HloModulePass {
   //
   //   compact_shape_function: Function which returns the compact form of a
   //   shape. If nullptr is provided, an default identity function is used.
+  //
+  //   use_recompute_cost: If true, candidates are ranked by the memory they
+  //   save per flop and byte accessed to recompute them, as estimated by
+  //   HloCostAnalysis, rather than by the memory they save only. This trades
+  //   some compile time for less recomputation at run time.
   explicit HloRematerialization(
       const ShapeSizeFunction& size_function, int64 memory_limit_bytes,
       RematerializationSizes* sizes, RematerializationPass pass_location,
       int block_size_limit,
       CompactShapeFunction compact_shape_function = nullptr,
       RematerializationMode mode = RematerializationMode::kRecomputeAndCompress,
-      int64 min_remat_size = 0)
+      int64 min_remat_size = 0, bool use_recompute_cost = false)
       : size_function_(size_function),
         memory_limit_bytes_(memory_limit_bytes),
         sizes_(sizes),
@@ -96,7 +101,8 @@ class HloRematerialization : public HloModulePass {
                                     ? DefaultCompactShapeFunction
                                     : std::move(compact_shape_function)),
         mode_(mode),
-        min_remat_size_(min_remat_size) {}
+        min_remat_size_(min_remat_size),
+        use_recompute_cost_(use_recompute_cost) {}
   ~HloRematerialization() override = default;
 
   absl::string_view name() const override { return "rematerialization"; }
@@ -190,6 +196,9 @@ class HloRematerialization : public HloModulePass {
   RematerializationMode mode_;
 
   int64 min_remat_size_;
+
+  // Whether to rank candidates by their recomputation cost too.
+  const bool use_recompute_cost_;
 };
 
 }  // namespace xla
@@ -42,7 +42,8 @@ class HloRematerializationTest : public RematerializationTestBase {
  protected:
   StatusOr<bool> RunHloRematerialization(int64 memory_limit_bytes,
                                          HloModule* module,
-                                         int64 min_remat_size = 0) {
+                                         int64 min_remat_size = 0,
+                                         bool use_recompute_cost = false) {
     TF_EXPECT_OK(verifier().Run(module).status());
     HloMemoryScheduler scheduler(
         [](const BufferValue& buffer) { return ByteSizeOf(buffer.shape()); },
@@ -54,7 +55,7 @@ class HloRematerializationTest : public RematerializationTestBase {
         HloRematerialization::RematerializationPass::kPreFusion,
         /*block_size_limit=*/1, nullptr,
         HloRematerialization::RematerializationMode::kRecomputeAndCompress,
-        min_remat_size);
+        min_remat_size, use_recompute_cost);
     return remat.Run(module);
   }
 };
@@ -99,6 +100,28 @@ TEST_F(HloRematerializationTest, SingleComputation) {
             remat_bcast);
 }
 
+// Test that ranking candidates by their recomputation cost still
+// rematerializes the broadcast, the only candidate saving enough memory.
+TEST_F(HloRematerializationTest, SingleComputationWithRecomputeCost) {
+  auto module = CreateNewVerifiedModule();
+  HloComputation* computation =
+      module->AddEntryComputation(MakeRematerializableComputation());
+
+  const HloInstruction* slice = computation->root_instruction();
+  ASSERT_THAT(slice, op::Slice(op::Concatenate(op::Broadcast(_), _)));
+  const HloInstruction* concat = slice->operand(0);
+  const HloInstruction* bcast = concat->operand(0);
+
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloRematerialization(
+                              /*memory_limit_bytes=*/14 * 1024, module.get(),
+                              /*min_remat_size=*/0,
+                              /*use_recompute_cost=*/true));
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(computation->root_instruction(), slice);
+  EXPECT_THAT(concat->operand(0), op::Broadcast(::testing::Ne(bcast)));
+}
+
 // Test rematerialization of a single computation that contains nodes that
 // doesn't contain node worth using remat.
 TEST_F(HloRematerializationTest, SingleComputationNoWorthRemat) {
@@ -0,0 +1,502 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/spmd/auto_sharding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_join.h"
+#include "absl/types/optional.h"
+#include "tensorflow/compiler/xla/array.h"
+#include "tensorflow/compiler/xla/service/hlo_computation.h"
+#include "tensorflow/compiler/xla/service/hlo_cost_analysis.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/hlo_opcode.h"
+#include "tensorflow/compiler/xla/service/hlo_sharding.h"
+#include "tensorflow/compiler/xla/service/sharding_propagation.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace xla {
+namespace spmd {
+namespace {
+
+constexpr int64 kPointerSize = 8;
+
+// Costs closer than this, relative to each other, are considered equal.
+constexpr double kRelativeTolerance = 1e-9;
+
+// The number of times the weight of parameter memory is doubled before giving
+// up on the memory budget.
+constexpr int64 kMaxMemoryRounds = 32;
+
+// A dimension that a mesh axis may shard, given by its index in the output
+// and in each operand of an instruction, or -1 where it does not appear.
+using DimensionMapping = std::vector<int64>;
+
+// One way to shard an instruction.
+struct Strategy {
+  HloSharding output_sharding = HloSharding::Replicate();
+  // The shardings the instruction expects its operands in, if any.
+  std::vector<absl::optional<HloSharding>> operand_shardings;
+  // The compute and communication cost of the instruction itself.
+  double cost = 0;
+  // The size of the output on each device.
+  int64 bytes_per_device = 0;
+};
+
+struct Node {
+  HloInstruction* instruction;
+  // The node producing each operand, or -1.
+  std::vector<int64> operand_nodes;
+  // The nodes using this node, with the operand number they use it as.
+  std::vector<std::pair<int64, int64>> users;
+  std::vector<Strategy> strategies;
+  int64 chosen = -1;
+};
+
+// Returns the sharding of `shape` that tiles dimension dims[a] over mesh axis
+// a, replicating over the axes where dims[a] is -1.
+HloSharding MeshSharding(const Shape& shape, absl::Span<const int64> mesh,
+                         absl::Span<const int64> dims) {
+  std::vector<int64> tile_dims(shape.rank(), 1);
+  int64 replication = 1;
+  for (int64 a = 0; a < mesh.size(); ++a) {
+    if (dims[a] >= 0) {
+      tile_dims[dims[a]] = mesh[a];
+    } else {
+      replication *= mesh[a];
+    }
+  }
+  if (replication == Product(mesh)) {
+    return HloSharding::Replicate();
+  }
+  if (replication > 1) {
+    tile_dims.push_back(replication);
+  }
+  Array<int64> tile_assignment(tile_dims);
+  Array<int64> devices(mesh);
+  devices.Each([&](absl::Span<const int64> coordinates, int64* /*device*/) {
+    std::vector<int64> index(tile_dims.size(), 0);
+    int64 device = 0;
+    int64 replica = 0;
+    for (int64 a = 0; a < mesh.size(); ++a) {
+      device = device * mesh[a] + coordinates[a];
+      if (dims[a] >= 0) {
+        index[dims[a]] = coordinates[a];
+      } else {
+        replica = replica * mesh[a] + coordinates[a];
+      }
+    }
+    if (replication > 1) {
+      index.back() = replica;
+    }
+    tile_assignment(index) = device;
+  });
+  return replication > 1 ? HloSharding::PartialTile(tile_assignment)
+                         : HloSharding::Tile(tile_assignment);
+}
+
+std::vector<DimensionMapping> ParameterMappings(const HloInstruction* hlo) {
+  std::vector<DimensionMapping> mappings;
+  for (int64 d = 0; d < hlo->shape().rank(); ++d) {
+    mappings.push_back({d});
+  }
+  return mappings;
+}
+
+std::vector<DimensionMapping> DotMappings(const HloInstruction* dot) {
+  const DotDimensionNumbers& dnums = dot->dot_dimension_numbers();
+  std::vector<DimensionMapping> mappings;
+  int64 output_dim = 0;
+  for (int64 i = 0; i < dnums.lhs_batch_dimensions_size(); ++i) {
+    mappings.push_back({output_dim++, dnums.lhs_batch_dimensions(i),
+                        dnums.rhs_batch_dimensions(i)});
+  }
+  for (int64 d = 0; d < dot->operand(0)->shape().rank(); ++d) {
+    if (!absl::c_linear_search(dnums.lhs_batch_dimensions(), d) &&
+        !absl::c_linear_search(dnums.lhs_contracting_dimensions(), d)) {
+      mappings.push_back({output_dim++, d, -1});
+    }
+  }
+  for (int64 d = 0; d < dot->operand(1)->shape().rank(); ++d) {
+    if (!absl::c_linear_search(dnums.rhs_batch_dimensions(), d) &&
+        !absl::c_linear_search(dnums.rhs_contracting_dimensions(), d)) {
+      mappings.push_back({output_dim++, -1, d});
+    }
+  }
+  for (int64 i = 0; i < dnums.lhs_contracting_dimensions_size(); ++i) {
+    mappings.push_back({-1, dnums.lhs_contracting_dimensions(i),
+                        dnums.rhs_contracting_dimensions(i)});
+  }
+  return mappings;
+}
+
+// Only the batch and feature dimensions of a convolution are sharded; the
+// spatial dimensions would need halo exchanges.
+std::vector<DimensionMapping> ConvolutionMappings(const HloInstruction* conv) {
+  if (conv->feature_group_count() != 1 || conv->batch_group_count() != 1) {
+    return {};
+  }
+  const ConvolutionDimensionNumbers& dnums =
+      conv->convolution_dimension_numbers();
+  return {{dnums.output_batch_dimension(), dnums.input_batch_dimension(), -1},
+          {dnums.output_feature_dimension(), -1,
+           dnums.kernel_output_feature_dimension()},
+          {-1, dnums.input_feature_dimension(),
+           dnums.kernel_input_feature_dimension()}};
+}
+
+// Returns the strategies of `hlo` that assign each mesh axis to a distinct
+// mapping in `mappings`, or replicate over it.
+std::vector<Strategy> EnumerateStrategies(
+    const HloInstruction* hlo, const std::vector<DimensionMapping>& mappings,
+    double flops, absl::Span<const int64> mesh,
+    const AutoShardingOptions& options) {
+  std::vector<const Shape*> shapes = {&hlo->shape()};
+  for (const HloInstruction* operand : hlo->operands()) {
+    shapes.push_back(&operand->shape());
+  }
+  const int64 num_choices = mappings.size() + 1;
+  const int64 num_assignments =
+      static_cast<int64>(std::pow(num_choices, mesh.size()));
+  std::vector<Strategy> strategies;
+  for (int64 n = 0; n < num_assignments; ++n) {
+    // Mesh axis a uses mappings[assignment[a]], or none if it is -1.
+    std::vector<int64> assignment(mesh.size());
+    for (int64 a = 0, rest = n; a < mesh.size(); ++a, rest /= num_choices) {
+      assignment[a] = rest % num_choices - 1;
+    }
+    bool valid = true;
+    int64 num_shards = 1;
+    int64 contraction_group = 1;
+    for (int64 a = 0; a < mesh.size() && valid; ++a) {
+      if (assignment[a] < 0) {
+        continue;
+      }
+      valid = absl::c_count(assignment, assignment[a]) == 1;
+      const DimensionMapping& mapping = mappings[assignment[a]];
+      for (int64 t = 0; t < shapes.size() && valid; ++t) {
+        valid = mapping[t] < 0 ||
+                shapes[t]->dimensions(mapping[t]) % mesh[a] == 0;
+      }
+      num_shards *= mesh[a];
+      if (mapping[0] < 0) {
+        contraction_group *= mesh[a];
+      }
+    }
+    if (!valid) {
+      continue;
+    }
+
+    std::vector<std::vector<int64>> dims(shapes.size(),
+                                         std::vector<int64>(mesh.size(), -1));
+    for (int64 a = 0; a < mesh.size(); ++a) {
+      for (int64 t = 0; t < shapes.size() && assignment[a] >= 0; ++t) {
+        dims[t][a] = mappings[assignment[a]][t];
+      }
+    }
+    Strategy strategy;
+    strategy.output_sharding = MeshSharding(*shapes[0], mesh, dims[0]);
+    if (hlo->opcode() != HloOpcode::kParameter) {
+      for (int64 t = 1; t < shapes.size(); ++t) {
+        strategy.operand_shardings.push_back(
+            MeshSharding(*shapes[t], mesh, dims[t]));
+      }
+    }
+    strategy.bytes_per_device = ShapeUtil::ByteSizeOf(*shapes[0]) /
+                                (num_shards / contraction_group);
+    strategy.cost = flops / num_shards / options.flops_per_second;
+    if (contraction_group > 1) {
+      // The partial results are combined with a ring all-reduce.
+      strategy.cost += 2.0 * (contraction_group - 1) / contraction_group *
+                       strategy.bytes_per_device / options.bytes_per_second;
+    }
+    strategies.push_back(std::move(strategy));
+  }
+  return strategies;
+}
+
+// Returns the node producing `operand`, looking through elementwise
+// instructions that keep its dimensions, or -1.
+int64 ProducerNode(
+    const HloInstruction* operand,
+    const absl::flat_hash_map<const HloInstruction*, int64>& node_index) {
+  while (true) {
+    auto it = node_index.find(operand);
+    if (it != node_index.end()) {
+      return it->second;
+    }
+    if (!operand->IsElementwise()) {
+      return -1;
+    }
+    const HloInstruction* next = nullptr;
+    for (const HloInstruction* candidate : operand->operands()) {
+      if (candidate->shape().IsArray() &&
+          candidate->opcode() != HloOpcode::kBroadcast &&
+          candidate->opcode() != HloOpcode::kConstant &&
+          ShapeUtil::SameDimensions(candidate->shape(), operand->shape())) {
+        next = candidate;
+        break;
+      }
+    }
+    if (next == nullptr) {
+      return -1;
+    }
+    operand = next;
+  }
+}
+
+class StrategySearch {
+ public:
+  StrategySearch(std::vector<Node> nodes, const AutoShardingOptions& options)
+      : nodes_(std::move(nodes)), options_(options) {}
+
+  // Assigns a strategy to each node, weighing the bytes of each parameter on a
+  // device by `memory_weight`.
+  void Solve(double memory_weight) {
+    memory_weight_ = memory_weight;
+    for (Node& node : nodes_) {
+      node.chosen = -1;
+    }
+    for (int64 i = 0; i < nodes_.size(); ++i) {
+      nodes_[i].chosen = BestStrategy(i);
+    }
+    for (int64 iteration = 0; iteration < options_.max_iterations;
+         ++iteration) {
+      bool changed = false;
+      for (int64 i = 0; i < nodes_.size(); ++i) {
+        const int64 best = BestStrategy(i);
+        changed |= best != nodes_[i].chosen;
+        nodes_[i].chosen = best;
+      }
+      if (!changed) {
+        break;
+      }
+    }
+  }
+
+  int64 ParameterBytesPerDevice() const {
+    int64 bytes = 0;
+    for (const Node& node : nodes_) {
+      if (node.instruction->opcode() == HloOpcode::kParameter) {
+        bytes += node.strategies[node.chosen].bytes_per_device;
+      }
+    }
+    return bytes;
+  }
+
+  double TotalCost() const {
+    double cost = 0;
+    for (int64 i = 0; i < nodes_.size(); ++i) {
+      const Node& node = nodes_[i];
+      cost += node.strategies[node.chosen].cost;
+      for (int64 k = 0; k < node.operand_nodes.size(); ++k) {
+        if (node.operand_nodes[k] >= 0) {
+          cost += EdgeCost(node.operand_nodes[k],
+                           nodes_[node.operand_nodes[k]].chosen, i,
+                           node.chosen, k);
+        }
+      }
+    }
+    return cost;
+  }
+
+  const std::vector<Node>& nodes() const { return nodes_; }
+
+ private:
+  // The cost of resharding the output of `producer` to the sharding `user`
+  // expects its operand number `operand` in.
+  double EdgeCost(int64 producer, int64 producer_strategy, int64 user,
+                  int64 user_strategy, int64 operand) const {
+    const absl::optional<HloSharding>& expected =
+        nodes_[user].strategies[user_strategy].operand_shardings[operand];
+    const HloSharding& actual =
+        nodes_[producer].strategies[producer_strategy].output_sharding;
+    if (!expected.has_value() || actual == *expected || actual.IsReplicated()) {
+      // Slicing a replicated value is local to each device.
+      return 0;
+    }
+    // Each device receives its shard of the expected sharding.
+    const Shape& shape = nodes_[user].instruction->operand(operand)->shape();
+    return static_cast<double>(ShapeUtil::ByteSizeOf(shape)) /
+           expected->NumTiles() / options_.bytes_per_second;
+  }
+
+  // The cost of strategy `s` of node `i` given the strategies chosen for its
+  // neighbors.
+  double StrategyCost(int64 i, int64 s) const {
+    const Node& node = nodes_[i];
+    const Strategy& strategy = node.strategies[s];
+    double cost = strategy.cost;
+    if (node.instruction->opcode() == HloOpcode::kParameter) {
+      cost += memory_weight_ * strategy.bytes_per_device;
+    }
+    for (int64 k = 0; k < node.operand_nodes.size(); ++k) {
+      const int64 producer = node.operand_nodes[k];
+      if (producer >= 0 && nodes_[producer].chosen >= 0) {
+        cost += EdgeCost(producer, nodes_[producer].chosen, i, s, k);
+      }
+    }
+    for (const auto& user_and_operand : node.users) {
+      const Node& user = nodes_[user_and_operand.first];
+      if (user.chosen >= 0) {
+        cost += EdgeCost(i, s, user_and_operand.first, user.chosen,
+                         user_and_operand.second);
+      }
+    }
+    return cost;
+  }
+
+  // Returns the cheapest strategy of node `i`. Ties keep the current strategy,
+  // then prefer smaller shards.
+  int64 BestStrategy(int64 i) const {
+    const Node& node = nodes_[i];
+    int64 best = node.chosen >= 0 ? node.chosen : 0;
+    double best_cost = StrategyCost(i, best);
+    for (int64 s = 0; s < node.strategies.size(); ++s) {
+      const double cost = StrategyCost(i, s);
+      const double tolerance = kRelativeTolerance * std::max(cost, best_cost);
+      if (cost < best_cost - tolerance ||
+          (cost <= best_cost + tolerance &&
+           node.strategies[s].bytes_per_device <
+               node.strategies[best].bytes_per_device)) {
+        best = s;
+        best_cost = cost;
+      }
+    }
+    return best;
+  }
+
+  std::vector<Node> nodes_;
+  const AutoShardingOptions& options_;
+  double memory_weight_ = 0;
+};
+
+}  // namespace
+
+StatusOr<bool> AutoSharding::Run(HloModule* module) {
+  if (num_partitions_ <= 1) {
+    return false;
+  }
+  std::vector<int64> mesh = options_.mesh_shape;
+  if (mesh.empty()) {
+    mesh.push_back(num_partitions_);
+  }
+  if (Product(mesh) != num_partitions_) {
+    return InvalidArgument("Device mesh [%s] does not have %d devices.",
+                           absl::StrJoin(mesh, ","), num_partitions_);
+  }
+
+  HloComputation* entry = module->entry_computation();
+  HloCostAnalysis cost_analysis([](const Shape& shape) {
+    return ShapeUtil::ByteSizeOf(shape, kPointerSize);
+  });
+  TF_RETURN_IF_ERROR(entry->Accept(&cost_analysis));
+
+  std::vector<Node> nodes;
+  absl::flat_hash_map<const HloInstruction*, int64> node_index;
+  for (HloInstruction* hlo : entry->MakeInstructionPostOrder()) {
+    std::vector<DimensionMapping> mappings;
+    switch (hlo->opcode()) {
+      case HloOpcode::kParameter:
+        if (!hlo->shape().IsArray()) {
+          continue;
+        }
+        mappings = ParameterMappings(hlo);
+        break;
+      case HloOpcode::kDot:
+        mappings = DotMappings(hlo);
+        break;
+      case HloOpcode::kConvolution:
+        mappings = ConvolutionMappings(hlo);
+        break;
+      default:
+        continue;
+    }
+    Node node;
+    node.instruction = hlo;
+    if (hlo->has_sharding()) {
+      // Keep the user's annotation.
+      Strategy strategy;
+      strategy.output_sharding = hlo->sharding();
+      strategy.bytes_per_device = ShapeUtil::ByteSizeOf(hlo->shape());
+      if (!hlo->sharding().IsTuple() && !hlo->sharding().IsManual()) {
+        strategy.bytes_per_device /= hlo->sharding().NumTiles();
+      }
+      strategy.operand_shardings.resize(
+          hlo->opcode() == HloOpcode::kParameter ? 0 : hlo->operand_count());
+      node.strategies.push_back(std::move(strategy));
+    } else {
+      node.strategies = EnumerateStrategies(
+          hlo, mappings, cost_analysis.flop_count(*hlo), mesh, options_);
+    }
+    if (hlo->opcode() != HloOpcode::kParameter) {
+      for (int64 k = 0; k < hlo->operand_count(); ++k) {
+        const int64 producer = ProducerNode(hlo->operand(k), node_index);
+        node.operand_nodes.push_back(producer);
+        if (producer >= 0) {
+          nodes[producer].users.emplace_back(nodes.size(), k);
+        }
+      }
+    }
+    node_index[hlo] = nodes.size();
+    nodes.push_back(std::move(node));
+  }
+
+  StrategySearch search(std::move(nodes), options_);
+  search.Solve(/*memory_weight=*/0);
+  if (options_.memory_budget_per_device > 0) {
+    // Raise the price of parameter memory until the parameters fit.
+    double memory_weight = 1.0 / options_.bytes_per_second;
+    for (int64 round = 0; search.ParameterBytesPerDevice() >
+                          options_.memory_budget_per_device;
+         ++round) {
+      if (round == kMaxMemoryRounds) {
+        LOG(WARNING) << "Parameters of " << module->name() << " need "
+                     << search.ParameterBytesPerDevice()
+                     << " bytes per device, more than the budget of "
+                     << options_.memory_budget_per_device << " bytes.";
+        break;
+      }
+      search.Solve(memory_weight);
+      memory_weight *= 2;
+    }
+  }
+  VLOG(1) << "Auto-sharding cost of " << module->name() << ": "
+          << search.TotalCost();
+
+  bool changed = false;
+  for (const Node& node : search.nodes()) {
+    if (node.instruction->has_sharding()) {
+      continue;
+    }
+    const HloSharding& sharding = node.strategies[node.chosen].output_sharding;
+    VLOG(2) << node.instruction->name() << ": " << sharding.ToString();
+    node.instruction->set_sharding(sharding);
+    changed = true;
+  }
+  TF_ASSIGN_OR_RETURN(bool propagated,
+                      ShardingPropagation(/*is_spmd=*/true).Run(module));
+  return changed || propagated;
+}
+
+}  // namespace spmd
+}  // namespace xla
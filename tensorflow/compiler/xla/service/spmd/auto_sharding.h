@@ -0,0 +1,73 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_SPMD_AUTO_SHARDING_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_SPMD_AUTO_SHARDING_H_
+
+#include <vector>
+
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
+
+namespace xla {
+namespace spmd {
+
+struct AutoShardingOptions {
+  // Shape of the logical device mesh. Device ids are laid out on the mesh in
+  // row-major order. If empty, the devices form a 1D mesh.
+  std::vector<int64> mesh_shape;
+
+  // Throughput of a device, used to turn flops and communicated bytes into a
+  // common cost.
+  double flops_per_second = 1e14;
+  double bytes_per_second = 1e11;
+
+  // The number of bytes of entry parameters each device may hold. If
+  // non-zero, the search trades communication for smaller parameter shards
+  // until the parameters fit.
+  int64 memory_budget_per_device = 0;
+
+  // The maximum number of rounds of local improvement of the assignment.
+  int64 max_iterations = 8;
+};
+
+// Chooses shardings for the parameters, dots and convolutions of the entry
+// computation that carry no sharding annotation, then runs
+// ShardingPropagation to shard the remaining instructions for the
+// SpmdPartitioner.
+//
+// Each mesh axis either shards one dimension of an instruction or replicates
+// it. A strategy of a dot or convolution costs its flops, divided by the
+// number of shards, plus the all-reduce of a partitioned contraction. Users
+// expect their operands in the sharding of their strategy, and resharding a
+// producer to that sharding costs the bytes each device receives. The search
+// starts from a greedy assignment in post order and moves one instruction at a
+// time to its cheapest strategy until no move lowers the total cost.
+class AutoSharding : public HloModulePass {
+ public:
+  AutoSharding(int64 num_partitions, AutoShardingOptions options)
+      : num_partitions_(num_partitions), options_(std::move(options)) {}
+  absl::string_view name() const override { return "auto-sharding"; }
+  StatusOr<bool> Run(HloModule* module) override;
+
+ private:
+  const int64 num_partitions_;
+  const AutoShardingOptions options_;
+};
+
+}  // namespace spmd
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_SPMD_AUTO_SHARDING_H_
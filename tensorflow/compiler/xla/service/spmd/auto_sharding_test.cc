@@ -0,0 +1,122 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/spmd/auto_sharding.h"
+
+#include "tensorflow/compiler/xla/service/hlo_matchers.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace op = xla::testing::opcode_matchers;
+
+namespace xla {
+namespace spmd {
+namespace {
+
+using AutoShardingTest = HloTestBase;
+
+TEST_F(AutoShardingTest, ShardsBatchOfLargeActivations) {
+  const char* const hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %x = f32[4096,256] parameter(0)
+  %w = f32[256,64] parameter(1)
+  ROOT %dot = f32[4096,64] dot(%x, %w),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      AutoSharding(/*num_partitions=*/2, AutoShardingOptions())
+          .Run(module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_THAT(FindInstruction(module.get(), "x"),
+              op::Sharding("{devices=[2,1]0,1}"));
+  EXPECT_THAT(FindInstruction(module.get(), "w"),
+              op::Sharding("{replicated}"));
+  EXPECT_THAT(FindInstruction(module.get(), "dot"),
+              op::Sharding("{devices=[2,1]0,1}"));
+}
+
+TEST_F(AutoShardingTest, ShardsParametersToFitMemoryBudget) {
+  const char* const hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %x = f32[4096,256] parameter(0)
+  %w = f32[256,64] parameter(1)
+  ROOT %dot = f32[4096,64] dot(%x, %w),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  AutoShardingOptions options;
+  // Half of each parameter.
+  options.memory_budget_per_device = (4096 * 256 + 256 * 64) * 4 / 2;
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      AutoSharding(/*num_partitions=*/2, options).Run(module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_FALSE(FindInstruction(module.get(), "x")->sharding().IsReplicated());
+  EXPECT_FALSE(FindInstruction(module.get(), "w")->sharding().IsReplicated());
+}
+
+TEST_F(AutoShardingTest, KeepsUserAnnotations) {
+  const char* const hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %x = f32[4096,256] parameter(0)
+  %w = f32[256,64] parameter(1)
+  %dot = f32[4096,64] dot(%x, %w),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0},
+    sharding={devices=[1,2]0,1}
+  ROOT %copy = f32[4096,64] copy(%dot)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      AutoSharding(/*num_partitions=*/2, AutoShardingOptions())
+          .Run(module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_THAT(FindInstruction(module.get(), "dot"),
+              op::Sharding("{devices=[1,2]0,1}"));
+  // ShardingPropagation shards the rest of the module.
+  EXPECT_THAT(FindInstruction(module.get(), "copy"),
+              op::Sharding("{devices=[1,2]0,1}"));
+}
+
+TEST_F(AutoShardingTest, RejectsMeshOfWrongSize) {
+  const char* const hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  ROOT %x = f32[8] parameter(0)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  AutoShardingOptions options;
+  options.mesh_shape = {3};
+  EXPECT_FALSE(
+      AutoSharding(/*num_partitions=*/2, options).Run(module.get()).ok());
+}
+
+}  // namespace
+}  // namespace spmd
+}  // namespace xla
@@ -15,8 +15,11 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
 
+#include <algorithm>
 #include <atomic>
+#include <thread>
 
+#include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
 #include "tensorflow/core/common_runtime/allocator_retry.h"
 #include "tensorflow/core/lib/core/bits.h"
@@ -37,15 +40,26 @@ limitations under the License.
 namespace tensorflow {
 
 constexpr BFCAllocator::ChunkHandle BFCAllocator::kInvalidChunkHandle;
+constexpr size_t BFCAllocator::kMaxSmallAllocationSize;
 
 BFCAllocator::BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
                            bool allow_growth, const string& name,
-                           bool garbage_collection)
+                           bool garbage_collection,
+                           size_t small_allocation_cache_bytes)
     : garbage_collection_(garbage_collection),
       sub_allocator_(sub_allocator),
       name_(name),
+      small_allocation_cache_bytes_(small_allocation_cache_bytes),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1) {
+  static_assert(kNumSmallAllocationClasses * kMinAllocationSize ==
+                    kMaxSmallAllocationSize,
+                "Small allocation classes must cover kMaxSmallAllocationSize");
+  if (small_allocation_cache_bytes_ > 0) {
+    small_allocation_shards_ =
+        absl::make_unique<SmallAllocationShard[]>(kNumSmallAllocationShards);
+  }
+
   if (allow_growth) {
     // 1MiB smallest initial allocation, unless total memory available
     // is less.
@@ -104,7 +118,11 @@ const BFCAllocator::Chunk* BFCAllocator::ChunkFromHandle(ChunkHandle h) const {
 }
 
 bool BFCAllocator::Extend(size_t alignment, size_t rounded_bytes) {
-  size_t available_bytes = memory_limit_ - total_region_allocated_bytes_;
+  // The sub-allocator may round regions up, past the memory limit.
+  size_t available_bytes =
+      memory_limit_ > total_region_allocated_bytes_
+          ? memory_limit_ - total_region_allocated_bytes_
+          : 0;
   // Rounds available_bytes down to the nearest multiple of kMinAllocationSize.
   available_bytes = (available_bytes / kMinAllocationSize) * kMinAllocationSize;
 
@@ -153,20 +171,26 @@ bool BFCAllocator::Extend(size_t alignment, size_t rounded_bytes) {
   VLOG(1) << "Extending allocation by " << strings::HumanReadableNumBytes(bytes)
           << " bytes.";
 
-  total_region_allocated_bytes_ += bytes;
+  total_region_allocated_bytes_ += bytes_received;
   VLOG(1) << "Total allocated bytes: "
           << strings::HumanReadableNumBytes(total_region_allocated_bytes_);
 
   VLOG(1) << "Allocated memory at " << mem_addr << " to "
           << static_cast<void*>(static_cast<char*>(mem_addr) + bytes);
-  region_manager_.AddAllocationRegion(mem_addr, bytes_received);
+  AllocationRegion* extended_region = nullptr;
+  if (sub_allocator_->SupportsCoalescing()) {
+    extended_region =
+        region_manager_.AddOrExtendAllocationRegion(mem_addr, bytes_received);
+  } else {
+    region_manager_.AddAllocationRegion(mem_addr, bytes_received);
+  }
 
   // Create one large chunk for the whole memory space that will
   // be chunked later.
   ChunkHandle h = AllocateChunk();
   BFCAllocator::Chunk* c = ChunkFromHandle(h);
   c->ptr = mem_addr;
-  c->size = bytes;
+  c->size = bytes_received;
   c->allocation_id = -1;
   c->prev = kInvalidChunkHandle;
   c->next = kInvalidChunkHandle;
@@ -174,8 +198,23 @@ bool BFCAllocator::Extend(size_t alignment, size_t rounded_bytes) {
 
   region_manager_.set_handle(c->ptr, h);
 
-  // Insert the chunk into the right bin.
-  InsertFreeChunkIntoBin(h);
+  if (extended_region != nullptr) {
+    // Link the new chunk after the last chunk of the region it extends, so
+    // that free memory on both sides of the old end of the region merges
+    // into one chunk.
+    ChunkHandle prev = extended_region->get_handle(extended_region->ptr());
+    Chunk* prev_chunk = ChunkFromHandle(prev);
+    while (prev_chunk->next != kInvalidChunkHandle) {
+      prev = prev_chunk->next;
+      prev_chunk = ChunkFromHandle(prev);
+    }
+    c->prev = prev;
+    prev_chunk->next = h;
+    InsertFreeChunkIntoBin(TryToCoalesce(h, /*ignore_freed_at=*/false));
+  } else {
+    // Insert the chunk into the right bin.
+    InsertFreeChunkIntoBin(h);
+  }
 
   return true;
 }
@@ -231,6 +270,16 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
 void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
                                 const AllocationAttributes& allocation_attr) {
   VLOG(1) << "AllocateRaw " << Name() << "  " << num_bytes;
+  // Blocks in the small allocation cache are reused as soon as they are
+  // freed, so they cannot honor the timestamps of the timestamped allocator.
+  if (small_allocation_shards_ != nullptr && num_bytes > 0 &&
+      num_bytes <= kMaxSmallAllocationSize && timing_counter_ == nullptr &&
+      allocation_attr.freed_by_func == nullptr) {
+    void* result = AllocateSmall(num_bytes);
+    if (result != nullptr) {
+      return result;
+    }
+  }
   if (!allocation_attr.retry_on_failure) {
     // Return immediately upon the first failure if this is for allocating an
     // optional scratch space.
@@ -263,6 +312,105 @@ void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
   }
 }
 
+BFCAllocator::SmallAllocationShard*
+BFCAllocator::CurrentSmallAllocationShard() {
+  static thread_local const size_t shard_index =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) %
+      kNumSmallAllocationShards;
+  return &small_allocation_shards_[shard_index];
+}
+
+void* BFCAllocator::AllocateSmall(size_t num_bytes) {
+  const int size_class = (num_bytes - 1) / kMinAllocationSize;
+  SmallAllocationShard* shard = CurrentSmallAllocationShard();
+  {
+    mutex_lock l(shard->mu);
+    std::vector<void*>& free_blocks = shard->free_blocks[size_class];
+    if (!free_blocks.empty()) {
+      void* ptr = free_blocks.back();
+      free_blocks.pop_back();
+      return ptr;
+    }
+  }
+
+  // Reserve room for a new slab within the cache size limit.
+  size_t slab_bytes = small_allocation_slab_bytes_.load();
+  do {
+    if (slab_bytes + kSmallAllocationSlabSize > small_allocation_cache_bytes_) {
+      return nullptr;
+    }
+  } while (!small_allocation_slab_bytes_.compare_exchange_weak(
+      slab_bytes, slab_bytes + kSmallAllocationSlabSize));
+
+  char* base = static_cast<char*>(
+      AllocateRawInternal(Allocator::kAllocatorAlignment,
+                          kSmallAllocationSlabSize,
+                          /*dump_log_on_failure=*/false, /*freed_before=*/0));
+  if (base == nullptr) {
+    small_allocation_slab_bytes_.fetch_sub(kSmallAllocationSlabSize);
+    return nullptr;
+  }
+  VLOG(2) << "Adding small allocation slab for size class " << size_class
+          << " at " << static_cast<void*>(base);
+
+  // Publish a new slab table that includes this slab before any of its blocks
+  // is handed out, so that DeallocateSmall() can always find it.
+  {
+    mutex_lock l(slab_table_mu_);
+    auto table = absl::make_unique<SlabTable>();
+    const SlabTable* old_table = slab_table_.load(std::memory_order_relaxed);
+    if (old_table != nullptr) {
+      table->slabs = old_table->slabs;
+    }
+    Slab slab{base, size_class};
+    table->slabs.insert(
+        std::upper_bound(table->slabs.begin(), table->slabs.end(), slab,
+                         [](const Slab& a, const Slab& b) {
+                           return a.base < b.base;
+                         }),
+        slab);
+    slab_table_.store(table.get(), std::memory_order_release);
+    slab_tables_.push_back(std::move(table));
+  }
+
+  const size_t block_size = SmallAllocationBlockSize(size_class);
+  const size_t num_blocks = kSmallAllocationSlabSize / block_size;
+  {
+    mutex_lock l(shard->mu);
+    std::vector<void*>& free_blocks = shard->free_blocks[size_class];
+    for (size_t i = num_blocks - 1; i > 0; --i) {
+      free_blocks.push_back(base + i * block_size);
+    }
+  }
+  return base;
+}
+
+const BFCAllocator::Slab* BFCAllocator::FindSlab(const void* ptr) const {
+  const SlabTable* table = slab_table_.load(std::memory_order_acquire);
+  if (table == nullptr) return nullptr;
+  const char* p = static_cast<const char*>(ptr);
+  // Find the last slab whose base is at or before `p`.
+  auto it = std::upper_bound(
+      table->slabs.begin(), table->slabs.end(), p,
+      [](const char* p, const Slab& slab) { return p < slab.base; });
+  if (it == table->slabs.begin()) return nullptr;
+  --it;
+  if (p >= it->base + kSmallAllocationSlabSize) return nullptr;
+  return &*it;
+}
+
+bool BFCAllocator::DeallocateSmall(void* ptr) {
+  const Slab* slab = FindSlab(ptr);
+  if (slab == nullptr) return false;
+  DCHECK_EQ((static_cast<char*>(ptr) - slab->base) %
+                SmallAllocationBlockSize(slab->size_class),
+            0);
+  SmallAllocationShard* shard = CurrentSmallAllocationShard();
+  mutex_lock l(shard->mu);
+  shard->free_blocks[slab->size_class].push_back(ptr);
+  return true;
+}
+
 // static
 size_t BFCAllocator::RoundedBytes(size_t bytes) {
   size_t rounded_bytes =
@@ -493,7 +641,8 @@ void BFCAllocator::AddTraceMe(absl::string_view traceme_name,
                            {"id", annotation.pending_step_id},
                            {"region_type", annotation.pending_region_type},
                            {"data_type", annotation.pending_data_type},
-                           {"shape", tensor_shape}});
+                           {"shape", tensor_shape},
+                           {"bin", BinNumForSize(alloc_bytes)}});
       },
       /*level=*/profiler::TraceMeLevel::kInfo);
 }
@@ -618,6 +767,10 @@ void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
 void BFCAllocator::DeallocateRaw(void* ptr) {
   VLOG(1) << "DeallocateRaw " << Name() << " "
           << (ptr ? RequestedSize(ptr) : 0);
+  if (small_allocation_shards_ != nullptr && ptr != nullptr &&
+      DeallocateSmall(ptr)) {
+    return;
+  }
   DeallocateRawInternal(ptr);
   retry_helper_.NotifyDealloc();
 }
@@ -869,8 +1022,14 @@ bool BFCAllocator::MergeTimestampedChunks(size_t required_bytes) {
 
 bool BFCAllocator::TracksAllocationSizes() const { return true; }
 
+// NOTE: The size of a block of the small allocation cache is reported as both
+// its requested and its allocated size, and all blocks of a slab share the
+// allocation id of the slab.
 size_t BFCAllocator::RequestedSize(const void* ptr) const {
   CHECK(ptr);
+  if (const Slab* slab = FindSlab(ptr)) {
+    return SmallAllocationBlockSize(slab->size_class);
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -880,6 +1039,9 @@ size_t BFCAllocator::RequestedSize(const void* ptr) const {
 }
 
 size_t BFCAllocator::AllocatedSize(const void* ptr) const {
+  if (const Slab* slab = FindSlab(ptr)) {
+    return SmallAllocationBlockSize(slab->size_class);
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -889,6 +1051,9 @@ size_t BFCAllocator::AllocatedSize(const void* ptr) const {
 }
 
 int64 BFCAllocator::AllocationId(const void* ptr) const {
+  if (const Slab* slab = FindSlab(ptr)) {
+    ptr = slab->base;
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_BFC_ALLOCATOR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_BFC_ALLOCATOR_H_
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <string>
@@ -49,9 +51,16 @@ class MemoryDump;
 class BFCAllocator : public Allocator {
  public:
   // Takes ownership of sub_allocator.
+  //
+  // If `small_allocation_cache_bytes` is positive, allocations of at most
+  // kMaxSmallAllocationSize bytes are served from slabs of fixed-size blocks
+  // carved out of the BFC regions, using at most that many bytes for slabs.
+  // Freed blocks are kept in per-thread-shard free lists, so that small
+  // allocations and deallocations do not take the allocator's global lock.
   BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
                bool allow_growth, const string& name,
-               bool garbage_collection = false);
+               bool garbage_collection = false,
+               size_t small_allocation_cache_bytes = 0);
   ~BFCAllocator() override;
 
   string Name() override { return name_; }
@@ -85,6 +94,9 @@ class BFCAllocator : public Allocator {
 
   MemoryDump RecordMemoryMap();
 
+  // The largest allocation that can be served by the small allocation cache.
+  static constexpr size_t kMaxSmallAllocationSize = 4096;
+
  private:
   struct Bin;
 
@@ -98,6 +110,51 @@ class BFCAllocator : public Allocator {
 
   void DeallocateRawInternal(void* ptr);
 
+  // The small allocation cache hands out blocks of (i + 1) *
+  // kMinAllocationSize bytes for size class i. Each block belongs to a slab of
+  // kSmallAllocationSlabSize bytes, which is allocated from the BFC bins as a
+  // single chunk and is never returned to them.
+  static constexpr int kNumSmallAllocationClasses = 16;
+  static constexpr size_t kSmallAllocationSlabSize = 64 << 10;
+  static constexpr int kNumSmallAllocationShards = 16;
+
+  struct Slab {
+    const char* base;
+    int size_class;
+  };
+
+  // An immutable list of slabs, sorted by base address. A new table is
+  // published every time a slab is added, so that lookups need no lock.
+  struct SlabTable {
+    std::vector<Slab> slabs;
+  };
+
+  // The free blocks of every size class. Every thread uses the shard selected
+  // by its thread id, so shards are rarely contended.
+  struct SmallAllocationShard {
+    mutex mu;
+    std::array<std::vector<void*>, kNumSmallAllocationClasses> free_blocks
+        TF_GUARDED_BY(mu);
+  };
+
+  // Returns a block of at least `num_bytes` from the small allocation cache,
+  // adding a new slab if necessary. Returns nullptr if the cache has reached
+  // its size limit and has no free block of the right size class.
+  void* AllocateSmall(size_t num_bytes) TF_LOCKS_EXCLUDED(lock_);
+
+  // Returns `ptr` to the small allocation cache, and returns true, if `ptr` is
+  // a block of one of its slabs. Otherwise returns false.
+  bool DeallocateSmall(void* ptr);
+
+  // Returns the slab that contains `ptr`, or nullptr if there is none.
+  const Slab* FindSlab(const void* ptr) const;
+
+  SmallAllocationShard* CurrentSmallAllocationShard();
+
+  static size_t SmallAllocationBlockSize(int size_class) {
+    return (size_class + 1) * kMinAllocationSize;
+  }
+
   // Chunks whose freed_at_count is later than the safe frontier value are kept
   // on a special list and not subject to merging immediately upon being freed.
   //
@@ -292,6 +349,19 @@ class BFCAllocator : public Allocator {
     void* ptr() const { return ptr_; }
     void* end_ptr() const { return end_ptr_; }
     size_t memory_size() const { return memory_size_; }
+    // Grows the region by `size` bytes of memory that immediately follow it.
+    void extend(size_t size) {
+      DCHECK_EQ(0, size % kMinAllocationSize);
+      const size_t old_n_handles = memory_size_ / kMinAllocationSize;
+      memory_size_ += size;
+      end_ptr_ = static_cast<void*>(static_cast<char*>(ptr_) + memory_size_);
+      const size_t n_handles = memory_size_ / kMinAllocationSize;
+      std::unique_ptr<ChunkHandle[]> handles(new ChunkHandle[n_handles]);
+      std::copy(handles_.get(), handles_.get() + old_n_handles, handles.get());
+      std::fill(handles.get() + old_n_handles, handles.get() + n_handles,
+                kInvalidChunkHandle);
+      handles_ = std::move(handles);
+    }
     ChunkHandle get_handle(const void* p) const {
       return handles_[IndexFor(p)];
     }
@@ -344,6 +414,23 @@ class BFCAllocator : public Allocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    // Like AddAllocationRegion, but extends the region that ends at `ptr` if
+    // there is one, and returns it. Returns nullptr if a new region was added.
+    AllocationRegion* AddOrExtendAllocationRegion(void* ptr,
+                                                  size_t memory_size) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      if (entry != regions_.begin()) {
+        auto preceding_region = entry - 1;
+        if (preceding_region->end_ptr() == ptr) {
+          preceding_region->extend(memory_size);
+          return &*preceding_region;
+        }
+      }
+      regions_.insert(entry, AllocationRegion(ptr, memory_size));
+      return nullptr;
+    }
+
     std::vector<AllocationRegion>::iterator RemoveAllocationRegion(
         std::vector<AllocationRegion>::iterator it) {
       return regions_.erase(it);
@@ -534,6 +621,17 @@ class BFCAllocator : public Allocator {
 
   std::atomic<uint64> safe_frontier_ = {0};
 
+  // Small allocation cache; see the constructor. `small_allocation_shards_` is
+  // null iff the cache is disabled.
+  const size_t small_allocation_cache_bytes_;
+  std::unique_ptr<SmallAllocationShard[]> small_allocation_shards_;
+  std::atomic<size_t> small_allocation_slab_bytes_{0};
+  std::atomic<const SlabTable*> slab_table_{nullptr};
+  mutex slab_table_mu_;
+  // Owns every published SlabTable, since lookups may still read an older one.
+  std::vector<std::unique_ptr<const SlabTable>> slab_tables_
+      TF_GUARDED_BY(slab_table_mu_);
+
   // Structures mutable after construction
   mutable mutex lock_;
   RegionManager region_manager_ TF_GUARDED_BY(lock_);
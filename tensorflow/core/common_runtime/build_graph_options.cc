@@ -48,6 +48,12 @@ string BuildGraphOptions::DebugString() const {
       break;
   }
   strings::StrAppend(&rv, "\ncollective_order: ", collective_order_str);
+  if (!specialized_feed_shapes.empty()) {
+    strings::StrAppend(&rv, "\nSpecialized feed shapes: ");
+    for (const auto& feed : specialized_feed_shapes) {
+      strings::StrAppend(&rv, feed.first, feed.second.DebugString(), ", ");
+    }
+  }
   return rv;
 }
 
@@ -0,0 +1,153 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/chunk_arena_allocator.h"
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+// Spreads threads round-robin over the shards.
+int ShardIndexOfCurrentThread(int num_shards) {
+  static std::atomic<int> next_index{0};
+  thread_local const int index = next_index.fetch_add(1);
+  return index % num_shards;
+}
+
+size_t RoundUpToAlignment(size_t num_bytes) {
+  return (num_bytes + Allocator::kAllocatorAlignment - 1) &
+         ~(Allocator::kAllocatorAlignment - 1);
+}
+
+}  // namespace
+
+ChunkArenaAllocator::ChunkArenaAllocator(Allocator* base,
+                                         size_t max_allocation_size,
+                                         size_t chunk_size, int max_free_chunks)
+    : base_(base),
+      max_allocation_size_(max_allocation_size),
+      chunk_size_(chunk_size),
+      max_free_chunks_(max_free_chunks) {
+  CHECK_EQ(chunk_size & (chunk_size - 1), 0) << chunk_size;
+  CHECK_GT(chunk_size, max_allocation_size);
+}
+
+ChunkArenaAllocator::~ChunkArenaAllocator() {
+  for (Shard& shard : shards_) {
+    Chunk* chunk;
+    {
+      mutex_lock l(shard.mu);
+      chunk = shard.current;
+      shard.current = nullptr;
+    }
+    if (chunk != nullptr) Unref(chunk);
+  }
+  mutex_lock l(chunks_mu_);
+  DCHECK_EQ(chunks_.size(), free_chunks_.size())
+      << "Allocations outlive the ChunkArenaAllocator";
+  for (Chunk* chunk : free_chunks_) {
+    base_->DeallocateRaw(chunk->data);
+    delete chunk;
+  }
+}
+
+void* ChunkArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  if (num_bytes == 0 || num_bytes > max_allocation_size_ ||
+      alignment > kAllocatorAlignment) {
+    return base_->AllocateRaw(alignment, num_bytes);
+  }
+  const size_t size = RoundUpToAlignment(num_bytes);
+  Shard& shard = shards_[ShardIndexOfCurrentThread(kNumShards)];
+  Chunk* full_chunk = nullptr;
+  void* ptr = nullptr;
+  {
+    mutex_lock l(shard.mu);
+    if (shard.current == nullptr ||
+        shard.current->offset + size > chunk_size_) {
+      full_chunk = shard.current;
+      shard.current = NewChunk();
+    }
+    if (shard.current != nullptr) {
+      ptr = shard.current->data + shard.current->offset;
+      shard.current->offset += size;
+      shard.current->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (full_chunk != nullptr) Unref(full_chunk);
+  if (ptr == nullptr) {
+    return base_->AllocateRaw(alignment, num_bytes);
+  }
+  return ptr;
+}
+
+void ChunkArenaAllocator::DeallocateRaw(void* ptr) {
+  Chunk* chunk = FindChunk(ptr);
+  if (chunk == nullptr) {
+    base_->DeallocateRaw(ptr);
+    return;
+  }
+  Unref(chunk);
+}
+
+int64 ChunkArenaAllocator::NumChunks() const {
+  tf_shared_lock l(chunks_mu_);
+  return chunks_.size();
+}
+
+ChunkArenaAllocator::Chunk* ChunkArenaAllocator::NewChunk() {
+  {
+    mutex_lock l(chunks_mu_);
+    if (!free_chunks_.empty()) {
+      Chunk* chunk = free_chunks_.back();
+      free_chunks_.pop_back();
+      return chunk;
+    }
+  }
+  // Chunks are aligned to their size, so that the chunk of an allocation is
+  // found by masking its address.
+  char* data =
+      static_cast<char*>(base_->AllocateRaw(chunk_size_, chunk_size_));
+  if (data == nullptr) return nullptr;
+  Chunk* chunk = new Chunk(data);
+  mutex_lock l(chunks_mu_);
+  chunks_.emplace(data, chunk);
+  return chunk;
+}
+
+void ChunkArenaAllocator::Unref(Chunk* chunk) {
+  if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  // No allocation is left in the chunk and no shard is filling it.
+  mutex_lock l(chunks_mu_);
+  if (free_chunks_.size() < static_cast<size_t>(max_free_chunks_)) {
+    chunk->offset = 0;
+    chunk->refs.store(1, std::memory_order_relaxed);
+    free_chunks_.push_back(chunk);
+    return;
+  }
+  chunks_.erase(chunk->data);
+  base_->DeallocateRaw(chunk->data);
+  delete chunk;
+}
+
+ChunkArenaAllocator::Chunk* ChunkArenaAllocator::FindChunk(void* ptr) {
+  char* data = reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(ptr) &
+                                       ~(chunk_size_ - 1));
+  tf_shared_lock l(chunks_mu_);
+  auto it = chunks_.find(data);
+  return it == chunks_.end() ? nullptr : it->second;
+}
+
+}  // namespace tensorflow
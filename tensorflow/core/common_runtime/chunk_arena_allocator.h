@@ -0,0 +1,114 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_CHUNK_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_CHUNK_ARENA_ALLOCATOR_H_
+
+#include <atomic>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Serves small allocations by bumping a pointer in fixed-size chunks obtained
+// from another allocator, and forwards all other allocations to it.
+//
+// Most small tensors of a step (shapes, scalars, indices...) die within the
+// step, and bump allocation makes them much cheaper than a general purpose
+// allocator. Each chunk counts its live allocations, so tensors that outlive
+// the step (e.g. assigned to a variable or enqueued) just keep their chunk
+// alive; once all allocations in a chunk are freed, the chunk is recycled.
+//
+// Threads are spread over several chunks being filled at the same time, to
+// limit contention.
+class ChunkArenaAllocator : public Allocator {
+ public:
+  // `base` is not owned and must outlive this allocator. Allocations of at most
+  // `max_allocation_size` bytes are served from chunks of `chunk_size` bytes,
+  // which must be a power of two larger than `max_allocation_size`. At most
+  // `max_free_chunks` unused chunks are kept for reuse.
+  ChunkArenaAllocator(Allocator* base, size_t max_allocation_size,
+                      size_t chunk_size, int max_free_chunks);
+
+  // REQUIRES: All allocations have been freed.
+  ~ChunkArenaAllocator() override;
+
+  string Name() override { return base_->Name(); }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+
+  void DeallocateRaw(void* ptr) override;
+
+  absl::optional<AllocatorStats> GetStats() override {
+    return base_->GetStats();
+  }
+
+  // Returns the number of chunks obtained from the base allocator and not
+  // returned to it yet.
+  int64 NumChunks() const;
+
+ private:
+  struct Chunk {
+    explicit Chunk(char* data) : data(data) {}
+
+    char* const data;
+    // Next free byte. Only changed by the thread that fills the chunk.
+    size_t offset = 0;
+    // Number of live allocations, plus one while the chunk is being filled.
+    std::atomic<int64> refs{1};
+  };
+
+  struct Shard {
+    mutex mu;
+    Chunk* current TF_GUARDED_BY(mu) = nullptr;
+  };
+
+  // Returns a chunk for a shard to fill, or nullptr if the base allocator
+  // could not provide one.
+  Chunk* NewChunk() TF_LOCKS_EXCLUDED(chunks_mu_);
+
+  // Drops one reference to `chunk`, recycling it if it was the last one.
+  void Unref(Chunk* chunk) TF_LOCKS_EXCLUDED(chunks_mu_);
+
+  // Returns the chunk that contains `ptr`, or nullptr if `ptr` was allocated
+  // by the base allocator.
+  Chunk* FindChunk(void* ptr) TF_LOCKS_EXCLUDED(chunks_mu_);
+
+  static constexpr int kNumShards = 16;
+
+  Allocator* const base_;  // Not owned.
+  const size_t max_allocation_size_;
+  const size_t chunk_size_;
+  const int max_free_chunks_;
+
+  Shard shards_[kNumShards];
+
+  mutable mutex chunks_mu_;
+  // Owns all chunks, keyed by their data.
+  absl::flat_hash_map<char*, Chunk*> chunks_ TF_GUARDED_BY(chunks_mu_);
+  std::vector<Chunk*> free_chunks_ TF_GUARDED_BY(chunks_mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ChunkArenaAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_CHUNK_ARENA_ALLOCATOR_H_
@@ -0,0 +1,105 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/chunk_arena_allocator.h"
+
+#include <vector>
+
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr size_t kChunkSize = 4096;
+
+TEST(ChunkArenaAllocatorTest, ServesSmallAllocationsFromChunks) {
+  ChunkArenaAllocator allocator(cpu_allocator(), 256, kChunkSize,
+                                /*max_free_chunks=*/0);
+  std::vector<void*> ptrs;
+  // 64 allocations of 64 bytes fill exactly one chunk.
+  for (int i = 0; i < 64; ++i) {
+    void* ptr = allocator.AllocateRaw(Allocator::kAllocatorAlignment, 10);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) %
+                  Allocator::kAllocatorAlignment,
+              0);
+    ptrs.push_back(ptr);
+  }
+  EXPECT_EQ(allocator.NumChunks(), 1);
+  for (int i = 1; i < 64; ++i) {
+    EXPECT_EQ(static_cast<char*>(ptrs[i]) - static_cast<char*>(ptrs[i - 1]),
+              64);
+  }
+  void* large = allocator.AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+  EXPECT_EQ(allocator.NumChunks(), 1);
+  allocator.DeallocateRaw(large);
+  for (void* ptr : ptrs) allocator.DeallocateRaw(ptr);
+}
+
+TEST(ChunkArenaAllocatorTest, LiveAllocationKeepsChunk) {
+  ChunkArenaAllocator allocator(cpu_allocator(), 1024, kChunkSize,
+                                /*max_free_chunks=*/0);
+  // Outlives the allocations of the "step" below.
+  void* escaped = allocator.AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; ++i) {
+    ptrs.push_back(allocator.AllocateRaw(Allocator::kAllocatorAlignment, 1024));
+  }
+  EXPECT_EQ(allocator.NumChunks(), 5);
+  for (void* ptr : ptrs) allocator.DeallocateRaw(ptr);
+  // The first chunk holds `escaped` and the last one is still being filled.
+  EXPECT_EQ(allocator.NumChunks(), 2);
+  memset(escaped, 0, 1024);
+  allocator.DeallocateRaw(escaped);
+  EXPECT_EQ(allocator.NumChunks(), 1);
+}
+
+TEST(ChunkArenaAllocatorTest, RecyclesFreeChunks) {
+  ChunkArenaAllocator allocator(cpu_allocator(), 1024, kChunkSize,
+                                /*max_free_chunks=*/4);
+  for (int step = 0; step < 10; ++step) {
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 16; ++i) {
+      ptrs.push_back(
+          allocator.AllocateRaw(Allocator::kAllocatorAlignment, 1024));
+    }
+    for (void* ptr : ptrs) allocator.DeallocateRaw(ptr);
+  }
+  EXPECT_LE(allocator.NumChunks(), 5);
+}
+
+TEST(ChunkArenaAllocatorTest, ConcurrentAllocations) {
+  ChunkArenaAllocator allocator(cpu_allocator(), 512, kChunkSize,
+                                /*max_free_chunks=*/8);
+  {
+    thread::ThreadPool pool(Env::Default(), "test", 8);
+    for (int t = 0; t < 8; ++t) {
+      pool.Schedule([&allocator, t]() {
+        for (int i = 0; i < 1000; ++i) {
+          const size_t num_bytes = 1 + (i * 37 + t) % 512;
+          char* ptr = static_cast<char*>(
+              allocator.AllocateRaw(Allocator::kAllocatorAlignment, num_bytes));
+          memset(ptr, t, num_bytes);
+          allocator.DeallocateRaw(ptr);
+        }
+      });
+    }
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
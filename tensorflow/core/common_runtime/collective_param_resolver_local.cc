@@ -75,6 +75,29 @@ const char* GetCollectiveName(const CollectiveParams* cp, bool nccl) {
   }
 }
 
+// Reductions of at least this many bytes over several tasks with the same
+// number of devices use the two-level ring unless another implementation is
+// requested. Reducing within each task first leaves only 1/(devices per task)
+// of the tensor for the slower links between tasks, which pays for the extra
+// phases once the transfer is bandwidth bound.
+constexpr int64 kAutoHierarchicalRingMinBytes = 1 << 20;
+
+bool PreferHierarchicalRing(const CollectiveParams& cp) {
+  const string& hint = cp.instance.impl_details.communication_hint;
+  if (cp.instance.type != REDUCTION_COLLECTIVE ||
+      !(hint.empty() || hint == "auto") ||
+      cp.instance.impl_details.wire_data_type != DT_INVALID) {
+    return false;
+  }
+  if (cp.group.num_tasks <= 1 || !cp.group.same_num_devices_per_task ||
+      cp.group.group_size / cp.group.num_tasks <= 1) {
+    return false;
+  }
+  return cp.instance.shape.num_elements() *
+             DataTypeSize(cp.instance.data_type) >=
+         kAutoHierarchicalRingMinBytes;
+}
+
 string TaskNameFromDeviceName(const string& device_name) {
   DeviceNameUtils::ParsedName parsed_device;
   CHECK(DeviceNameUtils::ParseFullName(device_name, &parsed_device));
@@ -620,7 +643,8 @@ void CollectiveParamResolverLocal::CompleteInstanceAsync(
 
 // TODO(b/111897089): we need a better way to pick the collective
 // implementation.  The ideal way would depend upon the topology and link
-// strength before picking a particular implementation.
+// strength before picking a particular implementation.  For now only the
+// split of the group into tasks and the tensor size are taken into account.
 void CollectiveParamResolverLocal::AssignCollectiveType(CollectiveParams* cp) {
   // We use the NCCL implementation if this is an environment which supports
   // NCCL, i.e. `LookupParamResolverInstance` for `NcclReduce` returns OK, and
@@ -634,6 +658,13 @@ void CollectiveParamResolverLocal::AssignCollectiveType(CollectiveParams* cp) {
       CollectiveRegistry::LookupParamResolverInstance("NcclReduce", &col_impl)
           .ok();
   cp->instance.impl_details.collective_name = GetCollectiveName(cp, use_nccl);
+  // The two-level ring all-reduce is used when requested explicitly, or by
+  // default for large reductions across tasks.
+  if (!use_nccl && cp->instance.type == REDUCTION_COLLECTIVE &&
+      (cp->instance.impl_details.communication_hint == "hierarchical_ring" ||
+       PreferHierarchicalRing(*cp))) {
+    cp->instance.impl_details.collective_name = "HierarchicalRingReduce";
+  }
   VLOG(1) << "AssignCollectiveType "
           << cp->instance.impl_details.collective_name;
 }
@@ -76,6 +76,10 @@ class CollectiveParamResolverLocalTest : public ::testing::Test {
     EXPECT_EQ(group.device_names, expected_device_order);
   }
 
+  void AssignCollectiveType(CollectiveParams* cp) {
+    prl_->AssignCollectiveType(cp);
+  }
+
   DeviceAttributes GetDeviceAttributes(const string& device_name) {
     Device* device = nullptr;
     TF_CHECK_OK(device_mgr_->LookupDevice(device_name, &device));
@@ -160,6 +164,37 @@ TEST_F(CollectiveParamResolverLocalTest, CompleteDefaultRanking) {
                             });
 }
 
+TEST_F(CollectiveParamResolverLocalTest, AutoHierarchicalRingForLargeTensors) {
+  CollectiveParams cp;
+  cp.group.group_size = 4;
+  cp.group.num_tasks = 2;
+  cp.group.same_num_devices_per_task = true;
+  cp.instance.type = REDUCTION_COLLECTIVE;
+  cp.instance.data_type = DT_FLOAT;
+  cp.instance.impl_details.communication_hint = "auto";
+
+  cp.instance.shape = TensorShape({1 << 18});
+  AssignCollectiveType(&cp);
+  EXPECT_EQ(cp.instance.impl_details.collective_name,
+            "HierarchicalRingReduce");
+
+  cp.instance.shape = TensorShape({16});
+  AssignCollectiveType(&cp);
+  EXPECT_EQ(cp.instance.impl_details.collective_name, "RingReduce");
+
+  // An explicit ring request is honored regardless of size.
+  cp.instance.shape = TensorShape({1 << 18});
+  cp.instance.impl_details.communication_hint = "ring";
+  AssignCollectiveType(&cp);
+  EXPECT_EQ(cp.instance.impl_details.collective_name, "RingReduce");
+
+  // One device per task leaves nothing to reduce within a task.
+  cp.instance.impl_details.communication_hint = "auto";
+  cp.group.group_size = 2;
+  AssignCollectiveType(&cp);
+  EXPECT_EQ(cp.instance.impl_details.collective_name, "RingReduce");
+}
+
 TEST_F(CollectiveParamResolverLocalTest, CompleteParamsReduction1Task) {
   CollectiveParams cps[NUM_DEVS];
   Status statuses[NUM_DEVS];
@@ -15,9 +15,11 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/device/device_event_mgr.h"
 
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/platform/stacktrace.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -96,11 +98,27 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
                                       ? gpu_options.polling_active_delay_usecs()
                                       : 10),
       threadpool_(Env::Default(), "Device_Event_Manager", kNumThreads) {
+  Status status =
+      ReadInt64FromEnvVar("TF_EVENT_MGR_SPIN_USECS", 0, &spin_usecs_);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
+  status = ReadBoolFromEnvVar("TF_EVENT_MGR_USE_HOST_CALLBACKS", false,
+                              &use_host_callbacks_);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
   device_event_mgr::InitThreadpoolLabels(&threadpool_);
   StartPollingLoop();
 }
 
 EventMgr::~EventMgr() {
+  {
+    mutex_lock l(mu_);
+    while (num_pending_host_callbacks_ > 0) {
+      host_callbacks_done_.wait(l);
+    }
+  }
   StopPollingLoop();
 
   // Events are owned by this object.
@@ -140,9 +158,11 @@ void EventMgr::StopPollingLoop() {
 // A polling loop to detect completion of device events.
 //
 // While one or more events is outstanding, poll for completed events.  When no
-// events are outstanding, we sleep until one is enqueued.
+// events are outstanding, we sleep until one is enqueued.  Polling only sleeps
+// between polls once no event has completed for spin_usecs_.
 void EventMgr::PollLoop() {
   ToFreeVector to_free;
+  uint64 last_completion_usecs = 0;
   while (true) {
     bool events_still_pending;
     {
@@ -156,16 +176,49 @@ void EventMgr::PollLoop() {
       PollEvents(true, &to_free);
       events_still_pending = !used_events_.empty();
     }
+    const bool any_completed = !to_free.empty();
     FreeMemory(to_free);
     to_free.clear();
 
     if (events_still_pending) {
+      if (spin_usecs_ > 0) {
+        const uint64 now = Env::Default()->NowMicros();
+        if (any_completed || last_completion_usecs == 0) {
+          last_completion_usecs = now;
+        }
+        if (now - last_completion_usecs < static_cast<uint64>(spin_usecs_)) {
+          continue;
+        }
+      }
       Env::Default()->SleepForMicroseconds(polling_active_delay_usecs_);
+    } else {
+      last_completion_usecs = 0;
     }
   }
   polling_stopped_->Notify();
 }
 
+void EventMgr::QueueHostCallback(se::Stream* stream,
+                                 std::function<void()> func) {
+  {
+    mutex_lock l(mu_);
+    ++num_pending_host_callbacks_;
+  }
+  const uint64 queued_at_usecs = Env::Default()->NowMicros();
+  stream->ThenDoHostCallback([this, queued_at_usecs, func]() {
+    metrics::RecordEventMgrCompletionLatency(
+        Env::Default()->NowMicros() - queued_at_usecs,
+        /*host_callback=*/true);
+    // Host callbacks must not call into the driver, so the function runs in
+    // the thread pool like the ones of polled events.
+    threadpool_.Schedule(func);
+    mutex_lock l(mu_);
+    if (--num_pending_host_callbacks_ == 0) {
+      host_callbacks_done_.notify_all();
+    }
+  });
+}
+
 void EventMgr::QueueInUse(se::Stream* stream, InUse in_use) {
   VLOG(2) << "QueueInUse  free_events_ " << free_events_.size()
           << " used_events_ " << used_events_.size();
@@ -210,6 +263,7 @@ void EventMgr::PollEvents(bool is_dedicated_poller,
   // Sweep the remaining events in order.  If this is the dedicated
   // polling thread, check the entire set.  Otherwise, just sweep up to
   // the first non-complete record that is still pending.
+  uint64 now_usecs = 0;
   for (auto& iu : used_events_) {
     if (iu.event == nullptr) continue;
     se::Event::Status s = iu.event->PollForStatus();
@@ -224,6 +278,9 @@ void EventMgr::PollEvents(bool is_dedicated_poller,
         if (!is_dedicated_poller) return;  // quit processing queue
         break;
       case se::Event::Status::kComplete:
+        if (now_usecs == 0) now_usecs = Env::Default()->NowMicros();
+        metrics::RecordEventMgrCompletionLatency(
+            now_usecs - iu.queued_at_usecs, /*host_callback=*/false);
         // Make a copy of the InUse record so we can free it after releasing
         // the lock
         to_free->push_back(iu);
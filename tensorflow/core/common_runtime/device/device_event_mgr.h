@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -71,6 +72,10 @@ class EventMgr {
   // func must be brief and non-blocking since it executes in the one
   // thread used for all such callbacks and also buffer deletions.
   inline void ThenExecute(se::Stream* stream, std::function<void()> func) {
+    if (use_host_callbacks_ && stream->ok()) {
+      QueueHostCallback(stream, std::move(func));
+      return;
+    }
     ToFreeVector to_free;
     {
       mutex_lock l(mu_);
@@ -86,12 +91,21 @@ class EventMgr {
   friend class EventMgrFactory;
   se::StreamExecutor* const exec_;
   const int32 polling_active_delay_usecs_;
+  // How long the polling loop keeps polling without sleeping after it last
+  // saw an event complete, as set by TF_EVENT_MGR_SPIN_USECS.
+  int64 spin_usecs_ = 0;
+  // Whether ThenExecute() runs functions from host callbacks enqueued on the
+  // stream instead of polling events, as set by
+  // TF_EVENT_MGR_USE_HOST_CALLBACKS.
+  bool use_host_callbacks_ = false;
   mutex mu_;
   condition_variable events_pending_ TF_GUARDED_BY(mu_);
 
   struct InUse {
     se::Event* event;
     std::function<void()> func;
+    // When the function was queued, to measure completion latency.
+    uint64 queued_at_usecs;
   };
 
   typedef gtl::InlinedVector<InUse, 4> ToFreeVector;
@@ -113,9 +127,14 @@ class EventMgr {
 
   void QueueFunc(se::Stream* stream, std::function<void()> func)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    QueueInUse(stream, {nullptr, std::move(func)});
+    QueueInUse(stream, {nullptr, std::move(func), Env::Default()->NowMicros()});
   }
 
+  // Enqueues a host callback on `stream` that schedules `func` on the thread
+  // pool, so that no event needs to be polled.
+  void QueueHostCallback(se::Stream* stream, std::function<void()> func)
+      TF_LOCKS_EXCLUDED(mu_);
+
   // This function should be called at roughly the same tempo as
   // QueueTensors() to check whether pending events have recorded,
   // and then retire them.  It appends InUse elements that need cleanup
@@ -141,6 +160,10 @@ class EventMgr {
   bool stop_polling_ TF_GUARDED_BY(mu_);
   std::unique_ptr<Notification> polling_stopped_;
 
+  // Host callbacks enqueued by QueueHostCallback() that have not run yet.
+  int64 num_pending_host_callbacks_ TF_GUARDED_BY(mu_) = 0;
+  condition_variable host_callbacks_done_;
+
   // The main PollLoop for the event manager runs in this threadpool.
   thread::ThreadPool threadpool_;
 };
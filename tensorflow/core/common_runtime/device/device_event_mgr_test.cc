@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/stream_executor.h"
@@ -138,6 +139,23 @@ TEST(EventMgr, WarnIfInCallback) {
   note.WaitForNotification();
   EXPECT_TRUE(hit);
 }
+
+TEST(EventMgr, HostCallbacks) {
+  setenv("TF_EVENT_MGR_USE_HOST_CALLBACKS", "true", 1);
+  auto stream_exec = GPUMachineManager()->ExecutorForDevice(0).ValueOrDie();
+  TEST_EventMgr em(stream_exec, GPUOptions());
+  unsetenv("TF_EVENT_MGR_USE_HOST_CALLBACKS");
+  TEST_EventMgrHelper th(&em);
+  std::unique_ptr<se::Stream> stream(new se::Stream(stream_exec));
+  stream->Init();
+  BlockingCounter done(10);
+  for (int i = 0; i < 10; ++i) {
+    em.ThenExecute(stream.get(), [&done]() { done.DecrementCount(); });
+  }
+  // No event is polled.
+  EXPECT_EQ(0, th.queue_size());
+  done.Wait();
+}
 }  // namespace
 
 // Provides access to private resources of BaseGPUDevice.
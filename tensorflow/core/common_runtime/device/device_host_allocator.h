@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/stream_executor.h"
 
 namespace tensorflow {
@@ -26,12 +27,19 @@ namespace tensorflow {
 class DeviceHostAllocator : public SubAllocator {
  public:
   // Note: stream_exec cannot be null.
+  //
+  // If `numa_local` is true and NUMA is enabled, the memory is allocated on
+  // `numa_node` and then registered with the device, instead of letting the
+  // driver place it.
   explicit DeviceHostAllocator(se::StreamExecutor* stream_exec, int numa_node,
                                const std::vector<Visitor>& alloc_visitors,
-                               const std::vector<Visitor>& free_visitors)
+                               const std::vector<Visitor>& free_visitors,
+                               bool numa_local = false)
       : SubAllocator(alloc_visitors, free_visitors),
         stream_exec_(stream_exec),
-        numa_node_(numa_node) {
+        numa_node_(numa_node),
+        numa_local_(numa_local && numa_node != port::kNUMANoAffinity &&
+                    port::NUMAEnabled()) {
     CHECK(stream_exec_ != nullptr);
   }
   ~DeviceHostAllocator() override {}
@@ -41,7 +49,8 @@ class DeviceHostAllocator : public SubAllocator {
     void* ptr = nullptr;
     *bytes_received = num_bytes;
     if (num_bytes > 0) {
-      ptr = stream_exec_->HostMemoryAllocate(num_bytes);
+      ptr = numa_local_ ? NumaLocalAlloc(alignment, num_bytes)
+                        : stream_exec_->HostMemoryAllocate(num_bytes);
       if (ptr == nullptr) {
         LOG(WARNING) << "could not allocate pinned host memory of size: "
                      << num_bytes;
@@ -55,13 +64,31 @@ class DeviceHostAllocator : public SubAllocator {
   void Free(void* ptr, size_t num_bytes) override {
     if (ptr != nullptr) {
       VisitFree(ptr, numa_node_, num_bytes);
-      stream_exec_->HostMemoryDeallocate(ptr);
+      if (numa_local_) {
+        if (!stream_exec_->HostMemoryUnregister(ptr)) {
+          LOG(WARNING) << "could not unregister pinned host memory at " << ptr;
+        }
+        port::NUMAFree(ptr, num_bytes);
+      } else {
+        stream_exec_->HostMemoryDeallocate(ptr);
+      }
     }
   }
 
  private:
+  void* NumaLocalAlloc(size_t alignment, size_t num_bytes) {
+    void* ptr =
+        port::NUMAMalloc(numa_node_, num_bytes, static_cast<int>(alignment));
+    if (ptr != nullptr && !stream_exec_->HostMemoryRegister(ptr, num_bytes)) {
+      port::NUMAFree(ptr, num_bytes);
+      return nullptr;
+    }
+    return ptr;
+  }
+
   se::StreamExecutor* stream_exec_;  // not owned, non-null
   const int numa_node_;
+  const bool numa_local_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(DeviceHostAllocator);
 };
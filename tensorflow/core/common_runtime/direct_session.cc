@@ -78,6 +78,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/util/device_name_utils.h"
 #include "tensorflow/core/util/env_var.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -339,6 +340,15 @@ DirectSession::DirectSession(const SessionOptions& options,
       run_in_caller_thread_ = true;
     }
   }
+  const int max_inter_op_concurrency =
+      options_.config.experimental().max_inter_op_concurrency();
+  for (const auto& p_and_owned : thread_pools_) {
+    concurrency_limiters_.emplace_back(
+        max_inter_op_concurrency > 0 && p_and_owned.first != nullptr
+            ? new InterOpConcurrencyLimiter(p_and_owned.first,
+                                            max_inter_op_concurrency)
+            : nullptr);
+  }
   // The default value of sync_on_finish will be flipped soon and this
   // environment variable will be removed as well.
   const Status status =
@@ -564,6 +574,7 @@ Status DirectSession::RunInternal(
 #endif
 
   thread::ThreadPool* pool;
+  InterOpConcurrencyLimiter* limiter = nullptr;
   // Use std::unique_ptr to ensure garbage collection
   std::unique_ptr<thread::ThreadPool> threadpool_wrapper;
 
@@ -575,6 +586,7 @@ Status DirectSession::RunInternal(
     // specified.
     if (executors_and_keys->items.size() > 1) {
       pool = thread_pools_[0].first;
+      limiter = concurrency_limiters_[0].get();
     } else {
       VLOG(1) << "Executing Session::Run() synchronously!";
       pool = nullptr;
@@ -592,6 +604,8 @@ Status DirectSession::RunInternal(
     }
 
     pool = thread_pools_[run_options.inter_op_thread_pool()].first;
+    limiter =
+        concurrency_limiters_[run_options.inter_op_thread_pool()].get();
   }
 
   const int64 call_timeout = run_options.timeout_in_ms() > 0
@@ -621,6 +635,21 @@ Status DirectSession::RunInternal(
     default_runner = [handler_ptr](Executor::Args::Closure c) {
       handler_ptr->ScheduleInterOpClosure(std::move(c));
     };
+  } else if (limiter != nullptr) {
+    // The pool may be shared with other sessions, so also divide the
+    // intra-op threads among the sessions that have work running.
+    const int intra_op_threads =
+        options_.config.intra_op_parallelism_threads() > 0
+            ? options_.config.intra_op_parallelism_threads()
+            : port::MaxParallelism();
+    default_runner = [limiter, intra_op_threads](Executor::Args::Closure c) {
+      limiter->Schedule([c = std::move(c), intra_op_threads]() {
+        ScopedPerThreadMaxParallelism scope(std::max(
+            1, intra_op_threads /
+                   std::max(1, InterOpConcurrencyLimiter::NumBusyLimiters())));
+        c();
+      });
+    };
   } else {
     default_runner = [pool](Executor::Args::Closure c) {
       pool->Schedule(std::move(c));
@@ -852,6 +881,15 @@ Status DirectSession::Run(const RunOptions& run_options,
   RunStateArgs run_state_args(run_options.debug_options());
   run_state_args.collective_graph_key =
       run_options.experimental().collective_graph_key();
+  if (options_.config.experimental().specialize_feed_shapes()) {
+    for (const auto& it : inputs) {
+      TensorId tensor_id = ParseTensorName(it.first);
+      if (tensor_id.index() == 0) {
+        run_state_args.specialized_feed_shapes[string(tensor_id.node())] =
+            it.second.shape();
+      }
+    }
+  }
 
   TF_RETURN_IF_ERROR(GetOrCreateExecutors(input_tensor_names, output_names,
                                           target_nodes, &executors_and_keys,
@@ -946,6 +984,7 @@ Status DirectSession::PRunSetup(const std::vector<string>& input_names,
 
   // RunOptions is not available in PRunSetup, so use thread pool 0.
   thread::ThreadPool* pool = thread_pools_[0].first;
+  InterOpConcurrencyLimiter* limiter = concurrency_limiters_[0].get();
 
   // Check if we already have an executor for these arguments.
   ExecutorsAndKeys* executors_and_keys;
@@ -991,8 +1030,12 @@ Status DirectSession::PRunSetup(const std::vector<string>& input_names,
   // because RunOptions is not passed in so we can't know whether
   // their use is intended.
   args.collective_executor = nullptr;
-  args.runner = [this, pool](Executor::Args::Closure c) {
-    pool->Schedule(std::move(c));
+  args.runner = [this, pool, limiter](Executor::Args::Closure c) {
+    if (limiter != nullptr) {
+      limiter->Schedule(std::move(c));
+    } else {
+      pool->Schedule(std::move(c));
+    }
   };
   args.session_state = &session_state_;
   args.session_handle = session_handle_;
@@ -1298,6 +1341,7 @@ Status DirectSession::CreateExecutors(
   options.use_function_convention = !run_state_args->is_partial_run;
   options.collective_graph_key =
       callable_options.run_options().experimental().collective_graph_key();
+  options.specialized_feed_shapes = run_state_args->specialized_feed_shapes;
   if (options_.config.experimental()
           .collective_deterministic_sequential_execution()) {
     options.collective_order = GraphCollectiveOrder::kEdges;
@@ -1396,6 +1440,8 @@ Status DirectSession::CreateExecutors(
       if (kernel && !OpSegment::ShouldOwnKernel(lib, kernel->type_string()))
         delete kernel;
     };
+    params.use_static_memory_plan =
+        options_.config.experimental().use_static_memory_plan();
 
     optimizer.Optimize(lib, options_.env, device, &partition_graph,
                        /*shape_map=*/nullptr);
@@ -1476,11 +1522,17 @@ Status DirectSession::GetOrCreateExecutors(
         run_state_args->debug_options.debug_tensor_watch_opts());
   }
 
+  string feed_shapes_summary;
+  for (const auto& feed : run_state_args->specialized_feed_shapes) {
+    strings::StrAppend(&feed_shapes_summary, feed.first,
+                       feed.second.DebugString(), ";");
+  }
+
   // Fast lookup path, no sorting.
   const string key = strings::StrCat(
       absl::StrJoin(inputs, ","), "->", absl::StrJoin(outputs, ","), "/",
       absl::StrJoin(target_nodes, ","), "/", run_state_args->is_partial_run,
-      "/", debug_tensor_watches_summary);
+      "/", debug_tensor_watches_summary, "/", feed_shapes_summary);
   // Set the handle, if it's needed to log memory or for partial run.
   if (handle_name_counter_value >= 0) {
     run_state_args->handle =
@@ -1513,7 +1565,8 @@ Status DirectSession::GetOrCreateExecutors(
   const string sorted_key = strings::StrCat(
       absl::StrJoin(inputs_sorted, ","), "->",
       absl::StrJoin(outputs_sorted, ","), "/", absl::StrJoin(tn_sorted, ","),
-      "/", run_state_args->is_partial_run, "/", debug_tensor_watches_summary);
+      "/", run_state_args->is_partial_run, "/", debug_tensor_watches_summary,
+      "/", feed_shapes_summary);
   // Set the handle, if its needed to log memory or for partial run.
   if (handle_name_counter_value >= 0) {
     run_state_args->handle =
@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_set.h"
 #include "tensorflow/core/common_runtime/executor.h"
 #include "tensorflow/core/common_runtime/graph_execution_state.h"
+#include "tensorflow/core/common_runtime/inter_op_concurrency_limiter.h"
 #include "tensorflow/core/common_runtime/process_function_library_runtime.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/common_runtime/session_factory.h"
@@ -236,6 +237,8 @@ class DirectSession : public Session {
     std::unique_ptr<Graph> graph;
     const DebugOptions& debug_options;
     int64 collective_graph_key = BuildGraphOptions::kNoCollectiveGraphKey;
+    // Shapes of the fed nodes when specializing graphs for them.
+    std::map<string, TensorShape> specialized_feed_shapes;
   };
 
   // Retrieves an already existing set of executors to run 'inputs' and
@@ -350,6 +353,11 @@ class DirectSession : public Session {
   // is owned.
   std::vector<std::pair<thread::ThreadPool*, bool>> thread_pools_;
 
+  // If experimental.max_inter_op_concurrency is set, limits the closures
+  // this session runs on each of `thread_pools_` at a time; same indices.
+  std::vector<std::unique_ptr<InterOpConcurrencyLimiter>>
+      concurrency_limiters_;
+
   Status init_error_;  // Set to an error if construction failed.
 
   // If true, blocks until device has finished all queued operations in a step.
@@ -1540,6 +1540,51 @@ TEST(DirectSessionTest, PlacePrunedGraph) {
   }
 }
 
+TEST(DirectSessionTest, SpecializeFeedShapes) {
+  Graph g(OpRegistry::Global());
+  Node* x;
+  TF_ASSERT_OK(NodeBuilder("x", "Placeholder")
+                   .Attr("dtype", DT_FLOAT)
+                   .Attr("shape", PartialTensorShape({-1, 2}))
+                   .Finalize(&g, &x));
+  Node* shape = test::graph::Unary(&g, "Shape", x);
+  Node* y = test::graph::Binary(&g, "Reshape", x, shape);
+  GraphDef def;
+  g.ToGraphDef(&def);
+
+  auto count_shape_ops = [](const RunMetadata& metadata) {
+    int count = 0;
+    for (const GraphDef& partition : metadata.partition_graphs()) {
+      for (const NodeDef& node : partition.node()) {
+        if (node.op() == "Shape") ++count;
+      }
+    }
+    return count;
+  };
+
+  for (bool specialize : {false, true}) {
+    SessionOptions options;
+    options.config.mutable_experimental()->set_specialize_feed_shapes(
+        specialize);
+    std::unique_ptr<Session> session(NewSession(options));
+    TF_ASSERT_OK(session->Create(def));
+    RunOptions run_options;
+    run_options.set_output_partition_graphs(true);
+    for (int batch_size : {3, 5, 3}) {
+      Tensor x_value(DT_FLOAT, TensorShape({batch_size, 2}));
+      test::FillIota<float>(&x_value, 1.0f);
+      std::vector<Tensor> outputs;
+      RunMetadata metadata;
+      TF_ASSERT_OK(session->Run(run_options, {{x->name(), x_value}},
+                                {y->name() + ":0"}, {}, &outputs, &metadata));
+      ASSERT_EQ(1, outputs.size());
+      test::ExpectTensorEqual<float>(x_value, outputs[0]);
+      // The specialized graphs compute the shape of x statically.
+      EXPECT_EQ(specialize ? 0 : 1, count_shape_ops(metadata));
+    }
+  }
+}
+
 TEST(DirectSessionTest, PartialRunTest) {
   GraphDef def;
   Graph g(OpRegistry::Global());
@@ -216,9 +216,41 @@ void AttrBuilder::FillAttrValueMapWithoutDefaults(AttrValueMap* m) const {
   }
 }
 
+namespace {
+inline tensorflow::Fprint128 FingerprintCat128(const tensorflow::Fprint128& a,
+                                               const tensorflow::Fprint128& b) {
+  return {tensorflow::FingerprintCat64(a.low64, b.low64),
+          tensorflow::FingerprintCat64(a.high64, b.high64)};
+}
+
+void CombineUnordered(const tensorflow::Fprint128& a,
+                      tensorflow::Fprint128* b) {
+  b->low64 += a.low64;
+  b->high64 += a.high64;
+}
+
+inline tensorflow::Fprint128 CacheKeyHelper(StringPiece s,
+                                            const tensorflow::Fprint128& b) {
+  tensorflow::Fprint128 a = tensorflow::Fingerprint128(s);
+  return FingerprintCat128(a, b);
+}
+
+inline tensorflow::Fprint128 CacheKeyHelper(StringPiece s, uint64 b) {
+  return CacheKeyHelper(s, {b, b});
+}
+
+}  // namespace
+
 void AttrBuilder::AddAttrIfNotPresent(StringPiece attr_name,
                                       const AttrValue& value) {
-  encoded_attrs_.emplace(string(attr_name), value.SerializeAsString());
+  auto result =
+      encoded_attrs_.emplace(string(attr_name), value.SerializeAsString());
+  if (result.second) {
+    CombineUnordered(CacheKeyHelper(result.first->first,
+                                    tensorflow::Fingerprint128(
+                                        result.first->second)),
+                     &attrs_fingerprint_);
+  }
 }
 
 const NodeDef& AttrBuilder::BuildNodeDef() {
@@ -235,8 +267,14 @@ const NodeDef& AttrBuilder::BuildNodeDef() {
 }
 
 void AttrBuilder::CopyAttributes(const AttrBuilder& other) {
-  encoded_attrs_.insert(other.encoded_attrs_.begin(),
-                        other.encoded_attrs_.end());
+  for (const auto& p : other.encoded_attrs_) {
+    if (encoded_attrs_.insert(p).second) {
+      CombineUnordered(
+          CacheKeyHelper(p.first, tensorflow::Fingerprint128(p.second)),
+          &attrs_fingerprint_);
+    }
+  }
+  cached_cache_key_ = absl::nullopt;
 }
 
 Status AttrTypeByName(const AttrTypeMap& m, const string& attr_name,
@@ -255,31 +293,6 @@ Status AttrTypeByName(const AttrTypeMap& m, const string& attr_name,
   return Status::OK();
 }
 
-namespace {
-inline tensorflow::Fprint128 FingerprintCat128(const tensorflow::Fprint128& a,
-                                               const tensorflow::Fprint128& b) {
-  return {tensorflow::FingerprintCat64(a.low64, b.low64),
-          tensorflow::FingerprintCat64(a.high64, b.high64)};
-}
-
-void CombineUnordered(const tensorflow::Fprint128& a,
-                      tensorflow::Fprint128* b) {
-  b->low64 += a.low64;
-  b->high64 += a.high64;
-}
-
-inline tensorflow::Fprint128 CacheKeyHelper(StringPiece s,
-                                            const tensorflow::Fprint128& b) {
-  tensorflow::Fprint128 a = tensorflow::Fingerprint128(s);
-  return FingerprintCat128(a, b);
-}
-
-inline tensorflow::Fprint128 CacheKeyHelper(StringPiece s, uint64 b) {
-  return CacheKeyHelper(s, {b, b});
-}
-
-}  // namespace
-
 tensorflow::Fprint128 AttrBuilder::CacheKey(const StringPiece device) {
   if (!cached_cache_key_ || device != device_for_cached_cache_key_) {
     cached_cache_key_ = BuildCacheKeyForDevice(device);
@@ -291,12 +304,11 @@ tensorflow::Fprint128 AttrBuilder::CacheKey(const StringPiece device) {
 
 tensorflow::Fprint128 AttrBuilder::BuildCacheKeyForDevice(
     const StringPiece device) const {
-  tensorflow::Fprint128 f = tensorflow::Fingerprint128(op_name());
-  f = tensorflow::FingerprintCat128(f, tensorflow::Fingerprint128(device));
-  for (const auto& p : encoded_attrs_) {
-    CombineUnordered(
-        CacheKeyHelper(p.first, tensorflow::Fingerprint128(p.second)), &f);
-  }
+  tensorflow::Fprint128 f = tensorflow::FingerprintCat128(
+      op_name_fingerprint_, tensorflow::Fingerprint128(device));
+  // The attrs are combined in an order-independent way, so their fingerprints
+  // are accumulated as they are added rather than recomputed here.
+  CombineUnordered(attrs_fingerprint_, &f);
   return f;
 }
 
@@ -95,8 +95,10 @@ class AttrBuilder {
 
   void Reset(const char* op) {
     op_name_ = op;
+    op_name_fingerprint_ = tensorflow::Fingerprint128(op_name_);
     num_inputs_ = 0;
     encoded_attrs_.clear();
+    attrs_fingerprint_ = {0, 0};
     node_def_initialized_ = false;
     node_def_finalized_ = false;
     cached_cache_key_ = absl::nullopt;
@@ -180,9 +182,12 @@ class AttrBuilder {
   void AddAttrIfNotPresent(StringPiece attr_name, const AttrValue& value);
 
   gtl::FlatMap<string, string> encoded_attrs_;
+  // Order-independent combination of the fingerprints of `encoded_attrs_`.
+  tensorflow::Fprint128 attrs_fingerprint_ = {0, 0};
   mutable AttrValue attr_tmp_;  // For encoding
 
   string op_name_;  // Conceptually const, but can't be because of Reset(...)
+  tensorflow::Fprint128 op_name_fingerprint_ = {0, 0};
   int num_inputs_;
   NodeDef node_def_;
   bool node_def_initialized_;
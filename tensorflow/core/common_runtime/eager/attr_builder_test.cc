@@ -83,6 +83,27 @@ TEST(AttrTypeMap, CacheKey) {
   ASSERT_FALSE(cache_key == a.CacheKey("cpu:0"));
 }
 
+TEST(AttrTypeMap, CacheKeyIndependentOfAttrOrder) {
+  AttrBuilder a("op_name");
+  a.Set("T", TF_FLOAT);
+  a.Set("x", 1.0);
+
+  AttrBuilder b("op_name");
+  b.Set("x", 1.0);
+  b.Set("T", TF_FLOAT);
+  // Setting an attr again keeps its first value.
+  b.Set("T", TF_INT32);
+  ASSERT_TRUE(a.CacheKey("cpu:0") == b.CacheKey("cpu:0"));
+
+  AttrBuilder c("op_name");
+  c.Set("x", 1.0);
+  c.CopyAttributes(a);
+  ASSERT_TRUE(a.CacheKey("cpu:0") == c.CacheKey("cpu:0"));
+
+  c.Reset("op_name");
+  ASSERT_FALSE(a.CacheKey("cpu:0") == c.CacheKey("cpu:0"));
+}
+
 string ToString(const AttrValueMap& m) {
   std::vector<string> strs;
   for (const auto& e : m) {
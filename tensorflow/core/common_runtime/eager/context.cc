@@ -381,7 +381,10 @@ void EagerContext::ClearCachesAndDefaultExecutor() {
   // as well.
   mutex_lock ml(cache_mu_);
   default_executor_.WaitForAllPendingNodes().IgnoreError();
-  kernel_cache_.clear();
+  for (KernelCacheShard& shard : kernel_cache_) {
+    mutex_lock l(shard.mu);
+    shard.kernels.clear();
+  }
   for (auto& entry : registered_functions_) {
     entry.second->cached_kernel_keys->clear();
   }
@@ -772,7 +775,9 @@ Status EagerContext::RemoveFunction(const string& func) {
     is_last_ref = registered_function->RefCountIsOne();
     if (is_last_ref) {
       for (auto& key : *registered_function->cached_kernel_keys) {
-        kernel_cache_.erase(key);
+        KernelCacheShard& shard = GetKernelCacheShard(key);
+        mutex_lock l(shard.mu);
+        shard.kernels.erase(key);
       }
       registered_functions_.erase(func);
     }
@@ -835,9 +840,10 @@ Status EagerContext::SyncExecutors() {
 
 core::RefCountPtr<KernelAndDevice> EagerContext::GetCachedKernel(
     Fprint128 cache_key) {
-  tf_shared_lock l(cache_mu_);
-  auto iter = kernel_cache_.find(cache_key);
-  if (iter == kernel_cache_.end()) {
+  KernelCacheShard& shard = GetKernelCacheShard(cache_key);
+  tf_shared_lock l(shard.mu);
+  auto iter = shard.kernels.find(cache_key);
+  if (iter == shard.kernels.end()) {
     return nullptr;
   }
   core::RefCountPtr<KernelAndDevice> new_ref(iter->second.get());
@@ -847,10 +853,16 @@ core::RefCountPtr<KernelAndDevice> EagerContext::GetCachedKernel(
 
 void EagerContext::AddKernelToCache(Fprint128 cache_key,
                                     KernelAndDevice* kernel) {
-  mutex_lock ml(cache_mu_);
   core::RefCountPtr<KernelAndDevice> new_ref(kernel);
   new_ref->Ref();
-  kernel_cache_[cache_key] = std::move(new_ref);
+  // Add the kernel to the shard under `cache_mu_` too, so that a concurrent
+  // RemoveFunction() either sees its key or runs before it is added.
+  mutex_lock ml(cache_mu_);
+  {
+    KernelCacheShard& shard = GetKernelCacheShard(cache_key);
+    mutex_lock l(shard.mu);
+    shard.kernels[cache_key] = std::move(new_ref);
+  }
   auto* registered_function =
       gtl::FindPtrOrNull(registered_functions_, kernel->name());
   // The kernel name can be either a primitive op or a function.
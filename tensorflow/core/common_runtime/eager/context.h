@@ -572,15 +572,27 @@ class EagerContext : public ImmediateExecutionContext, public core::RefCounted {
 
   std::function<void(std::function<void()>)> runner_;
 
+  // Protects `registered_functions_`. When both are held, it is acquired
+  // before the mutex of a kernel cache shard.
   mutex cache_mu_;
   struct RegisteredFunction : public core::RefCounted {
     ~RegisteredFunction() override {}
 
     std::unique_ptr<std::vector<Fprint128>> cached_kernel_keys;
   };
-  std::unordered_map<Fprint128, core::RefCountPtr<KernelAndDevice>,
-                     Fprint128Hasher>
-      kernel_cache_ TF_GUARDED_BY(cache_mu_);
+  // The kernel cache is split into shards by cache key, so that concurrent
+  // eager ops rarely contend on the same mutex.
+  struct KernelCacheShard {
+    mutex mu;
+    std::unordered_map<Fprint128, core::RefCountPtr<KernelAndDevice>,
+                       Fprint128Hasher>
+        kernels TF_GUARDED_BY(mu);
+  };
+  static constexpr int kNumKernelCacheShards = 16;
+  KernelCacheShard& GetKernelCacheShard(const Fprint128& cache_key) {
+    return kernel_cache_[cache_key.low64 % kNumKernelCacheShards];
+  }
+  KernelCacheShard kernel_cache_[kNumKernelCacheShards];
   std::unordered_map<string, RegisteredFunction*> registered_functions_
       TF_GUARDED_BY(cache_mu_);
 
@@ -29,6 +29,13 @@ bool IsAsyncWaitForRemoteFunctionEnabled() {
                                  true, &enabled));
   return enabled;
 }
+
+int64 MaxBatchSizeFromEnvironment() {
+  int64 max_batch_size = 1;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_EAGER_ASYNC_MAX_BATCH_SIZE", 1,
+                                  &max_batch_size));
+  return std::max<int64>(1, max_batch_size);
+}
 }  // namespace
 
 EagerExecutor::EagerExecutor(bool async)
@@ -40,7 +47,8 @@ EagerExecutor::EagerExecutor(bool async)
                     : nullptr),
       last_eager_client_(nullptr),
       enable_async_wait_for_remote_function_(
-          IsAsyncWaitForRemoteFunctionEnabled()) {}
+          IsAsyncWaitForRemoteFunctionEnabled()),
+      max_batch_size_(MaxBatchSizeFromEnvironment()) {}
 
 EagerExecutor::~EagerExecutor() {
   tensorflow::mutex_lock l(node_queue_mutex_);
@@ -153,7 +161,7 @@ Status EagerExecutor::AddOrExecute(std::unique_ptr<EagerNode> node) {
     } else {
       status = status_;
       if (status.ok()) {
-        node_queue_.push(std::move(item));
+        node_queue_.push_back(std::move(item));
         // If there were no previous nodes pending, wake the run thread to
         // start processing requests again.
         if (node_queue_.size() == 1) {
@@ -235,7 +243,7 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
     if (from_queue) {
       // Since this was from the async queue, pop it from the front of the queue
       DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
-      node_queue_.pop();
+      node_queue_.pop_front();
     } else if (async) {
       // If it is an Async node then we will find the node in the unfinished
       // nodes list. However we only notify if we are at the front of the list
@@ -269,7 +277,7 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
       }
       while (!node_queue_.empty()) {
         items_to_destroy.push_front(std::move(node_queue_.front()));
-        node_queue_.pop();
+        node_queue_.pop_front();
       }
       for (auto& it : unfinished_nodes_) {
         items_to_destroy.push_front(std::move(it.second));
@@ -326,6 +334,7 @@ void EagerExecutor::Run() {
       gtl::MakeCleanup([this] { thread_exited_notification_.Notify(); });
   while (true) {
     core::RefCountPtr<NodeItem> curr_item;
+    std::vector<core::RefCountPtr<NodeItem>> batch;
     {
       tensorflow::mutex_lock l(node_queue_mutex_);
       while (node_queue_.empty() || !status_.ok()) {
@@ -341,8 +350,24 @@ void EagerExecutor::Run() {
       // and register a notification for its completion.
       curr_item.reset(node_queue_.front().get());
       curr_item->Ref();
+      // Take the synchronous nodes that directly follow the first one as well,
+      // so that they are run without going through the queue one at a time.
+      if (max_batch_size_ > 1 && curr_item->node->AsAsync() == nullptr) {
+        int64 batch_size = 1;
+        for (auto it = node_queue_.begin() + 1;
+             it != node_queue_.end() && batch_size < max_batch_size_ &&
+             (*it)->node->AsAsync() == nullptr;
+             ++it, ++batch_size) {
+          if (batch.empty()) batch.push_back(std::move(curr_item));
+          core::RefCountPtr<NodeItem> item(it->get());
+          item->Ref();
+          batch.push_back(std::move(item));
+        }
+      }
     }
-    Status status = RunItem(std::move(curr_item), /*from_queue=*/true);
+    Status status = batch.empty()
+                        ? RunItem(std::move(curr_item), /*from_queue=*/true)
+                        : RunBatch(std::move(batch));
     if (!status.ok()) {
       VLOG(1) << "Failed to run item: " << status;
     }
@@ -402,6 +427,38 @@ Status EagerExecutor::RunItem(core::RefCountPtr<NodeItem> item,
   return status();
 }
 
+Status EagerExecutor::RunBatch(
+    std::vector<core::RefCountPtr<NodeItem>> items) {
+  Status status;
+  int num_done = 0;
+  for (const auto& item : items) {
+    DVLOG(3) << "Running Node: [id " << item->id << "] "
+             << item->node->DebugString();
+    status = item->node->Run();
+    if (!status.ok()) break;
+    item->state = NodeState::kDONE;
+    ++num_done;
+  }
+  if (num_done > 0) {
+    mutex_lock l(node_queue_mutex_);
+    // If another node failed meanwhile, the queue has already been cleared.
+    if (status_.ok()) {
+      for (int i = 0; i < num_done; ++i) {
+        DCHECK(!node_queue_.empty() &&
+               items[i].get() == node_queue_.front().get());
+        node_queue_.pop_front();
+      }
+      NotifyWaiters(items[0]->id);
+    }
+  }
+  if (!status.ok()) {
+    const core::RefCountPtr<NodeItem>& failed_item = items[num_done];
+    NodeDone(failed_item, status, /*from_queue=*/true);
+  }
+  // The items are destroyed here, while not holding node_queue_mutex_.
+  return status;
+}
+
 Status EagerExecutor::MoveToUnfinished(core::RefCountPtr<NodeItem> item,
                                        bool from_queue) {
   tensorflow::mutex_lock l(node_queue_mutex_);
@@ -411,7 +468,7 @@ Status EagerExecutor::MoveToUnfinished(core::RefCountPtr<NodeItem> item,
 
   if (from_queue) {
     DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
-    node_queue_.pop();
+    node_queue_.pop_front();
   }
 
   DVLOG(3) << "Add Node: [id " << item->id << "] to unfinished map.";
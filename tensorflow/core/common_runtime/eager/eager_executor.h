@@ -17,9 +17,9 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstddef>
+#include <deque>
 #include <map>
 #include <memory>
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -204,6 +204,11 @@ class EagerExecutor {
   void Run();
 
   Status RunItem(core::RefCountPtr<NodeItem> item, bool from_queue);
+
+  // Runs the synchronous nodes `items`, which are at the front of the queue,
+  // one after the other, and pops them and notifies their waiters at once
+  // rather than after each node. Stops at the first node that fails.
+  Status RunBatch(std::vector<core::RefCountPtr<NodeItem>> items);
   Status MoveToUnfinished(core::RefCountPtr<NodeItem> item, bool from_queue);
 
   // The impl of WaitForAllPendingNodes
@@ -221,7 +226,7 @@ class EagerExecutor {
   condition_variable nodes_pending_ TF_GUARDED_BY(node_queue_mutex_);
 
   // Queue of pending NodeItems. Ordered by NodeItem::id.
-  std::queue<core::RefCountPtr<NodeItem>> node_queue_
+  std::deque<core::RefCountPtr<NodeItem>> node_queue_
       TF_GUARDED_BY(node_queue_mutex_);
 
   // Ordered by NodeItem::id.
@@ -258,6 +263,10 @@ class EagerExecutor {
 
   const bool enable_async_wait_for_remote_function_;
 
+  // Maximum number of consecutive synchronous nodes that the async executor
+  // thread takes from the queue and runs as one batch.
+  const int64 max_batch_size_;
+
   // Callbacks to run on destruction.
   std::unordered_map<intptr_t, std::vector<std::function<void()>>> cleanups_;
 };
@@ -498,14 +498,13 @@ Status TensorHandle::TensorFromDevice(const Device* d,
   }
 
   tf_shared_lock l(mu_);
-  auto elem = local_mirrors_.find(d);
-  if (elem == local_mirrors_.end()) {
+  LocalTensorHandleData* mirror = FindLocalMirror(d);
+  if (mirror == nullptr) {
     return errors::Internal("Invalid device: ", d,
                             " in Tensor call to handle: ", this);
   }
 
-  auto& mirror = elem->second;
-  return mirror.Tensor(t);
+  return mirror->Tensor(t);
 }
 
 Status TensorHandle::TensorValue(const Device* d, tensorflow::TensorValue* t) {
@@ -528,14 +527,13 @@ Status TensorHandle::TensorValue(const Device* d, tensorflow::TensorValue* t) {
   }
 
   tf_shared_lock l(mu_);
-  auto elem = local_mirrors_.find(d);
-  if (elem == local_mirrors_.end()) {
+  LocalTensorHandleData* mirror = FindLocalMirror(d);
+  if (mirror == nullptr) {
     return errors::Internal("Invalid device: ", d,
                             " in TensorValue call to handle: ", this);
   }
 
-  auto& mirror = elem->second;
-  return mirror.TensorValue(t);
+  return mirror->TensorValue(t);
 }
 
 Status TensorHandle::WaitUnknownDevice() const {
@@ -696,22 +694,32 @@ Status TensorHandle::Unprotect(const Device* d) {
   }
 
   tf_shared_lock l(mu_);
-  auto elem = local_mirrors_.find(d);
-  if (elem == local_mirrors_.end()) {
+  LocalTensorHandleData* mirror = FindLocalMirror(d);
+  if (mirror == nullptr) {
     return errors::Internal("Invalid device: ", d,
                             " in Unprotect call to handle: ", this);
   }
 
   // Check if the handle is non-empty
-  auto& mirror = elem->second;
-  return mirror.Unprotect();
+  return mirror->Unprotect();
+}
+
+TensorHandle::Mirrors* TensorHandle::MutableMirrors() {
+  if (mirrors_ == nullptr) mirrors_.reset(new Mirrors);
+  return mirrors_.get();
+}
+
+LocalTensorHandleData* TensorHandle::FindLocalMirror(const Device* d) const {
+  if (mirrors_ == nullptr) return nullptr;
+  auto elem = mirrors_->local.find(d);
+  return elem == mirrors_->local.end() ? nullptr : &elem->second;
 }
 
 bool TensorHandle::HasLocalMirror(const Device* d) const {
   DVLOG(3) << "HasLocalMirror on TensorHandle: " << this << " device: " << d;
 
   tf_shared_lock l(mu_);
-  return local_mirrors_.find(d) != local_mirrors_.end();
+  return FindLocalMirror(d) != nullptr;
 }
 
 Status TensorHandle::AddEmptyLocalMirror(const Device* d) {
@@ -723,17 +731,31 @@ Status TensorHandle::AddEmptyLocalMirror(const Device* d) {
   }
 
   mutex_lock l(mu_);
-  if (local_mirrors_.find(d) != local_mirrors_.end()) {
+  auto elem = MutableMirrors()->local.emplace(std::piecewise_construct,
+                                              std::forward_as_tuple(d),
+                                              std::forward_as_tuple());
+  if (!elem.second) {
     return errors::AlreadyExists("Attempted to duplicate a local mirror.");
   }
 
-  local_mirrors_.emplace(std::piecewise_construct, std::forward_as_tuple(d),
-                         std::forward_as_tuple());
-
   return Status::OK();
 }
 
 #if !defined(IS_MOBILE_PLATFORM)
+RemoteTensorHandleData* TensorHandle::FindRemoteMirror(
+    const string& device_name) const {
+  if (mirrors_ == nullptr) return nullptr;
+  auto mirror = mirrors_->remote.find(device_name);
+  return mirror == mirrors_->remote.end() ? nullptr : &mirror->second;
+}
+
+RemoteTensorHandleData* TensorHandle::FindResourceShapeMirror(
+    const string& device_name) const {
+  if (mirrors_ == nullptr) return nullptr;
+  auto mirror = mirrors_->resource_shape.find(device_name);
+  return mirror == mirrors_->resource_shape.end() ? nullptr : &mirror->second;
+}
+
 Status TensorHandle::RemoteAddress(const Device* d, const bool wait_until_ready,
                                    int64* op_id, int32* output_num) const {
   DVLOG(3) << "RemoteAddress on TensorHandle: " << this << " device: " << d
@@ -741,10 +763,9 @@ Status TensorHandle::RemoteAddress(const Device* d, const bool wait_until_ready,
 
   if (VariantDeviceIsCustom(device_) || d != absl::get<Device*>(device_)) {
     tf_shared_lock l(mu_);
-    auto mirror = remote_mirrors_.find(d->name());
-    if (mirror != remote_mirrors_.end()) {
-      return mirror->second.OpIdAndOutputNum(wait_until_ready, op_id,
-                                             output_num);
+    RemoteTensorHandleData* mirror = FindRemoteMirror(d->name());
+    if (mirror != nullptr) {
+      return mirror->OpIdAndOutputNum(wait_until_ready, op_id, output_num);
     }
 
     return errors::FailedPrecondition(
@@ -765,16 +786,9 @@ bool TensorHandle::HasRemoteMirror(const Device* d,
            << " " << d->name();
 
   tf_shared_lock l(mu_);
-  auto mirror = remote_mirrors_.find(d->name());
-  if (mirror != remote_mirrors_.end()) {
-    // Check if mirror is stale
-    if (mirror->second.context_view_id() != context_view_id) {
-      return false;
-    }
-    return true;
-  }
-
-  return false;
+  RemoteTensorHandleData* mirror = FindRemoteMirror(d->name());
+  // Check if mirror is stale
+  return mirror != nullptr && mirror->context_view_id() == context_view_id;
 }
 
 bool TensorHandle::HasResourceShapeMirror(const Device* d,
@@ -783,15 +797,9 @@ bool TensorHandle::HasResourceShapeMirror(const Device* d,
            << " device: " << d << " " << d->name();
 
   tf_shared_lock l(mu_);
-  auto mirror = resource_shape_mirrors_.find(d->name());
-  if (mirror != resource_shape_mirrors_.end()) {
-    // Check if mirror is stale
-    if (mirror->second.context_view_id() != context_view_id) {
-      return false;
-    }
-    return true;
-  }
-  return false;
+  RemoteTensorHandleData* mirror = FindResourceShapeMirror(d->name());
+  // Check if mirror is stale
+  return mirror != nullptr && mirror->context_view_id() == context_view_id;
 }
 
 Status TensorHandle::AddUnshapedRemoteMirror(const Device* d, int64 op_id,
@@ -803,16 +811,17 @@ Status TensorHandle::AddUnshapedRemoteMirror(const Device* d, int64 op_id,
            << " output_num: " << output_num;
 
   mutex_lock l(mu_);
-  auto remote_mirror = remote_mirrors_.find(d->name());
-  if (remote_mirror != remote_mirrors_.end()) {
+  auto& remote_mirrors = MutableMirrors()->remote;
+  auto remote_mirror = remote_mirrors.find(d->name());
+  if (remote_mirror != remote_mirrors.end()) {
     if (remote_mirror->second.context_view_id() >= ctx->GetContextId()) {
       return errors::Internal("Attempted to duplicate a remote mirror.");
     }
     // Remove stale mirror
-    remote_mirrors_.erase(remote_mirror);
+    remote_mirrors.erase(remote_mirror);
   }
 
-  remote_mirrors_.emplace(
+  remote_mirrors.emplace(
       std::piecewise_construct, std::forward_as_tuple(d->name()),
       std::forward_as_tuple(op_id, output_num, remote_task, ctx));
 
@@ -824,17 +833,18 @@ Status TensorHandle::AddResourceShapeMirror(const Device* d, int64 op_id,
   DVLOG(3) << "AddResourceShapeMirror on TensorHandle: " << this;
 
   mutex_lock l(mu_);
-  auto mirror = resource_shape_mirrors_.find(d->name());
-  if (mirror != resource_shape_mirrors_.end()) {
+  auto& resource_shape_mirrors = MutableMirrors()->resource_shape;
+  auto mirror = resource_shape_mirrors.find(d->name());
+  if (mirror != resource_shape_mirrors.end()) {
     if (mirror->second.context_view_id() == ctx->GetContextViewId()) {
       return errors::Internal(
           "Attempted to duplicate a resource shape mirror.");
     }
     // Remove stale mirror
-    resource_shape_mirrors_.erase(mirror);
+    resource_shape_mirrors.erase(mirror);
   }
 
-  resource_shape_mirrors_.emplace(
+  resource_shape_mirrors.emplace(
       std::piecewise_construct, std::forward_as_tuple(d->name()),
       std::forward_as_tuple(op_id, output_num, ctx->GetContextViewId(),
                             /*is_ready=*/true));
@@ -856,19 +866,18 @@ Status TensorHandle::SetRemoteShapeAndDevice(const TensorShape& shape,
 
   if (VariantDeviceIsCustom(device_) || d != absl::get<Device*>(device_)) {
     tf_shared_lock l(mu_);
-    auto remote_mirror = remote_mirrors_.find(d->name());
-    if (remote_mirror == remote_mirrors_.end()) {
+    RemoteTensorHandleData* mirror = FindRemoteMirror(d->name());
+    if (mirror == nullptr) {
       return Status::OK();
     }
-    auto& mirror = remote_mirror->second;
-    if (mirror.context_view_id() == context_view_id) {
-      return mirror.SetShape(shape);
-    } else if (mirror.context_view_id() < context_view_id) {
+    if (mirror->context_view_id() == context_view_id) {
+      return mirror->SetShape(shape);
+    } else if (mirror->context_view_id() < context_view_id) {
       return errors::Internal(
           absl::Substitute("Unexpected context_view_id ($0) which should not "
                            "be newer than the "
                            "one ($1) associated to the remote mirror.",
-                           context_view_id, mirror.context_view_id()));
+                           context_view_id, mirror->context_view_id()));
     } else {
       LOG(WARNING) << "SetRemoteShape is ignored for a remote mirror that is "
                       "accociated with a newer context_view_id.";
@@ -924,11 +933,9 @@ void TensorHandle::PoisonRemote(Status status, const Device* d,
     data.Poison(status);
   } else {
     tf_shared_lock l(mu_);
-    auto mirror = remote_mirrors_.find(d->name());
-    if (mirror != remote_mirrors_.end()) {
-      if (mirror->second.context_view_id() == context_view_id) {
-        mirror->second.Poison(status);
-      }
+    RemoteTensorHandleData* mirror = FindRemoteMirror(d->name());
+    if (mirror != nullptr && mirror->context_view_id() == context_view_id) {
+      mirror->Poison(status);
     }
   }
 }
@@ -942,9 +949,9 @@ Status TensorHandle::AddLocalMirror(tensorflow::Tensor&& tensor,
   }
 
   mutex_lock l(mu_);
-  auto elem =
-      local_mirrors_.emplace(std::piecewise_construct, std::forward_as_tuple(d),
-                             std::forward_as_tuple(std::move(tensor)));
+  auto elem = MutableMirrors()->local.emplace(
+      std::piecewise_construct, std::forward_as_tuple(d),
+      std::forward_as_tuple(std::move(tensor)));
   if (!elem.second) {
     return errors::AlreadyExists("Attempted to add existing mirror.");
   }
@@ -966,14 +973,13 @@ Status TensorHandle::SetTensor(tensorflow::Tensor&& t, const Device* d) {
     return data.SetTensor(std::move(t));
   } else {
     tf_shared_lock l(mu_);
-    auto elem = local_mirrors_.find(d);
-    if (elem == local_mirrors_.end()) {
+    LocalTensorHandleData* mirror = FindLocalMirror(d);
+    if (mirror == nullptr) {
       return errors::Internal(
           "Attempted to set tensor for non-existent local mirror.");
     }
 
-    auto& mirror = elem->second;
-    return mirror.SetTensor(std::move(t));
+    return mirror->SetTensor(std::move(t));
   }
 
   return Status::OK();
@@ -987,13 +993,12 @@ void TensorHandle::Poison(Status status, const Device* d) {
     absl::visit([status](auto& data) { data.Poison(status); }, data_);
   } else {
     tf_shared_lock l(mu_);
-    auto elem = local_mirrors_.find(d);
-    DCHECK(elem != local_mirrors_.end())
+    LocalTensorHandleData* mirror = FindLocalMirror(d);
+    DCHECK(mirror != nullptr)
         << "Attempted to poison non-existent local mirror, handle: " << this
         << " device: " << d;
 
-    auto& mirror = elem->second;
-    mirror.Poison(status);
+    mirror->Poison(status);
   }
 }
 
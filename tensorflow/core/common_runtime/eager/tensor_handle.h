@@ -308,19 +308,37 @@ class TensorHandle : public ImmediateExecutionTensorHandle {
 
   mutable mutex mu_;
 
-  // Map of local mirrors. This can include both ready and non-ready mirrors.
-  std::unordered_map<const tensorflow::Device*, LocalTensorHandleData>
-      local_mirrors_ TF_GUARDED_BY(mu_);
+  // Copies of the tensor on other devices. Most handles never get one, so the
+  // maps are only allocated when the first mirror is added.
+  struct Mirrors {
+    // Map of local mirrors. This can include both ready and non-ready mirrors.
+    std::unordered_map<const tensorflow::Device*, LocalTensorHandleData> local;
 #if !defined(IS_MOBILE_PLATFORM)
-  // TODO(yujingzhang): Remove resource_shape_mirrors_ once scalable per-replica
-  // variable is ready, since we could get the shape locally without remote copy
-  // then.
-  std::unordered_map<string, RemoteTensorHandleData> resource_shape_mirrors_
-      TF_GUARDED_BY(mu_);
-  // TODO(gjn): Is std::map the most optimal choice here? Perhaps this should be
-  // a fixed size map.
-  std::unordered_map<string, RemoteTensorHandleData> remote_mirrors_
-      TF_GUARDED_BY(mu_);
+    // TODO(yujingzhang): Remove resource_shape once scalable per-replica
+    // variable is ready, since we could get the shape locally without remote
+    // copy then.
+    std::unordered_map<string, RemoteTensorHandleData> resource_shape;
+    // TODO(gjn): Is std::map the most optimal choice here? Perhaps this should
+    // be a fixed size map.
+    std::unordered_map<string, RemoteTensorHandleData> remote;
+#endif
+  };
+  std::unique_ptr<Mirrors> mirrors_ TF_GUARDED_BY(mu_);
+
+  // Returns the mirrors of this handle, allocating them if needed.
+  Mirrors* MutableMirrors() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Returns the local mirror on `d`, or nullptr if there is none.
+  LocalTensorHandleData* FindLocalMirror(const Device* d) const
+      TF_SHARED_LOCKS_REQUIRED(mu_);
+#if !defined(IS_MOBILE_PLATFORM)
+  // Returns the remote mirror on device `device_name`, or nullptr if there is
+  // none.
+  RemoteTensorHandleData* FindRemoteMirror(const string& device_name) const
+      TF_SHARED_LOCKS_REQUIRED(mu_);
+  // Returns the resource shape mirror on device `device_name`, or nullptr if
+  // there is none.
+  RemoteTensorHandleData* FindResourceShapeMirror(
+      const string& device_name) const TF_SHARED_LOCKS_REQUIRED(mu_);
 #endif
 
   // `ctx` is only guaranteed to be set if the handle is not "ready". This is
@@ -16,10 +16,12 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/executor.h"
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/types/optional.h"
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/common_runtime/entry.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
@@ -29,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/propagator_state.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -56,6 +59,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
@@ -70,6 +74,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/scoped_annotation.h"
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
 
 namespace tensorflow {
@@ -134,13 +139,167 @@ struct KernelTimer {
 typedef gtl::InlinedVector<TensorValue, 4> TensorValueVec;
 typedef gtl::InlinedVector<AllocatorAttributes, 4> AllocatorAttributeVec;
 
+// A set of per-worker deques used by the "WORK_STEALING" executor to schedule
+// ready nodes within one step.
+//
+// Each worker (a closure dispatched through `Executor::Args::runner`) owns one
+// deque. A worker pushes newly ready nodes to and pops them from the back of
+// its own deque, so that consumers tend to run on the thread that produced
+// their inputs. When its own deque is empty, a worker steals from the front of
+// the other workers' deques. Every deque has its own lock, so workers only
+// contend with each other when stealing.
+//
+// A worker exits as soon as all deques are empty. To avoid losing work that is
+// pushed concurrently with a worker exiting, `StopWorker()` re-checks the
+// deques after releasing the worker's slot, and `MaybeStartWorker()` is called
+// after every push.
+template <typename Item>
+class WorkStealingQueues {
+ public:
+  explicit WorkStealingQueues(int num_workers)
+      : queues_(num_workers), num_active_workers_(0) {
+    free_worker_ids_.reserve(num_workers);
+    for (int i = num_workers - 1; i >= 0; --i) {
+      free_worker_ids_.push_back(i);
+    }
+  }
+
+  int num_workers() const { return queues_.size(); }
+
+  // Returns the id of the worker running on the current thread, or -1 if the
+  // current thread is not a worker for this set of queues.
+  int CurrentWorkerId() const {
+    return current_worker_.queues == this ? current_worker_.id : -1;
+  }
+
+  // Adds `item` to the back of the deque owned by `worker_id`. If `worker_id`
+  // is -1, the items are spread across the deques in round-robin order.
+  void Push(int worker_id, Item item) {
+    if (worker_id < 0) {
+      worker_id = next_queue_.fetch_add(1, std::memory_order_relaxed) %
+                  queues_.size();
+    }
+    Queue& q = queues_[worker_id];
+    mutex_lock l(q.mu);
+    q.items.push_back(std::move(item));
+  }
+
+  // Pops the most recently pushed item from the deque owned by `worker_id`
+  // or, if that deque is empty, steals the oldest item from another deque.
+  // Returns nullopt if all deques are empty.
+  absl::optional<Item> Pop(int worker_id) {
+    {
+      Queue& q = queues_[worker_id];
+      mutex_lock l(q.mu);
+      if (!q.items.empty()) {
+        Item item = std::move(q.items.back());
+        q.items.pop_back();
+        return item;
+      }
+    }
+    const int n = queues_.size();
+    for (int i = 1; i < n; ++i) {
+      Queue& q = queues_[(worker_id + i) % n];
+      mutex_lock l(q.mu);
+      if (!q.items.empty()) {
+        Item item = std::move(q.items.front());
+        q.items.pop_front();
+        return item;
+      }
+    }
+    return absl::nullopt;
+  }
+
+  // Claims a worker slot if fewer than `num_workers()` workers are active.
+  // Returns the id of the claimed slot, or -1 if all slots are taken.
+  int MaybeStartWorker() {
+    if (num_active_workers_.load() >= num_workers()) return -1;
+    mutex_lock l(worker_ids_mu_);
+    if (free_worker_ids_.empty()) return -1;
+    const int worker_id = free_worker_ids_.back();
+    free_worker_ids_.pop_back();
+    num_active_workers_.fetch_add(1);
+    return worker_id;
+  }
+
+  // Releases the slot `worker_id` once its worker has found all deques empty.
+  // If work was pushed in the meantime, claims a slot again and returns its
+  // id, in which case the caller must keep running as a worker. Otherwise
+  // returns -1.
+  int StopWorker(int worker_id) {
+    {
+      mutex_lock l(worker_ids_mu_);
+      free_worker_ids_.push_back(worker_id);
+      num_active_workers_.fetch_sub(1);
+    }
+    for (Queue& q : queues_) {
+      mutex_lock l(q.mu);
+      if (!q.items.empty()) return MaybeStartWorker();
+    }
+    return -1;
+  }
+
+  // Marks the current thread as running worker `worker_id` for the lifetime
+  // of this object, restoring the previous worker (if any) on destruction.
+  class WorkerScope {
+   public:
+    WorkerScope(const WorkStealingQueues* queues, int worker_id)
+        : saved_(current_worker_) {
+      current_worker_.queues = queues;
+      current_worker_.id = worker_id;
+    }
+    ~WorkerScope() { current_worker_ = saved_; }
+
+   private:
+    const typename WorkStealingQueues::CurrentWorker saved_;
+  };
+
+ private:
+  struct Queue {
+    mutex mu;
+    std::deque<Item> items TF_GUARDED_BY(mu);
+  };
+
+  struct CurrentWorker {
+    const WorkStealingQueues* queues = nullptr;
+    int id = -1;
+  };
+  static thread_local CurrentWorker current_worker_;
+
+  std::vector<Queue> queues_;
+  std::atomic<int> next_queue_{0};
+
+  mutex worker_ids_mu_;
+  std::vector<int> free_worker_ids_ TF_GUARDED_BY(worker_ids_mu_);
+  std::atomic<int> num_active_workers_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(WorkStealingQueues);
+};
+
+template <typename Item>
+thread_local typename WorkStealingQueues<Item>::CurrentWorker
+    WorkStealingQueues<Item>::current_worker_;
+
 class ExecutorImpl : public Executor {
  public:
-  explicit ExecutorImpl(const LocalExecutorParams& p) : immutable_state_(p) {}
+  // If `num_work_stealing_workers` is positive, each step schedules its nodes
+  // through per-worker deques with work stealing, using at most that many
+  // concurrent closures on the inter-op runner. Otherwise, every ready node
+  // that is not inlined is dispatched to the runner individually.
+  explicit ExecutorImpl(const LocalExecutorParams& p,
+                        int num_work_stealing_workers = 0)
+      : immutable_state_(p),
+        num_work_stealing_workers_(num_work_stealing_workers) {}
 
   Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
     kernel_stats_.Initialize(immutable_state_.graph_view());
+    const LocalExecutorParams& params = immutable_state_.params();
+    if (params.use_static_memory_plan &&
+        params.device->device_type() == DEVICE_CPU) {
+      memory_planner_ = absl::make_unique<StaticMemoryPlanner>(
+          graph, params.device->GetAllocator(AllocatorAttributes()));
+    }
     return Status::OK();
   }
 
@@ -214,6 +373,9 @@ class ExecutorImpl : public Executor {
 
   ImmutableExecutorState immutable_state_;
   KernelStats kernel_stats_;
+  const int num_work_stealing_workers_;
+  // Non-null iff the outputs are placed according to a static memory plan.
+  std::unique_ptr<StaticMemoryPlanner> memory_planner_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(ExecutorImpl);
 };
@@ -272,7 +434,9 @@ class ExecutorState {
  public:
   ExecutorState(const Executor::Args& args,
                 const ImmutableExecutorState& immutable_state_,
-                ExecutorImpl::KernelStats* kernel_stats_);
+                ExecutorImpl::KernelStats* kernel_stats_,
+                int num_work_stealing_workers,
+                StaticMemoryPlanner* memory_planner);
   ~ExecutorState();
 
   void RunAsync(Executor::DoneCallback done);
@@ -286,6 +450,13 @@ class ExecutorState {
 
   struct AsyncState;
 
+  // A ready node waiting in a work-stealing deque.
+  struct WorkItem {
+    TaggedNode tagged_node;
+    int64 scheduled_nsec;
+  };
+  typedef WorkStealingQueues<WorkItem> WorkQueues;
+
   // Process a ready node in current thread.
   void Process(TaggedNode node, int64 scheduled_nsec);
 
@@ -324,6 +495,17 @@ class ExecutorState {
   // REQUIRES: `!ready->empty()`.
   void ScheduleReady(TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready);
 
+  // Implements `ScheduleReady()` for the work-stealing mode: the first node in
+  // `*ready` is inlined if `inline_ready` is empty, and the rest are pushed to
+  // the current worker's deque.
+  void ScheduleReadyWorkStealing(TaggedNodeSeq* ready,
+                                 TaggedNodeReadyQueue* inline_ready,
+                                 int64 scheduled_nsec);
+
+  // Dispatches a closure to the runner that runs nodes from `work_queues_` as
+  // worker `worker_id`, until all deques are empty.
+  void StartWorker(int worker_id);
+
   // A wrapper for runner_ to keep track of the pending queue length. Op
   // execution should dispatch work using this function instead of using runner_
   // directly.
@@ -369,6 +551,20 @@ class ExecutorState {
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
+  // If true, records per-op queueing and compute times in the monitoring
+  // metrics. Read once per step, so that the check is cheap.
+  const bool record_op_metrics_;
+
+  // Non-null iff the executor runs in work-stealing mode. Shared with the
+  // worker closures, which can outlive this object.
+  std::shared_ptr<WorkQueues> work_queues_;
+
+  // Non-null iff the executor uses a static memory plan. The step either
+  // records the output sizes for the planner, or places the outputs into
+  // `memory_arena_` (if the planner had one available).
+  StaticMemoryPlanner* const memory_planner_;
+  bool recording_memory_plan_ = false;
+  StaticMemoryPlanner::Arena* memory_arena_ = nullptr;
 
   PropagatorStateType propagator_;
 
@@ -390,7 +586,8 @@ class ExecutorState {
 template <class PropagatorStateType>
 ExecutorState<PropagatorStateType>::ExecutorState(
     const Executor::Args& args, const ImmutableExecutorState& immutable_state,
-    ExecutorImpl::KernelStats* kernel_stats)
+    ExecutorImpl::KernelStats* kernel_stats, int num_work_stealing_workers,
+    StaticMemoryPlanner* memory_planner)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
       step_id_(args.step_id),
@@ -413,6 +610,8 @@ ExecutorState<PropagatorStateType>::ExecutorState(
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
       run_all_kernels_inline_(args.run_all_kernels_inline),
+      record_op_metrics_(metrics::IsOpLatencyMetricsEnabled()),
+      memory_planner_(memory_planner),
       propagator_(immutable_state, step_id_, vlog_),
       num_outstanding_ops_(0) {
   if (args.user_intra_op_threadpool != nullptr) {
@@ -420,6 +619,16 @@ ExecutorState<PropagatorStateType>::ExecutorState(
     user_device_ = RenamedDevice::NewRenamedDevice(
         device->name(), device, false, false, args.user_intra_op_threadpool);
   }
+  if (num_work_stealing_workers > 0 && !run_all_kernels_inline_) {
+    work_queues_ = std::make_shared<WorkQueues>(num_work_stealing_workers);
+  }
+  if (memory_planner_ != nullptr) {
+    if (memory_planner_->recording()) {
+      recording_memory_plan_ = true;
+    } else {
+      memory_arena_ = memory_planner_->AcquireArena();
+    }
+  }
 }
 
 template <class PropagatorStateType>
@@ -427,6 +636,9 @@ ExecutorState<PropagatorStateType>::~ExecutorState() {
   if (device_context_) {
     device_context_->Unref();
   }
+  if (memory_arena_) {
+    memory_arena_->Unref();
+  }
   delete slice_reader_cache_;
 }
 
@@ -514,6 +726,8 @@ struct ExecutorState<PropagatorStateType>::AsyncState {
   Entry* first_input;
   OpKernelContext ctx;
   NodeExecStatsInterface* stats;
+  // When the kernel started, if op metrics are recorded.
+  int64 start_nsec = 0;
 
  private:
   OpKernelContext::Params* ParamsButClearingEigenGPUDevice(
@@ -556,6 +770,7 @@ Status ExecutorState<PropagatorStateType>::ProcessSync(
   OpKernel* op_kernel = item.kernel;
   Device* device = immutable_state_.params().device;
   const bool is_expensive = kernel_stats_->IsExpensive(item);
+  const int64 start_nsec = record_op_metrics_ ? nodestats::NowInNsec() : 0;
 
   if (TF_PREDICT_FALSE(MightTrace(event_collector_, is_expensive))) {
     tracing::ScopedRegion region(tracing::EventCategory::kCompute,
@@ -581,6 +796,11 @@ Status ExecutorState<PropagatorStateType>::ProcessSync(
   } else {
     device->Compute(op_kernel, &ctx);
   }
+  if (record_op_metrics_) {
+    metrics::RecordOpComputeTime(
+        op_kernel->type_string(),
+        (nodestats::NowInNsec() - start_nsec) / EnvTime::kMicrosToNanos);
+  }
   nodestats::SetOpEnd(stats);
   if (outputs->size() < item.num_outputs) outputs->resize(item.num_outputs);
   s = ProcessOutputs(item, &ctx, outputs->data(), stats);
@@ -603,6 +823,12 @@ void ExecutorState<PropagatorStateType>::ProcessAsync(
     NodeExecStatsInterface* stats = state->stats;  // Shorthand
     Entry* first_input = state->first_input;       // Shorthand
 
+    if (record_op_metrics_) {
+      metrics::RecordOpComputeTime(
+          state->item->kernel->type_string(),
+          (nodestats::NowInNsec() - state->start_nsec) /
+              EnvTime::kMicrosToNanos);
+    }
     nodestats::SetOpEnd(stats);
     EntryVector outputs(state->item->num_outputs);
     Status s = ProcessOutputs(*state->item, &state->ctx, outputs.data(), stats);
@@ -630,6 +856,7 @@ void ExecutorState<PropagatorStateType>::ProcessAsync(
     if (completed) ScheduleFinish();
   };
   nodestats::SetOpStart(stats);
+  if (record_op_metrics_) state->start_nsec = nodestats::NowInNsec();
   {
     profiler::AnnotatedTraceMe activity(
         [async_kernel, state] {
@@ -681,9 +908,13 @@ void ExecutorState<PropagatorStateType>::Process(TaggedNode tagged_node,
   TaggedNodeSeq ready;
   TaggedNodeReadyQueue inline_ready;
 
-  // Parameters passed to OpKernel::Compute.
+  // Parameters passed to OpKernel::Compute. They are set up once and reused
+  // for every node processed inline below, and the vectors are sized for the
+  // widest node of the graph so that they never reallocate in the loop.
   TensorValueVec inputs;
   AllocatorAttributeVec input_alloc_attrs;
+  inputs.reserve(immutable_state_.max_num_inputs());
+  input_alloc_attrs.reserve(immutable_state_.max_num_inputs());
 
   OpKernelContext::Params params;
   params.step_id = step_id_;
@@ -738,6 +969,7 @@ void ExecutorState<PropagatorStateType>::Process(TaggedNode tagged_node,
   NodeExecStatsInterface* stats = nullptr;
 
   EntryVector outputs(1);
+  outputs.reserve(immutable_state_.max_num_outputs());
 
   bool completed = false;
   inline_ready.push_back(tagged_node);
@@ -749,6 +981,12 @@ void ExecutorState<PropagatorStateType>::Process(TaggedNode tagged_node,
 
     propagator_.MaybeMarkStarted(tagged_node);
 
+    if (record_op_metrics_ && !tagged_node.get_is_dead()) {
+      metrics::RecordOpQueueingTime(
+          item.kernel->type_string(),
+          (nodestats::NowInNsec() - scheduled_nsec) / EnvTime::kMicrosToNanos);
+    }
+
     params.track_allocations = false;
     stats = nullptr;
     if (stats_collector_ && !tagged_node.get_is_dead()) {
@@ -803,6 +1041,9 @@ void ExecutorState<PropagatorStateType>::Process(TaggedNode tagged_node,
       params.output_attr_array = item.output_attrs();
       params.forward_from_array = item.forward_from();
       params.outputs_required_array = item.outputs_required.get();
+      params.output_allocators =
+          memory_arena_ != nullptr ? memory_arena_->output_allocators(id)
+                                   : nullptr;
 
       if (item.kernel_is_async) {
         ProcessAsync(item, params, tagged_node, first_input, stats);
@@ -837,7 +1078,7 @@ void ExecutorState<PropagatorStateType>::Process(TaggedNode tagged_node,
         outputs[i].ClearVal();
       }
 
-      if (stats) {
+      if (stats || record_op_metrics_) {
         scheduled_nsec = nodestats::NowInNsec();
       }
       // Postprocess.
@@ -1018,6 +1259,11 @@ Status ExecutorState<PropagatorStateType>::ProcessOutputs(
         if (stats && val.tensor->IsInitialized()) {
           nodestats::SetOutput(stats, i, val.tensor);
         }
+        if (recording_memory_plan_ && !val.is_ref() &&
+            val.tensor->IsInitialized()) {
+          memory_planner_->RecordOutput(item.node_id, i,
+                                        val.tensor->TotalBytes());
+        }
         if (val.is_ref()) {
           out->state = Entry::State::HAS_REF_TENSOR;
           out->ref_tensor.tensor = val.tensor;
@@ -1143,11 +1389,13 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
   DCHECK(!ready->empty());
 
   int64 scheduled_nsec = 0;
-  if (stats_collector_) {
+  if (stats_collector_ || record_op_metrics_) {
     scheduled_nsec = nodestats::NowInNsec();
   }
 
-  if (run_all_kernels_inline_) {
+  if (work_queues_) {
+    ScheduleReadyWorkStealing(ready, inline_ready, scheduled_nsec);
+  } else if (run_all_kernels_inline_) {
     if (inline_ready == nullptr) {
       // Schedule all ready kernels from a single closure. This ensure that,
       // regardless of the `runner_` implementation, all kernels will run
@@ -1201,6 +1449,48 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
   ready->clear();
 }
 
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::ScheduleReadyWorkStealing(
+    TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready,
+    int64 scheduled_nsec) {
+  const int worker_id = work_queues_->CurrentWorkerId();
+  int num_pushed = 0;
+  for (auto& tagged_node : *ready) {
+    if (inline_ready != nullptr && inline_ready->empty()) {
+      // Run the first ready node on this thread, since its inputs are most
+      // likely still in this core's cache.
+      inline_ready->push_back(tagged_node);
+    } else {
+      work_queues_->Push(worker_id, WorkItem{tagged_node, scheduled_nsec});
+      ++num_pushed;
+    }
+  }
+  // Wake up at most one idle worker per pushed node. Workers that are already
+  // running will steal the remaining nodes.
+  for (int i = 0; i < num_pushed; ++i) {
+    const int new_worker_id = work_queues_->MaybeStartWorker();
+    if (new_worker_id < 0) break;
+    StartWorker(new_worker_id);
+  }
+}
+
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::StartWorker(int worker_id) {
+  // NOTE: The closure must not touch `this` unless it has popped a node,
+  // because the last node to complete deletes the ExecutorState while other
+  // workers may still be draining their (by then empty) deques.
+  RunTask([this, work_queues = work_queues_, worker_id]() {
+    int id = worker_id;
+    while (id >= 0) {
+      while (absl::optional<WorkItem> item = work_queues->Pop(id)) {
+        typename WorkQueues::WorkerScope worker_scope(work_queues.get(), id);
+        Process(item->tagged_node, item->scheduled_nsec);
+      }
+      id = work_queues->StopWorker(id);
+    }
+  });
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::ScheduleFinish() {
   // Checks condition to decide if needs to invoke Finish(). If there are
@@ -1232,6 +1522,10 @@ void ExecutorState<PropagatorStateType>::Finish() {
   CHECK(done_cb != nullptr);
   Device* device = immutable_state_.params().device;
 
+  if (recording_memory_plan_) {
+    memory_planner_->RecordStepDone(status.ok());
+  }
+
   if (vlog_ && !status.ok() && VLOG_IS_ON(1)) {
     // Logs verbose information about the current state of active and pending
     // nodes in the propagator.
@@ -1338,11 +1632,14 @@ void ExecutorState<PropagatorStateType>::Finish() {
 
 void ExecutorImpl::RunAsync(const Args& args, DoneCallback done) {
   if (immutable_state_.requires_control_flow_support()) {
-    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_))
+    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_,
+                                        num_work_stealing_workers_,
+                                        memory_planner_.get()))
         ->RunAsync(std::move(done));
   } else {
-    (new ExecutorState<SimplePropagatorState>(args, immutable_state_,
-                                              &kernel_stats_))
+    (new ExecutorState<SimplePropagatorState>(
+         args, immutable_state_, &kernel_stats_, num_work_stealing_workers_,
+         memory_planner_.get()))
         ->RunAsync(std::move(done));
   }
 }
@@ -1396,6 +1693,39 @@ class DefaultExecutorRegistrar {
 };
 static DefaultExecutorRegistrar registrar;
 
+// Registers the "WORK_STEALING" executor, which schedules ready nodes through
+// per-worker deques with work stealing instead of dispatching every node to
+// the inter-op runner. The maximum number of concurrent workers per step
+// defaults to the number of schedulable CPUs and can be overridden with the
+// TF_WORK_STEALING_EXECUTOR_NUM_WORKERS environment variable.
+class WorkStealingExecutorRegistrar {
+ public:
+  WorkStealingExecutorRegistrar() {
+    ExecutorFactory::Register("WORK_STEALING", new Factory);
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params, const Graph& graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      int64 num_workers;
+      TF_RETURN_IF_ERROR(
+          ReadInt64FromEnvVar("TF_WORK_STEALING_EXECUTOR_NUM_WORKERS",
+                              port::MaxParallelism(), &num_workers));
+      if (num_workers <= 0) {
+        return errors::InvalidArgument(
+            "TF_WORK_STEALING_EXECUTOR_NUM_WORKERS must be positive, got ",
+            num_workers);
+      }
+      auto impl = absl::make_unique<ExecutorImpl>(params, num_workers);
+      TF_RETURN_IF_ERROR(impl->Initialize(graph));
+      *out_executor = std::move(impl);
+      return Status::OK();
+    }
+  };
+};
+static WorkStealingExecutorRegistrar work_stealing_registrar;
+
 }  // namespace
 
 }  // namespace tensorflow
@@ -25,12 +25,14 @@ limitations under the License.
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/common_runtime/lower_functional_ops.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
@@ -38,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/monitoring/collection_registry.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
@@ -80,9 +83,12 @@ class ExecutorTest : public ::testing::Test {
     params.delete_kernel = [](OpKernel* kernel) {
       DeleteNonCachedKernel(kernel);
     };
+    params.use_static_memory_plan = use_static_memory_plan_;
     rendez_ = NewLocalRendezvous();
     delete exec_;
-    TF_CHECK_OK(NewLocalExecutor(params, *graph, &exec_));
+    std::unique_ptr<Executor> exec;
+    TF_CHECK_OK(NewExecutor(executor_type_, params, *graph, &exec));
+    exec_ = exec.release();
     runner_ = [this](std::function<void()> fn) { thread_pool_->Schedule(fn); };
   }
 
@@ -94,6 +100,10 @@ class ExecutorTest : public ::testing::Test {
     return exec_->Run(args);
   }
 
+  // The executor type passed to `NewExecutor()` by `Create()`.
+  string executor_type_;
+  // Whether `Create()` enables the static memory plan.
+  bool use_static_memory_plan_ = false;
   thread::ThreadPool* thread_pool_ = nullptr;
   std::unique_ptr<Device> device_;
   Executor* exec_ = nullptr;
@@ -175,6 +185,97 @@ TEST_F(ExecutorTest, SimpleAdd) {
   EXPECT_EQ(2.0, V(out));  // out = 1.0 + 1.0 = 2.0
 }
 
+// Returns the number of samples of op type `op_type` in histogram `metric`.
+int64 NumOpSamples(const string& metric, const string& op_type) {
+  std::unique_ptr<monitoring::CollectedMetrics> collected =
+      monitoring::CollectionRegistry::Default()->CollectMetrics({});
+  auto it = collected->point_set_map.find(metric);
+  if (it == collected->point_set_map.end()) return 0;
+  for (const auto& point : it->second->points) {
+    if (point->labels.size() == 1 && point->labels[0].value == op_type) {
+      return point->histogram_value.num();
+    }
+  }
+  return 0;
+}
+
+TEST_F(ExecutorTest, OpLatencyMetrics) {
+  const string kQueueingTime =
+      "/tensorflow/core/op_queueing_time_usecs_histogram";
+  const string kComputeTime =
+      "/tensorflow/core/op_compute_time_usecs_histogram";
+  auto g = absl::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto in1 = test::graph::Recv(g.get(), "b", "float", ALICE, 1, BOB);
+  auto tmp = test::graph::Add(g.get(), in0, in1);
+  test::graph::Send(g.get(), tmp, "c", BOB, 1, ALICE);
+  Create(std::move(g));
+  auto run_step = [this]() {
+    Rendezvous::Args args;
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args,
+                               V(1.0), false));
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "b"), args,
+                               V(1.0), false));
+    TF_ASSERT_OK(Run(rendez_));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out,
+                               &is_dead));
+    EXPECT_EQ(2.0, V(out));
+  };
+
+  const int64 queued = NumOpSamples(kQueueingTime, "Add");
+  const int64 computed = NumOpSamples(kComputeTime, "Add");
+  metrics::SetOpLatencyMetricsEnabled(true);
+  run_step();
+  EXPECT_EQ(NumOpSamples(kQueueingTime, "Add"), queued + 1);
+  EXPECT_EQ(NumOpSamples(kComputeTime, "Add"), computed + 1);
+  // The asynchronous _Recv kernels are timed as well.
+  EXPECT_GE(NumOpSamples(kComputeTime, "_Recv"), 2);
+
+  metrics::SetOpLatencyMetricsEnabled(false);
+  run_step();
+  EXPECT_EQ(NumOpSamples(kQueueingTime, "Add"), queued + 1);
+  EXPECT_EQ(NumOpSamples(kComputeTime, "Add"), computed + 1);
+}
+
+TEST_F(ExecutorTest, StaticMemoryPlan) {
+  // v0 <- a
+  // v1 = v0 + v0
+  // ... ...
+  // v5 = v4 + v4
+  //
+  // b <- v5
+  use_static_memory_plan_ = true;
+  auto g = absl::make_unique<Graph>(OpRegistry::Global());
+  auto v = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  for (int i = 1; i <= 5; ++i) {
+    v = test::graph::Add(g.get(), v, v);
+  }
+  test::graph::Send(g.get(), v, "b", BOB, 1, ALICE);
+  Create(std::move(g));
+  // The first steps record the output sizes, and the next ones place the
+  // outputs in the planned arenas.
+  for (int step = 0; step < 5; ++step) {
+    Rendezvous* rendez = NewLocalRendezvous();
+    Rendezvous::Args args;
+    TF_ASSERT_OK(rendez->Send(Key(ALICE, kIncarnation, BOB, "a"), args,
+                              V(step), false));
+    // Runs without a stats collector, which would track the allocations and
+    // bypass the arenas.
+    Executor::Args exec_args;
+    exec_args.rendezvous = rendez;
+    exec_args.runner = runner_;
+    TF_ASSERT_OK(exec_->Run(exec_args));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(
+        rendez->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out, &is_dead));
+    EXPECT_EQ(32.0 * step, V(out));
+    rendez->Unref();
+  }
+}
+
 TEST_F(ExecutorTest, SelfAdd) {
   // v0 <- a
   // v1 = v0 + v0
@@ -255,6 +356,22 @@ TEST_F(ExecutorTest, RandomTree) {
   EXPECT_EQ(4096.0, V(out));
 }
 
+TEST_F(ExecutorTest, WorkStealingRandomTree) {
+  executor_type_ = "WORK_STEALING";
+  auto g = absl::make_unique<Graph>(OpRegistry::Global());
+  BuildTree(4096, g.get());
+  Create(std::move(g));
+  Rendezvous::Args args;
+  TF_ASSERT_OK(
+      rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out, &is_dead));
+  EXPECT_EQ(4096.0, V(out));
+}
+
 void BuildConcurrentAddAssign(Graph* g) {
   auto one = test::graph::Constant(g, V(1.0));
   // A variable holds one float.
@@ -329,6 +446,25 @@ TEST_F(ExecutorTest, SimpleSwitchDead) {
   EXPECT_TRUE(is_dead);
 }
 
+TEST_F(ExecutorTest, WorkStealingSimpleSwitchDead) {
+  executor_type_ = "WORK_STEALING";
+  auto g = absl::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto in1 = test::graph::Constant(g.get(), VB(true));
+  auto tmp = test::graph::Switch(g.get(), in0, in1);
+  test::graph::Send(g.get(), tmp, "c", BOB, 1, ALICE);
+  Create(std::move(g));
+  Rendezvous::Args args;
+  TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0),
+                             false));  // in0 = 1.0
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out, &is_dead));
+  EXPECT_TRUE(is_dead);
+}
+
 TEST_F(ExecutorTest, Abort) {
   // e = a + b + c + d
   auto g = absl::make_unique<Graph>(OpRegistry::Global());
@@ -433,7 +569,8 @@ TEST_F(ExecutorTest, NoInputTensors) {
 // Create a graph that is 'depth' deep. At each level, fan-in and fan-out a
 // maximum of 'width' nodes. All nodes are no-ops and all dependencies are
 // control dependencies.
-static void BM_executor(::testing::benchmark::State& state) {
+static void BM_executorHelper(::testing::benchmark::State& state,
+                              const char* executor_type) {
   const int width = state.range(0);
   const int depth = state.range(1);
 
@@ -467,22 +604,88 @@ static void BM_executor(::testing::benchmark::State& state) {
   }
 
   FixupSourceAndSinkEdges(g);
-  test::Benchmark("cpu", g, /*old_benchmark_api=*/false).Run(state);
+  test::Benchmark("cpu", g, /*options=*/nullptr, /*init=*/nullptr,
+                  /*rendez=*/nullptr, executor_type,
+                  /*old_benchmark_api=*/false)
+      .Run(state);
 
   state.SetLabel(strings::StrCat("Nodes = ", cur));
   state.SetItemsProcessed(cur * static_cast<int64>(state.iterations()));
 }
 
+static void BM_executor(::testing::benchmark::State& state) {
+  BM_executorHelper(state, "");
+}
+
+static void BM_executorWorkStealing(::testing::benchmark::State& state) {
+  BM_executorHelper(state, "WORK_STEALING");
+}
+
 // Tall skinny graphs
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(16, 1024);
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(32, 8192);
+BENCHMARK(BM_executorWorkStealing)->UseRealTime()->ArgPair(16, 1024);
+BENCHMARK(BM_executorWorkStealing)->UseRealTime()->ArgPair(32, 8192);
 
 // Short fat graphs
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(1024, 16);
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(8192, 32);
+BENCHMARK(BM_executorWorkStealing)->UseRealTime()->ArgPair(1024, 16);
+BENCHMARK(BM_executorWorkStealing)->UseRealTime()->ArgPair(8192, 32);
 
 // Tall fat graph
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(1024, 1024);
+BENCHMARK(BM_executorWorkStealing)->UseRealTime()->ArgPair(1024, 1024);
+
+// Create a graph with 'depth' levels, where every node at one level fans out
+// to 'width' expensive nodes (small MatMuls) at the next level, which are
+// joined again before the following level.
+static void BM_FanOutHelper(::testing::benchmark::State& state,
+                            const char* executor_type) {
+  const int width = state.range(0);
+  const int depth = state.range(1);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor t(DT_FLOAT, TensorShape({16, 16}));
+  t.flat<float>().setRandom();
+  Node* in = test::graph::Constant(g, t);
+  int64 cur = 1;
+  for (int i = 0; i < depth; ++i) {
+    std::vector<Node*> fan_out;
+    for (int j = 0; j < width; ++j) {
+      fan_out.push_back(test::graph::Matmul(g, in, in, false, false));
+      ++cur;
+    }
+    in = test::graph::Identity(g, fan_out[0]);
+    for (Node* n : fan_out) {
+      g->AddControlEdge(n, in);
+    }
+    ++cur;
+  }
+
+  FixupSourceAndSinkEdges(g);
+  test::Benchmark("cpu", g, /*options=*/nullptr, /*init=*/nullptr,
+                  /*rendez=*/nullptr, executor_type,
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+
+  state.SetLabel(strings::StrCat("Nodes = ", cur));
+  state.SetItemsProcessed(cur * static_cast<int64>(state.iterations()));
+}
+
+static void BM_FanOut(::testing::benchmark::State& state) {
+  BM_FanOutHelper(state, "");
+}
+
+static void BM_FanOutWorkStealing(::testing::benchmark::State& state) {
+  BM_FanOutHelper(state, "WORK_STEALING");
+}
+
+BENCHMARK(BM_FanOut)->UseRealTime()->ArgPair(64, 16)->ArgPair(512, 4);
+BENCHMARK(BM_FanOutWorkStealing)
+    ->UseRealTime()
+    ->ArgPair(64, 16)
+    ->ArgPair(512, 4);
 
 static void BM_const_identity(::testing::benchmark::State& state) {
   const int width = state.range(0);
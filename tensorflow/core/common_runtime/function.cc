@@ -48,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/connected_traceme.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 #include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 // See core/kernels/function_ops.cc for related kernels.
 
@@ -65,6 +66,10 @@ static constexpr const char* const kGradientOp =
 static constexpr const char* const kNodeLabel = "Func";
 static constexpr const char* const kFuncAttr =
     FunctionLibraryDefinition::kFuncAttr;
+// Executor that runs the kernels of a graph one at a time on the caller thread
+// (see core/kernels/data/single_threaded_executor.h).
+static constexpr const char* const kSingleThreadedExecutor =
+    "SINGLE_THREADED_EXECUTOR";
 
 // Represents the index-th output of a node.
 struct Endpoint {
@@ -392,6 +397,10 @@ class FunctionLibraryRuntimeImpl : public FunctionLibraryRuntime {
   const SessionMetadata* const session_metadata_;
   Executor::Args::Runner default_runner_;
   const string device_name_;
+  // CPU function bodies with at most this many op nodes, and no executor
+  // requested, are run by the single-threaded executor if it supports them.
+  // 0 disables this.
+  const int64 inline_executor_max_nodes_;
 
   std::function<Status(const string&, const OpDef**)> get_func_sig_;
   std::function<Status(const std::shared_ptr<const NodeProperties>&,
@@ -434,6 +443,9 @@ class FunctionLibraryRuntimeImpl : public FunctionLibraryRuntime {
                            const FunctionLibraryDefinition* lib_def,
                            std::unique_ptr<FunctionBody>* fbody);
   Status CreateItem(Item** item);
+  // Returns true if the function body `g`, for which no executor type was
+  // requested, should be run by the single-threaded executor.
+  bool ShouldUseSingleThreadedExecutor(const Graph& g) const;
   Status GetOrCreateItem(LocalHandle local_handle, Item** item);
   Status InstantiateSymbolicGradient(const NameAttrList& func,
                                      const FunctionLibraryDefinition* lib_def,
@@ -474,6 +486,12 @@ FunctionLibraryRuntimeImpl::FunctionLibraryRuntimeImpl(
       device_name_(device_ == nullptr
                        ? ProcessFunctionLibraryRuntime::kDefaultFLRDevice
                        : device_->name()),
+      inline_executor_max_nodes_([] {
+        int64 max_nodes;
+        TF_CHECK_OK(ReadInt64FromEnvVar(
+            "TF_FUNCTION_INLINE_EXECUTOR_MAX_NODES", 0, &max_nodes));
+        return max_nodes;
+      }()),
       next_handle_(0),
       items_(new std::unordered_map<Handle, std::unique_ptr<Item>>),
       parent_(parent) {
@@ -944,7 +962,19 @@ Status FunctionLibraryRuntimeImpl::CreateItem(Item** item) {
   };
   params.session_metadata = session_metadata_;
   std::unique_ptr<Executor> exec;
-  TF_RETURN_IF_ERROR(NewExecutor(executor_type, params, *g, &exec));
+  if (executor_type.empty() && ShouldUseSingleThreadedExecutor(*g)) {
+    // The executor rejects the graphs it does not support (e.g. with low level
+    // control flow), in which case the default executor is used instead.
+    Status s = NewExecutor(kSingleThreadedExecutor, params, *g, &exec);
+    if (!s.ok()) {
+      VLOG(1) << "Not using " << kSingleThreadedExecutor << " for function "
+              << fbody->fdef.signature().name() << ": " << s;
+      exec.reset();
+    }
+  }
+  if (exec == nullptr) {
+    TF_RETURN_IF_ERROR(NewExecutor(executor_type, params, *g, &exec));
+  }
   {
     // Guard item since it is already inserted in items_.
     mutex_lock l(mu_);
@@ -956,6 +986,21 @@ Status FunctionLibraryRuntimeImpl::CreateItem(Item** item) {
   return Status::OK();
 }
 
+bool FunctionLibraryRuntimeImpl::ShouldUseSingleThreadedExecutor(
+    const Graph& g) const {
+  // Kernels of other devices may need non-default device contexts, which the
+  // single-threaded executor does not provide.
+  if (inline_executor_max_nodes_ <= 0 || device_ == nullptr ||
+      device_->device_type() != DEVICE_CPU) {
+    return false;
+  }
+  int64 num_nodes = 0;
+  for (const Node* n : g.op_nodes()) {
+    if (!n->IsArg() && !n->IsRetval()) ++num_nodes;
+  }
+  return num_nodes <= inline_executor_max_nodes_;
+}
+
 Status FunctionLibraryRuntimeImpl::GetOrCreateItem(LocalHandle local_handle,
                                                    Item** item) {
   {
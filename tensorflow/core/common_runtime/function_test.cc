@@ -518,6 +518,25 @@ TEST_F(FunctionLibraryRuntimeTest,
   TF_CHECK_OK(flr0_->ReleaseHandle(handle));
 }
 
+TEST_F(FunctionLibraryRuntimeTest, XTimesTwo_SmallFunctionSingleThreaded) {
+  // The variable is read when the runtimes are created.
+  setenv("TF_FUNCTION_INLINE_EXECUTOR_MAX_NODES", "8", 1);
+  Init({test::function::XTimesTwo()});
+  unsetenv("TF_FUNCTION_INLINE_EXECUTOR_MAX_NODES");
+  FunctionLibraryRuntime::Handle handle;
+  TF_CHECK_OK(flr0_->Instantiate(
+      "XTimesTwo", test::function::Attrs({{"T", DT_FLOAT}}), &handle));
+
+  auto x = test::AsTensor<float>({1, 2, 3, 4});
+  Tensor y;
+  FunctionLibraryRuntime::Options opts;
+  // Without a runner, only the single-threaded executor can run the function.
+  TF_CHECK_OK(Run(flr0_, handle, opts, {x}, {&y}, /* add_runner= */ false));
+  test::ExpectTensorEqual<float>(y, test::AsTensor<float>({2, 4, 6, 8}));
+
+  TF_CHECK_OK(flr0_->ReleaseHandle(handle));
+}
+
 TEST_F(FunctionLibraryRuntimeTest, XTimesN) {
   Init({test::function::XTimesTwo(), test::function::XTimesFour(),
         test::function::XTimes16()});
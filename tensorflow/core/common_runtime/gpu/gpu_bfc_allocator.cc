@@ -73,16 +73,18 @@ bool GPUBFCAllocator::GetGarbageCollectionValue() {
   return true;
 }
 
-GPUBFCAllocator::GPUBFCAllocator(DeviceMemAllocator* sub_allocator,
+GPUBFCAllocator::GPUBFCAllocator(SubAllocator* sub_allocator,
                                  size_t total_memory, const string& name)
     : GPUBFCAllocator(sub_allocator, total_memory, GPUOptions(), name) {}
 
-GPUBFCAllocator::GPUBFCAllocator(DeviceMemAllocator* sub_allocator,
+GPUBFCAllocator::GPUBFCAllocator(SubAllocator* sub_allocator,
                                  size_t total_memory,
                                  const GPUOptions& gpu_options,
                                  const string& name)
     : BFCAllocator(sub_allocator, total_memory,
                    GPUBFCAllocator::GetAllowGrowthValue(gpu_options), name,
-                   GPUBFCAllocator::GetGarbageCollectionValue()) {}
+                   GPUBFCAllocator::GetGarbageCollectionValue(),
+                   gpu_options.experimental().small_allocation_cache_bytes()) {
+}
 
 }  // namespace tensorflow
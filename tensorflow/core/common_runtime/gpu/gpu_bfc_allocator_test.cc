@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -225,6 +226,53 @@ TEST(GPUBFCAllocatorTest, AllocatedVsRequested) {
   a.DeallocateRaw(t1);
 }
 
+TEST(GPUBFCAllocatorTest, SmallAllocationCache) {
+  PlatformGpuId platform_gpu_id(0);
+  DeviceMemAllocator* sub_allocator = new DeviceMemAllocator(
+      ExecutorForPlatformGpuId(platform_gpu_id), platform_gpu_id,
+      false /*use_unified_memory*/, {}, {});
+  GPUOptions options;
+  // Room for two 64KiB slabs.
+  options.mutable_experimental()->set_small_allocation_cache_bytes(128 << 10);
+  GPUBFCAllocator a(sub_allocator, 1 << 30, options, "GPU_0_bfc");
+
+  // 256-byte blocks of a single slab.
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 256; ++i) {
+    void* raw = a.AllocateRaw(1, 100);
+    ASSERT_NE(nullptr, raw);
+    EXPECT_EQ(256, a.RequestedSize(raw));
+    EXPECT_EQ(256, a.AllocatedSize(raw));
+    ptrs.push_back(raw);
+  }
+  // A 4KiB block of the second slab.
+  void* large_block = a.AllocateRaw(1, 4000);
+  EXPECT_EQ(4096, a.AllocatedSize(large_block));
+  ptrs.push_back(large_block);
+  // The cache is full, so this is served from the bins.
+  void* uncached = a.AllocateRaw(1, 100);
+  EXPECT_EQ(100, a.RequestedSize(uncached));
+  ptrs.push_back(uncached);
+
+  std::sort(ptrs.begin(), ptrs.end());
+  for (size_t i = 1; i < ptrs.size(); i++) {
+    ASSERT_GE(static_cast<char*>(ptrs[i]) - static_cast<char*>(ptrs[i - 1]),
+              a.AllocatedSize(ptrs[i - 1]));
+  }
+
+  // Freed blocks are reused.
+  a.DeallocateRaw(large_block);
+  EXPECT_EQ(large_block, a.AllocateRaw(1, 3000));
+
+  for (void* ptr : ptrs) {
+    a.DeallocateRaw(ptr);
+  }
+  // The slabs stay allocated.
+  absl::optional<AllocatorStats> stats = a.GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(128 << 10, stats->bytes_in_use);
+}
+
 TEST(GPUBFCAllocatorTest, TestCustomMemoryLimit) {
   PlatformGpuId platform_gpu_id(0);
   DeviceMemAllocator* sub_allocator = new DeviceMemAllocator(
@@ -241,6 +289,55 @@ TEST(GPUBFCAllocatorTest, TestCustomMemoryLimit) {
   a.DeallocateRaw(first_ptr);
 }
 
+// Hands out consecutive ranges of one host buffer, like the virtual memory
+// allocator does with its address reservation.
+class ContiguousSubAllocator : public SubAllocator {
+ public:
+  explicit ContiguousSubAllocator(size_t size)
+      : SubAllocator({}, {}),
+        buffer_(static_cast<char*>(
+            port::AlignedMalloc(size, Allocator::kAllocatorAlignment))),
+        size_(size) {}
+  ~ContiguousSubAllocator() override { port::AlignedFree(buffer_); }
+
+  void* Alloc(size_t alignment, size_t num_bytes,
+              size_t* bytes_received) override {
+    if (offset_ + num_bytes > size_) return nullptr;
+    void* ptr = buffer_ + offset_;
+    offset_ += num_bytes;
+    *bytes_received = num_bytes;
+    return ptr;
+  }
+  void Free(void* ptr, size_t num_bytes) override {}
+  bool SupportsCoalescing() const override { return true; }
+
+ private:
+  char* const buffer_;
+  const size_t size_;
+  size_t offset_ = 0;
+};
+
+TEST(GPUBFCAllocatorTest, CoalescesContiguousRegions) {
+  GPUOptions options;
+  options.set_allow_growth(true);
+  const size_t kLimit = 3 << 20;
+  GPUBFCAllocator a(new ContiguousSubAllocator(kLimit), kLimit, options,
+                    "GPU_0_bfc");
+
+  // Grows from a first region of 1MiB to a second one of 2MiB.
+  void* first_ptr = a.AllocateRaw(1, 768 << 10);
+  void* second_ptr = a.AllocateRaw(1, 1 << 20);
+  ASSERT_NE(nullptr, first_ptr);
+  ASSERT_NE(nullptr, second_ptr);
+  a.DeallocateRaw(first_ptr);
+  a.DeallocateRaw(second_ptr);
+
+  // Only fits if both regions were merged into one free chunk.
+  void* all_ptr = a.AllocateRaw(1, kLimit);
+  EXPECT_NE(nullptr, all_ptr);
+  a.DeallocateRaw(all_ptr);
+}
+
 TEST(GPUBFCAllocatorTest, AllocationsAndDeallocationsWithGrowth) {
   GPUOptions options;
   options.set_allow_growth(true);
@@ -385,6 +482,56 @@ static void BM_AllocationThreaded(int iters, int num_threads) {
 }
 BENCHMARK(BM_AllocationThreaded)->Arg(1)->Arg(4)->Arg(16);
 
+static void BM_SmallAllocationThreaded(int iters, int num_threads,
+                                       int64 small_allocation_cache_bytes) {
+  PlatformGpuId platform_gpu_id(0);
+  DeviceMemAllocator* sub_allocator = new DeviceMemAllocator(
+      ExecutorForPlatformGpuId(platform_gpu_id), platform_gpu_id,
+      false /*use_unified_memory*/, {}, {});
+  GPUOptions options;
+  options.mutable_experimental()->set_small_allocation_cache_bytes(
+      small_allocation_cache_bytes);
+  GPUBFCAllocator a(sub_allocator, 1uLL << 33, options, "GPU_0_bfc");
+  thread::ThreadPool pool(Env::Default(), "test", num_threads);
+  std::atomic_int_fast32_t count(iters);
+  mutex done_lock;
+  condition_variable done;
+  bool done_flag = false;
+
+  for (int t = 0; t < num_threads; t++) {
+    pool.Schedule([&a, &count, &done_lock, &done, &done_flag, iters]() {
+      // Scalars and shape tensors.
+      std::vector<int> sizes = {4, 8, 16, 64, 256, 1024, 4096};
+      int size_index = 0;
+      for (int i = 0; i < iters; i++) {
+        int bytes = sizes[size_index++ % sizes.size()];
+        void* p = a.AllocateRaw(1, bytes);
+        a.DeallocateRaw(p);
+        if (count.fetch_sub(1) == 1) {
+          mutex_lock l(done_lock);
+          done_flag = true;
+          done.notify_all();
+          break;
+        }
+      }
+    });
+  }
+  mutex_lock l(done_lock);
+  if (!done_flag) {
+    done.wait(l);
+  }
+}
+
+static void BM_SmallAllocationThreadedNoCache(int iters, int num_threads) {
+  BM_SmallAllocationThreaded(iters, num_threads, 0);
+}
+BENCHMARK(BM_SmallAllocationThreadedNoCache)->Arg(1)->Arg(4)->Arg(16);
+
+static void BM_SmallAllocationThreadedCache(int iters, int num_threads) {
+  BM_SmallAllocationThreaded(iters, num_threads, 16 << 20);
+}
+BENCHMARK(BM_SmallAllocationThreadedCache)->Arg(1)->Arg(4)->Arg(16);
+
 // A more complex benchmark that defers deallocation of an object for
 // "delay" allocations.
 static void BM_AllocationDelayed(int iters, int delay) {
@@ -0,0 +1,153 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/gpu/gpu_cudamallocasync_allocator.h"
+
+#include <algorithm>
+
+#ifdef GOOGLE_CUDA
+#include "tensorflow/stream_executor/cuda/cuda_activation.h"
+#endif  // GOOGLE_CUDA
+
+#include "tensorflow/core/common_runtime/device/device_id_utils.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_init.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+GpuCudaMallocAsyncAllocator::GpuCudaMallocAsyncAllocator(
+    PlatformGpuId platform_gpu_id, size_t total_bytes, const string& name)
+    : name_(name) {
+  stream_exec_ = DeviceIdUtil::ExecutorForPlatformDeviceId(GPUMachineManager(),
+                                                           platform_gpu_id)
+                     .ValueOrDie();
+  stats_.bytes_limit = static_cast<int64>(total_bytes);
+#if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  se::cuda::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+  int supported = 0;
+  CUdevice device;
+  if (cuDeviceGet(&device, platform_gpu_id.value()) != CUDA_SUCCESS ||
+      cuDeviceGetAttribute(&supported,
+                           CU_DEVICE_ATTRIBUTE_MEMORY_POOLS_SUPPORTED,
+                           device) != CUDA_SUCCESS ||
+      !supported) {
+    LOG(ERROR) << "GPU " << platform_gpu_id.value()
+               << " does not support memory pools.";
+    return;
+  }
+  if (cuDeviceGetDefaultMemPool(&pool_, device) != CUDA_SUCCESS) {
+    LOG(ERROR) << "Failed to get the memory pool of GPU "
+               << platform_gpu_id.value();
+    pool_ = nullptr;
+    return;
+  }
+  // Keep freed memory in the pool instead of releasing it at each
+  // synchronization.
+  cuuint64_t release_threshold = total_bytes;
+  if (cuMemPoolSetAttribute(pool_, CU_MEMPOOL_ATTR_RELEASE_THRESHOLD,
+                            &release_threshold) != CUDA_SUCCESS) {
+    LOG(WARNING) << "Failed to set the release threshold of the memory pool "
+                    "of GPU "
+                 << platform_gpu_id.value();
+  }
+#else
+  LOG(ERROR) << "GpuCudaMallocAsyncAllocator requires CUDA 11.2 or later.";
+#endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
+}
+
+void* GpuCudaMallocAsyncAllocator::AllocateRaw(size_t alignment,
+                                               size_t num_bytes) {
+#if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  if (pool_ == nullptr) return nullptr;
+  mutex_lock l(mu_);
+  if (stats_.bytes_in_use + static_cast<int64>(num_bytes) >
+      *stats_.bytes_limit) {
+    LOG(WARNING) << name_ << " ran out of memory trying to allocate "
+                 << num_bytes << " bytes, with " << stats_.bytes_in_use
+                 << " bytes in use out of " << *stats_.bytes_limit;
+    return nullptr;
+  }
+  se::cuda::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+  CUdeviceptr ptr = 0;
+  // The pool only hands out allocations aligned to at least 256 bytes.
+  if (cuMemAllocFromPoolAsync(&ptr, num_bytes, pool_, cuda_stream_) !=
+      CUDA_SUCCESS) {
+    LOG(ERROR) << "cuMemAllocFromPoolAsync failed to allocate " << num_bytes;
+    return nullptr;
+  }
+  void* rv = reinterpret_cast<void*>(ptr);
+  size_map_[rv] = num_bytes;
+  ++stats_.num_allocs;
+  stats_.bytes_in_use += num_bytes;
+  stats_.peak_bytes_in_use =
+      std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  stats_.largest_alloc_size =
+      std::max<int64>(stats_.largest_alloc_size, num_bytes);
+  return rv;
+#else
+  return nullptr;
+#endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
+}
+
+void GpuCudaMallocAsyncAllocator::DeallocateRaw(void* ptr) {
+#if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  if (ptr == nullptr) return;
+  mutex_lock l(mu_);
+  se::cuda::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+  if (cuMemFreeAsync(reinterpret_cast<CUdeviceptr>(ptr), cuda_stream_) !=
+      CUDA_SUCCESS) {
+    LOG(ERROR) << "cuMemFreeAsync failed to free " << ptr;
+  }
+  auto it = size_map_.find(ptr);
+  DCHECK(it != size_map_.end());
+  if (it != size_map_.end()) {
+    stats_.bytes_in_use -= it->second;
+    size_map_.erase(it);
+  }
+#endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
+}
+
+size_t GpuCudaMallocAsyncAllocator::RequestedSize(const void* ptr) const {
+  tf_shared_lock l(mu_);
+  auto it = size_map_.find(ptr);
+  CHECK(it != size_map_.end()) << "Unknown pointer " << ptr;
+  return it->second;
+}
+
+size_t GpuCudaMallocAsyncAllocator::AllocatedSize(const void* ptr) const {
+  return RequestedSize(ptr);
+}
+
+absl::optional<AllocatorStats> GpuCudaMallocAsyncAllocator::GetStats() {
+  tf_shared_lock l(mu_);
+  return stats_;
+}
+
+void GpuCudaMallocAsyncAllocator::ClearStats() {
+  mutex_lock l(mu_);
+  stats_.num_allocs = 0;
+  stats_.peak_bytes_in_use = stats_.bytes_in_use;
+  stats_.largest_alloc_size = 0;
+}
+
+void GpuCudaMallocAsyncAllocator::SetStream(se::Stream* stream) {
+#if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  mutex_lock l(mu_);
+  cuda_stream_ = *reinterpret_cast<CUstream*>(
+      stream->implementation()->GpuStreamMemberHack());
+#endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
+}
+
+}  // namespace tensorflow
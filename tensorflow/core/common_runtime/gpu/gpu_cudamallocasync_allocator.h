@@ -0,0 +1,91 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_CUDAMALLOCASYNC_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_CUDAMALLOCASYNC_ALLOCATOR_H_
+
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_id.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+#ifdef GOOGLE_CUDA
+#include "third_party/gpus/cuda/include/cuda.h"
+
+#if CUDA_VERSION >= 11020
+#define TF_CUDA_MALLOC_ASYNC_SUPPORTED 1
+#endif
+#endif  // GOOGLE_CUDA
+
+namespace tensorflow {
+
+// An allocator that allocates in stream order from the memory pool the CUDA
+// driver keeps for the GPU (cuMemAllocFromPoolAsync, CUDA 11.2 and later).
+//
+// Allocations and frees are enqueued on the stream set by SetStream(), so
+// memory freed by the host can be reused right away by the next allocation
+// on that stream, without waiting for the kernels still using it. Other
+// streams only reuse it once the driver knows the free has happened, which
+// also lets the allocators of all virtual devices of a GPU share its memory.
+//
+// AllocateRaw() returns nullptr when not built with CUDA 11.2 or later, or when
+// the driver does not support memory pools.
+class GpuCudaMallocAsyncAllocator : public Allocator {
+ public:
+  // At most `total_bytes` bytes are allocated at a time. The pool keeps up to
+  // that much memory cached after frees instead of returning it to the driver.
+  GpuCudaMallocAsyncAllocator(PlatformGpuId platform_gpu_id, size_t total_bytes,
+                              const string& name);
+  ~GpuCudaMallocAsyncAllocator() override {}
+
+  string Name() override { return name_; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+  bool TracksAllocationSizes() const override { return true; }
+  size_t RequestedSize(const void* ptr) const override;
+  size_t AllocatedSize(const void* ptr) const override;
+  absl::optional<AllocatorStats> GetStats() override;
+  void ClearStats() override;
+
+  // Sets the stream that allocations and frees are ordered on. Until it is
+  // called, the legacy default stream is used, which synchronizes with all
+  // other streams.
+  void SetStream(se::Stream* stream);
+
+ private:
+  se::StreamExecutor* stream_exec_;  // Not owned.
+  const string name_;
+
+#if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  CUmemoryPool pool_ = nullptr;
+  CUstream cuda_stream_ TF_GUARDED_BY(mu_) = nullptr;
+#endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
+
+  mutable mutex mu_;
+  AllocatorStats stats_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<const void*, size_t> size_map_ TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(GpuCudaMallocAsyncAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_CUDAMALLOCASYNC_ALLOCATOR_H_
@@ -0,0 +1,68 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/gpu/gpu_cudamallocasync_allocator.h"
+
+#if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+
+#include "tensorflow/core/common_runtime/device/device_id_utils.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_id.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_init.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(GpuCudaMallocAsyncAllocatorTest, AllocatesInStreamOrder) {
+  const PlatformGpuId platform_gpu_id(0);
+  se::StreamExecutor* stream_exec =
+      DeviceIdUtil::ExecutorForPlatformDeviceId(GPUMachineManager(),
+                                                platform_gpu_id)
+          .ValueOrDie();
+  se::Stream stream(stream_exec);
+  stream.Init();
+  GpuCudaMallocAsyncAllocator a(platform_gpu_id, 1 << 30, "GPU_0_test");
+  a.SetStream(&stream);
+
+  const size_t num_bytes = 1 << 20;
+  void* ptr = a.AllocateRaw(Allocator::kAllocatorAlignment, num_bytes);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % Allocator::kAllocatorAlignment,
+            0);
+  EXPECT_EQ(a.RequestedSize(ptr), num_bytes);
+  EXPECT_EQ(a.GetStats()->bytes_in_use, num_bytes);
+
+  se::DeviceMemoryBase mem(ptr, num_bytes);
+  stream.ThenMemZero(&mem, num_bytes);
+  a.DeallocateRaw(ptr);
+  EXPECT_EQ(a.GetStats()->bytes_in_use, 0);
+  EXPECT_EQ(a.GetStats()->peak_bytes_in_use, num_bytes);
+  TF_ASSERT_OK(stream.BlockHostUntilDone());
+}
+
+TEST(GpuCudaMallocAsyncAllocatorTest, EnforcesMemoryLimit) {
+  const PlatformGpuId platform_gpu_id(0);
+  GpuCudaMallocAsyncAllocator a(platform_gpu_id, 1 << 20, "GPU_0_test");
+  void* ptr = a.AllocateRaw(Allocator::kAllocatorAlignment, 1 << 20);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(a.AllocateRaw(Allocator::kAllocatorAlignment, 1), nullptr);
+  a.DeallocateRaw(ptr);
+}
+
+}  // namespace
+}  // namespace tensorflow
+
+#endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
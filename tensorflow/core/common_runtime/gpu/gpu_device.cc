@@ -37,11 +37,14 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device/device_event_mgr.h"
 #include "tensorflow/core/common_runtime/device/device_id_utils.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_cudamallocasync_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_device.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id_manager.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_init.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_stream_ordered_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_util.h"
 #include "tensorflow/core/common_runtime/gpu_device_context.h"
 #include "tensorflow/core/common_runtime/local_device.h"
@@ -229,7 +232,8 @@ class EigenGpuStreamDevice : public ::Eigen::StreamInterface {
 // the same physical device and stream group id use the same stream group
 // object (and therefore the same CUDA streams). This is necessary since there
 // is a single memory allocator per device (see ProcessState::GetGPUAllocator)
-// and allocators must not be shared across streams.
+// and allocators must not be shared across streams (unless frees are stream
+// ordered, see GPUStreamOrderedAllocator).
 class BaseGPUDevice::StreamGroupFactory {
  public:
   // Returns the unique stream group for use with the stream defined by
@@ -393,6 +397,28 @@ BaseGPUDevice::BaseGPUDevice(const SessionOptions& options, const string& name,
   GPUProcessState::singleton()->EnableGPUDevice();
 }
 
+namespace {
+
+// Returns an allocator that frees into `base_allocator` in the order of
+// `stream`. Like the streams, these allocators are never destroyed, since
+// tensors allocated by a device may outlive it.
+Allocator* GetStreamOrderedAllocator(Allocator* base_allocator,
+                                     se::Stream* stream, EventMgr* em) {
+  static mutex* mu = new mutex;
+  static auto* allocators =
+      new std::map<std::pair<Allocator*, se::Stream*>,
+                   std::unique_ptr<GPUStreamOrderedAllocator>>;
+  mutex_lock l(*mu);
+  std::unique_ptr<GPUStreamOrderedAllocator>& allocator =
+      (*allocators)[std::make_pair(base_allocator, stream)];
+  if (allocator == nullptr) {
+    allocator.reset(new GPUStreamOrderedAllocator(base_allocator, stream, em));
+  }
+  return allocator.get();
+}
+
+}  // namespace
+
 BaseGPUDevice::~BaseGPUDevice() {
   delete gpu_device_info_;
   gpu_allocator_->DeallocateRaw(scratch_);
@@ -444,12 +470,28 @@ Status BaseGPUDevice::Init(const SessionOptions& options) {
   em_ = EventMgrFactory::Singleton()->GetEventMgr(executor_,
                                                   options.config.gpu_options());
 
+  if (auto* cuda_malloc_async_allocator =
+          dynamic_cast<GpuCudaMallocAsyncAllocator*>(gpu_allocator_)) {
+    // Frees are enqueued behind the kernels of the compute stream.
+    cuda_malloc_async_allocator->SetStream(stream_->compute);
+  } else if (GPUProcessState::singleton()->VirtualDevicesShareMemory(
+                 options.config.gpu_options())) {
+    // The other virtual devices of this GPU allocate from the same allocator
+    // on their own streams.
+    gpu_allocator_ =
+        GetStreamOrderedAllocator(gpu_allocator_, stream_->compute, em_);
+  }
+
   GPUKernelTracker::Params tracker_params(
       options.config.gpu_options().experimental().kernel_tracker_max_interval(),
       options.config.gpu_options().experimental().kernel_tracker_max_bytes(),
       options.config.gpu_options().experimental().kernel_tracker_max_pending());
   timestamped_allocator_ =
       options.config.gpu_options().experimental().timestamped_allocator();
+  prefetch_unified_memory_ =
+      options.config.gpu_options().experimental().prefetch_unified_memory() &&
+      (options.config.gpu_options().per_process_gpu_memory_fraction() > 1.0 ||
+       options.config.gpu_options().experimental().use_unified_memory());
   pending_cap_ = tracker_params.max_pending;
   if (timestamped_allocator_ ||
       (tracker_params.max_interval > 0 || tracker_params.max_bytes > 0 ||
@@ -564,6 +606,9 @@ void BaseGPUDevice::Compute(OpKernel* op_kernel, OpKernelContext* context) {
     }
   }
   ScopedActivateExecutorContext scoped_activation{stream->parent()};
+  if (prefetch_unified_memory_) {
+    PrefetchInputs(context, stream);
+  }
   ScopedMemoryDebugAnnotation op_annotation(op_kernel->name_view().data(),
                                             context->step_id());
   op_kernel->Compute(context);
@@ -600,6 +645,38 @@ void BaseGPUDevice::Compute(OpKernel* op_kernel, OpKernelContext* context) {
   }
 }
 
+void BaseGPUDevice::PrefetchInputs(OpKernelContext* context,
+                                   se::Stream* stream) {
+#if GOOGLE_CUDA
+  // Ops are scheduled well ahead of the GPU, so the migration enqueued here
+  // overlaps with the kernels still queued in front of this op, and the op
+  // itself does not fault its inputs in page by page.
+  gpuStream_t gpu_stream = *reinterpret_cast<gpuStream_t*>(
+      stream->implementation()->GpuStreamMemberHack());
+  const int device = executor_->device_ordinal();
+  for (int i = 0; i < context->num_inputs(); ++i) {
+    if (context->input_memory_type(i) != DEVICE_MEMORY) continue;
+    const Tensor input = context->input_is_ref(i)
+                             ? context->mutable_input(i, /*lock_held=*/false)
+                             : context->input(i);
+    if (!input.IsInitialized() || !DMAHelper::CanUseDMA(&input) ||
+        input.TotalBytes() == 0) {
+      continue;
+    }
+    cudaError_t err =
+        cudaMemPrefetchAsync(DMAHelper::base(&input), input.TotalBytes(),
+                             device, gpu_stream);
+    if (err != cudaSuccess) {
+      // Clear the error so that it is not reported by the next kernel launch.
+      cudaGetLastError();
+      LOG_FIRST_N(WARNING, 1) << "cudaMemPrefetchAsync failed for input " << i
+                              << " of " << context->op_kernel().name() << ": "
+                              << cudaGetErrorString(err);
+    }
+  }
+#endif  // GOOGLE_CUDA
+}
+
 Status BaseGPUDevice::Sync() {
   DCHECK_NE(stream_, nullptr);
 
@@ -628,6 +705,9 @@ void BaseGPUDevice::ComputeAsync(AsyncOpKernel* op_kernel,
           << stream_id << "]";
 
   ScopedActivateExecutorContext scoped_activation{stream->parent()};
+  if (prefetch_unified_memory_) {
+    PrefetchInputs(context, stream);
+  }
   op_kernel->ComputeAsync(context, std::move(done));
 }
 
@@ -683,6 +763,39 @@ Status BaseGPUDevice::MaybeCopyTensorToGPU(
   }
 }
 
+#if GOOGLE_CUDA
+namespace {
+
+// Unified memory is migrated in pages of up to this many bytes.
+constexpr uintptr_t kUnifiedMemoryPageSize = 64 << 10;
+
+// Advises the driver that the unified memory pages of `tensor` are read-mostly,
+// so that they are duplicated on the GPU instead of moved, and a copy evicted
+// under oversubscription does not need to be written back. Only the pages that
+// lie entirely within the tensor are advised, since neighbouring allocations
+// may be written. The advice outlives the tensor; constants are expected to
+// live as long as the graph.
+void AdviseReadMostly(const Tensor& tensor, int device) {
+  if (!DMAHelper::CanUseDMA(&tensor)) return;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(DMAHelper::base(&tensor));
+  const uintptr_t end = begin + tensor.TotalBytes();
+  const uintptr_t page_begin = (begin + kUnifiedMemoryPageSize - 1) &
+                               ~(kUnifiedMemoryPageSize - 1);
+  const uintptr_t page_end = end & ~(kUnifiedMemoryPageSize - 1);
+  if (page_end <= page_begin) return;
+  cudaError_t err =
+      cudaMemAdvise(reinterpret_cast<void*>(page_begin), page_end - page_begin,
+                    cudaMemAdviseSetReadMostly, device);
+  if (err != cudaSuccess) {
+    cudaGetLastError();
+    LOG_FIRST_N(WARNING, 1) << "cudaMemAdvise failed: "
+                            << cudaGetErrorString(err);
+  }
+}
+
+}  // namespace
+#endif  // GOOGLE_CUDA
+
 Status BaseGPUDevice::MakeTensorFromProto(const TensorProto& tensor_proto,
                                           const AllocatorAttributes alloc_attrs,
                                           Tensor* tensor) {
@@ -745,6 +858,11 @@ Status BaseGPUDevice::MakeTensorFromProto(const TensorProto& tensor_proto,
                                               n.Notify();
                                             }));
     n.WaitForNotification();
+#if GOOGLE_CUDA
+    if (status.ok() && prefetch_unified_memory_ && !alloc_attrs.on_host()) {
+      AdviseReadMostly(*tensor, executor_->device_ordinal());
+    }
+#endif  // GOOGLE_CUDA
     return status;
   }
 }
@@ -1332,6 +1450,7 @@ Status BaseGPUDeviceFactory::CreateDevices(
   }
   int next_tf_gpu_id = 0;
   std::vector<int64> memory_limit_bytes;
+  std::map<int, int64> platform_gpu_memory_limit_bytes;
   for (int i = 0; i < num_gpus_to_use; ++i) {
     const PlatformGpuId platform_gpu_id = valid_platform_gpu_ids[i];
     if (virtual_devices.empty() ||
@@ -1349,6 +1468,8 @@ Status BaseGPUDeviceFactory::CreateDevices(
     }
     while (next_tf_gpu_id < memory_limit_bytes.size()) {
       TfGpuId tf_gpu_id(next_tf_gpu_id);
+      platform_gpu_memory_limit_bytes[platform_gpu_id.value()] +=
+          memory_limit_bytes[next_tf_gpu_id];
       ++next_tf_gpu_id;
       TF_RETURN_IF_ERROR(
           GpuIdManager::InsertTfPlatformGpuIdPair(tf_gpu_id, platform_gpu_id));
@@ -1356,6 +1477,18 @@ Status BaseGPUDeviceFactory::CreateDevices(
   }
   const int num_tf_gpus = next_tf_gpu_id;
 
+  if (GPUProcessState::singleton()->VirtualDevicesShareMemory(gpu_options)) {
+    // The allocator shared by the virtual devices of a GPU gets the memory of
+    // all of them.
+    for (int di = 0; di < num_tf_gpus; ++di) {
+      PlatformGpuId platform_gpu_id;
+      TF_RETURN_IF_ERROR(
+          GpuIdManager::TfToPlatformGpuId(TfGpuId(di), &platform_gpu_id));
+      memory_limit_bytes[di] =
+          platform_gpu_memory_limit_bytes[platform_gpu_id.value()];
+    }
+  }
+
   LocalityMap device_localities;
   TF_RETURN_IF_ERROR(
       GetDeviceLocalities(num_tf_gpus, interconnect_maps, &device_localities));
@@ -17,6 +17,9 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_device.h"
 
+#if GOOGLE_CUDA
+#include "third_party/gpus/cuda/include/cuda_runtime_api.h"
+#endif  // GOOGLE_CUDA
 #include "tensorflow/core/common_runtime/device/device_id_utils.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_init.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
@@ -404,6 +407,63 @@ TEST_F(GPUDeviceTest, UnifiedMemoryAllocation) {
   allocator->DeallocateRaw(ptr);
 }
 
+#if GOOGLE_CUDA
+// With prefetch_unified_memory, constants are advised read-mostly and still
+// hold their values.
+TEST_F(GPUDeviceTest, UnifiedMemoryPrefetchAdvisesConstantsReadMostly) {
+  int cc_major, cc_minor;
+  TF_ASSERT_OK(GetComputeCapability(PlatformGpuId(0), &cc_major, &cc_minor));
+  if (cc_major < 6) {
+    LOG(INFO)
+        << "Unified memory allocation is not supported with pre-Pascal GPUs.";
+    return;
+  }
+
+  SessionOptions opts = MakeSessionOptions("0", /*memory_fraction=*/1.2);
+  opts.config.mutable_gpu_options()
+      ->mutable_experimental()
+      ->set_prefetch_unified_memory(true);
+  std::vector<std::unique_ptr<Device>> devices;
+  TF_ASSERT_OK(DeviceFactory::GetFactory("GPU")->CreateDevices(
+      opts, kDeviceNamePrefix, &devices));
+  Device* device = devices[0].get();
+
+  constexpr int kNumElements = 1 << 18;
+  Tensor cpu_tensor(cpu_allocator(), DT_FLOAT, TensorShape({kNumElements}));
+  auto values = cpu_tensor.flat<float>();
+  for (int i = 0; i < kNumElements; ++i) {
+    values(i) = i;
+  }
+  TensorProto proto;
+  cpu_tensor.AsProtoTensorContent(&proto);
+  Tensor gpu_tensor;
+  TF_ASSERT_OK(
+      device->MakeTensorFromProto(proto, AllocatorAttributes(), &gpu_tensor));
+
+  // The first 64KiB page that lies entirely within the tensor.
+  constexpr uintptr_t kPageSize = 64 << 10;
+  const uintptr_t page =
+      (reinterpret_cast<uintptr_t>(gpu_tensor.tensor_data().data()) +
+       kPageSize - 1) &
+      ~(kPageSize - 1);
+  int read_mostly = 0;
+  ASSERT_EQ(cudaSuccess, cudaMemRangeGetAttribute(
+                             &read_mostly, sizeof(read_mostly),
+                             cudaMemRangeAttributeReadMostly,
+                             reinterpret_cast<void*>(page), kPageSize));
+  EXPECT_EQ(1, read_mostly);
+
+  Tensor output_cpu_tensor(cpu_allocator(), DT_FLOAT,
+                           TensorShape({kNumElements}));
+  CopyGPUToCPU(&gpu_tensor, &output_cpu_tensor, device,
+               device->tensorflow_gpu_device_info()->default_context);
+  auto output = output_cpu_tensor.flat<float>();
+  for (int i = 0; i < kNumElements; ++i) {
+    ASSERT_EQ(values(i), output(i)) << " for index " << i;
+  }
+}
+#endif  // GOOGLE_CUDA
+
 TEST_F(GPUDeviceTest, CopyTensorInSameDevice) {
   SessionOptions opts = MakeSessionOptions("0");
   std::vector<std::unique_ptr<Device>> devices;
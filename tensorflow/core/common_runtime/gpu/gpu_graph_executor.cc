@@ -0,0 +1,551 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Registers the "GPU_GRAPH" executor, which records the GPU work of a function
+// body into a CUDA graph and replays it on later calls, so that the kernels of
+// launch-bound functions are launched with one driver call instead of one per
+// op.
+//
+// A function body is only recorded if all its nodes are placed on one GPU and
+// are of an op type known to only enqueue work onto the GPU stream: no host
+// synchronization, no data-dependent output shapes and no state. All other
+// graphs run exactly like with the default executor. For an eligible body:
+//
+//  * The first call with a given set of arguments runs normally, which also
+//    performs lazy initialization (autotuning, cuBLAS handles...) that is
+//    illegal while recording.
+//  * The second call with the same argument shapes, buffers and host-memory
+//    argument values runs the body while recording the compute stream into a
+//    graph, and then launches the graph. All the memory allocated while
+//    recording stays reserved for the graph until it is discarded.
+//  * Later calls with the same arguments launch the graph and return the same
+//    output buffers, unless the caller still holds the outputs of an earlier
+//    call, in which case the body runs normally.
+//  * A call with different arguments discards the graph and starts over.
+//
+// Nothing else may enqueue work onto the GPU's compute stream while a body is
+// being recorded, since that work would be recorded as well. Only CUDA 10 and
+// newer support graphs; with other versions every body runs normally.
+
+#if GOOGLE_CUDA
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/stream_executor/gpu/gpu_graph.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr char kGpuGraphExecutor[] = "GPU_GRAPH";
+
+// Returns whether the GPU kernel of `node` only enqueues work onto the compute
+// stream, given the same inputs.
+bool IsRecordable(const Node* node) {
+  static const auto* const kRecordableOps = new absl::flat_hash_set<string>({
+      // clang-format off
+      "_Arg", "_DeviceArg", "_Retval", "_DeviceRetval", "Const", "Identity",
+      "NoOp",
+      // Element-wise math.
+      "Abs", "Add", "AddN", "AddV2", "BiasAdd", "Cast", "Elu", "Erf", "Exp",
+      "Floor", "LeakyRelu", "Log", "Log1p", "Maximum", "Minimum", "Mul",
+      "Neg", "RealDiv", "Reciprocal", "Relu", "Relu6", "Rsqrt", "Select",
+      "SelectV2", "Selu", "Sigmoid", "Sign", "Softplus", "Sqrt", "Square",
+      "SquaredDifference", "Sub", "Tanh",
+      // Linear algebra, normalization and reductions.
+      "BatchMatMul", "BatchMatMulV2", "LogSoftmax", "MatMul", "Max", "Mean",
+      "Min", "Prod", "Softmax", "Sum",
+      // Shapes and layouts, computed from static shapes.
+      "ConcatV2", "ExpandDims", "Fill", "GatherV2", "OnesLike", "Pack",
+      "Reshape", "Slice", "Split", "SplitV", "Squeeze", "StridedSlice", "Tile",
+      "Transpose", "Unpack", "ZerosLike",
+      // clang-format on
+  });
+  return kRecordableOps->contains(node->type_string());
+}
+
+// Forwards to another allocator and, while retaining, keeps the memory of the
+// allocations it serves out of the other allocator until they are released,
+// even once their owners free them.
+class RetainingAllocator : public Allocator {
+ public:
+  explicit RetainingAllocator(Allocator* base) : base_(base) {}
+
+  string Name() override { return base_->Name(); }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    return Retain(base_->AllocateRaw(alignment, num_bytes));
+  }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override {
+    return Retain(base_->AllocateRaw(alignment, num_bytes, allocation_attr));
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    if (has_retained_.load(std::memory_order_acquire)) {
+      mutex_lock l(mu_);
+      auto it = retained_.find(ptr);
+      if (it != retained_.end()) {
+        it->second = true;
+        return;
+      }
+    }
+    base_->DeallocateRaw(ptr);
+  }
+
+  bool TracksAllocationSizes() const override {
+    return base_->TracksAllocationSizes();
+  }
+
+  size_t RequestedSize(const void* ptr) const override {
+    return base_->RequestedSize(ptr);
+  }
+
+  size_t AllocatedSize(const void* ptr) const override {
+    return base_->AllocatedSize(ptr);
+  }
+
+  int64 AllocationId(const void* ptr) const override {
+    return base_->AllocationId(ptr);
+  }
+
+  absl::optional<AllocatorStats> GetStats() override {
+    return base_->GetStats();
+  }
+
+  void set_retaining(bool retaining) { retaining_.store(retaining); }
+
+  // Frees the retained allocations whose owners are done with them, and stops
+  // retaining the others.
+  void Release() {
+    std::vector<void*> to_free;
+    {
+      mutex_lock l(mu_);
+      for (const auto& it : retained_) {
+        if (it.second) to_free.push_back(it.first);
+      }
+      retained_.clear();
+      has_retained_.store(false, std::memory_order_release);
+    }
+    for (void* ptr : to_free) {
+      base_->DeallocateRaw(ptr);
+    }
+  }
+
+ private:
+  void* Retain(void* ptr) {
+    if (ptr != nullptr && retaining_.load()) {
+      mutex_lock l(mu_);
+      retained_[ptr] = false;
+      has_retained_.store(true, std::memory_order_release);
+    }
+    return ptr;
+  }
+
+  Allocator* const base_;  // Not owned.
+  std::atomic<bool> retaining_{false};
+  // Lets frees skip the lock while nothing is retained.
+  std::atomic<bool> has_retained_{false};
+  mutex mu_;
+  // Whether each retained allocation has been freed by its owner.
+  absl::flat_hash_map<void*, bool> retained_ TF_GUARDED_BY(mu_);
+};
+
+// Wraps a GPU device, delegating work to it, so that the allocators it hands
+// out can retain the memory used while recording.
+class RetainingDevice : public Device {
+ public:
+  explicit RetainingDevice(Device* underlying)
+      : Device(underlying->env(), underlying->attributes()),
+        underlying_device_(underlying) {}
+
+  // Turns retaining on or off for all the allocators handed out.
+  void SetRetaining(bool retaining) {
+    mutex_lock l(mu_);
+    retaining_ = retaining;
+    for (auto& it : allocators_) {
+      it.second->set_retaining(retaining);
+    }
+  }
+
+  void Release() {
+    mutex_lock l(mu_);
+    for (auto& it : allocators_) {
+      it.second->Release();
+    }
+  }
+
+  const DeviceBase* UnderlyingDevice() const override {
+    return underlying_device_->UnderlyingDevice();
+  }
+  DeviceBase* UnderlyingDevice() override {
+    return underlying_device_->UnderlyingDevice();
+  }
+
+  const CpuWorkerThreads* tensorflow_cpu_worker_threads() const override {
+    return underlying_device_->tensorflow_cpu_worker_threads();
+  }
+
+  const GpuDeviceInfo* tensorflow_gpu_device_info() const override {
+    return underlying_device_->tensorflow_gpu_device_info();
+  }
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    Allocator* base = underlying_device_->GetAllocator(attr);
+    {
+      tf_shared_lock l(mu_);
+      auto it = allocators_.find(base);
+      if (it != allocators_.end()) return it->second.get();
+    }
+    mutex_lock l(mu_);
+    std::unique_ptr<RetainingAllocator>& allocator = allocators_[base];
+    if (allocator == nullptr) {
+      allocator = absl::make_unique<RetainingAllocator>(base);
+      allocator->set_retaining(retaining_);
+    }
+    return allocator.get();
+  }
+
+  const Eigen::ThreadPoolDevice* eigen_cpu_device() override {
+    return underlying_device_->eigen_cpu_device();
+  }
+
+  thread::ThreadPool* tensorflow_device_thread_pool() override {
+    return underlying_device_->tensorflow_device_thread_pool();
+  }
+
+  bool has_eigen_cpu_device() const override {
+    return underlying_device_->has_eigen_cpu_device();
+  }
+
+  PerOpGpuDevice* MakeGpuDevice() override {
+    return underlying_device_->MakeGpuDevice();
+  }
+
+  Status ReinitializeGpuDevice(OpKernelContext* context, PerOpGpuDevice* device,
+                               DeviceContext* dc,
+                               Allocator* allocator) override {
+    return underlying_device_->ReinitializeGpuDevice(context, device, dc,
+                                                     allocator);
+  }
+
+  Status MakeTensorFromProto(const TensorProto& tensor_proto,
+                             const AllocatorAttributes alloc_attrs,
+                             Tensor* tensor) override {
+    return underlying_device_->MakeTensorFromProto(tensor_proto, alloc_attrs,
+                                                   tensor);
+  }
+
+  void CopyTensorInSameDevice(const Tensor* input_tensor, Tensor* output_tensor,
+                              const DeviceContext* device_context,
+                              StatusCallback done) override {
+    underlying_device_->CopyTensorInSameDevice(input_tensor, output_tensor,
+                                               device_context, std::move(done));
+  }
+
+  void Compute(OpKernel* op_kernel, OpKernelContext* context) override {
+    underlying_device_->Compute(op_kernel, context);
+  }
+
+  void ComputeAsync(AsyncOpKernel* op_kernel, OpKernelContext* context,
+                    AsyncOpKernel::DoneCallback done) override {
+    underlying_device_->ComputeAsync(op_kernel, context, std::move(done));
+  }
+
+  Status Sync() override { return underlying_device_->Sync(); }
+
+  bool AllowsSyncOnCompletion() const override {
+    return underlying_device_->AllowsSyncOnCompletion();
+  }
+
+  Status RefreshStatus() override {
+    return underlying_device_->RefreshStatus();
+  }
+
+  Status MaybeRewriteGraph(std::unique_ptr<Graph>* graph) override {
+    return underlying_device_->MaybeRewriteGraph(graph);
+  }
+
+  Status TryGetDeviceContext(DeviceContext** out_context) override {
+    return underlying_device_->TryGetDeviceContext(out_context);
+  }
+
+  ResourceMgr* resource_manager() override {
+    return underlying_device_->resource_manager();
+  }
+
+  bool IsLocal() const override { return underlying_device_->IsLocal(); }
+
+  bool IsRemoteCallAllowed() const override {
+    return underlying_device_->IsRemoteCallAllowed();
+  }
+
+ private:
+  Device* const underlying_device_;  // Not owned.
+
+  mutex mu_;
+  bool retaining_ TF_GUARDED_BY(mu_) = false;
+  // Wraps each allocator of the underlying device.
+  absl::flat_hash_map<Allocator*, std::unique_ptr<RetainingAllocator>>
+      allocators_ TF_GUARDED_BY(mu_);
+};
+
+// Forwards the arguments of another call frame, and keeps the return values
+// instead of forwarding them.
+class RecordingCallFrame : public CallFrameInterface {
+ public:
+  explicit RecordingCallFrame(CallFrameInterface* call_frame)
+      : call_frame_(call_frame), retvals_(call_frame->num_retvals()) {}
+
+  size_t num_args() const override { return call_frame_->num_args(); }
+  size_t num_retvals() const override { return retvals_.size(); }
+
+  Status GetArg(int index, const Tensor** val) override {
+    return call_frame_->GetArg(index, val);
+  }
+
+  Status SetRetval(int index, const Tensor& val) override {
+    retvals_[index] = val;
+    return Status::OK();
+  }
+
+  std::vector<Tensor>* retvals() { return &retvals_; }
+
+ private:
+  CallFrameInterface* const call_frame_;  // Not owned.
+  std::vector<Tensor> retvals_;
+};
+
+// What a recorded graph depends on for one argument.
+struct ArgSignature {
+  DataType dtype;
+  TensorShape shape;
+  const void* data;
+  // The contents of arguments in host memory, which kernels read on the host
+  // while recording.
+  string host_value;
+
+  bool operator==(const ArgSignature& other) const {
+    return dtype == other.dtype && shape == other.shape &&
+           data == other.data && host_value == other.host_value;
+  }
+};
+
+class GpuGraphExecutor : public Executor {
+ public:
+  GpuGraphExecutor(Device* device, std::unique_ptr<RetainingDevice> retaining,
+                   std::unique_ptr<Executor> executor)
+      : device_(device),
+        retaining_device_(std::move(retaining)),
+        executor_(std::move(executor)) {}
+
+  ~GpuGraphExecutor() override {
+    mutex_lock l(mu_);
+    Discard();
+  }
+
+  void RunAsync(const Args& args, DoneCallback done) override {
+    std::vector<ArgSignature> signature;
+    const bool has_signature =
+        args.call_frame != nullptr && GetSignature(args, &signature);
+    {
+      mutex_lock l(mu_);
+      if (has_signature && !disabled_) {
+        if (signature != signature_) {
+          Discard();
+          signature_ = std::move(signature);
+        }
+        ++num_calls_;
+        if (graph_ == nullptr && num_calls_ >= 2 && num_running_ == 0) {
+          Record(args);
+        }
+        if (graph_ != nullptr && OutputsAreIdle()) {
+          Status s = Replay(args);
+          l.unlock();
+          done(s);
+          return;
+        }
+      }
+      ++num_running_;
+    }
+    executor_->RunAsync(args, [this, done = std::move(done)](const Status& s) {
+      {
+        mutex_lock l(mu_);
+        --num_running_;
+      }
+      done(s);
+    });
+  }
+
+ private:
+  // Returns false if the arguments cannot be part of a signature.
+  static bool GetSignature(const Args& args,
+                           std::vector<ArgSignature>* signature) {
+    CallFrameInterface* call_frame = args.call_frame;
+    signature->reserve(call_frame->num_args());
+    for (int i = 0; i < static_cast<int>(call_frame->num_args()); ++i) {
+      const Tensor* arg;
+      if (!call_frame->GetArg(i, &arg).ok() ||
+          !DataTypeCanUseMemcpy(arg->dtype())) {
+        return false;
+      }
+      signature->push_back(
+          {arg->dtype(), arg->shape(), DMAHelper::base(arg), ""});
+      if (MTypeFromDType(arg->dtype()) == HOST_MEMORY) {
+        signature->back().host_value = string(arg->tensor_data());
+      }
+    }
+    return true;
+  }
+
+  // Returns whether nobody else holds the outputs of the recorded graph, which
+  // it is about to overwrite.
+  bool OutputsAreIdle() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    for (const Tensor& output : outputs_) {
+      if (output.IsInitialized() && !output.RefCountIsOne()) return false;
+    }
+    return true;
+  }
+
+  se::Stream* compute_stream() const {
+    return device_->tensorflow_gpu_device_info()->stream;
+  }
+
+  // Launches the recorded graph and returns its outputs.
+  Status Replay(const Args& args) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    TF_RETURN_IF_ERROR(graph_->Launch(compute_stream()));
+    for (int i = 0; i < static_cast<int>(outputs_.size()); ++i) {
+      TF_RETURN_IF_ERROR(args.call_frame->SetRetval(i, outputs_[i]));
+    }
+    if (args.sync_on_finish && device_->AllowsSyncOnCompletion()) {
+      return device_->Sync();
+    }
+    return Status::OK();
+  }
+
+  // Runs the body while recording its GPU work into a graph, without executing
+  // the work. Holding `mu_` keeps other calls from enqueuing work meanwhile.
+  void Record(const Args& args) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    RecordingCallFrame call_frame(args.call_frame);
+    Args recording_args = args;
+    recording_args.call_frame = &call_frame;
+    // Enqueues all the work from this thread, so that calls that are illegal
+    // while recording fail instead of corrupting the graph.
+    recording_args.run_all_kernels_inline = true;
+    recording_args.sync_on_finish = false;
+    retaining_device_->SetRetaining(true);
+    auto graph_or = se::gpu::GpuGraph::Capture(
+        compute_stream(), [&]() { return executor_->Run(recording_args); });
+    retaining_device_->SetRetaining(false);
+    if (!graph_or.ok()) {
+      LOG(WARNING) << "Running function on " << device_->name()
+                   << " without a GPU graph: " << graph_or.status();
+      retaining_device_->Release();
+      disabled_ = true;
+      return;
+    }
+    graph_ = std::move(graph_or.ValueOrDie());
+    outputs_ = std::move(*call_frame.retvals());
+    VLOG(1) << "Recorded a GPU graph on " << device_->name();
+  }
+
+  // Discards the recorded graph and the memory it uses.
+  void Discard() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (graph_ != nullptr) {
+      // Work enqueued later reuses the memory of the graph, so it executes
+      // after the last launch.
+      graph_.reset();
+      outputs_.clear();
+      retaining_device_->Release();
+    }
+    num_calls_ = 0;
+  }
+
+  Device* const device_;  // Not owned.
+  const std::unique_ptr<RetainingDevice> retaining_device_;
+  const std::unique_ptr<Executor> executor_;
+
+  mutex mu_;
+  // Set once recording failed, after which the body always runs normally.
+  bool disabled_ TF_GUARDED_BY(mu_) = false;
+  // The arguments of the last call, and the number of calls in a row with the
+  // same arguments.
+  std::vector<ArgSignature> signature_ TF_GUARDED_BY(mu_);
+  int num_calls_ TF_GUARDED_BY(mu_) = 0;
+  // The number of calls running normally, which must not be recorded.
+  int num_running_ TF_GUARDED_BY(mu_) = 0;
+  std::unique_ptr<se::gpu::GpuGraph> graph_ TF_GUARDED_BY(mu_);
+  // The return values of the recorded call, which each launch overwrites.
+  std::vector<Tensor> outputs_ TF_GUARDED_BY(mu_);
+};
+
+class GpuGraphExecutorRegistrar {
+ public:
+  GpuGraphExecutorRegistrar() {
+    ExecutorFactory::Register(kGpuGraphExecutor, new Factory);
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params, const Graph& graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      Device* device = params.device;
+      bool recordable = device->tensorflow_gpu_device_info() != nullptr;
+      for (const Node* node : graph.op_nodes()) {
+        if (!recordable) break;
+        recordable = IsRecordable(node) &&
+                     node->assigned_device_name() == device->name();
+      }
+      if (!recordable) {
+        VLOG(1) << "Running function on " << device->name()
+                << " without a GPU graph";
+        return tensorflow::NewExecutor("", params, graph, out_executor);
+      }
+      auto retaining_device = absl::make_unique<RetainingDevice>(device);
+      LocalExecutorParams retaining_params = params;
+      retaining_params.device = retaining_device.get();
+      std::unique_ptr<Executor> executor;
+      TF_RETURN_IF_ERROR(
+          tensorflow::NewExecutor("", retaining_params, graph, &executor));
+      out_executor->reset(new GpuGraphExecutor(
+          device, std::move(retaining_device), std::move(executor)));
+      return Status::OK();
+    }
+  };
+};
+static GpuGraphExecutorRegistrar registrar;
+
+}  // namespace
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA
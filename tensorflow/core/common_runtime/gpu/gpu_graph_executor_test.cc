@@ -0,0 +1,151 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if GOOGLE_CUDA
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/function_ops.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+namespace {
+
+class GpuGraphExecutorTest : public ::testing::Test {
+ protected:
+  GpuGraphExecutorTest()
+      : device_(DeviceFactory::NewDevice("GPU", SessionOptions(),
+                                         "/job:a/replica:0/task:0")) {}
+
+  // Creates an executor for `y = x * x + x`, optionally with an op that
+  // cannot be recorded.
+  void Create(bool recordable) {
+    Scope root = Scope::NewRootScope().ExitOnError();
+    auto x = ops::_Arg(root.WithOpName("x"), DT_FLOAT, 0);
+    Output y = ops::AddV2(root.WithOpName("y"), ops::Mul(root, x, x), x);
+    if (!recordable) {
+      y = ops::Where3(root.WithOpName("where"),
+                      ops::Greater(root, y, ops::ZerosLike(root, y)), y, x);
+    }
+    ops::_Retval(root.WithOpName("retval"), y, 0);
+    auto graph = absl::make_unique<Graph>(OpRegistry::Global());
+    TF_ASSERT_OK(root.ToGraph(graph.get()));
+    for (Node* node : graph->op_nodes()) {
+      node->set_assigned_device_name(device_->name());
+    }
+    const int version = graph->versions().producer();
+    LocalExecutorParams params;
+    params.device = device_.get();
+    params.create_kernel =
+        [this, version](const std::shared_ptr<const NodeProperties>& props,
+                        OpKernel** kernel) {
+          return CreateNonCachedKernel(device_.get(), nullptr, props, version,
+                                       kernel);
+        };
+    params.delete_kernel = [](OpKernel* kernel) {
+      DeleteNonCachedKernel(kernel);
+    };
+    TF_ASSERT_OK(NewExecutor("GPU_GRAPH", params, *graph, &executor_));
+  }
+
+  Tensor ToDevice(const Tensor& cpu_tensor) {
+    Tensor device_tensor(device_->GetAllocator(AllocatorAttributes()),
+                         cpu_tensor.dtype(), cpu_tensor.shape());
+    TF_CHECK_OK(device_->tensorflow_gpu_device_info()
+                    ->default_context->CopyCPUTensorToDeviceSync(
+                        &cpu_tensor, device_.get(), &device_tensor));
+    return device_tensor;
+  }
+
+  // Runs the executor on `x`, and returns the output copied to the host.
+  Tensor Run(const Tensor& x) {
+    FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+    TF_CHECK_OK(call_frame.SetArgs({x}));
+    Executor::Args args;
+    args.call_frame = &call_frame;
+    args.runner = [](std::function<void()> fn) { fn(); };
+    TF_CHECK_OK(executor_->Run(args));
+    std::vector<Tensor> retvals;
+    TF_CHECK_OK(call_frame.ConsumeRetvals(&retvals, false));
+    Tensor cpu_tensor(retvals[0].dtype(), retvals[0].shape());
+    TF_CHECK_OK(device_->tensorflow_gpu_device_info()
+                    ->default_context->CopyDeviceTensorToCPUSync(
+                        &retvals[0], "y", device_.get(), &cpu_tensor));
+    return cpu_tensor;
+  }
+
+  std::unique_ptr<Device> device_;
+  std::unique_ptr<Executor> executor_;
+};
+
+TEST_F(GpuGraphExecutorTest, ReplaysWithSameArguments) {
+  Create(/*recordable=*/true);
+  Tensor x = ToDevice(test::AsTensor<float>({1, 2, 3, 4}, {2, 2}));
+  const Tensor expected = test::AsTensor<float>({2, 6, 12, 20}, {2, 2});
+  for (int i = 0; i < 4; ++i) {
+    test::ExpectTensorEqual<float>(Run(x), expected);
+  }
+}
+
+TEST_F(GpuGraphExecutorTest, ReadsArgumentsOnEachReplay) {
+  Create(/*recordable=*/true);
+  Tensor x = ToDevice(test::AsTensor<float>({1, 2, 3, 4}, {2, 2}));
+  Run(x);
+  Run(x);
+  // Overwrites the argument in place, keeping its buffer.
+  Tensor new_x = test::AsTensor<float>({0, 1, 2, 3}, {2, 2});
+  TF_ASSERT_OK(device_->tensorflow_gpu_device_info()
+                   ->default_context->CopyCPUTensorToDeviceSync(
+                       &new_x, device_.get(), &x));
+  test::ExpectTensorEqual<float>(
+      Run(x), test::AsTensor<float>({0, 2, 6, 12}, {2, 2}));
+}
+
+TEST_F(GpuGraphExecutorTest, StartsOverWithOtherArguments) {
+  Create(/*recordable=*/true);
+  Tensor x = ToDevice(test::AsTensor<float>({1, 2, 3, 4}, {2, 2}));
+  Run(x);
+  Run(x);
+  Tensor other_x = ToDevice(test::AsTensor<float>({1, 2, 3}, {3}));
+  for (int i = 0; i < 3; ++i) {
+    test::ExpectTensorEqual<float>(Run(other_x),
+                                   test::AsTensor<float>({2, 6, 12}, {3}));
+  }
+}
+
+TEST_F(GpuGraphExecutorTest, RunsOtherGraphsNormally) {
+  Create(/*recordable=*/false);
+  Tensor x = ToDevice(test::AsTensor<float>({-1, 2}, {2}));
+  for (int i = 0; i < 3; ++i) {
+    test::ExpectTensorEqual<float>(Run(x), test::AsTensor<float>({-1, 6}, {2}));
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA
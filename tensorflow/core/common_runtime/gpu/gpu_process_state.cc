@@ -22,10 +22,12 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device/device_id_utils.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_bfc_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_cudamalloc_allocator.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_cudamallocasync_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_debug_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id_manager.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_init.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_virtual_mem_allocator.h"
 #include "tensorflow/core/common_runtime/pool_allocator.h"
 #include "tensorflow/core/common_runtime/shared_counter.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -47,12 +49,92 @@ bool useCudaMallocAllocator() {
          std::strcmp(debug_allocator_str, "cuda_malloc") == 0;
 }
 
+bool useCudaMallocAsyncAllocator() {
+  const char* debug_allocator_str = std::getenv("TF_GPU_ALLOCATOR");
+  return debug_allocator_str != nullptr &&
+         std::strcmp(debug_allocator_str, "cuda_malloc_async") == 0;
+}
+
 bool useCudaMemoryGuardAllocator() {
   const char* debug_allocator_str = std::getenv("TF_GPU_ALLOCATOR");
   return debug_allocator_str != nullptr &&
          std::strcmp(debug_allocator_str, "memory_guard") == 0;
 }
 
+// Whether BFC allocators grow within one reservation of virtual addresses,
+// mapping physical memory on demand, instead of allocating separate regions.
+bool useVirtualMemoryAllocator() {
+  static const bool use_virtual_memory = [] {
+    bool use_virtual_memory = false;
+    Status status = ReadBoolFromEnvVar("TF_GPU_VIRTUAL_MEMORY_ALLOCATOR",
+                                       false, &use_virtual_memory);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+    }
+    return use_virtual_memory;
+  }();
+  return use_virtual_memory;
+}
+
+// Whether pinned host memory is allocated on the NUMA node it serves and then
+// registered with the GPU driver, rather than placed by the driver.
+bool useNumaLocalGpuHostMemory() {
+  static const bool use_numa_local = [] {
+    bool use_numa_local = false;
+    Status status = ReadBoolFromEnvVar("TF_GPU_HOST_MEM_NUMA_LOCAL", false,
+                                       &use_numa_local);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+    }
+    return use_numa_local;
+  }();
+  return use_numa_local;
+}
+
+SubAllocator* CreateSubAllocator(
+    const GPUOptions& options, PlatformGpuId platform_gpu_id,
+    const std::vector<SubAllocator::Visitor>& alloc_visitors,
+    size_t total_bytes) {
+  se::StreamExecutor* executor =
+      DeviceIdUtil::ExecutorForPlatformDeviceId(GPUMachineManager(),
+                                                platform_gpu_id)
+          .ValueOrDie();
+  const bool use_unified_memory =
+      options.per_process_gpu_memory_fraction() > 1.0 ||
+      options.experimental().use_unified_memory();
+#if GOOGLE_CUDA && CUDA_VERSION >= 10020
+  if (useVirtualMemoryAllocator() && !use_unified_memory) {
+    // Peer access is set up when memory is mapped, so it is granted to all
+    // GPUs that can access this one.
+    std::vector<PlatformGpuId> peer_gpu_ids;
+    se::Platform* platform = GPUMachineManager();
+    for (int i = 0; i < platform->VisibleDeviceCount(); ++i) {
+      if (i == platform_gpu_id.value()) continue;
+      auto peer_executor = platform->ExecutorForDevice(i);
+      if (peer_executor.ok() &&
+          peer_executor.ValueOrDie()->CanEnablePeerAccessTo(executor)) {
+        peer_gpu_ids.push_back(PlatformGpuId(i));
+      }
+    }
+    auto* gpu_context = reinterpret_cast<stream_executor::gpu::GpuContext*>(
+        executor->implementation()->GpuContextHack());
+    // Reserve twice the memory limit, since the allocator never reuses the
+    // addresses of regions freed in the middle of the reservation.
+    auto allocator = GpuVirtualMemAllocator::Create(
+        alloc_visitors, {}, *gpu_context, platform_gpu_id,
+        /*virtual_address_space_size=*/total_bytes * 2, peer_gpu_ids);
+    if (allocator.ok()) {
+      LOG(INFO) << "Using virtual memory allocator for GPU.";
+      return allocator.ConsumeValueOrDie().release();
+    }
+    LOG(WARNING) << "Failed to create virtual memory allocator for GPU "
+                 << platform_gpu_id.value() << ": " << allocator.status();
+  }
+#endif  // GOOGLE_CUDA && CUDA_VERSION >= 10020
+  return new DeviceMemAllocator(executor, platform_gpu_id, use_unified_memory,
+                                alloc_visitors, {});
+}
+
 }  // namespace
 
 /*static*/ GPUProcessState* GPUProcessState::singleton(GPUProcessState* ps) {
@@ -92,8 +174,25 @@ Allocator* GPUProcessState::GetGPUAllocator(const GPUOptions& options,
     gpu_allocators_.resize(tf_gpu_id.value() + 1);
   }
 
-  AllocatorParts& allocator_parts = gpu_allocators_[tf_gpu_id.value()];
-  if (allocator_parts.allocator == nullptr) {
+  AllocatorParts* allocator_parts = &gpu_allocators_[tf_gpu_id.value()];
+  // Allocators ordered on the streams of their devices can already share the
+  // memory pool of the GPU.
+  if (allocator_parts->allocator == nullptr &&
+      VirtualDevicesShareMemory(options) && !useCudaMallocAsyncAllocator()) {
+    PlatformGpuId platform_gpu_id;
+    TF_CHECK_OK(GpuIdManager::TfToPlatformGpuId(tf_gpu_id, &platform_gpu_id));
+    for (int i = 0; i < gpu_allocators_.size(); ++i) {
+      PlatformGpuId other_platform_gpu_id;
+      if (gpu_allocators_[i].allocator != nullptr &&
+          GpuIdManager::TfToPlatformGpuId(TfGpuId(i), &other_platform_gpu_id)
+              .ok() &&
+          other_platform_gpu_id == platform_gpu_id) {
+        allocator_parts = &gpu_allocators_[i];
+        break;
+      }
+    }
+  }
+  if (allocator_parts->allocator == nullptr) {
     // Validate allocator types.
     if (!allocator_type.empty() && allocator_type != "BFC") {
       LOG(ERROR) << "Invalid allocator type: " << allocator_type;
@@ -102,42 +201,51 @@ Allocator* GPUProcessState::GetGPUAllocator(const GPUOptions& options,
 
     PlatformGpuId platform_gpu_id;
     TF_CHECK_OK(GpuIdManager::TfToPlatformGpuId(tf_gpu_id, &platform_gpu_id));
-    int bus_id = BusIdForGPU(tf_gpu_id);
-    DCHECK_GE(bus_id, 0);
-    while (bus_id >= gpu_visitors_.size()) {
-      gpu_visitors_.push_back({});
-    }
-    DeviceMemAllocator* sub_allocator = new DeviceMemAllocator(
-        DeviceIdUtil::ExecutorForPlatformDeviceId(GPUMachineManager(),
-                                                  platform_gpu_id)
-            .ValueOrDie(),
-        platform_gpu_id,
-        (options.per_process_gpu_memory_fraction() > 1.0 ||
-         options.experimental().use_unified_memory()),
-        gpu_visitors_[bus_id], {});
-    GPUBFCAllocator* gpu_bfc_allocator =
-        new GPUBFCAllocator(sub_allocator, total_bytes, options,
-                            strings::StrCat("GPU_", tf_gpu_id.value(), "_bfc"));
-    Allocator* gpu_allocator = gpu_bfc_allocator;
+    Allocator* gpu_allocator = nullptr;
+    GPUBFCAllocator* gpu_bfc_allocator = nullptr;
+    SubAllocator* sub_allocator = nullptr;
     SharedCounter* timing_counter = nullptr;
-    if (options.experimental().timestamped_allocator()) {
-      timing_counter = new SharedCounter;
-      gpu_bfc_allocator->SetTimingCounter(timing_counter);
-    }
-
-    // If true, checks for memory overwrites by writing
-    // distinctive patterns on both ends of allocated memory.
-    if (useCudaMemoryGuardAllocator()) {
-      LOG(INFO) << "Using memory guard allocator for GPU.";
-      gpu_allocator = new GPUDebugAllocator(gpu_allocator, platform_gpu_id);
-      gpu_allocator = new GPUNanResetAllocator(gpu_allocator, platform_gpu_id);
-    } else if (useCudaMallocAllocator()) {
-      LOG(INFO) << "Using CUDA malloc allocator for GPU.";
-      // If true, passes all allocation requests through to cudaMalloc
-      // useful for doing memory debugging with tools like cuda-memcheck
-      // **WARNING** probably will not work in a multi-gpu scenario
-      gpu_allocator =
-          new GPUcudaMallocAllocator(gpu_allocator, platform_gpu_id);
+    if (useCudaMallocAsyncAllocator()) {
+      LOG(INFO) << "Using CUDA malloc async allocator for GPU.";
+      if (options.experimental().timestamped_allocator()) {
+        LOG(WARNING) << "The timestamped allocator is ignored with the CUDA "
+                        "malloc async allocator.";
+      }
+      gpu_allocator = new GpuCudaMallocAsyncAllocator(
+          platform_gpu_id, total_bytes,
+          strings::StrCat("GPU_", tf_gpu_id.value(), "_cuda_malloc_async"));
+    } else {
+      int bus_id = BusIdForGPU(tf_gpu_id);
+      DCHECK_GE(bus_id, 0);
+      while (bus_id >= gpu_visitors_.size()) {
+        gpu_visitors_.push_back({});
+      }
+      sub_allocator = CreateSubAllocator(options, platform_gpu_id,
+                                         gpu_visitors_[bus_id], total_bytes);
+      gpu_bfc_allocator = new GPUBFCAllocator(
+          sub_allocator, total_bytes, options,
+          strings::StrCat("GPU_", tf_gpu_id.value(), "_bfc"));
+      gpu_allocator = gpu_bfc_allocator;
+      if (options.experimental().timestamped_allocator()) {
+        timing_counter = new SharedCounter;
+        gpu_bfc_allocator->SetTimingCounter(timing_counter);
+      }
+
+      // If true, checks for memory overwrites by writing
+      // distinctive patterns on both ends of allocated memory.
+      if (useCudaMemoryGuardAllocator()) {
+        LOG(INFO) << "Using memory guard allocator for GPU.";
+        gpu_allocator = new GPUDebugAllocator(gpu_allocator, platform_gpu_id);
+        gpu_allocator =
+            new GPUNanResetAllocator(gpu_allocator, platform_gpu_id);
+      } else if (useCudaMallocAllocator()) {
+        LOG(INFO) << "Using CUDA malloc allocator for GPU.";
+        // If true, passes all allocation requests through to cudaMalloc
+        // useful for doing memory debugging with tools like cuda-memcheck
+        // **WARNING** probably will not work in a multi-gpu scenario
+        gpu_allocator =
+            new GPUcudaMallocAllocator(gpu_allocator, platform_gpu_id);
+      }
     }
 
     Allocator* recording_allocator = nullptr;
@@ -150,15 +258,15 @@ Allocator* GPUProcessState::GetGPUAllocator(const GPUOptions& options,
       recording_allocator = new internal::RecordingAllocator(
           &process_state_->mem_desc_map_, gpu_allocator, md, &mu_);
     }
-    allocator_parts = {std::unique_ptr<Allocator>(gpu_allocator),
-                       std::unique_ptr<SharedCounter>(timing_counter),
-                       gpu_bfc_allocator, sub_allocator,
-                       std::unique_ptr<Allocator>(recording_allocator)};
+    *allocator_parts = {std::unique_ptr<Allocator>(gpu_allocator),
+                        std::unique_ptr<SharedCounter>(timing_counter),
+                        gpu_bfc_allocator, sub_allocator,
+                        std::unique_ptr<Allocator>(recording_allocator)};
   }
   if (process_state_->ProcessState::FLAGS_brain_gpu_record_mem_types) {
-    return allocator_parts.recording_allocator.get();
+    return allocator_parts->recording_allocator.get();
   } else {
-    return allocator_parts.allocator.get();
+    return allocator_parts->allocator.get();
   }
 #else
   LOG(FATAL) << "GPUAllocator unavailable. Not compiled with --config=cuda or "
@@ -167,6 +275,24 @@ Allocator* GPUProcessState::GetGPUAllocator(const GPUOptions& options,
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 }
 
+bool GPUProcessState::VirtualDevicesShareMemory(const GPUOptions& options) {
+  static const bool share_memory = [] {
+    bool share_memory = false;
+    Status status = ReadBoolFromEnvVar("TF_GPU_VIRTUAL_DEVICES_SHARE_MEMORY",
+                                       false, &share_memory);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+    }
+    return share_memory;
+  }();
+  if (share_memory && options.experimental().timestamped_allocator()) {
+    LOG_FIRST_N(WARNING, 1) << "TF_GPU_VIRTUAL_DEVICES_SHARE_MEMORY is "
+                               "ignored with the timestamped allocator.";
+    return false;
+  }
+  return share_memory;
+}
+
 SharedCounter* GPUProcessState::GPUAllocatorCounter(TfGpuId tf_gpu_id) {
   DCHECK(process_state_);
 #if (defined(GOOGLE_CUDA) && GOOGLE_CUDA) || \
@@ -181,6 +307,11 @@ SharedCounter* GPUProcessState::GPUAllocatorCounter(TfGpuId tf_gpu_id) {
   }
 
   AllocatorParts& allocator_parts = gpu_allocators_[tf_gpu_id.value()];
+  if (allocator_parts.bfc_allocator == nullptr) {
+    LOG(ERROR) << "GPU allocator " << tf_gpu_id.value()
+               << " does not support timing counters";
+    return nullptr;
+  }
   if (allocator_parts.counter.get() == nullptr) {
     SharedCounter* timing_counter = new SharedCounter;
     allocator_parts.bfc_allocator->SetTimingCounter(timing_counter);
@@ -209,12 +340,12 @@ Allocator* GPUProcessState::GetGpuHostAllocator(int numa_node) {
     tf_shared_lock lock(mu_);
 
     if (process_state_->ProcessState::FLAGS_brain_gpu_record_mem_types &&
-        !gpu_host_allocators_.empty() &&
-        gpu_host_allocators_[0].recording_allocator != nullptr) {
-      return gpu_host_allocators_[0].recording_allocator.get();
+        static_cast<int>(gpu_host_allocators_.size()) > numa_node &&
+        gpu_host_allocators_[numa_node].recording_allocator != nullptr) {
+      return gpu_host_allocators_[numa_node].recording_allocator.get();
     }
     if (static_cast<int>(gpu_host_allocators_.size()) > numa_node) {
-      return gpu_host_allocators_[0].allocator.get();
+      return gpu_host_allocators_[numa_node].allocator.get();
     }
   }
 
@@ -245,9 +376,10 @@ Allocator* GPUProcessState::GetGpuHostAllocator(int numa_node) {
     while (gpu_host_free_visitors_.size() <= numa_node) {
       gpu_host_free_visitors_.push_back({});
     }
+    const int node = gpu_host_allocators_.size();
     SubAllocator* sub_allocator = new DeviceHostAllocator(
-        se, numa_node, gpu_host_alloc_visitors_[numa_node],
-        gpu_host_free_visitors_[numa_node]);
+        se, node, gpu_host_alloc_visitors_[node], gpu_host_free_visitors_[node],
+        useNumaLocalGpuHostMemory());
     // TODO(zheng-xq): evaluate whether 64GB by default is the best choice.
     int64 gpu_host_mem_limit_in_mb = -1;
     Status status = ReadInt64FromEnvVar("TF_GPU_HOST_MEM_LIMIT_IN_MB",
@@ -275,7 +407,7 @@ Allocator* GPUProcessState::GetGpuHostAllocator(int numa_node) {
     if (process_state_->ProcessState::FLAGS_brain_gpu_record_mem_types) {
       ProcessState::MemDesc md;
       md.loc = ProcessState::MemDesc::CPU;
-      md.dev_index = 0;
+      md.dev_index = node;
       md.gpu_registered = true;
       md.nic_registered = false;
       allocator_parts.recording_allocator.reset(
@@ -285,9 +417,9 @@ Allocator* GPUProcessState::GetGpuHostAllocator(int numa_node) {
     }
   }
   if (process_state_->ProcessState::FLAGS_brain_gpu_record_mem_types) {
-    return gpu_host_allocators_[0].recording_allocator.get();
+    return gpu_host_allocators_[numa_node].recording_allocator.get();
   } else {
-    return gpu_host_allocators_[0].allocator.get();
+    return gpu_host_allocators_[numa_node].allocator.get();
   }
 }
 
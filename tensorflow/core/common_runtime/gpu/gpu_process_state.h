@@ -79,11 +79,22 @@ class GPUProcessState {
   // underlying allocator.  REQUIRES: Must be a valid type (see
   // config.proto for the list of supported strings.).
   //
+  // If VirtualDevicesShareMemory(options), all tf_gpu_ids on the same
+  // platform GPU share the allocator created by the first of these calls.
+  //
   // REQUIRES: tf_gpu_id must be a valid id for a BaseGPUDevice available in the
   // current system environment.  Otherwise returns nullptr.
   virtual Allocator* GetGPUAllocator(const GPUOptions& options,
                                      TfGpuId tf_gpu_id, size_t total_bytes);
 
+  // Returns whether the virtual devices of a platform GPU share one allocator
+  // instead of partitioning its memory, as requested by setting
+  // TF_GPU_VIRTUAL_DEVICES_SHARE_MEMORY.  Each virtual device runs on its own
+  // streams, so this lets independent subgraphs placed on them overlap on the
+  // GPU without fixing how much memory each of them gets.  Not supported with
+  // the timestamped allocator, whose counters are per tf_gpu_id.
+  bool VirtualDevicesShareMemory(const GPUOptions& options);
+
   int NumGPUAllocators() {
     mutex_lock l(mu_);
     return gpu_allocators_.size();
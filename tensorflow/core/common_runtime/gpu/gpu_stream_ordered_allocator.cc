@@ -0,0 +1,66 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/gpu/gpu_stream_ordered_allocator.h"
+
+namespace tensorflow {
+
+GPUStreamOrderedAllocator::GPUStreamOrderedAllocator(Allocator* base_allocator,
+                                                     se::Stream* stream,
+                                                     EventMgr* event_mgr)
+    : base_allocator_(base_allocator), stream_(stream), event_mgr_(event_mgr) {}
+
+void* GPUStreamOrderedAllocator::AllocateRaw(size_t alignment,
+                                             size_t num_bytes) {
+  return base_allocator_->AllocateRaw(alignment, num_bytes);
+}
+
+void* GPUStreamOrderedAllocator::AllocateRaw(
+    size_t alignment, size_t num_bytes,
+    const AllocationAttributes& allocation_attr) {
+  return base_allocator_->AllocateRaw(alignment, num_bytes, allocation_attr);
+}
+
+void GPUStreamOrderedAllocator::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) return;
+  Allocator* base_allocator = base_allocator_;
+  event_mgr_->ThenExecute(stream_, [base_allocator, ptr]() {
+    base_allocator->DeallocateRaw(ptr);
+  });
+}
+
+bool GPUStreamOrderedAllocator::TracksAllocationSizes() const {
+  return base_allocator_->TracksAllocationSizes();
+}
+
+size_t GPUStreamOrderedAllocator::RequestedSize(const void* ptr) const {
+  return base_allocator_->RequestedSize(ptr);
+}
+
+size_t GPUStreamOrderedAllocator::AllocatedSize(const void* ptr) const {
+  return base_allocator_->AllocatedSize(ptr);
+}
+
+int64 GPUStreamOrderedAllocator::AllocationId(const void* ptr) const {
+  return base_allocator_->AllocationId(ptr);
+}
+
+absl::optional<AllocatorStats> GPUStreamOrderedAllocator::GetStats() {
+  return base_allocator_->GetStats();
+}
+
+void GPUStreamOrderedAllocator::ClearStats() { base_allocator_->ClearStats(); }
+
+}  // namespace tensorflow
@@ -0,0 +1,67 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ORDERED_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ORDERED_ALLOCATOR_H_
+
+#include <string>
+
+#include "tensorflow/core/common_runtime/device/device_event_mgr.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// An allocator that wraps a GPU allocator shared by several streams, and only
+// returns memory to it once the work enqueued on `stream` so far is done.
+//
+// A GPU allocator may hand out memory as soon as the host frees it, which is
+// only safe if all kernels that might still use it run on the same stream as
+// the kernels of the next owner. When the base allocator is shared with
+// devices using other streams, deferring the free until `stream` is idle
+// restores that guarantee.
+class GPUStreamOrderedAllocator : public Allocator {
+ public:
+  // `base_allocator`, `stream` and `event_mgr` are not owned and must outlive
+  // this allocator.
+  GPUStreamOrderedAllocator(Allocator* base_allocator, se::Stream* stream,
+                            EventMgr* event_mgr);
+  ~GPUStreamOrderedAllocator() override {}
+
+  string Name() override { return base_allocator_->Name(); }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override;
+  void DeallocateRaw(void* ptr) override;
+  bool TracksAllocationSizes() const override;
+  size_t RequestedSize(const void* ptr) const override;
+  size_t AllocatedSize(const void* ptr) const override;
+  int64 AllocationId(const void* ptr) const override;
+  absl::optional<AllocatorStats> GetStats() override;
+  void ClearStats() override;
+
+ private:
+  Allocator* const base_allocator_;  // Not owned.
+  se::Stream* const stream_;         // Not owned.
+  EventMgr* const event_mgr_;        // Not owned.
+
+  TF_DISALLOW_COPY_AND_ASSIGN(GPUStreamOrderedAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ORDERED_ALLOCATOR_H_
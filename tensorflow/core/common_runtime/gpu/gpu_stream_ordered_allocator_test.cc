@@ -0,0 +1,75 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if (defined(GOOGLE_CUDA) && GOOGLE_CUDA) || \
+    (defined(TENSORFLOW_USE_ROCM) && TENSORFLOW_USE_ROCM)
+
+#include "tensorflow/core/common_runtime/gpu/gpu_stream_ordered_allocator.h"
+
+#include "tensorflow/core/common_runtime/device/device_event_mgr.h"
+#include "tensorflow/core/common_runtime/device/device_id_utils.h"
+#include "tensorflow/core/common_runtime/device/device_mem_allocator.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_bfc_allocator.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_id.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_init.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+namespace tensorflow {
+namespace {
+
+int64 BytesInUse(Allocator* allocator) {
+  return allocator->GetStats()->bytes_in_use;
+}
+
+TEST(GPUStreamOrderedAllocatorTest, FreesOnceStreamIsDone) {
+  const PlatformGpuId platform_gpu_id(0);
+  se::StreamExecutor* stream_exec =
+      DeviceIdUtil::ExecutorForPlatformDeviceId(GPUMachineManager(),
+                                                platform_gpu_id)
+          .ValueOrDie();
+  DeviceMemAllocator* sub_allocator = new DeviceMemAllocator(
+      stream_exec, platform_gpu_id, false /*use_unified_memory*/, {}, {});
+  GPUBFCAllocator base(sub_allocator, 1 << 30, "GPU_0_bfc");
+  se::Stream stream(stream_exec);
+  stream.Init();
+  EventMgr* em =
+      EventMgrFactory::Singleton()->GetEventMgr(stream_exec, GPUOptions());
+  GPUStreamOrderedAllocator a(&base, &stream, em);
+
+  const size_t num_bytes = 1 << 20;
+  void* ptr = a.AllocateRaw(Allocator::kAllocatorAlignment, num_bytes);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(a.RequestedSize(ptr), num_bytes);
+  EXPECT_GE(BytesInUse(&a), num_bytes);
+
+  se::DeviceMemoryBase mem(ptr, num_bytes);
+  stream.ThenMemZero(&mem, num_bytes);
+  a.DeallocateRaw(ptr);
+  TF_ASSERT_OK(stream.BlockHostUntilDone());
+
+  // The free runs in the EventMgr thread pool once the memzero is done.
+  for (int i = 0; i < 1000 && BytesInUse(&base) > 0; ++i) {
+    Env::Default()->SleepForMicroseconds(10000);
+  }
+  EXPECT_EQ(BytesInUse(&base), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -68,6 +68,10 @@ class GpuVirtualMemAllocator : public SubAllocator {
   // this free function should never be invoked.
   void Free(void* ptr, size_t num_bytes) override;
 
+  // Successive allocations are contiguous, and Free() unmaps any number of
+  // them at once.
+  bool SupportsCoalescing() const override { return true; }
+
  private:
   GpuVirtualMemAllocator(const std::vector<Visitor>& alloc_visitors,
                          const std::vector<Visitor>& free_visitors,
@@ -128,6 +128,17 @@ TEST(PoolAllocatorTest, AutoResize) {
   EXPECT_EQ(100, pool.size_limit());
 }
 
+TEST(PoolAllocatorTest, BasicCPUAllocatorHugePages) {
+  BasicCPUAllocator sub_allocator(port::kNUMANoAffinity, {}, {},
+                                  /*use_huge_pages=*/true);
+  size_t bytes_received;
+  void* p = sub_allocator.Alloc(64, port::kHugePageSize + 1, &bytes_received);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(2 * port::kHugePageSize, bytes_received);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % port::kHugePageSize);
+  sub_allocator.Free(p, bytes_received);
+}
+
 TEST(PoolAllocatorTest, CudaHostAllocator) {
   int alloc_count = 0;
   int64 alloc_size = 0;
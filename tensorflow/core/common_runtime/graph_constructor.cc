@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/tensor_id.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
@@ -62,6 +63,22 @@ inline bool IsMerge(const NodeDef& node_def) {
          node_def.op() == "_XlaMerge";
 }
 
+// Minimum number of nodes for which op lookup and node validation run on the
+// thread pool, if one is given.
+constexpr int kMinNodesForParallelPreparation = 1024;
+
+// Returns true if `node_def` lacks an attr that has a default value in
+// `op_def`.
+bool HasMissingDefaultAttrs(const NodeDef& node_def, const OpDef& op_def) {
+  for (const OpDef::AttrDef& attr_def : op_def.attr()) {
+    if (attr_def.has_default_value() &&
+        node_def.attr().count(attr_def.name()) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 inline bool IsNextIteration(const NodeDef& node_def) {
   return node_def.op() == "NextIteration" ||
          node_def.op() == "RefNextIteration";
@@ -97,7 +114,8 @@ class GraphConstructor {
           importing(false),
           validate_nodes(in.validate_nodes),
           validate_colocation_constraints(false),
-          add_default_attributes(in.add_default_attributes) {}
+          add_default_attributes(in.add_default_attributes),
+          thread_pool(in.thread_pool) {}
     Options(const ImportGraphDefOptions& in)  // NOLINT(runtime/explicit)
         : allow_internal_ops(false),
           expect_device_spec(false),
@@ -115,7 +133,8 @@ class GraphConstructor {
           validate_nodes(true),
           validate_colocation_constraints(in.validate_colocation_constraints),
           validate_shape(in.validate_shape),
-          default_device(in.default_device) {}
+          default_device(in.default_device),
+          thread_pool(in.thread_pool) {}
 
     bool allow_internal_ops;
     bool expect_device_spec;
@@ -150,6 +169,9 @@ class GraphConstructor {
     bool add_default_attributes = true;
 
     string default_device;
+
+    // If set, PrepareNodeDefs() runs on this pool.
+    thread::ThreadPool* thread_pool = nullptr;
   };
 
   typedef gtl::ArraySlice<const NodeDef*> NodeDefSlice;
@@ -229,7 +251,19 @@ class GraphConstructor {
   Status MakeNode(NodeDef&& node_def, Node** node);
   Status MakeEdge(Node* src, int output_index, Node* dst, int input_index);
   Status ValidateShape(Node* node);
-  Status ModifyNodeDefForImport(NodeDef* node_def);
+  Status ModifyNodeDefForImport(int node_index, NodeDef* node_def);
+
+  // Looks up the ops of all NodeDefs and validates them on
+  // `opts_.thread_pool`, ahead of Convert(), which then only checks the
+  // results. Does nothing if there is no thread pool or the graph is small.
+  void PrepareNodeDefs();
+  // Looks up the op of `node_def` and validates it as Convert() would.
+  Status PrepareNodeDef(const NodeDef& node_def, const OpDef** op_def);
+  // Sets `op_def` to the op of the `node_index`-th NodeDef `node_def`, and
+  // `prepared` to true if the NodeDef was already validated by
+  // PrepareNodeDefs().
+  Status LookUpOpDef(int node_index, const NodeDef& node_def,
+                     const OpDef** op_def, bool* prepared);
   // Modifies node_def's inputs according to opts_.input_map.
   // input_already_exists is a pre-initialized vector of length
   // node_def->input_size(). This function will mark inputs that are remapped to
@@ -390,6 +424,11 @@ class GraphConstructor {
   };
   std::vector<EdgeInfo> back_edges_;
 
+  // Results of PrepareNodeDefs(), indexed like the NodeDefs. Empty if the
+  // NodeDefs were not prepared.
+  std::vector<const OpDef*> prepared_op_defs_;
+  std::vector<Status> prepared_statuses_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(GraphConstructor);
 };
 
@@ -832,10 +871,13 @@ Status GraphConstructor::ValidateShape(Node* node) {
   return Status::OK();
 }
 
-Status GraphConstructor::ModifyNodeDefForImport(NodeDef* node_def) {
+Status GraphConstructor::ModifyNodeDefForImport(int node_index,
+                                                NodeDef* node_def) {
   const OpDef* op_def;
-  TF_RETURN_IF_ERROR(g_->op_registry()->LookUpOpDef(node_def->op(), &op_def));
+  bool prepared;
+  TF_RETURN_IF_ERROR(LookUpOpDef(node_index, *node_def, &op_def, &prepared));
   AddDefaultsToNodeDef(*op_def, node_def);
+  if (prepared) return Status::OK();
   TF_RETURN_IF_ERROR(ValidateNodeDef(*node_def, *op_def));
   if (versions()) {
     TF_RETURN_IF_ERROR(CheckOpDeprecation(*op_def, versions()->producer()));
@@ -843,6 +885,59 @@ Status GraphConstructor::ModifyNodeDefForImport(NodeDef* node_def) {
   return Status::OK();
 }
 
+void GraphConstructor::PrepareNodeDefs() {
+  const int64 num_nodes = node_def_count();
+  if (opts_.thread_pool == nullptr ||
+      num_nodes < kMinNodesForParallelPreparation) {
+    return;
+  }
+  prepared_op_defs_.assign(num_nodes, nullptr);
+  prepared_statuses_.assign(num_nodes, Status::OK());
+  // The rewrites Convert() applies to imported NodeDefs before validating them
+  // (input remapping, control dependencies, prefixes) do not change their op,
+  // their attrs or their number of data inputs, so validating the original
+  // NodeDefs is equivalent.
+  opts_.thread_pool->ParallelFor(
+      num_nodes, /*cost_per_unit=*/10000, [this](int64 start, int64 limit) {
+        for (int64 i = start; i < limit; ++i) {
+          prepared_statuses_[i] =
+              PrepareNodeDef(get_node_def(i), &prepared_op_defs_[i]);
+        }
+      });
+}
+
+Status GraphConstructor::PrepareNodeDef(const NodeDef& node_def,
+                                        const OpDef** op_def) {
+  TF_RETURN_IF_ERROR(g_->op_registry()->LookUpOpDef(node_def.op(), op_def));
+  if (!opts_.importing && !opts_.validate_nodes) return Status::OK();
+  const bool add_defaults = opts_.importing || opts_.add_default_attributes;
+  if (add_defaults && HasMissingDefaultAttrs(node_def, **op_def)) {
+    // Only copy the NodeDef, which may hold a large constant, when
+    // ValidateNodeDef() needs the default attrs to be set.
+    NodeDef node_def_with_defaults = node_def;
+    AddDefaultsToNodeDef(**op_def, &node_def_with_defaults);
+    TF_RETURN_IF_ERROR(ValidateNodeDef(node_def_with_defaults, **op_def));
+  } else {
+    TF_RETURN_IF_ERROR(ValidateNodeDef(node_def, **op_def));
+  }
+  if (opts_.importing && versions()) {
+    TF_RETURN_IF_ERROR(CheckOpDeprecation(**op_def, versions()->producer()));
+  }
+  return Status::OK();
+}
+
+Status GraphConstructor::LookUpOpDef(int node_index, const NodeDef& node_def,
+                                     const OpDef** op_def, bool* prepared) {
+  if (prepared_op_defs_.empty()) {
+    *prepared = false;
+    return g_->op_registry()->LookUpOpDef(node_def.op(), op_def);
+  }
+  TF_RETURN_IF_ERROR(prepared_statuses_[node_index]);
+  *op_def = prepared_op_defs_[node_index];
+  *prepared = true;
+  return Status::OK();
+}
+
 void RemoveInputs(const std::vector<int>& inputs_to_remove, NodeDef* node_def,
                   std::vector<bool>* input_already_exists) {
   // Remove 'inputs_to_remove' from 'node_def'
@@ -1113,6 +1208,8 @@ Status GraphConstructor::Convert() {
     // avoid unnecessarily copying `*library()` here.
     TF_RETURN_IF_ERROR(g_->AddFunctionLibrary(*library()));
   }
+  // Functions must be in the library before their callers are looked up.
+  PrepareNodeDefs();
 
   std::vector<InputInfo> inputs;
   int processed = 0;
@@ -1230,15 +1327,15 @@ Status GraphConstructor::Convert() {
     }
 
     if (opts_.importing) {
-      TF_RETURN_IF_ERROR(ModifyNodeDefForImport(&node_def));
+      TF_RETURN_IF_ERROR(ModifyNodeDefForImport(o, &node_def));
     } else {
       const OpDef* op_def;
-      TF_RETURN_IF_ERROR(
-          g_->op_registry()->LookUpOpDef(node_def.op(), &op_def));
+      bool prepared;
+      TF_RETURN_IF_ERROR(LookUpOpDef(o, node_def, &op_def, &prepared));
       if (opts_.add_default_attributes) {
         AddDefaultsToNodeDef(*op_def, &node_def);
       }
-      if (opts_.validate_nodes) {
+      if (opts_.validate_nodes && !prepared) {
         TF_RETURN_IF_ERROR(ValidateNodeDef(node_def, *op_def));
       }
     }
@@ -23,6 +23,9 @@ limitations under the License.
 
 namespace tensorflow {
 class ShapeRefiner;
+namespace thread {
+class ThreadPool;
+}  // namespace thread
 
 // Construct a Graph *g out of a GraphDef gdef. Returns non-OK on
 // error, in which case *g is left in an incomplete state.
@@ -52,6 +55,11 @@ struct GraphConstructorOptions {
   // If true, GraphConstructor will add attributes with their default
   // value to the Node when they are missing from the NodeDef.
   bool add_default_attributes = true;
+
+  // If set, op lookup and node validation of large graphs run in parallel on
+  // this pool before the nodes and edges are added to the graph one by one.
+  // Not owned.
+  thread::ThreadPool* thread_pool = nullptr;
 };
 extern Status ConvertGraphDefToGraph(const GraphConstructorOptions& opts,
                                      const GraphDef& gdef, Graph* g);
@@ -146,6 +154,11 @@ struct ImportGraphDefOptions {
   // If false skips shape validation.
   bool validate_shape;
 
+  // If set, op lookup and node validation of large graphs run in parallel on
+  // this pool. Shape inference and the construction of nodes and edges stay
+  // sequential. Not owned.
+  thread::ThreadPool* thread_pool = nullptr;
+
   // TODO(ashankar): Enable handling of GraphDefs produced by newer binaries
   // with ops that are not defined in the binary calling ImportGraphDef.
   // Similar to the producer_op_list argument to import_graph_def in the
@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
@@ -822,6 +823,76 @@ TEST_F(GraphConstructorTest, TypeMismatch) {
        "expected int32."});
 }
 
+// Returns a GraphDef large enough for node preparation to run on a thread
+// pool: a chain of TestOneInputOneOutput nodes, each with a TestDefaultAttr
+// control dependency that lacks its default attr.
+GraphDef MakeLargeGraphDef(int num_nodes) {
+  GraphDef gdef;
+  NodeDef* input = gdef.add_node();
+  input->set_name("input");
+  input->set_op("TestInput");
+  string prev = "input";
+  for (int i = 0; i < num_nodes; ++i) {
+    NodeDef* defaults = gdef.add_node();
+    defaults->set_name(strings::StrCat("defaults", i));
+    defaults->set_op("TestDefaultAttr");
+
+    NodeDef* node = gdef.add_node();
+    node->set_name(strings::StrCat("node", i));
+    node->set_op("TestOneInputOneOutput");
+    node->add_input(prev);
+    node->add_input(strings::StrCat("^", defaults->name()));
+    (*node->mutable_attr())["T"].set_type(DT_FLOAT);
+    prev = node->name();
+  }
+  return gdef;
+}
+
+TEST_F(GraphConstructorTest, ParallelPreparation) {
+  thread::ThreadPool pool(Env::Default(), "test", 4);
+  GraphDef gdef = MakeLargeGraphDef(1000);
+
+  GraphConstructorOptions opts;
+  opts.validate_nodes = true;
+  opts.thread_pool = &pool;
+  TF_ASSERT_OK(ConvertGraphDefToGraph(opts, gdef, &graph_));
+  EXPECT_EQ(graph_.num_op_nodes(), gdef.node_size());
+  EXPECT_TRUE(HasEdge("node998", 0, "node999", 0));
+  EXPECT_TRUE(HasControlEdge("defaults999", "node999"));
+  int default_int;
+  TF_EXPECT_OK(GetNodeAttr(FindNode("defaults999")->attrs(), "default_int",
+                           &default_int));
+  EXPECT_EQ(default_int, 31415);
+
+  ImportGraphDefOptions import_opts;
+  import_opts.prefix = "import";
+  import_opts.thread_pool = &pool;
+  TF_ASSERT_OK(ImportGraphDef(import_opts, gdef, &graph_, nullptr));
+  EXPECT_TRUE(HasEdge("import/node998", 0, "import/node999", 0));
+}
+
+TEST_F(GraphConstructorTest, ParallelPreparationError) {
+  thread::ThreadPool pool(Env::Default(), "test", 4);
+  GraphDef gdef = MakeLargeGraphDef(1000);
+  (*gdef.mutable_node(1500)->mutable_attr())["unknown_attr"].set_i(1);
+  const string original_graph_description = GraphDebugString();
+
+  GraphConstructorOptions opts;
+  opts.validate_nodes = true;
+  opts.thread_pool = &pool;
+  Status s = ConvertGraphDefToGraph(opts, gdef, &graph_);
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+  EXPECT_TRUE(str_util::StrContains(s.error_message(),
+                                    "NodeDef mentions attr 'unknown_attr'"))
+      << s;
+
+  ImportGraphDefOptions import_opts;
+  import_opts.thread_pool = &pool;
+  s = ImportGraphDef(import_opts, gdef, &graph_, nullptr);
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+  EXPECT_EQ(original_graph_description, GraphDebugString());
+}
+
 TEST_F(GraphConstructorTest, EmptyGraph) {
   ExpectOK("");
   ExpectVersions(0, 0);
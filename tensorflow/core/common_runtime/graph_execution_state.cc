@@ -729,7 +729,17 @@ Status GraphExecutionState::OptimizeGraph(
         // choose 0 to minimize the memory impact. Note that this only matters
         // if an optimizer chooses to run the graph.
         TensorShape shape;
-        if (partial_shape.unknown_rank()) {
+        auto specialized_shape =
+            options.specialized_feed_shapes.find(node->name());
+        if (specialized_shape != options.specialized_feed_shapes.end()) {
+          if (!partial_shape.IsCompatibleWith(specialized_shape->second)) {
+            return errors::InvalidArgument(
+                "Shape ", specialized_shape->second.DebugString(),
+                " is not compatible with the shape of feed node: ",
+                node->def().DebugString());
+          }
+          shape = specialized_shape->second;
+        } else if (partial_shape.unknown_rank()) {
           shape = TensorShape({0});
         } else {
           for (int i = 0; i < partial_shape.dims(); ++i) {
@@ -776,6 +786,32 @@ Status GraphExecutionState::OptimizeGraph(
 
     // Convert Graph to GraphDef and add it to the GrapplerItem.
     graph_->ToGraphDef(&item.graph);
+
+    // When the graph is specialized for the shapes of its feeds, the fed
+    // placeholders take on these shapes, and the optimizers can assume that
+    // the feeds match them.
+    const ConfigProto* config = &session_options_->config;
+    ConfigProto specialized_config;
+    if (!options.specialized_feed_shapes.empty()) {
+      for (NodeDef& node : *item.graph.mutable_node()) {
+        auto it = options.specialized_feed_shapes.find(node.name());
+        if (it != options.specialized_feed_shapes.end() &&
+            (node.op() == "Placeholder" || node.op() == "PlaceholderV2")) {
+          it->second.AsProto((*node.mutable_attr())["shape"].mutable_shape());
+        }
+      }
+      specialized_config = *config;
+      RewriterConfig* rewrite_options =
+          specialized_config.mutable_graph_options()->mutable_rewrite_options();
+      if (rewrite_options->constant_folding() != RewriterConfig::OFF) {
+        rewrite_options->set_constant_folding(RewriterConfig::AGGRESSIVE);
+      }
+      if (rewrite_options->arithmetic_optimization() != RewriterConfig::OFF) {
+        rewrite_options->set_arithmetic_optimization(
+            RewriterConfig::AGGRESSIVE);
+      }
+      config = &specialized_config;
+    }
     // TODO(b/114748242): Add a unit test to test this bug fix.
     if (flib_def_) {
       *item.graph.mutable_library() = flib_def_->ToProto();
@@ -796,8 +832,8 @@ Status GraphExecutionState::OptimizeGraph(
     // Now we can run the MetaOptimizer on the constructed GrapplerItem.
     GraphDef new_graph;
     TF_RETURN_IF_ERROR(
-        grappler::RunMetaOptimizer(std::move(item), session_options_->config,
-                                   cpu_device, &cluster, &new_graph));
+        grappler::RunMetaOptimizer(std::move(item), *config, cpu_device,
+                                   &cluster, &new_graph));
 
     // Merge optimized graph function library with an original library.
     // Optimized graph might have new functions specialized for it's
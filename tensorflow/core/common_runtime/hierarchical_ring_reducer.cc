@@ -0,0 +1,320 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_ring_reducer.h"
+
+#include <utility>
+
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/device_base.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+namespace {
+
+// The phases of the algorithm.
+enum Phase {
+  kIntraTaskReduceScatter = 0,
+  kInterTaskReduceScatter,
+  kInterTaskAllGather,
+  kIntraTaskAllGather,
+};
+
+// Groups the device indices of "col_params" by task, in group order.
+// Returns an error unless every task has the same number of devices.
+Status GetTaskDevices(const CollectiveParams& col_params,
+                      std::vector<std::vector<int>>* task_devices) {
+  task_devices->clear();
+  std::vector<string> tasks;
+  for (int i = 0; i < col_params.group.task_names.size(); ++i) {
+    const string& task = col_params.group.task_names[i];
+    int t = 0;
+    while (t < tasks.size() && tasks[t] != task) ++t;
+    if (t == tasks.size()) {
+      tasks.push_back(task);
+      task_devices->emplace_back();
+    }
+    (*task_devices)[t].push_back(i);
+  }
+  if (task_devices->empty() ||
+      col_params.group.task_names.size() != col_params.group.group_size) {
+    return errors::Internal("Incomplete group in HierarchicalRingReduce: ",
+                            col_params.ToString());
+  }
+  for (const std::vector<int>& devices : *task_devices) {
+    if (devices.size() != task_devices->front().size()) {
+      return errors::InvalidArgument(
+          "HierarchicalRingReduce requires the same number of devices in "
+          "every task, but task ",
+          tasks.front(), " has ", task_devices->front().size(),
+          " devices and another one has ", devices.size());
+    }
+  }
+  return Status::OK();
+}
+
+string HierarchicalRingBufKey(const string& exec_key, int phase, int step,
+                              int chunk_idx, int source_rank) {
+  return strings::StrCat(exec_key, ":h", phase, ":", step, ":", chunk_idx, ":",
+                         source_rank);
+}
+
+}  // namespace
+
+Status HierarchicalRingReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  CHECK_EQ(col_params->instance.type, REDUCTION_COLLECTIVE);
+  CHECK_EQ(col_params->instance.impl_details.collective_name,
+           "HierarchicalRingReduce");
+  if (col_params->instance.impl_details.wire_data_type != DT_INVALID) {
+    return errors::Unimplemented(
+        "HierarchicalRingReduce does not support wire compression");
+  }
+  std::vector<std::vector<int>> task_devices;
+  TF_RETURN_IF_ERROR(GetTaskDevices(*col_params, &task_devices));
+  return RingAlg::InitializeCollectiveParams(col_params);
+}
+
+std::vector<int> HierarchicalRingReducer::ShardChunks(int shard_idx) const {
+  const int num_tasks = task_devices_.size();
+  std::vector<int> chunks;
+  for (int j = 0; j < num_tasks; ++j) {
+    const int chunk_idx = shard_idx * num_tasks + j;
+    if (ca_->ChunkBytes(chunk_idx) > 0) chunks.push_back(chunk_idx);
+  }
+  return chunks;
+}
+
+bool HierarchicalRingReducer::RunStep(int phase, int step, int send_to_dev_idx,
+                                      const std::vector<int>& send_chunks,
+                                      int recv_from_dev_idx,
+                                      const std::vector<int>& recv_chunks,
+                                      bool reduce) {
+  const int my_rank = col_params_->default_rank;
+  const int num_chunks = task_devices_.size() * task_devices_.front().size();
+  std::vector<Tensor> send_tensors;
+  send_tensors.reserve(send_chunks.size());
+  for (int chunk_idx : send_chunks) {
+    send_tensors.push_back(ca_->ChunkAlias(chunk_idx));
+  }
+  std::vector<Tensor> recv_tensors;
+  recv_tensors.reserve(recv_chunks.size());
+  for (int chunk_idx : recv_chunks) {
+    if (reduce) {
+      const int tmp_idx = (phase == kIntraTaskReduceScatter)
+                              ? chunk_idx
+                              : num_chunks + chunk_idx;
+      recv_tensors.push_back(tmp_chunks_[tmp_idx]);
+    } else {
+      recv_tensors.push_back(ca_->ChunkAlias(chunk_idx));
+    }
+  }
+
+  BlockingCounter pending(send_chunks.size() + recv_chunks.size());
+  auto done = [this, &pending](const Status& s) {
+    if (!s.ok()) StartAbort(s);
+    pending.DecrementCount();
+  };
+  for (int i = 0; i < send_chunks.size(); ++i) {
+    col_ctx_->col_exec->remote_access()->PostToPeer(
+        col_params_->group.device_names[send_to_dev_idx],
+        col_params_->group.task_names[send_to_dev_idx],
+        HierarchicalRingBufKey(col_ctx_->exec_key, phase, step, send_chunks[i],
+                               my_rank),
+        col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->output_alloc_attr(0), &send_tensors[i],
+        col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
+        done);
+  }
+  for (int i = 0; i < recv_chunks.size(); ++i) {
+    col_ctx_->col_exec->remote_access()->RecvFromPeer(
+        col_params_->group.device_names[recv_from_dev_idx],
+        col_params_->group.task_names[recv_from_dev_idx],
+        col_params_->task.is_local[recv_from_dev_idx],
+        HierarchicalRingBufKey(col_ctx_->exec_key, phase, step, recv_chunks[i],
+                               recv_from_dev_idx),
+        col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->output_alloc_attr(0), &recv_tensors[i],
+        col_ctx_->device_locality, 0 /*dev_to_dev_stream_index*/,
+        col_ctx_->op_ctx->cancellation_manager(), done);
+  }
+  pending.Wait();
+  {
+    mutex_lock l(status_mu_);
+    if (!status_.ok()) return false;
+  }
+
+  if (reduce) {
+    for (int i = 0; i < recv_chunks.size(); ++i) {
+      Tensor chunk = ca_->ChunkAlias(recv_chunks[i]);
+      Status s = collective_util::ComputeBinOp(
+          col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+          col_params_->merge_op, &chunk, &recv_tensors[i]);
+      if (!s.ok()) {
+        StartAbort(s);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool HierarchicalRingReducer::RunAsyncParts() {
+  // Like RingReducer::RunAsyncParts this runs in a blockable thread, which
+  // waits for the transfers of each step of the algorithm in turn.
+  Status s = GetTaskDevices(*col_params_, &task_devices_);
+  if (s.ok()) {
+    const int my_rank = col_params_->default_rank;
+    for (task_idx_ = 0; task_idx_ < task_devices_.size(); ++task_idx_) {
+      const std::vector<int>& devices = task_devices_[task_idx_];
+      local_idx_ = 0;
+      while (local_idx_ < devices.size() && devices[local_idx_] != my_rank) {
+        ++local_idx_;
+      }
+      if (local_idx_ < devices.size()) break;
+    }
+    if (task_idx_ == task_devices_.size()) {
+      s = errors::Internal("Device rank ", my_rank,
+                           " not found in HierarchicalRingReduce group");
+    }
+  }
+  if (!s.ok()) {
+    StartAbort(s);
+    return false;
+  }
+  const int num_tasks = task_devices_.size();
+  const int devs_per_task = task_devices_.front().size();
+  const std::vector<int>& local_devices = task_devices_[task_idx_];
+  // The output is divided into devs_per_task shards of num_tasks chunks each;
+  // shard i is made of chunks [i * num_tasks, (i + 1) * num_tasks).
+  const int num_chunks = devs_per_task * num_tasks;
+  AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
+  ca_.reset(MakeCollectiveAdapter(col_ctx_->output, num_chunks,
+                                  col_ctx_->device->GetAllocator(attr)));
+
+  // The shard this device reduces across tasks, and its ring neighbors.
+  const int my_shard = (local_idx_ + 1) % devs_per_task;
+  const int next_local = local_devices[(local_idx_ + 1) % devs_per_task];
+  const int prev_local =
+      local_devices[(local_idx_ + devs_per_task - 1) % devs_per_task];
+  const int next_task = task_devices_[(task_idx_ + 1) % num_tasks][local_idx_];
+  const int prev_task =
+      task_devices_[(task_idx_ + num_tasks - 1) % num_tasks][local_idx_];
+  auto shard = [devs_per_task](int i) {
+    return ((i % devs_per_task) + devs_per_task) % devs_per_task;
+  };
+  auto piece = [num_tasks](int j) {
+    return ((j % num_tasks) + num_tasks) % num_tasks;
+  };
+  auto shard_piece = [this, num_tasks, my_shard](int j) {
+    std::vector<int> chunks;
+    const int chunk_idx = my_shard * num_tasks + j;
+    if (ca_->ChunkBytes(chunk_idx) > 0) chunks.push_back(chunk_idx);
+    return chunks;
+  };
+
+  // Allocate the temporary buffers for every reduction step up front:
+  // indices [0, num_chunks) for the intra-task steps and the chunks of
+  // my_shard offset by num_chunks for the inter-task steps.
+  tmp_chunks_.clear();
+  tmp_chunks_.resize(2 * num_chunks);
+  for (int step = 0; step < devs_per_task - 1; ++step) {
+    for (int chunk_idx : ShardChunks(shard(local_idx_ - step - 1))) {
+      tmp_chunks_[chunk_idx] = ca_->TempChunk(chunk_idx);
+    }
+  }
+  for (int chunk_idx : ShardChunks(my_shard)) {
+    tmp_chunks_[num_chunks + chunk_idx] = ca_->TempChunk(chunk_idx);
+  }
+  const DeviceBase::GpuDeviceInfo* gpu_info =
+      col_ctx_->device->tensorflow_gpu_device_info();
+  if (gpu_info) {
+    // As in RingReducer, make sure the temporary buffers are valid before
+    // any transfer writes to them.
+    profiler::TraceMe activity("WaitForQueuedEvents",
+                               profiler::TraceMeLevel::kInfo);
+    Notification note;
+    s = gpu_info->default_context->ThenExecute(
+        col_ctx_->device, gpu_info->stream, [&note]() { note.Notify(); });
+    if (s.ok()) {
+      note.WaitForNotification();
+    } else {
+      mutex_lock l(status_mu_);
+      status_ = errors::Internal(
+          "Failed to dispatch ThenExecute in HierarchicalRingReducer");
+      return false;
+    }
+  }
+
+  profiler::TraceMe activity("HierarchicalRingReduce",
+                             profiler::TraceMeLevel::kInfo);
+  bool ok = true;
+  // After step s device local_idx_ holds the partial sum over the task of
+  // shard local_idx_ - s - 1, so it ends with the task sum of my_shard.
+  for (int step = 0; ok && step < devs_per_task - 1; ++step) {
+    ok = RunStep(kIntraTaskReduceScatter, step, next_local,
+                 ShardChunks(shard(local_idx_ - step)), prev_local,
+                 ShardChunks(shard(local_idx_ - step - 1)), /*reduce=*/true);
+  }
+  // Ring all-reduce of my_shard across tasks, one chunk per step.
+  for (int step = 0; ok && step < num_tasks - 1; ++step) {
+    ok = RunStep(kInterTaskReduceScatter, step, next_task,
+                 shard_piece(piece(task_idx_ - step)), prev_task,
+                 shard_piece(piece(task_idx_ - step - 1)), /*reduce=*/true);
+  }
+  if (ok && col_params_->final_op) {
+    // Chunk task_idx_ + 1 of my_shard now holds the value reduced over the
+    // whole group.
+    for (int chunk_idx : shard_piece(piece(task_idx_ + 1))) {
+      group_size_tensor_ready_.WaitForNotification();
+      Tensor chunk = ca_->ChunkAlias(chunk_idx);
+      s = collective_util::ComputeBinOp(
+          col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+          col_params_->final_op, &chunk, &group_size_tensor_);
+      if (!s.ok()) {
+        StartAbort(s);
+        ok = false;
+      }
+    }
+  }
+  for (int step = 0; ok && step < num_tasks - 1; ++step) {
+    ok = RunStep(kInterTaskAllGather, step, next_task,
+                 shard_piece(piece(task_idx_ + 1 - step)), prev_task,
+                 shard_piece(piece(task_idx_ - step)), /*reduce=*/false);
+  }
+  for (int step = 0; ok && step < devs_per_task - 1; ++step) {
+    ok = RunStep(kIntraTaskAllGather, step, next_local,
+                 ShardChunks(shard(local_idx_ + 1 - step)), prev_local,
+                 ShardChunks(shard(local_idx_ - step)), /*reduce=*/false);
+  }
+  tmp_chunks_.clear();
+
+  VLOG(2) << this << " device=" << col_ctx_->device_name << " finish;"
+          << " final value " << TensorDebugString(ca_->Value());
+  return ok;
+}
+
+namespace {
+REGISTER_COLLECTIVE(HierarchicalRingReduce, HierarchicalRingReducer);
+}  // namespace
+
+}  // namespace tensorflow
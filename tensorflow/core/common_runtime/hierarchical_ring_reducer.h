@@ -0,0 +1,71 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/ring_reducer.h"
+#include "tensorflow/core/framework/collective.h"
+
+namespace tensorflow {
+
+// Two-level ring implementation of collective all-reduce, for groups whose
+// tasks all have the same number of devices.
+//
+// The tensor is split into one shard per device of a task.  First the
+// devices of each task reduce-scatter the shards along an intra-task ring.
+// Then the devices holding the same shard in each task all-reduce it along
+// an inter-task ring.  Finally the devices of each task all-gather the
+// shards along the intra-task ring again.  Compared to RingReducer this
+// divides the bytes sent between tasks by the number of devices per task.
+//
+// Selected for reductions with communication_hint "hierarchical_ring".
+class HierarchicalRingReducer : public RingReducer {
+ public:
+  HierarchicalRingReducer() {}
+  ~HierarchicalRingReducer() override {}
+
+  // Checks that all tasks of the group have the same number of devices.
+  Status InitializeCollectiveParams(CollectiveParams* col_params) override;
+
+ protected:
+  bool RunAsyncParts() override;
+
+ private:
+  // Sends "send_chunks" to the device with index "send_to_dev_idx" while
+  // receiving "recv_chunks" from "recv_from_dev_idx", then merges the
+  // received values into the output if "reduce" or else stores them as
+  // they are.  Blocks until all transfers are done; returns false if the
+  // collective was aborted.
+  bool RunStep(int phase, int step, int send_to_dev_idx,
+               const std::vector<int>& send_chunks, int recv_from_dev_idx,
+               const std::vector<int>& recv_chunks, bool reduce);
+
+  // Returns the indices of the output chunks forming shard "shard_idx".
+  std::vector<int> ShardChunks(int shard_idx) const;
+
+  // Device indices of each task, in group order.
+  std::vector<std::vector<int>> task_devices_;
+  int task_idx_ = -1;   // Task of this device.
+  int local_idx_ = -1;  // Position of this device within its task.
+  std::vector<Tensor> tmp_chunks_;
+
+  friend class RingReducerTest;
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/immutable_executor_state.h"
 
+#include <algorithm>
+
 #include "absl/memory/memory.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -128,6 +130,8 @@ Status ImmutableExecutorState::Initialize(const Graph& graph) {
 
     item->input_start = frame_info->total_inputs;
     frame_info->total_inputs += n->num_inputs();
+    max_num_inputs_ = std::max(max_num_inputs_, n->num_inputs());
+    max_num_outputs_ = std::max(max_num_outputs_, n->num_outputs());
 
     Status s = params_.create_kernel(n->properties(), &item->kernel);
     if (!s.ok()) {
@@ -101,6 +101,11 @@ class ImmutableExecutorState {
 
   bool requires_control_flow_support() const { return requires_control_flow_; }
 
+  // The largest number of inputs and outputs of a node in the graph, used to
+  // size the per-node scratch vectors of the executor once up front.
+  int max_num_inputs() const { return max_num_inputs_; }
+  int max_num_outputs() const { return max_num_outputs_; }
+
   // Copies the pending counts for nodes in this graph to the given array.
   //
   // This method provides a more efficient way of initializing
@@ -132,6 +137,8 @@ class ImmutableExecutorState {
   LocalExecutorParams params_;
   GraphView gview_;
   bool requires_control_flow_;
+  int max_num_inputs_ = 0;
+  int max_num_outputs_ = 0;
   std::vector<PendingCounts::Handle> pending_ids_;
 
   // Root nodes (with no in edges) that should form the initial ready queue
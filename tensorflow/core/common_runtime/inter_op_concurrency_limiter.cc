@@ -0,0 +1,78 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/inter_op_concurrency_limiter.h"
+
+#include <atomic>
+#include <utility>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+std::atomic<int> num_busy_limiters{0};
+
+}  // namespace
+
+InterOpConcurrencyLimiter::InterOpConcurrencyLimiter(thread::ThreadPool* pool,
+                                                     int max_concurrency)
+    : state_(std::make_shared<State>(pool, max_concurrency)) {
+  DCHECK_GT(max_concurrency, 0);
+}
+
+void InterOpConcurrencyLimiter::Schedule(std::function<void()> fn) {
+  {
+    mutex_lock l(state_->mu);
+    if (state_->num_running >= state_->max_concurrency) {
+      state_->queue.push_back(std::move(fn));
+      return;
+    }
+    if (state_->num_running++ == 0) ++num_busy_limiters;
+  }
+  ScheduleOnPool(state_, std::move(fn));
+}
+
+int64 InterOpConcurrencyLimiter::NumQueued() const {
+  mutex_lock l(state_->mu);
+  return state_->queue.size();
+}
+
+/* static */ int InterOpConcurrencyLimiter::NumBusyLimiters() {
+  return num_busy_limiters.load(std::memory_order_relaxed);
+}
+
+void InterOpConcurrencyLimiter::ScheduleOnPool(std::shared_ptr<State> state,
+                                               std::function<void()> fn) {
+  thread::ThreadPool* pool = state->pool;
+  pool->Schedule([state = std::move(state), fn = std::move(fn)]() {
+    fn();
+    std::function<void()> next;
+    {
+      mutex_lock l(state->mu);
+      if (state->queue.empty()) {
+        if (--state->num_running == 0) --num_busy_limiters;
+        return;
+      }
+      next = std::move(state->queue.front());
+      state->queue.pop_front();
+    }
+    // Rather than running `next` on this thread, put it behind the closures
+    // that other sessions have scheduled meanwhile.
+    ScheduleOnPool(state, std::move(next));
+  });
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,86 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_INTER_OP_CONCURRENCY_LIMITER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_INTER_OP_CONCURRENCY_LIMITER_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Schedules the inter-op closures of one session on a thread pool that may be
+// shared with other sessions (see ThreadPoolOptionProto.global_name), running
+// at most `max_concurrency` of them at a time.
+//
+// Closures beyond the cap wait in a queue of their own session instead of in
+// the pool, and each one that finishes schedules the next queued one at the
+// back of the pool's queue. A busy session thus cannot take over the threads
+// of a shared pool, and the threads are shared fairly among the sessions with
+// pending work.
+//
+// Closures that block until other closures of the same session run (e.g.
+// synchronous kernels waiting on a queue) can deadlock if `max_concurrency`
+// is too small.
+class InterOpConcurrencyLimiter {
+ public:
+  // `pool` is not owned and must outlive the closures scheduled on it. The
+  // limiter itself may be destroyed while they still run.
+  InterOpConcurrencyLimiter(thread::ThreadPool* pool, int max_concurrency);
+
+  void Schedule(std::function<void()> fn);
+
+  // Returns the number of closures waiting for one of the session's slots.
+  int64 NumQueued() const;
+
+  // Returns the number of limiters in the process that have closures running.
+  // Intra-op parallelism can be divided by it so that the sessions sharing
+  // the cores do not each shard their kernels over all of them.
+  static int NumBusyLimiters();
+
+ private:
+  struct State {
+    State(thread::ThreadPool* pool, int max_concurrency)
+        : pool(pool), max_concurrency(max_concurrency) {}
+
+    thread::ThreadPool* const pool;  // Not owned.
+    const int max_concurrency;
+
+    mutex mu;
+    int num_running TF_GUARDED_BY(mu) = 0;
+    std::deque<std::function<void()>> queue TF_GUARDED_BY(mu);
+  };
+
+  // Runs `fn` on the pool, then hands its slot to the next queued closure, if
+  // any.
+  static void ScheduleOnPool(std::shared_ptr<State> state,
+                             std::function<void()> fn);
+
+  // Shared with the scheduled closures.
+  const std::shared_ptr<State> state_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(InterOpConcurrencyLimiter);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_INTER_OP_CONCURRENCY_LIMITER_H_
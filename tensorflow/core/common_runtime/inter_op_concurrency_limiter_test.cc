@@ -0,0 +1,112 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/inter_op_concurrency_limiter.h"
+
+#include <atomic>
+
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/notification.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(InterOpConcurrencyLimiterTest, RunsAtMostMaxConcurrencyClosures) {
+  thread::ThreadPool pool(Env::Default(), "test", 8);
+  InterOpConcurrencyLimiter limiter(&pool, 2);
+  constexpr int kNumClosures = 50;
+  std::atomic<int> running(0);
+  std::atomic<int> max_running(0);
+  BlockingCounter done(kNumClosures);
+  for (int i = 0; i < kNumClosures; ++i) {
+    limiter.Schedule([&]() {
+      const int now_running = ++running;
+      int prev_max = max_running.load();
+      while (now_running > prev_max &&
+             !max_running.compare_exchange_weak(prev_max, now_running)) {
+      }
+      Env::Default()->SleepForMicroseconds(100);
+      --running;
+      done.DecrementCount();
+    });
+  }
+  done.Wait();
+  EXPECT_LE(max_running.load(), 2);
+  EXPECT_EQ(limiter.NumQueued(), 0);
+}
+
+TEST(InterOpConcurrencyLimiterTest, OtherSessionsRunWhileOneIsBusy) {
+  thread::ThreadPool pool(Env::Default(), "test", 2);
+  InterOpConcurrencyLimiter busy(&pool, 1);
+  InterOpConcurrencyLimiter idle(&pool, 1);
+  Notification release;
+  busy.Schedule([&]() { release.WaitForNotification(); });
+  for (int i = 0; i < 10; ++i) {
+    busy.Schedule([]() {});
+  }
+  EXPECT_EQ(busy.NumQueued(), 10);
+
+  // The busy session only holds one of the two threads.
+  Notification ran;
+  idle.Schedule([&]() { ran.Notify(); });
+  ran.WaitForNotification();
+  release.Notify();
+}
+
+TEST(InterOpConcurrencyLimiterTest, CountsBusyLimiters) {
+  thread::ThreadPool pool(Env::Default(), "test", 2);
+  InterOpConcurrencyLimiter first(&pool, 1);
+  InterOpConcurrencyLimiter second(&pool, 1);
+  const int num_busy = InterOpConcurrencyLimiter::NumBusyLimiters();
+  Notification release;
+  BlockingCounter started(2);
+  BlockingCounter done(2);
+  first.Schedule([&]() {
+    started.DecrementCount();
+    release.WaitForNotification();
+    done.DecrementCount();
+  });
+  second.Schedule([&]() {
+    started.DecrementCount();
+    release.WaitForNotification();
+    done.DecrementCount();
+  });
+  started.Wait();
+  EXPECT_EQ(InterOpConcurrencyLimiter::NumBusyLimiters(), num_busy + 2);
+  release.Notify();
+  done.Wait();
+}
+
+TEST(InterOpConcurrencyLimiterTest, OutlivedByScheduledClosures) {
+  thread::ThreadPool pool(Env::Default(), "test", 1);
+  Notification release;
+  BlockingCounter done(3);
+  {
+    InterOpConcurrencyLimiter limiter(&pool, 1);
+    limiter.Schedule([&]() {
+      release.WaitForNotification();
+      done.DecrementCount();
+    });
+    limiter.Schedule([&]() { done.DecrementCount(); });
+    limiter.Schedule([&]() { done.DecrementCount(); });
+  }
+  release.Notify();
+  done.Wait();
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -20,6 +20,7 @@ limitations under the License.
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/common_runtime/process_state.h"
 #include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/cpu_feature_guard.h"
@@ -106,9 +107,31 @@ struct LocalDevice::EigenThreadPoolInfo {
     delete eigen_worker_threads_.workers;
   }
 
+  // Returns the pool that runs the kernels of the devices on `numa_node`, which
+  // is created on first use.
+  thread::ThreadPool* GetInterOpThreadPool(const SessionOptions& options,
+                                           int numa_node) {
+    if (!inter_op_threads_) {
+      int32 num_threads = options.config.inter_op_parallelism_threads();
+      if (num_threads <= 0) num_threads = NumInterOpThreadsFromEnvironment();
+      if (num_threads <= 0) num_threads = port::MaxParallelism(numa_node);
+      ThreadOptions thread_opts;
+      thread_opts.numa_node = numa_node;
+      VLOG(1) << "Creating " << num_threads
+              << " inter op threads for NUMA node " << numa_node;
+      inter_op_threads_.reset(new thread::ThreadPool(
+          options.env, thread_opts,
+          strings::StrCat("numa_", numa_node, "_Compute"), num_threads,
+          !options.config.experimental().disable_thread_spinning(),
+          /*allocator=*/nullptr));
+    }
+    return inter_op_threads_.get();
+  }
+
   DeviceBase::CpuWorkerThreads eigen_worker_threads_;
   std::unique_ptr<Eigen::ThreadPoolDevice> eigen_device_;
   std::unique_ptr<EigenAllocator> eigen_allocator_;
+  std::unique_ptr<thread::ThreadPool> inter_op_threads_;
 };
 
 LocalDevice::LocalDevice(const SessionOptions& options,
@@ -139,6 +162,13 @@ LocalDevice::LocalDevice(const SessionOptions& options,
             options, numa_node, numa_allocator);
       }
       tp_info = global_tp_info_[numa_node];
+      if (options.config.experimental().use_numa_inter_op_thread_pools() &&
+          attributes.device_type() == DEVICE_CPU) {
+        // Run the kernels on threads of the same NUMA node as the memory of
+        // the device, instead of on the session's inter op threads.
+        set_tensorflow_device_thread_pool(
+            tp_info->GetInterOpThreadPool(options, numa_node));
+      }
     } else {
       if (global_tp_info_.empty()) {
         global_tp_info_.push_back(new LocalDevice::EigenThreadPoolInfo(
@@ -47,6 +47,11 @@ struct LocalExecutorParams {
                        OpKernel**)>
       create_kernel;
   std::function<void(OpKernel*)> delete_kernel;
+
+  // If true and the device is a CPU, the outputs of the nodes are placed into
+  // a per-step arena planned from the output sizes of the first steps. See
+  // StaticMemoryPlanner.
+  bool use_static_memory_plan = false;
 };
 
 }  // end namespace tensorflow
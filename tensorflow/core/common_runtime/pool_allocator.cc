@@ -21,6 +21,7 @@ limitations under the License.
 #include <sys/mman.h>  // for munmap
 #endif
 
+#include <algorithm>
 #include <map>
 #include <utility>
 
@@ -260,6 +261,11 @@ void PoolAllocator::EvictOne() {
 void* BasicCPUAllocator::Alloc(size_t alignment, size_t num_bytes,
                                size_t* bytes_received) {
   void* ptr = nullptr;
+  if (use_huge_pages_) {
+    alignment = std::max(alignment, port::kHugePageSize);
+    num_bytes =
+        (num_bytes + port::kHugePageSize - 1) & ~(port::kHugePageSize - 1);
+  }
   *bytes_received = num_bytes;
   if (num_bytes > 0) {
     if (numa_node_ == port::kNUMANoAffinity) {
@@ -268,6 +274,16 @@ void* BasicCPUAllocator::Alloc(size_t alignment, size_t num_bytes,
       ptr =
           port::NUMAMalloc(numa_node_, num_bytes, static_cast<int>(alignment));
     }
+    if (use_huge_pages_ && ptr != nullptr) {
+      port::AdviseHugePages(ptr, num_bytes);
+      // Fault the pages in now, on the NUMA node of the caller, rather than on
+      // the first touch by whichever op gets the memory.
+      char* bytes = static_cast<char*>(ptr);
+      // Touches every regular 4KiB page, in case huge pages are unavailable.
+      for (size_t i = 0; i < num_bytes; i += 4096) {
+        bytes[i] = 0;
+      }
+    }
     VisitAlloc(ptr, numa_node_, num_bytes);
   }
   return ptr;
@@ -149,9 +149,16 @@ class Pow2Rounder : public RoundUpInterface {
 
 class BasicCPUAllocator : public SubAllocator {
  public:
+  // If `use_huge_pages` is true, allocations are rounded up to whole huge
+  // pages (see port::kHugePageSize), backed by transparent huge pages where
+  // the platform supports them, and faulted in before they are returned. This
+  // suits a BFCAllocator, which gets few large regions from its SubAllocator.
   BasicCPUAllocator(int numa_node, const std::vector<Visitor>& alloc_visitors,
-                    const std::vector<Visitor>& free_visitors)
-      : SubAllocator(alloc_visitors, free_visitors), numa_node_(numa_node) {}
+                    const std::vector<Visitor>& free_visitors,
+                    bool use_huge_pages = false)
+      : SubAllocator(alloc_visitors, free_visitors),
+        numa_node_(numa_node),
+        use_huge_pages_(use_huge_pages) {}
 
   ~BasicCPUAllocator() override {}
 
@@ -162,6 +169,7 @@ class BasicCPUAllocator : public SubAllocator {
 
  private:
   int numa_node_;
+  bool use_huge_pages_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(BasicCPUAllocator);
 };
@@ -391,6 +391,7 @@ Status SetArgShape(
 // Returns the local tensors referred by `args`.
 std::vector<Tensor> GetLocalArgs(gtl::ArraySlice<FunctionArg> args) {
   std::vector<Tensor> tensors;
+  tensors.reserve(args.size());
   for (const auto& arg : args) {
     if (arg.index() == 0) {
       tensors.push_back(absl::get<Tensor>(arg));
@@ -405,8 +406,9 @@ FunctionLibraryRuntime::DoneCallback TensorsToFunctionRetsDoneCallback(
     FunctionLibraryRuntime::DoneCallback done) {
   return [rets, tensors, done = std::move(done)](const Status& s) {
     if (s.ok()) {
-      for (const auto& t : *tensors) {
-        rets->push_back(t);
+      rets->reserve(rets->size() + tensors->size());
+      for (auto& t : *tensors) {
+        rets->push_back(std::move(t));
       }
     }
     delete tensors;
@@ -1100,6 +1102,8 @@ void ProcessFunctionLibraryRuntime::RunMultiDevice(
     refcounted_done->Ref();
   }
 
+  rets->resize(data->num_outputs_);
+
   FunctionLibraryRuntime::Options opts_copy = opts;
   for (const auto& pair : data->glue_) {
     const string& target = pair.first;
@@ -1111,6 +1115,7 @@ void ProcessFunctionLibraryRuntime::RunMultiDevice(
     opts_copy.cancellation_manager = cm;
 
     InternalArgs comp_args;
+    comp_args.args.reserve(comp_data.arg_indices.size());
     Status s = get_component_args(comp_data, &comp_args);
     if (!s.ok()) {
       VLOG(2) << "Failed to get component function arguments: " << s;
@@ -1120,13 +1125,14 @@ void ProcessFunctionLibraryRuntime::RunMultiDevice(
       continue;
     }
     std::vector<FunctionRet>* comp_rets = new std::vector<FunctionRet>;
-    rets->resize(data->num_outputs_);
 
-    auto component_fn_callback = [comp_rets, rets, comp_data, refcounted_done,
-                                  cm, local_cm, data, handle,
-                                  target](const Status& status) {
+    // `comp_data` and `target` are owned by `data`, which outlives the call,
+    // so the callback refers to them instead of copying them on every run.
+    auto component_fn_callback = [comp_rets, rets, comp_data = &comp_data,
+                                  refcounted_done, cm, local_cm, data, handle,
+                                  target = &target](const Status& status) {
       if (!status.ok()) {
-        VLOG(2) << "Component function execution on target " << target
+        VLOG(2) << "Component function execution on target " << *target
                 << " from " << data->function_name_ << " with handle " << handle
                 << " failed: " << status;
         const string function_and_msg = strings::StrCat(
@@ -1136,11 +1142,11 @@ void ProcessFunctionLibraryRuntime::RunMultiDevice(
         // Cancel the execution of other component functions.
         cm->StartCancel();
       } else {
-        VLOG(2) << "Component function execution on target " << target
+        VLOG(2) << "Component function execution on target " << *target
                 << " from " << data->function_name_ << " with handle " << handle
                 << " succeeded.";
         for (int i = 0; i < comp_rets->size(); ++i) {
-          (*rets)[comp_data.ret_indices[i]] = (*comp_rets)[i];
+          (*rets)[comp_data->ret_indices[i]] = std::move((*comp_rets)[i]);
         }
       }
       delete comp_rets;
@@ -1393,9 +1399,10 @@ void ProcessFunctionLibraryRuntime::Run(
   done = [rets, function_rets, done = std::move(done)](const Status& s) {
     Status status = s;
     if (status.ok()) {
-      for (const auto& ret : *function_rets) {
+      rets->reserve(rets->size() + function_rets->size());
+      for (auto& ret : *function_rets) {
         if (ret.index() == 0) {
-          rets->push_back(absl::get<Tensor>(ret));
+          rets->push_back(std::move(absl::get<Tensor>(ret)));
         } else {
           status.Update(errors::Internal(
               "Expect a Tensor as a function output but got a TensorShape."));
@@ -1444,6 +1451,7 @@ void ProcessFunctionLibraryRuntime::Run(
                           std::move(done), std::move(get_component_args));
   }
   std::vector<FunctionArg> local_args;
+  local_args.reserve(args.size());
   for (const auto& tensor : args) {
     local_args.push_back(tensor);
   }
@@ -15,12 +15,14 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/process_state.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <vector>
 
 #include "absl/base/call_once.h"
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
+#include "tensorflow/core/common_runtime/chunk_arena_allocator.h"
 #include "tensorflow/core/common_runtime/pool_allocator.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/log_memory.h"
@@ -82,12 +84,22 @@ Allocator* ProcessState::GetCPUAllocator(int numa_node) {
     if (!status.ok()) {
       LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
     }
+    // Backing the BFCAllocator regions with huge pages reduces the TLB misses
+    // of ops walking large tensors, e.g. embedding lookups.
+    bool use_huge_pages = false;
+    if (use_bfc_allocator) {
+      status = ReadBoolFromEnvVar("TF_CPU_BFC_USE_HUGE_PAGES", false,
+                                  &use_huge_pages);
+      if (!status.ok()) {
+        LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
+      }
+    }
     Allocator* allocator = nullptr;
     SubAllocator* sub_allocator =
         (numa_enabled_ || alloc_visitors_defined || use_bfc_allocator)
             ? new BasicCPUAllocator(
                   numa_enabled_ ? numa_node : port::kNUMANoAffinity,
-                  cpu_alloc_visitors_, cpu_free_visitors_)
+                  cpu_alloc_visitors_, cpu_free_visitors_, use_huge_pages)
             : nullptr;
     if (use_bfc_allocator) {
       // TODO(reedwm): evaluate whether 64GB by default is the best choice.
@@ -99,12 +111,20 @@ Allocator* ProcessState::GetCPUAllocator(int numa_node) {
         LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
       }
       int64 cpu_mem_limit = cpu_mem_limit_in_mb * (1LL << 20);
+      int64 small_allocation_cache_bytes = 0;
+      status = ReadInt64FromEnvVar("TF_CPU_BFC_SMALL_ALLOCATION_CACHE_BYTES",
+                                   0, &small_allocation_cache_bytes);
+      if (!status.ok()) {
+        LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
+      }
       DCHECK(sub_allocator);
-      allocator =
-          new BFCAllocator(sub_allocator, cpu_mem_limit, /*allow_growth=*/true,
-                           /*name=*/"bfc_cpu_allocator_for_gpu");
+      allocator = new BFCAllocator(
+          sub_allocator, cpu_mem_limit, /*allow_growth=*/true,
+          /*name=*/"bfc_cpu_allocator_for_gpu", /*garbage_collection=*/false,
+          std::max<int64>(small_allocation_cache_bytes, 0));
       VLOG(2) << "Using BFCAllocator with memory limit of "
-              << cpu_mem_limit_in_mb << " MB for ProcessState CPU allocator";
+              << cpu_mem_limit_in_mb << " MB for ProcessState CPU allocator"
+              << (use_huge_pages ? ", backed by huge pages" : "");
     } else if (sub_allocator) {
       DCHECK(sub_allocator);
       allocator =
@@ -117,6 +137,25 @@ Allocator* ProcessState::GetCPUAllocator(int numa_node) {
       DCHECK(!sub_allocator);
       allocator = cpu_allocator_base();
     }
+    int64 arena_max_allocation_bytes = 0;
+    status = ReadInt64FromEnvVar("TF_CPU_SMALL_ALLOCATION_ARENA_BYTES", 0,
+                                 &arena_max_allocation_bytes);
+    if (!status.ok()) {
+      LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
+    }
+    if (arena_max_allocation_bytes > 0) {
+      // Bump-allocate small tensors out of chunks holding at least 16 of them.
+      const size_t min_chunk_size = 16 * arena_max_allocation_bytes;
+      size_t chunk_size = 64 << 10;
+      while (chunk_size < min_chunk_size) {
+        chunk_size <<= 1;
+      }
+      allocator = new ChunkArenaAllocator(allocator, arena_max_allocation_bytes,
+                                          chunk_size, /*max_free_chunks=*/64);
+      VLOG(2) << "Serving CPU allocations of at most "
+              << arena_max_allocation_bytes << " bytes from " << chunk_size
+              << " byte chunks";
+    }
     if (LogMemory::IsEnabled() && !allocator->TracksAllocationSizes()) {
       // Wrap the allocator to track allocation ids for better logging
       // at the cost of performance.
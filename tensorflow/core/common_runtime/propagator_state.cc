@@ -661,8 +661,14 @@ PropagatorState::FrameState::IncrementIteration(TaggedNodeSeq* ready) {
   iteration_count++;
 
   // Initialize the next iteration.
-  IterationState* next_iter =
-      new IterationState(iteration_count, pending_counts, total_input_tensors);
+  IterationState* next_iter = free_iteration;
+  if (next_iter != nullptr) {
+    free_iteration = nullptr;
+    next_iter->Reset(iteration_count, pending_counts, total_input_tensors);
+  } else {
+    next_iter = new IterationState(iteration_count, pending_counts,
+                                   total_input_tensors);
+  }
   SetIteration(iteration_count, next_iter);
   num_outstanding_iterations++;
   dead_exits.clear();
@@ -680,7 +686,11 @@ bool PropagatorState::FrameState::CleanupIterations(IterationState* iter_state,
                                                     TaggedNodeSeq* ready) {
   int64 curr_iter = iter_state->iter_num;
   while (curr_iter <= iteration_count && IsIterationDone(iter_state)) {
-    delete iter_state;
+    if (free_iteration == nullptr) {
+      free_iteration = iter_state;
+    } else {
+      delete iter_state;
+    }
     SetIteration(curr_iter, nullptr);
     --num_outstanding_iterations;
     ++curr_iter;
@@ -130,7 +130,20 @@ class PropagatorState {
           counts(*pending_counts) {  // Initialize with copy of *pending_counts
     }
 
-    const int64 iter_num;  // The index of this iteration in the enclosing loop.
+    // Reuses the state of a done iteration for iteration `iter_num` of the
+    // same frame, avoiding new allocations.
+    void Reset(int64 iter_num, const PendingCounts* pending_counts,
+               int total_input_tensors) {
+      this->iter_num = iter_num;
+      for (int i = 0; i < total_input_tensors; ++i) {
+        input_tensors[i].ClearVal();
+      }
+      outstanding_ops = 0;
+      outstanding_frame_count = 0;
+      counts.CopyFrom(*pending_counts);
+    }
+
+    int64 iter_num;  // The index of this iteration in the enclosing loop.
 
     // One copy per iteration. For iteration k, i-th node's j-th input is in
     // input_tensors[k][immutable_state_.nodes[i].input_start + j]. An entry is
@@ -256,6 +269,11 @@ class PropagatorState {
     IterationState** const iterations_raw TF_GUARDED_BY(mu);
     IterationState* iterations_first TF_GUARDED_BY(mu);
 
+    // The state of the last done iteration, kept to start the next one. Loops
+    // with many short iterations would otherwise allocate the pending counts
+    // and input tensors of each iteration anew.
+    IterationState* free_iteration TF_GUARDED_BY(mu) = nullptr;
+
    public:
     // The NextIteration nodes to enter a new iteration. If the number of
     // outstanding iterations reaches the limit, we will defer the start of
@@ -386,6 +404,7 @@ class PropagatorState {
         delete iterations[i];
         iterations[i] = nullptr;
       }
+      delete free_iteration;
     }
 
    private:
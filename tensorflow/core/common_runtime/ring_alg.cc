@@ -393,7 +393,8 @@ void RingAlg::DispatchSend(RingField* rf, const StatusCallback& done) {
       col_params_->group.device_names[send_to_dev_idx],
       col_params_->group.task_names[send_to_dev_idx], send_buf_key,
       col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
-      col_ctx_->op_ctx->output_alloc_attr(0), &rf->chunk,
+      col_ctx_->op_ctx->output_alloc_attr(0),
+      rf->wire_chunk.IsInitialized() ? &rf->wire_chunk : &rf->chunk,
       col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
       done);
 }
@@ -409,6 +410,7 @@ void RingAlg::DispatchRecv(RingField* rf, const StatusCallback& done) {
   Tensor* dst_tensor = (!rf->second_pass && (col_params_->merge_op != nullptr))
                            ? &rf->tmp_chunk
                            : &rf->chunk;
+  if (rf->wire_chunk.IsInitialized()) dst_tensor = &rf->wire_chunk;
   col_ctx_->col_exec->remote_access()->RecvFromPeer(
       col_params_->group.device_names[rf->recv_dev_idx],
       col_params_->group.task_names[rf->recv_dev_idx],
@@ -81,6 +81,7 @@ class RingAlg : public CollectiveImplementationInterface {
     bool is_final = false;  // is the last field in the pass for this rank
     Tensor chunk;           // alias to field values
     Tensor tmp_chunk;
+    Tensor wire_chunk;  // if initialized, chunk values as sent and received
     Status status;
     string DebugString() const;
   };
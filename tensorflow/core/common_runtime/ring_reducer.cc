@@ -49,6 +49,24 @@ Status RingReducer::InitializeCollectiveParams(CollectiveParams* col_params) {
   // TODO(b/113171733): change CHECKs to return errors.
   CHECK_EQ(col_params->instance.type, REDUCTION_COLLECTIVE);
   CHECK_EQ(col_params->instance.impl_details.collective_name, "RingReduce");
+  const DataType wire_type = col_params->instance.impl_details.wire_data_type;
+  if (wire_type != DT_INVALID) {
+    if (wire_type != DT_HALF && wire_type != DT_BFLOAT16) {
+      return errors::InvalidArgument("Unsupported wire type ",
+                                     DataTypeString(wire_type),
+                                     " for RingReduce");
+    }
+    if (col_params->instance.data_type != DT_FLOAT) {
+      return errors::InvalidArgument(
+          "RingReduce wire compression requires float input, got ",
+          DataTypeString(col_params->instance.data_type));
+    }
+    if (col_params->group.device_type != DEVICE_CPU) {
+      return errors::Unimplemented(
+          "RingReduce wire compression is only implemented on CPU, got ",
+          col_params->group.device_type.type_string());
+    }
+  }
   return RingAlg::InitializeCollectiveParams(col_params);
 }
 
@@ -167,6 +185,48 @@ void RingReducer::InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
   if (rf->do_recv) {
     rf->tmp_chunk = ca_->TempChunk(rf->sc_idx);
   }
+  const DataType wire_type = col_params_->instance.impl_details.wire_data_type;
+  if (wire_type != DT_INVALID && rf->chunk.IsInitialized()) {
+    rf->wire_chunk = Tensor(
+        col_ctx_->device->GetAllocator(col_ctx_->op_ctx->output_alloc_attr(0)),
+        wire_type, TensorShape({rf->chunk.NumElements()}));
+  }
+}
+
+namespace {
+template <typename WireT>
+void EncodeChunk(bool round_in_place, Tensor* chunk, Tensor* wire_chunk) {
+  wire_chunk->flat<WireT>() = chunk->flat<float>().cast<WireT>();
+  if (round_in_place) {
+    chunk->flat<float>() = wire_chunk->flat<WireT>().template cast<float>();
+  }
+}
+
+template <typename WireT>
+void DecodeChunk(const Tensor& wire_chunk, Tensor* dst) {
+  dst->flat<float>() = wire_chunk.flat<WireT>().template cast<float>();
+}
+}  // namespace
+
+void RingReducer::EncodeWireChunk(RingField* rf) {
+  if (!rf->wire_chunk.IsInitialized()) return;
+  if (rf->wire_chunk.dtype() == DT_HALF) {
+    EncodeChunk<Eigen::half>(rf->second_pass, &rf->chunk, &rf->wire_chunk);
+  } else {
+    EncodeChunk<bfloat16>(rf->second_pass, &rf->chunk, &rf->wire_chunk);
+  }
+}
+
+void RingReducer::DecodeWireChunk(RingField* rf) {
+  if (!rf->wire_chunk.IsInitialized()) return;
+  Tensor* dst = (!rf->second_pass && (col_params_->merge_op != nullptr))
+                    ? &rf->tmp_chunk
+                    : &rf->chunk;
+  if (rf->wire_chunk.dtype() == DT_HALF) {
+    DecodeChunk<Eigen::half>(rf->wire_chunk, dst);
+  } else {
+    DecodeChunk<bfloat16>(rf->wire_chunk, dst);
+  }
 }
 
 // At the beginning of the algorithm initialize a RingField struct for
@@ -252,6 +312,7 @@ bool RingReducer::RunAsyncParts() {
           case RF_RECV:
             CHECK_GT(recv_pending_count, 0);
             --recv_pending_count;
+            DecodeWireChunk(rf);
             if (!rf->second_pass) {
               rf->action = RF_REDUCE;
               Status s = collective_util::ComputeBinOp(
@@ -294,6 +355,7 @@ bool RingReducer::RunAsyncParts() {
                 }
                 ready_queue.Enqueue(rf);
               };
+              EncodeWireChunk(rf);
               DispatchSend(rf, send_complete);
               dispatched = true;
               ++send_pending_count;
@@ -45,13 +45,24 @@ class RingReducer : public RingAlg {
   void InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
                      int field_idx) override;
 
- private:
-  void ContinueAfterInputCopy();
-  bool RunAsyncParts();
+  // With wire compression, casts rf->chunk into rf->wire_chunk before a send.
+  // Second pass sends also round rf->chunk itself, so that the rank owning
+  // the final value ends up with exactly what the other ranks receive.
+  void EncodeWireChunk(RingField* rf);
+  // With wire compression, casts a received rf->wire_chunk back into the
+  // tensor DispatchRecv would otherwise have received into.
+  void DecodeWireChunk(RingField* rf);
+
+  // Runs the reduction of the output after the input has been copied to it.
+  // Returns false if it was aborted.
+  virtual bool RunAsyncParts();
 
   Tensor group_size_tensor_;
   Notification group_size_tensor_ready_;
 
+ private:
+  void ContinueAfterInputCopy();
+
   friend class RingReducerTest;
 };
 
@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/device_resolver_local.h"
+#include "tensorflow/core/common_runtime/hierarchical_ring_reducer.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/test_collective_executor_mgr.h"
 #include "tensorflow/core/common_runtime/threadpool_device.h"
@@ -212,8 +213,9 @@ class RingReducerTest : public ::testing::Test {
     col_params_.instance.instance_key = kInstanceKey;
     col_params_.instance.impl_details.subdiv_offsets.clear();
     col_params_.instance.type = REDUCTION_COLLECTIVE;
-    col_params_.instance.impl_details.collective_name = "RingReduce";
+    col_params_.instance.impl_details.collective_name = collective_name_;
     col_params_.instance.data_type = dtype;
+    col_params_.instance.impl_details.wire_data_type = wire_data_type_;
     col_params_.instance.impl_details.subdiv_permutations.resize(num_subdivs);
     col_params_.subdiv_rank.resize(num_subdivs);
     int subdiv_stride = num_devices / num_subdivs;
@@ -367,6 +369,40 @@ class RingReducerTest : public ::testing::Test {
     }
   }
 
+  // Reduces float values that are not exactly representable in wire_type and
+  // checks that the result is close to the exact one and identical on every
+  // device.
+  void RunWireCompressionTest(DataType wire_type, int num_devices,
+                              int tensor_len) {
+    wire_data_type_ = wire_type;
+    Init(/*num_workers=*/1, num_devices, DT_FLOAT, DEVICE_CPU,
+         /*num_subdivs=*/1, /*fail_after=*/0);
+    std::vector<float> expected(tensor_len, 0.0);
+    for (int di = 0; di < static_cast<int>(instances_.size()); ++di) {
+      instances_[di]->InitTensor(
+          DT_FLOAT, TensorShape({tensor_len}), [&expected, di](Tensor* t) {
+            for (int i = 0; i < t->NumElements(); ++i) {
+              float value = di + 0.1f * i;
+              t->flat<float>()(i) = value;
+              expected[i] += value;
+            }
+          });
+    }
+    Reduce(/*fail_after=*/0);
+    const Tensor& first = instances_[0]->tensor_;
+    for (int di = 0; di < static_cast<int>(instances_.size()); ++di) {
+      TF_EXPECT_OK(instances_[di]->status_);
+      auto actual = instances_[di]->tensor_.flat<float>();
+      for (int i = 0; i < tensor_len; ++i) {
+        float exact = expected[i] / num_devices;
+        EXPECT_NEAR(exact, actual(i), 2e-2 * std::abs(exact) + 1e-3)
+            << "Mismatch at device " << di << " index " << i;
+        EXPECT_EQ(first.flat<float>()(i), actual(i))
+            << "Devices disagree at device " << di << " index " << i;
+      }
+    }
+  }
+
   std::unique_ptr<OpKernel> GetCollectiveReduce(const CollectiveParams& params,
                                                 Tensor* input,
                                                 const DeviceType& device_type,
@@ -406,6 +442,25 @@ class RingReducerTest : public ::testing::Test {
     reducer->group_size_tensor_ready_.Notify();  // To unblock destructor.
   }
 
+  Status InitializeRingParams(CollectiveParams* cp) {
+    col_exec_ = nullptr;
+    RingReducer* reducer = new RingReducer;
+    core::ScopedUnref unref(reducer);
+    Status s = reducer->InitializeCollectiveParams(cp);
+    reducer->group_size_tensor_ready_.Notify();  // To unblock destructor.
+    return s;
+  }
+
+  Status InitializeHierarchicalParams(CollectiveParams* cp) {
+    col_exec_ = nullptr;
+    cp->instance.impl_details.collective_name = "HierarchicalRingReduce";
+    HierarchicalRingReducer* reducer = new HierarchicalRingReducer;
+    core::ScopedUnref unref(reducer);
+    Status s = reducer->InitializeCollectiveParams(cp);
+    reducer->group_size_tensor_ready_.Notify();  // To unblock destructor.
+    return s;
+  }
+
   class DeviceInstance {
    public:
     DeviceInstance(int rank, const string& dev_name,
@@ -510,7 +565,11 @@ class RingReducerTest : public ::testing::Test {
       // Prepare a RingReducer instance.
       string exec_key =
           strings::StrCat(col_params_.instance.instance_key, ":0:0");
-      RingReducer* reducer = new RingReducer;
+      RingReducer* reducer =
+          col_params_.instance.impl_details.collective_name ==
+                  "HierarchicalRingReduce"
+              ? new HierarchicalRingReducer
+              : new RingReducer;
       core::ScopedUnref unref(reducer);
       auto col_ctx = std::make_shared<CollectiveContext>(
           parent_->col_exec_, /*nccl_communicator*/ nullptr,
@@ -544,6 +603,8 @@ class RingReducerTest : public ::testing::Test {
   };
 
   bool stop_ = false;
+  string collective_name_ = "RingReduce";
+  DataType wire_data_type_ = DT_INVALID;
   DeviceType device_type_;
   TestCollectiveExecutorMgr col_exec_mgr_;
   CollectiveExecutor* col_exec_;
@@ -684,6 +745,57 @@ TEST_F(RingReducerTest, AutomaticSubdivUpperBound) {
     }                                                                         \
   }
 
+TEST_F(RingReducerTest, WireCompressionHalf) {
+  RunWireCompressionTest(DT_HALF, /*num_devices=*/4, /*tensor_len=*/1001);
+}
+
+TEST_F(RingReducerTest, WireCompressionBfloat16) {
+  RunWireCompressionTest(DT_BFLOAT16, /*num_devices=*/8, /*tensor_len=*/4095);
+}
+
+TEST_F(RingReducerTest, WireCompressionRequiresFloat) {
+  CollectiveParams cp = SetUpCollectiveParams(4, 1);
+  cp.default_rank = 0;
+  cp.group.device_type = DeviceType(DEVICE_CPU);
+  cp.instance.data_type = DT_INT32;
+  cp.instance.impl_details.wire_data_type = DT_HALF;
+  EXPECT_EQ(error::INVALID_ARGUMENT, InitializeRingParams(&cp).code());
+
+  cp.instance.data_type = DT_FLOAT;
+  TF_EXPECT_OK(InitializeRingParams(&cp));
+}
+
+TEST_F(RingReducerTest, HierarchicalInitializeParams) {
+  CollectiveParams cp = SetUpCollectiveParams(4, 2);
+  cp.default_rank = 0;
+  TF_EXPECT_OK(InitializeHierarchicalParams(&cp));
+
+  // Tasks with different numbers of devices are not supported.
+  cp = SetUpCollectiveParams(4, 2);
+  cp.default_rank = 0;
+  cp.group.task_names[4] = cp.group.task_names[0];
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            InitializeHierarchicalParams(&cp).code());
+}
+
+// TODO(b/113171733): change to use TEST_P.
+#define DEF_HIERARCHICAL_TEST(B, T, W, D, L, A)                       \
+  TEST_F(RingReducerTest,                                             \
+         HierDaTy##B##_DevTy##T##_Wkr##W##_Dev##D##_Len##L##_Abrt##A) { \
+    collective_name_ = "HierarchicalRingReduce";                      \
+    DataType dtype = DT_##B;                                          \
+    switch (dtype) {                                                  \
+      case DT_FLOAT: {                                                \
+        RunTest<float>(dtype, DEVICE_##T, W, D, 1, L, A);             \
+      } break;                                                        \
+      case DT_INT64: {                                                \
+        RunTest<int64>(dtype, DEVICE_##T, W, D, 1, L, A);             \
+      } break;                                                        \
+      default:                                                        \
+        LOG(FATAL) << "Unimplemented";                                \
+    }                                                                 \
+  }
+
 #if !(GOOGLE_CUDA || TENSORFLOW_USE_ROCM)
 // Success tests
 DEF_TEST(FLOAT, CPU, 1, 2, 1, 1, 0)
@@ -709,6 +821,16 @@ DEF_TEST(INT64, CPU, 2, 8, 3, 4095, 0)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 1)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 7)
 DEF_TEST(FLOAT, CPU, 2, 8, 2, 9408, 11)
+
+// Hierarchical tests
+DEF_HIERARCHICAL_TEST(FLOAT, CPU, 1, 4, 1001, 0)
+DEF_HIERARCHICAL_TEST(FLOAT, CPU, 2, 1, 1001, 0)
+DEF_HIERARCHICAL_TEST(FLOAT, CPU, 2, 4, 1, 0)
+DEF_HIERARCHICAL_TEST(FLOAT, CPU, 2, 4, 7, 0)
+DEF_HIERARCHICAL_TEST(FLOAT, CPU, 2, 4, 1001, 0)
+DEF_HIERARCHICAL_TEST(FLOAT, CPU, 3, 8, 4095, 0)
+DEF_HIERARCHICAL_TEST(INT64, CPU, 2, 4, 1001, 0)
+DEF_HIERARCHICAL_TEST(FLOAT, CPU, 2, 4, 9408, 5)
 #endif
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
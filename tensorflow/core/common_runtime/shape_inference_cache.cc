@@ -0,0 +1,160 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/shape_inference_cache.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/strcat.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+using shape_inference::DimensionHandle;
+using shape_inference::InferenceContext;
+using shape_inference::ShapeHandle;
+
+/*static*/ ShapeInferenceCache* ShapeInferenceCache::Global() {
+  static ShapeInferenceCache* cache = []() -> ShapeInferenceCache* {
+    int64 capacity = 0;
+    Status status =
+        ReadInt64FromEnvVar("TF_SHAPE_INFERENCE_CACHE_SIZE", 0, &capacity);
+    if (!status.ok()) {
+      LOG(ERROR) << "ShapeInferenceCache: " << status.error_message();
+    }
+    if (capacity <= 0) return nullptr;
+    return new ShapeInferenceCache(capacity);
+  }();
+  return cache;
+}
+
+ShapeInferenceCache::ShapeInferenceCache(int64 capacity)
+    : capacity_(capacity) {}
+
+/*static*/ bool ShapeInferenceCache::MakeKey(int graph_def_version,
+                                             const NodeDef& ndef,
+                                             InferenceContext* c,
+                                             Fprint128* key) {
+  string buf = strings::StrCat(ndef.op(), ";", graph_def_version, ";");
+
+  gtl::InlinedVector<const protobuf::MapPair<string, AttrValue>*, 8> attrs;
+  for (const auto& attr : ndef.attr()) {
+    const AttrValue& value = attr.second;
+    // Tensors are expensive to serialize and rarely repeat, and functions may
+    // have different definitions in different graphs.
+    if (value.value_case() == AttrValue::kTensor ||
+        value.value_case() == AttrValue::kFunc ||
+        value.list().tensor_size() > 0 || value.list().func_size() > 0) {
+      return false;
+    }
+    attrs.push_back(&attr);
+  }
+  std::sort(attrs.begin(), attrs.end(),
+            [](const protobuf::MapPair<string, AttrValue>* a,
+               const protobuf::MapPair<string, AttrValue>* b) {
+              return a->first < b->first;
+            });
+  string serialized;
+  for (const auto* attr : attrs) {
+    serialized.clear();
+    if (!SerializeToStringDeterministic(attr->second, &serialized)) {
+      return false;
+    }
+    strings::StrAppend(&buf, attr->first, "=", serialized.size(), ":",
+                       serialized, ";");
+  }
+
+  for (int i = 0; i < c->num_inputs(); ++i) {
+    ShapeHandle shape = c->input(i);
+    if (!c->FullyDefined(shape) ||
+        c->input_handle_shapes_and_types(i) != nullptr) {
+      return false;
+    }
+    buf.push_back('[');
+    for (int d = 0; d < c->Rank(shape); ++d) {
+      strings::StrAppend(&buf, c->Value(c->Dim(shape, d)), ",");
+    }
+    buf.push_back(']');
+  }
+
+  *key = Fingerprint128(buf);
+  return true;
+}
+
+bool ShapeInferenceCache::Lookup(const Fprint128& key, InferenceContext* c) {
+  tf_shared_lock l(mu_);
+  auto it = cache_.find(key);
+  if (it == cache_.end()) return false;
+  const std::vector<CachedShape>& outputs = it->second;
+  if (outputs.size() != static_cast<size_t>(c->num_outputs())) return false;
+  for (int i = 0; i < c->num_outputs(); ++i) {
+    const CachedShape& cached = outputs[i];
+    if (cached.rank < 0) {
+      c->set_output(i, c->UnknownShape());
+      continue;
+    }
+    std::vector<DimensionHandle> dims;
+    dims.reserve(cached.rank);
+    for (int64 dim : cached.dims) {
+      dims.push_back(dim < 0 ? c->UnknownDim() : c->MakeDim(dim));
+    }
+    c->set_output(i, c->MakeShape(dims));
+  }
+  return true;
+}
+
+void ShapeInferenceCache::Insert(const Fprint128& key, InferenceContext* c) {
+  for (int i = 0; i < c->num_inputs(); ++i) {
+    if (c->requested_input_tensor(i) ||
+        c->requested_input_tensor_as_partial_shape(i)) {
+      return;
+    }
+  }
+  std::vector<CachedShape> outputs(c->num_outputs());
+  for (int i = 0; i < c->num_outputs(); ++i) {
+    ShapeHandle shape = c->output(i);
+    if (!shape.IsSet() || c->output_handle_shapes_and_types(i) != nullptr) {
+      return;
+    }
+    CachedShape& cached = outputs[i];
+    if (!c->RankKnown(shape)) {
+      cached.rank = -1;
+      continue;
+    }
+    cached.rank = c->Rank(shape);
+    cached.dims.reserve(cached.rank);
+    for (int d = 0; d < cached.rank; ++d) {
+      cached.dims.push_back(c->Value(c->Dim(shape, d)));
+    }
+  }
+
+  mutex_lock l(mu_);
+  if (static_cast<int64>(cache_.size()) >= capacity_) {
+    VLOG(1) << "Clearing the shape inference cache after " << cache_.size()
+            << " entries";
+    cache_.clear();
+  }
+  cache_.emplace(key, std::move(outputs));
+}
+
+int64 ShapeInferenceCache::size() const {
+  tf_shared_lock l(mu_);
+  return cache_.size();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,84 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SHAPE_INFERENCE_CACHE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SHAPE_INFERENCE_CACHE_H_
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Memoizes the output shapes computed by op shape functions, keyed by the op,
+// its attrs and its input shapes, so that identical nodes appearing in many
+// graphs and functions only run their shape function once.
+//
+// Only results that are fully determined by the key are cached: the input
+// shapes must be fully defined, the shape function must not have looked at
+// input tensor values, and no resource or variant handle data may be involved.
+class ShapeInferenceCache {
+ public:
+  // Returns the process-wide cache, or nullptr if it is disabled. It is
+  // enabled by setting TF_SHAPE_INFERENCE_CACHE_SIZE to the maximum number of
+  // entries.
+  static ShapeInferenceCache* Global();
+
+  explicit ShapeInferenceCache(int64 capacity);
+
+  // Computes the key of running the shape function of `ndef` with the inputs
+  // currently set in `c`. Returns false if the result cannot be cached.
+  static bool MakeKey(int graph_def_version, const NodeDef& ndef,
+                      shape_inference::InferenceContext* c, Fprint128* key);
+
+  // If outputs are cached for `key`, sets them on `c` and returns true.
+  bool Lookup(const Fprint128& key, shape_inference::InferenceContext* c)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Caches the outputs of `c` after its shape function ran successfully,
+  // unless they may depend on more than `key`.
+  void Insert(const Fprint128& key, shape_inference::InferenceContext* c)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  int64 size() const TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct CachedShape {
+    // -1 for unknown rank.
+    int rank;
+    // -1 for unknown dimensions.
+    gtl::InlinedVector<int64, 4> dims;
+  };
+
+  const int64 capacity_;
+
+  mutable mutex mu_;
+  absl::flat_hash_map<Fprint128, std::vector<CachedShape>, Fprint128Hasher>
+      cache_ TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ShapeInferenceCache);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SHAPE_INFERENCE_CACHE_H_
@@ -0,0 +1,130 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/shape_inference_cache.h"
+
+#include <memory>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+using shape_inference::InferenceContext;
+using shape_inference::ShapeHandle;
+
+REGISTER_OP("ShapeInferenceCacheTestOp")
+    .Input("a: float")
+    .Output("o: float")
+    .Attr("n: int");
+
+class ShapeInferenceCacheTest : public ::testing::Test {
+ protected:
+  NodeDef MakeNode(int n) {
+    NodeDef ndef;
+    TF_CHECK_OK(NodeDefBuilder("node", "ShapeInferenceCacheTestOp")
+                    .Input(FakeInput(DT_FLOAT))
+                    .Attr("n", n)
+                    .Finalize(&ndef));
+    return ndef;
+  }
+
+  // Returns a context for `ndef` whose input has shape `input_dims`.
+  std::unique_ptr<InferenceContext> MakeContext(
+      const NodeDef& ndef, const std::vector<int64>& input_dims) {
+    const OpRegistrationData* op_reg_data;
+    TF_CHECK_OK(OpRegistry::Global()->LookUp(ndef.op(), &op_reg_data));
+    std::unique_ptr<InferenceContext> c(new InferenceContext(
+        TF_GRAPH_DEF_VERSION, ndef, op_reg_data->op_def,
+        std::vector<ShapeHandle>(1), {}, {}, {}));
+    TF_CHECK_OK(c->construction_status());
+    std::vector<shape_inference::DimensionHandle> dims;
+    for (int64 dim : input_dims) {
+      dims.push_back(dim < 0 ? c->UnknownDim() : c->MakeDim(dim));
+    }
+    c->SetInput(0, c->MakeShape(dims));
+    return c;
+  }
+};
+
+TEST_F(ShapeInferenceCacheTest, ReusesOutputs) {
+  ShapeInferenceCache cache(/*capacity=*/10);
+  const NodeDef ndef = MakeNode(1);
+
+  auto c = MakeContext(ndef, {2, 3});
+  Fprint128 key;
+  ASSERT_TRUE(
+      ShapeInferenceCache::MakeKey(TF_GRAPH_DEF_VERSION, ndef, c.get(), &key));
+  EXPECT_FALSE(cache.Lookup(key, c.get()));
+  c->set_output(0, c->Matrix(3, InferenceContext::kUnknownDim));
+  cache.Insert(key, c.get());
+  EXPECT_EQ(cache.size(), 1);
+
+  auto other = MakeContext(ndef, {2, 3});
+  Fprint128 other_key;
+  ASSERT_TRUE(ShapeInferenceCache::MakeKey(TF_GRAPH_DEF_VERSION, ndef,
+                                           other.get(), &other_key));
+  EXPECT_EQ(key, other_key);
+  ASSERT_TRUE(cache.Lookup(other_key, other.get()));
+  EXPECT_EQ("[3,?]", other->DebugString(other->output(0)));
+}
+
+TEST_F(ShapeInferenceCacheTest, KeyDependsOnAttrsAndInputShapes) {
+  const NodeDef ndef = MakeNode(1);
+  auto c = MakeContext(ndef, {2, 3});
+  Fprint128 key;
+  ASSERT_TRUE(
+      ShapeInferenceCache::MakeKey(TF_GRAPH_DEF_VERSION, ndef, c.get(), &key));
+
+  const NodeDef other_attrs = MakeNode(2);
+  auto c_attrs = MakeContext(other_attrs, {2, 3});
+  Fprint128 key_attrs;
+  ASSERT_TRUE(ShapeInferenceCache::MakeKey(TF_GRAPH_DEF_VERSION, other_attrs,
+                                           c_attrs.get(), &key_attrs));
+  EXPECT_FALSE(key == key_attrs);
+
+  auto c_shape = MakeContext(ndef, {3, 2});
+  Fprint128 key_shape;
+  ASSERT_TRUE(ShapeInferenceCache::MakeKey(TF_GRAPH_DEF_VERSION, ndef,
+                                           c_shape.get(), &key_shape));
+  EXPECT_FALSE(key == key_shape);
+}
+
+TEST_F(ShapeInferenceCacheTest, OnlyCachesResultsDeterminedByKey) {
+  ShapeInferenceCache cache(/*capacity=*/10);
+  const NodeDef ndef = MakeNode(1);
+
+  // Partially known input shapes are not cached.
+  auto partial = MakeContext(ndef, {2, -1});
+  Fprint128 key;
+  EXPECT_FALSE(ShapeInferenceCache::MakeKey(TF_GRAPH_DEF_VERSION, ndef,
+                                            partial.get(), &key));
+
+  // Results that looked at input values are not cached.
+  auto c = MakeContext(ndef, {2, 3});
+  ASSERT_TRUE(
+      ShapeInferenceCache::MakeKey(TF_GRAPH_DEF_VERSION, ndef, c.get(), &key));
+  c->input_tensor(0);
+  c->set_output(0, c->Scalar());
+  cache.Insert(key, c.get());
+  EXPECT_EQ(cache.size(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eval_const_tensor.h"
 #include "tensorflow/core/common_runtime/function_utils.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
+#include "tensorflow/core/common_runtime/shape_inference_cache.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/node_def.pb.h"
@@ -696,6 +697,17 @@ Status ShapeRefiner::RunShapeFn(const Node* node,
     }
     return Status::OK();
   };
+  // Identical nodes are common across the graphs and functions of a process,
+  // so reuse the outputs computed for them when possible.
+  ShapeInferenceCache* cache = ShapeInferenceCache::Global();
+  Fprint128 cache_key;
+  const bool cacheable =
+      cache != nullptr && op_reg_data->shape_inference_fn != nullptr &&
+      !(function_library_ && IsFunctionCall(*function_library_, *node)) &&
+      ShapeInferenceCache::MakeKey(graph_def_version_, node->def(), c,
+                                   &cache_key);
+  if (cacheable && cache->Lookup(cache_key, c)) return Status::OK();
+
   TF_RETURN_IF_ERROR(run_inference_lambda());
 
   // We must run the shape function repeatedly, in case users write
@@ -761,6 +773,7 @@ Status ShapeRefiner::RunShapeFn(const Node* node,
     }
   } while (rerun_shape_fn);
 
+  if (cacheable) cache->Insert(cache_key, c);
   return Status::OK();
 }
 
@@ -0,0 +1,325 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Values of `recorded_bytes_` for outputs without a known static size.
+constexpr int64 kUnknownBytes = -1;
+constexpr int64 kDynamicBytes = -2;
+
+size_t RoundUpToAlignment(size_t bytes) {
+  constexpr size_t kAlignment = Allocator::kAllocatorAlignment;
+  return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+}  // namespace
+
+struct StaticMemoryPlanner::Plan {
+  struct Slot {
+    size_t offset;
+    size_t bytes;
+    // The other slots that share some memory with this one.
+    std::vector<int> overlapping_slots;
+  };
+
+  int64 arena_bytes = 0;
+  std::vector<Slot> slots;
+  // Index of the first output of each node in `output_slots`.
+  std::vector<int> output_offsets;
+  // Slot of each node output, or -1 if the output is not planned.
+  std::vector<int> output_slots;
+  std::vector<bool> node_has_slots;
+};
+
+class StaticMemoryPlanner::Arena::SlotAllocator : public Allocator {
+ public:
+  SlotAllocator(Arena* arena, int slot) : arena_(arena), slot_(slot) {}
+
+  std::string Name() override { return "static_memory_plan"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    return AllocateRaw(alignment, num_bytes, AllocationAttributes());
+  }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override {
+    void* ptr = arena_->AllocateSlot(slot_, alignment, num_bytes);
+    if (ptr == nullptr) {
+      ptr = arena_->allocator_->AllocateRaw(alignment, num_bytes,
+                                            allocation_attr);
+    }
+    // The memory may outlive the step, so it keeps the arena alive.
+    if (ptr != nullptr) arena_->Ref();
+    return ptr;
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    Arena* arena = arena_;
+    if (!arena->DeallocateSlot(slot_, ptr)) {
+      arena->allocator_->DeallocateRaw(ptr);
+    }
+    // May delete the arena, and thus this allocator.
+    arena->Unref();
+  }
+
+ private:
+  Arena* const arena_;
+  const int slot_;
+};
+
+StaticMemoryPlanner::Arena::Arena(std::shared_ptr<const Plan> plan,
+                                  Allocator* allocator)
+    : plan_(std::move(plan)), allocator_(allocator) {
+  base_ = static_cast<char*>(allocator_->AllocateRaw(
+      Allocator::kAllocatorAlignment, plan_->arena_bytes));
+  slot_allocators_.reserve(plan_->slots.size());
+  for (int slot = 0; slot < plan_->slots.size(); ++slot) {
+    slot_allocators_.push_back(absl::make_unique<SlotAllocator>(this, slot));
+  }
+  output_allocators_.resize(plan_->output_slots.size(), nullptr);
+  for (int i = 0; i < plan_->output_slots.size(); ++i) {
+    const int slot = plan_->output_slots[i];
+    if (slot >= 0) output_allocators_[i] = slot_allocators_[slot].get();
+  }
+  in_use_.resize(plan_->slots.size(), false);
+}
+
+StaticMemoryPlanner::Arena::~Arena() {
+  if (base_ != nullptr) allocator_->DeallocateRaw(base_);
+}
+
+Allocator* const* StaticMemoryPlanner::Arena::output_allocators(
+    int node_id) const {
+  if (!plan_->node_has_slots[node_id]) return nullptr;
+  return output_allocators_.data() + plan_->output_offsets[node_id];
+}
+
+void* StaticMemoryPlanner::Arena::AllocateSlot(int slot, size_t alignment,
+                                               size_t num_bytes) {
+  const Plan::Slot& s = plan_->slots[slot];
+  if (num_bytes > s.bytes || alignment > Allocator::kAllocatorAlignment) {
+    return nullptr;
+  }
+  mutex_lock l(mu_);
+  if (in_use_[slot]) return nullptr;
+  for (int other : s.overlapping_slots) {
+    if (in_use_[other]) return nullptr;
+  }
+  in_use_[slot] = true;
+  return base_ + s.offset;
+}
+
+bool StaticMemoryPlanner::Arena::DeallocateSlot(int slot, void* ptr) {
+  if (ptr != base_ + plan_->slots[slot].offset) return false;
+  mutex_lock l(mu_);
+  DCHECK(in_use_[slot]);
+  in_use_[slot] = false;
+  return true;
+}
+
+StaticMemoryPlanner::StaticMemoryPlanner(const Graph& graph,
+                                         Allocator* allocator)
+    : allocator_(allocator), num_node_ids_(graph.num_node_ids()) {
+  output_offsets_.resize(num_node_ids_ + 1, 0);
+  for (int id = 0; id < num_node_ids_; ++id) {
+    const Node* n = graph.FindNodeId(id);
+    output_offsets_[id + 1] =
+        output_offsets_[id] + (n == nullptr ? 0 : n->num_outputs());
+  }
+  recorded_bytes_.resize(output_offsets_.back(), kUnknownBytes);
+
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+  std::vector<int> position(num_node_ids_, -1);
+  for (int i = 0; i < order.size(); ++i) {
+    position[order[i]->id()] = i;
+  }
+
+  // Nodes that may keep their inputs past the end of the step, or pass them
+  // to another frame, prevent them from being planned.
+  const auto may_escape = [](const Node* n) {
+    return !n->IsOp() || n->IsRetval() || n->IsSend() || n->IsControlFlow() ||
+           n->op_def().is_stateful();
+  };
+  for (const Node* n : order) {
+    if (may_escape(n)) continue;
+    for (int i = 0; i < n->num_outputs(); ++i) {
+      if (IsRefType(n->output_type(i))) continue;
+      Candidate candidate{n->id(), i, position[n->id()], position[n->id()]};
+      bool escapes = false;
+      for (const Edge* e : n->out_edges()) {
+        if (e->IsControlEdge() || e->src_output() != i) continue;
+        if (may_escape(e->dst())) {
+          escapes = true;
+          break;
+        }
+        candidate.last_use =
+            std::max(candidate.last_use, position[e->dst()->id()]);
+      }
+      if (!escapes) candidates_.push_back(candidate);
+    }
+  }
+  if (candidates_.empty()) recording_ = false;
+}
+
+StaticMemoryPlanner::~StaticMemoryPlanner() {
+  mutex_lock l(mu_);
+  for (Arena* arena : arenas_) {
+    arena->Unref();
+  }
+}
+
+void StaticMemoryPlanner::RecordOutput(int node_id, int output_index,
+                                       size_t bytes) {
+  if (!recording()) return;
+  mutex_lock l(mu_);
+  int64& recorded = recorded_bytes_[output_offsets_[node_id] + output_index];
+  if (recorded == kUnknownBytes) {
+    recorded = bytes;
+  } else if (recorded != bytes) {
+    recorded = kDynamicBytes;
+  }
+}
+
+void StaticMemoryPlanner::RecordStepDone(bool ok) {
+  if (!ok) return;
+  mutex_lock l(mu_);
+  if (!recording()) return;
+  if (++num_recorded_steps_ < kNumRecordingSteps) return;
+  BuildPlanLocked();
+  recording_.store(false, std::memory_order_release);
+}
+
+void StaticMemoryPlanner::BuildPlanLocked() {
+  auto plan = std::make_shared<Plan>();
+  plan->output_offsets = output_offsets_;
+  plan->output_slots.resize(recorded_bytes_.size(), -1);
+  plan->node_has_slots.resize(num_node_ids_, false);
+
+  struct Placement {
+    const Candidate* candidate;
+    size_t bytes;
+    size_t offset;
+  };
+  std::vector<Placement> placements;
+  int64 total_bytes = 0;
+  for (const Candidate& candidate : candidates_) {
+    const int64 bytes = recorded_bytes_[output_offsets_[candidate.node_id] +
+                                        candidate.output_index];
+    if (bytes <= 0) continue;
+    placements.push_back({&candidate, RoundUpToAlignment(bytes), 0});
+    total_bytes += placements.back().bytes;
+  }
+
+  // Place the largest outputs first, each at the lowest offset that doesn't
+  // overlap the outputs already placed whose lifetimes overlap its own, like
+  // TFLite's ArenaPlanner does.
+  std::stable_sort(placements.begin(), placements.end(),
+                   [](const Placement& a, const Placement& b) {
+                     return a.bytes > b.bytes;
+                   });
+  const auto lifetimes_overlap = [](const Candidate& a, const Candidate& b) {
+    return a.first_use <= b.last_use && b.first_use <= a.last_use;
+  };
+  // The placements done so far, sorted by offset.
+  std::vector<const Placement*> placed;
+  for (Placement& placement : placements) {
+    size_t offset = 0;
+    for (const Placement* other : placed) {
+      if (!lifetimes_overlap(*placement.candidate, *other->candidate)) {
+        continue;
+      }
+      if (other->offset >= offset + placement.bytes) break;
+      offset = std::max(offset, other->offset + other->bytes);
+    }
+    placement.offset = offset;
+    placed.insert(std::upper_bound(placed.begin(), placed.end(), &placement,
+                                   [](const Placement* a, const Placement* b) {
+                                     return a->offset < b->offset;
+                                   }),
+                  &placement);
+    plan->arena_bytes =
+        std::max<int64>(plan->arena_bytes, offset + placement.bytes);
+  }
+
+  for (const Placement* placement : placed) {
+    const int slot = plan->slots.size();
+    plan->slots.push_back({placement->offset, placement->bytes, {}});
+    const Candidate& candidate = *placement->candidate;
+    plan->output_slots[output_offsets_[candidate.node_id] +
+                       candidate.output_index] = slot;
+    plan->node_has_slots[candidate.node_id] = true;
+  }
+  // The slots are sorted by offset, so the slots that share memory with a
+  // slot immediately follow it.
+  for (int i = 0; i < plan->slots.size(); ++i) {
+    Plan::Slot& slot = plan->slots[i];
+    for (int j = i + 1; j < plan->slots.size() &&
+                        plan->slots[j].offset < slot.offset + slot.bytes;
+         ++j) {
+      slot.overlapping_slots.push_back(j);
+      plan->slots[j].overlapping_slots.push_back(i);
+    }
+  }
+
+  VLOG(1) << "Planned " << plan->slots.size() << " outputs in an arena of "
+          << plan->arena_bytes << " bytes instead of " << total_bytes
+          << " bytes";
+  plan_ = std::move(plan);
+}
+
+StaticMemoryPlanner::Arena* StaticMemoryPlanner::AcquireArena() {
+  mutex_lock l(mu_);
+  if (plan_ == nullptr || plan_->slots.empty()) return nullptr;
+  for (Arena* arena : arenas_) {
+    // Once no step and no output uses an arena anymore, only the planner
+    // holds a reference to it.
+    if (arena->RefCountIsOne()) {
+      arena->Ref();
+      return arena;
+    }
+  }
+  if (arenas_.size() >= kMaxNumArenas) return nullptr;
+  Arena* arena = new Arena(plan_, allocator_);
+  if (arena->base_ == nullptr) {
+    arena->Unref();
+    return nullptr;
+  }
+  arenas_.push_back(arena);
+  arena->Ref();
+  return arena;
+}
+
+int64 StaticMemoryPlanner::arena_bytes() const {
+  mutex_lock l(mu_);
+  return plan_ == nullptr ? 0 : plan_->arena_bytes;
+}
+
+int StaticMemoryPlanner::num_planned_outputs() const {
+  mutex_lock l(mu_);
+  return plan_ == nullptr ? 0 : plan_->slots.size();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,149 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Places the outputs of the nodes of a graph at pre-planned offsets of a
+// single arena per step, instead of allocating each of them separately.
+//
+// The planner records the sizes of the outputs during the first
+// `kNumRecordingSteps` steps. The outputs that have the same size in all of
+// them are then assigned an offset in the arena, such that the outputs whose
+// lifetimes overlap in a topological order of the graph don't share memory.
+// Outputs with dynamic sizes, and outputs that may escape the step (e.g.
+// fetched, sent to another device or consumed by a stateful op), keep using
+// the device allocator.
+//
+// The plan is only a hint: at run time, an output only gets its range of the
+// arena if none of the outputs whose ranges overlap it is still alive, and
+// falls back to the device allocator otherwise. The arena is thus correct
+// whatever the order in which the nodes actually run.
+//
+// This class is thread-safe.
+class StaticMemoryPlanner {
+ public:
+  static constexpr int kNumRecordingSteps = 2;
+  // Maximum number of arenas kept around for reuse by later steps.
+  static constexpr int kMaxNumArenas = 4;
+
+  class Arena;
+
+  // `allocator` is used for the arenas and for the outputs that can't be
+  // placed in them. It must outlive the planner and its arenas.
+  StaticMemoryPlanner(const Graph& graph, Allocator* allocator);
+  ~StaticMemoryPlanner();
+
+  // Returns true while the planner records the sizes of the outputs.
+  bool recording() const { return recording_.load(std::memory_order_acquire); }
+
+  // Records that output `output_index` of node `node_id` had `bytes` bytes in
+  // the current recording step.
+  void RecordOutput(int node_id, int output_index, size_t bytes);
+
+  // Marks the end of a recording step. Steps that failed are ignored. The
+  // plan is built at the end of the last recording step.
+  void RecordStepDone(bool ok);
+
+  // Returns an arena for the outputs of a step, or nullptr if there is no plan
+  // or all the arenas are in use. The caller must Unref() the arena once the
+  // step is done; the outputs that live in the arena hold their own reference.
+  Arena* AcquireArena();
+
+  // Returns the size of the arenas, or 0 if there is no plan.
+  int64 arena_bytes() const;
+
+  // Returns the number of outputs that have an offset in the arenas.
+  int num_planned_outputs() const;
+
+ private:
+  struct Plan;
+
+  // An output that may be placed in the arena, with its lifetime expressed as
+  // positions in a topological order of the graph.
+  struct Candidate {
+    int node_id;
+    int output_index;
+    int first_use;
+    int last_use;
+  };
+
+  void BuildPlanLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  Allocator* const allocator_;
+  const int num_node_ids_;
+  std::vector<Candidate> candidates_;
+  // Index of the first output of each node in `recorded_bytes_`.
+  std::vector<int> output_offsets_;
+
+  std::atomic<bool> recording_{true};
+  mutable mutex mu_;
+  int num_recorded_steps_ TF_GUARDED_BY(mu_) = 0;
+  // Size of each node output in the recording steps, kUnknownBytes if it was
+  // never recorded, or kDynamicBytes if it changed from one step to another.
+  std::vector<int64> recorded_bytes_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<const Plan> plan_ TF_GUARDED_BY(mu_);
+  std::vector<Arena*> arenas_ TF_GUARDED_BY(mu_);
+};
+
+// The memory of one step. Each planned output has its own allocator, which
+// places the output at its offset in the arena if possible, and forwards to
+// the device allocator otherwise.
+class StaticMemoryPlanner::Arena : public core::RefCounted {
+ public:
+  // Returns the allocators of the outputs of the node, indexed by output
+  // number, or nullptr if none of its outputs is planned. Null entries are
+  // outputs that are not planned.
+  Allocator* const* output_allocators(int node_id) const;
+
+ private:
+  friend class StaticMemoryPlanner;
+  class SlotAllocator;
+
+  Arena(std::shared_ptr<const Plan> plan, Allocator* allocator);
+  ~Arena() override;
+
+  // Returns the memory of `slot` if it can hold `num_bytes` bytes and none of
+  // the slots that share its memory is in use, or nullptr otherwise.
+  void* AllocateSlot(int slot, size_t alignment, size_t num_bytes);
+  // Returns true if `ptr` is the memory of `slot`, which is released.
+  bool DeallocateSlot(int slot, void* ptr);
+
+  const std::shared_ptr<const Plan> plan_;
+  Allocator* const allocator_;
+  char* base_;
+  std::vector<std::unique_ptr<SlotAllocator>> slot_allocators_;
+  // Allocators of all the node outputs, null for outputs that are not planned.
+  std::vector<Allocator*> output_allocators_;
+
+  mutex mu_;
+  std::vector<bool> in_use_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
@@ -0,0 +1,155 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int kNumElements = 256;
+constexpr int64 kBytes = kNumElements * sizeof(float);
+
+class StaticMemoryPlannerTest : public ::testing::Test {
+ protected:
+  // Builds the chain x -> a -> b -> c -> d, in which each output only lives
+  // until the next node runs.
+  void SetUp() override {
+    graph_ = absl::make_unique<Graph>(OpRegistry::Global());
+    Tensor value(DT_FLOAT, TensorShape({kNumElements}));
+    Node* node = test::graph::Constant(graph_.get(), value);
+    nodes_.push_back(node);
+    for (int i = 0; i < 4; ++i) {
+      node = test::graph::Unary(graph_.get(), "Neg", node);
+      nodes_.push_back(node);
+    }
+  }
+
+  // Records `bytes` for every output of the chain, except the ones in
+  // `overrides`.
+  void RecordStep(StaticMemoryPlanner* planner,
+                  const std::map<int, int64>& overrides = {}) {
+    ASSERT_TRUE(planner->recording());
+    for (int i = 0; i < nodes_.size(); ++i) {
+      auto it = overrides.find(i);
+      planner->RecordOutput(nodes_[i]->id(), 0,
+                            it == overrides.end() ? kBytes : it->second);
+    }
+    planner->RecordStepDone(/*ok=*/true);
+  }
+
+  Allocator* OutputAllocator(StaticMemoryPlanner::Arena* arena, int i) {
+    Allocator* const* allocators = arena->output_allocators(nodes_[i]->id());
+    return allocators == nullptr ? nullptr : allocators[0];
+  }
+
+  std::unique_ptr<Graph> graph_;
+  std::vector<Node*> nodes_;
+};
+
+TEST_F(StaticMemoryPlannerTest, ReusesMemoryOfDeadOutputs) {
+  StaticMemoryPlanner planner(*graph_, cpu_allocator());
+  EXPECT_EQ(planner.AcquireArena(), nullptr);
+  for (int step = 0; step < StaticMemoryPlanner::kNumRecordingSteps; ++step) {
+    RecordStep(&planner);
+  }
+  EXPECT_FALSE(planner.recording());
+  EXPECT_EQ(planner.num_planned_outputs(), nodes_.size());
+  // Two consecutive outputs are live at the same time.
+  EXPECT_EQ(planner.arena_bytes(), 2 * kBytes);
+
+  StaticMemoryPlanner::Arena* arena = planner.AcquireArena();
+  ASSERT_NE(arena, nullptr);
+  Tensor x(OutputAllocator(arena, 0), DT_FLOAT, TensorShape({kNumElements}));
+  Tensor a(OutputAllocator(arena, 1), DT_FLOAT, TensorShape({kNumElements}));
+  EXPECT_NE(x.data(), a.data());
+
+  // `b` is planned in the memory of `x`, which is still alive: it falls back
+  // to the allocator.
+  const void* x_data = x.data();
+  Tensor b(OutputAllocator(arena, 2), DT_FLOAT, TensorShape({kNumElements}));
+  EXPECT_NE(b.data(), x_data);
+  EXPECT_NE(b.data(), a.data());
+
+  // Once `x` and the fallback of `b` are released, `b` takes its place.
+  x = Tensor();
+  b = Tensor();
+  b = Tensor(OutputAllocator(arena, 2), DT_FLOAT, TensorShape({kNumElements}));
+  EXPECT_EQ(b.data(), x_data);
+
+  // Outputs larger than planned fall back to the allocator.
+  Tensor d(OutputAllocator(arena, 4), DT_FLOAT,
+           TensorShape({2 * kNumElements}));
+  EXPECT_TRUE(d.IsInitialized());
+  arena->Unref();
+}
+
+TEST_F(StaticMemoryPlannerTest, SkipsDynamicOutputs) {
+  StaticMemoryPlanner planner(*graph_, cpu_allocator());
+  RecordStep(&planner);
+  RecordStep(&planner, {{3, 2 * kBytes}});
+  EXPECT_EQ(planner.num_planned_outputs(), nodes_.size() - 1);
+
+  StaticMemoryPlanner::Arena* arena = planner.AcquireArena();
+  ASSERT_NE(arena, nullptr);
+  EXPECT_NE(OutputAllocator(arena, 2), nullptr);
+  EXPECT_EQ(OutputAllocator(arena, 3), nullptr);
+  arena->Unref();
+}
+
+TEST_F(StaticMemoryPlannerTest, IgnoresFailedSteps) {
+  StaticMemoryPlanner planner(*graph_, cpu_allocator());
+  RecordStep(&planner);
+  planner.RecordStepDone(/*ok=*/false);
+  EXPECT_TRUE(planner.recording());
+  RecordStep(&planner);
+  EXPECT_FALSE(planner.recording());
+}
+
+TEST_F(StaticMemoryPlannerTest, ReusesArenasOnceReleased) {
+  StaticMemoryPlanner planner(*graph_, cpu_allocator());
+  for (int step = 0; step < StaticMemoryPlanner::kNumRecordingSteps; ++step) {
+    RecordStep(&planner);
+  }
+
+  StaticMemoryPlanner::Arena* arena = planner.AcquireArena();
+  ASSERT_NE(arena, nullptr);
+  Tensor x(OutputAllocator(arena, 0), DT_FLOAT, TensorShape({kNumElements}));
+  arena->Unref();
+
+  // `x` still uses the first arena, so the next step gets another one.
+  StaticMemoryPlanner::Arena* other_arena = planner.AcquireArena();
+  ASSERT_NE(other_arena, nullptr);
+  EXPECT_NE(other_arena, arena);
+  other_arena->Unref();
+
+  x = Tensor();
+  StaticMemoryPlanner::Arena* reused_arena = planner.AcquireArena();
+  EXPECT_TRUE(reused_arena == arena || reused_arena == other_arena);
+  reused_arena->Unref();
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -27,10 +27,13 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/types.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #ifdef INTEL_MKL
 #ifdef _OPENMP
@@ -68,7 +71,27 @@ ThreadPoolDevice::ThreadPoolDevice(const SessionOptions& options,
 #endif  // !defined(ENABLE_MKLDNN_THREADPOOL) && defined(INTEL_MKL)
 }
 
-ThreadPoolDevice::~ThreadPoolDevice() {}
+ThreadPoolDevice::~ThreadPoolDevice() {
+  if (ShardCostModelEnabled()) {
+    VLOG(1) << "Learned Shard() costs:\n" << ShardCostModelDebugString();
+  }
+}
+
+void ThreadPoolDevice::Compute(OpKernel* op_kernel, OpKernelContext* context) {
+  if (!ShardCostModelEnabled()) {
+    op_kernel->Compute(context);
+    return;
+  }
+  const DataType dtype = op_kernel->num_inputs() > 0
+                             ? op_kernel->input_type(0)
+                             : op_kernel->num_outputs() > 0
+                                   ? op_kernel->output_type(0)
+                                   : DT_INVALID;
+  const string key =
+      strings::StrCat(op_kernel->type_string(), ":", DataTypeString(dtype));
+  ScopedShardCostKey scoped_key(&key);
+  op_kernel->Compute(context);
+}
 
 Allocator* ThreadPoolDevice::GetAllocator(AllocatorAttributes attr) {
   return allocator_;
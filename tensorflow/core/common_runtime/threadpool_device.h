@@ -42,6 +42,10 @@ class ThreadPoolDevice : public LocalDevice {
                               const DeviceContext* device_context,
                               StatusCallback done) override;
 
+  // Sets the Shard() cost key of the kernel if the adaptive cost model is
+  // enabled.
+  void Compute(OpKernel* op_kernel, OpKernelContext* context) override;
+
   Status Sync() override { return Status::OK(); }
 
  private:
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/process_state.h"
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 #include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -38,6 +39,15 @@ class ThreadPoolDeviceFactory : public DeviceFactory {
   Status CreateDevices(const SessionOptions& options, const string& name_prefix,
                        std::vector<std::unique_ptr<Device>>* devices) override {
     int num_numa_nodes = port::NUMANumNodes();
+    if (options.config.experimental().use_numa_affinity() &&
+        options.config.experimental().pin_to_numa_node()) {
+      const int32 numa_node = options.config.experimental().numa_node();
+      if (numa_node < 0 || numa_node >= num_numa_nodes) {
+        return errors::InvalidArgument("Cannot pin the session to NUMA node ",
+                                       numa_node, ": only ", num_numa_nodes,
+                                       " NUMA nodes are visible in system");
+      }
+    }
     int n = 1;
     auto iter = options.config.device_count().find("CPU");
     if (iter != options.config.device_count().end()) {
@@ -48,7 +58,11 @@ class ThreadPoolDeviceFactory : public DeviceFactory {
       std::unique_ptr<ThreadPoolDevice> tpd;
       if (options.config.experimental().use_numa_affinity()) {
         int numa_node = i % num_numa_nodes;
-        if (numa_node != i) {
+        if (options.config.experimental().pin_to_numa_node()) {
+          // All CPU devices of the session share the pinned node, so graphs
+          // placed on any of them stay on that node.
+          numa_node = options.config.experimental().numa_node();
+        } else if (numa_node != i) {
           LOG(INFO) << "Only " << num_numa_nodes
                     << " NUMA nodes visible in system, "
                     << " assigning device " << name << " to NUMA node "
@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 
+#include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -68,5 +70,35 @@ TEST(ThreadPoolDeviceTest, CopyTensor) {
   device_context->Unref();
 }
 
+TEST(ThreadPoolDeviceTest, PinToNumaNode) {
+  SessionOptions options;
+  (*options.config.mutable_device_count())["CPU"] = 2;
+  auto* experimental = options.config.mutable_experimental();
+  experimental->set_use_numa_affinity(true);
+  experimental->set_use_numa_inter_op_thread_pools(true);
+  experimental->set_pin_to_numa_node(true);
+  const int numa_node = port::NUMANumNodes() - 1;
+  experimental->set_numa_node(numa_node);
+
+  std::vector<std::unique_ptr<Device>> devices;
+  TF_ASSERT_OK(DeviceFactory::GetFactory(DEVICE_CPU)->CreateDevices(
+      options, "/job:localhost/replica:0/task:0", &devices));
+  ASSERT_EQ(devices.size(), 2);
+  for (const auto& device : devices) {
+    EXPECT_EQ(device->attributes().locality().numa_node(), numa_node);
+    ASSERT_NE(device->tensorflow_device_thread_pool(), nullptr);
+    EXPECT_EQ(device->tensorflow_device_thread_pool(),
+              devices[0]->tensorflow_device_thread_pool());
+  }
+
+  experimental->set_numa_node(port::NUMANumNodes());
+  devices.clear();
+  EXPECT_EQ(DeviceFactory::GetFactory(DEVICE_CPU)
+                ->CreateDevices(options, "/job:localhost/replica:0/task:0",
+                                &devices)
+                .code(),
+            error::INVALID_ARGUMENT);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/platform/snappy.h"
@@ -21,60 +22,90 @@ limitations under the License.
 namespace tensorflow {
 namespace data {
 
-Status CompressElement(const std::vector<Tensor>& element,
-                       CompressedElement* out) {
-  // Step 1: Determine the total uncompressed size. This requires serializing
-  // non-memcopyable tensors, which we save to use again later.
-  std::vector<TensorProto> non_memcpy_components;
-  int64 total_size = 0;
-  for (auto& component : element) {
-    if (DataTypeCanUseMemcpy(component.dtype())) {
-      // Some datatypes can be memcopied, allowing us to save two copies
-      // (AsProtoTensorContent and SerializeToArray).
-      total_size += DMAHelper::buffer(&component)->size();
-    } else {
-      non_memcpy_components.emplace_back();
-      component.AsProtoTensorContent(&non_memcpy_components.back());
-      total_size += non_memcpy_components.back().ByteSizeLong();
-    }
-  }
+namespace {
 
-  // Step 2: Write the tensor data to a buffer, and compress that buffer.
-  // We use tstring for access to resize_uninitialized.
-  tstring uncompressed;
-  uncompressed.resize_uninitialized(total_size);
-  // Position in `uncompressed` to write the next component.
-  char* position = uncompressed.mdata();
-  int non_memcpy_component_index = 0;
-  for (auto& component : element) {
-    CompressedComponentMetadata* metadata =
-        out->mutable_component_metadata()->Add();
-    metadata->set_dtype(component.dtype());
-    component.shape().AsProto(metadata->mutable_tensor_shape());
-    if (DataTypeCanUseMemcpy(component.dtype())) {
-      const TensorBuffer* buffer = DMAHelper::buffer(&component);
-      memcpy(position, buffer->data(), buffer->size());
-      metadata->set_tensor_size_bytes(buffer->size());
-    } else {
-      TensorProto& proto = non_memcpy_components[non_memcpy_component_index++];
-      proto.SerializeToArray(position, proto.ByteSizeLong());
-      metadata->set_tensor_size_bytes(proto.ByteSizeLong());
+// Components smaller than this are stored uncompressed, since compressing them
+// saves at most a few bytes.
+constexpr size_t kMinCompressionBytes = 64;
+// Number of bytes sampled to estimate how well a larger component compresses.
+constexpr size_t kCompressionSampleBytes = 16 << 10;
+// A component is only compressed if snappy shrinks it to at most this fraction
+// of its size. Otherwise, the CPU spent compressing and uncompressing it is
+// not worth the bytes saved.
+constexpr double kMaxCompressionRatio = 0.8;
+
+// Decides how to encode the `size` bytes at `data`. Components up to
+// `kCompressionSampleBytes` are compressed in full to decide; if the result is
+// kept, it is stored in `compressed`.
+CompressedComponentMetadata::Compression ChooseCompression(
+    const char* data, size_t size, std::string* compressed) {
+  if (size < kMinCompressionBytes) {
+    return CompressedComponentMetadata::NONE;
+  }
+  if (size <= kCompressionSampleBytes) {
+    if (port::Snappy_Compress(data, size, compressed) &&
+        compressed->size() <= kMaxCompressionRatio * size) {
+      return CompressedComponentMetadata::SNAPPY;
     }
-    position += metadata->tensor_size_bytes();
+    compressed->clear();
+    return CompressedComponentMetadata::NONE;
+  }
+  // Sample from the middle, since formats such as JPEG start with headers
+  // which compress much better than their payload.
+  std::string sample;
+  if (!port::Snappy_Compress(data + (size - kCompressionSampleBytes) / 2,
+                             kCompressionSampleBytes, &sample) ||
+      sample.size() > kMaxCompressionRatio * kCompressionSampleBytes) {
+    return CompressedComponentMetadata::NONE;
   }
-  DCHECK_EQ(position, uncompressed.mdata() + total_size);
+  return CompressedComponentMetadata::SNAPPY;
+}
 
-  if (!port::Snappy_Compress(uncompressed.mdata(), total_size,
-                             out->mutable_data())) {
-    return errors::Internal("Failed to compress using snappy.");
+// Decodes the `metadata.encoded_size_bytes()` bytes at `encoded` into the
+// `metadata.tensor_size_bytes()` bytes at `output`.
+Status DecodeComponent(const CompressedComponentMetadata& metadata,
+                       const char* encoded, char* output) {
+  const size_t encoded_size = metadata.encoded_size_bytes();
+  const size_t size = metadata.tensor_size_bytes();
+  switch (metadata.compression()) {
+    case CompressedComponentMetadata::NONE:
+      if (encoded_size != size) {
+        return errors::Internal("Uncompressed component has ", encoded_size,
+                                " bytes whereas the tensor metadata suggests ",
+                                size);
+      }
+      if (size > 0) {
+        memcpy(output, encoded, size);
+      }
+      return Status::OK();
+    case CompressedComponentMetadata::SNAPPY: {
+      size_t uncompressed_size;
+      if (!port::Snappy_GetUncompressedLength(encoded, encoded_size,
+                                              &uncompressed_size)) {
+        return errors::Internal(
+            "Could not get snappy uncompressed length. Compressed data size: ",
+            encoded_size);
+      }
+      if (uncompressed_size != size) {
+        return errors::Internal(
+            "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
+            " whereas the tensor metadata suggests ", size);
+      }
+      if (!port::Snappy_Uncompress(encoded, encoded_size, output)) {
+        return errors::Internal("Failed to perform snappy decompression.");
+      }
+      return Status::OK();
+    }
+    default:
+      return errors::Internal("Unknown component compression ",
+                              metadata.compression());
   }
-  VLOG(3) << "Compressed element from " << total_size << " bytes to "
-          << out->data().size() << " bytes";
-  return Status::OK();
 }
 
-Status UncompressElement(const CompressedElement& compressed,
-                         std::vector<Tensor>* out) {
+// Uncompresses an element in which all components are snappy-compressed
+// together.
+Status UncompressElementV0(const CompressedElement& compressed,
+                           std::vector<Tensor>* out) {
   int num_components = compressed.component_metadata_size();
   out->clear();
   out->reserve(num_components);
@@ -146,5 +177,145 @@ Status UncompressElement(const CompressedElement& compressed,
   return Status::OK();
 }
 
+}  // namespace
+
+Status CompressElement(const std::vector<Tensor>& element,
+                       CompressedElement* out) {
+  out->set_version(1);
+  // Step 1: Get the bytes of each component and choose how to encode them.
+  // This requires serializing non-memcopyable tensors, which we save to use
+  // again later.
+  std::vector<std::string> serialized(element.size());
+  std::vector<std::string> compressed(element.size());
+  std::vector<absl::string_view> uncompressed(element.size());
+  int64 total_size = 0;
+  int64 total_uncompressed_size = 0;
+  for (int i = 0; i < element.size(); ++i) {
+    const Tensor& component = element[i];
+    CompressedComponentMetadata* metadata =
+        out->mutable_component_metadata()->Add();
+    metadata->set_dtype(component.dtype());
+    component.shape().AsProto(metadata->mutable_tensor_shape());
+    if (DataTypeCanUseMemcpy(component.dtype())) {
+      // Some datatypes can be memcopied, allowing us to save two copies
+      // (AsProtoTensorContent and SerializeToArray).
+      const TensorBuffer* buffer = DMAHelper::buffer(&component);
+      if (buffer != nullptr) {
+        uncompressed[i] = absl::string_view(
+            static_cast<const char*>(buffer->data()), buffer->size());
+      }
+    } else {
+      TensorProto proto;
+      component.AsProtoTensorContent(&proto);
+      proto.SerializeToString(&serialized[i]);
+      uncompressed[i] = serialized[i];
+    }
+    metadata->set_tensor_size_bytes(uncompressed[i].size());
+    total_uncompressed_size += uncompressed[i].size();
+
+    CompressedComponentMetadata::Compression compression = ChooseCompression(
+        uncompressed[i].data(), uncompressed[i].size(), &compressed[i]);
+    if (compression == CompressedComponentMetadata::SNAPPY &&
+        compressed[i].empty() &&
+        !port::Snappy_Compress(uncompressed[i].data(), uncompressed[i].size(),
+                               &compressed[i])) {
+      return errors::Internal("Failed to compress using snappy.");
+    }
+    metadata->set_compression(compression);
+    metadata->set_encoded_size_bytes(
+        compression == CompressedComponentMetadata::SNAPPY
+            ? compressed[i].size()
+            : uncompressed[i].size());
+    total_size += metadata->encoded_size_bytes();
+  }
+
+  // Step 2: Write the encoded components one after another.
+  std::string* data = out->mutable_data();
+  data->clear();
+  data->reserve(total_size);
+  for (int i = 0; i < element.size(); ++i) {
+    if (out->component_metadata(i).compression() ==
+        CompressedComponentMetadata::SNAPPY) {
+      data->append(compressed[i]);
+    } else {
+      data->append(uncompressed[i].data(), uncompressed[i].size());
+    }
+  }
+  VLOG(3) << "Compressed element from " << total_uncompressed_size
+          << " bytes to " << data->size() << " bytes";
+  return Status::OK();
+}
+
+Status UncompressElement(const CompressedElement& compressed,
+                         std::vector<Tensor>* out) {
+  if (compressed.version() == 0) {
+    return UncompressElementV0(compressed, out);
+  }
+  if (compressed.version() != 1) {
+    return errors::Internal("Unsupported compressed element version ",
+                            compressed.version());
+  }
+  int num_components = compressed.component_metadata_size();
+  out->clear();
+  out->reserve(num_components);
+
+  const std::string& data = compressed.data();
+  // Position in `data` of the next component.
+  size_t position = 0;
+  std::string tensor_proto_str;
+  for (int i = 0; i < num_components; ++i) {
+    const CompressedComponentMetadata& metadata =
+        compressed.component_metadata(i);
+    const size_t encoded_size = metadata.encoded_size_bytes();
+    if (encoded_size > data.size() - position) {
+      return errors::Internal("Compressed element is truncated: component ", i,
+                              " ends at byte ", position + encoded_size,
+                              " of ", data.size());
+    }
+    const char* encoded = data.data() + position;
+    position += encoded_size;
+
+    if (DataTypeCanUseMemcpy(metadata.dtype())) {
+      out->emplace_back(metadata.dtype(), metadata.tensor_shape());
+      TensorBuffer* buffer = DMAHelper::buffer(&out->back());
+      const size_t buffer_size = buffer == nullptr ? 0 : buffer->size();
+      if (buffer_size != metadata.tensor_size_bytes()) {
+        return errors::Internal("Tensor of shape ",
+                                out->back().shape().DebugString(), " has ",
+                                buffer_size,
+                                " bytes whereas the tensor metadata suggests ",
+                                metadata.tensor_size_bytes());
+      }
+      if (buffer_size > 0) {
+        TF_RETURN_IF_ERROR(DecodeComponent(
+            metadata, encoded, static_cast<char*>(buffer->data())));
+      }
+      continue;
+    }
+
+    // Uncompressed tensor protos are parsed in place.
+    const char* tensor_proto_data = encoded;
+    if (metadata.compression() != CompressedComponentMetadata::NONE) {
+      tensor_proto_str.resize(metadata.tensor_size_bytes());
+      TF_RETURN_IF_ERROR(
+          DecodeComponent(metadata, encoded, &tensor_proto_str[0]));
+      tensor_proto_data = tensor_proto_str.data();
+    } else if (encoded_size != metadata.tensor_size_bytes()) {
+      return errors::Internal("Uncompressed component has ", encoded_size,
+                              " bytes whereas the tensor metadata suggests ",
+                              metadata.tensor_size_bytes());
+    }
+    TensorProto tp;
+    if (!tp.ParseFromArray(tensor_proto_data, metadata.tensor_size_bytes())) {
+      return errors::Internal("Could not parse TensorProto");
+    }
+    out->emplace_back();
+    if (!out->back().FromProto(tp)) {
+      return errors::Internal("Could not parse Tensor");
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace data
 }  // namespace tensorflow
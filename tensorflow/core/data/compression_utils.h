@@ -25,7 +25,9 @@ namespace data {
 // Compresses the components of `element` into the `CompressedElement` proto.
 //
 // In addition to writing the actual compressed bytes, `Compress` fills
-// out the per-component metadata for the `CompressedElement`.
+// out the per-component metadata for the `CompressedElement`. Each component
+// is snappy-compressed only if a sample of it compresses well; components that
+// are already compressed, such as encoded images, are stored as they are.
 Status CompressElement(const std::vector<Tensor>& element,
                        CompressedElement* out);
 
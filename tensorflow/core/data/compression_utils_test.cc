@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/kernels/data/dataset_test_base.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -35,6 +37,20 @@ TEST_P(ParameterizedCompressionUtilsTest, RoundTrip) {
       ExpectEqual(element, round_trip_element, /*compare_order=*/true));
 }
 
+// Returns `size` random bytes, which snappy can't compress.
+tstring RandomBytes(int64 size) {
+  random::PhiloxRandom philox(/*seed=*/42);
+  tstring bytes;
+  while (bytes.size() < size) {
+    random::PhiloxRandom::ResultType values = philox();
+    for (int i = 0; i < values.size(); ++i) {
+      bytes.append(reinterpret_cast<const char*>(&values[i]), sizeof(uint32));
+    }
+  }
+  bytes.resize(size);
+  return bytes;
+}
+
 std::vector<std::vector<Tensor>> TestCases() {
   return {
       CreateTensors<int64>(TensorShape{1}, {{1}}),             // int64
@@ -43,11 +59,78 @@ std::vector<std::vector<Tensor>> TestCases() {
       {CreateTensor<tstring>(TensorShape{1}, {"a"}),
        CreateTensor<int64>(TensorShape{1}, {1})},  // mixed tstring/int64
       {},                                          // empty
+      {CreateTensor<int64>(TensorShape{0}, {})},   // no elements
+      // compressible and incompressible components
+      {CreateTensor<float>(TensorShape{100000},
+                           std::vector<float>(100000, 1.0f)),
+       CreateTensor<tstring>(TensorShape{1}, {RandomBytes(100000)}),
+       CreateTensor<tstring>(TensorShape{1}, {string(1000, 'a')})},
   };
 }
 
 INSTANTIATE_TEST_SUITE_P(Instantiation, ParameterizedCompressionUtilsTest,
                          ::testing::ValuesIn(TestCases()));
 
+class CompressionUtilsTest : public DatasetOpsTestBase {};
+
+TEST_F(CompressionUtilsTest, CompressesOnlyCompressibleComponents) {
+  std::vector<Tensor> element = {
+      CreateTensor<tstring>(TensorShape{1}, {RandomBytes(100000)}),
+      CreateTensor<int64>(TensorShape{10000}, std::vector<int64>(10000, 7)),
+      CreateTensor<int64>(TensorShape{1}, {1})};
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, &compressed));
+  ASSERT_EQ(compressed.component_metadata_size(), 3);
+  EXPECT_EQ(compressed.component_metadata(0).compression(),
+            CompressedComponentMetadata::NONE);
+  EXPECT_EQ(compressed.component_metadata(1).compression(),
+            CompressedComponentMetadata::SNAPPY);
+  EXPECT_LT(compressed.component_metadata(1).encoded_size_bytes(),
+            compressed.component_metadata(1).tensor_size_bytes());
+  // Too small to be worth compressing.
+  EXPECT_EQ(compressed.component_metadata(2).compression(),
+            CompressedComponentMetadata::NONE);
+
+  std::vector<Tensor> round_trip_element;
+  TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+  TF_EXPECT_OK(
+      ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+}
+
+TEST_F(CompressionUtilsTest, UncompressVersion0) {
+  std::vector<Tensor> element = {
+      CreateTensor<int64>(TensorShape{2}, {1, 2}),
+      CreateTensor<int64>(TensorShape{3}, {3, 4, 5})};
+  // All components snappy-compressed together.
+  CompressedElement compressed;
+  std::string uncompressed;
+  for (const Tensor& component : element) {
+    CompressedComponentMetadata* metadata =
+        compressed.add_component_metadata();
+    metadata->set_dtype(component.dtype());
+    component.shape().AsProto(metadata->mutable_tensor_shape());
+    metadata->set_tensor_size_bytes(component.tensor_data().size());
+    uncompressed.append(component.tensor_data().data(),
+                        component.tensor_data().size());
+  }
+  ASSERT_TRUE(port::Snappy_Compress(uncompressed.data(), uncompressed.size(),
+                                    compressed.mutable_data()));
+
+  std::vector<Tensor> round_trip_element;
+  TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+  TF_EXPECT_OK(
+      ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+}
+
+TEST_F(CompressionUtilsTest, TruncatedData) {
+  std::vector<Tensor> element = {
+      CreateTensor<int64>(TensorShape{10000}, std::vector<int64>(10000, 7))};
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, &compressed));
+  compressed.mutable_data()->resize(compressed.data().size() / 2);
+  std::vector<Tensor> round_trip_element;
+  EXPECT_FALSE(UncompressElement(compressed, &round_trip_element).ok());
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/credentials_factory.h"
 #include "tensorflow/core/data/service/dispatcher.grpc.pb.h"
 #include "tensorflow/core/data/service/grpc_util.h"
+#include "tensorflow/core/data/service/local_workers.h"
 #include "tensorflow/core/data/service/worker.grpc.pb.h"
 #include "tensorflow/core/framework/dataset.h"
 
@@ -112,12 +113,14 @@ Status DataServiceDispatcherClient::GetDatasetDef(int64 dataset_id,
 }
 
 Status DataServiceDispatcherClient::GetSplit(int64 job_id, int64 repetition,
+                                             const std::string& worker_address,
                                              Tensor& split,
                                              bool& end_of_splits) {
   TF_RETURN_IF_ERROR(EnsureInitialized());
   GetSplitRequest req;
   req.set_job_id(job_id);
   req.set_repetition(repetition);
+  req.set_worker_address(worker_address);
   GetSplitResponse resp;
   grpc::ClientContext client_ctx;
   grpc::Status status = stub_->GetSplit(&client_ctx, req, &resp);
@@ -245,10 +248,19 @@ Status DataServiceWorkerClient::GetElement(int64 task_id,
   GetElementRequest req;
   req.set_task_id(task_id);
   GetElementResponse resp;
-  grpc::ClientContext ctx;
-  grpc::Status s = stub_->GetElement(&ctx, req, &resp);
-  if (!s.ok()) {
-    return grpc_util::WrapError("Failed to get element", s);
+  // Looked up for every request, so that a client stops using a local worker
+  // as soon as it shuts down.
+  std::shared_ptr<LocalWorker> local_worker = LocalWorkers::Get(address_);
+  if (local_worker) {
+    // The element is moved out of the worker's response without being
+    // serialized.
+    TF_RETURN_IF_ERROR(local_worker->GetElement(&req, &resp));
+  } else {
+    grpc::ClientContext ctx;
+    grpc::Status s = stub_->GetElement(&ctx, req, &resp);
+    if (!s.ok()) {
+      return grpc_util::WrapError("Failed to get element", s);
+    }
   }
   end_of_sequence = resp.end_of_sequence();
   if (!end_of_sequence) {
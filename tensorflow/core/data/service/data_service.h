@@ -92,8 +92,10 @@ class DataServiceDispatcherClient : public DataServiceClientBase {
   // definition in `dataset_def`.
   Status GetDatasetDef(int64 dataset_id, DatasetDef& dataset_def);
 
-  // Gets the next split for the specified job id and repetition.
-  Status GetSplit(int64 job_id, int64 repetition, Tensor& split,
+  // Gets the next split for the specified job id and repetition, on behalf of
+  // the worker at `worker_address`.
+  Status GetSplit(int64 job_id, int64 repetition,
+                  const std::string& worker_address, Tensor& split,
                   bool& end_of_splits);
 
   // Registers a dataset with the tf.data service, and stores the generated
@@ -141,6 +143,9 @@ class DataServiceWorkerClient : public DataServiceClientBase {
   // Fetches the next element for the specified task_id. The element's
   // compressed tensors will be stored in `element`. If no element is available,
   // `end_of_sequence` will be `true`, and `element` will be left unchanged.
+  //
+  // If the worker runs in the same process, the request is handed to it
+  // directly instead of through RPC.
   Status GetElement(int64 task_id, CompressedElement& element,
                     bool& end_of_sequence);
 
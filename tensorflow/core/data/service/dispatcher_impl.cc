@@ -254,6 +254,7 @@ Status DataServiceDispatcherImpl::WorkerHeartbeat(
     if (task->job->num_consumers.has_value()) {
       task_def->set_num_consumers(task->job->num_consumers.value());
     }
+    SetSharedProducerWindowSize(*task->job, *task_def);
   }
   for (int64 current_task : current_tasks) {
     if (!correct_tasks_set.contains(current_task)) {
@@ -329,8 +330,14 @@ Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
   DCHECK(split_provider != nullptr);
   Tensor split;
   bool end_of_splits = false;
-  TF_RETURN_IF_ERROR(split_provider->GetNext(&split, &end_of_splits));
-  TF_RETURN_IF_ERROR(RecordSplitProduced(job_id, repetition, end_of_splits));
+  if (config_.split_locality_lookahead() > 0) {
+    TF_RETURN_IF_ERROR(GetScheduledSplit(*job, repetition,
+                                         request->worker_address(), split,
+                                         end_of_splits));
+  } else {
+    TF_RETURN_IF_ERROR(split_provider->GetNext(&split, &end_of_splits));
+    TF_RETURN_IF_ERROR(RecordSplitProduced(job_id, repetition, end_of_splits));
+  }
   response->set_end_of_splits(end_of_splits);
   if (end_of_splits) {
     // Create a new split provider for the next repetition.
@@ -343,6 +350,40 @@ Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
   return Status::OK();
 }
 
+Status DataServiceDispatcherImpl::GetScheduledSplit(
+    const Job& job, int64 repetition, const std::string& worker_address,
+    Tensor& split, bool& end_of_splits) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::unique_ptr<SplitScheduler>& scheduler = split_schedulers_[job.job_id];
+  if (!scheduler) {
+    scheduler = absl::make_unique<SplitScheduler>(
+        /*max_skips=*/config_.split_locality_lookahead());
+  }
+  SplitProvider* split_provider = split_providers_[job.job_id].get();
+  while (!scheduler->end_of_splits() &&
+         scheduler->num_buffered() < config_.split_locality_lookahead()) {
+    Tensor buffered;
+    bool provider_end_of_splits = false;
+    TF_RETURN_IF_ERROR(
+        split_provider->GetNext(&buffered, &provider_end_of_splits));
+    if (provider_end_of_splits) {
+      scheduler->SetEndOfSplits();
+      break;
+    }
+    // Splits are journaled when they leave the split provider, so that a
+    // restarted dispatcher resumes the provider after the buffered splits.
+    TF_RETURN_IF_ERROR(
+        RecordSplitProduced(job.job_id, repetition, /*finished=*/false));
+    scheduler->AddSplit(std::move(buffered));
+  }
+  end_of_splits = !scheduler->GetSplit(worker_address, split);
+  if (end_of_splits) {
+    TF_RETURN_IF_ERROR(
+        RecordSplitProduced(job.job_id, repetition, /*finished=*/true));
+    split_schedulers_.erase(job.job_id);
+  }
+  return Status::OK();
+}
+
 Status DataServiceDispatcherImpl::MakeSplitProvider(
     int64 dataset_id, std::unique_ptr<SplitProvider>& split_provider)
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -619,6 +660,18 @@ Status DataServiceDispatcherImpl::GetOrCreateWorkerStub(
   return Status::OK();
 }
 
+void DataServiceDispatcherImpl::SetSharedProducerWindowSize(
+    const Job& job, TaskDef& task_def) const {
+  // Only jobs whose tasks each produce a whole epoch in any order can share
+  // producers.
+  if (config_.shared_producer_window_size() > 0 &&
+      job.processing_mode == ProcessingMode::PARALLEL_EPOCHS &&
+      !job.num_consumers.has_value()) {
+    task_def.set_shared_producer_window_size(
+        config_.shared_producer_window_size());
+  }
+}
+
 Status DataServiceDispatcherImpl::AssignTask(std::shared_ptr<const Task> task)
     TF_LOCKS_EXCLUDED(mu_) {
   VLOG(2) << "Started assigning task " << task->task_id << " to worker "
@@ -646,6 +699,7 @@ Status DataServiceDispatcherImpl::AssignTask(std::shared_ptr<const Task> task)
   }
   task_def->set_task_id(task->task_id);
   task_def->set_processing_mode(ProcessingModeDef(task->job->processing_mode));
+  SetSharedProducerWindowSize(*task->job, *task_def);
   ProcessTaskResponse resp;
   WorkerService::Stub* stub;
   TF_RETURN_IF_ERROR(GetOrCreateWorkerStub(task->worker_address, stub));
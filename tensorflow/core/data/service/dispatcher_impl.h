@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/dataset_store.h"
 #include "tensorflow/core/data/service/dispatcher.pb.h"
 #include "tensorflow/core/data/service/dispatcher_state.h"
+#include "tensorflow/core/data/service/split_scheduler.h"
 #include "tensorflow/core/data/service/worker.grpc.pb.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -87,6 +88,13 @@ class DataServiceDispatcherImpl {
   Status MakeSplitProvider(int64 dataset_id,
                            std::unique_ptr<SplitProvider>& split_provider)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Gets the next split of `job` for the worker at `worker_address` from the
+  // job's `SplitScheduler`, first refilling the scheduler from the job's split
+  // provider.
+  Status GetScheduledSplit(const DispatcherState::Job& job, int64 repetition,
+                           const std::string& worker_address, Tensor& split,
+                           bool& end_of_splits)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Registers a dataset with the given fingerprint, storing the new dataset's
   // id in `dataset_id`.
   Status RegisterDataset(uint64 fingerprint, const DatasetDef& dataset,
@@ -128,6 +136,10 @@ class DataServiceDispatcherImpl {
   Status AssignTasks(
       std::vector<std::shared_ptr<const DispatcherState::Task>> tasks)
       TF_LOCKS_EXCLUDED(mu_);
+  // Configures `task_def` to share producers with the tasks of other jobs
+  // over the same dataset, if sharing is enabled and applies to `job`.
+  void SetSharedProducerWindowSize(const DispatcherState::Job& job,
+                                   TaskDef& task_def) const;
   // Assigns a task to the worker indicated by its `worker_address` field.
   Status AssignTask(std::shared_ptr<const DispatcherState::Task> task)
       TF_LOCKS_EXCLUDED(mu_);
@@ -178,6 +190,11 @@ class DataServiceDispatcherImpl {
   // DISTRIBUTED_EPOCH.
   absl::flat_hash_map<int64, std::unique_ptr<SplitProvider>> split_providers_
       TF_GUARDED_BY(mu_);
+  // Mapping from job id to the `SplitScheduler` of the job's current
+  // repetition, for DISTRIBUTED_EPOCH jobs when `split_locality_lookahead` is
+  // positive.
+  absl::flat_hash_map<int64, std::unique_ptr<SplitScheduler>>
+      split_schedulers_ TF_GUARDED_BY(mu_);
 
   absl::optional<std::unique_ptr<JournalWriter>> journal_writer_
       TF_GUARDED_BY(mu_);
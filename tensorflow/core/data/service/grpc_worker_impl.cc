@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/grpc_worker_impl.h"
 
 #include "grpcpp/server_context.h"
+#include "tensorflow/core/data/service/local_workers.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 
 namespace tensorflow {
@@ -26,20 +27,29 @@ using ::grpc::ServerContext;
 
 GrpcWorkerImpl::GrpcWorkerImpl(const experimental::WorkerConfig& config,
                                ServerBuilder& server_builder)
-    : impl_(config) {
+    : impl_(std::make_shared<DataServiceWorkerImpl>(config)) {
   server_builder.RegisterService(this);
   VLOG(1) << "Registered data service worker";
 }
 
+GrpcWorkerImpl::~GrpcWorkerImpl() {
+  if (!worker_address_.empty()) {
+    LocalWorkers::Remove(worker_address_);
+  }
+}
+
 Status GrpcWorkerImpl::Start(const std::string& worker_address) {
-  return impl_.Start(worker_address);
+  TF_RETURN_IF_ERROR(impl_->Start(worker_address));
+  worker_address_ = worker_address;
+  LocalWorkers::Add(worker_address_, impl_);
+  return Status::OK();
 }
 
 #define HANDLER(method)                                                 \
   ::grpc::Status GrpcWorkerImpl::method(ServerContext* context,         \
                                         const method##Request* request, \
                                         method##Response* response) {   \
-    return ToGrpcStatus(impl_.method(request, response));               \
+    return ToGrpcStatus(impl_->method(request, response));              \
   }
 HANDLER(ProcessTask);
 HANDLER(GetElement);
@@ -31,7 +31,7 @@ class GrpcWorkerImpl : public WorkerService::Service {
   // `server_builder`.
   explicit GrpcWorkerImpl(const experimental::WorkerConfig& config,
                           ::grpc::ServerBuilder& server_builder);
-  ~GrpcWorkerImpl() override {}
+  ~GrpcWorkerImpl() override;
 
   Status Start(const std::string& worker_address);
 
@@ -45,7 +45,9 @@ class GrpcWorkerImpl : public WorkerService::Service {
 #undef HANDLER
 
  private:
-  DataServiceWorkerImpl impl_;
+  // Shared with clients in the same process, which call it directly.
+  const std::shared_ptr<DataServiceWorkerImpl> impl_;
+  std::string worker_address_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(GrpcWorkerImpl);
 };
@@ -0,0 +1,63 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/local_workers.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using AddressToWorkerMap =
+    absl::flat_hash_map<std::string, std::shared_ptr<LocalWorker>>;
+
+mutex* LocalWorkersMutex() {
+  static mutex* mu = new mutex;
+  return mu;
+}
+
+// Must be accessed while holding `LocalWorkersMutex()`.
+AddressToWorkerMap* LocalWorkersMap() {
+  static AddressToWorkerMap* local_workers = new AddressToWorkerMap;
+  return local_workers;
+}
+
+}  // namespace
+
+void LocalWorkers::Add(absl::string_view worker_address,
+                       std::shared_ptr<LocalWorker> worker) {
+  mutex_lock l(*LocalWorkersMutex());
+  (*LocalWorkersMap())[worker_address] = std::move(worker);
+}
+
+std::shared_ptr<LocalWorker> LocalWorkers::Get(
+    absl::string_view worker_address) {
+  mutex_lock l(*LocalWorkersMutex());
+  AddressToWorkerMap* local_workers = LocalWorkersMap();
+  auto it = local_workers->find(worker_address);
+  if (it == local_workers->end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+void LocalWorkers::Remove(absl::string_view worker_address) {
+  mutex_lock l(*LocalWorkersMutex());
+  LocalWorkersMap()->erase(worker_address);
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,57 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_LOCAL_WORKERS_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_LOCAL_WORKERS_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/platform/status.h"
+
+namespace tensorflow {
+namespace data {
+
+// Worker API which clients in the same process as the worker can call
+// directly, skipping RPC and proto serialization.
+class LocalWorker {
+ public:
+  virtual ~LocalWorker() = default;
+
+  // See worker.proto for API documentation.
+  virtual Status GetElement(const GetElementRequest* request,
+                            GetElementResponse* response) = 0;
+};
+
+// Process-wide registry of the workers running in this process, keyed by the
+// addresses they registered with the dispatcher.
+class LocalWorkers {
+ public:
+  // Registers `worker` as the worker serving `worker_address`, replacing any
+  // worker previously registered for that address.
+  static void Add(absl::string_view worker_address,
+                  std::shared_ptr<LocalWorker> worker);
+  // Returns the worker serving `worker_address`, or nullptr if that worker
+  // does not run in this process.
+  static std::shared_ptr<LocalWorker> Get(absl::string_view worker_address);
+  // Unregisters the worker serving `worker_address`.
+  static void Remove(absl::string_view worker_address);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_LOCAL_WORKERS_H_
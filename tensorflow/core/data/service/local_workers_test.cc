@@ -0,0 +1,77 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/local_workers.h"
+
+#include <memory>
+
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Returns end of sequence for every task.
+class FakeLocalWorker : public LocalWorker {
+ public:
+  Status GetElement(const GetElementRequest* request,
+                    GetElementResponse* response) override {
+    ++num_requests_;
+    response->set_end_of_sequence(true);
+    return Status::OK();
+  }
+
+  int num_requests() const { return num_requests_; }
+
+ private:
+  int num_requests_ = 0;
+};
+
+TEST(LocalWorkersTest, AddGetRemove) {
+  constexpr char kAddress[] = "localhost:1234";
+  EXPECT_EQ(LocalWorkers::Get(kAddress), nullptr);
+
+  auto worker = std::make_shared<FakeLocalWorker>();
+  LocalWorkers::Add(kAddress, worker);
+  std::shared_ptr<LocalWorker> local_worker = LocalWorkers::Get(kAddress);
+  ASSERT_NE(local_worker, nullptr);
+  EXPECT_EQ(LocalWorkers::Get("localhost:5678"), nullptr);
+
+  GetElementRequest req;
+  GetElementResponse resp;
+  TF_ASSERT_OK(local_worker->GetElement(&req, &resp));
+  EXPECT_TRUE(resp.end_of_sequence());
+  EXPECT_EQ(worker->num_requests(), 1);
+
+  LocalWorkers::Remove(kAddress);
+  EXPECT_EQ(LocalWorkers::Get(kAddress), nullptr);
+}
+
+TEST(LocalWorkersTest, ReplaceWorker) {
+  constexpr char kAddress[] = "localhost:1234";
+  auto worker1 = std::make_shared<FakeLocalWorker>();
+  auto worker2 = std::make_shared<FakeLocalWorker>();
+  LocalWorkers::Add(kAddress, worker1);
+  LocalWorkers::Add(kAddress, worker2);
+  EXPECT_EQ(LocalWorkers::Get(kAddress), worker2);
+  LocalWorkers::Remove(kAddress);
+  EXPECT_EQ(LocalWorkers::Get(kAddress), nullptr);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -28,10 +28,12 @@ namespace data {
 class DataServiceSplitProvider : public SplitProvider {
  public:
   DataServiceSplitProvider(const std::string& address,
-                           const std::string& protocol, int64 job_id,
+                           const std::string& protocol,
+                           const std::string& worker_address, int64 job_id,
                            int64 timeout_ms)
       : address_(address),
         protocol_(protocol),
+        worker_address_(worker_address),
         job_id_(job_id),
         timeout_ms_(timeout_ms) {}
 
@@ -45,6 +47,7 @@ class DataServiceSplitProvider : public SplitProvider {
  private:
   const std::string address_;
   const std::string protocol_;
+  const std::string worker_address_;
   const int64 job_id_;
   const int64 timeout_ms_;
 
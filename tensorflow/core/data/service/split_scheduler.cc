@@ -0,0 +1,86 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/split_scheduler.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/framework/types.pb.h"
+
+namespace tensorflow {
+namespace data {
+
+void SplitScheduler::AddSplit(Tensor split) {
+  buffer_.push_back({std::move(split)});
+}
+
+bool SplitScheduler::GetSplit(const std::string& worker_address,
+                              Tensor& split) {
+  if (buffer_.empty()) {
+    return false;
+  }
+  size_t chosen = 0;
+  auto last_split = last_splits_.find(worker_address);
+  if (last_split != last_splits_.end() &&
+      buffer_.front().num_skips < max_skips_) {
+    int64 best_affinity = 0;
+    for (size_t i = 0; i < buffer_.size(); ++i) {
+      int64 affinity = SplitAffinity(last_split->second, buffer_[i].split);
+      if (affinity > best_affinity) {
+        best_affinity = affinity;
+        chosen = i;
+      }
+    }
+  }
+  for (size_t i = 0; i < chosen; ++i) {
+    ++buffer_[i].num_skips;
+  }
+  split = std::move(buffer_[chosen].split);
+  buffer_.erase(buffer_.begin() + chosen);
+  last_splits_[worker_address] = split;
+  return true;
+}
+
+int64 SplitAffinity(const Tensor& a, const Tensor& b) {
+  if (a.dtype() != b.dtype() || a.NumElements() != 1 ||
+      b.NumElements() != 1) {
+    return 0;
+  }
+  switch (a.dtype()) {
+    case DT_STRING: {
+      const tstring& a_str = a.flat<tstring>()(0);
+      const tstring& b_str = b.flat<tstring>()(0);
+      size_t size = std::min(a_str.size(), b_str.size());
+      return std::mismatch(a_str.data(), a_str.data() + size, b_str.data())
+                 .first -
+             a_str.data();
+    }
+    case DT_INT32:
+    case DT_INT64: {
+      int64 a_value = a.dtype() == DT_INT32 ? a.flat<int32>()(0)
+                                             : a.flat<int64>()(0);
+      int64 b_value = b.dtype() == DT_INT32 ? b.flat<int32>()(0)
+                                             : b.flat<int64>()(0);
+      if (a_value == b_value) {
+        return 2;
+      }
+      return (a_value + 1 == b_value || b_value + 1 == a_value) ? 1 : 0;
+    }
+    default:
+      return 0;
+  }
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,79 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_SPLIT_SCHEDULER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_SPLIT_SCHEDULER_H_
+
+#include <deque>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+namespace data {
+
+// Hands out the splits of one repetition of a distributed_epoch job, preferring
+// to give each worker splits close to the ones it processed before, so that
+// workers keep reading from files and blocks they already have cached.
+//
+// The dispatcher buffers splits in the order the split provider produces them.
+// A worker asking for a split gets the buffered split with the highest
+// affinity to the last split it received (see `SplitAffinity`), or the oldest
+// one if no split has any affinity. Splits are only assigned when a worker asks
+// for them, so no split ever waits behind a slow worker; to keep the order
+// close to the provider's, a split passed over `max_skips` times is handed to
+// the next worker that asks.
+//
+// Not thread-safe.
+class SplitScheduler {
+ public:
+  explicit SplitScheduler(int64 max_skips) : max_skips_(max_skips) {}
+
+  // Adds a split produced by the split provider.
+  void AddSplit(Tensor split);
+  // Records that the split provider has no more splits.
+  void SetEndOfSplits() { end_of_splits_ = true; }
+  // Removes the split to give to `worker_address` from the buffer and stores
+  // it in `split`. Returns false if there are no buffered splits.
+  bool GetSplit(const std::string& worker_address, Tensor& split);
+
+  int64 num_buffered() const { return buffer_.size(); }
+  bool end_of_splits() const { return end_of_splits_; }
+
+ private:
+  struct BufferedSplit {
+    Tensor split;
+    // Number of times a newer split was handed out instead of this one.
+    int64 num_skips = 0;
+  };
+
+  const int64 max_skips_;
+  std::deque<BufferedSplit> buffer_;
+  bool end_of_splits_ = false;
+  // The last split given to each worker.
+  absl::flat_hash_map<std::string, Tensor> last_splits_;
+};
+
+// Returns how close split `b` is to split `a`, with 0 meaning the splits are
+// unrelated. String splits, usually file names, score the length of their
+// common prefix, so that identical files and other files of the same directory
+// or sharded set score high. Integer splits score 2 if they are identical and 1
+// if they are adjacent.
+int64 SplitAffinity(const Tensor& a, const Tensor& b);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_SPLIT_SCHEDULER_H_
@@ -0,0 +1,108 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/split_scheduler.h"
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+std::string GetFileSplit(SplitScheduler& scheduler,
+                         const std::string& worker_address) {
+  Tensor split;
+  EXPECT_TRUE(scheduler.GetSplit(worker_address, split));
+  return split.scalar<tstring>()();
+}
+
+TEST(SplitScheduler, PrefersAffineSplits) {
+  SplitScheduler scheduler(/*max_skips=*/10);
+  for (const char* file : {"a/0", "b/0", "a/1", "b/1"}) {
+    scheduler.AddSplit(test::AsScalar<tstring>(file));
+  }
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "a/0");
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_b"), "b/0");
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_b"), "b/1");
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "a/1");
+  Tensor split;
+  EXPECT_FALSE(scheduler.GetSplit("worker_a", split));
+}
+
+TEST(SplitScheduler, FallsBackToOldestSplit) {
+  SplitScheduler scheduler(/*max_skips=*/10);
+  for (const char* file : {"a/0", "b/0", "c/0"}) {
+    scheduler.AddSplit(test::AsScalar<tstring>(file));
+  }
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "a/0");
+  // No buffered split has affinity with "a/0".
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "b/0");
+  // A new worker gets the oldest split.
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_c"), "c/0");
+}
+
+TEST(SplitScheduler, MaxSkips) {
+  SplitScheduler scheduler(/*max_skips=*/2);
+  for (const char* file : {"a/0", "b/0", "a/1", "a/2", "a/3"}) {
+    scheduler.AddSplit(test::AsScalar<tstring>(file));
+  }
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "a/0");
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "a/1");
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "a/2");
+  // "b/0" has been skipped twice, so it is handed out next.
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "b/0");
+  EXPECT_EQ(GetFileSplit(scheduler, "worker_a"), "a/3");
+}
+
+TEST(SplitScheduler, EndOfSplits) {
+  SplitScheduler scheduler(/*max_skips=*/10);
+  EXPECT_FALSE(scheduler.end_of_splits());
+  scheduler.AddSplit(test::AsScalar<int64>(0));
+  scheduler.SetEndOfSplits();
+  EXPECT_TRUE(scheduler.end_of_splits());
+  EXPECT_EQ(scheduler.num_buffered(), 1);
+  Tensor split;
+  EXPECT_TRUE(scheduler.GetSplit("worker", split));
+  EXPECT_EQ(scheduler.num_buffered(), 0);
+  EXPECT_FALSE(scheduler.GetSplit("worker", split));
+}
+
+TEST(SplitAffinity, Strings) {
+  Tensor file = test::AsScalar<tstring>("dir/file-00001");
+  EXPECT_EQ(SplitAffinity(file, file), 14);
+  EXPECT_EQ(SplitAffinity(file, test::AsScalar<tstring>("dir/file-00002")),
+            13);
+  EXPECT_EQ(SplitAffinity(file, test::AsScalar<tstring>("other")), 0);
+}
+
+TEST(SplitAffinity, Integers) {
+  EXPECT_EQ(SplitAffinity(test::AsScalar<int64>(5), test::AsScalar<int64>(5)),
+            2);
+  EXPECT_EQ(SplitAffinity(test::AsScalar<int64>(5), test::AsScalar<int64>(6)),
+            1);
+  EXPECT_EQ(SplitAffinity(test::AsScalar<int32>(5), test::AsScalar<int32>(4)),
+            1);
+  EXPECT_EQ(SplitAffinity(test::AsScalar<int64>(5), test::AsScalar<int64>(7)),
+            0);
+  EXPECT_EQ(SplitAffinity(test::AsScalar<int64>(5), test::AsScalar<int32>(5)),
+            0);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/task_runner.h"
 
 #include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/errors.h"
 
@@ -125,5 +126,103 @@ Status RoundRobinTaskRunner::FillBuffer() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   }
   return Status::OK();
 }
+
+SharedProducer::SharedProducer(std::unique_ptr<TaskIterator> iterator,
+                               int64 window_size)
+    : window_size_(window_size), iterator_(std::move(iterator)) {}
+
+int64 SharedProducer::AddConsumer() {
+  mutex_lock l(mu_);
+  int64 consumer_id = next_consumer_id_++;
+  positions_[consumer_id] = buffer_start_;
+  return consumer_id;
+}
+
+void SharedProducer::RemoveConsumer(int64 consumer_id) {
+  mutex_lock l(mu_);
+  positions_.erase(consumer_id);
+  EvictLocked();
+  cv_.notify_all();
+}
+
+Status SharedProducer::GetNext(int64 consumer_id, std::vector<Tensor>& element,
+                               bool& end_of_sequence) {
+  while (true) {
+    {
+      mutex_lock l(mu_);
+      while (true) {
+        auto it = positions_.find(consumer_id);
+        if (it == positions_.end()) {
+          return errors::FailedPrecondition("Unknown consumer ", consumer_id);
+        }
+        int64 offset = it->second - buffer_start_;
+        if (offset < static_cast<int64>(buffer_.size())) {
+          // Consumers each take their own copy, since elements are consumed
+          // destructively when sent to clients.
+          element.clear();
+          for (const Tensor& tensor : buffer_[offset]) {
+            element.push_back(tensor::DeepCopy(tensor));
+          }
+          end_of_sequence = false;
+          ++it->second;
+          EvictLocked();
+          cv_.notify_all();
+          return Status::OK();
+        }
+        TF_RETURN_IF_ERROR(status_);
+        if (end_of_sequence_) {
+          end_of_sequence = true;
+          return Status::OK();
+        }
+        if (!producing_ && static_cast<int64>(buffer_.size()) < window_size_) {
+          producing_ = true;
+          break;
+        }
+        cv_.wait(l);
+      }
+    }
+    // Produce the next element without holding `mu_`, so that other
+    // consumers can keep reading buffered elements.
+    std::vector<Tensor> next;
+    bool end_of_input = false;
+    Status s = iterator_->GetNext(next, end_of_input);
+    mutex_lock l(mu_);
+    producing_ = false;
+    if (!s.ok()) {
+      status_ = s;
+    } else if (end_of_input) {
+      end_of_sequence_ = true;
+    } else {
+      buffer_.push_back(std::move(next));
+    }
+    cv_.notify_all();
+  }
+}
+
+void SharedProducer::EvictLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  int64 min_position = buffer_start_ + buffer_.size();
+  for (const auto& position : positions_) {
+    min_position = std::min(min_position, position.second);
+  }
+  while (buffer_start_ < min_position) {
+    buffer_.pop_front();
+    ++buffer_start_;
+  }
+}
+
+SharedProducerTaskRunner::SharedProducerTaskRunner(
+    std::shared_ptr<SharedProducer> producer)
+    : producer_(std::move(producer)),
+      consumer_id_(producer_->AddConsumer()) {}
+
+SharedProducerTaskRunner::~SharedProducerTaskRunner() {
+  producer_->RemoveConsumer(consumer_id_);
+}
+
+Status SharedProducerTaskRunner::GetNext(const Request& request,
+                                         std::vector<Tensor>& element,
+                                         bool& end_of_task) {
+  return producer_->GetNext(consumer_id_, element, end_of_task);
+}
 }  // namespace data
 }  // namespace tensorflow
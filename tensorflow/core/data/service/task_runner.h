@@ -15,8 +15,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_TASK_RUNNER_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_TASK_RUNNER_H_
 
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 
 namespace tensorflow {
@@ -137,6 +143,66 @@ class RoundRobinTaskRunner : public TaskRunner {
   std::vector<Result> buffer_ TF_GUARDED_BY(mu_);
 };
 
+// Produces the elements of a single iterator for any number of consumers,
+// each of which receives every element. This lets the tasks of several jobs
+// over the same dataset share one stream instead of each processing the
+// dataset.
+//
+// Produced elements are kept in a sliding window of at most `window_size`
+// elements, starting at the oldest element not yet read by all consumers. A
+// consumer that gets `window_size` elements ahead of the slowest consumer
+// blocks until the slowest consumer catches up. A consumer joining the stream
+// starts at the oldest buffered element, so it may not see the first elements
+// of the dataset.
+class SharedProducer {
+ public:
+  SharedProducer(std::unique_ptr<TaskIterator> iterator, int64 window_size);
+
+  // Registers a new consumer and returns its id.
+  int64 AddConsumer();
+  // Unregisters a consumer, releasing the elements only it still needed.
+  void RemoveConsumer(int64 consumer_id);
+  // Stores a copy of the next element for the consumer in `element`, or sets
+  // `end_of_sequence` if the stream is exhausted.
+  Status GetNext(int64 consumer_id, std::vector<Tensor>& element,
+                 bool& end_of_sequence);
+
+ private:
+  // Drops the buffered elements read by all consumers.
+  void EvictLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64 window_size_;
+  std::unique_ptr<TaskIterator> iterator_;
+  mutex mu_;
+  // Notified whenever an element is produced or evicted.
+  condition_variable cv_;
+  // Buffered elements. `buffer_.front()` has index `buffer_start_` in the
+  // stream.
+  std::deque<std::vector<Tensor>> buffer_ TF_GUARDED_BY(mu_);
+  int64 buffer_start_ TF_GUARDED_BY(mu_) = 0;
+  // Map from consumer id to the index of the next element it reads.
+  absl::flat_hash_map<int64, int64> positions_ TF_GUARDED_BY(mu_);
+  int64 next_consumer_id_ TF_GUARDED_BY(mu_) = 0;
+  // Whether a consumer is currently producing the next element.
+  bool producing_ TF_GUARDED_BY(mu_) = false;
+  bool end_of_sequence_ TF_GUARDED_BY(mu_) = false;
+  Status status_ TF_GUARDED_BY(mu_);
+};
+
+// A task runner which reads its task's elements from a `SharedProducer`,
+// registering as one of its consumers for the lifetime of the runner.
+class SharedProducerTaskRunner : public TaskRunner {
+ public:
+  explicit SharedProducerTaskRunner(std::shared_ptr<SharedProducer> producer);
+  ~SharedProducerTaskRunner() override;
+  Status GetNext(const Request& request, std::vector<Tensor>& element,
+                 bool& end_of_task) override;
+
+ private:
+  const std::shared_ptr<SharedProducer> producer_;
+  const int64 consumer_id_;
+};
+
 }  // namespace data
 }  // namespace tensorflow
 
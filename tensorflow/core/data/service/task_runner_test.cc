@@ -191,5 +191,88 @@ TEST(RoundRobinTaskRunner, ConsumeParallelPartialRound) {
     }
   }
 }
+
+TEST(SharedProducerTaskRunner, EveryConsumerGetsEveryElement) {
+  int64 num_elements = 1000;
+  int64 num_consumers = 4;
+  std::vector<std::vector<Tensor>> elements;
+  for (int64 i = 0; i < num_elements; ++i) {
+    std::vector<Tensor> element;
+    element.push_back(Tensor(i));
+    elements.push_back(element);
+  }
+  auto producer = std::make_shared<SharedProducer>(
+      absl::make_unique<TestTaskIterator>(elements), /*window_size=*/3);
+  std::vector<std::unique_ptr<SharedProducerTaskRunner>> runners;
+  for (int consumer = 0; consumer < num_consumers; ++consumer) {
+    runners.push_back(absl::make_unique<SharedProducerTaskRunner>(producer));
+  }
+  std::vector<std::vector<std::vector<Tensor>>> per_consumer_results(
+      num_consumers);
+  std::vector<std::unique_ptr<Thread>> consumers;
+  mutex mu;
+  Status error;
+  for (int consumer = 0; consumer < num_consumers; ++consumer) {
+    consumers.push_back(absl::WrapUnique(Env::Default()->StartThread(
+        {}, absl::StrCat("consumer_", consumer), [&, consumer] {
+          std::vector<std::vector<Tensor>> results;
+          Status s = RunConsumer(consumer, /*start_index=*/0,
+                                 *runners[consumer], results);
+          mutex_lock l(mu);
+          if (!s.ok()) {
+            error = s;
+            return;
+          }
+          per_consumer_results[consumer] = std::move(results);
+        })));
+  }
+  // Wait for all consumers to finish;
+  consumers.clear();
+  mutex_lock l(mu);
+  TF_ASSERT_OK(error);
+  for (int consumer = 0; consumer < num_consumers; ++consumer) {
+    auto& results = per_consumer_results[consumer];
+    ASSERT_EQ(results.size(), num_elements);
+    for (int i = 0; i < num_elements; ++i) {
+      test::ExpectEqual(results[i][0], elements[i][0]);
+    }
+  }
+}
+
+TEST(SharedProducerTaskRunner, LateConsumerStartsAtOldestBufferedElement) {
+  std::vector<std::vector<Tensor>> elements;
+  for (int64 i = 0; i < 10; ++i) {
+    std::vector<Tensor> element;
+    element.push_back(Tensor(i));
+    elements.push_back(element);
+  }
+  auto producer = std::make_shared<SharedProducer>(
+      absl::make_unique<TestTaskIterator>(elements), /*window_size=*/5);
+  TaskRunner::Request request;
+  std::vector<Tensor> element;
+  bool end_of_sequence = false;
+  auto first = absl::make_unique<SharedProducerTaskRunner>(producer);
+  auto second = absl::make_unique<SharedProducerTaskRunner>(producer);
+  // `first` reads 0 to 3. Element 1 and later stay buffered for `second`.
+  for (int64 i = 0; i < 4; ++i) {
+    TF_ASSERT_OK(first->GetNext(request, element, end_of_sequence));
+    test::ExpectEqual(element[0], Tensor(i));
+  }
+  TF_ASSERT_OK(second->GetNext(request, element, end_of_sequence));
+  test::ExpectEqual(element[0], Tensor(int64{0}));
+  auto late = absl::make_unique<SharedProducerTaskRunner>(producer);
+  TF_ASSERT_OK(late->GetNext(request, element, end_of_sequence));
+  test::ExpectEqual(element[0], Tensor(int64{1}));
+  // Once the other consumers are gone, the window no longer holds `first`
+  // back.
+  second.reset();
+  late.reset();
+  for (int64 i = 4; i < 10; ++i) {
+    TF_ASSERT_OK(first->GetNext(request, element, end_of_sequence));
+    test::ExpectEqual(element[0], Tensor(i));
+  }
+  TF_ASSERT_OK(first->GetNext(request, element, end_of_sequence));
+  EXPECT_TRUE(end_of_sequence);
+}
 }  // namespace data
 }  // namespace tensorflow
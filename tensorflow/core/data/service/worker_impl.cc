@@ -118,28 +118,49 @@ Status DataServiceWorkerImpl::ProcessTaskInternal(const TaskDef& task_def)
 }
 
 Status DataServiceWorkerImpl::EnsureTaskInitialized(
-    DataServiceWorkerImpl::Task& task) {
+    DataServiceWorkerImpl::Task& task) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   mutex_lock l(task.mu);
   if (task.initialized) {
     return Status::OK();
   }
+  if (task.task_def.shared_producer_window_size() > 0) {
+    std::shared_ptr<SharedProducer> producer;
+    TF_RETURN_IF_ERROR(GetOrCreateSharedProducer(task.task_def, producer));
+    task.task_runner =
+        std::make_shared<SharedProducerTaskRunner>(std::move(producer));
+  } else {
+    std::unique_ptr<TaskIterator> task_iterator;
+    TF_RETURN_IF_ERROR(MakeTaskIterator(task.task_def, task_iterator));
+    std::unique_ptr<TaskRunner> task_runner;
+    TF_RETURN_IF_ERROR(TaskRunner::Create(
+        task.task_def, std::move(task_iterator), task_runner));
+    task.task_runner = std::move(task_runner);
+  }
+
+  task.initialized = true;
+  VLOG(3) << "Created iterator for task " << task.task_def.task_id();
+  return Status::OK();
+}
+
+Status DataServiceWorkerImpl::MakeTaskIterator(
+    const TaskDef& task_def, std::unique_ptr<TaskIterator>& out) {
   standalone::Dataset::Params params;
   std::unique_ptr<standalone::Dataset> dataset;
   std::unique_ptr<standalone::Iterator> iterator;
 
-  switch (task.task_def.dataset_case()) {
+  switch (task_def.dataset_case()) {
     case TaskDef::kDatasetDef:
       TF_RETURN_IF_ERROR(standalone::Dataset::FromGraph(
-          params, task.task_def.dataset_def().graph(), &dataset));
+          params, task_def.dataset_def().graph(), &dataset));
       break;
     case TaskDef::kPath: {
       DatasetDef def;
-      Status s = ReadDatasetDef(task.task_def.path(), def);
+      Status s = ReadDatasetDef(task_def.path(), def);
       if (!s.ok()) {
-        LOG(INFO) << "Failed to read dataset from " << task.task_def.path()
-                  << ": " << s << ". Falling back to reading from dispatcher.";
+        LOG(INFO) << "Failed to read dataset from " << task_def.path() << ": "
+                  << s << ". Falling back to reading from dispatcher.";
         TF_RETURN_IF_ERROR(
-            dispatcher_->GetDatasetDef(task.task_def.dataset_id(), def));
+            dispatcher_->GetDatasetDef(task_def.dataset_id(), def));
       }
       TF_RETURN_IF_ERROR(
           standalone::Dataset::FromGraph(params, def.graph(), &dataset));
@@ -147,13 +168,13 @@ Status DataServiceWorkerImpl::EnsureTaskInitialized(
     }
     case TaskDef::DATASET_NOT_SET:
       return errors::Internal("Unrecognized dataset case: ",
-                              task.task_def.dataset_case());
+                              task_def.dataset_case());
   }
-  switch (task.task_def.processing_mode()) {
+  switch (task_def.processing_mode()) {
     case DISTRIBUTED_EPOCH: {
       auto split_provider = absl::make_unique<DataServiceSplitProvider>(
-          config_.dispatcher_address(), config_.protocol(),
-          task.task_def.job_id(), config_.dispatcher_timeout_ms());
+          config_.dispatcher_address(), config_.protocol(), worker_address_,
+          task_def.job_id(), config_.dispatcher_timeout_ms());
       TF_RETURN_IF_ERROR(
           dataset->MakeIterator(std::move(split_provider), &iterator));
       break;
@@ -163,15 +184,29 @@ Status DataServiceWorkerImpl::EnsureTaskInitialized(
       break;
     default:
       return errors::InvalidArgument("Unrecognized processing mode: ",
-                                     task.task_def.processing_mode());
+                                     task_def.processing_mode());
   }
-  auto task_iterator = absl::make_unique<StandaloneTaskIterator>(
-      std::move(dataset), std::move(iterator));
-  TF_RETURN_IF_ERROR(TaskRunner::Create(task.task_def, std::move(task_iterator),
-                                        task.task_runner));
+  out = absl::make_unique<StandaloneTaskIterator>(std::move(dataset),
+                                                  std::move(iterator));
+  return Status::OK();
+}
 
-  task.initialized = true;
-  VLOG(3) << "Created iterator for task " << task.task_def.task_id();
+Status DataServiceWorkerImpl::GetOrCreateSharedProducer(
+    const TaskDef& task_def, std::shared_ptr<SharedProducer>& out)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::weak_ptr<SharedProducer>& shared_producer =
+      shared_producers_[task_def.dataset_id()];
+  out = shared_producer.lock();
+  if (out) {
+    VLOG(3) << "Task " << task_def.task_id()
+            << " shares the producer of dataset " << task_def.dataset_id();
+    return Status::OK();
+  }
+  std::unique_ptr<TaskIterator> task_iterator;
+  TF_RETURN_IF_ERROR(MakeTaskIterator(task_def, task_iterator));
+  out = std::make_shared<SharedProducer>(
+      std::move(task_iterator), task_def.shared_producer_window_size());
+  shared_producer = out;
   return Status::OK();
 }
 
@@ -180,6 +215,8 @@ Status DataServiceWorkerImpl::GetElement(const GetElementRequest* request,
   VLOG(3) << "Received GetElement request for task " << request->task_id();
   bool end_of_sequence = false;
   std::vector<tensorflow::Tensor> outputs;
+  std::shared_ptr<TaskRunner> task_runner;
+  TaskRunner::Request get_next_request;
   {
     mutex_lock l(mu_);
     if (!registered_) {
@@ -203,7 +240,6 @@ Status DataServiceWorkerImpl::GetElement(const GetElementRequest* request,
     }
     auto& task = it->second;
     TF_RETURN_IF_ERROR(EnsureTaskInitialized(*task));
-    TaskRunner::Request get_next_request;
     if (request->optional_consumer_index_case() ==
         GetElementRequest::kConsumerIndex) {
       get_next_request.consumer_index = request->consumer_index();
@@ -212,13 +248,17 @@ Status DataServiceWorkerImpl::GetElement(const GetElementRequest* request,
         GetElementRequest::kRoundIndex) {
       get_next_request.round_index = request->round_index();
     }
-    TF_RETURN_IF_ERROR(
-        task->task_runner->GetNext(get_next_request, outputs, end_of_sequence));
-    if (end_of_sequence) {
-      VLOG(3) << "Reached end_of_sequence for task " << request->task_id();
-      pending_completed_tasks_.insert(request->task_id());
-      task_completion_cv_.notify_one();
-    }
+    task_runner = task->task_runner;
+  }
+  // Task runners may block until other consumers make progress, so they are
+  // called without holding `mu_`.
+  TF_RETURN_IF_ERROR(
+      task_runner->GetNext(get_next_request, outputs, end_of_sequence));
+  if (end_of_sequence) {
+    VLOG(3) << "Reached end_of_sequence for task " << request->task_id();
+    mutex_lock l(mu_);
+    pending_completed_tasks_.insert(request->task_id());
+    task_completion_cv_.notify_one();
   }
 
   if (!end_of_sequence) {
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/data_service.h"
 #include "tensorflow/core/data/service/dispatcher.grpc.pb.h"
+#include "tensorflow/core/data/service/local_workers.h"
 #include "tensorflow/core/data/service/task_runner.h"
 #include "tensorflow/core/data/service/worker.pb.h"
 #include "tensorflow/core/data/standalone.h"
@@ -31,10 +32,10 @@ namespace tensorflow {
 namespace data {
 
 // A TensorFlow DataService serves dataset elements over RPC.
-class DataServiceWorkerImpl {
+class DataServiceWorkerImpl : public LocalWorker {
  public:
   explicit DataServiceWorkerImpl(const experimental::WorkerConfig& config);
-  ~DataServiceWorkerImpl();
+  ~DataServiceWorkerImpl() override;
 
   // Starts the worker. The worker needs to know its own address so that it can
   // register with the dispatcher. This is set in `Start` instead of in the
@@ -51,7 +52,7 @@ class DataServiceWorkerImpl {
 
   /// Client-facing API.
   Status GetElement(const GetElementRequest* request,
-                    GetElementResponse* response);
+                    GetElementResponse* response) override;
   Status GetWorkerTasks(const GetWorkerTasksRequest* request,
                         GetWorkerTasksResponse* response);
 
@@ -62,7 +63,9 @@ class DataServiceWorkerImpl {
     TaskDef task_def;
     mutex mu;
     bool initialized TF_GUARDED_BY(mu) = false;
-    std::unique_ptr<TaskRunner> task_runner;
+    // Shared so that requests can read from the runner without holding `mu_`
+    // while the task is deleted.
+    std::shared_ptr<TaskRunner> task_runner;
   };
 
   // Sends task status to the dispatcher and checks for dispatcher commands.
@@ -70,7 +73,15 @@ class DataServiceWorkerImpl {
   // Creates an iterator to process a task.
   Status ProcessTaskInternal(const TaskDef& task)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
-  Status EnsureTaskInitialized(Task& task);
+  Status EnsureTaskInitialized(Task& task) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Creates an iterator over the elements of a task.
+  Status MakeTaskIterator(const TaskDef& task_def,
+                          std::unique_ptr<TaskIterator>& out);
+  // Returns the producer shared by the tasks for `task_def`'s dataset,
+  // creating it if no other task uses it.
+  Status GetOrCreateSharedProducer(const TaskDef& task_def,
+                                   std::shared_ptr<SharedProducer>& out)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // A thread for notifying the dispatcher when tasks complete.
   void TaskCompletionThread() TF_LOCKS_EXCLUDED(mu_);
   // A thread for doing periodic heartbeats to the dispatcher.
@@ -88,6 +99,10 @@ class DataServiceWorkerImpl {
   absl::flat_hash_map<int64, std::unique_ptr<Task>> tasks_ TF_GUARDED_BY(mu_);
   // Ids of tasks that have finished.
   absl::flat_hash_set<int64> finished_tasks_ TF_GUARDED_BY(mu_);
+  // Producers shared by the tasks reading the same dataset, keyed by dataset
+  // id. Producers are owned by the runners of those tasks.
+  absl::flat_hash_map<int64, std::weak_ptr<SharedProducer>> shared_producers_
+      TF_GUARDED_BY(mu_);
   // Completed tasks which haven't yet been communicated to the dispatcher.
   absl::flat_hash_set<int64> pending_completed_tasks_ TF_GUARDED_BY(mu_);
   bool cancelled_ TF_GUARDED_BY(mu_) = false;
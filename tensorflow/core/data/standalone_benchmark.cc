@@ -0,0 +1,257 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks a tf.data input pipeline outside of a TensorFlow session.
+//
+// The pipeline is either read from a serialized dataset graph (as produced by
+// `tf.data.Dataset._as_serialized_graph()`, with a `_Retval` node returning the
+// dataset) or, without --graph_def_path, is a synthetic source producing
+// elements with a fixed latency. Each run iterates over the pipeline and
+// reports its throughput, the distribution of GetNext() latencies and the
+// change of host memory in use.
+//
+// Example:
+//
+//   standalone_benchmark --graph_def_path=/tmp/pipeline.pb \
+//       --num_elements=10000 --warmup_elements=100 --runs=3 \
+//       --inter_op_threads=16
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/histogram/histogram.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/init_main.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/command_line_flags.h"
+
+namespace tensorflow {
+namespace data {
+namespace standalone {
+namespace {
+
+struct BenchmarkOptions {
+  string graph_def_path;
+  int64 synthetic_elements = 10000;
+  int64 synthetic_latency_us = 0;
+  int64 synthetic_prefetch = 0;
+  int64 num_elements = -1;
+  int64 warmup_elements = 0;
+  int32 runs = 1;
+  int32 inter_op_threads = 0;
+  int32 intra_op_threads = 0;
+};
+
+Status AddScalarConst(const string& name, int64 value, GraphDef* graph_def) {
+  Tensor tensor(DT_INT64, TensorShape({}));
+  tensor.scalar<int64>()() = value;
+  return NodeDefBuilder(name, "Const")
+      .Attr("dtype", DT_INT64)
+      .Attr("value", tensor)
+      .Finalize(graph_def->add_node());
+}
+
+// Builds the graph of `range(synthetic_elements)`, with
+// `synthetic_latency_us` of latency per element, optionally followed by a
+// prefetch of `synthetic_prefetch` elements (-1 for autotuning).
+Status MakeSyntheticGraph(const BenchmarkOptions& options,
+                          GraphDef* graph_def) {
+  const DataTypeVector output_types = {DT_INT64};
+  const std::vector<PartialTensorShape> output_shapes = {
+      PartialTensorShape({})};
+
+  TF_RETURN_IF_ERROR(AddScalarConst("start", 0, graph_def));
+  TF_RETURN_IF_ERROR(
+      AddScalarConst("stop", options.synthetic_elements, graph_def));
+  TF_RETURN_IF_ERROR(AddScalarConst("step", 1, graph_def));
+  TF_RETURN_IF_ERROR(NodeDefBuilder("range", "RangeDataset")
+                         .Input("start", 0, DT_INT64)
+                         .Input("stop", 0, DT_INT64)
+                         .Input("step", 0, DT_INT64)
+                         .Attr("output_types", output_types)
+                         .Attr("output_shapes", output_shapes)
+                         .Finalize(graph_def->add_node()));
+  string dataset = "range";
+
+  if (options.synthetic_latency_us > 0) {
+    TF_RETURN_IF_ERROR(AddScalarConst(
+        "sleep_microseconds", options.synthetic_latency_us, graph_def));
+    TF_RETURN_IF_ERROR(NodeDefBuilder("sleep", "SleepDataset")
+                           .Input(dataset, 0, DT_VARIANT)
+                           .Input("sleep_microseconds", 0, DT_INT64)
+                           .Attr("output_types", output_types)
+                           .Attr("output_shapes", output_shapes)
+                           .Finalize(graph_def->add_node()));
+    dataset = "sleep";
+  }
+
+  if (options.synthetic_prefetch != 0) {
+    TF_RETURN_IF_ERROR(AddScalarConst(
+        "buffer_size", options.synthetic_prefetch, graph_def));
+    TF_RETURN_IF_ERROR(NodeDefBuilder("prefetch", "PrefetchDataset")
+                           .Input(dataset, 0, DT_VARIANT)
+                           .Input("buffer_size", 0, DT_INT64)
+                           .Attr("output_types", output_types)
+                           .Attr("output_shapes", output_shapes)
+                           .Finalize(graph_def->add_node()));
+    dataset = "prefetch";
+  }
+
+  return NodeDefBuilder("retval", "_Retval")
+      .Input(dataset, 0, DT_VARIANT)
+      .Attr("index", 0)
+      .Finalize(graph_def->add_node());
+}
+
+Status LoadGraph(const BenchmarkOptions& options, GraphDef* graph_def) {
+  if (options.graph_def_path.empty()) {
+    return MakeSyntheticGraph(options, graph_def);
+  }
+  if (absl::EndsWith(options.graph_def_path, ".pbtxt")) {
+    return ReadTextProto(Env::Default(), options.graph_def_path, graph_def);
+  }
+  return ReadBinaryProto(Env::Default(), options.graph_def_path, graph_def);
+}
+
+int64 HostMemoryInUse() {
+  port::MemoryInfo info = port::GetMemoryInfo();
+  return info.total - info.free;
+}
+
+// Runs the pipeline once and prints its statistics.
+Status RunOnce(const BenchmarkOptions& options, int run, Dataset* dataset) {
+  std::unique_ptr<Iterator> iterator;
+  TF_RETURN_IF_ERROR(dataset->MakeIterator(&iterator));
+
+  Env* env = Env::Default();
+  bool end_of_input = false;
+  std::vector<Tensor> outputs;
+  for (int64 i = 0; i < options.warmup_elements && !end_of_input; ++i) {
+    outputs.clear();
+    TF_RETURN_IF_ERROR(iterator->GetNext(&outputs, &end_of_input));
+  }
+
+  histogram::Histogram latencies_us;
+  int64 num_elements = 0;
+  int64 num_bytes = 0;
+  const int64 memory_before = HostMemoryInUse();
+  const uint64 start_us = env->NowMicros();
+  while (!end_of_input &&
+         (options.num_elements < 0 || num_elements < options.num_elements)) {
+    outputs.clear();
+    const uint64 element_start_us = env->NowMicros();
+    TF_RETURN_IF_ERROR(iterator->GetNext(&outputs, &end_of_input));
+    if (end_of_input) break;
+    latencies_us.Add(env->NowMicros() - element_start_us);
+    ++num_elements;
+    for (const Tensor& output : outputs) {
+      num_bytes += output.TotalBytes();
+    }
+  }
+  const double seconds = (env->NowMicros() - start_us) / 1e6;
+  const int64 memory_after = HostMemoryInUse();
+
+  std::cout << "Run " << run << ": " << num_elements << " elements in "
+            << seconds << " s, "
+            << (seconds > 0 ? num_elements / seconds : 0) << " elements/s, "
+            << (seconds > 0 ? num_bytes / seconds / (1 << 20) : 0)
+            << " MiB/s\n"
+            << "  GetNext latency (us): mean " << latencies_us.Average()
+            << ", p50 " << latencies_us.Median() << ", p90 "
+            << latencies_us.Percentile(90) << ", p99 "
+            << latencies_us.Percentile(99) << ", max "
+            << latencies_us.Percentile(100) << "\n"
+            << "  Host memory in use: "
+            << (memory_after - memory_before) / (1 << 20)
+            << " MiB more than before the run\n";
+  return Status::OK();
+}
+
+Status RunBenchmark(const BenchmarkOptions& options) {
+  GraphDef graph_def;
+  TF_RETURN_IF_ERROR(LoadGraph(options, &graph_def));
+
+  Dataset::Params params;
+  params.session_options.config.set_inter_op_parallelism_threads(
+      options.inter_op_threads);
+  params.session_options.config.set_intra_op_parallelism_threads(
+      options.intra_op_threads);
+  std::unique_ptr<Dataset> dataset;
+  TF_RETURN_IF_ERROR(Dataset::FromGraph(params, graph_def, &dataset));
+
+  for (int run = 0; run < options.runs; ++run) {
+    TF_RETURN_IF_ERROR(RunOnce(options, run, dataset.get()));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+}  // namespace standalone
+}  // namespace data
+}  // namespace tensorflow
+
+int main(int argc, char** argv) {
+  tensorflow::data::standalone::BenchmarkOptions options;
+  std::vector<tensorflow::Flag> flag_list = {
+      tensorflow::Flag("graph_def_path", &options.graph_def_path,
+                       "Path of the serialized dataset graph, in binary or "
+                       "(with a .pbtxt extension) text format. If empty, a "
+                       "synthetic source is benchmarked."),
+      tensorflow::Flag("synthetic_elements", &options.synthetic_elements,
+                       "Number of elements of the synthetic source."),
+      tensorflow::Flag("synthetic_latency_us", &options.synthetic_latency_us,
+                       "Latency of each element of the synthetic source, in "
+                       "microseconds."),
+      tensorflow::Flag("synthetic_prefetch", &options.synthetic_prefetch,
+                       "If not 0, prefetch this many elements of the "
+                       "synthetic source (-1 to autotune)."),
+      tensorflow::Flag("num_elements", &options.num_elements,
+                       "Maximum number of elements to read per run, or -1 to "
+                       "read the whole pipeline."),
+      tensorflow::Flag("warmup_elements", &options.warmup_elements,
+                       "Number of elements to read before measuring a run."),
+      tensorflow::Flag("runs", &options.runs, "Number of runs."),
+      tensorflow::Flag("inter_op_threads", &options.inter_op_threads,
+                       "Threads used to run the pipeline, or 0 for the "
+                       "number of cores."),
+      tensorflow::Flag("intra_op_threads", &options.intra_op_threads,
+                       "Threads used within ops, or 0 for the number of "
+                       "cores."),
+  };
+  const bool parse_result = tensorflow::Flags::Parse(&argc, argv, flag_list);
+  if (!parse_result || options.runs < 1) {
+    std::cerr << tensorflow::Flags::Usage(argv[0], flag_list);
+    return -1;
+  }
+  tensorflow::port::InitMain(argv[0], &argc, &argv);
+
+  tensorflow::Status status =
+      tensorflow::data::standalone::RunBenchmark(options);
+  if (!status.ok()) {
+    LOG(ERROR) << "Benchmark failed: " << status;
+    return 1;
+  }
+  return 0;
+}
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/graph_mgr.h"
 
 #include <chrono>  // NOLINT(build/c++11)
+#include <list>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/build_graph_options.h"
@@ -43,8 +44,10 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_partition.h"
 #include "tensorflow/core/graph/validate.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/tracing.h"
@@ -111,6 +114,105 @@ Status GraphMgr::DecorateAndPublishGraphForDebug(
   return Status::OK();
 }
 
+namespace {
+
+// Process-wide cache of the partitioned and optimized per-device graphs
+// built by GraphMgr::InitItem, so that a graph registered again by a later
+// session (e.g. a restarted evaluator) only needs its executors built. The
+// capacity, in registered graphs, is read from the environment variable
+// "TF_WORKER_PARTITION_GRAPH_CACHE_SIZE" and defaults to 0 (disabled).
+//
+// Kernels and rendezvous state are tied to a session, so only graphs are
+// shared; each hit gets its own copies.
+class PartitionGraphCache {
+ public:
+  using DeviceGraphs = std::vector<std::pair<string, std::unique_ptr<Graph>>>;
+
+  static PartitionGraphCache* Global() {
+    static PartitionGraphCache* cache = new PartitionGraphCache;
+    return cache;
+  }
+
+  bool enabled() const { return capacity_ > 0; }
+
+  // Node names generated while partitioning end up in the op segment of
+  // every session that reuses the graphs, so they are made unique across the
+  // process rather than per GraphMgr.
+  int64 NextNameId() { return next_name_id_.fetch_add(1); }
+
+  // Copies the graphs cached under `key` into `graphs`. Returns false if
+  // there is no such entry.
+  bool Lookup(const Fprint128& key, DeviceGraphs* graphs) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+    for (const auto& p : it->second.graphs) {
+      graphs->emplace_back(p.first, CopyDeviceGraph(*p.second));
+    }
+    return true;
+  }
+
+  void Insert(const Fprint128& key, DeviceGraphs graphs) {
+    mutex_lock l(mu_);
+    if (entries_.count(key) > 0) return;
+    lru_.push_front(key);
+    entries_[key] = {std::move(graphs), lru_.begin()};
+    while (entries_.size() > capacity_) {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
+  static std::unique_ptr<Graph> CopyDeviceGraph(const Graph& src) {
+    std::unique_ptr<Graph> dst(new Graph(OpRegistry::Global()));
+    TF_CHECK_OK(dst->AddFunctionLibrary(src.flib_def().ToProto()));
+    CopyGraph(src, dst.get());
+    return dst;
+  }
+
+ private:
+  PartitionGraphCache() {
+    int64 capacity;
+    Status s = ReadInt64FromEnvVar("TF_WORKER_PARTITION_GRAPH_CACHE_SIZE", 0,
+                                   &capacity);
+    if (!s.ok()) {
+      LOG(ERROR) << s.error_message();
+    }
+    capacity_ = capacity > 0 ? capacity : 0;
+  }
+
+  struct Entry {
+    DeviceGraphs graphs;
+    std::list<Fprint128>::iterator lru_it;
+  };
+
+  size_t capacity_ = 0;
+  std::atomic<int64> next_name_id_{0};
+  mutex mu_;
+  std::list<Fprint128> lru_ TF_GUARDED_BY(mu_);  // Most recently used first.
+  std::unordered_map<Fprint128, Entry, Fprint128Hasher> entries_
+      TF_GUARDED_BY(mu_);
+};
+
+// Fingerprints everything InitItem's partitioning and optimization depend on.
+Fprint128 PartitionGraphCacheKey(const GraphDef& gdef,
+                                 const GraphOptions& graph_options,
+                                 const DeviceMgr* device_mgr) {
+  string key;
+  SerializeToStringDeterministic(gdef, &key);
+  string options;
+  SerializeToStringDeterministic(graph_options, &options);
+  strings::StrAppend(&key, options);
+  for (const Device* device : device_mgr->ListDevices()) {
+    strings::StrAppend(&key, device->name(), ":",
+                       device->attributes().incarnation(), ";");
+  }
+  return Fingerprint128(key);
+}
+
+}  // namespace
+
 // Creates executors given a graph definition "gdef" of a "session".
 // If a node in "gdef" is shared by other graphs in "session", the
 // same op kernel is reused. E.g., typically a params node is shared
@@ -134,6 +236,13 @@ Status GraphMgr::InitItem(
 
   TF_RETURN_IF_ERROR(ValidateGraphDefForDevices(gdef));
 
+  // Graphs decorated for the debugger are published as they are built, so
+  // they are neither cached nor reused.
+  PartitionGraphCache* cache = PartitionGraphCache::Global();
+  const bool use_cache =
+      cache->enabled() && debug_options.debug_tensor_watch_opts().empty();
+  Fprint128 cache_key = {0, 0};
+
   // We don't explicitly Validate the graph def because ConvertGraphDefToGraph
   // does that below.
   item->proc_flr.reset(new ProcessFunctionLibraryRuntime(
@@ -154,63 +263,31 @@ Status GraphMgr::InitItem(
             return Status::OK();
           }}));
 
-  // Constructs the graph out of "gdef".
-  Graph graph(OpRegistry::Global());
-  GraphConstructorOptions opts;
-  opts.allow_internal_ops = true;
-  opts.expect_device_spec = true;
-  opts.validate_nodes = true;
-  TF_RETURN_IF_ERROR(ConvertGraphDefToGraph(opts, gdef, &graph));
-
-  // Splits "graph" into multiple subgraphs by device names.
-  std::unordered_map<string, GraphDef> partitions;
-  PartitionOptions popts;
-  popts.node_to_loc = SplitByDevice;
-  popts.new_name = [this](const string& prefix) {
-    mutex_lock l(mu_);
-    return strings::StrCat(prefix, "_G", next_id_++);
-  };
-  popts.get_incarnation = [this](const string& name) -> int64 {
-    Device* device = nullptr;
-    Status s = device_mgr_->LookupDevice(name, &device);
-    if (s.ok()) {
-      return device->attributes().incarnation();
-    } else {
-      return PartitionOptions::kIllegalIncarnation;
-    }
-  };
-  popts.flib_def = &graph.flib_def();
-  popts.control_flow_added = true;
-  popts.scheduling_for_recvs = graph_options.enable_recv_scheduling();
-  TF_RETURN_IF_ERROR(Partition(popts, &graph, &partitions));
-  if (popts.scheduling_for_recvs) {
-    TF_RETURN_IF_ERROR(AddControlEdges(popts, &partitions));
+  PartitionGraphCache::DeviceGraphs cached_graphs;
+  bool from_cache = false;
+  if (use_cache) {
+    cache_key = PartitionGraphCacheKey(gdef, graph_options, device_mgr_);
+    from_cache = cache->Lookup(cache_key, &cached_graphs);
+    VLOG(1) << "Partition graph cache " << (from_cache ? "hit" : "miss")
+            << " for graph " << handle;
   }
-
   std::unordered_map<string, std::unique_ptr<Graph>> partition_graphs;
-  for (auto& partition : partitions) {
-    std::unique_ptr<Graph> device_graph(new Graph(OpRegistry::Global()));
-    GraphConstructorOptions device_opts;
-    // There are internal operations (e.g., send/recv) that we now allow.
-    device_opts.allow_internal_ops = true;
-    device_opts.expect_device_spec = true;
-    TF_RETURN_IF_ERROR(ConvertGraphDefToGraph(
-        device_opts, std::move(partition.second), device_graph.get()));
-    partition_graphs.emplace(partition.first, std::move(device_graph));
+  if (from_cache) {
+    for (auto& p : cached_graphs) {
+      partition_graphs.emplace(p.first, std::move(p.second));
+    }
+  } else {
+    TF_RETURN_IF_ERROR(BuildPartitionGraphs(gdef, graph_options, use_cache,
+                                            item, &partition_graphs));
   }
 
-  GraphOptimizationPassOptions optimization_options;
-  optimization_options.flib_def = item->lib_def.get();
-  optimization_options.partition_graphs = &partition_graphs;
-  TF_RETURN_IF_ERROR(OptimizationPassRegistry::Global()->RunGrouping(
-      OptimizationPassRegistry::POST_PARTITIONING, optimization_options));
-
   LocalExecutorParams params;
 
-  item->units.reserve(partitions.size());
+  item->units.reserve(partition_graphs.size());
   item->graph_mgr = this;
   const auto& optimizer_opts = graph_options.optimizer_options();
   GraphOptimizer optimizer(optimizer_opts);
+  PartitionGraphCache::DeviceGraphs graphs_to_cache;
   for (auto& p : partition_graphs) {
     const string& device_name = p.first;
     std::unique_ptr<Graph>& subgraph = p.second;
@@ -227,7 +304,9 @@ Status GraphMgr::InitItem(
     }
 
     // Give the device an opportunity to rewrite its subgraph.
-    TF_RETURN_IF_ERROR(unit->device->MaybeRewriteGraph(&subgraph));
+    if (!from_cache) {
+      TF_RETURN_IF_ERROR(unit->device->MaybeRewriteGraph(&subgraph));
+    }
 
     // Top-level nodes in the graph uses the op segment to cache
     // kernels. Therefore, as long as the executor is alive, we need
@@ -270,18 +349,24 @@ Status GraphMgr::InitItem(
       }
     };
 
-    optimizer.Optimize(lib, worker_env_->env, params.device, &subgraph,
-                       /*shape_map=*/nullptr);
+    if (!from_cache) {
+      optimizer.Optimize(lib, worker_env_->env, params.device, &subgraph,
+                         /*shape_map=*/nullptr);
 
-    // TensorFlow Debugger (tfdbg) inserts debug nodes in the graph.
-    if (!debug_options.debug_tensor_watch_opts().empty()) {
-      TF_RETURN_IF_ERROR(DecorateAndPublishGraphForDebug(
-          debug_options, subgraph.get(), params.device));
-    }
+      // TensorFlow Debugger (tfdbg) inserts debug nodes in the graph.
+      if (!debug_options.debug_tensor_watch_opts().empty()) {
+        TF_RETURN_IF_ERROR(DecorateAndPublishGraphForDebug(
+            debug_options, subgraph.get(), params.device));
+      }
 
-    TF_RETURN_IF_ERROR(
-        EnsureMemoryTypes(DeviceType(unit->device->device_type()),
-                          unit->device->name(), subgraph.get()));
+      TF_RETURN_IF_ERROR(
+          EnsureMemoryTypes(DeviceType(unit->device->device_type()),
+                            unit->device->name(), subgraph.get()));
+      if (use_cache) {
+        graphs_to_cache.emplace_back(
+            device_name, PartitionGraphCache::CopyDeviceGraph(*subgraph));
+      }
+    }
     unit->graph = std::move(subgraph);
     unit->build_cost_model = graph_options.build_cost_model();
     if (unit->build_cost_model > 0) {
@@ -289,9 +374,71 @@ Status GraphMgr::InitItem(
     }
     TF_RETURN_IF_ERROR(NewLocalExecutor(params, *unit->graph, &unit->root));
   }
+  if (use_cache && !from_cache) {
+    cache->Insert(cache_key, std::move(graphs_to_cache));
+  }
   return Status::OK();
 }
 
+Status GraphMgr::BuildPartitionGraphs(
+    const GraphDef& gdef, const GraphOptions& graph_options,
+    bool process_unique_names, Item* item,
+    std::unordered_map<string, std::unique_ptr<Graph>>* partition_graphs) {
+  // Constructs the graph out of "gdef".
+  Graph graph(OpRegistry::Global());
+  GraphConstructorOptions opts;
+  opts.allow_internal_ops = true;
+  opts.expect_device_spec = true;
+  opts.validate_nodes = true;
+  TF_RETURN_IF_ERROR(ConvertGraphDefToGraph(opts, gdef, &graph));
+
+  // Splits "graph" into multiple subgraphs by device names.
+  std::unordered_map<string, GraphDef> partitions;
+  PartitionOptions popts;
+  popts.node_to_loc = SplitByDevice;
+  popts.new_name = [this, process_unique_names](const string& prefix) {
+    if (process_unique_names) {
+      return strings::StrCat(prefix, "_G",
+                             PartitionGraphCache::Global()->NextNameId());
+    }
+    mutex_lock l(mu_);
+    return strings::StrCat(prefix, "_G", next_id_++);
+  };
+  popts.get_incarnation = [this](const string& name) -> int64 {
+    Device* device = nullptr;
+    Status s = device_mgr_->LookupDevice(name, &device);
+    if (s.ok()) {
+      return device->attributes().incarnation();
+    } else {
+      return PartitionOptions::kIllegalIncarnation;
+    }
+  };
+  popts.flib_def = &graph.flib_def();
+  popts.control_flow_added = true;
+  popts.scheduling_for_recvs = graph_options.enable_recv_scheduling();
+  TF_RETURN_IF_ERROR(Partition(popts, &graph, &partitions));
+  if (popts.scheduling_for_recvs) {
+    TF_RETURN_IF_ERROR(AddControlEdges(popts, &partitions));
+  }
+
+  for (auto& partition : partitions) {
+    std::unique_ptr<Graph> device_graph(new Graph(OpRegistry::Global()));
+    GraphConstructorOptions device_opts;
+    // There are internal operations (e.g., send/recv) that we now allow.
+    device_opts.allow_internal_ops = true;
+    device_opts.expect_device_spec = true;
+    TF_RETURN_IF_ERROR(ConvertGraphDefToGraph(
+        device_opts, std::move(partition.second), device_graph.get()));
+    partition_graphs->emplace(partition.first, std::move(device_graph));
+  }
+
+  GraphOptimizationPassOptions optimization_options;
+  optimization_options.flib_def = item->lib_def.get();
+  optimization_options.partition_graphs = partition_graphs;
+  return OptimizationPassRegistry::Global()->RunGrouping(
+      OptimizationPassRegistry::POST_PARTITIONING, optimization_options);
+}
+
 Status GraphMgr::Register(
     const string& handle, const GraphDef& gdef, WorkerSession* session,
     const GraphOptions& graph_options, const DebugOptions& debug_options,
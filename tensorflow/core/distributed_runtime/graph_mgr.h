@@ -184,6 +184,15 @@ class GraphMgr {
                   const ConfigProto& config_proto, int64 collective_graph_key,
                   DistributedFunctionLibraryRuntime* cluster_flr, Item* item);
 
+  // Partitions "gdef" by device and runs the post-partitioning passes,
+  // filling "partition_graphs" with one graph per device. If
+  // "process_unique_names" is true, generated node names are unique across
+  // all GraphMgrs in the process.
+  Status BuildPartitionGraphs(
+      const GraphDef& gdef, const GraphOptions& graph_options,
+      bool process_unique_names, Item* item,
+      std::unordered_map<string, std::unique_ptr<Graph>>* partition_graphs);
+
   Status DecorateAndPublishGraphForDebug(const DebugOptions& debug_options,
                                          Graph* graph, Device* device);
 
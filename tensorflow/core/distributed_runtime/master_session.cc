@@ -212,7 +212,8 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
                        RunCallableResponse* resp, CancellationManager* cm);
 
   // Calls workers to cleanup states for the step "step_id".  Calls
-  // `done` when all cleanup RPCs have completed.
+  // `done` when all cleanup RPCs have completed.  If remote partitions of
+  // the step are still running, the cleanup starts when they finish.
   void CleanupPartitionsAsync(int64 step_id, StatusCallback done);
 
   // Post-processing of any runtime statistics gathered during execution.
@@ -287,6 +288,16 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
 
   std::unique_ptr<StatsPublisherInterface> stats_publisher_;
 
+  // With ConfigProto.Experimental.max_remote_step_staleness > 0, steps whose
+  // remote fetch-free partitions (e.g. parameter server updates) were still
+  // running when the step returned, mapped to the cleanup deferred until they
+  // finish (empty until CleanupPartitionsAsync is called for the step).
+  mutex detached_mu_;
+  condition_variable detached_cv_;
+  std::unordered_map<int64, std::function<void()>> detached_steps_
+      TF_GUARDED_BY(detached_mu_);
+  Status detached_status_ TF_GUARDED_BY(detached_mu_);
+
   string DetailText(const NodeDetails& details, const NodeExecStats& stats) {
     int64 tot = 0;
     for (auto& no : stats.output()) {
@@ -325,6 +336,15 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
       const ClientRequestType& req, ClientResponseType* resp,
       CancellationManager* cm, bool is_last_partial_run);
 
+  // Blocks until at most `max_staleness` steps have remote partitions that
+  // are still running, then returns (and clears) the first error reported by
+  // any such partition since the last call.
+  Status WaitForDetachedSteps(int max_staleness);
+
+  // Called when the remote partitions of step `step_id` that were left
+  // running by RunPartitionsHelper have all finished.
+  void DetachedPartitionsDone(int64 step_id, const Status& s);
+
   // Deregisters the partitions on the workers.  Called in the
   // destructor and does not wait for the rpc completion.
   void DeregisterPartitions();
@@ -499,9 +519,18 @@ Status MasterSession::ReffedClientGraph::DoRegisterPartitions(
 
 namespace {
 // Helper class to manage "num" parallel RunGraph calls.
+//
+// `num_detached` of the calls may be marked `detached`.  Wait() does not wait
+// for those; `detached_done` is called with their status once they have all
+// finished.
 class RunManyGraphs {
  public:
-  explicit RunManyGraphs(int num) : calls_(num), pending_(num) {}
+  explicit RunManyGraphs(int num, int num_detached = 0,
+                         StatusCallback detached_done = nullptr)
+      : calls_(num),
+        pending_(num - num_detached),
+        detached_pending_(num_detached),
+        detached_done_(std::move(detached_done)) {}
 
   ~RunManyGraphs() {}
 
@@ -509,6 +538,7 @@ class RunManyGraphs {
   struct Call {
     CallOptions opts;
     const string* worker_name;
+    bool detached = false;
     std::atomic<bool> done{false};
     std::unique_ptr<MutableRunGraphRequestWrapper> req;
     std::unique_ptr<MutableRunGraphResponseWrapper> resp;
@@ -526,14 +556,26 @@ class RunManyGraphs {
       mutex_lock l(mu_);
       ReportBadStatus(Status(resp->status_code(),
                              strings::StrCat("From ", *call->worker_name, ":\n",
-                                             resp->status_error_message())));
+                                             resp->status_error_message())),
+                      call->detached);
     } else if (!s.ok()) {
       mutex_lock l(mu_);
       ReportBadStatus(
           Status(s.code(), strings::StrCat("From ", *call->worker_name, ":\n",
-                                           s.error_message())));
+                                           s.error_message())),
+          call->detached);
+    }
+    if (!call->detached) {
+      pending_.DecrementCount();
+      return;
+    }
+    Status detached_status;
+    {
+      mutex_lock l(mu_);
+      if (--detached_pending_ > 0) return;
+      detached_status = detached_status_group_.as_concatenated_status();
     }
-    pending_.DecrementCount();
+    detached_done_(detached_status);
   }
 
   void StartCancel() {
@@ -585,9 +627,15 @@ class RunManyGraphs {
   BlockingCounter pending_;
   mutable mutex mu_;
   StatusGroup status_group_ TF_GUARDED_BY(mu_);
+  int detached_pending_ TF_GUARDED_BY(mu_);
+  StatusGroup detached_status_group_ TF_GUARDED_BY(mu_);
+  const StatusCallback detached_done_;
   bool cancel_issued_ TF_GUARDED_BY(mu_) = false;
 
-  void ReportBadStatus(const Status& s) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  // Errors of detached calls are reported to `detached_done_` rather than
+  // status(), since the step may already have returned.
+  void ReportBadStatus(const Status& s, bool detached = false)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     VLOG(1) << "Master received error status " << s;
     if (!cancel_issued_ && !StatusGroup::IsDerived(s)) {
       // Only start cancelling other workers upon receiving a non-derived
@@ -600,7 +648,11 @@ class RunManyGraphs {
       }
     }
 
-    status_group_.Update(s);
+    if (detached) {
+      detached_status_group_.Update(s);
+    } else {
+      status_group_.Update(s);
+    }
   }
 
   TF_DISALLOW_COPY_AND_ASSIGN(RunManyGraphs);
@@ -667,12 +719,44 @@ Status MasterSession::ReffedClientGraph::RunPartitionsHelper(
   }
 
   const int num = partitions_.size();
-  RunManyGraphs calls(num);
+  // Partitions in other tasks that produce no fetches, such as the variable
+  // updates on parameter servers, may keep running after the step returns if
+  // bounded staleness is enabled. Requests for statistics need every
+  // partition's response, so they make the step synchronous again.
+  const int max_staleness =
+      session_opts_.config.experimental().max_remote_step_staleness();
+  std::vector<bool> detach(num, false);
+  int num_detached = 0;
+  if (max_staleness > 0) {
+    TF_RETURN_IF_ERROR(WaitForDetachedSteps(max_staleness));
+    if (!is_partial_ && !pss->collect_costs && !pss->collect_timeline &&
+        !pss->collect_partition_graphs && !env->local_devices.empty()) {
+      const string& local_device = env->local_devices[0]->name();
+      for (int i = 0; i < num; ++i) {
+        const Part& part = partitions_[i];
+        if (part.key_fetch.empty() &&
+            !DeviceNameUtils::IsSameAddressSpace(part.name, local_device)) {
+          detach[i] = true;
+          ++num_detached;
+        }
+      }
+    }
+    if (num_detached == num) {
+      // Nothing would be left to wait for; run the step synchronously.
+      detach.assign(num, false);
+      num_detached = 0;
+    }
+  }
+  auto calls = std::make_shared<RunManyGraphs>(
+      num, num_detached, [this, step_id](const Status& s) {
+        DetachedPartitionsDone(step_id, s);
+      });
 
   for (int i = 0; i < num; ++i) {
     const Part& part = partitions_[i];
-    RunManyGraphs::Call* c = calls.get(i);
+    RunManyGraphs::Call* c = calls->get(i);
     c->worker_name = &part.name;
+    c->detached = detach[i];
     c->req.reset(part.worker->CreateRunGraphRequest());
     c->resp.reset(part.worker->CreateRunGraphResponse());
     if (is_partial_) {
@@ -732,42 +816,51 @@ Status MasterSession::ReffedClientGraph::RunPartitionsHelper(
     }
   }
 
-  // Issues RunGraph calls.
+  if (num_detached > 0) {
+    // Keeps this graph alive until DetachedPartitionsDone.
+    Ref();
+    mutex_lock l(detached_mu_);
+    detached_steps_.emplace(step_id, nullptr);
+  }
+
+  // Issues RunGraph calls.  Each call keeps `calls` alive until it is done,
+  // which may be after this step returns for detached ones.
   for (int i = 0; i < num; ++i) {
     const Part& part = partitions_[i];
-    RunManyGraphs::Call* call = calls.get(i);
+    RunManyGraphs::Call* call = calls->get(i);
     TRACEPRINTF("Partition %d %s", i, part.name.c_str());
     part.worker->RunGraphAsync(
         &call->opts, call->req.get(), call->resp.get(),
-        std::bind(&RunManyGraphs::WhenDone, &calls, i, std::placeholders::_1));
+        [calls, i](const Status& s) { calls->WhenDone(i, s); });
   }
 
   // Waits for the RunGraph calls.
   call_opts->SetCancelCallback([&calls]() {
     LOG(INFO) << "Client requested cancellation for RunStep, cancelling "
                  "worker operations.";
-    calls.StartCancel();
+    calls->StartCancel();
   });
   auto token = cm->get_cancellation_token();
   const bool success =
-      cm->RegisterCallback(token, [&calls]() { calls.StartCancel(); });
+      cm->RegisterCallback(token, [&calls]() { calls->StartCancel(); });
   if (!success) {
-    calls.StartCancel();
+    calls->StartCancel();
   }
-  calls.Wait();
+  calls->Wait();
   call_opts->ClearCancelCallback();
   if (success) {
     cm->DeregisterCallback(token);
   } else {
     return errors::Cancelled("Step was cancelled");
   }
-  TF_RETURN_IF_ERROR(calls.status());
+  TF_RETURN_IF_ERROR(calls->status());
 
   // Collects fetches and metadata.
   Status status;
   for (int i = 0; i < num; ++i) {
     const Part& part = partitions_[i];
-    MutableRunGraphResponseWrapper* run_graph_resp = calls.get(i)->resp.get();
+    if (detach[i]) continue;
+    MutableRunGraphResponseWrapper* run_graph_resp = calls->get(i)->resp.get();
     for (size_t j = 0; j < run_graph_resp->num_recvs(); ++j) {
       auto iter = part.key_fetch.find(run_graph_resp->recv_key(j));
       if (iter == part.key_fetch.end()) {
@@ -923,8 +1016,51 @@ class CleanupBroadcastHelper {
 
 }  // namespace
 
+Status MasterSession::ReffedClientGraph::WaitForDetachedSteps(
+    int max_staleness) {
+  mutex_lock l(detached_mu_);
+  while (detached_steps_.size() > static_cast<size_t>(max_staleness)) {
+    detached_cv_.wait(l);
+  }
+  Status s = detached_status_;
+  detached_status_ = Status::OK();
+  return s;
+}
+
+void MasterSession::ReffedClientGraph::DetachedPartitionsDone(
+    int64 step_id, const Status& s) {
+  std::function<void()> cleanup;
+  {
+    mutex_lock l(detached_mu_);
+    auto it = detached_steps_.find(step_id);
+    DCHECK(it != detached_steps_.end());
+    cleanup = std::move(it->second);
+    detached_steps_.erase(it);
+    if (!s.ok()) {
+      LOG(WARNING) << "Remote partitions of step " << step_id
+                   << " failed after the step returned: " << s;
+    }
+    detached_status_.Update(s);
+  }
+  detached_cv_.notify_all();
+  if (cleanup) cleanup();
+  Unref();
+}
+
 void MasterSession::ReffedClientGraph::CleanupPartitionsAsync(
     int64 step_id, StatusCallback done) {
+  {
+    mutex_lock l(detached_mu_);
+    auto it = detached_steps_.find(step_id);
+    if (it != detached_steps_.end()) {
+      // Cleaning up the step would abort the rendezvous that its running
+      // partitions still use.
+      it->second = [this, step_id, done = std::move(done)]() mutable {
+        CleanupPartitionsAsync(step_id, std::move(done));
+      };
+      return;
+    }
+  }
   const int num = partitions_.size();
   // Helper object will be deleted when the final call completes.
   CleanupBroadcastHelper* helper =
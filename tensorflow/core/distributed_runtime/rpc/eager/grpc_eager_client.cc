@@ -63,6 +63,32 @@ bool EnableStreaming() {
   return result;
 }
 
+// With streaming enqueue on, setting "TF_EAGER_CLIENT_ENQUEUE_BATCH_ITEMS" to
+// N > 1 coalesces consecutive StreamingEnqueue requests for the same remote
+// context into a single request of up to N queue items. A partial batch is
+// sent "TF_EAGER_CLIENT_ENQUEUE_BATCH_WINDOW_US" microseconds after its first
+// request was added. This trades a bounded extra latency per op for far fewer
+// messages when many small ops are dispatched asynchronously.
+int64 EnqueueBatchItems() {
+  static const int64 batch_items = [] {
+    int64 result;
+    TF_CHECK_OK(
+        ReadInt64FromEnvVar("TF_EAGER_CLIENT_ENQUEUE_BATCH_ITEMS", 0, &result));
+    return result;
+  }();
+  return batch_items;
+}
+
+int64 EnqueueBatchWindowMicros() {
+  static const int64 window_us = [] {
+    int64 result;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_EAGER_CLIENT_ENQUEUE_BATCH_WINDOW_US",
+                                    50, &result));
+    return result;
+  }();
+  return window_us;
+}
+
 // Ref-counted thread to handle callbacks for completed requests a GRPC
 // completion queue. The thread might be shared by multiple eager clients, and
 // each one of them should hold a reference count to ensure that the thread
@@ -169,6 +195,14 @@ class GrpcEagerClient : public EagerClient {
             << request->DebugString();
 
     mutex_lock l(mu_);
+    const auto& batch_it = enqueue_batches_.find(request->context_id());
+    if (batch_it != enqueue_batches_.end()) {
+      for (auto& part : batch_it->second.parts) {
+        part.done(errors::Cancelled("Remote eager context ",
+                                    request->context_id(), " was closed."));
+      }
+      enqueue_batches_.erase(batch_it);
+    }
     const auto& it = enqueue_dispatchers_.find(request->context_id());
     if (it != enqueue_dispatchers_.end()) {
       it->second.CancelCall();
@@ -184,20 +218,14 @@ class GrpcEagerClient : public EagerClient {
                              EnqueueResponse* response,
                              StatusCallback done) override {
     StatusCallback done_wrapped = callback_wrapper(std::move(done));
-    if (EnableStreaming()) {
+    if (EnableStreaming() && EnqueueBatchItems() > 1) {
+      mutex_lock l(mu_);
+      AddToEnqueueBatch(*request, response, std::move(done_wrapped));
+    } else if (EnableStreaming()) {
       mutex_lock l(mu_);
-      auto it = enqueue_dispatchers_.find(request->context_id());
-      if (it == enqueue_dispatchers_.end()) {
-        auto it_and_bool = enqueue_dispatchers_.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(request->context_id()),
-            std::forward_as_tuple(
-                &stub_, cq_,
-                "/tensorflow.eager.EagerService/StreamingEnqueue"));
-        it = it_and_bool.first;
-      }
       // TODO(haoyuzhang): Consider supporting cancellation for streaming RPC?
-      it->second.SendNextRequest(*request, response, std::move(done_wrapped));
+      GetEnqueueDispatcher(request->context_id())
+          ->SendNextRequest(*request, response, std::move(done_wrapped));
     } else {
       Notification n;
       Status status;
@@ -223,6 +251,92 @@ class GrpcEagerClient : public EagerClient {
   std::unordered_map<uint64, StreamingRPCDispatcher<EnqueueResponse>>
       enqueue_dispatchers_ TF_GUARDED_BY(mu_);
 
+  // Requests for one context that have not been sent yet, merged into
+  // `request`. Each part owns the next `num_items` queue items.
+  struct EnqueueBatch {
+    struct Part {
+      int num_items;
+      EnqueueResponse* response;
+      StatusCallback done;
+    };
+    EnqueueRequest request;
+    std::vector<Part> parts;
+  };
+  std::unordered_map<uint64, EnqueueBatch> enqueue_batches_ TF_GUARDED_BY(mu_);
+
+  StreamingRPCDispatcher<EnqueueResponse>* GetEnqueueDispatcher(
+      uint64 context_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto it = enqueue_dispatchers_.find(context_id);
+    if (it == enqueue_dispatchers_.end()) {
+      auto it_and_bool = enqueue_dispatchers_.emplace(
+          std::piecewise_construct, std::forward_as_tuple(context_id),
+          std::forward_as_tuple(
+              &stub_, cq_, "/tensorflow.eager.EagerService/StreamingEnqueue"));
+      it = it_and_bool.first;
+    }
+    return &it->second;
+  }
+
+  void AddToEnqueueBatch(const EnqueueRequest& request,
+                         EnqueueResponse* response, StatusCallback done)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const uint64 context_id = request.context_id();
+    auto it = enqueue_batches_.find(context_id);
+    if (it == enqueue_batches_.end()) {
+      it = enqueue_batches_.emplace(context_id, EnqueueBatch()).first;
+      it->second.request.set_context_id(context_id);
+      // The first request of a batch bounds how long it may wait.
+      Ref();
+      Env::Default()->SchedClosureAfter(EnqueueBatchWindowMicros(),
+                                        [this, context_id]() {
+                                          {
+                                            mutex_lock l(mu_);
+                                            FlushEnqueueBatch(context_id);
+                                          }
+                                          this->Unref();
+                                        });
+    }
+    EnqueueBatch& batch = it->second;
+    batch.request.mutable_queue()->MergeFrom(request.queue());
+    batch.parts.push_back({request.queue_size(), response, std::move(done)});
+    if (batch.request.queue_size() >= EnqueueBatchItems()) {
+      FlushEnqueueBatch(context_id);
+    }
+  }
+
+  // Sends the pending batch of `context_id`, if any, as one request and
+  // splits the response back into the responses of its parts. The service
+  // answers every queue item in order, so on success part i gets the next
+  // `num_items` queue responses; an error fails every part, as it would
+  // have failed all later requests on the stream anyway.
+  void FlushEnqueueBatch(uint64 context_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto it = enqueue_batches_.find(context_id);
+    if (it == enqueue_batches_.end()) return;
+    auto batch = std::make_shared<EnqueueBatch>(std::move(it->second));
+    enqueue_batches_.erase(it);
+    VLOG(3) << "Sending " << batch->parts.size()
+            << " coalesced enqueue requests with "
+            << batch->request.queue_size() << " items";
+    auto response = std::make_shared<EnqueueResponse>();
+    GetEnqueueDispatcher(context_id)
+        ->SendNextRequest(
+            batch->request, response.get(),
+            [batch, response](const Status& status) {
+              int offset = 0;
+              for (auto& part : batch->parts) {
+                if (status.ok()) {
+                  for (int i = 0; i < part.num_items &&
+                                  offset < response->queue_response_size();
+                       ++i, ++offset) {
+                    part.response->add_queue_response()->Swap(
+                        response->mutable_queue_response(offset));
+                  }
+                }
+                part.done(status);
+              }
+            });
+  }
+
   StatusCallback callback_wrapper(StatusCallback done) {
     Ref();
     return [this, done = std::move(done)](const Status& status) {
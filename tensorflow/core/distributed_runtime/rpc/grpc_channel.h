@@ -82,16 +82,22 @@ class GrpcChannelCache {
 
 typedef std::function<SharedGrpcChannelPtr(string)> ChannelCreationFunction;
 
-GrpcChannelCache* NewGrpcChannelCache(const GrpcChannelSpec& channel_spec,
-                                      ChannelCreationFunction channel_func);
+// Channels are created by `channel_func`, num_channels_per_target of them per
+// target if rpc_options requests more than one.
+GrpcChannelCache* NewGrpcChannelCache(
+    const GrpcChannelSpec& channel_spec, ChannelCreationFunction channel_func,
+    const RPCOptions& rpc_options = RPCOptions());
 
 // Below here are internal-only functions.
 
 ::grpc::ChannelArguments GetChannelArguments(const RPCOptions* rpc_options);
 
+// If `rpc_options` is not null, a copy of it is passed to every call of
+// `new_channel_func_ptr`.
 ChannelCreationFunction ConvertToChannelCreationFunction(
     const std::function<Status(string, const RPCOptions*,
-                               SharedGrpcChannelPtr*)>& new_channel_func_ptr);
+                               SharedGrpcChannelPtr*)>& new_channel_func_ptr,
+    const RPCOptions* rpc_options = nullptr);
 
 Status NewHostPortGrpcChannel(const string& target,
                               const RPCOptions* rpc_options,
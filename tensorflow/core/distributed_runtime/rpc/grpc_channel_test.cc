@@ -118,6 +118,39 @@ TEST(GrpcChannelTest, HostPorts) {
   }
 }
 
+TEST(GrpcChannelTest, MultipleChannelsPerTarget) {
+  RPCOptions rpc_options;
+  rpc_options.set_num_channels_per_target(3);
+  for (bool multi_job : {false, true}) {
+    GrpcChannelSpec spec;
+    TF_EXPECT_OK(spec.AddHostPortsJob("mnist", {"a:1", "b:2", "d:4"}));
+    if (multi_job) {
+      TF_EXPECT_OK(spec.AddHostPortsJob("ps", std::vector<string>({"c:3"})));
+    }
+    ChannelCreationFunction channel_func =
+        ConvertToChannelCreationFunction(NewHostPortGrpcChannel, &rpc_options);
+    std::unique_ptr<GrpcChannelCache> cc(
+        NewGrpcChannelCache(spec, channel_func, rpc_options));
+
+    // Channels to one target are handed out in turn.
+    std::vector<::grpc::Channel*> a_1;
+    for (int i = 0; i < 6; ++i) {
+      a_1.push_back(cc->FindWorkerChannel("/job:mnist/replica:0/task:0").get());
+    }
+    EXPECT_NE(a_1[0], a_1[1]);
+    EXPECT_NE(a_1[0], a_1[2]);
+    EXPECT_NE(a_1[1], a_1[2]);
+    EXPECT_EQ(a_1[0], a_1[3]);
+    EXPECT_EQ(a_1[1], a_1[4]);
+    EXPECT_EQ(a_1[2], a_1[5]);
+
+    auto b_2 = cc->FindWorkerChannel("/job:mnist/replica:0/task:1");
+    for (::grpc::Channel* ch : a_1) {
+      EXPECT_NE(b_2.get(), ch);
+    }
+  }
+}
+
 TEST(GrpcChannelTest, SparseHostPorts) {
   GrpcChannelSpec spec;
   TF_EXPECT_OK(
@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstring>
 #include <limits>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include "grpcpp/grpcpp.h"
@@ -371,7 +372,11 @@ Status GrpcServer::WorkerCacheFactory(const WorkerCacheFactoryOptions& options,
   TF_RETURN_IF_ERROR(ParseChannelSpec(options, &channel_spec));
 
   std::shared_ptr<GrpcChannelCache> channel_cache(
-      NewGrpcChannelCache(channel_spec, GetChannelCreationFunction()));
+      NewGrpcChannelCache(channel_spec,
+                          ReuseChannels(GetChannelCreationFunction()),
+                          options.rpc_options != nullptr
+                              ? *options.rpc_options
+                              : RPCOptions()));
 
   string name_prefix = strings::StrCat("/job:", *options.job_name, "/replica:0",
                                        "/task:", options.task_index);
@@ -394,6 +399,22 @@ Status GrpcServer::WorkerCacheFactory(const WorkerCacheFactoryOptions& options,
   return Status::OK();
 }
 
+ChannelCreationFunction GrpcServer::ReuseChannels(
+    ChannelCreationFunction channel_func) {
+  // Request counts per target, local to the worker cache being built.
+  auto requests = std::make_shared<std::unordered_map<string, int>>();
+  return [this, channel_func = std::move(channel_func),
+          requests](string target) -> SharedGrpcChannelPtr {
+    mutex_lock l(channels_mu_);
+    const string key = strings::StrCat(target, "#", (*requests)[target]++);
+    SharedGrpcChannelPtr& channel = channels_[key];
+    if (channel == nullptr) {
+      channel = channel_func(std::move(target));
+    }
+    return channel;
+  };
+}
+
 Status GrpcServer::Start() {
   mutex_lock l(mu_);
   switch (state_) {
@@ -442,6 +463,27 @@ Status GrpcServer::UpdateServerDef(const ServerDef& server_def) {
   // Transfer ownership of worker_cache to worker_env_.session_mgr.
   worker_env_.session_mgr->ResetDefaultWorkerCache(worker_cache);
 
+  // Stop reusing channels to targets that left the cluster. Worker caches
+  // that still hold them keep them alive.
+  {
+    GrpcChannelSpec channel_spec;
+    TF_RETURN_IF_ERROR(ParseChannelSpec(worker_cache_factory_options,
+                                        &channel_spec));
+    std::unordered_set<string> targets;
+    for (const auto& job : channel_spec.host_ports_jobs()) {
+      for (const auto& task : job.host_ports) targets.insert(task.second);
+    }
+    mutex_lock l(channels_mu_);
+    for (auto it = channels_.begin(); it != channels_.end();) {
+      const string target = it->first.substr(0, it->first.rfind('#'));
+      if (targets.count(target) == 0) {
+        it = channels_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   string default_worker_name;
   string unused;
   if (!DeviceNameUtils::SplitDeviceName(master_env_.local_devices[0]->name(),
@@ -512,7 +554,13 @@ std::shared_ptr<::grpc::ServerCredentials> GrpcServer::GetServerCredentials(
 ChannelCreationFunction GrpcServer::GetChannelCreationFunction() const {
   // We can do this because SparseGrpcChannelCache is robust to nullptr being
   // returned by the channel creation function
-  return ConvertToChannelCreationFunction(NewHostPortGrpcChannel);
+  const RPCOptions& rpc_options =
+      server_def_.default_session_config().rpc_options();
+  // Striping RPCs over several channels per target needs channel arguments
+  // that give each channel its own connection.
+  return ConvertToChannelCreationFunction(
+      NewHostPortGrpcChannel,
+      rpc_options.num_channels_per_target() > 1 ? &rpc_options : nullptr);
 }
 
 std::unique_ptr<Master> GrpcServer::CreateMaster(MasterEnv* master_env) {
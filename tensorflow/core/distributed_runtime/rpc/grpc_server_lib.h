@@ -19,6 +19,7 @@ limitations under the License.
 // GrpcServer manages the lifecycle of an Eager, Worker and Master service.
 
 #include <memory>
+#include <unordered_map>
 
 #include "grpcpp/grpcpp.h"
 #include "grpcpp/security/credentials.h"
@@ -62,6 +63,17 @@ typedef std::function<std::unique_ptr<GrpcWorker>(WorkerEnv*,
                                                   const ConfigProto& config)>
     WorkerCreationFunction;
 
+// Options through which a subclass of GrpcServer can replace parts of the
+// worker. An alternative tensor transport (e.g. over RDMA verbs) keeps gRPC
+// for control messages and plugs in by registering a ServerFactory for its
+// own protocol (e.g. "grpc+verbs") whose server sets:
+//  * `rendezvous_mgr_func` to a RendezvousMgrInterface that moves tensors
+//    over the transport;
+//  * `service_func` to a gRPC service through which peers exchange the
+//    transport's connection and memory region information.
+// Host and GPU memory can be registered with the transport as it is
+// allocated through ProcessState::AddCPUAllocVisitor and
+// GPUProcessState::AddGPUAllocVisitor.
 struct GrpcServerOptions {
   ServiceInitFunction service_func = nullptr;
   RendezvousMgrCreationFunction rendezvous_mgr_func = nullptr;
@@ -128,6 +140,11 @@ class GrpcServer : public ServerInterface {
   virtual Status WorkerCacheFactory(const WorkerCacheFactoryOptions& options,
                                     WorkerCacheInterface** worker_cache);
 
+  // Wraps `channel_func` so that channels it created for an earlier worker
+  // cache are reused for the same targets. This lets UpdateServerDef keep the
+  // connections to tasks whose address did not change.
+  ChannelCreationFunction ReuseChannels(ChannelCreationFunction channel_func);
+
   // Parses a WorkerCacheFactoryOptions into a GrpcChannelSpec.
   Status ParseChannelSpec(const WorkerCacheFactoryOptions& options,
                           GrpcChannelSpec* channel_spec);
@@ -152,6 +169,13 @@ class GrpcServer : public ServerInterface {
   // Guards server configuration, server, and state.
   mutex mu_;
 
+  // Channels handed out by ReuseChannels, keyed by target and by the index
+  // of the request for that target within one worker cache (a target gets
+  // several channels when RPCOptions.num_channels_per_target > 1).
+  mutex channels_mu_;
+  std::unordered_map<string, SharedGrpcChannelPtr> channels_
+      TF_GUARDED_BY(channels_mu_);
+
   // Represents the current state of the server, which changes as follows:
   //
   //                 Join()            Join()
@@ -254,5 +254,95 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
   }
 }
 
+void EncodeTensorChunkToByteBuffer(const Tensor& val, int64 chunk_offset,
+                                   int64 max_chunk_bytes,
+                                   ::grpc::ByteBuffer* result) {
+  const int kLargeTensorBytes = 1024;
+  CHECK(DataTypeCanUseMemcpy(val.dtype()));
+  StringPiece tdata = val.tensor_data();
+  CHECK_GE(chunk_offset, 0);
+  CHECK_LT(chunk_offset, tdata.size());
+  CHECK_GT(max_chunk_bytes, 0);
+  StringPiece chunk = tdata.substr(chunk_offset, max_chunk_bytes);
+
+  RecvTensorResponse response;
+  response.set_require_ack(chunk_offset + chunk.size() == tdata.size());
+  response.set_send_start_micros(Env::Default()->NowMicros());
+  response.set_total_content_bytes(tdata.size());
+  response.set_chunk_offset(chunk_offset);
+
+  // The encoding mirrors EncodeTensorToByteBuffer, except that the
+  // tensor() field only holds the skeleton and the data is encoded as
+  // R.chunk_data() after it:
+  //
+  // A:   <protocol buffer encoding of fields except R.tensor() and
+  //          R.chunk_data()>
+  // B:   <tag, varint32 length and skeleton encoding of R.tensor()>
+  // C1:  <tag encoding for RecvTensorResponse::chunk_data>
+  // C2:  <varint32 length of the chunk>
+  // D:   <actual data for the chunk>
+  gtl::InlinedVector<char, 128> skeleton(SkeletonEncodingSizeUpperBound(val));
+  io::ProtoEncodeHelper e_skeleton(skeleton.data(), skeleton.size());
+  EncodeSkeleton(val, &e_skeleton);
+
+  string header;
+  response.AppendToString(&header);
+
+  size_t expected_size =
+      (header.size() +
+       VarLengthEncodingSize(RecvTensorResponse::kTensorFieldNumber,
+                             e_skeleton.size()) +
+       VarLengthEncodingSize(RecvTensorResponse::kChunkDataFieldNumber,
+                             chunk.size()));
+  bool share_tensor_slice_memory = (chunk.size() > kLargeTensorBytes);
+  size_t encoder_size = expected_size - chunk.size();
+
+  gtl::InlinedVector<char, 1024> space(encoder_size);
+  io::ProtoEncodeHelper e(space.data(), space.size());
+  // (A)
+  e.WriteRawBytes(header);
+  // (B)
+  e.WriteVarlengthBeginning(RecvTensorResponse::kTensorFieldNumber,
+                            e_skeleton.size());
+  e.WriteRawBytes(StringPiece(e_skeleton.data(), e_skeleton.size()));
+  // (C1) & (C2)
+  e.WriteVarlengthBeginning(RecvTensorResponse::kChunkDataFieldNumber,
+                            chunk.size());
+
+  ::grpc::Slice slices[2];
+  int num_slices = 0;
+  {
+    size_t slice_len =
+        e.size() + (share_tensor_slice_memory ? 0 : chunk.size());
+    slices[0] = ::grpc::Slice(slice_len);
+    memcpy(const_cast<uint8_t*>(slices[0].begin()), e.data(), e.size());
+    if (!share_tensor_slice_memory) {
+      // (D)
+      memcpy(const_cast<uint8_t*>(slices[0].begin()) + e.size(), chunk.data(),
+             chunk.size());
+    }
+    num_slices += 1;
+  }
+
+  if (share_tensor_slice_memory) {
+    // (D) Encode the chunk, but by sharing backing store
+    const TensorBuffer* buf = DMAHelper::buffer(&val);
+    buf->Ref();
+    slices[1] = ::grpc::Slice(
+        const_cast<void*>(static_cast<const void*>(chunk.data())), chunk.size(),
+        [](void* backing) { static_cast<TensorBuffer*>(backing)->Unref(); },
+        const_cast<TensorBuffer*>(buf));
+    num_slices += 1;
+  }
+  size_t total_bytes = 0;
+  for (int i = 0; i < num_slices; i++) {
+    total_bytes += slices[i].size();
+  }
+  CHECK_EQ(total_bytes, expected_size);
+
+  ::grpc::ByteBuffer tmp(&slices[0], num_slices);
+  result->Swap(&tmp);
+}
+
 }  // namespace grpc
 }  // namespace tensorflow
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_TENSOR_CODING_H_
 
 #include "grpcpp/impl/codegen/byte_buffer.h"
+#include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
 class Tensor;
@@ -49,6 +50,21 @@ void EncodeRecvTensorResponseToByteBuffer(const RecvTensorResponse& proto,
 void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
                               ::grpc::ByteBuffer* result);
 
+// Encode the chunk of the content of "val" starting at "chunk_offset" and at
+// most "max_chunk_bytes" long into a byte buffer in a format that is parseable
+// as a RecvTensorResponse protocol buffer. The tensor() field only holds the
+// dtype and shape of "val", and the chunk is shared with the backing store of
+// "val" where possible. The response requires an ack iff it holds the last
+// chunk of the content.
+//
+// REQUIRES: DataTypeCanUseMemcpy(val.dtype()).
+// REQUIRES: 0 <= chunk_offset < val.TotalBytes() and max_chunk_bytes > 0.
+//
+// Discards original contents of *result.
+void EncodeTensorChunkToByteBuffer(const Tensor& val, int64 chunk_offset,
+                                   int64 max_chunk_bytes,
+                                   ::grpc::ByteBuffer* result);
+
 }  // namespace grpc
 }  // namespace tensorflow
 
@@ -100,4 +100,38 @@ TEST_F(GrpcTensorCodingTest, Simple) {
 
 TEST_F(GrpcTensorCodingTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(GrpcTensorCodingTest, Chunks) {
+  for (int elems : {1, 100, 1000, 10000}) {
+    Tensor t(DT_FLOAT, TensorShape({2, elems}));
+    test::FillFn<float>(&t, [](int i) -> float { return i; });
+    StringPiece tdata = t.tensor_data();
+    const int64 total_bytes = tdata.size();
+    for (int64 max_chunk_bytes : {1, 7, 4096, 1 << 20}) {
+      string content;
+      for (int64 offset = 0; offset < total_bytes; offset += max_chunk_bytes) {
+        ::grpc::ByteBuffer buf;
+        grpc::EncodeTensorChunkToByteBuffer(t, offset, max_chunk_bytes, &buf);
+        std::vector<::grpc::Slice> slices;
+        (void)buf.Dump(&slices);
+        string tmp;
+        for (const auto& s : slices) {
+          tmp.append(reinterpret_cast<const char*>(s.begin()), s.size());
+        }
+
+        RecvTensorResponse response;
+        ASSERT_TRUE(response.ParseFromString(tmp));
+        EXPECT_EQ(total_bytes, response.total_content_bytes());
+        EXPECT_EQ(offset, response.chunk_offset());
+        EXPECT_EQ(offset + max_chunk_bytes >= total_bytes,
+                  response.require_ack());
+        EXPECT_EQ(DT_FLOAT, response.tensor().dtype());
+        EXPECT_EQ(t.shape(), TensorShape(response.tensor().tensor_shape()));
+        EXPECT_TRUE(response.tensor().tensor_content().empty());
+        content.append(response.chunk_data());
+      }
+      EXPECT_EQ(tdata, content);
+    }
+  }
+}
+
 }  // namespace tensorflow
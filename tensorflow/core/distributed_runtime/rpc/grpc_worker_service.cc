@@ -446,12 +446,32 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
   const int64 step_id = request->step_id();
 
   bool cache_enabled = (response_cache_ != nullptr && request_id != 0);
+  const int64 max_chunk_bytes = request->max_chunk_bytes();
+  const int64 chunk_offset = request->chunk_offset();
 
-  auto do_response = [response, done, cache_enabled](const Tensor& tensor,
-                                                     bool is_dead,
-                                                     const Status& status) {
+  auto do_response = [response, done, cache_enabled, max_chunk_bytes,
+                      chunk_offset](const Tensor& tensor, bool is_dead,
+                                    const Status& status) {
     if (status.ok()) {
-      grpc::EncodeTensorToByteBuffer(is_dead, tensor, cache_enabled, response);
+      // The remaining chunks of a chunked response are requested with the
+      // same request id and served from the response cache, so chunking
+      // requires it.
+      if (cache_enabled && max_chunk_bytes > 0 && !is_dead &&
+          DataTypeCanUseMemcpy(tensor.dtype()) &&
+          tensor.TotalBytes() > max_chunk_bytes) {
+        if (chunk_offset < 0 || chunk_offset >= tensor.TotalBytes()) {
+          done(errors::InvalidArgument(
+              "RecvTensor chunk offset ", chunk_offset,
+              " is out of range for a tensor of ", tensor.TotalBytes(),
+              " bytes"));
+          return;
+        }
+        grpc::EncodeTensorChunkToByteBuffer(tensor, chunk_offset,
+                                            max_chunk_bytes, response);
+      } else {
+        grpc::EncodeTensorToByteBuffer(is_dead, tensor, cache_enabled,
+                                       response);
+      }
     }
     done(status);
   };
@@ -33,11 +33,29 @@ limitations under the License.
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 namespace {
 
+// Returns the size of the chunks in which the content of large tensors
+// received into host memory is requested, or 0 to receive every tensor in
+// a single response.
+int64 RecvTensorChunkBytes() {
+  static const int64 chunk_bytes = [] {
+    int64 value;
+    Status s =
+        ReadInt64FromEnvVar("TF_GRPC_RECV_TENSOR_CHUNK_BYTES", 0, &value);
+    if (!s.ok()) {
+      LOG(ERROR) << s;
+      return int64{0};
+    }
+    return value;
+  }();
+  return chunk_bytes;
+}
+
 class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  public:
   RpcRemoteRendezvous(const WorkerEnv* env, int64 step_id)
@@ -86,6 +104,7 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     resp_.Clear();
     {
       mutex_lock l(mu_);
+      DCHECK(chunk_calls_.empty());
       status_ = Status::OK();
     }
     done_ = nullptr;
@@ -107,6 +126,9 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     {
       mutex_lock l(mu_);
       status_.Update(s);
+      for (ChunkCall* chunk : chunk_calls_) {
+        chunk->opts.StartCancel();
+      }
     }
     opts_.StartCancel();
   }
@@ -134,18 +156,53 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
  private:
   friend class RpcRemoteRendezvous;
 
+  // Maximum number of RecvTensor calls fetching chunks of the same tensor
+  // at a time.
+  static constexpr int kMaxChunksInFlight = 4;
+
+  // A RecvTensor call fetching one chunk of the tensor content after the
+  // first one.
+  struct ChunkCall {
+    CallOptions opts;
+    RecvTensorRequest req;
+    TensorResponse resp;
+  };
+
+  // State shared by the chunk calls of one tensor.
+  struct ChunkFetchState {
+    std::function<void()> recv_done;
+    mutex mu;
+    int64 next_offset TF_GUARDED_BY(mu) = 0;
+    int in_flight TF_GUARDED_BY(mu) = 0;
+    bool finished TF_GUARDED_BY(mu) = false;
+  };
+
   // Start the main RecvTensor call, checking for an async abort.
   void StartRTCall(std::function<void()> recv_done) {
     resp_.InitAlloc(dst_device_, alloc_attrs_);
+    // Chunks are parsed directly into the tensor allocated for the first
+    // one, which is only supported in host memory.
+    if (RecvTensorChunkBytes() > 0 && resp_.on_host()) {
+      req_.set_max_chunk_bytes(RecvTensorChunkBytes());
+    }
     auto abort_checked = std::make_shared<Notification>();
     auto cb = [this, abort_checked,
                recv_done = std::move(recv_done)](const Status& s) {
       // Make sure the Rendezvous abort checking is finished before running the
       // callback, which might destroy the current call object.
       abort_checked->WaitForNotification();
-      if (!s.ok()) {
+      Status status = s;
+      if (status.ok() && resp_.metadata().total_content_bytes() > 0) {
+        status = CheckChunk(resp_, 0);
+        if (status.ok() &&
+            req_.max_chunk_bytes() < resp_.metadata().total_content_bytes()) {
+          FetchRemainingChunks(recv_done);
+          return;
+        }
+      }
+      if (!status.ok()) {
         mutex_lock l(mu_);
-        status_.Update(s);
+        status_.Update(status);
       }
       recv_done();
     };
@@ -168,6 +225,114 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     abort_checked->Notify();
   }
 
+  // Returns an error unless "resp" holds the chunk at "offset" of the tensor
+  // whose first chunk is in resp_.
+  Status CheckChunk(const TensorResponse& resp, int64 offset) const {
+    const RecvTensorResponse& meta = resp.metadata();
+    if (meta.total_content_bytes() != resp_.metadata().total_content_bytes() ||
+        meta.chunk_offset() != offset ||
+        resp.tensor().tensor_data().data() !=
+            resp_.tensor().tensor_data().data()) {
+      return errors::Internal("Unexpected chunk at offset ",
+                              meta.chunk_offset(), " instead of ", offset,
+                              " in RecvTensor response for ",
+                              req_.rendezvous_key());
+    }
+    return Status::OK();
+  }
+
+  // Fetches the chunks after the first one with up to kMaxChunksInFlight
+  // concurrent calls and runs "recv_done" once all of them finished.
+  void FetchRemainingChunks(std::function<void()> recv_done) {
+    auto state = std::make_shared<ChunkFetchState>();
+    state->recv_done = std::move(recv_done);
+    {
+      mutex_lock l(state->mu);
+      state->next_offset = req_.max_chunk_bytes();
+      // Hold one call slot while starting the calls, so that none of their
+      // callbacks finishes the fetch early.
+      state->in_flight = 1;
+    }
+    for (int i = 0; i < kMaxChunksInFlight; ++i) {
+      FetchNextChunk(state, /*chunk_done=*/false);
+    }
+    FetchNextChunk(state, /*chunk_done=*/true);
+  }
+
+  // Starts the call for the next chunk if possible, or runs recv_done if all
+  // calls finished.  "chunk_done" releases the call slot of a finished call.
+  //
+  // The last chunk is only requested once all others were received: its
+  // response asks for an ack, which erases the tensor from the sender's
+  // response cache that serves the other chunks.
+  void FetchNextChunk(const std::shared_ptr<ChunkFetchState>& state,
+                      bool chunk_done) {
+    int64 offset = -1;
+    {
+      mutex_lock l(state->mu);
+      if (chunk_done) --state->in_flight;
+      // Once finished, *this may have been released already.
+      if (state->finished) return;
+      const int64 total_bytes = resp_.metadata().total_content_bytes();
+      const bool ok = status().ok();
+      const bool is_last =
+          state->next_offset + req_.max_chunk_bytes() >= total_bytes;
+      if (ok && state->next_offset < total_bytes &&
+          (!is_last || state->in_flight == 0)) {
+        offset = state->next_offset;
+        state->next_offset += req_.max_chunk_bytes();
+        ++state->in_flight;
+      } else if (state->in_flight > 0 ||
+                 (ok && state->next_offset < total_bytes)) {
+        return;
+      } else {
+        state->finished = true;
+      }
+    }
+    if (offset < 0) {
+      state->recv_done();
+      return;
+    }
+    StartChunkCall(state, offset);
+  }
+
+  // Starts the call for the chunk at "offset", checking for an async abort.
+  void StartChunkCall(std::shared_ptr<ChunkFetchState> state, int64 offset) {
+    ChunkCall* chunk = new ChunkCall;
+    chunk->req = req_;
+    chunk->req.set_chunk_offset(offset);
+    chunk->resp.InitAlloc(dst_device_, alloc_attrs_);
+    chunk->resp.InitChunkDestination(resp_.tensor());
+    {
+      mutex_lock l(mu_);
+      chunk_calls_.insert(chunk);
+    }
+    auto abort_checked = std::make_shared<Notification>();
+    auto cb = [this, state, chunk, offset, abort_checked](const Status& s) {
+      abort_checked->WaitForNotification();
+      Status status = s;
+      if (status.ok()) {
+        status = CheckChunk(chunk->resp, offset);
+      }
+      {
+        mutex_lock l(mu_);
+        chunk_calls_.erase(chunk);
+        status_.Update(status);
+      }
+      delete chunk;
+      FetchNextChunk(state, /*chunk_done=*/true);
+    };
+    wi_->RecvTensorAsync(&chunk->opts, &chunk->req, &chunk->resp,
+                         std::move(cb));
+    {
+      mutex_lock l(mu_);
+      if (!status_.ok()) {
+        chunk->opts.StartCancel();
+      }
+    }
+    abort_checked->Notify();
+  }
+
   string src_worker_;
   string src_rel_device_;
   WorkerInterface* wi_;  // Not owned.
@@ -181,6 +346,7 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
 
   mutable mutex mu_;
   Status status_ TF_GUARDED_BY(mu_);
+  std::unordered_set<ChunkCall*> chunk_calls_ TF_GUARDED_BY(mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRecvTensorCall);
 };
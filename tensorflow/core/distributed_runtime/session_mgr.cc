@@ -184,6 +184,10 @@ Status SessionMgr::CreateSession(
 }
 
 void SessionMgr::ResetDefaultWorkerCache(WorkerCacheInterface* worker_cache) {
+  mutex_lock l(mu_);
+  if (default_worker_cache_ != nullptr) {
+    retired_worker_caches_.push_back(std::move(default_worker_cache_));
+  }
   default_worker_cache_.reset(worker_cache);
 }
 
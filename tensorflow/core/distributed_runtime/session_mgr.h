@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_SESSION_MGR_H_
 
 #include <functional>
+#include <vector>
 
 #include "tensorflow/core/distributed_runtime/worker_session.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -66,6 +67,9 @@ class SessionMgr {
       const protobuf::RepeatedPtrField<DeviceAttributes>& device_attributes,
       bool isolate_session_state, string master_task, int64 master_incarnation);
 
+  // Replaces the worker cache used by sessions created from now on without
+  // their own cluster. Existing sessions keep the cache they were created
+  // with. Takes ownership of `worker_cache`.
   void ResetDefaultWorkerCache(WorkerCacheInterface* worker_cache);
 
   // Updates state (worker cache, devices) of worker session identified by
@@ -107,6 +111,10 @@ class SessionMgr {
   // device_mgr is deleted after WorkerSession's graph_mgr.
 
   std::unique_ptr<WorkerCacheInterface> default_worker_cache_;
+  // Default worker caches replaced by ResetDefaultWorkerCache. Sessions
+  // created before the reset (including legacy_session_) still wrap them, so
+  // they are kept until the SessionMgr is deleted.
+  std::vector<std::unique_ptr<WorkerCacheInterface>> retired_worker_caches_;
   std::shared_ptr<WorkerSession> legacy_session_;
 
   bool is_logging_active_ = false;
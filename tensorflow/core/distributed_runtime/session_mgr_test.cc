@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/session_mgr.h"
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
+#include "tensorflow/core/distributed_runtime/test_utils.h"
 #include "tensorflow/core/distributed_runtime/worker_env.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
@@ -266,4 +267,29 @@ TEST_F(SessionMgrTest, DeleteLegacySession) {
   TF_EXPECT_OK(mgr_.DeleteSession(""));
 }
 
+TEST_F(SessionMgrTest, ResetDefaultWorkerCacheKeepsExistingSessions) {
+  auto* old_cache = new TestWorkerCache;
+  old_cache->AddWorker("/job:mnist/replica:0/task:1", nullptr);
+  SessionMgr mgr(&env_, "/job:mnist/replica:0/task:0",
+                 std::unique_ptr<WorkerCacheInterface>(old_cache), factory_);
+  ServerDef server_def;
+  server_def.set_job_name("mnist");
+  server_def.set_task_index(0);
+  TF_EXPECT_OK(mgr.CreateSession("before", server_def, false));
+
+  auto* new_cache = new TestWorkerCache;
+  new_cache->AddWorker("/job:mnist/replica:0/task:2", nullptr);
+  mgr.ResetDefaultWorkerCache(new_cache);
+  TF_EXPECT_OK(mgr.CreateSession("after", server_def, false));
+
+  std::shared_ptr<WorkerSession> session;
+  std::vector<string> workers;
+  TF_EXPECT_OK(mgr.WorkerSessionForSession("before", &session));
+  session->worker_cache()->ListWorkers(&workers);
+  EXPECT_EQ(workers, std::vector<string>({"/job:mnist/replica:0/task:1"}));
+  TF_EXPECT_OK(mgr.WorkerSessionForSession("after", &session));
+  session->worker_cache()->ListWorkers(&workers);
+  EXPECT_EQ(workers, std::vector<string>({"/job:mnist/replica:0/task:2"}));
+}
+
 }  // namespace tensorflow
@@ -31,6 +31,7 @@ void TensorResponse::Clear() {
   alloc_attrs_ = AllocatorAttributes();
   allocator_ = nullptr;
   already_used_ = false;
+  chunk_destination_ = Tensor();
   ClearTensor();
 }
 
@@ -144,6 +145,34 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
 
 }  // namespace
 
+bool TensorResponse::InitChunkTensor(const TensorProto& tensor_meta) {
+  if (!TensorShape::IsValid(tensor_meta.tensor_shape())) return false;
+  TensorShape shape(tensor_meta.tensor_shape());
+  if (chunk_destination_.IsInitialized()) {
+    if (chunk_destination_.dtype() != tensor_meta.dtype() ||
+        chunk_destination_.shape() != shape) {
+      return false;
+    }
+    tensor_ = chunk_destination_;
+  } else {
+    Tensor t(allocator_, tensor_meta.dtype(), shape);
+    tensor_ = std::move(t);
+  }
+  return DataTypeCanUseMemcpy(tensor_.dtype()) &&
+         tensor_.TotalBytes() == meta_.total_content_bytes();
+}
+
+char* TensorResponse::ChunkBuffer(int64 num_bytes) {
+  StringPiece buf = tensor_.tensor_data();
+  const int64 size = buf.size();
+  const int64 offset = meta_.chunk_offset();
+  if (meta_.total_content_bytes() != size || offset < 0 || num_bytes < 0 ||
+      offset + num_bytes > size) {
+    return nullptr;
+  }
+  return const_cast<char*>(buf.data()) + offset;
+}
+
 bool TensorResponse::ParseTensorSubmessage(
     protobuf::io::CodedInputStream* input, TensorProto* tensor_meta) {
   bool seen_tensor_content = false;
@@ -154,6 +183,10 @@ bool TensorResponse::ParseTensorSubmessage(
     if (!p.second) {
       bool ok = (tag == 0);
       if (ok && !seen_tensor_content) {
+        // The content is sent separately in chunks.
+        if (meta_.total_content_bytes() > 0) {
+          return InitChunkTensor(*tensor_meta);
+        }
         // No tensor content: could be because it's a zero-length tensor
         TensorShape shape(tensor_meta->tensor_shape());
         Tensor t(allocator_, tensor_meta->dtype(), shape);
@@ -267,6 +300,32 @@ bool TensorResponse::ParseFast(Source* source) {
         meta_.set_require_ack(v != 0);
         break;
       }
+      case RecvTensorResponse::kTotalContentBytesFieldNumber: {
+        protobuf_uint64 v;
+        if ((wt != WIRETYPE_VARINT) || !input.ReadVarint64(&v)) return false;
+        if (meta_.has_tensor()) return false;
+        meta_.set_total_content_bytes(static_cast<int64>(v));
+        break;
+      }
+      case RecvTensorResponse::kChunkOffsetFieldNumber: {
+        protobuf_uint64 v;
+        if ((wt != WIRETYPE_VARINT) || !input.ReadVarint64(&v)) return false;
+        meta_.set_chunk_offset(static_cast<int64>(v));
+        break;
+      }
+      case RecvTensorResponse::kChunkDataFieldNumber: {
+        // The chunk can only be read in place once the tensor skeleton
+        // has been parsed.
+        if (wt != WIRETYPE_LENGTH_DELIMITED || !meta_.has_tensor() ||
+            meta_.total_content_bytes() <= 0) {
+          return false;
+        }
+        int num_bytes;
+        if (!ReadVarintSizeAsInt(&input, &num_bytes)) return false;
+        char* buf = ChunkBuffer(num_bytes);
+        if (buf == nullptr || !input.ReadRaw(buf, num_bytes)) return false;
+        break;
+      }
       default: {
         // Unknown tag, so don't handle we can't handle on the fast path
         return false;
@@ -282,6 +341,17 @@ bool TensorResponse::ParseSlow(Source* source) {
     return false;
   }
 
+  if (meta_.total_content_bytes() > 0) {
+    const string& chunk = meta_.chunk_data();
+    if (!InitChunkTensor(meta_.tensor())) return false;
+    char* buf = ChunkBuffer(chunk.size());
+    if (buf == nullptr) return false;
+    memcpy(buf, chunk.data(), chunk.size());
+    meta_.clear_chunk_data();
+    meta_.clear_tensor();
+    return true;
+  }
+
   Tensor parsed(meta_.tensor().dtype());
   if (!parsed.FromProto(allocator_, meta_.tensor())) {
     return false;
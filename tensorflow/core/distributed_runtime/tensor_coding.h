@@ -91,18 +91,36 @@ class TensorResponse {
   // Return pointer to the device hosting the tensor.
   DeviceBase* device() const { return device_; }
 
+  // Whether the tensor is parsed into host memory.  Only such responses
+  // can receive tensor content in chunks.
+  bool on_host() const { return on_host_; }
+
+  // Parse the chunks of tensor content in later responses directly into
+  // the buffer of "t", which must have been parsed from an earlier chunk of
+  // the same tensor, instead of allocating a new tensor.  Must be called
+  // after InitAlloc.
+  void InitChunkDestination(const Tensor& t) { chunk_destination_ = t; }
+
  private:
   bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
                              TensorProto* tensor_meta);
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
 
+  // Set tensor_ to the destination of the chunk of tensor content
+  // described by meta_, allocating it if there is no chunk destination.
+  bool InitChunkTensor(const TensorProto& tensor_meta);
+  // Return the buffer to read "num_bytes" bytes of content at
+  // meta_.chunk_offset() into, or nullptr if they don't fit in tensor_.
+  char* ChunkBuffer(int64 num_bytes);
+
   bool on_host_ = false;
   DeviceBase* device_ = nullptr;
   AllocatorAttributes alloc_attrs_;
   Allocator* allocator_ = nullptr;
   bool already_used_ = false;
   Tensor tensor_;
+  Tensor chunk_destination_;
   RecvTensorResponse meta_;
 };
 
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
@@ -156,6 +157,75 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+// Encodes the chunk of the content of "src" at "offset" as a
+// RecvTensorResponse.  If "header_first", the chunk metadata precedes the
+// tensor field as in the gRPC encoding, otherwise fields are in field
+// number order.
+string EncodeChunk(const Tensor& src, int64 offset, int64 chunk_bytes,
+                   bool header_first) {
+  StringPiece tdata = src.tensor_data();
+  RecvTensorResponse header;
+  header.set_total_content_bytes(tdata.size());
+  header.set_chunk_offset(offset);
+  RecvTensorResponse body;
+  body.mutable_tensor()->set_dtype(src.dtype());
+  src.shape().AsProto(body.mutable_tensor()->mutable_tensor_shape());
+  body.set_chunk_data(string(tdata.substr(offset, chunk_bytes)));
+  string encoded;
+  if (header_first) {
+    header.AppendToString(&encoded);
+    body.AppendToString(&encoded);
+  } else {
+    header.MergeFrom(body);
+    header.AppendToString(&encoded);
+  }
+  return encoded;
+}
+
+TEST_F(TensorResponseTest, Chunks) {
+  Tensor src(DT_FLOAT, TensorShape({3, 1000}));
+  test::FillFn<float>(&src, [](int i) -> float { return i; });
+  const int64 total_bytes = src.TotalBytes();
+  const int64 chunk_bytes = 1000;
+  DummyDevice cpu_device(Env::Default());
+  for (bool header_first : {true, false}) {
+    Tensor dst;
+    for (int64 offset = 0; offset < total_bytes; offset += chunk_bytes) {
+      string encoded = EncodeChunk(src, offset, chunk_bytes, header_first);
+      StringSource source(&encoded, 1024);
+      TensorResponse response;
+      response.InitAlloc(&cpu_device, AllocatorAttributes());
+      if (offset > 0) {
+        response.InitChunkDestination(dst);
+      }
+      TF_EXPECT_OK(response.ParseFrom(&source));
+      EXPECT_EQ(total_bytes, response.metadata().total_content_bytes());
+      EXPECT_EQ(offset, response.metadata().chunk_offset());
+      if (offset == 0) {
+        dst = response.tensor();
+      } else {
+        // Later chunks are parsed in place.
+        EXPECT_EQ(dst.tensor_data().data(),
+                  response.tensor().tensor_data().data());
+      }
+    }
+    test::ExpectTensorEqual<float>(src, dst);
+  }
+}
+
+TEST_F(TensorResponseTest, ChunkOutOfRange) {
+  Tensor src(DT_FLOAT, TensorShape({100}));
+  test::FillFn<float>(&src, [](int i) -> float { return i; });
+  string encoded = EncodeChunk(src, 0, 100, true);
+  StringSource source(&encoded, 1024);
+  DummyDevice cpu_device(Env::Default());
+  TensorResponse response;
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  // The destination is too small for the tensor.
+  response.InitChunkDestination(Tensor(DT_FLOAT, TensorShape({10})));
+  EXPECT_FALSE(response.ParseFrom(&source).ok());
+}
+
 string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
@@ -446,6 +446,11 @@ class SubAllocator {
                       size_t* bytes_received) = 0;
   virtual void Free(void* ptr, size_t num_bytes) = 0;
 
+  // Returns true if memory returned by consecutive calls to Alloc() may be
+  // contiguous and used as one region, in which case Free() must accept a
+  // range covering several of them.
+  virtual bool SupportsCoalescing() const { return false; }
+
  protected:
   // Implementation of Alloc() method must call this on newly allocated
   // value.
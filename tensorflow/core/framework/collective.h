@@ -99,6 +99,10 @@ struct CollImplDetails {
                               // e.g. ring or nccl
   float timeout_seconds;      // If non zero, set a completion timeout for the
                               // collective op to detect staleness.
+  // If not DT_INVALID, the type that float reduction chunks are cast to
+  // between devices; accumulation stays in the full precision data_type.
+  // Every member of the instance must use the same value.
+  DataType wire_data_type = DT_INVALID;
 };
 
 // Data common to all members of a collective instance.
@@ -1061,6 +1061,14 @@ class DatasetBaseIterator : public IteratorBase {
     }
   }
 
+  // When modeling is enabled, this method records that a consumer of this
+  // iterator waited for `wait_nanos` for an element to be produced.
+  void RecordWaitTime(IteratorContext* ctx, int64 wait_nanos) {
+    if (collect_resource_usage(ctx)) {
+      node_->add_wait_time(wait_nanos);
+    }
+  }
+
   // Returns whether work is currently being recorded, i.e. whether we are
   // currently between a `RecordStart` and a `RecordStop`.
   bool IsRecording(IteratorContext* ctx) {
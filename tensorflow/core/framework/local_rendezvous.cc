@@ -97,7 +97,12 @@ void LocalRendezvous::ItemQueue::push_back(Item* item) {
 }
 
 LocalRendezvous::~LocalRendezvous() {
-  if (!table_.empty()) {
+  bool empty = true;
+  for (TableShard& shard : table_shards_) {
+    mutex_lock l(shard.mu);
+    empty = empty && shard.table.empty();
+  }
+  if (!empty) {
     StartAbort(errors::Cancelled("LocalRendezvous deleted"));
   }
 }
@@ -122,15 +127,16 @@ Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
         ->IncrementBy(1);
   }
 
-  mu_.lock();
-  if (!status_.ok()) {
+  TableShard& shard = ShardFor(key_hash);
+  shard.mu.lock();
+  if (!shard.status.ok()) {
     // Rendezvous has been aborted.
-    Status s = status_;
-    mu_.unlock();
+    Status s = shard.status;
+    shard.mu.unlock();
     return s;
   }
 
-  ItemQueue* queue = &table_[key_hash];
+  ItemQueue* queue = &shard.table[key_hash];
   if (queue->head == nullptr || queue->head->type == Item::kSend) {
     // There is no waiter for this message. Append the message
     // into the queue. The waiter will pick it up when arrives.
@@ -139,7 +145,7 @@ Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
     // the lock.
     DVLOG(2) << "Enqueue Send Item (key:" << key.FullKey() << "). ";
     queue->push_back(new Item(send_args, val, is_dead));
-    mu_.unlock();
+    shard.mu.unlock();
     return Status::OK();
   }
 
@@ -150,11 +156,11 @@ Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
   // Delete the queue when the last element has been consumed.
   if (item->next == nullptr) {
     DVLOG(2) << "Clean up Send/Recv queue (key:" << key.FullKey() << "). ";
-    table_.erase(key_hash);
+    shard.table.erase(key_hash);
   } else {
     queue->head = item->next;
   }
-  mu_.unlock();
+  shard.mu.unlock();
 
   // Notify the waiter by invoking its done closure, outside the
   // lock.
@@ -170,16 +176,17 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
   uint64 key_hash = KeyHash(key.FullKey());
   DVLOG(2) << "Recv " << this << " " << key_hash << " " << key.FullKey();
 
-  mu_.lock();
-  if (!status_.ok()) {
+  TableShard& shard = ShardFor(key_hash);
+  shard.mu.lock();
+  if (!shard.status.ok()) {
     // Rendezvous has been aborted.
-    Status s = status_;
-    mu_.unlock();
+    Status s = shard.status;
+    shard.mu.unlock();
     done(s, Rendezvous::Args(), recv_args, Tensor(), false);
     return;
   }
 
-  ItemQueue* queue = &table_[key_hash];
+  ItemQueue* queue = &shard.table[key_hash];
   if (queue->head == nullptr || queue->head->type == Item::kRecv) {
     // There is no message to pick up.
     // Only recv-related fields need to be filled.
@@ -205,8 +212,9 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
       already_cancelled = !cm->RegisterCallback(token, [this, token, key_hash] {
         Item* item = nullptr;
         {
-          mutex_lock l(mu_);
-          ItemQueue* queue = &table_[key_hash];
+          TableShard& shard = ShardFor(key_hash);
+          mutex_lock l(shard.mu);
+          ItemQueue* queue = &shard.table[key_hash];
           // Find an item in the queue with a cancellation token that matches
           // `token`, and remove it.
           if (queue->head != nullptr && queue->head->type == Item::kRecv) {
@@ -217,7 +225,7 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
                 if (queue->head->next == nullptr) {
                   // We have a single-element queue, so we can erase it from
                   // the table.
-                  table_.erase(key_hash);
+                  shard.table.erase(key_hash);
                 } else {
                   // Remove the current item from the queue.
                   if (curr == queue->head) {
@@ -249,7 +257,7 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
       });
     }
     if (already_cancelled) {
-      mu_.unlock();
+      shard.mu.unlock();
       // Unref case (2)
       if (rc_owner_) rc_owner_->Unref();
       done(StatusGroup::MakeDerived(
@@ -286,7 +294,7 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
       queue->push_back(new Item(recv_args, std::move(done), token));
     }
 
-    mu_.unlock();
+    shard.mu.unlock();
     return;
   }
 
@@ -298,11 +306,11 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
   // Delete the queue when the last element has been consumed.
   if (item->next == nullptr) {
     DVLOG(2) << "Clean up Send/Recv queue (key:" << key.FullKey() << "). ";
-    table_.erase(key_hash);
+    shard.table.erase(key_hash);
   } else {
     queue->head = item->next;
   }
-  mu_.unlock();
+  shard.mu.unlock();
 
   // Invoke done() without holding the table lock.
   DCHECK_EQ(item->type, Item::kSend);
@@ -313,22 +321,29 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
 
 void LocalRendezvous::StartAbort(const Status& status) {
   CHECK(!status.ok());
-  Table table;
+  Table tables[kNumTableShards];
   {
-    mutex_lock l(mu_);
+    mutex_lock l(status_mu_);
     status_.Update(status);
-    table_.swap(table);
+    for (int i = 0; i < kNumTableShards; ++i) {
+      TableShard& shard = table_shards_[i];
+      mutex_lock shard_lock(shard.mu);
+      shard.status = status_;
+      shard.table.swap(tables[i]);
+    }
   }
-  for (auto& p : table) {
-    Item* item = p.second.head;
-    while (item != nullptr) {
-      if (item->type == Item::kRecv) {
-        (*item->recv_state.waiter)(status, Rendezvous::Args(),
-                                   Rendezvous::Args(), Tensor(), false);
+  for (Table& table : tables) {
+    for (auto& p : table) {
+      Item* item = p.second.head;
+      while (item != nullptr) {
+        if (item->type == Item::kRecv) {
+          (*item->recv_state.waiter)(status, Rendezvous::Args(),
+                                     Rendezvous::Args(), Tensor(), false);
+        }
+        Item* to_delete = item;
+        item = item->next;
+        delete to_delete;
       }
-      Item* to_delete = item;
-      item = item->next;
-      delete to_delete;
     }
   }
 }
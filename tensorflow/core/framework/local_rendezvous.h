@@ -66,13 +66,31 @@ class LocalRendezvous {
 
   typedef gtl::FlatMap<uint64, ItemQueue> Table;
 
+  // Pending items are spread over shards by key hash, so that Send and Recv
+  // calls for different keys rarely contend on the same mutex.
+  static constexpr int kNumTableShardsLog2 = 4;
+  static constexpr int kNumTableShards = 1 << kNumTableShardsLog2;
+
+  struct TableShard {
+    mutex mu;
+    Table table TF_GUARDED_BY(mu);
+    // Copy of `status_`, so that Send and Recv only lock their shard.
+    Status status TF_GUARDED_BY(mu);
+  };
+
+  // Shards by the top bits of the hash, as the table itself uses the low ones.
+  TableShard& ShardFor(uint64 key_hash) {
+    return table_shards_[key_hash >> (64 - kNumTableShardsLog2)];
+  }
+
   // Pointer to the owner class of this LocalRendezvous if it is refcounted.
   const Rendezvous* rc_owner_;
 
-  // TODO(zhifengc): shard table_.
-  mutex mu_;
-  Table table_ TF_GUARDED_BY(mu_);
-  Status status_ TF_GUARDED_BY(mu_);
+  TableShard table_shards_[kNumTableShards];
+
+  // Serializes aborts, so that all shards see the same status.
+  mutex status_mu_;
+  Status status_ TF_GUARDED_BY(status_mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(LocalRendezvous);
 };
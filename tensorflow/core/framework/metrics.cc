@@ -14,8 +14,14 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/framework/metrics.h"
+
+#include <atomic>
+
 #include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/lib/monitoring/sampler.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace metrics {
@@ -64,6 +70,57 @@ auto* graph_unused_outputs = monitoring::Counter<1>::New(
     "/tensorflow/core/graph_unused_outputs",
     "The number of unused outputs for ops of a given type.", "name");
 
+auto* op_queueing_time_usecs_histogram = monitoring::Sampler<1>::New(
+    {"/tensorflow/core/op_queueing_time_usecs_histogram",
+     "The time ops of a given type waited to run after becoming ready in "
+     "microseconds.",
+     "op_type"},
+    // Power of 2 with bucket count 24 (> 8 seconds)
+    {monitoring::Buckets::Exponential(1, 2, 24)});
+
+auto* op_compute_time_usecs_histogram = monitoring::Sampler<1>::New(
+    {"/tensorflow/core/op_compute_time_usecs_histogram",
+     "The time spent running the kernels of ops of a given type in "
+     "microseconds.",
+     "op_type"},
+    // Power of 2 with bucket count 24 (> 8 seconds)
+    {monitoring::Buckets::Exponential(1, 2, 24)});
+
+auto* run_handler_spin_time_usecs = monitoring::Counter<0>::New(
+    "/tensorflow/core/run_handler/spin_time_usecs",
+    "The time idle RunHandler threads spent spinning for work in "
+    "microseconds.");
+
+auto* run_handler_spins = monitoring::Counter<1>::New(
+    "/tensorflow/core/run_handler/spins",
+    "The number of times idle RunHandler threads spun for work, by whether "
+    "they found work before parking.",
+    "found_work");
+
+auto* run_handler_wakeups = monitoring::Counter<0>::New(
+    "/tensorflow/core/run_handler/wakeups",
+    "The number of times parked RunHandler threads woke up.");
+
+auto* event_mgr_completion_latency_usecs_histogram =
+    monitoring::Sampler<1>::New(
+        {"/tensorflow/core/event_mgr/completion_latency_usecs_histogram",
+         "The time between queueing a function to run once a device stream "
+         "is done and noticing that it is, in microseconds.",
+         "mechanism"},
+        // Power of 2 with bucket count 24 (> 16 seconds)
+        {monitoring::Buckets::Exponential(1, 2, 24)});
+
+std::atomic<bool>* OpLatencyMetricsEnabled() {
+  static std::atomic<bool>* enabled = [] {
+    bool enabled = false;
+    Status s = ReadBoolFromEnvVar("TF_ENABLE_OP_LATENCY_METRICS",
+                                  /*default_val=*/false, &enabled);
+    if (!s.ok()) LOG(ERROR) << s;
+    return new std::atomic<bool>(enabled);
+  }();
+  return enabled;
+}
+
 auto* tf_data_autotune_counter = monitoring::Counter<1>::New(
     "/tensorflow/data/autotune", "tf.data autotuning", "name");
 
@@ -79,6 +136,29 @@ auto* tf_data_bytes_read_counter = monitoring::Counter<1>::New(
     "/tensorflow/data/bytes_read",
     "The number of bytes read by tf.data Dataset sources.", "name");
 
+auto* tf_data_processing_time_counter = monitoring::Counter<1>::New(
+    "/tensorflow/data/processing_time",
+    "The time (in microseconds) tf.data iterators spent producing elements.",
+    "name");
+
+auto* tf_data_wait_time_counter = monitoring::Counter<1>::New(
+    "/tensorflow/data/wait_time",
+    "The time (in microseconds) consumers of tf.data iterators waited for an "
+    "element to be produced.",
+    "name");
+
+auto* tf_data_buffer_utilization_histogram = monitoring::Sampler<1>::New(
+    {"/tensorflow/data/buffer_utilization",
+     "The fraction of the buffer of tf.data iterators that holds elements.",
+     "name"},
+    {monitoring::Buckets::Explicit(
+        {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0})});
+
+auto* tf_data_bottleneck_gauge = monitoring::Gauge<string, 0>::New(
+    "/tensorflow/data/bottleneck",
+    "The Dataset type of the node that limits the throughput of the tf.data "
+    "input pipeline analyzed last.");
+
 auto* tf_data_bytes_fetched_counter = monitoring::Counter<0>::New(
     "/tensorflow/data/bytes_fetched",
     "The number of bytes fetched from tf.data Dataset iterator.");
@@ -153,6 +233,16 @@ auto* xla_compilation_time_usecs = monitoring::Counter<0>::New(
     "/tensorflow/core/xla_compilation_time_usecs",
     "The total time spent on compiling XLA graphs in microseconds.");
 
+auto* nccl_communicator_inits = monitoring::Counter<0>::New(
+    "/tensorflow/core/nccl_communicator_inits",
+    "The number of NCCL communicators created, used to collect "
+    "/tensorflow/core/nccl_communicator_init_time_usecs");
+
+auto* nccl_communicator_init_time_usecs = monitoring::Counter<0>::New(
+    "/tensorflow/core/nccl_communicator_init_time_usecs",
+    "The total time spent on initializing NCCL communicators in "
+    "microseconds.");
+
 auto* mlir_import_failure_count = monitoring::Counter<0>::New(
     "/tensorflow/mlir/import_failure_count",
     "The number of jobs that failed during mlir import or verification.");
@@ -184,6 +274,22 @@ monitoring::CounterCell* GetTFDataElementsCounter(const string& name) {
   return tf_data_elements_counter->GetCell(name);
 }
 
+monitoring::CounterCell* GetTFDataProcessingTimeCounter(const string& name) {
+  return tf_data_processing_time_counter->GetCell(name);
+}
+
+monitoring::CounterCell* GetTFDataWaitTimeCounter(const string& name) {
+  return tf_data_wait_time_counter->GetCell(name);
+}
+
+monitoring::SamplerCell* GetTFDataBufferUtilizationSampler(const string& name) {
+  return tf_data_buffer_utilization_histogram->GetCell(name);
+}
+
+void RecordTFDataBottleneck(const string& name) {
+  tf_data_bottleneck_gauge->GetCell()->Set(name);
+}
+
 void RecordTFDataBytesFetched(int64 num_bytes) {
   tf_data_bytes_fetched_counter->GetCell()->IncrementBy(num_bytes);
 }
@@ -302,6 +408,15 @@ void UpdateXlaCompilationTime(const uint64 compilation_time_usecs) {
   }
 }
 
+void UpdateNcclCommunicatorInitTime(const uint64 init_time_usecs) {
+  static auto* nccl_communicator_inits_cell =
+      nccl_communicator_inits->GetCell();
+  static auto* nccl_communicator_init_time_usecs_cell =
+      nccl_communicator_init_time_usecs->GetCell();
+  nccl_communicator_inits_cell->IncrementBy(1);
+  nccl_communicator_init_time_usecs_cell->IncrementBy(init_time_usecs);
+}
+
 void UpdateBfcAllocatorDelayTime(const uint64 delay_usecs) {
   static auto* bfc_allocator_delay_cell = bfc_allocator_delay->GetCell();
   if (delay_usecs > 0) {
@@ -319,5 +434,43 @@ void RecordUnusedOutput(const string& op_name) {
   graph_unused_outputs->GetCell(op_name)->IncrementBy(1);
 }
 
+void SetOpLatencyMetricsEnabled(bool enabled) {
+  OpLatencyMetricsEnabled()->store(enabled, std::memory_order_relaxed);
+}
+
+bool IsOpLatencyMetricsEnabled() {
+  return OpLatencyMetricsEnabled()->load(std::memory_order_relaxed);
+}
+
+void RecordOpQueueingTime(const string& op_type, uint64 queueing_time_usecs) {
+  op_queueing_time_usecs_histogram->GetCell(op_type)->Add(
+      queueing_time_usecs);
+}
+
+void RecordOpComputeTime(const string& op_type, uint64 compute_time_usecs) {
+  op_compute_time_usecs_histogram->GetCell(op_type)->Add(compute_time_usecs);
+}
+
+void RecordRunHandlerSpin(uint64 spin_usecs, bool found_work) {
+  static auto* spin_time_cell = run_handler_spin_time_usecs->GetCell();
+  static auto* hit_cell = run_handler_spins->GetCell("true");
+  static auto* miss_cell = run_handler_spins->GetCell("false");
+  spin_time_cell->IncrementBy(spin_usecs);
+  (found_work ? hit_cell : miss_cell)->IncrementBy(1);
+}
+
+void RecordRunHandlerWakeup() {
+  static auto* wakeups_cell = run_handler_wakeups->GetCell();
+  wakeups_cell->IncrementBy(1);
+}
+
+void RecordEventMgrCompletionLatency(uint64 latency_usecs, bool host_callback) {
+  static auto* host_callback_cell =
+      event_mgr_completion_latency_usecs_histogram->GetCell("host_callback");
+  static auto* poll_cell =
+      event_mgr_completion_latency_usecs_histogram->GetCell("poll");
+  (host_callback ? host_callback_cell : poll_cell)->Add(latency_usecs);
+}
+
 }  // namespace metrics
 }  // namespace tensorflow
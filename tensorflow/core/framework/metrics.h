@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_FRAMEWORK_METRICS_H_
 
 #include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -53,6 +54,31 @@ monitoring::CounterCell* GetTFDataBytesReadCounter(const string& name);
 // The `name` argument identifies the Dataset type (e.g. "Batch" or "Map").
 monitoring::CounterCell* GetTFDataElementsCounter(const string& name);
 
+// Returns a counter that can be used to record the time (in microseconds)
+// spent producing elements by the iterators of a tf.data.Dataset, excluding the
+// time spent waiting.
+//
+// The `name` argument identifies the Dataset type (e.g. "Batch" or "Map").
+monitoring::CounterCell* GetTFDataProcessingTimeCounter(const string& name);
+
+// Returns a counter that can be used to record the time (in microseconds)
+// consumers of the iterators of a tf.data.Dataset waited for an element to be
+// produced.
+//
+// The `name` argument identifies the Dataset type (e.g. "Prefetch").
+monitoring::CounterCell* GetTFDataWaitTimeCounter(const string& name);
+
+// Returns a sampler that can be used to record the fraction of the buffer of a
+// tf.data.Dataset iterator that holds elements.
+//
+// The `name` argument identifies the Dataset type (e.g. "Prefetch").
+monitoring::SamplerCell* GetTFDataBufferUtilizationSampler(const string& name);
+
+// Records the Dataset type of the node that limits the throughput of the
+// tf.data input pipeline analyzed last, i.e. the node with the largest
+// processing time per element and unit of parallelism.
+void RecordTFDataBottleneck(const string& name);
+
 // Records the number of bytes fetched from tf.data.Dataset iterator.
 void RecordTFDataBytesFetched(int64 num_bytes);
 
@@ -103,6 +129,33 @@ void UpdateGraphPendingQueueLength(uint64 len);
 // Records that one output of an op of type `op_name` was unused.
 void RecordUnusedOutput(const string& op_name);
 
+// Enables or disables the per-op latency metrics recorded by the executor,
+// which are off by default unless TF_ENABLE_OP_LATENCY_METRICS is set. Steps
+// that are already running keep their setting.
+void SetOpLatencyMetricsEnabled(bool enabled);
+bool IsOpLatencyMetricsEnabled();
+
+// Records the time (in microseconds) an op of type `op_type` waited between
+// becoming ready and starting to run, mostly queued in the inter-op pool.
+void RecordOpQueueingTime(const string& op_type, uint64 queueing_time_usecs);
+
+// Records the time (in microseconds) spent running the kernel of an op of
+// type `op_type`, until it is done for asynchronous kernels.
+void RecordOpComputeTime(const string& op_type, uint64 compute_time_usecs);
+
+// Records that an idle RunHandler thread spun for `spin_usecs` microseconds
+// looking for work before it found some (`found_work`) or gave up and parked.
+void RecordRunHandlerSpin(uint64 spin_usecs, bool found_work);
+
+// Records that a parked RunHandler thread woke up, for new work or on a
+// timeout.
+void RecordRunHandlerWakeup();
+
+// Records the time between queueing a function to run once a device stream is
+// done and the device EventMgr noticing it, from a host callback
+// (`host_callback`) or by polling an event.
+void RecordEventMgrCompletionLatency(uint64 latency_usecs, bool host_callback);
+
 // Updates the metrics stored about time spent building graphs.
 //
 // By "GraphBuild", we refer to building a client graph, which is a sub-graph of
@@ -127,6 +180,9 @@ void UpdateGrapplerPassTime(const string& pass_name,
 // Updates the metrics stored about time XLA spents compiling graphs.
 void UpdateXlaCompilationTime(const uint64 compilation_time_usecs);
 
+// Updates the metrics stored about time spent initializing NCCL communicators.
+void UpdateNcclCommunicatorInitTime(const uint64 init_time_usecs);
+
 // Updates the metrics stored about time BFC allocator spents during delay.
 void UpdateBfcAllocatorDelayTime(const uint64 delay_usecs);
 
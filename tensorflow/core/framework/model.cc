@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/model.h"
 
+#include <deque>
 #include <memory>
 
 #include "absl/time/clock.h"
@@ -104,6 +105,30 @@ inline void UpdateParameterValues(
   }
 }
 
+// Estimates the per-element processing time of a node at `parallelism` from
+// the times measured at other parallelism values, by linear interpolation
+// between the nearest measurements or linear extrapolation beyond them.
+double InterpolateProcessingTime(const std::map<int64, double>& times,
+                                 double parallelism) {
+  DCHECK(!times.empty());
+  if (times.size() == 1) {
+    return times.begin()->second;
+  }
+  auto upper = times.lower_bound(static_cast<int64>(std::ceil(parallelism)));
+  if (upper != times.end() && upper->first == parallelism) {
+    return upper->second;
+  }
+  if (upper == times.begin()) {
+    ++upper;
+  } else if (upper == times.end()) {
+    --upper;
+  }
+  auto lower = std::prev(upper);
+  const double slope =
+      (upper->second - lower->second) / (upper->first - lower->first);
+  return std::max(0.0, lower->second + slope * (parallelism - lower->first));
+}
+
 // Copies the parameter values (which are for optimization tuning) and updates
 // the state values (which are for the input pipeline to follow).
 inline void UpdateStateValues(
@@ -1076,6 +1101,14 @@ void Node::FlushMetrics() {
   metrics_.record_bytes_consumed(bytes_consumed_);
   metrics_.record_bytes_produced(bytes_produced_);
   metrics_.record_num_elements(num_elements_);
+  metrics_.record_processing_time(processing_time_);
+  metrics_.record_wait_time(wait_time_);
+  double buffer_size = parameter_value_or(kBufferSize, 0.0);
+  if (buffer_size <= 0) buffer_size = parameter_value_or(kParallelism, 0.0);
+  if (buffer_size > 0) {
+    metrics_.record_buffer_utilization(
+        std::min(1.0, buffered_elements_ / buffer_size));
+  }
 }
 
 double Node::OutputTime(absl::flat_hash_map<string, double>* input_times,
@@ -1143,6 +1176,21 @@ double Node::TotalBufferedBytes() const {
   return total_bytes[long_name()];
 }
 
+double Node::TotalUntunedBufferedBytes() const {
+  tf_shared_lock l(mu_);
+  double total_bytes = 0;
+  if (!HasTunedBuffer()) {
+    total_bytes = buffered_bytes_;
+  }
+  for (const auto& node : CollectNodes(TraversalOrder::BFS, IsAnyNode)) {
+    tf_shared_lock l(node->mu_);
+    if (!node->HasTunedBuffer()) {
+      total_bytes += node->buffered_bytes_;
+    }
+  }
+  return total_bytes;
+}
+
 double Node::TotalMaximumBufferedBytes() const {
   absl::flat_hash_map<string, double> total_bytes;
   tf_shared_lock l(mu_);
@@ -1180,32 +1228,33 @@ double Node::TotalProcessingTime(
 double Node::AverageBufferedElementSize() const {
   DCHECK_GE(num_elements_, 0);
   DCHECK_GE(buffered_elements_, 0);
+  double size;
   if (num_elements_ <= 0) {
     if (buffered_elements_ <= 0) {
       // If there are no produced elements or buffered elements recorded, return
       // 0.
-      return 0;
+      size = 0;
+    } else {
+      // If there are no produced elements but some buffered elements, return
+      // the average size of all buffered elements.
+      size = static_cast<double>(buffered_bytes_) /
+             static_cast<double>(buffered_elements_);
     }
-    // If there are no produced elements but some buffered elements, return the
-    // average size of all buffered elements.
-    return static_cast<double>(buffered_bytes_) /
-           static_cast<double>(buffered_elements_);
-  }
-
-  if (buffered_elements_ <= 0) {
+  } else if (buffered_elements_ <= 0) {
     // If there are no buffered elements but some produced elements, return the
     // average size of all produced elements.
-    return static_cast<double>(bytes_produced_) /
+    size = static_cast<double>(bytes_produced_) /
            static_cast<double>(num_elements_);
-  }
-
-  // Otherwise, return the mean value of average size of all produced elements
-  // and average size of all buffered elements.
-  return (static_cast<double>(bytes_produced_) /
-              static_cast<double>(num_elements_) +
-          static_cast<double>(buffered_bytes_) /
-              static_cast<double>(buffered_elements_)) /
-         2.0;
+  } else {
+    // Otherwise, return the mean value of average size of all produced
+    // elements and average size of all buffered elements.
+    size = (static_cast<double>(bytes_produced_) /
+                static_cast<double>(num_elements_) +
+            static_cast<double>(buffered_bytes_) /
+                static_cast<double>(buffered_elements_)) /
+           2.0;
+  }
+  return std::max(size, buffered_element_size_estimate_);
 }
 
 double Node::OutputTimeForInputs(
@@ -1274,6 +1323,14 @@ double Node::TotalProcessingTimeForInputs(
 }
 
 double Node::SelfProcessingTimeLocked() const {
+  if (self_processing_time_estimator_) {
+    double parallelism = 1.0;
+    auto* parameter = gtl::FindOrNull(parameters_, kParallelism);
+    if (parameter) {
+      parallelism = (*parameter)->value;
+    }
+    return self_processing_time_estimator_(parallelism);
+  }
   if (num_elements_ == 0) {
     return 0;
   }
@@ -1390,11 +1447,7 @@ void Node::TotalBufferedBytesHelper(
   }
 
   double result = 0;
-  auto* parameter = gtl::FindOrNull(parameters_, kBufferSize);
-  if (!parameter) {
-    parameter = gtl::FindOrNull(parameters_, kParallelism);
-  }
-  if (parameter) {
+  if (HasTunedBuffer()) {
     result = buffered_bytes_;
   }
   for (auto& input : inputs_) {
@@ -1418,6 +1471,11 @@ void Node::TotalMaximumBufferedBytesHelper(
   total_bytes->insert(std::make_pair(long_name(), result));
 }
 
+bool Node::HasTunedBuffer() const TF_SHARED_LOCKS_REQUIRED(mu_) {
+  return autotune_ && (parameters_.contains(kBufferSize) ||
+                       parameters_.contains(kParallelism));
+}
+
 double Node::MaximumBufferedBytes() const TF_SHARED_LOCKS_REQUIRED(mu_) {
   return 0;
 }
@@ -1451,18 +1509,45 @@ void Model::FlushMetrics() {
     tf_shared_lock l(mu_);
     if (output_) queue.push_back(output_);
   }
+  // The bottleneck is the node that takes the longest to produce an element,
+  // accounting for the elements it produces in parallel.
+  std::shared_ptr<Node> bottleneck;
+  double bottleneck_time = 0.0;
   while (!queue.empty()) {
     auto node = queue.front();
     queue.pop_front();
     node->FlushMetrics();
+    if (node->autotune()) {
+      const double time = node->SelfProcessingTime() /
+                          std::max(1.0, node->parameter_value_or(
+                                            kParallelism, 1.0));
+      if (time > bottleneck_time) {
+        bottleneck = node;
+        bottleneck_time = time;
+      }
+    }
     for (auto input : node->inputs()) {
       queue.push_back(input);
     }
   }
+  if (bottleneck) {
+    VLOG(2) << "The bottleneck is " << bottleneck->long_name();
+    metrics::RecordTFDataBottleneck(bottleneck->name());
+  }
 }
 
 void Model::Optimize(AutotuneAlgorithm algorithm, int64 cpu_budget,
                      int64 ram_budget, double model_input_time) {
+  double untuned_bytes;
+  {
+    tf_shared_lock lock(mu_);
+    untuned_bytes = output_->TotalUntunedBufferedBytes();
+  }
+  if (untuned_bytes > 0) {
+    VLOG(2) << "Buffers that are not tuned hold " << untuned_bytes
+            << " bytes of the RAM budget of " << ram_budget << " bytes.";
+    ram_budget = std::max<int64>(0, ram_budget - untuned_bytes);
+  }
   switch (algorithm) {
     case AutotuneAlgorithm::HILL_CLIMB:
       OptimizeHillClimb(cpu_budget, ram_budget, model_input_time);
@@ -1470,9 +1555,20 @@ void Model::Optimize(AutotuneAlgorithm algorithm, int64 cpu_budget,
     case AutotuneAlgorithm::GRADIENT_DESCENT:
       OptimizeGradientDescent(cpu_budget, ram_budget, model_input_time);
       break;
+    case AutotuneAlgorithm::LEARNED:
+      OptimizeLearned(cpu_budget, ram_budget, model_input_time);
+      break;
   }
 }
 
+double Model::BufferedBytes() {
+  tf_shared_lock lock(mu_);
+  if (!output_) {
+    return 0;
+  }
+  return output_->TotalBufferedBytes() + output_->TotalUntunedBufferedBytes();
+}
+
 void Model::RemoveNode(std::shared_ptr<Node> node) {
   mutex_lock l(mu_);
   if (node) {
@@ -1655,6 +1751,200 @@ void Model::OptimizeHillClimb(int64 cpu_budget, int64 ram_budget,
   UpdateStateValues(&parameters);
 }
 
+void Model::OptimizeLearned(int64 cpu_budget, int64 ram_budget,
+                            double model_input_time) {
+  std::shared_ptr<Node> snapshot;
+  {
+    tf_shared_lock lock(mu_);
+    snapshot = output_->Snapshot();
+  }
+  VLOG(2) << "Starting optimization of tunable parameters with the learned "
+             "cost model.";
+  auto parameters = CollectTunableParameters(snapshot);
+  if (parameters.empty()) {
+    VLOG(2) << "The learned cost model optimization is terminated since no "
+               "node with tunable parameters has recorded elements.";
+    return;
+  }
+  const auto measured_ranges = FitLearnedEstimates(snapshot, parameters);
+
+  // A parameter change is applied only if it decreases the output time by at
+  // least this fraction, so that measurement noise does not move parameters.
+  constexpr double kMinImprovement = 0.01L;
+
+  // Maximum number of parameter changes per optimization round.
+  constexpr int64 kMaxIterations = 1000;
+
+  // Start from the values the input pipeline currently runs with, and bound
+  // the parallelism values to the measured ones and their neighbors.
+  absl::flat_hash_map<string, std::pair<double, double>> bounds;
+  for (auto& pair : parameters) {
+    auto& parameter = pair.second;
+    {
+      tf_shared_lock state_lock(*parameter->state->mu);
+      parameter->value = parameter->state->value == kAutotune
+                             ? parameter->min
+                             : parameter->state->value;
+    }
+    parameter->value =
+        std::min(std::max(parameter->value, parameter->min), parameter->max);
+    double lower = parameter->min;
+    double upper = parameter->max;
+    auto* range = gtl::FindOrNull(measured_ranges, pair.first);
+    if (range && parameter->name == kParallelism) {
+      lower = std::max(lower, std::min(range->first - 1, parameter->value));
+      upper = std::min(upper, std::max(range->second + 1, parameter->value));
+    }
+    bounds[pair.first] = std::make_pair(lower, upper);
+  }
+
+  auto total_parallelism = [&parameters]() {
+    double result = 0;
+    for (auto& pair : parameters) {
+      if (pair.second->name == kParallelism) {
+        result += pair.second->value;
+      }
+    }
+    return result;
+  };
+
+  for (int64 i = 0; i < kMaxIterations; ++i) {
+    const double output_time =
+        OutputTime(snapshot, model_input_time, /*gradients=*/nullptr);
+    const double buffered_bytes = TotalMaximumBufferedBytes(snapshot);
+    // While over the RAM budget, only look for changes releasing memory.
+    const bool over_ram_budget = buffered_bytes > ram_budget;
+    double best_output_time = output_time * (1.0L - kMinImprovement);
+    double best_buffered_bytes = buffered_bytes;
+    Parameter* best_parameter = nullptr;
+    double best_step = 0;
+    for (auto& pair : parameters) {
+      Parameter* parameter = pair.second.get();
+      const auto& bound = bounds[pair.first];
+      for (const double step : {-1.0L, 1.0L}) {
+        const double value = parameter->value + step;
+        if (value < bound.first || value > bound.second) {
+          continue;
+        }
+        if (step > 0 && parameter->name == kParallelism &&
+            total_parallelism() + step > cpu_budget) {
+          continue;
+        }
+        parameter->value = value;
+        const double new_output_time =
+            OutputTime(snapshot, model_input_time, /*gradients=*/nullptr);
+        const double new_buffered_bytes = TotalMaximumBufferedBytes(snapshot);
+        parameter->value -= step;
+        const bool better =
+            over_ram_budget ? new_buffered_bytes < best_buffered_bytes
+                            : new_buffered_bytes <= ram_budget &&
+                                  new_output_time < best_output_time;
+        if (better) {
+          best_output_time = new_output_time;
+          best_buffered_bytes = new_buffered_bytes;
+          best_parameter = parameter;
+          best_step = step;
+        }
+      }
+    }
+    if (!best_parameter) {
+      break;
+    }
+    best_parameter->value += best_step;
+  }
+  UpdateStateValues(&parameters);
+}
+
+absl::flat_hash_map<string, std::pair<double, double>>
+Model::FitLearnedEstimates(
+    std::shared_ptr<Node> snapshot,
+    const absl::flat_hash_map<string, std::shared_ptr<Parameter>>&
+        parameters) {
+  // Metrics covering fewer elements than this are too noisy to be recorded;
+  // they are accumulated until the next round instead.
+  constexpr int64 kMinElements = 10;
+
+  // Weight of the latest measurement in the moving averages.
+  constexpr double kSmoothing = 0.5L;
+
+  absl::flat_hash_map<string, std::pair<double, double>> measured_ranges;
+  mutex_lock l(learned_mu_);
+  ++learned_round_;
+  std::deque<std::shared_ptr<Node>> queue = {snapshot};
+  while (!queue.empty()) {
+    auto node = queue.front();
+    queue.pop_front();
+    for (auto& input : node->inputs()) {
+      queue.push_back(input);
+    }
+    NodeObservations& observations = observations_[node->long_name()];
+    observations.round = learned_round_;
+
+    double parallelism = 1;
+    auto* parameter = gtl::FindOrNull(parameters, node->long_name());
+    const bool has_parallelism =
+        parameter != nullptr && (*parameter)->name == kParallelism;
+    if (has_parallelism) {
+      tf_shared_lock state_lock(*(*parameter)->state->mu);
+      if ((*parameter)->state->value != kAutotune) {
+        parallelism = (*parameter)->state->value;
+      } else {
+        parallelism = (*parameter)->min;
+      }
+    }
+
+    const int64 processing_time = node->processing_time();
+    const int64 num_elements = node->num_elements();
+    const int64 bytes_produced = node->bytes_produced();
+    const int64 num_new_elements = num_elements - observations.num_elements;
+    if (num_new_elements >= kMinElements) {
+      const double time =
+          static_cast<double>(processing_time - observations.processing_time) /
+          num_new_elements;
+      auto result = observations.processing_times.emplace(
+          std::lround(parallelism), time);
+      if (!result.second) {
+        result.first->second += kSmoothing * (time - result.first->second);
+      }
+      const double size =
+          static_cast<double>(bytes_produced - observations.bytes_produced) /
+          num_new_elements;
+      if (observations.element_size == 0) {
+        observations.element_size = size;
+      } else {
+        observations.element_size +=
+            kSmoothing * (size - observations.element_size);
+      }
+      observations.processing_time = processing_time;
+      observations.num_elements = num_elements;
+      observations.bytes_produced = bytes_produced;
+    }
+
+    if (!observations.processing_times.empty()) {
+      node->set_self_processing_time_estimator(
+          [times = observations.processing_times](double parallelism) {
+            return InterpolateProcessingTime(times, parallelism);
+          });
+      if (has_parallelism) {
+        measured_ranges[node->long_name()] =
+            std::make_pair(observations.processing_times.begin()->first,
+                           observations.processing_times.rbegin()->first);
+      }
+    }
+    node->set_buffered_element_size_estimate(observations.element_size);
+  }
+
+  // Forget the nodes that have been removed from the pipeline.
+  for (auto it = observations_.begin(); it != observations_.end();) {
+    if (it->second.round != learned_round_) {
+      observations_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  return measured_ranges;
+}
+
 double Model::OutputTime(std::shared_ptr<Node> node, double model_input_time,
                          absl::flat_hash_map<string, double>* gradients) {
   // To store the input time for each node.
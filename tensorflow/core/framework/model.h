@@ -15,7 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_MODEL_H_
 #define TENSORFLOW_CORE_FRAMEWORK_MODEL_H_
 
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
 // TODO(b/114492873): Move this include into core/platform.
@@ -48,6 +50,7 @@ constexpr char kModelInputTimeKey[] = "model_input_time";
 enum class AutotuneAlgorithm {
   HILL_CLIMB = 0,
   GRADIENT_DESCENT = 1,
+  LEARNED = 2,
 };
 
 enum class TraversalOrder {
@@ -153,6 +156,7 @@ class Node {
         bytes_produced_(0),
         num_elements_(0),
         processing_time_(0),
+        wait_time_(0),
         record_metrics_(true),
         metrics_(name_),
         output_(args.output.get()) {}
@@ -194,6 +198,12 @@ class Node {
     processing_time_ += delta;
   }
 
+  // Increments the aggregate time consumers waited for elements of this node by
+  // the given delta.
+  void add_wait_time(int64 delta) TF_LOCKS_EXCLUDED(mu_) {
+    wait_time_ += delta;
+  }
+
   // Returns an indication whether autotuning is enabled for this node.
   bool autotune() const TF_LOCKS_EXCLUDED(mu_) {
     return autotune_;
@@ -257,11 +267,23 @@ class Node {
     return parameters_.at(name)->state->value;
   }
 
+  // Returns the parameter value, or `default_value` if the node does not have
+  // the parameter.
+  double parameter_value_or(const string& name, double default_value) const
+      TF_LOCKS_EXCLUDED(mu_) {
+    tf_shared_lock l(mu_);
+    auto it = parameters_.find(name);
+    return it == parameters_.end() ? default_value : it->second->state->value;
+  }
+
   // Returns the aggregate processing time.
   int64 processing_time() const TF_LOCKS_EXCLUDED(mu_) {
     return processing_time_;
   }
 
+  // Returns the aggregate time consumers waited for elements of this node.
+  int64 wait_time() const TF_LOCKS_EXCLUDED(mu_) { return wait_time_; }
+
   // Records that the node consumed the given number of bytes.
   void record_bytes_consumed(int64 num_bytes) { bytes_consumed_ += num_bytes; }
 
@@ -311,6 +333,23 @@ class Node {
     autotune_.store(autotune);
   }
 
+  // Replaces the recorded per-element self processing time of this node by
+  // `estimator(parallelism)`, where `parallelism` is the model value of the
+  // parallelism parameter of the node, or 1 if it has none. Passing an empty
+  // function restores the recorded value.
+  void set_self_processing_time_estimator(
+      std::function<double(double)> estimator) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    self_processing_time_estimator_ = std::move(estimator);
+  }
+
+  // Sets an estimate of the size of the elements buffered by this node, used
+  // as a lower bound of the recorded average size. Zero disables it.
+  void set_buffered_element_size_estimate(double size) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    buffered_element_size_estimate_ = size;
+  }
+
   // Given the average time between events when the elements in the buffer are
   // produced (`producer_time`), the average time between events when elements
   // in the buffer are consumed (`consumer_time`) and the buffer size, the
@@ -370,6 +409,11 @@ class Node {
   // would be used by the subtree nodes if all of their buffers were full.
   double TotalMaximumBufferedBytes() const TF_LOCKS_EXCLUDED(mu_);
 
+  // Returns the total number of bytes buffered in all nodes in the subtree
+  // whose buffer size is not tuned by the model, such as shuffle buffers,
+  // caches or buffers of transformations with a fixed buffer size.
+  double TotalUntunedBufferedBytes() const TF_LOCKS_EXCLUDED(mu_);
+
   // Returns the per-element CPU time spent in the subtree rooted in this node.
   // If `processing_times` is not `nullptr`, collects the per-element CPU time
   // spent in each node of the subtree.
@@ -385,9 +429,16 @@ class Node {
         : bytes_consumed_counter_(metrics::GetTFDataBytesConsumedCounter(name)),
           bytes_produced_counter_(metrics::GetTFDataBytesProducedCounter(name)),
           num_elements_counter_(metrics::GetTFDataElementsCounter(name)),
+          processing_time_counter_(
+              metrics::GetTFDataProcessingTimeCounter(name)),
+          wait_time_counter_(metrics::GetTFDataWaitTimeCounter(name)),
+          buffer_utilization_sampler_(
+              metrics::GetTFDataBufferUtilizationSampler(name)),
           recorded_bytes_consumed_(0),
           recorded_bytes_produced_(0),
-          recorded_num_elements_(0) {}
+          recorded_num_elements_(0),
+          recorded_processing_time_us_(0),
+          recorded_wait_time_us_(0) {}
 
     // Expects the total number of bytes consumed and records the delta since
     // last invocation.
@@ -413,13 +464,40 @@ class Node {
       num_elements_counter_->IncrementBy(delta);
     }
 
+    // Expects the total processing time in nanoseconds and records the delta
+    // since last invocation.
+    void record_processing_time(int64 total_nanos) {
+      const int64 total_us = total_nanos / EnvTime::kMicrosToNanos;
+      int64 delta =
+          total_us - recorded_processing_time_us_.exchange(total_us);
+      processing_time_counter_->IncrementBy(delta);
+    }
+
+    // Expects the total wait time in nanoseconds and records the delta since
+    // last invocation.
+    void record_wait_time(int64 total_nanos) {
+      const int64 total_us = total_nanos / EnvTime::kMicrosToNanos;
+      int64 delta = total_us - recorded_wait_time_us_.exchange(total_us);
+      wait_time_counter_->IncrementBy(delta);
+    }
+
+    // Records the current fraction of the buffer that holds elements.
+    void record_buffer_utilization(double utilization) {
+      buffer_utilization_sampler_->Add(utilization);
+    }
+
    private:
     monitoring::CounterCell* const bytes_consumed_counter_;
     monitoring::CounterCell* const bytes_produced_counter_;
     monitoring::CounterCell* const num_elements_counter_;
+    monitoring::CounterCell* const processing_time_counter_;
+    monitoring::CounterCell* const wait_time_counter_;
+    monitoring::SamplerCell* const buffer_utilization_sampler_;
     std::atomic<int64> recorded_bytes_consumed_;
     std::atomic<int64> recorded_bytes_produced_;
     std::atomic<int64> recorded_num_elements_;
+    std::atomic<int64> recorded_processing_time_us_;
+    std::atomic<int64> recorded_wait_time_us_;
   };
 
   // Returns the number of inputs.
@@ -527,6 +605,9 @@ class Node {
       absl::flat_hash_map<string, double>* total_bytes) const
       TF_SHARED_LOCKS_REQUIRED(mu_);
 
+  // Returns whether the size of the buffer of the node is tuned by the model.
+  bool HasTunedBuffer() const TF_SHARED_LOCKS_REQUIRED(mu_);
+
   // Compute and return the maximum buffered bytes on the node itself. By
   // default non-tunable nodes are assumed not to buffer any bytes, so the
   // tunable nodes as subclasses are expected to override this method to ensure
@@ -558,11 +639,19 @@ class Node {
   std::atomic<int64> bytes_produced_;
   std::atomic<int64> num_elements_;
   std::atomic<int64> processing_time_;
+  std::atomic<int64> wait_time_;
   std::atomic<bool> record_metrics_;
   Metrics metrics_;
   absl::flat_hash_map<string, std::shared_ptr<Parameter>> parameters_
       TF_GUARDED_BY(mu_);
 
+  // Estimates replacing the recorded metrics when set, see
+  // `set_self_processing_time_estimator()` and
+  // `set_buffered_element_size_estimate()`.
+  std::function<double(double)> self_processing_time_estimator_
+      TF_GUARDED_BY(mu_);
+  double buffered_element_size_estimate_ TF_GUARDED_BY(mu_) = 0.0L;
+
   // Statistic of inputs processing time history.
   double input_processing_time_sum_ = 0.0L;
   int64 input_processing_time_count_ = 0;
@@ -636,9 +725,17 @@ class Model {
   void FlushMetrics() TF_LOCKS_EXCLUDED(mu_);
 
   // Uses the given algorithm to perform the autotuning optimization.
+  //
+  // The `ram_budget` applies to all buffers of the input pipeline. Buffers
+  // whose size is not tuned count against the budget, and the sizes of the
+  // tuned buffers are chosen to fit in the remainder.
   void Optimize(AutotuneAlgorithm algorithm, int64 cpu_budget, int64 ram_budget,
                 double model_input_time) TF_LOCKS_EXCLUDED(mu_);
 
+  // Returns the number of bytes currently buffered by all nodes of the model,
+  // whether their buffer size is tuned or not.
+  double BufferedBytes() TF_LOCKS_EXCLUDED(mu_);
+
   // Removes the given node.
   void RemoveNode(std::shared_ptr<Node> node) TF_LOCKS_EXCLUDED(mu_);
 
@@ -679,6 +776,30 @@ class Model {
   void OptimizeGradientDescent(int64 cpu_budget, int64 ram_budget,
                                double model_input_time);
 
+  // This optimization algorithm replaces the analytic estimates of per-element
+  // processing time and buffered element size with estimates fitted on the
+  // metrics recorded between consecutive optimization rounds, for each value
+  // of parallelism a node has run with. Starting from the current parameter
+  // values, it then repeatedly applies the unit change of a parameter that
+  // decreases the output time the most, while the total parallelism stays
+  // within the CPU budget and the buffers within the RAM budget. Parallelism
+  // parameters move at most one step away from the values that have been
+  // measured, so that every round explores the neighborhood of the best known
+  // configuration instead of trusting extrapolated estimates.
+  void OptimizeLearned(int64 cpu_budget, int64 ram_budget,
+                       double model_input_time);
+
+  // Records the metrics of the nodes of `snapshot` since the last
+  // `OptimizeLearned` round, keyed by the current value of the tunable
+  // parallelism parameter of the node in `parameters`, and installs the
+  // fitted estimates on the nodes.
+  // Returns, for each node with a parallelism parameter, the range of
+  // parallelism values it has been measured with.
+  absl::flat_hash_map<string, std::pair<double, double>> FitLearnedEstimates(
+      std::shared_ptr<Node> snapshot,
+      const absl::flat_hash_map<string, std::shared_ptr<Parameter>>&
+          parameters) TF_LOCKS_EXCLUDED(learned_mu_);
+
   // Collects the output time and if `gradients` is not `nullptr`, the output
   // time gradient w.r.t. tunable parameters of the subtree rooted in the given
   // node.
@@ -712,6 +833,28 @@ class Model {
   // tunable parameter (because the information is used for tuning the value of
   // the parameter) and never stops.
   std::atomic<bool> collect_resource_usage_;
+
+  // Metrics of a node accumulated by the `LEARNED` algorithm.
+  struct NodeObservations {
+    // Recorded totals of the node at the last optimization round.
+    int64 processing_time = 0;
+    int64 num_elements = 0;
+    int64 bytes_produced = 0;
+    // Moving average of the per-element self processing time, for each
+    // parallelism the node has run with.
+    std::map<int64, double> processing_times;
+    // Moving average of the size of the elements produced.
+    double element_size = 0.0L;
+    // Optimization round in which the node was last seen.
+    int64 round = 0;
+  };
+
+  // Guards the state of the `LEARNED` algorithm, which is kept across calls
+  // to `Optimize`.
+  mutex learned_mu_;
+  absl::flat_hash_map<string, NodeObservations> observations_
+      TF_GUARDED_BY(learned_mu_);
+  int64 learned_round_ TF_GUARDED_BY(learned_mu_) = 0;
 };
 
 }  // namespace model
@@ -481,6 +481,34 @@ TEST(BufferedBytesTest, Node) {
   EXPECT_EQ(node->inputs().size(), 0);
 }
 
+TEST(UntunedBufferedBytesTest, Node) {
+  std::shared_ptr<Node> node = model::MakeAsyncKnownRatioNode(
+      {0, "TunedNode", nullptr}, 1,
+      {model::MakeParameter(
+          "buffer_size",
+          std::make_shared<SharedState>(/*value=*/3, nullptr, nullptr),
+          /*min=*/1, /*max=*/7)});
+  std::shared_ptr<Node> input =
+      model::MakeKnownRatioNode({1, "UntunedInput", node}, 1);
+  node->add_input(input);
+  std::shared_ptr<Node> source = model::MakeSourceNode({2, "Source", input});
+  input->add_input(source);
+
+  node->record_buffer_event(20, 1);
+  input->record_buffer_event(30, 1);
+  source->record_buffer_event(5, 1);
+  EXPECT_EQ(node->TotalBufferedBytes(), 20);
+  EXPECT_EQ(node->TotalUntunedBufferedBytes(), 35);
+  EXPECT_EQ(input->TotalUntunedBufferedBytes(), 35);
+
+  // Buffers of nodes for which autotuning is disabled are not tuned.
+  node->set_autotune(false);
+  EXPECT_EQ(node->TotalUntunedBufferedBytes(), 55);
+
+  input->remove_input(source);
+  node->remove_input(input);
+}
+
 // Returns a weighted sum of a prior and the actual processing time.
 double weighted_processing_time(int64 num_elements, double processing_time,
                                 double prior) {
@@ -1032,7 +1060,90 @@ TEST_P(OptimizeZeroRamBudgetTest, Model) {
 }
 
 INSTANTIATE_TEST_SUITE_P(Test, OptimizeZeroRamBudgetTest,
-                         ::testing::Values(0, 1));
+                         ::testing::Values(0, 1, 2));
+
+// The per-element processing time grows quadratically with the parallelism,
+// e.g. because of lock contention, so that the analytic model overestimates
+// the benefit of parallelism and the output time is minimal for parallelism 2.
+TEST(OptimizeLearnedTest, Model) {
+  auto processing_time = [](int64 parallelism) {
+    return 100 + 30 * (parallelism - 1) * (parallelism - 1);
+  };
+
+  std::shared_ptr<mutex> mutex1 = std::make_shared<mutex>();
+  std::shared_ptr<condition_variable> cv1 =
+      std::make_shared<condition_variable>();
+  std::shared_ptr<Node> node1 = model::MakeAsyncKnownRatioNode(
+      {1, "1", nullptr}, 1,
+      {model::MakeParameter("parallelism",
+                            std::make_shared<SharedState>(
+                                /*value=*/model::kAutotune, mutex1, cv1),
+                            /*min=*/1, /*max=*/8)});
+  model::Model model;
+  model.AddNode([&node1](model::Node::Args args) { return node1; }, "1",
+                nullptr, &node1);
+
+  // Each round runs the node with the parallelism chosen by the previous one,
+  // which explores parallelism 1, 2 and 3 before settling on 2.
+  const std::vector<int64> expected_parallelism = {2, 3, 2, 2, 2};
+  for (int64 expected : expected_parallelism) {
+    const int64 parallelism =
+        node1->parameter_value("parallelism") == model::kAutotune
+            ? 1
+            : node1->parameter_value("parallelism");
+    for (int i = 0; i < 100; ++i) {
+      node1->add_processing_time(processing_time(parallelism));
+      node1->record_bytes_produced(10);
+      node1->record_element();
+    }
+    model.Optimize(model::AutotuneAlgorithm::LEARNED, /*cpu_budget=*/40,
+                   /*ram_budget=*/1000, /*model_input_time=*/0);
+    EXPECT_EQ(node1->parameter_value("parallelism"), expected);
+  }
+
+  // The measured element size bounds the buffers by the RAM budget.
+  model.Optimize(model::AutotuneAlgorithm::LEARNED, /*cpu_budget=*/40,
+                 /*ram_budget=*/10, /*model_input_time=*/0);
+  EXPECT_EQ(node1->parameter_value("parallelism"), 1);
+}
+
+TEST(FlushMetricsTest, Model) {
+  std::shared_ptr<mutex> mutex1 = std::make_shared<mutex>();
+  std::shared_ptr<condition_variable> cv1 =
+      std::make_shared<condition_variable>();
+  std::shared_ptr<Node> node1 = model::MakeAsyncKnownRatioNode(
+      {1, "FlushMetricsAsync", nullptr}, 1,
+      {model::MakeParameter(
+          "buffer_size",
+          std::make_shared<SharedState>(/*value=*/4, mutex1, cv1),
+          /*min=*/1, /*max=*/8)});
+  model::Model model;
+  model.AddNode([&node1](model::Node::Args args) { return node1; },
+                "FlushMetricsAsync", nullptr, &node1);
+  node1->add_processing_time(3000);
+  node1->add_wait_time(5000);
+  node1->record_buffer_event(/*bytes_delta=*/10, /*elements_delta=*/2);
+  node1->record_element();
+
+  model.FlushMetrics();
+  EXPECT_EQ(metrics::GetTFDataProcessingTimeCounter("FlushMetricsAsync")
+                ->value(),
+            3);
+  EXPECT_EQ(metrics::GetTFDataWaitTimeCounter("FlushMetricsAsync")->value(),
+            5);
+  HistogramProto utilization =
+      metrics::GetTFDataBufferUtilizationSampler("FlushMetricsAsync")
+          ->value();
+  EXPECT_EQ(utilization.num(), 1);
+  EXPECT_EQ(utilization.sum(), 0.5);
+
+  // Only the time recorded since the last flush is added to the counters.
+  node1->add_processing_time(2000);
+  model.FlushMetrics();
+  EXPECT_EQ(metrics::GetTFDataProcessingTimeCounter("FlushMetricsAsync")
+                ->value(),
+            5);
+}
 
 TEST(RecordTimeTest, RecordTimeTest) {
   std::shared_ptr<Node> source = model::MakeSourceNode({});
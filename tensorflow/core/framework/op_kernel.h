@@ -302,6 +302,10 @@ class OpKernelConstruction {
   // User-supplied configuration of this operation.
   const NodeDef& def() const { return props_->node_def; }
 
+  // The properties def() belongs to. Holding a copy keeps def() alive after
+  // kernel construction.
+  const std::shared_ptr<const NodeProperties>& props() const { return props_; }
+
   // For inspecting the inputs to this operation.
   int num_inputs() const { return props_->input_types.size(); }
   DataType input_type(int i) const { return props_->input_types[i]; }
@@ -704,6 +708,12 @@ class OpKernelContext {
     // For implementing `OpKernelContext::output_required()`. If null, all
     // outputs are required.
     bool* outputs_required_array = nullptr;
+
+    // Array indexed by output number of the allocators to use for the outputs
+    // allocated with `allocate_output()` instead of the device allocator. Used
+    // by the executor to place outputs into a pre-planned arena. If null, or
+    // for null entries, the outputs are allocated from the device.
+    Allocator* const* output_allocators = nullptr;
   };
 
   // params must outlive the OpKernelContext.
@@ -1276,6 +1286,10 @@ class OpKernelContext {
                          Tensor* out_tensor, AllocatorAttributes allocator_attr,
                          const AllocationAttributes& allocation_attr);
 
+  Status allocate_tensor(Allocator* a, DataType type, const TensorShape& shape,
+                         Tensor* out_tensor,
+                         const AllocationAttributes& allocation_attr);
+
   // Helpers for `set_output()`.
 
   // Returns `true` if the tensor was copied into an allocated output.
@@ -77,6 +77,7 @@ Status ValidateDevice(OpKernelContext* ctx, const ResourceHandle& p) {
 
 Status ResourceMgr::InsertDebugTypeName(uint64 hash_code,
                                         const string& type_name) {
+  mutex_lock l(debug_type_names_mu_);
   auto iter = debug_type_names_.emplace(hash_code, type_name);
   if (iter.first->second != type_name) {
     return errors::AlreadyExists("Duplicate hash code found for type ",
@@ -86,6 +87,8 @@ Status ResourceMgr::InsertDebugTypeName(uint64 hash_code,
 }
 
 const char* ResourceMgr::DebugTypeName(uint64 hash_code) const {
+  // Entries are never removed, so the returned name outlives the lock.
+  mutex_lock l(debug_type_names_mu_);
   auto type_name_iter = debug_type_names_.find(hash_code);
   if (type_name_iter == debug_type_names_.end()) {
     return "<unknown>";
@@ -126,52 +129,51 @@ ResourceMgr::~ResourceMgr() { Clear(); }
 void ResourceMgr::Clear() {
   // We do the deallocation outside of the lock to avoid a potential deadlock
   // in case any of the destructors access the resource manager.
-  std::unordered_map<string, Container*> tmp_containers;
+  std::vector<Container*> tmp_containers;
   {
-    mutex_lock l(mu_);
-    tmp_containers = std::move(containers_);
+    mutex_lock l(container_names_mu_);
+    container_names_.clear();
   }
-  for (const auto& p : tmp_containers) {
-    delete p.second;
+  for (Shard& shard : shards_) {
+    mutex_lock l(shard.mu);
+    for (const auto& p : shard.containers) {
+      tmp_containers.push_back(p.second);
+    }
+    shard.containers.clear();
+  }
+  for (Container* container : tmp_containers) {
+    delete container;
   }
-  tmp_containers.clear();
 }
 
 string ResourceMgr::DebugString() const {
-  mutex_lock l(mu_);
-  struct Line {
-    const string* container;
-    const string type;
-    const string* resource;
-    const string detail;
-  };
-  std::vector<Line> lines;
-  for (const auto& p : containers_) {
-    const string& container = p.first;
-    for (const auto& q : *p.second) {
-      const Key& key = q.first;
-      const char* type = DebugTypeName(key.first);
-      Line l{&container, port::Demangle(type), q.second.name.get(),
-             q.second.resource->DebugString()};
-      lines.push_back(l);
-    }
-  }
   std::vector<string> text;
-  text.reserve(lines.size());
-  for (const Line& line : lines) {
-    text.push_back(strings::Printf(
-        "%-20s | %-40s | %-40s | %-s", line.container->c_str(),
-        line.type.c_str(), line.resource->c_str(), line.detail.c_str()));
+  for (const Shard& shard : shards_) {
+    tf_shared_lock l(shard.mu);
+    for (const auto& p : shard.containers) {
+      const string& container = p.first;
+      for (const auto& q : *p.second) {
+        const Key& key = q.first;
+        const string type = port::Demangle(DebugTypeName(key.first));
+        text.push_back(strings::Printf(
+            "%-20s | %-40s | %-40s | %-s", container.c_str(), type.c_str(),
+            q.second.name->c_str(),
+            q.second.resource->DebugString().c_str()));
+      }
+    }
   }
   std::sort(text.begin(), text.end());
   return absl::StrJoin(text, "\n");
 }
 
-Status ResourceMgr::DoCreate(const string& container, TypeIndex type,
-                             const string& name, ResourceBase* resource) {
-  Container** b = &containers_[container];
+Status ResourceMgr::DoCreate(Shard* shard, const string& container,
+                             TypeIndex type, const string& name,
+                             ResourceBase* resource) {
+  Container** b = &shard->containers[container];
   if (*b == nullptr) {
     *b = new Container;
+    mutex_lock l(container_names_mu_);
+    container_names_.insert(container);
   }
 
   // NOTE: Separating out the construction of the map key and value so that the
@@ -189,15 +191,31 @@ Status ResourceMgr::DoCreate(const string& container, TypeIndex type,
                                type.name());
 }
 
-Status ResourceMgr::DoLookup(const string& container, TypeIndex type,
-                             const string& name,
-                             ResourceBase** resource) const {
-  const Container* b = gtl::FindPtrOrNull(containers_, container);
-  if (b == nullptr) {
+Status ResourceMgr::MissingResourceError(const string& container,
+                                         const string& name,
+                                         const string& type_name) const {
+  bool container_exists;
+  {
+    mutex_lock l(container_names_mu_);
+    container_exists = container_names_.count(container) > 0;
+  }
+  if (!container_exists) {
     return errors::NotFound("Container ", container,
                             " does not exist. (Could not find resource: ",
                             container, "/", name, ")");
   }
+  return errors::NotFound("Resource ", container, "/", name, "/", type_name,
+                          " does not exist.");
+}
+
+Status ResourceMgr::DoLookup(const Shard& shard, const string& container,
+                             TypeIndex type, const string& name,
+                             ResourceBase** resource) const {
+  const Container* b = gtl::FindPtrOrNull(shard.containers, container);
+  if (b == nullptr) {
+    // The container may still hold resources in other shards.
+    return MissingResourceError(container, name, type.name());
+  }
   auto iter = b->find({type.hash_code(), name});
   if (iter == b->end()) {
     return errors::NotFound("Resource ", container, "/", name, "/", type.name(),
@@ -213,10 +231,11 @@ Status ResourceMgr::DoDelete(const string& container, uint64 type_hash_code,
                              const string& type_name) {
   ResourceAndName resource_and_name;
   {
-    mutex_lock l(mu_);
-    Container* b = gtl::FindPtrOrNull(containers_, container);
+    Shard* shard = GetShard(type_hash_code, resource_name);
+    mutex_lock l(shard->mu);
+    Container* b = gtl::FindPtrOrNull(shard->containers, container);
     if (b == nullptr) {
-      return errors::NotFound("Container ", container, " does not exist.");
+      return MissingResourceError(container, resource_name, type_name);
     }
     auto iter = b->find({type_hash_code, resource_name});
     if (iter == b->end()) {
@@ -242,25 +261,24 @@ Status ResourceMgr::Delete(const ResourceHandle& handle) {
 
 Status ResourceMgr::Cleanup(const string& container) {
   {
-    tf_shared_lock l(mu_);
-    if (!gtl::FindOrNull(containers_, container)) {
-      // Nothing to cleanup.
+    mutex_lock l(container_names_mu_);
+    if (container_names_.erase(container) == 0) {
+      // Nothing to cleanup, it's OK (possibly a concurrent cleanup).
       return Status::OK();
     }
   }
-  Container* b = nullptr;
-  {
-    mutex_lock l(mu_);
-    auto iter = containers_.find(container);
-    if (iter == containers_.end()) {
-      // Nothing to cleanup, it's OK (concurrent cleanup).
-      return Status::OK();
+  for (Shard& shard : shards_) {
+    Container* b = nullptr;
+    {
+      mutex_lock l(shard.mu);
+      auto iter = shard.containers.find(container);
+      if (iter == shard.containers.end()) continue;
+      b = iter->second;
+      shard.containers.erase(iter);
     }
-    b = iter->second;
-    containers_.erase(iter);
+    // Delete outside of the lock, in case a destructor accesses *this.
+    delete b;
   }
-  CHECK(b != nullptr);
-  delete b;
   return Status::OK();
 }
 
@@ -16,11 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 
+#include <array>
 #include <memory>
 #include <string>
 #include <typeindex>
 #include <typeinfo>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
@@ -181,9 +183,9 @@ class ResourceMgr {
   Status Lookup(const std::string& container, const std::string& name,
                 T** resource) const TF_MUST_USE_RESULT;
 
-  // Similar to Lookup, but looks up multiple resources at once, with only a
-  // single lock acquisition.  If containers_and_names[i] is uninitialized
-  // then this function does not modify resources[i].
+  // Similar to Lookup, but looks up multiple resources at once.  If
+  // containers_and_names[i] is uninitialized then this function does not
+  // modify resources[i].
   template <typename T, bool use_dynamic_cast = false>
   Status LookupMany(absl::Span<std::pair<const string*, const string*> const>
                         containers_and_names,
@@ -252,22 +254,50 @@ class ResourceMgr {
   };
   typedef std::unordered_map<Key, ResourceAndName, KeyHash, KeyEqual> Container;
 
+  // Resources are spread over shards by type and name. Each shard has its own
+  // lock and its own part of every container, so that concurrent lookups of
+  // different resources, e.g. by ReadVariableOp, do not contend on one lock.
+  static constexpr int kNumShards = 16;
+  struct Shard {
+    mutable mutex mu;
+    std::unordered_map<string, Container*> containers TF_GUARDED_BY(mu);
+  };
+
+  // Returns the shard holding the resources of type `type_hash_code` named
+  // `name`, in all containers.
+  Shard* GetShard(uint64 type_hash_code, const std::string& name) const {
+    return &shards_[Hash64(name.data(), name.size(), type_hash_code) %
+                    kNumShards];
+  }
+
   const std::string default_container_;
-  mutable mutex mu_;
-  std::unordered_map<string, Container*> containers_ TF_GUARDED_BY(mu_);
+  mutable std::array<Shard, kNumShards> shards_;
+
+  // Names of the containers that exist in any shard, used to tell missing
+  // containers from missing resources in error messages.
+  mutable mutex container_names_mu_;
+  std::unordered_set<string> container_names_
+      TF_GUARDED_BY(container_names_mu_);
 
   template <typename T, bool use_dynamic_cast = false>
-  Status LookupInternal(const std::string& container, const std::string& name,
-                        T** resource) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+  Status LookupInternal(const Shard& shard, const std::string& container,
+                        const std::string& name, T** resource) const
+      TF_SHARED_LOCKS_REQUIRED(shard.mu) TF_MUST_USE_RESULT;
 
-  Status DoCreate(const std::string& container, TypeIndex type,
+  Status DoCreate(Shard* shard, const std::string& container, TypeIndex type,
                   const std::string& name, ResourceBase* resource)
-      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+      TF_EXCLUSIVE_LOCKS_REQUIRED(shard->mu) TF_MUST_USE_RESULT;
+
+  Status DoLookup(const Shard& shard, const std::string& container,
+                  TypeIndex type, const std::string& name,
+                  ResourceBase** resource) const
+      TF_SHARED_LOCKS_REQUIRED(shard.mu) TF_MUST_USE_RESULT;
 
-  Status DoLookup(const std::string& container, TypeIndex type,
-                  const std::string& name, ResourceBase** resource) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+  // Returns the error for a lookup of `container`/`name` that is not in the
+  // container part of its shard.
+  Status MissingResourceError(const std::string& container,
+                              const std::string& name,
+                              const std::string& type_name) const;
 
   Status DoDelete(const std::string& container, uint64 type_hash_code,
                   const std::string& resource_name,
@@ -277,16 +307,18 @@ class ResourceMgr {
 
   // Inserts the type name for 'hash_code' into the hash_code to type name map.
   Status InsertDebugTypeName(uint64 hash_code, const std::string& type_name)
-      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+      TF_LOCKS_EXCLUDED(debug_type_names_mu_) TF_MUST_USE_RESULT;
 
   // Returns the type name for the 'hash_code'.
   // Returns "<unknown>" if a resource with such a type was never inserted into
   // the container.
   const char* DebugTypeName(uint64 hash_code) const
-      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+      TF_LOCKS_EXCLUDED(debug_type_names_mu_);
 
   // Map from type hash_code to type name.
-  std::unordered_map<uint64, string> debug_type_names_ TF_GUARDED_BY(mu_);
+  mutable mutex debug_type_names_mu_;
+  std::unordered_map<uint64, string> debug_type_names_
+      TF_GUARDED_BY(debug_type_names_mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(ResourceMgr);
 };
@@ -593,16 +625,20 @@ Status ResourceMgr::Create(const std::string& container,
                            const std::string& name, T* resource) {
   CheckDeriveFromResourceBase<T>();
   CHECK(resource != nullptr);
-  mutex_lock l(mu_);
-  return DoCreate(container, TypeIndex::Make<T>(), name, resource);
+  const TypeIndex type = TypeIndex::Make<T>();
+  Shard* shard = GetShard(type.hash_code(), name);
+  mutex_lock l(shard->mu);
+  return DoCreate(shard, container, type, name, resource);
 }
 
 template <typename T, bool use_dynamic_cast>
 Status ResourceMgr::Lookup(const std::string& container,
                            const std::string& name, T** resource) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
-  return LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  const Shard* shard = GetShard(TypeIndex::Make<T>().hash_code(), name);
+  tf_shared_lock l(shard->mu);
+  return LookupInternal<T, use_dynamic_cast>(*shard, container, name,
+                                             resource);
 }
 
 template <typename T, bool use_dynamic_cast>
@@ -611,13 +647,16 @@ Status ResourceMgr::LookupMany(
         containers_and_names,
     std::vector<std::unique_ptr<T, core::RefCountDeleter>>* resources) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
+  const uint64 type_hash_code = TypeIndex::Make<T>().hash_code();
   resources->resize(containers_and_names.size());
   for (size_t i = 0; i < containers_and_names.size(); ++i) {
+    const Shard* shard =
+        GetShard(type_hash_code, *containers_and_names[i].second);
+    tf_shared_lock l(shard->mu);
     T* resource;
     Status s = LookupInternal<T, use_dynamic_cast>(
-        *containers_and_names[i].first, *containers_and_names[i].second,
-        &resource);
+        *shard, *containers_and_names[i].first,
+        *containers_and_names[i].second, &resource);
     if (s.ok()) {
       (*resources)[i].reset(resource);
     }
@@ -637,11 +676,12 @@ struct TypeCastFunctor<T, true> {
 };
 
 template <typename T, bool use_dynamic_cast>
-Status ResourceMgr::LookupInternal(const std::string& container,
+Status ResourceMgr::LookupInternal(const Shard& shard,
+                                   const std::string& container,
                                    const std::string& name,
                                    T** resource) const {
   ResourceBase* found = nullptr;
-  Status s = DoLookup(container, TypeIndex::Make<T>(), name, &found);
+  Status s = DoLookup(shard, container, TypeIndex::Make<T>(), name, &found);
   if (s.ok()) {
     // It's safe to down cast 'found' to T* since
     // typeid(T).hash_code() is part of the map key.
@@ -656,17 +696,19 @@ Status ResourceMgr::LookupOrCreate(const std::string& container,
                                    std::function<Status(T**)> creator) {
   CheckDeriveFromResourceBase<T>();
   *resource = nullptr;
+  const TypeIndex type = TypeIndex::Make<T>();
+  Shard* shard = GetShard(type.hash_code(), name);
   Status s;
   {
-    tf_shared_lock l(mu_);
-    s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+    tf_shared_lock l(shard->mu);
+    s = LookupInternal<T, use_dynamic_cast>(*shard, container, name, resource);
     if (s.ok()) return s;
   }
-  mutex_lock l(mu_);
-  s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  mutex_lock l(shard->mu);
+  s = LookupInternal<T, use_dynamic_cast>(*shard, container, name, resource);
   if (s.ok()) return s;
   TF_RETURN_IF_ERROR(creator(resource));
-  s = DoCreate(container, TypeIndex::Make<T>(), name, *resource);
+  s = DoCreate(shard, container, type, name, *resource);
   if (!s.ok()) {
     return errors::Internal("LookupOrCreate failed unexpectedly");
   }
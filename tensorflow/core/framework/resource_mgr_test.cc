@@ -129,6 +129,45 @@ TEST(ResourceMgrTest, Basic) {
   TF_CHECK_OK(rm.Cleanup("bar"));
 }
 
+TEST(ResourceMgrTest, ManyResources) {
+  // Enough resources to cover every shard of the manager.
+  ResourceMgr rm;
+  for (int i = 0; i < 100; ++i) {
+    TF_CHECK_OK(rm.Create("foo", strings::StrCat("r", i),
+                          new Resource(strings::StrCat(i))));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(strings::StrCat("R/", i),
+              Find<Resource>(rm, "foo", strings::StrCat("r", i)));
+  }
+  std::vector<string> names = {"r0", "r99", "xxx"};
+  std::vector<std::pair<const string*, const string*>> containers_and_names;
+  const string container = "foo";
+  for (const string& name : names) {
+    containers_and_names.emplace_back(&container, &name);
+  }
+  std::vector<std::unique_ptr<Resource, core::RefCountDeleter>> resources;
+  TF_CHECK_OK(rm.LookupMany<Resource>(containers_and_names, &resources));
+  ASSERT_EQ(resources.size(), 3);
+  EXPECT_EQ(resources[0]->DebugString(), "R/0");
+  EXPECT_EQ(resources[1]->DebugString(), "R/99");
+  EXPECT_TRUE(resources[2] == nullptr);
+
+  // Missing resources are reported as such, whichever shard they map to.
+  for (int i = 100; i < 200; ++i) {
+    HasError(FindErr<Resource>(rm, "foo", strings::StrCat("r", i)),
+             "Not found: Resource foo/r");
+  }
+
+  // Cleanup drops the container from all shards.
+  TF_CHECK_OK(rm.Cleanup("foo"));
+  for (int i = 0; i < 100; ++i) {
+    HasError(FindErr<Resource>(rm, "foo", strings::StrCat("r", i)),
+             "Not found: Container foo");
+  }
+  EXPECT_EQ(rm.DebugString(), "");
+}
+
 TEST(ResourceMgrTest, CreateOrLookup) {
   ResourceMgr rm;
   EXPECT_EQ("R/cat", LookupOrCreate<Resource>(&rm, "foo", "bar", "cat"));
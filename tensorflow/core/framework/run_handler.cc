@@ -23,6 +23,7 @@ limitations under the License.
 #include <memory>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/run_handler_util.h"
 #include "tensorflow/core/lib/core/threadpool_interface.h"
 #include "tensorflow/core/lib/strings/strcat.h"
@@ -44,6 +45,15 @@ static constexpr int32 kMaxConcurrentHandlers = 128;
 typedef typename internal::RunHandlerEnvironment::Task Task;
 typedef Eigen::RunQueue<Task, 1024> Queue;
 
+// Whether threads look for the work of requests with a higher priority than
+// the requests they are assigned to before each task, so that lower priority
+// work is preempted at task (e.g. intra op shard) boundaries.
+bool PreemptLowerPriorityWork() {
+  static const bool preempt = ParamFromEnvBoolWithDefault(
+      "TF_RUN_HANDLER_PREEMPT_LOWER_PRIORITY_WORK", true);
+  return preempt;
+}
+
 }  // namespace
 
 namespace internal {
@@ -131,6 +141,7 @@ ThreadWorkSource::ThreadWorkSource()
       blocking_inflight_(0),
       non_blocking_inflight_(0),
       traceme_id_(0),
+      priority_(0),
       version_(0),
       sub_thread_pool_waiter_(nullptr) {
   queue_waiters_.next = &queue_waiters_;
@@ -260,6 +271,12 @@ int64 ThreadWorkSource::GetTracemeId() {
 
 void ThreadWorkSource::SetTracemeId(int64 value) { traceme_id_ = value; }
 
+int64 ThreadWorkSource::GetPriority() {
+  return priority_.load(std::memory_order_relaxed);
+}
+
+void ThreadWorkSource::SetPriority(int64 value) { priority_ = value; }
+
 void ThreadWorkSource::SetWaiter(uint64 version, Waiter* waiter, mutex* mutex) {
   {
     tf_shared_lock lock(run_handler_waiter_mu_);
@@ -334,7 +351,9 @@ RunHandlerThreadPool::RunHandlerThreadPool(
           std::vector<double>({0, 0.4}))),
       sub_thread_pool_end_request_percentage_(ParamFromEnvWithDefault(
           "TF_RUN_HANDLER_SUB_THREAD_POOL_END_REQUEST_PERCENTAGE",
-          std::vector<double>({0.4, 1}))) {
+          std::vector<double>({0.4, 1}))),
+      spin_budget_micros_(static_cast<int64>(
+          ParamFromEnvWithDefault("TF_RUN_HANDLER_SPIN_BUDGET_MICROS", 0.0))) {
   thread_data_.resize(num_threads_);
   VLOG(1) << "Creating RunHandlerThreadPool " << name << " with  "
           << num_blocking_threads_ << " blocking threads and "
@@ -408,12 +427,28 @@ void RunHandlerThreadPool::SetThreadWorkSources(
     return;
   }
   thread_data_[tid].new_thread_work_sources->resize(0);
+  thread_data_[tid].new_start_request_index = 0;
   if (use_sub_thread_pool_) {
     for (int i = 0; i < thread_work_sources.size(); ++i) {
       thread_data_[tid].new_thread_work_sources->emplace_back(
           thread_work_sources[i]);
     }
   } else {
+    // Requests with a higher priority than the start request are attempted
+    // before it. thread_work_sources is sorted by decreasing priority.
+    const int64 start_priority =
+        thread_work_sources[start_request_idx]->GetPriority();
+    int num_higher_priority_requests = 0;
+    if (PreemptLowerPriorityWork()) {
+      while (num_higher_priority_requests < start_request_idx &&
+             thread_work_sources[num_higher_priority_requests]->GetPriority() >
+                 start_priority) {
+        thread_data_[tid].new_thread_work_sources->emplace_back(
+            thread_work_sources[num_higher_priority_requests]);
+        ++num_higher_priority_requests;
+      }
+    }
+    thread_data_[tid].new_start_request_index = num_higher_priority_requests;
     thread_data_[tid].new_thread_work_sources->emplace_back(
         thread_work_sources[start_request_idx]);
     // The number of shards for the queue. Threads in each shard will
@@ -429,7 +464,7 @@ void RunHandlerThreadPool::SetThreadWorkSources(
     int token = tid % num_shards;
     for (int i = 0; i < num_shards; ++i) {
       for (int j = token; j < thread_work_sources.size(); j += num_shards) {
-        if (j != start_request_idx) {
+        if (j != start_request_idx && j >= num_higher_priority_requests) {
           thread_data_[tid].new_thread_work_sources->emplace_back(
               thread_work_sources[j]);
         }
@@ -468,15 +503,19 @@ int RunHandlerThreadPool::NumNonBlockingThreads() const {
 RunHandlerThreadPool::ThreadData::ThreadData()
     : new_version(0),
       current_index(0),
+      new_start_request_index(0),
       new_thread_work_sources(
           new Eigen::MaxSizeVector<ThreadWorkSource*>(static_cast<int32>(
               ParamFromEnvWithDefault("TF_RUN_HANDLER_MAX_CONCURRENT_HANDLERS",
                                       kMaxConcurrentHandlers)))),
       current_version(0),
+      current_start_request_index(0),
       current_thread_work_sources(
           new Eigen::MaxSizeVector<ThreadWorkSource*>(static_cast<int32>(
               ParamFromEnvWithDefault("TF_RUN_HANDLER_MAX_CONCURRENT_HANDLERS",
-                                      kMaxConcurrentHandlers)))) {}
+                                      kMaxConcurrentHandlers)))),
+      idle_start_micros(0),
+      mean_idle_micros(-1) {}
 
 Task RunHandlerThreadPool::FindTask(
     int searching_range_start, int searching_range_end, int thread_id,
@@ -538,6 +577,8 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
             thread_data_[thread_id].new_version;
         thread_data_[thread_id].current_thread_work_sources.swap(
             thread_data_[thread_id].new_thread_work_sources);
+        thread_data_[thread_id].current_start_request_index =
+            thread_data_[thread_id].new_start_request_index;
       }
     }
     Eigen::MaxSizeVector<ThreadWorkSource*>* thread_work_sources =
@@ -558,10 +599,32 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
             std::min(active_requests,
                      std::max(search_range_end, search_range_start + 1));
 
-        t = FindTask(search_range_start, search_range_end, thread_id,
-                     sub_thread_pool_id, kMaxBlockingInflight,
-                     /*may_steal_blocking_work=*/true, *thread_work_sources,
-                     &task_from_blocking_queue, &tws);
+        // Requests with a higher priority than those of the sub thread pool
+        // come first, so that their work preempts that of lower priority
+        // requests at task boundaries.
+        int num_higher_priority_requests = 0;
+        if (PreemptLowerPriorityWork() &&
+            search_range_start < active_requests) {
+          const int64 priority =
+              (*thread_work_sources)[search_range_start]->GetPriority();
+          while (num_higher_priority_requests < search_range_start &&
+                 (*thread_work_sources)[num_higher_priority_requests]
+                         ->GetPriority() > priority) {
+            ++num_higher_priority_requests;
+          }
+        }
+        if (num_higher_priority_requests > 0) {
+          t = FindTask(0, num_higher_priority_requests, thread_id,
+                       sub_thread_pool_id, kMaxBlockingInflight,
+                       /*may_steal_blocking_work=*/true, *thread_work_sources,
+                       &task_from_blocking_queue, &tws);
+        }
+        if (!t.f) {
+          t = FindTask(search_range_start, search_range_end, thread_id,
+                       sub_thread_pool_id, kMaxBlockingInflight,
+                       /*may_steal_blocking_work=*/true, *thread_work_sources,
+                       &task_from_blocking_queue, &tws);
+        }
         if (!t.f) {
           // Search from all requests if the thread cannot find tasks from
           // requests that belong to its own sub thread pool.
@@ -581,6 +644,8 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
     } else {
       // TODO(chaox): Refactor the following code to share the logic with
       // FindTask.
+      const int start_request_index =
+          thread_data_[thread_id].current_start_request_index;
       for (int i = 0; i < thread_work_sources->size(); ++i) {
         tws = (*thread_work_sources)[i];
         // We want a smallish numbers of inter threads since
@@ -593,8 +658,9 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
             break;
           }
         }
-        if (i == 0) {
-          // Always look for any work from the "primary" work source.
+        if (i <= start_request_index) {
+          // Always look for any work from the "primary" work source, and from
+          // the higher priority ones before it.
           // This way when we wake up a thread for a new closure we are
           // guaranteed it can be worked on.
           t = tws->PopNonBlockingTask(thread_id, true);
@@ -615,6 +681,18 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
       }
     }
     if (t.f) {
+      ThreadData& data = thread_data_[thread_id];
+      if (data.idle_start_micros > 0) {
+        // Learn how long work takes to arrive, to tune how long the thread
+        // spins the next time it runs out of work.
+        const double idle_micros =
+            EnvTime::NowMicros() - data.idle_start_micros;
+        data.mean_idle_micros =
+            data.mean_idle_micros < 0
+                ? idle_micros
+                : 0.8 * data.mean_idle_micros + 0.2 * idle_micros;
+        data.idle_start_micros = 0;
+      }
       profiler::TraceMe activity(
           [=] {
             return strings::StrCat(task_from_blocking_queue ? "inter" : "intra",
@@ -628,6 +706,15 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
       env_.ExecuteTask(t);
       tws->DecrementInflightTaskCount(task_from_blocking_queue);
     } else {
+      if (spin_budget_micros_ > 0) {
+        if (thread_data_[thread_id].idle_start_micros == 0) {
+          thread_data_[thread_id].idle_start_micros = EnvTime::NowMicros();
+        }
+        if (SpinForWork(may_steal_blocking_work, thread_id,
+                        *thread_work_sources)) {
+          continue;
+        }
+      }
       profiler::TraceMe activity(
           [=] {
             return strings::StrCat("Sleeping#thread_id=", thread_id, "#");
@@ -644,10 +731,40 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
       } else {
         WaitForWork(may_steal_blocking_work, thread_id, kMaxBlockingInflight);
       }
+      metrics::RecordRunHandlerWakeup();
     }
   }
 }
 
+bool RunHandlerThreadPool::SpinForWork(
+    bool is_blocking, int thread_id,
+    const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources) {
+  const ThreadData& data = thread_data_[thread_id];
+  // The spin is bounded per idle period, so a thread that keeps finding no
+  // runnable task (e.g. as too many blocking tasks are inflight) still parks.
+  const uint64 spin_end_micros =
+      data.idle_start_micros +
+      ComputeSpinMicros(data.mean_idle_micros, spin_budget_micros_);
+  const uint64 spin_start_micros = EnvTime::NowMicros();
+  if (spin_start_micros >= spin_end_micros) {
+    return false;
+  }
+  bool found_work = false;
+  uint64 now_micros = spin_start_micros;
+  while (!found_work && !cancelled_ && now_micros < spin_end_micros) {
+    for (int i = 0; i < thread_work_sources.size() && !found_work; ++i) {
+      found_work =
+          thread_work_sources[i]->TaskQueueSize(false) > 0 ||
+          (is_blocking && thread_work_sources[i]->TaskQueueSize(true) > 0);
+    }
+    if (!found_work) {
+      now_micros = EnvTime::NowMicros();
+    }
+  }
+  metrics::RecordRunHandlerSpin(now_micros - spin_start_micros, found_work);
+  return found_work;
+}
+
 void RunHandlerThreadPool::WaitForWorkInSubThreadPool(bool is_blocking,
                                                       int sub_thread_pool_id) {
   const int kMaxSleepMicros = 250;
@@ -682,6 +799,8 @@ void RunHandlerThreadPool::WaitForWork(bool is_blocking, int thread_id,
           thread_data_[thread_id].new_thread_work_sources);
       thread_data_[thread_id].current_version =
           thread_data_[thread_id].new_version;
+      thread_data_[thread_id].current_start_request_index =
+          thread_data_[thread_id].new_start_request_index;
     }
     Eigen::MaxSizeVector<ThreadWorkSource*>* thread_work_sources =
         thread_data_[thread_id].current_thread_work_sources.get();
@@ -694,6 +813,8 @@ void RunHandlerThreadPool::WaitForWork(bool is_blocking, int thread_id,
             thread_data_[thread_id].new_thread_work_sources);
         thread_data_[thread_id].current_version =
             thread_data_[thread_id].new_version;
+        thread_data_[thread_id].current_start_request_index =
+            thread_data_[thread_id].new_start_request_index;
         thread_work_sources =
             thread_data_[thread_id].current_thread_work_sources.get();
       }
@@ -741,6 +862,8 @@ class RunHandler::Impl {
 
   int64 priority() { return options_.priority(); }
 
+  double weight() { return options_.weight(); }
+
  private:
   class ThreadPoolInterfaceWrapper : public thread::ThreadPoolInterface {
    public:
@@ -834,6 +957,7 @@ class RunHandlerPool::Impl {
                     static_cast<int32>(ParamFromEnvWithDefault(
                         "TF_RUN_HANDLER_MAX_CONCURRENT_HANDLERS",
                         kMaxConcurrentHandlers))));
+    thread_local std::vector<double> weights;
     uint64 version;
     int num_active_requests;
     RunHandler::Impl* handler_impl;
@@ -862,6 +986,7 @@ class RunHandlerPool::Impl {
 
       num_active_requests = sorted_active_handlers_.size() + 1;
       thread_work_sources->resize(num_active_requests);
+      weights.resize(num_active_requests);
       int priority = options.priority();
       auto it = sorted_active_handlers_.cbegin();
       bool new_handler_inserted = false;
@@ -874,11 +999,13 @@ class RunHandlerPool::Impl {
           --it;
         }
         (*thread_work_sources)[i] = (*it)->tws();
+        weights[i] = (*it)->weight();
         ++it;
       }
       version = ++version_;
     }
-    RecomputePoolStats(num_active_requests, version, *thread_work_sources);
+    RecomputePoolStats(num_active_requests, version, *thread_work_sources,
+                       weights);
     return WrapUnique<RunHandler>(new RunHandler(handler_impl));
   }
 
@@ -924,10 +1051,13 @@ class RunHandlerPool::Impl {
   }
 
  private:
+  // Distributes the threads across the active requests: by their weights if
+  // any request has one, and exponentially by priority and arrival otherwise.
   void RecomputePoolStats(
       int num_active_requests, uint64 version,
       const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
-          thread_work_sources);
+          thread_work_sources,
+      const std::vector<double>& weights);
 
   void LogInfo() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
@@ -963,8 +1093,17 @@ class RunHandlerPool::Impl {
 void RunHandlerPool::Impl::RecomputePoolStats(
     int num_active_requests, uint64 version,
     const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
-        thread_work_sources) {
+        thread_work_sources,
+    const std::vector<double>& weights) {
   if (num_active_requests == 0) return;
+  const bool use_weights =
+      std::any_of(weights.begin(), weights.end(),
+                  [](double weight) { return weight > 0; });
+  auto choose_requests = [&](int num_threads) {
+    return use_weights ? ChooseRequestsWithWeights(weights, num_threads)
+                       : ChooseRequestsWithExponentialDistribution(
+                             num_active_requests, num_threads);
+  };
 
   int sub_thread_pool_id = 0;
   for (int i = 0; i < num_active_requests; ++i) {
@@ -984,8 +1123,7 @@ void RunHandlerPool::Impl::RecomputePoolStats(
   int num_blocking_threads = run_handler_thread_pool()->NumBlockingThreads();
   int num_non_blocking_threads = num_threads - num_blocking_threads;
 
-  std::vector<int> request_idx_list = ChooseRequestsWithExponentialDistribution(
-      num_active_requests, num_blocking_threads);
+  std::vector<int> request_idx_list = choose_requests(num_blocking_threads);
   for (int i = 0; i < num_blocking_threads; ++i) {
     VLOG(2) << "Set work for tid=" << i
             << " with start_request_idx=" << request_idx_list[i];
@@ -993,8 +1131,7 @@ void RunHandlerPool::Impl::RecomputePoolStats(
         i, request_idx_list[i], version, thread_work_sources);
   }
 
-  request_idx_list = ChooseRequestsWithExponentialDistribution(
-      num_active_requests, num_non_blocking_threads);
+  request_idx_list = choose_requests(num_non_blocking_threads);
   for (int i = 0; i < num_non_blocking_threads; ++i) {
     VLOG(2) << "Set work for tid=" << (i + num_blocking_threads)
             << " with start_request_idx=" << request_idx_list[i];
@@ -1070,6 +1207,7 @@ void RunHandler::Impl::Reset(
   step_id_ = step_id;
   options_ = options;
   tws_.SetTracemeId(step_id);
+  tws_.SetPriority(options.priority());
 }
 
 RunHandlerPool::RunHandlerPool(int num_inter_op_threads)
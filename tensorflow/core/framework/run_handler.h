@@ -173,6 +173,10 @@ class ThreadWorkSource {
 
   void SetTracemeId(int64 value);
 
+  int64 GetPriority();
+
+  void SetPriority(int64 value);
+
   void SetWaiter(uint64 version, Waiter* waiter, mutex* mutex);
 
   int64 GetInflightTaskCount(bool is_blocking);
@@ -204,6 +208,7 @@ class ThreadWorkSource {
   mutex waiters_mu_;
   Waiter queue_waiters_ TF_GUARDED_BY(waiters_mu_);
   std::atomic<int64> traceme_id_;
+  std::atomic<int64> priority_;
 
   mutex run_handler_waiter_mu_;
   uint64 version_ TF_GUARDED_BY(run_handler_waiter_mu_);
@@ -235,8 +240,10 @@ class RunHandlerThreadPool {
                       std::function<void()> fn);
 
   // Set work queues from which the thread 'tid' can steal its work.
-  // The request with start_request_idx will be attempted first. Other requests
-  // will be attempted in FIFO order based on their arrival time.
+  // The request with start_request_idx will be attempted first, unless other
+  // requests have a higher priority: their work preempts that of the start
+  // request at task boundaries. Other requests will be attempted in FIFO order
+  // based on their arrival time.
   void SetThreadWorkSources(
       int tid, int start_request_idx, uint64 version,
       const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources);
@@ -268,6 +275,14 @@ class RunHandlerThreadPool {
 
   void WaitForWorkInSubThreadPool(bool is_blocking, int sub_thread_pool_id);
 
+  // Spins until one of `thread_work_sources` has a task the calling thread
+  // may run, for as long as recent idle periods of the thread suggest that
+  // work arrives before it would be worth parking. Returns whether work was
+  // found, in which case the thread should look for it instead of parking.
+  bool SpinForWork(
+      bool is_blocking, int thread_id,
+      const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources);
+
  private:
   struct ThreadData {
     ThreadData();
@@ -278,13 +293,24 @@ class RunHandlerThreadPool {
     int current_index;
     std::unique_ptr<Eigen::MaxSizeVector<ThreadWorkSource*>>
         new_thread_work_sources TF_GUARDED_BY(mu);
+    // Index of the start request in new_thread_work_sources. The sources
+    // before it have a higher priority.
+    int new_start_request_index TF_GUARDED_BY(mu);
 
     uint64 current_version;
+    int current_start_request_index;
     // Should only be accessed by one thread.
     std::unique_ptr<Eigen::MaxSizeVector<ThreadWorkSource*>>
         current_thread_work_sources;
 
     int sub_thread_pool_id;
+
+    // Should only be accessed by one thread. When the current idle period of
+    // the thread started, or 0 while it is running tasks.
+    uint64 idle_start_micros;
+    // Exponential moving average of the length of the idle periods of the
+    // thread, or negative before the first one.
+    double mean_idle_micros;
   };
 
   const int num_threads_;
@@ -305,6 +331,10 @@ class RunHandlerThreadPool {
   // fashion.
   std::vector<double> sub_thread_pool_start_request_percentage_;
   std::vector<double> sub_thread_pool_end_request_percentage_;
+
+  // The longest that idle threads spin for work before parking. 0 disables
+  // spinning.
+  const int64 spin_budget_micros_;
 };
 
 }  // namespace internal
@@ -495,6 +495,50 @@ TEST(RunHandlerThreadPool, RoundRobinExecution) {
   delete run_handler_thread_pool;
 }
 
+TEST(RunHandlerThreadPool, HigherPriorityWorkFirst) {
+  setenv("TF_RUN_HANDLER_USE_SUB_THREAD_POOL", "false", true);
+
+  Eigen::MaxSizeVector<mutex> waiters_mu(1);
+  waiters_mu.resize(1);
+  Eigen::MaxSizeVector<internal::Waiter> waiters(1);
+  waiters.resize(1);
+  internal::RunHandlerThreadPool* run_handler_thread_pool =
+      new internal::RunHandlerThreadPool(
+          /*num_blocking_threads=*/1, /*num_non_blocking_threads=*/0,
+          Env::Default(), ThreadOptions(), "tf_run_handler_pool", &waiters_mu,
+          &waiters);
+  // The work sources are sorted by decreasing priority.
+  Eigen::MaxSizeVector<internal::ThreadWorkSource*> thread_work_sources(2);
+  thread_work_sources.resize(2);
+  internal::ThreadWorkSource tws[2];
+  for (int i = 0; i < 2; ++i) {
+    tws[i].SetWaiter(1, &waiters[0], &waiters_mu[0]);
+    tws[i].SetPriority(1 - i);
+    thread_work_sources[i] = &tws[i];
+  }
+
+  mutex mu;
+  std::vector<int> executed;
+  BlockingCounter counter(2);
+  for (int i : {1, 0}) {
+    run_handler_thread_pool->AddWorkToQueue(
+        &tws[i], /*is_blocking=*/true, [&mu, &executed, &counter, i] {
+          mutex_lock l(mu);
+          executed.push_back(i);
+          counter.DecrementCount();
+        });
+  }
+  run_handler_thread_pool->Start();
+  // Even though the thread starts with the low priority request, the work of
+  // the high priority request runs first.
+  run_handler_thread_pool->SetThreadWorkSources(
+      /*tid=*/0, /*start_request_idx=*/1, /*version=*/1, thread_work_sources);
+  counter.Wait();
+  EXPECT_EQ(executed, std::vector<int>({0, 1}));
+
+  delete run_handler_thread_pool;
+}
+
 TEST(RunHandlerThreadPool, MultipleSubThreadPool) {
   // Set up environment for 2 sub thread pools.
   setenv("TF_RUN_HANDLER_USE_SUB_THREAD_POOL", "true", true);
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/run_handler_util.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "tensorflow/core/lib/strings/numbers.h"
@@ -181,4 +182,38 @@ std::vector<int> ChooseRequestsWithExponentialDistribution(
   return request_idx_list;
 }
 
+std::vector<int> ChooseRequestsWithWeights(const std::vector<double>& weights,
+                                           int num_threads) {
+  std::vector<double> cumulative_weights;
+  cumulative_weights.reserve(weights.size());
+  double total_weight = 0;
+  for (double weight : weights) {
+    total_weight += weight > 0 ? weight : 1.0;
+    cumulative_weights.push_back(total_weight);
+  }
+  std::vector<int> request_idx_list(num_threads, 0);
+  int request_idx = 0;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    // Thread `tid` serves the request whose share of the total weight contains
+    // the middle of the thread's share of the threads.
+    const double point = (tid + 0.5) * total_weight / num_threads;
+    while (request_idx + 1 < static_cast<int>(cumulative_weights.size()) &&
+           cumulative_weights[request_idx] < point) {
+      ++request_idx;
+    }
+    request_idx_list[tid] = request_idx;
+  }
+  return request_idx_list;
+}
+
+std::int64_t ComputeSpinMicros(double mean_idle_micros,
+                               std::int64_t spin_budget_micros) {
+  if (spin_budget_micros <= 0 || mean_idle_micros > spin_budget_micros) {
+    return 0;
+  }
+  if (mean_idle_micros < 0) return spin_budget_micros;
+  return std::min(spin_budget_micros,
+                  static_cast<std::int64_t>(std::ceil(2 * mean_idle_micros)));
+}
+
 }  // namespace tensorflow
@@ -54,6 +54,20 @@ void ComputeInterOpStealingRanges(int num_threads, int min_threads_per_domain,
 std::vector<int> ChooseRequestsWithExponentialDistribution(
     int num_active_requests, int num_threads);
 
+// Like ChooseRequestsWithExponentialDistribution, but distributes the threads
+// across requests in proportion to `weights`, which holds one non-negative
+// weight per active request. Requests with a weight of 0 count as 1.
+std::vector<int> ChooseRequestsWithWeights(const std::vector<double>& weights,
+                                           int num_threads);
+
+// Returns how long an idle thread should spin looking for work before it
+// parks, given the mean length `mean_idle_micros` of its recent idle periods
+// (negative if unknown) and the largest allowed spin `spin_budget_micros`.
+// Threads spin for about twice the mean idle period, and not at all when work
+// usually takes longer than the budget to arrive.
+std::int64_t ComputeSpinMicros(double mean_idle_micros,
+                               std::int64_t spin_budget_micros);
+
 // Look up environment variable named 'var_name' and return the value if it
 // exist and can be parsed. Return 'default_value' otherwise.
 double ParamFromEnvWithDefault(const char* var_name, double default_value);
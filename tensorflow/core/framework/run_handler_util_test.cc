@@ -126,6 +126,32 @@ TEST(RunHandlerUtilTest, TestExponentialRequestDistribution) {
   ASSERT_EQ(actual_distribution, expected_distribution);
 }
 
+TEST(RunHandlerUtilTest, TestWeightedRequestDistribution) {
+  std::vector<int> actual_distribution =
+      ChooseRequestsWithWeights({3, 0, 1}, /*num_threads=*/10);
+
+  std::vector<int> expected_distribution{0, 0, 0, 0, 0, 0, 1, 1, 2, 2};
+  ASSERT_EQ(actual_distribution, expected_distribution);
+
+  // Requests get no thread of their own when there are too few threads.
+  actual_distribution = ChooseRequestsWithWeights({1, 1, 1, 1}, 2);
+  expected_distribution = {0, 2};
+  ASSERT_EQ(actual_distribution, expected_distribution);
+}
+
+TEST(RunHandlerUtilTest, TestComputeSpinMicros) {
+  // Spinning is disabled without a budget.
+  EXPECT_EQ(ComputeSpinMicros(-1, 0), 0);
+  EXPECT_EQ(ComputeSpinMicros(10, 0), 0);
+  // Threads that have not been idle yet spin for the whole budget.
+  EXPECT_EQ(ComputeSpinMicros(-1, 50), 50);
+  // Otherwise they spin for twice their mean idle period, up to the budget.
+  EXPECT_EQ(ComputeSpinMicros(10, 50), 20);
+  EXPECT_EQ(ComputeSpinMicros(40, 50), 50);
+  // Threads that usually wait longer than the budget park right away.
+  EXPECT_EQ(ComputeSpinMicros(60, 50), 0);
+}
+
 TEST(RunHandlerUtilTest, TestParamFromEnvWithDefault) {
   std::vector<double> result = ParamFromEnvWithDefault(
       "RUN_HANDLER_TEST_ENV", std::vector<double>{0, 0, 0});
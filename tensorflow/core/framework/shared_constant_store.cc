@@ -0,0 +1,98 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/shared_constant_store.h"
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Returns true iff `a` and `b` have the same type, shape and contents.
+bool IdenticalTensors(const Tensor& a, const Tensor& b) {
+  return a.dtype() == b.dtype() && a.shape() == b.shape() &&
+         a.tensor_data() == b.tensor_data();
+}
+
+}  // namespace
+
+SharedConstantStore* SharedConstantStore::Global() {
+  static SharedConstantStore* store = new SharedConstantStore();
+  return store;
+}
+
+bool SharedConstantStore::IsSupported(const Tensor& tensor) {
+  return tensor.IsInitialized() && DataTypeCanUseMemcpy(tensor.dtype());
+}
+
+Status SharedConstantStore::Insert(const Tensor& tensor, string* handle) {
+  if (!IsSupported(tensor)) {
+    return errors::InvalidArgument("Can't share a tensor of type ",
+                                   DataTypeString(tensor.dtype()));
+  }
+  const StringPiece data = tensor.tensor_data();
+  const uint64 fingerprint = FingerprintCat64(
+      Fingerprint64(data),
+      Fingerprint64(absl::StrCat(DataTypeString(tensor.dtype()), "/",
+                                 tensor.shape().DebugString())));
+  const string base = absl::StrCat(absl::Hex(fingerprint, absl::kZeroPad16));
+
+  mutex_lock l(mu_);
+  // Probe past the (unlikely) handles of different tensors with the same
+  // fingerprint.
+  for (int i = 0;; ++i) {
+    string candidate = i == 0 ? base : absl::StrCat(base, "_", i);
+    auto it = tensors_.find(candidate);
+    if (it == tensors_.end()) {
+      tensors_.emplace(candidate, tensor);
+      num_bytes_ += data.size();
+      *handle = std::move(candidate);
+      return Status::OK();
+    }
+    if (IdenticalTensors(it->second, tensor)) {
+      *handle = std::move(candidate);
+      return Status::OK();
+    }
+  }
+}
+
+Status SharedConstantStore::Lookup(const string& handle,
+                                   Tensor* tensor) const {
+  tf_shared_lock l(mu_);
+  auto it = tensors_.find(handle);
+  if (it == tensors_.end()) {
+    return errors::NotFound(
+        "No shared constant with handle ", handle,
+        ". Shared constants are only valid in the process that created them.");
+  }
+  *tensor = it->second;
+  return Status::OK();
+}
+
+int64 SharedConstantStore::size() const {
+  tf_shared_lock l(mu_);
+  return tensors_.size();
+}
+
+int64 SharedConstantStore::num_bytes() const {
+  tf_shared_lock l(mu_);
+  return num_bytes_;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,72 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_FRAMEWORK_SHARED_CONSTANT_STORE_H_
+#define TENSORFLOW_CORE_FRAMEWORK_SHARED_CONSTANT_STORE_H_
+
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// SharedConstantStore keeps immutable tensors that graphs reference by handle
+// (see the _SharedConst op) instead of embedding their values in the GraphDef.
+// Identical tensors are stored only once, and the kernels referencing a tensor
+// alias its buffer, so the value is never copied after it has been added.
+//
+// Handles are only valid within the process that created them. Tensors are
+// kept for the lifetime of the process.
+class SharedConstantStore {
+ public:
+  // Returns the process-wide store.
+  static SharedConstantStore* Global();
+
+  SharedConstantStore() = default;
+
+  // Returns true if `tensor` can be kept in the store. Only tensors of types
+  // that can be compared with memcmp are supported.
+  static bool IsSupported(const Tensor& tensor);
+
+  // Adds `tensor` to the store unless an identical tensor is already present,
+  // and returns the handle of the stored tensor in `handle`.
+  Status Insert(const Tensor& tensor, string* handle);
+
+  // Looks up the tensor with the given `handle`.
+  Status Lookup(const string& handle, Tensor* tensor) const;
+
+  // Returns the number of distinct tensors in the store.
+  int64 size() const;
+
+  // Returns the total size of the distinct tensors in the store, in bytes.
+  int64 num_bytes() const;
+
+ private:
+  mutable mutex mu_;
+  absl::flat_hash_map<string, Tensor> tensors_ TF_GUARDED_BY(mu_);
+  int64 num_bytes_ TF_GUARDED_BY(mu_) = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SharedConstantStore);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_SHARED_CONSTANT_STORE_H_
@@ -0,0 +1,66 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/shared_constant_store.h"
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(SharedConstantStoreTest, InsertAndLookup) {
+  SharedConstantStore store;
+  const Tensor t = test::AsTensor<float>({1, 2, 3, 4}, {2, 2});
+  string handle;
+  TF_ASSERT_OK(store.Insert(t, &handle));
+  EXPECT_EQ(store.size(), 1);
+  EXPECT_EQ(store.num_bytes(), t.TotalBytes());
+
+  Tensor result;
+  TF_ASSERT_OK(store.Lookup(handle, &result));
+  test::ExpectTensorEqual<float>(result, t);
+  // The stored tensor aliases the inserted buffer.
+  EXPECT_EQ(result.tensor_data().data(), t.tensor_data().data());
+
+  EXPECT_TRUE(errors::IsNotFound(store.Lookup("missing", &result)));
+}
+
+TEST(SharedConstantStoreTest, Deduplicates) {
+  SharedConstantStore store;
+  string handle1, handle2, handle3, handle4;
+  TF_ASSERT_OK(store.Insert(test::AsTensor<float>({1, 2, 3, 4}), &handle1));
+  TF_ASSERT_OK(store.Insert(test::AsTensor<float>({1, 2, 3, 4}), &handle2));
+  TF_ASSERT_OK(
+      store.Insert(test::AsTensor<float>({1, 2, 3, 4}, {2, 2}), &handle3));
+  TF_ASSERT_OK(store.Insert(test::AsTensor<int32>({1, 2, 3, 4}), &handle4));
+  EXPECT_EQ(handle1, handle2);
+  EXPECT_NE(handle1, handle3);
+  EXPECT_NE(handle1, handle4);
+  EXPECT_EQ(store.size(), 3);
+}
+
+TEST(SharedConstantStoreTest, Unsupported) {
+  SharedConstantStore store;
+  const Tensor t = test::AsTensor<tstring>({"a", "b"});
+  EXPECT_FALSE(SharedConstantStore::IsSupported(t));
+  string handle;
+  EXPECT_TRUE(errors::IsInvalidArgument(store.Insert(t, &handle)));
+  EXPECT_EQ(store.size(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
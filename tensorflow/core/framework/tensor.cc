@@ -50,6 +50,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/tensor_coding.h"
 #include "tensorflow/core/platform/types.h"
@@ -755,11 +756,85 @@ bool Tensor::RefCountIsOne() const {
                      LOG(FATAL) << "Unexpected type: " << TYPE_ENUM; \
                      , LOG(FATAL) << "Type not set";)
 
+// NOTE(mrry): The default allocator for a Tensor (when none is specified) is
+// the default CPU allocator for NUMA zone 0. Accessing that currently involves
+// acquiring a lock, which guards initialization of the per-NUMA zone
+// allocators, and becomes highly contended.
+//
+// Note also that it would be better if all Tensor allocations required the user
+// to specify an allocator, for purposes of accounting, etc. However, the
+// default allocator is widely used throughout the codebase and in client code.
+static Allocator* get_default_cpu_allocator() {
+  static Allocator* default_cpu_allocator =
+      cpu_allocator(port::kNUMANoAffinity);
+  return default_cpu_allocator;
+}
+
+namespace {
+
+// Tensors of at most this many bytes allocated by the default CPU allocator
+// keep their data in an InlineTensorBuffer.
+constexpr int64 kMaxInlineTensorBytes = 32;
+
+// A buffer that holds its data inline, in a single heap allocation with the
+// buffer itself, instead of asking an allocator for it. This halves the
+// allocations of the small host tensors (scalars, shape vectors) that make up
+// a large fraction of the tensors of control-heavy graphs.
+class InlineTensorBuffer : public TensorBuffer {
+ public:
+  explicit InlineTensorBuffer(size_t size)
+      : TensorBuffer(inline_data_), size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  bool GetAllocatedBytes(size_t* out_bytes) const override { return false; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("InlineTensorBuffer");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // `new` only guarantees the alignment of fundamental types before C++17,
+  // and the data must be aligned like allocator memory.
+  static void* operator new(size_t size) {
+    return port::AlignedMalloc(size, Allocator::kAllocatorAlignment);
+  }
+  static void operator delete(void* ptr) { port::AlignedFree(ptr); }
+
+ private:
+  ~InlineTensorBuffer() override {}
+
+  const size_t size_;
+  alignas(Allocator::kAllocatorAlignment) char
+      inline_data_[kMaxInlineTensorBytes];
+
+  TF_DISALLOW_COPY_AND_ASSIGN(InlineTensorBuffer);
+};
+
+// Returns an InlineTensorBuffer for a tensor of `type` and `shape` allocated
+// by `a`, or nullptr if the tensor must be allocated by `a`.
+TensorBuffer* MaybeNewInlineTensorBuffer(Allocator* a, DataType type,
+                                         const TensorShape& shape) {
+  const int64 num_elements = shape.num_elements();
+  if (a != get_default_cpu_allocator() || !DataTypeCanUseMemcpy(type) ||
+      num_elements == 0 || num_elements > kMaxInlineTensorBytes ||
+      CPUAllocatorStatsEnabled()) {
+    return nullptr;
+  }
+  const int64 num_bytes = num_elements * DataTypeSize(type);
+  if (num_bytes > kMaxInlineTensorBytes) return nullptr;
+  return new InlineTensorBuffer(num_bytes);
+}
+
+}  // namespace
+
 Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape)
     : shape_(shape), buf_(nullptr) {
   set_dtype(type);
   CHECK_NOTNULL(a);
-  if (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle()) {
+  buf_ = MaybeNewInlineTensorBuffer(a, type, shape);
+  if (buf_ == nullptr &&
+      (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle())) {
     CASES(type, buf_ = new Buffer<T>(a, shape.num_elements()));
   }
   if (MemoryLoggingEnabled() && buf_ != nullptr && buf_->data() != nullptr) {
@@ -773,7 +848,9 @@ Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape,
     : shape_(shape), buf_(nullptr) {
   set_dtype(type);
   CHECK_NOTNULL(a);
-  if (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle()) {
+  buf_ = MaybeNewInlineTensorBuffer(a, type, shape);
+  if (buf_ == nullptr &&
+      (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle())) {
     CASES(type, buf_ = new Buffer<T>(a, shape.num_elements(), allocation_attr));
   }
   if (MemoryLoggingEnabled() && !allocation_attr.allocation_will_be_logged &&
@@ -783,20 +860,6 @@ Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape,
   }
 }
 
-// NOTE(mrry): The default allocator for a Tensor (when none is specified) is
-// the default CPU allocator for NUMA zone 0. Accessing that currently involves
-// acquiring a lock, which guards initialization of the per-NUMA zone
-// allocators, and becomes highly contended.
-//
-// Note also that it would be better if all Tensor allocations required the user
-// to specify an allocator, for purposes of accounting, etc. However, the
-// default allocator is widely used throughout the codebase and in client code.
-static Allocator* get_default_cpu_allocator() {
-  static Allocator* default_cpu_allocator =
-      cpu_allocator(port::kNUMANoAffinity);
-  return default_cpu_allocator;
-}
-
 Tensor::Tensor(DataType type, const TensorShape& shape)
     : Tensor(get_default_cpu_allocator(), type, shape) {}
 
@@ -850,6 +913,38 @@ class SubBuffer : public TensorBuffer {
   TF_DISALLOW_COPY_AND_ASSIGN(SubBuffer);
 };
 
+namespace {
+
+// A buffer that aliases memory owned by another object, such as the
+// `tensor_content` of a TensorProto, and keeps that object alive.
+class AliasingBuffer : public TensorBuffer {
+ public:
+  AliasingBuffer(const void* data, size_t size,
+                 std::shared_ptr<const void> owner)
+      : TensorBuffer(const_cast<void*>(data)),
+        size_(size),
+        owner_(std::move(owner)) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("AliasingBuffer");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const size_t size_;
+  const std::shared_ptr<const void> owner_;
+
+  ~AliasingBuffer() override {}
+
+  TF_DISALLOW_COPY_AND_ASSIGN(AliasingBuffer);
+};
+
+}  // namespace
+
 Tensor Tensor::Slice(int64 start, int64 limit) const {
   CHECK_GE(dims(), 1);
   CHECK_LE(0, start);
@@ -935,6 +1030,33 @@ bool Tensor::FromProto(Allocator* a, const TensorProto& proto) {
   return true;
 }
 
+bool Tensor::FromProtoAliasingContent(const TensorProto& proto,
+                                      std::shared_ptr<const void> owner) {
+  const string& content = proto.tensor_content();
+  if (!DataTypeCanUseMemcpy(proto.dtype()) || content.empty() ||
+      !TensorShape::IsValid(proto.tensor_shape())) {
+    return FromProto(proto);
+  }
+  TensorShape shape(proto.tensor_shape());
+  const bool aligned =
+#if EIGEN_MAX_ALIGN_BYTES == 0
+      true;
+#else
+      reinterpret_cast<intptr_t>(content.data()) % EIGEN_MAX_ALIGN_BYTES == 0;
+#endif
+  if (!aligned || content.size() != shape.num_elements() *
+                                        DataTypeSize(proto.dtype())) {
+    // Kernels require aligned buffers, and size mismatches are reported by
+    // FromProto().
+    return FromProto(proto);
+  }
+  shape_ = shape;
+  set_dtype(proto.dtype());
+  UnrefIfNonNull(buf_);
+  buf_ = new AliasingBuffer(content.data(), content.size(), std::move(owner));
+  return true;
+}
+
 void Tensor::AsProtoField(TensorProto* proto) const {
   proto->Clear();
   shape_.AsProto(proto->mutable_tensor_shape());
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_FRAMEWORK_TENSOR_H_
 
 #include <cstdint>
+#include <memory>
 #include <type_traits>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -361,6 +362,17 @@ class Tensor {
   bool FromProto(const TensorProto& other) TF_MUST_USE_RESULT;
   bool FromProto(Allocator* a, const TensorProto& other) TF_MUST_USE_RESULT;
 
+  /// \brief Like `FromProto(other)`, but if `other` holds its values in an
+  /// aligned `tensor_content` of a memcpy-able type, the tensor aliases those
+  /// bytes instead of copying them. The buffer then holds a reference to
+  /// `owner`, which must keep `other` alive and unmodified, e.g. the object
+  /// owning `other` or a memory-mapped file holding it.
+  ///
+  /// The resulting tensor is in host memory and must not be written to.
+  bool FromProtoAliasingContent(const TensorProto& other,
+                                std::shared_ptr<const void> owner)
+      TF_MUST_USE_RESULT;
+
   /// \brief Fills in `proto` with `*this` tensor's content.
   ///
   /// `AsProtoField()` fills in the repeated field for `proto.dtype()`, while
@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/framework/tensor.h"
 
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
@@ -1173,6 +1175,72 @@ TEST(Tensor, SharesBufferWith) {
   EXPECT_TRUE(a.SharesBufferWith(copy));
 }
 
+TEST(Tensor, FromProtoAliasingContent) {
+  Tensor t(DT_FLOAT, TensorShape({1024}));
+  for (int i = 0; i < 1024; ++i) t.vec<float>()(i) = i;
+  auto proto = std::make_shared<TensorProto>();
+  t.AsProtoTensorContent(proto.get());
+  std::weak_ptr<TensorProto> weak_proto = proto;
+
+  Tensor a;
+  ASSERT_TRUE(a.FromProtoAliasingContent(*proto, proto));
+  // The content is only aliased if it is aligned, otherwise it is copied, so
+  // the tensor is aligned either way. The proto lives as long as it is
+  // aliased.
+  const bool aliased =
+      a.tensor_data().data() == proto->tensor_content().data();
+  EXPECT_TRUE(a.IsAligned());
+  proto.reset();
+  EXPECT_EQ(aliased, !weak_proto.expired());
+  test::ExpectTensorEqual<float>(t, a);
+
+  // Values that are not in tensor_content are always copied.
+  TensorProto field_proto;
+  t.AsProtoField(&field_proto);
+  Tensor b;
+  ASSERT_TRUE(b.FromProtoAliasingContent(field_proto, nullptr));
+  test::ExpectTensorEqual<float>(t, b);
+
+  // Size mismatches are rejected as in FromProto().
+  TensorProto bad_proto;
+  t.AsProtoTensorContent(&bad_proto);
+  bad_proto.mutable_tensor_shape()->mutable_dim(0)->set_size(1023);
+  Tensor c;
+  EXPECT_FALSE(c.FromProtoAliasingContent(bad_proto, nullptr));
+}
+
+string AllocatorName(const Tensor& t) {
+  TensorDescription description;
+  t.FillDescription(&description);
+  return description.allocation_description().allocator_name();
+}
+
+TEST(Tensor, SmallTensorsAreInline) {
+  if (CPUAllocatorStatsEnabled()) {
+    // Allocations must go through the allocator to be accounted for.
+    return;
+  }
+  Tensor t(DT_INT64, TensorShape({4}));
+  EXPECT_EQ("InlineTensorBuffer", AllocatorName(t));
+  EXPECT_TRUE(t.IsAligned());
+  t.flat<int64>().setValues({1, 2, 3, 4});
+  test::ExpectTensorEqual<int64>(test::AsTensor<int64>({1, 2, 3, 4}), t);
+
+  // Copies and slices share the inline buffer.
+  Tensor copy = t;
+  EXPECT_TRUE(copy.SharesBufferWith(t));
+  Tensor slice = t.Slice(1, 3);
+  EXPECT_TRUE(slice.SharesBufferWith(t));
+  test::ExpectTensorEqual<int64>(test::AsTensor<int64>({2, 3}), slice);
+
+  // Larger tensors and tensors of types that cannot be memcpy'd are allocated
+  // as usual.
+  EXPECT_NE("InlineTensorBuffer",
+            AllocatorName(Tensor(DT_INT64, TensorShape({5}))));
+  EXPECT_NE("InlineTensorBuffer",
+            AllocatorName(Tensor(DT_STRING, TensorShape({}))));
+}
+
 TEST(Tensor, FailureToAllocate) {
   TensorShape shape({1});
   DummyCPUAllocator allocator;
@@ -22,7 +22,7 @@ limitations under the License.
 namespace tensorflow {
 namespace grappler {
 
-enum class AutoMixedPrecisionMode { CUDA, MKL };
+enum class AutoMixedPrecisionMode { CUDA, MKL, CPU };
 
 // Convert data types to float16 or bfloat16 where appropriate to improve
 // performance on GPUs or CPUs.
@@ -30,7 +30,8 @@ class AutoMixedPrecision : public GraphOptimizer {
  public:
   // If 'mode' is CUDA, converts nodes to float16 on Nvidia GPUs. If MKL,
   // converts nodes to bfloat16 on CPUs in order to take advantage of MKL
-  // performance improvements with bfloat16.
+  // performance improvements with bfloat16. If CPU, converts nodes to bfloat16
+  // on CPUs using the default kernels, which does not require an MKL build.
   explicit AutoMixedPrecision(
       AutoMixedPrecisionMode mode = AutoMixedPrecisionMode::CUDA)
       : mode_(mode) {}
@@ -38,8 +39,14 @@ class AutoMixedPrecision : public GraphOptimizer {
   ~AutoMixedPrecision() override {}
 
   string name() const override {
-    return mode_ == AutoMixedPrecisionMode::CUDA ? "auto_mixed_precision_cuda"
-                                                 : "auto_mixed_precision_mkl";
+    switch (mode_) {
+      case AutoMixedPrecisionMode::CUDA:
+        return "auto_mixed_precision_cuda";
+      case AutoMixedPrecisionMode::MKL:
+        return "auto_mixed_precision_mkl";
+      case AutoMixedPrecisionMode::CPU:
+        return "auto_mixed_precision_cpu";
+    }
   };
 
   bool UsesFunctionLibrary() const override { return false; }
@@ -439,6 +439,85 @@ class AutoMixedPrecisionListsMkl : public AutoMixedPrecisionLists {
   }
 };
 
+// Lists for converting to bfloat16 on CPUs using the default (Eigen) kernels,
+// which does not require an MKL build. Only ops whose bfloat16 CPU kernels were
+// measured to be at least as fast as their float32 counterparts are added to
+// the allow list; nodes without a bfloat16 CPU kernel are never converted.
+class AutoMixedPrecisionListsCpu : public AutoMixedPrecisionLists {
+ public:
+  // If 'fp32_accumulation' is true, ops which accumulate over many elements
+  // (reductions and gradient aggregations) are kept in float32.
+  explicit AutoMixedPrecisionListsCpu(bool fp32_accumulation)
+      : fp32_accumulation_(fp32_accumulation) {}
+
+  gtl::FlatSet<string> AllowList() override {
+    // The CPU bfloat16 matmul kernels accumulate in float32 internally.
+    auto list = gtl::FlatSet<string>{"MatMul", "BatchMatMul", "BatchMatMulV2"};
+    UpdateList("ALLOWLIST", &list);
+    return list;
+  }
+
+  gtl::FlatSet<string> InferList() override {
+    auto list = gtl::FlatSet<string>{
+        "Add",     "AddV2",   "BiasAdd", "BiasAddV1", "LeakyRelu",
+        "Maximum", "Minimum", "Mul",     "Sigmoid",   "SigmoidGrad",
+        "Sqrt",    "Square",  "Sub",     "Tanh",      "TanhGrad",
+    };
+    if (!fp32_accumulation_) {
+      for (const string& op : AccumulationOps()) list.insert(op);
+    }
+    UpdateList("INFERLIST", &list);
+    return list;
+  }
+
+  gtl::FlatSet<string> DenyList() override {
+    auto list = gtl::FlatSet<string>{
+        "Exp",
+        "Expm1",
+        "L2Loss",
+        "Log",
+        "Log1p",
+        "Mean",
+        "Pow",
+        "SaveV2",
+        "Softmax",
+        "SoftmaxCrossEntropyWithLogits",
+        "SparseSoftmaxCrossEntropyWithLogits",
+        "Sum",
+    };
+    if (fp32_accumulation_) {
+      for (const string& op : AccumulationOps()) list.insert(op);
+    }
+    UpdateList("DENYLIST", &list);
+    return list;
+  }
+
+  gtl::FlatSet<string> ClearList() override {
+    auto list = gtl::FlatSet<string>{
+        "Concat",          "ConcatV2",  "Enter",         "EnsureShape",
+        "Equal",           "Exit",      "ExpandDims",    "Identity",
+        "MaxPool",         "Merge",     "NextIteration", "Pack",
+        "PreventGradient", "Relu",      "Relu6",         "Relu6Grad",
+        "ReluGrad",        "Reshape",   "Select",        "SelectV2",
+        "Shape",           "ShapeN",    "Slice",         "Split",
+        "SplitV",          "Squeeze",   "StopGradient",  "Switch",
+        "Tile",            "Transpose", "Unpack",        "ZerosLike",
+    };
+    AddTensorListOps(&list);
+    UpdateList("CLEARLIST", &list);
+    return list;
+  }
+
+ private:
+  static const gtl::FlatSet<string>& AccumulationOps() {
+    static const auto* const ops =
+        new gtl::FlatSet<string>{"AddN", "BiasAddGrad"};
+    return *ops;
+  }
+
+  bool fp32_accumulation_;
+};
+
 }  // end namespace grappler
 }  // end namespace tensorflow
 
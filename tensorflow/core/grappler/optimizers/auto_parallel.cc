@@ -15,16 +15,25 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/auto_parallel.h"
 
+#include <algorithm>
+#include <unordered_map>
+
+#include "absl/strings/match.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/grappler/costs/utils.h"
+#include "tensorflow/core/grappler/costs/virtual_placer.h"
 #include "tensorflow/core/grappler/devices.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/op_types.h"
 #include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/grappler/utils/transitive_fanin.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 
@@ -32,6 +41,52 @@ namespace tensorflow {
 namespace grappler {
 const char kAutoParallelPrefix[] = "AutoParallel";
 
+namespace {
+
+constexpr char kGradientsScope[] = "gradients/";
+
+// Returns the position right after the "gradients" name scope in the node
+// name, or string::npos if the node was not created by the gradient
+// computation.
+size_t GradientsScopeEnd(const string& name) {
+  if (absl::StartsWith(name, kGradientsScope)) {
+    return strlen(kGradientsScope);
+  }
+  size_t pos = name.find(strings::StrCat("/", kGradientsScope));
+  return pos == string::npos ? pos : pos + 1 + strlen(kGradientsScope);
+}
+
+// Gradient nodes are named "gradients/<forward node>_grad/...". Returns the
+// name of the forward node or an empty string.
+string ForwardNodeOfGradient(const string& name) {
+  size_t begin = GradientsScopeEnd(name);
+  if (begin == string::npos) {
+    return "";
+  }
+  size_t end = name.find("_grad/", begin);
+  return end == string::npos ? "" : name.substr(begin, end - begin);
+}
+
+Costs::NanoSeconds PredictExecutionTime(const GraphProperties& properties,
+                                        const OpLevelCostEstimator& estimator,
+                                        const VirtualPlacer& placer,
+                                        const NodeDef& node) {
+  OpContext op_context;
+  op_context.op_info.set_op(node.op());
+  *op_context.op_info.mutable_attr() = node.attr();
+  for (const auto& input : properties.GetInputProperties(node.name())) {
+    *op_context.op_info.add_inputs() = input;
+  }
+  for (const auto& output : properties.GetOutputProperties(node.name())) {
+    *op_context.op_info.add_outputs() = output;
+  }
+  *op_context.op_info.mutable_device() = placer.get_device(node);
+  return std::max(estimator.PredictCosts(op_context).execution_time,
+                  Costs::NanoSeconds(1));
+}
+
+}  // namespace
+
 NodeDef* AutoParallel::AddNodeDivConst() {
   NodeDef* node = graph_.add_node();
   node->set_name(strings::StrCat(kAutoParallelPrefix, "-Div-Const"));
@@ -152,7 +207,7 @@ Status AutoParallel::Initialize(const GrapplerItem& item) {
   TF_RETURN_IF_ERROR(ComputeTransitiveFanin(graph_, item.fetch, &train_nodes));
   LOG(INFO) << "Number of training nodes: " << train_nodes.size();
 
-  const NodeDef* dequeue_node;
+  const NodeDef* dequeue_node = nullptr;
   for (const auto& train_node : train_nodes) {
     if (IsDequeueOp(*train_node)) {
       dequeue_node = train_node;
@@ -200,6 +255,214 @@ Status AutoParallel::Initialize(const GrapplerItem& item) {
   return Status::OK();
 }
 
+Status AutoParallel::AssignPipelineStages(Cluster* cluster) {
+  pipeline_stages_.clear();
+  backward_nodes_.clear();
+  stage_devices_.clear();
+  std::unordered_map<string, DeviceProperties> devices;
+  if (cluster) {
+    devices = cluster->GetDevices();
+    for (const auto& device : devices) {
+      if (device.second.type() == "GPU") {
+        stage_devices_.push_back(device.first);
+      }
+    }
+    std::sort(stage_devices_.begin(), stage_devices_.end());
+  }
+  if (stage_devices_.empty()) {
+    for (int i = 0; i < num_gpus_; i++) {
+      stage_devices_.push_back(strings::StrCat("/gpu:", i));
+    }
+  }
+
+  GrapplerItem item = item_->WithGraph(GraphDef(graph_));
+  GraphProperties properties(item);
+  TF_RETURN_IF_ERROR(
+      properties.InferStatically(/*assume_valid_feeds=*/true,
+                                 /*aggressive_shape_inference=*/false,
+                                 /*include_tensor_values=*/false));
+  OpLevelCostEstimator estimator;
+  VirtualPlacer placer(devices);
+
+  std::vector<const NodeDef*> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(graph_, &topo_order));
+
+  const string div_prefix = strings::StrCat(kAutoParallelPrefix, "-Div-");
+  const string div_const = strings::StrCat(kAutoParallelPrefix, "-Div-Const");
+  std::vector<std::pair<const NodeDef*, double>> forward_nodes;
+  double total_cost = 0;
+  for (const NodeDef* node : topo_order) {
+    const string& name = node->name();
+    if (replica_nodes_.find(name) == replica_nodes_.end()) {
+      continue;
+    }
+    if (GradientsScopeEnd(name) != string::npos ||
+        apply_gradients_nodes_.find(name) != apply_gradients_nodes_.end() ||
+        (absl::StartsWith(name, div_prefix) && name != div_const)) {
+      backward_nodes_.insert(name);
+      continue;
+    }
+    double cost =
+        PredictExecutionTime(properties, estimator, placer, *node).count();
+    forward_nodes.emplace_back(node, cost);
+    total_cost += cost;
+  }
+
+  // Split the forward nodes into contiguous ranges of the topological order
+  // of about the same estimated execution time. Since every edge goes forward
+  // in the topological order, activations only flow to later stages.
+  std::vector<int64> stage_bytes(num_pipeline_stages_, 0);
+  double prefix_cost = 0;
+  for (const auto& forward_node : forward_nodes) {
+    int stage = std::min<int>(
+        num_pipeline_stages_ - 1,
+        (prefix_cost + forward_node.second / 2) * num_pipeline_stages_ /
+            total_cost);
+    prefix_cost += forward_node.second;
+    const NodeDef* node = forward_node.first;
+    pipeline_stages_[node->name()] = stage;
+    for (const auto& output : properties.GetOutputProperties(node->name())) {
+      stage_bytes[stage] += CalculateTensorSize(output);
+    }
+    // Variables live on the first stage that reads them.
+    for (const string& input : node->input()) {
+      const string input_name = NodeName(input);
+      auto it = all_nodes_.find(input_name);
+      if (it != all_nodes_.end() && IsVariable(*it->second) &&
+          !NotSharedNode(input_name) &&
+          pipeline_stages_.insert({input_name, stage}).second) {
+        for (const auto& output : properties.GetOutputProperties(input_name)) {
+          stage_bytes[stage] += CalculateTensorSize(output);
+        }
+      }
+    }
+  }
+
+  // Optimizer updates are colocated with their variable, other backward nodes
+  // with the forward node they differentiate, or else with the latest stage
+  // they consume.
+  auto variable_stage = [this](const string& apply_node) {
+    auto it = pipeline_stages_.find(NodeName(all_nodes_[apply_node]->input(0)));
+    return it == pipeline_stages_.end() ? -1 : it->second;
+  };
+  for (const NodeDef* node : topo_order) {
+    const string& name = node->name();
+    if (backward_nodes_.find(name) == backward_nodes_.end()) {
+      continue;
+    }
+    int stage = -1;
+    if (apply_gradients_nodes_.find(name) != apply_gradients_nodes_.end()) {
+      stage = variable_stage(name);
+    } else if (absl::StartsWith(name, div_prefix)) {
+      stage = variable_stage(name.substr(div_prefix.size()));
+    } else {
+      auto it = pipeline_stages_.find(ForwardNodeOfGradient(name));
+      if (it != pipeline_stages_.end() &&
+          backward_nodes_.find(it->first) == backward_nodes_.end()) {
+        stage = it->second;
+      }
+    }
+    if (stage < 0) {
+      for (const string& input : node->input()) {
+        auto it = pipeline_stages_.find(NodeName(input));
+        if (it != pipeline_stages_.end()) {
+          stage = std::max(stage, it->second);
+        }
+      }
+    }
+    pipeline_stages_[name] = stage < 0 ? num_pipeline_stages_ - 1 : stage;
+  }
+
+  for (int i = 0; i < num_pipeline_stages_; i++) {
+    const string& device = StageDevice(i);
+    LOG(INFO) << "Pipeline stage " << i << " on device '" << device
+              << "' holds " << stage_bytes[i] << " bytes of weights and "
+              << "activations per micro-batch";
+    // At most num_pipeline_stages_ - i micro-batches are in flight on stage i.
+    auto it = devices.find(device);
+    if (it != devices.end() && it->second.memory_size() > 0 &&
+        stage_bytes[i] * (num_pipeline_stages_ - i) >
+            it->second.memory_size()) {
+      LOG(WARNING) << "Pipeline stage " << i << " might not fit in the "
+                   << it->second.memory_size() << " bytes of " << device;
+    }
+  }
+  return Status::OK();
+}
+
+const string& AutoParallel::StageDevice(int stage) const {
+  static const string* const kNoDevice = new string();
+  return stage_devices_.empty() ? *kNoDevice
+                                : stage_devices_[stage % stage_devices_.size()];
+}
+
+void AutoParallel::AddPipelineSchedule(GraphDef* graph) {
+  // Entry nodes of a stage are the forward nodes without data inputs from the
+  // same stage: delaying them delays the whole forward pass of the stage.
+  std::vector<std::vector<string>> backward(num_pipeline_stages_);
+  std::vector<std::vector<string>> entries(num_pipeline_stages_);
+  for (const auto& node_stage : pipeline_stages_) {
+    const string& name = node_stage.first;
+    const int stage = node_stage.second;
+    if (!NotSharedNode(name)) {
+      continue;
+    }
+    if (backward_nodes_.find(name) != backward_nodes_.end()) {
+      backward[stage].push_back(name);
+      continue;
+    }
+    bool is_entry = true;
+    for (const string& input : all_nodes_[name]->input()) {
+      const string input_name = NodeName(input);
+      auto it = pipeline_stages_.find(input_name);
+      if (!IsControlInput(input) && it != pipeline_stages_.end() &&
+          it->second == stage && NotSharedNode(input_name) &&
+          backward_nodes_.find(input_name) == backward_nodes_.end()) {
+        is_entry = false;
+        break;
+      }
+    }
+    if (is_entry) {
+      entries[stage].push_back(name);
+    }
+  }
+
+  std::unordered_map<string, NodeDef*> nodes;
+  for (int i = 0; i < graph->node_size(); i++) {
+    nodes[graph->node(i).name()] = graph->mutable_node(i);
+  }
+
+  // Stage s keeps at most num_pipeline_stages_ - s micro-batches in flight:
+  // micro-batch m starts its forward pass on stage s once the backward pass of
+  // micro-batch m - (num_pipeline_stages_ - s) is done there. Dependencies
+  // always point to earlier micro-batches, so they cannot create a cycle.
+  for (int stage = 0; stage < num_pipeline_stages_; stage++) {
+    if (backward[stage].empty() || entries[stage].empty()) {
+      continue;
+    }
+    const int in_flight = num_pipeline_stages_ - stage;
+    for (int number = in_flight; number < num_replicas_; number++) {
+      const int done = number - in_flight;
+      string done_prefix =
+          strings::StrCat(kAutoParallelPrefix, "-Replica-", done);
+      std::set<string> deps;
+      for (const auto& node : backward[stage]) {
+        deps.insert(AddPrefixToNodeName(node, done_prefix));
+      }
+      NodeDef* barrier = AddNodeControl(
+          strings::StrCat(kAutoParallelPrefix, "-Pipeline-Stage-", stage,
+                          "-Backward-", done),
+          deps, graph);
+      barrier->set_device(StageDevice(stage));
+      string prefix = strings::StrCat(kAutoParallelPrefix, "-Replica-", number);
+      for (const auto& node : entries[stage]) {
+        nodes[AddPrefixToNodeName(node, prefix)]->add_input(
+            AsControlDependency(barrier->name()));
+      }
+    }
+  }
+}
+
 bool AutoParallel::NotSharedNode(const string& name) {
   return shared_nodes_.find(name) == shared_nodes_.end();
 }
@@ -215,6 +478,11 @@ void AutoParallel::AddSharedNodes(GraphDef* graph) {
         *new_node->mutable_input(i) = new_name;
       }
     }
+    auto it = pipeline_stages_.find(node);
+    if (IsPipelined() && it != pipeline_stages_.end() &&
+        !StageDevice(it->second).empty()) {
+      new_node->set_device(StageDevice(it->second));
+    }
   }
 }
 
@@ -225,7 +493,13 @@ void AutoParallel::AddOneReplica(GraphDef* graph, int number) {
     *new_node = *all_nodes_[node];
     if (NotSharedNode(new_node->name())) {
       new_node->set_name(AddPrefixToNodeName(new_node->name(), prefix));
-      if (num_gpus_ > 0) {
+      auto it = pipeline_stages_.find(node);
+      if (IsPipelined()) {
+        if (it != pipeline_stages_.end() &&
+            !StageDevice(it->second).empty()) {
+          new_node->set_device(StageDevice(it->second));
+        }
+      } else if (num_gpus_ > 0) {
         new_node->set_device(strings::StrCat("/gpu:", number % num_gpus_));
       }
       for (int i = 0; i < new_node->input_size(); i++) {
@@ -243,6 +517,9 @@ void AutoParallel::BuildGraph(GraphDef* graph) {
   for (int i = 0; i < num_replicas_; i++) {
     AddOneReplica(graph, i);
   }
+  if (IsPipelined()) {
+    AddPipelineSchedule(graph);
+  }
   std::set<string> fetches;
   for (size_t i = 0; i < item_->fetch.size(); i++) {
     for (int j = 0; j < num_replicas_; j++) {
@@ -266,6 +543,9 @@ void AutoParallel::BuildGraph(GraphDef* graph) {
 Status AutoParallel::Optimize(Cluster* cluster, const GrapplerItem& item,
                               GraphDef* output) {
   TF_RETURN_IF_ERROR(Initialize(item));
+  if (IsPipelined()) {
+    TF_RETURN_IF_ERROR(AssignPipelineStages(cluster));
+  }
   BuildGraph(output);
   return Status::OK();
 }
@@ -24,9 +24,19 @@ namespace tensorflow {
 namespace grappler {
 
 // Automatically parallelize a graph by splitting in the batch dimension.
+//
+// With num_pipeline_stages >= 2 the replicas become micro-batches of a
+// pipeline instead: the forward nodes are split into stages of balanced
+// estimated cost, each stage is placed on its own device, backward nodes
+// follow the forward nodes they consume, and control dependencies limit stage
+// s to num_pipeline_stages - s micro-batches in flight, which yields a
+// one-forward-one-backward (1F1B) schedule once the pipeline is full.
 class AutoParallel : public GraphOptimizer {
  public:
-  AutoParallel(int num_replicas) : num_replicas_(num_replicas) {
+  AutoParallel(int num_replicas) : AutoParallel(num_replicas, 1) {}
+  AutoParallel(int num_replicas, int num_pipeline_stages)
+      : num_replicas_(num_replicas),
+        num_pipeline_stages_(num_pipeline_stages) {
     CHECK(num_replicas_ >= 2);
   }
   ~AutoParallel() override {}
@@ -50,7 +60,16 @@ class AutoParallel : public GraphOptimizer {
   const GrapplerItem* item_;
   int num_replicas_;
   int num_gpus_;
+  int num_pipeline_stages_;
+  // Pipeline stage of every node placed by the pipeline partitioner.
+  std::map<string, int> pipeline_stages_;
+  std::set<string> backward_nodes_;
+  std::vector<string> stage_devices_;
   Status Initialize(const GrapplerItem& item);
+  bool IsPipelined() const { return num_pipeline_stages_ >= 2; }
+  Status AssignPipelineStages(Cluster* cluster);
+  const string& StageDevice(int stage) const;
+  void AddPipelineSchedule(GraphDef* graph);
   NodeDef* AddNodeDivConst();
   NodeDef* AddNodeDiv(const string& name, const string& input_a,
                       const string& input_b);
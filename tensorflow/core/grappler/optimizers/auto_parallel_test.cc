@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/auto_parallel.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/grappler/clusters/virtual_cluster.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -126,6 +127,98 @@ TEST_F(AutoParallelTest, SimpleParallel) {
   EXPECT_EQ("^AutoParallel-Control-Fetch", node_gradient.input(0));
 }
 
+TEST_F(AutoParallelTest, PipelineParallel) {
+  // Two layers with their gradients named the way the gradient computation
+  // names them.
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Const(s.WithOpName("x"), 1.0f, {512, 512});
+  Output w1 = ops::Variable(s.WithOpName("w1"), {512, 512}, DT_FLOAT);
+  Output w2 = ops::Variable(s.WithOpName("w2"), {512, 512}, DT_FLOAT);
+  Output assign1 = ops::Assign(s.WithOpName("assign1"), w1, x);
+  Output assign2 = ops::Assign(s.WithOpName("assign2"), w2, x);
+  Output h1 = ops::MatMul(s.WithOpName("h1"), x, w1);
+  Output h2 = ops::MatMul(s.WithOpName("h2"), h1, w2);
+  Output grad_h2 = ops::OnesLike(s.WithOpName("gradients/OnesLike"), h2);
+  Output grad_h1 =
+      ops::MatMul(s.WithOpName("gradients/h2_grad/MatMul"), grad_h2, w2,
+                  ops::MatMul::TransposeB(true));
+  Output grad_w2 =
+      ops::MatMul(s.WithOpName("gradients/h2_grad/MatMul_1"), h1, grad_h2,
+                  ops::MatMul::TransposeA(true));
+  Output grad_w1 =
+      ops::MatMul(s.WithOpName("gradients/h1_grad/MatMul_1"), x, grad_h1,
+                  ops::MatMul::TransposeA(true));
+  Output learning_rate = ops::Const(s.WithOpName("learning_rate"), 0.01f);
+  Output apply1 = ops::ApplyGradientDescent(s.WithOpName("apply1"), w1,
+                                            learning_rate, grad_w1);
+  Output apply2 = ops::ApplyGradientDescent(s.WithOpName("apply2"), w2,
+                                            learning_rate, grad_w2);
+
+  GrapplerItem item;
+  item.init_ops = {"assign1", "assign2"};
+  item.fetch = {"apply1", "apply2"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  DeviceProperties gpu_device;
+  gpu_device.set_type("GPU");
+  gpu_device.set_frequency(1000);
+  gpu_device.set_num_cores(4);
+  gpu_device.set_bandwidth(32);
+  gpu_device.mutable_environment()->insert({"architecture", "6"});
+  DeviceProperties cpu_device;
+  cpu_device.set_type("CPU");
+  VirtualCluster cluster(
+      {{"/GPU:0", gpu_device}, {"/GPU:1", gpu_device}, {"/CPU:0", cpu_device}});
+
+  AutoParallel parallel(/*num_replicas=*/3, /*num_pipeline_stages=*/2);
+  GraphDef output;
+  TF_EXPECT_OK(parallel.Optimize(&cluster, item, &output));
+
+  std::map<string, const NodeDef*> nodes;
+  for (const NodeDef& node : output.node()) {
+    nodes[node.name()] = &node;
+  }
+  // Each layer and its weights are on their own stage, and each gradient is
+  // computed on the stage of the layer it differentiates.
+  EXPECT_EQ("/GPU:0", nodes.at("w1")->device());
+  EXPECT_EQ("/GPU:1", nodes.at("w2")->device());
+  for (int i = 0; i < 3; i++) {
+    string prefix = strings::StrCat("AutoParallel-Replica-", i, "/");
+    EXPECT_EQ("/GPU:0", nodes.at(prefix + "h1")->device());
+    EXPECT_EQ("/GPU:1", nodes.at(prefix + "h2")->device());
+    EXPECT_EQ("/GPU:1", nodes.at(prefix + "gradients/OnesLike")->device());
+    EXPECT_EQ("/GPU:1",
+              nodes.at(prefix + "gradients/h2_grad/MatMul_1")->device());
+    EXPECT_EQ("/GPU:0",
+              nodes.at(prefix + "gradients/h1_grad/MatMul_1")->device());
+    EXPECT_EQ("/GPU:0", nodes.at(prefix + "apply1")->device());
+    EXPECT_EQ("/GPU:1", nodes.at(prefix + "apply2")->device());
+  }
+
+  // The last stage runs one micro-batch at a time, the first stage two.
+  auto has_control_input = [&nodes](const string& node, const string& dep) {
+    for (const string& input : nodes.at(node)->input()) {
+      if (input == AsControlDependency(dep)) return true;
+    }
+    return false;
+  };
+  EXPECT_TRUE(has_control_input("AutoParallel-Replica-1/h2",
+                                "AutoParallel-Pipeline-Stage-1-Backward-0"));
+  EXPECT_TRUE(has_control_input("AutoParallel-Replica-2/h2",
+                                "AutoParallel-Pipeline-Stage-1-Backward-1"));
+  EXPECT_TRUE(has_control_input("AutoParallel-Replica-2/x",
+                                "AutoParallel-Pipeline-Stage-0-Backward-0"));
+  EXPECT_FALSE(has_control_input("AutoParallel-Replica-1/x",
+                                 "AutoParallel-Pipeline-Stage-0-Backward-0"));
+  EXPECT_EQ(0, nodes.count("AutoParallel-Pipeline-Stage-0-Backward-1"));
+  const NodeDef* barrier = nodes.at("AutoParallel-Pipeline-Stage-1-Backward-0");
+  EXPECT_EQ("/GPU:1", barrier->device());
+  EXPECT_TRUE(has_control_input("AutoParallel-Pipeline-Stage-1-Backward-0",
+                                "AutoParallel-Replica-0/apply2"));
+  EXPECT_FALSE(has_control_input("AutoParallel-Pipeline-Stage-1-Backward-0",
+                                 "AutoParallel-Replica-0/apply1"));
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_def.pb.h"
+#include "tensorflow/core/framework/shared_constant_store.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/tensor_util.h"
@@ -61,6 +62,9 @@ using TensorVector = gtl::InlinedVector<TensorValue, 4>;
 
 // We only fold/materialize constants smaller than 100kB.
 const int64 kMaxConstantSize = 100 * 1024;
+// Unless they are moved to the SharedConstantStore, which keeps them out of
+// the GraphDef.
+const int64 kMaxSharedConstantSize = 1024 * 1024 * 1024;
 
 namespace {
 template <typename T>
@@ -188,18 +192,22 @@ float QuantizedTypeMaxAsFloat(DataType data_type) {
 
 ConstantFolding::ConstantFolding(RewriterConfig::Toggle opt_level,
                                  DeviceBase* cpu_device,
-                                 bool disable_compressed_tensor_optimization)
+                                 bool disable_compressed_tensor_optimization,
+                                 int64 shared_constant_min_bytes)
     : opt_level_(opt_level),
       cpu_device_(cpu_device),
       disable_compressed_tensor_optimization_(
-          disable_compressed_tensor_optimization) {
+          disable_compressed_tensor_optimization),
+      shared_constant_min_bytes_(shared_constant_min_bytes) {
   resource_mgr_.reset(new ResourceMgr());
 }
 
 ConstantFolding::ConstantFolding(DeviceBase* cpu_device,
-                                 bool disable_compressed_tensor_optimization)
+                                 bool disable_compressed_tensor_optimization,
+                                 int64 shared_constant_min_bytes)
     : ConstantFolding(RewriterConfig::ON, cpu_device,
-                      disable_compressed_tensor_optimization) {}
+                      disable_compressed_tensor_optimization,
+                      shared_constant_min_bytes) {}
 
 // static
 string ConstantFolding::AddControlDependency(const string& input_name,
@@ -1008,7 +1016,8 @@ bool ConstantFolding::IsFoldableUncached(
       if (output_shape.IsFullyDefined()) {
         const int64 num_bytes =
             output_shape.num_elements() * DataTypeSize(output_prop.dtype());
-        if (num_bytes > input_size_bytes && num_bytes > kMaxConstantSize) {
+        if (num_bytes > input_size_bytes &&
+            num_bytes > MaxFoldedConstantSize(node, output_prop.dtype())) {
           // Do not fold nodes if the in-memory size of output is too large.
           // Notice that this is not exactly the same check used in
           // CreateNodeDef() where the actual encoded size is checked.
@@ -1021,6 +1030,43 @@ bool ConstantFolding::IsFoldableUncached(
   return true;
 }
 
+int64 ConstantFolding::MaxFoldedConstantSize(const NodeDef& node,
+                                             DataType dtype) const {
+  // _SharedConst only has a CPU kernel.
+  const bool can_share = shared_constant_min_bytes_ > 0 &&
+                         DataTypeCanUseMemcpy(dtype) &&
+                         (node.device().empty() || NodeIsOnCpu(&node));
+  return can_share ? kMaxSharedConstantSize : kMaxConstantSize;
+}
+
+Status ConstantFolding::ShareLargeFoldedConstants(GraphDef* optimized_graph) {
+  int num_shared = 0;
+  for (NodeDef& node : *optimized_graph->mutable_node()) {
+    if (!IsConstant(node) || !folded_nodes_.contains(node.name()) ||
+        nodes_to_preserve_.find(node.name()) != nodes_to_preserve_.end() ||
+        MaxFoldedConstantSize(node, node.attr().at("dtype").type()) ==
+            kMaxConstantSize) {
+      continue;
+    }
+    Tensor value;
+    if (!value.FromProto(node.attr().at("value").tensor()) ||
+        !SharedConstantStore::IsSupported(value) ||
+        value.TotalBytes() < shared_constant_min_bytes_) {
+      continue;
+    }
+    string handle;
+    TF_RETURN_IF_ERROR(SharedConstantStore::Global()->Insert(value, &handle));
+    node.set_op("_SharedConst");
+    node.mutable_attr()->erase("value");
+    value.shape().AsProto((*node.mutable_attr())["shape"].mutable_shape());
+    (*node.mutable_attr())["handle"].set_s(handle);
+    ++num_shared;
+  }
+  VLOG(1) << "Moved " << num_shared
+          << " folded constants to the shared constant store";
+  return Status::OK();
+}
+
 bool ConstantFolding::MaybeFoldable(const NodeDef& node,
                                     const GraphProperties* properties) const {
   // Skip constants, they're already folded
@@ -1212,7 +1258,8 @@ bool IsValidConstShapeForMulConvPushDown(
 // static
 Status ConstantFolding::CreateNodeDef(const string& name,
                                       const TensorValue& tensor, NodeDef* node,
-                                      size_t original_size) {
+                                      size_t original_size,
+                                      int64 max_constant_size) {
   node->set_name(name);
   node->set_op("Const");
 
@@ -1291,10 +1338,10 @@ Status ConstantFolding::CreateNodeDef(const string& name,
   }
   node->mutable_attr()->insert({"value", attr_tensor});
 
-  if (encoded_size > original_size && encoded_size >= kMaxConstantSize) {
+  if (encoded_size > original_size && encoded_size >= max_constant_size) {
     return errors::InvalidArgument(
         strings::StrCat("Can't fold ", name, ", its size would be too large (",
-                        encoded_size, " >= ", kMaxConstantSize, " bytes)"));
+                        encoded_size, " >= ", max_constant_size, " bytes)"));
   }
   return Status::OK();
 }
@@ -1357,8 +1404,9 @@ Status ConstantFolding::EvaluateOneFoldable(const NodeDef& node,
       node_name = strings::StrCat(node_name, "-", i);
     }
     if (output_tensors[i].tensor) {
-      Status s = CreateNodeDef(node_name, output_tensors[i], &outputs->at(i),
-                               total_inputs_size);
+      Status s = CreateNodeDef(
+          node_name, output_tensors[i], &outputs->at(i), total_inputs_size,
+          MaxFoldedConstantSize(node, output_tensors[i]->dtype()));
       if (!s.ok()) {
         *result_too_large = true;
         return s;
@@ -1517,6 +1565,7 @@ Status ConstantFolding::FoldNode(NodeDef* node, GraphDef* output_graph,
     // We rewrite the existing node if it only has a single output, and
     // create new nodes otherwise.
     if (const_nodes.size() == 1) {
+      folded_nodes_.insert(node->name());
       node->set_op("Const");
       // Note we need to clear the inputs in NodeMap before we clear the inputs
       // in the node, otherwise NodeMap would see empty inputs and effectively
@@ -1538,6 +1587,7 @@ Status ConstantFolding::FoldNode(NodeDef* node, GraphDef* output_graph,
       NodeDef* added_node = output_graph->add_node();
       *added_node = *const_node;
       added_node->set_device(node->device());
+      folded_nodes_.insert(added_node->name());
       node_map_->AddNode(added_node->name(), added_node);
       for (const auto& input : added_node->input()) {
         node_map_->AddOutput(NodeName(input), added_node->name());
@@ -3984,6 +4034,7 @@ Status ConstantFolding::Optimize(Cluster* cluster, const GrapplerItem& item,
   }
 
   has_fetch_ = !item.fetch.empty();
+  folded_nodes_.clear();
   GrapplerItem item_to_optimize = item;
   *optimized_graph = GraphDef();
   item_to_optimize.graph.Swap(optimized_graph);
@@ -3997,6 +4048,9 @@ Status ConstantFolding::Optimize(Cluster* cluster, const GrapplerItem& item,
     TF_RETURN_IF_ERROR(
         RunOptimizationPass(cluster, &item_to_optimize, optimized_graph));
   } while (graph_modified_ || optimized_graph->node_size() != node_count);
+  if (shared_constant_min_bytes_ > 0) {
+    TF_RETURN_IF_ERROR(ShareLargeFoldedConstants(optimized_graph));
+  }
   *optimized_graph->mutable_library() = item.graph.library();
   *optimized_graph->mutable_versions() = item.graph.versions();
 
@@ -34,6 +34,7 @@ namespace grappler {
 const char kConstantFoldingConst[] = "ConstantFolding";
 const char kConstantFoldingCtrl[] = "ConstantFoldingCtrl";
 extern const int64 kMaxConstantSize;
+extern const int64 kMaxSharedConstantSize;
 
 // Constant folding optimization for a graph.
 class ConstantFolding : public GraphOptimizer {
@@ -41,14 +42,20 @@ class ConstantFolding : public GraphOptimizer {
   // The size limit will only be considered if the newly created node is greater
   // than original_size (optional).
   static Status CreateNodeDef(const string& name, const TensorValue& tensor,
-                              NodeDef* node, size_t original_size = 0);
+                              NodeDef* node, size_t original_size = 0,
+                              int64 max_constant_size = kMaxConstantSize);
   static string AddControlDependency(const string& input_name, GraphDef* graph,
                                      NodeMap* node_map);
 
+  // If 'shared_constant_min_bytes' is positive, folded constants of at least
+  // that many bytes are moved to the SharedConstantStore and referenced by
+  // _SharedConst nodes, and may be up to kMaxSharedConstantSize bytes large.
   explicit ConstantFolding(DeviceBase* cpu_device,
-                           bool disable_compressed_tensor_optimization = false);
+                           bool disable_compressed_tensor_optimization = false,
+                           int64 shared_constant_min_bytes = 0);
   ConstantFolding(RewriterConfig::Toggle opt_level, DeviceBase* cpu_device,
-                  bool disable_compressed_tensor_optimization = false);
+                  bool disable_compressed_tensor_optimization = false,
+                  int64 shared_constant_min_bytes = 0);
 
   ~ConstantFolding() override {}
 
@@ -69,6 +76,12 @@ class ConstantFolding : public GraphOptimizer {
 
   bool IsReallyConstant(const NodeDef& node) const;
 
+  // Returns the maximum size of the constants that folding `node` may create.
+  int64 MaxFoldedConstantSize(const NodeDef& node, DataType dtype) const;
+
+  // Replaces the large constants created by folding with _SharedConst nodes.
+  Status ShareLargeFoldedConstants(GraphDef* optimized_graph);
+
   bool GetTensorFromConstNode(const string& node_name_or_input, Tensor* tensor);
 
   Status MaterializeShapes(const GraphProperties& properties);
@@ -340,6 +353,9 @@ class ConstantFolding : public GraphOptimizer {
   bool graph_modified_;
   bool graph_contains_assign_or_inplace_op_;
   bool disable_compressed_tensor_optimization_;
+  int64 shared_constant_min_bytes_;
+  // Names of the constant nodes created by folding.
+  absl::flat_hash_set<string> folded_nodes_;
 };
 
 }  // end namespace grappler
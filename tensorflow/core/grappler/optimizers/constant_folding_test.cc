@@ -3029,6 +3029,59 @@ TEST_F(ConstantFoldingTest, LargeConstantNoSizeIncrease) {
   EXPECT_LT(output.ByteSizeLong(), sizeof(float) * large_constant_size + 500);
 }
 
+TEST_F(ConstantFoldingTest, ShareLargeFoldedConstants) {
+  // The output of fill is larger than kMaxConstantSize, so it is only folded
+  // when it can be moved to the shared constant store.
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice(
+      "/job:localhost/replica:0/task:0/device:CPU:0");
+  const int64 large_constant_size = kMaxConstantSize;
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({large_constant_size}));
+  Output dims = ops::Const(s.WithOpName("dims"), {large_constant_size}, {1});
+  Output value = ops::Const(s.WithOpName("value"), 2.0f, {});
+  Output fill = ops::Fill(s.WithOpName("fill"), dims, value);
+  Output add = ops::Add(s.WithOpName("add"), x, fill);
+
+  GrapplerItem item;
+  item.fetch = {"add"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  GraphDef output;
+  ConstantFolding default_optimizer(/*cpu_device=*/nullptr);
+  TF_EXPECT_OK(default_optimizer.Optimize(/*cluster=*/nullptr, item, &output));
+  for (const auto& node : output.node()) {
+    if (node.name() == "fill") {
+      EXPECT_EQ("Fill", node.op());
+    }
+  }
+
+  ConstantFolding optimizer(/*cpu_device=*/nullptr,
+                            /*disable_compressed_tensor_optimization=*/false,
+                            /*shared_constant_min_bytes=*/1024);
+  TF_EXPECT_OK(optimizer.Optimize(/*cluster=*/nullptr, item, &output));
+  int found = 0;
+  for (const auto& node : output.node()) {
+    if (node.name() == "fill") {
+      ++found;
+      EXPECT_EQ("_SharedConst", node.op());
+      EXPECT_EQ(0, node.attr().count("value"));
+      for (const string& input : node.input()) {
+        EXPECT_TRUE(IsControlInput(input));
+      }
+    }
+  }
+  EXPECT_EQ(1, found);
+  EXPECT_LT(output.ByteSizeLong(), 2048);
+
+  Tensor x_t(DT_FLOAT, TensorShape({large_constant_size}));
+  test::FillIota<float>(&x_t, 0.0f);
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, {{"x", x_t}});
+  auto tensors = EvaluateNodes(output, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(1, tensors_expected.size());
+  ASSERT_EQ(1, tensors.size());
+  test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
+}
+
 TEST_F(ConstantFoldingTest, MaterializeBroadcastGradientArgs) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output a =
@@ -0,0 +1,241 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/decode_crop_and_resize_fusion.h"
+
+#include <algorithm>
+#include <array>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/strip.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/function.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/function_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kFusedOpName[] = "DecodeCropAndResizeJpeg";
+
+constexpr std::array<const char*, 5> kMapDatasetOps = {
+    "MapDataset", "ParallelMapDataset", "ParallelMapDatasetV2",
+    "MapAndBatchDataset", "ExperimentalMapAndBatchDataset"};
+
+// Returns the node of `function` that produces the tensor `input` if its op is
+// `op`, and nullptr otherwise.
+const NodeDef* FindProducer(const FunctionDef& function, const string& input,
+                            const string& op) {
+  const function_utils::FunctionDefTensorDesc desc(input);
+  const int index =
+      function_utils::FindFunctionNodeWithName(desc.node_name, function);
+  if (index == -1) return nullptr;
+  const NodeDef& node = function.node_def(index);
+  if (node.op() != op) return nullptr;
+  return &node;
+}
+
+// Counts the data and control references to `node_name` in `function`.
+int NumReferences(const FunctionDef& function, const string& node_name) {
+  auto references = [&node_name](const string& input) {
+    StringPiece tensor(input);
+    absl::ConsumePrefix(&tensor, "^");
+    return function_utils::FunctionDefTensorDesc(string(tensor)).node_name ==
+           node_name;
+  };
+  int num_references = 0;
+  for (const NodeDef& node : function.node_def()) {
+    num_references += std::count_if(node.input().begin(), node.input().end(),
+                                    references);
+  }
+  for (const auto& ret : function.ret()) {
+    if (references(ret.second)) ++num_references;
+  }
+  for (const auto& control_ret : function.control_ret()) {
+    if (control_ret.second == node_name) ++num_references;
+  }
+  return num_references;
+}
+
+bool IsScalarConstZero(const FunctionDef& function, const string& input) {
+  const NodeDef* node = FindProducer(function, input, "Const");
+  if (node == nullptr) return false;
+  const auto* value = gtl::FindOrNull(node->attr(), "value");
+  Tensor tensor;
+  if (value == nullptr || !tensor.FromProto(value->tensor()) ||
+      tensor.NumElements() != 1) {
+    return false;
+  }
+  if (tensor.dtype() == DT_INT32) return tensor.flat<int32>()(0) == 0;
+  if (tensor.dtype() == DT_INT64) return tensor.flat<int64>()(0) == 0;
+  return false;
+}
+
+// Matches
+//   squeeze = Squeeze(resize, squeeze_dims=[0])
+//   resize = ResizeBilinear(expand, size, T=uint8)
+//   expand = ExpandDims(decode, 0)
+//   decode = DecodeAndCropJpeg(contents, crop_window, ratio=1)
+// where the intermediate results have no other consumers.
+bool MatchDecodeCropAndResize(const FunctionDef& function,
+                              const NodeDef& squeeze, const NodeDef** decode,
+                              const NodeDef** expand, const NodeDef** resize) {
+  if (squeeze.op() != "Squeeze" || squeeze.input_size() != 1) return false;
+  const auto* squeeze_dims = gtl::FindOrNull(squeeze.attr(), "squeeze_dims");
+  if (squeeze_dims == nullptr || squeeze_dims->list().i_size() != 1 ||
+      squeeze_dims->list().i(0) != 0) {
+    return false;
+  }
+
+  *resize = FindProducer(function, squeeze.input(0), "ResizeBilinear");
+  if (*resize == nullptr || (*resize)->input_size() != 2 ||
+      (*resize)->attr().at("T").type() != DT_UINT8) {
+    return false;
+  }
+
+  *expand = FindProducer(function, (*resize)->input(0), "ExpandDims");
+  if (*expand == nullptr || (*expand)->input_size() != 2 ||
+      !IsScalarConstZero(function, (*expand)->input(1))) {
+    return false;
+  }
+
+  *decode = FindProducer(function, (*expand)->input(0), "DecodeAndCropJpeg");
+  if (*decode == nullptr || (*decode)->input_size() != 2) return false;
+  const auto* ratio = gtl::FindOrNull((*decode)->attr(), "ratio");
+  if (ratio != nullptr && ratio->i() != 1) return false;
+
+  for (const NodeDef* node : {*decode, *expand, *resize}) {
+    if (NumReferences(function, node->name()) != 1) return false;
+  }
+  return true;
+}
+
+NodeDef MakeFusedNode(const NodeDef& squeeze, const NodeDef& decode,
+                      const NodeDef& resize) {
+  NodeDef fused_node;
+  fused_node.set_name(squeeze.name());
+  fused_node.set_op(kFusedOpName);
+  fused_node.set_device(squeeze.device());
+  fused_node.add_input(decode.input(0));
+  fused_node.add_input(decode.input(1));
+  fused_node.add_input(resize.input(1));
+
+  for (auto key : {"channels", "fancy_upscaling", "try_recover_truncated",
+                   "acceptable_fraction", "dct_method"}) {
+    if (gtl::FindOrNull(decode.attr(), key)) {
+      graph_utils::CopyAttribute(key, decode, &fused_node);
+    }
+  }
+  for (auto key : {"align_corners", "half_pixel_centers"}) {
+    if (gtl::FindOrNull(resize.attr(), key)) {
+      graph_utils::CopyAttribute(key, resize, &fused_node);
+    }
+  }
+  return fused_node;
+}
+
+// Fuses every occurrence of the pattern in `function` and returns the number
+// of rewrites.
+int FuseDecodeCropAndResize(FunctionDef* function) {
+  int num_changes = 0;
+  absl::flat_hash_set<string> nodes_to_delete;
+  for (int i = 0; i < function->node_def_size(); ++i) {
+    const NodeDef& squeeze = function->node_def(i);
+    const NodeDef *decode, *expand, *resize;
+    if (!MatchDecodeCropAndResize(*function, squeeze, &decode, &expand,
+                                  &resize)) {
+      continue;
+    }
+    nodes_to_delete.insert(decode->name());
+    nodes_to_delete.insert(expand->name());
+    nodes_to_delete.insert(resize->name());
+
+    NodeDef fused_node = MakeFusedNode(squeeze, *decode, *resize);
+    function_utils::ReplaceReferences(
+        strings::StrCat(fused_node.name(), ":output:0"),
+        strings::StrCat(fused_node.name(), ":image:0"), function);
+    *function->mutable_node_def(i) = std::move(fused_node);
+    ++num_changes;
+  }
+
+  auto* nodes = function->mutable_node_def();
+  nodes->erase(std::remove_if(nodes->begin(), nodes->end(),
+                              [&nodes_to_delete](const NodeDef& node) {
+                                return nodes_to_delete.contains(node.name());
+                              }),
+               nodes->end());
+  return num_changes;
+}
+
+}  // namespace
+
+Status DecodeCropAndResizeFusion::OptimizeAndCollectStats(
+    Cluster* cluster, const GrapplerItem& item, GraphDef* output,
+    OptimizationStats* stats) {
+  *output = item.graph;
+  FunctionLibraryDefinition function_library(OpRegistry::Global(),
+                                             item.graph.library());
+
+  // Maps the name of each rewritten function to the name of its fused copy, so
+  // that map transformations sharing a function share the copy too.
+  absl::flat_hash_map<string, string> fused_functions;
+  for (int i = 0; i < output->node_size(); ++i) {
+    NodeDef* map_node = output->mutable_node(i);
+    if (std::find(kMapDatasetOps.begin(), kMapDatasetOps.end(),
+                  map_node->op()) == kMapDatasetOps.end()) {
+      continue;
+    }
+    auto* func = (*map_node->mutable_attr())["f"].mutable_func();
+    auto it = fused_functions.find(func->name());
+    if (it == fused_functions.end()) {
+      const FunctionDef* function = function_library.Find(func->name());
+      if (function == nullptr) continue;
+      FunctionDef fused_function = *function;
+      const int num_changes = FuseDecodeCropAndResize(&fused_function);
+      if (num_changes == 0) continue;
+      graph_utils::SetUniqueGraphFunctionName(
+          "fused_decode_function", output->mutable_library(), &fused_function);
+      it = fused_functions
+               .emplace(func->name(), fused_function.signature().name())
+               .first;
+      *output->mutable_library()->add_function() = std::move(fused_function);
+      stats->num_changes += num_changes;
+    }
+    func->set_name(it->second);
+  }
+  return Status::OK();
+}
+
+void DecodeCropAndResizeFusion::Feedback(Cluster* cluster,
+                                         const GrapplerItem& item,
+                                         const GraphDef& optimize_output,
+                                         double result) {
+  // no-op
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(DecodeCropAndResizeFusion,
+                            "decode_crop_and_resize_fusion");
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,59 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_DECODE_CROP_AND_RESIZE_FUSION_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_DECODE_CROP_AND_RESIZE_FUSION_H_
+
+#include "tensorflow/core/grappler/optimizers/data/optimizer_base.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// This optimization rewrites `DecodeAndCropJpeg` followed by a bilinear resize
+// of the decoded image inside the functions of map transformations, i.e.
+//
+//   Squeeze(ResizeBilinear(ExpandDims(DecodeAndCropJpeg(contents, crop), 0),
+//                          size), [0])
+//
+// which is what `tf.image.resize` emits for a single image, into
+// `DecodeCropAndResizeJpeg(contents, crop, size)`. The fused op decodes the
+// crop at the smallest DCT scale that covers `size`, so its output is not
+// bit-identical to the original computation.
+class DecodeCropAndResizeFusion : public TFDataOptimizerBase {
+ public:
+  DecodeCropAndResizeFusion() = default;
+  ~DecodeCropAndResizeFusion() override = default;
+
+  string name() const override { return "decode_crop_and_resize_fusion"; };
+
+  bool UsesFunctionLibrary() const override { return true; }
+
+  Status Init(
+      const tensorflow::RewriterConfig_CustomGraphOptimizer* config) override {
+    return Status::OK();
+  }
+
+  Status OptimizeAndCollectStats(Cluster* cluster, const GrapplerItem& item,
+                                 GraphDef* output,
+                                 OptimizationStats* stats) override;
+
+  void Feedback(Cluster* cluster, const GrapplerItem& item,
+                const GraphDef& optimize_output, double result) override;
+};
+
+}  // namespace grappler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_DECODE_CROP_AND_RESIZE_FUSION_H_
@@ -0,0 +1,140 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/decode_crop_and_resize_fusion.h"
+
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/function_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_test_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+
+// Returns the function `tf.image.resize(decode_and_crop_jpeg(contents))`
+// generates. If `expose_resize` is true, the 4-D resized image is returned as
+// well.
+FunctionDef DecodeCropAndResize(bool expose_resize) {
+  std::vector<string> outputs = {"image: float"};
+  std::vector<std::pair<string, string>> rets = {
+      {"image", "squeeze:output:0"}};
+  if (expose_resize) {
+    outputs.push_back("resized: float");
+    rets.push_back({"resized", "resize:resized_images:0"});
+  }
+  return FunctionDefHelper::Create(
+      "DecodeCropAndResize", {"contents: string"}, outputs, {},
+      {{{"crop"},
+        "Const",
+        {},
+        {{"value", test::AsTensor<int32>({10, 20, 100, 200})},
+         {"dtype", DT_INT32}}},
+       {{"axis"},
+        "Const",
+        {},
+        {{"value", test::AsScalar<int32>(0)}, {"dtype", DT_INT32}}},
+       {{"size"},
+        "Const",
+        {},
+        {{"value", test::AsTensor<int32>({32, 64})}, {"dtype", DT_INT32}}},
+       {{"decode"},
+        "DecodeAndCropJpeg",
+        {"contents", "crop:output:0"},
+        {{"channels", 3}, {"dct_method", "INTEGER_ACCURATE"}}},
+       {{"expand"},
+        "ExpandDims",
+        {"decode:image:0", "axis:output:0"},
+        {{"T", DT_UINT8}, {"Tdim", DT_INT32}}},
+       {{"resize"},
+        "ResizeBilinear",
+        {"expand:output:0", "size:output:0"},
+        {{"T", DT_UINT8}, {"half_pixel_centers", true}}},
+       {{"squeeze"},
+        "Squeeze",
+        {"resize:resized_images:0"},
+        {{"T", DT_FLOAT}, {"squeeze_dims", gtl::ArraySlice<int>{0}}}}},
+      rets);
+}
+
+GrapplerItem MakeItem(bool expose_resize) {
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("start", "Const", {}, {{"value", 0}, {"dtype", DT_INT32}}),
+       NDef("stop", "Const", {}, {{"value", 10}, {"dtype", DT_INT32}}),
+       NDef("step", "Const", {}, {{"value", 1}, {"dtype", DT_INT32}}),
+       NDef("range", "RangeDataset", {"start", "stop", "step"},
+            {{"output_shapes", gtl::ArraySlice<TensorShape>{}},
+             {"output_types", gtl::ArraySlice<DataType>{}}}),
+       graph_tests_utils::MakeMapNode("map", "range", "DecodeCropAndResize")},
+      {DecodeCropAndResize(expose_resize)});
+  return item;
+}
+
+TEST(DecodeCropAndResizeFusionTest, FusesDecodeCropAndResize) {
+  GrapplerItem item = MakeItem(/*expose_resize=*/false);
+  DecodeCropAndResizeFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  const NodeDef& map_node =
+      output.node(graph_utils::FindGraphNodeWithName("map", output));
+  const string& function_name = map_node.attr().at("f").func().name();
+  EXPECT_NE(function_name, "DecodeCropAndResize");
+  const int function_index =
+      graph_utils::FindGraphFunctionWithName(function_name, output.library());
+  ASSERT_NE(function_index, -1);
+  const FunctionDef& function = output.library().function(function_index);
+
+  for (const char* op : {"DecodeAndCropJpeg", "ExpandDims", "ResizeBilinear",
+                         "Squeeze"}) {
+    EXPECT_FALSE(function_utils::ContainsFunctionNodeWithOp(op, function));
+  }
+  const int fused_index = function_utils::FindFunctionNodeWithOp(
+      "DecodeCropAndResizeJpeg", function);
+  ASSERT_NE(fused_index, -1);
+  const NodeDef& fused_node = function.node_def(fused_index);
+  ASSERT_EQ(fused_node.input_size(), 3);
+  EXPECT_EQ(fused_node.input(0), "contents");
+  EXPECT_EQ(fused_node.input(1), "crop:output:0");
+  EXPECT_EQ(fused_node.input(2), "size:output:0");
+  EXPECT_EQ(fused_node.attr().at("channels").i(), 3);
+  EXPECT_EQ(fused_node.attr().at("dct_method").s(), "INTEGER_ACCURATE");
+  EXPECT_TRUE(fused_node.attr().at("half_pixel_centers").b());
+  EXPECT_EQ(function.ret().at("image"),
+            strings::StrCat(fused_node.name(), ":image:0"));
+}
+
+TEST(DecodeCropAndResizeFusionTest, KeepsIntermediateWithOtherConsumers) {
+  GrapplerItem item = MakeItem(/*expose_resize=*/true);
+  DecodeCropAndResizeFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  const NodeDef& map_node =
+      output.node(graph_utils::FindGraphNodeWithName("map", output));
+  EXPECT_EQ(map_node.attr().at("f").func().name(), "DecodeCropAndResize");
+  EXPECT_EQ(output.library().function_size(), 1);
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -35,7 +35,7 @@ using ConfigMap =
     std::map<string, tensorflow::RewriterConfig_CustomGraphOptimizer>;
 
 // tf.data optimizations, in the order we want to perform them.
-constexpr std::array<const char*, 19> kTFDataOptimizations = {
+constexpr std::array<const char*, 20> kTFDataOptimizations = {
     "noop_elimination",
     "disable_intra_op_parallelism",
     "shuffle_and_repeat_fusion",
@@ -44,6 +44,7 @@ constexpr std::array<const char*, 19> kTFDataOptimizations = {
     "filter_with_random_uniform_fusion",
     "map_and_filter_fusion",
     "hoist_random_uniform",
+    "decode_crop_and_resize_fusion",
     "map_parallelization",
     "map_and_batch_fusion",
     "map_vectorization",
@@ -194,15 +194,18 @@ REGISTER_VECTORIZER("Digamma", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Elu", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Erf", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Erfc", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("Erfinv", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Exp", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Expm1", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Floor", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Inv", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("IsFinite", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("IsInf", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("LeakyRelu", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Lgamma", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Log", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Log1p", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("Ndtri", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Neg", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Reciprocal", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Relu", UnaryCwiseOpVectorizer);
@@ -226,6 +229,21 @@ REGISTER_VECTORIZER("Tan", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Cast", UnaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Identity", UnaryCwiseOpVectorizer);
 
+// String unary
+REGISTER_VECTORIZER("AsString", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("DecodeBase64", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("EncodeBase64", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StaticRegexFullMatch", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StaticRegexReplace", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StringLength", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StringLower", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StringStrip", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StringToHashBucket", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StringToHashBucketFast", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StringToHashBucketStrong", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StringToNumber", UnaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("StringUpper", UnaryCwiseOpVectorizer);
+
 // Bitwise binary
 REGISTER_VECTORIZER("BitwiseAnd", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("BitwiseOr", BinaryCwiseOpVectorizer);
@@ -258,6 +276,7 @@ REGISTER_VECTORIZER("Maximum", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Minimum", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Mod", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Mul", BinaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("MulNoNan", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("NotEqual", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Polygamma", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Pow", BinaryCwiseOpVectorizer);
@@ -266,6 +285,9 @@ REGISTER_VECTORIZER("SquaredDifference", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Sub", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("TruncateDiv", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("TruncateMod", BinaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("Xdivy", BinaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("Xlog1py", BinaryCwiseOpVectorizer);
+REGISTER_VECTORIZER("Xlogy", BinaryCwiseOpVectorizer);
 REGISTER_VECTORIZER("Zeta", BinaryCwiseOpVectorizer);
 }  // namespace
 }  // namespace grappler
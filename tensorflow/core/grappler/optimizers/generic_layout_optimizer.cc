@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/generic_layout_optimizer_transposer.h"
 #include "tensorflow/core/grappler/optimizers/generic_layout_optimizer_transposer_factory.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/util/util.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -399,7 +400,8 @@ Status EraseOutputShapeAttrs(TransposeContext* context) {
 // When there is a GPU, the computation graph is converted to NCHW format.
 // When there is only CPU, there will be no conversion by default, unless user
 // chose to convert the graph to a desired format. Currently, NCHW -> NHWC
-// format conversion is available on CPU.
+// format conversion is available on CPU, and NHWC -> NCHW conversion is
+// available on CPU when MKL is enabled.
 Status GenericLayoutOptimizer::Optimize(Cluster* cluster,
                                         const GrapplerItem& item,
                                         GraphDef* output) {
@@ -429,12 +431,22 @@ Status GenericLayoutOptimizer::Optimize(Cluster* cluster,
       case RewriterConfig::NCHW_TO_NHWC:
         context.AssignDeviceAndDataFormats(kCPU, kNCHW, kNHWC);
         break;
-      // TODO(intel-tf): Add functionality for NHWC_TO_NCHW layout conversion on
-      // CPU.
       case RewriterConfig::NHWC_TO_NCHW:
+#ifdef INTEL_MKL
+        // The MKL convolution and pooling kernels take NCHW inputs, which map
+        // onto their blocked (nChw8c/nChw16c) formats by only splitting the
+        // channel dimension. The MKL layout pass keeps tensors in the blocked
+        // format within regions of MKL ops, so converting whole regions to
+        // NCHW here leaves conversions only at the region boundaries.
+        if (!DisableMKL()) {
+          context.AssignDeviceAndDataFormats(kCPU, kNHWC, kNCHW);
+          break;
+        }
+#endif  // INTEL_MKL
+        // Without MKL, most CPU kernels only support NHWC.
         return errors::Aborted(
-            "Conversion from NHWC to NCHW is currently not  available for "
-            "CPU.");
+            "Conversion from NHWC to NCHW is only available for CPU when MKL "
+            "is enabled.");
       default:
         *output = item.graph;
         VLOG(2) << "No layout conversion will take place for CPU.";
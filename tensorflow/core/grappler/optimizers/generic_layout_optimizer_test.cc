@@ -357,6 +357,53 @@ TEST_F(GenericLayoutOptimizerTest, CPUDevice) {
 #endif  // (GOOGLE_CUDA || TENSORFLOW_USE_ROCM)
 }
 
+#if defined(INTEL_MKL) && !(GOOGLE_CUDA || TENSORFLOW_USE_ROCM)
+TEST_F(GenericLayoutOptimizerTest, CPUDeviceNhwcToNchw) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Tensor input_data(DT_FLOAT, TensorShape({8, 4, 4, 3}));
+  test::FillIota<float>(&input_data, 1.0f);
+  Output input =
+      ops::Const(s.WithOpName("Input"), Input::Initializer(input_data));
+  Tensor filter_data(DT_FLOAT, TensorShape({2, 2, 3, 2}));
+  test::FillIota<float>(&filter_data, 1.0f);
+  Output filter =
+      ops::Const(s.WithOpName("Filter"), Input::Initializer(filter_data));
+  Output conv = ops::Conv2D(s.WithOpName("Conv2D").WithDevice("/CPU:0"),
+                            input, filter, {1, 1, 1, 1}, "VALID",
+                            ops::Conv2D::Attrs().DataFormat("NHWC"));
+  Output relu = ops::Relu(s.WithOpName("Relu").WithDevice("/CPU:0"), conv);
+  Output pool = ops::MaxPool(s.WithOpName("MaxPool").WithDevice("/CPU:0"),
+                             relu, {1, 2, 2, 1}, {1, 1, 1, 1}, "VALID",
+                             ops::MaxPool::Attrs().DataFormat("NHWC"));
+  Output fetch = ops::Identity(s.WithOpName("Fetch"), {pool});
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  GenericLayoutOptimizer optimizer(RewriterConfig::DEFAULT,
+                                   RewriterConfig::NHWC_TO_NCHW);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(virtual_cluster_.get(), item, &output));
+
+  Status status;
+  utils::GraphView graph_view(&output, &status);
+  TF_ASSERT_OK(status);
+  auto* conv_node = graph_view.GetNode("Conv2D");
+  ASSERT_NE(conv_node, nullptr);
+  VerifyDataFormatAttributeMatch(conv_node, "NCHW");
+  auto* pool_node = graph_view.GetNode("MaxPool");
+  ASSERT_NE(pool_node, nullptr);
+  VerifyDataFormatAttributeMatch(pool_node, "NCHW");
+
+  // The region is converted as a whole, so there is a single transpose at its
+  // input and a single one at its output.
+  int num_transposes = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.op() == "Transpose") ++num_transposes;
+  }
+  EXPECT_EQ(num_transposes, 2);
+}
+#endif  // INTEL_MKL && !(GOOGLE_CUDA || TENSORFLOW_USE_ROCM)
+
 TEST_F(GenericLayoutOptimizerTest, NoOptimizeIntegerConvolution) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   auto conv = SimpleConv2D<int32>(&s, 4, 2, "VALID", "");
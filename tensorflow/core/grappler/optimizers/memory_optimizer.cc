@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/memory_optimizer.h"
 
 #include <algorithm>
+#include <limits>
 #include <queue>
 #include <set>
 #include <unordered_map>
@@ -440,6 +441,18 @@ void RecomputeSubgraph(
   }
 }
 
+// Nodes whose inputs we may want to recompute. This matches node names that
+// contain recomputation_targets_name_scope as a name scope, meaning it either
+// begins with or contains the name scope. Defaults to "gradients/" which will
+// match any node names that begins with "gradients/" or contains
+// "/gradients/".
+bool IsRecomputationTarget(const NodeDef& node,
+                           const string& recomputation_targets_name_scope) {
+  return absl::StartsWith(node.name(), recomputation_targets_name_scope) ||
+         static_cast<int>(
+             node.name().find("/" + recomputation_targets_name_scope)) != -1;
+}
+
 void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
                                 const string& recomputation_targets_name_scope,
                                 GraphDef* graph, const GrapplerItem& item) {
@@ -461,15 +474,7 @@ void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
   }
   std::function<bool(const NodeDef&)> is_target =
       [&recomputation_targets_name_scope](const NodeDef& node) {
-        // Nodes whose inputs we may want to recompute. This matches node names
-        // that contain recomputation_targets_name_scope as a name scope,
-        // meaning it either begins with or contains the name scope.
-        // Defaults to "gradients/" which will match any node names that begins
-        // with "gradients/" or contains "/gradients/".
-        return absl::StartsWith(node.name(),
-                                recomputation_targets_name_scope) ||
-               static_cast<int>(node.name().find(
-                   "/" + recomputation_targets_name_scope)) != -1;
+        return IsRecomputationTarget(node, recomputation_targets_name_scope);
       };
 
   if (optimization_level == RewriterConfig::RECOMPUTATION_HEURISTICS ||
@@ -488,7 +493,8 @@ void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
                   node.attr().count(kRecomputeHint) > 0);
         },
         is_target);
-  } else if (optimization_level == RewriterConfig::MANUAL) {
+  } else if (optimization_level == RewriterConfig::MANUAL ||
+             optimization_level == RewriterConfig::COST_BASED) {
     recomputed_subgraphs = GetOpGroupsToRecompute(
         graph, node_map,
         [&feeds, &is_target](const NodeDef& node) {
@@ -1146,6 +1152,251 @@ static bool IdentifySwappingCandidates(
   return updated_graph;
 }
 
+// Simulated execution of a node.
+struct NodeTiming {
+  Costs::NanoSeconds start_time;
+  Costs::NanoSeconds completion_time;
+  Costs::NanoSeconds compute_time;
+};
+
+// Simulates one step of the item on a virtual cluster with the devices of
+// `cluster`, and records when each node runs.
+Status SimulateNodeTimings(
+    Cluster* cluster, const GrapplerItem& item,
+    std::unordered_map<string, NodeTiming>* node_timings) {
+  VirtualCluster vcluster(cluster->GetDevices());
+  TF_RETURN_IF_ERROR(vcluster.Provision());
+  TF_RETURN_IF_ERROR(vcluster.Initialize(item));
+  RunMetadata metadata;
+  Status s = vcluster.Run(item.graph, item.feed, item.fetch, &metadata);
+  // The simulation still produces the step stats when the graph doesn't fit in
+  // memory, which is precisely the case we're trying to fix.
+  if (!s.ok() && s.code() != error::RESOURCE_EXHAUSTED) {
+    return s;
+  }
+  for (const auto& dev_stats : metadata.step_stats().dev_stats()) {
+    for (const auto& node_stats : dev_stats.node_stats()) {
+      NodeTiming timing;
+      timing.start_time = Costs::MicroSeconds(node_stats.all_start_micros());
+      timing.completion_time =
+          Costs::NanoSeconds(1) +
+          Costs::MicroSeconds(node_stats.all_start_micros() +
+                              node_stats.op_end_rel_micros());
+      timing.compute_time = Costs::MicroSeconds(
+          node_stats.op_end_rel_micros() - node_stats.op_start_rel_micros());
+      node_timings->emplace(node_stats.node_name(), timing);
+    }
+  }
+  return Status::OK();
+}
+
+// What to do with a tensor that is live at the peak memory usage of a device.
+enum class MemoryAction { kKeep, kSwap, kRecompute };
+
+struct MemoryPlanCandidate {
+  MutableGraphView::OutputPort port;
+  int64 memory_used;
+  // The uses of the tensor that run after the peak.
+  std::vector<MutableGraphView::InputPort> late_uses;
+  MemoryAction action = MemoryAction::kKeep;
+  // Estimated increase of the step time caused by the action.
+  double overhead_ns = 0;
+
+  bool operator<(const MemoryPlanCandidate& other) const {
+    // Cheapest savings per byte first.
+    return overhead_ns * other.memory_used < other.overhead_ns * memory_used;
+  }
+};
+
+// Chooses, for each tensor that is live at the peak memory usage of a GPU,
+// whether to keep it, swap it to the host or recompute it, so that the peak
+// usage drops below `memory_target_bytes` (or the memory size of the device if
+// 0) at the lowest estimated cost. The peak memory usage and the op costs come
+// from a simulation of the step with the analytical cost model. The decisions
+// are recorded as `_swap_to_host` and `_recompute_hint` annotations, which are
+// then applied by the swapping and recomputation passes. Returns true if any
+// annotation was added.
+bool CostBasedMemoryPlanningPass(Cluster* cluster, int64 memory_target_bytes,
+                                 const string& recomputation_targets_name_scope,
+                                 GrapplerItem* item) {
+  GraphMemory memory(*item);
+  Status s = memory.InferStatically(cluster->GetDevices());
+  if (!s.ok()) {
+    VLOG(1) << "Failed to infer memory usage: " << s.error_message();
+    return false;
+  }
+  std::unordered_map<string, NodeTiming> node_timings;
+  s = SimulateNodeTimings(cluster, *item, &node_timings);
+  if (!s.ok()) {
+    VLOG(1) << "Failed to simulate the step: " << s.error_message();
+    return false;
+  }
+  std::unordered_set<string> feeds;
+  for (const auto& feed : item->feed) {
+    feeds.insert(NodeName(feed.first));
+  }
+
+  MutableGraphView graph(&item->graph);
+  std::unordered_set<string> annotated_tensors;
+  bool updated_graph = false;
+  for (const auto& device : cluster->GetDevices()) {
+    const DeviceProperties& prop = device.second;
+    if (prop.type() != "GPU") {
+      continue;
+    }
+    const int64 target =
+        memory_target_bytes > 0 ? memory_target_bytes : prop.memory_size();
+    const GraphMemory::MemoryUsage& mem_usage =
+        memory.GetPeakMemoryUsage(device.first);
+    if (target <= 0 || mem_usage.used_memory <= target) {
+      continue;
+    }
+    int64 required_savings = mem_usage.used_memory - target;
+
+    Costs::Duration peak_time = -1;
+    std::unordered_map<string, const GraphMemory::LiveTensor*> live_at_peak;
+    for (const auto& live_tensor : mem_usage.live_tensors) {
+      peak_time = std::max(peak_time, live_tensor.allocation_time);
+      live_at_peak[strings::StrCat(live_tensor.node, ":",
+                                   live_tensor.output_id)] = &live_tensor;
+    }
+
+    std::vector<MemoryPlanCandidate> candidates;
+    for (const auto& live_tensor : mem_usage.live_tensors) {
+      if (live_tensor.memory_used <= 1024) {
+        // Don't bother with small tensors.
+        continue;
+      }
+      MemoryPlanCandidate candidate;
+      candidate.port =
+          graph.GetOutputPort(live_tensor.node, live_tensor.output_id);
+      if (candidate.port.node == nullptr) {
+        continue;
+      }
+      candidate.memory_used = live_tensor.memory_used;
+
+      bool valid = true;
+      Costs::Duration earliest_use(Costs::Duration::infinity());
+      for (MutableGraphView::InputPort input :
+           graph.GetFanout(candidate.port)) {
+        auto it = node_timings.find(input.node->name());
+        if (it == node_timings.end()) {
+          valid = false;
+          break;
+        }
+        if (it->second.start_time > peak_time) {
+          candidate.late_uses.push_back(input);
+          earliest_use = std::min(earliest_use, it->second.start_time);
+        }
+      }
+      // The memory can only be released if all the uses that keep the tensor
+      // alive past the peak are rewired.
+      if (!valid || candidate.late_uses.empty()) {
+        continue;
+      }
+
+      // Swapping: the copies to and from the host overlap with the
+      // computations that run between the allocation and the peak, and between
+      // the peak and the first late use respectively. Let's assume that the
+      // copies go over PCIe running at 16 GBps.
+      double swap_overhead = std::numeric_limits<double>::infinity();
+      bool swappable = IsSwappable(graph, candidate.port);
+      for (MutableGraphView::InputPort input : candidate.late_uses) {
+        swappable &= IsSwappable(input);
+      }
+      if (swappable) {
+        const double transfer_ns = candidate.memory_used / 16.0;
+        const double before_peak =
+            (peak_time - live_tensor.allocation_time).count();
+        const double after_peak = (earliest_use - peak_time).count();
+        swap_overhead = std::max(0.0, transfer_ns - before_peak) +
+                        std::max(0.0, transfer_ns - after_peak);
+      }
+
+      // Recomputation: the producer runs a second time right before the late
+      // uses. This only saves memory if its inputs are kept alive anyway.
+      double recompute_overhead = std::numeric_limits<double>::infinity();
+      const NodeDef* producer = candidate.port.node;
+      bool recomputable =
+          feeds.count(producer->name()) == 0 && IsFreeOfSideEffect(*producer) &&
+          !IsRecomputationTarget(*producer, recomputation_targets_name_scope) &&
+          node_timings.count(producer->name()) > 0;
+      for (MutableGraphView::InputPort input : candidate.late_uses) {
+        recomputable &= IsRecomputationTarget(
+            *input.node, recomputation_targets_name_scope);
+      }
+      for (int i = 0; recomputable && i < producer->input_size(); ++i) {
+        const TensorId input = ParseTensorName(producer->input(i));
+        if (input.index() < 0) {
+          continue;
+        }
+        auto it = live_at_peak.find(strings::StrCat(input.node(), ":",
+                                                    input.index()));
+        recomputable = it != live_at_peak.end() &&
+                       it->second->deallocation_time >= earliest_use;
+      }
+      if (recomputable) {
+        recompute_overhead =
+            node_timings.at(producer->name()).compute_time.count();
+      }
+
+      if (swap_overhead <= recompute_overhead && swappable) {
+        candidate.action = MemoryAction::kSwap;
+        candidate.overhead_ns = swap_overhead;
+      } else if (recomputable) {
+        candidate.action = MemoryAction::kRecompute;
+        candidate.overhead_ns = recompute_overhead;
+      } else {
+        continue;
+      }
+      candidates.push_back(std::move(candidate));
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    for (const MemoryPlanCandidate& candidate : candidates) {
+      if (required_savings <= 0) {
+        break;
+      }
+      const string tensor_name = strings::StrCat(candidate.port.node->name(),
+                                                 ":", candidate.port.port_id);
+      if (!annotated_tensors.insert(tensor_name).second) {
+        continue;
+      }
+      if (candidate.action == MemoryAction::kSwap) {
+        VLOG(1) << "Will swap tensor " << tensor_name << " of size "
+                << candidate.memory_used << " with an estimated overhead of "
+                << candidate.overhead_ns << "ns";
+        for (MutableGraphView::InputPort input : candidate.late_uses) {
+          AttrValue& val = (*input.node->mutable_attr())["_swap_to_host"];
+          if (!val.has_list()) {
+            const bool has_port = val.value_case() == AttrValue::kI;
+            const int64 port = val.i();
+            val.mutable_list();
+            if (has_port) val.mutable_list()->add_i(port);
+          }
+          val.mutable_list()->add_i(input.port_id);
+        }
+      } else {
+        VLOG(1) << "Will recompute tensor " << tensor_name << " of size "
+                << candidate.memory_used << " with an estimated overhead of "
+                << candidate.overhead_ns << "ns";
+        NodeDef* producer = candidate.port.node;
+        if (producer->attr().count(kRecomputeHint) == 0) {
+          (*producer->mutable_attr())[kRecomputeHint].set_i(0);
+        }
+      }
+      required_savings -= candidate.memory_used;
+      updated_graph = true;
+    }
+    if (required_savings > 0) {
+      VLOG(1) << "Could not find enough memory savings for device "
+              << device.first << ": still " << required_savings
+              << " bytes over the target";
+    }
+  }
+  return updated_graph;
+}
+
 bool SwappingPass(RewriterConfig::MemOptType optimization_level,
                   Cluster* cluster, std::unique_ptr<GraphMemory>* memory,
                   GrapplerItem* item, std::unordered_set<string>* skip_list) {
@@ -1386,7 +1637,8 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   bool run_recomputation_pass =
       (optimization_level_ == RewriterConfig::RECOMPUTATION_HEURISTICS ||
        optimization_level_ == RewriterConfig::HEURISTICS ||
-       optimization_level_ == RewriterConfig::MANUAL);
+       optimization_level_ == RewriterConfig::MANUAL ||
+       optimization_level_ == RewriterConfig::COST_BASED);
   if (!run_recomputation_pass && nodes_to_relax.empty() && item.fetch.empty()) {
     return errors::Aborted("Nothing to do.");
   }
@@ -1394,6 +1646,15 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   GrapplerItem optimized_item(item);
   RelaxAssignNodes(nodes_to_relax, &optimized_item.graph);
 
+  // The cost based planner only annotates the graph: the annotations are
+  // applied by the recomputation and swapping passes below.
+  if (optimization_level_ == RewriterConfig::COST_BASED &&
+      !item.fetch.empty() && cluster != nullptr) {
+    CostBasedMemoryPlanningPass(cluster, memory_target_bytes_,
+                                recomputation_targets_name_scope_,
+                                &optimized_item);
+  }
+
   if (run_recomputation_pass) {
     RecomputationRewritingPass(optimization_level_,
                                recomputation_targets_name_scope_,
@@ -1426,7 +1687,8 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       if ((optimization_level_ == RewriterConfig::DEFAULT_MEM_OPT ||
            optimization_level_ == RewriterConfig::SWAPPING_HEURISTICS ||
            optimization_level_ == RewriterConfig::HEURISTICS ||
-           optimization_level_ == RewriterConfig::MANUAL) &&
+           optimization_level_ == RewriterConfig::MANUAL ||
+           optimization_level_ == RewriterConfig::COST_BASED) &&
           cluster != nullptr) {
         if (SwappingPass(optimization_level_, cluster, &memory, &optimized_item,
                          &skip_list)) {
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/meta_optimizer.h"
 
+#include <algorithm>
+
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/substitute.h"
@@ -41,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/loop_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/memory_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/model_pruner.h"
+#include "tensorflow/core/grappler/optimizers/optimization_cache.h"
 #include "tensorflow/core/grappler/optimizers/pin_to_host_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 #include "tensorflow/core/grappler/optimizers/scoped_allocator_optimizer.h"
@@ -51,8 +54,12 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/grappler/utils/tpu.h"
 #include "tensorflow/core/grappler/verifiers/structure_verifier.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/util/dump_graph.h"
 #include "tensorflow/core/util/ptr_util.h"
 #include "tensorflow/core/util/xla_config_registry.h"
@@ -90,7 +97,8 @@ int NumIterations(const RewriterConfig& cfg) {
 bool IsRunOnceOptimizer(const string& name) {
   return name == "layout" || name == "memory_optimizer" ||
          name == "loop_optimizer" || name == "auto_mixed_precision" ||
-         name == "auto_mixed_precision_mkl";
+         name == "auto_mixed_precision_mkl" ||
+         name == "auto_mixed_precision_cpu";
 }
 
 // Creates a function library stub from a real function library: copy only
@@ -111,6 +119,84 @@ FunctionDefLibrary GetFunctionDefLibraryStub(
   return stub;
 }
 
+uint64 FingerprintProto(const protobuf::MessageLite& proto) {
+  string serialized;
+  SerializeToStringDeterministic(proto, &serialized);
+  return Fingerprint64(serialized);
+}
+
+// Returns a fingerprint of `fdef_lib` that does not depend on the order of its
+// functions and gradients.
+uint64 FingerprintFunctionLibrary(const FunctionDefLibrary& fdef_lib) {
+  std::vector<const FunctionDef*> functions;
+  for (const FunctionDef& fn : fdef_lib.function()) functions.push_back(&fn);
+  std::sort(functions.begin(), functions.end(),
+            [](const FunctionDef* a, const FunctionDef* b) {
+              return a->signature().name() < b->signature().name();
+            });
+  std::vector<const GradientDef*> gradients;
+  for (const GradientDef& grad : fdef_lib.gradient()) {
+    gradients.push_back(&grad);
+  }
+  std::sort(gradients.begin(), gradients.end(),
+            [](const GradientDef* a, const GradientDef* b) {
+              return a->function_name() < b->function_name();
+            });
+
+  uint64 fingerprint = 0;
+  for (const FunctionDef* fn : functions) {
+    fingerprint = FingerprintCat64(fingerprint, FingerprintProto(*fn));
+  }
+  for (const GradientDef* grad : gradients) {
+    fingerprint = FingerprintCat64(fingerprint, FingerprintProto(*grad));
+  }
+  return fingerprint;
+}
+
+// Returns a fingerprint of the properties of `item` that optimizers can depend
+// on. It is used as the key of the item in the optimization cache.
+uint64 FingerprintGrapplerItem(const GrapplerItem& item) {
+  uint64 fingerprint = 0;
+  const auto add = [&fingerprint](const StringPiece s) {
+    fingerprint = FingerprintCat64(fingerprint, Fingerprint64(s));
+  };
+  for (const NodeDef& node : item.graph.node()) {
+    fingerprint = FingerprintCat64(fingerprint, FingerprintProto(node));
+  }
+  fingerprint =
+      FingerprintCat64(fingerprint, FingerprintProto(item.graph.versions()));
+  fingerprint = FingerprintCat64(
+      fingerprint, FingerprintFunctionLibrary(item.graph.library()));
+
+  for (const auto& feed : item.feed) {
+    add(strings::StrCat("feed:", feed.first, ":",
+                        DataTypeString(feed.second.dtype()), ":",
+                        feed.second.shape().DebugString()));
+  }
+  for (const string& fetch : item.fetch) add(strings::StrCat("fetch:", fetch));
+  for (const string& op : item.init_ops) add(strings::StrCat("init:", op));
+  for (const string& op : item.keep_ops) add(strings::StrCat("keep:", op));
+  for (const QueueRunnerDef& queue_runner : item.queue_runners) {
+    fingerprint =
+        FingerprintCat64(fingerprint, FingerprintProto(queue_runner));
+  }
+  add(strings::StrCat("save:", item.save_op, ":", item.restore_op, ":",
+                      item.save_restore_loc_tensor, ":",
+                      item.expected_init_time));
+
+  std::vector<string> devices(item.devices().begin(), item.devices().end());
+  std::sort(devices.begin(), devices.end());
+  for (const string& device : devices) add(strings::StrCat("device:", device));
+
+  const GrapplerItem::OptimizationOptions& options =
+      item.optimization_options();
+  add(strings::StrCat("options:", options.allow_non_differentiable_rewrites,
+                      options.allow_pruning_stateful_and_dataset_ops,
+                      options.optimize_function_library,
+                      options.is_eager_mode));
+  return fingerprint;
+}
+
 uint64 DeadlineMicroSeconds(const RewriterConfig& cfg) {
   const uint64 kTwentyMinutesInUsec = 20 * 60 * 1000 * 1000;
   if (cfg.meta_optimizer_timeout_ms() < 0) {
@@ -189,7 +275,8 @@ std::unique_ptr<GraphOptimizer> MetaOptimizer::MakeNewOptimizer(
   MK_OPT("constfold",
          new ConstantFolding(
              cpu_device_,
-             cfg_.experimental_disable_compressed_tensor_optimization()));
+             cfg_.experimental_disable_compressed_tensor_optimization(),
+             cfg_.experimental_shared_constant_min_bytes()));
   MK_OPT("shape", new ShapeOptimizer());
   MK_OPT("remap", new Remapper(cfg_.remapping()));
   MK_OPT("layout", new GenericLayoutOptimizer(
@@ -199,11 +286,15 @@ std::unique_ptr<GraphOptimizer> MetaOptimizer::MakeNewOptimizer(
          new AutoMixedPrecision(AutoMixedPrecisionMode::CUDA));
   MK_OPT("auto_mixed_precision_mkl",
          new AutoMixedPrecision(AutoMixedPrecisionMode::MKL));
+  MK_OPT("auto_mixed_precision_cpu",
+         new AutoMixedPrecision(AutoMixedPrecisionMode::CPU));
   MK_OPT("memory", new MemoryOptimizer(RewriterConfig::MANUAL));
   MK_OPT("common_subgraph_elimination",
          new CommonSubgraphElimination(cfg_.common_subgraph_elimination()));
   MK_OPT("arithmetic", new ArithmeticOptimizer(cfg_.arithmetic_optimization()));
-  MK_OPT("autoparallel", new AutoParallel(cfg_.auto_parallel().num_replicas()));
+  MK_OPT("autoparallel",
+         new AutoParallel(cfg_.auto_parallel().num_replicas(),
+                          cfg_.auto_parallel().num_pipeline_stages()));
   MK_OPT("loop", new LoopOptimizer(cfg_.loop_optimization(), cpu_device_));
   MK_OPT("dependency", new DependencyOptimizer(cfg_.dependency_optimization()));
   MK_OPT("debug_stripper", new DebugStripper());
@@ -253,7 +344,8 @@ Status MetaOptimizer::InitializeOptimizers(
   if (cfg_.constant_folding() != RewriterConfig::OFF) {
     optimizers->push_back(MakeUnique<ConstantFolding>(
         cfg_.constant_folding(), cpu_device_,
-        cfg_.experimental_disable_compressed_tensor_optimization()));
+        cfg_.experimental_disable_compressed_tensor_optimization(),
+        cfg_.experimental_shared_constant_min_bytes()));
   }
   if (cfg_.shape_optimization() != RewriterConfig::OFF) {
     optimizers->push_back(MakeUnique<ShapeOptimizer>());
@@ -266,6 +358,10 @@ Status MetaOptimizer::InitializeOptimizers(
     optimizers->push_back(
         MakeUnique<AutoMixedPrecision>(AutoMixedPrecisionMode::MKL));
   }
+  if (AutoMixedPrecisionEnabled(cfg_.auto_mixed_precision_cpu())) {
+    optimizers->push_back(
+        MakeUnique<AutoMixedPrecision>(AutoMixedPrecisionMode::CPU));
+  }
   if (cfg_.pin_to_host_optimization() == RewriterConfig::ON) {
     optimizers->push_back(MakeUnique<PinToHostOptimizer>());
   }
@@ -295,16 +391,19 @@ Status MetaOptimizer::InitializeOptimizers(
     if (cfg_.memory_optimizer_target_node_name_scope().empty()) {
       optimizers->push_back(
           // Use the default target node name prefix "gradients/"
-          MakeUnique<MemoryOptimizer>(cfg_.memory_optimization()));
+          MakeUnique<MemoryOptimizer>(cfg_.memory_optimization(), "gradients/",
+                                      cfg_.memory_optimizer_target_bytes()));
     } else {
       optimizers->push_back(MakeUnique<MemoryOptimizer>(
           cfg_.memory_optimization(),
-          cfg_.memory_optimizer_target_node_name_scope()));
+          cfg_.memory_optimizer_target_node_name_scope(),
+          cfg_.memory_optimizer_target_bytes()));
     }
   }
   if (cfg_.auto_parallel().enable()) {
     optimizers->push_back(
-        MakeUnique<AutoParallel>(cfg_.auto_parallel().num_replicas()));
+        MakeUnique<AutoParallel>(cfg_.auto_parallel().num_replicas(),
+                                 cfg_.auto_parallel().num_pipeline_stages()));
   }
   if (cfg_.scoped_allocator_optimization()) {
     optimizers->push_back(MakeUnique<ScopedAllocatorOptimizer>(
@@ -401,8 +500,9 @@ void MetaOptimizer::InitializeVerifiers(
   }
 }
 
-Status MetaOptimizer::OptimizeGraph(Cluster* cluster, GrapplerItem&& item,
-                                    GraphDef* optimized_graph) {
+Status MetaOptimizer::OptimizeGraph(
+    Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph,
+    std::vector<GraphOptimizationResult>* optimization_results) {
   int min_graph_nodes = cfg_.min_graph_nodes() == 0 ? kDefaultMinGraphNodes
                                                     : cfg_.min_graph_nodes();
   if (item.graph.node_size() < min_graph_nodes) {
@@ -534,7 +634,7 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, GrapplerItem&& item,
                                    }) != optimization_result.results.end();
 
   // Record graph optimization result.
-  optimization_results_.push_back(optimization_result);
+  optimization_results->push_back(optimization_result);
 
   if (is_optimized) {
     TF_RETURN_IF_ERROR(TopologicalSort(optimized_graph));
@@ -673,6 +773,21 @@ void PropagateTFDataAttrs(const FunctionLibraryDefinition& flib,
   }
 }
 
+uint64 MetaOptimizer::CacheFingerprint(Cluster* cluster,
+                                       const GrapplerItem& item) const {
+  uint64 fingerprint = FingerprintCat64(FingerprintGrapplerItem(item),
+                                        FingerprintProto(config_proto_));
+  if (cluster) {
+    std::vector<string> device_names = cluster->GetDeviceNames();
+    std::sort(device_names.begin(), device_names.end());
+    fingerprint = FingerprintCat64(fingerprint, Fingerprint64(cluster->type()));
+    for (const string& device_name : device_names) {
+      fingerprint = FingerprintCat64(fingerprint, Fingerprint64(device_name));
+    }
+  }
+  return fingerprint;
+}
+
 Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
                                           GraphDef* optimized_graph) {
   const uint64 start_us = Env::Default()->NowMicros();
@@ -702,13 +817,27 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       "Deleted $0 unreachable functions from the graph (library size = $1)",
       old_library_size - new_library_size, new_library_size);
 
+  // Reuse the result of a previous optimization of an identical item.
+  const bool use_cache = cfg_.experimental_enable_optimization_cache();
+  const string& cache_dir = cfg_.experimental_optimization_cache_dir();
+  uint64 item_fingerprint = 0;
+  if (use_cache) {
+    item_fingerprint = CacheFingerprint(cluster, item);
+    if (OptimizationCache::Global()->Lookup(item_fingerprint, cache_dir,
+                                            optimized_graph)) {
+      VLOG(1) << "Reusing cached optimization of grappler item: " << item.id;
+      return Status::OK();
+    }
+  }
+
   // Save a few small fields from item before we move it.
   bool optimize_function_library =
       item.optimization_options().optimize_function_library;
   const auto producer = item.graph.versions().producer();
 
   // 1. Optimize main graph
-  TF_RETURN_IF_ERROR(OptimizeGraph(cluster, std::move(item), optimized_graph));
+  TF_RETURN_IF_ERROR(OptimizeGraph(cluster, std::move(item), optimized_graph,
+                                   &optimization_results_));
   VLOG(1) << "Optimized main graph.";
   GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
 
@@ -783,11 +912,110 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
   // Propagate `_tf_data_function` attributes from functions to their callees.
   PropagateTFDataAttrs(flib, *optimized_graph->mutable_library());
 
+  // Functions are optimized concurrently on a thread pool if requested. The
+  // results are applied to the library in library order, and every function of
+  // a pass is optimized against the library as it was at the start of the
+  // pass, so the optimized library doesn't depend on the number of threads.
+  const int num_threads = cfg_.experimental_function_optimization_threads();
+  std::unique_ptr<thread::ThreadPool> thread_pool;
+  if (num_threads > 1) {
+    thread_pool = MakeUnique<thread::ThreadPool>(
+        Env::Default(), "grappler_function_optimization", num_threads);
+  }
+
+  // A function of the library that is optimized in the current pass.
+  struct FunctionOptimizationTask {
+    string func_name;
+    GrapplerFunctionItem func_item;
+    uint64 func_fingerprint = 0;
+    GraphDef optimized_func_graph;
+    std::vector<GraphOptimizationResult> optimization_results;
+    Status status;
+  };
+
+  // Optimizes the body of the function of `task`. Doesn't touch `flib`, so it
+  // can run concurrently with other tasks.
+  const auto optimize_function = [&](bool is_tpu_graph,
+                                     FunctionOptimizationTask* task) {
+    GrapplerFunctionItem& func_item = task->func_item;
+    if (is_tpu_graph) {
+      // Skip optimizing functions if this is a TPU graph. Currently, Grappler
+      // passes do not handle TPU functions correctly in a variety of ways
+      // (Note that due to the pre-placement TPU graph rewriting passes, the
+      // TPU-related ops are encapsulated away into functions). For example,
+      // TPU graphs contain TPUReplicateMetadata node that carries relevant
+      // TPU metadata and Grappler passes could prune that away. Grappler
+      // passes could also cause issues around shape inference. Since the
+      // desired and existing behavior is to not optimize TPU functions with
+      // Grappler, this check preserves that. The only exception is
+      // implementation selector what is required to swap in some TPU specific
+      // lowering code and is verified the work correctly on TPUs.
+      ImplementationSelector implementation_selector;
+
+      // Implementation selector needs to have access to valid function
+      // signature and attributes, and it doesn't need actual function body.
+      FunctionDefLibrary func_item_function_library;
+      func_item_function_library.Swap(func_item.graph.mutable_library());
+      *func_item.graph.mutable_library() =
+          GetFunctionDefLibraryStub(func_item_function_library);
+
+      task->status = implementation_selector.Optimize(
+          cluster, func_item, &task->optimized_func_graph);
+    } else {
+      GrapplerFunctionItem func_item_copy = func_item;
+      task->status =
+          OptimizeGraph(cluster, std::move(func_item_copy),
+                        &task->optimized_func_graph,
+                        &task->optimization_results);
+    }
+  };
+
+  // Replaces the function of `task` in `flib` with its optimized version.
+  const auto apply_optimized_function =
+      [&](FunctionOptimizationTask* task) -> Status {
+    TF_RETURN_IF_ERROR(task->status);
+    optimization_results_.insert(
+        optimization_results_.end(),
+        std::make_move_iterator(task->optimization_results.begin()),
+        std::make_move_iterator(task->optimization_results.end()));
+
+    // Function body optimization might have created new specialized
+    // functions for each instantiation context. Add them to the library.
+    GraphDef func_cache_entry;
+    FunctionDef* cached_func =
+        func_cache_entry.mutable_library()->add_function();
+    for (const FunctionDef& func_def :
+         task->optimized_func_graph.library().function()) {
+      if (flib.Find(func_def.signature().name()) == nullptr) {
+        TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+        if (use_cache) {
+          *func_cache_entry.mutable_library()->add_function() = func_def;
+        }
+      }
+    }
+
+    // Convert optimized graph back to FunctionDef.
+    FunctionDef optimized_func;
+    task->func_item.SwapFunctionBody(std::move(task->optimized_func_graph));
+    TF_RETURN_IF_ERROR(MakeFunctionDef(task->func_item, flib, &optimized_func));
+    if (use_cache) {
+      *cached_func = optimized_func;
+      OptimizationCache::Global()->Insert(task->func_fingerprint, cache_dir,
+                                          func_cache_entry);
+    }
+
+    // Replace optimized function with a new FunctionDef.
+    return flib.ReplaceFunction(task->func_name, optimized_func);
+  };
+
   // Optimize each function only once.
   absl::flat_hash_set<string> optimized_funcs;
   while (optimize_function_library) {
     optimize_function_library = false;
 
+    const bool is_tpu_graph = IsTPUGraphDef(*optimized_graph);
+    std::vector<std::unique_ptr<FunctionOptimizationTask>> tasks;
+
     int function_idx = 0;
     for (const FunctionDef& func : optimized_graph->library().function()) {
       GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
@@ -821,7 +1049,9 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       optimized_funcs.insert(func_name);
 
       // Make a GrapplerItem from a FunctionDef.
-      GrapplerFunctionItem func_item;
+      auto task = MakeUnique<FunctionOptimizationTask>();
+      task->func_name = func_name;
+      GrapplerFunctionItem& func_item = task->func_item;
       TF_RETURN_IF_ERROR(
           MakeGrapplerFunctionItem(func, flib, producer, &func_item));
 
@@ -845,53 +1075,56 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       func_item.optimization_options().allow_pruning_stateful_and_dataset_ops =
           false;
 
-      // Optimize function body graph.
-      GraphDef optimized_func_graph;
-      if (IsTPUGraphDef(*optimized_graph)) {
-        // Skip optimizing functions if this is a TPU graph. Currently, Grappler
-        // passes do not handle TPU functions correctly in a variety of ways
-        // (Note that due to the pre-placement TPU graph rewriting passes, the
-        // TPU-related ops are encapsulated away into functions). For example,
-        // TPU graphs contain TPUReplicateMetadata node that carries relevant
-        // TPU metadata and Grappler passes could prune that away. Grappler
-        // passes could also cause issues around shape inference. Since the
-        // desired and existing behavior is to not optimize TPU functions with
-        // Grappler, this check preserves that. The only exception is
-        // implementation selector what is required to swap in some TPU specific
-        // lowering code and is verified the work correctly on TPUs.
-        ImplementationSelector implementation_selector;
-
-        // Implementation selector needs to have access to valid function
-        // signature and attributes, and it doesn't need actual function body.
-        FunctionDefLibrary func_item_function_library;
-        func_item_function_library.Swap(func_item.graph.mutable_library());
-        *func_item.graph.mutable_library() =
-            GetFunctionDefLibraryStub(func_item_function_library);
-
-        TF_RETURN_IF_ERROR(implementation_selector.Optimize(
-            cluster, func_item, &optimized_func_graph));
-      } else {
-        GrapplerFunctionItem func_item_copy = func_item;
-        TF_RETURN_IF_ERROR(OptimizeGraph(cluster, std::move(func_item_copy),
-                                         &optimized_func_graph));
+      // Reuse the result of a previous optimization of an identical function,
+      // if any. The cached library holds the optimized function, followed by
+      // the specialized functions its optimization created.
+      if (use_cache) {
+        task->func_fingerprint = FingerprintCat64(
+            CacheFingerprint(cluster, func_item), is_tpu_graph);
+        GraphDef cached;
+        if (OptimizationCache::Global()->Lookup(task->func_fingerprint,
+                                                cache_dir, &cached)) {
+          VLOG(3) << "Reusing cached optimization of function: " << func_name;
+          for (int i = 1; i < cached.library().function_size(); ++i) {
+            const FunctionDef& func_def = cached.library().function(i);
+            if (flib.Find(func_def.signature().name()) == nullptr) {
+              TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+            }
+          }
+          TF_RETURN_IF_ERROR(
+              flib.ReplaceFunction(func_name, cached.library().function(0)));
+          continue;
+        }
       }
 
-      // Function body optimization might have created new specialized
-      // functions for each instantiation context. Add them to the library.
-      for (const FunctionDef& func_def :
-           optimized_func_graph.library().function()) {
-        if (flib.Find(func_def.signature().name()) == nullptr) {
-          TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
-        }
+      if (num_threads > 0) {
+        // Optimized later in this pass, together with the other functions.
+        tasks.push_back(std::move(task));
+        continue;
       }
 
-      // Convert optimized graph back to FunctionDef.
-      FunctionDef optimized_func;
-      func_item.SwapFunctionBody(std::move(optimized_func_graph));
-      TF_RETURN_IF_ERROR(MakeFunctionDef(func_item, flib, &optimized_func));
+      // Optimize function body graph.
+      optimize_function(is_tpu_graph, task.get());
+      TF_RETURN_IF_ERROR(apply_optimized_function(task.get()));
+    }
 
-      // Replace optimized function with a new FunctionDef.
-      TF_RETURN_IF_ERROR(flib.ReplaceFunction(func_name, optimized_func));
+    if (!tasks.empty()) {
+      if (thread_pool != nullptr) {
+        BlockingCounter counter(tasks.size());
+        for (auto& task : tasks) {
+          thread_pool->Schedule([&, task = task.get()]() {
+            optimize_function(is_tpu_graph, task);
+            counter.DecrementCount();
+          });
+        }
+        counter.Wait();
+      } else {
+        for (auto& task : tasks) optimize_function(is_tpu_graph, task.get());
+      }
+      GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+      for (auto& task : tasks) {
+        TF_RETURN_IF_ERROR(apply_optimized_function(task.get()));
+      }
     }
 
     // If optimized at least one function, update the graph library.
@@ -910,6 +1143,11 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
         *optimized_graph);
   }
 
+  if (use_cache) {
+    OptimizationCache::Global()->Insert(item_fingerprint, cache_dir,
+                                        *optimized_graph);
+  }
+
   const uint64 end_us = Env::Default()->NowMicros();
   metrics::UpdateGrapplerPassTime("*", end_us - start_us);
 
@@ -954,6 +1192,7 @@ bool MetaOptimizerEnabled(const ConfigProto& cfg) {
          rewrite_cfg.pin_to_host_optimization() == RewriterConfig::ON ||
          AutoMixedPrecisionEnabled(rewrite_cfg.auto_mixed_precision()) ||
          AutoMixedPrecisionEnabled(rewrite_cfg.auto_mixed_precision_mkl()) ||
+         AutoMixedPrecisionEnabled(rewrite_cfg.auto_mixed_precision_cpu()) ||
          !rewrite_cfg.optimizers().empty() ||
          !rewrite_cfg.custom_optimizers().empty();
 }
@@ -84,10 +84,20 @@ class MetaOptimizer : public GraphOptimizer {
       std::vector<std::unique_ptr<GraphVerifier>>* post_optimization_verifiers)
       const;
 
+  struct GraphOptimizationResult;
+
   // Run optimization pass over a single GrapplerItem. Meta optimizer might run
-  // multiple such passes: 1) for the main graph 2) for the function library
-  Status OptimizeGraph(Cluster* cluster, GrapplerItem&& item,
-                       GraphDef* optimized_graph);
+  // multiple such passes: 1) for the main graph 2) for the function library.
+  // The result of the pass is appended to `optimization_results`. Passes over
+  // different items may run concurrently.
+  Status OptimizeGraph(
+      Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph,
+      std::vector<GraphOptimizationResult>* optimization_results);
+
+  // Returns the key of `item` in the optimization cache, which covers the item
+  // itself, the configuration of the meta optimizer and the devices of
+  // `cluster`.
+  uint64 CacheFingerprint(Cluster* cluster, const GrapplerItem& item) const;
 
   DeviceBase* const cpu_device_;  // may be NULL
   ConfigProto config_proto_;
@@ -0,0 +1,135 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/optimization_cache.h"
+
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr int64 kDefaultCapacityBytes = 256 << 20;  // 256 MiB
+
+string CacheFileName(const string& directory, uint64 fingerprint) {
+  return io::JoinPath(directory,
+                      strings::StrCat(strings::Hex(fingerprint,
+                                                   strings::kZeroPad16),
+                                      ".graph.pb"));
+}
+
+}  // namespace
+
+OptimizationCache::OptimizationCache(int64 capacity_bytes)
+    : capacity_bytes_(capacity_bytes) {}
+
+OptimizationCache* OptimizationCache::Global() {
+  static OptimizationCache* cache =
+      new OptimizationCache(kDefaultCapacityBytes);
+  return cache;
+}
+
+bool OptimizationCache::Lookup(uint64 fingerprint, const string& directory,
+                               GraphDef* graph) {
+  std::shared_ptr<const GraphDef> cached;
+  {
+    mutex_lock l(mu_);
+    auto it = entries_.find(fingerprint);
+    if (it != entries_.end()) {
+      cached = it->second.graph;
+    }
+  }
+  if (cached) {
+    *graph = *cached;
+    return true;
+  }
+  if (directory.empty()) {
+    return false;
+  }
+  Env* env = Env::Default();
+  const string file_name = CacheFileName(directory, fingerprint);
+  if (!env->FileExists(file_name).ok()) {
+    return false;
+  }
+  auto read_graph = std::make_shared<GraphDef>();
+  Status s = ReadBinaryProto(env, file_name, read_graph.get());
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to read cached optimized graph " << file_name
+                 << ": " << s;
+    return false;
+  }
+  *graph = *read_graph;
+  InsertInMemory(fingerprint, std::move(read_graph));
+  return true;
+}
+
+void OptimizationCache::Insert(uint64 fingerprint, const string& directory,
+                               const GraphDef& graph) {
+  InsertInMemory(fingerprint, std::make_shared<const GraphDef>(graph));
+  if (directory.empty()) {
+    return;
+  }
+  // Write to a temporary file first, so that concurrent readers never see a
+  // partially written graph.
+  Env* env = Env::Default();
+  const string file_name = CacheFileName(directory, fingerprint);
+  const string tmp_file_name =
+      strings::StrCat(file_name, ".", random::New64(), ".tmp");
+  Status s = env->RecursivelyCreateDir(directory);
+  if (s.ok()) {
+    s = WriteBinaryProto(env, tmp_file_name, graph);
+  }
+  if (s.ok()) {
+    s = env->RenameFile(tmp_file_name, file_name);
+  }
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to write cached optimized graph " << file_name
+                 << ": " << s;
+    env->DeleteFile(tmp_file_name).IgnoreError();
+  }
+}
+
+int64 OptimizationCache::size() {
+  mutex_lock l(mu_);
+  return entries_.size();
+}
+
+void OptimizationCache::InsertInMemory(uint64 fingerprint,
+                                       std::shared_ptr<const GraphDef> graph) {
+  const int64 size_bytes = graph->ByteSizeLong();
+  if (size_bytes > capacity_bytes_) {
+    return;
+  }
+  mutex_lock l(mu_);
+  if (entries_.contains(fingerprint)) {
+    return;
+  }
+  while (size_bytes_ + size_bytes > capacity_bytes_) {
+    auto oldest = entries_.find(insertion_order_.front());
+    size_bytes_ -= oldest->second.size_bytes;
+    entries_.erase(oldest);
+    insertion_order_.pop_front();
+  }
+  entries_[fingerprint] = {std::move(graph), size_bytes};
+  insertion_order_.push_back(fingerprint);
+  size_bytes_ += size_bytes;
+}
+
+}  // namespace grappler
+}  // namespace tensorflow
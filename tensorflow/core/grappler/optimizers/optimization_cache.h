@@ -0,0 +1,78 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OPTIMIZATION_CACHE_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OPTIMIZATION_CACHE_H_
+
+#include <deque>
+#include <memory>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// A thread-safe cache of optimized graphs, keyed by a fingerprint of the
+// original graph and of everything else its optimization depends on.
+//
+// Entries are kept in memory, evicting the oldest entries once their total
+// size exceeds the capacity. If a directory is passed to `Lookup()` and
+// `Insert()`, entries are also persisted as files in that directory, so that
+// other processes can reuse them.
+class OptimizationCache {
+ public:
+  explicit OptimizationCache(int64 capacity_bytes);
+
+  // Returns the process-wide cache used by the meta optimizer.
+  static OptimizationCache* Global();
+
+  // Looks up the graph with the given fingerprint, in memory and then in
+  // `directory` if it is non-empty. Returns whether the graph was found.
+  bool Lookup(uint64 fingerprint, const string& directory, GraphDef* graph)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Caches `graph` under the given fingerprint, in memory and in `directory`
+  // if it is non-empty. Failures to persist the graph are logged and ignored.
+  void Insert(uint64 fingerprint, const string& directory,
+              const GraphDef& graph) TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the number of graphs cached in memory.
+  int64 size() TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct Entry {
+    std::shared_ptr<const GraphDef> graph;
+    int64 size_bytes;
+  };
+
+  void InsertInMemory(uint64 fingerprint, std::shared_ptr<const GraphDef> graph)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  const int64 capacity_bytes_;
+  mutex mu_;
+  absl::flat_hash_map<uint64, Entry> entries_ TF_GUARDED_BY(mu_);
+  // Fingerprints of the entries, from oldest to newest.
+  std::deque<uint64> insertion_order_ TF_GUARDED_BY(mu_);
+  int64 size_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace grappler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OPTIMIZATION_CACHE_H_
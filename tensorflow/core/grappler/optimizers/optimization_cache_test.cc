@@ -0,0 +1,79 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/optimization_cache.h"
+
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+GraphDef MakeGraph(const string& node_name) {
+  GraphDef graph;
+  NodeDef* node = graph.add_node();
+  node->set_name(node_name);
+  node->set_op("NoOp");
+  return graph;
+}
+
+TEST(OptimizationCacheTest, InMemory) {
+  OptimizationCache cache(/*capacity_bytes=*/1 << 20);
+  GraphDef graph;
+  EXPECT_FALSE(cache.Lookup(1, /*directory=*/"", &graph));
+
+  cache.Insert(1, /*directory=*/"", MakeGraph("a"));
+  cache.Insert(2, /*directory=*/"", MakeGraph("b"));
+  EXPECT_EQ(cache.size(), 2);
+  ASSERT_TRUE(cache.Lookup(1, /*directory=*/"", &graph));
+  EXPECT_EQ(graph.node(0).name(), "a");
+  ASSERT_TRUE(cache.Lookup(2, /*directory=*/"", &graph));
+  EXPECT_EQ(graph.node(0).name(), "b");
+}
+
+TEST(OptimizationCacheTest, EvictsOldestEntries) {
+  const int64 graph_size = MakeGraph("a").ByteSizeLong();
+  OptimizationCache cache(/*capacity_bytes=*/2 * graph_size);
+  cache.Insert(1, /*directory=*/"", MakeGraph("a"));
+  cache.Insert(2, /*directory=*/"", MakeGraph("b"));
+  cache.Insert(3, /*directory=*/"", MakeGraph("c"));
+  EXPECT_EQ(cache.size(), 2);
+  GraphDef graph;
+  EXPECT_FALSE(cache.Lookup(1, /*directory=*/"", &graph));
+  EXPECT_TRUE(cache.Lookup(2, /*directory=*/"", &graph));
+  EXPECT_TRUE(cache.Lookup(3, /*directory=*/"", &graph));
+}
+
+TEST(OptimizationCacheTest, PersistsInDirectory) {
+  const string directory =
+      io::JoinPath(testing::TmpDir(), "optimization_cache_test");
+  {
+    OptimizationCache cache(/*capacity_bytes=*/1 << 20);
+    cache.Insert(1, directory, MakeGraph("a"));
+  }
+  OptimizationCache cache(/*capacity_bytes=*/1 << 20);
+  GraphDef graph;
+  EXPECT_FALSE(cache.Lookup(1, /*directory=*/"", &graph));
+  ASSERT_TRUE(cache.Lookup(1, directory, &graph));
+  EXPECT_EQ(graph.node(0).name(), "a");
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_FALSE(cache.Lookup(2, directory, &graph));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
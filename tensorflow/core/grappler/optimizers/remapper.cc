@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
@@ -32,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/util/util.h"
 
 #if GOOGLE_CUDA
+#include "third_party/gpus/cuda/include/cuda.h"
 #include "third_party/gpus/cudnn/cudnn.h"
 #endif  // GOOGLE_CUDA
 
@@ -61,6 +63,22 @@ namespace grappler {
 //
 // In all cases, the supported activation functions are Relu, Relu6, and Elu.
 //
+// Chain of element-wise ops on CPU -> _FusedElementwise
+//   (1) <Elementwise> + <Elementwise> + ... where the other operand of each
+//       binary op is either a scalar or has the shape of the chain.
+//
+// Gather + SparseSegment{Sum,Mean,SqrtN}[WithNumSegments] on CPU
+//   -> SparseSegment{Sum,Mean,SqrtN}[WithNumSegments] reading from params
+//   (1) <Reduction>(Gather(params, ids), indices, ...) is rewritten into
+//       <Reduction>(params, Gather(ids, indices), ...), so the gathered
+//       embedding rows are never materialized.
+//
+// SparseApply{Adagrad,AdagradV2,Ftrl,FtrlV2} on CPU with deduplicated
+// gradients -> the same op with deduplicate_indices=true
+//   (1) <Apply>(..., UnsortedSegmentSum(grad, Unique(indices):1, n),
+//       Unique(indices):0, ...), as built by the optimizers for IndexedSlices
+//       gradients, is rewritten into <Apply>(..., grad, indices, ...).
+//
 // Both Conv2D and MatMul implemented as Tensor contraction (on CPU), so all the
 // patterns are "ContractionWith...".
 namespace {
@@ -69,6 +87,7 @@ constexpr char kFusedConv2D[] = "_FusedConv2D";
 constexpr char kFusedMatMul[] = "_FusedMatMul";
 constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
+constexpr char kFusedElementwise[] = "_FusedElementwise";
 
 constexpr char kDataFormat[] = "data_format";
 constexpr char kIsTraining[] = "is_training";
@@ -207,6 +226,34 @@ struct ContractionWithBiasAndAddActivation {
 };
 #endif  // INTEL_MKL
 
+// Chain of element-wise ops that can be replaced with a _FusedElementwise.
+struct ElementwiseChain {
+  // Nodes of the chain, from the first to the last one.
+  std::vector<int> nodes;
+  // Index of the regular fanin of each node that carries the chain value.
+  std::vector<int> chain_ports;
+};
+
+// Gather of embedding rows that is only consumed by a sparse segment
+// reduction, which can read the rows directly from the gathered params.
+struct SparseSegmentReductionWithGather {
+  int gather = kMissingIndex;
+  // Optional Identity between the Gather and the reduction.
+  int identity = kMissingIndex;
+  int reduction = kMissingIndex;
+};
+
+// Sparse apply op whose gradient rows are summed by index with Unique and
+// UnsortedSegmentSum, which the op can do itself with deduplicate_indices.
+struct SparseApplyWithDeduplicatedGradient {
+  int apply = kMissingIndex;
+  int grad_port = kMissingIndex;
+  int unique = kMissingIndex;
+  int segment_sum = kMissingIndex;
+  // Nodes that only compute the deduplicated gradient and indices.
+  std::vector<int> dead_nodes;
+};
+
 bool IsInPreserveSet(const RemapperContext& ctx, const NodeDef* node) {
   return ctx.nodes_to_preserve.count(node->name()) > 0;
 }
@@ -253,7 +300,7 @@ bool IsCpuCompatibleDataType(const NodeDef* contraction,
 bool IsGpuCompatibleDataType(const NodeDef* contraction,
                              const string& type_attr = "T") {
   DataType dtype = GetDataTypeFromAttr(*contraction, type_attr);
-  if (IsConv2D(*contraction)) {
+  if (IsConv2D(*contraction) || IsMatMul(*contraction)) {
     return dtype == DT_FLOAT;
   } else {
     return false;
@@ -293,6 +340,17 @@ bool IsCpuCompatibleMatMul(const NodeDef* matmul) {
   return NodeIsOnCpu(matmul) && IsCpuCompatibleDataType(matmul);
 }
 
+// _FusedMatMul on GPU is a single cublasLt matmul with a bias epilogue, which
+// requires CUDA 11.
+bool IsGpuCompatibleMatMul(const NodeDef* matmul) {
+  DCHECK(IsMatMul(*matmul)) << "Expected MatMul op";
+#if GOOGLE_CUDA && CUDA_VERSION >= 11000
+  return NodeIsOnGpu(matmul) && IsGpuCompatibleDataType(matmul);
+#else
+  return false;
+#endif  // GOOGLE_CUDA && CUDA_VERSION >= 11000
+}
+
 bool IsCpuCompatibleDepthwiseConv2dNative(const NodeDef* dw_conv2d) {
   DCHECK(IsDepthwiseConv2dNative(*dw_conv2d))
       << "Expected DepthwiseConv2dNative op";
@@ -321,7 +379,7 @@ bool IsCpuCompatible(const RemapperContext& ctx, const Pattern& matched) {
   }
 }
 
-// Checks if we can rewrite a pattern to the `_FusedConv2D` on GPU device.
+// Checks if we can rewrite a pattern to the `_Fused{Conv2D,MatMul}` on GPU.
 bool IsGpuCompatible(const RemapperContext& ctx,
                      const ContractionWithBiasAddAndActivation& matched) {
 #if TENSORFLOW_USE_ROCM
@@ -330,6 +388,12 @@ bool IsGpuCompatible(const RemapperContext& ctx,
 #endif
   const GraphDef* graph = ctx.graph_view.graph();
   const NodeDef& contraction_node = graph->node(matched.contraction);
+
+  // cublasLt fuses only the Relu activation into the matmul epilogue.
+  if (IsMatMul(contraction_node)) {
+    return IsRelu(graph->node(matched.activation)) &&
+           IsGpuCompatibleMatMul(&contraction_node);
+  }
   if (!IsConv2D(contraction_node)) return false;
 
   const std::vector<OpInfo::TensorProperties>& input_props =
@@ -355,7 +419,9 @@ bool IsGpuCompatible(const RemapperContext& ctx,
 }
 bool IsGpuCompatible(const RemapperContext& ctx,
                      const ContractionWithBiasAdd& matched) {
-  return false;
+  const NodeDef& contraction_node =
+      ctx.graph_view.graph()->node(matched.contraction);
+  return IsMatMul(contraction_node) && IsGpuCompatibleMatMul(&contraction_node);
 }
 bool IsGpuCompatible(const RemapperContext& ctx,
                      const ContractionWithSqueezeAndBiasAdd& matched) {
@@ -769,6 +835,289 @@ bool FindContractionWithBiasAndAddActivation(
 }
 #endif
 
+bool IsFusibleUnaryElementwise(const NodeDef& node) {
+  static const auto* const kOps = new absl::flat_hash_set<string>(
+      {"Abs", "Elu", "Exp", "Log", "Neg", "Relu", "Relu6", "Rsqrt", "Sigmoid",
+       "Sqrt", "Square", "Tanh"});
+  return kOps->contains(node.op());
+}
+
+bool IsFusibleBinaryElementwise(const NodeDef& node) {
+  static const auto* const kOps = new absl::flat_hash_set<string>(
+      {"Add", "AddV2", "Div", "Maximum", "Minimum", "Mul", "RealDiv",
+       "SquaredDifference", "Sub"});
+  return kOps->contains(node.op());
+}
+
+// Returns true if `node_view` is a CPU element-wise op supported by
+// _FusedElementwise.
+bool IsFusibleElementwise(const utils::MutableNodeView& node_view) {
+  const NodeDef* node = node_view.node();
+  if (!IsFusibleUnaryElementwise(*node) && !IsFusibleBinaryElementwise(*node)) {
+    return false;
+  }
+  const DataType dtype = GetDataTypeFromAttr(*node, "T");
+  return (dtype == DT_FLOAT || dtype == DT_DOUBLE) && NodeIsOnCpu(node) &&
+         node_view.NumControllingFanins() == 0;
+}
+
+// Returns the regular fanin of the element-wise `node_view` that carries the
+// value of a chain ending at `node_view`, or kMissingIndex if the node can't
+// be part of a chain. The other operand of a binary op must be a scalar or
+// have the shape of the chain, because _FusedElementwise does not broadcast.
+int ElementwiseChainPort(const RemapperContext& ctx,
+                         const utils::MutableNodeView& node_view) {
+  const NodeDef* node = node_view.node();
+  if (IsFusibleUnaryElementwise(*node)) return 0;
+  if (node_view.NumRegularFanins() != 2) return kMissingIndex;
+
+  const auto& props = ctx.graph_properties.GetInputProperties(node->name());
+  if (props.size() != 2) return kMissingIndex;
+  const auto is_valid_chain_port = [&](int port) -> bool {
+    const TensorShapeProto& other = props[1 - port].shape();
+    return (!other.unknown_rank() && other.dim_size() == 0) ||
+           ShapesSymbolicallyEqual(props[port].shape(), other);
+  };
+  const auto extends_chain = [&](int port) -> bool {
+    const auto& fanin = node_view.GetRegularFanin(port);
+    return fanin.index() == 0 && IsFusibleElementwise(*fanin.node_view());
+  };
+  // Prefer the operand that lets the chain grow.
+  for (int port : {0, 1}) {
+    if (is_valid_chain_port(port) && extends_chain(port)) return port;
+  }
+  for (int port : {0, 1}) {
+    if (is_valid_chain_port(port)) return port;
+  }
+  return kMissingIndex;
+}
+
+bool FindElementwiseChain(const RemapperContext& ctx, int node_index,
+                          ElementwiseChain* matched) {
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  if (!IsFusibleElementwise(*node_view)) return false;
+  const NodeDef* last = node_view->node();
+
+  std::vector<int> nodes;
+  std::vector<int> chain_ports;
+  while (true) {
+    const int chain_port = ElementwiseChainPort(ctx, *node_view);
+    if (chain_port == kMissingIndex) break;
+    nodes.push_back(node_view->node_index());
+    chain_ports.push_back(chain_port);
+
+    // The chain continues with the producer of the chain value, if its result
+    // is not used anywhere else.
+    const auto& fanin = node_view->GetRegularFanin(chain_port);
+    const auto* fanin_node_view = fanin.node_view();
+    const NodeDef* fanin_node = fanin_node_view->node();
+    if (fanin.index() != 0 || !IsFusibleElementwise(*fanin_node_view) ||
+        !HasAtMostOneFanoutAtPort0(*fanin_node_view) ||
+        HasControlFaninOrFanout(*fanin_node_view) ||
+        IsInPreserveSet(ctx, fanin_node) ||
+        fanin_node->device() != last->device() ||
+        !HaveSameDataType(fanin_node, last)) {
+      break;
+    }
+    node_view = fanin_node_view;
+  }
+  // A single op does not need to be fused.
+  if (nodes.size() < 2) return false;
+
+  std::reverse(nodes.begin(), nodes.end());
+  std::reverse(chain_ports.begin(), chain_ports.end());
+  matched->nodes = std::move(nodes);
+  matched->chain_ports = std::move(chain_ports);
+  return true;
+}
+
+bool IsSparseSegmentReduction(const NodeDef& node) {
+  static const auto* const kOps = new absl::flat_hash_set<string>(
+      {"SparseSegmentSum", "SparseSegmentMean", "SparseSegmentSqrtN",
+       "SparseSegmentSumWithNumSegments", "SparseSegmentMeanWithNumSegments",
+       "SparseSegmentSqrtNWithNumSegments"});
+  return kOps->contains(node.op());
+}
+
+bool IsScalarZeroConstant(const NodeDef& node) {
+  if (!IsConstant(node)) return false;
+  const auto value_attr = node.attr().find("value");
+  if (value_attr == node.attr().end()) return false;
+  Tensor value;
+  if (!value.FromProto(value_attr->second.tensor()) ||
+      value.NumElements() != 1) {
+    return false;
+  }
+  if (value.dtype() == DT_INT32) return value.flat<int32>()(0) == 0;
+  if (value.dtype() == DT_INT64) return value.flat<int64>()(0) == 0;
+  return false;
+}
+
+bool FindSparseSegmentReductionWithGather(
+    const RemapperContext& ctx, int node_index,
+    SparseSegmentReductionWithGather* matched) {
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const NodeDef* node_def = node_view->node();
+  // Sparse segment reductions only have CPU kernels.
+  if (!IsSparseSegmentReduction(*node_def) || !NodeIsOnCpu(node_def) ||
+      node_view->NumRegularFanins() < 2) {
+    return false;
+  }
+
+  // Nodes between the params and the reduction are removed by the rewrite.
+  const auto is_removable = [&](const utils::MutableNodeView& fanin) -> bool {
+    const NodeDef* fanin_def = fanin.node();
+    return HasAtMostOneFanoutAtPort0(fanin) &&
+           !HasControlFaninOrFanout(fanin) &&
+           !IsInPreserveSet(ctx, fanin_def) &&
+           fanin_def->device() == node_def->device();
+  };
+
+  // embedding_lookup adds an Identity after the Gather.
+  const auto* data = node_view->GetRegularFanin(0).node_view();
+  int identity = kMissingIndex;
+  if (IsIdentity(*data->node())) {
+    if (!is_removable(*data) || data->NumRegularFanins() != 1) return false;
+    identity = data->node_index();
+    data = data->GetRegularFanin(0).node_view();
+  }
+
+  const NodeDef* gather = data->node();
+  if (!IsGather(*gather) || !is_removable(*data)) return false;
+  if (gather->op() == "GatherV2") {
+    int batch_dims = 0;
+    if (TryGetNodeAttr(*gather, "batch_dims", &batch_dims) &&
+        batch_dims != 0) {
+      return false;
+    }
+    if (data->NumRegularFanins() != 3 ||
+        !IsScalarZeroConstant(*data->GetRegularFanin(2).node_view()->node())) {
+      return false;
+    }
+  }
+  // The composed indices have the index type of the Gather, which must be
+  // a valid index type of the reduction.
+  const DataType index_type = GetDataTypeFromAttr(*gather, "Tindices");
+  if (index_type != DT_INT32 && index_type != DT_INT64) return false;
+
+  matched->gather = data->node_index();
+  matched->identity = identity;
+  matched->reduction = node_index;
+  return true;
+}
+
+// Returns the input port of the gradient of a sparse apply op that supports
+// deduplicate_indices, or kMissingIndex. The indices follow the gradient.
+int SparseApplyGradPort(const NodeDef& node) {
+  static const auto* const kGradPorts =
+      new absl::flat_hash_map<string, int>({{"SparseApplyAdagrad", 3},
+                                            {"ResourceSparseApplyAdagrad", 3},
+                                            {"SparseApplyAdagradV2", 4},
+                                            {"ResourceSparseApplyAdagradV2", 4},
+                                            {"SparseApplyFtrl", 3},
+                                            {"ResourceSparseApplyFtrl", 3},
+                                            {"SparseApplyFtrlV2", 3},
+                                            {"ResourceSparseApplyFtrlV2", 3}});
+  const auto it = kGradPorts->find(node.op());
+  return it == kGradPorts->end() ? kMissingIndex : it->second;
+}
+
+// Marks the fanins of `node_index` as dead if all their fanouts, except
+// `ignored_fanout`, are dead. Nodes in `kept` stay alive.
+void MarkDeadFanins(const RemapperContext& ctx, int node_index,
+                    int ignored_fanout, const absl::flat_hash_set<int>& kept,
+                    std::vector<bool>* dead) {
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  std::vector<int> fanins;
+  for (const auto& fanin : node_view->GetRegularFanins()) {
+    fanins.push_back(fanin.node_index());
+  }
+  for (const auto& fanin : node_view->GetControllingFanins()) {
+    fanins.push_back(fanin.node_index());
+  }
+
+  const auto is_dead_fanout = [&](int fanout) -> bool {
+    return fanout == ignored_fanout || (*dead)[fanout];
+  };
+  for (int fanin : fanins) {
+    if ((*dead)[fanin] || kept.contains(fanin)) continue;
+    const auto* fanin_view = ctx.graph_view.GetNode(fanin);
+    const NodeDef* fanin_def = fanin_view->node();
+    if (IsInPreserveSet(ctx, fanin_def) || !IsFreeOfSideEffect(*fanin_def)) {
+      continue;
+    }
+    bool all_fanouts_dead = true;
+    for (const auto& port_fanouts : fanin_view->GetRegularFanouts()) {
+      for (const auto& fanout : port_fanouts) {
+        all_fanouts_dead &= is_dead_fanout(fanout.node_index());
+      }
+    }
+    for (const auto& fanout : fanin_view->GetControlledFanouts()) {
+      all_fanouts_dead &= is_dead_fanout(fanout.node_index());
+    }
+    if (!all_fanouts_dead) continue;
+    (*dead)[fanin] = true;
+    MarkDeadFanins(ctx, fanin, ignored_fanout, kept, dead);
+  }
+}
+
+bool FindSparseApplyWithDeduplicatedGradient(
+    const RemapperContext& ctx, int node_index,
+    SparseApplyWithDeduplicatedGradient* matched) {
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const NodeDef* node_def = node_view->node();
+  // deduplicate_indices is only supported by the CPU kernels.
+  const int grad_port = SparseApplyGradPort(*node_def);
+  if (grad_port == kMissingIndex || !NodeIsOnCpu(node_def) ||
+      node_view->NumRegularFanins() <= grad_port + 1) {
+    return false;
+  }
+  bool deduplicate_indices = false;
+  if (TryGetNodeAttr(*node_def, "deduplicate_indices", &deduplicate_indices) &&
+      deduplicate_indices) {
+    return false;
+  }
+
+  const auto& grad = node_view->GetRegularFanin(grad_port);
+  const auto* segment_sum = grad.node_view();
+  if (segment_sum->node()->op() != "UnsortedSegmentSum" ||
+      !HasAtMostOneFanoutAtPort0(*segment_sum) ||
+      HasControlFaninOrFanout(*segment_sum) ||
+      IsInPreserveSet(ctx, segment_sum->node()) ||
+      segment_sum->NumRegularFanins() != 3) {
+    return false;
+  }
+
+  // The gradient rows are summed by their position among the unique indices,
+  // and the op is applied on the unique indices.
+  const auto& indices = node_view->GetRegularFanin(grad_port + 1);
+  const auto& segment_ids = segment_sum->GetRegularFanin(1);
+  const auto* unique = indices.node_view();
+  if (unique->node()->op() != "Unique" || indices.index() != 0 ||
+      segment_ids.node_index() != unique->node_index() ||
+      segment_ids.index() != 1 || unique->NumRegularFanins() != 1) {
+    return false;
+  }
+
+  // The new op reads the gradient and the indices before deduplication.
+  const absl::flat_hash_set<int> kept = {
+      segment_sum->GetRegularFanin(0).node_index(),
+      unique->GetRegularFanin(0).node_index()};
+  std::vector<bool> dead(ctx.graph_view.NumNodes());
+  dead[segment_sum->node_index()] = true;
+  MarkDeadFanins(ctx, segment_sum->node_index(), node_index, kept, &dead);
+
+  matched->apply = node_index;
+  matched->grad_port = grad_port;
+  matched->unique = unique->node_index();
+  matched->segment_sum = segment_sum->node_index();
+  matched->dead_nodes.clear();
+  for (int i = 0; i < dead.size(); ++i) {
+    if (dead[i]) matched->dead_nodes.push_back(i);
+  }
+  return true;
+}
+
 bool FindFusedBatchNorm(const RemapperContext& ctx, int node_index,
                         FusedBatchNorm* matched) {
   const auto* node_view = ctx.graph_view.GetNode(node_index);
@@ -1441,6 +1790,129 @@ Status AddFusedBatchNormExNode(RemapperContext* ctx,
   return Status::OK();
 }
 
+Status AddFusedElementwiseNode(RemapperContext* ctx,
+                               const ElementwiseChain& matched,
+                               std::vector<bool>* invalidated_nodes,
+                               std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& first = graph->node(matched.nodes.front());
+  const NodeDef& last = graph->node(matched.nodes.back());
+  VLOG(2) << "Fuse " << matched.nodes.size()
+          << " element-wise ops into _FusedElementwise: first="
+          << first.name() << " last=" << last.name();
+
+  NodeDef fused_op;
+  fused_op.set_name(last.name());
+  fused_op.set_op(kFusedElementwise);
+  fused_op.set_device(last.device());
+  fused_op.add_input(first.input(matched.chain_ports.front()));  // 0: x
+
+  std::vector<string> fused_ops;
+  std::vector<bool> arg_is_lhs;
+  for (int i = 0; i < matched.nodes.size(); ++i) {
+    const NodeDef& node = graph->node(matched.nodes[i]);
+    fused_ops.push_back(node.op());
+    if (IsFusibleBinaryElementwise(node)) {
+      const int chain_port = matched.chain_ports[i];
+      fused_op.add_input(node.input(1 - chain_port));
+      arg_is_lhs.push_back(chain_port == 1);
+    }
+  }
+
+  auto* attr = fused_op.mutable_attr();
+  (*attr)["T"] = last.attr().at("T");
+  SetAttrValue(fused_ops, &(*attr)["fused_ops"]);
+  SetAttrValue(static_cast<int>(arg_is_lhs.size()), &(*attr)["num_args"]);
+  SetAttrValue(arg_is_lhs, &(*attr)["arg_is_lhs"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.nodes.back()] = true;
+  for (int i = 0; i + 1 < matched.nodes.size(); ++i) {
+    (*nodes_to_delete)[matched.nodes[i]] = true;
+  }
+
+  return Status::OK();
+}
+
+Status AddSparseSegmentReductionWithGatherNodes(
+    RemapperContext* ctx, const SparseSegmentReductionWithGather& matched,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& gather = graph->node(matched.gather);
+  const NodeDef& reduction = graph->node(matched.reduction);
+  VLOG(2) << "Fuse " << gather.op() << " into " << reduction.op()
+          << ": gather=" << gather.name() << " reduction=" << reduction.name();
+
+  // The reduction reads row ids[indices[i]] of the params instead of row
+  // indices[i] of the gathered rows.
+  NodeDef gathered_indices;
+  gathered_indices.set_name(
+      AddPrefixToNodeName("GatheredIndices", reduction.name()));
+  gathered_indices.set_op("Gather");
+  gathered_indices.set_device(reduction.device());
+  gathered_indices.add_input(gather.input(1));     // 0: ids
+  gathered_indices.add_input(reduction.input(1));  // 1: indices
+  auto* indices_attr = gathered_indices.mutable_attr();
+  (*indices_attr)["Tparams"] = gather.attr().at("Tindices");
+  (*indices_attr)["Tindices"] = reduction.attr().at("Tidx");
+  SetAttrValue(true, &(*indices_attr)["validate_indices"]);
+
+  NodeDef fused_op = reduction;
+  fused_op.set_input(0, gather.input(0));
+  fused_op.set_input(1, gathered_indices.name());
+  (*fused_op.mutable_attr())["Tidx"] = gather.attr().at("Tindices");
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(gathered_indices), &status);
+  TF_RETURN_IF_ERROR(status);
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.reduction] = true;
+  (*nodes_to_delete)[matched.gather] = true;
+  if (matched.identity != kMissingIndex) {
+    (*nodes_to_delete)[matched.identity] = true;
+  }
+
+  return Status::OK();
+}
+
+Status AddSparseApplyWithDeduplicateIndicesNode(
+    RemapperContext* ctx, const SparseApplyWithDeduplicatedGradient& matched,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& apply = graph->node(matched.apply);
+  const NodeDef& unique = graph->node(matched.unique);
+  const NodeDef& segment_sum = graph->node(matched.segment_sum);
+  VLOG(2) << "Fuse " << unique.op() << " and " << segment_sum.op() << " into "
+          << apply.op() << ": apply=" << apply.name();
+
+  NodeDef fused_op = apply;
+  fused_op.set_input(matched.grad_port, segment_sum.input(0));
+  fused_op.set_input(matched.grad_port + 1, unique.input(0));
+  SetAttrValue(true, &(*fused_op.mutable_attr())["deduplicate_indices"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.apply] = true;
+  for (int dead_node : matched.dead_nodes) {
+    (*nodes_to_delete)[dead_node] = true;
+  }
+
+  return Status::OK();
+}
+
 Status AddBatchNormNodes(RemapperContext* ctx, const FusedBatchNorm& matched) {
   const GraphDef* graph = ctx->graph_view.graph();
   const NodeDef& fused_node = graph->node(matched.fused_batch_norm);
@@ -1688,6 +2160,7 @@ bool IsContractionWithAdd(const RemapperContext& ctx, int node_index) {
 //   (2) Fusing side input and/or activation into FusedBatchNorm.
 //   (3) Fusing Conv2D biasadd and relu on GPU
 //   (4) INTEL_MKL specific: Conv2D -> Add or Conv2D -> BiasAdd -> Add.
+//   (5) Fusing chains of element-wise ops on CPU.
 bool RequiresInferredShapes(const RemapperContext& ctx, int node_index) {
   // Candidate for a FusedBatchNorm splitting.
   const auto* node_view = ctx.graph_view.GetNode(node_index);
@@ -1758,13 +2231,25 @@ bool RequiresInferredShapes(const RemapperContext& ctx, int node_index) {
     return false;
   };
 
+  // Candidate for an element-wise chain fusion.
+  const auto is_elementwise_chain_candidate = [&]() -> bool {
+    if (!IsFusibleElementwise(*node_view)) return false;
+    for (int i = 0; i < node_view->NumRegularFanins(); ++i) {
+      if (IsFusibleElementwise(*node_view->GetRegularFanin(i).node_view())) {
+        return true;
+      }
+    }
+    return false;
+  };
+
 #ifdef INTEL_MKL
   (void)is_relu_biasadd_conv2d_candidate;  // To fix unused variable error.
   return is_batch_norm_candidate() || is_batch_norm_fusion_candidate() ||
-         IsContractionWithAdd(ctx, node_index);
+         IsContractionWithAdd(ctx, node_index) ||
+         is_elementwise_chain_candidate();
 #else
   return is_relu_biasadd_conv2d_candidate() || is_batch_norm_candidate() ||
-         is_batch_norm_fusion_candidate();
+         is_batch_norm_fusion_candidate() || is_elementwise_chain_candidate();
 #endif  // INTEL_MKL
 }
 
@@ -1923,6 +2408,39 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       TF_RETURN_IF_ERROR(AddBatchNormNodes(&ctx, fused_batch_norm));
       continue;
     }
+
+    // Remap chains of element-wise ops into the _FusedElementwise, which
+    // makes a single pass over memory instead of one pass per op.
+    ElementwiseChain elementwise_chain;
+    if (allow_non_differentiable_rewrites &&
+        FindElementwiseChain(ctx, i, &elementwise_chain)) {
+      TF_RETURN_IF_ERROR(AddFusedElementwiseNode(
+          &ctx, elementwise_chain, &invalidated_nodes, &nodes_to_delete));
+      continue;
+    }
+
+    // Remap Gather+SparseSegment<Reduction> into a SparseSegment<Reduction>
+    // over the params with composed indices. The rewrite would turn the
+    // sparse gradient of the params into a dense one.
+    SparseSegmentReductionWithGather reduction_with_gather;
+    if (allow_non_differentiable_rewrites &&
+        FindSparseSegmentReductionWithGather(ctx, i, &reduction_with_gather)) {
+      TF_RETURN_IF_ERROR(AddSparseSegmentReductionWithGatherNodes(
+          &ctx, reduction_with_gather, &invalidated_nodes, &nodes_to_delete));
+      continue;
+    }
+
+    // Remap Unique+UnsortedSegmentSum+SparseApply<Optimizer> into the
+    // SparseApply<Optimizer> with deduplicate_indices, which aggregates the
+    // gradient rows itself and updates the unique rows in parallel.
+    SparseApplyWithDeduplicatedGradient apply_with_deduplicated_gradient;
+    if (FindSparseApplyWithDeduplicatedGradient(
+            ctx, i, &apply_with_deduplicated_gradient)) {
+      TF_RETURN_IF_ERROR(AddSparseApplyWithDeduplicateIndicesNode(
+          &ctx, apply_with_deduplicated_gradient, &invalidated_nodes,
+          &nodes_to_delete));
+      continue;
+    }
   }
 
   // Remove invalidated nodes.
@@ -24,9 +24,11 @@ limitations under the License.
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/utils/grappler_test.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/tensor_float_32_utils.h"
 #include "tensorflow/core/platform/test.h"
 
 #if GOOGLE_CUDA
+#include "third_party/gpus/cuda/include/cuda.h"
 #include "third_party/gpus/cudnn/cudnn.h"
 #endif  // GOOGLE_CUDA
 
@@ -390,6 +392,186 @@ TEST_F(RemapperTest, FuseConv2DWithBias) {
   test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
 }
 
+TEST_F(RemapperTest, FuseElementwiseChain) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto input_shape = ops::Placeholder::Shape({8, 32});
+  auto input = Placeholder(s.WithOpName("input"), DT_FLOAT, input_shape);
+  auto scale = Placeholder(s.WithOpName("scale"), DT_FLOAT, input_shape);
+  auto offset = Placeholder(s.WithOpName("offset"), DT_FLOAT,
+                            ops::Placeholder::Shape({}));
+  auto mul = ops::Mul(s.WithOpName("mul"), input, scale);
+  auto add = ops::Add(s.WithOpName("add"), offset, mul);
+  auto tanh = ops::Tanh(s.WithOpName("tanh"), add);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), tanh);
+
+  auto input_t = GenerateRandomTensor<DT_FLOAT>({8, 32});
+  auto scale_t = GenerateRandomTensor<DT_FLOAT>({8, 32});
+  auto offset_t = GenerateRandomTensor<DT_FLOAT>({});
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"input", input_t}, {"scale", scale_t}, {"offset", offset_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  // Place all nodes on CPU.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::AGGRESSIVE);  // trust placeholders shape
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "mul");
+    EXPECT_NE(node.name(), "add");
+    if (node.name() == "tanh") {
+      EXPECT_EQ(node.op(), "_FusedElementwise");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "input");
+      EXPECT_EQ(node.input(1), "scale");
+      EXPECT_EQ(node.input(2), "offset");
+
+      EXPECT_EQ(node.attr().at("num_args").i(), 2);
+      const auto fused_ops = node.attr().at("fused_ops").list().s();
+      ASSERT_EQ(fused_ops.size(), 3);
+      EXPECT_EQ(fused_ops[0], "Mul");
+      EXPECT_EQ(fused_ops[1], "Add");
+      EXPECT_EQ(fused_ops[2], "Tanh");
+
+      const auto arg_is_lhs = node.attr().at("arg_is_lhs").list().b();
+      ASSERT_EQ(arg_is_lhs.size(), 2);
+      EXPECT_FALSE(arg_is_lhs[0]);
+      EXPECT_TRUE(arg_is_lhs[1]);
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 1);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+}
+
+TEST_F(RemapperTest, FuseGatherIntoSparseSegmentReduction) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto params_t = GenerateRandomTensor<DT_FLOAT>({10, 4});
+  auto params = ops::Const(s.WithOpName("params"), params_t);
+  auto ids = Placeholder(s.WithOpName("ids"), DT_INT64);
+  auto indices = Placeholder(s.WithOpName("indices"), DT_INT32);
+  auto segment_ids = Placeholder(s.WithOpName("segment_ids"), DT_INT32);
+  auto axis = ops::Const(s.WithOpName("axis"), 0);
+  auto gather = ops::GatherV2(s.WithOpName("gather"), params, ids, axis);
+  auto embeddings = ops::Identity(s.WithOpName("embeddings"), gather);
+  auto mean = ops::SparseSegmentMean(s.WithOpName("mean"), embeddings, indices,
+                                     segment_ids);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), mean);
+
+  auto ids_t = test::AsTensor<int64>({7, 2, 9, 0});
+  auto indices_t = test::AsTensor<int32>({0, 1, 1, 3, 2, 0});
+  auto segment_ids_t = test::AsTensor<int32>({0, 0, 1, 1, 1, 2});
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {
+      {"ids", ids_t}, {"indices", indices_t}, {"segment_ids", segment_ids_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  // Place all nodes on CPU.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "gather");
+    EXPECT_NE(node.name(), "embeddings");
+    if (node.name() == "mean") {
+      EXPECT_EQ(node.op(), "SparseSegmentMean");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "params");
+      EXPECT_EQ(node.input(1), "mean/GatheredIndices");
+      EXPECT_EQ(node.input(2), "segment_ids");
+      EXPECT_EQ(node.attr().at("Tidx").type(), DT_INT64);
+      found++;
+    } else if (node.name() == "mean/GatheredIndices") {
+      EXPECT_EQ(node.op(), "Gather");
+      ASSERT_EQ(node.input_size(), 2);
+      EXPECT_EQ(node.input(0), "ids");
+      EXPECT_EQ(node.input(1), "indices");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 2);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+}
+
+TEST_F(RemapperTest, FuseGradientDeduplicationIntoSparseApply) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto var = ops::Variable(s.WithOpName("var"), {10, 4}, DT_FLOAT);
+  auto accum = ops::Variable(s.WithOpName("accum"), {10, 4}, DT_FLOAT);
+  auto lr = ops::Const(s.WithOpName("lr"), 0.1f);
+  auto epsilon = ops::Const(s.WithOpName("epsilon"), 1e-7f);
+  auto values = Placeholder(s.WithOpName("values"), DT_FLOAT);
+  auto indices = Placeholder(s.WithOpName("indices"), DT_INT64);
+  auto unique = ops::Unique(s.WithOpName("unique"), indices);
+  auto num_unique = ops::Size(s.WithOpName("num_unique"), unique.y);
+  auto summed_values = ops::UnsortedSegmentSum(
+      s.WithOpName("summed_values"), values, unique.idx, num_unique);
+  auto apply = ops::SparseApplyAdagradV2(
+      s.WithOpName("apply"), var, accum, lr, epsilon, summed_values, unique.y);
+
+  GrapplerItem item;
+  item.fetch = {"apply"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  // Place all nodes on CPU.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "unique");
+    EXPECT_NE(node.name(), "num_unique");
+    EXPECT_NE(node.name(), "summed_values");
+    if (node.name() == "apply") {
+      EXPECT_EQ(node.op(), "SparseApplyAdagradV2");
+      ASSERT_EQ(node.input_size(), 6);
+      EXPECT_EQ(node.input(4), "values");
+      EXPECT_EQ(node.input(5), "indices");
+      EXPECT_TRUE(node.attr().at("deduplicate_indices").b());
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 1);
+}
+
 class RemapperFuseMatMulWithBiasTest : public RemapperTest {
  public:
   template <DataType DTYPE>
@@ -541,6 +723,79 @@ TEST_F(RemapperTest, DISABLED_FuseConv2DWithBiasAndActivationOnGPU) {
   }
 }
 
+TEST_F(RemapperTest, FuseMatMulWithBiasAndActivationOnGPU) {
+#if !(GOOGLE_CUDA && CUDA_VERSION >= 11000)
+  GTEST_SKIP() << "No cublasLt, skip FuseMatMulWithBiasAndActivation on GPU";
+#endif  // !(GOOGLE_CUDA && CUDA_VERSION >= 11000)
+  // Requires full precision MatMul op
+  tensorflow::enable_tensor_float_32_execution(false);
+  using ::tensorflow::ops::Placeholder;
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto lhs_shape = Placeholder::Shape({8, 32});
+  auto rhs_shape = Placeholder::Shape({32, 64});
+  auto bias_shape = Placeholder::Shape({64});
+
+  auto lhs = Placeholder(s.WithOpName("lhs"), DT_FLOAT, lhs_shape);
+  auto rhs = Placeholder(s.WithOpName("rhs"), DT_FLOAT, rhs_shape);
+  auto bias = Placeholder(s.WithOpName("bias"), DT_FLOAT, bias_shape);
+
+  auto matmul = ops::MatMul(s.WithOpName("matmul"), lhs, rhs);
+  auto bias_add = ops::BiasAdd(s.WithOpName("bias_add"), matmul, bias);
+
+  ops::Identity fetch = [&]() -> ops::Identity {
+    auto activate = s.WithOpName("activation");
+    auto fetch = s.WithOpName("fetch");
+    return ops::Identity(fetch, ops::Relu(activate, bias_add));
+  }();
+
+  auto lhs_t = GenerateRandomTensor<DT_FLOAT>({8, 32});
+  auto rhs_t = GenerateRandomTensor<DT_FLOAT>({32, 64});
+  auto bias_t = GenerateRandomTensor<DT_FLOAT>({64});
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"lhs", lhs_t}, {"rhs", rhs_t}, {"bias", bias_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  // Place all nodes on GPU.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:GPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "activation") {
+      EXPECT_EQ(node.op(), "_FusedMatMul");
+      ASSERT_GE(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "lhs");
+      EXPECT_EQ(node.input(1), "rhs");
+
+      EXPECT_EQ(node.attr().at("num_args").i(), 1);
+      EXPECT_EQ(node.input(2), "bias");
+
+      const auto fused_ops = node.attr().at("fused_ops").list().s();
+      ASSERT_EQ(fused_ops.size(), 2);
+      EXPECT_EQ(fused_ops[0], "BiasAdd");
+      EXPECT_EQ(fused_ops[1], "Relu");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 1);
+
+  if (GetNumAvailableGPUs() > 0) {
+    auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+    ASSERT_EQ(tensors_expected.size(), 1);
+    auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+    ASSERT_EQ(tensors.size(), 1);
+    test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-5);
+  }
+}
+
 TEST_F(RemapperTest, FuseConv2DWithBiasAndActivation) {
   using ::tensorflow::ops::Placeholder;
 
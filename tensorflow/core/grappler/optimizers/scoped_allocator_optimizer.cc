@@ -14,8 +14,12 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/grappler/optimizers/scoped_allocator_optimizer.h"
 
+#include <map>
+
+#include "absl/strings/match.h"
 #include "tensorflow/core/common_runtime/scoped_allocator.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
+#include "tensorflow/core/framework/attr_value_util.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/node_def_util.h"
@@ -667,10 +671,8 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
     op_builder.Device(device_name);
 
     // Transfer the Node Attr from the first replaced Node to the new
-    // Node.  TODO(tucker): In principle we should verify that
-    // the Attr are consistent and compatible across all op instances.
-    // Unfortunately that will probably require op-specific tests, so
-    // punt on that for the time being.
+    // Node.  The ops have already been partitioned by PartitionByAttrs so
+    // every attr but the instance_key of collectives agrees.
     AttrSlice first_slice(*ops[0]);
     for (auto& it : first_slice) {
       op_builder.Attr(it.first, it.second);
@@ -888,7 +890,7 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
 
 ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
     RewriterConfig::Toggle opt_level, const ScopedAllocatorOptions& opts)
-    : opt_level_(opt_level) {
+    : opt_level_(opt_level), max_pack_bytes_(opts.max_pack_bytes()) {
   VLOG(1) << "ScopedAllocatorOptimizer::ScopedAllocatorOptimizer";
   Rewriter* r = new UnaryElementwiseRewriter();
   to_delete_.push_back(r);
@@ -1060,6 +1062,84 @@ void PartitionByLoopStructure(const FrameView& frame_view,
   }
 }
 
+// The rewritten instances are replaced by a single one that takes the
+// attributes of the first, so they can be grouped only if they agree on every
+// attribute: e.g. the alpha of LeakyRelu, or the group, merge and final ops and
+// subdiv offsets of collectives.  Collectives are exempt from matching
+// instance_key, which differs per instance by design.  Splits nodes into
+// compatible subsets.
+void PartitionByAttrs(const std::vector<NodeDef*>& nodes,
+                      std::vector<std::vector<NodeDef*>>* groups) {
+  if (nodes.empty()) return;
+  const bool is_collective = IsCollective(*nodes[0]);
+  std::map<string, std::vector<NodeDef*>> attr_sets;
+  for (NodeDef* nd : nodes) {
+    std::map<string, const AttrValue*> sorted_attrs;
+    for (const auto& it : nd->attr()) {
+      if ((is_collective && it.first == "instance_key") ||
+          absl::StartsWith(it.first, "_")) {
+        continue;
+      }
+      sorted_attrs[it.first] = &it.second;
+    }
+    string signature;
+    for (const auto& it : sorted_attrs) {
+      strings::StrAppend(&signature, it.first, "=",
+                         SummarizeAttrValue(*it.second), ";");
+    }
+    attr_sets[signature].push_back(nd);
+  }
+  for (auto& it : attr_sets) {
+    groups->push_back(std::move(it.second));
+  }
+}
+
+// Returns the size in bytes of the single output of `nd`, or -1 if it is not
+// statically known.
+int64 OutputBytes(const GraphProperties& graph_properties, const NodeDef& nd) {
+  if (!graph_properties.HasOutputProperties(nd.name())) return -1;
+  const std::vector<OpInfo::TensorProperties>& prop_list =
+      graph_properties.GetOutputProperties(nd.name());
+  if (prop_list.size() != 1) return -1;
+  const OpInfo::TensorProperties& props = prop_list[0];
+  if (!TensorShape::IsValid(props.shape()) || props.shape().unknown_rank()) {
+    return -1;
+  }
+  const TensorShape shape(props.shape());
+  return shape.num_elements() * DataTypeSize(props.dtype());
+}
+
+// Splits the ordered `nodes` into consecutive packs whose known output sizes
+// sum to at most max_pack_bytes.  Nodes that alone exceed the limit are
+// dropped, since packing gains little over their own transfer time.  Nodes
+// with unknown size are kept so that the Rewriter can reject the group.
+void PartitionByPackSize(const GraphProperties& graph_properties,
+                         int64 max_pack_bytes,
+                         const std::vector<NodeDef*>& nodes,
+                         std::vector<std::vector<NodeDef*>>* packs) {
+  if (max_pack_bytes <= 0) {
+    packs->push_back(nodes);
+    return;
+  }
+  std::vector<NodeDef*> pack;
+  int64 pack_bytes = 0;
+  for (NodeDef* nd : nodes) {
+    const int64 bytes = std::max<int64>(0, OutputBytes(graph_properties, *nd));
+    if (bytes > max_pack_bytes) {
+      VLOG(2) << "Not packing " << nd->name() << " of " << bytes << " bytes";
+      continue;
+    }
+    if (pack_bytes + bytes > max_pack_bytes) {
+      packs->push_back(std::move(pack));
+      pack.clear();
+      pack_bytes = 0;
+    }
+    pack.push_back(nd);
+    pack_bytes += bytes;
+  }
+  if (!pack.empty()) packs->push_back(std::move(pack));
+}
+
 // Identify outputs that are inputs to multiple sets of nodes.
 void IdentifyRepeatedInputs(const std::vector<NodeDef*>& nodes,
                             absl::flat_hash_set<string>* seen_outputs,
@@ -1121,21 +1201,30 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
         // in the same Tree struct.  Split those groups into subgroups that
         // share identical loop nesting.
         status = ApplyToAll(root.get(), [this, rewriter, graph, &frame_view,
-                                         &op_name, invocation_count](Tree* t) {
+                                         &graph_properties, &op_name,
+                                         invocation_count](Tree* t) {
           VLOG(2) << "applied to tree node " << t->edge_ << " at depth "
                   << t->depth_ << " of size " << t->nodes_.size();
           if (t->nodes_.size() > 1) {
             std::vector<std::vector<NodeDef*>> loop_groups;
             PartitionByLoopStructure(frame_view, t->nodes_, &loop_groups);
             for (auto& lg : loop_groups) {
-              if (lg.size() > 1) {
-                bool applied = false;
-                Status s = OrderNodeSet(&lg);
-                TF_RETURN_IF_ERROR(s);
-                VLOG(1) << "Applying Rewriter for " << op_name;
-                s = rewriter->Rewrite(this, invocation_count, graph, op_name,
-                                      lg, &applied);
-                LOG_WARNING_AND_RETURN_IF_ERROR(s);
+              std::vector<std::vector<NodeDef*>> attr_groups;
+              PartitionByAttrs(lg, &attr_groups);
+              for (auto& ag : attr_groups) {
+                if (ag.size() <= 1) continue;
+                TF_RETURN_IF_ERROR(OrderNodeSet(&ag));
+                std::vector<std::vector<NodeDef*>> packs;
+                PartitionByPackSize(graph_properties, max_pack_bytes_, ag,
+                                    &packs);
+                for (auto& pack : packs) {
+                  if (pack.size() <= 1) continue;
+                  bool applied = false;
+                  VLOG(1) << "Applying Rewriter for " << op_name;
+                  Status s = rewriter->Rewrite(this, invocation_count, graph,
+                                               op_name, pack, &applied);
+                  LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                }
               }
             }
           }
@@ -107,6 +107,29 @@ class ScopedAllocatorOptimizerTest : public ::testing::Test {
     TF_CHECK_OK(s.ToGraphDef(graph_def));
   }
 
+  // Constructs the graph of BuildAbsGraph, with LeakyRelu ops l1 and l2 of
+  // the given alphas in place of a1 and a2.
+  void BuildLeakyReluGraph(GraphDef* graph_def, float alpha1, float alpha2) {
+    Scope s = Scope::NewRootScope();
+    s = s.WithDevice("/job:localhost/replica:0/task:0/device:CPU:0");
+
+    Output a =
+        ops::Const<float>(s.WithOpName("a"), {1.0, 0.0, 0.0, -1.0}, {2, 2});
+    Output b =
+        ops::Const<float>(s.WithOpName("b"), {1.0, -2.0, 3.0, 4.0}, {2, 2});
+    Output c =
+        ops::Const<float>(s.WithOpName("c"), {-5.0, -2.0, 0.0, -2.0}, {2, 2});
+    Output s1 = ops::Add(s.WithOpName("s1"), a, b);
+    Output s2 = ops::Add(s.WithOpName("s2"), b, c);
+    Output l1 = ops::LeakyRelu(s.WithOpName("l1"), s1,
+                               ops::LeakyRelu::Alpha(alpha1));
+    Output l2 = ops::LeakyRelu(s.WithOpName("l2"), s2,
+                               ops::LeakyRelu::Alpha(alpha2));
+    Output r1 = ops::Reshape(s.WithOpName("r1"), l1, {1, 4});
+    Output r2 = ops::Reshape(s.WithOpName("r2"), l2, {4, 1});
+    TF_CHECK_OK(s.ToGraphDef(graph_def));
+  }
+
   // Constructs the following graph.
   // (Flow is top to bottom, like nature intends.)
   //
@@ -273,7 +296,7 @@ class ScopedAllocatorOptimizerTest : public ::testing::Test {
     shape_proto.add_dim()->set_size(2);
 
     for (NodeDef& n : *graph_def->mutable_node()) {
-      if (n.op() == "Add" || n.op() == "Abs") {
+      if (n.op() == "Add" || n.op() == "Abs" || n.op() == "LeakyRelu") {
         AddNodeAttr("_output_shapes", {shape_proto}, &n);
       }
     }
@@ -596,6 +619,71 @@ TEST_F(ScopedAllocatorOptimizerTest, ConstInput) {
   EXPECT_EQ(num_identity_ops, 2);
 }
 
+// Test that max_pack_bytes bounds the combined size of a rewritten group.
+TEST_F(ScopedAllocatorOptimizerTest, MaxPackBytes) {
+  GrapplerItem item;
+  BuildAbsGraph(&item.graph, false);
+  SetShapes(&item.graph);
+
+  auto count_scoped_allocators = [](const GraphDef& graph) {
+    int count = 0;
+    for (const NodeDef& node : graph.node()) {
+      if (node.op() == "_ScopedAllocator") ++count;
+    }
+    return count;
+  };
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("Abs");
+  // Each Abs output is a 2x2 float tensor of 16 bytes, so only one fits.
+  opts.set_max_pack_bytes(16);
+  {
+    ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+    GraphDef optimized_graph;
+    TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+    EXPECT_EQ(count_scoped_allocators(optimized_graph), 0);
+  }
+  opts.set_max_pack_bytes(32);
+  {
+    ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+    GraphDef optimized_graph;
+    TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+    EXPECT_EQ(count_scoped_allocators(optimized_graph), 1);
+  }
+}
+
+// Test that only ops agreeing on all attributes share a ScopedAllocator.
+TEST_F(ScopedAllocatorOptimizerTest, AttrMismatch) {
+  auto count_scoped_allocators = [](const GraphDef& graph) {
+    int count = 0;
+    for (const NodeDef& node : graph.node()) {
+      if (node.op() == "_ScopedAllocator") ++count;
+    }
+    return count;
+  };
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("LeakyRelu");
+  {
+    GrapplerItem item;
+    BuildLeakyReluGraph(&item.graph, 0.1f, 0.2f);
+    SetShapes(&item.graph);
+    ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+    GraphDef optimized_graph;
+    TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+    EXPECT_EQ(count_scoped_allocators(optimized_graph), 0);
+  }
+  {
+    GrapplerItem item;
+    BuildLeakyReluGraph(&item.graph, 0.1f, 0.1f);
+    SetShapes(&item.graph);
+    ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+    GraphDef optimized_graph;
+    TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+    EXPECT_EQ(count_scoped_allocators(optimized_graph), 1);
+  }
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
@@ -86,6 +86,7 @@ class BatchResource : public serving::BatchResourceBase {
   static Status Create(int32 num_batch_threads, int32 max_batch_size,
                        int32 batch_timeout_micros, int32 max_enqueued_batches,
                        const std::vector<int32>& allowed_batch_sizes,
+                       const std::vector<int32>& length_bucket_boundaries,
                        FunctionLibraryRuntime::Handle fhandle,
                        bool enable_large_batch_splitting,
                        std::unique_ptr<BatchResource>* resource) {
@@ -100,7 +101,7 @@ class BatchResource : public serving::BatchResourceBase {
                                batch_timeout_micros, max_enqueued_batches,
                                allowed_batch_sizes,
                                enable_large_batch_splitting),
-        allowed_batch_sizes));
+        allowed_batch_sizes, length_bucket_boundaries));
     return Status::OK();
   }
 
@@ -108,6 +109,7 @@ class BatchResource : public serving::BatchResourceBase {
       AdaptiveBatcherT::Options adaptive_shared_batch_scheduler_options,
       int32 max_batch_size, int32 batch_timeout_micros,
       int32 max_enqueued_batches, const std::vector<int32>& allowed_batch_sizes,
+      const std::vector<int32>& length_bucket_boundaries,
       FunctionLibraryRuntime::Handle fhandle,
       std::unique_ptr<BatchResource>* resource) {
     std::shared_ptr<AdaptiveBatcherT> batcher;
@@ -118,7 +120,7 @@ class BatchResource : public serving::BatchResourceBase {
         fhandle, std::move(batcher),
         GetAdaptiveBatcherQueueOptions(max_batch_size, batch_timeout_micros,
                                        max_enqueued_batches, true),
-        allowed_batch_sizes));
+        allowed_batch_sizes, length_bucket_boundaries));
     return Status::OK();
   }
 
@@ -128,21 +130,25 @@ class BatchResource : public serving::BatchResourceBase {
   BatchResource(FunctionLibraryRuntime::Handle fhandle,
                 std::shared_ptr<BatcherT> batcher,
                 const BatcherT::QueueOptions& batcher_queue_options,
-                std::vector<int32> allowed_batch_sizes)
+                std::vector<int32> allowed_batch_sizes,
+                std::vector<int32> length_bucket_boundaries)
       : BatchResourceBase(
             /*has_process_batch_function=*/fhandle != kInvalidHandle,
             std::move(batcher), batcher_queue_options,
-            std::move(allowed_batch_sizes)),
+            std::move(allowed_batch_sizes),
+            std::move(length_bucket_boundaries)),
         fhandle_(fhandle) {}
 
   BatchResource(FunctionLibraryRuntime::Handle fhandle,
                 std::shared_ptr<AdaptiveBatcherT> batcher,
                 const AdaptiveBatcherT::QueueOptions& batcher_queue_options,
-                std::vector<int32> allowed_batch_sizes)
+                std::vector<int32> allowed_batch_sizes,
+                std::vector<int32> length_bucket_boundaries)
       : BatchResourceBase(
             /*has_process_batch_function=*/fhandle != kInvalidHandle,
             std::move(batcher), batcher_queue_options,
-            std::move(allowed_batch_sizes)),
+            std::move(allowed_batch_sizes),
+            std::move(length_bucket_boundaries)),
         fhandle_(fhandle) {}
 
   void ProcessFuncBatchImpl(
@@ -228,7 +234,13 @@ class BatchFunctionKernel : public AsyncOpKernel {
       has_attribute_enable_large_batch_splitting_ = false;
     }
 
+    if (c->HasAttr("length_bucket_boundaries")) {
+      OP_REQUIRES_OK(c, c->GetAttr("length_bucket_boundaries",
+                                   &length_bucket_boundaries_));
+    }
+
     OP_REQUIRES_OK(c, ValidateAllowedBatchSizes());
+    OP_REQUIRES_OK(c, ValidateLengthBucketBoundaries());
   }
 
   bool IsExpensive() override { return false; }
@@ -279,7 +291,7 @@ class BatchFunctionKernel : public AsyncOpKernel {
         TF_RETURN_IF_ERROR(BatchResource::Create(
             adaptive_shared_batch_scheduler_options, max_batch_size_,
             batch_timeout_micros_, max_enqueued_batches_, allowed_batch_sizes_,
-            handle, &new_resource));
+            length_bucket_boundaries_, handle, &new_resource));
         *r = new_resource.release();
         return Status::OK();
       };
@@ -288,8 +300,9 @@ class BatchFunctionKernel : public AsyncOpKernel {
         std::unique_ptr<BatchResource> new_resource;
         TF_RETURN_IF_ERROR(BatchResource::Create(
             num_batch_threads_, max_batch_size_, batch_timeout_micros_,
-            max_enqueued_batches_, allowed_batch_sizes_, handle,
-            enable_large_batch_splitting_, &new_resource));
+            max_enqueued_batches_, allowed_batch_sizes_,
+            length_bucket_boundaries_, handle, enable_large_batch_splitting_,
+            &new_resource));
         *r = new_resource.release();
         return Status::OK();
       };
@@ -406,6 +419,24 @@ class BatchFunctionKernel : public AsyncOpKernel {
     return Status::OK();
   }
 
+  // Validates 'length_bucket_boundaries_'. The entries must be positive and
+  // increase monotonically.
+  Status ValidateLengthBucketBoundaries() const {
+    for (size_t i = 0; i < length_bucket_boundaries_.size(); ++i) {
+      const int32 boundary = length_bucket_boundaries_[i];
+      if (boundary <= 0) {
+        return errors::InvalidArgument(
+            "length_bucket_boundaries entries must be positive");
+      }
+      if (i > 0 && boundary <= length_bucket_boundaries_[i - 1]) {
+        return errors::InvalidArgument(
+            "length_bucket_boundaries entries must be monotonically "
+            "increasing");
+      }
+    }
+    return Status::OK();
+  }
+
  private:
   string container_;
   string shared_name_;
@@ -415,6 +446,7 @@ class BatchFunctionKernel : public AsyncOpKernel {
   int32 batch_timeout_micros_;
   int32 max_enqueued_batches_;
   std::vector<int32> allowed_batch_sizes_;
+  std::vector<int32> length_bucket_boundaries_;
   NameAttrList func_;
   absl::optional<FunctionLibraryRuntime::Handle> fhandle_ TF_GUARDED_BY(mu_);
   bool enable_large_batch_splitting_;
@@ -471,7 +503,8 @@ class BatchKernel : public AsyncOpKernel {
       std::unique_ptr<BatchResource> new_resource;
       TF_RETURN_IF_ERROR(BatchResource::Create(
           num_batch_threads_, max_batch_size_, batch_timeout_micros_,
-          max_enqueued_batches_, allowed_batch_sizes_, kInvalidHandle, false,
+          max_enqueued_batches_, allowed_batch_sizes_,
+          /*length_bucket_boundaries=*/{}, kInvalidHandle, false,
           &new_resource));
       *r = new_resource.release();
       return Status::OK();
@@ -601,6 +601,9 @@ ASBSQueue<TaskType>::~ASBSQueue() {
 
 template <typename TaskType>
 Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
+  if ((*task)->IsExpired()) {
+    return errors::DeadlineExceeded("Task expired before it was scheduled");
+  }
   size_t size = (*task)->size();
   if (options_.split_input_task_func == nullptr &&
       size > options_.max_batch_size) {
@@ -15,10 +15,15 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/batching_util/batch_resource_base.h"
 
+#include <cstring>
+
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/framework/ops_util.h"
 #include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/batching_util/concat_split_util.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/lib/monitoring/percentile_sampler.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
@@ -64,6 +69,15 @@ void RecordProcessedBatchSize(int32 batch_size, const string& model_name) {
   cell->GetCell(model_name)->Add(static_cast<double>(batch_size));
 }
 
+void RecordExpiredTasks(int64 num_tasks, const string& model_name) {
+  static auto* cell = monitoring::Counter<1>::New(
+      "/tensorflow/serving/batching/expired_tasks",
+      "Tracks the number of tasks dropped by model_name (if available) because "
+      "they expired before they were processed.",
+      "model_name");
+  cell->GetCell(model_name)->IncrementBy(num_tasks);
+}
+
 void RecordBatchDelayUs(int64 batch_delay_us, const string& model_name) {
   static auto* cell = monitoring::PercentileSampler<1>::New(
       {"/tensorflow/serving/batching/batch_delay_us",
@@ -202,12 +216,95 @@ Status BatchResourceBase::RegisterInput(
   batch_components->output = std::make_shared<TensorMatrix>();
   batch_components->status = std::make_shared<ThreadSafeStatus>();
 
+  string queue_name = batcher_queue_name;
+  TF_RETURN_IF_ERROR(PadToLengthBucket(batch_components.get(), &queue_name));
+
   BatcherQueueT* batcher_queue;
-  TF_RETURN_IF_ERROR(
-      LookupOrCreateBatcherQueue(batcher_queue_name, &batcher_queue));
+  TF_RETURN_IF_ERROR(LookupOrCreateBatcherQueue(queue_name, &batcher_queue));
   return batcher_queue->Schedule(&batch_components);
 }
 
+Status BatchResourceBase::PadToLengthBucket(BatchTask* task,
+                                            string* queue_name) const {
+  if (length_bucket_boundaries_.empty()) {
+    return Status::OK();
+  }
+
+  std::vector<Tensor>& inputs = task->inputs;
+  if (inputs[0].dims() < 2) {
+    return errors::InvalidArgument(
+        "Batching input tensors must have at least two dimensions when "
+        "length_bucket_boundaries is set; got shape ",
+        inputs[0].shape().DebugString());
+  }
+  const int64 length = inputs[0].dim_size(1);
+  for (const Tensor& input : inputs) {
+    if (input.dims() < 2 || input.dim_size(1) != length) {
+      return errors::InvalidArgument(
+          "Batching input tensors supplied in a given op invocation must "
+          "have equal 1st-dimension size when length_bucket_boundaries is "
+          "set; got shapes ",
+          inputs[0].shape().DebugString(), " and ",
+          input.shape().DebugString());
+    }
+  }
+
+  // Inputs longer than the last boundary are batched with inputs of the same
+  // length only, without padding.
+  int64 padded_length = length;
+  for (int32 boundary : length_bucket_boundaries_) {
+    if (boundary >= length) {
+      padded_length = boundary;
+      break;
+    }
+  }
+  absl::StrAppend(queue_name, "/length_bucket_", padded_length);
+  if (padded_length == length) {
+    return Status::OK();
+  }
+
+  for (Tensor& input : inputs) {
+    TensorShape padded_shape = input.shape();
+    padded_shape.set_dim(1, padded_length);
+    Tensor padded;
+    AllocatorAttributes attr;
+    attr.set_on_host(true);
+    TF_RETURN_IF_ERROR(task->context->allocate_temp(
+        input.dtype(), padded_shape, &padded, attr));
+
+    // Copy each row of 'input' to the start of the matching row of 'padded',
+    // and fill the rest of that row with zeros.
+    const int64 num_rows = input.dim_size(0);
+    const int64 row_elements = input.NumElements() / num_rows;
+    const int64 padded_row_elements = padded.NumElements() / num_rows;
+    if (DataTypeCanUseMemcpy(input.dtype())) {
+      const int64 element_size = DataTypeSize(input.dtype());
+      const char* from = input.tensor_data().data();
+      char* to = const_cast<char*>(padded.tensor_data().data());
+      std::memset(to, 0, padded.TotalBytes());
+      for (int64 row = 0; row < num_rows; ++row) {
+        std::memcpy(to + row * padded_row_elements * element_size,
+                    from + row * row_elements * element_size,
+                    row_elements * element_size);
+      }
+    } else if (input.dtype() == DT_STRING) {
+      auto from = input.flat<tstring>();
+      auto to = padded.flat<tstring>();
+      for (int64 row = 0; row < num_rows; ++row) {
+        for (int64 i = 0; i < row_elements; ++i) {
+          to(row * padded_row_elements + i) = from(row * row_elements + i);
+        }
+      }
+    } else {
+      return errors::InvalidArgument(
+          "Cannot pad batching input tensors of type ",
+          DataTypeString(input.dtype()), " to a length bucket");
+    }
+    input = std::move(padded);
+  }
+  return Status::OK();
+}
+
 /*static*/ BatchResourceBase::BatcherT::QueueOptions
 BatchResourceBase::GetBatcherQueueOptions(
     int32 num_batch_threads, int32 max_batch_size, int32 batch_timeout_micros,
@@ -312,6 +409,15 @@ Status BatchResourceBase::ConcatInputTensors(
   const int num_inputs = batch.task(0).inputs.size();
   concatenated_tensors->reserve(num_inputs);
 
+  // A single task that needs no padding is already a batch; pass its inputs
+  // through rather than copying them.
+  if (batch.num_tasks() == 1 && padding_amount == 0) {
+    const std::vector<Tensor>& inputs = batch.task(0).inputs;
+    concatenated_tensors->insert(concatenated_tensors->end(), inputs.begin(),
+                                 inputs.end());
+    return Status::OK();
+  }
+
   // Process each input one at a time (the typical case has just one).
   for (int i = 0; i < num_inputs; ++i) {
     // Concatenate the tasks ith input tensors into a big output tensor.
@@ -457,19 +563,8 @@ Status BatchResourceBase::SplitOutputTensors(
                             batch->num_tasks());
   }
 
-  std::vector<int64> task_sizes_plus_optional_padding;
-  task_sizes_plus_optional_padding.reserve(batch->num_tasks());
-  for (int i = 0; i < batch->num_tasks(); ++i) {
-    task_sizes_plus_optional_padding.push_back(batch->task(i).size());
-  }
   const int padding_size =
       RoundToLowestAllowedBatchSize(batch->size()) - batch->size();
-  if (padding_size > 0) {
-    task_sizes_plus_optional_padding.push_back(padding_size);
-  }
-
-  // For each output tensor name, a divided-up tensor with one entry per task.
-  std::map<string, std::vector<Tensor>> split_tensors;
 
   DCHECK_EQ(batch->task(0).context->num_outputs(), combined_outputs.size());
   int combined_outputs_size = combined_outputs.size();
@@ -491,30 +586,24 @@ Status BatchResourceBase::SplitOutputTensors(
           "the 0th dimension sizes of the input tensors");
     }
 
-    std::vector<Tensor> split_tensor;
-    const Status split_status = tensor::Split(
-        output_tensor, task_sizes_plus_optional_padding, &split_tensor);
-    DCHECK(split_status.ok()) << split_status.ToString();
-    if (!split_status.ok()) {
-      return errors::Internal("Tensor split operation failed: ",
-                              split_status.ToString());
-    }
-    DCHECK_EQ(split_tensor.size(), task_sizes_plus_optional_padding.size());
-    if (split_tensor.size() != task_sizes_plus_optional_padding.size()) {
-      return errors::Internal(
-          "Tensor split operation did not work as expected; got ",
-          split_tensor.size(), " splits; expected ",
-          task_sizes_plus_optional_padding.size());
-    }
-
-    // Ignore a possible final split_tensors entry containing the padding.
+    // Hand each task a slice of the batched output, which shares its buffer,
+    // and only copy the slices that are not aligned enough for the kernels
+    // consuming them. The rows of the padding are dropped.
+    int64 start = 0;
     for (int j = 0; j < batch->num_tasks(); ++j) {
       BatchTask& task = *(batch->mutable_task(j));
+      const int64 end = start + task.size();
+      Tensor split_tensor = output_tensor.Slice(start, end);
+      if (!split_tensor.IsAligned()) {
+        split_tensor = tensor::DeepCopy(split_tensor);
+      }
+      start = end;
+
       if (task.is_partial) {
         std::vector<Tensor>& tensor_vector = (*task.output)[task.split_index];
-        tensor_vector[i] = std::move(split_tensor[j]);
+        tensor_vector[i] = std::move(split_tensor);
       } else {
-        task.context->set_output(i, split_tensor[j]);
+        task.context->set_output(i, std::move(split_tensor));
       }
     }
   }
@@ -522,7 +611,53 @@ Status BatchResourceBase::SplitOutputTensors(
   return Status::OK();
 }
 
+bool BatchResourceBase::BatchTask::IsExpired() const {
+  CancellationManager* cancellation_manager = context->cancellation_manager();
+  return cancellation_manager != nullptr &&
+         cancellation_manager->IsCancelled();
+}
+
+/*static*/ void BatchResourceBase::DropExpiredTasks(
+    std::unique_ptr<BatchT>* batch) {
+  bool has_expired_task = false;
+  for (int i = 0; i < (*batch)->num_tasks(); ++i) {
+    if ((*batch)->task(i).IsExpired()) {
+      has_expired_task = true;
+      break;
+    }
+  }
+  if (!has_expired_task) {
+    return;
+  }
+
+  // Tasks can only be removed from the back of a batch, so move the tasks
+  // that did not expire to a new batch.
+  std::vector<std::unique_ptr<BatchTask>> tasks((*batch)->num_tasks());
+  for (int i = tasks.size() - 1; i >= 0; --i) {
+    tasks[i] = (*batch)->RemoveTask();
+  }
+  auto live_batch = absl::make_unique<BatchT>((*batch)->traceme_context_id());
+  const Status status =
+      errors::DeadlineExceeded("Batching task expired before it was processed");
+  for (std::unique_ptr<BatchTask>& task : tasks) {
+    if (!task->IsExpired()) {
+      live_batch->AddTask(std::move(task));
+      continue;
+    }
+    RecordExpiredTasks(1, GetModelName(task->context));
+    if (task->is_partial) {
+      task->status->Update(status);
+    } else {
+      task->context->SetStatus(status);
+    }
+    task->done_callback();
+  }
+  live_batch->Close();
+  *batch = std::move(live_batch);
+}
+
 void BatchResourceBase::ProcessFuncBatch(std::unique_ptr<BatchT> batch) const {
+  DropExpiredTasks(&batch);
   if (batch->empty()) {
     return;
   }
@@ -608,6 +743,7 @@ void BatchResourceBase::ProcessFuncBatch(std::unique_ptr<BatchT> batch) const {
 
 // Processes a batch of one or more BatchTask entries.
 void BatchResourceBase::ProcessBatch(std::unique_ptr<BatchT> batch) const {
+  DropExpiredTasks(&batch);
   if (batch->empty()) {
     return;
   }
@@ -93,6 +93,10 @@ class BatchResourceBase : public ResourceBase {
 
     size_t size() const override { return inputs[0].shape().dim_size(0); }
 
+    // A task expires when the step running its op is cancelled, which
+    // includes the step exceeding its RunOptions timeout.
+    bool IsExpired() const override;
+
     // Create a split task from this one. The caller needs to setup the inputs
     // of the new task
     std::unique_ptr<BatchTask> CreateSplitTask(
@@ -116,22 +120,26 @@ class BatchResourceBase : public ResourceBase {
   BatchResourceBase(bool has_process_batch_function,
                     std::shared_ptr<BatcherT> batcher,
                     const BatcherT::QueueOptions& batcher_queue_options,
-                    std::vector<int32> allowed_batch_sizes)
+                    std::vector<int32> allowed_batch_sizes,
+                    std::vector<int32> length_bucket_boundaries)
       : has_process_batch_function_(has_process_batch_function),
         batcher_(std::move(batcher)),
         batcher_queue_options_(batcher_queue_options),
-        allowed_batch_sizes_(std::move(allowed_batch_sizes)) {
+        allowed_batch_sizes_(std::move(allowed_batch_sizes)),
+        length_bucket_boundaries_(std::move(length_bucket_boundaries)) {
     allowed_batch_sizes_str_ = absl::StrJoin(allowed_batch_sizes_, ",");
   }
 
   BatchResourceBase(bool has_process_batch_function,
                     std::shared_ptr<AdaptiveBatcherT> batcher,
                     const AdaptiveBatcherT::QueueOptions& batcher_queue_options,
-                    std::vector<int32> allowed_batch_sizes)
+                    std::vector<int32> allowed_batch_sizes,
+                    std::vector<int32> length_bucket_boundaries)
       : has_process_batch_function_(has_process_batch_function),
         adaptive_batcher_(std::move(batcher)),
         adaptive_batcher_queue_options_(batcher_queue_options),
-        allowed_batch_sizes_(std::move(allowed_batch_sizes)) {}
+        allowed_batch_sizes_(std::move(allowed_batch_sizes)),
+        length_bucket_boundaries_(std::move(length_bucket_boundaries)) {}
 
   static BatcherT::QueueOptions GetBatcherQueueOptions(
       int32 num_batch_threads, int32 max_batch_size, int32 batch_timeout_micros,
@@ -158,6 +166,11 @@ class BatchResourceBase : public ResourceBase {
   // Assumes the batch is non-empty.
   static Status ValidateBatch(const BatchT& batch);
 
+  // If 'length_bucket_boundaries_' is non-empty, pads the inputs of 'task'
+  // along their 1st dimension up to the smallest boundary that fits them, and
+  // sets 'queue_name' to the batcher queue of that bucket.
+  Status PadToLengthBucket(BatchTask* task, string* queue_name) const;
+
   // Returns the smallest entry in 'allowed_batch_sizes_' that is greater than
   // or equal to 'batch_size'. If 'allowed_batch_sizes_' is empty, simply
   // returns 'batch_size'.
@@ -189,6 +202,10 @@ class BatchResourceBase : public ResourceBase {
   Status SplitOutputTensors(const std::vector<Tensor>& combined_outputs,
                             BatchT* batch) const;
 
+  // Finishes the expired tasks of 'batch' with an error instead of processing
+  // them, and removes them from the batch.
+  static void DropExpiredTasks(std::unique_ptr<BatchT>* batch);
+
   void ProcessFuncBatch(std::unique_ptr<BatchT> batch) const;
 
   // Processes a batch of one or more BatchTask entries.
@@ -230,6 +247,9 @@ class BatchResourceBase : public ResourceBase {
   // A concatenated string of <allowed_batch_sizes_>, separated by ",". This is
   // used to record batching parameter.
   string allowed_batch_sizes_str_;
+
+  // Sequence lengths inputs are padded up to, see PadToLengthBucket().
+  std::vector<int32> length_bucket_boundaries_;
 };
 
 }  // namespace serving
@@ -64,6 +64,12 @@ class BatchTask {
   // Returns the size of the task, in terms of how much it contributes to the
   // size of a batch. (A batch's size is the sum of its task sizes.)
   virtual size_t size() const = 0;
+
+  // Returns true if the outcome of the task is no longer wanted, e.g. because
+  // the request it belongs to timed out or was cancelled. Schedulers refuse
+  // to enqueue expired tasks, and batch processors may drop them instead of
+  // processing them.
+  virtual bool IsExpired() const { return false; }
 };
 
 // A thread-safe collection of BatchTasks, to be executed together in some
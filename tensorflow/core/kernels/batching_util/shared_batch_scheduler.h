@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <deque>
 #include <functional>
 #include <list>
@@ -30,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/batching_util/periodic_function.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/cpu_info.h"
@@ -194,6 +196,39 @@ class SharedBatchScheduler
     // submit batches whose size is in a small set of allowed sizes, that can be
     // done by adding padding in the process-batch callback.
     size_t max_execution_batch_size = 1000;
+
+    // Options for a controller that adjusts the queue's batch timeout and the
+    // batch size at which it closes a batch, based on the observed queue depth
+    // and per-batch processing time. This lets a queue trade throughput for
+    // latency under varying load instead of using fixed parameters.
+    struct AdaptiveBatchingOptions {
+      // Target for the time (in microseconds) between a task entering the
+      // queue and its batch being processed. If zero, the controller is
+      // disabled and `batch_timeout_micros` and `max_execution_batch_size` are
+      // used as is.
+      int64 latency_slo_micros = 0;
+
+      // Range of the adjusted batch timeout. A `max_batch_timeout_micros` of
+      // zero means `batch_timeout_micros`, which is also the initial value.
+      int64 min_batch_timeout_micros = 0;
+      int64 max_batch_timeout_micros = 0;
+
+      // Lower bound for the size at which a batch is closed and scheduled.
+      // The upper bound, and initial value, is the maximum execution batch
+      // size.
+      size_t min_target_batch_size = 1;
+
+      // The number of processed batches between adjustments.
+      int adjustment_interval_batches = 16;
+
+      // The relative amount by which a parameter is changed per adjustment.
+      // Must be in (0, 1).
+      double adjustment_step = 0.25;
+
+      // Label of this queue in the exported metrics.
+      string metrics_label;
+    };
+    AdaptiveBatchingOptions adaptive_batching;
   };
   Status AddQueue(const QueueOptions& options,
                   std::function<void(std::unique_ptr<Batch<TaskType>>)>
@@ -242,6 +277,25 @@ class SharedBatchScheduler
 
 namespace internal {
 
+// Exports the parameters chosen by the adaptive batching controller of the
+// queue labeled `queue_label`.
+inline void RecordAdaptiveBatchingParameters(const string& queue_label,
+                                             int64 batch_timeout_micros,
+                                             int64 target_batch_size) {
+  static auto* timeout_cell = monitoring::Gauge<int64, 1>::New(
+      "/tensorflow/serving/batching/adaptive_batch_timeout_micros",
+      "Tracks the batch timeout chosen by the adaptive batching controller of "
+      "a SharedBatchScheduler queue.",
+      "queue");
+  static auto* batch_size_cell = monitoring::Gauge<int64, 1>::New(
+      "/tensorflow/serving/batching/adaptive_target_batch_size",
+      "Tracks the batch size at which the adaptive batching controller of a "
+      "SharedBatchScheduler queue schedules a batch.",
+      "queue");
+  timeout_cell->GetCell(queue_label)->Set(batch_timeout_micros);
+  batch_size_cell->GetCell(queue_label)->Set(target_batch_size);
+}
+
 // A task queue for SharedBatchScheduler. Accepts tasks and accumulates them
 // into batches, and dispenses those batches to be processed via a "pull"
 // interface. The queue's behavior is governed by maximum batch size, timeout
@@ -345,6 +399,16 @@ class Queue {
   // currently schedulable.
   bool IsOpenBatchSchedulable() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  bool adaptive_batching_enabled() const {
+    return options_.adaptive_batching.latency_slo_micros > 0;
+  }
+
+  // Records the processing time of a batch for the adaptive batching
+  // controller, and adjusts `batch_timeout_micros_` and `target_batch_size_`
+  // once enough batches have been observed.
+  void UpdateAdaptiveBatching(int64 processing_time_micros)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   const typename SharedBatchScheduler<TaskType>::QueueOptions options_;
 
   // The environment to use.
@@ -383,6 +447,19 @@ class Queue {
   // Incremented in ScheduleBatch() and decremented in ProcessBatch().
   int num_batches_being_processed_ TF_GUARDED_BY(mu_) = 0;
 
+  // The current batch timeout and the size at which the open batch becomes
+  // schedulable. Fixed unless adaptive batching is enabled.
+  int64 batch_timeout_micros_ TF_GUARDED_BY(mu_);
+  size_t target_batch_size_ TF_GUARDED_BY(mu_);
+
+  // Observations since the last adaptive batching adjustment: the number and
+  // total processing time of processed batches, and the number of closed
+  // batches left waiting each time a batch was scheduled.
+  int window_num_batches_ TF_GUARDED_BY(mu_) = 0;
+  int64 window_processing_time_micros_ TF_GUARDED_BY(mu_) = 0;
+  int window_num_depth_samples_ TF_GUARDED_BY(mu_) = 0;
+  int64 window_waiting_batches_ TF_GUARDED_BY(mu_) = 0;
+
   // Used by CloseAndWaitUntilEmpty() to wait until the queue is empty, for
   // the case in which the queue is not empty when CloseAndWaitUntilEmpty()
   // starts. When ProcessBatch() dequeues the last batch and makes the queue
@@ -474,6 +551,42 @@ Status SharedBatchScheduler<TaskType>::AddQueue(
         options.max_enqueued_batches);
   }
 
+  const auto& adaptive = options.adaptive_batching;
+  if (adaptive.latency_slo_micros < 0) {
+    return errors::InvalidArgument(
+        "adaptive_batching.latency_slo_micros must be non-negative; was ",
+        adaptive.latency_slo_micros);
+  }
+  if (adaptive.latency_slo_micros > 0) {
+    const int64 max_batch_timeout_micros =
+        adaptive.max_batch_timeout_micros > 0
+            ? adaptive.max_batch_timeout_micros
+            : options.batch_timeout_micros;
+    if (adaptive.min_batch_timeout_micros < 0 ||
+        adaptive.min_batch_timeout_micros > max_batch_timeout_micros) {
+      return errors::InvalidArgument(
+          "adaptive_batching.min_batch_timeout_micros must be in [0, ",
+          max_batch_timeout_micros, "]; was ",
+          adaptive.min_batch_timeout_micros);
+    }
+    if (adaptive.min_target_batch_size < 1) {
+      return errors::InvalidArgument(
+          "adaptive_batching.min_target_batch_size must be positive; was ",
+          adaptive.min_target_batch_size);
+    }
+    if (adaptive.adjustment_interval_batches < 1) {
+      return errors::InvalidArgument(
+          "adaptive_batching.adjustment_interval_batches must be positive; "
+          "was ",
+          adaptive.adjustment_interval_batches);
+    }
+    if (!(adaptive.adjustment_step > 0 && adaptive.adjustment_step < 1)) {
+      return errors::InvalidArgument(
+          "adaptive_batching.adjustment_step must be in (0, 1); was ",
+          adaptive.adjustment_step);
+    }
+  }
+
   if (options.enable_large_batch_splitting &&
       options.split_input_task_func == nullptr) {
     return errors::InvalidArgument(
@@ -593,9 +706,16 @@ Queue<TaskType>::Queue(
     : options_(options),
       env_(env),
       process_batch_callback_(process_batch_callback),
-      schedulable_batch_callback_(schedulable_batch_callback) {
+      schedulable_batch_callback_(schedulable_batch_callback),
+      batch_timeout_micros_(options.batch_timeout_micros),
+      target_batch_size_(max_execution_batch_size()) {
   // Create an initial, open batch.
   batches_.emplace_back(new Batch<TaskType>);
+  if (adaptive_batching_enabled()) {
+    RecordAdaptiveBatchingParameters(options_.adaptive_batching.metrics_label,
+                                     batch_timeout_micros_,
+                                     target_batch_size_);
+  }
 }
 
 template <typename TaskType>
@@ -609,6 +729,9 @@ Queue<TaskType>::~Queue() {
 
 template <typename TaskType>
 Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
+  if ((*task)->IsExpired()) {
+    return errors::DeadlineExceeded("Task expired before it was scheduled");
+  }
   if (options_.enable_large_batch_splitting) {
     return ScheduleWithSplit(std::move(task));
   }
@@ -797,6 +920,10 @@ std::unique_ptr<Batch<TaskType>> Queue<TaskType>::ScheduleBatch() {
       ++num_batches_being_processed_;
       batch_to_schedule = std::move(batches_.front());
       batches_.pop_front();
+      if (adaptive_batching_enabled()) {
+        ++window_num_depth_samples_;
+        window_waiting_batches_ += batches_.size() - 1;
+      }
     } else {
       schedulable_batch_ = false;
     }
@@ -814,10 +941,15 @@ void Queue<TaskType>::ProcessBatch(std::unique_ptr<Batch<TaskType>> batch) {
       },
       profiler::ContextType::kSharedBatchScheduler,
       batch->traceme_context_id());
+  const uint64 start_time_micros = env_->NowMicros();
   process_batch_callback_(std::move(batch));
+  const int64 processing_time_micros = env_->NowMicros() - start_time_micros;
 
   {
     mutex_lock l(mu_);
+    if (adaptive_batching_enabled()) {
+      UpdateAdaptiveBatching(processing_time_micros);
+    }
     --num_batches_being_processed_;
     if (empty_notification_ != nullptr && IsEmptyInternal()) {
       empty_notification_->Notify();
@@ -876,9 +1008,78 @@ bool Queue<TaskType>::IsOpenBatchSchedulable() const {
   if (open_batch->empty()) {
     return false;
   }
-  return closed_ || open_batch->size() >= max_execution_batch_size() ||
-         env_->NowMicros() >=
-             open_batch_start_time_micros_ + options_.batch_timeout_micros;
+  return closed_ || open_batch->size() >= target_batch_size_ ||
+         env_->NowMicros() >= open_batch_start_time_micros_ +
+                                  static_cast<uint64>(batch_timeout_micros_);
+}
+
+template <typename TaskType>
+void Queue<TaskType>::UpdateAdaptiveBatching(int64 processing_time_micros) {
+  const auto& adaptive = options_.adaptive_batching;
+  ++window_num_batches_;
+  window_processing_time_micros_ += processing_time_micros;
+  if (window_num_batches_ < adaptive.adjustment_interval_batches) return;
+
+  const double avg_processing_time_micros =
+      static_cast<double>(window_processing_time_micros_) / window_num_batches_;
+  const double avg_waiting_batches =
+      window_num_depth_samples_ > 0
+          ? static_cast<double>(window_waiting_batches_) /
+                window_num_depth_samples_
+          : 0;
+  window_num_batches_ = 0;
+  window_processing_time_micros_ = 0;
+  window_num_depth_samples_ = 0;
+  window_waiting_batches_ = 0;
+
+  const int64 max_batch_timeout_micros = adaptive.max_batch_timeout_micros > 0
+                                             ? adaptive.max_batch_timeout_micros
+                                             : options_.batch_timeout_micros;
+  const size_t max_target_batch_size = max_execution_batch_size();
+  const size_t min_target_batch_size =
+      std::min(adaptive.min_target_batch_size, max_target_batch_size);
+  const double step = adaptive.adjustment_step;
+
+  // The first task of an open batch waits for the batch timeout, then for the
+  // closed batches ahead of it, and finally for its own batch to be processed.
+  const double estimated_latency_micros =
+      batch_timeout_micros_ +
+      (avg_waiting_batches + 1) * avg_processing_time_micros;
+  const double slo_micros = adaptive.latency_slo_micros;
+
+  if (estimated_latency_micros > slo_micros) {
+    if (avg_waiting_batches >= 1) {
+      // Batches are formed faster than they are processed, so latency is
+      // dominated by queueing. Larger batches raise throughput.
+      target_batch_size_ = std::min(
+          max_target_batch_size,
+          std::max(target_batch_size_ + 1,
+                   static_cast<size_t>(target_batch_size_ * (1 + step))));
+    } else {
+      batch_timeout_micros_ =
+          std::max(adaptive.min_batch_timeout_micros,
+                   static_cast<int64>(batch_timeout_micros_ * (1 - step)));
+      if (avg_processing_time_micros > slo_micros) {
+        // A single batch exceeds the target; only smaller batches can help.
+        target_batch_size_ = std::max(
+            min_target_batch_size,
+            static_cast<size_t>(target_batch_size_ * (1 - step)));
+      }
+    }
+  } else if (estimated_latency_micros < slo_micros * (1 - step)) {
+    // There is headroom: wait longer to form larger, more efficient batches.
+    batch_timeout_micros_ = std::min(
+        max_batch_timeout_micros,
+        std::max(batch_timeout_micros_ + 1,
+                 static_cast<int64>(batch_timeout_micros_ * (1 + step))));
+    target_batch_size_ = std::min(
+        max_target_batch_size,
+        std::max(target_batch_size_ + 1,
+                 static_cast<size_t>(target_batch_size_ * (1 + step))));
+  }
+
+  RecordAdaptiveBatchingParameters(adaptive.metrics_label,
+                                   batch_timeout_micros_, target_batch_size_);
 }
 
 template <typename TaskType>
@@ -28,14 +28,18 @@ namespace {
 
 class FakeTask : public BatchTask {
  public:
-  explicit FakeTask(size_t size) : size_(size) {}
+  explicit FakeTask(size_t size, bool expired = false)
+      : size_(size), expired_(expired) {}
 
   ~FakeTask() override = default;
 
   size_t size() const override { return size_; }
 
+  bool IsExpired() const override { return expired_; }
+
  private:
   const size_t size_;
+  const bool expired_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(FakeTask);
 };
@@ -463,6 +467,35 @@ TEST(SharedBatchSchedulerTest, ConstMethods) {
   }
 }
 
+TEST(SharedBatchSchedulerTest, RejectsExpiredTasks) {
+  int num_processed_tasks = 0;
+  auto callback =
+      [&num_processed_tasks](std::unique_ptr<Batch<FakeTask>> batch) {
+        ASSERT_TRUE(batch->IsClosed());
+        num_processed_tasks += batch->num_tasks();
+      };
+  {
+    SharedBatchScheduler<FakeTask>::Options options;
+    options.num_batch_threads = 1;
+    std::shared_ptr<SharedBatchScheduler<FakeTask>> scheduler;
+    TF_ASSERT_OK(SharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+    SharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+    queue_options.input_batch_size_limit = 10;
+    queue_options.batch_timeout_micros = 0;
+    std::unique_ptr<BatchScheduler<FakeTask>> queue;
+    TF_ASSERT_OK(scheduler->AddQueue(queue_options, callback, &queue));
+
+    std::unique_ptr<FakeTask> expired_task(new FakeTask(1, /*expired=*/true));
+    Status status = queue->Schedule(&expired_task);
+    EXPECT_EQ(error::DEADLINE_EXCEEDED, status.code());
+    EXPECT_NE(nullptr, expired_task);
+    EXPECT_EQ(0, queue->NumEnqueuedTasks());
+
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+  }
+  EXPECT_EQ(1, num_processed_tasks);
+}
+
 TEST(SharedBatchSchedulerTest, OneFullQueueDoesntBlockOtherQueues) {
   Notification queue_0_processing, queue_0_proceed;
   auto queue_0_callback = [&queue_0_processing, &queue_0_proceed](
@@ -591,6 +624,95 @@ TEST(SharedBatchSchedulerTest, QueueDestructorBlocksUntilAllTasksProcessed) {
   stop_teardown.Notify();
 }
 
+TEST(SharedBatchSchedulerTest, AdaptiveBatchingLowersTimeoutToMeetSlo) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    constexpr int64 kProcessingTimeMicros = 1000;
+    mutex mu;
+    condition_variable full_batch_processed;
+    int num_full_batches_processed = 0;
+    Notification underfull_batch_processed;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      if (batch->size() == 1) {
+        underfull_batch_processed.Notify();
+        return;
+      }
+      env.AdvanceByMicroseconds(kProcessingTimeMicros);
+      mutex_lock l(mu);
+      ++num_full_batches_processed;
+      full_batch_processed.notify_all();
+    };
+
+    SharedBatchScheduler<FakeTask>::Options options;
+    options.num_batch_threads = 1;
+    options.env = &env;
+    std::shared_ptr<SharedBatchScheduler<FakeTask>> scheduler;
+    TF_ASSERT_OK(SharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+    SharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+    queue_options.input_batch_size_limit = 4;
+    queue_options.batch_timeout_micros = 1000 * 1000;  // 1 second
+    queue_options.max_enqueued_batches = 2;
+    queue_options.adaptive_batching.latency_slo_micros = 10 * 1000;
+    queue_options.adaptive_batching.adjustment_interval_batches = 1;
+    queue_options.adaptive_batching.adjustment_step = 0.5;
+    queue_options.adaptive_batching.metrics_label = "test_queue";
+    std::unique_ptr<BatchScheduler<FakeTask>> queue;
+    TF_ASSERT_OK(scheduler->AddQueue(queue_options, callback, &queue));
+
+    // Full batches are processed right away, and each one tells the
+    // controller that the configured timeout is far above the latency target.
+    for (int i = 0; i < 20; ++i) {
+      TF_ASSERT_OK(ScheduleTask(4, queue.get()));
+      mutex_lock l(mu);
+      while (num_full_batches_processed <= i) {
+        full_batch_processed.wait(l);
+      }
+    }
+
+    // An underfull batch now only has to wait for the adjusted timeout, which
+    // is below the latency target, rather than the configured one second.
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    env.AdvanceByMicroseconds(
+        queue_options.adaptive_batching.latency_slo_micros);
+    underfull_batch_processed.WaitForNotification();
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerTest, AdaptiveBatchingInvalidOptions) {
+  SharedBatchScheduler<FakeTask>::Options options;
+  options.num_batch_threads = 1;
+  std::shared_ptr<SharedBatchScheduler<FakeTask>> scheduler;
+  TF_ASSERT_OK(SharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {};
+
+  SharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+  queue_options.batch_timeout_micros = 100;
+  queue_options.adaptive_batching.latency_slo_micros = 1000;
+  std::unique_ptr<BatchScheduler<FakeTask>> queue;
+
+  queue_options.adaptive_batching.min_batch_timeout_micros = 200;
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            scheduler->AddQueue(queue_options, callback, &queue).code());
+  queue_options.adaptive_batching.min_batch_timeout_micros = 0;
+
+  queue_options.adaptive_batching.adjustment_step = 1.5;
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            scheduler->AddQueue(queue_options, callback, &queue).code());
+  queue_options.adaptive_batching.adjustment_step = 0.25;
+
+  queue_options.adaptive_batching.adjustment_interval_batches = 0;
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            scheduler->AddQueue(queue_options, callback, &queue).code());
+}
+
 }  // namespace
 }  // namespace serving
 }  // namespace tensorflow
@@ -22,7 +22,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/boosted_trees/boosted_trees.pb.h"
 #include "tensorflow/core/kernels/boosted_trees/tree_helper.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -1354,22 +1356,33 @@ class BoostedTreesAggregateStatsOp : public OpKernel {
     auto temp_stats_double = temp_stats_double_t.tensor<double, 4>();
     temp_stats_double.setZero();
 
-    for (int i = 0; i < batch_size; ++i) {
-      const int32 node = node_ids(i);
-      for (int feature_dim = 0; feature_dim < feature_dims; ++feature_dim) {
-        const int32 feature_value = feature(i, feature_dim);
-        const int32 bucket =
-            (feature_value == -1) ? num_buckets_ : feature_value;
-        for (int stat_dim = 0; stat_dim < logits_dims; ++stat_dim) {
-          temp_stats_double(node, feature_dim, bucket, stat_dim) +=
-              gradients(i, stat_dim);
-        }
-        for (int stat_dim = logits_dims; stat_dim < stats_dims; ++stat_dim) {
-          temp_stats_double(node, feature_dim, bucket, stat_dim) +=
-              hessians(i, stat_dim - logits_dims);
+    // Each feature dimension owns a disjoint slice of the histograms, so they
+    // are built in parallel without synchronization.
+    auto do_work = [&](int64 begin, int64 end) {
+      for (int64 feature_dim = begin; feature_dim < end; ++feature_dim) {
+        for (int i = 0; i < batch_size; ++i) {
+          const int32 node = node_ids(i);
+          const int32 feature_value = feature(i, feature_dim);
+          const int32 bucket =
+              (feature_value == -1) ? num_buckets_ : feature_value;
+          double* const bucket_stats =
+              &temp_stats_double(node, feature_dim, bucket, 0);
+          const float* const gradients_row = &gradients(i, 0);
+          for (int stat_dim = 0; stat_dim < logits_dims; ++stat_dim) {
+            bucket_stats[stat_dim] += gradients_row[stat_dim];
+          }
+          const float* const hessians_row = &hessians(i, 0);
+          for (int stat_dim = 0; stat_dim < hessians_dims; ++stat_dim) {
+            bucket_stats[logits_dims + stat_dim] += hessians_row[stat_dim];
+          }
         }
       }
-    }
+    };
+    const int64 cost_per_feature = batch_size * (stats_dims + 2);
+    thread::ThreadPool* const worker_threads =
+        context->device()->tensorflow_cpu_worker_threads()->workers;
+    Shard(worker_threads->NumThreads(), worker_threads, feature_dims,
+          cost_per_feature, do_work);
 
     // Copy temp tensor over to output tensor, downcasting to float.
     Tensor* output_stats_summary_t = nullptr;
@@ -50,6 +50,21 @@ static std::unique_ptr<OpKernel> BuildOpKernel(OpKernelConstruction* c,
   return k;
 }
 
+// Maps the wire_compression attr of the reduce ops to the type that chunks
+// are cast to in transit, DT_INVALID if they are sent uncompressed.
+static Status GetWireDataType(OpKernelConstruction* c, DataType* wire_type) {
+  string wire_compression;
+  TF_RETURN_IF_ERROR(c->GetAttr("wire_compression", &wire_compression));
+  if (wire_compression == "fp16") {
+    *wire_type = DT_HALF;
+  } else if (wire_compression == "bf16") {
+    *wire_type = DT_BFLOAT16;
+  } else {
+    *wire_type = DT_INVALID;
+  }
+  return Status::OK();
+}
+
 class CollectiveOpV1Kernel : public AsyncOpKernel {
  public:
   explicit CollectiveOpV1Kernel(OpKernelConstruction* c)
@@ -240,6 +255,9 @@ class CollectiveReduceOpKernel : public CollectiveOpV1Kernel {
     OP_REQUIRES_OK(
         c, c->GetAttr("timeout_seconds",
                       &col_params_.instance.impl_details.timeout_seconds));
+    OP_REQUIRES_OK(
+        c,
+        GetWireDataType(c, &col_params_.instance.impl_details.wire_data_type));
     VLOG(2) << "CollectiveReduce instance " << col_params_.instance.instance_key
             << " merge_op " << merge_op_name << " final_op " << final_op_name
             << " communication_hint "
@@ -475,6 +493,7 @@ class CollectiveReduceV2OpKernel : public AsyncOpKernel {
     OP_REQUIRES_OK(c, c->GetAttr("final_op", &final_op_name));
     OP_REQUIRES_OK(c, c->GetAttr("communication_hint", &communication_hint_));
     OP_REQUIRES_OK(c, c->GetAttr("timeout_seconds", &timeout_seconds_));
+    OP_REQUIRES_OK(c, GetWireDataType(c, &wire_data_type_));
     // Prepare OpKernels for reduction and final operations.
     // The merge_op takes two inputs
     NodeDef sub_node;
@@ -524,6 +543,7 @@ class CollectiveReduceV2OpKernel : public AsyncOpKernel {
     col_params->instance.data_type = data_type_;
     col_params->instance.impl_details.communication_hint = communication_hint_;
     col_params->instance.impl_details.timeout_seconds = timeout_seconds_;
+    col_params->instance.impl_details.wire_data_type = wire_data_type_;
     // Add a default value for subdiv offsets, which is the same as the default
     // value in the V1 op's attribute.
     col_params->instance.impl_details.subdiv_offsets.push_back(0);
@@ -594,6 +614,7 @@ class CollectiveReduceV2OpKernel : public AsyncOpKernel {
   DataType data_type_ = DT_INVALID;
   string communication_hint_;
   float timeout_seconds_ = 0;
+  DataType wire_data_type_ = DT_INVALID;
   DeviceType device_type_;
   std::unique_ptr<OpKernel> merge_op_;
   std::unique_ptr<OpKernel> final_op_;
@@ -24,6 +24,9 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/constant_op.h"
 
+#include <memory>
+#include <unordered_map>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/bounds_check.h"
@@ -37,7 +40,9 @@ limitations under the License.
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/graph/graph_node_util.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 
 
 namespace tensorflow {
@@ -67,6 +72,68 @@ NodeDef StripTensorDataFromNodeDef(OpKernelConstruction* ctx) {
   return ret;
 }
 
+// Constants smaller than this are not worth fingerprinting.
+constexpr int64 kMinSharedConstantBytes = 1 << 10;
+
+// Process-wide store of the values of CPU constants, keyed by their content.
+// Sessions that load the same model, e.g. several versions of a served model
+// that only differ in some of their weights, then hold a single copy of each
+// identical constant. Values are only held while a ConstantOp uses them.
+class SharedConstantStore {
+ public:
+  static SharedConstantStore* Global() {
+    static SharedConstantStore* store = new SharedConstantStore;
+    return store;
+  }
+
+  // Returns the stored value equal to `tensor`, storing `tensor` if there is
+  // none, or nullptr if `tensor` is not eligible for sharing.
+  std::shared_ptr<const Tensor> Intern(const Tensor& tensor) {
+    if (!DataTypeCanUseMemcpy(tensor.dtype()) ||
+        tensor.TotalBytes() < kMinSharedConstantBytes) {
+      return nullptr;
+    }
+    const StringPiece data = tensor.tensor_data();
+    const Fprint128 key = Fingerprint128(data);
+
+    // Declared before the lock so that, if this is the last reference, the
+    // value is released (and its entry erased) after `mu_` is unlocked.
+    std::shared_ptr<const Tensor> stored;
+    mutex_lock l(mu_);
+    auto it = tensors_.find(key);
+    if (it != tensors_.end()) {
+      stored = it->second.lock();
+      if (stored != nullptr) {
+        if (stored->dtype() == tensor.dtype() &&
+            stored->shape() == tensor.shape() &&
+            stored->tensor_data() == data) {
+          return stored;
+        }
+        // Same content with another type or shape, or a fingerprint
+        // collision: keep the values apart.
+        return nullptr;
+      }
+    }
+    stored.reset(new Tensor(tensor), [this, key](const Tensor* t) {
+      {
+        mutex_lock l(mu_);
+        auto it = tensors_.find(key);
+        if (it != tensors_.end() && it->second.expired()) {
+          tensors_.erase(it);
+        }
+      }
+      delete t;
+    });
+    tensors_[key] = stored;
+    return stored;
+  }
+
+ private:
+  mutex mu_;
+  std::unordered_map<Fprint128, std::weak_ptr<const Tensor>, Fprint128Hasher>
+      tensors_ TF_GUARDED_BY(mu_);
+};
+
 }  // namespace
 
 ConstantOp::ConstantOp(OpKernelConstruction* ctx)
@@ -75,13 +142,25 @@ ConstantOp::ConstantOp(OpKernelConstruction* ctx)
   const TensorProto* proto = nullptr;
   ScopedMemoryDebugAnnotation op_annotation(name_view().data());
   OP_REQUIRES_OK(ctx, ctx->GetAttr("value", &proto));
-  OP_REQUIRES_OK(ctx, ctx->device()->MakeTensorFromProto(
-                          *proto, AllocatorAttributes(), &tensor_));
+  if (ctx->device_type() == DEVICE_CPU) {
+    // The graph keeps the NodeDef, so share its tensor content rather than
+    // holding a second copy of a possibly large constant.
+    OP_REQUIRES(ctx, tensor_.FromProtoAliasingContent(*proto, ctx->props()),
+                errors::InvalidArgument("Cannot parse tensor from proto: ",
+                                        proto->DebugString()));
+  } else {
+    OP_REQUIRES_OK(ctx, ctx->device()->MakeTensorFromProto(
+                            *proto, AllocatorAttributes(), &tensor_));
+  }
   OP_REQUIRES(
       ctx, ctx->output_type(0) == tensor_.dtype(),
       errors::InvalidArgument("Type mismatch between value (",
                               DataTypeString(tensor_.dtype()), ") and dtype (",
                               DataTypeString(ctx->output_type(0)), ")"));
+  if (ctx->device_type() == DEVICE_CPU) {
+    shared_tensor_ = SharedConstantStore::Global()->Intern(tensor_);
+    if (shared_tensor_ != nullptr) tensor_ = *shared_tensor_;
+  }
 }
 
 void ConstantOp::Compute(OpKernelContext* ctx) {
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_CONSTANT_OP_H_
 #define TENSORFLOW_CORE_KERNELS_CONSTANT_OP_H_
 
+#include <memory>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor_types.h"
@@ -34,6 +36,9 @@ class ConstantOp : public OpKernel {
 
  private:
   Tensor tensor_;
+  // Keeps the value of `tensor_` in the process-wide store of constants while
+  // this kernel is alive, if it is shared. Null otherwise.
+  std::shared_ptr<const Tensor> shared_tensor_;
   TF_DISALLOW_COPY_AND_ASSIGN(ConstantOp);
 };
 
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/graph.h"
@@ -96,6 +97,50 @@ TEST_F(ConstantOpTest, PersistentMemoryTracking) {
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 }
 
+// Creates a CPU Const kernel named `name` with value `value` and returns its
+// output.
+Tensor ComputeConstant(Device* device, const string& name, const Tensor& value,
+                       std::unique_ptr<OpKernel>* op) {
+  NodeDef const_node;
+  TF_CHECK_OK(NodeDefBuilder(name, "Const")
+                  .Attr("dtype", value.dtype())
+                  .Attr("value", value)
+                  .Finalize(&const_node));
+  Status status;
+  op->reset(CreateOpKernel(DEVICE_CPU, device, cpu_allocator(), const_node,
+                           TF_GRAPH_DEF_VERSION, &status));
+  TF_CHECK_OK(status);
+
+  OpKernelContext::Params params;
+  params.device = device;
+  params.frame_iter = FrameAndIter(0, 0);
+  params.op_kernel = op->get();
+  OpKernelContext ctx(&params);
+  (*op)->Compute(&ctx);
+  TF_CHECK_OK(ctx.status());
+  return *ctx.mutable_output(0);
+}
+
+TEST_F(ConstantOpTest, IdenticalConstantsShareMemory) {
+  std::unique_ptr<Device> device(
+      DeviceFactory::NewDevice("CPU", {}, "/job:worker/replica:0/task:0"));
+  Tensor value(DT_FLOAT, TensorShape({1024}));
+  for (int i = 0; i < 1024; ++i) {
+    value.flat<float>()(i) = i;
+  }
+  Tensor other_value(DT_FLOAT, TensorShape({1024}));
+  other_value.flat<float>().setZero();
+
+  std::unique_ptr<OpKernel> op_a, op_b, op_c;
+  Tensor a = ComputeConstant(device.get(), "a", value, &op_a);
+  Tensor b = ComputeConstant(device.get(), "b", value, &op_b);
+  Tensor c = ComputeConstant(device.get(), "c", other_value, &op_c);
+  EXPECT_TRUE(a.SharesBufferWith(b));
+  EXPECT_FALSE(a.SharesBufferWith(c));
+  test::ExpectTensorEqual<float>(value, b);
+  test::ExpectTensorEqual<float>(other_value, c);
+}
+
 // Returns graph containing "num" const nodes.  If 'sequential' is
 // true, make sure all constants are executed sequentially in the
 // graph by adding control dependencies.
@@ -152,7 +152,7 @@ class ConvParameters {
         "(", str_util::Join(stride_, ", "), "), ",
         "(", str_util::Join(padding_, ", "), "), ",
         dtype_, ", ",
-        device_id_,
+        device_id_, ", ",
         group_count_);
     // clang-format on
   }
@@ -19,7 +19,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/data/cache_ops.h"
 #include "tensorflow/core/kernels/data/dataset_utils.h"
+#include "tensorflow/core/kernels/data/hash_utils.h"
 #include "tensorflow/core/kernels/data/name_utils.h"
+#include "tensorflow/core/kernels/data/serialization_utils.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
@@ -37,6 +39,9 @@ namespace data {
 /* static */ constexpr const char* const CacheDatasetOp::kFileName;
 /* static */ constexpr const char* const CacheDatasetOp::kOutputTypes;
 /* static */ constexpr const char* const CacheDatasetOp::kOutputShapes;
+/* static */ constexpr const char* const CacheDatasetOp::kMemoryBudget;
+/* static */ constexpr const char* const CacheDatasetOp::kSpillDirectory;
+/* static */ constexpr const char* const CacheDatasetOp::kShared;
 
 namespace {
 
@@ -56,6 +61,7 @@ constexpr char kCacheSize[] = "cache_size";
 constexpr char kCache[] = "cache";
 constexpr char kSizeSuffix[] = ".size";
 constexpr char kCacheCompleted[] = "cache_completed";
+constexpr char kCacheUnclaimed[] = "cache_unclaimed";
 constexpr char kIndex[] = "index";
 constexpr char kImpl[] = "Impl";
 constexpr char kCacheDataset[] = "CacheDataset";
@@ -735,8 +741,13 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       mutex_lock l(mu_);
       if (cache_->IsCompleted()) {
         TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kCacheCompleted), ""));
+        // Spilled elements are read back to be written to the checkpoint.
+        std::vector<std::vector<Tensor>> elements(cache_->size());
+        for (size_t i = 0; i < elements.size(); ++i) {
+          TF_RETURN_IF_ERROR(cache_->Get(i, &elements[i]));
+        }
         TF_RETURN_IF_ERROR(
-            WriteElementsToCheckpoint(writer, prefix(), cache_->data()));
+            WriteElementsToCheckpoint(writer, prefix(), elements));
       }
       return SaveInput(ctx, writer, iterator_);
     }
@@ -750,13 +761,17 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         std::vector<std::vector<Tensor>> temp_cache;
         TF_RETURN_IF_ERROR(
             ReadElementsFromCheckpoint(reader, prefix(), &temp_cache));
-        cache_->Complete(std::move(temp_cache));
+        TF_RETURN_IF_ERROR(cache_->Complete(std::move(temp_cache)));
       }
       TF_RETURN_IF_ERROR(InitializeIterator(ctx));
       return RestoreInput(ctx, reader, iterator_);
     }
 
    private:
+    // Populates the cache with the elements of the input if it holds the
+    // claim of the cache, and otherwise only forwards them. This way a single
+    // copy of the elements is buffered when several iterators share a cache
+    // which is not completed yet.
     class MemoryWriterIterator : public DatasetIterator<MemoryDatasetBase> {
      public:
       explicit MemoryWriterIterator(const Params& params, MemoryCache* cache)
@@ -764,13 +779,17 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
 
       ~MemoryWriterIterator() override {
         mutex_lock l(mu_);
-        if (!temp_cache_.empty() && !cache_->IsCompleted()) {
-          LOG(WARNING) << kIncompleteCacheErrorMessage;
+        if (claimed_ && !cache_->IsCompleted()) {
+          if (cache_->size() > 0) {
+            LOG(WARNING) << kIncompleteCacheErrorMessage;
+          }
           cache_->Reset();
         }
       }
 
       Status Initialize(IteratorContext* ctx) override {
+        mutex_lock l(mu_);
+        claimed_ = cache_->Claim();
         return dataset()->input_->MakeIterator(ctx, this, prefix(),
                                                &input_impl_);
       }
@@ -781,19 +800,20 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         mutex_lock l(mu_);
         TF_RETURN_IF_ERROR(
             input_impl_->GetNext(ctx, out_tensors, end_of_sequence));
+        if (!claimed_ || cache_->IsCompleted()) {
+          return Status::OK();
+        }
         if (*end_of_sequence) {
-          if (!cache_->IsCompleted()) {
-            VLOG(2) << "Finalizing the cache because EOF has been reached.";
-            cache_->Complete(std::move(temp_cache_));
-          }
+          VLOG(2) << "Finalizing the cache because EOF has been reached.";
+          cache_->Complete();
           return Status::OK();
         }
         RecordBufferEnqueue(ctx, *out_tensors);
-        temp_cache_.emplace_back(*out_tensors);
-        if (temp_cache_.size() == dataset()->input_->Cardinality()) {
+        TF_RETURN_IF_ERROR(cache_->Add(*out_tensors));
+        if (cache_->size() == dataset()->input_->Cardinality()) {
           VLOG(2) << "Finalizing the cache because its size matches the "
                      "expected input cardinality.";
-          cache_->Complete(std::move(temp_cache_));
+          cache_->Complete();
         }
         return Status::OK();
       }
@@ -808,9 +828,16 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       Status SaveInternal(SerializationContext* ctx,
                           IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
-        if (!cache_->IsCompleted()) {
+        if (!claimed_) {
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(full_name(kCacheUnclaimed), ""));
+        } else if (!cache_->IsCompleted()) {
+          std::vector<std::vector<Tensor>> elements(cache_->size());
+          for (size_t i = 0; i < elements.size(); ++i) {
+            TF_RETURN_IF_ERROR(cache_->Get(i, &elements[i]));
+          }
           TF_RETURN_IF_ERROR(
-              WriteElementsToCheckpoint(writer, prefix(), temp_cache_));
+              WriteElementsToCheckpoint(writer, prefix(), elements));
         }
         return SaveInput(ctx, writer, input_impl_);
       }
@@ -818,9 +845,22 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       Status RestoreInternal(IteratorContext* ctx,
                              IteratorStateReader* reader) override {
         mutex_lock l(mu_);
-        if (!reader->Contains(full_name(kCacheCompleted))) {
+        if (reader->Contains(full_name(kCacheUnclaimed))) {
+          // The checkpointed iterator only forwarded its input, so caching
+          // the rest of the input would truncate the cache.
+          if (claimed_) {
+            cache_->Reset();
+            claimed_ = false;
+          }
+        } else if (!reader->Contains(full_name(kCacheCompleted))) {
+          std::vector<std::vector<Tensor>> temp_cache;
           TF_RETURN_IF_ERROR(
-              ReadElementsFromCheckpoint(reader, prefix(), &temp_cache_));
+              ReadElementsFromCheckpoint(reader, prefix(), &temp_cache));
+          if (claimed_) {
+            for (auto& element : temp_cache) {
+              TF_RETURN_IF_ERROR(cache_->Add(std::move(element)));
+            }
+          }
         }
         return RestoreInput(ctx, reader, input_impl_);
       }
@@ -829,7 +869,8 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       mutex mu_;
       std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
       MemoryCache* const cache_ TF_GUARDED_BY(mu_);  // not owned.
-      std::vector<std::vector<Tensor>> temp_cache_ TF_GUARDED_BY(mu_);
+      // Whether this iterator populates the cache.
+      bool claimed_ TF_GUARDED_BY(mu_) = false;
     };  // MemoryWriterIterator
 
     class MemoryReaderIterator : public DatasetIterator<MemoryDatasetBase> {
@@ -846,8 +887,11 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         // is that this is incorrect if there are concurrent instances of this
         // iterator.
         tf_shared_lock l(mu_);
+        std::vector<Tensor> element;
         for (size_t i = 0; i < cache_->size(); ++i) {
-          RecordBufferEnqueue(ctx, cache_->at(i));
+          if (cache_->GetIfInMemory(i, &element)) {
+            RecordBufferEnqueue(ctx, element);
+          }
         }
         return Status::OK();
       }
@@ -857,7 +901,8 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
         if (index_ < cache_->size()) {
-          const std::vector<Tensor>& cache_tensors = cache_->at(index_);
+          std::vector<Tensor> cache_tensors;
+          TF_RETURN_IF_ERROR(cache_->Get(index_, &cache_tensors));
           out_tensors->insert(out_tensors->begin(), cache_tensors.begin(),
                               cache_tensors.end());
           index_++;
@@ -1018,7 +1063,52 @@ class CacheDatasetOp::MemoryDatasetV2
 
 CacheDatasetOp::CacheDatasetOp(OpKernelConstruction* ctx)
     : UnaryDatasetOpKernel(ctx),
-      op_version_(ctx->def().op() == kCacheDataset ? 1 : 2) {}
+      op_version_(ctx->def().op() == kCacheDataset ? 1 : 2) {
+  if (ctx->HasAttr(kMemoryBudget)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kMemoryBudget, &memory_budget_));
+    OP_REQUIRES(ctx, memory_budget_ >= 0,
+                errors::InvalidArgument("Memory budget must be non-negative "
+                                        "but is ",
+                                        memory_budget_, "."));
+  }
+  if (ctx->HasAttr(kSpillDirectory)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kSpillDirectory, &spill_directory_));
+  }
+  if (ctx->HasAttr(kShared)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kShared, &shared_));
+  }
+}
+
+Status CacheDatasetOp::MakeMemoryCache(OpKernelContext* ctx,
+                                       const DatasetBase* input,
+                                       std::shared_ptr<MemoryCache>* cache) {
+  Env* env = ctx->env();
+  const int64 memory_budget = memory_budget_;
+  const string spill_directory = spill_directory_;
+  auto create = [env, memory_budget, spill_directory]() {
+    return std::make_shared<MemoryCache>(env, memory_budget, spill_directory);
+  };
+  if (!shared_) {
+    *cache = create();
+    return Status::OK();
+  }
+  // Datasets with the same input graph produce the same elements, assuming
+  // the input is deterministic.
+  GraphDef graph_def;
+  SerializationContext::Params params;
+  std::vector<std::pair<string, Tensor>> input_list;
+  params.input_list = &input_list;
+  params.external_state_policy =
+      SerializationContext::ExternalStatePolicy::kIgnore;
+  TF_RETURN_IF_ERROR(
+      AsGraphDef(ctx, input, SerializationContext(params), &graph_def));
+  uint64 fingerprint;
+  TF_RETURN_IF_ERROR(HashGraph(graph_def, &fingerprint));
+  fingerprint = Hash64Combine(fingerprint, memory_budget);
+  fingerprint = Hash64Combine(fingerprint, Hash64(spill_directory));
+  *cache = SharedMemoryCaches::Global()->LookupOrCreate(fingerprint, create);
+  return Status::OK();
+}
 
 void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
                                  DatasetBase** output) {
@@ -1038,11 +1128,14 @@ void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
           handle.container(), handle.name(), &manager);
       if (errors::IsNotFound(s)) {
         owns_resource = true;
+        std::shared_ptr<MemoryCache> cache;
+        OP_REQUIRES_OK(ctx, MakeMemoryCache(ctx, input, &cache));
         OP_REQUIRES_OK(
             ctx,
             ctx->resource_manager()->LookupOrCreate<MemoryCacheManager>(
-                container, name, &manager, [](MemoryCacheManager** manager) {
-                  *manager = new MemoryCacheManager();
+                container, name, &manager,
+                [&cache](MemoryCacheManager** manager) {
+                  *manager = new MemoryCacheManager(std::move(cache));
                   return Status::OK();
                 }));
         handle = MakeResourceHandle<MemoryCacheManager>(ctx, container, name);
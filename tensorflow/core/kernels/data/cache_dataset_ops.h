@@ -15,7 +15,11 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_CACHE_DATASET_OPS_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_CACHE_DATASET_OPS_H_
 
+#include <memory>
+#include <string>
+
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/kernels/data/cache_ops.h"
 
 namespace tensorflow {
 namespace data {
@@ -30,6 +34,9 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
   static constexpr const char* const kFileName = "filename";
   static constexpr const char* const kOutputTypes = "output_types";
   static constexpr const char* const kOutputShapes = "output_shapes";
+  static constexpr const char* const kMemoryBudget = "memory_budget";
+  static constexpr const char* const kSpillDirectory = "spill_directory";
+  static constexpr const char* const kShared = "shared";
 
   explicit CacheDatasetOp(OpKernelConstruction* ctx);
 
@@ -43,7 +50,14 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
   class MemoryDataset;
   class MemoryDatasetV2;
 
+  // Returns the memory cache the memory datasets of this op use for `input`.
+  Status MakeMemoryCache(OpKernelContext* ctx, const DatasetBase* input,
+                         std::shared_ptr<MemoryCache>* cache);
+
   const int op_version_;
+  int64 memory_budget_ = 0;
+  std::string spill_directory_;
+  bool shared_ = false;
 };
 
 }  // namespace data
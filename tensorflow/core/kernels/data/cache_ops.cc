@@ -22,23 +22,73 @@ limitations under the License.
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/strcat.h"
+#include "tensorflow/core/protobuf/snapshot.pb.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
 constexpr char kMemoryCache[] = "MemoryCache";
+constexpr char kSpillFileSuffix[] = ".spill";
 
 }  // namespace
 
 string MemoryCacheManager::DebugString() const { return kMemoryCache; }
 
-void MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache) {
+MemoryCache::MemoryCache(Env* env, int64 memory_budget,
+                         const string& spill_directory)
+    : env_(env),
+      memory_budget_(memory_budget),
+      spill_directory_(spill_directory) {}
+
+MemoryCache::~MemoryCache() {
+  mutex_lock l(mu_);
+  DeleteSpillFileLocked();
+}
+
+bool MemoryCache::Claim() {
+  mutex_lock l(mu_);
+  if (completed_ || claimed_) {
+    return false;
+  }
+  claimed_ = true;
+  return true;
+}
+
+Status MemoryCache::Add(std::vector<Tensor> element) {
+  mutex_lock l(mu_);
+  DCHECK(claimed_);
+  if (completed_) {
+    return Status::OK();
+  }
+  return AddLocked(std::move(element));
+}
+
+void MemoryCache::Complete() {
+  mutex_lock l(mu_);
+  DCHECK(claimed_);
+  completed_ = true;
+  claimed_ = false;
+}
+
+Status MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache) {
   mutex_lock l(mu_);
-  if (!completed_) {
-    cache_ = std::move(cache);
-    completed_ = true;
+  if (completed_) {
+    return Status::OK();
+  }
+  cache_.clear();
+  lru_.clear();
+  memory_usage_ = 0;
+  DeleteSpillFileLocked();
+  for (auto& element : cache) {
+    TF_RETURN_IF_ERROR(AddLocked(std::move(element)));
   }
+  cache.clear();
+  completed_ = true;
+  claimed_ = false;
+  return Status::OK();
 }
 
 bool MemoryCache::IsCompleted() {
@@ -49,13 +99,43 @@ bool MemoryCache::IsCompleted() {
 void MemoryCache::Reset() {
   mutex_lock l(mu_);
   completed_ = false;
+  claimed_ = false;
   cache_.clear();
+  lru_.clear();
+  memory_usage_ = 0;
+  DeleteSpillFileLocked();
+}
+
+Status MemoryCache::Get(int64 index, std::vector<Tensor>* element) {
+  if (memory_budget_ <= 0) {
+    tf_shared_lock l(mu_);
+    DCHECK(index < cache_.size());
+    *element = cache_[index].element;
+    return Status::OK();
+  }
+  mutex_lock l(mu_);
+  DCHECK(index < cache_.size());
+  Entry& entry = cache_[index];
+  if (entry.in_memory) {
+    lru_.splice(lru_.begin(), lru_, entry.lru_position);
+  } else {
+    TF_RETURN_IF_ERROR(ReadSpilledLocked(&entry));
+    entry.in_memory = true;
+    memory_usage_ += entry.bytes;
+    entry.lru_position = lru_.insert(lru_.begin(), index);
+  }
+  *element = entry.element;
+  return SpillLocked();
 }
 
-const std::vector<Tensor>& MemoryCache::at(int64 index) {
+bool MemoryCache::GetIfInMemory(int64 index, std::vector<Tensor>* element) {
   tf_shared_lock l(mu_);
   DCHECK(index < cache_.size());
-  return cache_[index];
+  if (!cache_[index].in_memory) {
+    return false;
+  }
+  *element = cache_[index].element;
+  return true;
 }
 
 size_t MemoryCache::size() {
@@ -63,9 +143,142 @@ size_t MemoryCache::size() {
   return cache_.size();
 }
 
-const std::vector<std::vector<Tensor>>& MemoryCache::data() {
+int64 MemoryCache::memory_usage() {
   tf_shared_lock l(mu_);
-  return cache_;
+  return memory_usage_;
+}
+
+Status MemoryCache::AddLocked(std::vector<Tensor> element) {
+  Entry entry;
+  for (const Tensor& tensor : element) {
+    entry.bytes += tensor.TotalBytes();
+  }
+  entry.element = std::move(element);
+  memory_usage_ += entry.bytes;
+  cache_.push_back(std::move(entry));
+  if (memory_budget_ <= 0) {
+    return Status::OK();
+  }
+  cache_.back().lru_position = lru_.insert(lru_.begin(), cache_.size() - 1);
+  return SpillLocked();
+}
+
+Status MemoryCache::SpillLocked() {
+  while (memory_usage_ > memory_budget_ && lru_.size() > 1) {
+    Entry& entry = cache_[lru_.back()];
+    // Elements are immutable, so an element is written at most once and can
+    // afterwards be dropped from memory for free.
+    if (entry.offset < 0) {
+      TF_RETURN_IF_ERROR(WriteSpilledLocked(&entry));
+    }
+    entry.element.clear();
+    entry.in_memory = false;
+    memory_usage_ -= entry.bytes;
+    lru_.pop_back();
+  }
+  return Status::OK();
+}
+
+Status MemoryCache::WriteSpilledLocked(Entry* entry) {
+  if (!spill_writer_) {
+    string filename;
+    if (spill_directory_.empty()) {
+      if (!env_->LocalTempFilename(&filename)) {
+        return errors::Unavailable(
+            "Failed to create a local temporary file to spill the cache to.");
+      }
+    } else {
+      TF_RETURN_IF_ERROR(env_->RecursivelyCreateDir(spill_directory_));
+      filename = io::JoinPath(
+          spill_directory_, strings::StrCat("tf_data_cache_", random::New64(),
+                                            kSpillFileSuffix));
+    }
+    TF_RETURN_IF_ERROR(env_->NewWritableFile(filename, &spill_writer_));
+    spill_filename_ = filename;
+  }
+  experimental::SnapshotRecord record;
+  for (const Tensor& tensor : entry->element) {
+    tensor.AsProtoTensorContent(record.add_tensor());
+  }
+  string serialized;
+  if (!record.SerializeToString(&serialized)) {
+    return errors::Internal("Failed to serialize a cached element.");
+  }
+  TF_RETURN_IF_ERROR(spill_writer_->Append(serialized));
+  entry->offset = spill_file_size_;
+  entry->length = serialized.size();
+  spill_file_size_ += serialized.size();
+  return Status::OK();
+}
+
+Status MemoryCache::ReadSpilledLocked(Entry* entry) {
+  TF_RETURN_IF_ERROR(spill_writer_->Flush());
+  if (!spill_reader_) {
+    TF_RETURN_IF_ERROR(
+        env_->NewRandomAccessFile(spill_filename_, &spill_reader_));
+  }
+  string serialized(entry->length, '\0');
+  StringPiece result;
+  TF_RETURN_IF_ERROR(spill_reader_->Read(entry->offset, entry->length,
+                                         &result, &serialized[0]));
+  if (result.size() != entry->length) {
+    return errors::DataLoss("Failed to read a cached element from ",
+                            spill_filename_, ": expected ", entry->length,
+                            " bytes, got ", result.size(), ".");
+  }
+  experimental::SnapshotRecord record;
+  if (!record.ParseFromArray(result.data(), result.size())) {
+    return errors::DataLoss("Failed to parse a cached element from ",
+                            spill_filename_, ".");
+  }
+  std::vector<Tensor> element(record.tensor_size());
+  for (int i = 0; i < record.tensor_size(); ++i) {
+    if (!element[i].FromProto(record.tensor(i))) {
+      return errors::DataLoss("Failed to parse a cached tensor from ",
+                              spill_filename_, ".");
+    }
+  }
+  entry->element = std::move(element);
+  return Status::OK();
+}
+
+void MemoryCache::DeleteSpillFileLocked() {
+  spill_reader_.reset();
+  spill_writer_.reset();
+  spill_file_size_ = 0;
+  if (!spill_filename_.empty()) {
+    Status s = env_->DeleteFile(spill_filename_);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to delete cache spill file " << spill_filename_
+                   << ": " << s.ToString();
+    }
+    spill_filename_.clear();
+  }
+}
+
+SharedMemoryCaches* SharedMemoryCaches::Global() {
+  static SharedMemoryCaches* caches = new SharedMemoryCaches();
+  return caches;
+}
+
+std::shared_ptr<MemoryCache> SharedMemoryCaches::LookupOrCreate(
+    uint64 fingerprint,
+    const std::function<std::shared_ptr<MemoryCache>()>& create) {
+  mutex_lock l(mu_);
+  std::shared_ptr<MemoryCache> cache = caches_[fingerprint].lock();
+  if (!cache) {
+    cache = create();
+    caches_[fingerprint] = cache;
+  }
+  // Forget the caches which are not used anymore.
+  for (auto it = caches_.begin(); it != caches_.end();) {
+    if (it->second.expired()) {
+      caches_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  return cache;
 }
 
 AnonymousMemoryCacheHandleOp::AnonymousMemoryCacheHandleOp(
@@ -16,45 +16,115 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/kernels/data/dataset_utils.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
 
 namespace tensorflow {
 namespace data {
 
 // A thread-safe data structure for caching dataset elements.
 //
-// The expected use is that a single `MemoryWriterIterator` populates the
-// cache with dataset elements. Once all elements are cached, the cache can
-// be used by one or more `MemoryReaderIterator`s.
+// The expected use is that a single `MemoryWriterIterator` claims the cache
+// and populates it with dataset elements. Once all elements are cached, the
+// cache can be used by one or more `MemoryReaderIterator`s.
+//
+// The cache can be given a memory budget, in which case the least recently
+// used elements exceeding the budget are spilled to a local file, serialized
+// as `SnapshotRecord`s, and read back when accessed.
 class MemoryCache {
  public:
   MemoryCache() = default;
 
-  // Marks the cache as completed.
-  void Complete(std::vector<std::vector<Tensor>>&& cache);
+  // Creates a cache that keeps at most `memory_budget` bytes of elements in
+  // memory, spilling the others to a file in `spill_directory`, or in a local
+  // temporary directory if it is empty. A non-positive budget keeps all
+  // elements in memory.
+  MemoryCache(Env* env, int64 memory_budget, const string& spill_directory);
+
+  ~MemoryCache();
+
+  // Claims the cache for populating it with `Add()`. Returns false if the
+  // cache is completed or has already been claimed.
+  bool Claim();
+
+  // Appends an element to the cache, whose claim must be held by the caller.
+  // Does nothing if the cache has been completed in the meantime.
+  Status Add(std::vector<Tensor> element);
+
+  // Marks the cache populated with `Add()` as completed.
+  void Complete();
+
+  // Marks the cache as completed with the given elements, unless it is
+  // already completed.
+  Status Complete(std::vector<std::vector<Tensor>>&& cache);
 
   // Returns whether the cache is completed.
   bool IsCompleted();
 
-  // Resets the cache.
+  // Resets the cache, which also releases its claim.
   void Reset();
 
   // Returns the element at the given index.
-  const std::vector<Tensor>& at(int64 index);
+  Status Get(int64 index, std::vector<Tensor>* element);
+
+  // Returns the element at the given index if it is in memory, without reading
+  // spilled elements or affecting which elements are spilled.
+  bool GetIfInMemory(int64 index, std::vector<Tensor>* element);
 
   // Returns the size of the cache.
   size_t size();
 
-  // Returns a reference to the cache's data. The returned reference will be
-  // invalidated by any call to Reset().
-  const std::vector<std::vector<Tensor>>& data();
+  // Returns the number of bytes of the elements held in memory.
+  int64 memory_usage();
 
  private:
+  struct Entry {
+    // Empty if the element has been spilled.
+    std::vector<Tensor> element;
+    int64 bytes = 0;
+    bool in_memory = true;
+    // Location of the element in the spill file, if it has been written.
+    int64 offset = -1;
+    int64 length = 0;
+    // Position in `lru_`, if in memory and the cache has a memory budget.
+    std::list<int64>::iterator lru_position;
+  };
+
+  Status AddLocked(std::vector<Tensor> element)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Spills the least recently used entries until the memory budget is met,
+  // keeping at least the most recently used one in memory.
+  Status SpillLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  Status WriteSpilledLocked(Entry* entry) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  Status ReadSpilledLocked(Entry* entry) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void DeleteSpillFileLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  Env* const env_ = nullptr;
+  const int64 memory_budget_ = 0;
+  const string spill_directory_;
+
   mutex mu_;
   // Determines whether all elements of the dataset have been cached.
   bool completed_ TF_GUARDED_BY(mu_) = false;
-  std::vector<std::vector<Tensor>> cache_ TF_GUARDED_BY(mu_);
+  // Determines whether a writer is populating the cache.
+  bool claimed_ TF_GUARDED_BY(mu_) = false;
+  std::vector<Entry> cache_ TF_GUARDED_BY(mu_);
+  int64 memory_usage_ TF_GUARDED_BY(mu_) = 0;
+  // Indices of the entries in memory, from the most to the least recently
+  // used. Only maintained if the cache has a memory budget.
+  std::list<int64> lru_ TF_GUARDED_BY(mu_);
+  string spill_filename_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<WritableFile> spill_writer_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<RandomAccessFile> spill_reader_ TF_GUARDED_BY(mu_);
+  int64 spill_file_size_ TF_GUARDED_BY(mu_) = 0;
 };
 
 // A resource wrapping a shared instance of a memory cache.
@@ -62,6 +132,9 @@ class MemoryCacheManager : public ResourceBase {
  public:
   MemoryCacheManager() : cache_(std::make_shared<MemoryCache>()) {}
 
+  explicit MemoryCacheManager(std::shared_ptr<MemoryCache> cache)
+      : cache_(std::move(cache)) {}
+
   string DebugString() const override;
 
   std::shared_ptr<MemoryCache> get() { return cache_; }
@@ -70,6 +143,27 @@ class MemoryCacheManager : public ResourceBase {
   std::shared_ptr<MemoryCache> cache_;
 };
 
+// Process-wide registry of the memory caches shared by the cache datasets
+// whose inputs have the same fingerprint, so that several datasets producing
+// the same elements, e.g. one per tower of a replicated model, hold a single
+// copy of them. A cache lives as long as a dataset uses it.
+class SharedMemoryCaches {
+ public:
+  // Returns the global registry.
+  static SharedMemoryCaches* Global();
+
+  // Returns the cache registered for `fingerprint`, registering the result of
+  // `create()` if there is none.
+  std::shared_ptr<MemoryCache> LookupOrCreate(
+      uint64 fingerprint,
+      const std::function<std::shared_ptr<MemoryCache>()>& create);
+
+ private:
+  mutex mu_;
+  absl::flat_hash_map<uint64, std::weak_ptr<MemoryCache>> caches_
+      TF_GUARDED_BY(mu_);
+};
+
 // Creates an instance of cache resource and transfers ownership to the caller.
 class AnonymousMemoryCacheHandleOp
     : public AnonymousResourceOp<MemoryCacheManager> {
@@ -0,0 +1,165 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/cache_ops.h"
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr int64 kNumElements = 10;
+
+std::vector<Tensor> MakeElement(int64 i) {
+  return {test::AsTensor<int64>({i, i + 1}),
+          test::AsScalar<tstring>(strings::StrCat("element ", i))};
+}
+
+void ExpectElement(MemoryCache* cache, int64 i) {
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(cache->Get(i, &element));
+  std::vector<Tensor> expected = MakeElement(i);
+  ASSERT_EQ(element.size(), expected.size());
+  test::ExpectTensorEqual<int64>(element[0], expected[0]);
+  EXPECT_EQ(element[1].scalar<tstring>()(), expected[1].scalar<tstring>()());
+}
+
+int64 ElementBytes(int64 i) {
+  int64 bytes = 0;
+  for (const Tensor& tensor : MakeElement(i)) {
+    bytes += tensor.TotalBytes();
+  }
+  return bytes;
+}
+
+TEST(MemoryCacheTest, Claim) {
+  MemoryCache cache;
+  EXPECT_TRUE(cache.Claim());
+  EXPECT_FALSE(cache.Claim());
+  TF_ASSERT_OK(cache.Add(MakeElement(0)));
+  cache.Complete();
+  EXPECT_TRUE(cache.IsCompleted());
+  EXPECT_FALSE(cache.Claim());
+  EXPECT_EQ(cache.size(), 1);
+  ExpectElement(&cache, 0);
+
+  cache.Reset();
+  EXPECT_FALSE(cache.IsCompleted());
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_TRUE(cache.Claim());
+}
+
+TEST(MemoryCacheTest, Unbounded) {
+  MemoryCache cache(Env::Default(), /*memory_budget=*/0,
+                    /*spill_directory=*/"");
+  ASSERT_TRUE(cache.Claim());
+  int64 bytes = 0;
+  for (int64 i = 0; i < kNumElements; ++i) {
+    TF_ASSERT_OK(cache.Add(MakeElement(i)));
+    bytes += ElementBytes(i);
+  }
+  cache.Complete();
+  EXPECT_EQ(cache.memory_usage(), bytes);
+  for (int64 i = 0; i < kNumElements; ++i) {
+    ExpectElement(&cache, i);
+  }
+}
+
+TEST(MemoryCacheTest, SpillsLeastRecentlyUsed) {
+  const string spill_directory =
+      io::JoinPath(testing::TmpDir(), "memory_cache_spill");
+  const int64 budget = 3 * ElementBytes(0);
+  {
+    MemoryCache cache(Env::Default(), budget, spill_directory);
+    ASSERT_TRUE(cache.Claim());
+    for (int64 i = 0; i < kNumElements; ++i) {
+      TF_ASSERT_OK(cache.Add(MakeElement(i)));
+      EXPECT_LE(cache.memory_usage(), budget);
+    }
+    cache.Complete();
+    EXPECT_EQ(cache.size(), kNumElements);
+
+    // Only the most recently added elements are still in memory.
+    std::vector<Tensor> element;
+    EXPECT_FALSE(cache.GetIfInMemory(0, &element));
+    EXPECT_TRUE(cache.GetIfInMemory(kNumElements - 1, &element));
+
+    // Spilled elements are read back, evicting the least recently used ones.
+    for (int epoch = 0; epoch < 2; ++epoch) {
+      for (int64 i = 0; i < kNumElements; ++i) {
+        ExpectElement(&cache, i);
+        EXPECT_LE(cache.memory_usage(), budget);
+      }
+    }
+    EXPECT_TRUE(cache.GetIfInMemory(kNumElements - 1, &element));
+    EXPECT_FALSE(cache.GetIfInMemory(kNumElements - 4, &element));
+    ExpectElement(&cache, kNumElements - 4);
+    EXPECT_TRUE(cache.GetIfInMemory(kNumElements - 4, &element));
+
+    std::vector<string> children;
+    TF_ASSERT_OK(Env::Default()->GetChildren(spill_directory, &children));
+    EXPECT_EQ(children.size(), 1);
+  }
+  // The spill file is deleted with the cache.
+  std::vector<string> children;
+  TF_ASSERT_OK(Env::Default()->GetChildren(spill_directory, &children));
+  EXPECT_TRUE(children.empty());
+}
+
+TEST(MemoryCacheTest, CompleteWithElements) {
+  MemoryCache cache(Env::Default(), /*memory_budget=*/ElementBytes(0),
+                    /*spill_directory=*/"");
+  std::vector<std::vector<Tensor>> elements;
+  for (int64 i = 0; i < kNumElements; ++i) {
+    elements.push_back(MakeElement(i));
+  }
+  TF_ASSERT_OK(cache.Complete(std::move(elements)));
+  EXPECT_TRUE(cache.IsCompleted());
+  EXPECT_LE(cache.memory_usage(), ElementBytes(0));
+  for (int64 i = kNumElements - 1; i >= 0; --i) {
+    ExpectElement(&cache, i);
+  }
+}
+
+TEST(SharedMemoryCachesTest, LookupOrCreate) {
+  int num_created = 0;
+  auto create = [&num_created]() {
+    ++num_created;
+    return std::make_shared<MemoryCache>();
+  };
+  std::shared_ptr<MemoryCache> cache1 =
+      SharedMemoryCaches::Global()->LookupOrCreate(1, create);
+  std::shared_ptr<MemoryCache> cache2 =
+      SharedMemoryCaches::Global()->LookupOrCreate(1, create);
+  std::shared_ptr<MemoryCache> cache3 =
+      SharedMemoryCaches::Global()->LookupOrCreate(2, create);
+  EXPECT_EQ(cache1, cache2);
+  EXPECT_NE(cache1, cache3);
+  EXPECT_EQ(num_created, 2);
+
+  // A cache is recreated once no dataset uses it anymore.
+  cache1.reset();
+  cache2.reset();
+  std::shared_ptr<MemoryCache> cache4 =
+      SharedMemoryCaches::Global()->LookupOrCreate(1, create);
+  EXPECT_EQ(num_created, 3);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -224,6 +224,9 @@ class GroupByWindowDatasetOp : public UnaryDatasetOpKernel {
             // We have reached the end of the current group, so maybe move on
             // to the next group.
             current_group_iterator_.reset();
+            for (const auto& element : groups_[current_key_]) {
+              RecordBufferDequeue(ctx, element);
+            }
             groups_.erase(current_key_);
           }
 
@@ -277,6 +280,9 @@ class GroupByWindowDatasetOp : public UnaryDatasetOpKernel {
 
               const int64 window_size = window_sizes_[key];
 
+              // Account for the buffered elements, so that autotuning keeps
+              // the pipeline within its RAM budget.
+              RecordBufferEnqueue(ctx, next_input_element);
               std::vector<std::vector<Tensor>>& group = groups_[key];
               group.push_back(std::move(next_input_element));
 
@@ -393,7 +399,10 @@ class GroupByWindowDatasetOp : public UnaryDatasetOpKernel {
             TF_RETURN_IF_ERROR(RestoreGroup(
                 reader, full_name(strings::StrCat("groups_[", idx, "]")),
                 &group));
-            groups_[key] = group;
+            for (const auto& element : group) {
+              RecordBufferEnqueue(ctx, element);
+            }
+            groups_[key] = std::move(group);
           }
         }
 
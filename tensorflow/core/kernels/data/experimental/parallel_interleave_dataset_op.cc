@@ -335,6 +335,9 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
                   "ParallelInterleaveConsume",
                   {{"element_id", current_worker->outputs.front().id}});
             });
+            if (s.ok()) {
+              RecordBufferDequeue(ctx, current_worker->outputs.front().output);
+            }
             current_worker->outputs.front().output.swap(*out_tensors);
             current_worker->outputs.pop_front();
             current_worker->cond_var.notify_one();
@@ -878,6 +881,12 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
                 worker_thread_states_[thread_index].input.clear();
                 worker_thread_states_[thread_index].end_of_sequence = false;
               } else {
+                if (worker_thread_states_[thread_index].output_elem.status
+                        .ok()) {
+                  RecordBufferEnqueue(
+                      ctx.get(),
+                      worker_thread_states_[thread_index].output_elem.output);
+                }
                 workers_[thread_index].outputs.emplace_back(
                     worker_thread_states_[thread_index].output_elem.status,
                     worker_thread_states_[thread_index].output_elem.id);
@@ -639,13 +639,22 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
                           std::vector<Tensor>* output) {
         thread::ThreadPool* device_threadpool =
             ctx->flr()->device()->tensorflow_cpu_worker_threads()->workers;
+        // The input is normally a single vector of serialized examples, which
+        // is parsed in place. Only multiple input components are copied into
+        // one contiguous vector.
         std::vector<tstring> slice_vec;
-        for (const Tensor& t : input) {
-          auto serialized_t = t.flat<tstring>();
-          gtl::ArraySlice<tstring> slice(serialized_t.data(),
-                                         serialized_t.size());
-          for (auto it = slice.begin(); it != slice.end(); it++)
-            slice_vec.push_back(*it);
+        gtl::ArraySlice<tstring> serialized;
+        if (input.size() == 1) {
+          auto serialized_t = input[0].flat<tstring>();
+          serialized = gtl::ArraySlice<tstring>(serialized_t.data(),
+                                                serialized_t.size());
+        } else {
+          for (const Tensor& t : input) {
+            auto serialized_t = t.flat<tstring>();
+            slice_vec.insert(slice_vec.end(), serialized_t.data(),
+                             serialized_t.data() + serialized_t.size());
+          }
+          serialized = slice_vec;
         }
         example::FastParseExampleConfig config = dataset()->config_;
         // local copy of config_ for modification.
@@ -655,14 +664,14 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
         }
         example::Result example_result;
         TF_RETURN_IF_ERROR(FastParseExample(
-            config, slice_vec, {}, device_threadpool, &example_result));
+            config, serialized, {}, device_threadpool, &example_result));
         (*output).resize(dataset()->key_to_output_index_.size());
         for (int d = 0; d < dataset()->dense_keys_.size(); ++d) {
           int output_index =
               dataset()->key_to_output_index_.at(dataset()->dense_keys_[d]);
           TF_RETURN_IF_ERROR(CheckOutputTensor(example_result.dense_values[d],
                                                d, output_index));
-          (*output)[output_index] = example_result.dense_values[d];
+          (*output)[output_index] = std::move(example_result.dense_values[d]);
         }
         for (int d = 0; d < dataset()->sparse_keys_.size(); ++d) {
           int output_index =
@@ -670,9 +679,9 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
           (*output)[output_index] = Tensor(ctx->allocator({}), DT_VARIANT, {3});
           Tensor& serialized_sparse = (*output)[output_index];
           auto serialized_sparse_t = serialized_sparse.vec<Variant>();
-          serialized_sparse_t(0) = example_result.sparse_indices[d];
-          serialized_sparse_t(1) = example_result.sparse_values[d];
-          serialized_sparse_t(2) = example_result.sparse_shapes[d];
+          serialized_sparse_t(0) = std::move(example_result.sparse_indices[d]);
+          serialized_sparse_t(1) = std::move(example_result.sparse_values[d]);
+          serialized_sparse_t(2) = std::move(example_result.sparse_shapes[d]);
           TF_RETURN_IF_ERROR(
               CheckOutputTensor(serialized_sparse, d, output_index));
         }
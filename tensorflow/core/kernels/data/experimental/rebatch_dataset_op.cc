@@ -414,12 +414,16 @@ class RebatchDatasetV2Op : public UnaryDatasetOpKernel {
           int64 slice_end = std::min(offset_ + desired_batch_size - batch_size,
                                      tensors_[0].dim_size(0));
 
-          std::vector<Tensor> slices;
-          slices.reserve(tensors_.size());
-          for (const auto& tensor : tensors_) {
-            slices.push_back(tensor.Slice(offset_, slice_end));
+          // Empty input batches contribute nothing, and skipping them lets a
+          // batch with a single non-empty slice alias it instead of copying.
+          if (slice_end > offset_) {
+            std::vector<Tensor> slices;
+            slices.reserve(tensors_.size());
+            for (const auto& tensor : tensors_) {
+              slices.push_back(tensor.Slice(offset_, slice_end));
+            }
+            slices_to_concatenate.push_back(std::move(slices));
           }
-          slices_to_concatenate.push_back(std::move(slices));
 
           batch_size += (slice_end - offset_);
           offset_ = slice_end;
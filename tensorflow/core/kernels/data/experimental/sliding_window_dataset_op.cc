@@ -171,6 +171,7 @@ class SlidingWindowDatasetOp : public UnaryDatasetOpKernel {
             TF_RETURN_IF_ERROR(
                 input_impl_->GetNext(ctx, &element, end_of_sequence));
             if (!*end_of_sequence) {
+              RecordBufferEnqueue(ctx, element);
               buffer_.push_back(std::move(element));
             } else {
               input_impl_.reset();
@@ -199,8 +200,14 @@ class SlidingWindowDatasetOp : public UnaryDatasetOpKernel {
                 break;
               }
             }
+            for (const auto& element : buffer_) {
+              RecordBufferDequeue(ctx, element);
+            }
             buffer_.clear();
           } else {
+            for (size_t i = 0; i < window_shift; ++i) {
+              RecordBufferDequeue(ctx, buffer_[i]);
+            }
             buffer_.erase(buffer_.begin(), buffer_.begin() + window_shift);
           }
         }
@@ -914,6 +914,8 @@ const int64 kCurrentVersion = 1;
 
 constexpr char kSnapshotReaderWorkerPool[] = "snapshot_reader_worker_pool";
 constexpr char kSnapshotWriterWorkerPool[] = "snapshot_writer_worker_pool";
+constexpr char kSnapshotCompressionWorkerPool[] =
+    "snapshot_compression_worker_pool";
 constexpr char kSeparator[] = "::";
 constexpr char kBookkeeping[] = "Bookkeeping";
 constexpr char kSnapshotReadElements[] = "snapshot_read_elements";
@@ -938,6 +940,8 @@ constexpr char kCode[] = ".code";
 constexpr char kErrorMessage[] = ".error_message";
 constexpr char kEndOfSequence[] = "end_of_sequence";
 constexpr char kBuffer[] = "buffer";
+constexpr char kEncodedBuffer[] = "encoded_buffer";
+constexpr char kNumBytes[] = "num_bytes";
 constexpr char kNumElementsWritten[] = "num_elements_written";
 constexpr char kNextElem[] = "next_elem";
 
@@ -980,6 +984,12 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
       OP_REQUIRES_OK(ctx, ctx->GetAttr("snapshot_name", &snapshot_name_));
     }
 
+    num_compression_threads_ = 0;
+    if (ctx->HasAttr("num_compression_threads")) {
+      OP_REQUIRES_OK(ctx, ctx->GetAttr("num_compression_threads",
+                                       &num_compression_threads_));
+    }
+
     if (shard_size_bytes_ == -1) shard_size_bytes_ = kDefaultShardSizeBytes;
 
     // Default to 1 day expiry for snapshots.
@@ -991,6 +1001,11 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
     if (reader_buffer_size_ == -1) reader_buffer_size_ = 1;
     if (num_writer_threads_ == -1) num_writer_threads_ = 1;
     if (writer_buffer_size_ == -1) writer_buffer_size_ = 1;
+    if (num_compression_threads_ == -1) num_compression_threads_ = 0;
+
+    OP_REQUIRES(ctx, num_compression_threads_ >= 0,
+                errors::InvalidArgument(
+                    "num_compression_threads must be non-negative."));
 
     OP_REQUIRES(
         ctx,
@@ -1051,8 +1066,9 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
                           writer_path_prefix_, compression_, shard_size_bytes_,
                           pending_snapshot_expiry_seconds_, num_reader_threads_,
                           reader_buffer_size_, num_writer_threads_,
-                          writer_buffer_size_, shuffle_on_read_, seed_, seed2_,
-                          mode_, snapshot_name_);
+                          writer_buffer_size_, num_compression_threads_,
+                          shuffle_on_read_, seed_, seed2_, mode_,
+                          snapshot_name_);
   }
 
  private:
@@ -1065,7 +1081,8 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
             const uint64 pending_snapshot_expiry_seconds,
             const uint64 num_reader_threads, const uint64 reader_buffer_size,
             const uint64 num_writer_threads, const uint64 writer_buffer_size,
-            const bool shuffle_on_read, const uint64 seed, const uint64 seed2,
+            const uint64 num_compression_threads, const bool shuffle_on_read,
+            const uint64 seed, const uint64 seed2,
             const std::string& mode, const std::string& snapshot_name)
         : DatasetBase(DatasetContext(ctx)),
           input_(input),
@@ -1080,6 +1097,7 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
           reader_buffer_size_(reader_buffer_size),
           num_writer_threads_(num_writer_threads),
           writer_buffer_size_(writer_buffer_size),
+          num_compression_threads_(num_compression_threads),
           shuffle_on_read_(shuffle_on_read),
           seed_(seed),
           seed2_(seed2),
@@ -1156,6 +1174,10 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
       AttrValue writer_buffer_size_attr;
       b->BuildAttrValue<int64>(writer_buffer_size_, &writer_buffer_size_attr);
 
+      AttrValue num_compression_threads_attr;
+      b->BuildAttrValue<int64>(num_compression_threads_,
+                               &num_compression_threads_attr);
+
       AttrValue shuffle_on_read_attr;
       b->BuildAttrValue<bool>(shuffle_on_read_, &shuffle_on_read_attr);
 
@@ -1188,6 +1210,7 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
            {"reader_buffer_size", reader_buffer_size_attr},
            {"num_writer_threads", num_writer_threads_attr},
            {"writer_buffer_size", writer_buffer_size_attr},
+           {"num_compression_threads", num_compression_threads_attr},
            {"shuffle_on_read", shuffle_on_read_attr},
            {"seed", seed_attr},
            {"seed2", seed2_attr},
@@ -1779,6 +1802,11 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
         Status Initialize(IteratorContext* ctx) override {
           thread_pool_ = ctx->CreateThreadPool(kSnapshotWriterWorkerPool,
                                                dataset()->num_writer_threads_);
+          if (dataset()->num_compression_threads_ > 0) {
+            compression_thread_pool_ = ctx->CreateThreadPool(
+                kSnapshotCompressionWorkerPool,
+                dataset()->num_compression_threads_);
+          }
           return dataset()->input_->MakeIterator(ctx, this, prefix(),
                                                  &input_impl_);
         }
@@ -1816,6 +1844,12 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
                 thread_pool_->Schedule(
                     [this, env = ctx->env()]() { WriterThread(env); });
               }
+              for (int i = 0; i < dataset()->num_compression_threads_; ++i) {
+                ++num_active_threads_;
+                ++num_active_compression_threads_;
+                compression_thread_pool_->Schedule(
+                    [this]() { CompressionThread(); });
+              }
               first_call_ = false;
             }
           }
@@ -1925,6 +1959,26 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
                   buffer_element.value[j]));
             }
           }
+          TF_RETURN_IF_ERROR(writer->WriteScalar(
+              full_name(strings::StrCat(kEncodedBuffer, kSizeSuffix)),
+              encoded_buffer_.size()));
+          for (size_t i = 0; i < encoded_buffer_.size(); ++i) {
+            const EncodedElement& encoded_element = encoded_buffer_[i];
+            TF_RETURN_IF_ERROR(writer->WriteScalar(
+                full_name(
+                    strings::StrCat(kEncodedBuffer, "[", i, "].", kNumBytes)),
+                encoded_element.num_bytes));
+            TF_RETURN_IF_ERROR(writer->WriteScalar(
+                full_name(
+                    strings::StrCat(kEncodedBuffer, "[", i, "]", kSizeSuffix)),
+                encoded_element.records.size()));
+            for (size_t j = 0; j < encoded_element.records.size(); ++j) {
+              TF_RETURN_IF_ERROR(writer->WriteScalar(
+                  full_name(
+                      strings::StrCat(kEncodedBuffer, "[", i, "][", j, "]")),
+                  encoded_element.records[j]));
+            }
+          }
           TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kNumElementsWritten),
                                                  num_elements_written_));
           if (next_elem_.end_of_sequence) {
@@ -1949,6 +2003,7 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
                                IteratorStateReader* reader) override {
           mutex_lock l(mu_);
           buffer_.clear();
+          encoded_buffer_.clear();
           TF_RETURN_IF_ERROR(RestoreInput(ctx, reader, input_impl_));
           tstring hash_dir;
           TF_RETURN_IF_ERROR(
@@ -2005,6 +2060,36 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
                   &buffer_element.value.back()));
             }
           }
+          // Checkpoints written before elements could be encoded ahead of the
+          // writer threads have no encoded buffer.
+          if (reader->Contains(
+                  full_name(strings::StrCat(kEncodedBuffer, kSizeSuffix)))) {
+            int64 encoded_buffer_size;
+            TF_RETURN_IF_ERROR(reader->ReadScalar(
+                full_name(strings::StrCat(kEncodedBuffer, kSizeSuffix)),
+                &encoded_buffer_size));
+            for (int64 i = 0; i < encoded_buffer_size; ++i) {
+              encoded_buffer_.emplace_back();
+              EncodedElement& encoded_element = encoded_buffer_.back();
+              TF_RETURN_IF_ERROR(reader->ReadScalar(
+                  full_name(
+                      strings::StrCat(kEncodedBuffer, "[", i, "].", kNumBytes)),
+                  &encoded_element.num_bytes));
+              int64 num_records;
+              TF_RETURN_IF_ERROR(reader->ReadScalar(
+                  full_name(strings::StrCat(kEncodedBuffer, "[", i, "]",
+                                            kSizeSuffix)),
+                  &num_records));
+              for (int64 j = 0; j < num_records; ++j) {
+                tstring record;
+                TF_RETURN_IF_ERROR(reader->ReadScalar(
+                    full_name(
+                        strings::StrCat(kEncodedBuffer, "[", i, "][", j, "]")),
+                    &record));
+                encoded_element.records.push_back(std::string(record));
+              }
+            }
+          }
           // Since the last save we might have written out some files. So we
           // get a list of files in the directory and take the final filename
           // written. We use the name of the snapshot file to figure out
@@ -2118,21 +2203,44 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
           bool produced_elem = false;
           bool snapshot_failed = false;
           snapshot_util::ElementOrEOF elem;
+          EncodedElement encoded_elem;
+          const bool encoded = dataset()->num_compression_threads_ > 0;
           {
             mutex_lock l(mu_);
-            // Wait for buffer to not be empty.
-            while (!cancelled_ && buffer_.empty() && !end_of_sequence_ &&
-                   !snapshot_failed_) {
-              cond_var_.wait(l);
-            }
-            cancelled = cancelled_;
-            if (!buffer_.empty()) {
-              produced_elem = true;
-              std::swap(elem, buffer_.front());
-              buffer_.pop_front();
-              cond_var_.notify_all();
+            if (encoded) {
+              // Wait for the compression threads to encode an element, or to
+              // finish.
+              while (!cancelled_ && encoded_buffer_.empty() &&
+                     !snapshot_failed_ &&
+                     !(end_of_sequence_ &&
+                       num_active_compression_threads_ == 0)) {
+                cond_var_.wait(l);
+              }
+              cancelled = cancelled_;
+              if (!encoded_buffer_.empty()) {
+                produced_elem = true;
+                std::swap(encoded_elem, encoded_buffer_.front());
+                encoded_buffer_.pop_front();
+                cond_var_.notify_all();
+              } else {
+                *end_of_processing =
+                    end_of_sequence_ && num_active_compression_threads_ == 0;
+              }
             } else {
-              *end_of_processing = end_of_sequence_;
+              // Wait for buffer to not be empty.
+              while (!cancelled_ && buffer_.empty() && !end_of_sequence_ &&
+                     !snapshot_failed_) {
+                cond_var_.wait(l);
+              }
+              cancelled = cancelled_;
+              if (!buffer_.empty()) {
+                produced_elem = true;
+                std::swap(elem, buffer_.front());
+                buffer_.pop_front();
+                cond_var_.notify_all();
+              } else {
+                *end_of_processing = end_of_sequence_;
+              }
             }
             snapshot_failed = snapshot_failed_;
           }
@@ -2148,6 +2256,9 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
           }
 
           if (produced_elem) {
+            if (encoded) {
+              *bytes_written += encoded_elem.num_bytes;
+            }
             for (const auto& out_tensor : elem.value) {
               *bytes_written += out_tensor.TotalBytes();
             }
@@ -2166,7 +2277,12 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
                   kCurrentVersion, dataset()->output_dtypes(), writer));
               *bytes_written = 0;
             }
-            TF_RETURN_IF_ERROR((*writer)->WriteTensors(elem.value));
+            if (encoded) {
+              TF_RETURN_IF_ERROR(
+                  (*writer)->WriteEncodedTensors(encoded_elem.records));
+            } else {
+              TF_RETURN_IF_ERROR((*writer)->WriteTensors(elem.value));
+            }
             return Status::OK();
           }
 
@@ -2234,6 +2350,55 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
           }
         }
 
+        // Pulls elements off the buffer and encodes them for the writer
+        // threads, so that compression is not limited to one thread per file
+        // being written.
+        void CompressionThread() {
+          auto cleanup = gtl::MakeCleanup([this]() {
+            mutex_lock l(mu_);
+            --num_active_threads_;
+            --num_active_compression_threads_;
+            cond_var_.notify_all();
+          });
+
+          while (true) {
+            snapshot_util::ElementOrEOF elem;
+            {
+              mutex_lock l(mu_);
+              // Wait for an element to encode and for room to store it.
+              while (!cancelled_ && !snapshot_failed_ &&
+                     ((buffer_.empty() && !end_of_sequence_) ||
+                      encoded_buffer_.size() >=
+                          dataset()->writer_buffer_size_)) {
+                cond_var_.wait(l);
+              }
+              if (cancelled_ || snapshot_failed_ || buffer_.empty()) {
+                return;
+              }
+              std::swap(elem, buffer_.front());
+              buffer_.pop_front();
+              cond_var_.notify_all();
+            }
+
+            EncodedElement encoded_elem;
+            for (const auto& tensor : elem.value) {
+              encoded_elem.num_bytes += tensor.TotalBytes();
+            }
+            Status s = snapshot_util::CustomWriter::EncodeTensors(
+                elem.value, dataset()->compression_, &encoded_elem.records);
+            mutex_lock l(mu_);
+            if (!s.ok()) {
+              LOG(INFO) << "Error while compressing snapshot data: "
+                        << s.ToString();
+              snapshot_failed_ = true;
+              cond_var_.notify_all();
+              return;
+            }
+            encoded_buffer_.push_back(std::move(encoded_elem));
+            cond_var_.notify_all();
+          }
+        }
+
         Status ShouldCloseWriter(Env* env, const string& filename,
                                  uint64 bytes_written,
                                  snapshot_util::Writer* writer,
@@ -2269,6 +2434,13 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
           return Status::OK();
         }
 
+        // The records `snapshot_util::CustomWriter` writes for an element.
+        struct EncodedElement {
+          std::vector<std::string> records;
+          // Size of the element's tensors before encoding.
+          int64 num_bytes = 0;
+        };
+
         mutex mu_;
         // This condition variable is notified
         // 1. By the background writer threads when an element from the buffer
@@ -2278,6 +2450,8 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
         // 4. By the background writer threads when any error is encountered
         //    while writing.
         // 5. By the background threads when they finish.
+        // 6. By the background compression threads when they add an element
+        //    to the encoded buffer.
         condition_variable cond_var_;
 
         snapshot_util::ElementOrEOF next_elem_ TF_GUARDED_BY(mu_);
@@ -2294,6 +2468,9 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
         int64 bytes_produced_ TF_GUARDED_BY(mu_) = 0;
 
         std::deque<snapshot_util::ElementOrEOF> buffer_ TF_GUARDED_BY(mu_);
+        // Elements encoded by the compression threads, waiting to be written.
+        // Only used if `num_compression_threads` is positive.
+        std::deque<EncodedElement> encoded_buffer_ TF_GUARDED_BY(mu_);
         bool snapshot_failed_ TF_GUARDED_BY(mu_) = false;
         bool cancelled_ TF_GUARDED_BY(mu_) = false;
         bool first_call_ TF_GUARDED_BY(mu_) = true;
@@ -2301,7 +2478,10 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
         bool written_final_metadata_file_ TF_GUARDED_BY(mu_) = false;
         uint64 next_file_index_ TF_GUARDED_BY(mu_) = 0;
         std::unique_ptr<thread::ThreadPool> thread_pool_;
+        std::unique_ptr<thread::ThreadPool> compression_thread_pool_;
+        // Number of writer and compression threads still running.
         int64 num_active_threads_ TF_GUARDED_BY(mu_) = 0;
+        int64 num_active_compression_threads_ TF_GUARDED_BY(mu_) = 0;
         int64 num_elements_written_ = 0;
       };
 
@@ -2357,6 +2537,7 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
     const uint64 reader_buffer_size_;
     const uint64 num_writer_threads_;
     const uint64 writer_buffer_size_;
+    const uint64 num_compression_threads_;
     const bool shuffle_on_read_;
 
     const uint64 seed_;
@@ -2393,6 +2574,7 @@ class SnapshotDatasetOp : public UnaryDatasetOpKernel {
   int64 reader_buffer_size_;
   int64 num_writer_threads_;
   int64 writer_buffer_size_;
+  int64 num_compression_threads_;
   bool shuffle_on_read_;
 
   int64 seed_;
@@ -184,16 +184,6 @@ Status CustomWriter::Initialize(tensorflow::Env* env) {
     dest_.reset(zlib_output_buffer);
   }
 #endif  // IS_SLIM_BUILD
-  simple_tensor_mask_.reserve(dtypes_.size());
-  for (const auto& dtype : dtypes_) {
-    if (DataTypeCanUseMemcpy(dtype)) {
-      simple_tensor_mask_.push_back(true);
-      num_simple_++;
-    } else {
-      simple_tensor_mask_.push_back(false);
-      num_complex_++;
-    }
-  }
 
   return Status::OK();
 }
@@ -217,10 +207,35 @@ Status CustomWriter::WriteTensors(const std::vector<Tensor>& tensors) {
 #endif  // TF_CORD_SUPPORT
   }
 
+  std::vector<std::string> records;
+  TF_RETURN_IF_ERROR(EncodeTensors(tensors, compression_type_, &records));
+  return WriteEncodedTensors(records);
+}
+
+Status CustomWriter::WriteEncodedTensors(
+    const std::vector<std::string>& records) {
+  for (const std::string& record : records) {
+    TF_RETURN_IF_ERROR(WriteRecord(record));
+  }
+  return Status::OK();
+}
+
+Status CustomWriter::EncodeTensors(const std::vector<Tensor>& tensors,
+                                   const std::string& compression_type,
+                                   std::vector<std::string>* records) {
+  records->clear();
+  if (compression_type != io::compression::kSnappy) {
+    experimental::SnapshotRecord record;
+    for (const auto& tensor : tensors) {
+      TensorProto* t = record.add_tensor();
+      tensor.AsProtoTensorContent(t);
+    }
+    records->push_back(record.SerializeAsString());
+    return Status::OK();
+  }
+
   std::vector<const TensorBuffer*> tensor_buffers;
-  tensor_buffers.reserve(num_simple_);
   std::vector<TensorProto> tensor_protos;
-  tensor_protos.reserve(num_complex_);
   experimental::SnapshotTensorMetadata metadata;
   int64 total_size = 0;
   for (int i = 0, end = tensors.size(); i < end; ++i) {
@@ -229,7 +244,7 @@ Status CustomWriter::WriteTensors(const std::vector<Tensor>& tensors) {
         metadata.add_tensor_metadata();
     tensor.shape().AsProto(tensor_metadata->mutable_tensor_shape());
     int64 size = 0;
-    if (simple_tensor_mask_[i]) {
+    if (DataTypeCanUseMemcpy(tensor.dtype())) {
       auto tensor_buffer = DMAHelper::buffer(&tensor);
       tensor_buffers.push_back(tensor_buffer);
       size = tensor_buffer->size();
@@ -249,7 +264,7 @@ Status CustomWriter::WriteTensors(const std::vector<Tensor>& tensors) {
   int proto_index = 0;
   for (int i = 0, end = tensors.size(); i < end; ++i) {
     const auto& tensor_metadata = metadata.tensor_metadata(i);
-    if (simple_tensor_mask_[i]) {
+    if (DataTypeCanUseMemcpy(tensors[i].dtype())) {
       memcpy(position, tensor_buffers[buffer_index]->data(),
              tensor_metadata.tensor_size_bytes());
       buffer_index++;
@@ -266,18 +281,8 @@ Status CustomWriter::WriteTensors(const std::vector<Tensor>& tensors) {
   if (!port::Snappy_Compress(uncompressed.data(), total_size, &output)) {
     return errors::Internal("Failed to compress using snappy.");
   }
-
-#if defined(TF_CORD_SUPPORT)
-  auto metadata_buffer = new std::string();
-  metadata.SerializeToString(metadata_buffer);
-  absl::Cord metadata_serialized = absl::MakeCordFromExternal(
-      *metadata_buffer,
-      [metadata_buffer](absl::string_view) { delete metadata_buffer; });
-#else
-  std::string metadata_serialized = metadata.SerializeAsString();
-#endif  // TF_CORD_SUPPORT
-  TF_RETURN_IF_ERROR(WriteRecord(metadata_serialized));
-  TF_RETURN_IF_ERROR(WriteRecord(output));
+  records->push_back(metadata.SerializeAsString());
+  records->push_back(std::move(output));
   return Status::OK();
 }
 
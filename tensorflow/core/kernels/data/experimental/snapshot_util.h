@@ -81,6 +81,13 @@ class Writer {
   // Writes a vector of tensors to the snapshot writer file.
   virtual Status WriteTensors(const std::vector<Tensor>& tensors) = 0;
 
+  // Writes records produced by `CustomWriter::EncodeTensors`. Only supported
+  // by writers of the custom file format.
+  virtual Status WriteEncodedTensors(const std::vector<std::string>& records) {
+    return errors::Unimplemented(
+        "This snapshot writer does not support writing encoded tensors.");
+  }
+
   // Flushes any in-memory buffers to disk.
   virtual Status Sync() = 0;
 
@@ -134,12 +141,22 @@ class CustomWriter : public Writer {
 
   Status WriteTensors(const std::vector<Tensor>& tensors) override;
 
+  Status WriteEncodedTensors(const std::vector<std::string>& records) override;
+
   Status Sync() override;
 
   Status Close() override;
 
   ~CustomWriter() override;
 
+  // Serializes `tensors` and, for snappy compression, compresses them into the
+  // records `WriteTensors` would write, so that this expensive part of writing
+  // can run on other threads than the file writes. GZIP compression is applied
+  // to the whole file, so it still happens in `WriteEncodedTensors`.
+  static Status EncodeTensors(const std::vector<Tensor>& tensors,
+                              const std::string& compression_type,
+                              std::vector<std::string>* records);
+
  protected:
   Status Initialize(tensorflow::Env* env) override;
 
@@ -158,9 +175,6 @@ class CustomWriter : public Writer {
   // in dest_ if we want compression. ZlibOutputBuffer doesn't own the original
   // dest_ and so we need somewhere to store the original one.
   std::unique_ptr<WritableFile> zlib_underlying_dest_;
-  std::vector<bool> simple_tensor_mask_;  // true for simple, false for complex.
-  int num_simple_ = 0;
-  int num_complex_ = 0;
 };
 
 // Interface class for reading snapshot files previous written with Writer.
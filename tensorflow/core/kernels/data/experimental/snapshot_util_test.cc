@@ -38,7 +38,8 @@ void GenerateTensorVector(tensorflow::DataTypeVector& dtypes,
   }
 }
 
-void SnapshotRoundTrip(std::string compression_type, int version) {
+void SnapshotRoundTrip(std::string compression_type, int version,
+                       bool write_encoded = false) {
   // Generate ground-truth tensors for writing and reading.
   std::vector<Tensor> tensors;
   tensorflow::DataTypeVector dtypes;
@@ -52,7 +53,14 @@ void SnapshotRoundTrip(std::string compression_type, int version) {
                               compression_type, version, dtypes, &writer));
 
   for (int i = 0; i < 100; ++i) {
-    TF_ASSERT_OK(writer->WriteTensors(tensors));
+    if (write_encoded) {
+      std::vector<std::string> records;
+      TF_ASSERT_OK(
+          CustomWriter::EncodeTensors(tensors, compression_type, &records));
+      TF_ASSERT_OK(writer->WriteEncodedTensors(records));
+    } else {
+      TF_ASSERT_OK(writer->WriteTensors(tensors));
+    }
   }
   TF_ASSERT_OK(writer->Close());
 
@@ -91,6 +99,23 @@ TEST(SnapshotUtilTest, CombinationRoundTripTest) {
   SnapshotRoundTrip(io::compression::kSnappy, 2);
 }
 
+TEST(SnapshotUtilTest, EncodedRoundTripTest) {
+  SnapshotRoundTrip(io::compression::kNone, 1, /*write_encoded=*/true);
+  SnapshotRoundTrip(io::compression::kGzip, 1, /*write_encoded=*/true);
+  SnapshotRoundTrip(io::compression::kSnappy, 1, /*write_encoded=*/true);
+}
+
+TEST(SnapshotUtilTest, TFRecordWriterDoesNotWriteEncodedTensors) {
+  std::string filename;
+  EXPECT_TRUE(Env::Default()->LocalTempFilename(&filename));
+  std::unique_ptr<Writer> writer;
+  TF_ASSERT_OK(Writer::Create(Env::Default(), filename, io::compression::kNone,
+                              /*version=*/2, {DT_STRING}, &writer));
+  EXPECT_EQ(writer->WriteEncodedTensors({}).code(), error::UNIMPLEMENTED);
+  TF_ASSERT_OK(writer->Close());
+  TF_ASSERT_OK(Env::Default()->DeleteFile(filename));
+}
+
 void SnapshotReaderBenchmarkLoop(int iters, std::string compression_type,
                                  int version) {
   tensorflow::testing::StopTiming();
@@ -33,10 +33,23 @@ namespace data {
 namespace {
 
 constexpr int64 kOptimizationPeriodThresholdMs = 60 * EnvTime::kSecondsToMillis;
+constexpr int64 kOptimizationPeriodMinMs = 10;
 
 // Default share of available RAM that can be used by model's internal buffers.
 constexpr double kRamBudgetShare = 0.5;
 
+const char* AutotuneAlgorithmName(model::AutotuneAlgorithm algorithm) {
+  switch (algorithm) {
+    case model::AutotuneAlgorithm::HILL_CLIMB:
+      return "hill climb";
+    case model::AutotuneAlgorithm::GRADIENT_DESCENT:
+      return "gradient descent";
+    case model::AutotuneAlgorithm::LEARNED:
+      return "learned";
+  }
+  return "unknown";
+}
+
 }  // namespace
 
 /* static */ constexpr const char* const ModelDatasetOp::kAlgorithm;
@@ -54,9 +67,7 @@ class ModelDatasetOp::Dataset : public DatasetBase {
         cpu_budget_(cpu_budget),
         ram_budget_(ram_budget),
         traceme_metadata_(
-            {{"algorithm", algorithm == model::AutotuneAlgorithm::HILL_CLIMB
-                               ? "hill climb"
-                               : "gradient descent"},
+            {{"algorithm", AutotuneAlgorithmName(algorithm)},
              {"cpu_budget",
               strings::Printf("%lld", static_cast<long long>(cpu_budget))},
              {"ram_budget",
@@ -121,10 +132,7 @@ class ModelDatasetOp::Dataset : public DatasetBase {
     explicit Iterator(const Params& params)
         : DatasetIterator<Dataset>(params),
           cpu_budget_(dataset()->cpu_budget_ == 0 ? port::NumSchedulableCPUs()
-                                                  : dataset()->cpu_budget_),
-          ram_budget_(dataset()->ram_budget_ == 0
-                          ? kRamBudgetShare * port::AvailableRam()
-                          : dataset()->ram_budget_) {
+                                                  : dataset()->cpu_budget_) {
       model_ = std::make_shared<model::Model>();
     }
 
@@ -199,7 +207,8 @@ class ModelDatasetOp::Dataset : public DatasetBase {
 
     void ModelThread() {
       int64 last_optimization_ms = 0;
-      int64 optimization_period_ms = 10;
+      int64 optimization_period_ms = kOptimizationPeriodMinMs;
+      int64 last_ram_budget = kint64max;
       int64 current_time_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
       while (true) {
         {
@@ -221,23 +230,51 @@ class ModelDatasetOp::Dataset : public DatasetBase {
         }
 
         int64 optimization_start_us = EnvTime::NowMicros();
-        model_->Optimize(dataset()->algorithm_, cpu_budget_, ram_budget_,
+        const double buffered_bytes = model_->BufferedBytes();
+        const int64 ram_budget = RamBudget(buffered_bytes);
+        model_->Optimize(dataset()->algorithm_, cpu_budget_, ram_budget,
                          /*model_input_time=*/0);
         VLOG(2) << "Optimized for "
                 << (EnvTime::NowMicros() - optimization_start_us) << " us.";
 
-        // Exponentially increase the period of running the optimization
-        // until a threshold is reached.
-        if (optimization_period_ms != kOptimizationPeriodThresholdMs) {
+        if (buffered_bytes > ram_budget && ram_budget < last_ram_budget) {
+          // The budget shrank below what the buffers hold, so they need to
+          // shrink before the host runs out of memory. Check on them again
+          // soon.
+          VLOG(2) << "Buffered " << buffered_bytes
+                  << " bytes, exceeding the RAM budget of " << ram_budget
+                  << " bytes.";
+          optimization_period_ms = kOptimizationPeriodMinMs;
+        } else if (optimization_period_ms != kOptimizationPeriodThresholdMs) {
+          // Exponentially increase the period of running the optimization
+          // until a threshold is reached.
           optimization_period_ms = std::min(optimization_period_ms << 1,
                                             kOptimizationPeriodThresholdMs);
         }
+        last_ram_budget = ram_budget;
         current_time_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
         last_optimization_ms = current_time_ms;
         model_->FlushMetrics();
       }
     }
 
+    // Returns the RAM budget for the buffers of the input pipeline, given that
+    // they currently hold `buffered_bytes`. Unless the budget is fixed by the
+    // dataset, it is a share of the memory the pipeline could use: the memory
+    // it already buffers plus the free memory of the host. The budget thus
+    // shrinks when the host is under memory pressure, and grows back when
+    // memory is freed.
+    int64 RamBudget(double buffered_bytes) const {
+      if (dataset()->ram_budget_ != 0) {
+        return dataset()->ram_budget_;
+      }
+      const int64 available_ram = port::AvailableRam();
+      if (available_ram == kint64max) {
+        return kint64max;
+      }
+      return kRamBudgetShare * (available_ram + buffered_bytes);
+    }
+
     void RecordInput(int64 time_nanos) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (last_output_time_ != 0) {
         DCHECK_LE(last_output_time_, time_nanos);
@@ -268,7 +305,6 @@ class ModelDatasetOp::Dataset : public DatasetBase {
     int64 input_time_ TF_GUARDED_BY(mu_) = 0;
     int64 last_output_time_ TF_GUARDED_BY(mu_) = 0;
     const int64 cpu_budget_;
-    const int64 ram_budget_;
   };
 
   const DatasetBase* input_;
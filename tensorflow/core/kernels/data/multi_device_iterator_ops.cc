@@ -20,8 +20,10 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/function_handle_cache.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/kernels/data/dataset_utils.h"
 #include "tensorflow/core/kernels/data/iterator_ops.h"
 #include "tensorflow/core/kernels/data/unbounded_thread_pool.h"
@@ -40,6 +42,10 @@ const char kDevices[] = "devices";
 const char kOutputShapes[] = "output_shapes";
 const char kOutputTypes[] = "output_types";
 
+// Upper bound for the per device buffer size when `max_buffer_size` is
+// autotuned.
+constexpr int64 kMaxAutotuneBufferSize = 16;
+
 struct HostBufferElement {
   Status status;
   bool end_of_sequence;
@@ -49,6 +55,51 @@ struct HostBufferElement {
 using MultiDeviceIteratorCallback =
     std::function<void(const HostBufferElement&)>;
 
+// Returns true if any of `devices` is a GPU.
+bool HasGpuDevice(const std::vector<string>& devices) {
+  for (const string& device : devices) {
+    DeviceNameUtils::ParsedName parsed_name;
+    if (DeviceNameUtils::ParseFullName(device, &parsed_name) &&
+        parsed_name.type == DEVICE_GPU) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Copies the memcpy-able components of `element` to GPU-compatible (pinned)
+// host memory, unless they are there already. Copies from pinned memory to a
+// GPU are asynchronous DMAs that overlap with computation, whereas copies from
+// pageable memory are staged synchronously by the driver. The pinned memory is
+// pooled by the allocator, so the staging buffers are reused across elements.
+void StageInPinnedMemory(IteratorContext* ctx, std::vector<Tensor>* element) {
+  AllocatorAttributes attrs;
+  attrs.set_on_host(true);
+  attrs.set_gpu_compatible(true);
+  Allocator* allocator = ctx->allocator(attrs);
+  for (Tensor& component : *element) {
+    if (!DataTypeCanUseMemcpy(component.dtype()) ||
+        component.TotalBytes() == 0) {
+      continue;
+    }
+    TensorDescription description;
+    component.FillDescription(&description);
+    if (description.allocation_description().allocator_name() ==
+        allocator->Name()) {
+      continue;
+    }
+    Tensor staged(allocator, component.dtype(), component.shape());
+    if (!staged.IsInitialized()) {
+      // Copying from pageable memory is slower, but still works.
+      continue;
+    }
+    StringPiece src = component.tensor_data();
+    memcpy(const_cast<char*>(staged.tensor_data().data()), src.data(),
+           src.size());
+    component = std::move(staged);
+  }
+}
+
 class MultiDeviceIterator : public ResourceBase {
  public:
   MultiDeviceIterator(
@@ -63,6 +114,7 @@ class MultiDeviceIterator : public ResourceBase {
         output_types_(output_types),
         output_shapes_(output_shapes),
         devices_(devices),
+        stage_in_pinned_memory_(HasGpuDevice(devices)),
         flib_def_(std::move(flib_def)),
         flr_(flr),
         pflr_(std::move(pflr)),
@@ -149,6 +201,11 @@ class MultiDeviceIterator : public ResourceBase {
  private:
   // A private class that uses a background thread to keep a per device buffer
   // full.
+  //
+  // If `max_buffer_size` is `model::kAutotune`, each per device buffer starts
+  // with room for one element, and their size doubles (up to
+  // `kMaxAutotuneBufferSize`) whenever a device finds its buffer empty after
+  // the buffers had a chance to fill up.
   class MultiDeviceBuffer {
    public:
     MultiDeviceBuffer(size_t size, int64 max_buffer_size, int64 incarnation_id,
@@ -156,7 +213,8 @@ class MultiDeviceIterator : public ResourceBase {
                       MultiDeviceIterator* parent)
         : buffer_(size),
           size_(size),
-          max_buffer_size_(max_buffer_size),
+          autotune_(max_buffer_size == model::kAutotune),
+          max_buffer_size_(autotune_ ? 1 : max_buffer_size),
           incarnation_id_(incarnation_id),
           host_iterator_(std::move(host_iterator)),
           parent_(parent) {}
@@ -224,6 +282,7 @@ class MultiDeviceIterator : public ResourceBase {
             produced_output = true;
             elem.end_of_sequence = true;
           } else {
+            MaybeGrowBuffers();
             buffer_[shard_num].callbacks.push_back(std::move(callback));
             callback = nullptr;
           }
@@ -236,6 +295,21 @@ class MultiDeviceIterator : public ResourceBase {
     }
 
    private:
+    // Called when a device finds its buffer empty.
+    void MaybeGrowBuffers() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (!autotune_ || max_buffer_size_ >= kMaxAutotuneBufferSize ||
+          num_elements_fetched_ < size_ * max_buffer_size_) {
+        return;
+      }
+      max_buffer_size_ = std::min(2 * max_buffer_size_, kMaxAutotuneBufferSize);
+      VLOG(2) << "Increased MultiDeviceIterator buffer size to "
+              << max_buffer_size_;
+      // Wake up the background thread if it is blocked on a full buffer.
+      for (int i = 0; i < size_; ++i) {
+        buffer_[i].cond_var.notify_all();
+      }
+    }
+
     void EnsureBackgroundThreadStarted(IteratorContext* ctx)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (!background_thread_) {
@@ -313,10 +387,13 @@ class MultiDeviceIterator : public ResourceBase {
 
         if (elem.status.ok() && elem.end_of_sequence) {
           end_of_iterator = true;
+        } else if (elem.status.ok() && parent_->stage_in_pinned_memory_) {
+          StageInPinnedMemory(ctx.get(), &elem.value);
         }
 
         {
           mutex_lock l(mu_);
+          ++num_elements_fetched_;
           // Try to find a callback, else just push stuff into buffer.
           if (!buffer_[shard_to_fetch].callbacks.empty()) {
             callback = buffer_[shard_to_fetch].callbacks.front();
@@ -364,7 +441,11 @@ class MultiDeviceIterator : public ResourceBase {
     std::vector<HostBuffer> buffer_;
 
     const size_t size_;
-    const int64 max_buffer_size_;
+    const bool autotune_;
+    int64 max_buffer_size_ TF_GUARDED_BY(mu_);
+    // Number of elements the background thread has fetched from
+    // `host_iterator_`.
+    int64 num_elements_fetched_ TF_GUARDED_BY(mu_) = 0;
     const int64 incarnation_id_;
     const std::unique_ptr<IteratorBase> host_iterator_;
     MultiDeviceIterator* const parent_;  // Not owned.
@@ -375,6 +456,9 @@ class MultiDeviceIterator : public ResourceBase {
   const DataTypeVector output_types_;
   const std::vector<PartialTensorShape> output_shapes_;
   const std::vector<string> devices_;
+  // Whether to copy elements to pinned host memory before handing them to
+  // devices.
+  const bool stage_in_pinned_memory_;
   const std::unique_ptr<FunctionLibraryDefinition> flib_def_;
   FunctionLibraryRuntime* const flr_ = nullptr;  // not owned.
   const std::unique_ptr<ProcessFunctionLibraryRuntime> pflr_;
@@ -363,6 +363,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         EnsureThreadsStarted();
         while (!cancelled_ && !Consume(&result)) {
           RecordStop(ctx);
+          const int64 wait_start_nanos = EnvTime::NowNanos();
           if (deterministic_) {
             VLOG(3) << "Blocked waiting for element "
                     << current_elements_[cycle_index_]->id;
@@ -370,6 +371,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           } else {
             any_element_available_cond_var_.wait(l);
           }
+          RecordWaitTime(ctx, EnvTime::NowNanos() - wait_start_nanos);
           RecordStart(ctx);
         }
         if (cancelled_) {
@@ -863,6 +865,15 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
               element->active = false;
               break;
             }
+            // Move on to other elements waiting for a worker, and come back to
+            // this one later, so that a slow element does not hold a worker
+            // while faster ones run dry.
+            if (ShouldYield(element)) {
+              element->active = false;
+              elements_to_process_.push_back(element_index);
+              current_workers_cond_var_.notify_one();
+              break;
+            }
           }
         }
       }
@@ -962,7 +973,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         mutex_lock l(*mu_);
         element->results.push_back(std::move(result));
         NotifyElementUpdate(element);
-        if (element->results.size() == dataset()->buffer_output_elements_) {
+        if (element->results.size() == dataset()->buffer_output_elements_ ||
+            ShouldYield(element)) {
           break;
         }
       }
@@ -1052,6 +1064,26 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       }
     }
 
+    // Returns true if the current worker processing `element` should leave it
+    // for other elements of the cycle. Only done when results may be produced
+    // out of order, where a consumer takes whichever element has a result:
+    // once `element` has a buffered result and other elements wait for a
+    // worker, they are better served first.
+    bool ShouldYield(const std::shared_ptr<Element>& element)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (deterministic_ || element->cycle_index == -1 ||
+          element->results.empty()) {
+        return false;
+      }
+      for (int index : elements_to_process_) {
+        const std::shared_ptr<Element>& other = current_elements_[index];
+        if (other != element && NeedsProcessing(other) && !other->active) {
+          return true;
+        }
+      }
+      return false;
+    }
+
     bool NeedsProcessing(const std::shared_ptr<Element>& element)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (!element) {
@@ -239,7 +239,9 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
         EnsureThreadsStarted(ctx);
         while (ShouldWait(&result)) {
           RecordStop(ctx);
+          const int64 wait_start_nanos = EnvTime::NowNanos();
           cond_var_->wait(l);
+          RecordWaitTime(ctx, EnvTime::NowNanos() - wait_start_nanos);
           RecordStart(ctx);
         }
         if (cancelled_) {
@@ -247,7 +249,9 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
         }
       }
       RecordStop(ctx);
+      const int64 wait_start_nanos = EnvTime::NowNanos();
       result->notification.WaitForNotification();
+      RecordWaitTime(ctx, EnvTime::NowNanos() - wait_start_nanos);
       RecordStart(ctx);
       profiler::TraceMe traceme([&] {
         return profiler::TraceMeEncode("ParallelMapConsume",
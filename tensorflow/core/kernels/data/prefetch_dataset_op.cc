@@ -178,14 +178,18 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
             auto_tuner_.RecordEmpty();
             buffer_size_->value = auto_tuner_.buffer_limit();
             RecordStop(ctx);
+            const int64 wait_start_nanos = EnvTime::NowNanos();
             cond_var_->wait(l);
+            RecordWaitTime(ctx, EnvTime::NowNanos() - wait_start_nanos);
             RecordStart(ctx);
           }
         } else {
           while (!cancelled_ && buffer_.empty() && !prefetch_thread_finished_ &&
                  buffer_size_->value != 0) {
             RecordStop(ctx);
+            const int64 wait_start_nanos = EnvTime::NowNanos();
             cond_var_->wait(l);
+            RecordWaitTime(ctx, EnvTime::NowNanos() - wait_start_nanos);
             RecordStart(ctx);
           }
         }
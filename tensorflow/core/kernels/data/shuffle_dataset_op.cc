@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/shuffle_dataset_op.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <tuple>
 #include <vector>
@@ -25,12 +27,14 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/dataset_utils.h"
 #include "tensorflow/core/kernels/data/name_utils.h"
 #include "tensorflow/core/kernels/data/random_seed_ops.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/stringprintf.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace data {
@@ -46,6 +50,8 @@ namespace data {
 /* static */ constexpr const char* const ShuffleDatasetOpBase::kOutputShapes;
 /* static */ constexpr const char* const
     ShuffleDatasetOpBase::kReshuffleEachIteration;
+/* static */ constexpr const char* const
+    ShuffleDatasetOpBase::kFillParallelism;
 
 /* static */ constexpr const char* const ShuffleDatasetOp::kDatasetType;
 
@@ -55,6 +61,9 @@ namespace data {
 
 const int64 kLogIntervalMicros = 10 * 1000000;  // 10 seconds.
 const int64 kMaxEpochsInBuffer = 3;
+// The maximum number of elements each thread fetches per round of filling the
+// buffer in parallel. Rounds keep the progress logging responsive.
+const int64 kMaxParallelFillElementsPerThread = 256;
 
 constexpr char kNumRandomSamples[] = "num_random_samples";
 constexpr char kDataProduced[] = "data_produced";
@@ -83,15 +92,20 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
  public:
   ShuffleDatasetBase(OpKernelContext* ctx, const DatasetBase* input,
                      int64 buffer_size,
-                     std::shared_ptr<SeedGenerator> seed_generator, int64 count)
+                     std::shared_ptr<SeedGenerator> seed_generator, int64 count,
+                     int64 fill_parallelism = 0)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
         buffer_size_(buffer_size),
         seed_generator_(std::move(seed_generator)),
         count_(count),
+        fill_parallelism_(fill_parallelism),
         traceme_metadata_(
             {{"buffer_size",
-              strings::Printf("%lld", static_cast<long long>(buffer_size))}}) {
+              strings::Printf("%lld", static_cast<long long>(buffer_size))},
+             {"fill_parallelism",
+              strings::Printf("%lld",
+                              static_cast<long long>(fill_parallelism))}}) {
     input_->Ref();
   }
 
@@ -177,6 +191,16 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           LOG(INFO) << "Filling up shuffle buffer (this may take a while): "
                     << num_elements_ << " of " << this->dataset()->buffer_size_;
         }
+        if (this->dataset()->fill_parallelism_ > 1 &&
+            this->dataset()->buffer_size_ - num_elements_ > 1) {
+          bool filled = false;
+          TF_RETURN_IF_ERROR(FillBufferInParallel(ctx, &filled));
+          if (filled) {
+            continue;
+          }
+          // The input is exhausted; fall through to advance to the next
+          // epoch on this thread.
+        }
         std::vector<Tensor> input_element;
         bool end_of_input_sequence = false;
         while (this->dataset()->count_ == -1 ||
@@ -396,6 +420,81 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       int64 end;
     };
 
+    // Fetches up to `buffer_size_ - num_elements_` elements of the current
+    // epoch from `input_impl_` using `fill_parallelism_` concurrent `GetNext`
+    // calls, each thread collecting its elements into its own shard. The
+    // shards are then interleaved into the last slice of `buffer_`, from
+    // which elements are sampled uniformly regardless of their shard, so the
+    // checkpointed state is the same as for a sequential fill. Sets `*filled`
+    // to whether any element was added; if not, `input_impl_` is at the end
+    // of its sequence.
+    //
+    // The order in which concurrent calls receive elements is
+    // nondeterministic, so the shuffle order is too.
+    Status FillBufferInParallel(IteratorContext* ctx, bool* filled)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      const int64 num_threads = this->dataset()->fill_parallelism_;
+      if (!fill_thread_pool_) {
+        fill_thread_pool_ = ctx->CreateThreadPool(
+            "tf_data_shuffle_fill", static_cast<int>(num_threads));
+      }
+      std::atomic<int64> num_remaining(
+          std::min(this->dataset()->buffer_size_ - num_elements_,
+                   num_threads * kMaxParallelFillElementsPerThread));
+      std::atomic<bool> end_of_input_sequence(false);
+      std::vector<std::vector<std::vector<Tensor>>> shards(num_threads);
+      std::vector<Status> statuses(num_threads);
+      BlockingCounter counter(num_threads);
+      IteratorBase* const input_impl = input_impl_.get();
+      for (int64 i = 0; i < num_threads; ++i) {
+        fill_thread_pool_->Schedule([&, i]() {
+          RecordStart(ctx);
+          while (!end_of_input_sequence && num_remaining.fetch_sub(1) > 0) {
+            std::vector<Tensor> element;
+            bool end_of_sequence = false;
+            statuses[i] = input_impl->GetNext(ctx, &element, &end_of_sequence);
+            if (!statuses[i].ok() || end_of_sequence) {
+              end_of_input_sequence = true;
+              break;
+            }
+            shards[i].push_back(std::move(element));
+          }
+          RecordStop(ctx);
+          counter.DecrementCount();
+        });
+      }
+      RecordStop(ctx);
+      counter.Wait();
+      RecordStart(ctx);
+      for (const Status& status : statuses) {
+        TF_RETURN_IF_ERROR(status);
+      }
+
+      *filled = false;
+      for (size_t j = 0;; ++j) {
+        bool added = false;
+        for (auto& shard : shards) {
+          if (j >= shard.size()) {
+            continue;
+          }
+          this->RecordBufferEnqueue(ctx, shard[j]);
+          buffer_->at(slices_.back()->end % this->dataset()->buffer_size_) =
+              std::move(shard[j]);
+          num_elements_++;
+          slices_.back()->end++;
+          added = true;
+        }
+        if (!added) {
+          break;
+        }
+        *filled = true;
+      }
+      if (*filled) {
+        data_produced_ = true;
+      }
+      return Status::OK();
+    }
+
     random::SingleSampleAdapter<random::PhiloxRandom>::ResultType Random()
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       num_random_samples_++;
@@ -408,6 +507,8 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     std::unique_ptr<std::vector<std::vector<Tensor>>> buffer_
         TF_GUARDED_BY(mu_);
     std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_) = nullptr;
+    // Runs the concurrent `GetNext` calls of `FillBufferInParallel()`.
+    std::unique_ptr<thread::ThreadPool> fill_thread_pool_ TF_GUARDED_BY(mu_);
     int64 epoch_ TF_GUARDED_BY(mu_) = 0;
     int64 num_elements_ TF_GUARDED_BY(mu_) = 0;
     int64 seed_ TF_GUARDED_BY(mu_) = 0;
@@ -431,6 +532,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   // fuse shuffle and repeat together, and make the shuffle dataset op
   // responsible for repeating as well.
   const int64 count_;
+  // The number of threads concurrently fetching input elements to fill the
+  // buffer. Values of 0 and 1 fill the buffer on the calling thread.
+  const int64 fill_parallelism_;
   const TraceMeMetadata traceme_metadata_;
 };  // ShuffleDatasetBase
 
@@ -554,8 +658,10 @@ class ShuffleDatasetOp::DatasetV3 : public ShuffleDatasetBase {
  public:
   DatasetV3(OpKernelContext* ctx, const DatasetBase* input, int64 buffer_size,
             int64 count, RandomSeeds&& seeds, SeedGeneratorManager* manager,
-            ResourceHandle&& resource_handle, bool owns_resource)
-      : ShuffleDatasetBase(ctx, input, buffer_size, manager->get(), count),
+            ResourceHandle&& resource_handle, bool owns_resource,
+            int64 fill_parallelism)
+      : ShuffleDatasetBase(ctx, input, buffer_size, manager->get(), count,
+                           fill_parallelism),
         manager_(manager),
         owns_resource_(owns_resource),
         resource_handle_(std::move(resource_handle)),
@@ -594,13 +700,15 @@ class ShuffleDatasetOp::DatasetV3 : public ShuffleDatasetBase {
     AttrValue reshuffle_each_iteration;
     b->BuildAttrValue(seed_generator_->reshuffle_each_iteration(),
                       &reshuffle_each_iteration);
-    TF_RETURN_IF_ERROR(
-        b->AddDataset(this,
-                      {input_graph_node, buffer_size_node, seed_node,
-                       seed2_node, resource_handle_node},  // Inputs
-                      {std::make_pair(kReshuffleEachIteration,
-                                      reshuffle_each_iteration)},  // Attrs
-                      output));
+    AttrValue fill_parallelism;
+    b->BuildAttrValue(fill_parallelism_, &fill_parallelism);
+    TF_RETURN_IF_ERROR(b->AddDataset(
+        this,
+        {input_graph_node, buffer_size_node, seed_node, seed2_node,
+         resource_handle_node},  // Inputs
+        {std::make_pair(kReshuffleEachIteration, reshuffle_each_iteration),
+         std::make_pair(kFillParallelism, fill_parallelism)},  // Attrs
+        output));
     return Status::OK();
   }
 
@@ -626,6 +734,12 @@ ShuffleDatasetOp::ShuffleDatasetOp(OpKernelConstruction* ctx)
     OP_REQUIRES_OK(
         ctx, ctx->GetAttr(kReshuffleEachIteration, &reshuffle_each_iteration_));
   }
+  if (ctx->HasAttr(kFillParallelism)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kFillParallelism, &fill_parallelism_));
+    OP_REQUIRES(
+        ctx, fill_parallelism_ >= 0,
+        errors::InvalidArgument("fill_parallelism must be non-negative."));
+  }
 }
 
 void ShuffleDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
@@ -676,9 +790,9 @@ void ShuffleDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
     }
 
     // Ownership of manager is transferred onto `DatasetV3`.
-    *output = new ShuffleDatasetOp::DatasetV3(ctx, input, buffer_size, count,
-                                              std::move(seeds), manager,
-                                              std::move(handle), owns_resource);
+    *output = new ShuffleDatasetOp::DatasetV3(
+        ctx, input, buffer_size, count, std::move(seeds), manager,
+        std::move(handle), owns_resource, fill_parallelism_);
   } else if (op_version_ == 2) {
     auto handle = HandleFromInput(ctx, 2);
     SeedGeneratorManager* manager = nullptr;
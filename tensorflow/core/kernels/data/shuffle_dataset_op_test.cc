@@ -94,6 +94,48 @@ class ShuffleDatasetParams : public DatasetParams {
   bool reshuffle_each_iteration_;
 };
 
+// Parameters of a `ShuffleDatasetV3` node that fills its buffer with
+// `fill_parallelism` concurrent input fetches.
+class ParallelFillShuffleDatasetParams : public ShuffleDatasetParams {
+ public:
+  template <typename T>
+  ParallelFillShuffleDatasetParams(T input_dataset_params, int64 buffer_size,
+                                   int64 fill_parallelism)
+      : ShuffleDatasetParams(std::move(input_dataset_params), buffer_size,
+                             /*seed=*/1, /*seed2=*/2, /*count=*/1,
+                             /*reshuffle_each_iteration=*/false,
+                             /*output_dtypes=*/{DT_INT64},
+                             /*output_shapes=*/{PartialTensorShape({})},
+                             /*node_name=*/kShuffleNodeName),
+        fill_parallelism_(fill_parallelism) {
+    op_version_ = 3;
+  }
+
+  std::vector<Tensor> GetInputTensors() const override {
+    std::vector<Tensor> input_tensors = ShuffleDatasetParams::GetInputTensors();
+    // The dataset creates its own seed generator for an unknown handle.
+    input_tensors.push_back(
+        CreateTensor<ResourceHandle>(TensorShape({}), {ResourceHandle()}));
+    return input_tensors;
+  }
+
+  Status GetInputNames(std::vector<string>* input_names) const override {
+    TF_RETURN_IF_ERROR(ShuffleDatasetParams::GetInputNames(input_names));
+    input_names->emplace_back("seed_generator");
+    return Status::OK();
+  }
+
+  Status GetAttributes(AttributeVector* attr_vector) const override {
+    TF_RETURN_IF_ERROR(ShuffleDatasetParams::GetAttributes(attr_vector));
+    attr_vector->emplace_back(ShuffleDatasetOpBase::kFillParallelism,
+                              fill_parallelism_);
+    return Status::OK();
+  }
+
+ private:
+  int64 fill_parallelism_;
+};
+
 class ShuffleDatasetOpTest : public DatasetOpsTestBase {};
 
 // Test case 1: test shuffle_dataset with reshuffle_each_iteration = false.
@@ -549,6 +591,86 @@ INSTANTIATE_TEST_CASE_P(ShuffleDatasetOpTest,
                         ParameterizedIteratorSaveAndRestoreTest,
                         ::testing::ValuesIn(IteratorSaveAndRestoreTestCases()));
 
+TEST_F(ShuffleDatasetOpTest, ParallelFill) {
+  constexpr int64 kNumElements = 1000;
+  constexpr int64 kBufferSize = 300;
+  auto dataset_params = ParallelFillShuffleDatasetParams(
+      RangeDatasetParams(0, kNumElements, 1), kBufferSize,
+      /*fill_parallelism=*/4);
+  TF_ASSERT_OK(Initialize(dataset_params));
+
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  while (!end_of_sequence) {
+    std::vector<Tensor> next;
+    TF_ASSERT_OK(
+        iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+    if (!end_of_sequence) {
+      // Each output is sampled from at most `buffer_size` elements.
+      EXPECT_LT(next[0].scalar<int64>()(),
+                kBufferSize + static_cast<int64>(out_tensors.size()));
+      out_tensors.push_back(next[0]);
+    }
+  }
+
+  std::vector<Tensor> expected_outputs;
+  for (int64 i = 0; i < kNumElements; ++i) {
+    expected_outputs.push_back(CreateTensor<int64>(TensorShape({}), {i}));
+  }
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                           /*compare_order=*/false));
+}
+
+TEST_F(ShuffleDatasetOpTest, ParallelFillSaveAndRestore) {
+  constexpr int64 kNumElements = 100;
+  auto dataset_params = ParallelFillShuffleDatasetParams(
+      RangeDatasetParams(0, kNumElements, 1), /*buffer_size=*/40,
+      /*fill_parallelism=*/3);
+  TF_ASSERT_OK(Initialize(dataset_params));
+
+  std::unique_ptr<SerializationContext> serialization_ctx;
+  TF_ASSERT_OK(CreateSerializationContext(&serialization_ctx));
+
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  int64 cur_iteration = 0;
+  const std::vector<int64> breakpoints = {0, 10, 50, kNumElements};
+  for (int64 breakpoint : breakpoints) {
+    VariantTensorDataWriter writer;
+    TF_EXPECT_OK(iterator_->Save(serialization_ctx.get(), &writer));
+    std::vector<const VariantTensorData*> data;
+    writer.GetData(&data);
+    VariantTensorDataReader reader(data);
+    TF_EXPECT_OK(RestoreIterator(iterator_ctx_.get(), &reader,
+                                 dataset_params.iterator_prefix(), *dataset_,
+                                 &iterator_));
+
+    while (cur_iteration <= breakpoint && !end_of_sequence) {
+      std::vector<Tensor> next;
+      TF_EXPECT_OK(
+          iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+      out_tensors.insert(out_tensors.end(), next.begin(), next.end());
+      cur_iteration++;
+    }
+  }
+
+  // Every element is produced exactly once across the restored iterators.
+  std::vector<Tensor> expected_outputs;
+  for (int64 i = 0; i < kNumElements; ++i) {
+    expected_outputs.push_back(CreateTensor<int64>(TensorShape({}), {i}));
+  }
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                           /*compare_order=*/false));
+}
+
+TEST_F(ShuffleDatasetOpTest, InvalidFillParallelism) {
+  auto dataset_params = ParallelFillShuffleDatasetParams(
+      RangeDatasetParams(0, 10, 1), /*buffer_size=*/3,
+      /*fill_parallelism=*/-1);
+  EXPECT_EQ(Initialize(dataset_params).code(),
+            tensorflow::error::INVALID_ARGUMENT);
+}
+
 TEST_F(ShuffleDatasetOpTest, InvalidArguments) {
   std::vector<ShuffleDatasetParams> dataset_params_vec(
       {ShuffleDatasetParamsWithInvalidBufferSize(),
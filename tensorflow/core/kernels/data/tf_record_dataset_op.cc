@@ -18,9 +18,11 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/data/name_utils.h"
+#include "tensorflow/core/kernels/data/split_utils.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
+#include "tensorflow/core/lib/io/record_index.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
@@ -35,13 +37,18 @@ namespace data {
 /* static */ constexpr const char* const TFRecordDatasetOp::kFileNames;
 /* static */ constexpr const char* const TFRecordDatasetOp::kCompressionType;
 /* static */ constexpr const char* const TFRecordDatasetOp::kBufferSize;
+/* static */ constexpr const char* const TFRecordDatasetOp::kUseMemoryMapping;
+/* static */ constexpr const char* const TFRecordDatasetOp::kVerifyChecksums;
 
 constexpr char kCurrentFileIndex[] = "current_file_index";
 constexpr char kOffset[] = "offset";
+constexpr char kCurrentSplit[] = "current_split";
 constexpr char kGcsFsPrefix[] = "gs://";
 constexpr char kS3FsPrefix[] = "s3://";
 constexpr int64 kCloudTpuBlockSize = 127LL << 20;  // 127MB.
 constexpr int64 kS3BlockSize = kCloudTpuBlockSize;
+// Indexed files are split into byte ranges of about this size.
+constexpr uint64 kTargetSplitBytes = 8 << 20;  // 8MB.
 
 bool is_cloud_tpu_gcs_fs() {
 #if defined(PLATFORM_CLOUD_TPU) && defined(TPU_GCS_FS)
@@ -53,12 +60,15 @@ bool is_cloud_tpu_gcs_fs() {
 class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<string> filenames,
-                   const string& compression_type, int64 buffer_size)
+                   const string& compression_type, int64 buffer_size,
+                   bool use_memory_mapping, bool verify_checksums)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         options_(io::RecordReaderOptions::CreateRecordReaderOptions(
-            compression_type)) {
+            compression_type)),
+        use_memory_mapping_(use_memory_mapping),
+        verify_checksums_(verify_checksums) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
@@ -91,6 +101,16 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
   Status CheckExternalState() const override { return Status::OK(); }
 
+  // Splits the files into byte ranges at record boundaries, which requires a
+  // record index for every file (see record_index.h).
+  Status MakeSplitProvider(
+      std::unique_ptr<SplitProvider>* split_provider) const override {
+    std::vector<Split> splits;
+    TF_RETURN_IF_ERROR(ComputeSplits(Env::Default(), &splits));
+    *split_provider = absl::make_unique<IndexSplitProvider>(splits.size());
+    return Status::OK();
+  }
+
  protected:
   Status AsGraphDefInternal(SerializationContext* ctx,
                             DatasetGraphDefBuilder* b,
@@ -101,29 +121,82 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     TF_RETURN_IF_ERROR(b->AddScalar(compression_type_, &compression_type));
     Node* buffer_size = nullptr;
     TF_RETURN_IF_ERROR(b->AddScalar(options_.buffer_size, &buffer_size));
-    TF_RETURN_IF_ERROR(b->AddDataset(
-        this, {filenames, compression_type, buffer_size}, output));
+    AttrValue use_memory_mapping;
+    b->BuildAttrValue(use_memory_mapping_, &use_memory_mapping);
+    AttrValue verify_checksums;
+    b->BuildAttrValue(verify_checksums_, &verify_checksums);
+    TF_RETURN_IF_ERROR(
+        b->AddDataset(this, {filenames, compression_type, buffer_size},
+                      {{kUseMemoryMapping, use_memory_mapping},
+                       {kVerifyChecksums, verify_checksums}},
+                      output));
     return Status::OK();
   }
 
  private:
+  // The records of file `file_index` in the byte range [begin, end).
+  struct Split {
+    size_t file_index;
+    uint64 begin;
+    uint64 end;
+  };
+
+  Status ComputeSplits(Env* env, std::vector<Split>* splits) const {
+    if (!compression_type_.empty()) {
+      return errors::Unimplemented(
+          "Splitting TFRecord files requires uncompressed files, but got "
+          "compression_type: ",
+          compression_type_);
+    }
+    splits->clear();
+    for (size_t i = 0; i < filenames_.size(); ++i) {
+      std::vector<uint64> offsets;
+      Status s = io::ReadRecordIndex(env, filenames_[i], &offsets);
+      if (errors::IsNotFound(s)) {
+        return errors::FailedPrecondition(
+            "Splitting TFRecord files requires a record index, but ",
+            io::RecordIndexFilename(filenames_[i]), " does not exist");
+      }
+      TF_RETURN_IF_ERROR(s);
+      if (offsets.empty()) continue;
+      uint64 begin = offsets[0];
+      for (uint64 offset : offsets) {
+        if (offset - begin >= kTargetSplitBytes) {
+          splits->push_back({i, begin, offset});
+          begin = offset;
+        }
+      }
+      splits->push_back({i, begin, kuint64max});
+    }
+    return Status::OK();
+  }
+
   class Iterator : public DatasetIterator<Dataset> {
    public:
     explicit Iterator(const Params& params)
         : DatasetIterator<Dataset>(params) {}
 
+    Status Initialize(IteratorContext* ctx) override {
+      split_provider_ = ctx->split_provider();
+      return Status::OK();
+    }
+
     Status GetNextInternal(IteratorContext* ctx,
                            std::vector<Tensor>* out_tensors,
                            bool* end_of_sequence) override {
       out_tensors->reserve(1);
       mutex_lock l(mu_);
+      if (split_provider_) {
+        return GetNextFromSplitsLocked(ctx, out_tensors, end_of_sequence);
+      }
       do {
         // We are currently processing a file, so try to read the next record.
-        if (reader_) {
+        if (reader_ || mmap_reader_) {
           out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
                                     TensorShape({}));
-          Status s =
-              reader_->ReadRecord(&out_tensors->back().scalar<tstring>()());
+          tstring* record = &out_tensors->back().scalar<tstring>()();
+          Status s = reader_ ? reader_->ReadRecord(record)
+                             : mmap_reader_->ReadRecord(record);
           if (s.ok()) {
             static monitoring::CounterCell* bytes_counter =
                 metrics::GetTFDataBytesReadCounter(kDatasetType);
@@ -167,12 +240,27 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     Status SaveInternal(SerializationContext* ctx,
                         IteratorStateWriter* writer) override {
       mutex_lock l(mu_);
+      if (split_provider_) {
+        TF_RETURN_IF_ERROR(split_provider_->Save(
+            [this](const std::string& key) { return full_name(key); },
+            writer));
+        if (split_reader_) {
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(full_name(kCurrentSplit), current_split_));
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(full_name(kOffset), split_offset_));
+        }
+        return Status::OK();
+      }
       TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kCurrentFileIndex),
                                              current_file_index_));
 
       if (reader_) {
         TF_RETURN_IF_ERROR(
             writer->WriteScalar(full_name(kOffset), reader_->TellOffset()));
+      } else if (mmap_reader_) {
+        TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kOffset),
+                                               mmap_reader_->TellOffset()));
       }
       return Status::OK();
     }
@@ -181,6 +269,20 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
                            IteratorStateReader* reader) override {
       mutex_lock l(mu_);
       ResetStreamsLocked();
+      if (split_provider_) {
+        TF_RETURN_IF_ERROR(split_provider_->Restore(
+            [this](const std::string& key) { return full_name(key); },
+            reader));
+        if (reader->Contains(full_name(kCurrentSplit))) {
+          int64 offset;
+          TF_RETURN_IF_ERROR(
+              reader->ReadScalar(full_name(kCurrentSplit), &current_split_));
+          TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kOffset), &offset));
+          TF_RETURN_IF_ERROR(OpenSplitLocked(ctx->env(), current_split_));
+          split_offset_ = offset;
+        }
+        return Status::OK();
+      }
       int64 current_file_index;
       TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kCurrentFileIndex),
                                             &current_file_index));
@@ -189,12 +291,78 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
         int64 offset;
         TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kOffset), &offset));
         TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
-        TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+        if (reader_) {
+          TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+        } else {
+          TF_RETURN_IF_ERROR(mmap_reader_->SeekOffset(offset));
+        }
       }
       return Status::OK();
     }
 
    private:
+    // Reads the records of the splits from `split_provider_`.
+    Status GetNextFromSplitsLocked(IteratorContext* ctx,
+                                   std::vector<Tensor>* out_tensors,
+                                   bool* end_of_sequence)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      do {
+        if (split_reader_) {
+          if (split_offset_ < splits_[current_split_].end) {
+            out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
+                                      TensorShape({}));
+            tstring* record = &out_tensors->back().scalar<tstring>()();
+            Status s = split_reader_->ReadRecord(&split_offset_, record);
+            if (s.ok()) {
+              static monitoring::CounterCell* bytes_counter =
+                  metrics::GetTFDataBytesReadCounter(kDatasetType);
+              bytes_counter->IncrementBy(record->size());
+              *end_of_sequence = false;
+              return Status::OK();
+            }
+            out_tensors->pop_back();
+            if (!errors::IsOutOfRange(s)) {
+              // Moves on to the next split, like for files above.
+              ResetStreamsLocked();
+              return s;
+            }
+          }
+          ResetStreamsLocked();
+        }
+
+        Tensor split;
+        TF_RETURN_IF_ERROR(split_provider_->GetNext(&split, end_of_sequence));
+        if (*end_of_sequence) {
+          return Status::OK();
+        }
+        TF_RETURN_IF_ERROR(
+            OpenSplitLocked(ctx->env(), split.scalar<int64>()()));
+      } while (true);
+    }
+
+    // Opens split `index` for reading from its beginning.
+    Status OpenSplitLocked(Env* env, int64 index)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (!splits_computed_) {
+        TF_RETURN_IF_ERROR(dataset()->ComputeSplits(env, &splits_));
+        splits_computed_ = true;
+      }
+      if (index < 0 || static_cast<size_t>(index) >= splits_.size()) {
+        return errors::FailedPrecondition(
+            "Split ", index, " is out of range [0, ", splits_.size(),
+            "). The TFRecord files may have changed since the splits were "
+            "made.");
+      }
+      const Split& split = splits_[index];
+      TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
+          dataset()->filenames_[split.file_index], &file_));
+      split_reader_ =
+          absl::make_unique<io::RecordReader>(file_.get(), dataset()->options_);
+      current_split_ = index;
+      split_offset_ = split.begin;
+      return Status::OK();
+    }
+
     // Sets up reader streams to read from the file at `current_file_index_`.
     Status SetupStreamsLocked(Env* env) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (current_file_index_ >= dataset()->filenames_.size()) {
@@ -205,6 +373,13 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
       // Actually move on to next file.
       const string& next_filename = dataset()->filenames_[current_file_index_];
+      if (dataset()->use_memory_mapping_) {
+        TF_RETURN_IF_ERROR(
+            env->NewReadOnlyMemoryRegionFromFile(next_filename, &region_));
+        mmap_reader_ = absl::make_unique<io::MemoryMappedRecordReader>(
+            region_.get(), dataset()->verify_checksums_);
+        return Status::OK();
+      }
       TF_RETURN_IF_ERROR(env->NewRandomAccessFile(next_filename, &file_));
       reader_ = absl::make_unique<io::SequentialRecordReader>(
           file_.get(), dataset()->options_);
@@ -213,8 +388,11 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
     // Resets all reader streams.
     void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      split_reader_.reset();
       reader_.reset();
       file_.reset();
+      mmap_reader_.reset();
+      region_.reset();
     }
 
     mutex mu_;
@@ -224,15 +402,35 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     // we must destroy `reader_` before `file_`.
     std::unique_ptr<RandomAccessFile> file_ TF_GUARDED_BY(mu_);
     std::unique_ptr<io::SequentialRecordReader> reader_ TF_GUARDED_BY(mu_);
+
+    // Used instead of `file_` and `reader_` if `use_memory_mapping_` is true.
+    // `mmap_reader_` borrows the object that `region_` points to.
+    std::unique_ptr<ReadOnlyMemoryRegion> region_ TF_GUARDED_BY(mu_);
+    std::unique_ptr<io::MemoryMappedRecordReader> mmap_reader_
+        TF_GUARDED_BY(mu_);
+
+    // Used instead of `reader_` when reading splits. `split_reader_` borrows
+    // `file_`.
+    std::shared_ptr<SplitProvider> split_provider_;
+    bool splits_computed_ TF_GUARDED_BY(mu_) = false;
+    std::vector<Split> splits_ TF_GUARDED_BY(mu_);
+    int64 current_split_ TF_GUARDED_BY(mu_) = 0;
+    uint64 split_offset_ TF_GUARDED_BY(mu_) = 0;
+    std::unique_ptr<io::RecordReader> split_reader_ TF_GUARDED_BY(mu_);
   };
 
   const std::vector<string> filenames_;
   const tstring compression_type_;
   io::RecordReaderOptions options_;
+  const bool use_memory_mapping_;
+  const bool verify_checksums_;
 };
 
 TFRecordDatasetOp::TFRecordDatasetOp(OpKernelConstruction* ctx)
-    : DatasetOpKernel(ctx) {}
+    : DatasetOpKernel(ctx) {
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kUseMemoryMapping, &use_memory_mapping_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kVerifyChecksums, &verify_checksums_));
+}
 
 void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
                                     DatasetBase** output) {
@@ -256,6 +454,11 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
   tstring compression_type;
   OP_REQUIRES_OK(ctx, ParseScalarArgument<tstring>(ctx, kCompressionType,
                                                    &compression_type));
+  OP_REQUIRES(ctx, !use_memory_mapping_ || compression_type.empty(),
+              errors::InvalidArgument(
+                  "`use_memory_mapping` requires uncompressed TFRecord files, "
+                  "but got compression_type: ",
+                  compression_type));
 
   int64 buffer_size = -1;
   OP_REQUIRES_OK(ctx,
@@ -279,8 +482,8 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
     buffer_size = kS3BlockSize;
   }
 
-  *output =
-      new Dataset(ctx, std::move(filenames), compression_type, buffer_size);
+  *output = new Dataset(ctx, std::move(filenames), compression_type,
+                        buffer_size, use_memory_mapping_, verify_checksums_);
 }
 
 namespace {
@@ -49,6 +49,28 @@ void FIFOQueue::DequeueLocked(OpKernelContext* ctx, Tuple* tuple) {
 
 void FIFOQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
                            DoneCallback callback) {
+  // Fast path: when no earlier enqueue is waiting and there is room, the
+  // element is added in a single short critical section, without registering
+  // for cancellation or queueing an attempt.
+  bool enqueued = false;
+  bool wake_dequeuers = false;
+  {
+    mutex_lock l(mu_);
+    if (!closed_ && enqueue_attempts_.empty() &&
+        queues_[0].size() < static_cast<size_t>(capacity_)) {
+      for (int i = 0; i < num_components(); ++i) {
+        queues_[i].push_back(PersistentTensor(tuple[i]));
+      }
+      enqueued = true;
+      wake_dequeuers = !dequeue_attempts_.empty();
+    }
+  }
+  if (enqueued) {
+    if (wake_dequeuers) FlushUnlocked();
+    callback();
+    return;
+  }
+
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -153,6 +175,26 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
 }
 
 void FIFOQueue::TryDequeue(OpKernelContext* ctx, CallbackWithTuple callback) {
+  // Fast path: when no earlier dequeue is waiting and an element is available,
+  // it is removed in a single short critical section. Elements remaining in a
+  // closed queue are still dequeued.
+  Tuple tuple;
+  bool dequeued = false;
+  bool wake_enqueuers = false;
+  {
+    mutex_lock l(mu_);
+    if (dequeue_attempts_.empty() && !queues_[0].empty()) {
+      DequeueLocked(ctx, &tuple);
+      dequeued = true;
+      wake_enqueuers = !enqueue_attempts_.empty();
+    }
+  }
+  if (dequeued) {
+    if (wake_enqueuers) FlushUnlocked();
+    callback(tuple);
+    return;
+  }
+
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
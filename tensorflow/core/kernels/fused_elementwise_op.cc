@@ -0,0 +1,371 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Implements the _FusedElementwise op, which applies a chain of element-wise
+// ops in a single pass over memory. Grappler's remapper creates it from chains
+// of cwise ops whose intermediate results have no other consumers.
+
+#define EIGEN_USE_THREADS
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_join.h"
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+
+namespace tensorflow {
+namespace {
+
+// Number of elements to which all fused ops are applied before moving on to
+// the next elements, so that intermediate results stay in the L1 cache.
+constexpr int64 kBlockSize = 1024;
+
+enum class FusedOpKind {
+  // Unary ops.
+  kAbs,
+  kElu,
+  kExp,
+  kLog,
+  kNeg,
+  kRelu,
+  kRelu6,
+  kRsqrt,
+  kSigmoid,
+  kSqrt,
+  kSquare,
+  kTanh,
+  // Binary ops.
+  kAdd,
+  kDiv,
+  kMaximum,
+  kMinimum,
+  kMul,
+  kSquaredDifference,
+  kSub,
+};
+
+struct FusedOp {
+  FusedOpKind kind;
+  // Index of the other operand in `args` for binary ops, -1 otherwise.
+  int arg = -1;
+  // Whether the other operand is the first operand of a binary op.
+  bool arg_is_lhs = false;
+};
+
+using FusedOpKinds = absl::flat_hash_map<string, FusedOpKind>;
+
+bool ParseUnaryOp(const string& name, FusedOpKind* kind) {
+  static const auto* const kUnaryOps = new FusedOpKinds({
+      {"Abs", FusedOpKind::kAbs},
+      {"Elu", FusedOpKind::kElu},
+      {"Exp", FusedOpKind::kExp},
+      {"Log", FusedOpKind::kLog},
+      {"Neg", FusedOpKind::kNeg},
+      {"Relu", FusedOpKind::kRelu},
+      {"Relu6", FusedOpKind::kRelu6},
+      {"Rsqrt", FusedOpKind::kRsqrt},
+      {"Sigmoid", FusedOpKind::kSigmoid},
+      {"Sqrt", FusedOpKind::kSqrt},
+      {"Square", FusedOpKind::kSquare},
+      {"Tanh", FusedOpKind::kTanh},
+  });
+  auto it = kUnaryOps->find(name);
+  if (it == kUnaryOps->end()) return false;
+  *kind = it->second;
+  return true;
+}
+
+bool ParseBinaryOp(const string& name, FusedOpKind* kind) {
+  static const auto* const kBinaryOps = new FusedOpKinds({
+      {"Add", FusedOpKind::kAdd},
+      {"AddV2", FusedOpKind::kAdd},
+      {"Div", FusedOpKind::kDiv},
+      {"Maximum", FusedOpKind::kMaximum},
+      {"Minimum", FusedOpKind::kMinimum},
+      {"Mul", FusedOpKind::kMul},
+      {"RealDiv", FusedOpKind::kDiv},
+      {"SquaredDifference", FusedOpKind::kSquaredDifference},
+      {"Sub", FusedOpKind::kSub},
+  });
+  auto it = kBinaryOps->find(name);
+  if (it == kBinaryOps->end()) return false;
+  *kind = it->second;
+  return true;
+}
+
+// Returns the estimated cost of applying `kind` to one element, in cycles.
+template <typename T>
+int64 OpCost(FusedOpKind kind) {
+  using Eigen::internal::functor_traits;
+  switch (kind) {
+    case FusedOpKind::kAbs:
+      return functor_traits<Eigen::internal::scalar_abs_op<T>>::Cost;
+    case FusedOpKind::kElu:
+      return functor_traits<Eigen::internal::scalar_exp_op<T>>::Cost +
+             2 * Eigen::NumTraits<T>::AddCost;
+    case FusedOpKind::kExp:
+      return functor_traits<Eigen::internal::scalar_exp_op<T>>::Cost;
+    case FusedOpKind::kLog:
+      return functor_traits<Eigen::internal::scalar_log_op<T>>::Cost;
+    case FusedOpKind::kNeg:
+      return functor_traits<Eigen::internal::scalar_opposite_op<T>>::Cost;
+    case FusedOpKind::kRelu:
+      return functor_traits<Eigen::internal::scalar_max_op<T>>::Cost;
+    case FusedOpKind::kRelu6:
+      return functor_traits<Eigen::internal::scalar_max_op<T>>::Cost +
+             functor_traits<Eigen::internal::scalar_min_op<T>>::Cost;
+    case FusedOpKind::kRsqrt:
+      return functor_traits<Eigen::internal::scalar_rsqrt_op<T>>::Cost;
+    case FusedOpKind::kSigmoid:
+      return functor_traits<Eigen::internal::scalar_logistic_op<T>>::Cost;
+    case FusedOpKind::kSqrt:
+      return functor_traits<Eigen::internal::scalar_sqrt_op<T>>::Cost;
+    case FusedOpKind::kSquare:
+      return functor_traits<Eigen::internal::scalar_square_op<T>>::Cost;
+    case FusedOpKind::kTanh:
+      return functor_traits<Eigen::internal::scalar_tanh_op<T>>::Cost;
+    case FusedOpKind::kAdd:
+      return functor_traits<Eigen::internal::scalar_sum_op<T>>::Cost;
+    case FusedOpKind::kDiv:
+      return functor_traits<Eigen::internal::scalar_quotient_op<T>>::Cost;
+    case FusedOpKind::kMaximum:
+      return functor_traits<Eigen::internal::scalar_max_op<T>>::Cost;
+    case FusedOpKind::kMinimum:
+      return functor_traits<Eigen::internal::scalar_min_op<T>>::Cost;
+    case FusedOpKind::kMul:
+      return functor_traits<Eigen::internal::scalar_product_op<T>>::Cost;
+    case FusedOpKind::kSquaredDifference:
+      return functor_traits<Eigen::internal::scalar_difference_op<T>>::Cost +
+             functor_traits<Eigen::internal::scalar_square_op<T>>::Cost;
+    case FusedOpKind::kSub:
+      return functor_traits<Eigen::internal::scalar_difference_op<T>>::Cost;
+  }
+  return 1;
+}
+
+// Applies the unary op `kind` to `block` in place.
+template <typename T>
+void ApplyUnaryOp(FusedOpKind kind, typename TTypes<T>::UnalignedFlat block) {
+  switch (kind) {
+    case FusedOpKind::kAbs:
+      block = block.abs();
+      break;
+    case FusedOpKind::kElu:
+      block = (block < static_cast<T>(0))
+                  .select(block.exp() - block.constant(static_cast<T>(1)),
+                          block);
+      break;
+    case FusedOpKind::kExp:
+      block = block.exp();
+      break;
+    case FusedOpKind::kLog:
+      block = block.log();
+      break;
+    case FusedOpKind::kNeg:
+      block = -block;
+      break;
+    case FusedOpKind::kRelu:
+      block = block.cwiseMax(static_cast<T>(0));
+      break;
+    case FusedOpKind::kRelu6:
+      block = block.cwiseMax(static_cast<T>(0)).cwiseMin(static_cast<T>(6));
+      break;
+    case FusedOpKind::kRsqrt:
+      block = block.rsqrt();
+      break;
+    case FusedOpKind::kSigmoid:
+      block = block.sigmoid();
+      break;
+    case FusedOpKind::kSqrt:
+      block = block.sqrt();
+      break;
+    case FusedOpKind::kSquare:
+      block = block.square();
+      break;
+    case FusedOpKind::kTanh:
+      block = block.tanh();
+      break;
+    default:
+      LOG(FATAL) << "Not a unary op: " << static_cast<int>(kind);
+  }
+}
+
+// Assigns the binary op `kind` applied to `lhs` and `rhs` to `out`. The
+// operands may alias `out`.
+template <typename T, typename Lhs, typename Rhs>
+void AssignBinaryOp(FusedOpKind kind, const Lhs& lhs, const Rhs& rhs,
+                    typename TTypes<T>::UnalignedFlat out) {
+  switch (kind) {
+    case FusedOpKind::kAdd:
+      out = lhs + rhs;
+      break;
+    case FusedOpKind::kDiv:
+      out = lhs / rhs;
+      break;
+    case FusedOpKind::kMaximum:
+      out = lhs.cwiseMax(rhs);
+      break;
+    case FusedOpKind::kMinimum:
+      out = lhs.cwiseMin(rhs);
+      break;
+    case FusedOpKind::kMul:
+      out = lhs * rhs;
+      break;
+    case FusedOpKind::kSquaredDifference:
+      out = (lhs - rhs).square();
+      break;
+    case FusedOpKind::kSub:
+      out = lhs - rhs;
+      break;
+    default:
+      LOG(FATAL) << "Not a binary op: " << static_cast<int>(kind);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+class FusedElementwiseOp : public OpKernel {
+ public:
+  explicit FusedElementwiseOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    int num_args;
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args));
+    std::vector<bool> arg_is_lhs;
+    OP_REQUIRES_OK(context, context->GetAttr("arg_is_lhs", &arg_is_lhs));
+    OP_REQUIRES(context, !fused_ops.empty(),
+                errors::InvalidArgument("Fused ops must not be empty."));
+    OP_REQUIRES(
+        context, arg_is_lhs.empty() || arg_is_lhs.size() == num_args,
+        errors::InvalidArgument("Expected ", num_args,
+                                " values for arg_is_lhs, got ",
+                                arg_is_lhs.size(), "."));
+
+    int next_arg = 0;
+    cost_per_element_ = 2 * sizeof(T);  // Reading the input and the output.
+    for (const string& name : fused_ops) {
+      FusedOp op;
+      if (ParseBinaryOp(name, &op.kind)) {
+        OP_REQUIRES(context, next_arg < num_args,
+                    errors::InvalidArgument("Expected more than ", num_args,
+                                            " args for fused ops [",
+                                            absl::StrJoin(fused_ops, ","),
+                                            "]."));
+        op.arg = next_arg++;
+        op.arg_is_lhs = !arg_is_lhs.empty() && arg_is_lhs[op.arg];
+        cost_per_element_ += sizeof(T);  // Reading the other operand.
+      } else {
+        OP_REQUIRES(context, ParseUnaryOp(name, &op.kind),
+                    errors::Unimplemented("Unsupported fused op: ", name));
+      }
+      cost_per_element_ += OpCost<T>(op.kind);
+      ops_.push_back(op);
+    }
+    OP_REQUIRES(context, next_arg == num_args,
+                errors::InvalidArgument("Expected ", next_arg,
+                                        " args for fused ops [",
+                                        absl::StrJoin(fused_ops, ","),
+                                        "], got ", num_args, "."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& x = context->input(0);
+    OpInputList args;
+    OP_REQUIRES_OK(context, context->input_list("args", &args));
+    for (int i = 0; i < args.size(); ++i) {
+      OP_REQUIRES(context,
+                  args[i].shape() == x.shape() ||
+                      TensorShapeUtils::IsScalar(args[i].shape()),
+                  errors::InvalidArgument(
+                      "Expected args to have the shape of x ",
+                      x.shape().DebugString(), " or to be scalars, got ",
+                      args[i].shape().DebugString(), " for arg ", i, "."));
+    }
+
+    Tensor* y = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                {0}, 0, x.shape(), &y));
+    const int64 num_elements = x.NumElements();
+    if (num_elements == 0) return;
+
+    const T* x_data = x.flat<T>().data();
+    T* y_data = y->flat<T>().data();
+    std::vector<const T*> arg_data;
+    std::vector<bool> arg_is_scalar;
+    for (int i = 0; i < args.size(); ++i) {
+      arg_data.push_back(args[i].flat<T>().data());
+      arg_is_scalar.push_back(args[i].NumElements() == 1 &&
+                              num_elements != 1);
+    }
+
+    auto compute_blocks = [&](int64 start_block, int64 end_block) {
+      for (int64 block_index = start_block; block_index < end_block;
+           ++block_index) {
+        const int64 offset = block_index * kBlockSize;
+        const int64 size = std::min(kBlockSize, num_elements - offset);
+        typename TTypes<T>::UnalignedFlat block(y_data + offset, size);
+        if (x_data != y_data) {
+          block = typename TTypes<T>::UnalignedConstFlat(x_data + offset, size);
+        }
+        for (const FusedOp& op : ops_) {
+          if (op.arg < 0) {
+            ApplyUnaryOp<T>(op.kind, block);
+          } else if (arg_is_scalar[op.arg]) {
+            const auto arg = block.constant(*arg_data[op.arg]);
+            if (op.arg_is_lhs) {
+              AssignBinaryOp<T>(op.kind, arg, block, block);
+            } else {
+              AssignBinaryOp<T>(op.kind, block, arg, block);
+            }
+          } else {
+            typename TTypes<T>::UnalignedConstFlat arg(
+                arg_data[op.arg] + offset, size);
+            if (op.arg_is_lhs) {
+              AssignBinaryOp<T>(op.kind, arg, block, block);
+            } else {
+              AssignBinaryOp<T>(op.kind, block, arg, block);
+            }
+          }
+        }
+      }
+    };
+    const int64 num_blocks = Eigen::divup(num_elements, kBlockSize);
+    context->device()->tensorflow_cpu_worker_threads()->workers->ParallelFor(
+        num_blocks, kBlockSize * cost_per_element_, compute_blocks);
+  }
+
+ private:
+  std::vector<FusedOp> ops_;
+  int64 cost_per_element_;
+};
+
+#define REGISTER_CPU(T)                                                    \
+  REGISTER_KERNEL_BUILDER(                                                 \
+      Name("_FusedElementwise").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedElementwiseOp<T>);
+
+TF_CALL_float(REGISTER_CPU);
+TF_CALL_double(REGISTER_CPU);
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
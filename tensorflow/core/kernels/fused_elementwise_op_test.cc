@@ -0,0 +1,103 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class FusedElementwiseOpTest : public OpsTestBase {
+ protected:
+  Status MakeOp(const std::vector<string>& fused_ops, int num_args,
+                const std::vector<bool>& arg_is_lhs) {
+    TF_RETURN_IF_ERROR(NodeDefBuilder("fused_elementwise", "_FusedElementwise")
+                           .Input(FakeInput(DT_FLOAT))
+                           .Input(FakeInput(num_args, DT_FLOAT))
+                           .Attr("fused_ops", fused_ops)
+                           .Attr("arg_is_lhs", arg_is_lhs)
+                           .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(FusedElementwiseOpTest, UnaryChain) {
+  TF_ASSERT_OK(MakeOp({"Square", "Neg", "Exp"}, /*num_args=*/0, {}));
+  AddInputFromArray<float>(TensorShape({2, 2}), {0, 1, -2, 0.5});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({2, 2}));
+  test::FillValues<float>(&expected, {1, std::exp(-1.0f), std::exp(-4.0f),
+                                      std::exp(-0.25f)});
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-6);
+}
+
+TEST_F(FusedElementwiseOpTest, BinaryChain) {
+  // tanh(2 - (x * y)) + 1
+  TF_ASSERT_OK(MakeOp({"Mul", "Sub", "Tanh", "AddV2"}, /*num_args=*/3,
+                      {false, true, false}));
+  AddInputFromArray<float>(TensorShape({3}), {1, 2, 3});
+  AddInputFromArray<float>(TensorShape({3}), {0.5, -1, 0});
+  AddInputFromArray<float>(TensorShape({}), {2});
+  AddInputFromArray<float>(TensorShape({}), {1});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({3}));
+  test::FillValues<float>(&expected, {std::tanh(1.5f) + 1, std::tanh(4.0f) + 1,
+                                      std::tanh(2.0f) + 1});
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-6);
+}
+
+TEST_F(FusedElementwiseOpTest, SpansMultipleBlocks) {
+  TF_ASSERT_OK(MakeOp({"Mul", "Relu6"}, /*num_args=*/1, {false}));
+  const int64 num_elements = 5000;
+  std::vector<float> x(num_elements);
+  std::vector<float> y(num_elements);
+  std::vector<float> expected_values(num_elements);
+  for (int64 i = 0; i < num_elements; ++i) {
+    x[i] = i % 17 - 8;
+    y[i] = (i % 5) * 0.5f;
+    expected_values[i] = std::min(std::max(x[i] * y[i], 0.0f), 6.0f);
+  }
+  AddInputFromArray<float>(TensorShape({num_elements}), x);
+  AddInputFromArray<float>(TensorShape({num_elements}), y);
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({num_elements}));
+  test::FillValues<float>(&expected, expected_values);
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsBroadcasting) {
+  TF_ASSERT_OK(MakeOp({"Add"}, /*num_args=*/1, {false}));
+  AddInputFromArray<float>(TensorShape({2, 2}), {1, 2, 3, 4});
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsUnsupportedOp) {
+  EXPECT_TRUE(
+      errors::IsUnimplemented(MakeOp({"Cos"}, /*num_args=*/0, {})));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -22,6 +22,8 @@ limitations under the License.
 #include "google/protobuf/any.pb.h"
 #include "absl/algorithm/container.h"
 #include "absl/base/call_once.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logger.h"
 #include "tensorflow/core/protobuf/autotuning.pb.h"
 #include "tensorflow/core/protobuf/conv_autotuning.pb.h"
@@ -30,6 +32,10 @@ limitations under the License.
 #include "tensorflow/stream_executor/gpu/asm_compiler.h"
 #include "tensorflow/stream_executor/gpu/redzone_allocator.h"
 
+#if GOOGLE_CUDA
+#include "third_party/gpus/cudnn/cudnn.h"
+#endif
+
 namespace tensorflow {
 
 bool RedzoneCheckDisabled() {
@@ -243,6 +249,199 @@ bool RequireCudnnDeterminism() {
   return require_cudnn_determinism;
 }
 
+namespace {
+
+constexpr char kAutotuneCacheFingerprintKey[] = "fingerprint";
+
+// Describes the GPUs visible to the process, without initializing them, and
+// the version of the DNN library they use.
+string AutotuneCacheFingerprint() {
+#if GOOGLE_CUDA
+  const char* platform_name = "CUDA";
+  string fingerprint = strings::StrCat("cudnn ", CUDNN_VERSION);
+#else
+  const char* platform_name = "ROCM";
+  string fingerprint = "miopen";
+#endif
+  auto platform_or = se::MultiPlatformManager::PlatformWithName(platform_name);
+  if (!platform_or.ok()) return fingerprint;
+  se::Platform* platform = platform_or.ValueOrDie();
+  for (int i = 0; i < platform->VisibleDeviceCount(); ++i) {
+    auto description_or = platform->DescriptionForDevice(i);
+    if (!description_or.ok()) continue;
+    const se::DeviceDescription& description = *description_or.ValueOrDie();
+    strings::StrAppend(&fingerprint, "; ", description.name(), " ",
+                       description.runtime_version());
+#if GOOGLE_CUDA
+    int cc_major, cc_minor;
+    if (description.cuda_compute_capability(&cc_major, &cc_minor)) {
+      strings::StrAppend(&fingerprint, " sm_", cc_major, cc_minor);
+    }
+#else
+    strings::StrAppend(&fingerprint, " ",
+                       description.rocm_amdgpu_gcn_arch_name());
+#endif
+  }
+  return fingerprint;
+}
+
+string AutotuneCacheKey(const string& map_name, const string& key) {
+  return strings::StrCat(map_name, "\t", key);
+}
+
+}  // namespace
+
+AutotuneCache* AutotuneCache::Global() {
+  static AutotuneCache* cache = []() -> AutotuneCache* {
+    string path;
+    Status status = ReadStringFromEnvVar("TF_AUTOTUNE_CACHE_FILE", "", &path);
+    if (!status.ok()) LOG(ERROR) << status;
+    if (path.empty()) return nullptr;
+    bool read_only = false;
+    status = ReadBoolFromEnvVar("TF_AUTOTUNE_CACHE_READ_ONLY", false,
+                                &read_only);
+    if (!status.ok()) LOG(ERROR) << status;
+    return new AutotuneCache(path, read_only);
+  }();
+  return cache;
+}
+
+AutotuneCache::AutotuneCache(const string& path, bool read_only)
+    : path_(path),
+      read_only_(read_only),
+      fingerprint_(AutotuneCacheFingerprint()) {
+  mutex_lock l(mu_);
+  Load();
+}
+
+void AutotuneCache::Load() {
+  Env* env = Env::Default();
+  string contents;
+  // The file starts with the fingerprint, followed by one
+  // "<map name>\t<parameters>\t<config>" line per entry.
+  if (env->FileExists(path_).ok() &&
+      ReadFileToString(env, path_, &contents).ok()) {
+    std::vector<string> lines = str_util::Split(contents, '\n');
+    if (!lines.empty() &&
+        lines[0] ==
+            strings::StrCat(kAutotuneCacheFingerprintKey, "\t", fingerprint_)) {
+      for (size_t i = 1; i < lines.size(); ++i) {
+        std::vector<string> fields = str_util::Split(lines[i], '\t');
+        // Skips the truncated line of a process that died while writing.
+        if (fields.size() != 3) continue;
+        entries_[AutotuneCacheKey(fields[0], fields[1])] = fields[2];
+      }
+      VLOG(1) << "Loaded " << entries_.size() << " autotune results from "
+              << path_;
+      if (!read_only_) {
+        Status status = env->NewAppendableFile(path_, &file_);
+        if (!status.ok()) LOG(WARNING) << status;
+      }
+      return;
+    }
+    LOG(WARNING) << "Ignoring autotune results in " << path_
+                 << ", which were found on other devices.";
+  }
+  if (read_only_) return;
+  Status status = env->NewWritableFile(path_, &file_);
+  if (status.ok()) {
+    status = file_->Append(
+        strings::StrCat(kAutotuneCacheFingerprintKey, "\t", fingerprint_, "\n"));
+  }
+  if (status.ok()) status = file_->Flush();
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to write autotune results to " << path_ << ": "
+                 << status;
+    file_.reset();
+  }
+}
+
+bool AutotuneCache::Lookup(const string& map_name, const string& key,
+                           string* value) {
+  mutex_lock l(mu_);
+  auto it = entries_.find(AutotuneCacheKey(map_name, key));
+  if (it == entries_.end()) return false;
+  *value = it->second;
+  return true;
+}
+
+void AutotuneCache::Insert(const string& map_name, const string& key,
+                           const string& value) {
+  mutex_lock l(mu_);
+  string& entry = entries_[AutotuneCacheKey(map_name, key)];
+  if (entry == value) return;
+  entry = value;
+  if (file_ == nullptr) return;
+  // Each entry is flushed on its own, so that it survives a crash later on.
+  Status status =
+      file_->Append(strings::StrCat(map_name, "\t", key, "\t", value, "\n"));
+  if (status.ok()) status = file_->Flush();
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to write autotune results to " << path_ << ": "
+                 << status;
+    file_.reset();
+  }
+}
+
+namespace {
+
+// Writes an algorithm as "<algo id>,<tensor ops>", or "-" if it is not set.
+string SerializeAlgorithm(
+    const absl::optional<se::dnn::AlgorithmDesc>& algorithm) {
+  if (!algorithm.has_value()) return "-";
+  return strings::StrCat(algorithm->algo_id(), ",",
+                         algorithm->tensor_ops_enabled() ? 1 : 0);
+}
+
+bool ParseAlgorithm(const string& in,
+                    absl::optional<se::dnn::AlgorithmDesc>* algorithm) {
+  if (in == "-") {
+    algorithm->reset();
+    return true;
+  }
+  std::vector<string> fields = str_util::Split(in, ',');
+  int64 algo_id;
+  int32 tensor_ops;
+  if (fields.size() != 2 || !strings::safe_strto64(fields[0], &algo_id) ||
+      !strings::safe_strto32(fields[1], &tensor_ops)) {
+    return false;
+  }
+  *algorithm = se::dnn::AlgorithmDesc(algo_id, tensor_ops != 0);
+  return true;
+}
+
+}  // namespace
+
+bool SerializeAutotuneConfig(const se::dnn::AlgorithmConfig& config,
+                             string* out) {
+  const auto scratch_size = config.scratch_size();
+  *out = strings::StrCat(
+      SerializeAlgorithm(config.algorithm()), " ",
+      SerializeAlgorithm(config.algorithm_no_scratch()), " ",
+      scratch_size.has_value() ? strings::StrCat(*scratch_size) : "-");
+  return true;
+}
+
+bool ParseAutotuneConfig(const string& in, se::dnn::AlgorithmConfig* config) {
+  std::vector<string> fields = str_util::Split(in, ' ');
+  absl::optional<se::dnn::AlgorithmDesc> algorithm, algorithm_no_scratch;
+  if (fields.size() != 3 || !ParseAlgorithm(fields[0], &algorithm) ||
+      !ParseAlgorithm(fields[1], &algorithm_no_scratch)) {
+    return false;
+  }
+  *config = se::dnn::AlgorithmConfig();
+  if (algorithm.has_value()) config->set_algorithm(*algorithm);
+  if (algorithm_no_scratch.has_value()) {
+    config->set_algorithm_no_scratch(*algorithm_no_scratch);
+  }
+  if (fields[2] != "-") {
+    uint64 scratch_size;
+    if (!strings::safe_strtou64(fields[2], &scratch_size)) return false;
+    config->set_scratch_size(scratch_size);
+  }
+  return true;
+}
+
 Status BestCudnnConvAlgorithm(absl::Span<const AutotuneResult> results,
                               se::dnn::AlgorithmConfig* algo) {
   std::vector<AutotuneResult> filtered_results;
@@ -18,6 +18,7 @@ limitations under the License.
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
+#include <memory>
 #include <unordered_map>
 
 #include "absl/types/span.h"
@@ -26,8 +27,11 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 
 namespace stream_executor {
 class RedzoneAllocator;
@@ -66,6 +70,63 @@ inline se::DeviceMemory<T> AsDeviceMemory(const T* cuda_memory, uint64 size) {
   return typed;
 }
 
+// Autotune results shared across processes through a file.
+//
+// Enabled by setting the TF_AUTOTUNE_CACHE_FILE environment variable to a
+// file path. Entries are read from the file the first time the cache is used,
+// and every newly accepted autotune result is appended to it, so that later
+// processes on the same machine skip autotuning for the shapes already seen.
+// The file is only trusted if it was written for the same GPU models and cuDNN
+// version, otherwise it is rewritten from scratch. Setting
+// TF_AUTOTUNE_CACHE_READ_ONLY to true stops new results from being written.
+class AutotuneCache {
+ public:
+  // Returns the process-wide cache, or nullptr if it is disabled.
+  static AutotuneCache* Global();
+
+  // Sets `*value` to the entry stored for `key` in the autotune map called
+  // `map_name`, and returns whether there was one.
+  bool Lookup(const string& map_name, const string& key, string* value)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Stores `value` for `key` in the autotune map called `map_name`.
+  void Insert(const string& map_name, const string& key, const string& value)
+      TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  AutotuneCache(const string& path, bool read_only);
+
+  // Reads the entries of the file, or starts the file over if it is missing
+  // or was written for other devices.
+  void Load() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const string path_;
+  const bool read_only_;
+  // Describes the GPUs of the process and the cuDNN version.
+  const string fingerprint_;
+
+  mutex mu_;
+  // Entries keyed by map name and parameters.
+  std::unordered_map<string, string> entries_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<WritableFile> file_ TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(AutotuneCache);
+};
+
+// Converts autotune configs to and from the text stored by AutotuneCache.
+// Configs without an overload are not persisted.
+template <typename Config>
+bool SerializeAutotuneConfig(const Config& config, string* out) {
+  return false;
+}
+template <typename Config>
+bool ParseAutotuneConfig(const string& in, Config* config) {
+  return false;
+}
+bool SerializeAutotuneConfig(const se::dnn::AlgorithmConfig& config,
+                             string* out);
+bool ParseAutotuneConfig(const string& in, se::dnn::AlgorithmConfig* config);
+
 // A helper class that looks up the best autotuned config from parameters.
 // Due to the noisy nature of autotune, especially with multiple devices, it
 // only accepts a config if its margin exceeds a threshold.
@@ -82,9 +143,11 @@ class AutoTuneMap {
   bool Find(const Parameters& params, Config* config) const {
     mutex_lock lock(mu_);
     auto iter = params_config_map_.find(params);
-    if (iter == params_config_map_.end() ||
-        (iter->second.score < min_score_threshold_ &&
-         iter->second.count <= max_autotune_count_)) {
+    if (iter == params_config_map_.end()) {
+      return FindInCache(params, config);
+    }
+    if (iter->second.score < min_score_threshold_ &&
+        iter->second.count <= max_autotune_count_) {
       return false;
     }
     *config = iter->second.config;
@@ -121,6 +184,7 @@ class AutoTuneMap {
     }
     if (new_score >= min_score_threshold_) {
       VLOG(1) << GetActionSummary("accepts", params, config);
+      InsertInCache(params, config);
     } else if (autotune_global_count_ >= max_autotune_global_count_) {
       // The autotuning exceeds the max iteration threshold and we accept the
       // the winner if it exists in the map, otherwise we accept the current
@@ -141,6 +205,7 @@ class AutoTuneMap {
         winner->second.score = min_score_threshold_;
       }
       VLOG(1) << GetActionSummary("accepts", params, config);
+      InsertInCache(params, params_config_map_.find(params)->second.config);
     }
     autotune_global_count_++;
   }
@@ -175,8 +240,33 @@ class AutoTuneMap {
     }
   };
 
+  // Accepts the config stored for `params` in the AutotuneCache, if any.
+  bool FindInCache(const Parameters& params, Config* config) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    AutotuneCache* cache = AutotuneCache::Global();
+    string value;
+    if (cache == nullptr ||
+        !cache->Lookup(name_, params.ToString(), &value) ||
+        !ParseAutotuneConfig(value, config)) {
+      return false;
+    }
+    VLOG(1) << GetActionSummary("loads", params, *config);
+    params_config_map_.insert(
+        std::make_pair(params, ValueType{*config, min_score_threshold_, 1}));
+    return true;
+  }
+
+  void InsertInCache(const Parameters& params, const Config& config)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    AutotuneCache* cache = AutotuneCache::Global();
+    string value;
+    if (cache != nullptr && SerializeAutotuneConfig(config, &value)) {
+      cache->Insert(name_, params.ToString(), value);
+    }
+  }
+
   std::string GetActionSummary(StringPiece action, const Parameters& params,
-                               const Config& config) {
+                               const Config& config) const {
     return strings::Printf("autotune_map %s %s: %s -> (%s)", name_.c_str(),
                            string(action).c_str(), params.ToString().c_str(),
                            config.ToString().c_str());
@@ -188,7 +278,8 @@ class AutoTuneMap {
     int32 score;
     int32 count;
   };
-  std::unordered_map<Parameters, ValueType, Hasher> params_config_map_
+  // Mutable so that Find() can add the entries loaded from the AutotuneCache.
+  mutable std::unordered_map<Parameters, ValueType, Hasher> params_config_map_
       TF_GUARDED_BY(mu_);
   std::string name_;
   int32 min_score_threshold_;
@@ -0,0 +1,55 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#include "tensorflow/core/kernels/gpu_utils.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(AutotuneConfigTest, AlgorithmConfigRoundTrips) {
+  se::dnn::AlgorithmConfig config(se::dnn::AlgorithmDesc(7, true), 1024);
+  config.set_algorithm_no_scratch(se::dnn::AlgorithmDesc(1, false));
+  string text;
+  ASSERT_TRUE(SerializeAutotuneConfig(config, &text));
+  se::dnn::AlgorithmConfig parsed;
+  ASSERT_TRUE(ParseAutotuneConfig(text, &parsed));
+  EXPECT_EQ(parsed, config);
+}
+
+TEST(AutotuneConfigTest, EmptyAlgorithmConfigRoundTrips) {
+  se::dnn::AlgorithmConfig config;
+  string text;
+  ASSERT_TRUE(SerializeAutotuneConfig(config, &text));
+  se::dnn::AlgorithmConfig parsed(se::dnn::AlgorithmDesc(3, false), 16);
+  ASSERT_TRUE(ParseAutotuneConfig(text, &parsed));
+  EXPECT_EQ(parsed, config);
+}
+
+TEST(AutotuneConfigTest, RejectsMalformedAlgorithmConfig) {
+  se::dnn::AlgorithmConfig parsed;
+  EXPECT_FALSE(ParseAutotuneConfig("", &parsed));
+  EXPECT_FALSE(ParseAutotuneConfig("7,1 -", &parsed));
+  EXPECT_FALSE(ParseAutotuneConfig("x,1 - 0", &parsed));
+  EXPECT_FALSE(ParseAutotuneConfig("7,1 - size", &parsed));
+}
+
+}  // namespace
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -0,0 +1,620 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/lookup_interface.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/lookup_table_op.h"
+#include "tensorflow/core/kernels/lookup_util.h"
+#include "tensorflow/core/kernels/sharded_hash_map.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace lookup {
+
+// Embedding table keyed by integer ids with an unbounded vocabulary. A row is
+// only allocated for an id once it has been looked up `admission_threshold`
+// times, and HashEmbeddingEvict drops the rows of ids that were looked up less
+// than a given number of times since the previous eviction. Besides the
+// embedding, every row stores `num_slots` optimizer slot vectors of the same
+// size, so the fused HashEmbeddingSparseApply* kernels update a row and its
+// slots in place.
+//
+// Rows live in a ShardedHashMap. Lookups read rows with their shard locked
+// for reading, and optimizer updates, admissions and evictions lock the shard
+// of the row for writing.
+//
+// The table also implements LookupInterface, so LookupTableFindV2 and friends
+// work on it: they read and write embeddings only and do not count
+// frequencies.
+class HashEmbeddingTableBase : public LookupInterface {
+ public:
+  // Drops the rows of ids looked up less than `min_frequency` times since the
+  // previous eviction along with pending admissions, resets the frequencies
+  // of the kept rows and returns the number of dropped rows. Rows written by
+  // Insert or ImportValues start with a frequency of 0.
+  virtual int64 Evict(int64 min_frequency) = 0;
+};
+
+template <class K, class V>
+class HashEmbeddingTable final : public HashEmbeddingTableBase {
+ public:
+  HashEmbeddingTable(OpKernelContext* ctx, OpKernel* kernel) {
+    OP_REQUIRES_OK(ctx,
+                   GetNodeAttr(kernel->def(), "embedding_dim", &dim_));
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "slot_initial_values",
+                                    &slot_initial_values_));
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "admission_threshold",
+                                    &admission_threshold_));
+    num_slots_ = slot_initial_values_.size();
+  }
+
+  int64 dim() const { return dim_; }
+  int64 num_slots() const { return num_slots_; }
+
+  size_t size() const override { return rows_.size(); }
+
+  // Writes the embeddings of `keys` into the rows of `*values`. Ids without a
+  // row get their row of `default_value`. With `count_frequency`, increments
+  // the frequency of every id and allocates rows for the ids that reach the
+  // admission threshold, initialized to their default value.
+  Status Lookup(const Tensor& keys, const Tensor& default_value,
+                bool count_frequency, Tensor* values) {
+    const auto key_values = keys.flat<K>();
+    auto value_values = values->flat_inner_dims<V, 2>();
+    const auto default_flat = default_value.flat_inner_dims<V, 2>();
+    const bool is_full_size_default =
+        (default_flat.dimension(0) == key_values.size());
+
+    for (int64 i = 0; i < key_values.size(); ++i) {
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      V* out = &value_values(i, 0);
+      const V* default_row = &default_flat(is_full_size_default ? i : 0, 0);
+      auto copy_row = [this, out](const RowPtr& row) {
+        std::copy_n(row->data.get(), dim_, out);
+      };
+      const bool found = rows_.FindAndApply(key, [&](const RowPtr& row) {
+        if (count_frequency) {
+          row->frequency.fetch_add(1, std::memory_order_relaxed);
+        }
+        copy_row(row);
+      });
+      if (found) continue;
+
+      int64 frequency = 1;
+      if (count_frequency && admission_threshold_ > 1) {
+        candidates_.FindOrInsertAndMutate(
+            key, []() { return int64{0}; },
+            [&frequency](int64* count) { frequency = ++*count; });
+      }
+      if (!count_frequency || frequency < admission_threshold_) {
+        std::copy_n(default_row, dim_, out);
+        continue;
+      }
+      rows_.FindOrInsertAndMutate(
+          key, [this, default_row]() { return NewRow(default_row); },
+          [&](RowPtr* row) {
+            (*row)->frequency.fetch_add(frequency, std::memory_order_relaxed);
+            copy_row(*row);
+          });
+      if (admission_threshold_ > 1) candidates_.Erase(key);
+    }
+    return Status::OK();
+  }
+
+  // Calls `fn(grad_index, var, slots)` for every index whose id has a row,
+  // with the shard of the row locked for writing. `var` points to the
+  // embedding and `slots` to the `num_slots` slot vectors that follow it.
+  // Gradients of ids without a row are dropped.
+  template <typename Fn>
+  void ApplyRows(const Tensor& indices, Fn fn) {
+    const auto indices_vec = indices.flat<K>();
+    for (int64 i = 0; i < indices_vec.size(); ++i) {
+      const K key = SubtleMustCopyIfIntegral(indices_vec(i));
+      rows_.FindAndMutate(key, [&](RowPtr* row) {
+        V* data = (*row)->data.get();
+        fn(i, data, data + dim_);
+      });
+    }
+  }
+
+  int64 Evict(int64 min_frequency) override {
+    candidates_.Clear();
+    return rows_.EraseIf([min_frequency](const K& key, RowPtr* row) {
+      if ((*row)->frequency.load(std::memory_order_relaxed) < min_frequency) {
+        return true;
+      }
+      (*row)->frequency.store(0, std::memory_order_relaxed);
+      return false;
+    });
+  }
+
+  // Exports all rows as `keys`, `values`, `slots` and `frequencies` outputs.
+  Status ExportAll(OpKernelContext* ctx) {
+    Status status;
+    Tensor* keys = nullptr;
+    Tensor* values = nullptr;
+    Tensor* slots = nullptr;
+    Tensor* frequencies = nullptr;
+    int64 i = 0;
+    rows_.ForEach(
+        [&](size_t size) {
+          const int64 n = size;
+          status.Update(
+              ctx->allocate_output("keys", TensorShape({n}), &keys));
+          if (!status.ok()) return;
+          status.Update(
+              ctx->allocate_output("values", TensorShape({n, dim_}), &values));
+          if (!status.ok()) return;
+          status.Update(ctx->allocate_output(
+              "slots", TensorShape({n, num_slots_, dim_}), &slots));
+          if (!status.ok()) return;
+          status.Update(ctx->allocate_output(
+              "frequencies", TensorShape({n}), &frequencies));
+        },
+        [&](const K& key, const RowPtr& row) {
+          if (!status.ok()) return;
+          keys->flat<K>()(i) = key;
+          std::copy_n(row->data.get(), dim_,
+                      values->flat<V>().data() + i * dim_);
+          std::copy_n(row->data.get() + dim_, num_slots_ * dim_,
+                      slots->flat<V>().data() + i * num_slots_ * dim_);
+          frequencies->flat<int64>()(i) =
+              row->frequency.load(std::memory_order_relaxed);
+          ++i;
+        });
+    return status;
+  }
+
+  // Replaces the contents of the table with the exported rows.
+  Status ImportAll(const Tensor& keys, const Tensor& values,
+                   const Tensor& slots, const Tensor& frequencies) {
+    const int64 n = keys.NumElements();
+    if (values.shape() != TensorShape({n, dim_}) ||
+        slots.shape() != TensorShape({n, num_slots_, dim_}) ||
+        frequencies.shape() != TensorShape({n})) {
+      return errors::InvalidArgument(
+          "Expected values of shape [", n, ", ", dim_, "], slots of shape [",
+          n, ", ", num_slots_, ", ", dim_, "] and frequencies of shape [", n,
+          "], got ", values.shape().DebugString(), ", ",
+          slots.shape().DebugString(), " and ",
+          frequencies.shape().DebugString());
+    }
+    const auto key_values = keys.flat<K>();
+    const V* value_data = values.flat<V>().data();
+    const V* slot_data = slots.flat<V>().data();
+    const auto frequency_values = frequencies.flat<int64>();
+    candidates_.Clear();
+    rows_.Assign([&](const std::function<void(const K&, RowPtr)>& insert) {
+      for (int64 i = 0; i < n; ++i) {
+        RowPtr row = NewRow(value_data + i * dim_);
+        std::copy_n(slot_data + i * num_slots_ * dim_, num_slots_ * dim_,
+                    row->data.get() + dim_);
+        row->frequency.store(frequency_values(i), std::memory_order_relaxed);
+        insert(SubtleMustCopyIfIntegral(key_values(i)), std::move(row));
+      }
+    });
+    return Status::OK();
+  }
+
+  Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+              const Tensor& default_value) override {
+    return Lookup(key, default_value, /*count_frequency=*/false, value);
+  }
+
+  Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                const Tensor& values) override {
+    const auto key_values = keys.flat<K>();
+    const auto value_values = values.flat_inner_dims<V, 2>();
+    for (int64 i = 0; i < key_values.size(); ++i) {
+      const V* value_row = &value_values(i, 0);
+      rows_.FindOrInsertAndMutate(
+          SubtleMustCopyIfIntegral(key_values(i)),
+          [this, value_row]() { return NewRow(value_row); },
+          [this, value_row](RowPtr* row) {
+            std::copy_n(value_row, dim_, (*row)->data.get());
+          });
+    }
+    return Status::OK();
+  }
+
+  Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    const auto key_values = keys.flat<K>();
+    for (int64 i = 0; i < key_values.size(); ++i) {
+      rows_.Erase(SubtleMustCopyIfIntegral(key_values(i)));
+    }
+    return Status::OK();
+  }
+
+  Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    const auto key_values = keys.flat<K>();
+    const auto value_values = values.flat_inner_dims<V, 2>();
+    candidates_.Clear();
+    rows_.Assign([&](const std::function<void(const K&, RowPtr)>& insert) {
+      for (int64 i = 0; i < key_values.size(); ++i) {
+        insert(SubtleMustCopyIfIntegral(key_values(i)),
+               NewRow(&value_values(i, 0)));
+      }
+    });
+    return Status::OK();
+  }
+
+  Status ExportValues(OpKernelContext* ctx) override {
+    Status status;
+    Tensor* keys = nullptr;
+    Tensor* values = nullptr;
+    int64 i = 0;
+    rows_.ForEach(
+        [&](size_t size) {
+          const int64 n = size;
+          status.Update(
+              ctx->allocate_output("keys", TensorShape({n}), &keys));
+          if (!status.ok()) return;
+          status.Update(
+              ctx->allocate_output("values", TensorShape({n, dim_}), &values));
+        },
+        [&](const K& key, const RowPtr& row) {
+          if (!status.ok()) return;
+          keys->flat<K>()(i) = key;
+          std::copy_n(row->data.get(), dim_,
+                      values->flat<V>().data() + i * dim_);
+          ++i;
+        });
+    return status;
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return TensorShape({dim_}); }
+
+  int64 MemoryUsed() const override {
+    return sizeof(HashEmbeddingTable) +
+           rows_.capacity() * (sizeof(K) + sizeof(RowPtr)) +
+           rows_.size() * (sizeof(Row) + (1 + num_slots_) * dim_ * sizeof(V)) +
+           candidates_.capacity() * (sizeof(K) + sizeof(int64));
+  }
+
+ private:
+  struct Row {
+    explicit Row(int64 size) : data(new V[size]) {}
+    // The embedding followed by the slot vectors.
+    std::unique_ptr<V[]> data;
+    std::atomic<int64> frequency{0};
+  };
+  typedef std::unique_ptr<Row> RowPtr;
+
+  // Returns a row with embedding `value` and freshly initialized slots.
+  RowPtr NewRow(const V* value) const {
+    RowPtr row(new Row((1 + num_slots_) * dim_));
+    std::copy_n(value, dim_, row->data.get());
+    for (int64 s = 0; s < num_slots_; ++s) {
+      std::fill_n(row->data.get() + (1 + s) * dim_, dim_,
+                  static_cast<V>(slot_initial_values_[s]));
+    }
+    return row;
+  }
+
+  int64 dim_ = 0;
+  int64 num_slots_ = 0;
+  int64 admission_threshold_ = 1;
+  std::vector<float> slot_initial_values_;
+  ShardedHashMap<K, RowPtr> rows_;
+  // Lookup counts of ids that have not reached the admission threshold yet.
+  ShardedHashMap<K, int64> candidates_;
+};
+
+}  // namespace lookup
+
+namespace {
+
+template <class K, class V>
+Status GetHashEmbeddingTable(OpKernelContext* ctx,
+                             lookup::HashEmbeddingTable<K, V>** table) {
+  lookup::LookupInterface* lookup_table;
+  TF_RETURN_IF_ERROR(
+      lookup::GetLookupTable("table_handle", ctx, &lookup_table));
+  *table = dynamic_cast<lookup::HashEmbeddingTable<K, V>*>(lookup_table);
+  if (*table == nullptr) {
+    lookup_table->Unref();
+    return errors::InvalidArgument(
+        "Table is not a HashEmbeddingTable with key type ",
+        DataTypeString(DataTypeToEnum<K>::v()), " and value type ",
+        DataTypeString(DataTypeToEnum<V>::v()));
+  }
+  return Status::OK();
+}
+
+template <class K, class V>
+class HashEmbeddingLookupOp : public OpKernel {
+ public:
+  explicit HashEmbeddingLookupOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("count_frequency", &count_frequency_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    lookup::HashEmbeddingTable<K, V>* table;
+    OP_REQUIRES_OK(ctx, GetHashEmbeddingTable(ctx, &table));
+    core::ScopedUnref unref_me(table);
+
+    const Tensor& keys = ctx->input(1);
+    const Tensor& default_value = ctx->input(2);
+    OP_REQUIRES_OK(ctx, table->CheckFindArguments(keys, default_value));
+
+    TensorShape output_shape = keys.shape();
+    output_shape.AddDim(table->dim());
+    Tensor* values;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("values", output_shape, &values));
+    OP_REQUIRES_OK(
+        ctx, table->Lookup(keys, default_value, count_frequency_, values));
+  }
+
+ private:
+  bool count_frequency_;
+};
+
+// Checks that `grad` holds one embedding sized row per index.
+template <class K, class V>
+Status CheckSparseApplyArguments(const lookup::HashEmbeddingTable<K, V>& table,
+                                 const Tensor& grad, const Tensor& indices,
+                                 int64 min_num_slots) {
+  if (!TensorShapeUtils::IsVector(indices.shape())) {
+    return errors::InvalidArgument("indices must be one-dimensional, got ",
+                                   indices.shape().DebugString());
+  }
+  if (grad.shape() != TensorShape({indices.dim_size(0), table.dim()})) {
+    return errors::InvalidArgument(
+        "grad must have shape [", indices.dim_size(0), ", ", table.dim(),
+        "], got ", grad.shape().DebugString());
+  }
+  if (table.num_slots() < min_num_slots) {
+    return errors::FailedPrecondition("The table has ", table.num_slots(),
+                                      " slots, the optimizer needs ",
+                                      min_num_slots);
+  }
+  return Status::OK();
+}
+
+// Same update as SparseApplyAdagradV2 on the rows of the looked up ids, with
+// the accumulator in slot 0.
+template <class K, class V>
+class HashEmbeddingSparseApplyAdagradOp : public OpKernel {
+ public:
+  explicit HashEmbeddingSparseApplyAdagradOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("update_slots", &update_slots_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    lookup::HashEmbeddingTable<K, V>* table;
+    OP_REQUIRES_OK(ctx, GetHashEmbeddingTable(ctx, &table));
+    core::ScopedUnref unref_me(table);
+
+    const Tensor& lr = ctx->input(1);
+    const Tensor& epsilon = ctx->input(2);
+    const Tensor& grad = ctx->input(3);
+    const Tensor& indices = ctx->input(4);
+    OP_REQUIRES(ctx,
+                TensorShapeUtils::IsScalar(lr.shape()) &&
+                    TensorShapeUtils::IsScalar(epsilon.shape()),
+                errors::InvalidArgument("lr and epsilon must be scalars"));
+    OP_REQUIRES_OK(ctx, CheckSparseApplyArguments(*table, grad, indices,
+                                                  /*min_num_slots=*/1));
+
+    const V lr_scalar = lr.scalar<V>()();
+    const V epsilon_scalar = epsilon.scalar<V>()();
+    const auto grad_flat = grad.matrix<V>();
+    const int64 dim = table->dim();
+    const bool update_slots = update_slots_;
+    table->ApplyRows(indices, [&](int64 i, V* var, V* accum) {
+      for (int64 j = 0; j < dim; ++j) {
+        const V g = grad_flat(i, j);
+        if (update_slots) accum[j] += g * g;
+        var[j] -= lr_scalar * g / (std::sqrt(accum[j]) + epsilon_scalar);
+      }
+    });
+  }
+
+ private:
+  bool update_slots_;
+};
+
+// Same update as SparseApplyFtrl on the rows of the looked up ids, with the
+// accumulator in slot 0 and the linear term in slot 1.
+template <class K, class V>
+class HashEmbeddingSparseApplyFtrlOp : public OpKernel {
+ public:
+  explicit HashEmbeddingSparseApplyFtrlOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(
+        ctx, ctx->GetAttr("multiply_linear_by_lr", &multiply_linear_by_lr_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    lookup::HashEmbeddingTable<K, V>* table;
+    OP_REQUIRES_OK(ctx, GetHashEmbeddingTable(ctx, &table));
+    core::ScopedUnref unref_me(table);
+
+    const Tensor& grad = ctx->input(1);
+    const Tensor& indices = ctx->input(2);
+    for (int i = 3; i < 7; ++i) {
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(ctx->input(i).shape()),
+                  errors::InvalidArgument(
+                      "lr, l1, l2 and lr_power must be scalars, got ",
+                      ctx->input(i).shape().DebugString()));
+    }
+    const V lr = ctx->input(3).scalar<V>()();
+    const V l1 = ctx->input(4).scalar<V>()();
+    const V l2 = ctx->input(5).scalar<V>()();
+    const V lr_power = ctx->input(6).scalar<V>()();
+    OP_REQUIRES(ctx, lr > static_cast<V>(0),
+                errors::InvalidArgument("lr is not a positive scalar: ", lr));
+    OP_REQUIRES(
+        ctx, l1 >= static_cast<V>(0),
+        errors::InvalidArgument("l1 is not a non-negative scalar: ", l1));
+    OP_REQUIRES(
+        ctx, l2 >= static_cast<V>(0),
+        errors::InvalidArgument("l2 is not a non-negative scalar: ", l2));
+    OP_REQUIRES(
+        ctx, lr_power <= static_cast<V>(0),
+        errors::InvalidArgument("lr_power is not a non-positive scalar: ",
+                                lr_power));
+    OP_REQUIRES_OK(ctx, CheckSparseApplyArguments(*table, grad, indices,
+                                                  /*min_num_slots=*/2));
+
+    const auto grad_flat = grad.matrix<V>();
+    const int64 dim = table->dim();
+    const bool multiply_linear_by_lr = multiply_linear_by_lr_;
+    table->ApplyRows(indices, [&](int64 i, V* var, V* slots) {
+      V* accum = slots;
+      V* linear = slots + dim;
+      for (int64 j = 0; j < dim; ++j) {
+        const V g = grad_flat(i, j);
+        const V new_accum = accum[j] + g * g;
+        V sigma =
+            std::pow(new_accum, -lr_power) - std::pow(accum[j], -lr_power);
+        if (!multiply_linear_by_lr) sigma /= lr;
+        linear[j] += (multiply_linear_by_lr ? g * lr : g) - sigma * var[j];
+        const V l1_reg = multiply_linear_by_lr ? l1 * lr : l1;
+        const V quadratic =
+            std::pow(new_accum, -lr_power) / (multiply_linear_by_lr ? 1 : lr) +
+            static_cast<V>(2) * l2 * (multiply_linear_by_lr ? lr : 1);
+        const V l1_reg_adjust = std::max(std::min(linear[j], l1_reg), -l1_reg);
+        var[j] = (l1_reg_adjust - linear[j]) / quadratic;
+        accum[j] = new_accum;
+      }
+    });
+  }
+
+ private:
+  bool multiply_linear_by_lr_;
+};
+
+class HashEmbeddingEvictOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    lookup::LookupInterface* lookup_table;
+    OP_REQUIRES_OK(ctx,
+                   lookup::GetLookupTable("table_handle", ctx, &lookup_table));
+    core::ScopedUnref unref_me(lookup_table);
+    auto* table = dynamic_cast<lookup::HashEmbeddingTableBase*>(lookup_table);
+    OP_REQUIRES(ctx, table != nullptr,
+                errors::InvalidArgument("Table is not a HashEmbeddingTable"));
+
+    const Tensor& min_frequency = ctx->input(1);
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(min_frequency.shape()),
+                errors::InvalidArgument("min_frequency must be a scalar"));
+    Tensor* num_evicted;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("num_evicted", TensorShape({}),
+                                             &num_evicted));
+    num_evicted->scalar<int64>()() =
+        table->Evict(min_frequency.scalar<int64>()());
+  }
+};
+
+template <class K, class V>
+class HashEmbeddingExportOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    lookup::HashEmbeddingTable<K, V>* table;
+    OP_REQUIRES_OK(ctx, GetHashEmbeddingTable(ctx, &table));
+    core::ScopedUnref unref_me(table);
+    OP_REQUIRES_OK(ctx, table->ExportAll(ctx));
+  }
+};
+
+template <class K, class V>
+class HashEmbeddingImportOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    lookup::HashEmbeddingTable<K, V>* table;
+    OP_REQUIRES_OK(ctx, GetHashEmbeddingTable(ctx, &table));
+    core::ScopedUnref unref_me(table);
+    OP_REQUIRES(ctx, TensorShapeUtils::IsVector(ctx->input(1).shape()),
+                errors::InvalidArgument("keys must be one-dimensional"));
+    OP_REQUIRES_OK(ctx, table->ImportAll(ctx->input(1), ctx->input(2),
+                                        ctx->input(3), ctx->input(4)));
+  }
+};
+
+}  // namespace
+
+REGISTER_KERNEL_BUILDER(Name("HashEmbeddingEvict").Device(DEVICE_CPU),
+                        HashEmbeddingEvictOp);
+
+#define REGISTER_KERNELS(key_dtype, value_dtype)                              \
+  REGISTER_KERNEL_BUILDER(                                                    \
+      Name("HashEmbeddingTable")                                              \
+          .Device(DEVICE_CPU)                                                 \
+          .TypeConstraint<key_dtype>("key_dtype")                             \
+          .TypeConstraint<value_dtype>("value_dtype"),                        \
+      LookupTableOp<lookup::HashEmbeddingTable<key_dtype, value_dtype>,       \
+                    key_dtype, value_dtype>)                                  \
+  REGISTER_KERNEL_BUILDER(Name("HashEmbeddingLookup")                         \
+                              .Device(DEVICE_CPU)                             \
+                              .TypeConstraint<key_dtype>("Tkeys")             \
+                              .TypeConstraint<value_dtype>("Tvalues"),        \
+                          HashEmbeddingLookupOp<key_dtype, value_dtype>);     \
+  REGISTER_KERNEL_BUILDER(                                                    \
+      Name("HashEmbeddingSparseApplyAdagrad")                                 \
+          .Device(DEVICE_CPU)                                                 \
+          .TypeConstraint<value_dtype>("T")                                   \
+          .TypeConstraint<key_dtype>("Tindices"),                             \
+      HashEmbeddingSparseApplyAdagradOp<key_dtype, value_dtype>);             \
+  REGISTER_KERNEL_BUILDER(                                                    \
+      Name("HashEmbeddingSparseApplyFtrl")                                    \
+          .Device(DEVICE_CPU)                                                 \
+          .TypeConstraint<value_dtype>("T")                                   \
+          .TypeConstraint<key_dtype>("Tindices"),                             \
+      HashEmbeddingSparseApplyFtrlOp<key_dtype, value_dtype>);                \
+  REGISTER_KERNEL_BUILDER(Name("HashEmbeddingExport")                         \
+                              .Device(DEVICE_CPU)                             \
+                              .TypeConstraint<key_dtype>("Tkeys")             \
+                              .TypeConstraint<value_dtype>("Tvalues"),        \
+                          HashEmbeddingExportOp<key_dtype, value_dtype>);     \
+  REGISTER_KERNEL_BUILDER(Name("HashEmbeddingImport")                         \
+                              .Device(DEVICE_CPU)                             \
+                              .TypeConstraint<key_dtype>("Tkeys")             \
+                              .TypeConstraint<value_dtype>("Tvalues"),        \
+                          HashEmbeddingImportOp<key_dtype, value_dtype>);
+
+REGISTER_KERNELS(int32, float);
+REGISTER_KERNELS(int32, double);
+REGISTER_KERNELS(int64, float);
+REGISTER_KERNELS(int64, double);
+
+#undef REGISTER_KERNELS
+
+}  // namespace tensorflow
@@ -0,0 +1,386 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#if GOOGLE_CUDA
+#define EIGEN_USE_GPU
+#endif  // GOOGLE_CUDA
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/image/resize_bilinear_op.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/image_resizer_state.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+#if GOOGLE_CUDA
+#include <unordered_map>
+
+#include "third_party/gpus/cuda/include/nvjpeg.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/stream_executor/cuda/cuda_activation.h"
+#endif  // GOOGLE_CUDA
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+typedef Eigen::GpuDevice GPUDevice;
+
+namespace {
+
+struct Interpolation {
+  int64 lower;
+  int64 upper;
+  float lerp;
+};
+
+// Same weights as ResizeBilinear computes for its CPU kernel.
+template <typename Scaler>
+void ComputeInterpolation(const Scaler& scaler, int64 out_size, int64 in_size,
+                          float scale, std::vector<Interpolation>* out) {
+  out->resize(out_size);
+  for (int64 i = 0; i < out_size; ++i) {
+    const float in = scaler(i, scale);
+    const float in_f = std::floor(in);
+    Interpolation& interpolation = (*out)[i];
+    interpolation.lower = std::max(static_cast<int64>(in_f), int64{0});
+    interpolation.upper =
+        std::min(static_cast<int64>(std::ceil(in)), in_size - 1);
+    interpolation.lerp = in - in_f;
+  }
+}
+
+}  // namespace
+
+// Decodes a batch of JPEG images and bilinearly resizes each of them into its
+// slice of a float [batch, height, width, channels] output.
+template <typename Device>
+class DecodeAndResizeJpegBatchOp : public OpKernel {
+ public:
+  explicit DecodeAndResizeJpegBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, channels_ == 1 || channels_ == 3,
+                errors::InvalidArgument("channels must be 1 or 3, got ",
+                                        channels_));
+    OP_REQUIRES_OK(context, context->GetAttr("align_corners", &align_corners_));
+    OP_REQUIRES_OK(context, context->GetAttr("half_pixel_centers",
+                                             &half_pixel_centers_));
+    OP_REQUIRES(context, !(align_corners_ && half_pixel_centers_),
+                errors::InvalidArgument("If half_pixel_centers is True, "
+                                        "align_corners must be False."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(contents.shape()),
+                errors::InvalidArgument("contents must be a vector, got shape ",
+                                        contents.shape().DebugString()));
+    const Tensor& size = context->input(1);
+    OP_REQUIRES(context, size.dims() == 1 && size.dim_size(0) == 2,
+                errors::InvalidArgument("size must have two elements ",
+                                        size.shape().DebugString()));
+    const int64 out_height = size.vec<int32>()(0);
+    const int64 out_width = size.vec<int32>()(1);
+    OP_REQUIRES(context, out_height > 0 && out_width > 0,
+                errors::InvalidArgument("output dimensions must be positive"));
+
+    const int64 batch_size = contents.dim_size(0);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0,
+                       TensorShape({batch_size, out_height, out_width,
+                                    static_cast<int64>(channels_)}),
+                       &output));
+    if (batch_size == 0) return;
+
+    auto inputs = contents.vec<tstring>();
+    for (int64 b = 0; b < batch_size; ++b) {
+      OP_REQUIRES(
+          context, inputs(b).size() <= std::numeric_limits<int>::max(),
+          errors::InvalidArgument("JPEG contents are too large for int: ",
+                                  inputs(b).size()));
+    }
+    DecodeAndResize(context, inputs, output);
+  }
+
+ protected:
+  float ResizeScale(int64 in_size, int64 out_size) const {
+    return CalculateResizeScale(in_size, out_size, align_corners_);
+  }
+
+  void DecodeAndResize(OpKernelContext* context,
+                       TTypes<tstring>::ConstVec inputs, Tensor* output);
+
+  int channels_;
+  bool align_corners_;
+  bool half_pixel_centers_;
+};
+
+template <>
+void DecodeAndResizeJpegBatchOp<CPUDevice>::DecodeAndResize(
+    OpKernelContext* context, TTypes<tstring>::ConstVec inputs,
+    Tensor* output) {
+  const int64 out_height = output->dim_size(1);
+  const int64 out_width = output->dim_size(2);
+  const int64 image_size = out_height * out_width * channels_;
+  jpeg::UncompressFlags flags;
+  flags.components = channels_;
+
+  // Each shard decodes and resizes whole images, reusing one decode buffer for
+  // all of its images.
+  mutex status_mu;
+  Status status;
+  auto decode_images = [&](int64 start, int64 limit) {
+    std::vector<uint8> decoded;
+    std::vector<Interpolation> ys;
+    std::vector<Interpolation> xs;
+    for (int64 b = start; b < limit; ++b) {
+      const StringPiece input = inputs(b);
+      int64 height = 0;
+      int64 width = 0;
+      uint8* buffer = jpeg::Uncompress(
+          input.data(), input.size(), flags, nullptr /* nwarn */,
+          [&](int w, int h, int c) -> uint8* {
+            width = w;
+            height = h;
+            decoded.resize(static_cast<size_t>(w) * h * c);
+            return decoded.data();
+          });
+      if (buffer == nullptr) {
+        mutex_lock l(status_mu);
+        status.Update(errors::InvalidArgument(
+            "jpeg::Uncompress failed. Invalid JPEG data in element ", b));
+        return;
+      }
+
+      const float height_scale = ResizeScale(height, out_height);
+      const float width_scale = ResizeScale(width, out_width);
+      if (half_pixel_centers_) {
+        ComputeInterpolation(HalfPixelScaler(), out_height, height,
+                             height_scale, &ys);
+        ComputeInterpolation(HalfPixelScaler(), out_width, width, width_scale,
+                             &xs);
+      } else {
+        ComputeInterpolation(LegacyScaler(), out_height, height, height_scale,
+                             &ys);
+        ComputeInterpolation(LegacyScaler(), out_width, width, width_scale,
+                             &xs);
+      }
+
+      const int64 row_size = width * channels_;
+      float* out = output->flat<float>().data() + b * image_size;
+      for (int64 y = 0; y < out_height; ++y) {
+        const uint8* top = decoded.data() + ys[y].lower * row_size;
+        const uint8* bottom = decoded.data() + ys[y].upper * row_size;
+        const float y_lerp = ys[y].lerp;
+        for (int64 x = 0; x < out_width; ++x) {
+          const int64 left = xs[x].lower * channels_;
+          const int64 right = xs[x].upper * channels_;
+          const float x_lerp = xs[x].lerp;
+          for (int64 c = 0; c < channels_; ++c) {
+            const float top_value =
+                top[left + c] + (top[right + c] - top[left + c]) * x_lerp;
+            const float bottom_value =
+                bottom[left + c] +
+                (bottom[right + c] - bottom[left + c]) * x_lerp;
+            *out++ = top_value + (bottom_value - top_value) * y_lerp;
+          }
+        }
+      }
+    }
+  };
+  auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+  // Decoding dominates, and costs roughly a few hundred cycles per output
+  // pixel at typical downscaling ratios.
+  Shard(worker_threads.num_threads, worker_threads.workers, inputs.size(),
+        500 * image_size, decode_images);
+  OP_REQUIRES_OK(context, status);
+}
+
+REGISTER_KERNEL_BUILDER(Name("DecodeAndResizeJpegBatch").Device(DEVICE_CPU),
+                        DecodeAndResizeJpegBatchOp<CPUDevice>);
+
+#if GOOGLE_CUDA
+
+namespace {
+
+Status NvjpegStatus(nvjpegStatus_t status, const char* what) {
+  if (status == NVJPEG_STATUS_SUCCESS) return Status::OK();
+  return errors::Internal(what, " failed with nvjpeg status ",
+                          static_cast<int>(status));
+}
+
+// An nvjpeg library handle and the decoder state used with it. nvjpeg
+// decodes one image at a time per state, so users hold `mu` while decoding.
+// We maintain one instance per unique stream.
+class NvjpegHandles {
+ public:
+  NvjpegHandles() = default;
+
+  ~NvjpegHandles() {
+    if (state_ != nullptr) nvjpegJpegStateDestroy(state_);
+    if (handle_ != nullptr) nvjpegDestroy(handle_);
+  }
+
+  Status Initialize() {
+    TF_RETURN_IF_ERROR(
+        NvjpegStatus(nvjpegCreateSimple(&handle_), "nvjpegCreateSimple"));
+    return NvjpegStatus(nvjpegJpegStateCreate(handle_, &state_),
+                        "nvjpegJpegStateCreate");
+  }
+
+  nvjpegHandle_t handle() const { return handle_; }
+  nvjpegJpegState_t state() const { return state_; }
+  mutex& mu() { return mu_; }
+
+ private:
+  nvjpegHandle_t handle_ = nullptr;
+  nvjpegJpegState_t state_ = nullptr;
+  mutex mu_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(NvjpegHandles);
+};
+
+static mutex handle_map_mutex(LINKER_INITIALIZED);
+
+using HandleMap =
+    std::unordered_map<cudaStream_t, std::unique_ptr<NvjpegHandles>>;
+
+// Returns a singleton map used for storing initialized handles for each unique
+// cuda stream.
+HandleMap* GetHandleMapSingleton() {
+  static HandleMap* cm = new HandleMap;
+  return cm;
+}
+
+Status GetNvjpegHandles(cudaStream_t stream, NvjpegHandles** handles) {
+  HandleMap* handle_map = GetHandleMapSingleton();
+  mutex_lock lock(handle_map_mutex);
+  auto it = handle_map->find(stream);
+  if (it == handle_map->end()) {
+    VLOG(1) << "Creating nvjpeg handles for stream " << stream;
+    auto new_handles = std::make_unique<NvjpegHandles>();
+    TF_RETURN_IF_ERROR(new_handles->Initialize());
+    it = handle_map->emplace(stream, std::move(new_handles)).first;
+  }
+  *handles = it->second.get();
+  return Status::OK();
+}
+
+}  // namespace
+
+// Decodes with nvjpeg on the op's compute stream and resizes with the
+// ResizeBilinear GPU functor, so only the encoded bytes are read on the host.
+template <>
+void DecodeAndResizeJpegBatchOp<GPUDevice>::DecodeAndResize(
+    OpKernelContext* context, TTypes<tstring>::ConstVec inputs,
+    Tensor* output) {
+  se::Stream* stream = context->op_device_context()->stream();
+  OP_REQUIRES(context, stream, errors::Internal("No GPU stream available."));
+  se::cuda::ScopedActivateExecutorContext scoped_activation{stream->parent()};
+  const cudaStream_t cu_stream = *reinterpret_cast<const cudaStream_t*>(
+      stream->implementation()->GpuStreamMemberHack());
+  NvjpegHandles* handles = nullptr;
+  OP_REQUIRES_OK(context, GetNvjpegHandles(cu_stream, &handles));
+
+  const int64 batch_size = inputs.size();
+  std::vector<int> heights(batch_size);
+  std::vector<int> widths(batch_size);
+  int64 max_decoded_size = 0;
+  for (int64 b = 0; b < batch_size; ++b) {
+    const StringPiece input = inputs(b);
+    int num_components;
+    nvjpegChromaSubsampling_t subsampling;
+    int component_widths[NVJPEG_MAX_COMPONENT];
+    int component_heights[NVJPEG_MAX_COMPONENT];
+    OP_REQUIRES(
+        context,
+        nvjpegGetImageInfo(handles->handle(),
+                           reinterpret_cast<const unsigned char*>(input.data()),
+                           input.size(), &num_components, &subsampling,
+                           component_widths,
+                           component_heights) == NVJPEG_STATUS_SUCCESS,
+        errors::InvalidArgument("Invalid JPEG data in element ", b));
+    widths[b] = component_widths[0];
+    heights[b] = component_heights[0];
+    max_decoded_size = std::max(
+        max_decoded_size, static_cast<int64>(widths[b]) * heights[b]);
+  }
+
+  // Every image is decoded into the same scratch buffer: nvjpeg and the resize
+  // kernels are ordered on the compute stream, so an image is only
+  // overwritten after it has been resized.
+  Tensor decoded;
+  OP_REQUIRES_OK(context,
+                 context->allocate_temp(
+                     DT_UINT8, TensorShape({max_decoded_size * channels_}),
+                     &decoded));
+  uint8* decoded_data = decoded.flat<uint8>().data();
+  const nvjpegOutputFormat_t format =
+      channels_ == 3 ? NVJPEG_OUTPUT_RGBI : NVJPEG_OUTPUT_Y;
+  const int64 out_height = output->dim_size(1);
+  const int64 out_width = output->dim_size(2);
+  const int64 image_size = out_height * out_width * channels_;
+  const GPUDevice& d = context->eigen_device<GPUDevice>();
+
+  mutex_lock lock(handles->mu());
+  for (int64 b = 0; b < batch_size; ++b) {
+    const StringPiece input = inputs(b);
+    nvjpegImage_t destination = {};
+    destination.channel[0] = decoded_data;
+    destination.pitch[0] = widths[b] * channels_;
+    OP_REQUIRES_OK(
+        context,
+        NvjpegStatus(
+            nvjpegDecode(handles->handle(), handles->state(),
+                         reinterpret_cast<const unsigned char*>(input.data()),
+                         input.size(), format, &destination, cu_stream),
+            "nvjpegDecode"));
+
+    TTypes<uint8, 4>::ConstTensor image(decoded_data, 1, heights[b],
+                                                 widths[b], channels_);
+    TTypes<float, 4>::Tensor resized(
+        output->flat<float>().data() + b * image_size, 1, out_height,
+        out_width, channels_);
+    functor::ResizeBilinear<GPUDevice, uint8>()(
+        d, image, ResizeScale(heights[b], out_height),
+        ResizeScale(widths[b], out_width), half_pixel_centers_, resized);
+  }
+}
+
+REGISTER_KERNEL_BUILDER(Name("DecodeAndResizeJpegBatch")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("contents")
+                            .HostMemory("size"),
+                        DecodeAndResizeJpegBatchOp<GPUDevice>);
+
+#endif  // GOOGLE_CUDA
+
+}  // namespace tensorflow
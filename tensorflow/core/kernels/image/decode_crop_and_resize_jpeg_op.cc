@@ -0,0 +1,261 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/image_resizer_state.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Interpolation weights of one output row or column.
+struct Interpolation {
+  int64 lower;
+  int64 upper;
+  float lerp;
+};
+
+// Computes the weights with which `out_size` outputs sample a crop of
+// `crop_size` pixels at `crop_start` of the original image, when it was
+// decoded at 1/`ratio` scale into `decoded_size` pixels at `decoded_start`.
+// With ratio = 1 these are the weights of ResizeBilinear over the crop.
+template <typename Scaler>
+void ComputeInterpolation(const Scaler& scaler, int64 out_size,
+                          int64 crop_start, int64 crop_size,
+                          int64 decoded_start, int64 decoded_size, int ratio,
+                          bool align_corners, std::vector<Interpolation>* out) {
+  const float scale = CalculateResizeScale(crop_size, out_size, align_corners);
+  // A decoded pixel averages `ratio` original ones, so its center is at
+  // (ratio - 1) / 2 in their coordinates. The offset is exact, which keeps
+  // ratio = 1 bit-identical to resizing the decoded crop.
+  const float offset = crop_start - ratio * decoded_start - 0.5f * (ratio - 1);
+  out->resize(out_size);
+  for (int64 i = 0; i < out_size; ++i) {
+    const float in = (scaler(i, scale) + offset) / ratio;
+    const float in_f = std::floor(in);
+    Interpolation& interpolation = (*out)[i];
+    interpolation.lower = std::min(
+        std::max(static_cast<int64>(in_f), int64{0}), decoded_size - 1);
+    interpolation.upper = std::min(
+        std::max(static_cast<int64>(std::ceil(in)), int64{0}),
+        decoded_size - 1);
+    interpolation.lerp = in - in_f;
+  }
+}
+
+}  // namespace
+
+// Decodes a crop of a JPEG image at the smallest DCT scale that still covers
+// the output size, and resizes it bilinearly. Equivalent to DecodeAndCropJpeg
+// followed by ResizeBilinear, up to the filtering of the DCT scaling.
+class DecodeCropAndResizeJpegOp : public OpKernel {
+ public:
+  explicit DecodeCropAndResizeJpegOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, channels_ == 0 || channels_ == 1 || channels_ == 3,
+                errors::InvalidArgument("channels must be 0, 1, or 3, got ",
+                                        channels_));
+    OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
+                                             &flags_.fancy_upscaling));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("try_recover_truncated",
+                                    &flags_.try_recover_truncated_jpeg));
+    OP_REQUIRES_OK(context, context->GetAttr("acceptable_fraction",
+                                             &flags_.min_acceptable_fraction));
+    string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        errors::InvalidArgument("dct_method must be one of "
+                                "{'', 'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    flags_.dct_method =
+        dct_method == "INTEGER_ACCURATE" ? JDCT_ISLOW : JDCT_IFAST;
+    flags_.components = channels_;
+    OP_REQUIRES_OK(context, context->GetAttr("align_corners", &align_corners_));
+    OP_REQUIRES_OK(context, context->GetAttr("half_pixel_centers",
+                                             &half_pixel_centers_));
+    OP_REQUIRES(context, !(align_corners_ && half_pixel_centers_),
+                errors::InvalidArgument("If half_pixel_centers is True, "
+                                        "align_corners must be False."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsScalar(contents.shape()),
+                errors::InvalidArgument("contents must be scalar, got shape ",
+                                        contents.shape().DebugString()));
+    const StringPiece input = contents.scalar<tstring>()();
+    OP_REQUIRES(context, input.size() <= std::numeric_limits<int>::max(),
+                errors::InvalidArgument("JPEG contents are too large for int: ",
+                                        input.size()));
+    const Tensor& crop_window = context->input(1);
+    OP_REQUIRES(context,
+                crop_window.dims() == 1 && crop_window.dim_size(0) == 4,
+                errors::InvalidArgument("crop_window must have four elements ",
+                                        crop_window.shape().DebugString()));
+    const Tensor& size = context->input(2);
+    OP_REQUIRES(context, size.dims() == 1 && size.dim_size(0) == 2,
+                errors::InvalidArgument("size must have two elements ",
+                                        size.shape().DebugString()));
+    const int64 out_height = size.vec<int32>()(0);
+    const int64 out_width = size.vec<int32>()(1);
+    OP_REQUIRES(context, out_height > 0 && out_width > 0,
+                errors::InvalidArgument("output dimensions must be positive"));
+
+    int width, height;
+    OP_REQUIRES(context,
+                jpeg::GetImageInfo(input.data(), input.size(), &width, &height,
+                                   nullptr),
+                errors::InvalidArgument("Invalid JPEG data, size ",
+                                        input.size()));
+    auto crop_window_vec = crop_window.vec<int32>();
+    const int64 crop_y = crop_window_vec(0);
+    const int64 crop_x = crop_window_vec(1);
+    const int64 crop_height = crop_window_vec(2);
+    const int64 crop_width = crop_window_vec(3);
+    OP_REQUIRES(context,
+                crop_height > 0 && crop_width > 0 && crop_y >= 0 &&
+                    crop_x >= 0 && crop_y + crop_height <= height &&
+                    crop_x + crop_width <= width,
+                errors::InvalidArgument(
+                    "Invalid crop window: ", crop_window.DebugString(),
+                    " for image of size ", height, "x", width));
+
+    // Decoding at 1/ratio scale skips the inverse DCT of the dropped
+    // frequencies; pick the smallest scale that does not go below the output
+    // size.
+    int ratio = 8;
+    while (ratio > 1 && (crop_height < ratio * out_height ||
+                         crop_width < ratio * out_width)) {
+      ratio /= 2;
+    }
+    // libjpeg rounds scaled dimensions up.
+    const int64 scaled_height = (height + ratio - 1) / ratio;
+    const int64 scaled_width = (width + ratio - 1) / ratio;
+    jpeg::UncompressFlags flags = flags_;
+    flags.ratio = ratio;
+    flags.crop = true;
+    flags.crop_y = crop_y / ratio;
+    flags.crop_x = crop_x / ratio;
+    flags.crop_height =
+        std::min((crop_y + crop_height + ratio - 1) / ratio, scaled_height) -
+        flags.crop_y;
+    flags.crop_width =
+        std::min((crop_x + crop_width + ratio - 1) / ratio, scaled_width) -
+        flags.crop_x;
+
+    Tensor decoded;
+    uint8* buffer = jpeg::Uncompress(
+        input.data(), input.size(), flags, nullptr /* nwarn */,
+        [&](int width, int height, int channels) -> uint8* {
+          Status status =
+              context->allocate_temp(DT_UINT8,
+                                     TensorShape({height, width, channels}),
+                                     &decoded);
+          if (!status.ok()) {
+            VLOG(1) << status;
+            context->SetStatus(status);
+            return nullptr;
+          }
+          return decoded.flat<uint8>().data();
+        });
+    OP_REQUIRES(
+        context, buffer,
+        errors::InvalidArgument(
+            "jpeg::Uncompress failed. Invalid JPEG data or crop window."));
+
+    const int64 decoded_height = decoded.dim_size(0);
+    const int64 decoded_width = decoded.dim_size(1);
+    const int64 channels = decoded.dim_size(2);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({out_height, out_width, channels}),
+                       &output));
+
+    std::vector<Interpolation> ys;
+    std::vector<Interpolation> xs;
+    if (half_pixel_centers_) {
+      ComputeInterpolation(HalfPixelScaler(), out_height, crop_y, crop_height,
+                           flags.crop_y, decoded_height, ratio, align_corners_,
+                           &ys);
+      ComputeInterpolation(HalfPixelScaler(), out_width, crop_x, crop_width,
+                           flags.crop_x, decoded_width, ratio, align_corners_,
+                           &xs);
+    } else {
+      ComputeInterpolation(LegacyScaler(), out_height, crop_y, crop_height,
+                           flags.crop_y, decoded_height, ratio, align_corners_,
+                           &ys);
+      ComputeInterpolation(LegacyScaler(), out_width, crop_x, crop_width,
+                           flags.crop_x, decoded_width, ratio, align_corners_,
+                           &xs);
+    }
+
+    const uint8* image = decoded.flat<uint8>().data();
+    float* resized = output->flat<float>().data();
+    const int64 row_size = decoded_width * channels;
+    auto resize_rows = [&](int64 start, int64 limit) {
+      for (int64 y = start; y < limit; ++y) {
+        const uint8* top = image + ys[y].lower * row_size;
+        const uint8* bottom = image + ys[y].upper * row_size;
+        const float y_lerp = ys[y].lerp;
+        float* out = resized + y * out_width * channels;
+        for (int64 x = 0; x < out_width; ++x) {
+          const int64 left = xs[x].lower * channels;
+          const int64 right = xs[x].upper * channels;
+          const float x_lerp = xs[x].lerp;
+          for (int64 c = 0; c < channels; ++c) {
+            const float top_value =
+                top[left + c] + (top[right + c] - top[left + c]) * x_lerp;
+            const float bottom_value =
+                bottom[left + c] +
+                (bottom[right + c] - bottom[left + c]) * x_lerp;
+            *out++ = top_value + (bottom_value - top_value) * y_lerp;
+          }
+        }
+      }
+    };
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers, out_height,
+          10 * out_width * channels, resize_rows);
+  }
+
+ private:
+  int channels_;
+  jpeg::UncompressFlags flags_;
+  bool align_corners_;
+  bool half_pixel_centers_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("DecodeCropAndResizeJpeg").Device(DEVICE_CPU),
+                        DecodeCropAndResizeJpegOp);
+
+}  // namespace tensorflow
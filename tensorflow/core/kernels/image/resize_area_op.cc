@@ -184,15 +184,16 @@ class ResizeAreaOp : public OpKernel {
           Bound(x_interp.end - 1, st.in_width) != (x_interp.end - 1);
     }
 
+    const CPUDevice& d = context->eigen_device<CPUDevice>();
     if (st.channels == 3) {
-      ComputeLoop<3>(st, x_interps, input_data);
+      ComputeLoop<3>(d, st, x_interps, input_data);
     } else {
-      ComputeLoop<-1>(st, x_interps, input_data);
+      ComputeLoop<-1>(d, st, x_interps, input_data);
     }
   }
 
   template <int64 kKnownNumChannels>
-  void ComputeLoop(const ImageResizerState& st,
+  void ComputeLoop(const CPUDevice& d, const ImageResizerState& st,
                    const std::vector<CachedInterpolation>& x_interps,
                    typename TTypes<T, 4>::ConstTensor input_data) {
     TTypes<float, 4>::Tensor output_data = st.output->tensor<float, 4>();
@@ -217,12 +218,17 @@ class ResizeAreaOp : public OpKernel {
     //   out[1] = (in[1] * 2/3 + in[2] * 2/3 * scale
     //   out[2] = (in[3] * 1/3 + in[3] * 1.0) * scale
     const T* const input_ptr = input_data.data();
-    std::vector<float> y_scales;
-    std::vector<const T*> y_ptrs;
-    float scale = 1.0 / (st.height_scale * st.width_scale);
-    float* output_ptr = output_data.data();
-    for (int64 b = 0; b < st.batch_size; ++b) {
-      for (int64 y = 0; y < st.out_height; ++y) {
+    const float scale = 1.0 / (st.height_scale * st.width_scale);
+    float* const output_data_ptr = output_data.data();
+    const int64 out_row_size = st.out_width * st.channels;
+    // Output rows are independent, so rows of all the images in the batch are
+    // computed in parallel.
+    auto compute_rows = [&](int64 start, int64 end) {
+      std::vector<float> y_scales;
+      std::vector<const T*> y_ptrs;
+      for (int64 row = start; row < end; ++row) {
+        const int64 b = row / st.out_height;
+        const int64 y = row % st.out_height;
         const float in_y = y * st.height_scale;
         const float in_y1 = (y + 1) * st.height_scale;
         // The start and end height indices of all the cells that could
@@ -245,6 +251,7 @@ class ResizeAreaOp : public OpKernel {
                            Bound(i, st.in_height) * st.in_width * st.channels));
         }
 
+        float* output_ptr = output_data_ptr + row * out_row_size;
         if (kKnownNumChannels == 3) {
           for (int64 x = 0; x < st.out_width; ++x) {
             const CachedInterpolation& x_interp = x_interps[x];
@@ -271,7 +278,18 @@ class ResizeAreaOp : public OpKernel {
           }
         }
       }
-    }
+    };
+    // Each output value sums a patch of at most (height_scale + 1) *
+    // (width_scale + 1) input cells, counting the partially covered ones.
+    const double patch_size = (st.height_scale + 1) * (st.width_scale + 1);
+    const Eigen::TensorOpCost cost_per_row(
+        /*bytes_loaded=*/out_row_size * patch_size * sizeof(T),
+        /*bytes_stored=*/out_row_size * sizeof(float),
+        /*compute_cycles=*/out_row_size * patch_size *
+            (Eigen::TensorOpCost::CastCost<T, float>() +
+             Eigen::TensorOpCost::AddCost<float>() +
+             Eigen::TensorOpCost::MulCost<float>()));
+    d.parallelFor(st.batch_size * st.out_height, cost_per_row, compute_rows);
   }
 
  private:
@@ -220,14 +220,15 @@ void ResizeLine3ChannelsVector(const T* const ys_input_lower_ptr,
 
 template <typename T>
 void resize_image(
-    typename TTypes<T, 4>::ConstTensor images, const int batch_size,
-    const int64 in_height, const int64 in_width, const int64 out_height,
-    const int64 out_width, const int channels,
+    const CPUDevice& d, typename TTypes<T, 4>::ConstTensor images,
+    const int batch_size, const int64 in_height, const int64 in_width,
+    const int64 out_height, const int64 out_width, const int channels,
     const std::vector<CachedInterpolation>& xs,
     const std::vector<CachedInterpolation>& ys,
     typename TTypes<float, 4>::Tensor output) TF_ATTRIBUTE_NOINLINE;
 template <typename T>
-void resize_image(typename TTypes<T, 4>::ConstTensor images,
+void resize_image(const CPUDevice& d,
+                  typename TTypes<T, 4>::ConstTensor images,
                   const int batch_size, const int64 in_height,
                   const int64 in_width, const int64 out_height,
                   const int64 out_width, const int channels,
@@ -238,52 +239,55 @@ void resize_image(typename TTypes<T, 4>::ConstTensor images,
   const int64 in_batch_num_values = in_height * in_row_size;
   const int64 out_row_size = out_width * channels;
 
-  const T* input_b_ptr = images.data();
+  const T* input_ptr = images.data();
+  float* output_ptr = output.data();
   const CachedInterpolation* xs = xs_vec.data();
 
-  if (channels == 3) {
-    float* output_y_ptr = output.data();
-    for (int b = 0; b < batch_size; ++b) {
-      for (int64 y = 0; y < out_height; ++y) {
-        const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
-        const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
+  // Each output row only reads two input rows, so rows of all the images in
+  // the batch are resized in parallel.
+  auto resize_rows = [&](int64 start, int64 end) {
+    for (int64 row = start; row < end; ++row) {
+      const int64 y = row % out_height;
+      const T* input_b_ptr =
+          input_ptr + (row / out_height) * in_batch_num_values;
+      const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
+      const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
+      const float ys_lerp = ys[y].lerp;
+      float* output_y_ptr = output_ptr + row * out_row_size;
+      if (channels == 3) {
 #ifdef __SSE4_1__
         ResizeLine3ChannelsVector(ys_input_lower_ptr, ys_input_upper_ptr, xs,
-                                  ys[y].lerp, out_width, output_y_ptr);
+                                  ys_lerp, out_width, output_y_ptr);
 #else
         ResizeLine3Channels(ys_input_lower_ptr, ys_input_upper_ptr, xs,
-                            ys[y].lerp, out_width, output_y_ptr);
+                            ys_lerp, out_width, output_y_ptr);
 #endif
-        output_y_ptr += out_row_size;
+        continue;
       }
-      input_b_ptr += in_batch_num_values;
-    }
-  } else {
-    float* output_y_ptr = output.data();
-    for (int b = 0; b < batch_size; ++b) {
-      for (int64 y = 0; y < out_height; ++y) {
-        const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
-        const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
-        const float ys_lerp = ys[y].lerp;
-        for (int64 x = 0; x < out_width; ++x) {
-          auto xs_lower = xs[x].lower;
-          auto xs_upper = xs[x].upper;
-          auto xs_lerp = xs[x].lerp;
-          for (int c = 0; c < channels; ++c) {
-            const float top_left(ys_input_lower_ptr[xs_lower + c]);
-            const float top_right(ys_input_lower_ptr[xs_upper + c]);
-            const float bottom_left(ys_input_upper_ptr[xs_lower + c]);
-            const float bottom_right(ys_input_upper_ptr[xs_upper + c]);
-            output_y_ptr[x * channels + c] =
-                compute_lerp(top_left, top_right, bottom_left, bottom_right,
-                             xs_lerp, ys_lerp);
-          }
+      for (int64 x = 0; x < out_width; ++x) {
+        auto xs_lower = xs[x].lower;
+        auto xs_upper = xs[x].upper;
+        auto xs_lerp = xs[x].lerp;
+        for (int c = 0; c < channels; ++c) {
+          const float top_left(ys_input_lower_ptr[xs_lower + c]);
+          const float top_right(ys_input_lower_ptr[xs_upper + c]);
+          const float bottom_left(ys_input_upper_ptr[xs_lower + c]);
+          const float bottom_right(ys_input_upper_ptr[xs_upper + c]);
+          output_y_ptr[x * channels + c] =
+              compute_lerp(top_left, top_right, bottom_left, bottom_right,
+                           xs_lerp, ys_lerp);
         }
-        output_y_ptr += out_row_size;
       }
-      input_b_ptr += in_batch_num_values;
     }
-  }
+  };
+  const Eigen::TensorOpCost cost_per_row(
+      /*bytes_loaded=*/out_row_size * 4 * sizeof(T),
+      /*bytes_stored=*/out_row_size * sizeof(float),
+      /*compute_cycles=*/out_row_size *
+          (Eigen::TensorOpCost::CastCost<T, float>() * 4 +
+           Eigen::TensorOpCost::AddCost<float>() * 6 +
+           Eigen::TensorOpCost::MulCost<float>() * 3));
+  d.parallelFor(batch_size * out_height, cost_per_row, resize_rows);
 }
 
 // Casts from float16 to T.
@@ -352,7 +356,7 @@ struct ResizeBilinear<CPUDevice, T> {
       xs[i].upper *= channels;
     }
 
-    resize_image<T>(images, batch_size, in_height, in_width, out_height,
+    resize_image<T>(d, images, batch_size, in_height, in_width, out_height,
                     out_width, channels, xs, ys, output);
   }
 };
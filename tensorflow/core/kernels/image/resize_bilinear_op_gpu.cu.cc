@@ -524,6 +524,8 @@ struct ResizeBilinearGrad<GPUDevice, T> {
 #define DEFINE_GPU_SPEC(T) template struct ResizeBilinear<GPUDevice, T>;
 
 TF_CALL_GPU_NUMBER_TYPES(DEFINE_GPU_SPEC);
+// Used by DecodeAndResizeJpegBatch on decoded images.
+TF_CALL_uint8(DEFINE_GPU_SPEC);
 
 #define DEFINE_GRAD_GPU_SPEC(T) \
   template struct ResizeBilinearGrad<GPUDevice, T>;
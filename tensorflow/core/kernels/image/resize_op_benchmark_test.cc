@@ -21,11 +21,15 @@ limitations under the License.
 
 namespace tensorflow {
 
-static Graph* Resize(const char* algorithm, int batches, int width,
-                     int height) {
+static Graph* Resize(const char* algorithm, DataType dtype, int batches,
+                     int width, int height) {
   Graph* g = new Graph(OpRegistry::Global());
-  Tensor in(DT_FLOAT, TensorShape({batches, width, height, 3}));
-  in.flat<float>().setRandom();
+  Tensor in(dtype, TensorShape({batches, width, height, 3}));
+  if (dtype == DT_UINT8) {
+    in.flat<uint8>().setRandom();
+  } else {
+    in.flat<float>().setRandom();
+  }
 
   Tensor out_size(DT_INT32, TensorShape({2}));
   auto out_size_flat = out_size.flat<int32>();
@@ -41,18 +45,33 @@ static Graph* Resize(const char* algorithm, int batches, int width,
   return g;
 }
 
-#define BM_ResizeDev(DEVICE, ALGORITHM, B, W, H)                  \
-  static void BM_Resize_##ALGORITHM##_##DEVICE##_##B##_##W##_##H( \
-      ::testing::benchmark::State& state) {                       \
-    test::Benchmark(#DEVICE, Resize(#ALGORITHM, B, W, H),         \
-                    /*old_benchmark_api*/ false)                  \
-        .Run(state);                                              \
-    state.SetItemsProcessed(state.iterations() * B * W * H * 3);  \
-  }                                                               \
+#define BM_ResizeDev(DEVICE, ALGORITHM, B, W, H)                    \
+  static void BM_Resize_##ALGORITHM##_##DEVICE##_##B##_##W##_##H(   \
+      ::testing::benchmark::State& state) {                         \
+    test::Benchmark(#DEVICE, Resize(#ALGORITHM, DT_FLOAT, B, W, H), \
+                    /*old_benchmark_api*/ false)                    \
+        .Run(state);                                                \
+    state.SetItemsProcessed(state.iterations() * B * W * H * 3);    \
+  }                                                                 \
   BENCHMARK(BM_Resize_##ALGORITHM##_##DEVICE##_##B##_##W##_##H)
 
+// Resizes of uint8 images, as decoded from JPEG or PNG.
+#define BM_ResizeDevUint8(DEVICE, ALGORITHM, B, W, H)                  \
+  static void BM_ResizeUint8_##ALGORITHM##_##DEVICE##_##B##_##W##_##H( \
+      ::testing::benchmark::State& state) {                            \
+    test::Benchmark(#DEVICE, Resize(#ALGORITHM, DT_UINT8, B, W, H),    \
+                    /*old_benchmark_api*/ false)                       \
+        .Run(state);                                                   \
+    state.SetItemsProcessed(state.iterations() * B * W * H * 3);       \
+  }                                                                    \
+  BENCHMARK(BM_ResizeUint8_##ALGORITHM##_##DEVICE##_##B##_##W##_##H)
+
 BM_ResizeDev(cpu, ResizeNearestNeighbor, 10, 499, 499);
 BM_ResizeDev(cpu, ResizeBilinear, 10, 499, 499);
+BM_ResizeDev(cpu, ResizeArea, 10, 499, 499);
+BM_ResizeDev(cpu, ResizeBilinear, 1, 499, 499);
+BM_ResizeDevUint8(cpu, ResizeBilinear, 10, 499, 499);
+BM_ResizeDevUint8(cpu, ResizeArea, 10, 499, 499);
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 BM_ResizeDev(gpu, ResizeNearestNeighbor, 10, 499, 499);
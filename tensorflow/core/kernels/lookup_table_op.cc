@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#include <functional>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -24,17 +25,20 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/kernels/initializable_lookup_table.h"
+#include "tensorflow/core/kernels/sharded_hash_map.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
 
 namespace tensorflow {
 namespace lookup {
 
-// Lookup table that wraps an unordered_map, where the key and value data type
+// Lookup table that wraps a ShardedHashMap, where the key and value data type
 // is specified. Each individual value must be a scalar. If vector values are
 // required, use MutableHashTableOfTensors.
 //
 // This table is mutable and thread safe - Insert can be called at any time.
+// Keys are spread over independently locked shards, so concurrent Find and
+// Insert calls only contend on keys that share a shard.
 //
 // Sample use case:
 //
@@ -49,10 +53,7 @@ class MutableHashTableOfScalars final : public LookupInterface {
  public:
   MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
 
-  size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
-  }
+  size_t size() const override { return table_.size(); }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
               const Tensor& default_value) override {
@@ -64,7 +65,6 @@ class MutableHashTableOfScalars final : public LookupInterface {
     int64 default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
-    tf_shared_lock l(mu_);
     for (int64 i = 0; i < key_values.size(); ++i) {
       // is_full_size_default is true:
       //   Each key has an independent default value, key_values(i)
@@ -72,9 +72,11 @@ class MutableHashTableOfScalars final : public LookupInterface {
       //
       // is_full_size_default is false:
       //   All keys will share the default_flat(0) as default value.
-      value_values(i) = gtl::FindWithDefault(
-          table_, SubtleMustCopyIfIntegral(key_values(i)),
-          is_full_size_default ? default_flat(i) : default_flat(0));
+      if (!table_.Find(SubtleMustCopyIfIntegral(key_values(i)),
+                       &value_values(i))) {
+        value_values(i) =
+            is_full_size_default ? default_flat(i) : default_flat(0);
+      }
     }
 
     return Status::OK();
@@ -84,13 +86,18 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = keys.flat<K>();
     const auto value_values = values.flat<V>();
 
-    mutex_lock l(mu_);
     if (clear) {
-      table_.clear();
+      table_.Assign([&](const std::function<void(const K&, V)>& insert) {
+        for (int64 i = 0; i < key_values.size(); ++i) {
+          insert(SubtleMustCopyIfIntegral(key_values(i)),
+                 SubtleMustCopyIfIntegral(value_values(i)));
+        }
+      });
+      return Status::OK();
     }
     for (int64 i = 0; i < key_values.size(); ++i) {
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          SubtleMustCopyIfIntegral(value_values(i)));
+      table_.InsertOrUpdate(SubtleMustCopyIfIntegral(key_values(i)),
+                            SubtleMustCopyIfIntegral(value_values(i)));
     }
     return Status::OK();
   }
@@ -103,9 +110,8 @@ class MutableHashTableOfScalars final : public LookupInterface {
   Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
     for (int64 i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
+      table_.Erase(SubtleMustCopyIfIntegral(key_values(i)));
     }
     return Status::OK();
   }
@@ -116,24 +122,25 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64 size = table_.size();
-
-    Tensor* keys;
-    Tensor* values;
-    TF_RETURN_IF_ERROR(
-        ctx->allocate_output("keys", TensorShape({size}), &keys));
-    TF_RETURN_IF_ERROR(
-        ctx->allocate_output("values", TensorShape({size}), &values));
-
-    auto keys_data = keys->flat<K>();
-    auto values_data = values->flat<V>();
+    Status status;
+    Tensor* keys = nullptr;
+    Tensor* values = nullptr;
     int64 i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      keys_data(i) = it->first;
-      values_data(i) = it->second;
-    }
-    return Status::OK();
+    table_.ForEach(
+        [&](size_t size) {
+          status.Update(ctx->allocate_output(
+              "keys", TensorShape({static_cast<int64>(size)}), &keys));
+          if (!status.ok()) return;
+          status.Update(ctx->allocate_output(
+              "values", TensorShape({static_cast<int64>(size)}), &values));
+        },
+        [&](const K& key, const V& value) {
+          if (!status.ok()) return;
+          keys->flat<K>()(i) = key;
+          values->flat<V>()(i) = value;
+          ++i;
+        });
+    return status;
   }
 
   DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
@@ -145,25 +152,15 @@ class MutableHashTableOfScalars final : public LookupInterface {
   TensorShape value_shape() const override { return TensorShape(); }
 
   int64 MemoryUsed() const override {
-    int64 ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
-      }
-    }
-    return sizeof(MutableHashTableOfScalars) + ret;
+    return sizeof(MutableHashTableOfScalars) +
+           table_.capacity() * (sizeof(K) + sizeof(V));
   }
 
  private:
-  mutable mutex mu_;
-  std::unordered_map<K, V> table_ TF_GUARDED_BY(mu_);
+  ShardedHashMap<K, V> table_;
 };
 
-// Lookup table that wraps an unordered_map. Behaves identical to
+// Lookup table that wraps a ShardedHashMap. Behaves identical to
 // MutableHashTableOfScalars except that each value must be a vector.
 template <class K, class V>
 class MutableHashTableOfTensors final : public LookupInterface {
@@ -177,10 +174,7 @@ class MutableHashTableOfTensors final : public LookupInterface {
                                 value_shape_.DebugString()));
   }
 
-  size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
-  }
+  size_t size() const override { return table_.size(); }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
               const Tensor& default_value) override {
@@ -193,15 +187,15 @@ class MutableHashTableOfTensors final : public LookupInterface {
     int64 default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
-    tf_shared_lock l(mu_);
     for (int64 i = 0; i < key_values.size(); ++i) {
-      ValueArray* value_vec =
-          gtl::FindOrNull(table_, SubtleMustCopyIfIntegral(key_values(i)));
-      if (value_vec != nullptr) {
-        for (int64 j = 0; j < value_dim; j++) {
-          value_values(i, j) = value_vec->at(j);
-        }
-      } else {
+      const bool found = table_.FindAndApply(
+          SubtleMustCopyIfIntegral(key_values(i)),
+          [&](const ValueArray& value_vec) {
+            for (int64 j = 0; j < value_dim; j++) {
+              value_values(i, j) = value_vec.at(j);
+            }
+          });
+      if (!found) {
         // is_full_size_default is true:
         //   Each key has an independent default value, key_values(i)
         //   corresponding uses default_flat(i) as its default value.
@@ -223,18 +217,26 @@ class MutableHashTableOfTensors final : public LookupInterface {
     const auto value_values = values.flat_inner_dims<V, 2>();
     int64 value_dim = value_shape_.dim_size(0);
 
-    mutex_lock l(mu_);
-    if (clear) {
-      table_.clear();
-    }
-    for (int64 i = 0; i < key_values.size(); ++i) {
+    auto make_value = [&](int64 i) {
       ValueArray value_vec;
       for (int64 j = 0; j < value_dim; j++) {
         V value = value_values(i, j);
         value_vec.push_back(value);
       }
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          value_vec);
+      return value_vec;
+    };
+    if (clear) {
+      table_.Assign(
+          [&](const std::function<void(const K&, ValueArray)>& insert) {
+            for (int64 i = 0; i < key_values.size(); ++i) {
+              insert(SubtleMustCopyIfIntegral(key_values(i)), make_value(i));
+            }
+          });
+      return Status::OK();
+    }
+    for (int64 i = 0; i < key_values.size(); ++i) {
+      table_.InsertOrUpdate(SubtleMustCopyIfIntegral(key_values(i)),
+                            make_value(i));
     }
     return Status::OK();
   }
@@ -247,9 +249,8 @@ class MutableHashTableOfTensors final : public LookupInterface {
   Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
     for (int64 i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
+      table_.Erase(SubtleMustCopyIfIntegral(key_values(i)));
     }
     return Status::OK();
   }
@@ -260,29 +261,31 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64 size = table_.size();
     int64 value_dim = value_shape_.dim_size(0);
 
-    Tensor* keys;
-    Tensor* values;
-    TF_RETURN_IF_ERROR(
-        ctx->allocate_output("keys", TensorShape({size}), &keys));
-    TF_RETURN_IF_ERROR(ctx->allocate_output(
-        "values", TensorShape({size, value_dim}), &values));
-
-    auto keys_data = keys->flat<K>();
-    auto values_data = values->matrix<V>();
+    Status status;
+    Tensor* keys = nullptr;
+    Tensor* values = nullptr;
     int64 i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      K key = it->first;
-      ValueArray value = it->second;
-      keys_data(i) = key;
-      for (int64 j = 0; j < value_dim; j++) {
-        values_data(i, j) = value[j];
-      }
-    }
-    return Status::OK();
+    table_.ForEach(
+        [&](size_t size) {
+          status.Update(ctx->allocate_output(
+              "keys", TensorShape({static_cast<int64>(size)}), &keys));
+          if (!status.ok()) return;
+          status.Update(ctx->allocate_output(
+              "values", TensorShape({static_cast<int64>(size), value_dim}),
+              &values));
+        },
+        [&](const K& key, const ValueArray& value) {
+          if (!status.ok()) return;
+          keys->flat<K>()(i) = key;
+          auto values_data = values->matrix<V>();
+          for (int64 j = 0; j < value_dim; j++) {
+            values_data(i, j) = value[j];
+          }
+          ++i;
+        });
+    return status;
   }
 
   DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
@@ -294,24 +297,14 @@ class MutableHashTableOfTensors final : public LookupInterface {
   TensorShape value_shape() const override { return value_shape_; }
 
   int64 MemoryUsed() const override {
-    int64 ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
-      }
-    }
-    return sizeof(MutableHashTableOfTensors) + ret;
+    return sizeof(MutableHashTableOfTensors) +
+           table_.capacity() * (sizeof(K) + sizeof(ValueArray));
   }
 
  private:
   TensorShape value_shape_;
-  mutable mutex mu_;
   typedef gtl::InlinedVector<V, 4> ValueArray;
-  std::unordered_map<K, ValueArray> table_ TF_GUARDED_BY(mu_);
+  ShardedHashMap<K, ValueArray> table_;
 };
 
 namespace {
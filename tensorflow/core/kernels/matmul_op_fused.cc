@@ -20,7 +20,8 @@ limitations under the License.
 //
 // Activation: Relu, Relu6, Elu, etc...
 //
-// Currently supported only on CPU device.
+// On GPU only MatMul + BiasAdd and MatMul + BiasAdd + Relu are supported, as a
+// single cublasLt matmul with a bias (and ReLU) epilogue.
 
 #ifndef TENSORFLOW_CORE_KERNELS_MATMUL_OP_FUSED_H_
 #define TENSORFLOW_CORE_KERNELS_MATMUL_OP_FUSED_H_
@@ -44,9 +45,19 @@ limitations under the License.
 #include "tensorflow/core/kernels/eigen_contraction_kernel.h"
 #endif
 
+#if GOOGLE_CUDA
+#include "third_party/gpus/cuda/include/cuda.h"
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/kernels/gpu_utils.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/tensor_float_32_utils.h"
+#endif  // GOOGLE_CUDA
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
+typedef Eigen::GpuDevice GPUDevice;
 
 template <typename Device, typename T>
 struct LaunchFusedMatMulOp {
@@ -145,6 +156,221 @@ struct LaunchFusedMatMulOp<CPUDevice, T> {
   };
 };
 
+#if GOOGLE_CUDA
+
+namespace {
+
+// Upper bound on the cublasLt workspace, used when picking an algorithm.
+constexpr int64 kBlasLtMaxWorkspaceSize = 1LL << 22;  // 4 MiB
+
+// Allocates the cublasLt workspace as temporary memory of the op.
+class BlasLtScratchAllocator : public se::ScratchAllocator {
+ public:
+  explicit BlasLtScratchAllocator(OpKernelContext* context)
+      : context_(context) {}
+
+  int64 GetMemoryLimitInBytes() override { return kBlasLtMaxWorkspaceSize; }
+
+  se::port::StatusOr<se::DeviceMemory<uint8>> AllocateBytes(
+      int64 byte_size) override {
+    Tensor temporary_memory;
+    TF_RETURN_IF_ERROR(context_->allocate_temp(
+        DT_UINT8, TensorShape({byte_size}), &temporary_memory));
+    // Hold the reference of the allocated tensors until the end of the
+    // allocator.
+    allocated_tensors_.push_back(temporary_memory);
+    return AsDeviceMemory(temporary_memory.flat<uint8>().data(),
+                          temporary_memory.flat<uint8>().size());
+  }
+
+ private:
+  OpKernelContext* context_;
+  std::vector<Tensor> allocated_tensors_;
+};
+
+// Identifies a cublasLt matmul plan. All fused matmuls are computed in the
+// column-major form C' = op(B') x op(A') of the row-major product.
+struct BlasLtMatmulKey {
+  int device_id;
+  uint64 m;
+  uint64 n;
+  uint64 k;
+  bool transpose_a;
+  bool transpose_b;
+  se::blas::Epilogue epilogue;
+  se::blas::ComputationType computation_type;
+
+  bool operator==(const BlasLtMatmulKey& other) const {
+    return device_id == other.device_id && m == other.m && n == other.n &&
+           k == other.k && transpose_a == other.transpose_a &&
+           transpose_b == other.transpose_b && epilogue == other.epilogue &&
+           computation_type == other.computation_type;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const BlasLtMatmulKey& key) {
+    return H::combine(std::move(h), key.device_id, key.m, key.n, key.k,
+                      key.transpose_a, key.transpose_b, key.epilogue,
+                      key.computation_type);
+  }
+};
+
+struct BlasLtMatmulPlanAndAlgorithm {
+  std::unique_ptr<se::blas::IBlasLtMatmulPlan> plan;
+  std::unique_ptr<se::blas::IBlasLtMatmulAlgorithm> algorithm;
+};
+
+// Process-wide cache of cublasLt plans and the algorithms picked for them, so
+// that plan creation and the algorithm heuristic run once per shape. Entries
+// are never evicted.
+class BlasLtMatmulPlanCache {
+ public:
+  static BlasLtMatmulPlanCache* GetInstance() {
+    static BlasLtMatmulPlanCache* instance = new BlasLtMatmulPlanCache;
+    return instance;
+  }
+
+  template <typename T>
+  Status Get(se::Stream* stream, const BlasLtMatmulKey& key,
+             const BlasLtMatmulPlanAndAlgorithm** entry) {
+    mutex_lock lock(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      *entry = it->second.get();
+      return Status::OK();
+    }
+
+    se::blas::BlasLtMatmulPlanParams params;
+    params.ab_type = se::blas::ToDataType<T>::value;
+    params.c_type = se::blas::ToDataType<T>::value;
+    params.computation_type = key.computation_type;
+    params.pointer_mode = se::blas::PointerMode::kHost;
+    params.epilogue = key.epilogue;
+    params.transa = key.transpose_b ? se::blas::Transpose::kTranspose
+                                    : se::blas::Transpose::kNoTranspose;
+    params.transb = key.transpose_a ? se::blas::Transpose::kTranspose
+                                    : se::blas::Transpose::kNoTranspose;
+    params.m = key.n;
+    params.n = key.m;
+    params.k = key.k;
+    params.lda = key.transpose_b ? key.k : key.n;
+    params.ldb = key.transpose_a ? key.m : key.k;
+    params.ldc = key.n;
+
+    auto value = std::make_unique<BlasLtMatmulPlanAndAlgorithm>();
+    se::StreamExecutor* executor = stream->parent();
+    auto plan_or = executor->CreateBlasLtMatmulPlan(params);
+    TF_RETURN_IF_ERROR(plan_or.status());
+    value->plan = plan_or.ConsumeValueOrDie();
+
+    auto algorithms_or = executor->GetBlasLtMatmulAlgorithms(
+        value->plan.get(), kBlasLtMaxWorkspaceSize,
+        /*max_algorithm_count=*/1);
+    TF_RETURN_IF_ERROR(algorithms_or.status());
+    auto algorithms = algorithms_or.ConsumeValueOrDie();
+    if (algorithms.empty()) {
+      return errors::Internal("No cublasLt algorithm for the fused matmul");
+    }
+    value->algorithm = std::move(algorithms.front());
+
+    *entry = value.get();
+    entries_.emplace(key, std::move(value));
+    return Status::OK();
+  }
+
+ private:
+  BlasLtMatmulPlanCache() = default;
+
+  mutex mu_;
+  absl::flat_hash_map<BlasLtMatmulKey,
+                      std::unique_ptr<BlasLtMatmulPlanAndAlgorithm>>
+      entries_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+template <typename T>
+struct LaunchFusedMatMulOp<GPUDevice, T> {
+  void operator()(
+      OpKernelContext* context, const Tensor& a, const Tensor& b,
+      const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+      FusedComputationType fusion, const FusedComputationArgs& fusion_args,
+      Tensor* output) {
+    auto* stream = context->op_device_context()->stream();
+    OP_REQUIRES(context, stream, errors::Internal("No GPU stream available."));
+
+    se::blas::Epilogue epilogue;
+    switch (fusion) {
+      case FusedComputationType::kBiasAdd:
+        epilogue = se::blas::Epilogue::kBias;
+        break;
+      case FusedComputationType::kBiasAddWithRelu:
+        epilogue = se::blas::Epilogue::kBiasThenReLU;
+        break;
+      default:
+        OP_REQUIRES_OK(context, errors::Unimplemented(
+                                    "FusedMatMul on GPU only supports fusing "
+                                    "with `BiasAdd` and `BiasAdd + Relu`."));
+    }
+
+    const bool transpose_a = dim_pair[0].first == 0;
+    const bool transpose_b = dim_pair[0].second == 1;
+    const uint64 m = output->dim_size(0);
+    const uint64 n = output->dim_size(1);
+    const uint64 k = a.dim_size(dim_pair[0].first);
+
+    const Tensor& bias = context->input(2);
+    OP_REQUIRES(context, bias.dims() == 1,
+                errors::InvalidArgument("bias must be 1-dimensional",
+                                        bias.shape().DebugString()));
+    OP_REQUIRES(context, bias.dim_size(0) == n,
+                errors::InvalidArgument(
+                    "bias dimension must match the number of output columns: ",
+                    bias.shape().DebugString(), " vs. ",
+                    output->shape().DebugString()));
+
+    BlasLtMatmulKey key;
+    key.device_id = stream->parent()->device_ordinal();
+    key.m = m;
+    key.n = n;
+    key.k = k;
+    key.transpose_a = transpose_a;
+    key.transpose_b = transpose_b;
+    key.epilogue = epilogue;
+    key.computation_type = tensor_float_32_execution_enabled()
+                               ? se::blas::ComputationType::kTF32AsF32
+                               : se::blas::ComputationType::kF32;
+
+    const BlasLtMatmulPlanAndAlgorithm* entry;
+    OP_REQUIRES_OK(context, BlasLtMatmulPlanCache::GetInstance()->Get<T>(
+                                stream, key, &entry));
+
+    auto a_ptr = AsDeviceMemory(a.flat<T>().data(), a.NumElements());
+    auto b_ptr = AsDeviceMemory(b.flat<T>().data(), b.NumElements());
+    auto c_ptr = AsDeviceMemory(output->flat<T>().data(),
+                                output->NumElements());
+    auto bias_ptr = AsDeviceMemory(bias.flat<T>().data(), bias.NumElements());
+
+    // The row-major product is computed as C' = B' x A' in column-major
+    // order, so the bias is broadcast along the rows of C'.
+    BlasLtScratchAllocator scratch_allocator(context);
+    bool blas_launch_status =
+        stream
+            ->ThenBlasLtMatmul(entry->plan.get(), static_cast<T>(1.0), b_ptr,
+                               a_ptr, static_cast<T>(0.0), &c_ptr,
+                               &scratch_allocator, entry->algorithm.get(),
+                               bias_ptr)
+            .ok();
+    OP_REQUIRES(context, blas_launch_status,
+                errors::Internal("cublasLt fused matmul launch failed: "
+                                 "a.shape=", a.shape().DebugString(),
+                                 ", b.shape=", b.shape().DebugString(),
+                                 ", m=", m, ", n=", n, ", k=", k));
+  }
+};
+
+#endif  // GOOGLE_CUDA
+
 template <typename Device, typename T>
 class FusedMatMulOp : public OpKernel {
  public:
@@ -163,6 +389,11 @@ class FusedMatMulOp : public OpKernel {
           {FCT::kBiasAddWithElu, {"BiasAdd", "Elu"}},
           {FCT::kBiasAddWithLeakyRelu, {"BiasAdd", "LeakyRelu"}},
       };
+    } else if (std::is_same<Device, GPUDevice>::value) {
+      patterns = {
+          {FCT::kBiasAdd, {"BiasAdd"}},
+          {FCT::kBiasAddWithRelu, {"BiasAdd", "Relu"}},
+      };
     }
 
     OP_REQUIRES_OK(context, InitializeFusedComputation(
@@ -239,5 +470,19 @@ TF_CALL_float(REGISTER_FUSED_CPU_MATMUL);
 
 #undef REGISTER_FUSED_CPU_MATMUL
 
+#if GOOGLE_CUDA
+
+// Registration of the GPU implementations.
+#define REGISTER_FUSED_GPU_MATMUL(T)                                  \
+  REGISTER_KERNEL_BUILDER(                                            \
+      Name("_FusedMatMul").Device(DEVICE_GPU).TypeConstraint<T>("T"), \
+      FusedMatMulOp<GPUDevice, T>);
+
+TF_CALL_float(REGISTER_FUSED_GPU_MATMUL);
+
+#undef REGISTER_FUSED_GPU_MATMUL
+
+#endif  // GOOGLE_CUDA
+
 }  // namespace tensorflow
 #endif  // TENSORFLOW_CORE_KERNELS_MATMUL_OP_FUSED_H_
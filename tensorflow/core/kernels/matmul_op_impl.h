@@ -241,11 +241,24 @@ struct LaunchBatchMatMul<CPUDevice, Scalar> {
     // NOTE(nikhilsarda): This heuristic is optimal in benchmarks as of
     // Jan 21, 2020.
     const int64 kMaxCostOuterParallelism = 128 * 128;  // heuristic.
+    // Below this total cost, dispatching to the thread pool takes longer than
+    // the products themselves, so they are computed in the calling thread.
+    const int64 kMaxCostInline = 64 * 64 * 64;  // heuristic.
+    // When every thread gets at least one product, products up to this cost
+    // are faster one per thread than each one split across all threads, e.g.
+    // for the per-head products of attention layers.
+    const int64 kMaxCostBatchParallelism = 256 * 256 * 256;  // heuristic.
     auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    const bool parallelize_batch =
+        batch_size >= worker_threads.num_threads &&
+        cost_per_unit <= kMaxCostBatchParallelism;
     // TODO(rmlarsen): Reconsider the heuristics now that we have asynchronous
     // evaluation in Eigen Tensor.
-    if (small_dim > 1 &&
-        (batch_size == 1 || cost_per_unit > kMaxCostOuterParallelism)) {
+    if (batch_size * cost_per_unit <= kMaxCostInline) {
+      SequentialMatMulKernel<Scalar>::Run(in_x, in_y, adj_x, adj_y, trans_x,
+                                          trans_y, bcast, out, 0, batch_size);
+    } else if (small_dim > 1 && !parallelize_batch &&
+               (batch_size == 1 || cost_per_unit > kMaxCostOuterParallelism)) {
       // Parallelize over inner dims.
       // For large matrix products it is counter-productive to parallelize
       // over the batch dimension.
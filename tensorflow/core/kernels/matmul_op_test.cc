@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/tensor_float_32_utils.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
@@ -219,19 +220,19 @@ class FusedMatMulOpTest : public OpsTestBase {
   // Verifies that computing MatMul+BiasAdd in a graph is identical to
   // FusedMatMul.
   void VerifyMatMulWithBias(int m, int k, int n, bool transpose_a,
-                            bool transpose_b) {
+                            bool transpose_b, bool allow_gpu_device = false) {
     const BiasAddGraphRunner run_default =
         [&](const Tensor& input_data, const Tensor& filter_data,
             const Tensor& bias_data, Tensor* out) {
           RunMatMulWithBias(input_data, filter_data, bias_data, transpose_a,
-                            transpose_b, out);
+                            transpose_b, out, allow_gpu_device);
         };
 
     const BiasAddGraphRunner run_fused =
         [&](const Tensor& input_data, const Tensor& filter_data,
             const Tensor& bias_data, Tensor* out) {
           RunFusedMatMulOp(input_data, filter_data, {bias_data}, {"BiasAdd"},
-                           transpose_a, transpose_b, out);
+                           transpose_a, transpose_b, out, allow_gpu_device);
         };
 
     VerifyBiasAddTensorsNear(m, k, n, run_default, run_fused);
@@ -241,13 +242,15 @@ class FusedMatMulOpTest : public OpsTestBase {
   // to FusedMatMul.
   void VerifyConv2DWithBiasAndActivation(int m, int k, int n, bool transpose_a,
                                          bool transpose_b,
-                                         const string& activation) {
+                                         const string& activation,
+                                         bool allow_gpu_device = false) {
     const BiasAddGraphRunner run_default = [&](const Tensor& input_data,
                                                const Tensor& filter_data,
                                                const Tensor& bias_data,
                                                Tensor* out) {
       RunMatMulWithBiasAndActivation(input_data, filter_data, bias_data,
-                                     transpose_a, transpose_b, activation, out);
+                                     transpose_a, transpose_b, activation, out,
+                                     allow_gpu_device);
     };
 
     const BiasAddGraphRunner run_fused = [&](const Tensor& input_data,
@@ -255,7 +258,8 @@ class FusedMatMulOpTest : public OpsTestBase {
                                              const Tensor& bias_data,
                                              Tensor* out) {
       RunFusedMatMulOp(input_data, filter_data, {bias_data},
-                       {"BiasAdd", activation}, transpose_a, transpose_b, out);
+                       {"BiasAdd", activation}, transpose_a, transpose_b, out,
+                       allow_gpu_device);
     };
 
     VerifyBiasAddTensorsNear(m, k, n, run_default, run_fused);
@@ -327,6 +331,29 @@ TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul1x256x1WithActivation) {
   }
 }
 
+// On GPU only BiasAdd and BiasAdd + Relu are fused, through cublasLt.
+TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul256x256x256OnGpu) {
+  // Requires full precision MatMul op
+  tensorflow::enable_tensor_float_32_execution(false);
+  for (bool transpose_a : {false, true}) {
+    for (bool transpose_b : {false, true}) {
+      this->VerifyMatMulWithBias(256, 256, 256, transpose_a, transpose_b,
+                                 /*allow_gpu_device=*/true);
+      this->VerifyConv2DWithBiasAndActivation(256, 256, 256, transpose_a,
+                                              transpose_b, "Relu",
+                                              /*allow_gpu_device=*/true);
+    }
+  }
+}
+
+TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul1x256x1OnGpu) {
+  tensorflow::enable_tensor_float_32_execution(false);
+  this->VerifyMatMulWithBias(1, 256, 1, false, false,
+                             /*allow_gpu_device=*/true);
+  this->VerifyConv2DWithBiasAndActivation(1, 256, 1, false, false, "Relu",
+                                          /*allow_gpu_device=*/true);
+}
+
 REGISTER_TYPED_TEST_SUITE_P(FusedMatMulWithBiasOpTest,        //
                             MatMul256x256x256,                //
                             MatMul1x256x256,                  //
@@ -335,7 +362,9 @@ REGISTER_TYPED_TEST_SUITE_P(FusedMatMulWithBiasOpTest,        //
                             MatMul256x256x256WithActivation,  //
                             MatMul1x256x256WithActivation,    //
                             MatMul256x256x1WithActivation,    //
-                            MatMul1x256x1WithActivation);
+                            MatMul1x256x1WithActivation,      //
+                            MatMul256x256x256OnGpu,           //
+                            MatMul1x256x1OnGpu);
 
 // TODO(ezhulenev): Add support for more data types.
 using FusedBiasAddDataTypes = ::testing::Types<float>;
@@ -660,6 +689,12 @@ BM_BatchMatmul(32, 256, 256, 256, false, false);
 BM_BatchMatmul(32, 1024, 1024, 1024, false, false);
 BM_BatchMatmul(32, 2048, 2048, 2048, false, false);
 
+// Small per-head products of attention layers.
+BM_BatchMatmul(1, 16, 64, 64, false, false);
+BM_BatchMatmul(128, 16, 64, 64, false, false);
+BM_BatchMatmul(128, 128, 64, 128, false, true);
+BM_BatchMatmul(128, 128, 128, 64, false, false);
+
 // Matrix-vector multiplies.
 BM_BatchMatmul(1, 10000, 200, 1, false, false);
 BM_BatchMatmul(8, 10000, 200, 1, false, false);
@@ -29,7 +29,9 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -274,7 +276,13 @@ struct RestoreOp {
     VLOG(1) << "Restoring tensor " << idx << " : " << tensor_name << " : "
             << restored_full_shape.num_elements();
     Tensor* restored_tensor;
-    if (shape_and_slice.empty()) {
+    if (shape_and_slice.empty() && memory_mapped) {
+      // Lookup the full tensor, backed by the data file where possible.
+      Tensor mapped;
+      TF_RETURN_IF_ERROR(reader->LookupMapped(tensor_name, &mapped));
+      context->set_output(idx, mapped);
+      restored_tensor = context->mutable_output(idx);
+    } else if (shape_and_slice.empty()) {
       // Lookup the full tensor.
       TF_RETURN_IF_ERROR(
           context->allocate_output(idx, restored_full_shape, &restored_tensor));
@@ -327,6 +335,7 @@ struct RestoreOp {
   string tensor_name;
   string shape_and_slice;
   string reader_prefix;
+  bool memory_mapped;
 
   ::tensorflow::Status status;
 };
@@ -353,6 +362,13 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
   std::vector<std::unique_ptr<RestoreOp> > pool_restore_ops;
   std::vector<std::unique_ptr<RestoreOp> > direct_restore_ops;
 
+  // Memory mapping the restored tensors lets large models start serving
+  // before all their variables are paged in, and shares their pages with
+  // other processes restoring the same checkpoint.
+  bool memory_mapped;
+  TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_RESTORE_MEMORY_MAPPED",
+                                        /*default_val=*/false, &memory_mapped));
+
   BundleReader default_reader(Env::Default(), prefix_string);
   TF_RETURN_IF_ERROR(default_reader.status());
 
@@ -379,8 +395,8 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
   for (auto i : sorted_name_idx) {
     const string& tensor_name = tensor_names_flat(i);
     const string& shape_and_slice = shape_and_slices_flat(i);
-    auto op =
-        new RestoreOp{context, i, tensor_name, shape_and_slice, prefix_string};
+    auto op = new RestoreOp{context,       i, tensor_name, shape_and_slice,
+                            prefix_string, memory_mapped};
     if (op->should_run_in_pool(&default_reader)) {
       pool_restore_ops.emplace_back(op);
     } else {
@@ -424,4 +440,76 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
   return Status::OK();
 }
 
+namespace {
+
+// Number of background threads running asynchronous V2 saves.
+const int kNumAsyncSaveThreads = 4;
+
+// Tracks the asynchronous V2 saves of this process, per checkpoint prefix.
+class AsyncSaveTracker {
+ public:
+  static AsyncSaveTracker* Global() {
+    static AsyncSaveTracker* tracker = new AsyncSaveTracker;
+    return tracker;
+  }
+
+  void Schedule(const string& prefix, std::function<Status()> write_fn) {
+    {
+      mutex_lock l(mu_);
+      ++saves_[prefix].num_pending;
+    }
+    pool_.Schedule([this, prefix, write_fn = std::move(write_fn)]() {
+      Status s = write_fn();
+      if (!s.ok()) {
+        LOG(ERROR) << "Asynchronous save of " << prefix << " failed: " << s;
+      }
+      mutex_lock l(mu_);
+      PrefixSaves& saves = saves_[prefix];
+      saves.status.Update(s);
+      if (--saves.num_pending == 0) {
+        if (saves.status.ok()) saves_.erase(prefix);
+        cv_.notify_all();
+      }
+    });
+  }
+
+  Status Wait(const string& prefix) {
+    mutex_lock l(mu_);
+    auto it = saves_.find(prefix);
+    while (it != saves_.end() && it->second.num_pending > 0) {
+      cv_.wait(l);
+      it = saves_.find(prefix);
+    }
+    if (it == saves_.end()) return Status::OK();
+    Status s = it->second.status;
+    saves_.erase(it);
+    return s;
+  }
+
+ private:
+  AsyncSaveTracker()
+      : pool_(Env::Default(), "async_save_v2", kNumAsyncSaveThreads) {}
+
+  struct PrefixSaves {
+    int num_pending = 0;
+    Status status;
+  };
+
+  thread::ThreadPool pool_;
+  mutex mu_;
+  condition_variable cv_;
+  std::unordered_map<string, PrefixSaves> saves_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+void ScheduleAsyncSaveV2(const string& prefix,
+                         std::function<Status()> write_fn) {
+  AsyncSaveTracker::Global()->Schedule(prefix, std::move(write_fn));
+}
+
+Status WaitForAsyncSavesV2(const string& prefix) {
+  return AsyncSaveTracker::Global()->Wait(prefix);
+}
+
 }  // namespace tensorflow
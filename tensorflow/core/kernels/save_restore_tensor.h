@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_SAVE_RESTORE_TENSOR_H_
 #define TENSORFLOW_CORE_KERNELS_SAVE_RESTORE_TENSOR_H_
 
+#include <functional>
+
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_writer.h"
 
@@ -68,6 +70,17 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
                         const Tensor& shape_and_slices,
                         gtl::ArraySlice<DataType> dtypes);
 
+// Runs "write_fn", which writes the V2 checkpoint "prefix", on a background
+// thread and returns immediately.  The files only become usable once
+// WaitForAsyncSavesV2(prefix) has returned OK.
+void ScheduleAsyncSaveV2(const string& prefix,
+                         std::function<Status()> write_fn);
+
+// Blocks until every write scheduled by ScheduleAsyncSaveV2() for "prefix" in
+// this process has finished.  Returns the first error among them, which is
+// then cleared.  Returns OK right away if none is pending.
+Status WaitForAsyncSavesV2(const string& prefix);
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_KERNELS_SAVE_RESTORE_TENSOR_H_
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/kernels/save_restore_tensor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
@@ -340,5 +341,47 @@ TEST_F(SaveV2OpTest, Simple) {
   }
 }
 
+class AsyncSaveV2OpTest : public OpsTestBase {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("myop", "SaveV2")
+                     .Input(FakeInput())            // prefix
+                     .Input(FakeInput())            // tensor_names
+                     .Input(FakeInput())            // shape_and_slices
+                     .Input(FakeInput({DT_FLOAT}))  // tensors
+                     .Attr("asynchronous", true)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(AsyncSaveV2OpTest, SavesSnapshotOfInputs) {
+  const string prefix = io::JoinPath(testing::TmpDir(), "tensor_async");
+
+  MakeOp();
+  AddInput<tstring>(TensorShape({}),
+                    [&prefix](int x) -> tstring { return prefix; });
+  AddInput<tstring>(TensorShape({1}),
+                    [](int x) -> tstring { return "tensor_float"; });
+  AddInput<tstring>(TensorShape({1}), [](int x) -> tstring { return ""; });
+  AddInput<float>(TensorShape({2, 4}),
+                  [](int x) -> float { return static_cast<float>(x) / 10; });
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Updating the input after the op returns must not change what is saved.
+  Tensor input = GetInput(3);
+  input.flat<float>().setZero();
+  TF_ASSERT_OK(WaitForAsyncSavesV2(prefix));
+
+  BundleReader reader(Env::Default(), prefix);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  TF_EXPECT_OK(reader.Lookup("tensor_float", &val));
+  EXPECT_EQ(DT_FLOAT, val.dtype());
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(static_cast<float>(i) / 10, val.template flat<float>()(i));
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
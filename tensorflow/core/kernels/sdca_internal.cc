@@ -171,11 +171,12 @@ const ExampleStatistics Example::ComputeWxAndWeightedExampleNorm(
       const double feature_value = sparse_features.values == nullptr
                                        ? 1.0
                                        : (*sparse_features.values)(k);
+      const int64 id = sparse_weights.IdOf(feature_index);
       for (int l = 0; l < num_weight_vectors; ++l) {
-        const float sparse_weight = sparse_weights.nominals(l, feature_index);
+        const float sparse_weight = sparse_weights.nominals_by_id(l, id);
         const double feature_weight =
             sparse_weight +
-            sparse_weights.deltas(l, feature_index) * num_loss_partitions;
+            sparse_weights.deltas_by_id(l, id) * num_loss_partitions;
         result.prev_wx[l] +=
             feature_value * regularization.Shrink(sparse_weight);
         result.wx[l] += feature_value * regularization.Shrink(feature_weight);
@@ -190,27 +191,37 @@ const ExampleStatistics Example::ComputeWxAndWeightedExampleNorm(
     const FeatureWeightsDenseStorage& dense_weights =
         model_weights.dense_weights()[j];
 
-    const Eigen::Tensor<float, 2, Eigen::RowMajor> feature_weights =
-        dense_weights.nominals() +
-        dense_weights.deltas() *
-            dense_weights.deltas().constant(num_loss_partitions);
     if (num_weight_vectors == 1) {
+      // Shrinks and reduces in single Eigen expressions, which are vectorized
+      // and avoid materializing the current and shrunk weight vectors for
+      // every example.
+      const int64 num_features = dense_weights.nominals().dimension(1);
+      const Eigen::TensorMap<Eigen::Tensor<const float, 1, Eigen::RowMajor>>
+          nominals(dense_weights.nominals().data(), num_features);
+      const Eigen::TensorMap<Eigen::Tensor<const float, 1, Eigen::RowMajor>>
+          deltas(dense_weights.deltas().data(), num_features);
+      const float shrinkage = regularization.shrinkage();
+      const float scale = num_loss_partitions;
+      // Proximal step on the weights which is sign(w)*|w - shrinkage|+.
       const Eigen::Tensor<float, 0, Eigen::RowMajor> prev_prediction =
-          (dense_vector.Row() *
-           regularization.EigenShrinkVector(
-               Eigen::TensorMap<Eigen::Tensor<const float, 1, Eigen::RowMajor>>(
-                   dense_weights.nominals().data(),
-                   dense_weights.nominals().dimension(1))))
+          (dense_vector.Row() * nominals.sign() *
+           (nominals.abs() - nominals.constant(shrinkage))
+               .cwiseMax(nominals.constant(0.0f)))
               .sum();
       const Eigen::Tensor<float, 0, Eigen::RowMajor> prediction =
           (dense_vector.Row() *
-           regularization.EigenShrinkVector(
-               Eigen::TensorMap<Eigen::Tensor<const float, 1, Eigen::RowMajor>>(
-                   feature_weights.data(), feature_weights.dimension(1))))
+           (nominals + deltas * deltas.constant(scale)).sign() *
+           ((nominals + deltas * deltas.constant(scale)).abs() -
+            nominals.constant(shrinkage))
+               .cwiseMax(nominals.constant(0.0f)))
               .sum();
       result.prev_wx[0] += prev_prediction();
       result.wx[0] += prediction();
     } else {
+      const Eigen::Tensor<float, 2, Eigen::RowMajor> feature_weights =
+          dense_weights.nominals() +
+          dense_weights.deltas() *
+              dense_weights.deltas().constant(num_loss_partitions);
       const Eigen::array<Eigen::IndexPair<int>, 1> product_dims = {
           Eigen::IndexPair<int>(1, 1)};
       const Eigen::Tensor<float, 2, Eigen::RowMajor> prev_prediction =
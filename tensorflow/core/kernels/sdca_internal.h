@@ -110,6 +110,9 @@ class Regularizations {
 
   float symmetric_l2() const { return symmetric_l2_; }
 
+  // L1 divided by L2, the amount weights are shrunk towards zero by.
+  float shrinkage() const { return shrinkage_; }
+
  private:
   float symmetric_l1_ = 0;
   float symmetric_l2_ = 0;
@@ -247,14 +250,27 @@ class FeatureWeightsSparseStorage {
 
   // Nominal value at a particular feature index and class label.
   float nominals(const int class_id, const int64 index) const {
-    auto it = indices_to_id_.find(index);
-    return nominals_(class_id, it->second);
+    return nominals_(class_id, IdOf(index));
   }
 
   // Delta weights during mini-batch updates.
   float deltas(const int class_id, const int64 index) const {
-    auto it = indices_to_id_.find(index);
-    return deltas_(class_id, it->second);
+    return deltas_(class_id, IdOf(index));
+  }
+
+  // Position of a valid feature index in the underlying storage. Looking it
+  // up once lets callers read nominals and deltas of all classes without
+  // further hashing.
+  int64 IdOf(const int64 index) const {
+    return indices_to_id_.find(index)->second;
+  }
+
+  // Nominal value and delta weight at a position returned by IdOf().
+  float nominals_by_id(const int class_id, const int64 id) const {
+    return nominals_(class_id, id);
+  }
+  float deltas_by_id(const int class_id, const int64 id) const {
+    return deltas_(class_id, id);
   }
 
   // Updates delta weights based on active sparse features in the example and
@@ -0,0 +1,229 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_SHARDED_HASH_MAP_H_
+#define TENSORFLOW_CORE_KERNELS_SHARDED_HASH_MAP_H_
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/platform/hash.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace lookup {
+
+// A hash map whose entries are spread over a fixed number of shards, each an
+// open-addressing absl::flat_hash_map guarded by its own mutex. Lookups of
+// different keys only contend when the keys land in the same shard, and a
+// shard that grows rehashes only its own entries while the other shards stay
+// available, so concurrent readers and writers scale with the number of
+// shards instead of serializing on one table-wide lock.
+//
+// Operations on a single key are linearizable. Clear(), Assign() and
+// ForEach() take every shard lock, in shard order, so they observe or
+// replace the whole map atomically.
+template <class K, class V, class Hash = std::hash<K>>
+class ShardedHashMap {
+ public:
+  static constexpr int kDefaultNumShards = 32;
+
+  // `num_shards` is rounded up to a power of two.
+  explicit ShardedHashMap(int num_shards = kDefaultNumShards) {
+    CHECK_GT(num_shards, 0);
+    while ((1 << shard_bits_) < num_shards) ++shard_bits_;
+    num_shards_ = 1 << shard_bits_;
+    shards_.reset(new Shard[num_shards_]);
+  }
+
+  ShardedHashMap(const ShardedHashMap&) = delete;
+  void operator=(const ShardedHashMap&) = delete;
+
+  int num_shards() const { return num_shards_; }
+
+  size_t size() const {
+    size_t size = 0;
+    for (int i = 0; i < num_shards_; ++i) {
+      tf_shared_lock l(shards_[i].mu);
+      size += shards_[i].map.size();
+    }
+    return size;
+  }
+
+  // Copies the value stored for `key` into `*value` and returns true, or
+  // returns false if there is none.
+  bool Find(const K& key, V* value) const {
+    return FindAndApply(key, [value](const V& v) { *value = v; });
+  }
+
+  // Calls `fn(value)` with the value stored for `key` while its shard is
+  // locked for reading and returns true, or returns false if there is none.
+  // `fn` must not access the map.
+  template <typename Fn>
+  bool FindAndApply(const K& key, Fn fn) const {
+    const Shard& shard = GetShard(key);
+    tf_shared_lock l(shard.mu);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) return false;
+    fn(it->second);
+    return true;
+  }
+
+  // Like FindAndApply(), but locks the shard for writing and passes a
+  // mutable pointer to the value.
+  template <typename Fn>
+  bool FindAndMutate(const K& key, Fn fn) {
+    Shard& shard = GetShard(key);
+    mutex_lock l(shard.mu);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) return false;
+    fn(&it->second);
+    return true;
+  }
+
+  // Calls `fn(&value)` with the value stored for `key`, first inserting
+  // `make()` if there is none, while its shard is locked for writing. Neither
+  // function may access the map.
+  template <typename MakeFn, typename Fn>
+  void FindOrInsertAndMutate(const K& key, MakeFn make, Fn fn) {
+    Shard& shard = GetShard(key);
+    mutex_lock l(shard.mu);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      it = shard.map.emplace(key, make()).first;
+    }
+    fn(&it->second);
+  }
+
+  void InsertOrUpdate(const K& key, V value) {
+    Shard& shard = GetShard(key);
+    mutex_lock l(shard.mu);
+    shard.map.insert_or_assign(key, std::move(value));
+  }
+
+  // Returns true if `key` was present.
+  bool Erase(const K& key) {
+    Shard& shard = GetShard(key);
+    mutex_lock l(shard.mu);
+    return shard.map.erase(key) > 0;
+  }
+
+  // Erases every entry for which `pred(key, &value)` returns true and returns
+  // the number of erased entries. Shards are locked for writing one at a time,
+  // so concurrent operations on other shards proceed. `pred` may modify the
+  // entries it keeps and must not access the map.
+  template <typename Pred>
+  int64 EraseIf(Pred pred) {
+    int64 num_erased = 0;
+    for (int i = 0; i < num_shards_; ++i) {
+      mutex_lock l(shards_[i].mu);
+      auto& map = shards_[i].map;
+      for (auto it = map.begin(); it != map.end();) {
+        if (pred(it->first, &it->second)) {
+          map.erase(it++);
+          ++num_erased;
+        } else {
+          ++it;
+        }
+      }
+    }
+    return num_erased;
+  }
+
+  void Clear() {
+    Assign([](const std::function<void(const K&, V)>&) {});
+  }
+
+  // Replaces the contents of the map with the entries that `fill` passes to
+  // the insert function it is called with. Readers see either the old or the
+  // new contents. `fill` must not access the map.
+  template <typename Fn>
+  void Assign(Fn fill) TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (int i = 0; i < num_shards_; ++i) {
+      shards_[i].mu.lock();
+      shards_[i].map.clear();
+    }
+    const std::function<void(const K&, V)> insert =
+        [this](const K& key, V value) TF_NO_THREAD_SAFETY_ANALYSIS {
+          GetShard(key).map.insert_or_assign(key, std::move(value));
+        };
+    fill(insert);
+    for (int i = num_shards_ - 1; i >= 0; --i) {
+      shards_[i].mu.unlock();
+    }
+  }
+
+  // Calls `fn(num_entries)` and then `fn(key, value)` for every entry on a
+  // consistent snapshot of the map. `fn` must not access the map.
+  template <typename SizeFn, typename Fn>
+  void ForEach(SizeFn size_fn, Fn fn) const TF_NO_THREAD_SAFETY_ANALYSIS {
+    size_t size = 0;
+    for (int i = 0; i < num_shards_; ++i) {
+      shards_[i].mu.lock_shared();
+      size += shards_[i].map.size();
+    }
+    size_fn(size);
+    for (int i = 0; i < num_shards_; ++i) {
+      for (const auto& entry : shards_[i].map) {
+        fn(entry.first, entry.second);
+      }
+    }
+    for (int i = num_shards_ - 1; i >= 0; --i) {
+      shards_[i].mu.unlock_shared();
+    }
+  }
+
+  // Returns the number of slots allocated by all shards.
+  size_t capacity() const {
+    size_t capacity = 0;
+    for (int i = 0; i < num_shards_; ++i) {
+      tf_shared_lock l(shards_[i].mu);
+      capacity += shards_[i].map.capacity();
+    }
+    return capacity;
+  }
+
+ private:
+  struct Shard {
+    mutable mutex mu;
+    absl::flat_hash_map<K, V, Hash> map TF_GUARDED_BY(mu);
+  };
+
+  // Picks the shard from the high bits of a mixed hash, so that the shard
+  // does not correlate with the slot the key takes within its shard even for
+  // identity hashes of integer keys.
+  int ShardIndex(const K& key) const {
+    if (shard_bits_ == 0) return 0;
+    const uint64 h = static_cast<uint64>(Hash()(key)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<int>(h >> (64 - shard_bits_));
+  }
+  Shard& GetShard(const K& key) { return shards_[ShardIndex(key)]; }
+  const Shard& GetShard(const K& key) const {
+    return shards_[ShardIndex(key)];
+  }
+
+  int shard_bits_ = 0;
+  int num_shards_ = 1;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace lookup
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_SHARDED_HASH_MAP_H_
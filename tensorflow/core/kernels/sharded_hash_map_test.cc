@@ -0,0 +1,189 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/sharded_hash_map.h"
+
+#include <atomic>
+#include <vector>
+
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace lookup {
+namespace {
+
+TEST(ShardedHashMapTest, RoundsUpNumShards) {
+  using Map = ShardedHashMap<int64, int64>;
+  EXPECT_EQ(Map(1).num_shards(), 1);
+  EXPECT_EQ(Map(5).num_shards(), 8);
+  EXPECT_EQ(Map().num_shards(), static_cast<int>(Map::kDefaultNumShards));
+}
+
+TEST(ShardedHashMapTest, InsertFindErase) {
+  ShardedHashMap<int64, int64> map;
+  for (int64 i = 0; i < 1000; ++i) {
+    map.InsertOrUpdate(i, 2 * i);
+  }
+  EXPECT_EQ(map.size(), 1000);
+  map.InsertOrUpdate(7, -1);
+  EXPECT_EQ(map.size(), 1000);
+
+  int64 value = 0;
+  EXPECT_TRUE(map.Find(7, &value));
+  EXPECT_EQ(value, -1);
+  EXPECT_TRUE(map.Find(999, &value));
+  EXPECT_EQ(value, 1998);
+  EXPECT_FALSE(map.Find(1000, &value));
+
+  EXPECT_TRUE(map.Erase(7));
+  EXPECT_FALSE(map.Erase(7));
+  EXPECT_FALSE(map.Find(7, &value));
+  EXPECT_EQ(map.size(), 999);
+  EXPECT_GE(map.capacity(), map.size());
+}
+
+TEST(ShardedHashMapTest, MutateAndEraseIf) {
+  ShardedHashMap<int64, int64> map;
+  EXPECT_FALSE(map.FindAndMutate(1, [](int64* v) { ++*v; }));
+  for (int64 i = 0; i < 10; ++i) {
+    map.FindOrInsertAndMutate(
+        i % 5, []() { return int64{0}; }, [](int64* v) { ++*v; });
+  }
+  EXPECT_EQ(map.size(), 5);
+  EXPECT_TRUE(map.FindAndMutate(1, [](int64* v) { ++*v; }));
+
+  // Keeps key 1, which was counted three times, and halves its count.
+  const int64 num_erased = map.EraseIf([](const int64& key, int64* v) {
+    if (*v < 3) return true;
+    *v /= 2;
+    return false;
+  });
+  EXPECT_EQ(num_erased, 4);
+  int64 value = 0;
+  EXPECT_TRUE(map.Find(1, &value));
+  EXPECT_EQ(value, 1);
+  EXPECT_EQ(map.size(), 1);
+}
+
+TEST(ShardedHashMapTest, StringKeys) {
+  ShardedHashMap<tstring, int64> map(4);
+  map.InsertOrUpdate("foo", 1);
+  map.InsertOrUpdate("bar", 2);
+  int64 value = 0;
+  EXPECT_TRUE(map.FindAndApply("bar", [&value](int64 v) { value = v; }));
+  EXPECT_EQ(value, 2);
+  EXPECT_FALSE(map.FindAndApply("baz", [&value](int64 v) { value = v; }));
+}
+
+TEST(ShardedHashMapTest, AssignAndForEach) {
+  ShardedHashMap<int64, int64> map;
+  map.InsertOrUpdate(-1, -1);
+  map.Assign([](const std::function<void(const int64&, int64)>& insert) {
+    for (int64 i = 0; i < 100; ++i) insert(i, i + 1);
+  });
+  EXPECT_EQ(map.size(), 100);
+
+  size_t reported_size = 0;
+  int64 key_sum = 0;
+  int64 num_visited = 0;
+  map.ForEach([&](size_t size) { reported_size = size; },
+              [&](const int64& key, const int64& value) {
+                EXPECT_EQ(value, key + 1);
+                key_sum += key;
+                ++num_visited;
+              });
+  EXPECT_EQ(reported_size, 100);
+  EXPECT_EQ(num_visited, 100);
+  EXPECT_EQ(key_sum, 99 * 100 / 2);
+
+  map.Clear();
+  EXPECT_EQ(map.size(), 0);
+}
+
+TEST(ShardedHashMapTest, ConcurrentInsertAndFind) {
+  constexpr int kNumThreads = 8;
+  constexpr int64 kKeysPerThread = 2000;
+  ShardedHashMap<int64, int64> map;
+  std::atomic<int64> num_bad_values(0);
+  {
+    thread::ThreadPool pool(Env::Default(), "test", kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t) {
+      pool.Schedule([&map, &num_bad_values, t]() {
+        for (int64 i = 0; i < kKeysPerThread; ++i) {
+          const int64 key = t * kKeysPerThread + i;
+          map.InsertOrUpdate(key, key);
+          // Reads of keys owned by other threads see either nothing or the
+          // value that was written.
+          int64 value;
+          const int64 other = ((t + 1) % kNumThreads) * kKeysPerThread + i;
+          if (map.Find(other, &value) && value != other) ++num_bad_values;
+        }
+      });
+    }
+  }
+  EXPECT_EQ(num_bad_values, 0);
+  EXPECT_EQ(map.size(), kNumThreads * kKeysPerThread);
+}
+
+// Runs `state.range(0)` threads that each perform lookups over a shared table
+// of 1M keys, with one insert of a new key per `state.range(1)` lookups.
+void BM_MixedFindInsert(::testing::benchmark::State& state) {
+  const int num_threads = state.range(0);
+  const int finds_per_insert = state.range(1);
+  constexpr int64 kNumKeys = 1 << 20;
+  constexpr int64 kOpsPerThread = 1 << 16;
+  ShardedHashMap<int64, int64> map;
+  for (int64 i = 0; i < kNumKeys; ++i) map.InsertOrUpdate(i, i);
+
+  thread::ThreadPool pool(Env::Default(), "bench", num_threads);
+  std::atomic<int64> next_key(kNumKeys);
+  for (auto s : state) {
+    BlockingCounter done(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      pool.Schedule([&, t]() {
+        uint64 key = t * 0x9E3779B97F4A7C15ULL;
+        int64 value;
+        for (int64 i = 0; i < kOpsPerThread; ++i) {
+          key = key * 6364136223846793005ULL + 1442695040888963407ULL;
+          if (i % (finds_per_insert + 1) == finds_per_insert) {
+            map.InsertOrUpdate(next_key++, i);
+          } else {
+            testing::DoNotOptimize(
+                map.Find(static_cast<int64>(key % kNumKeys), &value));
+          }
+        }
+        done.DecrementCount();
+      });
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(static_cast<int64>(state.iterations()) *
+                          num_threads * kOpsPerThread);
+}
+BENCHMARK(BM_MixedFindInsert)
+    ->ArgPair(1, 100)
+    ->ArgPair(4, 100)
+    ->ArgPair(16, 100)
+    ->ArgPair(16, 10)
+    ->ArgPair(16, 1)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace lookup
+}  // namespace tensorflow
@@ -0,0 +1,57 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/shared_constant_op.h"
+
+#include "tensorflow/core/framework/shared_constant_store.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+
+SharedConstantOp::SharedConstantOp(OpKernelConstruction* ctx)
+    : OpKernel(ctx) {
+  string handle;
+  DataType dtype;
+  TensorShape shape;
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kHandleAttr, &handle));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kDTypeAttr, &dtype));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kShapeAttr, &shape));
+  OP_REQUIRES_OK(ctx, SharedConstantStore::Global()->Lookup(handle, &tensor_));
+  OP_REQUIRES(ctx, tensor_.dtype() == dtype && tensor_.shape() == shape,
+              errors::InvalidArgument(
+                  "Shared constant ", handle, " is a ",
+                  DataTypeString(tensor_.dtype()), " tensor of shape ",
+                  tensor_.shape().DebugString(), ", but ", name(),
+                  " expects a ", DataTypeString(dtype), " tensor of shape ",
+                  shape.DebugString()));
+}
+
+void SharedConstantOp::Compute(OpKernelContext* ctx) {
+  ctx->set_output(0, tensor_);
+  if (TF_PREDICT_FALSE(ctx->track_allocations())) {
+    ctx->record_persistent_memory_allocation(tensor_.AllocatedBytes());
+  }
+}
+
+constexpr char const* SharedConstantOp::kDTypeAttr;
+constexpr char const* SharedConstantOp::kShapeAttr;
+constexpr char const* SharedConstantOp::kHandleAttr;
+
+REGISTER_KERNEL_BUILDER(Name("_SharedConst").Device(DEVICE_CPU),
+                        SharedConstantOp);
+
+}  // namespace tensorflow
@@ -19,17 +19,265 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/sparse_tensor_dense_matmul_op.h"
 
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/kernels/fill_functor.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/mutex.h"
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#include "tensorflow/core/kernels/transpose_functor.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/util/cuda_sparse.h"
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
 
+// Multiplies with a CSR copy of the sparse operand, built once the same
+// indices are seen twice in a row, as happens when they are constant across
+// steps. Does nothing by default, leaving the product to the functor.
+template <typename Device, typename T, typename Tindices>
+class CachedCsrMatMul {
+ public:
+  // Sets `*computed` if `out` was computed.
+  Status Compute(OpKernelContext* ctx, bool adjoint_a, bool adjoint_b,
+                 const Tensor& a_indices, const Tensor& a_values,
+                 const Tensor& b, Tensor* out, bool* computed) {
+    *computed = false;
+    return Status::OK();
+  }
+};
+
+#if GOOGLE_CUDA && CUDA_VERSION >= 10020
+
+namespace functor {
+template <>
+void PermuteSparseValuesFunctor<GPUDevice, float>::operator()(
+    const GPUDevice& d, typename TTypes<int32>::ConstVec permutation,
+    typename TTypes<float>::ConstVec in, typename TTypes<float>::Vec out);
+extern template struct PermuteSparseValuesFunctor<GPUDevice, float>;
+}  // namespace functor
+
+// Uses cuSPARSE SpMM, whose row-parallel CSR kernels scale much better with
+// the width of `b` than the atomics of the functor. Converting to CSR takes
+// a round trip through the host, which is why it is only done for indices
+// that are seen again.
+template <typename Tindices>
+class CachedCsrMatMul<GPUDevice, float, Tindices> {
+ public:
+  Status Compute(OpKernelContext* ctx, bool adjoint_a, bool adjoint_b,
+                 const Tensor& a_indices, const Tensor& a_values,
+                 const Tensor& b, Tensor* out, bool* computed) {
+    *computed = false;
+    std::shared_ptr<const CsrStructure> csr;
+    TF_RETURN_IF_ERROR(LookupCsr(ctx, adjoint_a, a_indices, out->dim_size(0),
+                                 adjoint_b ? b.dim_size(1) : b.dim_size(0),
+                                 &csr));
+    if (csr == nullptr) return Status::OK();
+
+    const GPUDevice& d = ctx->eigen_device<GPUDevice>();
+    const int m = out->dim_size(0);
+    const int p = out->dim_size(1);
+    const int k = adjoint_b ? b.dim_size(1) : b.dim_size(0);
+    const int nnz = a_values.NumElements();
+
+    Tensor csr_values = a_values;
+    if (csr->permutation.IsInitialized()) {
+      TF_RETURN_IF_ERROR(
+          ctx->allocate_temp(DT_FLOAT, a_values.shape(), &csr_values));
+      functor::PermuteSparseValuesFunctor<GPUDevice, float>()(
+          d, csr->permutation.vec<int32>(), a_values.vec<float>(),
+          csr_values.vec<float>());
+    }
+
+    // SpMM computes C = A * op(B) for column-major B and C. The row-major b
+    // is read as its column-major transpose, and C is transposed into out.
+    Tensor c;
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(DT_FLOAT, TensorShape({p, m}), &c));
+
+    GpuSparse cuda_sparse(ctx);
+    TF_RETURN_IF_ERROR(cuda_sparse.Initialize());
+    const float alpha = 1;
+    const float beta = 0;
+    const gpusparseOperation_t transA = CUSPARSE_OPERATION_NON_TRANSPOSE;
+    const gpusparseOperation_t transB = adjoint_b
+                                            ? CUSPARSE_OPERATION_NON_TRANSPOSE
+                                            : CUSPARSE_OPERATION_TRANSPOSE;
+    gpusparseSpMatDescr_t matA;
+    gpusparseDnMatDescr_t matB, matC;
+    TF_RETURN_IF_GPUSPARSE_ERROR(cusparseCreateCsr(
+        &matA, m, k, nnz, const_cast<int*>(csr->row_ptr.flat<int32>().data()),
+        const_cast<int*>(csr->col_ind.flat<int32>().data()),
+        const_cast<float*>(csr_values.flat<float>().data()),
+        CUSPARSE_INDEX_32I, CUSPARSE_INDEX_32I, CUSPARSE_INDEX_BASE_ZERO,
+        CUDA_R_32F));
+    const int b_rows = b.dim_size(0);
+    const int b_cols = b.dim_size(1);
+    TF_RETURN_IF_GPUSPARSE_ERROR(cusparseCreateDnMat(
+        &matB, b_cols, b_rows, b_cols,
+        const_cast<float*>(b.flat<float>().data()), CUDA_R_32F,
+        CUSPARSE_ORDER_COL));
+    TF_RETURN_IF_GPUSPARSE_ERROR(
+        cusparseCreateDnMat(&matC, m, p, m, c.flat<float>().data(), CUDA_R_32F,
+                            CUSPARSE_ORDER_COL));
+
+    size_t buffer_size = 0;
+    TF_RETURN_IF_ERROR(cuda_sparse.SpMMBufferSize(
+        transA, transB, &alpha, matA, matB, &beta, matC,
+        CUSPARSE_MM_ALG_DEFAULT, &buffer_size));
+    Tensor buffer;
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(
+        DT_INT8, TensorShape({static_cast<int64>(buffer_size)}), &buffer));
+    TF_RETURN_IF_ERROR(cuda_sparse.SpMM(transA, transB, &alpha, matA, matB,
+                                        &beta, matC, CUSPARSE_MM_ALG_DEFAULT,
+                                        buffer.flat<int8>().data()));
+
+    TF_RETURN_IF_GPUSPARSE_ERROR(cusparseDestroyDnMat(matB));
+    TF_RETURN_IF_GPUSPARSE_ERROR(cusparseDestroyDnMat(matC));
+    TF_RETURN_IF_GPUSPARSE_ERROR(cusparseDestroySpMat(matA));
+
+    TF_RETURN_IF_ERROR(DoTranspose(d, c, {1, 0}, out));
+    *computed = true;
+    return Status::OK();
+  }
+
+ private:
+  // CSR representation of a, or of its adjoint.
+  struct CsrStructure {
+    Tensor row_ptr;
+    Tensor col_ind;
+    // Position in a_values of each CSR value. Left uninitialized when the
+    // indices are already in row-major order.
+    Tensor permutation;
+  };
+
+  Status LookupCsr(OpKernelContext* ctx, bool adjoint_a,
+                   const Tensor& a_indices, int64 num_rows, int64 num_cols,
+                   std::shared_ptr<const CsrStructure>* csr) {
+    mutex_lock l(mu_);
+    const bool same_indices =
+        indices_.IsInitialized() && indices_.shape() == a_indices.shape() &&
+        indices_.tensor_data().data() == a_indices.tensor_data().data() &&
+        adjoint_a_ == adjoint_a && num_rows_ == num_rows &&
+        num_cols_ == num_cols;
+    if (!same_indices) {
+      // Holding on to the indices keeps their buffer from being reused, so
+      // seeing it again means that they are unchanged.
+      indices_ = a_indices;
+      adjoint_a_ = adjoint_a;
+      num_rows_ = num_rows;
+      num_cols_ = num_cols;
+      csr_.reset();
+      csr_built_ = false;
+      return Status::OK();
+    }
+    if (!csr_built_) {
+      csr_built_ = true;
+      TF_RETURN_IF_ERROR(BuildCsr(ctx));
+    }
+    *csr = csr_;
+    return Status::OK();
+  }
+
+  // Leaves csr_ empty if the indices are out of bounds or repeated, which the
+  // functor handles instead.
+  Status BuildCsr(OpKernelContext* ctx) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    se::Stream* stream = ctx->op_device_context()->stream();
+    const int64 nnz = indices_.dim_size(0);
+    std::vector<Tindices> indices(2 * nnz);
+    se::DeviceMemoryBase indices_ptr(
+        const_cast<char*>(indices_.tensor_data().data()),
+        indices_.TotalBytes());
+    if (!stream->ThenMemcpy(indices.data(), indices_ptr, indices_.TotalBytes())
+             .ok()) {
+      return errors::Internal("Failed to copy a_indices to the host");
+    }
+    TF_RETURN_IF_ERROR(stream->BlockHostUntilDone());
+
+    const int lhs_index_a = adjoint_a_ ? 1 : 0;
+    const int rhs_index_a = adjoint_a_ ? 0 : 1;
+    std::vector<int32> rows(nnz);
+    std::vector<int32> cols(nnz);
+    for (int64 i = 0; i < nnz; ++i) {
+      const Tindices row = indices[2 * i + lhs_index_a];
+      const Tindices col = indices[2 * i + rhs_index_a];
+      if (!FastBoundsCheck(row, num_rows_) ||
+          !FastBoundsCheck(col, num_cols_)) {
+        return Status::OK();
+      }
+      rows[i] = row;
+      cols[i] = col;
+    }
+
+    std::vector<int32> permutation(nnz);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    auto row_major_less = [&rows, &cols](int32 i, int32 j) {
+      return rows[i] < rows[j] || (rows[i] == rows[j] && cols[i] < cols[j]);
+    };
+    const bool sorted = std::is_sorted(permutation.begin(), permutation.end(),
+                                       row_major_less);
+    if (!sorted) {
+      std::sort(permutation.begin(), permutation.end(), row_major_less);
+    }
+    std::vector<int32> row_ptr(num_rows_ + 1, 0);
+    std::vector<int32> col_ind(nnz);
+    for (int64 i = 0; i < nnz; ++i) {
+      const int32 j = permutation[i];
+      if (i > 0 && !row_major_less(permutation[i - 1], j)) {
+        return Status::OK();
+      }
+      ++row_ptr[rows[j] + 1];
+      col_ind[i] = cols[j];
+    }
+    std::partial_sum(row_ptr.begin(), row_ptr.end(), row_ptr.begin());
+
+    auto csr = std::make_shared<CsrStructure>();
+    TF_RETURN_IF_ERROR(CopyToDevice(ctx, row_ptr, &csr->row_ptr));
+    TF_RETURN_IF_ERROR(CopyToDevice(ctx, col_ind, &csr->col_ind));
+    if (!sorted) {
+      TF_RETURN_IF_ERROR(CopyToDevice(ctx, permutation, &csr->permutation));
+    }
+    // The host vectors must outlive the copies.
+    TF_RETURN_IF_ERROR(stream->BlockHostUntilDone());
+    csr_ = std::move(csr);
+    return Status::OK();
+  }
+
+  static Status CopyToDevice(OpKernelContext* ctx,
+                             const std::vector<int32>& host, Tensor* device) {
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(
+        DT_INT32, TensorShape({static_cast<int64>(host.size())}), device));
+    se::DeviceMemoryBase device_ptr(device->flat<int32>().data(),
+                                    device->TotalBytes());
+    if (!ctx->op_device_context()
+             ->stream()
+             ->ThenMemcpy(&device_ptr, host.data(), device->TotalBytes())
+             .ok()) {
+      return errors::Internal("Failed to copy the CSR structure to the device");
+    }
+    return Status::OK();
+  }
+
+  mutex mu_;
+  Tensor indices_ TF_GUARDED_BY(mu_);
+  bool adjoint_a_ TF_GUARDED_BY(mu_) = false;
+  int64 num_rows_ TF_GUARDED_BY(mu_) = 0;
+  int64 num_cols_ TF_GUARDED_BY(mu_) = 0;
+  bool csr_built_ TF_GUARDED_BY(mu_) = false;
+  std::shared_ptr<const CsrStructure> csr_ TF_GUARDED_BY(mu_);
+};
+
+#endif  // GOOGLE_CUDA && CUDA_VERSION >= 10020
+
 template <typename Device, typename T, typename Tindices>
 class SparseTensorDenseMatMulOp : public OpKernel {
  public:
@@ -133,6 +381,12 @@ class SparseTensorDenseMatMulOp : public OpKernel {
       return;
     }
 
+    bool computed = false;
+    OP_REQUIRES_OK(ctx, csr_mat_mul_.Compute(ctx, adjoint_a_, adjoint_b_,
+                                             *a_indices, *a_values, *b, out,
+                                             &computed));
+    if (computed) return;
+
 #define MAYBE_ADJOINT(ADJ_A, ADJ_B)                                        \
   if (adjoint_a_ == ADJ_A && adjoint_b_ == ADJ_B) {                        \
     Status functor_status = functor::SparseTensorDenseMatMulFunctor<       \
@@ -154,6 +408,7 @@ class SparseTensorDenseMatMulOp : public OpKernel {
  private:
   bool adjoint_a_;
   bool adjoint_b_;
+  CachedCsrMatMul<Device, T, Tindices> csr_mat_mul_;
 };
 
 #define REGISTER_CPU(TypeT, TypeIndex)           \
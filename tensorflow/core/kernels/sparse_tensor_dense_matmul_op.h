@@ -34,6 +34,16 @@ struct SparseTensorDenseMatMulFunctor {
       typename TTypes<T>::ConstVec a_values, typename TTypes<T>::ConstMatrix b);
 };
 
+// Gathers `out(i) = in(permutation(i))`, e.g. to reorder the values of a
+// sparse tensor into the order of its CSR representation.
+template <typename Device, typename T>
+struct PermuteSparseValuesFunctor {
+  void operator()(const Device& d,
+                  typename TTypes<int32>::ConstVec permutation,
+                  typename TTypes<T>::ConstVec in,
+                  typename TTypes<T>::Vec out);
+};
+
 template <typename MATRIX, bool ADJ>
 class MaybeAdjoint;
 
@@ -58,8 +58,29 @@ __global__ void SparseTensorDenseMatMulKernel(
   }
 }
 
+template <typename T>
+__global__ void PermuteSparseValuesKernel(int size,
+                                          const int32* __restrict__ permutation,
+                                          const T* __restrict__ in,
+                                          T* __restrict__ out) {
+  GPU_1D_KERNEL_LOOP(i, size) { out[i] = ldg(in + ldg(permutation + i)); }
+}
+
 namespace functor {
 
+template <>
+void PermuteSparseValuesFunctor<GPUDevice, float>::operator()(
+    const GPUDevice& d, typename TTypes<int32>::ConstVec permutation,
+    typename TTypes<float>::ConstVec in, typename TTypes<float>::Vec out) {
+  const int size = out.size();
+  if (size == 0) return;
+  GpuLaunchConfig config = GetGpuLaunchConfig(size, d);
+  TF_CHECK_OK(GpuLaunchKernel(PermuteSparseValuesKernel<float>,
+                              config.block_count, config.thread_per_block, 0,
+                              d.stream(), size, permutation.data(), in.data(),
+                              out.data()));
+}
+
 template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
 struct SparseTensorDenseMatMulFunctor<GPUDevice, T, Tindices, ADJ_A, ADJ_B> {
   static EIGEN_ALWAYS_INLINE Status
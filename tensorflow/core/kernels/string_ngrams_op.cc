@@ -19,16 +19,19 @@ limitations under the License.
 #include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace text {
 
 namespace {
-template <typename SPLITS_TYPE>
-class StringNGramsOp : public tensorflow::OpKernel {
+// Reads the ngram attributes and builds ngrams for the kernels below.
+class StringNGramsOpBase : public tensorflow::OpKernel {
  public:
-  explicit StringNGramsOp(tensorflow::OpKernelConstruction* context)
+  explicit StringNGramsOpBase(tensorflow::OpKernelConstruction* context)
       : tensorflow::OpKernel(context) {
     OP_REQUIRES_OK(context, context->GetAttr("separator", &separator_));
     OP_REQUIRES_OK(context, context->GetAttr("ngram_widths", &ngram_widths_));
@@ -52,6 +55,112 @@ class StringNGramsOp : public tensorflow::OpKernel {
     return std::max(0, ((length + 2 * pad_width) - ngram_width) + 1);
   }
 
+  // Returns the number of ngrams of all widths of a sequence of `length`
+  // tokens.
+  int get_total_ngrams(const int length) const {
+    int num_ngrams = 0;
+    for (int ngram_width : ngram_widths_)
+      num_ngrams += get_num_ngrams(length, ngram_width);
+    if (preserve_short_ && length > 0 && num_ngrams == 0) {
+      num_ngrams = 1;
+    }
+    return num_ngrams;
+  }
+
+  // Calls `create(num_ngrams, ngram_width, output_offset)` for each width of
+  // the ngrams of a sequence of `length` tokens, where `output_offset` is the
+  // position of the first ngram of that width among the sequence's ngrams.
+  template <typename CreateFn>
+  void ForEachNgramWidth(const int length, CreateFn create) const {
+    int output_offset = 0;
+    for (int ngram_width : ngram_widths_) {
+      int num_ngrams = get_num_ngrams(length, ngram_width);
+      create(num_ngrams, ngram_width, output_offset);
+      output_offset += num_ngrams;
+    }
+    // If we're preserving short sequences, check to see if no sequence was
+    // generated by comparing the output offset to zero. One legitimate reason
+    // to not have any ngrams when preserve_short_ is true is if the sequence
+    // itself is empty. In that case, move on.
+    if (preserve_short_ && output_offset == 0 && length > 0) {
+      // We don't have to worry about dynamic padding sizes here: if padding
+      // was dynamic, every sequence would have had sufficient padding to
+      // generate at least one ngram.
+      create(1, length + 2 * pad_width_, 0);
+    }
+  }
+
+  // Builds the `ngram_index`th of the `num_ngrams` ngrams of width
+  // `ngram_width` over the tokens at `data` into the empty string `ngram`.
+  template <typename Token, typename String>
+  void CreateNgram(const Token* data, int ngram_index, int num_ngrams,
+                   int ngram_width, String* ngram) const {
+    int pad_width = get_pad_width(ngram_width);
+    int left_padding = std::max(0, pad_width - ngram_index);
+    int right_padding =
+        std::max(0, pad_width - (num_ngrams - (ngram_index + 1)));
+    int num_tokens = ngram_width - (left_padding + right_padding);
+    int data_start_index = left_padding > 0 ? 0 : ngram_index - pad_width;
+
+    // Calculate the total expected size of the ngram so we can reserve the
+    // correct amount of space in the string.
+    int ngram_size = 0;
+    // Size of the left padding.
+    ngram_size += left_padding * left_pad_.length();
+    // Size of the tokens.
+    for (int n = 0; n < num_tokens; ++n) {
+      ngram_size += data[data_start_index + n].length();
+    }
+    // Size of the right padding.
+    ngram_size += right_padding * right_pad_.length();
+    // Size of the separators.
+    int num_separators = left_padding + right_padding + num_tokens - 1;
+    ngram_size += num_separators * separator_.length();
+
+    // Build the ngram.
+    ngram->reserve(ngram_size);
+    for (int n = 0; n < left_padding; ++n) {
+      Append(left_pad_, ngram);
+      Append(separator_, ngram);
+    }
+    for (int n = 0; n < num_tokens - 1; ++n) {
+      Append(data[data_start_index + n], ngram);
+      Append(separator_, ngram);
+    }
+    Append(data[data_start_index + num_tokens - 1], ngram);
+    for (int n = 0; n < right_padding; ++n) {
+      Append(separator_, ngram);
+      Append(right_pad_, ngram);
+    }
+
+    // In debug mode only: validate that we've reserved enough space for the
+    // ngram.
+    DCHECK_EQ(ngram_size, ngram->size());
+  }
+
+ private:
+  template <typename Piece, typename String>
+  static void Append(const Piece& piece, String* ngram) {
+    ngram->append(piece.data(), piece.size());
+  }
+
+  string separator_;
+  string left_pad_;
+  string right_pad_;
+  bool use_pad_;
+  bool extend_pad_;
+  bool preserve_short_;
+
+  std::vector<int> ngram_widths_;
+  int pad_width_;
+};
+
+template <typename SPLITS_TYPE>
+class StringNGramsOp : public StringNGramsOpBase {
+ public:
+  explicit StringNGramsOp(tensorflow::OpKernelConstruction* context)
+      : StringNGramsOpBase(context) {}
+
   void Compute(tensorflow::OpKernelContext* context) override {
     const tensorflow::Tensor* data;
     OP_REQUIRES_OK(context, context->input("data", &data));
@@ -93,13 +202,8 @@ class StringNGramsOp : public tensorflow::OpKernel {
     ngrams_splits_data[0] = 0;
     for (int i = 1; i <= num_batch_items; ++i) {
       int length = splits_vec(i) - splits_vec(i - 1);
-      int num_ngrams = 0;
-      for (int ngram_width : ngram_widths_)
-        num_ngrams += get_num_ngrams(length, ngram_width);
-      if (preserve_short_ && length > 0 && num_ngrams == 0) {
-        num_ngrams = 1;
-      }
-      ngrams_splits_data[i] = ngrams_splits_data[i - 1] + num_ngrams;
+      ngrams_splits_data[i] =
+          ngrams_splits_data[i - 1] + get_total_ngrams(length);
     }
 
     tensorflow::Tensor* ngrams;
@@ -111,94 +215,133 @@ class StringNGramsOp : public tensorflow::OpKernel {
 
     for (int i = 0; i < num_batch_items; ++i) {
       auto data_start = &input_data[splits_vec(i)];
-      int output_start_idx = ngrams_splits_data[i];
-      for (int ngram_width : ngram_widths_) {
-        auto output_start = &ngrams_data[output_start_idx];
-        int length = splits_vec(i + 1) - splits_vec(i);
-        int num_ngrams = get_num_ngrams(length, ngram_width);
-        CreateNgrams(data_start, output_start, num_ngrams, ngram_width);
-        output_start_idx += num_ngrams;
-      }
-      // If we're preserving short sequences, check to see if no sequence was
-      // generated by comparing the current output start idx to the original
-      // one (ngram_splits_data). If no ngrams were generated, then they will
-      // be equal (since we increment output_start_idx by num_ngrams every
-      // time we create a set of ngrams.)
-      if (preserve_short_ && output_start_idx == ngrams_splits_data[i]) {
-        int data_length = splits_vec(i + 1) - splits_vec(i);
-        // One legitimate reason to not have any ngrams when preserve_short_
-        // is true is if the sequence itself is empty. In that case, move on.
-        if (data_length == 0) {
-          continue;
+      auto output_start = &ngrams_data[ngrams_splits_data[i]];
+      int length = splits_vec(i + 1) - splits_vec(i);
+      ForEachNgramWidth(length, [&](int num_ngrams, int ngram_width,
+                                    int output_offset) {
+        for (int ngram_index = 0; ngram_index < num_ngrams; ++ngram_index) {
+          CreateNgram(data_start, ngram_index, num_ngrams, ngram_width,
+                      &output_start[output_offset + ngram_index]);
         }
-        // We don't have to worry about dynamic padding sizes here: if padding
-        // was dynamic, every sequence would have had sufficient padding to
-        // generate at least one ngram.
-        int ngram_width = data_length + 2 * pad_width_;
-        auto output_start = &ngrams_data[output_start_idx];
-        int num_ngrams = 1;
-        CreateNgrams(data_start, output_start, num_ngrams, ngram_width);
-      }
+      });
     }
   }
+};
 
-  void CreateNgrams(const tstring* data, tstring* output, int num_ngrams,
-                    int ngram_width) const {
-    for (int ngram_index = 0; ngram_index < num_ngrams; ++ngram_index) {
-      int pad_width = get_pad_width(ngram_width);
-      int left_padding = std::max(0, pad_width - ngram_index);
-      int right_padding =
-          std::max(0, pad_width - (num_ngrams - (ngram_index + 1)));
-      int num_tokens = ngram_width - (left_padding + right_padding);
-      int data_start_index = left_padding > 0 ? 0 : ngram_index - pad_width;
-
-      // Calculate the total expected size of the ngram so we can reserve the
-      // correct amount of space in the string.
-      int ngram_size = 0;
-      // Size of the left padding.
-      ngram_size += left_padding * left_pad_.length();
-      // Size of the tokens.
-      for (int n = 0; n < num_tokens; ++n) {
-        ngram_size += data[data_start_index + n].length();
-      }
-      // Size of the right padding.
-      ngram_size += right_padding * right_pad_.length();
-      // Size of the separators.
-      int num_separators = left_padding + right_padding + num_tokens - 1;
-      ngram_size += num_separators * separator_.length();
-
-      // Build the ngram.
-      tstring* ngram = &output[ngram_index];
-      ngram->reserve(ngram_size);
-      for (int n = 0; n < left_padding; ++n) {
-        ngram->append(left_pad_);
-        ngram->append(separator_);
-      }
-      for (int n = 0; n < num_tokens - 1; ++n) {
-        ngram->append(data[data_start_index + n]);
-        ngram->append(separator_);
-      }
-      ngram->append(data[data_start_index + num_tokens - 1]);
-      for (int n = 0; n < right_padding; ++n) {
-        ngram->append(separator_);
-        ngram->append(right_pad_);
-      }
+// Splits each input string like StringSplitV2 and hashes its ngrams like
+// StringToHashBucketFast, without materializing the tokens or the ngrams as
+// tensors. Every ngram is built in a scratch buffer that is reused across
+// ngrams, so it hashes to the same bucket as the unfused ops would give it.
+template <typename SPLITS_TYPE>
+class StringSplitNGramsToHashBucketFastOp : public StringNGramsOpBase {
+ public:
+  explicit StringSplitNGramsToHashBucketFastOp(
+      tensorflow::OpKernelConstruction* context)
+      : StringNGramsOpBase(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("num_buckets", &num_buckets_));
+  }
+
+  void Compute(tensorflow::OpKernelContext* context) override {
+    const tensorflow::Tensor* input;
+    OP_REQUIRES_OK(context, context->input("input", &input));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(input->shape()),
+                errors::InvalidArgument("input must be a vector, got shape: ",
+                                        input->shape().DebugString()));
+    const tensorflow::Tensor* sep_tensor;
+    OP_REQUIRES_OK(context, context->input("sep", &sep_tensor));
+    OP_REQUIRES(context, TensorShapeUtils::IsScalar(sep_tensor->shape()),
+                errors::InvalidArgument("sep must be a scalar, got shape: ",
+                                        sep_tensor->shape().DebugString()));
+    const StringPiece sep(sep_tensor->scalar<tstring>()());
+    const auto input_vec = input->vec<tstring>();
+    const int64 num_batch_items = input_vec.size();
 
-      // In debug mode only: validate that we've reserved enough space for the
-      // ngram.
-      DCHECK_EQ(ngram_size, ngram->size());
+    // The tokens of all inputs, as views into the input strings.
+    std::vector<StringPiece> tokens;
+    std::vector<int64> tokens_splits(num_batch_items + 1, 0);
+    for (int64 i = 0; i < num_batch_items; ++i) {
+      Split(input_vec(i), sep, &tokens);
+      tokens_splits[i + 1] = tokens.size();
     }
+
+    tensorflow::Tensor* ngrams_splits;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       1, TensorShape({num_batch_items + 1}), &ngrams_splits));
+    auto ngrams_splits_data = ngrams_splits->flat<SPLITS_TYPE>().data();
+    // Inputs without tokens have no ngrams, even padded ones.
+    ngrams_splits_data[0] = 0;
+    for (int64 i = 0; i < num_batch_items; ++i) {
+      int length = tokens_splits[i + 1] - tokens_splits[i];
+      ngrams_splits_data[i + 1] =
+          ngrams_splits_data[i] + (length > 0 ? get_total_ngrams(length) : 0);
+    }
+
+    tensorflow::Tensor* values;
+    OP_REQUIRES_OK(
+        context,
+        context->allocate_output(
+            0, TensorShape({ngrams_splits_data[num_batch_items]}), &values));
+    auto values_data = values->flat<int64>().data();
+
+    auto hash_ngrams = [&](int64 start, int64 limit) {
+      string ngram;
+      for (int64 i = start; i < limit; ++i) {
+        const StringPiece* data_start = tokens.data() + tokens_splits[i];
+        int64* output_start = values_data + ngrams_splits_data[i];
+        int length = tokens_splits[i + 1] - tokens_splits[i];
+        if (length == 0) continue;
+        ForEachNgramWidth(length, [&](int num_ngrams, int ngram_width,
+                                      int output_offset) {
+          for (int ngram_index = 0; ngram_index < num_ngrams; ++ngram_index) {
+            ngram.clear();
+            CreateNgram(data_start, ngram_index, num_ngrams, ngram_width,
+                        &ngram);
+            // The number of buckets is always in the positive range of int64
+            // so is the resulting bucket id.
+            output_start[output_offset + ngram_index] =
+                static_cast<int64>(Fingerprint64(ngram) % num_buckets_);
+          }
+        });
+      }
+    };
+    const int64 num_values = ngrams_splits_data[num_batch_items];
+    const int64 cost_per_item =
+        num_batch_items > 0
+            ? 50 * (num_values + tokens.size()) / num_batch_items + 1
+            : 1;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers,
+          num_batch_items, cost_per_item, hash_ngrams);
   }
 
-  string separator_;
-  string left_pad_;
-  string right_pad_;
-  bool use_pad_;
-  bool extend_pad_;
-  bool preserve_short_;
+ private:
+  // Appends the tokens of `str` to `tokens`, with the semantics of
+  // StringSplitV2 without `maxsplit`.
+  static void Split(const tstring& str, StringPiece sep,
+                    std::vector<StringPiece>* tokens) {
+    StringPiece text(str);
+    if (sep.empty()) {
+      StringPiece token;
+      str_util::RemoveLeadingWhitespace(&text);
+      while (str_util::ConsumeNonWhitespace(&text, &token)) {
+        tokens->push_back(token);
+        str_util::RemoveLeadingWhitespace(&text);
+      }
+      return;
+    }
+    auto p = std::search(text.begin(), text.end(), sep.begin(), sep.end());
+    while (p != text.end()) {
+      StringPiece token = text.substr(0, p - text.begin());
+      tokens->push_back(token);
+      text.remove_prefix(token.size());
+      text.remove_prefix(sep.size());
+      p = std::search(text.begin(), text.end(), sep.begin(), sep.end());
+    }
+    tokens->push_back(text);
+  }
 
-  std::vector<int> ngram_widths_;
-  int pad_width_;
+  int64 num_buckets_;
 };
 
 }  // namespace
@@ -210,6 +353,14 @@ REGISTER_KERNEL_BUILDER(Name("StringNGrams")
                             .Device(tensorflow::DEVICE_CPU)
                             .TypeConstraint<int64>("Tsplits"),
                         StringNGramsOp<int64>);
+REGISTER_KERNEL_BUILDER(Name("StringSplitNGramsToHashBucketFast")
+                            .Device(tensorflow::DEVICE_CPU)
+                            .TypeConstraint<int32>("Tsplits"),
+                        StringSplitNGramsToHashBucketFastOp<int32>);
+REGISTER_KERNEL_BUILDER(Name("StringSplitNGramsToHashBucketFast")
+                            .Device(tensorflow::DEVICE_CPU)
+                            .TypeConstraint<int64>("Tsplits"),
+                        StringSplitNGramsToHashBucketFastOp<int64>);
 
 }  // namespace text
 }  // namespace tensorflow
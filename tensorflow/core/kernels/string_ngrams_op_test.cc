@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/fingerprint.h"
 
 namespace tensorflow {
 namespace text {
@@ -551,5 +552,81 @@ TEST_F(NgramKernelTest, ShapeFn) {
   INFER_ERROR("Shape must be rank 1 but is rank 0", op, "?;[]");
 }
 
+class SplitNgramsHashKernelTest : public NgramKernelTest {
+ public:
+  void MakeOp(string separator, std::vector<int> ngram_width, string left_pad,
+              string right_pad, int pad_width, bool preserve) {
+    TF_ASSERT_OK(
+        NodeDefBuilder("tested_op", "StringSplitNGramsToHashBucketFast")
+            .Attr("separator", separator)
+            .Attr("ngram_widths", ngram_width)
+            .Attr("left_pad", left_pad)
+            .Attr("right_pad", right_pad)
+            .Attr("pad_width", pad_width)
+            .Attr("preserve_short_sequences", preserve)
+            .Attr("num_buckets", kNumBuckets)
+            .Input(FakeInput())
+            .Input(FakeInput())
+            .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Checks that the values are the buckets StringToHashBucketFast gives
+  // `expected_ngrams`.
+  void assert_buckets_equal(const std::vector<tstring> &expected_ngrams,
+                            const Tensor &value) {
+    std::vector<int64> expected_buckets;
+    for (const tstring &ngram : expected_ngrams) {
+      expected_buckets.push_back(Fingerprint64(ngram) % kNumBuckets);
+    }
+    assert_int64_equal(expected_buckets, value);
+  }
+
+  static constexpr int64 kNumBuckets = 1 << 20;
+};
+
+constexpr int64 SplitNgramsHashKernelTest::kNumBuckets;
+
+TEST_F(SplitNgramsHashKernelTest, TestPaddedBigramsOnWhitespace) {
+  MakeOp("|", {2}, "LP", "RP", -1, false);
+  AddInputFromArray<tstring>(TensorShape({4}),
+                             {"a b  c", "  d ", "", "e\tf"});
+  AddInputFromArray<tstring>(TensorShape({}), {""});
+  TF_ASSERT_OK(RunOpKernel());
+
+  std::vector<tstring> expected_ngrams(            //
+      {"LP|a", "a|b", "b|c", "c|RP",               // 0
+       "LP|d", "d|RP",                             // 1
+       "LP|e", "e|f", "f|RP"});                    // 3
+  std::vector<int64> expected_splits({0, 4, 6, 6, 9});
+
+  assert_buckets_equal(expected_ngrams, *GetOutput(0));
+  assert_int64_equal(expected_splits, *GetOutput(1));
+}
+
+TEST_F(SplitNgramsHashKernelTest, TestPreserveShortOnSeparator) {
+  MakeOp(" ", {3}, "", "", 0, true);
+  AddInputFromArray<tstring>(TensorShape({3}), {"a,b", "a,,b,c", "d"});
+  AddInputFromArray<tstring>(TensorShape({}), {","});
+  TF_ASSERT_OK(RunOpKernel());
+
+  std::vector<tstring> expected_ngrams(  //
+      {"a b",                            // 0
+       "a  b", " b c",                   // 1
+       "d"});                            // 2
+  std::vector<int64> expected_splits({0, 1, 3, 4});
+
+  assert_buckets_equal(expected_ngrams, *GetOutput(0));
+  assert_int64_equal(expected_splits, *GetOutput(1));
+}
+
+TEST_F(SplitNgramsHashKernelTest, ShapeFn) {
+  ShapeInferenceTestOp op("StringSplitNGramsToHashBucketFast");
+  INFER_OK(op, "?;?", "[?];[?]");
+  INFER_OK(op, "[3];[]", "[?];[4]");
+  INFER_ERROR("Shape must be rank 1 but is rank 0", op, "[];?");
+  INFER_ERROR("Shape must be rank 0 but is rank 1", op, "?;[1]");
+}
+
 }  // namespace text
 }  // namespace tensorflow
@@ -99,6 +99,116 @@ class TopK : public OpKernel {
 
 namespace functor {
 
+// Rows at least this long are selected by SelectTopK, in blocks of at least
+// this size when there are fewer rows than threads.
+constexpr int64 kMinTopKBlockSize = 1 << 14;
+
+// Orders indices into `input` by decreasing value, then increasing index.
+template <typename T>
+struct TopKGreater {
+  bool operator()(const int32 a, const int32 b) const {
+    if (input[b] < input[a]) {
+      return true;
+    } else if (input[b] > input[a]) {
+      return false;
+    } else {
+      return a < b;
+    }
+  }
+  const T* input;
+};
+
+// Writes the indices of the top `k` elements of input[start, end) to `top`,
+// in no particular order. Requires end - start >= k.
+//
+// Only elements larger than the k-th largest one seen so far are kept as
+// candidates, and the candidates are cut back to k with a partial selection
+// whenever they number 2k. Elements are compared against the threshold 16 at
+// a time, so that the common case of rejecting them all vectorizes.
+template <typename T>
+void SelectTopK(const T* input, int32 start, int32 end, int k, int32* top) {
+  const TopKGreater<T> greater{input};
+  std::vector<int32> candidates(k);
+  std::iota(candidates.begin(), candidates.end(), start);
+  candidates.reserve(2 * k);
+  T threshold;
+  auto shrink = [&]() {
+    std::nth_element(candidates.begin(), candidates.begin() + k - 1,
+                     candidates.end(), greater);
+    candidates.resize(k);
+    threshold = input[candidates[k - 1]];
+  };
+  shrink();
+
+  // Later elements lose ties, so only larger ones become candidates.
+  auto maybe_push = [&](int32 i) {
+    if (threshold < input[i]) {
+      candidates.push_back(i);
+      if (candidates.size() == 2 * static_cast<size_t>(k)) shrink();
+    }
+  };
+  constexpr int kBatchSize = 16;
+  int32 i = start + k;
+  for (; i + kBatchSize <= end; i += kBatchSize) {
+    bool any_larger = false;
+    for (int j = 0; j < kBatchSize; ++j) {
+      any_larger |= threshold < input[i + j];
+    }
+    if (!any_larger) continue;
+    for (int j = 0; j < kBatchSize; ++j) maybe_push(i + j);
+  }
+  for (; i < end; ++i) maybe_push(i);
+
+  if (candidates.size() > static_cast<size_t>(k)) shrink();
+  std::copy(candidates.begin(), candidates.end(), top);
+}
+
+// Computes the top k of each row from the top k of `blocks_per_row` blocks
+// of it, which are selected in parallel.
+template <typename T>
+void BlockedTopK(OpKernelContext* context, int k,
+                 const typename TTypes<T, 2>::ConstTensor& input,
+                 const int64 num_rows, const int64 num_cols,
+                 const int64 blocks_per_row,
+                 typename TTypes<T, 2>::Tensor values,
+                 typename TTypes<int, 2>::Tensor indices) {
+  const int64 block_size = num_cols / blocks_per_row;
+  std::vector<int32> block_top(num_rows * blocks_per_row * k);
+  auto select_blocks = [&](int64 start_block, int64 limit_block) {
+    for (int64 block = start_block; block < limit_block; ++block) {
+      const int64 row = block / blocks_per_row;
+      const int64 i = block % blocks_per_row;
+      // The last block takes the remainder of the row.
+      const int32 start = i * block_size;
+      const int32 end = i == blocks_per_row - 1 ? num_cols : start + block_size;
+      SelectTopK(&input(row, 0), start, end, k, &block_top[block * k]);
+    }
+  };
+  const double cmp_cost = Eigen::TensorOpCost::AddCost<T>();
+  auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers,
+        num_rows * blocks_per_row, static_cast<int64>(cmp_cost * block_size),
+        select_blocks);
+
+  // Merging always sorts, which also satisfies sorted=False.
+  auto merge_rows = [&](int64 start_row, int64 limit_row) {
+    for (int64 row = start_row; row < limit_row; ++row) {
+      int32* begin = &block_top[row * blocks_per_row * k];
+      int32* end = begin + blocks_per_row * k;
+      std::partial_sort(begin, begin + k, end, TopKGreater<T>{&input(row, 0)});
+      std::copy(begin, begin + k, &indices(row, 0));
+      std::transform(
+          begin, begin + k, &values(row, 0),
+          [row, &input](const int32 loc) { return input(row, loc); });
+    }
+  };
+  const int64 merge_cost = static_cast<int64>(
+      3 * cmp_cost * blocks_per_row * k *
+      Eigen::numext::log2(static_cast<float>(k + 1)));
+  Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
+        merge_cost, merge_rows);
+}
+
 template <typename T>
 struct TopKFunctor<CPUDevice, T> {
   static EIGEN_ALWAYS_INLINE Status
@@ -136,6 +246,19 @@ struct TopKFunctor<CPUDevice, T> {
       return Status::OK();
     }
 
+    // Long rows are split into blocks so that a few of them, e.g. a batch of
+    // one over a large vocabulary, still keep all threads busy.
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    const int64 min_block_size = std::max<int64>(kMinTopKBlockSize, 4 * k);
+    if (num_cols >= min_block_size) {
+      const int64 blocks_per_row = std::min<int64>(
+          (worker_threads.num_threads + num_rows - 1) / num_rows,
+          num_cols / min_block_size);
+      BlockedTopK<T>(context, k, input, num_rows, num_cols,
+                     std::max<int64>(blocks_per_row, 1), values, indices);
+      return Status::OK();
+    }
+
     auto SortIndices = [&](int64 start_batch, int64 limit_batch) {
       for (int32 b = start_batch; b < limit_batch; ++b) {
         const T* input_data = &input(b, 0);
@@ -221,7 +344,6 @@ struct TopKFunctor<CPUDevice, T> {
     const int64 final_cost = (total_cost >= static_cast<double>(kint64max))
                                  ? kint64max
                                  : static_cast<int64>(total_cost);
-    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
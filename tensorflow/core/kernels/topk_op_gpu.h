@@ -19,6 +19,7 @@ limitations under the License.
 
 #define EIGEN_USE_GPU
 
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <vector>
@@ -378,10 +379,65 @@ TopKKernel(const T* __restrict__ input, int length, int k, bool sorted,
   }
 }
 
+// Like TopKKernel, but for `num_segments` contiguous segments of each row,
+// the last of which takes the remainder of the row. Block i computes the top
+// k of segment i % num_segments of row i / num_segments, with indices into
+// the row, into the i-th group of k outputs.
 template <typename T>
-cudaError LaunchTopKKernel(const gpuStream_t& stream, int num_shards,
-                           const T* input, int batch_size, int length, int k,
-                           bool sorted, T* output, int* indices) {
+#if TENSORFLOW_USE_ROCM
+__attribute__((amdgpu_flat_work_group_size(1, 256)))
+#endif  // TENSORFLOW_USE_ROCM
+__global__ void
+SegmentedTopKKernel(const T* __restrict__ input, int length,
+                    int segment_length, int num_segments, int k,
+                    T* __restrict__ output, int* __restrict__ indices) {
+#if TENSORFLOW_USE_ROCM
+  HIP_DYNAMIC_SHARED(char, shared_memory);
+#endif  // TENSORFLOW_USE_ROCM
+
+  const int batch_index = blockIdx.x / num_segments;
+  const int segment = blockIdx.x % num_segments;
+  const int segment_start = segment * segment_length;
+  const int segment_end =
+      segment == num_segments - 1 ? length : segment_start + segment_length;
+  const T* segment_input = input + batch_index * length + segment_start;
+
+  const int thread_index = threadIdx.x;
+  const int thread_count = blockDim.x;
+
+  Entry<T>* shared_entries = (Entry<T>*)shared_memory;
+
+  heapTopK<T, StridedData>(segment_input, segment_end - segment_start, k,
+                           shared_entries, true, thread_index, thread_count);
+
+  __syncthreads();
+  if (thread_index == 0) {
+    const int offset = blockIdx.x * k;
+    auto segment_output = output + offset;
+    auto segment_indices = indices + offset;
+    Entry<T>* top_k_heap = shared_entries + thread_count * k;
+    mergeShards(thread_count, k, shared_entries, top_k_heap, segment_output,
+                segment_indices);
+    for (int i = 0; i < k; ++i) {
+      segment_indices[i] += segment_start;
+    }
+  }
+}
+
+// Maps positions among the candidates of each row to the indices that the
+// candidates have in the input.
+__global__ void GatherCandidateIndicesKernel(
+    const int* __restrict__ candidate_indices, int num_candidates, int k,
+    int size, int* __restrict__ indices) {
+  GPU_1D_KERNEL_LOOP(i, size) {
+    const int row = i / k;
+    indices[i] = candidate_indices[row * num_candidates + indices[i]];
+  }
+}
+
+// Returns the number of threads that TopKKernel uses for one row.
+template <typename T>
+int NumTopKShards(int length, int k) {
   // This code assumes that k is small enough that the computation
   // fits inside shared memory (hard coded to 48KB).  In practice this
   // means k <= 3072 for T=float/int32 and k <= 2048 for T=double/int64.
@@ -389,32 +445,40 @@ cudaError LaunchTopKKernel(const gpuStream_t& stream, int num_shards,
   //   shared_memory_size / (2 * (sizeof(int) + sizeof(T))) < k.
 
   // Use as many shards as possible.
+  constexpr auto shared_memory_size = 48 << 10;  // 48 KB
+  const auto heap_size = k * sizeof(Entry<T>);
+  // shared_memory_size = (num_shards + 1) * heap_size <=>
+  int num_shards = shared_memory_size / heap_size - 1;
   if (num_shards <= 0) {
-    constexpr auto shared_memory_size = 48 << 10;  // 48 KB
-    const auto heap_size = k * sizeof(Entry<T>);
-    // shared_memory_size = (num_shards + 1) * heap_size <=>
-    num_shards = shared_memory_size / heap_size - 1;
-    if (num_shards <= 0) {
-      num_shards = 1;
-    }
-    auto shard_size = length / num_shards;
-    auto min_shard_size = 2 * k;
-    if (shard_size < min_shard_size) {
-      num_shards = length / min_shard_size;
-    }
-    if (num_shards <= 0) {
-      num_shards = 1;
+    num_shards = 1;
+  }
+  auto shard_size = length / num_shards;
+  auto min_shard_size = 2 * k;
+  if (shard_size < min_shard_size) {
+    num_shards = length / min_shard_size;
+  }
+  if (num_shards <= 0) {
+    num_shards = 1;
 #if GOOGLE_CUDA
-    } else if (num_shards > 1024) {
-      num_shards = 1024;
-    }
+  } else if (num_shards > 1024) {
+    num_shards = 1024;
+  }
 #elif TENSORFLOW_USE_ROCM
-      // ROCm can't execute with 1024 and requires an explicit
-      // amdgpu_flat_work_group_size attribute with >256
-    } else if (num_shards > 256) {
-      num_shards = 256;
-    }
+    // ROCm can't execute with 1024 and requires an explicit
+    // amdgpu_flat_work_group_size attribute with >256
+  } else if (num_shards > 256) {
+    num_shards = 256;
+  }
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  return num_shards;
+}
+
+template <typename T>
+cudaError LaunchTopKKernel(const gpuStream_t& stream, int num_shards,
+                           const T* input, int batch_size, int length, int k,
+                           bool sorted, T* output, int* indices) {
+  if (num_shards <= 0) {
+    num_shards = NumTopKShards<T>(length, k);
   }
   // We are limited by the amount of shared memory we have per block.
   auto shared_memory_size = (num_shards + 1) * k * sizeof(Entry<T>);
@@ -425,6 +489,55 @@ cudaError LaunchTopKKernel(const gpuStream_t& stream, int num_shards,
   return cudaGetLastError();
 }
 
+// Rows are split into segments of at least this many elements when there are
+// too few rows to give every multiprocessor blocks of its own.
+constexpr int kMinTopKSegmentLength = 1 << 14;
+
+// Computes the top k of each row in two passes, for few rows that are much
+// longer than k: the top k of each of `num_segments` segments of a row are
+// computed by blocks of their own, and then the top k of these candidates.
+template <typename T>
+Status LaunchSegmentedTopKKernel(OpKernelContext* ctx, const T* input,
+                                 int num_rows, int num_cols, int num_segments,
+                                 int k, T* values, int* indices) {
+  const GPUDevice& d = ctx->eigen_device<GPUDevice>();
+  const auto& cu_stream = GetGpuStream(ctx);
+  const int num_candidates = num_segments * k;
+  Tensor candidate_values;
+  Tensor candidate_indices;
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(DataTypeToEnum<T>::value,
+                                        TensorShape({num_rows, num_candidates}),
+                                        &candidate_values));
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(
+      DT_INT32, TensorShape({num_rows, num_candidates}), &candidate_indices));
+
+  const int segment_length = num_cols / num_segments;
+  const int num_shards = NumTopKShards<T>(segment_length, k);
+  TF_CHECK_OK(GpuLaunchKernel(
+      SegmentedTopKKernel<T>, num_rows * num_segments, num_shards,
+      (num_shards + 1) * k * sizeof(Entry<T>), cu_stream, input, num_cols,
+      segment_length, num_segments, k, candidate_values.flat<T>().data(),
+      candidate_indices.flat<int32>().data()));
+
+  // Candidates of equal value are ordered by index, so the positions that
+  // the heap kernel prefers for ties also have the lowest indices.
+  auto err = LaunchTopKKernel(cu_stream, /* num_shards */ 0,
+                              candidate_values.flat<T>().data(), num_rows,
+                              num_candidates, k, /* sorted */ true, values,
+                              indices);
+  if (err != cudaSuccess) {
+    return errors::Internal("Could not launch TopKKernel: ",
+                            cudaGetErrorString(err), ".");
+  }
+  const int size = num_rows * k;
+  GpuLaunchConfig config = GetGpuLaunchConfig(size, d);
+  TF_CHECK_OK(GpuLaunchKernel(GatherCandidateIndicesKernel,
+                              config.block_count, config.thread_per_block, 0,
+                              cu_stream, candidate_indices.flat<int32>().data(),
+                              num_candidates, k, size, indices));
+  return Status::OK();
+}
+
 struct SegmentOffsetCreator {
   EIGEN_DEVICE_FUNC
   SegmentOffsetCreator(int num_cols) : num_cols_(num_cols) {}
@@ -566,6 +679,18 @@ struct TopKFunctor<GPUDevice, T> {
     if (num_cols <= 1000 || k == num_cols || k >= 100) {
       return impl::LaunchSortKernel(context, input.data(), num_rows, num_cols,
                                     k, values, indices);
+    }
+    // A block per row leaves most multiprocessors idle for few long rows,
+    // e.g. for a batch of one over a large vocabulary.
+    const int num_multiprocessors =
+        context->eigen_device<GPUDevice>().getNumGpuMultiProcessors();
+    const int num_segments = std::min<int64>(
+        (2 * num_multiprocessors + num_rows - 1) / num_rows,
+        num_cols / std::max<int64>(impl::kMinTopKSegmentLength, 64 * k));
+    if (num_segments > 1) {
+      return impl::LaunchSegmentedTopKKernel(context, input.data(), num_rows,
+                                             num_cols, num_segments, k,
+                                             values.data(), indices.data());
     } else {
       const auto& cu_stream = GetGpuStream(context);
       auto err = impl::LaunchTopKKernel(cu_stream, /* num_shards */ 0,
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <algorithm>  // NOLINT
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -25,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/variable_ops.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/util.h"
 
 namespace tensorflow {
@@ -929,6 +931,104 @@ struct ApplyPowerSign<CPUDevice, T> {
 
 }  // namespace functor
 
+namespace {
+
+// Sums the rows of `grad` that share an index, so that a sparse update
+// touches every row of the variable once and the rows can be updated in
+// parallel. Unique indices keep the order of their first occurrence and the
+// rows of an index are summed in input order, so the result is
+// deterministic.
+template <typename T, typename Tindex>
+Status DeduplicateSparseGradient(OpKernelContext* ctx, const Tensor& grad,
+                                 const Tensor& indices, int64 first_dim_size,
+                                 Tensor* unique_grad, Tensor* unique_indices) {
+  const auto indices_vec = indices.vec<Tindex>();
+  const Tindex N = static_cast<Tindex>(indices_vec.dimension(0));
+  if (N == 0) {
+    *unique_grad = grad;
+    *unique_indices = indices;
+    return Status::OK();
+  }
+
+  // Position of every input row among the unique indices.
+  absl::flat_hash_map<Tindex, Tindex> unique_positions;
+  unique_positions.reserve(N);
+  std::vector<Tindex> uniques;
+  std::vector<Tindex> positions(N);
+  for (Tindex i = 0; i < N; ++i) {
+    const Tindex index = internal::SubtleMustCopy(indices_vec(i));
+    if (!FastBoundsCheck(index, first_dim_size)) {
+      return errors::InvalidArgument(
+          strings::StrCat("Index ", index, " at offset ", i,
+                          " in indices is out of range"));
+    }
+    const auto inserted = unique_positions.emplace(
+        index, static_cast<Tindex>(uniques.size()));
+    if (inserted.second) uniques.push_back(index);
+    positions[i] = inserted.first->second;
+  }
+  const Tindex num_unique = static_cast<Tindex>(uniques.size());
+
+  // Group the input rows by unique index.
+  std::vector<Tindex> row_starts(num_unique + 1, 0);
+  for (Tindex i = 0; i < N; ++i) ++row_starts[positions[i] + 1];
+  for (Tindex u = 0; u < num_unique; ++u) row_starts[u + 1] += row_starts[u];
+  std::vector<Tindex> rows(N);
+  std::vector<Tindex> next_rows(row_starts.begin(), row_starts.end() - 1);
+  for (Tindex i = 0; i < N; ++i) rows[next_rows[positions[i]]++] = i;
+
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(DataTypeToEnum<Tindex>::value,
+                                        TensorShape({num_unique}),
+                                        unique_indices));
+  std::copy(uniques.begin(), uniques.end(),
+            unique_indices->vec<Tindex>().data());
+  TensorShape unique_grad_shape = grad.shape();
+  unique_grad_shape.set_dim(0, num_unique);
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(DataTypeToEnum<T>::value,
+                                        unique_grad_shape, unique_grad));
+
+  const auto grad_flat = grad.flat_outer_dims<T>();
+  auto unique_grad_flat = unique_grad->flat_outer_dims<T>();
+  const int64 inner_dim = grad_flat.dimension(1);
+  const double rows_per_unique = static_cast<double>(N) / num_unique;
+  const Eigen::TensorOpCost cost(
+      rows_per_unique * inner_dim * sizeof(T), inner_dim * sizeof(T),
+      rows_per_unique * inner_dim * Eigen::TensorOpCost::AddCost<T>());
+  const auto shard = [&](Eigen::Index start, Eigen::Index end) -> void {
+    for (Eigen::Index u = start; u < end; ++u) {
+      auto sum = unique_grad_flat.template chip<0>(u);
+      sum = grad_flat.template chip<0>(rows[row_starts[u]]);
+      for (Tindex r = row_starts[u] + 1; r < row_starts[u + 1]; ++r) {
+        sum += grad_flat.template chip<0>(rows[r]);
+      }
+    }
+  };
+  ctx->eigen_device<CPUDevice>().parallelFor(num_unique, cost, shard);
+  return Status::OK();
+}
+
+// Runs `apply(start, end)` on shards of the `num_rows` rows of a
+// deduplicated sparse update. Every variable row is updated by a single
+// shard, so the shards can run concurrently.
+template <typename Tindex>
+Status ParallelApplyUniqueRows(
+    OpKernelContext* ctx, Tindex num_rows, const Eigen::TensorOpCost& cost,
+    const std::function<Status(Tindex, Tindex)>& apply) {
+  mutex mu;
+  Status status;
+  const auto shard = [&](Eigen::Index start, Eigen::Index end) -> void {
+    Status shard_status = apply(start, end);
+    if (!shard_status.ok()) {
+      mutex_lock l(mu);
+      status.Update(shard_status);
+    }
+  };
+  ctx->eigen_device<CPUDevice>().parallelFor(num_rows, cost, shard);
+  return status;
+}
+
+}  // namespace
+
 template <typename Device, typename T>
 class ApplyGradientDescentOp : public OpKernel {
  public:
@@ -1852,7 +1952,13 @@ class SparseApplyAdagradOp : public OpKernel {
   explicit SparseApplyAdagradOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("update_slots", &update_slots_));
-  }
+
+    OP_REQUIRES_OK(ctx,
+                   ctx->GetAttr("deduplicate_indices", &deduplicate_indices_));
+    OP_REQUIRES(
+        ctx, !deduplicate_indices_ || (std::is_same<Device, CPUDevice>::value),
+        errors::Unimplemented("deduplicate_indices is only supported on CPU"));
+ }
 
   void Compute(OpKernelContext* ctx) override TF_NO_THREAD_SAFETY_ANALYSIS {
     const bool sparse = true;
@@ -1906,14 +2012,26 @@ class SparseApplyAdagradOp : public OpKernel {
                 errors::InvalidArgument(
                     "Inner dimension should be greater than zero."));
 
+    Tensor unique_grad;
+    Tensor unique_indices;
+    if (deduplicate_indices_) {
+      OP_REQUIRES_OK(ctx, DeduplicateSparseGradient<T, Tindex>(
+                              ctx, grad, indices, var.dim_size(0),
+                              &unique_grad, &unique_indices));
+    }
+    const Tensor& apply_grad = deduplicate_indices_ ? unique_grad : grad;
+    const Tensor& apply_indices =
+        deduplicate_indices_ ? unique_indices : indices;
+
     const Device& device = ctx->template eigen_device<Device>();
     OP_REQUIRES_OK(
-        ctx, functor::SparseApplyAdagrad<Device, T, Tindex,
-                                         /*has_epsilon = */ false>()(
-                 device, var.flat_outer_dims<T>(), accum.flat_outer_dims<T>(),
-                 // Note: Passing lr as a placeholder for unused epsilon.
-                 lr.scalar<T>(), lr.scalar<T>(), grad.flat_outer_dims<T>(),
-                 indices.vec<Tindex>(), inner_dim, update_slots_));
+        ctx,
+        functor::SparseApplyAdagrad<Device, T, Tindex,
+                                    /*has_epsilon = */ false>()(
+            device, var.flat_outer_dims<T>(), accum.flat_outer_dims<T>(),
+            // Note: Passing lr as a placeholder for unused epsilon.
+            lr.scalar<T>(), lr.scalar<T>(), apply_grad.flat_outer_dims<T>(),
+            apply_indices.vec<Tindex>(), inner_dim, update_slots_));
 
     MaybeForwardRefInputToRefOutput(ctx, 0, 0);
   }
@@ -1921,6 +2039,7 @@ class SparseApplyAdagradOp : public OpKernel {
  private:
   bool use_exclusive_lock_;
   bool update_slots_;
+  bool deduplicate_indices_;
 };
 
 #define REGISTER_KERNELS(D, T, Tindices)                                 \
@@ -1982,7 +2101,13 @@ class SparseApplyAdagradV2Op : public OpKernel {
   explicit SparseApplyAdagradV2Op(OpKernelConstruction* ctx) : OpKernel(ctx) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("update_slots", &update_slots_));
-  }
+
+    OP_REQUIRES_OK(ctx,
+                   ctx->GetAttr("deduplicate_indices", &deduplicate_indices_));
+    OP_REQUIRES(
+        ctx, !deduplicate_indices_ || (std::is_same<Device, CPUDevice>::value),
+        errors::Unimplemented("deduplicate_indices is only supported on CPU"));
+ }
 
   void Compute(OpKernelContext* ctx) override TF_NO_THREAD_SAFETY_ANALYSIS {
     const bool sparse = true;
@@ -2040,13 +2165,25 @@ class SparseApplyAdagradV2Op : public OpKernel {
                 errors::InvalidArgument(
                     "Inner dimension should be greater than zero."));
 
+    Tensor unique_grad;
+    Tensor unique_indices;
+    if (deduplicate_indices_) {
+      OP_REQUIRES_OK(ctx, DeduplicateSparseGradient<T, Tindex>(
+                              ctx, grad, indices, var.dim_size(0),
+                              &unique_grad, &unique_indices));
+    }
+    const Tensor& apply_grad = deduplicate_indices_ ? unique_grad : grad;
+    const Tensor& apply_indices =
+        deduplicate_indices_ ? unique_indices : indices;
+
     const Device& device = ctx->template eigen_device<Device>();
     OP_REQUIRES_OK(
         ctx, functor::SparseApplyAdagrad<Device, T, Tindex,
                                          /*has_epsilon = */ true>()(
                  device, var.flat_outer_dims<T>(), accum.flat_outer_dims<T>(),
-                 lr.scalar<T>(), epsilon.scalar<T>(), grad.flat_outer_dims<T>(),
-                 indices.vec<Tindex>(), inner_dim, update_slots_));
+                 lr.scalar<T>(), epsilon.scalar<T>(),
+                 apply_grad.flat_outer_dims<T>(), apply_indices.vec<Tindex>(),
+                 inner_dim, update_slots_));
 
     MaybeForwardRefInputToRefOutput(ctx, 0, 0);
   }
@@ -2054,6 +2191,7 @@ class SparseApplyAdagradV2Op : public OpKernel {
  private:
   bool use_exclusive_lock_;
   bool update_slots_;
+  bool deduplicate_indices_;
 };
 
 #define REGISTER_KERNELS(D, T, Tindices)                                   \
@@ -2770,7 +2908,13 @@ class SparseApplyFtrlOp : public OpKernel {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
     OP_REQUIRES_OK(
         ctx, ctx->GetAttr("multiply_linear_by_lr", &multiply_linear_by_lr_));
-  }
+
+    OP_REQUIRES_OK(ctx,
+                   ctx->GetAttr("deduplicate_indices", &deduplicate_indices_));
+    OP_REQUIRES(
+        ctx, !deduplicate_indices_ || (std::is_same<Device, CPUDevice>::value),
+        errors::Unimplemented("deduplicate_indices is only supported on CPU"));
+ }
 
   void Compute(OpKernelContext* ctx) override TF_NO_THREAD_SAFETY_ANALYSIS {
     const bool sparse = true;
@@ -2885,18 +3029,48 @@ class SparseApplyFtrlOp : public OpKernel {
                                   l2_shrinkage->shape().DebugString()));
     }
 
+    Tensor unique_grad;
+    Tensor unique_indices;
+    if (deduplicate_indices_) {
+      OP_REQUIRES_OK(ctx, DeduplicateSparseGradient<T, Tindex>(
+                              ctx, grad, indices, var.dim_size(0),
+                              &unique_grad, &unique_indices));
+    }
+    const Tensor& apply_grad = deduplicate_indices_ ? unique_grad : grad;
+    const Tensor& apply_indices =
+        deduplicate_indices_ ? unique_indices : indices;
+
     const Device& device = ctx->template eigen_device<Device>();
-    auto indices_vec = indices.vec<Tindex>();
-    OP_REQUIRES_OK(
-        ctx, functor::SparseApplyFtrl<Device, T, Tindex, has_l2_shrinkage>()(
-                 device, var.flat_outer_dims<T>(), accum.flat_outer_dims<T>(),
-                 linear.flat_outer_dims<T>(), lr.scalar<T>(), l1.scalar<T>(),
-                 l2.scalar<T>(),
-                 // Note: Passing l2 as a placeholder when not has_l2_shrinkage
-                 // (it will not be used).
-                 has_l2_shrinkage ? l2_shrinkage->scalar<T>() : l2.scalar<T>(),
-                 lr_power.scalar<T>(), grad.flat_outer_dims<T>(), indices_vec,
-                 inner_dim, multiply_linear_by_lr_));
+    const T* grad_data = apply_grad.flat<T>().data();
+    const Tindex* indices_data = apply_indices.vec<Tindex>().data();
+    // Applies the update to rows [start, end) of the gradient.
+    const auto apply = [&](Tindex start, Tindex end) -> Status {
+      return functor::SparseApplyFtrl<Device, T, Tindex, has_l2_shrinkage>()(
+          device, var.flat_outer_dims<T>(), accum.flat_outer_dims<T>(),
+          linear.flat_outer_dims<T>(), lr.scalar<T>(), l1.scalar<T>(),
+          l2.scalar<T>(),
+          // Note: Passing l2 as a placeholder when not has_l2_shrinkage
+          // (it will not be used).
+          has_l2_shrinkage ? l2_shrinkage->scalar<T>() : l2.scalar<T>(),
+          lr_power.scalar<T>(),
+          typename TTypes<T>::ConstMatrix(grad_data + start * inner_dim,
+                                          end - start, inner_dim),
+          typename TTypes<Tindex>::ConstVec(indices_data + start, end - start),
+          inner_dim, multiply_linear_by_lr_);
+    };
+    if (deduplicate_indices_) {
+      // The CPU functor updates the rows one after the other, because rows
+      // may repeat. Unique rows can be updated in parallel instead.
+      const Eigen::TensorOpCost cost(
+          inner_dim * sizeof(T) * 4, inner_dim * sizeof(T) * 3,
+          inner_dim * (Eigen::TensorOpCost::AddCost<T>() * 6 +
+                       Eigen::TensorOpCost::MulCost<T>() * 6 +
+                       Eigen::TensorOpCost::DivCost<T>() * 2));
+      OP_REQUIRES_OK(ctx, ParallelApplyUniqueRows<Tindex>(
+                              ctx, apply_indices.dim_size(0), cost, apply));
+    } else {
+      OP_REQUIRES_OK(ctx, apply(0, N));
+    }
 
     MaybeForwardRefInputToRefOutput(ctx, 0, 0);
   }
@@ -2904,6 +3078,7 @@ class SparseApplyFtrlOp : public OpKernel {
  private:
   bool use_exclusive_lock_;
   bool multiply_linear_by_lr_;
+  bool deduplicate_indices_;
 };
 
 #define REGISTER_KERNELS(D, T, Tindices)                                      \
@@ -13,9 +13,15 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
 #include <functional>
+#include <numeric>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
@@ -68,6 +74,261 @@ struct UniqueOpHashMap<bfloat16, TIndex> {
   using map_type = std::unordered_map<bfloat16, TIndex>;
 };
 
+// 1-D integer inputs with at least this many elements are uniquified in
+// parallel, by partitioning the elements by hash.
+constexpr int64 kParallelUniqueMinSize = 1 << 16;
+// From this size on, int32 and int64 inputs are uniquified by radix sorting
+// them instead, whose passes stream through memory rather than probing hash
+// maps that no longer fit in cache.
+constexpr int64 kRadixSortUniqueMinSize = 1 << 24;
+
+// Runs `fn(chunk, start, end)` in parallel over `num_chunks` contiguous
+// chunks of [0, n).
+template <typename Fn>
+void ParallelForChunks(const CPUDevice& d, int64 n, int64 num_chunks,
+                       const Fn& fn) {
+  const int64 chunk_size = (n + num_chunks - 1) / num_chunks;
+  // Every chunk is a separate task.
+  const Eigen::TensorOpCost cost(chunk_size, chunk_size, chunk_size * 10);
+  d.parallelFor(num_chunks, cost, [&](Eigen::Index first, Eigen::Index last) {
+    for (Eigen::Index chunk = first; chunk < last; ++chunk) {
+      const int64 start = chunk * chunk_size;
+      fn(chunk, start, std::min(n, start + chunk_size));
+    }
+  });
+}
+
+// Stably moves the elements [0, n) into `num_buckets` buckets. `bucket(i)`
+// returns the bucket of element i, and `move(i, dst)` moves element i to
+// position dst: elements end up ordered by bucket and, within a bucket, by
+// position. Writes the start of every bucket to `bucket_starts` (with
+// num_buckets + 1 entries) and returns false without moving anything if all
+// elements fall into the same bucket.
+template <typename BucketFn, typename MoveFn>
+bool ParallelCountingScatter(const CPUDevice& d, int64 n, int64 num_chunks,
+                             int num_buckets, const BucketFn& bucket,
+                             const MoveFn& move,
+                             std::vector<int64>* bucket_starts) {
+  std::vector<int64> offsets(num_chunks * num_buckets, 0);
+  ParallelForChunks(d, n, num_chunks, [&](int64 chunk, int64 start, int64 end) {
+    int64* counts = &offsets[chunk * num_buckets];
+    for (int64 i = start; i < end; ++i) ++counts[bucket(i)];
+  });
+
+  bucket_starts->assign(num_buckets + 1, 0);
+  for (int b = 0; b < num_buckets; ++b) {
+    int64 bucket_size = 0;
+    for (int64 chunk = 0; chunk < num_chunks; ++chunk) {
+      bucket_size += offsets[chunk * num_buckets + b];
+    }
+    if (bucket_size == n) return false;
+    (*bucket_starts)[b + 1] = (*bucket_starts)[b] + bucket_size;
+  }
+  for (int b = 0; b < num_buckets; ++b) {
+    int64 offset = (*bucket_starts)[b];
+    for (int64 chunk = 0; chunk < num_chunks; ++chunk) {
+      const int64 count = offsets[chunk * num_buckets + b];
+      offsets[chunk * num_buckets + b] = offset;
+      offset += count;
+    }
+  }
+
+  ParallelForChunks(d, n, num_chunks, [&](int64 chunk, int64 start, int64 end) {
+    int64* next = &offsets[chunk * num_buckets];
+    for (int64 i = start; i < end; ++i) move(i, next[bucket(i)]++);
+  });
+  return true;
+}
+
+// Sets `first(i)` to the position of the first occurrence of `in(i)` and
+// `is_first(p)` for all such positions, by partitioning the elements by hash
+// and uniquifying every partition with its own hash map.
+template <typename T, typename TIndex>
+void FindFirstOccurrencesByHashing(const CPUDevice& d, const T* in, int64 n,
+                                   int64 num_chunks, TIndex* first,
+                                   uint8* is_first) {
+  const int num_partitions = std::min<int64>(num_chunks, 256);
+  const auto partition = [&](int64 i) -> int {
+    const uint64 h = static_cast<uint64>(in[i]) * 0x9E3779B97F4A7C15ull;
+    return static_cast<int>(((h >> 32) * num_partitions) >> 32);
+  };
+  std::vector<int64> positions(n);
+  std::vector<int64> partition_starts;
+  if (!ParallelCountingScatter(
+          d, n, num_chunks, num_partitions, partition,
+          [&](int64 i, int64 dst) { positions[dst] = i; },
+          &partition_starts)) {
+    // All elements hash to the same partition.
+    std::iota(positions.begin(), positions.end(), 0);
+    partition_starts = {0, n};
+  }
+
+  const int64 num_tasks = partition_starts.size() - 1;
+  const Eigen::TensorOpCost cost(n / num_tasks * sizeof(T), 0,
+                                 n / num_tasks * 100);
+  d.parallelFor(num_tasks, cost, [&](Eigen::Index first_p,
+                                     Eigen::Index last_p) {
+    for (Eigen::Index p = first_p; p < last_p; ++p) {
+      const int64 start = partition_starts[p];
+      const int64 end = partition_starts[p + 1];
+      absl::flat_hash_map<T, TIndex> first_positions;
+      first_positions.reserve(end - start);
+      // Positions are increasing within a partition, so the first insertion
+      // of a value is its first occurrence.
+      for (int64 k = start; k < end; ++k) {
+        const int64 i = positions[k];
+        const auto it = first_positions.emplace(in[i], i);
+        first[i] = it.first->second;
+        if (it.second) is_first[i] = 1;
+      }
+    }
+  });
+}
+
+// Same as FindFirstOccurrencesByHashing, by stably radix sorting the
+// elements with their positions.
+template <typename T, typename TIndex>
+void FindFirstOccurrencesByRadixSort(const CPUDevice& d, const T* in, int64 n,
+                                     int64 num_chunks, TIndex* first,
+                                     uint8* is_first) {
+  // Only equal elements need to be adjacent, so the bits of signed values
+  // can be sorted as if they were unsigned.
+  using Key = typename std::make_unsigned<T>::type;
+  std::vector<Key> keys(n);
+  std::vector<Key> sorted_keys(n);
+  std::vector<int64> positions(n);
+  std::vector<int64> sorted_positions(n);
+  ParallelForChunks(d, n, num_chunks, [&](int64 chunk, int64 start, int64 end) {
+    for (int64 i = start; i < end; ++i) {
+      keys[i] = static_cast<Key>(in[i]);
+      positions[i] = i;
+    }
+  });
+
+  // Digits shared by all elements, e.g. the high bytes of small ids, are
+  // skipped.
+  std::vector<Key> chunk_or(num_chunks, 0);
+  std::vector<Key> chunk_and(num_chunks, ~Key{0});
+  ParallelForChunks(d, n, num_chunks, [&](int64 chunk, int64 start, int64 end) {
+    for (int64 i = start; i < end; ++i) {
+      chunk_or[chunk] |= keys[i];
+      chunk_and[chunk] &= keys[i];
+    }
+  });
+  Key varying_bits = 0;
+  for (int64 chunk = 0; chunk < num_chunks; ++chunk) {
+    varying_bits |= chunk_or[chunk] ^ chunk_and[0];
+    varying_bits |= chunk_and[chunk] ^ chunk_and[0];
+  }
+
+  std::vector<int64> digit_starts;
+  for (int shift = 0; shift < static_cast<int>(8 * sizeof(Key)); shift += 8) {
+    if (((varying_bits >> shift) & 0xFF) == 0) continue;
+    const auto digit = [&](int64 i) -> int {
+      return static_cast<int>((keys[i] >> shift) & 0xFF);
+    };
+    const auto move = [&](int64 i, int64 dst) {
+      sorted_keys[dst] = keys[i];
+      sorted_positions[dst] = positions[i];
+    };
+    if (ParallelCountingScatter(d, n, num_chunks, /*num_buckets=*/256, digit,
+                                move, &digit_starts)) {
+      keys.swap(sorted_keys);
+      positions.swap(sorted_positions);
+    }
+  }
+
+  // The keys are now sorted, and the sort is stable, so every run of equal
+  // keys starts with the first occurrence of the key. Runs can span chunks.
+  ParallelForChunks(d, n, num_chunks, [&](int64 chunk, int64 start, int64 end) {
+    int64 run_start =
+        std::lower_bound(keys.begin(), keys.begin() + start, keys[start]) -
+        keys.begin();
+    for (int64 k = start; k < end; ++k) {
+      if (keys[k] != keys[run_start]) run_start = k;
+      first[positions[k]] = positions[run_start];
+      if (k == run_start) is_first[positions[k]] = 1;
+    }
+  });
+}
+
+// Parallel implementation of `UniqueOp` for large 1-D inputs of integers.
+template <typename T, typename TIndex, typename Enable = void>
+struct ParallelUnique {
+  static bool Supports(OpKernelContext* context, const Tensor& input) {
+    return false;
+  }
+  static Status Compute(OpKernelContext* context, const Tensor& input,
+                        typename TTypes<TIndex>::Vec idx, int64* uniq_size) {
+    return errors::Unimplemented("Parallel unique of ",
+                                 DataTypeString(input.dtype()));
+  }
+};
+
+template <typename T, typename TIndex>
+struct ParallelUnique<
+    T, TIndex,
+    typename std::enable_if<std::is_integral<T>::value &&
+                            !std::is_same<T, bool>::value>::type> {
+  static bool Supports(OpKernelContext* context, const Tensor& input) {
+    return input.NumElements() >= kParallelUniqueMinSize &&
+           context->eigen_device<CPUDevice>().numThreads() > 1;
+  }
+
+  static Status Compute(OpKernelContext* context, const Tensor& input,
+                        typename TTypes<TIndex>::Vec idx, int64* uniq_size) {
+    const int64 n = input.NumElements();
+    const CPUDevice& d = context->eigen_device<CPUDevice>();
+    const int64 num_chunks =
+        std::min<int64>(4 * d.numThreads(), n / (kParallelUniqueMinSize / 16));
+
+    const T* in = input.flat<T>().data();
+    TIndex* first = idx.data();
+    std::vector<uint8> is_first(n, 0);
+    if (n >= kRadixSortUniqueMinSize &&
+        (std::is_same<T, int32>::value || std::is_same<T, int64>::value)) {
+      FindFirstOccurrencesByRadixSort(d, in, n, num_chunks, first,
+                                      is_first.data());
+    } else {
+      FindFirstOccurrencesByHashing(d, in, n, num_chunks, first,
+                                    is_first.data());
+    }
+
+    // Number the first occurrences in input order, which keeps the order of
+    // the unique elements of the serial implementation.
+    std::vector<int64> chunk_ids(num_chunks + 1, 0);
+    const auto count_firsts = [&](int64 chunk, int64 start, int64 end) {
+      chunk_ids[chunk + 1] =
+          std::count(is_first.begin() + start, is_first.begin() + end, 1);
+    };
+    ParallelForChunks(d, n, num_chunks, count_firsts);
+    std::partial_sum(chunk_ids.begin(), chunk_ids.end(), chunk_ids.begin());
+    *uniq_size = chunk_ids[num_chunks];
+
+    Tensor* output = nullptr;
+    TF_RETURN_IF_ERROR(
+        context->allocate_output(0, TensorShape({*uniq_size}), &output));
+    T* out = output->flat<T>().data();
+    std::vector<TIndex> ids(n);
+    const auto number_firsts = [&](int64 chunk, int64 start, int64 end) {
+      TIndex id = chunk_ids[chunk];
+      for (int64 i = start; i < end; ++i) {
+        if (is_first[i]) {
+          ids[i] = id;
+          out[id++] = in[i];
+        }
+      }
+    };
+    ParallelForChunks(d, n, num_chunks, number_firsts);
+    // Every element takes the id of its first occurrence.
+    const auto set_ids = [&](int64 chunk, int64 start, int64 end) {
+      for (int64 i = start; i < end; ++i) first[i] = ids[first[i]];
+    };
+    ParallelForChunks(d, n, num_chunks, set_ids);
+    return Status::OK();
+  }
+};
+
 // `UniqueOp` computes the unique elements in the input tensor.
 //
 // * `T` is the element type.
@@ -143,7 +404,11 @@ class UniqueOp : public OpKernel {
     auto idx_vec = idx->template vec<TIndex>();
 
     int64 uniq_size;
-    if (new_sizes[0] == 1 && new_sizes[2] == 1) {
+    if (new_sizes[0] == 1 && new_sizes[2] == 1 &&
+        ParallelUnique<T, TIndex>::Supports(context, input)) {
+      OP_REQUIRES_OK(context, ParallelUnique<T, TIndex>::Compute(
+                                  context, input, idx_vec, &uniq_size));
+    } else if (new_sizes[0] == 1 && new_sizes[2] == 1) {
       // Specialized and faster implementation when unique is run over single
       // elements. Here we put T directly into the map rather than ints pointing
       // to them as in the general case.
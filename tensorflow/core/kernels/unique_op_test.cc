@@ -13,8 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <random>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -111,6 +113,42 @@ void BM_Unique_INT32_Repeat(::testing::benchmark::State& state) {
                           sizeof(int32));
 }
 
+// Returns `dim` int64 values below `max_int`. When `skewed` is set, 90% of
+// the values are drawn from the 64 smallest ones, as with hot feature ids.
+Tensor GetRandomInt64Tensor(int dim, int64 max_int, bool skewed) {
+  Tensor tensor(DT_INT64, TensorShape({dim}));
+  auto values = tensor.flat<int64>();
+  std::mt19937_64 rng(0);
+  for (int i = 0; i < dim; ++i) {
+    const bool hot = skewed && rng() % 10 != 0;
+    values(i) = rng() % (hot ? std::min<int64>(64, max_int) : max_int);
+  }
+  return tensor;
+}
+
+void BM_Unique_INT64(::testing::benchmark::State& state) {
+  const int dim = state.range(0);
+  const int64 max_int = state.range(1);
+  const bool skewed = state.range(2);
+
+  Graph* g = new Graph(OpRegistry::Global());
+
+  Tensor input = GetRandomInt64Tensor(dim, max_int, skewed);
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "Unique")
+                  .Input(test::graph::Constant(g, input))
+                  .Attr("T", DT_INT64)
+                  .Finalize(g, &node));
+  FixupSourceAndSinkEdges(g);
+
+  test::Benchmark("cpu", g, nullptr, nullptr, nullptr,
+                  "SINGLE_THREADED_EXECUTOR", /*old_benchmark_api*/ false)
+      .Run(state);
+  state.SetBytesProcessed(static_cast<int64>(state.iterations()) * dim *
+                          sizeof(int64));
+}
+
 TensorProto GetRandomStringsTensorProto(int dim, int max_str_len) {
   TensorProto tensor_proto;
   tensor_proto.set_dtype(DT_STRING);
@@ -193,6 +231,21 @@ BENCHMARK(BM_Unique_INT32_Repeat)
     ->ArgPair(64 * 1024, 64 * 1024 * 1024)
     ->ArgPair(1024 * 1024, 64 * 1024 * 1024);
 
+// Covers the serial, hash partitioned and radix sorted implementations, on
+// uniformly distributed and skewed inputs.
+BENCHMARK(BM_Unique_INT64)
+    ->UseRealTime()
+    ->Args({16 * 1024, 1024 * 1024, 0})
+    ->Args({256 * 1024, 1024 * 1024, 0})
+    ->Args({1024 * 1024, 1024 * 1024, 0})
+    ->Args({16 * 1024 * 1024, 1024 * 1024, 0})
+    ->Args({16 * 1024 * 1024, int64{1} << 40, 0})
+    ->Args({16 * 1024, 1024 * 1024, 1})
+    ->Args({256 * 1024, 1024 * 1024, 1})
+    ->Args({1024 * 1024, 1024 * 1024, 1})
+    ->Args({16 * 1024 * 1024, 1024 * 1024, 1})
+    ->Args({16 * 1024 * 1024, int64{1} << 40, 1});
+
 BENCHMARK(BM_Unique_STRING)
     ->UseRealTime()
     ->Arg(32)
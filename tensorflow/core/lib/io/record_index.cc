@@ -0,0 +1,125 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/record_index.h"
+
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/strcat.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+constexpr uint64 kIndexMagic = 0x7864697265726674ULL;  // "tfreridx"
+constexpr size_t kIndexHeaderSize = 3 * sizeof(uint64);
+
+}  // namespace
+
+string RecordIndexFilename(const string& filename) {
+  return strings::StrCat(filename, ".index");
+}
+
+Status WriteRecordIndex(Env* env, const string& filename,
+                        const std::vector<uint64>& offsets, uint64 file_size) {
+  string contents;
+  contents.reserve(kIndexHeaderSize + offsets.size() * sizeof(uint64) +
+                   sizeof(uint32));
+  core::PutFixed64(&contents, kIndexMagic);
+  core::PutFixed64(&contents, file_size);
+  core::PutFixed64(&contents, offsets.size());
+  for (uint64 offset : offsets) {
+    core::PutFixed64(&contents, offset);
+  }
+  core::PutFixed32(&contents, crc32c::Mask(crc32c::Value(contents.data(),
+                                                         contents.size())));
+
+  const string index_filename = RecordIndexFilename(filename);
+  const string tmp_filename =
+      strings::StrCat(index_filename, ".", random::New64(), ".tmp");
+  Status s = WriteStringToFile(env, tmp_filename, contents);
+  if (s.ok()) s = env->RenameFile(tmp_filename, index_filename);
+  if (!s.ok()) env->DeleteFile(tmp_filename).IgnoreError();
+  return s;
+}
+
+Status ReadRecordIndex(Env* env, const string& filename,
+                       std::vector<uint64>* offsets) {
+  const string index_filename = RecordIndexFilename(filename);
+  string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, index_filename, &contents));
+  if (contents.size() < kIndexHeaderSize + sizeof(uint32)) {
+    return errors::DataLoss("Truncated record index ", index_filename);
+  }
+  const size_t crc_offset = contents.size() - sizeof(uint32);
+  if (crc32c::Unmask(core::DecodeFixed32(&contents[crc_offset])) !=
+      crc32c::Value(contents.data(), crc_offset)) {
+    return errors::DataLoss("Corrupted record index ", index_filename);
+  }
+  const char* p = contents.data();
+  const uint64 magic = core::DecodeFixed64(p);
+  const uint64 indexed_size = core::DecodeFixed64(p + sizeof(uint64));
+  const uint64 num_records = core::DecodeFixed64(p + 2 * sizeof(uint64));
+  if (magic != kIndexMagic ||
+      num_records != (crc_offset - kIndexHeaderSize) / sizeof(uint64) ||
+      (crc_offset - kIndexHeaderSize) % sizeof(uint64) != 0) {
+    return errors::DataLoss("Malformed record index ", index_filename);
+  }
+  uint64 file_size;
+  TF_RETURN_IF_ERROR(env->GetFileSize(filename, &file_size));
+  if (file_size != indexed_size) {
+    return errors::FailedPrecondition(
+        "Record index ", index_filename, " is for a file of ", indexed_size,
+        " bytes, but ", filename, " has ", file_size, " bytes");
+  }
+
+  offsets->resize(num_records);
+  p += kIndexHeaderSize;
+  for (uint64 i = 0; i < num_records; ++i, p += sizeof(uint64)) {
+    (*offsets)[i] = core::DecodeFixed64(p);
+  }
+  return Status::OK();
+}
+
+IndexedRecordReader::IndexedRecordReader(std::unique_ptr<RandomAccessFile> file,
+                                         std::vector<uint64> offsets)
+    : file_(std::move(file)),
+      offsets_(std::move(offsets)),
+      reader_(file_.get()) {}
+
+Status IndexedRecordReader::Create(
+    Env* env, const string& filename,
+    std::unique_ptr<IndexedRecordReader>* result) {
+  std::vector<uint64> offsets;
+  TF_RETURN_IF_ERROR(ReadRecordIndex(env, filename, &offsets));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+  result->reset(new IndexedRecordReader(std::move(file), std::move(offsets)));
+  return Status::OK();
+}
+
+Status IndexedRecordReader::ReadRecord(int64 index, tstring* record) {
+  if (index < 0 || index >= num_records()) {
+    return errors::OutOfRange("Record ", index, " is out of range [0, ",
+                              num_records(), ")");
+  }
+  uint64 offset = offsets_[index];
+  return reader_.ReadRecord(&offset, record);
+}
+
+}  // namespace io
+}  // namespace tensorflow
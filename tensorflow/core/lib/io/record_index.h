@@ -0,0 +1,91 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_RECORD_INDEX_H_
+#define TENSORFLOW_CORE_LIB_IO_RECORD_INDEX_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+// An optional sidecar index of an uncompressed TFRecord file, stored next to
+// it as "<filename>.index". Format:
+//  uint64    magic
+//  uint64    size of the TFRecord file
+//  uint64    number of records
+//  uint64    offset[number of records]
+//  uint32    masked crc of the above
+//
+// The file size guards against using an index of a file that was rewritten
+// or appended to.
+
+// Returns the name of the index of the TFRecord file `filename`.
+string RecordIndexFilename(const string& filename);
+
+// Writes the index of the TFRecord file `filename`, which is `file_size`
+// bytes long and has records at `offsets`. The index is written to a temporary
+// file and renamed into place, so readers never see a partial index.
+Status WriteRecordIndex(Env* env, const string& filename,
+                        const std::vector<uint64>& offsets, uint64 file_size);
+
+// Reads the index of the TFRecord file `filename` into `*offsets`. Returns
+// NotFound if there is no index, and FailedPrecondition if the index does not
+// belong to the current contents of the file.
+Status ReadRecordIndex(Env* env, const string& filename,
+                       std::vector<uint64>* offsets);
+
+// Reads the records of an indexed TFRecord file in any order.
+//
+// Note: this class is not thread safe; external synchronization required.
+class IndexedRecordReader {
+ public:
+  // Opens the uncompressed TFRecord file `filename` and reads its index.
+  static Status Create(Env* env, const string& filename,
+                       std::unique_ptr<IndexedRecordReader>* result);
+
+  int64 num_records() const { return offsets_.size(); }
+
+  // Returns the file offset of every record.
+  const std::vector<uint64>& offsets() const { return offsets_; }
+
+  // Reads record `index` into `*record`. Returns OUT_OF_RANGE if the file has
+  // no such record.
+  Status ReadRecord(int64 index, tstring* record);
+
+ private:
+  IndexedRecordReader(std::unique_ptr<RandomAccessFile> file,
+                      std::vector<uint64> offsets);
+
+  // `reader_` borrows `file_`, so it is declared after it.
+  const std::unique_ptr<RandomAccessFile> file_;
+  const std::vector<uint64> offsets_;
+  RecordReader reader_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(IndexedRecordReader);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_RECORD_INDEX_H_
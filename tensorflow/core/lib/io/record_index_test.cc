@@ -0,0 +1,90 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/record_index.h"
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/strcat.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+constexpr int kNumRecords = 100;
+
+string Record(int i) { return strings::StrCat("record ", i, string(i, 'x')); }
+
+// Writes `kNumRecords` records and their index to `fname`.
+void WriteIndexedFile(const string& fname) {
+  Env* env = Env::Default();
+  std::unique_ptr<WritableFile> file;
+  TF_ASSERT_OK(env->NewWritableFile(fname, &file));
+  RecordWriterOptions options;
+  options.build_index = true;
+  RecordWriter writer(file.get(), options);
+  for (int i = 0; i < kNumRecords; ++i) {
+    TF_ASSERT_OK(writer.WriteRecord(Record(i)));
+  }
+  TF_ASSERT_OK(writer.Close());
+  TF_ASSERT_OK(file->Close());
+  ASSERT_EQ(writer.record_offsets().size(), kNumRecords);
+  TF_ASSERT_OK(WriteRecordIndex(env, fname, writer.record_offsets(),
+                                writer.bytes_written()));
+}
+
+TEST(RecordIndexTest, RandomAccess) {
+  const string fname = testing::TmpDir() + "/record_index_random_access";
+  WriteIndexedFile(fname);
+  std::unique_ptr<IndexedRecordReader> reader;
+  TF_ASSERT_OK(IndexedRecordReader::Create(Env::Default(), fname, &reader));
+  ASSERT_EQ(reader->num_records(), kNumRecords);
+  tstring record;
+  for (int i = kNumRecords - 1; i >= 0; i -= 7) {
+    TF_ASSERT_OK(reader->ReadRecord(i, &record));
+    EXPECT_EQ(record, Record(i));
+  }
+  EXPECT_EQ(reader->ReadRecord(kNumRecords, &record).code(),
+            error::OUT_OF_RANGE);
+}
+
+TEST(RecordIndexTest, MissingIndex) {
+  const string fname = testing::TmpDir() + "/record_index_missing";
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), fname, ""));
+  std::vector<uint64> offsets;
+  EXPECT_EQ(ReadRecordIndex(Env::Default(), fname, &offsets).code(),
+            error::NOT_FOUND);
+}
+
+TEST(RecordIndexTest, StaleIndex) {
+  const string fname = testing::TmpDir() + "/record_index_stale";
+  WriteIndexedFile(fname);
+  std::unique_ptr<WritableFile> file;
+  TF_ASSERT_OK(Env::Default()->NewAppendableFile(fname, &file));
+  RecordWriter writer(file.get());
+  TF_ASSERT_OK(writer.WriteRecord("appended"));
+  TF_ASSERT_OK(writer.Close());
+  TF_ASSERT_OK(file->Close());
+
+  std::vector<uint64> offsets;
+  EXPECT_EQ(ReadRecordIndex(Env::Default(), fname, &offsets).code(),
+            error::FAILED_PRECONDITION);
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -245,5 +245,51 @@ SequentialRecordReader::SequentialRecordReader(
     RandomAccessFile* file, const RecordReaderOptions& options)
     : underlying_(file, options), offset_(0) {}
 
+MemoryMappedRecordReader::MemoryMappedRecordReader(
+    ReadOnlyMemoryRegion* region, bool verify_checksums)
+    : data_(static_cast<const char*>(region->data())),
+      size_(region->length()),
+      verify_checksums_(verify_checksums) {}
+
+Status MemoryMappedRecordReader::ReadRecord(tstring* record) {
+  if (offset_ == size_) {
+    return errors::OutOfRange("eof");
+  }
+  if (size_ - offset_ < RecordReader::kHeaderSize) {
+    return errors::DataLoss("truncated record at ", offset_);
+  }
+  const char* header = data_ + offset_;
+  if (verify_checksums_ &&
+      crc32c::Unmask(core::DecodeFixed32(header + sizeof(uint64))) !=
+          crc32c::Value(header, sizeof(uint64))) {
+    return errors::DataLoss("corrupted record at ", offset_);
+  }
+  const uint64 length = core::DecodeFixed64(header);
+  const uint64 remaining = size_ - offset_ - RecordReader::kHeaderSize;
+  if (remaining < RecordReader::kFooterSize ||
+      length > remaining - RecordReader::kFooterSize) {
+    return errors::DataLoss("truncated record at ", offset_);
+  }
+  const char* data = header + RecordReader::kHeaderSize;
+  if (verify_checksums_ &&
+      crc32c::Unmask(core::DecodeFixed32(data + length)) !=
+          crc32c::Value(data, length)) {
+    return errors::DataLoss("corrupted record at ", offset_);
+  }
+  record->assign(data, length);
+  offset_ += RecordReader::kHeaderSize + length + RecordReader::kFooterSize;
+  return Status::OK();
+}
+
+Status MemoryMappedRecordReader::SeekOffset(uint64 offset) {
+  if (offset > size_) {
+    return errors::InvalidArgument("Trying to seek offset: ", offset,
+                                   " which is past the end of the file: ",
+                                   size_);
+  }
+  offset_ = offset;
+  return Status::OK();
+}
+
 }  // namespace io
 }  // namespace tensorflow
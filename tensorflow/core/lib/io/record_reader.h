@@ -31,6 +31,7 @@ limitations under the License.
 namespace tensorflow {
 
 class RandomAccessFile;
+class ReadOnlyMemoryRegion;
 
 namespace io {
 
@@ -174,6 +175,41 @@ class SequentialRecordReader {
   uint64 offset_ = 0;
 };
 
+// Reads uncompressed TFRecords from a memory-mapped file.
+//
+// Unlike SequentialRecordReader, which reads the file through an input buffer,
+// every record is copied exactly once: from the mapped region into the
+// output string.
+//
+// Note: this class is not thread safe; external synchronization required.
+class MemoryMappedRecordReader {
+ public:
+  // Create a reader that will return records from "*region", which must
+  // remain live while this reader is in use. If "verify_checksums" is false,
+  // the masked CRCs of the record lengths and data are not checked.
+  explicit MemoryMappedRecordReader(ReadOnlyMemoryRegion* region,
+                                    bool verify_checksums = true);
+
+  // Read the next record in the file into *record. Returns OK on success,
+  // OUT_OF_RANGE for end of file, or something else for an error.
+  Status ReadRecord(tstring* record);
+
+  // Return the current offset in the file.
+  uint64 TellOffset() const { return offset_; }
+
+  // Seek to this offset within the file and set this offset as the current
+  // offset.
+  Status SeekOffset(uint64 offset);
+
+ private:
+  const char* const data_;
+  const uint64 size_;
+  const bool verify_checksums_;
+  uint64 offset_ = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MemoryMappedRecordReader);
+};
+
 }  // namespace io
 }  // namespace tensorflow
 
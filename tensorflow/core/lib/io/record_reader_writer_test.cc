@@ -158,6 +158,106 @@ TEST(RecordReaderWriterTest, TestBasics) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestPrecomputedChecksums) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_checksums_test";
+
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriter writer(file.get());
+    const string data = "abc";
+    char header[io::RecordWriter::kHeaderSize];
+    char footer[io::RecordWriter::kFooterSize];
+    io::RecordWriter::PopulateHeader(header, data.data(), data.size());
+    io::RecordWriter::PopulateFooter(footer, data.data(), data.size());
+    TF_EXPECT_OK(writer.WriteRecord(data, header, footer));
+    TF_EXPECT_OK(writer.WriteRecord("defg"));
+    TF_CHECK_OK(writer.Close());
+  }
+
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+  io::RecordReader reader(read_file.get());
+  uint64 offset = 0;
+  tstring record;
+  TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+  EXPECT_EQ("abc", record);
+  TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+  EXPECT_EQ("defg", record);
+}
+
+TEST(RecordReaderWriterTest, TestMemoryMapped) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_mmap_test";
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    io::RecordWriter writer(file.get());
+    TF_EXPECT_OK(writer.WriteRecord("abc"));
+    TF_EXPECT_OK(writer.WriteRecord(""));
+    TF_EXPECT_OK(writer.WriteRecord("defg"));
+    TF_CHECK_OK(writer.Flush());
+  }
+
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  TF_CHECK_OK(env->NewReadOnlyMemoryRegionFromFile(fname, &region));
+  io::MemoryMappedRecordReader reader(region.get());
+  tstring record;
+  TF_CHECK_OK(reader.ReadRecord(&record));
+  EXPECT_EQ("abc", record);
+  EXPECT_EQ(19, reader.TellOffset());
+  TF_CHECK_OK(reader.ReadRecord(&record));
+  EXPECT_EQ("", record);
+  TF_CHECK_OK(reader.ReadRecord(&record));
+  EXPECT_EQ("defg", record);
+  EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&record)));
+
+  // Seeking back to a record boundary re-reads from there.
+  TF_CHECK_OK(reader.SeekOffset(19));
+  TF_CHECK_OK(reader.ReadRecord(&record));
+  EXPECT_EQ("", record);
+  EXPECT_TRUE(errors::IsInvalidArgument(reader.SeekOffset(1000)));
+}
+
+TEST(RecordReaderWriterTest, TestMemoryMappedCorruption) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_mmap_corrupt_test";
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    io::RecordWriter writer(file.get());
+    TF_EXPECT_OK(writer.WriteRecord("abc"));
+    TF_CHECK_OK(writer.Flush());
+  }
+  // Flip a byte of the record data.
+  string contents;
+  TF_CHECK_OK(ReadFileToString(env, fname, &contents));
+  contents[io::RecordReader::kHeaderSize] = 'x';
+  TF_CHECK_OK(WriteStringToFile(env, fname, contents));
+
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  TF_CHECK_OK(env->NewReadOnlyMemoryRegionFromFile(fname, &region));
+  tstring record;
+  {
+    io::MemoryMappedRecordReader reader(region.get());
+    EXPECT_TRUE(errors::IsDataLoss(reader.ReadRecord(&record)));
+  }
+  {
+    io::MemoryMappedRecordReader reader(region.get(),
+                                        /*verify_checksums=*/false);
+    TF_CHECK_OK(reader.ReadRecord(&record));
+    EXPECT_EQ("xbc", record);
+  }
+
+  // A truncated file.
+  TF_CHECK_OK(WriteStringToFile(env, fname, contents.substr(0, 14)));
+  TF_CHECK_OK(env->NewReadOnlyMemoryRegionFromFile(fname, &region));
+  io::MemoryMappedRecordReader reader(region.get());
+  EXPECT_TRUE(errors::IsDataLoss(reader.ReadRecord(&record)));
+}
+
 TEST(RecordReaderWriterTest, TestSkipBasic) {
   Env* env = Env::Default();
   string fname = testing::TmpDir() + "/record_reader_writer_skip_basic_test";
@@ -305,6 +405,39 @@ TEST(RecordReaderWriterTest, TestZlib) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestParallelZlib) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_parallel_zlib_test";
+  const int kNumRecords = 1000;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    io::RecordWriterOptions options =
+        io::RecordWriterOptions::CreateRecordWriterOptions("GZIP");
+    options.zlib_options.input_buffer_size = 1000;
+    options.compression_threads = 4;
+    io::RecordWriter writer(file.get(), options);
+    for (int i = 0; i < kNumRecords; ++i) {
+      TF_EXPECT_OK(writer.WriteRecord(strings::StrCat("record ", i)));
+    }
+    TF_CHECK_OK(writer.Close());
+    TF_CHECK_OK(file->Close());
+  }
+
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+  io::RecordReader reader(
+      read_file.get(),
+      io::RecordReaderOptions::CreateRecordReaderOptions("GZIP"));
+  uint64 offset = 0;
+  tstring record;
+  for (int i = 0; i < kNumRecords; ++i) {
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ(strings::StrCat("record ", i), record);
+  }
+  EXPECT_EQ(error::OUT_OF_RANGE, reader.ReadRecord(&offset, &record).code());
+}
+
 TEST(RecordReaderWriterTest, TestUseAfterClose) {
   Env* env = Env::Default();
   string fname = testing::TmpDir() + "/record_reader_writer_flush_close_test";
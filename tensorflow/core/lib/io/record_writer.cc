@@ -60,12 +60,28 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
 RecordWriter::RecordWriter(WritableFile* dest,
                            const RecordWriterOptions& options)
     : dest_(dest), options_(options) {
+  if (options_.build_index &&
+      options_.compression_type != RecordWriterOptions::NONE) {
+    LOG(ERROR) << "A record index requires an uncompressed file. No index "
+                  "will be built.";
+    options_.build_index = false;
+  }
 #if defined(IS_SLIM_BUILD)
   if (options.compression_type != RecordWriterOptions::NONE) {
     LOG(FATAL) << "Compression is unsupported on mobile platforms.";
   }
 #else
-  if (IsZlibCompressed(options)) {
+  if (IsZlibCompressed(options) && options.compression_threads > 1) {
+    ParallelZlibOutputBuffer* zlib_output_buffer = new ParallelZlibOutputBuffer(
+        dest, options.zlib_options.input_buffer_size,
+        options.compression_threads, options.zlib_options);
+    Status s = zlib_output_buffer->Init();
+    if (!s.ok()) {
+      LOG(FATAL) << "Failed to initialize Zlib outputbuffer. Error: "
+                 << s.ToString();
+    }
+    dest_ = zlib_output_buffer;
+  } else if (IsZlibCompressed(options)) {
     ZlibOutputBuffer* zlib_output_buffer = new ZlibOutputBuffer(
         dest, options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options);
@@ -110,9 +126,19 @@ Status RecordWriter::WriteRecord(StringPiece data) {
   char footer[kFooterSize];
   PopulateHeader(header, data.data(), data.size());
   PopulateFooter(footer, data.data(), data.size());
-  TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
+  return WriteRecord(data, header, footer);
+}
+
+Status RecordWriter::WriteRecord(StringPiece data, const char* header,
+                                 const char* footer) {
+  if (dest_ == nullptr) {
+    return Status(::tensorflow::error::FAILED_PRECONDITION,
+                  "Writer not initialized or previously closed");
+  }
+  AddRecord(data.size());
+  TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, kHeaderSize)));
   TF_RETURN_IF_ERROR(dest_->Append(data));
-  return dest_->Append(StringPiece(footer, sizeof(footer)));
+  return dest_->Append(StringPiece(footer, kFooterSize));
 }
 
 #if defined(TF_CORD_SUPPORT)
@@ -130,6 +156,7 @@ Status RecordWriter::WriteRecord(const absl::Cord& data) {
   char footer[kFooterSize];
   PopulateHeader(header, data);
   PopulateFooter(footer, data);
+  AddRecord(data.size());
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
   return dest_->Append(StringPiece(footer, sizeof(footer)));
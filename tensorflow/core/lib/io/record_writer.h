@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_LIB_IO_RECORD_WRITER_H_
 #define TENSORFLOW_CORE_LIB_IO_RECORD_WRITER_H_
 
+#include <vector>
+
 #include "tensorflow/core/lib/core/coding.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
@@ -45,6 +47,10 @@ struct RecordWriterOptions {
   };
   CompressionType compression_type = NONE;
 
+  // Whether to keep the offset of every record, for writing a record index
+  // (see record_index.h). Only supported without compression.
+  bool build_index = false;
+
   static RecordWriterOptions CreateRecordWriterOptions(
       const string& compression_type);
 
@@ -52,6 +58,11 @@ struct RecordWriterOptions {
   // Options specific to compression.
   tensorflow::io::ZlibCompressionOptions zlib_options;
   tensorflow::io::SnappyCompressionOptions snappy_options;
+
+  // If greater than 1, zlib output is compressed on this many threads in
+  // chunks of `zlib_options.input_buffer_size` bytes. See
+  // ParallelZlibOutputBuffer.
+  int32 compression_threads = 1;
 #endif  // IS_SLIM_BUILD
 };
 
@@ -83,6 +94,12 @@ class RecordWriter {
   Status WriteRecord(const absl::Cord& data);
 #endif
 
+  // Same as WriteRecord(data), with the record-header and record-footer of
+  // `data` already populated by PopulateHeader() and PopulateFooter(). This
+  // lets callers sharing a writer under a lock checksum their records before
+  // taking it.
+  Status WriteRecord(StringPiece data, const char* header, const char* footer);
+
   // Flushes any buffered data held by underlying containers of the
   // RecordWriter to the WritableFile. Does *not* flush the
   // WritableFile.
@@ -94,6 +111,13 @@ class RecordWriter {
   // are invalid.
   Status Close();
 
+  // Returns the offsets of the records written so far, if
+  // `RecordWriterOptions::build_index` is set.
+  const std::vector<uint64>& record_offsets() const { return record_offsets_; }
+
+  // Returns the number of bytes written so far, before compression.
+  uint64 bytes_written() const { return bytes_written_; }
+
   // Utility method to populate TFRecord headers.  Populates record-header in
   // "header[0,kHeaderSize-1]".  The record-header is based on data[0, n-1].
   inline static void PopulateHeader(char* header, const char* data, size_t n);
@@ -111,6 +135,14 @@ class RecordWriter {
  private:
   WritableFile* dest_;
   RecordWriterOptions options_;
+  uint64 bytes_written_ = 0;
+  std::vector<uint64> record_offsets_;
+
+  // Accounts for a record of `n` bytes.
+  void AddRecord(size_t n) {
+    if (options_.build_index) record_offsets_.push_back(bytes_written_);
+    bytes_written_ += kHeaderSize + n + kFooterSize;
+  }
 
   inline static uint32 MaskedCrc(const char* data, size_t n) {
     return crc32c::Mask(crc32c::Value(data, n));
@@ -162,6 +162,50 @@ TEST(ZlibBuffers, MultipleWriteCallsWithFlush) {
   TestMultipleWrites(200, 200, 10, true);
 }
 
+void TestParallelCompression(CompressionOptions options) {
+  Env* env = Env::Default();
+  string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  const string data = GenTestString(500);
+  for (int chunk_size : {10, 1000, 100000}) {
+    for (int num_threads : {2, 4}) {
+      std::unique_ptr<WritableFile> file_writer;
+      TF_ASSERT_OK(env->NewWritableFile(fname, &file_writer));
+      ParallelZlibOutputBuffer out(file_writer.get(), chunk_size, num_threads,
+                                   options);
+      TF_ASSERT_OK(out.Init());
+      // The flush leaves a partial chunk in the middle of the stream.
+      TF_ASSERT_OK(out.Append(StringPiece(data).substr(0, 12345)));
+      TF_ASSERT_OK(out.Flush());
+      TF_ASSERT_OK(out.Append(StringPiece(data).substr(12345)));
+      TF_ASSERT_OK(out.Close());
+      TF_ASSERT_OK(file_writer->Close());
+
+      std::unique_ptr<RandomAccessFile> file_reader;
+      TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file_reader));
+      std::unique_ptr<RandomAccessInputStream> input_stream(
+          new RandomAccessInputStream(file_reader.get()));
+      ZlibInputStream in(input_stream.get(), 1000, 1000, options);
+      tstring result;
+      TF_ASSERT_OK(in.ReadNBytes(data.size(), &result));
+      EXPECT_EQ(result, data);
+      EXPECT_EQ(errors::Code::OUT_OF_RANGE, in.ReadNBytes(1, &result).code());
+    }
+  }
+}
+
+TEST(ZlibBuffers, ParallelDefaultOptions) {
+  TestParallelCompression(CompressionOptions::DEFAULT());
+}
+
+TEST(ZlibBuffers, ParallelRawDeflate) {
+  TestParallelCompression(CompressionOptions::RAW());
+}
+
+TEST(ZlibBuffers, ParallelGzip) {
+  TestParallelCompression(CompressionOptions::GZIP());
+}
+
 TEST(ZlibInputStream, FailsToReadIfWindowBitsAreIncompatible) {
   Env* env = Env::Default();
   string fname;
@@ -15,7 +15,11 @@ limitations under the License.
 
 #include "tensorflow/core/lib/io/zlib_outputbuffer.h"
 
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/coding.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 namespace io {
@@ -239,5 +243,256 @@ Status ZlibOutputBuffer::Deflate(int flush) {
 
 Status ZlibOutputBuffer::Tell(int64* position) { return file_->Tell(position); }
 
+ParallelZlibOutputBuffer::ParallelZlibOutputBuffer(
+    WritableFile* file, int32 input_buffer_bytes, int num_threads,
+    const ZlibCompressionOptions& zlib_options)
+    : file_(file),
+      chunk_size_(std::max<int32>(input_buffer_bytes, 1)),
+      max_pending_chunks_(2 * std::max(num_threads, 1)),
+      zlib_options_(zlib_options),
+      pool_(new thread::ThreadPool(Env::Default(), "parallel_zlib_output",
+                                   std::max(num_threads, 1))) {}
+
+ParallelZlibOutputBuffer::~ParallelZlibOutputBuffer() {
+  if (!closed_) {
+    LOG(WARNING) << "ParallelZlibOutputBuffer::Close() not called. Possible "
+                    "data loss";
+  }
+}
+
+Status ParallelZlibOutputBuffer::Init() {
+  int window_bits = zlib_options_.window_bits;
+  if (window_bits > MAX_WBITS) {
+    gzip_ = true;
+    window_bits -= 16;
+  } else if (window_bits < 0) {
+    raw_ = true;
+    window_bits = -window_bits;
+  }
+  if (window_bits < 8 || window_bits > MAX_WBITS) {
+    return errors::InvalidArgument("Unsupported window_bits ",
+                                   zlib_options_.window_bits);
+  }
+  // zlib silently uses a 512 byte window for raw deflate with 8 bits.
+  window_bits_ = std::max(window_bits, 9);
+
+  // Checks the remaining options.
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  int status =
+      deflateInit2(&stream, zlib_options_.compression_level,
+                   zlib_options_.compression_method, -window_bits_,
+                   zlib_options_.mem_level, zlib_options_.compression_strategy);
+  if (status != Z_OK) {
+    return errors::InvalidArgument("deflateInit failed with status", status);
+  }
+  deflateEnd(&stream);
+
+  const int level = zlib_options_.compression_level == Z_DEFAULT_COMPRESSION
+                        ? 6
+                        : zlib_options_.compression_level;
+  string header;
+  if (gzip_) {
+    // No file name, comment or modification time, as written by zlib.
+    const char extra_flags = level == 9 ? 2 : (level == 1 ? 4 : 0);
+    header = string("\x1f\x8b\x08\0\0\0\0\0", 8);
+    header.push_back(extra_flags);
+    header.push_back('\xff');  // Unknown operating system.
+    check_ = crc32(0L, Z_NULL, 0);
+  } else if (!raw_) {
+    int level_flags = 3;
+    if (zlib_options_.compression_strategy >= Z_HUFFMAN_ONLY || level < 2) {
+      level_flags = 0;
+    } else if (level < 6) {
+      level_flags = 1;
+    } else if (level == 6) {
+      level_flags = 2;
+    }
+    uint32 value = (Z_DEFLATED + ((window_bits_ - 8) << 4)) << 8;
+    value |= level_flags << 6;
+    value += 31 - value % 31;
+    header.push_back(static_cast<char>(value >> 8));
+    header.push_back(static_cast<char>(value & 0xff));
+    check_ = adler32(0L, Z_NULL, 0);
+  }
+  TF_RETURN_IF_ERROR(file_->Append(header));
+  input_.reserve(chunk_size_);
+  closed_ = false;
+  return Status::OK();
+}
+
+Status ParallelZlibOutputBuffer::Append(StringPiece data) {
+  if (closed_) {
+    return errors::FailedPrecondition(
+        "ParallelZlibOutputBuffer is not initialized or closed");
+  }
+  while (!data.empty()) {
+    const size_t bytes =
+        std::min<size_t>(data.size(), chunk_size_ - input_.size());
+    input_.append(data.data(), bytes);
+    data.remove_prefix(bytes);
+    if (input_.size() == chunk_size_) {
+      TF_RETURN_IF_ERROR(SubmitChunk(/*last=*/false));
+    }
+  }
+  return Status::OK();
+}
+
+#if defined(TF_CORD_SUPPORT)
+Status ParallelZlibOutputBuffer::Append(const absl::Cord& cord) {
+  for (absl::string_view fragment : cord.Chunks()) {
+    TF_RETURN_IF_ERROR(Append(fragment));
+  }
+  return Status::OK();
+}
+#endif
+
+Status ParallelZlibOutputBuffer::Flush() {
+  if (closed_) {
+    return errors::FailedPrecondition(
+        "ParallelZlibOutputBuffer is not initialized or closed");
+  }
+  if (!input_.empty()) {
+    TF_RETURN_IF_ERROR(SubmitChunk(/*last=*/false));
+  }
+  TF_RETURN_IF_ERROR(WriteChunks(0));
+  return file_->Flush();
+}
+
+Status ParallelZlibOutputBuffer::Close() {
+  if (closed_) return Status::OK();
+  closed_ = true;
+  TF_RETURN_IF_ERROR(SubmitChunk(/*last=*/true));
+  TF_RETURN_IF_ERROR(WriteChunks(0));
+  char trailer[8];
+  if (gzip_) {
+    core::EncodeFixed32(trailer, check_);
+    core::EncodeFixed32(trailer + 4, static_cast<uint32>(total_in_));
+    return file_->Append(StringPiece(trailer, 8));
+  } else if (!raw_) {
+    // The zlib trailer is big-endian.
+    for (int i = 0; i < 4; ++i) {
+      trailer[i] = static_cast<char>(check_ >> (24 - 8 * i));
+    }
+    return file_->Append(StringPiece(trailer, 4));
+  }
+  return Status::OK();
+}
+
+Status ParallelZlibOutputBuffer::Name(StringPiece* result) const {
+  return file_->Name(result);
+}
+
+Status ParallelZlibOutputBuffer::Sync() {
+  TF_RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
+Status ParallelZlibOutputBuffer::Tell(int64* position) {
+  return file_->Tell(position);
+}
+
+Status ParallelZlibOutputBuffer::SubmitChunk(bool last) {
+  auto chunk = std::make_shared<Chunk>();
+  chunk->input.swap(input_);
+  input_.reserve(chunk_size_);
+  chunk->dictionary = dictionary_;
+  chunk->last = last;
+
+  const size_t window_size = size_t{1} << window_bits_;
+  if (chunk->input.size() >= window_size) {
+    dictionary_.assign(chunk->input, chunk->input.size() - window_size,
+                       window_size);
+  } else {
+    dictionary_.append(chunk->input);
+    if (dictionary_.size() > window_size) {
+      dictionary_.erase(0, dictionary_.size() - window_size);
+    }
+  }
+  total_in_ += chunk->input.size();
+
+  pending_.push_back(chunk);
+  pool_->Schedule([this, chunk]() {
+    Compress(chunk.get());
+    chunk->done.Notify();
+  });
+  return WriteChunks(max_pending_chunks_);
+}
+
+Status ParallelZlibOutputBuffer::WriteChunks(size_t max_pending) {
+  while (pending_.size() > max_pending) {
+    std::shared_ptr<Chunk> chunk = pending_.front();
+    pending_.pop_front();
+    chunk->done.WaitForNotification();
+    TF_RETURN_IF_ERROR(chunk->status);
+    if (gzip_) {
+      check_ = crc32_combine(check_, chunk->check, chunk->input.size());
+    } else if (!raw_) {
+      check_ = adler32_combine(check_, chunk->check, chunk->input.size());
+    }
+    TF_RETURN_IF_ERROR(file_->Append(chunk->output));
+  }
+  return Status::OK();
+}
+
+void ParallelZlibOutputBuffer::Compress(Chunk* chunk) const {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  int error =
+      deflateInit2(&stream, zlib_options_.compression_level,
+                   zlib_options_.compression_method, -window_bits_,
+                   zlib_options_.mem_level, zlib_options_.compression_strategy);
+  if (error != Z_OK) {
+    chunk->status = errors::Internal("deflateInit failed with status", error);
+    return;
+  }
+  if (!chunk->dictionary.empty()) {
+    error = deflateSetDictionary(
+        &stream, reinterpret_cast<const Bytef*>(chunk->dictionary.data()),
+        chunk->dictionary.size());
+  }
+
+  const int flush = chunk->last ? Z_FINISH : Z_SYNC_FLUSH;
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(chunk->input.data()));
+  stream.avail_in = chunk->input.size();
+  // Leaves room for the empty stored block that ends a chunk.
+  chunk->output.resize(deflateBound(&stream, chunk->input.size()) + 8);
+  size_t produced = 0;
+  while (error == Z_OK) {
+    if (produced == chunk->output.size()) {
+      chunk->output.resize(2 * produced);
+    }
+    stream.next_out = reinterpret_cast<Bytef*>(&chunk->output[produced]);
+    stream.avail_out = chunk->output.size() - produced;
+    error = deflate(&stream, flush);
+    produced = chunk->output.size() - stream.avail_out;
+    // A sync flush is complete once deflate() leaves output space unused, or
+    // has nothing left to do.
+    if (flush == Z_SYNC_FLUSH &&
+        ((error == Z_OK && stream.avail_out > 0) || error == Z_BUF_ERROR)) {
+      error = Z_OK;
+      break;
+    }
+  }
+  if (error != Z_OK && error != Z_STREAM_END) {
+    string error_string =
+        strings::StrCat("deflate() failed with error ", error);
+    if (stream.msg != nullptr) {
+      strings::StrAppend(&error_string, ": ", stream.msg);
+    }
+    chunk->status = errors::DataLoss(error_string);
+  }
+  deflateEnd(&stream);
+  chunk->output.resize(produced);
+
+  const Bytef* input = reinterpret_cast<const Bytef*>(chunk->input.data());
+  if (gzip_) {
+    chunk->check = crc32(crc32(0L, Z_NULL, 0), input, chunk->input.size());
+  } else if (!raw_) {
+    chunk->check = adler32(adler32(0L, Z_NULL, 0), input, chunk->input.size());
+  }
+}
+
 }  // namespace io
 }  // namespace tensorflow
@@ -18,10 +18,14 @@ limitations under the License.
 
 #include <zlib.h>
 
+#include <deque>
+#include <memory>
 #include <string>
 
+#include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/file_system.h"
@@ -152,6 +156,113 @@ class ZlibOutputBuffer : public WritableFile {
   TF_DISALLOW_COPY_AND_ASSIGN(ZlibOutputBuffer);
 };
 
+// A ZlibOutputBuffer that deflates on `num_threads` threads.
+//
+// The input is cut into chunks of `input_buffer_bytes` bytes that are
+// deflated independently, in the manner of pigz: every chunk is primed with
+// the last window of the chunk before it and ends on a byte boundary with
+// Z_SYNC_FLUSH, so that their concatenation, with the zlib or gzip header and
+// trailer around it, is a single ordinary deflate stream that ZlibInputStream
+// reads. The trailer checksum is combined from those of the chunks.
+//
+// Append() only hands full chunks to the threads and writes the chunks that
+// are done, in order, once more than two per thread are outstanding.
+// `zlib_options.flush_mode` is ignored.
+//
+// A given instance is NOT safe for concurrent use by multiple threads.
+class ParallelZlibOutputBuffer : public WritableFile {
+ public:
+  // Does not take ownership of `file`.
+  ParallelZlibOutputBuffer(WritableFile* file, int32 input_buffer_bytes,
+                           int num_threads,
+                           const ZlibCompressionOptions& zlib_options);
+
+  ~ParallelZlibOutputBuffer() override;
+
+  // Checks the options and writes the stream header. This call is required
+  // before any other operation on the buffer.
+  Status Init();
+
+  // Adds `data` to the current chunk, and starts compressing the chunk once
+  // it is full.
+  Status Append(StringPiece data) override;
+
+#if defined(TF_CORD_SUPPORT)
+  Status Append(const absl::Cord& cord) override;
+#endif
+
+  // Compresses the current chunk, waits for all chunks and writes them to
+  // file.
+  Status Flush() override;
+
+  // Like `Flush()`, but ends the stream and writes its trailer. This must be
+  // called before the destructor to avoid any data loss.
+  //
+  // After calling this, any further calls to `Append()` or `Flush()` will
+  // fail.
+  Status Close() override;
+
+  // Returns the name of the underlying file.
+  Status Name(StringPiece* result) const override;
+
+  // Flushes all output to file and syncs it.
+  Status Sync() override;
+
+  // Returns the write position in the underlying file. The position does not
+  // reflect buffered, un-flushed data.
+  Status Tell(int64* position) override;
+
+ private:
+  struct Chunk {
+    string input;
+    // The input preceding this chunk that back-references may point into.
+    string dictionary;
+    // Whether this chunk ends the stream.
+    bool last;
+
+    // Set by Compress().
+    string output;
+    uint32 check;  // adler32 or crc32 of `input`.
+    Status status;
+    Notification done;
+  };
+
+  // Hands the current chunk to the threads and writes finished chunks if too
+  // many are outstanding.
+  Status SubmitChunk(bool last);
+
+  // Waits for the oldest chunks and writes them until at most `max_pending`
+  // are left.
+  Status WriteChunks(size_t max_pending);
+
+  // Deflates `chunk->input` into `chunk->output`.
+  void Compress(Chunk* chunk) const;
+
+  WritableFile* file_;  // Not owned
+  const size_t chunk_size_;
+  const size_t max_pending_chunks_;
+  ZlibCompressionOptions const zlib_options_;
+
+  // The window size, and whether the stream has a gzip or zlib wrapper.
+  int window_bits_;
+  bool gzip_ = false;
+  bool raw_ = false;
+
+  string input_;
+  string dictionary_;
+  std::deque<std::shared_ptr<Chunk>> pending_;
+  // Checksum and length of the input written so far.
+  uint32 check_ = 0;
+  uint64 total_in_ = 0;
+  bool closed_ = true;
+
+  // Declared last so that outstanding compressions finish before any other
+  // member is destroyed.
+  std::unique_ptr<thread::ThreadPool> pool_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ParallelZlibOutputBuffer);
+};
+
 }  // namespace io
 }  // namespace tensorflow
 
@@ -19,6 +19,7 @@ limitations under the License.
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 #include "absl/base/call_once.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/threadpool.h"
@@ -387,6 +388,7 @@ Status NcclManager::GetCommunicator(NcclManager::Collective* collective,
     devices[i] = collective->participants[i]->gpu_device_id;
   }
 
+  const uint64 init_start_us = env->NowMicros();
   std::vector<ncclComm_t> nccl_comms(collective->num_local_devices);
 #if NCCL_MAJOR >= 2
   // For NCCL 2, we always initialize using ncclCommInitRank guarded by NCCL
@@ -420,6 +422,13 @@ Status NcclManager::GetCommunicator(NcclManager::Collective* collective,
       nccl_comms.data(), collective->num_local_devices, devices.data()));
 #endif
 
+  const uint64 init_time_us = env->NowMicros() - init_start_us;
+  metrics::UpdateNcclCommunicatorInitTime(init_time_us);
+  VLOG(1) << "Initialized NCCL communicator for "
+          << collective->num_local_devices << " local and "
+          << collective->num_global_devices
+          << " global devices in " << init_time_us << " us";
+
   for (int i = 0; i < collective->num_local_devices; ++i) {
     members[i].nccl_comm = nccl_comms[i];
   }
@@ -429,6 +438,30 @@ Status NcclManager::GetCommunicator(NcclManager::Collective* collective,
   return Status::OK();
 }
 
+Status NcclManager::WarmUpCommunicator(
+    std::vector<std::unique_ptr<Participant>> participants,
+    const Context& context) {
+  if (static_cast<int>(participants.size()) != context.num_local_devices) {
+    return errors::InvalidArgument(
+        "WarmUpCommunicator expected ", context.num_local_devices,
+        " participants but got ", participants.size());
+  }
+  Collective* collective = new Collective(
+      context.collective_key, DT_INVALID, kAllReduce, ncclSum,
+      context.num_local_devices, context.num_global_devices,
+      context.communicator_key);
+  core::ScopedUnref unref(collective);
+  TF_RETURN_IF_ERROR(collective->status);
+  if (!collective->single_node && collective->communicator_key.empty()) {
+    return errors::InvalidArgument(
+        "Multi-node NCCL communicator for ", context.collective_key,
+        " needs a communicator_key");
+  }
+  collective->participants = std::move(participants);
+  Communicator* communicator = nullptr;
+  return GetCommunicator(collective, &communicator);
+}
+
 void NcclManager::AddToAllReduce(std::unique_ptr<Participant> participant,
                                  const Context& context,
                                  ncclRedOp_t reduction_op) {
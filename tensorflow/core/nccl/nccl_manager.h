@@ -191,6 +191,21 @@ class NcclManager {
   // function.
   void SignalMultiNodeReady(const string& collective_key);
 
+  // Creates the communicator that a collective over `participants` would use,
+  // if it does not exist yet, so that the first collective over these devices
+  // does not pay for NCCL initialization. Communicators are shared by all
+  // collectives over the same devices (or with the same `communicator_key`),
+  // so warming up once covers every later instance key.
+  //
+  // `participants` must hold one entry per local device. Their inputs and
+  // outputs are not used and their done callbacks are not called. For
+  // multi-node communicators, all nodes must call this concurrently with the
+  // same `context.communicator_key`, since NCCL initialization blocks until
+  // every rank has joined.
+  Status WarmUpCommunicator(
+      std::vector<std::unique_ptr<Participant>> participants,
+      const Context& context);
+
   // Aborts all collectives. After abortion, no further collectives can be
   // launched with this NcclManager.
   void StartAbort(const Status& s);
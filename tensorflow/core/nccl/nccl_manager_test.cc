@@ -494,6 +494,44 @@ TYPED_TEST(NcclManagerTest, BasicSumReduction) {
   }
 }
 
+// Warming up the communicator first must not change the result of the first
+// collective over the same devices.
+TYPED_TEST(NcclManagerTest, WarmUpCommunicator) {
+  const int num_ranks = this->NumGPUs();
+  NcclManager::Context context("warmup", /*num_local_devices=*/num_ranks,
+                               /*num_global_devices=*/num_ranks,
+                               /*communicator_key=*/"", /*source_rank=*/-1);
+  std::vector<std::unique_ptr<NcclManager::Participant>> warmup_participants;
+  for (int rank = 0; rank < num_ranks; ++rank) {
+    auto* device = this->GetDevice(num_ranks, /*node=*/0, rank);
+    auto* info = device->tensorflow_gpu_device_info();
+    warmup_participants.push_back(absl::make_unique<NcclManager::Participant>(
+        device->executor(), info->stream, info, /*input=*/nullptr,
+        /*output=*/nullptr, /*global_rank=*/-1, /*done_callback=*/nullptr));
+  }
+  TF_ASSERT_OK(NcclManager::instance()->WarmUpCommunicator(
+      std::move(warmup_participants), context));
+
+  std::unique_ptr<typename TestFixture::TestCase> test_case(
+      this->MakeReductionTestCase(/*num_nodes=*/1, num_ranks, ncclSum,
+                                  TensorShape({2, 3}), 0.0f));
+  for (int rank = 0; rank < num_ranks; ++rank) {
+    auto* device = this->GetDevice(num_ranks, /*node=*/0, rank);
+    auto* info = device->tensorflow_gpu_device_info();
+    auto participant = absl::make_unique<NcclManager::Participant>(
+        device->executor(), info->stream, info, &test_case->ins[rank],
+        &test_case->outs[rank], /*global_rank=*/-1,
+        this->CreateDoneCallback(test_case.get()));
+    NcclManager::instance()->AddToAllReduce(
+        std::move(participant),
+        {"allreduce_after_warmup", /*num_local_devices=*/num_ranks,
+         /*num_global_devices=*/num_ranks, /*communicator_key=*/"",
+         /*source_rank=*/-1},
+        ncclSum);
+  }
+  this->VerifyResults(test_case.get());
+}
+
 // Same as the Basic test, but with multiple threads launching parts of many
 // reductions.
 //
@@ -736,6 +736,15 @@ REGISTER_OP("ImmutableConst")
     .Output("tensor: dtype")
     .SetShapeFn(shape_inference::ExplicitShape);
 
+// Returns the tensor with the given handle in the process-wide
+// SharedConstantStore. Created by constant folding for large folded constants.
+REGISTER_OP("_SharedConst")
+    .Attr("dtype: type")
+    .Attr("shape: shape")
+    .Attr("handle: string")
+    .Output("tensor: dtype")
+    .SetShapeFn(shape_inference::ExplicitShape);
+
 REGISTER_OP("GuaranteeConst")
     .Input("input: T")
     .Output("output: T")
@@ -54,6 +54,10 @@ REGISTER_OP("BatchFunction")
     // NOTE: Support for `enable_large_batch_splitting == true` is still
     // developed in progress.
     .Attr("enable_large_batch_splitting: bool = false")
+    // If 'length_bucket_boundaries' is non-empty, inputs are padded along their
+    // 1st dimension up to the smallest boundary that fits them, and only
+    // inputs padded to the same length are batched together.
+    .Attr("length_bucket_boundaries: list(int) = []")
     // TODO(apassos): Fix this shape inference function. It requires shape
     // inference of function calls.
     .SetShapeFn(shape_inference::UnknownShape);
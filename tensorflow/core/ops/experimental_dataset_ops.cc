@@ -950,6 +950,7 @@ REGISTER_OP("SnapshotDataset")
     .Attr("seed2: int = 0")
     .Attr("mode: string = 'auto'")
     .Attr("snapshot_name: string = ''")
+    .Attr("num_compression_threads: int = 0")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       shape_inference::ShapeHandle unused;
       // snapshot_path should be a scalar.
@@ -439,6 +439,151 @@ REGISTER_OP("MutableDenseHashTableV2")
       return MutableHashTableShape(c, /*key=*/c->input(0), /*value=*/value_s);
     });
 
+REGISTER_OP("HashEmbeddingTable")
+    .Output("table_handle: resource")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .Attr("use_node_name_sharing: bool = false")
+    .Attr("key_dtype: {int32, int64}")
+    .Attr("value_dtype: {float, double}")
+    .Attr("embedding_dim: int >= 1")
+    .Attr("slot_initial_values: list(float) = []")
+    .Attr("admission_threshold: int >= 1 = 1")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      int64 embedding_dim;
+      TF_RETURN_IF_ERROR(c->GetAttr("embedding_dim", &embedding_dim));
+      return MutableHashTableShape(c, /*key=*/c->Scalar(),
+                                   /*value=*/c->Vector(embedding_dim));
+    });
+
+REGISTER_OP("HashEmbeddingLookup")
+    .Input("table_handle: resource")
+    .Input("keys: Tkeys")
+    .Input("default_value: Tvalues")
+    .Output("values: Tvalues")
+    .Attr("Tkeys: {int32, int64}")
+    .Attr("Tvalues: {float, double}")
+    .Attr("count_frequency: bool = true")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle handle;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &handle));
+
+      // The default value is either one row or one row per key.
+      ShapeHandle default_value;
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(2), 1, &default_value));
+      ShapeHandle output;
+      TF_RETURN_IF_ERROR(c->Concatenate(
+          c->input(1), c->Vector(c->Dim(default_value, -1)), &output));
+      c->set_output(0, output);
+      return Status::OK();
+    });
+
+Status HashEmbeddingSparseApplyShape(InferenceContext* c, int grad_index,
+                                     int indices_index) {
+  ShapeHandle handle;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &handle));
+  for (int i = 1; i < c->num_inputs(); ++i) {
+    if (i == grad_index) {
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(i), 2, &handle));
+    } else if (i == indices_index) {
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(i), 1, &handle));
+    } else {
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(i), 0, &handle));
+    }
+  }
+  DimensionHandle unused;
+  TF_RETURN_IF_ERROR(c->Merge(c->Dim(c->input(grad_index), 0),
+                              c->Dim(c->input(indices_index), 0), &unused));
+  return Status::OK();
+}
+
+REGISTER_OP("HashEmbeddingSparseApplyAdagrad")
+    .Input("table_handle: resource")
+    .Input("lr: T")
+    .Input("epsilon: T")
+    .Input("grad: T")
+    .Input("indices: Tindices")
+    .Attr("T: {float, double}")
+    .Attr("Tindices: {int32, int64}")
+    .Attr("update_slots: bool = true")
+    .SetShapeFn([](InferenceContext* c) {
+      return HashEmbeddingSparseApplyShape(c, /*grad_index=*/3,
+                                           /*indices_index=*/4);
+    });
+
+REGISTER_OP("HashEmbeddingSparseApplyFtrl")
+    .Input("table_handle: resource")
+    .Input("grad: T")
+    .Input("indices: Tindices")
+    .Input("lr: T")
+    .Input("l1: T")
+    .Input("l2: T")
+    .Input("lr_power: T")
+    .Attr("T: {float, double}")
+    .Attr("Tindices: {int32, int64}")
+    .Attr("multiply_linear_by_lr: bool = false")
+    .SetShapeFn([](InferenceContext* c) {
+      return HashEmbeddingSparseApplyShape(c, /*grad_index=*/1,
+                                           /*indices_index=*/2);
+    });
+
+REGISTER_OP("HashEmbeddingEvict")
+    .Input("table_handle: resource")
+    .Input("min_frequency: int64")
+    .Output("num_evicted: int64")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle handle;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &handle));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &handle));
+      return ScalarOutput(c);
+    });
+
+REGISTER_OP("HashEmbeddingExport")
+    .Input("table_handle: resource")
+    .Output("keys: Tkeys")
+    .Output("values: Tvalues")
+    .Output("slots: Tvalues")
+    .Output("frequencies: int64")
+    .Attr("Tkeys: {int32, int64}")
+    .Attr("Tvalues: {float, double}")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle handle;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &handle));
+      DimensionHandle n = c->UnknownDim();
+      c->set_output(0, c->Vector(n));
+      c->set_output(1, c->Matrix(n, c->UnknownDim()));
+      c->set_output(2, c->MakeShape({n, c->UnknownDim(), c->UnknownDim()}));
+      c->set_output(3, c->Vector(n));
+      return Status::OK();
+    });
+
+REGISTER_OP("HashEmbeddingImport")
+    .Input("table_handle: resource")
+    .Input("keys: Tkeys")
+    .Input("values: Tvalues")
+    .Input("slots: Tvalues")
+    .Input("frequencies: int64")
+    .Attr("Tkeys: {int32, int64}")
+    .Attr("Tvalues: {float, double}")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle handle;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &handle));
+      ShapeHandle keys;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &keys));
+      ShapeHandle values;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 2, &values));
+      ShapeHandle slots;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(3), 3, &slots));
+      ShapeHandle frequencies;
+      TF_RETURN_IF_ERROR(c->Merge(keys, c->input(4), &frequencies));
+      DimensionHandle unused;
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(keys, 0), c->Dim(values, 0), &unused));
+      TF_RETURN_IF_ERROR(c->Merge(c->Dim(keys, 0), c->Dim(slots, 0), &unused));
+      return Status::OK();
+    });
+
 REGISTER_OP("InitializeTable")
     .Input("table_handle: Ref(string)")
     .Input("keys: Tkey")
@@ -980,6 +980,34 @@ _FusedConv2D output.
 expected to create these operators.
 )doc");
 
+REGISTER_OP("_FusedElementwise")
+    .Input("x: T")
+    .Input("args: num_args * T")
+    .Output("y: T")
+    .Attr("T: {float, double}")
+    .Attr("num_args: int >= 0")
+    .Attr("fused_ops: list(string)")
+    .Attr("arg_is_lhs: list(bool) = []")
+    .SetShapeFn(shape_inference::UnchangedShape)
+    .Doc(R"doc(
+Applies a chain of element-wise operations to `x` in a single pass.
+
+The operations are specified by the `fused_ops` attribute, which is a list of
+TF op names specified as strings (e.g. "Tanh"). They are performed in order,
+where the (first) input to each op is the output of the preceding op, and the
+input of the first op is `x`.
+
+Supported unary ops are Abs, Elu, Exp, Log, Neg, Relu, Relu6, Rsqrt, Sigmoid,
+Sqrt, Square and Tanh. Supported binary ops are Add, AddV2, Div, Maximum,
+Minimum, Mul, RealDiv, SquaredDifference and Sub. Each binary op consumes the
+next tensor of `args`, which must either have the shape of `x` or be a scalar.
+If `arg_is_lhs[i]` is true, `args[i]` is the first operand of its op, and the
+output of the preceding op the second one.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
 // --------------------------------------------------------------------------
 
 // For operations where the output is a reduction function along some
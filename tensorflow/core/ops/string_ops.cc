@@ -389,4 +389,29 @@ REGISTER_OP("StringNGrams")
       return Status::OK();
     });
 
+REGISTER_OP("StringSplitNGramsToHashBucketFast")
+    .Attr("separator: string")
+    .Attr("ngram_widths: list(int) >= 0")
+    .Attr("left_pad: string")
+    .Attr("right_pad: string")
+    .Attr("pad_width: int")
+    .Attr("preserve_short_sequences: bool")
+    .Attr("num_buckets: int >= 1")
+    .Attr("Tsplits: {int32, int64} = DT_INT64")
+    .Input("input: string")
+    .Input("sep: string")
+    .Output("values: int64")
+    .Output("row_splits: Tsplits")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle input;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &input));
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &unused));
+      DimensionHandle num_splits;
+      TF_RETURN_IF_ERROR(c->Add(c->Dim(input, 0), 1, &num_splits));
+      c->set_output(0, c->UnknownShapeOfRank(1));
+      c->set_output(1, c->Vector(num_splits));
+      return Status::OK();
+    });
+
 }  // namespace tensorflow
@@ -50,6 +50,10 @@ constexpr size_t kDefaultMaxCacheSize = 0;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that sets how many blocks the LRU cache fetches in
+// parallel ahead of a sequential read. Has no effect if the cache is disabled.
+constexpr char kReadaheadBlocks[] = "GCS_READ_CACHE_READAHEAD_BLOCKS";
+constexpr size_t kDefaultReadaheadBlocks = 0;
 
 // Helper function to extract an environment variable and convert it into a
 // value of type T.
@@ -35,6 +35,7 @@ std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::Lookup(
   mutex_lock lock(mu_);
   auto entry = block_map_.find(key);
   if (entry != block_map_.end()) {
+    entry->second->prefetched = false;
     if (BlockNotStale(entry->second)) {
       if (cache_stats_ != nullptr) {
         cache_stats_->RecordCacheHitBlockSize(entry->second->data.size());
@@ -67,13 +68,18 @@ void RamFileBlockCache::Trim() {
 
 /// Move the block to the front of the LRU list if it isn't already there.
 Status RamFileBlockCache::UpdateLRU(const Key& key,
-                                    const std::shared_ptr<Block>& block) {
+                                    const std::shared_ptr<Block>& block,
+                                    bool consumed) {
   mutex_lock lock(mu_);
   if (block->timestamp == 0) {
     // The block was evicted from another thread. Allow it to remain evicted.
     return Status::OK();
   }
-  if (block->lru_iterator != lru_list_.begin()) {
+  if (consumed) {
+    lru_list_.erase(block->lru_iterator);
+    lru_list_.push_back(key);
+    block->lru_iterator = std::prev(lru_list_.end());
+  } else if (block->lru_iterator != lru_list_.begin()) {
     lru_list_.erase(block->lru_iterator);
     lru_list_.push_front(key);
     block->lru_iterator = lru_list_.begin();
@@ -82,12 +88,14 @@ Status RamFileBlockCache::UpdateLRU(const Key& key,
   // Check for inconsistent state. If there is a block later in the same file
   // in the cache, and our current block is not block size, this likely means
   // we have inconsistent state within the cache. Note: it's possible some
-  // incomplete reads may still go undetected.
+  // incomplete reads may still go undetected. Readahead blocks that were not
+  // read yet may lie past the end of the file, so they are not considered.
   if (block->data.size() < block_size_) {
-    Key fmax = std::make_pair(key.first, std::numeric_limits<size_t>::max());
-    auto fcmp = block_map_.upper_bound(fmax);
-    if (fcmp != block_map_.begin() && key < (--fcmp)->first) {
-      return errors::Internal("Block cache contents are inconsistent.");
+    for (auto it = block_map_.upper_bound(key);
+         it != block_map_.end() && it->first.first == key.first; ++it) {
+      if (!it->second->prefetched) {
+        return errors::Internal("Block cache contents are inconsistent.");
+      }
     }
   }
 
@@ -182,6 +190,12 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   if (finish < offset + n) {
     finish += block_size_;
   }
+  const bool sequential =
+      readahead_blocks_ > 0 && RecordRead(filename, offset, n);
+  if (sequential) {
+    // Start fetching the blocks after this read before waiting for its own.
+    Readahead(filename, finish);
+  }
   size_t total_bytes_transferred = 0;
   // Now iterate through the blocks, reading them one at a time.
   for (size_t pos = start; pos < finish; pos += block_size_) {
@@ -191,7 +205,8 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
     std::shared_ptr<Block> block = Lookup(key);
     DCHECK(block) << "No block for key " << key.first << "@" << key.second;
     TF_RETURN_IF_ERROR(MaybeFetch(key, block));
-    TF_RETURN_IF_ERROR(UpdateLRU(key, block));
+    TF_RETURN_IF_ERROR(
+        UpdateLRU(key, block, sequential && pos + block_size_ <= offset + n));
     // Copy the relevant portion of the block into the result buffer.
     const auto& data = block->data;
     if (offset >= pos + data.size()) {
@@ -227,6 +242,60 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   return Status::OK();
 }
 
+bool RamFileBlockCache::RecordRead(const string& filename, size_t offset,
+                                   size_t n) {
+  mutex_lock lock(mu_);
+  if (read_ends_.size() >= kMaxTrackedFiles &&
+      read_ends_.find(filename) == read_ends_.end()) {
+    read_ends_.clear();
+  }
+  auto it = read_ends_.emplace(filename, 0).first;
+  const bool sequential = it->second == offset && offset > 0;
+  it->second = offset + n;
+  return sequential;
+}
+
+void RamFileBlockCache::Readahead(const string& filename, size_t pos) {
+  std::vector<std::pair<Key, std::shared_ptr<Block>>> blocks;
+  {
+    mutex_lock lock(mu_);
+    for (size_t i = 0; i < readahead_blocks_; ++i, pos += block_size_) {
+      Key key = std::make_pair(filename, pos);
+      if (block_map_.find(key) != block_map_.end()) continue;
+      auto block = std::make_shared<Block>();
+      lru_list_.push_front(key);
+      lra_list_.push_front(key);
+      block->lru_iterator = lru_list_.begin();
+      block->lra_iterator = lra_list_.begin();
+      block->timestamp = env_->NowSeconds();
+      block->prefetched = true;
+      block_map_.emplace(key, block);
+      blocks.emplace_back(std::move(key), std::move(block));
+    }
+  }
+  for (auto& key_and_block : blocks) {
+    readahead_pool_->Schedule(
+        [this, key = std::move(key_and_block.first),
+         block = std::move(key_and_block.second)]() {
+          FetchReadaheadBlock(key, block);
+        });
+  }
+}
+
+void RamFileBlockCache::FetchReadaheadBlock(
+    const Key& key, const std::shared_ptr<Block>& block) {
+  const Status status = MaybeFetch(key, block);
+  mutex_lock lock(mu_);
+  if (block->timestamp == 0) return;  // Evicted meanwhile.
+  if (!status.ok() || block->data.size() < block_size_) {
+    auto entry = block_map_.find(key);
+    if (entry != block_map_.end() && entry->second == block) {
+      RemoveBlock(entry);
+    }
+  }
+  Trim();
+}
+
 bool RamFileBlockCache::ValidateAndUpdateFileSignature(const string& filename,
                                                        int64 file_signature) {
   mutex_lock lock(mu_);
@@ -271,12 +340,14 @@ void RamFileBlockCache::Flush() {
   block_map_.clear();
   lru_list_.clear();
   lra_list_.clear();
+  read_ends_.clear();
   cache_size_ = 0;
 }
 
 void RamFileBlockCache::RemoveFile(const string& filename) {
   mutex_lock lock(mu_);
   RemoveFile_Locked(filename);
+  read_ends_.erase(filename);
 }
 
 void RamFileBlockCache::RemoveFile_Locked(const string& filename) {
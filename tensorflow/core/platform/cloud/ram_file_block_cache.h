@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/stringpiece.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -50,22 +51,38 @@ class RamFileBlockCache : public FileBlockCache {
                                size_t* bytes_transferred)>
       BlockFetcher;
 
+  /// If `readahead_blocks` is positive, reads that continue where the previous
+  /// read of the same file ended are treated as a sequential scan: up to
+  /// `readahead_blocks` blocks past the read are fetched in parallel in the
+  /// background, and blocks the scan has moved past become the first to be
+  /// evicted, so that streaming reads do not push out randomly accessed ones.
   RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
-                    BlockFetcher block_fetcher, Env* env = Env::Default())
+                    BlockFetcher block_fetcher, Env* env = Env::Default(),
+                    size_t readahead_blocks = 0)
       : block_size_(block_size),
         max_bytes_(max_bytes),
         max_staleness_(max_staleness),
         block_fetcher_(block_fetcher),
-        env_(env) {
+        env_(env),
+        readahead_blocks_(IsCacheEnabled() ? readahead_blocks : 0) {
     if (max_staleness_ > 0) {
       pruning_thread_.reset(env_->StartThread(ThreadOptions(), "TF_prune_FBC",
                                               [this] { Prune(); }));
     }
+    if (readahead_blocks_ > 0) {
+      readahead_pool_.reset(new thread::ThreadPool(
+          env_, "TF_readahead_FBC",
+          static_cast<int>(
+              std::min(readahead_blocks_, size_t{kMaxReadaheadThreads}))));
+    }
     VLOG(1) << "GCS file block cache is "
-            << (IsCacheEnabled() ? "enabled" : "disabled");
+            << (IsCacheEnabled() ? "enabled" : "disabled")
+            << ", readahead blocks = " << readahead_blocks_;
   }
 
   ~RamFileBlockCache() override {
+    // Wait for in-flight readahead, which uses the members below.
+    readahead_pool_.reset();
     if (pruning_thread_) {
       stop_pruning_thread_.Notify();
       // Destroying pruning_thread_ will block until Prune() receives the above
@@ -131,6 +148,13 @@ class RamFileBlockCache : public FileBlockCache {
   const BlockFetcher block_fetcher_;
   /// The Env from which we read timestamps.
   Env* const env_;  // not owned
+  /// The number of blocks fetched ahead of a sequential scan.
+  const size_t readahead_blocks_;
+
+  /// The maximum number of concurrent readahead fetches.
+  static constexpr size_t kMaxReadaheadThreads = 16;
+  /// The maximum number of files whose last read offset is remembered.
+  static constexpr size_t kMaxTrackedFiles = 1024;
 
   /// \brief The key type for the file block cache.
   ///
@@ -181,6 +205,9 @@ class RamFileBlockCache : public FileBlockCache {
     FetchState state TF_GUARDED_BY(mu) = FetchState::CREATED;
     /// Wait on cond_var if state is FETCHING.
     condition_variable cond_var;
+    /// True if the block was added by readahead and has not been read yet.
+    /// Guarded by the block-cache-wide mu_.
+    bool prefetched = false;
   };
 
   /// \brief The block map type for the file block cache.
@@ -203,8 +230,25 @@ class RamFileBlockCache : public FileBlockCache {
   /// Trim the block cache to make room for another entry.
   void Trim() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
-  /// Update the LRU iterator for the block at `key`.
-  Status UpdateLRU(const Key& key, const std::shared_ptr<Block>& block)
+  /// Update the LRU iterator for the block at `key`. The block moves to the
+  /// front of the LRU list, or to the back if `consumed` is true, i.e. a
+  /// sequential scan has read past it.
+  Status UpdateLRU(const Key& key, const std::shared_ptr<Block>& block,
+                   bool consumed = false) TF_LOCKS_EXCLUDED(mu_);
+
+  /// Records a read of [offset, offset + n) from `filename`, and returns true
+  /// if it starts where the previous read of the file ended.
+  bool RecordRead(const string& filename, size_t offset, size_t n)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  /// Starts fetching in the background the blocks of `filename` in the
+  /// readahead window that begins at block-aligned offset `pos`.
+  void Readahead(const string& filename, size_t pos) TF_LOCKS_EXCLUDED(mu_);
+
+  /// Fetches a block added by Readahead(). Blocks that fail or turn out to be
+  /// partial (i.e. at or past the end of the file) are dropped again, since
+  /// the reader may not have asked for them.
+  void FetchReadaheadBlock(const Key& key, const std::shared_ptr<Block>& block)
       TF_LOCKS_EXCLUDED(mu_);
 
   /// Remove all blocks of a file, with mu_ already held.
@@ -218,6 +262,9 @@ class RamFileBlockCache : public FileBlockCache {
   /// The cache pruning thread that removes files with expired blocks.
   std::unique_ptr<Thread> pruning_thread_;
 
+  /// The threads fetching readahead blocks. Null if readahead is disabled.
+  std::unique_ptr<thread::ThreadPool> readahead_pool_;
+
   /// Notification for stopping the cache pruning thread.
   Notification stop_pruning_thread_;
 
@@ -243,6 +290,10 @@ class RamFileBlockCache : public FileBlockCache {
 
   // A filename->file_signature map.
   std::map<string, int64> file_signature_map_ TF_GUARDED_BY(mu_);
+
+  /// The offset at which the last read of each file ended, used to detect
+  /// sequential scans. Only maintained if readahead is enabled.
+  std::map<string, size_t> read_ends_ TF_GUARDED_BY(mu_);
 };
 
 }  // namespace tensorflow
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/cloud/now_seconds_env.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -566,5 +567,69 @@ TEST(RamFileBlockCacheTest, Flush) {
   EXPECT_EQ(calls, 2);
 }
 
+TEST(RamFileBlockCacheTest, ReadaheadSequentialScan) {
+  const size_t block_size = 16;
+  const size_t file_size = 9 * block_size + 8;
+  mutex mu;
+  std::map<size_t, int> calls;
+  auto fetcher = [&](const string& filename, size_t offset, size_t n,
+                     char* buffer, size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      calls[offset]++;
+    }
+    *bytes_transferred = 0;
+    for (size_t i = offset; i < offset + n && i < file_size; ++i) {
+      buffer[(*bytes_transferred)++] = static_cast<char>('a' + i % 26);
+    }
+    return Status::OK();
+  };
+  RamFileBlockCache cache(block_size, 64 * block_size, 0, fetcher,
+                          Env::Default(), /*readahead_blocks=*/4);
+  std::vector<char> out;
+  string contents;
+  for (size_t offset = 0; offset < file_size; offset += block_size) {
+    TF_EXPECT_OK(ReadCache(&cache, "a", offset, block_size, &out));
+    contents.append(out.begin(), out.end());
+  }
+  ASSERT_EQ(contents.size(), file_size);
+  for (size_t i = 0; i < file_size; ++i) {
+    EXPECT_EQ(contents[i], static_cast<char>('a' + i % 26));
+  }
+  mutex_lock l(mu);
+  for (size_t offset = 0; offset + block_size <= file_size;
+       offset += block_size) {
+    EXPECT_EQ(calls[offset], 1) << "at offset " << offset;
+  }
+}
+
+TEST(RamFileBlockCacheTest, ReadaheadScanDoesNotEvictRandomReads) {
+  const size_t block_size = 16;
+  mutex mu;
+  std::map<string, int> calls;
+  auto fetcher = [&](const string& filename, size_t offset, size_t n,
+                     char* buffer, size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      calls[filename]++;
+    }
+    // "stream" holds 8 blocks, "hot" holds one.
+    const size_t file_size = (filename == "stream" ? 8 : 1) * block_size;
+    *bytes_transferred = offset < file_size ? n : 0;
+    memset(buffer, 'x', *bytes_transferred);
+    return Status::OK();
+  };
+  RamFileBlockCache cache(block_size, 4 * block_size, 0, fetcher,
+                          Env::Default(), /*readahead_blocks=*/1);
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "hot", 0, block_size, &out));
+  for (size_t offset = 0; offset < 8 * block_size; offset += block_size) {
+    TF_EXPECT_OK(ReadCache(&cache, "stream", offset, block_size, &out));
+  }
+  TF_EXPECT_OK(ReadCache(&cache, "hot", 0, block_size, &out));
+  mutex_lock l(mu);
+  EXPECT_EQ(calls["hot"], 1);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -24,6 +24,7 @@ limitations under the License.
 
 #if defined(__linux__) && !defined(__ANDROID__)
 #include <sched.h>
+#include <sys/mman.h>
 #include <sys/sysinfo.h>
 #else
 #include <sys/syscall.h>
@@ -198,6 +199,10 @@ void NUMASetThreadNodeAffinity(int node) {
     if (obj) {
       hwloc_set_cpubind(hwloc_topology_handle, obj->cpuset,
                         HWLOC_CPUBIND_THREAD | HWLOC_CPUBIND_STRICT);
+      // Also allocate the memory the thread touches first (e.g. its stack and
+      // its malloc arenas) on the node, so it does not access remote memory.
+      hwloc_set_membind(hwloc_topology_handle, obj->nodeset, HWLOC_MEMBIND_BIND,
+                        HWLOC_MEMBIND_THREAD | HWLOC_MEMBIND_BYNODESET);
     } else {
       LOG(ERROR) << "Could not find hwloc NUMA node " << node;
     }
@@ -281,6 +286,23 @@ void NUMAFree(void* ptr, size_t size) {
   Free(ptr);
 }
 
+bool AdviseHugePages(void* ptr, size_t size) {
+#if defined(__linux__) && !defined(__ANDROID__) && defined(MADV_HUGEPAGE)
+  // madvise() applies to whole pages, so only advise the huge pages that lie
+  // entirely within the range.
+  const uintptr_t begin =
+      (reinterpret_cast<uintptr_t>(ptr) + kHugePageSize - 1) &
+      ~(kHugePageSize - 1);
+  const uintptr_t end =
+      (reinterpret_cast<uintptr_t>(ptr) + size) & ~(kHugePageSize - 1);
+  if (begin >= end) return false;
+  return madvise(reinterpret_cast<void*>(begin), end - begin,
+                 MADV_HUGEPAGE) == 0;
+#else
+  return false;
+#endif
+}
+
 int NUMAGetMemAffinity(const void* addr) {
   int node = kNUMANoAffinity;
 #ifdef TENSORFLOW_USE_NUMA
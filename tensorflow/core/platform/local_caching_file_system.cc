@@ -0,0 +1,241 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/local_caching_file_system.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/str_util.h"
+#include "tensorflow/core/platform/strcat.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Suffix of blocks being written. Such files are skipped by eviction.
+constexpr char kTempSuffix[] = ".tmp";
+
+// Eviction deletes blocks until the cache is at most this fraction of its
+// budget, so that it does not have to scan the directory on every insert.
+constexpr double kEvictionLowWatermark = 0.9;
+
+class CachingRandomAccessFile : public RandomAccessFile {
+ public:
+  CachingRandomAccessFile(LocalCachingFileSystem* fs, string file_key,
+                          uint64 length,
+                          std::unique_ptr<RandomAccessFile> base_file)
+      : fs_(fs),
+        file_key_(std::move(file_key)),
+        length_(length),
+        base_file_(std::move(base_file)) {}
+
+  Status Name(StringPiece* result) const override {
+    return base_file_->Name(result);
+  }
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override {
+    const uint64 block_size = fs_->block_size();
+    const uint64 end = std::min<uint64>(offset + n, length_);
+    size_t copied = 0;
+    mutex_lock l(mu_);
+    for (uint64 pos = offset; pos < end;) {
+      const uint64 index = pos / block_size;
+      const uint64 block_offset = pos - index * block_size;
+      const size_t bytes = std::min(end - pos, block_size - block_offset);
+      if (index != block_index_ || (!block_file_ && block_data_.empty())) {
+        block_file_.reset();
+        block_data_.clear();
+        TF_RETURN_IF_ERROR(fs_->OpenBlock(file_key_, length_, base_file_.get(),
+                                          index, &block_file_, &block_data_));
+        block_index_ = index;
+      }
+      if (block_file_) {
+        StringPiece piece;
+        TF_RETURN_IF_ERROR(
+            block_file_->Read(block_offset, bytes, &piece, scratch + copied));
+        if (piece.size() != bytes) {
+          return errors::DataLoss("Cached block ", index, " of ", file_key_,
+                                  " is truncated");
+        }
+        if (piece.data() != scratch + copied) {
+          memmove(scratch + copied, piece.data(), bytes);
+        }
+      } else {
+        memcpy(scratch + copied, block_data_.data() + block_offset, bytes);
+      }
+      copied += bytes;
+      pos += bytes;
+    }
+    *result = StringPiece(scratch, copied);
+    if (copied < n) {
+      return errors::OutOfRange("Read less bytes than requested");
+    }
+    return Status::OK();
+  }
+
+ private:
+  LocalCachingFileSystem* const fs_;  // Not owned.
+  const string file_key_;
+  const uint64 length_;
+  const std::unique_ptr<RandomAccessFile> base_file_;
+
+  // The block read last, either from the cache or from base_file_.
+  mutable mutex mu_;
+  mutable uint64 block_index_ TF_GUARDED_BY(mu_) = 0;
+  mutable std::unique_ptr<RandomAccessFile> block_file_ TF_GUARDED_BY(mu_);
+  mutable string block_data_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+LocalCachingFileSystem::LocalCachingFileSystem(
+    std::unique_ptr<FileSystem> base_file_system, const Options& options,
+    Env* env)
+    : base_file_system_(std::move(base_file_system)),
+      options_(options),
+      env_(env) {
+  Status s = env_->RecursivelyCreateDir(options_.cache_dir);
+  if (!s.ok()) {
+    LOG(WARNING) << "Could not create cache directory " << options_.cache_dir
+                 << ": " << s;
+  }
+}
+
+Status LocalCachingFileSystem::NewRandomAccessFile(
+    const string& filename, TransactionToken* token,
+    std::unique_ptr<RandomAccessFile>* result) {
+  std::unique_ptr<RandomAccessFile> base_file;
+  TF_RETURN_IF_ERROR(
+      base_file_system_->NewRandomAccessFile(filename, token, &base_file));
+  FileStatistics stat;
+  if (options_.block_size == 0 ||
+      !base_file_system_->Stat(filename, token, &stat).ok() ||
+      stat.is_directory || stat.length < 0) {
+    // Without a length and version the contents cannot be cached safely.
+    *result = std::move(base_file);
+    return Status::OK();
+  }
+  const string file_key = strings::StrCat(
+      strings::Hex(Fingerprint64(strings::StrCat(
+          filename, "@", stat.length, "@", stat.mtime_nsec))));
+  result->reset(new CachingRandomAccessFile(this, file_key, stat.length,
+                                            std::move(base_file)));
+  return Status::OK();
+}
+
+Status LocalCachingFileSystem::OpenBlock(
+    const string& file_key, uint64 length, RandomAccessFile* base_file,
+    uint64 index, std::unique_ptr<RandomAccessFile>* cached, string* fetched) {
+  const uint64 offset = index * options_.block_size;
+  const size_t expected_size =
+      std::min<uint64>(options_.block_size, length - offset);
+  const string path = io::JoinPath(options_.cache_dir,
+                                   strings::StrCat(file_key, "_", index));
+  uint64 cached_size;
+  if (env_->GetFileSize(path, &cached_size).ok() &&
+      cached_size == expected_size &&
+      env_->NewRandomAccessFile(path, cached).ok()) {
+    return Status::OK();
+  }
+
+  fetched->resize(expected_size);
+  StringPiece contents;
+  Status s = base_file->Read(offset, expected_size, &contents, &(*fetched)[0]);
+  if (contents.size() != expected_size) {
+    if (s.ok()) {
+      s = errors::DataLoss("Read ", contents.size(), " bytes at offset ",
+                           offset, " but expected ", expected_size);
+    }
+    return s;
+  }
+  if (contents.data() != fetched->data()) {
+    memmove(&(*fetched)[0], contents.data(), contents.size());
+  }
+  WriteBlock(path, *fetched);
+  return Status::OK();
+}
+
+void LocalCachingFileSystem::WriteBlock(const string& path,
+                                        const string& data) {
+  const string tmp_path =
+      strings::StrCat(path, ".", random::New64(), kTempSuffix);
+  Status s = WriteStringToFile(env_, tmp_path, data);
+  if (s.ok()) s = env_->RenameFile(tmp_path, path);
+  if (!s.ok()) {
+    VLOG(1) << "Could not cache block " << path << ": " << s;
+    env_->DeleteFile(tmp_path).IgnoreError();
+    return;
+  }
+  AddCachedBytes(data.size());
+}
+
+void LocalCachingFileSystem::AddCachedBytes(uint64 bytes) {
+  mutex_lock l(mu_);
+  if (cached_bytes_ >= 0) cached_bytes_ += bytes;
+  if (cached_bytes_ < 0 ||
+      static_cast<uint64>(cached_bytes_) > options_.max_bytes) {
+    Evict();
+  }
+}
+
+void LocalCachingFileSystem::Evict() {
+  std::vector<string> children;
+  Status s = env_->GetChildren(options_.cache_dir, &children);
+  if (!s.ok()) {
+    VLOG(1) << "Could not list cache directory " << options_.cache_dir << ": "
+            << s;
+    return;
+  }
+  struct CachedBlock {
+    string path;
+    int64 mtime_nsec;
+    int64 length;
+  };
+  std::vector<CachedBlock> blocks;
+  uint64 total_bytes = 0;
+  for (const string& child : children) {
+    if (str_util::EndsWith(child, kTempSuffix)) continue;
+    const string path = io::JoinPath(options_.cache_dir, child);
+    FileStatistics stat;
+    // Another process may have deleted the block meanwhile.
+    if (!env_->Stat(path, &stat).ok() || stat.is_directory) continue;
+    blocks.push_back({path, stat.mtime_nsec, stat.length});
+    total_bytes += stat.length;
+  }
+  const uint64 target_bytes = options_.max_bytes * kEvictionLowWatermark;
+  if (total_bytes > options_.max_bytes) {
+    std::sort(blocks.begin(), blocks.end(),
+              [](const CachedBlock& a, const CachedBlock& b) {
+                return a.mtime_nsec < b.mtime_nsec;
+              });
+    for (const CachedBlock& block : blocks) {
+      if (total_bytes <= target_bytes) break;
+      // Failures mean another process already evicted the block.
+      env_->DeleteFile(block.path).IgnoreError();
+      total_bytes -= block.length;
+    }
+  }
+  cached_bytes_ = total_bytes;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,185 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_PLATFORM_LOCAL_CACHING_FILE_SYSTEM_H_
+#define TENSORFLOW_CORE_PLATFORM_LOCAL_CACHING_FILE_SYSTEM_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+/// A wrapper that caches the contents of files read from another (usually
+/// remote) file system in a directory on local disk.
+///
+/// Files are cached in blocks of `block_size` bytes, each stored as one file
+/// in `cache_dir`. Block names include a fingerprint of the file name and of
+/// the length and modification time reported by the base file system when the
+/// file is opened, so a rewritten file gets new blocks and stale contents are
+/// never served. Blocks are written to a temporary file and renamed into
+/// place, which lets several processes on a host share `cache_dir`. Once the
+/// blocks in `cache_dir` exceed `max_bytes`, the least recently cached ones
+/// are deleted.
+///
+/// Only reads through NewRandomAccessFile() are cached; every other operation
+/// is forwarded to the base file system.
+class LocalCachingFileSystem : public FileSystem {
+ public:
+  struct Options {
+    /// Local directory holding the cached blocks. Created if missing.
+    string cache_dir;
+    /// The size of the cached blocks and of the reads from the base file
+    /// system.
+    size_t block_size = 16 * 1024 * 1024;
+    /// The maximum number of bytes kept in `cache_dir`.
+    uint64 max_bytes = 8ULL * 1024 * 1024 * 1024;
+  };
+
+  LocalCachingFileSystem(std::unique_ptr<FileSystem> base_file_system,
+                         const Options& options, Env* env = Env::Default());
+
+  TF_USE_FILESYSTEM_METHODS_WITH_NO_TRANSACTION_SUPPORT;
+
+  Status NewRandomAccessFile(
+      const string& filename, TransactionToken* token,
+      std::unique_ptr<RandomAccessFile>* result) override;
+
+  Status NewWritableFile(const string& filename, TransactionToken* token,
+                         std::unique_ptr<WritableFile>* result) override {
+    return base_file_system_->NewWritableFile(filename, token, result);
+  }
+
+  Status NewAppendableFile(const string& filename, TransactionToken* token,
+                           std::unique_ptr<WritableFile>* result) override {
+    return base_file_system_->NewAppendableFile(filename, token, result);
+  }
+
+  Status NewReadOnlyMemoryRegionFromFile(
+      const string& filename, TransactionToken* token,
+      std::unique_ptr<ReadOnlyMemoryRegion>* result) override {
+    return base_file_system_->NewReadOnlyMemoryRegionFromFile(filename, token,
+                                                              result);
+  }
+
+  Status FileExists(const string& fname, TransactionToken* token) override {
+    return base_file_system_->FileExists(fname, token);
+  }
+
+  Status GetChildren(const string& dir, TransactionToken* token,
+                     std::vector<string>* result) override {
+    return base_file_system_->GetChildren(dir, token, result);
+  }
+
+  Status GetMatchingPaths(const string& pattern, TransactionToken* token,
+                          std::vector<string>* result) override {
+    return base_file_system_->GetMatchingPaths(pattern, token, result);
+  }
+
+  Status Stat(const string& fname, TransactionToken* token,
+              FileStatistics* stat) override {
+    return base_file_system_->Stat(fname, token, stat);
+  }
+
+  Status DeleteFile(const string& fname, TransactionToken* token) override {
+    return base_file_system_->DeleteFile(fname, token);
+  }
+
+  Status CreateDir(const string& dirname, TransactionToken* token) override {
+    return base_file_system_->CreateDir(dirname, token);
+  }
+
+  Status DeleteDir(const string& dirname, TransactionToken* token) override {
+    return base_file_system_->DeleteDir(dirname, token);
+  }
+
+  Status GetFileSize(const string& fname, TransactionToken* token,
+                     uint64* file_size) override {
+    return base_file_system_->GetFileSize(fname, token, file_size);
+  }
+
+  Status RenameFile(const string& src, const string& target,
+                    TransactionToken* token) override {
+    return base_file_system_->RenameFile(src, target, token);
+  }
+
+  Status IsDirectory(const string& dirname, TransactionToken* token) override {
+    return base_file_system_->IsDirectory(dirname, token);
+  }
+
+  Status HasAtomicMove(const string& path, bool* has_atomic_move) override {
+    return base_file_system_->HasAtomicMove(path, has_atomic_move);
+  }
+
+  Status DeleteRecursively(const string& dirname, TransactionToken* token,
+                           int64* undeleted_files,
+                           int64* undeleted_dirs) override {
+    return base_file_system_->DeleteRecursively(dirname, token, undeleted_files,
+                                                undeleted_dirs);
+  }
+
+  /// Flushes the caches of the base file system. The blocks on local disk are
+  /// kept, since they are only ever used for an unchanged file.
+  void FlushCaches(TransactionToken* token) override {
+    base_file_system_->FlushCaches(token);
+  }
+
+  FileSystem* underlying() const { return base_file_system_.get(); }
+
+  /// Opens block `index` of the file opened as `base_file`, which is `length`
+  /// bytes long. `file_key` identifies the file and its version. On a hit,
+  /// sets `*cached` to the cached block. Otherwise reads the block from
+  /// `base_file` into `*fetched` and caches it.
+  Status OpenBlock(const string& file_key, uint64 length,
+                   RandomAccessFile* base_file, uint64 index,
+                   std::unique_ptr<RandomAccessFile>* cached, string* fetched);
+
+  size_t block_size() const { return options_.block_size; }
+
+ private:
+  /// Writes a block to `path` so that readers never see a partial block.
+  void WriteBlock(const string& path, const string& data);
+
+  /// Accounts for `bytes` newly cached bytes, and evicts blocks if the cache
+  /// is over budget.
+  void AddCachedBytes(uint64 bytes) TF_LOCKS_EXCLUDED(mu_);
+
+  /// Deletes the least recently cached blocks in the cache directory, which
+  /// may have been written by other processes, until their total size is
+  /// below the budget.
+  void Evict() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  std::unique_ptr<FileSystem> base_file_system_;
+  const Options options_;
+  Env* const env_;  // Not owned; used for the cache directory.
+
+  mutex mu_;
+  /// Estimate of the bytes in the cache directory, or -1 before the first
+  /// scan. Blocks cached by other processes are only seen by Evict().
+  int64 cached_bytes_ TF_GUARDED_BY(mu_) = -1;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(LocalCachingFileSystem);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PLATFORM_LOCAL_CACHING_FILE_SYSTEM_H_
@@ -0,0 +1,185 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/local_caching_file_system.h"
+
+#include <map>
+
+#include "absl/memory/memory.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/null_file_system.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// An in-memory file system that counts the bytes read from it.
+class FakeRemoteFileSystem : public NullFileSystem {
+ public:
+  TF_USE_FILESYSTEM_METHODS_WITH_NO_TRANSACTION_SUPPORT;
+
+  void SetFile(const string& fname, const string& contents) {
+    files_[fname] = contents;
+    ++version_;
+  }
+
+  int64 bytes_read() const { return bytes_read_; }
+
+  Status NewRandomAccessFile(
+      const string& fname, TransactionToken* token,
+      std::unique_ptr<RandomAccessFile>* result) override {
+    if (files_.find(fname) == files_.end()) {
+      return errors::NotFound(fname);
+    }
+    result->reset(new File(this, files_[fname]));
+    return Status::OK();
+  }
+
+  Status Stat(const string& fname, TransactionToken* token,
+              FileStatistics* stat) override {
+    if (files_.find(fname) == files_.end()) {
+      return errors::NotFound(fname);
+    }
+    *stat = FileStatistics(files_[fname].size(), version_, false);
+    return Status::OK();
+  }
+
+ private:
+  class File : public RandomAccessFile {
+   public:
+    File(FakeRemoteFileSystem* fs, const string& contents)
+        : fs_(fs), contents_(contents) {}
+
+    Status Read(uint64 offset, size_t n, StringPiece* result,
+                char* scratch) const override {
+      if (offset >= contents_.size()) {
+        *result = StringPiece();
+        return errors::OutOfRange("EOF");
+      }
+      const size_t bytes = std::min<size_t>(n, contents_.size() - offset);
+      memcpy(scratch, contents_.data() + offset, bytes);
+      fs_->bytes_read_ += bytes;
+      *result = StringPiece(scratch, bytes);
+      return bytes < n ? errors::OutOfRange("EOF") : Status::OK();
+    }
+
+   private:
+    FakeRemoteFileSystem* const fs_;
+    const string contents_;
+  };
+
+  std::map<string, string> files_;
+  int64 version_ = 0;
+  int64 bytes_read_ = 0;
+};
+
+class LocalCachingFileSystemTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    options_.cache_dir =
+        io::JoinPath(testing::TmpDir(), "local_caching_file_system_test",
+                     ::testing::UnitTest::GetInstance()
+                         ->current_test_info()
+                         ->name());
+    int64 undeleted_files, undeleted_dirs;
+    Env::Default()
+        ->DeleteRecursively(options_.cache_dir, &undeleted_files,
+                            &undeleted_dirs)
+        .IgnoreError();
+    options_.block_size = 8;
+    options_.max_bytes = 1024;
+  }
+
+  // Returns a caching file system over a new FakeRemoteFileSystem holding
+  // `contents` as "remote://file".
+  std::unique_ptr<LocalCachingFileSystem> MakeFileSystem(
+      const string& contents, FakeRemoteFileSystem** remote) {
+    *remote = new FakeRemoteFileSystem;
+    (*remote)->SetFile("remote://file", contents);
+    return absl::make_unique<LocalCachingFileSystem>(
+        std::unique_ptr<FileSystem>(*remote), options_);
+  }
+
+  static Status ReadAll(FileSystem* fs, size_t n, string* contents) {
+    std::unique_ptr<RandomAccessFile> file;
+    TF_RETURN_IF_ERROR(fs->NewRandomAccessFile("remote://file", &file));
+    contents->resize(n);
+    StringPiece result;
+    Status s = file->Read(0, n, &result, &(*contents)[0]);
+    contents->assign(result.data(), result.size());
+    return s;
+  }
+
+  LocalCachingFileSystem::Options options_;
+};
+
+TEST_F(LocalCachingFileSystemTest, SecondReaderIsServedFromCache) {
+  const string data = "0123456789abcdefghijklmnopqrstuvwxyz";
+  FakeRemoteFileSystem* first_remote;
+  auto first = MakeFileSystem(data, &first_remote);
+  string contents;
+  TF_EXPECT_OK(ReadAll(first.get(), data.size(), &contents));
+  EXPECT_EQ(contents, data);
+  EXPECT_EQ(first_remote->bytes_read(), data.size());
+
+  // Another instance, e.g. in another process, shares the cache directory.
+  FakeRemoteFileSystem* second_remote;
+  auto second = MakeFileSystem(data, &second_remote);
+  TF_EXPECT_OK(ReadAll(second.get(), data.size(), &contents));
+  EXPECT_EQ(contents, data);
+  EXPECT_EQ(second_remote->bytes_read(), 0);
+}
+
+TEST_F(LocalCachingFileSystemTest, ReadPastEndOfFile) {
+  FakeRemoteFileSystem* remote;
+  auto fs = MakeFileSystem("0123456789", &remote);
+  string contents;
+  EXPECT_EQ(ReadAll(fs.get(), 20, &contents).code(), error::OUT_OF_RANGE);
+  EXPECT_EQ(contents, "0123456789");
+}
+
+TEST_F(LocalCachingFileSystemTest, ChangedFileIsReadAgain) {
+  FakeRemoteFileSystem* remote;
+  auto fs = MakeFileSystem("0123456789", &remote);
+  string contents;
+  TF_EXPECT_OK(ReadAll(fs.get(), 10, &contents));
+  remote->SetFile("remote://file", "abcdefghij");
+  TF_EXPECT_OK(ReadAll(fs.get(), 10, &contents));
+  EXPECT_EQ(contents, "abcdefghij");
+  EXPECT_EQ(remote->bytes_read(), 20);
+}
+
+TEST_F(LocalCachingFileSystemTest, EvictsToStayWithinBudget) {
+  options_.max_bytes = 32;
+  FakeRemoteFileSystem* remote;
+  auto fs = MakeFileSystem(string(256, 'x'), &remote);
+  string contents;
+  TF_EXPECT_OK(ReadAll(fs.get(), 256, &contents));
+
+  std::vector<string> children;
+  TF_ASSERT_OK(Env::Default()->GetChildren(options_.cache_dir, &children));
+  uint64 total_bytes = 0;
+  for (const string& child : children) {
+    uint64 size;
+    TF_ASSERT_OK(Env::Default()->GetFileSize(
+        io::JoinPath(options_.cache_dir, child), &size));
+    total_bytes += size;
+  }
+  EXPECT_LE(total_bytes, options_.max_bytes);
+}
+
+}  // namespace
+}  // namespace tensorflow
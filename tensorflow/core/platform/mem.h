@@ -33,6 +33,15 @@ void* Malloc(size_t size);
 void* Realloc(void* ptr, size_t size);
 void Free(void* ptr);
 
+// Size of the huge pages that AdviseHugePages() asks for.
+constexpr size_t kHugePageSize = 2 << 20;
+
+// Asks the operating system to back the kHugePageSize-aligned part of
+// [ptr, ptr + size) with transparent huge pages, which reduces TLB misses on
+// large buffers. Returns false if huge pages are not supported, in which case
+// the memory keeps being backed by regular pages.
+bool AdviseHugePages(void* ptr, size_t size);
+
 // Tries to release num_bytes of free memory back to the operating
 // system for reuse.  Use this routine with caution -- to get this
 // memory back may require faulting pages back in by the OS, and
@@ -32,7 +32,8 @@ int NUMANumNodes();
 
 static const int kNUMANoAffinity = -1;
 
-// If possible sets affinity of the current thread to the specified NUMA node.
+// If possible sets affinity of the current thread to the specified NUMA node,
+// and binds the memory it allocates to the node.
 // If node == kNUMANoAffinity removes affinity to any particular node.
 void NUMASetThreadNodeAffinity(int node);
 
@@ -28,6 +28,7 @@ limitations under the License.
 #include <aws/s3/model/CompletedMultipartUpload.h>
 #include <aws/s3/model/CompletedPart.h>
 #include <aws/s3/model/CopyObjectRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadBucketRequest.h>
@@ -35,6 +36,7 @@ limitations under the License.
 #include <aws/s3/model/ListObjectsRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
 #include <aws/s3/model/UploadPartCopyRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 
 #include <cmath>
 #include <cstdlib>
@@ -62,6 +64,10 @@ static const int64 kS3TimeoutMsec = 300000;                           // 5 min
 static const uint64 kS3MultiPartUploadChunkSize = 50 * 1024 * 1024;   // 50 MB
 static const uint64 kS3MultiPartDownloadChunkSize = 2 * 1024 * 1024;  // 50 MB
 static const int kS3GetChildrenMaxKeys = 100;
+// S3 rejects multipart uploads whose parts (except the last) are smaller.
+static const uint64 kS3MinMultiPartUploadPartSize = 5 * 1024 * 1024;  // 5 MB
+// Parts of a streaming upload that may be in flight at once, per file.
+static const int kS3MaxPendingStreamingParts = 4;
 
 // With this change multiple threads are used in one single download.
 // Increasing the thread pool size since multiple downloads
@@ -344,12 +350,20 @@ class S3RandomAccessFile : public RandomAccessFile {
   bool use_multi_part_download_;
 };
 
+// A file written to S3 on Sync(), or when closed.
+//
+// If `streaming_part_size` is non-zero, every `streaming_part_size` bytes
+// appended are uploaded right away as a part of a multipart upload, so that
+// Close() only has to send the tail. Sync() or Flush() before Close() needs the
+// object to become visible, so it aborts the multipart upload and uploads the
+// whole file as before.
 class S3WritableFile : public WritableFile {
  public:
   S3WritableFile(
       const string& bucket, const string& object,
       std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager,
-      std::shared_ptr<Aws::S3::S3Client> s3_client)
+      std::shared_ptr<Aws::S3::S3Client> s3_client,
+      uint64 streaming_part_size = 0)
       : bucket_(bucket),
         object_(object),
         s3_client_(s3_client),
@@ -358,7 +372,14 @@ class S3WritableFile : public WritableFile {
         outfile_(Aws::MakeShared<Aws::Utils::TempFile>(
             kS3FileSystemAllocationTag, kS3TempFileTemplate,
             std::ios_base::binary | std::ios_base::trunc | std::ios_base::in |
-                std::ios_base::out)) {}
+                std::ios_base::out)),
+        part_size_(streaming_part_size),
+        streaming_(streaming_part_size >= kS3MinMultiPartUploadPartSize),
+        parts_(std::make_shared<StreamingParts>()) {}
+
+  ~S3WritableFile() override {
+    if (!upload_id_.empty()) StopStreaming();
+  }
 
   Status Append(StringPiece data) override {
     if (!outfile_) {
@@ -371,11 +392,30 @@ class S3WritableFile : public WritableFile {
       return errors::Internal(
           "Could not append to the internal temporary file.");
     }
+    size_ += data.size();
+    while (streaming_ && size_ - streamed_bytes_ >= part_size_) {
+      Status s = StreamPart(part_size_);
+      if (!s.ok()) {
+        LOG(WARNING) << "Streaming upload of s3://" << bucket_ << "/"
+                     << object_ << " failed, uploading on close instead: "
+                     << s;
+        StopStreaming();
+      }
+    }
     return Status::OK();
   }
 
   Status Close() override {
     if (outfile_) {
+      if (!upload_id_.empty()) {
+        Status s = FinishStreaming();
+        if (s.ok()) {
+          outfile_.reset();
+          return Status::OK();
+        }
+        LOG(WARNING) << "Streaming upload of s3://" << bucket_ << "/"
+                     << object_ << " failed, uploading whole file: " << s;
+      }
       TF_RETURN_IF_ERROR(Sync());
       outfile_.reset();
     }
@@ -396,6 +436,7 @@ class S3WritableFile : public WritableFile {
     if (!sync_needed_) {
       return Status::OK();
     }
+    StopStreaming();
     VLOG(1) << "WriteFileToS3: s3://" << bucket_ << "/" << object_;
     long offset = outfile_->tellp();
     std::shared_ptr<Aws::Transfer::TransferHandle> handle =
@@ -428,12 +469,156 @@ class S3WritableFile : public WritableFile {
   }
 
  private:
+  // The parts of a streaming upload, updated by the UploadPart callbacks.
+  struct StreamingParts {
+    mutex mu;
+    condition_variable cv;
+    int num_pending TF_GUARDED_BY(mu) = 0;
+    Status status TF_GUARDED_BY(mu);
+    std::map<int, Aws::String> etags TF_GUARDED_BY(mu);
+  };
+
+  // Starts uploading the next `n` bytes of outfile_ as a new part, starting
+  // the multipart upload if needed. Waits while too many parts are pending.
+  Status StreamPart(uint64 n) {
+    if (upload_id_.empty()) {
+      Aws::S3::Model::CreateMultipartUploadRequest request;
+      request.WithBucket(bucket_.c_str()).WithKey(object_.c_str());
+      auto outcome = s3_client_->CreateMultipartUpload(request);
+      if (!outcome.IsSuccess()) {
+        return CreateStatusFromAwsError(outcome.GetError());
+      }
+      upload_id_ = outcome.GetResult().GetUploadId();
+      VLOG(1) << "Started streaming upload of s3://" << bucket_ << "/"
+              << object_ << " in parts of " << part_size_ << " bytes";
+    }
+    {
+      mutex_lock l(parts_->mu);
+      while (parts_->num_pending >= kS3MaxPendingStreamingParts) {
+        parts_->cv.wait(l);
+      }
+      TF_RETURN_IF_ERROR(parts_->status);
+    }
+
+    auto body = Aws::MakeShared<Aws::StringStream>(kS3FileSystemAllocationTag);
+    std::unique_ptr<char[]> buffer(new char[n]);
+    outfile_->seekg(streamed_bytes_);
+    outfile_->read(buffer.get(), n);
+    const bool read_ok = outfile_->good();
+    outfile_->clear();
+    outfile_->seekp(0, std::ios_base::end);
+    if (!read_ok) {
+      return errors::Internal(
+          "Could not read back the internal temporary file.");
+    }
+    body->write(buffer.get(), n);
+
+    const int part_number = next_part_number_++;
+    Aws::S3::Model::UploadPartRequest request;
+    request.WithBucket(bucket_.c_str())
+        .WithKey(object_.c_str())
+        .WithUploadId(upload_id_)
+        .WithPartNumber(part_number)
+        .WithContentLength(n);
+    request.SetBody(body);
+    {
+      mutex_lock l(parts_->mu);
+      ++parts_->num_pending;
+    }
+    std::shared_ptr<StreamingParts> parts = parts_;
+    s3_client_->UploadPartAsync(
+        request,
+        [parts, part_number](
+            const Aws::S3::S3Client*, const Aws::S3::Model::UploadPartRequest&,
+            const Aws::S3::Model::UploadPartOutcome& outcome,
+            const std::shared_ptr<const Aws::Client::AsyncCallerContext>&) {
+          mutex_lock l(parts->mu);
+          if (outcome.IsSuccess()) {
+            parts->etags[part_number] = outcome.GetResult().GetETag();
+          } else {
+            parts->status.Update(CreateStatusFromAwsError(outcome.GetError()));
+          }
+          --parts->num_pending;
+          parts->cv.notify_all();
+        });
+    streamed_bytes_ += n;
+    return Status::OK();
+  }
+
+  // Waits for the pending parts and returns the first error among them.
+  Status WaitForParts() {
+    mutex_lock l(parts_->mu);
+    while (parts_->num_pending > 0) {
+      parts_->cv.wait(l);
+    }
+    return parts_->status;
+  }
+
+  // Uploads the remaining bytes as the last part and completes the upload.
+  Status FinishStreaming() {
+    if (size_ > streamed_bytes_) {
+      TF_RETURN_IF_ERROR(StreamPart(size_ - streamed_bytes_));
+    }
+    TF_RETURN_IF_ERROR(WaitForParts());
+    Aws::S3::Model::CompletedMultipartUpload completed;
+    {
+      mutex_lock l(parts_->mu);
+      for (const auto& part : parts_->etags) {
+        Aws::S3::Model::CompletedPart completed_part;
+        completed_part.SetPartNumber(part.first);
+        completed_part.SetETag(part.second);
+        completed.AddParts(completed_part);
+      }
+    }
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.WithBucket(bucket_.c_str())
+        .WithKey(object_.c_str())
+        .WithUploadId(upload_id_)
+        .WithMultipartUpload(completed);
+    auto outcome = s3_client_->CompleteMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+      return CreateStatusFromAwsError(outcome.GetError());
+    }
+    upload_id_.clear();
+    streaming_ = false;
+    sync_needed_ = false;
+    return Status::OK();
+  }
+
+  // Drops the streaming upload, if any. The data stays in outfile_ for Sync().
+  void StopStreaming() {
+    streaming_ = false;
+    if (upload_id_.empty()) return;
+    WaitForParts().IgnoreError();
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.WithBucket(bucket_.c_str())
+        .WithKey(object_.c_str())
+        .WithUploadId(upload_id_);
+    auto outcome = s3_client_->AbortMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+      LOG(WARNING) << "Could not abort streaming upload of s3://" << bucket_
+                   << "/" << object_ << ": " << outcome.GetError().GetMessage();
+    }
+    upload_id_.clear();
+  }
+
   string bucket_;
   string object_;
   std::shared_ptr<Aws::S3::S3Client> s3_client_;
   std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager_;
   bool sync_needed_;
   std::shared_ptr<Aws::Utils::TempFile> outfile_;
+
+  // Streaming multipart upload state.
+  const uint64 part_size_;
+  bool streaming_;
+  // Bytes appended so far, and how many of them were sent as parts.
+  uint64 size_ = 0;
+  uint64 streamed_bytes_ = 0;
+  // Empty unless a streaming upload is in progress.
+  Aws::String upload_id_;
+  int next_part_number_ = 1;
+  std::shared_ptr<StreamingParts> parts_;
 };
 
 class S3ReadOnlyMemoryRegion : public ReadOnlyMemoryRegion {
@@ -478,6 +663,14 @@ S3FileSystem::S3FileSystem()
     }
   }
 
+  use_streaming_upload_ = true;
+  const char* disable_streaming_upload = getenv("S3_DISABLE_STREAMING_UPLOAD");
+  if (disable_streaming_upload) {
+    if (disable_streaming_upload[0] == '1') {
+      use_streaming_upload_ = false;
+    }
+  }
+
   use_multi_part_download_ = true;
   const char* disable_transfer_mgr = getenv("S3_DISABLE_MULTI_PART_DOWNLOAD");
   if (disable_transfer_mgr) {
@@ -567,6 +760,11 @@ S3FileSystem::GetExecutor() {
   return this->executor_;
 }
 
+uint64 S3FileSystem::StreamingPartSize() {
+  if (!use_streaming_upload_) return 0;
+  return multi_part_chunk_size_[Aws::Transfer::TransferDirection::UPLOAD];
+}
+
 Status S3FileSystem::NewRandomAccessFile(
     const string& fname, TransactionToken* token,
     std::unique_ptr<RandomAccessFile>* result) {
@@ -596,7 +794,7 @@ Status S3FileSystem::NewWritableFile(const string& fname,
   result->reset(new S3WritableFile(
       bucket, object,
       this->GetTransferManager(Aws::Transfer::TransferDirection::UPLOAD),
-      this->GetS3Client()));
+      this->GetS3Client(), StreamingPartSize()));
 
   return Status::OK();
 }
@@ -616,7 +814,7 @@ Status S3FileSystem::NewAppendableFile(const string& fname,
   result->reset(new S3WritableFile(
       bucket, object,
       this->GetTransferManager(Aws::Transfer::TransferDirection::UPLOAD),
-      this->GetS3Client()));
+      this->GetS3Client(), StreamingPartSize()));
 
   while (true) {
     status = reader->Read(offset, kS3ReadAppendableFileBufferSize, &read_chunk,
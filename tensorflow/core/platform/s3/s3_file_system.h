@@ -151,6 +151,11 @@ class S3FileSystem : public FileSystem {
   std::map<Aws::Transfer::TransferDirection, uint64> multi_part_chunk_size_;
 
   bool use_multi_part_download_;
+
+  // Whether writable files upload parts while they are being written.
+  bool use_streaming_upload_;
+  // The part size of streaming uploads, or 0 if they are disabled.
+  uint64 StreamingPartSize();
 };
 
 /// S3 implementation of a file system with retry on failures.
@@ -0,0 +1,346 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/profiler/convert/xplane_to_critical_path.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/profiler/protobuf/critical_path.pb.h"
+#include "tensorflow/core/profiler/protobuf/xplane.pb.h"
+#include "tensorflow/core/profiler/utils/tf_xplane_visitor.h"
+#include "tensorflow/core/profiler/utils/xplane_schema.h"
+#include "tensorflow/core/profiler/utils/xplane_visitor.h"
+
+namespace tensorflow {
+namespace profiler {
+namespace {
+
+// A dependency of an event on an earlier event: the event starts `lag_ps`
+// after `node` starts, or after it finishes if `finish_to_start`.
+struct Dependency {
+  int node;
+  bool finish_to_start;
+  int64 lag_ps;
+};
+
+// A point in an event, or in an event nested in it.
+struct EventPoint {
+  int node;
+  int64 offset_ps;
+  // True if the point is the end of the event itself.
+  bool is_end;
+};
+
+// A top-level event of a step.
+struct Node {
+  std::string name;
+  std::string plane_name;
+  std::string line_name;
+  int64 start_ps;
+  int64 duration_ps;
+  std::vector<Dependency> dependencies;
+};
+
+// The events of a step, and the contexts connecting them.
+struct StepGraph {
+  std::vector<Node> nodes;
+  // The starts of producer and consumer events, keyed by (context type,
+  // context id).
+  absl::flat_hash_map<std::pair<int64, uint64>, EventPoint> producers;
+  std::vector<std::pair<std::pair<int64, uint64>, EventPoint>> consumers;
+  // The ends of launch events and the starts of device events, keyed by
+  // correlation id.
+  absl::flat_hash_map<int64, EventPoint> launches;
+  std::vector<std::pair<int64, EventPoint>> device_events;
+};
+
+std::string EventName(const XEventVisitor& event) {
+  if (absl::optional<XStatVisitor> tf_op = event.GetStat(StatType::kTfOp)) {
+    return std::string(tf_op->StrOrRefValue());
+  }
+  return std::string(event.Name());
+}
+
+// Records the contexts of `event`, which is `node` or nested in it.
+void AddContexts(const XEventVisitor& event, bool is_host, int node,
+                 StepGraph* graph) {
+  const Node& top = graph->nodes[node];
+  const int64 start_offset_ps = event.TimestampPs() - top.start_ps;
+  const int64 end_offset_ps = event.EndTimestampPs() - top.start_ps;
+  const EventPoint start{node, start_offset_ps, /*is_end=*/false};
+  const EventPoint end{node, end_offset_ps,
+                       /*is_end=*/start_offset_ps == 0 &&
+                           end_offset_ps == top.duration_ps};
+  absl::optional<int64> producer_type, consumer_type;
+  absl::optional<uint64> producer_id, consumer_id;
+  event.ForEachStat([&](const XStatVisitor& stat) {
+    if (!stat.Type().has_value()) return;
+    switch (*stat.Type()) {
+      case StatType::kProducerType:
+        producer_type = stat.IntValue();
+        break;
+      case StatType::kProducerId:
+        producer_id = stat.IntOrUintValue();
+        break;
+      case StatType::kConsumerType:
+        consumer_type = stat.IntValue();
+        break;
+      case StatType::kConsumerId:
+        consumer_id = stat.IntOrUintValue();
+        break;
+      case StatType::kCorrelationId:
+        if (is_host) {
+          graph->launches.emplace(stat.IntValue(), end);
+        } else {
+          graph->device_events.emplace_back(stat.IntValue(), start);
+        }
+        break;
+      default:
+        break;
+    }
+  });
+  if (producer_type && producer_id) {
+    graph->producers.emplace(std::make_pair(*producer_type, *producer_id),
+                             start);
+  }
+  if (consumer_type && consumer_id) {
+    graph->consumers.emplace_back(std::make_pair(*consumer_type, *consumer_id),
+                                  start);
+  }
+}
+
+// Adds the top-level events of `line` to the graphs of their steps.
+void AddLine(const XPlaneVisitor& plane, const XLineVisitor& line,
+             bool is_host, absl::flat_hash_map<int64, StepGraph>* graphs) {
+  std::vector<std::pair<XEventVisitor, int64>> events;
+  line.ForEachEvent([&](const XEventVisitor& event) {
+    if (absl::optional<XStatVisitor> group_id =
+            event.GetStat(StatType::kGroupId)) {
+      events.emplace_back(event, group_id->IntValue());
+    }
+  });
+  // Sorts enclosing events before the events nested in them.
+  std::stable_sort(events.begin(), events.end(),
+                   [](const std::pair<XEventVisitor, int64>& a,
+                      const std::pair<XEventVisitor, int64>& b) {
+                     return std::make_tuple(a.first.TimestampPs(),
+                                            -a.first.DurationPs()) <
+                            std::make_tuple(b.first.TimestampPs(),
+                                            -b.first.DurationPs());
+                   });
+
+  // The last top-level event of each step on this line.
+  absl::flat_hash_map<int64, int> last_nodes;
+  int64 top_end_ps = std::numeric_limits<int64>::min();
+  int64 top_group_id = -1;
+  int top_node = -1;
+  for (const auto& event_and_group : events) {
+    const XEventVisitor& event = event_and_group.first;
+    const int64 group_id = event_and_group.second;
+    StepGraph& graph = (*graphs)[group_id];
+    if (top_node < 0 || group_id != top_group_id ||
+        event.TimestampPs() >= top_end_ps) {
+      top_node = graph.nodes.size();
+      top_group_id = group_id;
+      top_end_ps = event.EndTimestampPs();
+      Node node;
+      node.name = EventName(event);
+      node.plane_name = std::string(plane.Name());
+      node.line_name = std::string(line.DisplayName());
+      node.start_ps = event.TimestampPs();
+      node.duration_ps = event.DurationPs();
+      auto last = last_nodes.find(group_id);
+      if (last != last_nodes.end()) {
+        node.dependencies.push_back(
+            {last->second, /*finish_to_start=*/true, /*lag_ps=*/0});
+      }
+      last_nodes[group_id] = top_node;
+      graph.nodes.push_back(std::move(node));
+    }
+    AddContexts(event, is_host, top_node, &graph);
+  }
+}
+
+// Computes the earliest start of each node in `order`, a topological order,
+// given its `durations`. Returns the length of the longest path.
+int64 ComputeEarliestStarts(const std::vector<Node>& nodes,
+                            const std::vector<int>& order,
+                            const std::vector<int64>& durations,
+                            std::vector<int64>* earliest_starts) {
+  earliest_starts->assign(nodes.size(), 0);
+  int64 length = 0;
+  for (int v : order) {
+    int64 start = 0;
+    for (const Dependency& dep : nodes[v].dependencies) {
+      start = std::max(start, (*earliest_starts)[dep.node] + dep.lag_ps +
+                                  (dep.finish_to_start ? durations[dep.node]
+                                                       : 0));
+    }
+    (*earliest_starts)[v] = start;
+    length = std::max(length, start + durations[v]);
+  }
+  return length;
+}
+
+CriticalPathEvent ToCriticalPathEvent(const Node& node, int64 step_start_ps,
+                                      int64 slack_ps) {
+  CriticalPathEvent event;
+  event.set_name(node.name);
+  event.set_plane_name(node.plane_name);
+  event.set_line_name(node.line_name);
+  event.set_offset_ps(node.start_ps - step_start_ps);
+  event.set_duration_ps(node.duration_ps);
+  event.set_slack_ps(slack_ps);
+  return event;
+}
+
+// Makes the node of `to` depend on the node of `from`, so that `to` follows
+// `from`.
+void AddDependency(const EventPoint& from, const EventPoint& to,
+                   std::vector<Node>* nodes) {
+  if (from.node == to.node) return;
+  std::vector<Dependency>& deps = (*nodes)[to.node].dependencies;
+  if (from.is_end) {
+    // Scales with the duration of `from`.
+    deps.push_back({from.node, /*finish_to_start=*/true, -to.offset_ps});
+  } else {
+    deps.push_back(
+        {from.node, /*finish_to_start=*/false, from.offset_ps - to.offset_ps});
+  }
+}
+
+void ConvertStepGraphToCriticalPath(StepGraph* graph, StepCriticalPath* step) {
+  std::vector<Node>& nodes = graph->nodes;
+  for (const auto& consumer : graph->consumers) {
+    auto producer = graph->producers.find(consumer.first);
+    if (producer != graph->producers.end()) {
+      AddDependency(producer->second, consumer.second, &nodes);
+    }
+  }
+  for (const auto& device_event : graph->device_events) {
+    auto launch = graph->launches.find(device_event.first);
+    if (launch != graph->launches.end()) {
+      AddDependency(launch->second, device_event.second, &nodes);
+    }
+  }
+
+  // Orders the nodes by start time, and drops the dependencies that do not
+  // follow it, so that clock skew cannot introduce cycles.
+  const int num_nodes = nodes.size();
+  std::vector<int> order(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&nodes](int a, int b) {
+    return std::make_pair(nodes[a].start_ps, a) <
+           std::make_pair(nodes[b].start_ps, b);
+  });
+  std::vector<int> positions(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) positions[order[i]] = i;
+  std::vector<int64> durations(num_nodes);
+  for (int v = 0; v < num_nodes; ++v) {
+    std::vector<Dependency>& deps = nodes[v].dependencies;
+    deps.erase(std::remove_if(deps.begin(), deps.end(),
+                              [&](const Dependency& dep) {
+                                return positions[dep.node] >= positions[v];
+                              }),
+               deps.end());
+    durations[v] = nodes[v].duration_ps;
+  }
+
+  std::vector<int64> earliest_starts;
+  const int64 length =
+      ComputeEarliestStarts(nodes, order, durations, &earliest_starts);
+
+  // Computes the latest finish of each node that does not delay the step.
+  std::vector<int64> latest_finishes(num_nodes, length);
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const int w = *it;
+    const int64 latest_start = latest_finishes[w] - durations[w];
+    for (const Dependency& dep : nodes[w].dependencies) {
+      latest_finishes[dep.node] =
+          std::min(latest_finishes[dep.node],
+                   latest_start - dep.lag_ps +
+                       (dep.finish_to_start ? 0 : durations[dep.node]));
+    }
+  }
+
+  step->set_critical_path_ps(length);
+  const int64 step_start_ps = num_nodes > 0 ? nodes[order[0]].start_ps : 0;
+  std::vector<std::pair<int64, int>> other_events;
+  std::vector<int64> speedup_durations = durations;
+  std::vector<int64> unused_starts;
+  for (int v : order) {
+    const int64 slack =
+        latest_finishes[v] - earliest_starts[v] - durations[v];
+    if (slack > 0) {
+      other_events.emplace_back(slack, v);
+      continue;
+    }
+    CriticalPathEvent* event = step->add_critical_path();
+    *event = ToCriticalPathEvent(nodes[v], step_start_ps, 0);
+    speedup_durations[v] = durations[v] / 2;
+    event->set_savings_if_2x_faster_ps(
+        length - ComputeEarliestStarts(nodes, order, speedup_durations,
+                                       &unused_starts));
+    speedup_durations[v] = durations[v];
+  }
+  std::stable_sort(other_events.begin(), other_events.end(),
+                   [](const std::pair<int64, int>& a,
+                      const std::pair<int64, int>& b) {
+                     return a.first < b.first;
+                   });
+  for (const auto& slack_and_node : other_events) {
+    *step->add_other_events() = ToCriticalPathEvent(
+        nodes[slack_and_node.second], step_start_ps, slack_and_node.first);
+  }
+}
+
+}  // namespace
+
+CriticalPathAnalysis ConvertXSpaceToCriticalPathAnalysis(const XSpace& space) {
+  absl::flat_hash_map<int64, StepGraph> graphs;
+  for (const XPlane& raw_plane : space.planes()) {
+    XPlaneVisitor plane = CreateTfXPlaneVisitor(&raw_plane);
+    const bool is_host = plane.Name() == kHostThreadsPlaneName;
+    plane.ForEachLine([&](const XLineVisitor& line) {
+      AddLine(plane, line, is_host, &graphs);
+    });
+  }
+
+  std::vector<int64> step_ids;
+  step_ids.reserve(graphs.size());
+  for (const auto& id_and_graph : graphs) {
+    step_ids.push_back(id_and_graph.first);
+  }
+  std::sort(step_ids.begin(), step_ids.end());
+  CriticalPathAnalysis analysis;
+  for (int64 step_id : step_ids) {
+    StepCriticalPath* step = analysis.add_steps();
+    step->set_step_id(step_id);
+    ConvertStepGraphToCriticalPath(&graphs[step_id], step);
+  }
+  return analysis;
+}
+
+}  // namespace profiler
+}  // namespace tensorflow
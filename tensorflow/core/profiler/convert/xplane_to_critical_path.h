@@ -0,0 +1,43 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_PROFILER_CONVERT_XPLANE_TO_CRITICAL_PATH_H_
+#define TENSORFLOW_CORE_PROFILER_CONVERT_XPLANE_TO_CRITICAL_PATH_H_
+
+#include "tensorflow/core/profiler/protobuf/critical_path.pb.h"
+#include "tensorflow/core/profiler/protobuf/xplane.pb.h"
+
+namespace tensorflow {
+namespace profiler {
+
+// Computes the critical path of each step of `space`, across all its hosts and
+// devices. The events must have been grouped into steps by GroupTfEvents().
+//
+// The events of a step are the top-level events with the step's group id on
+// each line; nested events are folded into their top-level event. An event
+// depends on
+//   - the event before it on the same line, which must finish first,
+//   - the launch event with the same correlation id, which must finish first,
+//   - the producer of the same context (see connected_traceme.h), which must
+//     start first.
+// The critical path is the longest path through these dependencies, i.e. the
+// step time if every event started as soon as its dependencies allowed, so
+// idle gaps in the trace are not part of it.
+CriticalPathAnalysis ConvertXSpaceToCriticalPathAnalysis(const XSpace& space);
+
+}  // namespace profiler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PROFILER_CONVERT_XPLANE_TO_CRITICAL_PATH_H_
@@ -0,0 +1,111 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/profiler/convert/xplane_to_critical_path.h"
+
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/profiler/protobuf/critical_path.pb.h"
+#include "tensorflow/core/profiler/protobuf/xplane.pb.h"
+#include "tensorflow/core/profiler/utils/xplane_builder.h"
+#include "tensorflow/core/profiler/utils/xplane_schema.h"
+#include "tensorflow/core/profiler/utils/xplane_test_utils.h"
+
+namespace tensorflow {
+namespace profiler {
+namespace {
+
+constexpr int64 kStepId = 1;
+
+TEST(ConvertXSpaceToCriticalPathAnalysis, ConnectedThreads) {
+  XSpace space;
+  XPlaneBuilder host_plane(GetOrCreateHostXPlane(&space));
+  XLineBuilder first_thread = host_plane.GetOrCreateLine(0);
+  CreateXEvent(&host_plane, &first_thread, "A", /*offset_ps=*/0,
+               /*duration_ps=*/100,
+               {{StatType::kGroupId, kStepId},
+                {StatType::kProducerType, int64{1}},
+                {StatType::kProducerId, int64{7}}});
+  CreateXEvent(&host_plane, &first_thread, "B", /*offset_ps=*/100,
+               /*duration_ps=*/200, {{StatType::kGroupId, kStepId}});
+  XLineBuilder second_thread = host_plane.GetOrCreateLine(1);
+  CreateXEvent(&host_plane, &second_thread, "C", /*offset_ps=*/10,
+               /*duration_ps=*/40,
+               {{StatType::kGroupId, kStepId},
+                {StatType::kConsumerType, int64{1}},
+                {StatType::kConsumerId, int64{7}}});
+  CreateXEvent(&host_plane, &second_thread, "D", /*offset_ps=*/50,
+               /*duration_ps=*/350, {{StatType::kGroupId, kStepId}});
+  // Nested events are folded into D.
+  CreateXEvent(&host_plane, &second_thread, "D_inner", /*offset_ps=*/60,
+               /*duration_ps=*/10, {{StatType::kGroupId, kStepId}});
+
+  CriticalPathAnalysis analysis = ConvertXSpaceToCriticalPathAnalysis(space);
+  ASSERT_EQ(analysis.steps_size(), 1);
+  const StepCriticalPath& step = analysis.steps(0);
+  EXPECT_EQ(step.step_id(), kStepId);
+  // C starts with A, and D follows C.
+  EXPECT_EQ(step.critical_path_ps(), 390);
+  ASSERT_EQ(step.critical_path_size(), 3);
+  EXPECT_EQ(step.critical_path(0).name(), "A");
+  // Only the start of A matters to C.
+  EXPECT_EQ(step.critical_path(0).savings_if_2x_faster_ps(), 0);
+  EXPECT_EQ(step.critical_path(1).name(), "C");
+  EXPECT_EQ(step.critical_path(1).offset_ps(), 10);
+  EXPECT_EQ(step.critical_path(1).savings_if_2x_faster_ps(), 20);
+  EXPECT_EQ(step.critical_path(2).name(), "D");
+  // Then A and B become the critical path.
+  EXPECT_EQ(step.critical_path(2).savings_if_2x_faster_ps(), 90);
+  ASSERT_EQ(step.other_events_size(), 1);
+  EXPECT_EQ(step.other_events(0).name(), "B");
+  EXPECT_EQ(step.other_events(0).slack_ps(), 90);
+}
+
+TEST(ConvertXSpaceToCriticalPathAnalysis, KernelLaunches) {
+  XSpace space;
+  XPlaneBuilder host_plane(GetOrCreateHostXPlane(&space));
+  XLineBuilder thread = host_plane.GetOrCreateLine(0);
+  CreateXEvent(&host_plane, &thread, "E", /*offset_ps=*/0,
+               /*duration_ps=*/100, {{StatType::kGroupId, kStepId}});
+  CreateXEvent(&host_plane, &thread, "cuLaunchKernel", /*offset_ps=*/10,
+               /*duration_ps=*/10,
+               {{StatType::kGroupId, kStepId},
+                {StatType::kCorrelationId, int64{5}}});
+  XPlaneBuilder device_plane(GetOrCreateGpuXPlane(&space, 0));
+  XLineBuilder stream = device_plane.GetOrCreateLine(0);
+  CreateXEvent(&device_plane, &stream, "kernel", /*offset_ps=*/30,
+               /*duration_ps=*/200,
+               {{StatType::kGroupId, kStepId},
+                {StatType::kCorrelationId, int64{5}}});
+  // Events of other steps are analyzed separately.
+  CreateXEvent(&device_plane, &stream, "other_kernel", /*offset_ps=*/230,
+               /*duration_ps=*/50, {{StatType::kGroupId, kStepId + 1}});
+
+  CriticalPathAnalysis analysis = ConvertXSpaceToCriticalPathAnalysis(space);
+  ASSERT_EQ(analysis.steps_size(), 2);
+  const StepCriticalPath& step = analysis.steps(0);
+  // The kernel starts when its launch is done.
+  EXPECT_EQ(step.critical_path_ps(), 220);
+  ASSERT_EQ(step.critical_path_size(), 2);
+  EXPECT_EQ(step.critical_path(0).name(), "E");
+  EXPECT_EQ(step.critical_path(1).name(), "kernel");
+  EXPECT_EQ(step.critical_path(1).savings_if_2x_faster_ps(), 100);
+  EXPECT_EQ(analysis.steps(1).step_id(), kStepId + 1);
+  EXPECT_EQ(analysis.steps(1).critical_path_ps(), 50);
+}
+
+}  // namespace
+}  // namespace profiler
+}  // namespace tensorflow
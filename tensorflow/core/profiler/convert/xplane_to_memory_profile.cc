@@ -72,6 +72,7 @@ struct ActivityMetadata {
   absl::string_view region_type;
   int64 data_type = 0;
   absl::string_view tensor_shape;
+  int64 bin = -1;
 };
 
 bool IsMemoryAllocation(int64 event_type) {
@@ -107,6 +108,7 @@ void FillActivityMetadata(int64 event_type, const ActivityMetadata& src,
   dst->set_data_type(tensorflow::DataTypeString(
       static_cast<tensorflow::DataType>(src.data_type)));
   dst->set_tensor_shape(std::string(src.tensor_shape));
+  dst->set_bin(src.bin);
 }
 
 void UpdateProfileSummary(const AggregationStats& stats, int64 time_offset_ps,
@@ -197,6 +199,9 @@ MemoryProfile GenerateMemoryProfile(const XPlane* host_trace) {
           case StatType::kTensorShapes:
             metadata.tensor_shape = stat.StrOrRefValue();
             break;
+          case StatType::kBinIndex:
+            metadata.bin = stat.IntValue();
+            break;
         }
       });
 
@@ -253,6 +258,7 @@ void UpdateDeallocation(PerAllocatorMemoryProfile* memory_profile) {
             alloc_meta->data_type());
         snapshot.mutable_activity_metadata()->set_tensor_shape(
             alloc_meta->tensor_shape());
+        snapshot.mutable_activity_metadata()->set_bin(alloc_meta->bin());
         // In case of following (unexpected) deallocations to the same chunk
         // address, leave the metadata as it is (empty or already captured).
         addr_metadata_map.erase(address);
@@ -351,6 +357,40 @@ bool operator==(const IndexMetaPair& a, const IndexMetaPair& b) {
          a_meta->tensor_shape() == b_meta->tensor_shape();
 }
 
+// Aggregate the active allocations at the peak usage by TF Op and region type,
+// so that the largest contributors to the peak can be listed directly.
+void FillPeakBreakdown(const std::vector<IndexMetaPair>& active_allocs,
+                       PerAllocatorMemoryProfile* memory_profile) {
+  absl::flat_hash_map<std::pair<std::string, std::string>, PeakMemoryBreakdown>
+      breakdown_map;
+  for (const auto& index_meta : active_allocs) {
+    const MemoryActivityMetadata* metadata = index_meta.second;
+    PeakMemoryBreakdown& breakdown = breakdown_map[std::make_pair(
+        metadata->tf_op_name(), metadata->region_type())];
+    breakdown.set_allocation_bytes(breakdown.allocation_bytes() +
+                                   metadata->allocation_bytes());
+    breakdown.set_num_allocations(breakdown.num_allocations() + 1);
+  }
+  std::vector<PeakMemoryBreakdown> breakdowns;
+  breakdowns.reserve(breakdown_map.size());
+  for (auto& key_and_breakdown : breakdown_map) {
+    key_and_breakdown.second.set_tf_op_name(key_and_breakdown.first.first);
+    key_and_breakdown.second.set_region_type(key_and_breakdown.first.second);
+    breakdowns.push_back(std::move(key_and_breakdown.second));
+  }
+  absl::c_sort(breakdowns, [](const PeakMemoryBreakdown& a,
+                              const PeakMemoryBreakdown& b) {
+    if (a.allocation_bytes() != b.allocation_bytes()) {
+      return a.allocation_bytes() > b.allocation_bytes();
+    }
+    return std::tie(a.tf_op_name(), a.region_type()) <
+           std::tie(b.tf_op_name(), b.region_type());
+  });
+  for (auto& breakdown : breakdowns) {
+    *memory_profile->add_peak_breakdown() = std::move(breakdown);
+  }
+}
+
 // Generate the memory breakdown table of active allocations at the peak usage
 // (within profiling window) and fill each ActiveAllocation proto (i.e. a row).
 void ProcessActiveAllocations(int64 peak_bytes_profile_step_id,
@@ -424,6 +464,8 @@ void ProcessActiveAllocations(int64 peak_bytes_profile_step_id,
 
   VLOG(2) << "Distinctive active allocation count="
           << memory_profile->active_allocations_size();
+
+  FillPeakBreakdown(active_allocs, memory_profile);
 }
 
 struct Sample {
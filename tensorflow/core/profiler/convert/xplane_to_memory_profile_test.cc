@@ -83,7 +83,8 @@ TEST(ConvertXPlaneToMemoryProfile, OneAllocatorMultiActivitiesTest) {
                 {StatType::kAllocatorName, "GPU_0_bfc"},
                 {StatType::kTfOp, "mul_grad/Sum"},
                 {StatType::kRegionType, "temp"},
-                {StatType::kTensorShapes, "[1, 2]"}});
+                {StatType::kTensorShapes, "[1, 2]"},
+                {StatType::kBinIndex, int64{1}}});
 
   tensorflow::profiler::GroupTfEvents(&space);
   MemoryProfile memory_profile = ConvertXPlaneToMemoryProfile(*host_plane);
@@ -113,6 +114,22 @@ TEST(ConvertXPlaneToMemoryProfile, OneAllocatorMultiActivitiesTest) {
   EXPECT_EQ(
       allocator_memory_profile.special_allocations().at(1).allocation_bytes(),
       2000);
+  EXPECT_EQ(allocator_memory_profile.memory_profile_snapshots(2)
+                .activity_metadata()
+                .bin(),
+            1);
+  // The peak breakdown has the stack, the unused preallocated memory and the
+  // temp allocation of mul_grad/Sum, largest first.
+  ASSERT_EQ(allocator_memory_profile.peak_breakdown_size(), 3);
+  for (int i = 1; i < allocator_memory_profile.peak_breakdown_size(); ++i) {
+    EXPECT_GE(allocator_memory_profile.peak_breakdown(i - 1).allocation_bytes(),
+              allocator_memory_profile.peak_breakdown(i).allocation_bytes());
+  }
+  const auto& smallest = allocator_memory_profile.peak_breakdown(2);
+  EXPECT_EQ(smallest.tf_op_name(), "mul_grad/Sum");
+  EXPECT_EQ(smallest.region_type(), "temp");
+  EXPECT_EQ(smallest.allocation_bytes(), 300);
+  EXPECT_EQ(smallest.num_allocations(), 1);
 }
 
 }  // namespace
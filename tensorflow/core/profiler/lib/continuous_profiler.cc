@@ -0,0 +1,125 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/profiler/lib/continuous_profiler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "tensorflow/core/platform/env_time.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace profiler {
+namespace {
+
+mutex global_mu(LINKER_INITIALIZED);
+ContinuousProfiler* global_profiler TF_GUARDED_BY(global_mu) = nullptr;
+
+}  // namespace
+
+/*static*/ std::unique_ptr<ContinuousProfiler> ContinuousProfiler::Create(
+    const Options& options) {
+  return absl::WrapUnique(new ContinuousProfiler(options));
+}
+
+/*static*/ Status ContinuousProfiler::StartGlobal(const Options& options) {
+  mutex_lock l(global_mu);
+  if (global_profiler != nullptr) {
+    return errors::AlreadyExists("The continuous profiler is already running.");
+  }
+  // Never deleted, so that the pointers returned by Global() stay valid.
+  global_profiler = Create(options).release();
+  return Status::OK();
+}
+
+/*static*/ ContinuousProfiler* ContinuousProfiler::Global() {
+  mutex_lock l(global_mu);
+  return global_profiler;
+}
+
+ContinuousProfiler::ContinuousProfiler(const Options& options)
+    : options_(options) {
+  LOG(INFO) << "Continuous profiler taking a " << options_.capture_duration_ms
+            << "ms capture every "
+            << options_.capture_duration_ms *
+                   std::max<uint32>(options_.sample_one_in, 1)
+            << "ms.";
+  thread_.reset(Env::Default()->StartThread(
+      ThreadOptions(), "continuous_profiler", [this]() { Run(); }));
+}
+
+ContinuousProfiler::~ContinuousProfiler() {
+  {
+    mutex_lock l(mu_);
+    cancelled_ = true;
+  }
+  cancelled_cv_.notify_all();
+  thread_.reset();
+}
+
+std::vector<std::shared_ptr<const XSpace>> ContinuousProfiler::GetCaptures()
+    const {
+  mutex_lock l(mu_);
+  return {captures_.begin(), captures_.end()};
+}
+
+void ContinuousProfiler::Run() {
+  const uint64 idle_ms = options_.capture_duration_ms *
+                         (std::max<uint32>(options_.sample_one_in, 1) - 1);
+  while (SleepFor(idle_ms)) {
+    Capture();
+  }
+}
+
+bool ContinuousProfiler::SleepFor(uint64 duration_ms) {
+  const uint64 deadline_micros =
+      EnvTime::NowMicros() + duration_ms * EnvTime::kMillisToMicros;
+  mutex_lock l(mu_);
+  while (!cancelled_) {
+    const uint64 now_micros = EnvTime::NowMicros();
+    if (now_micros >= deadline_micros) return true;
+    cancelled_cv_.wait_for(
+        l, std::chrono::microseconds(deadline_micros - now_micros));
+  }
+  return false;
+}
+
+void ContinuousProfiler::Capture() {
+  std::unique_ptr<ProfilerSession> session =
+      ProfilerSession::Create(options_.profile_options);
+  Status status = session->Status();
+  if (!status.ok()) {
+    VLOG(1) << "Skipping a continuous profiler capture: " << status;
+    return;
+  }
+  // Collects the capture even if cancelled, since the session has the trace.
+  SleepFor(options_.capture_duration_ms);
+  auto xspace = std::make_shared<XSpace>();
+  status = session->CollectData(xspace.get());
+  if (!status.ok()) {
+    LOG(WARNING) << "Continuous profiler capture failed: " << status;
+    return;
+  }
+  mutex_lock l(mu_);
+  captures_.push_back(std::move(xspace));
+  while (captures_.size() > std::max<size_t>(options_.max_captures, 1)) {
+    captures_.pop_front();
+  }
+}
+
+}  // namespace profiler
+}  // namespace tensorflow
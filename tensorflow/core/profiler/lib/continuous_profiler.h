@@ -0,0 +1,100 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_PROFILER_LIB_CONTINUOUS_PROFILER_H_
+#define TENSORFLOW_CORE_PROFILER_LIB_CONTINUOUS_PROFILER_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/profiler/lib/profiler_session.h"
+#include "tensorflow/core/profiler/profiler_options.pb.h"
+#include "tensorflow/core/profiler/protobuf/xplane.pb.h"
+
+namespace tensorflow {
+namespace profiler {
+
+// Profiles a process continuously by sampling: a background thread runs a
+// ProfilerSession for one short capture out of every `sample_one_in`, and
+// keeps the last `max_captures` of them in memory until they are exported.
+//
+// Tracing is disabled between captures, where TraceMe costs a single load, so
+// the overhead is about 1/`sample_one_in` of the overhead of a full capture.
+// A capture is skipped when another ProfilerSession, e.g. an on-demand one, is
+// active.
+// Thread-safety: ContinuousProfiler is thread-safe.
+class ContinuousProfiler {
+ public:
+  struct Options {
+    ProfileOptions profile_options = ProfilerSession::DefaultOptions();
+    // The length of each capture.
+    uint64 capture_duration_ms = 100;
+    // One capture is taken every `sample_one_in` capture durations.
+    uint32 sample_one_in = 100;
+    // The number of captures kept; older captures are dropped.
+    size_t max_captures = 10;
+  };
+
+  // Starts profiling in the background.
+  static std::unique_ptr<ContinuousProfiler> Create(const Options& options);
+
+  // Starts the process-wide continuous profiler, which is exported by the
+  // profiler service. Returns AlreadyExists if it was already started.
+  static Status StartGlobal(const Options& options);
+
+  // Returns the process-wide continuous profiler, or nullptr if it was not
+  // started.
+  static ContinuousProfiler* Global();
+
+  // Stops profiling, waiting for a capture in progress to finish.
+  ~ContinuousProfiler();
+
+  // Returns the buffered captures, oldest first.
+  std::vector<std::shared_ptr<const XSpace>> GetCaptures() const
+      TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  explicit ContinuousProfiler(const Options& options);
+
+  // The loop of the background thread.
+  void Run();
+
+  // Waits for `duration_ms`. Returns false if the profiler was cancelled.
+  bool SleepFor(uint64 duration_ms) TF_LOCKS_EXCLUDED(mu_);
+
+  // Takes one capture and adds it to the buffer.
+  void Capture() TF_LOCKS_EXCLUDED(mu_);
+
+  const Options options_;
+
+  mutable mutex mu_;
+  condition_variable cancelled_cv_;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  std::deque<std::shared_ptr<const XSpace>> captures_ TF_GUARDED_BY(mu_);
+
+  std::unique_ptr<Thread> thread_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ContinuousProfiler);
+};
+
+}  // namespace profiler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PROFILER_LIB_CONTINUOUS_PROFILER_H_
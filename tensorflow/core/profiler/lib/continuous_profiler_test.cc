@@ -0,0 +1,70 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/profiler/lib/continuous_profiler.h"
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/profiler/lib/profiler_session.h"
+
+namespace tensorflow {
+namespace profiler {
+namespace {
+
+// Waits up to 10 seconds for `profiler` to buffer `n` captures.
+bool WaitForCaptures(const ContinuousProfiler& profiler, size_t n) {
+  for (int i = 0; i < 1000; ++i) {
+    if (profiler.GetCaptures().size() >= n) return true;
+    Env::Default()->SleepForMicroseconds(10 * 1000);
+  }
+  return false;
+}
+
+TEST(ContinuousProfilerTest, KeepsLatestCaptures) {
+  ContinuousProfiler::Options options;
+  options.capture_duration_ms = 1;
+  options.sample_one_in = 2;
+  options.max_captures = 2;
+  auto profiler = ContinuousProfiler::Create(options);
+  ASSERT_TRUE(WaitForCaptures(*profiler, 2));
+  const auto first = profiler->GetCaptures();
+  // Newer captures replace the oldest ones.
+  for (int i = 0; i < 1000 && profiler->GetCaptures()[0] == first[0]; ++i) {
+    Env::Default()->SleepForMicroseconds(10 * 1000);
+  }
+  const auto latest = profiler->GetCaptures();
+  EXPECT_EQ(latest.size(), 2);
+  EXPECT_NE(latest[0], first[0]);
+}
+
+TEST(ContinuousProfilerTest, SkipsCapturesDuringOtherSessions) {
+  std::unique_ptr<ProfilerSession> session =
+      ProfilerSession::Create(ProfilerSession::DefaultOptions());
+  TF_ASSERT_OK(session->Status());
+
+  ContinuousProfiler::Options options;
+  options.capture_duration_ms = 1;
+  options.sample_one_in = 1;
+  auto profiler = ContinuousProfiler::Create(options);
+  Env::Default()->SleepForMicroseconds(50 * 1000);
+  EXPECT_TRUE(profiler->GetCaptures().empty());
+
+  session.reset();
+  EXPECT_TRUE(WaitForCaptures(*profiler, 1));
+}
+
+}  // namespace
+}  // namespace profiler
+}  // namespace tensorflow
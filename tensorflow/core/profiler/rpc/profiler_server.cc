@@ -22,14 +22,50 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/profiler/lib/continuous_profiler.h"
 #include "tensorflow/core/profiler/profiler_service.grpc.pb.h"
 #include "tensorflow/core/profiler/rpc/profiler_service_impl.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace profiler {
+namespace {
+
+// Starts the continuous profiler if TF_PROFILER_SAMPLE_ONE_IN is set, so that
+// the profiler service can export recent captures of production jobs.
+void MaybeStartContinuousProfiler() {
+  ContinuousProfiler::Options options;
+  int64 sample_one_in;
+  int64 capture_duration_ms;
+  int64 max_captures;
+  Status status = ReadInt64FromEnvVar("TF_PROFILER_SAMPLE_ONE_IN", 0,
+                                      &sample_one_in);
+  if (status.ok()) {
+    status = ReadInt64FromEnvVar("TF_PROFILER_CAPTURE_DURATION_MS",
+                                 options.capture_duration_ms,
+                                 &capture_duration_ms);
+  }
+  if (status.ok()) {
+    status = ReadInt64FromEnvVar("TF_PROFILER_MAX_CAPTURES",
+                                 options.max_captures, &max_captures);
+  }
+  if (!status.ok()) {
+    LOG(ERROR) << "Not starting the continuous profiler: " << status;
+    return;
+  }
+  if (sample_one_in <= 0) return;
+  options.sample_one_in = sample_one_in;
+  options.capture_duration_ms = capture_duration_ms;
+  options.max_captures = max_captures;
+  status = ContinuousProfiler::StartGlobal(options);
+  if (!status.ok()) VLOG(1) << status;
+}
+
+}  // namespace
 
 void ProfilerServer::StartProfilerServer(int32 port) {
   VLOG(1) << "Starting profiler server.";
+  MaybeStartContinuousProfiler();
   std::string server_address = absl::StrCat("[::]:", port);
   service_ = CreateProfilerService();
   ::grpc::ServerBuilder builder;
@@ -16,10 +16,12 @@ limitations under the License.
 #include "tensorflow/core/profiler/rpc/profiler_service_impl.h"
 
 #include <memory>
+#include <vector>
 
 #include "grpcpp/support/status.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/env_time.h"
@@ -28,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/profiler/lib/continuous_profiler.h"
 #include "tensorflow/core/profiler/lib/profiler_session.h"
 #include "tensorflow/core/profiler/profiler_service.grpc.pb.h"
 #include "tensorflow/core/profiler/profiler_service.pb.h"
@@ -41,6 +44,25 @@ namespace {
 
 const absl::string_view kXPlanePb = "xplane.pb";
 
+// Saves `xspace` to the run `session_id` of the repository.
+Status SaveXSpaceToRepository(const ProfileRequest& request,
+                              const std::string& session_id,
+                              const XSpace& xspace) {
+  std::string log_dir_path =
+      ProfilerJoinPath(request.repository_root(), session_id);
+  VLOG(1) << "Creating " << log_dir_path;
+  TF_RETURN_IF_ERROR(Env::Default()->RecursivelyCreateDir(log_dir_path));
+
+  std::string file_name = absl::StrCat(request.host_name(), ".", kXPlanePb);
+  // Windows file names do not support colons.
+  absl::StrReplaceAll({{":", "_"}}, &file_name);
+  // Dumps profile data to <repository_root>/<run>/<host>_<port>.<kXPlanePb>
+  std::string out_path = ProfilerJoinPath(log_dir_path, file_name);
+  LOG(INFO) << "Collecting XSpace to repository: " << out_path;
+
+  return WriteBinaryProto(Env::Default(), out_path, xspace);
+}
+
 // Collects data in XSpace format. The data is saved to a repository
 // unconditionally.
 Status CollectDataToRepository(const ProfileRequest& request,
@@ -53,20 +75,28 @@ Status CollectDataToRepository(const ProfileRequest& request,
   xspace.add_hostnames(request.host_name());
   VLOG(3) << "Collected XSpace to repository.";
   response->set_empty_trace(IsEmpty(xspace));
+  return SaveXSpaceToRepository(request, request.session_id(), xspace);
+}
 
-  std::string log_dir_path =
-      ProfilerJoinPath(request.repository_root(), request.session_id());
-  VLOG(1) << "Creating " << log_dir_path;
-  TF_RETURN_IF_ERROR(Env::Default()->RecursivelyCreateDir(log_dir_path));
-
-  std::string file_name = absl::StrCat(request.host_name(), ".", kXPlanePb);
-  // Windows file names do not support colons.
-  absl::StrReplaceAll({{":", "_"}}, &file_name);
-  // Dumps profile data to <repository_root>/<run>/<host>_<port>.<kXPlanePb>
-  std::string out_path = ProfilerJoinPath(log_dir_path, file_name);
-  LOG(INFO) << "Collecting XSpace to repository: " << out_path;
-
-  return WriteBinaryProto(Env::Default(), out_path, xspace);
+// Saves the captures of the continuous profiler to a repository.
+Status CollectContinuousCapturesToRepository(const ProfileRequest& request,
+                                             ProfileResponse* response) {
+  response->set_empty_trace(true);
+  ContinuousProfiler* profiler = ContinuousProfiler::Global();
+  if (profiler == nullptr) {
+    return errors::FailedPrecondition(
+        "The continuous profiler is not running.");
+  }
+  std::vector<std::shared_ptr<const XSpace>> captures =
+      profiler->GetCaptures();
+  for (size_t i = 0; i < captures.size(); ++i) {
+    XSpace xspace = *captures[i];
+    xspace.add_hostnames(request.host_name());
+    if (!IsEmpty(xspace)) response->set_empty_trace(false);
+    TF_RETURN_IF_ERROR(SaveXSpaceToRepository(
+        request, absl::StrCat(request.session_id(), "_", i), xspace));
+  }
+  return Status::OK();
 }
 
 class ProfilerServiceImpl : public grpc::ProfilerService::Service {
@@ -79,6 +109,14 @@ class ProfilerServiceImpl : public grpc::ProfilerService::Service {
   ::grpc::Status Profile(::grpc::ServerContext* ctx, const ProfileRequest* req,
                          ProfileResponse* response) override {
     VLOG(1) << "Received a profile request: " << req->DebugString();
+    if (req->collect_continuous_captures()) {
+      Status status = CollectContinuousCapturesToRepository(*req, response);
+      if (!status.ok()) {
+        return ::grpc::Status(::grpc::StatusCode::INTERNAL,
+                              status.error_message());
+      }
+      return ::grpc::Status::OK;
+    }
     std::unique_ptr<ProfilerSession> profiler =
         ProfilerSession::Create(req->opts());
     Status status = profiler->Status();
@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/summary/summary_file_writer.h"
 
+#include <algorithm>
+
 #include "tensorflow/core/summary/summary_converter.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -21,18 +23,27 @@ limitations under the License.
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/events_writer.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
 namespace {
 
+// Summaries are dropped instead of queued once this many times `max_queue`
+// events wait for the background thread, e.g. because the file system is
+// slow.
+constexpr int kMaxPendingQueues = 100;
+
+// Events are written and flushed by a background thread, so that writing a
+// summary only has to queue it.
 class SummaryFileWriter : public SummaryWriterInterface {
  public:
   SummaryFileWriter(int max_queue, int flush_millis, Env* env)
       : SummaryWriterInterface(),
         is_initialized_(false),
         max_queue_(max_queue),
+        max_pending_events_(std::max(max_queue, 1) * kMaxPendingQueues),
         flush_millis_(flush_millis),
         env_(env) {}
 
@@ -44,6 +55,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
       }
       TF_RETURN_IF_ERROR(env_->RecursivelyCreateDir(logdir));
     }
+    mutex_lock wl(write_mu_);
     mutex_lock ml(mu_);
     events_writer_ =
         tensorflow::MakeUnique<EventsWriter>(io::JoinPath(logdir, "events"));
@@ -52,19 +64,32 @@ class SummaryFileWriter : public SummaryWriterInterface {
         "Could not initialize events writer.");
     last_flush_ = env_->NowMicros();
     is_initialized_ = true;
+    flush_thread_.reset(env_->StartThread(ThreadOptions(),
+                                          "summary_file_writer",
+                                          [this]() { FlushLoop(); }));
     return Status::OK();
   }
 
   Status Flush() override {
-    mutex_lock ml(mu_);
-    if (!is_initialized_) {
-      return errors::FailedPrecondition("Class was not properly initialized.");
+    mutex_lock wl(write_mu_);
+    {
+      mutex_lock ml(mu_);
+      if (!is_initialized_) {
+        return errors::FailedPrecondition(
+            "Class was not properly initialized.");
+      }
     }
     return InternalFlush();
   }
 
   ~SummaryFileWriter() override {
-    (void)Flush();  // Ignore errors.
+    {
+      mutex_lock ml(mu_);
+      cancelled_ = true;
+      flush_requested_.notify_all();
+    }
+    flush_thread_.reset();  // Waits for the thread to finish.
+    (void)Flush();          // Ignore errors.
   }
 
   Status WriteTensor(int64 global_step, Tensor t, const string& tag,
@@ -140,12 +165,22 @@ class SummaryFileWriter : public SummaryWriterInterface {
 
   Status WriteEvent(std::unique_ptr<Event> event) override {
     mutex_lock ml(mu_);
-    queue_.emplace_back(std::move(event));
+    if (queue_.size() >= max_pending_events_ && event->has_summary()) {
+      LOG_EVERY_N(WARNING, 1000)
+          << "Dropping summaries because " << queue_.size()
+          << " events are waiting to be written to the events file.";
+    } else {
+      queue_.emplace_back(std::move(event));
+    }
     if (queue_.size() > max_queue_ ||
         env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
-      return InternalFlush();
+      flush_pending_ = true;
+      flush_requested_.notify_one();
     }
-    return Status::OK();
+    // Reports a failure of the background thread once.
+    Status s = background_status_;
+    background_status_ = Status::OK();
+    return s;
   }
 
   string DebugString() const override { return "SummaryFileWriter"; }
@@ -155,28 +190,69 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return static_cast<double>(env_->NowMicros()) / 1.0e6;
   }
 
-  Status InternalFlush() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    for (const std::unique_ptr<Event>& e : queue_) {
+  // Writes and flushes the queued events. `mu_` is only held to take them
+  // from the queue, so that WriteEvent() does not wait for the file system.
+  Status InternalFlush() TF_EXCLUSIVE_LOCKS_REQUIRED(write_mu_) {
+    std::vector<std::unique_ptr<Event>> events;
+    {
+      mutex_lock ml(mu_);
+      events.swap(queue_);
+      flush_pending_ = false;
+    }
+    for (const std::unique_ptr<Event>& e : events) {
       events_writer_->WriteEvent(*e);
     }
-    queue_.clear();
-    TF_RETURN_WITH_CONTEXT_IF_ERROR(events_writer_->Flush(),
-                                    "Could not flush events file.");
-    last_flush_ = env_->NowMicros();
+    Status s = events_writer_->Flush();
+    {
+      mutex_lock ml(mu_);
+      last_flush_ = env_->NowMicros();
+    }
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(s, "Could not flush events file.");
     return Status::OK();
   }
 
-  bool is_initialized_;
+  void FlushLoop() {
+    while (true) {
+      {
+        mutex_lock ml(mu_);
+        while (!flush_pending_ && !cancelled_) {
+          flush_requested_.wait(ml);
+        }
+        if (cancelled_) return;
+      }
+      mutex_lock wl(write_mu_);
+      Status s = InternalFlush();
+      if (!s.ok()) {
+        mutex_lock ml(mu_);
+        background_status_.Update(s);
+      }
+    }
+  }
+
+  bool is_initialized_ TF_GUARDED_BY(mu_);
   const int max_queue_;
+  const size_t max_pending_events_;
   const int flush_millis_;
-  uint64 last_flush_;
+  uint64 last_flush_ TF_GUARDED_BY(mu_);
   Env* env_;
+
+  // Serializes writes to the events file. Acquired before `mu_`.
+  mutex write_mu_;
+  // A pointer to allow deferred construction.
+  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(write_mu_);
+
   mutex mu_;
   std::vector<std::unique_ptr<Event>> queue_ TF_GUARDED_BY(mu_);
-  // A pointer to allow deferred construction.
-  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(mu_);
   std::vector<std::pair<string, SummaryMetadata>> registered_summaries_
       TF_GUARDED_BY(mu_);
+  condition_variable flush_requested_;
+  bool flush_pending_ TF_GUARDED_BY(mu_) = false;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  Status background_status_ TF_GUARDED_BY(mu_);
+
+  // Declared last so that the thread is joined before the members it uses
+  // are destroyed.
+  std::unique_ptr<Thread> flush_thread_;
 };
 
 }  // namespace
@@ -28,7 +28,9 @@ namespace tensorflow {
 /// makes this summary writer suitable for file systems like GCS.
 ///
 /// It will enqueue up to max_queue summaries, and flush at least every
-/// flush_millis milliseconds. The summaries will be written to the
+/// flush_millis milliseconds. Queued summaries are written and flushed by a
+/// background thread; if it falls far behind, further summaries are dropped
+/// rather than held in memory. The summaries will be written to the
 /// directory specified by logdir and with the filename suffixed by
 /// filename_suffix. The caller owns a reference to result if the
 /// returned status is ok. The Env object must not be destroyed until
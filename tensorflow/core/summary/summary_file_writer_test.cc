@@ -217,6 +217,47 @@ TEST_F(SummaryFileWriterTest, WriteEvent) {
                         }));
 }
 
+TEST_F(SummaryFileWriterTest, FlushesInBackground) {
+  SummaryWriterInterface* writer;
+  TF_CHECK_OK(CreateSummaryFileWriter(1, 1, testing::TmpDir(),
+                                      "background_flush_test", &env_,
+                                      &writer));
+  core::ScopedUnref deleter(writer);
+  Tensor one(DT_FLOAT, TensorShape({}));
+  one.scalar<float>()() = 1.0;
+  // The second event exceeds max_queue and wakes up the background thread.
+  TF_CHECK_OK(writer->WriteScalar(1, one, "name"));
+  TF_CHECK_OK(writer->WriteScalar(2, one, "name"));
+
+  std::vector<string> files;
+  TF_CHECK_OK(env_.GetChildren(testing::TmpDir(), &files));
+  string fname;
+  for (const string& f : files) {
+    if (absl::StrContains(f, "background_flush_test")) {
+      fname = io::JoinPath(testing::TmpDir(), f);
+    }
+  }
+  ASSERT_FALSE(fname.empty());
+  // Waits for the file version event and the two scalars, without Flush().
+  std::vector<Event> events;
+  for (int i = 0; i < 1000 && events.size() < 3; ++i) {
+    Env::Default()->SleepForMicroseconds(10000);
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env_.NewRandomAccessFile(fname, &read_file));
+    io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+    tstring record;
+    uint64 offset = 0;
+    events.clear();
+    while (reader.ReadRecord(&offset, &record).ok()) {
+      events.emplace_back();
+      events.back().ParseFromString(record);
+    }
+  }
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(events[1].step(), 1);
+  EXPECT_EQ(events[2].step(), 2);
+}
+
 TEST_F(SummaryFileWriterTest, WallTime) {
   env_.AdvanceByMillis(7023);
   TF_CHECK_OK(SummaryTestHelper(
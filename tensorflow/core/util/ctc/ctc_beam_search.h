@@ -264,11 +264,8 @@ void CTCBeamSearchDecoder<T, CTCBeamState, CTCBeamComparer>::Step(
     max_coeff = raw_input.maxCoeff();
   }
   // Get normalization term of softmax: log(sum(exp(logit[j]-max_coeff))).
-  T logsumexp = T(0.0);
-  for (int j = 0; j < raw_input.size(); ++j) {
-    logsumexp += Eigen::numext::exp(raw_input(j) - max_coeff);
-  }
-  logsumexp = Eigen::numext::log(logsumexp);
+  const T logsumexp = Eigen::numext::log(
+      (raw_input.array() - max_coeff).exp().sum());
   // Final normalization offset to get correct log probabilities.
   T norm_offset = max_coeff + logsumexp;
 
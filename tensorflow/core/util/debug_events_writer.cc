@@ -70,10 +70,18 @@ void SingleDebugEventFileWriter::WriteSerializedDebugEvent(
       return;
     }
   }
+  // Checksum the record before taking the lock, so that concurrent writers of
+  // large events, e.g. full tensor values, only serialize on the file append.
+  char header[io::RecordWriter::kHeaderSize];
+  char footer[io::RecordWriter::kFooterSize];
+  io::RecordWriter::PopulateHeader(header, debug_event_str.data(),
+                                   debug_event_str.size());
+  io::RecordWriter::PopulateFooter(footer, debug_event_str.data(),
+                                   debug_event_str.size());
   num_outstanding_events_.fetch_add(1);
   {
     mutex_lock l(writer_mu_);
-    record_writer_->WriteRecord(debug_event_str).IgnoreError();
+    record_writer_->WriteRecord(debug_event_str, header, footer).IgnoreError();
   }
 }
 
@@ -238,9 +246,12 @@ Status DebugEventsWriter::WriteExecution(Execution* execution) {
     string serialized;
     debug_event.SerializeToString(&serialized);
 
+    string evicted;
     mutex_lock l(execution_buffer_mu_);
     execution_buffer_.emplace_back(std::move(serialized));
     if (execution_buffer_.size() > circular_buffer_size_) {
+      // Freed after the lock is released.
+      evicted.swap(execution_buffer_.front());
       execution_buffer_.pop_front();
     }
     return Status::OK();
@@ -263,9 +274,12 @@ Status DebugEventsWriter::WriteGraphExecutionTrace(
     string serialized;
     debug_event.SerializeToString(&serialized);
 
+    string evicted;
     mutex_lock l(graph_execution_trace_buffer_mu_);
     graph_execution_trace_buffer_.emplace_back(std::move(serialized));
     if (graph_execution_trace_buffer_.size() > circular_buffer_size_) {
+      // Freed after the lock is released.
+      evicted.swap(graph_execution_trace_buffer_.front());
       graph_execution_trace_buffer_.pop_front();
     }
     return Status::OK();
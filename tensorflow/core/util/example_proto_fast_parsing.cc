@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
+#include <cstring>
 #include <vector>
 
 #include "absl/base/casts.h"
@@ -113,6 +114,55 @@ constexpr uint8 kVarintTag(uint32 tag) { return (tag << 3) | 0; }
 constexpr uint8 kDelimitedTag(uint32 tag) { return (tag << 3) | 2; }
 constexpr uint8 kFixed32Tag(uint32 tag) { return (tag << 3) | 5; }
 
+// Returns the number of varints terminating in [begin, end), i.e. the number of
+// bytes without the continuation bit set. The loop has no data dependencies,
+// so the compiler vectorizes it.
+inline size_t CountPackedVarints(const uint8* begin, const uint8* end) {
+  size_t count = 0;
+  for (const uint8* p = begin; p < end; ++p) {
+    count += (*p < 0x80);
+  }
+  return count;
+}
+
+// Decodes the packed varints in [begin, end) into `out`, writing at most
+// `max_out` values. Returns false if a varint is truncated or longer than 10
+// bytes. Runs of single-byte varints (the common case for small ids and
+// categorical features) are detected 8 bytes at a time and widened without
+// going through the per-byte protobuf decoder.
+inline bool DecodePackedVarints(const uint8* begin, const uint8* end,
+                                int64* out, size_t max_out) {
+  constexpr uint64 kContinuationBits = 0x8080808080808080ULL;
+  const uint8* p = begin;
+  size_t index = 0;
+  while (p < end) {
+    if (end - p >= 8 && index + 8 <= max_out) {
+      uint64 word;
+      std::memcpy(&word, p, sizeof(word));
+      if ((word & kContinuationBits) == 0) {
+        for (int i = 0; i < 8; ++i) out[index + i] = p[i];
+        p += 8;
+        index += 8;
+        continue;
+      }
+    }
+    uint64 value = 0;
+    bool terminated = false;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+      const uint8 byte = *p++;
+      value |= static_cast<uint64>(byte & 0x7F) << shift;
+      if (byte < 0x80) {
+        terminated = true;
+        break;
+      }
+    }
+    if (!terminated) return false;
+    if (index < max_out) out[index] = static_cast<int64>(value);
+    ++index;
+  }
+  return true;
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -299,15 +349,25 @@ class Feature {
         if (!stream.ExpectTag(kDelimitedTag(1))) return false;  // packed tag
         uint32 packed_length;
         if (!stream.ReadVarint32(&packed_length)) return false;
-        auto packed_limit = stream.PushLimit(packed_length);
-
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64>(n));
+        const void* packed_data;
+        int available;
+        if (!stream.GetDirectBufferPointer(&packed_data, &available) ||
+            static_cast<uint32>(available) < packed_length) {
+          return false;
         }
-
-        stream.PopLimit(packed_limit);
+        const uint8* packed_begin = static_cast<const uint8*>(packed_data);
+        const uint8* packed_end = packed_begin + packed_length;
+
+        // Size the output once up front and decode straight into it.
+        const size_t initial_size = int64_list->size();
+        int64_list->resize(initial_size +
+                           CountPackedVarints(packed_begin, packed_end));
+        if (!DecodePackedVarints(packed_begin, packed_end,
+                                 int64_list->data() + initial_size,
+                                 int64_list->size() - initial_size)) {
+          return false;
+        }
+        if (!stream.Skip(packed_length)) return false;
       } else {  // non-packed
         while (!stream.ExpectAtEnd()) {
           if (!stream.ExpectTag(kVarintTag(1))) return false;
@@ -1173,6 +1233,7 @@ Status FastParseExample(const Config& config,
   // Calculate number of minibatches.
   // In main regime make each minibatch around kMiniBatchSizeBytes bytes.
   // Apply 'special logic' below for small and big regimes.
+  size_t total_bytes = 0;
   const size_t num_minibatches = [&] {
     size_t result = 0;
     size_t minibatch_bytes = 0;
@@ -1181,6 +1242,7 @@ Status FastParseExample(const Config& config,
         result++;
       }
       minibatch_bytes += serialized[i].size() + 1;
+      total_bytes += serialized[i].size() + 1;
       if (minibatch_bytes > kMiniBatchSizeBytes) {
         minibatch_bytes = 0;
       }
@@ -1192,8 +1254,27 @@ Status FastParseExample(const Config& config,
                             std::min<size_t>(max_minibatches, result));
   }();
 
+  // Split the examples into minibatches of about the same number of bytes
+  // rather than of examples, so that a few large examples do not leave most
+  // threads idle while one parses them. Minibatch `m` starts at the first
+  // example preceded by at least `m / num_minibatches` of the total bytes.
+  std::vector<size_t> minibatch_starts(num_minibatches + 1, serialized.size());
+  if (num_minibatches > 0) {
+    minibatch_starts[0] = 0;
+    size_t minibatch = 1;
+    size_t bytes = 0;
+    for (size_t i = 0; i < serialized.size() && minibatch < num_minibatches;
+         i++) {
+      while (minibatch < num_minibatches &&
+             bytes * num_minibatches >= total_bytes * minibatch) {
+        minibatch_starts[minibatch++] = i;
+      }
+      bytes += serialized[i].size() + 1;
+    }
+  }
+
   auto first_example_of_minibatch = [&](size_t minibatch) -> size_t {
-    return (serialized.size() * minibatch) / num_minibatches;
+    return minibatch_starts[minibatch];
   };
 
   // TODO(lew): A big performance low-hanging fruit here is to improve
@@ -1955,18 +2036,20 @@ inline int ParseInt64Feature(protobuf::io::CodedInputStream* stream,
           !stream->ReadVarint32(&packed_length)) {
         return -1;
       }
-      auto packed_limit = stream->PushLimit(packed_length);
-      while (!stream->ExpectAtEnd()) {
-        protobuf_uint64 n;  // There is no API for int64
-        if (!stream->ReadVarint64(&n)) {
-          return -1;
-        }
-        if (out != nullptr) {
-          *out++ = n;
-        }
-        num_elements++;
+      const void* packed_data;
+      int available;
+      if (!stream->GetDirectBufferPointer(&packed_data, &available) ||
+          static_cast<uint32>(available) < packed_length) {
+        return -1;
       }
-      stream->PopLimit(packed_limit);
+      const uint8* packed_begin = static_cast<const uint8*>(packed_data);
+      const uint8* packed_end = packed_begin + packed_length;
+      num_elements = CountPackedVarints(packed_begin, packed_end);
+      if (out != nullptr &&
+          !DecodePackedVarints(packed_begin, packed_end, out, num_elements)) {
+        return -1;
+      }
+      if (!stream->Skip(packed_length)) return -1;
     } else if (peek_tag == kVarintTag(1)) {
       while (!stream->ExpectAtEnd()) {
         protobuf_uint64 n;  // There is no API for int64
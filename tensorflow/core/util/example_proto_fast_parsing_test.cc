@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <limits>
 #include <utility>
 
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
@@ -24,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/util/example_proto_fast_parsing_test.pb.h"
 
 namespace tensorflow {
@@ -170,6 +172,34 @@ TEST(FastParse, Packed) {
       "\x0a\x0d\x0a\x0b\x0a\x03\x61\x67\x65\x12\x04\x1a\x02\x08\x0d");
 }
 
+TEST(FastParse, PackedInt64MixedWidths) {
+  Example example;
+  Int64List* int64_list =
+      (*example.mutable_features()->mutable_feature())["int64_list"]
+          .mutable_int64_list();
+  // Long runs of single-byte varints interleaved with multi-byte and negative
+  // (10-byte) values exercise both the wide and per-value decoding paths.
+  for (int64 i = 0; i < 37; ++i) int64_list->add_value(i);
+  int64_list->add_value(300);
+  for (int64 i = 0; i < 9; ++i) int64_list->add_value(127 - i);
+  int64_list->add_value(-1);
+  int64_list->add_value(std::numeric_limits<int64>::min());
+  int64_list->add_value(std::numeric_limits<int64>::max());
+  for (int64 i = 0; i < 16; ++i) int64_list->add_value(i * 1000);
+  TestCorrectness(Serialize(example));
+}
+
+TEST(FastParse, PackedInt64Truncated) {
+  // Example{features{feature{key: "a" value{int64_list{value: [<0x80>]}}}}},
+  // where the only varint is missing its terminating byte.
+  const string serialized(
+      "\x0a\x0c\x0a\x0a\x0a\x01\x61\x12\x05\x1a\x03\x0a\x01\x80", 14);
+  Example example;
+  EXPECT_FALSE(example.ParseFromString(serialized));
+  Example fast_example;
+  EXPECT_FALSE(TestFastParse(serialized, &fast_example));
+}
+
 TEST(FastParse, EmptyFeatures) {
   Example example;
   example.mutable_features();
@@ -423,6 +453,114 @@ TEST(TestFastParseExample, Empty) {
   EXPECT_TRUE(status.ok()) << status;
 }
 
+TEST(TestFastParseExample, SkewedExampleSizes) {
+  // A few large examples followed by many small ones, so that minibatches
+  // balanced by bytes hold very different numbers of examples.
+  constexpr int kNumExamples = 200;
+  constexpr char kVarLenInt64Key[] = "varlen_int64";
+  auto num_ids = [](int i) { return i < 4 ? 5000 : i % 3; };
+  std::vector<tstring> serialized;
+  for (int i = 0; i < kNumExamples; ++i) {
+    Example example;
+    auto& features = *example.mutable_features()->mutable_feature();
+    features[kDenseFloatKey].mutable_float_list()->add_value(i);
+    for (int j = 0; j < num_ids(i); ++j) {
+      features[kSparseInt64Key].mutable_int64_list()->add_value(i);
+      features[kVarLenInt64Key].mutable_int64_list()->add_value(i);
+    }
+    serialized.push_back(Serialize(example));
+  }
+
+  FastParseExampleConfig config;
+  AddDenseFeature(kDenseFloatKey, DT_FLOAT, {1}, false, 1, &config);
+  AddDenseFeature(kVarLenInt64Key, DT_INT64, {-1}, true, 1, &config);
+  AddSparseFeature(kSparseInt64Key, DT_INT64, &config);
+  config.dense[1].default_value = Tensor(int64{-1});
+
+  thread::ThreadPool thread_pool(Env::Default(), "test", 4);
+  Result result;
+  TF_CHECK_OK(FastParseExample(config, serialized, {}, &thread_pool, &result));
+
+  auto dense = result.dense_values[0].matrix<float>();
+  auto varlen = result.dense_values[1].matrix<int64>();
+  ASSERT_EQ(result.dense_values[1].dim_size(1), num_ids(0));
+  auto indices = result.sparse_indices[0].matrix<int64>();
+  auto values = result.sparse_values[0].vec<int64>();
+  int64 sparse_offset = 0;
+  for (int i = 0; i < kNumExamples; ++i) {
+    EXPECT_EQ(dense(i, 0), i);
+    for (int j = 0; j < num_ids(0); ++j) {
+      EXPECT_EQ(varlen(i, j), j < num_ids(i) ? i : -1);
+    }
+    for (int j = 0; j < num_ids(i); ++j, ++sparse_offset) {
+      EXPECT_EQ(indices(sparse_offset, 0), i);
+      EXPECT_EQ(indices(sparse_offset, 1), j);
+      EXPECT_EQ(values(sparse_offset), i);
+    }
+  }
+  EXPECT_EQ(sparse_offset, result.sparse_values[0].NumElements());
+}
+
+// Builds `num_examples` serialized examples resembling a recommendation model
+// input: a dense float embedding, a dense int64 label and variable length
+// int64 id lists whose values are either small (single-byte varints) or large
+// hashed ids.
+std::vector<tstring> MakeBenchmarkExamples(int num_examples, int num_floats,
+                                           int num_ids, bool large_ids) {
+  random::PhiloxRandom philox(42);
+  random::SimplePhilox rng(&philox);
+  std::vector<tstring> serialized;
+  serialized.reserve(num_examples);
+  for (int i = 0; i < num_examples; ++i) {
+    Example example;
+    auto& features = *example.mutable_features()->mutable_feature();
+    FloatList* float_list = features[kDenseFloatKey].mutable_float_list();
+    for (int j = 0; j < num_floats; ++j) {
+      float_list->add_value(rng.RandFloat());
+    }
+    features[kDenseInt64Key].mutable_int64_list()->add_value(rng.Uniform(2));
+    Int64List* id_list = features[kSparseInt64Key].mutable_int64_list();
+    for (int j = 0; j < num_ids; ++j) {
+      id_list->add_value(large_ids ? static_cast<int64>(rng.Rand64() >> 1)
+                                   : rng.Uniform(128));
+    }
+    serialized.emplace_back(Serialize(example));
+  }
+  return serialized;
+}
+
+void BM_FastParseExample(::testing::benchmark::State& state, bool large_ids) {
+  const int num_ids = state.range(0);
+  constexpr int kNumExamples = 128;
+  constexpr int kNumFloats = 64;
+  std::vector<tstring> serialized =
+      MakeBenchmarkExamples(kNumExamples, kNumFloats, num_ids, large_ids);
+
+  FastParseExampleConfig config;
+  AddDenseFeature(kDenseFloatKey, DT_FLOAT, {kNumFloats}, false, kNumFloats,
+                  &config);
+  AddDenseFeature(kDenseInt64Key, DT_INT64, {1}, false, 1, &config);
+  AddSparseFeature(kSparseInt64Key, DT_INT64, &config);
+
+  int64 bytes = 0;
+  for (const tstring& s : serialized) bytes += s.size();
+  for (auto s : state) {
+    Result result;
+    TF_CHECK_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+void BM_FastParseExampleSmallIds(::testing::benchmark::State& state) {
+  BM_FastParseExample(state, /*large_ids=*/false);
+}
+BENCHMARK(BM_FastParseExampleSmallIds)->Arg(8)->Arg(64)->Arg(512);
+
+void BM_FastParseExampleLargeIds(::testing::benchmark::State& state) {
+  BM_FastParseExample(state, /*large_ids=*/true);
+}
+BENCHMARK(BM_FastParseExampleLargeIds)->Arg(8)->Arg(64)->Arg(512);
+
 }  // namespace
 }  // namespace example
 }  // namespace tensorflow
@@ -21,6 +21,7 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -950,6 +951,83 @@ Status BundleReader::Lookup(StringPiece key, Tensor* val) {
   }
 }
 
+namespace {
+
+// A tensor buffer pointing into a memory mapped data file, which it keeps
+// mapped.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                     uint64 offset, size_t size)
+      : TensorBuffer(const_cast<char*>(
+            static_cast<const char*>(region->data()) + offset)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("mmap");
+  }
+  // The mapping is read-only, so the buffer must never be written in place.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
+}  // namespace
+
+Status BundleReader::LookupMapped(StringPiece key, Tensor* val) {
+  CHECK(val != nullptr);
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  const TensorShape stored_shape(entry.shape());
+  if (!entry.slices().empty() || !DataTypeCanUseMemcpy(entry.dtype()) ||
+      need_to_swap_bytes_ || stored_shape.num_elements() == 0 ||
+      entry.offset() % EIGEN_MAX_ALIGN_BYTES != 0) {
+    *val = Tensor(entry.dtype(), stored_shape);
+    return Lookup(key, val);
+  }
+
+  auto it = mapped_data_.find(entry.shard_id());
+  if (it == mapped_data_.end()) {
+    const string fname = DataFilename(prefix_, entry.shard_id(), num_shards_);
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    Status s = env_->NewReadOnlyMemoryRegionFromFile(fname, &region);
+    if (!s.ok()) {
+      VLOG(1) << "Could not memory map " << fname << ": " << s;
+      region.reset();
+    }
+    it = mapped_data_.emplace(entry.shard_id(), std::move(region)).first;
+  }
+  const std::shared_ptr<ReadOnlyMemoryRegion>& region = it->second;
+  if (region == nullptr) {
+    *val = Tensor(entry.dtype(), stored_shape);
+    return Lookup(key, val);
+  }
+
+  const size_t expected_size =
+      stored_shape.num_elements() * DataTypeSize(entry.dtype());
+  if (entry.size() != expected_size) {
+    return errors::DataLoss("Invalid size in bundle entry: key ", key,
+                            "; stored size ", entry.size(),
+                            "; expected size ", expected_size);
+  }
+  if (entry.offset() + entry.size() > region->length()) {
+    return errors::DataLoss("Bundle entry ", key, " at offset ",
+                            entry.offset(), " with size ", entry.size(),
+                            " is past the end of its data file");
+  }
+  TensorBuffer* buf = new MappedTensorBuffer(region, entry.offset(),
+                                             entry.size());
+  *val = Tensor(entry.dtype(), stored_shape, buf);
+  buf->Unref();
+  return Status::OK();
+}
+
 Status BundleReader::ReadCurrent(Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1138,7 +1216,11 @@ string BundleReader::DebugString() {
   return shape_str;
 }
 
-FileOutputBuffer::~FileOutputBuffer() { delete file_; }
+FileOutputBuffer::~FileOutputBuffer() {
+  WaitForPendingWrite().IgnoreError();
+  writer_.reset();
+  delete file_;
+}
 
 Status FileOutputBuffer::Append(StringPiece data) {
   // In the below, it is critical to calculate the checksum on the actually
@@ -1150,19 +1232,19 @@ Status FileOutputBuffer::Append(StringPiece data) {
     crc32c_ = crc32c::Extend(crc32c_, &buffer_[position_], data.size());
   } else if (data.size() <= buffer_size_) {
     // Cannot fit, but can fit after flushing.
-    TF_RETURN_IF_ERROR(FlushBuffer());
+    TF_RETURN_IF_ERROR(FlushBufferAsync());
     memcpy(&buffer_[0], data.data(), data.size());
     crc32c_ = crc32c::Extend(crc32c_, &buffer_[0], data.size());
   } else {
     // Cannot fit even after flushing.  So we break down "data" by chunk, and
     // flush/checksum each chunk.
-    TF_RETURN_IF_ERROR(FlushBuffer());
+    TF_RETURN_IF_ERROR(FlushBufferAsync());
     for (size_t i = 0; i < data.size(); i += buffer_size_) {
       const size_t nbytes = std::min(data.size() - i, buffer_size_);
       memcpy(&buffer_[0], data.data() + i, nbytes);
       crc32c_ = crc32c::Extend(crc32c_, &buffer_[0], nbytes);
       position_ = nbytes;
-      TF_RETURN_IF_ERROR(FlushBuffer());
+      TF_RETURN_IF_ERROR(FlushBufferAsync());
     }
     return Status::OK();
   }
@@ -1176,6 +1258,7 @@ Status FileOutputBuffer::Close() {
 }
 
 Status FileOutputBuffer::FlushBuffer() {
+  TF_RETURN_IF_ERROR(WaitForPendingWrite());
   if (position_ > 0) {
     TF_RETURN_IF_ERROR(file_->Append(StringPiece(&buffer_[0], position_)));
     position_ = 0;
@@ -1183,4 +1266,37 @@ Status FileOutputBuffer::FlushBuffer() {
   return Status::OK();
 }
 
+Status FileOutputBuffer::FlushBufferAsync() {
+  if (position_ == 0) return Status::OK();
+  TF_RETURN_IF_ERROR(WaitForPendingWrite());
+  if (writer_ == nullptr) {
+    writer_.reset(new thread::ThreadPool(Env::Default(), "file_output_buffer",
+                                         /*num_threads=*/1));
+    pending_buffer_.resize(buffer_size_);
+  }
+  buffer_.swap(pending_buffer_);
+  const size_t nbytes = position_;
+  position_ = 0;
+  {
+    mutex_lock l(mu_);
+    write_pending_ = true;
+  }
+  writer_->Schedule([this, nbytes]() {
+    Status s = file_->Append(StringPiece(&pending_buffer_[0], nbytes));
+    mutex_lock l(mu_);
+    write_status_.Update(s);
+    write_pending_ = false;
+    cv_.notify_all();
+  });
+  return Status::OK();
+}
+
+Status FileOutputBuffer::WaitForPendingWrite() {
+  mutex_lock l(mu_);
+  while (write_pending_) {
+    cv_.wait(l);
+  }
+  return write_status_;
+}
+
 }  // namespace tensorflow
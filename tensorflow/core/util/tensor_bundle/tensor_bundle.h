@@ -62,6 +62,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_TENSOR_BUNDLE_H_
 
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -69,6 +70,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_slice.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/io/cache.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
@@ -76,6 +78,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/protobuf/tensor_bundle.pb.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
@@ -219,6 +222,24 @@ class BundleReader {
   // REQUIRES: status().ok()
   Status Lookup(StringPiece key, Tensor* val) TF_MUST_USE_RESULT;
 
+  // Looks up the tensor keyed by "key", and sets "val" to a tensor of the
+  // stored dtype and shape.  If possible, "val" is backed by a read-only
+  // memory mapping of the data file, so its pages are only read on first
+  // access and are shared through the page cache with every other process
+  // mapping the same file.  Since such a buffer does not own its memory,
+  // ops that update a variable holding it copy it first.
+  //
+  // Mapping requires a full (non-partitioned) tensor of a memcpy-able dtype,
+  // in a bundle of this machine's endianness, stored at an offset aligned to
+  // EIGEN_MAX_ALIGN_BYTES (see BundleWriter::Options::data_alignment).
+  // Otherwise, or if the file system does not support memory mapping, this
+  // falls back to reading a copy as "Lookup()" does.
+  //
+  // Unlike "Lookup()", does not validate the checksum of mapped tensors,
+  // since that would read every page.
+  // REQUIRES: status().ok()
+  Status LookupMapped(StringPiece key, Tensor* val) TF_MUST_USE_RESULT;
+
   // Looks up the tensor pointed to by the internal iterator.
   //
   // On error, "val" may contain nonsense data.
@@ -293,6 +314,10 @@ class BundleReader {
   table::Iterator* iter_;
   // Owned the InputBuffer objects and their underlying RandomAccessFile's.
   std::unordered_map<int32, io::InputBuffer*> data_;
+  // The memory mapped data files used by "LookupMapped()", shared with the
+  // tensors backed by them.  Holds nullptr for files that cannot be mapped.
+  std::unordered_map<int32, std::shared_ptr<ReadOnlyMemoryRegion>>
+      mapped_data_;
 
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
@@ -314,6 +339,10 @@ class BundleReader {
 // A buffering wrapper for a WritableFile.  Useful if the caller wishes to issue
 // small writes to a file (e.g. writing out a list of small varints).
 // External synchronization must be used in the presence of concurrent callers.
+//
+// A full buffer is written to the file by a background thread while the next
+// one is being filled, so copying and checksumming overlap with the write.
+// An error from such a write is returned by a later Append() or by Close().
 class FileOutputBuffer {
  public:
   FileOutputBuffer(WritableFile* file, size_t buffer_size)
@@ -338,6 +367,14 @@ class FileOutputBuffer {
   // Appends the buffered data to the underlying file. Does NOT flush the file.
   Status FlushBuffer();
 
+  // Like FlushBuffer(), but returns once the buffered data has been handed
+  // to `writer_`, which appends it while buffer_ is refilled.
+  Status FlushBufferAsync();
+
+  // Waits for the append started by FlushBufferAsync(), if any, and returns
+  // the status of all such appends so far.
+  Status WaitForPendingWrite();
+
   WritableFile* file_;  // Owned.
 
   // buffer_[0, position_) holds the buffered data not yet appended to the
@@ -346,6 +383,15 @@ class FileOutputBuffer {
   const size_t buffer_size_;
   std::vector<char> buffer_;
 
+  // Created on the first FlushBufferAsync().  pending_buffer_ holds the data
+  // being appended by writer_ while write_pending_ is true.
+  std::unique_ptr<thread::ThreadPool> writer_;
+  std::vector<char> pending_buffer_;
+  mutex mu_;
+  condition_variable cv_;
+  bool write_pending_ TF_GUARDED_BY(mu_) = false;
+  Status write_status_ TF_GUARDED_BY(mu_);
+
   // Checksum of all appended bytes since construction or last clear_crc32c().
   uint32 crc32c_ = 0;
 };
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/io/table_builder.h"
 #include "tensorflow/core/lib/strings/str_util.h"
@@ -1056,6 +1057,63 @@ TEST(TensorBundleTest, VersionTest) {
   }
 }
 
+TEST(TensorBundleTest, FileOutputBufferSpansManyBuffers) {
+  const string path = Prefix("file_output_buffer");
+  string expected;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_ASSERT_OK(Env::Default()->NewWritableFile(path, &file));
+    FileOutputBuffer out(file.release(), /*buffer_size=*/16);
+    // Mixes appends that fit, that need a flush first, and that are larger
+    // than the buffer, so that writes overlap with the next fill.
+    for (int i = 0; i < 64; ++i) {
+      const string piece(1 + (i * 7) % 40, static_cast<char>('a' + i % 26));
+      TF_ASSERT_OK(out.Append(piece));
+      expected += piece;
+    }
+    EXPECT_EQ(crc32c::Value(expected.data(), expected.size()), out.crc32c());
+    TF_ASSERT_OK(out.Close());
+  }
+  string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), path, &contents));
+  EXPECT_EQ(expected, contents);
+}
+
+TEST(TensorBundleTest, LookupMapped) {
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = EIGEN_MAX_ALIGN_BYTES;
+    BundleWriter writer(Env::Default(), Prefix("mapped"), opts);
+    TF_EXPECT_OK(writer.Add("floats", Constant_2x3<float>(1.5)));
+    TF_EXPECT_OK(writer.Add("ints", Constant_2x3<int64>(7)));
+    TF_EXPECT_OK(writer.Add("strings", Constant_2x3<tstring>("abc")));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader reader(Env::Default(), Prefix("mapped"));
+  TF_ASSERT_OK(reader.status());
+
+  Tensor floats;
+  TF_ASSERT_OK(reader.LookupMapped("floats", &floats));
+  test::ExpectTensorEqual<float>(floats, Constant_2x3<float>(1.5));
+  // The mapped buffer does not own its memory, so it cannot be forwarded or
+  // updated in place.
+  EXPECT_FALSE(floats.RefCountIsOne());
+
+  Tensor ints;
+  TF_ASSERT_OK(reader.LookupMapped("ints", &ints));
+  test::ExpectTensorEqual<int64>(ints, Constant_2x3<int64>(7));
+  EXPECT_FALSE(ints.RefCountIsOne());
+
+  // Strings are not stored as flat bytes, so they are read into a copy.
+  Tensor strings;
+  TF_ASSERT_OK(reader.LookupMapped("strings", &strings));
+  test::ExpectTensorEqual<tstring>(strings, Constant_2x3<tstring>("abc"));
+  EXPECT_TRUE(strings.RefCountIsOne());
+
+  Tensor missing;
+  EXPECT_EQ(reader.LookupMapped("missing", &missing).code(), error::NOT_FOUND);
+}
+
 class TensorBundleAlignmentTest : public ::testing::Test {
  protected:
   template <typename T>
@@ -15,12 +15,125 @@ limitations under the License.
 
 #include "tensorflow/core/util/work_sharder.h"
 
+#include <atomic>
+#include <map>
+
 #include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env_time.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 /* ABSL_CONST_INIT */ thread_local int per_thread_max_parallelism = 1000000;
+/* ABSL_CONST_INIT */ thread_local const string* shard_cost_key = nullptr;
+
+namespace {
+
+// Learned cost per unit of work of the Shard() calls made under a key.
+class ShardCostModel {
+ public:
+  // Number of Shard() calls to measure before trusting the learned cost.
+  static constexpr int64 kMinSamples = 8;
+
+  static ShardCostModel* Global() {
+    static ShardCostModel* model = new ShardCostModel;
+    return model;
+  }
+
+  // Returns the learned cost of `key`, or `cost_per_unit` if it has too few
+  // samples.
+  int64 CostPerUnit(const string& key, int64 cost_per_unit) {
+    tf_shared_lock l(mu_);
+    auto it = costs_.find(key);
+    if (it == costs_.end() || it->second.num_samples < kMinSamples) {
+      return cost_per_unit;
+    }
+    return std::max<int64>(1, it->second.ns_per_unit);
+  }
+
+  void Record(const string& key, int64 total, int64 elapsed_ns) {
+    const double ns_per_unit = static_cast<double>(elapsed_ns) / total;
+    mutex_lock l(mu_);
+    Cost& cost = costs_[key];
+    // Exponential moving average, seeded with the first sample.
+    cost.ns_per_unit = cost.num_samples == 0
+                           ? ns_per_unit
+                           : 0.9 * cost.ns_per_unit + 0.1 * ns_per_unit;
+    ++cost.num_samples;
+  }
+
+  string DebugString() {
+    tf_shared_lock l(mu_);
+    string result;
+    for (const auto& it : costs_) {
+      strings::StrAppend(&result, it.first, ": ", it.second.ns_per_unit,
+                         " ns/unit, ", it.second.num_samples, " samples\n");
+    }
+    return result;
+  }
+
+ private:
+  struct Cost {
+    double ns_per_unit = 0;
+    int64 num_samples = 0;
+  };
+
+  mutex mu_;
+  std::map<string, Cost> costs_ TF_GUARDED_BY(mu_);
+};
+
+// Calls `fn(cost_per_unit, work)`. If the adaptive cost model is enabled and
+// the calling thread has a key, passes the learned cost of the key instead and
+// records the time spent in `work`.
+template <typename Fn>
+void RunWithCostModel(int64 total, int64 cost_per_unit,
+                      const std::function<void(int64, int64)>& work, Fn fn) {
+  const string* key = shard_cost_key;
+  if (key == nullptr || !ShardCostModelEnabled()) {
+    fn(cost_per_unit, work);
+    return;
+  }
+  ShardCostModel* model = ShardCostModel::Global();
+  cost_per_unit = model->CostPerUnit(*key, cost_per_unit);
+  // Sum the time spent in the shards rather than the wall time of the call,
+  // so that the cost does not depend on how many threads were free.
+  std::atomic<int64> elapsed_ns(0);
+  fn(cost_per_unit, [&work, &elapsed_ns](int64 start, int64 limit) {
+    const uint64 start_ns = EnvTime::NowNanos();
+    work(start, limit);
+    elapsed_ns.fetch_add(EnvTime::NowNanos() - start_ns,
+                         std::memory_order_relaxed);
+  });
+  model->Record(*key, total, elapsed_ns.load(std::memory_order_relaxed));
+}
+
+}  // namespace
+
+bool ShardCostModelEnabled() {
+  static const bool enabled = [] {
+    bool value;
+    Status status = ReadBoolFromEnvVar("TF_SHARD_ADAPTIVE_COST", false, &value);
+    if (!status.ok()) {
+      LOG(ERROR) << status.error_message();
+    }
+    return value;
+  }();
+  return enabled;
+}
+
+ScopedShardCostKey::ScopedShardCostKey(const string* key)
+    : previous_(shard_cost_key) {
+  shard_cost_key = key;
+}
+
+ScopedShardCostKey::~ScopedShardCostKey() { shard_cost_key = previous_; }
+
+string ShardCostModelDebugString() {
+  return ShardCostModel::Global()->DebugString();
+}
 
 void SetPerThreadMaxParallelism(int max_parallelism) {
   CHECK_LE(0, max_parallelism);
@@ -36,19 +149,24 @@ void Shard(int max_parallelism, thread::ThreadPool* workers, int64 total,
     return;
   }
   max_parallelism = std::min(max_parallelism, GetPerThreadMaxParallelism());
-  if (max_parallelism <= 1) {
-    // Just inline the whole work since we only have 1 thread (core).
-    work(0, total);
-    return;
-  }
-  if (max_parallelism >= workers->NumThreads()) {
-    workers->ParallelFor(total, cost_per_unit, work);
-    return;
-  }
-  Sharder::Do(
+  RunWithCostModel(
       total, cost_per_unit, work,
-      [&workers](Sharder::Closure c) { workers->Schedule(c); },
-      max_parallelism);
+      [max_parallelism, workers, total](
+          int64 cost_per_unit, const std::function<void(int64, int64)>& work) {
+        if (max_parallelism <= 1) {
+          // Just inline the whole work since we only have 1 thread (core).
+          work(0, total);
+          return;
+        }
+        if (max_parallelism >= workers->NumThreads()) {
+          workers->ParallelFor(total, cost_per_unit, work);
+          return;
+        }
+        Sharder::Do(
+            total, cost_per_unit, work,
+            [&workers](Sharder::Closure c) { workers->Schedule(c); },
+            max_parallelism);
+      });
 }
 
 // DEPRECATED: Prefer threadpool->ParallelFor with SchedulingStrategy, which
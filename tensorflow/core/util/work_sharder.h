@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_UTIL_WORK_SHARDER_H_
 
 #include <functional>
+#include <string>
 
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/types.h"
@@ -84,6 +85,31 @@ class ScopedPerThreadMaxParallelism {
   int previous_ = -1;
 };
 
+// Adaptive cost model for Shard().
+//
+// When the environment variable TF_SHARD_ADAPTIVE_COST is true, Shard() calls
+// made while a ScopedShardCostKey is active time their shards and keep a
+// moving average of the measured nanoseconds per unit of work for the key
+// (e.g. an op type and dtype). Once a key has enough samples, the learned cost
+// replaces the "cost_per_unit" passed by the caller. The CPU device sets the
+// key for every kernel it runs.
+bool ShardCostModelEnabled();
+
+// Sets the key under which the Shard() calls of the current thread learn
+// their cost, until destroyed. `key` must outlive this object.
+class ScopedShardCostKey {
+ public:
+  explicit ScopedShardCostKey(const string* key);
+  ~ScopedShardCostKey();
+
+ private:
+  const string* previous_;
+};
+
+// Returns the learned nanoseconds per unit and number of samples of every key,
+// one per line, for debugging.
+string ShardCostModelDebugString();
+
 // Implementation details for Shard().
 class Sharder {
  public:
@@ -18,6 +18,7 @@ limitations under the License.
 #include <atomic>
 #include <vector>
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/test.h"
@@ -89,6 +90,27 @@ TEST(Shard, OverflowTest) {
   }
 }
 
+TEST(Shard, AdaptiveCost) {
+  setenv("TF_SHARD_ADAPTIVE_COST", "true", 1);
+  ASSERT_TRUE(ShardCostModelEnabled());
+  thread::ThreadPool threads(Env::Default(), "test", 4);
+  const string key = "AdaptiveCostTest:float";
+  ScopedShardCostKey scoped_key(&key);
+  for (int i = 0; i < 16; ++i) {
+    std::atomic<int64> num_elements(0);
+    // The static cost is far too low: each unit sleeps for 100us.
+    Shard(4, &threads, 8, 1, [&num_elements](int64 start, int64 limit) {
+      Env::Default()->SleepForMicroseconds(100 * (limit - start));
+      num_elements += limit - start;
+    });
+    EXPECT_EQ(num_elements.load(), 8);
+  }
+  const string debug_string = ShardCostModelDebugString();
+  EXPECT_NE(debug_string.find("AdaptiveCostTest:float: "), string::npos)
+      << debug_string;
+  EXPECT_NE(debug_string.find("16 samples"), string::npos) << debug_string;
+}
+
 void BM_Sharding(::testing::benchmark::State& state) {
   const int arg = state.range(0);
 
@@ -26,19 +26,24 @@ namespace {
 
 constexpr int32_t kNodeNotAssigned = std::numeric_limits<int32_t>::max();
 
+// The number of times the kSmallestArena search moves a tensor to the front.
+constexpr int kMaxSearchIterations = 64;
+
 }  // namespace
 
 ArenaPlanner::ArenaPlanner(TfLiteContext* context,
                            std::unique_ptr<GraphInfo> graph_info,
                            bool preserve_inputs, bool preserve_intermediates,
-                           int tensor_alignment)
+                           int tensor_alignment,
+                           MemoryPlanningStrategy strategy)
     : context_(context),
       graph_info_(std::move(graph_info)),
       arena_(kDefaultArenaAlignment),
       persistent_arena_(kDefaultArenaAlignment),
       preserve_inputs_(preserve_inputs),
       preserve_intermediates_(preserve_intermediates),
-      tensor_alignment_(tensor_alignment) {}
+      tensor_alignment_(tensor_alignment),
+      strategy_(strategy) {}
 
 ArenaPlanner::~ArenaPlanner() {}
 
@@ -247,15 +252,28 @@ bool ArenaPlanner::HasNonPersistentMemory() {
   return arena_.GetBufferSize() != 0;
 }
 
+size_t ArenaPlanner::GetNonPersistentArenaSize() {
+  return arena_.RequiredBufferSize();
+}
+
 TfLiteStatus ArenaPlanner::Commit() {
   TF_LITE_ENSURE_STATUS(arena_.Commit(context_));
   TF_LITE_ENSURE_STATUS(persistent_arena_.Commit(context_));
   return kTfLiteOk;
 }
 
-std::vector<int32_t> ArenaPlanner::CreateTensorAllocationVector(int first_node,
-                                                                int last_node) {
-  auto tensor_compare = [this](int idx1, int idx2) {
+std::vector<int32_t> ArenaPlanner::CreateTensorAllocationVector(
+    int first_node, int last_node, MemoryPlanningStrategy strategy) {
+  // The number of nodes a tensor is alive for. Tensors that are never
+  // deallocated live until the last node.
+  auto lifetime = [this](int idx) -> size_t {
+    const int32_t last =
+        std::min<int32_t>(this->dealloc_node_[idx],
+                          this->graph_info_->num_execution_nodes());
+    return last >= this->alloc_node_[idx] ? last - this->alloc_node_[idx] + 1
+                                          : 1;
+  };
+  auto tensor_compare = [this, strategy, &lifetime](int idx1, int idx2) {
     // Tensors that have lifespan through the whole model inference time are
     // allocated at the beginning of memory slice. Their respective order
     // doesn't matter in fact, so here they are sorted by index.
@@ -272,9 +290,17 @@ std::vector<int32_t> ArenaPlanner::CreateTensorAllocationVector(int first_node,
       return false;
     }
 
-    // All other tensors are sorted in non-increasing order of their size.
+    // All other tensors are sorted in non-increasing order of their size, or
+    // of the area they take in the (offset, node) plane.
     auto size1 = this->graph_info_->tensor(idx1)->bytes;
     auto size2 = this->graph_info_->tensor(idx2)->bytes;
+    if (strategy == MemoryPlanningStrategy::kGreedyBySizeTimesLifetime) {
+      const size_t area1 = size1 * lifetime(idx1);
+      const size_t area2 = size2 * lifetime(idx2);
+      if (area1 != area2) {
+        return area1 > area2;
+      }
+    }
     if (size1 != size2) {
       return size1 > size2;
     }
@@ -294,10 +320,84 @@ std::vector<int32_t> ArenaPlanner::CreateTensorAllocationVector(int first_node,
   return tensor_order;
 }
 
+TfLiteStatus ArenaPlanner::SimulateArenaSize(const std::vector<int32_t>& order,
+                                             size_t* arena_size,
+                                             int32_t* peak_tensor) {
+  SimpleMemoryArena arena(kDefaultArenaAlignment);
+  *arena_size = 0;
+  *peak_tensor = -1;
+  for (int32_t tensor_index : order) {
+    const TfLiteTensor& tensor = *graph_info_->tensor(tensor_index);
+    if (tensor.allocation_type != kTfLiteArenaRw) continue;
+    ArenaAllocWithUsageInterval alloc;
+    TF_LITE_ENSURE_STATUS(arena.Allocate(
+        context_, tensor_alignment_, tensor.bytes, tensor_index,
+        alloc_node_[tensor_index], dealloc_node_[tensor_index], &alloc));
+    if (alloc.offset + alloc.size > *arena_size) {
+      *arena_size = alloc.offset + alloc.size;
+      *peak_tensor = tensor_index;
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus ArenaPlanner::SearchTensorAllocationVector(
+    int first_node, int last_node, std::vector<int32_t>* order) {
+  size_t best_size = std::numeric_limits<size_t>::max();
+  int32_t peak_tensor = -1;
+  for (MemoryPlanningStrategy strategy :
+       {MemoryPlanningStrategy::kGreedyBySize,
+        MemoryPlanningStrategy::kGreedyBySizeTimesLifetime}) {
+    std::vector<int32_t> candidate =
+        CreateTensorAllocationVector(first_node, last_node, strategy);
+    size_t size;
+    int32_t candidate_peak_tensor;
+    TF_LITE_ENSURE_STATUS(
+        SimulateArenaSize(candidate, &size, &candidate_peak_tensor));
+    if (size < best_size) {
+      best_size = size;
+      peak_tensor = candidate_peak_tensor;
+      *order = std::move(candidate);
+    }
+  }
+
+  // The tensor ending at the top of the arena was placed above the tensors
+  // before it. Placing it first instead may let them fill the gaps below it.
+  std::set<int32_t> moved;
+  for (int i = 0; i < kMaxSearchIterations && peak_tensor >= 0 &&
+                  moved.insert(peak_tensor).second;
+       ++i) {
+    std::vector<int32_t> candidate = *order;
+    auto it = std::find(candidate.begin(), candidate.end(), peak_tensor);
+    std::rotate(candidate.begin(), it, it + 1);
+    size_t size;
+    int32_t candidate_peak_tensor;
+    TF_LITE_ENSURE_STATUS(
+        SimulateArenaSize(candidate, &size, &candidate_peak_tensor));
+    if (size < best_size) {
+      best_size = size;
+      peak_tensor = candidate_peak_tensor;
+      *order = std::move(candidate);
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus ArenaPlanner::CalculateAllocations(int first_node, int last_node) {
   // Indices of tensors in order their allocation offsets will be calculated.
-  const std::vector<int32_t> tensor_order =
-      CreateTensorAllocationVector(first_node, last_node);
+  // The search only runs when the whole plan is computed at once, since
+  // allocations made for earlier nodes stay where they are.
+  std::vector<int32_t> tensor_order;
+  if (strategy_ == MemoryPlanningStrategy::kSmallestArena && first_node == 0) {
+    TF_LITE_ENSURE_STATUS(
+        SearchTensorAllocationVector(first_node, last_node, &tensor_order));
+  } else {
+    tensor_order = CreateTensorAllocationVector(
+        first_node, last_node,
+        strategy_ == MemoryPlanningStrategy::kSmallestArena
+            ? MemoryPlanningStrategy::kGreedyBySize
+            : strategy_);
+  }
 
   // Deallocate if the tensor was already allocated.
   for (const auto& tensor_index : tensor_order) {
@@ -48,10 +48,13 @@ class ArenaPlanner : public MemoryPlanner {
   // Ownership of 'context' is not taken and it must remain util the
   // ArenaPlanner is destroyed. If 'preserve_inputs' is true the inputs to the
   // graph will not share memory with any other tensor, effectively preserving
-  // them until the end of inference.
+  // them until the end of inference. 'strategy' sets the order in which
+  // tensors are placed in the arena.
   ArenaPlanner(TfLiteContext* context, std::unique_ptr<GraphInfo> graph_info,
                bool preserve_inputs, bool preserve_intermediates,
-               int tensor_alignment);
+               int tensor_alignment,
+               MemoryPlanningStrategy strategy =
+                   MemoryPlanningStrategy::kGreedyBySize);
   ~ArenaPlanner() override;
   ArenaPlanner(const ArenaPlanner&) = delete;
   ArenaPlanner& operator=(const ArenaPlanner&) = delete;
@@ -63,6 +66,7 @@ class ArenaPlanner : public MemoryPlanner {
   TfLiteStatus ReleaseNonPersistentMemory() override;
   TfLiteStatus AcquireNonPersistentMemory() override;
   bool HasNonPersistentMemory() override;
+  size_t GetNonPersistentArenaSize() override;
 
   // Returns the base arena location for a given allocation type.
   std::intptr_t BasePointer(TfLiteAllocationType type);
@@ -77,10 +81,20 @@ class ArenaPlanner : public MemoryPlanner {
   // - Tensors that have lifespan through the whole model inference time go
   // first;
   // - Other tensors (e.g. intermediate and temporary ones) are sorted in
-  // non-increasing order of their size. If sizes of two tensors are equal, the
-  // one that needs to be allocated earlier goes first.
-  std::vector<int32_t> CreateTensorAllocationVector(int first_node,
-                                                    int last_node);
+  // non-increasing order of their size, or of their size times their lifetime
+  // for kGreedyBySizeTimesLifetime. If these are equal, the one that needs to
+  // be allocated earlier goes first.
+  std::vector<int32_t> CreateTensorAllocationVector(
+      int first_node, int last_node, MemoryPlanningStrategy strategy);
+
+  // Returns the tensor order found by the kSmallestArena search.
+  TfLiteStatus SearchTensorAllocationVector(int first_node, int last_node,
+                                            std::vector<int32_t>* order);
+
+  // Computes the arena size needed to place the kTfLiteArenaRw tensors of
+  // 'order' in that order, and the tensor that ends at that size.
+  TfLiteStatus SimulateArenaSize(const std::vector<int32_t>& order,
+                                 size_t* arena_size, int32_t* peak_tensor);
 
   // Traverse the allocation queue and reserve space in the appropriate arena
   // for all tensors affected by ops in the interval [first_node, last_node].
@@ -131,6 +145,8 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Number of bytes that tensor buffers should be aligned to.
   int tensor_alignment_;
+
+  MemoryPlanningStrategy strategy_;
 };
 
 }  // namespace tflite
@@ -165,12 +165,14 @@ void ReportError(TfLiteContext* context, const char* format, ...) {
 class ArenaPlannerTest : public ::testing::Test {
  protected:
   void SetGraph(TestGraph* graph, bool preserve_inputs = false,
-                bool preserve_intermediates = false) {
+                bool preserve_intermediates = false,
+                MemoryPlanningStrategy strategy =
+                    MemoryPlanningStrategy::kGreedyBySize) {
     graph_ = graph;
     context_.ReportError = ReportError;
     planner_.reset(new ArenaPlanner(
         &context_, std::unique_ptr<GraphInfo>(new TestGraphInfo(graph)),
-        preserve_inputs, preserve_intermediates, kTensorAlignment));
+        preserve_inputs, preserve_intermediates, kTensorAlignment, strategy));
     CHECK(planner_->ResetAllocations() == kTfLiteOk);
     CHECK(planner_->PlanAllocations() == kTfLiteOk);
   }
@@ -775,6 +777,60 @@ TEST_F(ArenaPlannerTest, DebugTensors) {
   EXPECT_EQ(tensorOffsets.size(), 8);
 }
 
+// Returns the arena size with which 'strategy' plans a graph where tensor 1 is
+// used by two nodes, with tensor sizes 'bytes'.
+size_t ArenaSizeWithStrategy(MemoryPlanningStrategy strategy,
+                             const std::vector<size_t>& bytes) {
+  TestGraph graph({0},
+                  {
+                      /* in, out, tmp */
+                      {{0}, {1}, {}},     // First op
+                      {{1}, {2}, {}},     // Second op
+                      {{1, 2}, {3}, {}},  // Third op
+                  },
+                  {3});
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    (*graph.tensors())[i].bytes = bytes[i];
+  }
+  TfLiteContext context;
+  context.ReportError = ReportError;
+  ArenaPlanner planner(&context,
+                       std::unique_ptr<GraphInfo>(new TestGraphInfo(&graph)),
+                       /*preserve_inputs=*/false,
+                       /*preserve_intermediates=*/false, kTensorAlignment,
+                       strategy);
+  CHECK(planner.ResetAllocations() == kTfLiteOk);
+  CHECK(planner.PlanAllocations() == kTfLiteOk);
+  CHECK(planner.ExecuteAllocations(0, 10) == kTfLiteOk);
+  return planner.GetNonPersistentArenaSize() - 2 * kDefaultArenaAlignment;
+}
+
+TEST(ArenaPlannerStrategyTest, GreedyBySizeTimesLifetime) {
+  // By size, the short-lived tensor 0 goes to the bottom of the arena and
+  // pushes the longer-lived tensor 1 above it.
+  const std::vector<size_t> bytes = {32, 24, 8, 28};
+  EXPECT_EQ(
+      ArenaSizeWithStrategy(MemoryPlanningStrategy::kGreedyBySize, bytes), 64);
+  EXPECT_EQ(ArenaSizeWithStrategy(
+                MemoryPlanningStrategy::kGreedyBySizeTimesLifetime, bytes),
+            60);
+  EXPECT_EQ(
+      ArenaSizeWithStrategy(MemoryPlanningStrategy::kSmallestArena, bytes), 60);
+}
+
+TEST(ArenaPlannerStrategyTest, SmallestArena) {
+  const std::vector<size_t> bytes = {32, 16, 28, 8};
+  EXPECT_EQ(
+      ArenaSizeWithStrategy(MemoryPlanningStrategy::kGreedyBySize, bytes), 56);
+  EXPECT_EQ(ArenaSizeWithStrategy(
+                MemoryPlanningStrategy::kGreedyBySizeTimesLifetime, bytes),
+            76);
+  // Moving tensor 3, which ends at the top of the arena by size, to the front
+  // of that order.
+  EXPECT_EQ(
+      ArenaSizeWithStrategy(MemoryPlanningStrategy::kSmallestArena, bytes), 52);
+}
+
 }  // namespace
 }  // namespace tflite
 
@@ -548,6 +548,23 @@ void Subgraph::SetCancellationFunction(void* data,
   check_cancelled_func_ = check_cancelled_func;
 }
 
+TfLiteStatus Subgraph::SetMemoryPlanningStrategy(
+    MemoryPlanningStrategy strategy) {
+  if (memory_planner_) {
+    ReportError(
+        "SetMemoryPlanningStrategy must be called before AllocateTensors.");
+    return kTfLiteError;
+  }
+  memory_planning_strategy_ = strategy;
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::SetUpperBoundAllocation(bool enabled) {
+  upper_bound_allocation_ = enabled;
+  if (!enabled) tensor_upper_bound_bytes_.clear();
+  return kTfLiteOk;
+}
+
 bool Subgraph::IsCancelled() {
   return (check_cancelled_func_ != nullptr) &&
          (*check_cancelled_func_)(cancellation_data_);
@@ -659,6 +676,21 @@ TfLiteStatus Subgraph::AllocateTensors() {
   // Restore delegation state if applicable.
   TF_LITE_ENSURE_STATUS(RedoAllDelegates());
 
+  // Inputs resized within their upper bounds only need the affected nodes to
+  // be prepared again; the memory plan stays valid.
+  if (!inputs_resized_within_bounds_.empty()) {
+    bool within_bounds = false;
+    if (state_ == kStateInvokable) {
+      TF_LITE_ENSURE_STATUS(PrepareWithinUpperBounds(&within_bounds));
+    }
+    inputs_resized_within_bounds_.clear();
+    if (within_bounds) {
+      ResetVariableTensors();
+      return kTfLiteOk;
+    }
+    state_ = kStateUninvokable;
+  }
+
   // Explicit (re)allocation is necessary if nodes have been changed or tensors
   // have been resized. For inputs marked as dynamic, we can't short-circuit the
   // allocation as the client may have done the resize manually.
@@ -685,6 +717,14 @@ TfLiteStatus Subgraph::AllocateTensors() {
 
   state_ = kStateInvokable;
 
+  tensor_upper_bound_bytes_.clear();
+  if (upper_bound_allocation_ && !has_dynamic_tensors_) {
+    tensor_upper_bound_bytes_.reserve(tensors_.size());
+    for (const TfLiteTensor& tensor : tensors_) {
+      tensor_upper_bound_bytes_.push_back(tensor.bytes);
+    }
+  }
+
   // Reset the variable tensors to zero after (re)allocating the tensors.
   // Developers shouldn't rely on the side effect of this function to reset
   // variable tensors. They should call `ResetVariableTensors` directly
@@ -816,6 +856,23 @@ TfLiteStatus Subgraph::ResizeInputTensor(int tensor_index,
     return kTfLiteOk;
   }
 
+  // Shrinking or growing an arena input within its upper bound keeps the
+  // memory plan, and thus its buffer, valid.
+  if (CanResizeWithinUpperBounds() &&
+      tensor->allocation_type == kTfLiteArenaRw &&
+      tensor->type != kTfLiteString && tensor->data.raw != nullptr) {
+    size_t bytes;
+    TF_LITE_ENSURE_OK(&context_, BytesRequired(tensor->type, dims.data(),
+                                               dims.size(), &bytes));
+    if (bytes <= tensor_upper_bound_bytes_[tensor_index]) {
+      TfLiteIntArrayFree(tensor->dims);
+      tensor->dims = ConvertVectorToTfLiteIntArray(dims);
+      tensor->bytes = bytes;
+      inputs_resized_within_bounds_.push_back(tensor_index);
+      return kTfLiteOk;
+    }
+  }
+
   if (graph_is_immutable) {
     // Undo delegation if it resulted in the graph being immutable.
     TF_LITE_ENSURE_STATUS(UndoAllDelegates());
@@ -918,7 +975,7 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
     memory_planner_.reset(new ArenaPlanner(
         &context_, std::unique_ptr<GraphInfo>(new InterpreterInfo(this)),
         /*preserve_inputs=*/true, /*preserve_intermediates*/ false,
-        kDefaultTensorAlignment));
+        kDefaultTensorAlignment, memory_planning_strategy_));
     memory_planner_->PlanAllocations();
   }
 
@@ -976,27 +1033,110 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   return kTfLiteOk;
 }
 
-TfLiteStatus Subgraph::Invoke() {
+bool Subgraph::CanResizeWithinUpperBounds() const {
+  if (state_ != kStateInvokable || tensor_upper_bound_bytes_.empty() ||
+      tensor_upper_bound_bytes_.size() != tensors_.size()) {
+    return false;
+  }
+  // Delegates that rely on propagated shapes need the original execution plan
+  // to be prepared as well.
+  for (const TfLiteDelegate* delegate : delegates_applied_) {
+    if (delegate->flags & kTfLiteDelegateFlagsRequirePropagatedShapes) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TfLiteStatus Subgraph::PrepareWithinUpperBounds(bool* within_bounds) {
+  *within_bounds = false;
+  if (memory_planner_ && !memory_planner_->HasNonPersistentMemory()) {
+    TF_LITE_ENSURE_STATUS(memory_planner_->AcquireNonPersistentMemory());
+  }
+
+  std::vector<bool> changed(tensors_.size(), false);
+  for (int tensor_index : inputs_resized_within_bounds_) {
+    changed[tensor_index] = true;
+  }
+  auto is_changed = [&changed](int tensor_index) {
+    return tensor_index >= 0 && tensor_index < changed.size() &&
+           changed[tensor_index];
+  };
+
+  preparing_within_upper_bounds_ = true;
+  upper_bound_exceeded_ = false;
+  for (int node_index : execution_plan_) {
+    TfLiteNode& node = nodes_and_registration_[node_index].first;
+    const TfLiteRegistration& registration =
+        nodes_and_registration_[node_index].second;
+    if (std::none_of(node.inputs->data, node.inputs->data + node.inputs->size,
+                     is_changed)) {
+      continue;
+    }
+
+    std::vector<std::vector<int>> output_dims(node.outputs->size);
+    for (int i = 0; i < node.outputs->size; ++i) {
+      const TfLiteTensor& output = tensors_[node.outputs->data[i]];
+      output_dims[i].assign(output.dims->data,
+                            output.dims->data + output.dims->size);
+    }
+
+    EnsureTensorsVectorCapacity();
+    if (OpPrepare(registration, &node) != kTfLiteOk) {
+      preparing_within_upper_bounds_ = false;
+      return ReportOpError(&context_, node, registration, node_index,
+                           "failed to prepare");
+    }
+    if (upper_bound_exceeded_ || HasDynamicTensor(context_, node.outputs) ||
+        tensors_.size() != tensor_upper_bound_bytes_.size()) {
+      preparing_within_upper_bounds_ = false;
+      return kTfLiteOk;
+    }
+
+    // Only the consumers of outputs whose shape changed are affected, as well
+    // as those of kTfLitePersistentRo outputs: their values are computed in
+    // Prepare (e.g. by SHAPE) and may have changed too.
+    for (int i = 0; i < node.outputs->size; ++i) {
+      const int output_index = node.outputs->data[i];
+      const TfLiteTensor& output = tensors_[output_index];
+      if (output.allocation_type == kTfLitePersistentRo ||
+          !EqualArrayAndTfLiteIntArray(output.dims, output_dims[i].size(),
+                                       output_dims[i].data())) {
+        changed[output_index] = true;
+      }
+    }
+  }
+  preparing_within_upper_bounds_ = false;
+  *within_bounds = true;
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::InvokeRange(int begin, int end) {
   if (!consistent_) {
     ReportError("Invoke called on model that is not consistent.");
     return kTfLiteError;
   }
 
   TfLiteStatus status = kTfLiteOk;
-  if (state_ == kStateUninvokable) {
+  if (state_ == kStateUninvokable || !inputs_resized_within_bounds_.empty()) {
     ReportError("Invoke called on model that is not ready.");
     return kTfLiteError;
   } else if (memory_planner_ && !memory_planner_->HasNonPersistentMemory()) {
     ReportError("Non-persistent memory is not available.");
     return kTfLiteError;
+  } else if (begin < 0 || begin > end ||
+             end > static_cast<int>(execution_plan_.size())) {
+    ReportError("Invalid execution plan range [%d, %d) of %d nodes.", begin,
+                end, static_cast<int>(execution_plan_.size()));
+    return kTfLiteError;
   }
 
   // Invocations are always done in node order.
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
   // called.
-  for (int execution_plan_index = 0;
-       execution_plan_index < execution_plan_.size(); execution_plan_index++) {
+  for (int execution_plan_index = begin; execution_plan_index < end;
+       execution_plan_index++) {
     if (execution_plan_index == next_execution_plan_index_to_prepare_) {
       TF_LITE_ENSURE_STATUS(PrepareOpsAndTensors());
       TF_LITE_ENSURE(&context_, next_execution_plan_index_to_prepare_ >=
@@ -1313,10 +1453,21 @@ TfLiteStatus Subgraph::ResizeTensorImpl(TfLiteTensor* tensor,
     if (tensor->dims) TfLiteIntArrayFree(tensor->dims);
     tensor->dims = new_size;
 
-    // Reset arena-allocated tensors; they will be allocated later.
+    // Reset arena-allocated tensors; they will be allocated later. While
+    // preparing within upper bounds, tensors that still fit keep their buffer.
     if (tensor->allocation_type == kTfLiteArenaRw ||
         tensor->allocation_type == kTfLiteArenaRwPersistent) {
-      tensor->data.raw = nullptr;
+      bool fits_upper_bound = false;
+      if (preparing_within_upper_bounds_ && tensor->data.raw != nullptr) {
+        const size_t tensor_index = tensor - tensors_.data();
+        fits_upper_bound =
+            tensor_index < tensor_upper_bound_bytes_.size() &&
+            tensor->bytes <= tensor_upper_bound_bytes_[tensor_index];
+      }
+      if (!fits_upper_bound) {
+        upper_bound_exceeded_ |= preparing_within_upper_bounds_;
+        tensor->data.raw = nullptr;
+      }
     }
   } else {
     // kTfLiteMmapRo tensors are stored in the flatbuffer and are therefore
@@ -232,7 +232,16 @@ class Subgraph {
   // to evaluate (i.e. if a ResizeTensor() has been performed without an
   // AllocateTensors().
   // Returns status of success or failure.
-  TfLiteStatus Invoke();
+  TfLiteStatus Invoke() {
+    return InvokeRange(0, static_cast<int>(execution_plan_.size()));
+  }
+
+  // Invoke the nodes at execution plan indices [`begin`, `end`) only. Running
+  // consecutive ranges that cover the execution plan in order is equivalent to
+  // Invoke(); this lets callers interleave other work between parts of a
+  // graph, e.g. between the nodes replaced by a delegate and the others.
+  // Returns status of success or failure.
+  TfLiteStatus InvokeRange(int begin, int end);
 
   // Entry point for C node plugin API to report an error.
   void ReportError(const char* format, ...);
@@ -337,6 +346,29 @@ class Subgraph {
   TfLiteStatus SetCustomAllocationForTensor(
       int tensor_index, const TfLiteCustomAllocation& allocation);
 
+  // Sets the order in which the memory planner places tensors in the arena.
+  // Must be called before the first AllocateTensors().
+  // WARNING: This is an experimental interface that is subject to change.
+  TfLiteStatus SetMemoryPlanningStrategy(MemoryPlanningStrategy strategy);
+
+  // Enables or disables upper-bound allocation. When enabled, every full
+  // AllocateTensors() records the allocated size of each tensor as its upper
+  // bound, so inputs should first be resized to their largest expected shapes.
+  // Later ResizeInputTensor() calls that keep the inputs within their bounds
+  // don't invalidate the memory plan: the following AllocateTensors() only
+  // re-runs Prepare on the nodes whose input shapes changed, and keeps every
+  // tensor at its planned offset in the arena. If any tensor outgrows its
+  // bound, it falls back to a full re-planning that records new bounds.
+  // WARNING: This is an experimental interface that is subject to change.
+  TfLiteStatus SetUpperBoundAllocation(bool enabled);
+
+  // Returns the number of bytes of the arena for non-persistent tensors, or 0
+  // before AllocateTensors().
+  // WARNING: This is an experimental interface that is subject to change.
+  size_t GetArenaSize() {
+    return memory_planner_ ? memory_planner_->GetNonPersistentArenaSize() : 0;
+  }
+
  private:
   // SubgraphAwareProfiler wraps an actual TFLite profiler, such as a
   // BufferedProfiler instance, and takes care of event profiling/tracing in a
@@ -427,6 +459,16 @@ class Subgraph {
                                     const std::vector<int>& execution_plan,
                                     int* last_execution_plan_index_prepared);
 
+  // Returns true if inputs can currently be resized within the upper bounds
+  // recorded by the last full AllocateTensors().
+  bool CanResizeWithinUpperBounds() const;
+
+  // Re-runs OpPrepare() on the nodes affected by the inputs resized within
+  // their upper bounds, keeping the current arena allocations. Sets
+  // 'within_bounds' to false if a tensor outgrew its upper bound or became
+  // dynamic, in which case a full re-planning is needed.
+  TfLiteStatus PrepareWithinUpperBounds(bool* within_bounds);
+
   // Tensors needed by the interpreter. Use `AddTensors` to add more blank
   // tensor entries. Note, `tensors_.data()` needs to be synchronized to the
   // `context_` whenever this std::vector is reallocated. Currently this
@@ -693,6 +735,8 @@ class Subgraph {
   std::vector<TfLiteDelegateParams> partitioning_preview_cache_;
 
   std::unique_ptr<MemoryPlanner> memory_planner_;
+  MemoryPlanningStrategy memory_planning_strategy_ =
+      MemoryPlanningStrategy::kGreedyBySize;
 
   // Contains <tensor idx, custom allocation> pairs for all applicable tensors.
   std::vector<std::pair<int, TfLiteCustomAllocation>> custom_allocations_;
@@ -714,6 +758,24 @@ class Subgraph {
   // The value is invalid before `PrepareOpStartingAt` is called.
   bool has_dynamic_tensors_ = true;
 
+  // Whether upper-bound allocation is enabled (see SetUpperBoundAllocation()).
+  bool upper_bound_allocation_ = false;
+
+  // The bytes allocated for every tensor by the last full AllocateTensors(),
+  // or empty if the upper bounds are not valid.
+  std::vector<size_t> tensor_upper_bound_bytes_;
+
+  // Inputs resized within their upper bounds since the last AllocateTensors().
+  // While non-empty, the subgraph keeps its state but can't be invoked.
+  std::vector<int> inputs_resized_within_bounds_;
+
+  // True while PrepareWithinUpperBounds() runs. Arena tensors resized in the
+  // meantime keep their buffers if they fit their upper bounds.
+  bool preparing_within_upper_bounds_ = false;
+
+  // Set if a tensor outgrew its upper bound during PrepareWithinUpperBounds().
+  bool upper_bound_exceeded_ = false;
+
   // Reference to cancellation function that can cancel a request in the middle
   // of a call to Invoke(). When this function returns True, a kTfLiteError is
   // thrown by Invoke().
@@ -824,6 +824,7 @@ class InferenceEnvironmentImpl : public InferenceEnvironment {
     } else {
       RETURN_IF_ERROR(CreateDefaultGPUDevice(&device));
     }
+    properties_.platform_version = device.GetPlatformVersion();
 
 #ifdef CL_DELEGATE_ALLOW_GL
     properties_.is_gl_sharing_supported = IsGlSharingSupported(device);
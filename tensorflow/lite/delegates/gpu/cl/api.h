@@ -24,6 +24,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <string>
 
 #include "absl/types/span.h"
 #include "tensorflow/lite/delegates/gpu/api.h"
@@ -67,6 +68,11 @@ struct InferenceEnvironmentProperties {
 
   // Indicates whether fast CL->GL synchronization is supported.
   bool is_cl_to_gl_fast_sync_supported = false;
+
+  // OpenCL platform version of the device, which includes the driver version.
+  // Serialized models are only valid for the platform version they were built
+  // with.
+  std::string platform_version;
 };
 
 // Environment manages all resources that need to stay until any inference is
@@ -16,12 +16,19 @@ limitations under the License.
 #include "tensorflow/lite/delegates/gpu/delegate.h"
 
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "tensorflow/lite/builtin_ops.h"
 #include "tensorflow/lite/c/common.h"
@@ -40,6 +47,7 @@ limitations under the License.
 #ifndef CL_DELEGATE_NO_GL
 #include "tensorflow/lite/delegates/gpu/gl/api2.h"
 #endif
+#include <farmhash.h>
 
 namespace tflite {
 namespace gpu {
@@ -69,6 +77,90 @@ InferenceUsage ToUsage(int32_t usage) {
   return InferenceUsage::UNKNOWN;
 }
 
+// Serialized OpenCL state of one delegated partition: the inference context,
+// which holds the generated kernels and their tuned workgroup sizes, and the
+// compiled program binaries.
+struct SerializedPartition {
+  uint64_t platform_version_fingerprint = 0;
+  std::vector<uint8_t> model;
+  std::vector<uint8_t> binary_cache;
+};
+
+constexpr char kSerializedPartitionMagic[4] = {'T', 'G', 'C', 'S'};
+
+void AppendBytes(const void* data, size_t size, std::string* out) {
+  out->append(static_cast<const char*>(data), size);
+}
+
+void AppendBlob(const std::vector<uint8_t>& blob, std::string* out) {
+  const uint64_t size = blob.size();
+  AppendBytes(&size, sizeof(size), out);
+  AppendBytes(blob.data(), blob.size(), out);
+}
+
+bool ReadBlob(absl::string_view* in, std::vector<uint8_t>* blob) {
+  uint64_t size;
+  if (in->size() < sizeof(size)) return false;
+  std::memcpy(&size, in->data(), sizeof(size));
+  in->remove_prefix(sizeof(size));
+  if (in->size() < size) return false;
+  blob->assign(in->data(), in->data() + size);
+  in->remove_prefix(size);
+  return true;
+}
+
+// Returns false if `path` is missing or does not hold a serialized partition.
+bool ReadSerializedPartition(const std::string& path,
+                             SerializedPartition* partition) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return false;
+  const std::string contents((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+  absl::string_view in(contents);
+  if (in.size() < sizeof(kSerializedPartitionMagic) +
+                      sizeof(partition->platform_version_fingerprint) ||
+      std::memcmp(in.data(), kSerializedPartitionMagic,
+                  sizeof(kSerializedPartitionMagic)) != 0) {
+    return false;
+  }
+  in.remove_prefix(sizeof(kSerializedPartitionMagic));
+  std::memcpy(&partition->platform_version_fingerprint, in.data(),
+              sizeof(partition->platform_version_fingerprint));
+  in.remove_prefix(sizeof(partition->platform_version_fingerprint));
+  return ReadBlob(&in, &partition->model) &&
+         ReadBlob(&in, &partition->binary_cache) && in.empty();
+}
+
+absl::Status WriteSerializedPartition(const std::string& path,
+                                      const SerializedPartition& partition) {
+  std::string contents;
+  AppendBytes(kSerializedPartitionMagic, sizeof(kSerializedPartitionMagic),
+              &contents);
+  AppendBytes(&partition.platform_version_fingerprint,
+              sizeof(partition.platform_version_fingerprint), &contents);
+  AppendBlob(partition.model, &contents);
+  AppendBlob(partition.binary_cache, &contents);
+
+  // Write to a temporary file first so that a concurrent or interrupted run
+  // never leaves a truncated file behind.
+  const std::string temp_path = path + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+    if (!file) {
+      std::remove(temp_path.c_str());
+      return absl::UnavailableError(
+          absl::StrCat("Failed to write serialized GPU model to ", temp_path));
+    }
+  }
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return absl::UnavailableError(
+        absl::StrCat("Failed to write serialized GPU model to ", path));
+  }
+  return absl::OkStatus();
+}
+
 // Forward declarations.
 TfLiteStatus DelegatePrepare(TfLiteContext* context, TfLiteDelegate* delegate);
 
@@ -80,6 +172,14 @@ class Delegate {
     if (options_.max_delegated_partitions <= 0) {
       options_.max_delegated_partitions = 1;
     }
+    if (options_.serialization_dir != nullptr &&
+        options_.model_token != nullptr) {
+      serialization_dir_ = options_.serialization_dir;
+      model_token_ = options_.model_token;
+    }
+    // The strings are owned by the delegate from now on.
+    options_.serialization_dir = nullptr;
+    options_.model_token = nullptr;
   }
 
   TfLiteDelegate* tflite_delegate() { return &delegate_; }
@@ -94,6 +194,25 @@ class Delegate {
   }
   int num_delegate_kernels() const { return num_delegate_kernels_; }
 
+  bool IsSerializationEnabled() const { return !serialization_dir_.empty(); }
+
+  // Returns the file storing the serialized partition replacing
+  // `delegate_params`, for the given OpenCL inference options.
+  std::string SerializedPartitionPath(
+      const TfLiteDelegateParams* delegate_params,
+      const cl::InferenceOptions& options) const {
+    std::string key = absl::StrCat(
+        static_cast<int>(options.usage), ",",
+        static_cast<int>(options.priority1), ",",
+        static_cast<int>(options.priority2), ",",
+        static_cast<int>(options.priority3), ",", options_.experimental_flags);
+    for (int i = 0; i < delegate_params->nodes_to_replace->size; ++i) {
+      absl::StrAppend(&key, ",", delegate_params->nodes_to_replace->data[i]);
+    }
+    return absl::StrCat(serialization_dir_, "/", model_token_, "_",
+                        absl::Hex(::util::Fingerprint64(key)), ".gpu_cl");
+  }
+
  private:
   TfLiteDelegate delegate_ = {
       .data_ = reinterpret_cast<void*>(this),
@@ -106,6 +225,9 @@ class Delegate {
 
   TfLiteGpuDelegateOptionsV2 options_;
   int num_delegate_kernels_ = 0;
+  // Set only when serialization is enabled.
+  std::string serialization_dir_;
+  std::string model_token_;
 
   friend class DelegateKernel;
 };
@@ -134,14 +256,16 @@ class DelegateKernel {
     bool graph_is_destroyed;
     const int experimental_flags = delegate_->options().experimental_flags;
     if (experimental_flags & TFLITE_GPU_EXPERIMENTAL_FLAGS_CL_ONLY) {
-      RETURN_IF_ERROR(
-          InitializeOpenClApi(&graph, &builder, &graph_is_destroyed));
+      RETURN_IF_ERROR(InitializeOpenClApi(delegate_params, &graph, &builder,
+                                          &graph_is_destroyed, &input_refs,
+                                          &output_refs));
     } else if (experimental_flags & TFLITE_GPU_EXPERIMENTAL_FLAGS_GL_ONLY) {
       RETURN_IF_ERROR(InitializeOpenGlApi(&graph, &builder));
     } else {
       // By default, we try CL first & fall back to GL if that fails.
       absl::Status status =
-          InitializeOpenClApi(&graph, &builder, &graph_is_destroyed);
+          InitializeOpenClApi(delegate_params, &graph, &builder,
+                              &graph_is_destroyed, &input_refs, &output_refs);
       if (!status.ok()) {
         TF_LITE_KERNEL_LOG(context, std::string(status.message()).c_str());
         TF_LITE_KERNEL_LOG(context, "Falling back to OpenGL");
@@ -283,14 +407,16 @@ class DelegateKernel {
     return absl::OkStatus();
   }
 
-  absl::Status InitializeOpenClApi(GraphFloat32* graph,
+  // When serialization is enabled and a partition serialized for this device
+  // exists, `input_refs` and `output_refs` are replaced by the ones stored with
+  // it and `graph` is left unused.
+  absl::Status InitializeOpenClApi(const TfLiteDelegateParams* delegate_params,
+                                   GraphFloat32* graph,
                                    std::unique_ptr<InferenceBuilder>* builder,
-                                   bool* graph_is_destroyed) {
+                                   bool* graph_is_destroyed,
+                                   std::vector<uint32_t>* input_refs,
+                                   std::vector<uint32_t>* output_refs) {
     *graph_is_destroyed = false;
-    cl::InferenceEnvironmentOptions env_options;
-    cl::InferenceEnvironmentProperties properties;
-    RETURN_IF_ERROR(cl::NewInferenceEnvironment(env_options, &cl_environment_,
-                                                &properties));
     auto delegate_options = delegate_->options();
     cl::InferenceOptions options;
     // If is_precision_loss_allowed == -1, then just use priorities instead
@@ -308,14 +434,93 @@ class DelegateKernel {
       }
     }
     options.usage = ToUsage(delegate_options.inference_preference);
-    *graph_is_destroyed = true;
-    RETURN_IF_ERROR(cl_environment_->NewInferenceBuilder(
-        options, std::move(*graph), builder));
+
+    if (!delegate_->IsSerializationEnabled()) {
+      cl::InferenceEnvironmentOptions env_options;
+      cl::InferenceEnvironmentProperties properties;
+      RETURN_IF_ERROR(cl::NewInferenceEnvironment(
+          env_options, &cl_environment_, &properties));
+      *graph_is_destroyed = true;
+      RETURN_IF_ERROR(cl_environment_->NewInferenceBuilder(
+          options, std::move(*graph), builder));
+    } else {
+      RETURN_IF_ERROR(InitializeSerializedOpenClApi(
+          delegate_params, options, graph, builder, graph_is_destroyed,
+          input_refs, output_refs));
+    }
     TFLITE_LOG_PROD_ONCE(tflite::TFLITE_LOG_INFO,
                          "Initialized OpenCL-based API.");
     return absl::OkStatus();
   }
 
+  absl::Status InitializeSerializedOpenClApi(
+      const TfLiteDelegateParams* delegate_params,
+      const cl::InferenceOptions& options, GraphFloat32* graph,
+      std::unique_ptr<InferenceBuilder>* builder, bool* graph_is_destroyed,
+      std::vector<uint32_t>* input_refs, std::vector<uint32_t>* output_refs) {
+    const std::string path =
+        delegate_->SerializedPartitionPath(delegate_params, options);
+    SerializedPartition partition;
+    const bool has_partition = ReadSerializedPartition(path, &partition);
+
+    // Invalid or outdated program binaries are discarded by the environment.
+    cl::InferenceEnvironmentOptions env_options;
+    if (has_partition) {
+      env_options.serialized_binary_cache =
+          absl::MakeConstSpan(partition.binary_cache);
+    }
+    cl::InferenceEnvironmentProperties properties;
+    RETURN_IF_ERROR(cl::NewInferenceEnvironment(env_options, &cl_environment_,
+                                                &properties));
+    const uint64_t platform_version_fingerprint =
+        ::util::Fingerprint64(properties.platform_version);
+
+    if (has_partition &&
+        partition.platform_version_fingerprint ==
+            platform_version_fingerprint) {
+      const absl::Status status = NewSerializedInferenceBuilder(
+          partition.model, builder, input_refs, output_refs);
+      if (status.ok()) {
+        TFLITE_LOG_PROD(tflite::TFLITE_LOG_INFO,
+                        "Loaded serialized GPU model from %s.", path.c_str());
+        return absl::OkStatus();
+      }
+      TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                      "Ignoring serialized GPU model %s: %s", path.c_str(),
+                      std::string(status.message()).c_str());
+    }
+
+    // Compile and tune the graph once, then restore it from the serialized
+    // form, which reuses the programs compiled in the environment.
+    partition.platform_version_fingerprint = platform_version_fingerprint;
+    *graph_is_destroyed = true;
+    RETURN_IF_ERROR(cl_environment_->BuildSerializedModel(
+        options, std::move(*graph), &partition.model));
+    RETURN_IF_ERROR(NewSerializedInferenceBuilder(partition.model, builder,
+                                                  input_refs, output_refs));
+    partition.binary_cache = cl_environment_->GetSerializedBinaryCache();
+    const absl::Status status = WriteSerializedPartition(path, partition);
+    if (!status.ok()) {
+      // Serialization only speeds up later runs; this one can go on.
+      TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING, "%s",
+                      std::string(status.message()).c_str());
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status NewSerializedInferenceBuilder(
+      const std::vector<uint8_t>& serialized_model,
+      std::unique_ptr<InferenceBuilder>* builder,
+      std::vector<uint32_t>* input_refs, std::vector<uint32_t>* output_refs) {
+    std::vector<int64_t> in_refs;
+    std::vector<int64_t> out_refs;
+    RETURN_IF_ERROR(cl_environment_->NewInferenceBuilder(
+        serialized_model, builder, &in_refs, &out_refs));
+    input_refs->assign(in_refs.begin(), in_refs.end());
+    output_refs->assign(out_refs.begin(), out_refs.end());
+    return absl::OkStatus();
+  }
+
   absl::Status InitializeOpenGlApi(GraphFloat32* graph,
                                    std::unique_ptr<InferenceBuilder>* builder) {
 #ifndef CL_DELEGATE_NO_GL
@@ -450,6 +655,8 @@ TfLiteGpuDelegateOptionsV2 TfLiteGpuDelegateOptionsV2Default() {
       .inference_priority3 = TFLITE_GPU_INFERENCE_PRIORITY_AUTO,
       .experimental_flags = TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_QUANT,
       .max_delegated_partitions = 1,
+      .serialization_dir = nullptr,
+      .model_token = nullptr,
   };
   return options;
 }
@@ -101,6 +101,20 @@ typedef struct {
   // This limits the maximum number of partitions to be delegated. By default,
   // it's set to 1 in TfLiteGpuDelegateOptionsV2Default().
   int32_t max_delegated_partitions;
+
+  // Directory in which the delegate stores the compiled OpenCL programs and
+  // the tuned workgroup sizes of every delegated partition. A later delegate
+  // created with the same directory and model token loads them instead of
+  // compiling and tuning again, which takes most of the initialization time.
+  // The directory must exist and should be private to the application.
+  // Only the OpenCL backend supports serialization.
+  const char* serialization_dir;
+
+  // Token that uniquely identifies the model, e.g. a fingerprint of the model
+  // file. Serialization is enabled only when both `serialization_dir` and
+  // `model_token` are set. Both strings are copied when the delegate is
+  // created.
+  const char* model_token;
 } TfLiteGpuDelegateOptionsV2;
 
 // Populates TfLiteGpuDelegateOptionsV2 as follows:
@@ -111,6 +125,8 @@ typedef struct {
 //   priority3 = TFLITE_GPU_INFERENCE_PRIORITY_AUTO
 //   experimental_flags = TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_QUANT
 //   max_delegated_partitions = 1
+//   serialization_dir = nullptr
+//   model_token = nullptr
 TFL_CAPI_EXPORT TfLiteGpuDelegateOptionsV2 TfLiteGpuDelegateOptionsV2Default();
 
 // Creates a new delegate instance that need to be destroyed with
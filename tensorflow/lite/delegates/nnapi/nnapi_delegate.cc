@@ -519,6 +519,16 @@ uint64_t GetHash(const TfLiteIntArray* int_array, uint64_t combine_with = 0) {
   return result;
 }
 
+// 64-bit FNV-1a hash of a nul-terminated string. Unlike std::hash, it is
+// stable across program invocations, as required by compilation caching.
+uint64_t GetHash(const char* str) {
+  uint64_t result = 0xcbf29ce484222325ULL;
+  for (; *str != '\0'; ++str) {
+    result = (result ^ static_cast<uint8_t>(*str)) * 0x100000001b3ULL;
+  }
+  return result;
+}
+
 bool HasZeroes(TfLiteIntArrayView array) {
   for (auto value : array) {
     if (value == 0) {
@@ -3657,9 +3667,7 @@ TfLiteStatus NNAPIDelegateKernel::Init(TfLiteContext* context,
     // TODO(b/133342794): use a generic token generator class.
     uint64_t token_parts[4];
     // Create bits from model_token.
-    // TODO(b/172237993): should not use std::hash, as that is not
-    // guaranteed to be stable across program invocations.
-    token_parts[0] = std::hash<std::string>{}(model_token);
+    token_parts[0] = GetHash(model_token);
     // Create bits from params->nodes_to_replace.
     token_parts[1] = GetHash(params->nodes_to_replace);
     // Create bits from params->input_tensors. These include the input tensor
@@ -4825,6 +4833,7 @@ StatefulNnApiDelegate::StatefulNnApiDelegate(const NnApi* nnapi,
   delegate_data_.disallow_nnapi_cpu = options.disallow_nnapi_cpu;
   delegate_data_.max_number_delegated_partitions =
       options.max_number_delegated_partitions;
+  delegate_data_.min_nodes_per_partition = options.min_nodes_per_partition;
   delegate_data_.allow_fp16 = options.allow_fp16;
   delegate_data_.execution_priority = options.execution_priority;
   delegate_data_.max_compilation_timeout_duration_ns =
@@ -4869,6 +4878,7 @@ const StatefulNnApiDelegate::Options StatefulNnApiDelegate::GetOptions(
   options.disallow_nnapi_cpu = delegate_data->disallow_nnapi_cpu;
   options.max_number_delegated_partitions =
       delegate_data->max_number_delegated_partitions;
+  options.min_nodes_per_partition = delegate_data->min_nodes_per_partition;
   options.allow_fp16 = delegate_data->allow_fp16;
   options.execution_priority = delegate_data->execution_priority;
   options.max_compilation_timeout_duration_ns =
@@ -5035,6 +5045,36 @@ TfLiteStatus StatefulNnApiDelegate::LimitDelegatedPartitions(
   return kTfLiteOk;
 }
 
+// static
+TfLiteStatus StatefulNnApiDelegate::DropSmallPartitions(
+    int min_nodes, std::vector<TfLiteDelegateParams>* partition_params_array,
+    std::vector<int>* nodes_to_delegate) {
+  if (min_nodes <= 1) {
+    return kTfLiteOk;
+  }
+
+  std::vector<int> kept_nodes;
+  auto is_small_or_not_delegated =
+      [min_nodes, nodes_to_delegate](const TfLiteDelegateParams& params) {
+        return params.nodes_to_replace->size < min_nodes ||
+               std::find(nodes_to_delegate->begin(), nodes_to_delegate->end(),
+                         params.nodes_to_replace->data[0]) ==
+                   nodes_to_delegate->end();
+      };
+  partition_params_array->erase(
+      std::remove_if(partition_params_array->begin(),
+                     partition_params_array->end(), is_small_or_not_delegated),
+      partition_params_array->end());
+  for (const TfLiteDelegateParams& params : *partition_params_array) {
+    kept_nodes.insert(kept_nodes.end(), params.nodes_to_replace->data,
+                      params.nodes_to_replace->data +
+                          params.nodes_to_replace->size);
+  }
+  *nodes_to_delegate = std::move(kept_nodes);
+
+  return kTfLiteOk;
+}
+
 TfLiteStatus StatefulNnApiDelegate::DoPrepare(TfLiteContext* context,
                                               TfLiteDelegate* delegate) {
   auto* delegate_data = static_cast<Data*>(delegate->data_);
@@ -5183,11 +5223,14 @@ TfLiteStatus StatefulNnApiDelegate::DoPrepare(TfLiteContext* context,
         &num_partitions));
   }
 
+  std::vector<TfLiteDelegateParams> partition_params_array(
+      params_array, params_array + num_partitions);
+  TF_LITE_ENSURE_STATUS(
+      DropSmallPartitions(delegate_options.min_nodes_per_partition,
+                          &partition_params_array, &nodes_to_delegate));
   TF_LITE_ENSURE_STATUS(
       LimitDelegatedPartitions(delegate_options.max_number_delegated_partitions,
-                               std::vector<TfLiteDelegateParams>(
-                                   params_array, params_array + num_partitions),
-                               &nodes_to_delegate));
+                               partition_params_array, &nodes_to_delegate));
 
   if (nodes_to_delegate.empty()) {
     return kTfLiteOk;
@@ -90,6 +90,14 @@ class StatefulNnApiDelegate : public TfLiteDelegate {
     // of number of nodes and selecting them until the limit is reached.
     int max_number_delegated_partitions = 3;
 
+    // Specifies the min number of nodes of a partition to delegate. A value
+    // <= 1 means no limit.
+    // Running a partition on NNAPI costs the copies of its inputs and outputs
+    // between TfLite and NNAPI, which a partition of a few cheap nodes does not
+    // make up for. Smaller partitions are left to the TfLite kernels, and are
+    // not counted against <max_number_delegated_partitions>.
+    int min_nodes_per_partition = 0;
+
     // allow fp32 compuation to be run in fp16.
     bool allow_fp16 = false;
 
@@ -220,6 +228,9 @@ class StatefulNnApiDelegate : public TfLiteDelegate {
     // Maximum number of NNAPI partition to delegate. Zero or negative means
     // no limit. Copied from StatefulNnApiDelegate::Options
     int max_number_delegated_partitions;
+    // Minimum number of nodes of a delegated NNAPI partition. Copied from
+    // StatefulNnApiDelegate::Options
+    int min_nodes_per_partition;
     // allow fp32 computation to be run in fp16.
     bool allow_fp16;
     // Specifies the relative priority for executions of the model.
@@ -304,6 +315,13 @@ class StatefulNnApiDelegate : public TfLiteDelegate {
       std::vector<TfLiteDelegateParams> partition_params_array,
       std::vector<int>* nodes_to_delegate);
 
+  // Removes from nodes_to_delegate and partition_params_array the partitions
+  // with fewer than min_nodes nodes, as well as the partitions whose nodes are
+  // not in nodes_to_delegate. A min_nodes <= 1 leaves both unchanged.
+  static TfLiteStatus DropSmallPartitions(
+      int min_nodes, std::vector<TfLiteDelegateParams>* partition_params_array,
+      std::vector<int>* nodes_to_delegate);
+
   // Delegate data presented through TfLiteDelegate::data_.
   Data delegate_data_;
 };
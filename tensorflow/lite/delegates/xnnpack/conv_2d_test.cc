@@ -17,6 +17,7 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <random>
+#include <string>
 
 #include <gtest/gtest.h>
 #include "tensorflow/lite/delegates/xnnpack/conv_2d_tester.h"
@@ -580,5 +581,103 @@ TEST(Conv2D, MultiThreading) {
       .Test(xnnpack_delegate.get());
 }
 
+TEST(Conv2D, WeightsCache) {
+  std::unique_ptr<TfLiteXNNPackDelegateWeightsCache,
+                  decltype(&TfLiteXNNPackDelegateWeightsCacheDelete)>
+      weights_cache(TfLiteXNNPackDelegateWeightsCacheCreate(),
+                    TfLiteXNNPackDelegateWeightsCacheDelete);
+  TfLiteXNNPackDelegateOptions delegate_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  delegate_options.weights_cache = weights_cache.get();
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate(TfLiteXNNPackDelegateCreate(&delegate_options),
+                       TfLiteXNNPackDelegateDelete);
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      other_xnnpack_delegate(TfLiteXNNPackDelegateCreate(&delegate_options),
+                             TfLiteXNNPackDelegateDelete);
+
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto batch_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 4), std::ref(rng));
+  auto input_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(10, 25), std::ref(rng));
+  auto kernel_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(3, 5), std::ref(rng));
+  auto stride_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 3), std::ref(rng));
+  auto channel_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(1, 16), std::ref(rng));
+
+  Conv2DTester tester;
+  tester.BatchSize(batch_rng())
+      .InputHeight(input_rng())
+      .InputWidth(input_rng())
+      .InputChannels(channel_rng())
+      .OutputChannels(channel_rng())
+      .KernelHeight(kernel_rng())
+      .KernelWidth(kernel_rng())
+      .StrideHeight(stride_rng())
+      .StrideWidth(stride_rng())
+      .SparseWeights()
+      .FP16Weights();
+  tester.Test(xnnpack_delegate.get());
+  tester.Test(other_xnnpack_delegate.get());
+}
+
+TEST(Conv2D, WeightsCacheFile) {
+  const std::string path =
+      ::testing::TempDir() + "/conv_2d_test_weights_cache.bin";
+  TfLiteXNNPackDelegateOptions delegate_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+
+  Conv2DTester tester;
+  tester.BatchSize(2)
+      .InputHeight(12)
+      .InputWidth(12)
+      .InputChannels(5)
+      .OutputChannels(7)
+      .KernelHeight(3)
+      .KernelWidth(3)
+      .SparseWeights()
+      .FP16Weights();
+
+  {
+    std::unique_ptr<TfLiteXNNPackDelegateWeightsCache,
+                    decltype(&TfLiteXNNPackDelegateWeightsCacheDelete)>
+        weights_cache(TfLiteXNNPackDelegateWeightsCacheCreate(),
+                      TfLiteXNNPackDelegateWeightsCacheDelete);
+    EXPECT_NE(TfLiteXNNPackDelegateWeightsCacheLoad(
+                  weights_cache.get(), (path + ".missing").c_str()),
+              kTfLiteOk);
+    delegate_options.weights_cache = weights_cache.get();
+    std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+        xnnpack_delegate(TfLiteXNNPackDelegateCreate(&delegate_options),
+                         TfLiteXNNPackDelegateDelete);
+    tester.Test(xnnpack_delegate.get());
+    ASSERT_EQ(TfLiteXNNPackDelegateWeightsCacheSave(weights_cache.get(),
+                                                    path.c_str()),
+              kTfLiteOk);
+  }
+
+  // A cache restored from the file can be used by new delegates and saved
+  // again.
+  std::unique_ptr<TfLiteXNNPackDelegateWeightsCache,
+                  decltype(&TfLiteXNNPackDelegateWeightsCacheDelete)>
+      weights_cache(TfLiteXNNPackDelegateWeightsCacheCreate(),
+                    TfLiteXNNPackDelegateWeightsCacheDelete);
+  ASSERT_EQ(
+      TfLiteXNNPackDelegateWeightsCacheLoad(weights_cache.get(), path.c_str()),
+      kTfLiteOk);
+  delegate_options.weights_cache = weights_cache.get();
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate(TfLiteXNNPackDelegateCreate(&delegate_options),
+                       TfLiteXNNPackDelegateDelete);
+  tester.Test(xnnpack_delegate.get());
+  EXPECT_EQ(
+      TfLiteXNNPackDelegateWeightsCacheSave(weights_cache.get(), path.c_str()),
+      kTfLiteOk);
+}
+
 }  // namespace xnnpack
 }  // namespace tflite
@@ -18,10 +18,14 @@ limitations under the License.
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -29,16 +33,69 @@ limitations under the License.
 
 #include <fp16.h>
 #include <xnnpack.h>
+#include "tensorflow/lite/allocation.h"
 #include "tensorflow/lite/builtin_ops.h"
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/minimal_logging.h"
+#include "tensorflow/lite/stderr_reporter.h"
 #include "tensorflow/lite/tools/optimize/sparsity/format_converter.h"
 
+struct TfLiteXNNPackDelegateWeightsCache {
+  // Unpacked weights are identified by the op unpacking them, the address,
+  // size and content hash of their source data, and their unpacked size. The
+  // hash guards against the source buffer being freed and reused.
+  using Key = std::tuple<int, const void*, size_t, uint64_t, size_t>;
+  // Weights stored in a cache file cannot be identified by the address of
+  // their source data, which changes from one process to the next.
+  using FileKey = std::tuple<int, size_t, uint64_t, size_t>;
+
+  static FileKey ToFileKey(const Key& key) {
+    return FileKey(std::get<0>(key), std::get<2>(key), std::get<3>(key),
+                   std::get<4>(key));
+  }
+
+  std::shared_ptr<char> Lookup(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = buffers.find(key);
+    if (it != buffers.end()) return it->second;
+    const auto file_it = file_buffers.find(ToFileKey(key));
+    if (file_it == file_buffers.end()) return nullptr;
+    buffers.emplace(key, file_it->second);
+    return file_it->second;
+  }
+
+  // Inserts "buffer" unless the key is already present, and returns the
+  // cached buffer.
+  std::shared_ptr<char> Insert(const Key& key, std::shared_ptr<char> buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffers.emplace(key, std::move(buffer)).first->second;
+  }
+
+  TfLiteStatus Load(const char* path);
+  TfLiteStatus Save(const char* path);
+
+  std::mutex mutex;
+  std::map<Key, std::shared_ptr<char>> buffers;
+  // Weights read from cache files, pointing into the file mappings. They are
+  // only ever read, like the rest of the unpacked weights.
+  std::map<FileKey, std::shared_ptr<char>> file_buffers;
+};
+
 namespace tflite {
 namespace xnnpack {
 namespace {
 
+// FNV-1a hash of "size" bytes at "data".
+uint64_t HashBytes(const void* data, size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  uint64_t hash = UINT64_C(14695981039346656037);
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * UINT64_C(1099511628211);
+  }
+  return hash;
+}
+
 // Forward declaration.
 TfLiteStatus DelegatePrepare(TfLiteContext* context, TfLiteDelegate* delegate);
 
@@ -47,6 +104,9 @@ class Delegate {
 
  public:
   explicit Delegate(const TfLiteXNNPackDelegateOptions* options) {
+    if (options != nullptr) {
+      weights_cache_ = options->weights_cache;
+    }
 #if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
     if (options != nullptr && options->num_threads > 1) {
       threadpool_.reset(
@@ -80,10 +140,12 @@ class Delegate {
 
   // Unpacked data for quasi-static tensors, i.e. tensors produced by
   // dequantizing or unpacking static buffers.
-  std::vector<char> static_unpacked_data_;
-  // Mapping from a tensor index for a quasi-static tensor to the offset to
-  // its unpacked data within static_unpacked_data_.
-  std::unordered_map<int, size_t> static_unpacked_data_map_;
+  std::vector<std::shared_ptr<char>> static_unpacked_data_;
+  // Mapping from a tensor index for a quasi-static tensor to its unpacked
+  // data within static_unpacked_data_.
+  std::unordered_map<int, const char*> static_unpacked_data_map_;
+  // Cache shared with other delegates for static_unpacked_data_, if any.
+  TfLiteXNNPackDelegateWeightsCache* weights_cache_ = nullptr;
   // Set of indices of nodes which unpack static data, e.g. Dequantize
   // operators which convert FP16 static weights to FP32. These nodes are simply
   // ignored in the delegate implementation, because their outputs are
@@ -217,7 +279,7 @@ class Subgraph {
         // Check for quasi-static data.
         const auto it = delegate->static_unpacked_data_map_.find(t);
         if (it != delegate->static_unpacked_data_map_.end()) {
-          data = delegate->static_unpacked_data_.data() + it->second;
+          data = it->second;
         }
       }
       if (inputs.count(t) != 0) {
@@ -246,7 +308,7 @@ class Subgraph {
 
     // Create a set of quasi-static tensors for VisitNode function
     std::unordered_set<int> quasi_static_tensors;
-    for (const std::pair<const int, size_t>& entry :
+    for (const std::pair<const int, const char*>& entry :
          delegate->static_unpacked_data_map_) {
       quasi_static_tensors.insert(entry.first);
     }
@@ -3122,18 +3184,29 @@ TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
       }
     }
 
-    // Align to XNN_EXTRA_BYTES bytes
-    while (static_unpacked_data_.size() % XNN_EXTRA_BYTES != 0) {
-      static_unpacked_data_.push_back(0);
-    }
-    const size_t tensor_offset = static_unpacked_data_.size();
-    static_unpacked_data_.resize(tensor_offset + context->tensors[t].bytes);
-
-    char* unpacked_data = static_unpacked_data_.data() + tensor_offset;
     const char* packed_data =
         static_unpacked_input_it_ != static_unpacked_data_map_.end()
-            ? static_unpacked_data_.data() + static_unpacked_input_it_->second
+            ? static_unpacked_input_it_->second
             : static_cast<const char*>(input_tensor.data.data);
+    TfLiteXNNPackDelegateWeightsCache::Key cache_key;
+    std::shared_ptr<char> unpacked_buffer;
+    if (weights_cache_ != nullptr) {
+      cache_key = TfLiteXNNPackDelegateWeightsCache::Key(
+          registration->builtin_code, packed_data, input_tensor.bytes,
+          HashBytes(packed_data, input_tensor.bytes),
+          context->tensors[t].bytes);
+      unpacked_buffer = weights_cache_->Lookup(cache_key);
+    }
+    if (unpacked_buffer != nullptr) {
+      static_unpacked_data_map_[t] = unpacked_buffer.get();
+      static_unpacked_data_.push_back(std::move(unpacked_buffer));
+      continue;
+    }
+
+    // XNNPACK may read up to XNN_EXTRA_BYTES past the end of the data.
+    unpacked_buffer.reset(new char[context->tensors[t].bytes + XNN_EXTRA_BYTES],
+                          std::default_delete<char[]>());
+    char* unpacked_data = unpacked_buffer.get();
     switch (registration->builtin_code) {
       case kTfLiteBuiltinDequantize: {
         if (input_tensor.type != kTfLiteFloat16) {
@@ -3217,7 +3290,12 @@ TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
         return nullptr;  // Hard error.
     }
 
-    static_unpacked_data_map_[t] = tensor_offset;
+    if (weights_cache_ != nullptr) {
+      unpacked_buffer =
+          weights_cache_->Insert(cache_key, std::move(unpacked_buffer));
+    }
+    static_unpacked_data_map_[t] = unpacked_buffer.get();
+    static_unpacked_data_.push_back(std::move(unpacked_buffer));
   }
 
   // Add nodes that unpack static data consumed by delegated nodes.
@@ -3323,6 +3401,171 @@ TfLiteDelegate* TfLiteXNNPackDelegateCreate(
   return xnnpack_delegate ? xnnpack_delegate->tflite_delegate() : nullptr;
 }
 
+namespace {
+
+// Layout of a weights cache file: a header, one entry per unpacked buffer,
+// then the buffers themselves, each aligned to kWeightsCacheAlignment and
+// followed by XNN_EXTRA_BYTES of padding.
+constexpr char kWeightsCacheMagic[8] = {'X', 'N', 'N', 'W', 'C', '0', '0', '1'};
+constexpr size_t kWeightsCacheAlignment = 64;
+
+struct WeightsCacheHeader {
+  char magic[8];
+  uint64_t num_entries;
+};
+
+struct WeightsCacheEntry {
+  int64_t builtin_code;
+  uint64_t source_size;
+  uint64_t source_hash;
+  uint64_t unpacked_size;
+  uint64_t offset;
+};
+
+size_t AlignWeightsCacheOffset(size_t offset) {
+  return (offset + kWeightsCacheAlignment - 1) / kWeightsCacheAlignment *
+         kWeightsCacheAlignment;
+}
+
+}  // namespace
+
+TfLiteStatus TfLiteXNNPackDelegateWeightsCache::Load(const char* path) {
+  std::shared_ptr<tflite::Allocation> allocation;
+  if (tflite::MMAPAllocation::IsSupported()) {
+    allocation = std::make_shared<tflite::MMAPAllocation>(
+        path, tflite::DefaultErrorReporter());
+  } else {
+    allocation = std::make_shared<tflite::FileCopyAllocation>(
+        path, tflite::DefaultErrorReporter());
+  }
+  if (!allocation->valid()) {
+    return kTfLiteError;
+  }
+
+  const char* base = static_cast<const char*>(allocation->base());
+  const size_t file_size = allocation->bytes();
+  WeightsCacheHeader header;
+  if (file_size < sizeof(header)) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_ERROR, "truncated weights cache file %s",
+                    path);
+    return kTfLiteError;
+  }
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, kWeightsCacheMagic, sizeof(header.magic)) !=
+          0 ||
+      header.num_entries >
+          (file_size - sizeof(header)) / sizeof(WeightsCacheEntry)) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_ERROR, "invalid weights cache file %s",
+                    path);
+    return kTfLiteError;
+  }
+
+  std::vector<std::pair<FileKey, std::shared_ptr<char>>> loaded;
+  for (uint64_t i = 0; i < header.num_entries; i++) {
+    WeightsCacheEntry entry;
+    std::memcpy(&entry, base + sizeof(header) + i * sizeof(entry),
+                sizeof(entry));
+    if (entry.offset > file_size || entry.unpacked_size > file_size ||
+        entry.unpacked_size + XNN_EXTRA_BYTES > file_size - entry.offset) {
+      TFLITE_LOG_PROD(tflite::TFLITE_LOG_ERROR,
+                      "weights cache file %s has an out-of-bounds entry", path);
+      return kTfLiteError;
+    }
+    // The buffers share ownership of the file mapping.
+    std::shared_ptr<char> buffer(allocation,
+                                 const_cast<char*>(base + entry.offset));
+    loaded.emplace_back(
+        FileKey(static_cast<int>(entry.builtin_code), entry.source_size,
+                entry.source_hash, entry.unpacked_size),
+        std::move(buffer));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  file_buffers.insert(loaded.begin(), loaded.end());
+  return kTfLiteOk;
+}
+
+TfLiteStatus TfLiteXNNPackDelegateWeightsCache::Save(const char* path) {
+  std::map<FileKey, std::shared_ptr<char>> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries = file_buffers;
+    for (const auto& buffer : buffers) {
+      entries.emplace(ToFileKey(buffer.first), buffer.second);
+    }
+  }
+
+  WeightsCacheHeader header;
+  std::memcpy(header.magic, kWeightsCacheMagic, sizeof(header.magic));
+  header.num_entries = entries.size();
+  std::vector<WeightsCacheEntry> table;
+  size_t offset = AlignWeightsCacheOffset(
+      sizeof(header) + entries.size() * sizeof(WeightsCacheEntry));
+  for (const auto& entry : entries) {
+    WeightsCacheEntry e;
+    e.builtin_code = std::get<0>(entry.first);
+    e.source_size = std::get<1>(entry.first);
+    e.source_hash = std::get<2>(entry.first);
+    e.unpacked_size = std::get<3>(entry.first);
+    e.offset = offset;
+    table.push_back(e);
+    offset =
+        AlignWeightsCacheOffset(offset + e.unpacked_size + XNN_EXTRA_BYTES);
+  }
+
+  // Write to a temporary file first so that readers never map a partially
+  // written cache.
+  const std::string temp_path = std::string(path) + ".tmp";
+  FILE* file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_ERROR,
+                    "failed to create weights cache %s", temp_path.c_str());
+    return kTfLiteError;
+  }
+  const std::vector<char> zeros(kWeightsCacheAlignment + XNN_EXTRA_BYTES, 0);
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+            std::fwrite(table.data(), sizeof(WeightsCacheEntry), table.size(),
+                        file) == table.size();
+  size_t written = sizeof(header) + table.size() * sizeof(WeightsCacheEntry);
+  auto entry_it = entries.cbegin();
+  for (size_t i = 0; ok && i < table.size(); i++, ++entry_it) {
+    const size_t padding = table[i].offset - written;
+    ok = std::fwrite(zeros.data(), 1, padding, file) == padding &&
+         std::fwrite(entry_it->second.get(), 1, table[i].unpacked_size,
+                     file) == table[i].unpacked_size &&
+         std::fwrite(zeros.data(), 1, XNN_EXTRA_BYTES, file) ==
+             XNN_EXTRA_BYTES;
+    written = table[i].offset + table[i].unpacked_size + XNN_EXTRA_BYTES;
+  }
+  ok = std::fclose(file) == 0 && ok;
+  if (!ok || std::rename(temp_path.c_str(), path) != 0) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_ERROR,
+                    "failed to write weights cache %s", path);
+    std::remove(temp_path.c_str());
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+TfLiteXNNPackDelegateWeightsCache* TfLiteXNNPackDelegateWeightsCacheCreate() {
+  return new TfLiteXNNPackDelegateWeightsCache();
+}
+
+void TfLiteXNNPackDelegateWeightsCacheDelete(
+    TfLiteXNNPackDelegateWeightsCache* cache) {
+  delete cache;
+}
+
+TfLiteStatus TfLiteXNNPackDelegateWeightsCacheLoad(
+    TfLiteXNNPackDelegateWeightsCache* cache, const char* path) {
+  return cache->Load(path);
+}
+
+TfLiteStatus TfLiteXNNPackDelegateWeightsCacheSave(
+    TfLiteXNNPackDelegateWeightsCache* cache, const char* path) {
+  return cache->Save(path);
+}
+
 void TfLiteXNNPackDelegateDelete(TfLiteDelegate* delegate) {
   if (delegate != nullptr) {
     delete static_cast<::tflite::xnnpack::Delegate*>(delegate->data_);
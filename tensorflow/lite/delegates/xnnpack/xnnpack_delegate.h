@@ -22,12 +22,46 @@ limitations under the License.
 extern "C" {
 #endif  // __cplusplus
 
+// Store of the static weights unpacked by XNNPack delegates, e.g. FP16
+// weights converted to FP32 or sparse weights densified. Delegates created
+// with the same weights cache share the unpacked copy of identical weights,
+// which saves memory when several interpreters are built from the same model.
+typedef struct TfLiteXNNPackDelegateWeightsCache
+    TfLiteXNNPackDelegateWeightsCache;
+
 typedef struct {
   // Number of threads to use in the thread pool.
   // 0 or negative value means no thread pool used.
   int32_t num_threads;
+  // Weights cache to share unpacked weights with other delegates, or nullptr
+  // for weights owned by the delegate. Not owned; it must outlive the
+  // delegates using it.
+  TfLiteXNNPackDelegateWeightsCache* weights_cache;
 } TfLiteXNNPackDelegateOptions;
 
+// Creates a new weights cache that needs to be destroyed with
+// `TfLiteXNNPackDelegateWeightsCacheDelete`. The cache may be used by several
+// delegates concurrently.
+TfLiteXNNPackDelegateWeightsCache* TfLiteXNNPackDelegateWeightsCacheCreate();
+
+// Destroys a weights cache created with
+// `TfLiteXNNPackDelegateWeightsCacheCreate`, after the delegates using it.
+void TfLiteXNNPackDelegateWeightsCacheDelete(
+    TfLiteXNNPackDelegateWeightsCache* cache);
+
+// Adds the weights stored in the file at `path` by
+// `TfLiteXNNPackDelegateWeightsCacheSave` to `cache`. The file is memory-mapped
+// where supported, and delegates created with the cache afterwards use the
+// stored copy of matching weights instead of unpacking them again. Stored
+// weights are matched by content, so a file saved for a different model is
+// harmless. Returns an error if the file is missing or malformed.
+TfLiteStatus TfLiteXNNPackDelegateWeightsCacheLoad(
+    TfLiteXNNPackDelegateWeightsCache* cache, const char* path);
+
+// Writes all weights held by `cache` to the file at `path`, replacing it.
+TfLiteStatus TfLiteXNNPackDelegateWeightsCacheSave(
+    TfLiteXNNPackDelegateWeightsCache* cache, const char* path);
+
 // Returns a structure with the default XNNPack delegate options.
 TfLiteXNNPackDelegateOptions TfLiteXNNPackDelegateOptionsDefault();
 
@@ -380,6 +380,29 @@ void Interpreter::SetCancellationFunction(void* data,
   }
 }
 
+TfLiteStatus Interpreter::SetMemoryPlanningStrategy(
+    MemoryPlanningStrategy strategy) {
+  for (auto& subgraph : subgraphs_) {
+    TF_LITE_ENSURE_STATUS(subgraph->SetMemoryPlanningStrategy(strategy));
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus Interpreter::SetUpperBoundAllocation(bool enabled) {
+  for (auto& subgraph : subgraphs_) {
+    TF_LITE_ENSURE_STATUS(subgraph->SetUpperBoundAllocation(enabled));
+  }
+  return kTfLiteOk;
+}
+
+size_t Interpreter::GetArenaSize() {
+  size_t arena_size = 0;
+  for (auto& subgraph : subgraphs_) {
+    arena_size += subgraph->GetArenaSize();
+  }
+  return arena_size;
+}
+
 bool Interpreter::IsCancelled() { return primary_subgraph().IsCancelled(); }
 
 TfLiteStatus Interpreter::ModifyGraphWithDelegate(TfLiteDelegate* delegate) {
@@ -612,6 +612,26 @@ class Interpreter {
   TfLiteStatus SetCustomAllocationForTensor(
       int tensor_index, const TfLiteCustomAllocation& allocation);
 
+  /// Sets the order in which the memory planner places tensors in the arena of
+  /// every subgraph. kSmallestArena searches for a tighter packing at the
+  /// cost of longer AllocateTensors() calls. Must be called before the first
+  /// AllocateTensors().
+  /// WARNING: This is an experimental API and subject to change.
+  TfLiteStatus SetMemoryPlanningStrategy(MemoryPlanningStrategy strategy);
+
+  /// Enables upper-bound allocation in every subgraph. Once the inputs have
+  /// been resized to their largest shapes and AllocateTensors() was called,
+  /// resizing inputs within those bounds makes AllocateTensors() only re-run
+  /// Prepare on the affected nodes, without re-planning or reallocating the
+  /// arena. Resizing beyond the bounds falls back to a full re-planning.
+  /// WARNING: This is an experimental API and subject to change.
+  TfLiteStatus SetUpperBoundAllocation(bool enabled);
+
+  /// Returns the total number of bytes of the arenas for non-persistent
+  /// tensors of all subgraphs, as planned by the last AllocateTensors().
+  /// WARNING: This is an experimental API and subject to change.
+  size_t GetArenaSize();
+
 #ifndef DOXYGEN_SKIP
   /// Adds `subgraphs_to_add` subgraphs, preserving pre-existing Subgraph
   /// entries. The value pointed to by `first_new_subgraph_index` will be set to
@@ -770,4 +770,32 @@ TfLiteStatus InterpreterBuilder::operator()(
   return kTfLiteOk;
 }
 
+TfLiteStatus InterpreterBuilder::operator()(
+    std::vector<std::unique_ptr<Interpreter>>* interpreters,
+    int num_interpreters, int num_threads) {
+  if (!interpreters) {
+    error_reporter_->Report(
+        "Null output pointer passed to InterpreterBuilder.");
+    return kTfLiteError;
+  }
+  interpreters->clear();
+
+  if (num_interpreters < 1) {
+    error_reporter_->Report("num_interpreters should be >= 1, got %d.",
+                            num_interpreters);
+    return kTfLiteError;
+  }
+
+  // Every replica points its constant tensors at the same model buffers, so
+  // only the arenas and the execution state are duplicated.
+  interpreters->resize(num_interpreters);
+  for (std::unique_ptr<Interpreter>& interpreter : *interpreters) {
+    if (operator()(&interpreter, num_threads) != kTfLiteOk) {
+      interpreters->clear();
+      return kTfLiteError;
+    }
+  }
+  return kTfLiteOk;
+}
+
 }  // namespace tflite
@@ -19,6 +19,7 @@ limitations under the License.
 #define TENSORFLOW_LITE_INTERPRETER_BUILDER_H_
 
 #include <memory>
+#include <vector>
 
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/core/api/error_reporter.h"
@@ -48,6 +49,14 @@ namespace tflite {
 /// Returns a kTfLiteOk when successful and sets interpreter to a valid
 /// Interpreter. Note: The user must ensure the lifetime of the model (and error
 /// reporter, if provided) is at least as long as interpreter's lifetime.
+///
+/// To serve concurrent requests with one model, build several interpreters
+/// with the overload taking `num_interpreters`. The replicas share the
+/// read-only constant tensors of the model, which are not copied, and each
+/// owns its own tensor arena and execution state, so they can be invoked from
+/// different threads without locking. Delegates are applied per replica; to
+/// also share the weights unpacked by the XNNPack delegate, apply to each
+/// replica an XNNPack delegate created with a common weights cache.
 class InterpreterBuilder {
  public:
   InterpreterBuilder(const FlatBufferModel& model,
@@ -64,6 +73,12 @@ class InterpreterBuilder {
   TfLiteStatus operator()(std::unique_ptr<Interpreter>* interpreter);
   TfLiteStatus operator()(std::unique_ptr<Interpreter>* interpreter,
                           int num_threads);
+  /// Builds `num_interpreters` independent interpreters of the model into
+  /// `interpreters`, each using `num_threads` threads. On error `interpreters`
+  /// is cleared.
+  TfLiteStatus operator()(
+      std::vector<std::unique_ptr<Interpreter>>* interpreters,
+      int num_interpreters, int num_threads = -1);
 
  private:
   TfLiteStatus BuildLocalIndexToRegistrationMapping();
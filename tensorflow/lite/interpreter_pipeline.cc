@@ -0,0 +1,169 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/interpreter_pipeline.h"
+
+#include <algorithm>
+
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/core/subgraph.h"
+
+namespace tflite {
+namespace {
+
+// Returns whether each node of the execution plan of `subgraph` is a delegate
+// kernel.
+std::vector<bool> GetDelegatedNodes(const Subgraph& subgraph) {
+  std::vector<bool> delegated;
+  for (int node_index : subgraph.execution_plan()) {
+    delegated.push_back(
+        subgraph.node_and_registration(node_index)->first.delegate != nullptr);
+  }
+  return delegated;
+}
+
+}  // namespace
+
+std::unique_ptr<InterpreterPipeline> InterpreterPipeline::Create(
+    std::vector<std::unique_ptr<Interpreter>> interpreters) {
+  if (interpreters.size() < 2) return nullptr;
+  for (const auto& interpreter : interpreters) {
+    if (!interpreter) return nullptr;
+  }
+  const std::vector<bool> delegated =
+      GetDelegatedNodes(interpreters[0]->primary_subgraph());
+  for (const auto& interpreter : interpreters) {
+    if (GetDelegatedNodes(interpreter->primary_subgraph()) != delegated) {
+      TF_LITE_REPORT_ERROR(interpreter->error_reporter(),
+                           "InterpreterPipeline needs interpreters with the "
+                           "same delegated execution plan.");
+      return nullptr;
+    }
+  }
+
+  std::unique_ptr<InterpreterPipeline> pipeline(new InterpreterPipeline());
+  const int num_nodes = static_cast<int>(delegated.size());
+  // An empty execution plan still gets one stage, which runs nothing.
+  int begin = 0;
+  do {
+    int end = begin + 1;
+    while (end < num_nodes && delegated[end] == delegated[begin]) ++end;
+    end = std::min(end, num_nodes);
+    Stage stage;
+    stage.begin = begin;
+    stage.end = end;
+    pipeline->stages_.push_back(std::move(stage));
+    begin = end;
+  } while (begin < num_nodes);
+  for (auto& interpreter : interpreters) {
+    pipeline->free_slots_.push_back(static_cast<int>(pipeline->slots_.size()));
+    Slot slot;
+    slot.interpreter = std::move(interpreter);
+    pipeline->slots_.push_back(std::move(slot));
+  }
+  for (int i = 0; i < pipeline->num_stages(); ++i) {
+    pipeline->stages_[i].thread =
+        std::thread([pipeline = pipeline.get(), i] { pipeline->StageLoop(i); });
+  }
+  return pipeline;
+}
+
+InterpreterPipeline::~InterpreterPipeline() {
+  Wait();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  changed_.notify_all();
+  for (Stage& stage : stages_) {
+    if (stage.thread.joinable()) stage.thread.join();
+  }
+}
+
+TfLiteStatus InterpreterPipeline::Enqueue(const SetInputsCallback& set_inputs,
+                                          DoneCallback done) {
+  int slot_index;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return !free_slots_.empty(); });
+    slot_index = free_slots_.front();
+    free_slots_.pop_front();
+    ++in_flight_;
+  }
+
+  Slot& slot = slots_[slot_index];
+  const TfLiteStatus status = set_inputs(slot.interpreter.get());
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (status != kTfLiteOk) {
+    free_slots_.push_back(slot_index);
+    --in_flight_;
+  } else {
+    slot.done = std::move(done);
+    slot.status = kTfLiteOk;
+    stages_[0].queue.push_back(slot_index);
+  }
+  changed_.notify_all();
+  return status;
+}
+
+void InterpreterPipeline::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock, [this] { return in_flight_ == 0; });
+}
+
+void InterpreterPipeline::StageLoop(int stage_index) {
+  Stage& stage = stages_[stage_index];
+  const bool is_last_stage = stage_index == num_stages() - 1;
+  while (true) {
+    int slot_index;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      changed_.wait(lock, [this, &stage] {
+        return shutdown_ || !stage.queue.empty();
+      });
+      if (stage.queue.empty()) return;
+      slot_index = stage.queue.front();
+      stage.queue.pop_front();
+    }
+
+    // The slot is only accessed by the stage it is queued for, so it can be
+    // used without holding the lock.
+    Slot& slot = slots_[slot_index];
+    Subgraph& subgraph = slot.interpreter->primary_subgraph();
+    if (slot.status == kTfLiteOk) {
+      slot.status = subgraph.InvokeRange(stage.begin, stage.end);
+    }
+
+    if (!is_last_stage) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stages_[stage_index + 1].queue.push_back(slot_index);
+      changed_.notify_all();
+      continue;
+    }
+
+    // Like Interpreter::Invoke(), make the outputs readable on the CPU.
+    for (int tensor_index : slot.interpreter->outputs()) {
+      if (slot.status != kTfLiteOk) break;
+      slot.status = subgraph.EnsureTensorDataIsReadable(tensor_index);
+    }
+    DoneCallback done = std::move(slot.done);
+    done(slot.status, slot.interpreter.get());
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_slots_.push_back(slot_index);
+    --in_flight_;
+    changed_.notify_all();
+  }
+}
+
+}  // namespace tflite
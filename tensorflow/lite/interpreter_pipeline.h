@@ -0,0 +1,128 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_INTERPRETER_PIPELINE_H_
+#define TENSORFLOW_LITE_INTERPRETER_PIPELINE_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/interpreter.h"
+
+namespace tflite {
+
+/// Pipelines consecutive invocations of a partially delegated model, so that
+/// the nodes of invocation N that run on the CPU overlap with the delegated
+/// nodes of invocation N+1.
+///
+/// The execution plan is split into stages, each a maximal run of nodes that
+/// are either all delegate kernels or all regular kernels. Every stage runs on
+/// its own thread, and every in-flight invocation uses its own interpreter, so
+/// the tensors at stage boundaries are multi-buffered across interpreters
+/// instead of being shared. The latency of a single invocation is unchanged,
+/// while the throughput approaches that of the slowest stage.
+///
+/// Example:
+///
+/// <pre><code>
+/// std::vector<std::unique_ptr<tflite::Interpreter>> interpreters;
+/// ... build 2 interpreters, apply a delegate to each, AllocateTensors() ...
+/// auto pipeline =
+///     tflite::InterpreterPipeline::Create(std::move(interpreters));
+/// for (const Frame& frame : frames) {
+///   pipeline->Enqueue(
+///       [&](tflite::Interpreter* interpreter) { ... fill inputs ... },
+///       [&](TfLiteStatus status, tflite::Interpreter* interpreter) {
+///         ... read outputs ...
+///       });
+/// }
+/// pipeline->Wait();
+/// </code></pre>
+class InterpreterPipeline {
+ public:
+  /// Fills the inputs of the interpreter the invocation runs on.
+  using SetInputsCallback = std::function<TfLiteStatus(Interpreter*)>;
+  /// Receives the status of the invocation; on success the outputs of the
+  /// interpreter are readable until the callback returns.
+  using DoneCallback = std::function<void(TfLiteStatus, Interpreter*)>;
+
+  /// Takes ownership of `interpreters`, at least two, built from the same
+  /// model with the same delegates applied, and with tensors allocated. The
+  /// number of interpreters bounds the number of invocations in flight.
+  /// Returns nullptr if the interpreters are not compatible. Delegates that
+  /// must be invoked on the thread that applied them are not supported.
+  static std::unique_ptr<InterpreterPipeline> Create(
+      std::vector<std::unique_ptr<Interpreter>> interpreters);
+
+  /// Waits for all enqueued invocations to be done.
+  ~InterpreterPipeline();
+
+  InterpreterPipeline(const InterpreterPipeline&) = delete;
+  InterpreterPipeline& operator=(const InterpreterPipeline&) = delete;
+
+  /// Starts an invocation and returns once its first stage has been queued.
+  /// Blocks while all interpreters are busy. `set_inputs` is called on the
+  /// calling thread, `done` on a pipeline thread; invocations complete in the
+  /// order they were enqueued. Returns the status of `set_inputs`, and on
+  /// failure does not call `done`.
+  TfLiteStatus Enqueue(const SetInputsCallback& set_inputs, DoneCallback done);
+
+  /// Blocks until every enqueued invocation is done.
+  void Wait();
+
+  /// Number of stages the execution plan was split into.
+  int num_stages() const { return static_cast<int>(stages_.size()); }
+
+ private:
+  struct Stage {
+    // Execution plan range of the stage.
+    int begin;
+    int end;
+    // Interpreter slots waiting to run this stage, in invocation order.
+    std::deque<int> queue;
+    std::thread thread;
+  };
+
+  struct Slot {
+    std::unique_ptr<Interpreter> interpreter;
+    DoneCallback done;
+    TfLiteStatus status = kTfLiteOk;
+  };
+
+  InterpreterPipeline() = default;
+
+  void StageLoop(int stage_index);
+
+  std::vector<Slot> slots_;
+  std::vector<Stage> stages_;
+
+  std::mutex mutex_;
+  // Signaled whenever a stage queue, the free slots or the number of
+  // invocations in flight change.
+  std::condition_variable changed_;
+  std::deque<int> free_slots_;
+  int in_flight_ = 0;
+  bool shutdown_ = false;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_INTERPRETER_PIPELINE_H_
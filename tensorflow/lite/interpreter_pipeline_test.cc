@@ -0,0 +1,117 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/interpreter_pipeline.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/delegates/delegate_test_util.h"
+#include "tensorflow/lite/interpreter.h"
+
+namespace tflite {
+namespace {
+
+// Uses the graph of TestDelegate, where node 0 computes "2 = 0 + 0" and is
+// delegated, while nodes 1 ("3 = 1 + 1") and 2 ("4 = 2 + 1") run on the CPU.
+class InterpreterPipelineTest : public delegates::test_utils::TestDelegate {
+ protected:
+  std::vector<std::unique_ptr<Interpreter>> BuildInterpreters(int count) {
+    std::vector<std::unique_ptr<Interpreter>> interpreters;
+    for (int i = 0; i < count; ++i) {
+      // Reuses SetUp() to build the graph in interpreter_.
+      SetUp();
+      EXPECT_EQ(interpreter_->ModifyGraphWithDelegate(
+                    delegate_->get_tf_lite_delegate()),
+                kTfLiteOk);
+      EXPECT_EQ(interpreter_->AllocateTensors(), kTfLiteOk);
+      interpreters.push_back(std::move(interpreter_));
+    }
+    return interpreters;
+  }
+};
+
+TEST_F(InterpreterPipelineTest, NeedsSeveralInterpreters) {
+  delegate_ = std::unique_ptr<SimpleDelegate>(new SimpleDelegate({0}));
+  EXPECT_EQ(InterpreterPipeline::Create(BuildInterpreters(1)), nullptr);
+}
+
+TEST_F(InterpreterPipelineTest, MatchesSequentialInvocations) {
+  delegate_ = std::unique_ptr<SimpleDelegate>(new SimpleDelegate({0}));
+  auto pipeline = InterpreterPipeline::Create(BuildInterpreters(2));
+  ASSERT_NE(pipeline, nullptr);
+  EXPECT_EQ(pipeline->num_stages(), 2);
+
+  constexpr int kNumInvocations = 16;
+  std::vector<std::vector<float>> outputs(kNumInvocations);
+  std::vector<TfLiteStatus> statuses(kNumInvocations, kTfLiteError);
+  for (int i = 0; i < kNumInvocations; ++i) {
+    ASSERT_EQ(pipeline->Enqueue(
+                  [i](Interpreter* interpreter) {
+                    for (int j = 0; j < 3; ++j) {
+                      interpreter->typed_input_tensor<float>(0)[j] = i + j;
+                      interpreter->typed_input_tensor<float>(1)[j] = 10 * i;
+                    }
+                    return kTfLiteOk;
+                  },
+                  [i, &outputs, &statuses](TfLiteStatus status,
+                                           Interpreter* interpreter) {
+                    statuses[i] = status;
+                    for (int j = 0; j < 3; ++j) {
+                      outputs[i].push_back(
+                          interpreter->typed_output_tensor<float>(0)[j]);
+                      outputs[i].push_back(
+                          interpreter->typed_output_tensor<float>(1)[j]);
+                    }
+                  }),
+              kTfLiteOk);
+  }
+  pipeline->Wait();
+
+  for (int i = 0; i < kNumInvocations; ++i) {
+    EXPECT_EQ(statuses[i], kTfLiteOk);
+    std::vector<float> expected;
+    for (int j = 0; j < 3; ++j) {
+      expected.push_back(20 * i);
+      expected.push_back(2 * (i + j) + 10 * i);
+    }
+    EXPECT_EQ(outputs[i], expected);
+  }
+}
+
+TEST_F(InterpreterPipelineTest, ReportsFailures) {
+  delegate_ = std::unique_ptr<SimpleDelegate>(
+      new SimpleDelegate({0}, kTfLiteDelegateFlagsNone,
+                         /*fail_node_prepare=*/false, /*min_ops_per_subset=*/0,
+                         /*fail_node_invoke=*/true));
+  auto pipeline = InterpreterPipeline::Create(BuildInterpreters(2));
+  ASSERT_NE(pipeline, nullptr);
+
+  TfLiteStatus done_status = kTfLiteOk;
+  ASSERT_EQ(pipeline->Enqueue(
+                [](Interpreter*) { return kTfLiteOk; },
+                [&done_status](TfLiteStatus status, Interpreter*) {
+                  done_status = status;
+                }),
+            kTfLiteOk);
+  EXPECT_EQ(pipeline->Enqueue([](Interpreter*) { return kTfLiteError; },
+                              [](TfLiteStatus, Interpreter*) { FAIL(); }),
+            kTfLiteError);
+  pipeline->Wait();
+  EXPECT_EQ(done_status, kTfLiteError);
+}
+
+}  // namespace
+}  // namespace tflite
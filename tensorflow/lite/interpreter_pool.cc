@@ -0,0 +1,193 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/interpreter_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/interpreter_builder.h"
+
+namespace tflite {
+
+std::unique_ptr<InterpreterPool> InterpreterPool::Create(
+    const FlatBufferModel& model, const OpResolver& op_resolver,
+    int num_workers) {
+  if (num_workers < 1) {
+    TF_LITE_REPORT_ERROR(model.error_reporter(),
+                         "InterpreterPool needs at least one worker, got %d.",
+                         num_workers);
+    return nullptr;
+  }
+  std::unique_ptr<InterpreterPool> pool(new InterpreterPool());
+  for (int i = 0; i < num_workers; ++i) {
+    auto worker = std::make_unique<Worker>();
+    if (InterpreterBuilder(model, op_resolver)(&worker->interpreter,
+                                               /*num_threads=*/1) !=
+            kTfLiteOk ||
+        !worker->interpreter) {
+      return nullptr;
+    }
+    pool->workers_.push_back(std::move(worker));
+  }
+  // Threads are started only once every interpreter has been built so that an
+  // early return above does not have to join anything.
+  for (auto& worker : pool->workers_) {
+    Worker* w = worker.get();
+    w->thread = std::thread([pool = pool.get(), w] { pool->WorkerLoop(w); });
+  }
+  return pool;
+}
+
+InterpreterPool::~InterpreterPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  work_available_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) worker->thread.join();
+  }
+}
+
+TfLiteStatus InterpreterPool::InvokeBatch(std::vector<Request>* requests) {
+  std::lock_guard<std::mutex> batch_lock(batch_mutex_);
+  if (requests->empty()) return kTfLiteOk;
+
+  // Run equally shaped requests back to back, so that a worker picking up the
+  // next request is likely to find its arena already allocated for it.
+  std::vector<Request*> batch;
+  batch.reserve(requests->size());
+  for (Request& request : *requests) batch.push_back(&request);
+  std::stable_sort(batch.begin(), batch.end(),
+                   [](const Request* a, const Request* b) {
+                     return a->input_shapes < b->input_shapes;
+                   });
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    batch_ = std::move(batch);
+    next_request_ = 0;
+    busy_workers_ = static_cast<int>(workers_.size());
+    ++batch_id_;
+    work_available_.notify_all();
+    work_done_.wait(lock, [this] { return busy_workers_ == 0; });
+    batch_.clear();
+  }
+
+  TfLiteStatus status = kTfLiteOk;
+  for (const Request& request : *requests) {
+    if (request.status != kTfLiteOk) status = kTfLiteError;
+  }
+  return status;
+}
+
+void InterpreterPool::WorkerLoop(Worker* worker) {
+  int64_t seen_batch_id = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_available_.wait(lock, [this, seen_batch_id] {
+        return shutdown_ || batch_id_ != seen_batch_id;
+      });
+      if (shutdown_) return;
+      seen_batch_id = batch_id_;
+    }
+    RunRequests(worker);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--busy_workers_ == 0) work_done_.notify_all();
+    }
+  }
+}
+
+void InterpreterPool::RunRequests(Worker* worker) {
+  // batch_ is not modified until every worker has checked in as done, so it
+  // can be read without holding mutex_.
+  for (size_t i = next_request_++; i < batch_.size(); i = next_request_++) {
+    Request* request = batch_[i];
+    request->status = RunRequest(worker, request);
+  }
+}
+
+TfLiteStatus InterpreterPool::PrepareForShapes(
+    Worker* worker, const std::vector<std::vector<int>>& shapes) {
+  if (worker->allocated && worker->allocated_shapes == shapes) {
+    return kTfLiteOk;
+  }
+  Interpreter* interpreter = worker->interpreter.get();
+  worker->allocated = false;
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    const int tensor_index = interpreter->inputs()[i];
+    const TfLiteTensor* tensor = interpreter->tensor(tensor_index);
+    if (TfLiteIntArrayEqualsArray(tensor->dims,
+                                  static_cast<int>(shapes[i].size()),
+                                  shapes[i].data())) {
+      continue;
+    }
+    TF_LITE_ENSURE_STATUS(
+        interpreter->ResizeInputTensor(tensor_index, shapes[i]));
+  }
+  TF_LITE_ENSURE_STATUS(interpreter->AllocateTensors());
+  worker->allocated_shapes = shapes;
+  worker->allocated = true;
+  return kTfLiteOk;
+}
+
+TfLiteStatus InterpreterPool::RunRequest(Worker* worker, Request* request) {
+  Interpreter* interpreter = worker->interpreter.get();
+  ErrorReporter* error_reporter = interpreter->error_reporter();
+  const size_t num_inputs = interpreter->inputs().size();
+  if (request->inputs.size() != num_inputs ||
+      request->input_shapes.size() != num_inputs) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Request has %d inputs and %d input shapes, but the "
+                         "model has %d inputs.",
+                         static_cast<int>(request->inputs.size()),
+                         static_cast<int>(request->input_shapes.size()),
+                         static_cast<int>(num_inputs));
+    return kTfLiteError;
+  }
+  TF_LITE_ENSURE_STATUS(PrepareForShapes(worker, request->input_shapes));
+
+  for (size_t i = 0; i < num_inputs; ++i) {
+    TfLiteTensor* tensor = interpreter->tensor(interpreter->inputs()[i]);
+    if (tensor->type == kTfLiteString) {
+      TF_LITE_REPORT_ERROR(error_reporter,
+                           "InterpreterPool does not support string inputs.");
+      return kTfLiteError;
+    }
+    if (tensor->bytes > 0) {
+      std::memcpy(tensor->data.raw, request->inputs[i], tensor->bytes);
+    }
+  }
+
+  TF_LITE_ENSURE_STATUS(interpreter->Invoke());
+
+  const size_t num_outputs = interpreter->outputs().size();
+  request->output_shapes.resize(num_outputs);
+  request->outputs.resize(num_outputs);
+  for (size_t i = 0; i < num_outputs; ++i) {
+    const TfLiteTensor* tensor = interpreter->tensor(interpreter->outputs()[i]);
+    request->output_shapes[i].assign(tensor->dims->data,
+                                     tensor->dims->data + tensor->dims->size);
+    request->outputs[i].assign(tensor->data.raw,
+                               tensor->data.raw + tensor->bytes);
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
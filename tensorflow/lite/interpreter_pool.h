@@ -0,0 +1,129 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_INTERPRETER_POOL_H_
+#define TENSORFLOW_LITE_INTERPRETER_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace tflite {
+
+/// A pool of interpreters built from the same model that executes batches of
+/// independent requests concurrently, one request per worker at a time.
+///
+/// Each worker owns its own Interpreter (and therefore its own tensor arena)
+/// and keeps it allocated for the shapes of the last request it ran, so a
+/// stream of equally shaped requests never calls ResizeInputTensor() or
+/// AllocateTensors() again. Worker interpreters are single threaded: the
+/// parallelism comes from running several requests at once rather than from
+/// splitting individual ops, which avoids sharing a CpuBackendContext between
+/// interpreters.
+///
+/// Example:
+///
+/// <pre><code>
+/// auto pool = tflite::InterpreterPool::Create(*model, resolver, 4);
+/// std::vector<tflite::InterpreterPool::Request> requests(n);
+/// ... fill requests[i].inputs and requests[i].input_shapes ...
+/// if (pool->InvokeBatch(&requests) != kTfLiteOk) ... inspect status ...
+/// </code></pre>
+class InterpreterPool {
+ public:
+  /// A single inference request. `inputs` and `input_shapes` are indexed like
+  /// Interpreter::inputs(); input buffers must stay valid until InvokeBatch()
+  /// returns. The remaining fields are filled in by the pool.
+  struct Request {
+    std::vector<std::vector<int>> input_shapes;
+    std::vector<const void*> inputs;
+
+    std::vector<std::vector<int>> output_shapes;
+    std::vector<std::vector<char>> outputs;
+    TfLiteStatus status = kTfLiteOk;
+  };
+
+  /// Builds `num_workers` interpreters for `model`. Returns nullptr if any of
+  /// them fails to build. `model` and `op_resolver` must outlive the pool.
+  static std::unique_ptr<InterpreterPool> Create(
+      const FlatBufferModel& model, const OpResolver& op_resolver,
+      int num_workers);
+
+  ~InterpreterPool();
+
+  InterpreterPool(const InterpreterPool&) = delete;
+  InterpreterPool& operator=(const InterpreterPool&) = delete;
+
+  /// Runs every request in `requests` and blocks until all of them are done.
+  /// Requests are independent and may have different input shapes. Returns
+  /// kTfLiteError if any request failed; the per-request `status` tells which.
+  /// Concurrent calls are serialized.
+  TfLiteStatus InvokeBatch(std::vector<Request>* requests);
+
+  int num_workers() const { return static_cast<int>(workers_.size()); }
+
+  /// Returns the interpreter owned by worker `index`, e.g. to inspect tensor
+  /// metadata. It must not be used while a batch is running.
+  Interpreter* worker_interpreter(int index) {
+    return workers_[index]->interpreter.get();
+  }
+
+ private:
+  struct Worker {
+    std::unique_ptr<Interpreter> interpreter;
+    // Input shapes the interpreter is currently allocated for.
+    std::vector<std::vector<int>> allocated_shapes;
+    bool allocated = false;
+    std::thread thread;
+  };
+
+  InterpreterPool() = default;
+
+  void WorkerLoop(Worker* worker);
+  // Runs the requests handed out from `next_request_` until none are left.
+  void RunRequests(Worker* worker);
+  TfLiteStatus RunRequest(Worker* worker, Request* request);
+  TfLiteStatus PrepareForShapes(Worker* worker,
+                                const std::vector<std::vector<int>>& shapes);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Serializes InvokeBatch() calls.
+  std::mutex batch_mutex_;
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable work_done_;
+  // Incremented for every batch so that workers pick up each batch once.
+  int64_t batch_id_ = 0;
+  bool shutdown_ = false;
+  int busy_workers_ = 0;
+
+  // The batch currently being executed, in execution order.
+  std::vector<Request*> batch_;
+  std::atomic<size_t> next_request_{0};
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_INTERPRETER_POOL_H_
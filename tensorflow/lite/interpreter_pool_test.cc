@@ -0,0 +1,115 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/interpreter_pool.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/kernels/register.h"
+#include "tensorflow/lite/model.h"
+
+namespace tflite {
+namespace {
+
+// add.bin computes `output = input + input + input` on a float tensor of any
+// shape.
+class InterpreterPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = FlatBufferModel::BuildFromFile("tensorflow/lite/testdata/add.bin");
+    ASSERT_TRUE(model_);
+  }
+
+  static InterpreterPool::Request MakeRequest(const std::vector<float>& data) {
+    InterpreterPool::Request request;
+    request.input_shapes = {{static_cast<int>(data.size())}};
+    request.inputs = {data.data()};
+    return request;
+  }
+
+  static std::vector<float> Output(const InterpreterPool::Request& request) {
+    const std::vector<char>& bytes = request.outputs[0];
+    const float* data = reinterpret_cast<const float*>(bytes.data());
+    return std::vector<float>(data, data + bytes.size() / sizeof(float));
+  }
+
+  std::unique_ptr<FlatBufferModel> model_;
+  ops::builtin::BuiltinOpResolver resolver_;
+};
+
+TEST_F(InterpreterPoolTest, RejectsZeroWorkers) {
+  EXPECT_EQ(InterpreterPool::Create(*model_, resolver_, 0), nullptr);
+}
+
+TEST_F(InterpreterPoolTest, RunsRequestsWithDifferentShapes) {
+  auto pool = InterpreterPool::Create(*model_, resolver_, 3);
+  ASSERT_TRUE(pool);
+  EXPECT_EQ(pool->num_workers(), 3);
+
+  std::vector<std::vector<float>> inputs;
+  for (int i = 0; i < 20; ++i) {
+    std::vector<float> input(1 + i % 4);
+    for (size_t j = 0; j < input.size(); ++j) input[j] = i + 0.5f * j;
+    inputs.push_back(input);
+  }
+  std::vector<InterpreterPool::Request> requests;
+  for (const auto& input : inputs) requests.push_back(MakeRequest(input));
+
+  ASSERT_EQ(pool->InvokeBatch(&requests), kTfLiteOk);
+  for (size_t i = 0; i < requests.size(); ++i) {
+    EXPECT_EQ(requests[i].status, kTfLiteOk);
+    ASSERT_EQ(requests[i].output_shapes.size(), 1);
+    EXPECT_EQ(requests[i].output_shapes[0],
+              std::vector<int>{static_cast<int>(inputs[i].size())});
+    std::vector<float> expected;
+    for (float x : inputs[i]) expected.push_back(3 * x);
+    EXPECT_EQ(Output(requests[i]), expected);
+  }
+}
+
+TEST_F(InterpreterPoolTest, ReusesAllocationForSameShape) {
+  auto pool = InterpreterPool::Create(*model_, resolver_, 1);
+  ASSERT_TRUE(pool);
+  const std::vector<float> first = {1, 2};
+  std::vector<InterpreterPool::Request> requests = {MakeRequest(first)};
+  ASSERT_EQ(pool->InvokeBatch(&requests), kTfLiteOk);
+  Interpreter* interpreter = pool->worker_interpreter(0);
+  const void* input_data = interpreter->input_tensor(0)->data.raw;
+
+  const std::vector<float> second = {3, 4};
+  requests = {MakeRequest(second)};
+  ASSERT_EQ(pool->InvokeBatch(&requests), kTfLiteOk);
+  EXPECT_EQ(interpreter->input_tensor(0)->data.raw, input_data);
+  EXPECT_EQ(Output(requests[0]), std::vector<float>({9, 12}));
+}
+
+TEST_F(InterpreterPoolTest, ReportsFailedRequests) {
+  auto pool = InterpreterPool::Create(*model_, resolver_, 2);
+  ASSERT_TRUE(pool);
+  const std::vector<float> input = {1, 2, 3};
+  std::vector<InterpreterPool::Request> requests = {MakeRequest(input),
+                                                    MakeRequest(input)};
+  // The model has a single input.
+  requests[1].inputs.push_back(input.data());
+  requests[1].input_shapes.push_back({3});
+
+  EXPECT_EQ(pool->InvokeBatch(&requests), kTfLiteError);
+  EXPECT_EQ(requests[0].status, kTfLiteOk);
+  EXPECT_EQ(Output(requests[0]), std::vector<float>({3, 6, 9}));
+  EXPECT_EQ(requests[1].status, kTfLiteError);
+}
+
+}  // namespace
+}  // namespace tflite
@@ -1077,6 +1077,112 @@ TEST(BasicInterpreter, DynamicTensorsResizeDescendants) {
   ASSERT_EQ(interpreter.tensor(3)->bytes, sizeof(float) * 10 * 14);
 }
 
+// NEG op that counts how often it is prepared.
+int g_counting_neg_prepare_count = 0;
+
+TfLiteRegistration GetCountingNegOpRegistration() {
+  TfLiteRegistration reg = *tflite::ops::builtin::Register_NEG();
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    ++g_counting_neg_prepare_count;
+    return tflite::ops::builtin::Register_NEG()->prepare(context, node);
+  };
+  return reg;
+}
+
+// Assembles two independent NEG nodes: tensor 0 -> 1 and tensor 2 -> 3.
+void BuildTwoNegInterpreter(Interpreter* interpreter,
+                            TfLiteRegistration* neg_op) {
+  ASSERT_EQ(interpreter->AddTensors(4), kTfLiteOk);
+  ASSERT_EQ(interpreter->SetInputs({0, 2}), kTfLiteOk);
+  ASSERT_EQ(interpreter->SetOutputs({1, 3}), kTfLiteOk);
+  TfLiteQuantizationParams quant;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(interpreter->SetTensorParametersReadWrite(i, kTfLiteFloat32, "",
+                                                        {1}, quant),
+              kTfLiteOk);
+  }
+  ASSERT_EQ(interpreter->AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                               neg_op),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter->AddNodeWithParameters({2}, {3}, nullptr, 0, nullptr,
+                                               neg_op),
+            kTfLiteOk);
+}
+
+TEST(BasicInterpreter, UpperBoundAllocationOnlyPreparesAffectedNodes) {
+  Interpreter interpreter;
+  TfLiteRegistration neg_op = GetCountingNegOpRegistration();
+  BuildTwoNegInterpreter(&interpreter, &neg_op);
+  ASSERT_EQ(interpreter.SetUpperBoundAllocation(true), kTfLiteOk);
+
+  // Plan the arena for the largest shapes.
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {8}), kTfLiteOk);
+  ASSERT_EQ(interpreter.ResizeInputTensor(2, {8}), kTfLiteOk);
+  g_counting_neg_prepare_count = 0;
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(g_counting_neg_prepare_count, 2);
+  const size_t arena_size = interpreter.GetArenaSize();
+  const char* input_data = interpreter.tensor(0)->data.raw;
+  const char* output_data = interpreter.tensor(1)->data.raw;
+
+  // Shrinking an input only prepares its consumer and keeps the buffers.
+  g_counting_neg_prepare_count = 0;
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {3}), kTfLiteOk);
+  EXPECT_NE(interpreter.Invoke(), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(g_counting_neg_prepare_count, 1);
+  EXPECT_EQ(interpreter.GetArenaSize(), arena_size);
+  EXPECT_EQ(interpreter.tensor(0)->data.raw, input_data);
+  EXPECT_EQ(interpreter.tensor(1)->data.raw, output_data);
+  EXPECT_EQ(interpreter.tensor(1)->bytes, 3 * sizeof(float));
+  ASSERT_EQ(interpreter.tensor(1)->dims->size, 1);
+  EXPECT_EQ(interpreter.tensor(1)->dims->data[0], 3);
+
+  for (int i = 0; i < 3; ++i) interpreter.typed_tensor<float>(0)[i] = i;
+  for (int i = 0; i < 8; ++i) interpreter.typed_tensor<float>(2)[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  EXPECT_EQ(interpreter.typed_tensor<float>(1)[2], -2.0f);
+  EXPECT_EQ(interpreter.typed_tensor<float>(3)[7], -7.0f);
+}
+
+TEST(BasicInterpreter, UpperBoundAllocationExceeded) {
+  Interpreter interpreter;
+  TfLiteRegistration neg_op = GetCountingNegOpRegistration();
+  BuildTwoNegInterpreter(&interpreter, &neg_op);
+  ASSERT_EQ(interpreter.SetUpperBoundAllocation(true), kTfLiteOk);
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {4}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  // Growing an input beyond its bound re-plans the whole graph.
+  g_counting_neg_prepare_count = 0;
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {16}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(g_counting_neg_prepare_count, 2);
+  EXPECT_EQ(interpreter.tensor(1)->bytes, 16 * sizeof(float));
+  for (int i = 0; i < 16; ++i) interpreter.typed_tensor<float>(0)[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  EXPECT_EQ(interpreter.typed_tensor<float>(1)[15], -15.0f);
+
+  // The new shapes are now the bounds.
+  g_counting_neg_prepare_count = 0;
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {10}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(g_counting_neg_prepare_count, 1);
+}
+
+TEST(BasicInterpreter, UpperBoundAllocationDisabled) {
+  Interpreter interpreter;
+  TfLiteRegistration neg_op = GetCountingNegOpRegistration();
+  BuildTwoNegInterpreter(&interpreter, &neg_op);
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {8}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  g_counting_neg_prepare_count = 0;
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {3}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(g_counting_neg_prepare_count, 2);
+}
+
 TEST(InterpreterTensorsCapacityTest, TestWithinHeadroom) {
   Interpreter interpreter;
   ASSERT_EQ(interpreter.AddTensors(Interpreter::kTensorsReservedCapacity),
@@ -37,8 +37,10 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/optimized/multithreaded_conv.h"
 #endif
 #include "tensorflow/lite/kernels/internal/optimized/optimized_ops.h"
+#include "tensorflow/lite/kernels/internal/optimized/sparse_ops/fully_connected.h"
 #include "tensorflow/lite/kernels/internal/quantization_util.h"
 #include "tensorflow/lite/kernels/internal/reference/conv.h"
+#include "tensorflow/lite/kernels/internal/reference/densify.h"
 #include "tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
 #include "tensorflow/lite/kernels/internal/tensor.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
@@ -210,6 +212,48 @@ bool IsIm2ColRequired(const TfLiteTensor* input, TfLiteConvParams* params,
   }
 }
 
+// Sparse filters are only supported for pointwise convolutions: with a 1x1
+// filter, unit strides and no dilation the convolution is a fully-connected
+// layer over all the output pixels, so it runs on the sparse fully-connected
+// kernels. The filter has to be compressed along the input channels, either
+// element-wise or in 1xN blocks.
+TfLiteStatus CheckSparseFilter(TfLiteContext* context,
+                               const TfLiteConvParams* params,
+                               const TfLiteTensor* input,
+                               const TfLiteTensor* filter) {
+  TF_LITE_ENSURE_MSG(
+      context,
+      input->type == filter->type &&
+          (input->type == kTfLiteFloat32 || input->type == kTfLiteInt8),
+      "Sparse filters are only supported for float32 and int8 convolutions.");
+  TF_LITE_ENSURE_MSG(
+      context,
+      filter->dims->data[1] == 1 && filter->dims->data[2] == 1 &&
+          params->stride_width == 1 && params->stride_height == 1 &&
+          params->dilation_width_factor == 1 &&
+          params->dilation_height_factor == 1,
+      "Sparse filters are only supported for pointwise convolutions.");
+
+  const TfLiteSparsity& sparsity = *filter->sparsity;
+  const int dims_count = sparsity.dim_metadata_size;
+  bool supported = (dims_count == 4 || dims_count == 5) &&
+                   sparsity.traversal_order != nullptr &&
+                   sparsity.traversal_order->size == dims_count;
+  for (int i = 0; supported && i < dims_count; ++i) {
+    supported = sparsity.traversal_order->data[i] == i &&
+                sparsity.dim_metadata[i].format ==
+                    (i == 3 ? kTfLiteDimSparseCSR : kTfLiteDimDense);
+  }
+  if (supported && dims_count == 5) {
+    supported = sparsity.block_map != nullptr &&
+                sparsity.block_map->size == 1 &&
+                sparsity.block_map->data[0] == 3;
+  }
+  TF_LITE_ENSURE_MSG(context, supported,
+                     "Unsupported sparse convolution filter format.");
+  return kTfLiteOk;
+}
+
 // Allocate temporary tensors (`im2col`, `hwcn_weights` if necessary).
 // Note: `context->AddTensors` might invalidate pointers to existing tensors.
 // Therefore the logic to add tensors are isolated into this function.
@@ -367,6 +411,10 @@ TfLiteStatus Prepare(KernelType kernel_type, TfLiteContext* context,
       (input->type == kTfLiteFloat32 &&
        (filter->type == kTfLiteUInt8 || filter->type == kTfLiteInt8));
 
+  if (filter->sparsity != nullptr) {
+    TF_LITE_ENSURE_STATUS(CheckSparseFilter(context, params, input, filter));
+  }
+
   if (is_hybrid && filter->type == kTfLiteInt8 &&
       filter->quantization.type == kTfLiteAffineQuantization &&
       filter->quantization.params &&
@@ -386,11 +434,13 @@ TfLiteStatus Prepare(KernelType kernel_type, TfLiteContext* context,
     }
   }
 
-  // The multi-threaded kernel supports neither dilation nor hybrid kernels, and
-  // is incompatible with mutable input filters that might change between evals.
+  // The multi-threaded kernel supports neither dilation nor hybrid kernels nor
+  // sparse filters, and is incompatible with mutable input filters that might
+  // change between evals.
   data->supports_multithreaded_kernel =
       (kernel_type == kMultithreadOptimized) &&
       (context->recommended_num_threads != 1) && !is_hybrid &&
+      (filter->sparsity == nullptr) &&
       (params->dilation_width_factor == 1) &&
       (params->dilation_height_factor == 1) &&
       (filter->allocation_type != kTfLiteArenaRw) &&
@@ -985,6 +1035,128 @@ TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
   return kTfLiteOk;
 }
 
+// Evaluates a pointwise convolution with a sparse filter (see
+// CheckSparseFilter) as a fully-connected layer. The reference kernel
+// densifies the filter and runs the dense convolution instead.
+template <KernelType kernel_type>
+TfLiteStatus EvalSparse(TfLiteContext* context, TfLiteNode* node,
+                        TfLiteConvParams* params, OpData* data,
+                        const TfLiteTensor* input, const TfLiteTensor* filter,
+                        const TfLiteTensor* bias, TfLiteTensor* output) {
+  const TfLiteSparsity& sparsity = *filter->sparsity;
+  const int channels_in = SizeOfDimension(filter, 3);
+  const int channels_out = SizeOfDimension(filter, 0);
+  const int pixels = NumElements(input) / channels_in;
+
+  if (kernel_type == kReference) {
+    ConvParams op_params;
+    op_params.padding_type = RuntimePaddingType(params->padding);
+    op_params.padding_values.width = data->padding.width;
+    op_params.padding_values.height = data->padding.height;
+    op_params.stride_width = params->stride_width;
+    op_params.stride_height = params->stride_height;
+    op_params.dilation_width_factor = params->dilation_width_factor;
+    op_params.dilation_height_factor = params->dilation_height_factor;
+    if (input->type == kTfLiteFloat32) {
+      CalculateActivationRange(params->activation,
+                               &op_params.float_activation_min,
+                               &op_params.float_activation_max);
+      std::vector<float> dense_filter(NumElements(filter));
+      reference_ops::Densify(&sparsity, GetTensorShape(filter),
+                             GetTensorData<float>(filter),
+                             GetTensorShape(filter), dense_filter.data(),
+                             context);
+      reference_ops::Conv(op_params, GetTensorShape(input),
+                          GetTensorData<float>(input), GetTensorShape(filter),
+                          dense_filter.data(), GetTensorShape(bias),
+                          GetTensorData<float>(bias), GetTensorShape(output),
+                          GetTensorData<float>(output), RuntimeShape(),
+                          nullptr);
+    } else {
+      op_params.input_offset = -input->params.zero_point;
+      op_params.output_offset = output->params.zero_point;
+      op_params.quantized_activation_min = data->output_activation_min;
+      op_params.quantized_activation_max = data->output_activation_max;
+      std::vector<int8_t> dense_filter(NumElements(filter));
+      reference_ops::Densify(&sparsity, GetTensorShape(filter),
+                             GetTensorData<int8_t>(filter),
+                             GetTensorShape(filter), dense_filter.data(),
+                             context);
+      reference_integer_ops::ConvPerChannel(
+          op_params, data->per_channel_output_multiplier.data(),
+          data->per_channel_output_shift.data(), GetTensorShape(input),
+          GetTensorData<int8>(input), GetTensorShape(filter),
+          dense_filter.data(), GetTensorShape(bias),
+          GetTensorData<int32>(bias), GetTensorShape(output),
+          GetTensorData<int8>(output));
+    }
+    return kTfLiteOk;
+  }
+
+  // View the [channels_out, 1, 1, channels_in] filter as a 2D matrix. The
+  // sparse fully-connected kernels only read the dimension metadata.
+  const bool is_block_sparse = sparsity.dim_metadata_size == 5;
+  TfLiteDimensionMetadata fc_dim_metadata[3] = {sparsity.dim_metadata[0],
+                                                sparsity.dim_metadata[3]};
+  if (is_block_sparse) fc_dim_metadata[2] = sparsity.dim_metadata[4];
+  TfLiteSparsity fc_sparsity = {};
+  fc_sparsity.dim_metadata = fc_dim_metadata;
+  fc_sparsity.dim_metadata_size = is_block_sparse ? 3 : 2;
+  const int block_size = is_block_sparse ? fc_dim_metadata[2].dense_size : 1;
+
+  const RuntimeShape fc_input_shape({pixels, channels_in});
+  const RuntimeShape fc_filter_shape({channels_out, channels_in});
+  const RuntimeShape fc_output_shape({pixels, channels_out});
+  CpuBackendContext* cpu_backend_context =
+      CpuBackendContext::GetFromContext(context);
+  FullyConnectedParams op_params;
+  if (input->type == kTfLiteFloat32) {
+    CalculateActivationRange(params->activation,
+                             &op_params.float_activation_min,
+                             &op_params.float_activation_max);
+    if (!is_block_sparse) {
+      optimized_ops::FullyConnectedSparseWeight(
+          fc_sparsity, op_params, fc_input_shape, GetTensorData<float>(input),
+          fc_filter_shape, GetTensorData<float>(filter), GetTensorShape(bias),
+          GetTensorData<float>(bias), fc_output_shape,
+          GetTensorData<float>(output));
+      return kTfLiteOk;
+    } else if (block_size == 4) {
+      optimized_ops::FullyConnectedSparseWeight1x4(
+          fc_sparsity, op_params, fc_input_shape, GetTensorData<float>(input),
+          fc_filter_shape, GetTensorData<float>(filter), GetTensorShape(bias),
+          GetTensorData<float>(bias), fc_output_shape,
+          GetTensorData<float>(output), cpu_backend_context);
+      return kTfLiteOk;
+    } else if (block_size == 16) {
+      optimized_ops::FullyConnectedSparseWeight1x16(
+          fc_sparsity, op_params, fc_input_shape, GetTensorData<float>(input),
+          fc_filter_shape, GetTensorData<float>(filter), GetTensorShape(bias),
+          GetTensorData<float>(bias), fc_output_shape,
+          GetTensorData<float>(output), cpu_backend_context);
+      return kTfLiteOk;
+    }
+  } else if (block_size == 16) {
+    op_params.input_offset = -input->params.zero_point;
+    op_params.weights_offset = 0;
+    op_params.output_offset = output->params.zero_point;
+    op_params.output_multiplier = data->output_multiplier;
+    op_params.output_shift = data->output_shift;
+    op_params.quantized_activation_min = data->output_activation_min;
+    op_params.quantized_activation_max = data->output_activation_max;
+    optimized_ops::FullyConnectedSparseWeight1x16(
+        fc_sparsity, op_params, data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), fc_input_shape,
+        GetTensorData<int8_t>(input), fc_filter_shape,
+        GetTensorData<int8_t>(filter), GetTensorShape(bias),
+        GetTensorData<int32_t>(bias), fc_output_shape,
+        GetTensorData<int8_t>(output), cpu_backend_context);
+    return kTfLiteOk;
+  }
+  TF_LITE_KERNEL_LOG(context, "Unsupported sparse convolution filter format.");
+  return kTfLiteError;
+}
+
 template <KernelType kernel_type, TfLiteType input_type>
 TfLiteStatus EvalImpl(TfLiteContext* context, TfLiteNode* node) {
   auto* params = reinterpret_cast<TfLiteConvParams*>(node->builtin_data);
@@ -1012,6 +1184,11 @@ TfLiteStatus EvalImpl(TfLiteContext* context, TfLiteNode* node) {
     data->have_weights_been_transposed = true;
   }
 
+  if (filter->sparsity != nullptr) {
+    return EvalSparse<kernel_type>(context, node, params, data, input, filter,
+                                   bias, output);
+  }
+
   TFLITE_DCHECK_EQ(input_type, input->type);
   switch (input_type) {  // Already know in/outtypes are same.
     case kTfLiteFloat32:
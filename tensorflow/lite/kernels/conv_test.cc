@@ -1742,6 +1742,77 @@ TEST_P(QuantizedConvolutionOpTest, SimpleTestExplicitQuantizedOp) {
                              }));
 }
 
+class SparseConvolutionOpModel : public SingleOpModel {
+ public:
+  SparseConvolutionOpModel(TfLiteRegistration* registration,
+                           const TensorData& input, const TensorData& filter,
+                           const std::vector<float>& filter_data) {
+    input_ = AddInput(input);
+    filter_ = AddConstSparseInput(filter, filter_data);
+    bias_ = AddInput({TensorType_FLOAT32, {GetShape(filter_)[0]}});
+    output_ = AddOutput({TensorType_FLOAT32, {}});
+
+    SetBuiltinOp(BuiltinOperator_CONV_2D, BuiltinOptions_Conv2DOptions,
+                 CreateConv2DOptions(builder_, Padding_VALID, /*stride_w=*/1,
+                                     /*stride_h=*/1)
+                     .Union());
+    resolver_ = absl::make_unique<SingleOpResolver>(BuiltinOperator_CONV_2D,
+                                                    registration);
+    BuildInterpreter({GetShape(input_), GetShape(filter_), GetShape(bias_)},
+                     /*num_threads=*/-1, /*allow_fp32_relax_to_fp16=*/false,
+                     /*apply_delegate=*/false);
+  }
+
+  void SetBias(const std::vector<float>& data) { PopulateTensor(bias_, data); }
+  void SetInput(const std::vector<float>& data) {
+    PopulateTensor(input_, data);
+  }
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+  std::vector<int> GetOutputShape() { return GetTensorShape(output_); }
+
+ private:
+  int input_;
+  int filter_;
+  int bias_;
+  int output_;
+};
+
+TEST_P(ConvolutionOpTest, SparsePointwiseFloat32) {
+  // Three 1x1 filters over 16 input channels; the second one is all zeros.
+  std::vector<float> filter_data(3 * 16, 0);
+  for (int i = 0; i < 16; ++i) {
+    filter_data[i] = 1;
+    if (i < 4) filter_data[2 * 16 + i] = 2;
+  }
+  std::vector<float> input(2 * 16, 1);
+  for (int i = 0; i < 16; ++i) {
+    input[16 + i] = i;
+  }
+
+  // Element-wise, 1x4 and 1x16 block sparsity along the input channels.
+  for (int block_size : {0, 4, 16}) {
+    TensorData filter = {TensorType_FLOAT32, {3, 1, 1, 16}};
+    filter.format = {kTfLiteDimDense, kTfLiteDimDense, kTfLiteDimDense,
+                     kTfLiteDimSparseCSR};
+    filter.traversal_order = {0, 1, 2, 3};
+    if (block_size > 0) {
+      filter.traversal_order.push_back(4);
+      filter.block_map = {3};
+      filter.block_size = {block_size};
+    }
+    SparseConvolutionOpModel m(GetRegistration(),
+                               {TensorType_FLOAT32, {1, 1, 2, 16}}, filter,
+                               filter_data);
+    m.SetBias({1, 2, 3});
+    m.SetInput(input);
+
+    m.Invoke();
+
+    EXPECT_THAT(m.GetOutputShape(), ElementsAreArray({1, 1, 2, 3}));
+    EXPECT_THAT(m.GetOutput(), ElementsAreArray({17, 2, 11, 121, 2, 15}));
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ConvolutionOpTest, ConvolutionOpTest,
     ::testing::ValuesIn(SingleOpTest::GetKernelTags(*kKernelMap)));
@@ -441,10 +441,11 @@ TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
 
 namespace {
 template <KernelType kernel_type>
-void FullyConnectedInt8(const OpData* data, const TfLiteTensor* input,
-                        const TfLiteTensor* filter, const TfLiteTensor* bias,
-                        TfLiteTensor* output,
-                        CpuBackendContext* cpu_backend_context) {
+TfLiteStatus FullyConnectedInt8(TfLiteContext* context, const OpData* data,
+                                const TfLiteTensor* input,
+                                const TfLiteTensor* filter,
+                                const TfLiteTensor* bias, TfLiteTensor* output,
+                                CpuBackendContext* cpu_backend_context) {
   FullyConnectedParams op_params;
   op_params.input_offset = -input->params.zero_point;
   op_params.weights_offset = -filter->params.zero_point;
@@ -455,7 +456,33 @@ void FullyConnectedInt8(const OpData* data, const TfLiteTensor* input,
   op_params.quantized_activation_max = data->output_activation_max;
   op_params.lhs_cacheable = IsConstantTensor(filter);
   op_params.rhs_cacheable = IsConstantTensor(input);
-  if (kernel_type == kReference) {
+  if (filter->sparsity != nullptr) {
+    const auto& sparsity = *filter->sparsity;
+    if (kernel_type == kReference) {
+      reference_ops::FullyConnectedSparseWeight(
+          sparsity, op_params, GetTensorShape(input),
+          GetTensorData<int8_t>(input), GetTensorShape(filter),
+          GetTensorData<int8_t>(filter), GetTensorShape(bias),
+          GetTensorData<int32_t>(bias), GetTensorShape(output),
+          GetTensorData<int8_t>(output));
+    } else if (SupportedSparsityFormat(sparsity) &&
+               sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse &&
+               sparsity.dim_metadata[2].dense_size == 16 &&
+               op_params.weights_offset == 0) {
+      // Block sparse with block size of 1x16 and symmetric weights.
+      optimized_ops::FullyConnectedSparseWeight1x16(
+          sparsity, op_params, /*per_channel_multiplier=*/nullptr,
+          /*per_channel_shift=*/nullptr, GetTensorShape(input),
+          GetTensorData<int8_t>(input), GetTensorShape(filter),
+          GetTensorData<int8_t>(filter), GetTensorShape(bias),
+          GetTensorData<int32_t>(bias), GetTensorShape(output),
+          GetTensorData<int8_t>(output), cpu_backend_context);
+    } else {
+      TF_LITE_KERNEL_LOG(context,
+                         "Unsupported sparse fully-connected weight format.");
+      return kTfLiteError;
+    }
+  } else if (kernel_type == kReference) {
     reference_integer_ops::FullyConnected(
         op_params, GetTensorShape(input), GetTensorData<int8_t>(input),
         GetTensorShape(filter), GetTensorData<int8_t>(filter),
@@ -469,6 +496,7 @@ void FullyConnectedInt8(const OpData* data, const TfLiteTensor* input,
         GetTensorShape(output), GetTensorData<int8_t>(output),
         cpu_backend_context);
   }
+  return kTfLiteOk;
 }
 }  // namespace
 
@@ -549,9 +577,10 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
         }
         break;
       case kTfLiteInt8:
-        FullyConnectedInt8<kernel_type>(
-            data, input, filter, bias, output,
-            CpuBackendContext::GetFromContext(context));
+        TF_LITE_ENSURE_OK(context,
+                          FullyConnectedInt8<kernel_type>(
+                              context, data, input, filter, bias, output,
+                              CpuBackendContext::GetFromContext(context)));
         break;
       case kTfLiteInt16:
         if (input->type == kTfLiteInt16) {
@@ -694,6 +723,16 @@ TfLiteStatus EvalFloat(TfLiteContext* context, TfLiteNode* node,
             GetTensorData<float>(bias), GetTensorShape(output),
             GetTensorData<float>(output),
             CpuBackendContext::GetFromContext(context));
+      } else if (sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse &&
+                 sparsity.dim_metadata[2].dense_size == 16) {
+        // Block sparse with block size of 1x16.
+        optimized_ops::FullyConnectedSparseWeight1x16(
+            sparsity, op_params, GetTensorShape(input),
+            GetTensorData<float>(input), GetTensorShape(filter),
+            GetTensorData<float>(filter), GetTensorShape(bias),
+            GetTensorData<float>(bias), GetTensorShape(output),
+            GetTensorData<float>(output),
+            CpuBackendContext::GetFromContext(context));
       } else {
         TF_LITE_KERNEL_LOG(context,
                            "Unsupported sparse fully-connected weight format.");
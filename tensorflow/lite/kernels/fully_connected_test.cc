@@ -1355,6 +1355,120 @@ TEST_P(SparseFullyConnectedOpTest, Simple1x4TestMultiThreadedMoreBatches) {
                                            ));
   }
 }
+
+TEST_P(SparseFullyConnectedOpTest, Simple1x16Test) {
+  // Only the first block of u = 0 and the second block of u = 1 are set.
+  std::vector<float> weight_data(3 * 32, 0);
+  for (int i = 0; i < 16; ++i) {
+    weight_data[i] = 1;
+    weight_data[32 + 16 + i] = i % 2 ? -1 : 2;
+  }
+  TensorData weight = {};
+  weight.type = TensorType_FLOAT32;
+  weight.shape = {3, 32};
+  weight.traversal_order = {0, 1, 2};
+  weight.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  weight.block_map = {1};
+  weight.block_size = {16};
+  for (int num_threads = 1; num_threads <= 2; num_threads++) {
+    SparseFullyConnectedOpModel<float> m(
+        GetRegistration(),
+        /*units=*/3, /*batches=*/2,
+        /*input=*/{TensorType_FLOAT32, {2, 32}}, weight, weight_data,
+        num_threads);
+    m.SetBias({1, 2, 3});
+
+    // b = 0 is all ones, b = 1 is 2 in its first and -1.5 in its second half.
+    std::vector<float> input(2 * 32, 1);
+    std::fill(input.begin() + 32, input.begin() + 48, 2);
+    std::fill(input.begin() + 48, input.end(), -1.5);
+    m.SetInput(input);
+
+    m.Invoke();
+
+    EXPECT_THAT(m.GetOutputShape(), ElementsAre(2, 3));
+    EXPECT_THAT(m.GetOutput(), ElementsAre(17, 10, 3, 33, 0, 3));
+  }
+}
+
+class SparseQuantizedFullyConnectedOpModel : public SingleOpModel {
+ public:
+  SparseQuantizedFullyConnectedOpModel(TfLiteRegistration* registration,
+                                       int units, const TensorData& input,
+                                       const TensorData& weights,
+                                       const std::vector<int8_t>& weights_data,
+                                       const TensorData& output,
+                                       int num_threads = 1) {
+    input_ = AddInput(input);
+    weights_ = AddConstSparseInput(weights, weights_data);
+    bias_ = AddInput({TensorType_INT32,
+                      {units},
+                      0,
+                      0,
+                      GetScale(input_) * GetScale(weights_)});
+    output_ = AddOutput(output);
+
+    SetBuiltinOp(
+        BuiltinOperator_FULLY_CONNECTED, BuiltinOptions_FullyConnectedOptions,
+        CreateFullyConnectedOptions(builder_, ActivationFunctionType_RELU)
+            .Union());
+    resolver_ = absl::make_unique<SingleOpResolver>(
+        BuiltinOperator_FULLY_CONNECTED, registration);
+    BuildInterpreter({GetShape(input_), GetShape(weights_), GetShape(bias_)},
+                     num_threads, /*allow_fp32_relax_to_fp16=*/false,
+                     /*apply_delegate=*/false);
+  }
+  void SetBias(const std::vector<float>& data) {
+    QuantizeAndPopulate<int32_t>(bias_, data);
+  }
+  void SetInput(const std::vector<float>& data) {
+    QuantizeAndPopulate<int8_t>(input_, data);
+  }
+  std::vector<int8_t> GetOutput() { return ExtractVector<int8_t>(output_); }
+  std::vector<float> GetDequantizedOutput() {
+    return Dequantize<int8_t>(GetOutput(), GetScale(output_),
+                              GetZeroPoint(output_));
+  }
+
+ protected:
+  int input_;
+  int weights_;
+  int bias_;
+  int output_;
+};
+
+TEST_P(SparseFullyConnectedOpTest, Simple1x16TestQuantizedInt8) {
+  // Only the first block of u = 0 and the second block of u = 1 are set.
+  std::vector<int8_t> weight_data(3 * 32, 0);
+  for (int i = 0; i < 16; ++i) {
+    weight_data[i] = 1;
+    weight_data[32 + 16 + i] = i % 2 ? -1 : 2;
+  }
+  TensorData weight = {TensorType_INT8, {3, 32}, 0, 0, /*scale=*/1.0};
+  weight.traversal_order = {0, 1, 2};
+  weight.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  weight.block_map = {1};
+  weight.block_size = {16};
+  for (int num_threads = 1; num_threads <= 2; num_threads++) {
+    SparseQuantizedFullyConnectedOpModel m(
+        GetRegistration(), /*units=*/3,
+        /*input=*/{TensorType_INT8, {2, 32}, -63.5, 64}, weight, weight_data,
+        /*output=*/{TensorType_INT8, {}, -127, 128}, num_threads);
+    m.SetBias({1, 2, 3});
+
+    // b = 0 is all ones, b = 1 is 2 in its first and -1.5 in its second half.
+    std::vector<float> input(2 * 32, 1);
+    std::fill(input.begin() + 32, input.begin() + 48, 2);
+    std::fill(input.begin() + 48, input.end(), -1.5);
+    m.SetInput(input);
+
+    m.Invoke();
+
+    EXPECT_THAT(m.GetDequantizedOutput(),
+                ElementsAreArray(ArrayFloatNear({17, 10, 3, 33, 0, 3})));
+    EXPECT_THAT(m.GetOutput(), ElementsAre(16, 9, 2, 32, -1, 2));
+  }
+}
 // TODO(b/148391360): Add tests for unsupported sparsity format.
 // TEST_P(SparseFullyConnectedOpTest, TestUnsupportedSparsityFormat)
 
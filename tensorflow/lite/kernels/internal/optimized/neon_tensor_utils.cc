@@ -1030,6 +1030,30 @@ void NeonMatrixBatchVectorMultiplyAccumulate(
                                       output_zp, scratch, output);
 }
 
+void NeonMatrixBatchVectorMultiplyAccumulateGates(
+    const int8_t* input, const int32_t* bias, const int8_t* gate_weights,
+    const int32_t* multipliers, const int32_t* shifts, int32_t n_gates,
+    int32_t n_batch, int32_t n_input, int32_t n_output, int32_t* scratch,
+    int16_t* const* outputs, CpuBackendContext* context) {
+  const int32_t n_rows = n_gates * n_output;
+#ifdef TFLITE_WITH_RUY_GEMV
+  NeonCpuBackendGemm(input, bias, gate_weights, n_batch, n_input, n_rows,
+                     /*output_zp=*/0, scratch, context);
+#else
+  NeonMatrixBatchVectorMultiplyImpl(input, bias, gate_weights, n_batch,
+                                    n_input, n_rows, /*output_zp=*/0, scratch);
+#endif
+  // Each batch of scratch holds the accumulators of all gates back to back.
+  for (int batch = 0; batch < n_batch; ++batch) {
+    for (int gate = 0; gate < n_gates; ++gate) {
+      NeonMatrixBatchVectorAccumulateImpl(
+          multipliers[gate], shifts[gate], /*n_batch=*/1, n_output,
+          /*output_zp=*/0, scratch + (batch * n_gates + gate) * n_output,
+          outputs[gate] + batch * n_output);
+    }
+  }
+}
+
 void NeonMatrixBatchVectorMultiplyAccumulate(const int8_t* __restrict__ matrix,
                                              const int m_rows, const int m_cols,
                                              const int8_t* __restrict__ vectors,
@@ -1926,6 +1950,95 @@ void NeonSparseMatrixBatchVectorMultiplyAccumulate1x4(
   }
 }
 
+void NeonSparseMatrixBatchVectorMultiplyAccumulate1x16(
+    const float* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const float* __restrict__ vector, int n_batch, float* __restrict__ result) {
+  const int kBlockSize = 16;
+  TFLITE_DCHECK_EQ(m_cols % kBlockSize, 0);
+
+  for (int batch = 0; batch < n_batch; batch++) {
+    const float* matrix_ptr = matrix;
+    for (int row = 0; row < m_rows; row++) {
+      float32x4_t acc_32x4 = vmovq_n_f32(0.0);
+      const float* vector_in_batch = vector + batch * m_cols;
+
+      for (int i = segments[row]; i < segments[row + 1]; i++) {
+        const float* vector_block_in_batch_ptr =
+            vector_in_batch + indices[i] * kBlockSize;
+        // The block spans four float32x4 registers.
+        for (int c = 0; c < kBlockSize; c += kFloatValuesPerNeonVector) {
+          const float32x4_t vector_f32x4 =
+              vld1q_f32(vector_block_in_batch_ptr + c);
+          const float32x4_t matrix_f32x4 = vld1q_f32(matrix_ptr + c);
+          acc_32x4 = vmlaq_f32(acc_32x4, matrix_f32x4, vector_f32x4);
+        }
+        matrix_ptr += kBlockSize;
+      }
+      result[batch * m_rows + row] += AccumulateNeonLane(acc_32x4);
+    }
+  }
+}
+
+void NeonSparseMatrixBatchVectorMultiplyAccumulate1x16(
+    const int8_t* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const int8_t* __restrict__ vector, const int32_t* __restrict__ bias_vector,
+    int n_batch, const int32_t input_offset, const int32_t output_multiplier,
+    const int32_t output_shift, const int32_t* per_channel_multiplier,
+    const int32_t* per_channel_shift, const int32_t output_offset,
+    const int32_t output_activation_min, const int32_t output_activation_max,
+    int8_t* __restrict__ result) {
+  const int kBlockSize = kInt8ValuesPerNeonVector;
+  TFLITE_DCHECK_EQ(m_cols % kBlockSize, 0);
+  const int16x8_t input_offset_16x8 = vdupq_n_s16(input_offset);
+
+  for (int batch = 0; batch < n_batch; ++batch) {
+    const int8_t* matrix_ptr = matrix;
+    for (int row = 0; row < m_rows; ++row) {
+      int32x4_t acc_32x4 = vmovq_n_s32(0);
+      const int8_t* vector_in_batch = vector + batch * m_cols;
+
+      for (int i = segments[row]; i < segments[row + 1]; ++i) {
+        // One block is exactly one int8x16 register. The input offset is
+        // folded into the widened vector, which cannot overflow int16.
+        const int8x16_t vector_8x16 =
+            vld1q_s8(vector_in_batch + indices[i] * kBlockSize);
+        const int8x16_t matrix_8x16 = vld1q_s8(matrix_ptr);
+        const int16x8_t vector_lo_16x8 = vaddq_s16(
+            vmovl_s8(vget_low_s8(vector_8x16)), input_offset_16x8);
+        const int16x8_t vector_hi_16x8 = vaddq_s16(
+            vmovl_s8(vget_high_s8(vector_8x16)), input_offset_16x8);
+        const int16x8_t matrix_lo_16x8 = vmovl_s8(vget_low_s8(matrix_8x16));
+        const int16x8_t matrix_hi_16x8 = vmovl_s8(vget_high_s8(matrix_8x16));
+        acc_32x4 = vmlal_s16(acc_32x4, vget_low_s16(matrix_lo_16x8),
+                             vget_low_s16(vector_lo_16x8));
+        acc_32x4 = vmlal_s16(acc_32x4, vget_high_s16(matrix_lo_16x8),
+                             vget_high_s16(vector_lo_16x8));
+        acc_32x4 = vmlal_s16(acc_32x4, vget_low_s16(matrix_hi_16x8),
+                             vget_low_s16(vector_hi_16x8));
+        acc_32x4 = vmlal_s16(acc_32x4, vget_high_s16(matrix_hi_16x8),
+                             vget_high_s16(vector_hi_16x8));
+        matrix_ptr += kBlockSize;
+      }
+
+      int32_t dot_prod = AccumulateNeonLane(acc_32x4);
+      if (bias_vector != nullptr) {
+        dot_prod += bias_vector[row];
+      }
+      dot_prod = MultiplyByQuantizedMultiplier(
+          dot_prod,
+          per_channel_multiplier ? per_channel_multiplier[row]
+                                 : output_multiplier,
+          per_channel_shift ? per_channel_shift[row] : output_shift);
+      dot_prod += output_offset;
+      result[batch * m_rows + row] =
+          static_cast<int8_t>(ActivationFunctionWithMinMax(
+              dot_prod, output_activation_min, output_activation_max));
+    }
+  }
+}
+
 void NeonSparseMatrixBatchVectorMultiplyAccumulate(
     const float* __restrict__ matrix, const uint8_t* __restrict__ ledger,
     int m_rows, int m_cols, const float* __restrict__ vector, int n_batch,
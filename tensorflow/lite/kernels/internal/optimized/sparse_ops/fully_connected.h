@@ -73,15 +73,19 @@ inline void FullyConnectedSparseWeight(
   }
 }
 
-inline void FullyConnectedSparseWeight1x4Impl(
+template <int kBlockSize>
+inline void FullyConnectedSparseWeight1xNImpl(
     const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
     const RuntimeShape& input_shape, const float* input_data,
     const RuntimeShape& weights_shape, const float* weights_data,
     const RuntimeShape& bias_shape, const float* bias_data,
     const RuntimeShape& output_shape, float* output_data, int thread_start,
     int thread_end, const CpuBackendContext& cpu_backend_context) {
+  static_assert(kBlockSize == 4 || kBlockSize == 16,
+                "Only 1x4 and 1x16 blocks are supported.");
   ruy::profiler::ScopeLabel label("FullyConnected");
-  ruy::profiler::ScopeLabel inner_label("1x4 Block Sparse");
+  ruy::profiler::ScopeLabel inner_label(kBlockSize == 4 ? "1x4 Block Sparse"
+                                                        : "1x16 Block Sparse");
   const float output_activation_min = params.float_activation_min;
   const float output_activation_max = params.float_activation_max;
 
@@ -96,10 +100,17 @@ inline void FullyConnectedSparseWeight1x4Impl(
   const int* w1_segments = sparsity.dim_metadata[1].array_segments->data;
   const int* w1_indices = sparsity.dim_metadata[1].array_indices->data;
 
-  tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1x4(
-      weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
-      weights_shape.Dims(1), input_data + thread_start * input_depth, batches,
-      output_data + thread_start * output_depth);
+  if (kBlockSize == 4) {
+    tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1x4(
+        weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
+        weights_shape.Dims(1), input_data + thread_start * input_depth,
+        batches, output_data + thread_start * output_depth);
+  } else {
+    tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1x16(
+        weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
+        weights_shape.Dims(1), input_data + thread_start * input_depth,
+        batches, output_data + thread_start * output_depth);
+  }
 
   ruy::profiler::ScopeLabel activation_label("activation function");
   for (int b = thread_start; b < thread_end; ++b) {
@@ -112,8 +123,9 @@ inline void FullyConnectedSparseWeight1x4Impl(
   }
 }
 
-struct FullyConnectedSparseWeight1x4Task : cpu_backend_threadpool::Task {
-  FullyConnectedSparseWeight1x4Task(
+template <int kBlockSize>
+struct FullyConnectedSparseWeight1xNTask : cpu_backend_threadpool::Task {
+  FullyConnectedSparseWeight1xNTask(
       const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
       const RuntimeShape& input_shape, const float* input_data,
       const RuntimeShape& weights_shape, const float* weights_data,
@@ -135,7 +147,7 @@ struct FullyConnectedSparseWeight1x4Task : cpu_backend_threadpool::Task {
         cpu_backend_context(cpu_backend_context_x) {}
 
   void Run() override {
-    FullyConnectedSparseWeight1x4Impl(
+    FullyConnectedSparseWeight1xNImpl<kBlockSize>(
         sparsity, params, input_shape, input_data, weights_shape, weights_data,
         bias_shape, bias_data, output_shape, output_data, thread_start,
         thread_end, cpu_backend_context);
@@ -161,7 +173,8 @@ struct FullyConnectedSparseWeight1x4Task : cpu_backend_threadpool::Task {
 // there's not enough batches of data, the number of threads used is equal to
 // the batch size. We can improve this later with slicing along the row
 // dimension of the weight.
-inline void FullyConnectedSparseWeight1x4(
+template <int kBlockSize>
+inline void FullyConnectedSparseWeight1xN(
     const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
     const RuntimeShape& input_shape, const float* input_data,
     const RuntimeShape& weights_shape, const float* weights_data,
@@ -176,12 +189,12 @@ inline void FullyConnectedSparseWeight1x4(
       FlatSizeSkipDim(output_shape, output_shape.DimensionsCount() - 1);
   const int thread_count = std::max(1, std::min(batches, max_threads));
   if (thread_count == 1) {
-    return FullyConnectedSparseWeight1x4Impl(
+    return FullyConnectedSparseWeight1xNImpl<kBlockSize>(
         sparsity, params, input_shape, input_data, weights_shape, weights_data,
         bias_shape, bias_data, output_shape, output_data, 0, batches,
         *cpu_backend_context);
   }
-  std::vector<FullyConnectedSparseWeight1x4Task> tasks;
+  std::vector<FullyConnectedSparseWeight1xNTask<kBlockSize>> tasks;
   tasks.reserve(thread_count);
   int thread_start = 0;
   for (int i = 0; i < thread_count; ++i) {
@@ -201,6 +214,150 @@ inline void FullyConnectedSparseWeight1x4(
                                   cpu_backend_context);
 }
 
+inline void FullyConnectedSparseWeight1x4(
+    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+    const RuntimeShape& input_shape, const float* input_data,
+    const RuntimeShape& weights_shape, const float* weights_data,
+    const RuntimeShape& bias_shape, const float* bias_data,
+    const RuntimeShape& output_shape, float* output_data,
+    CpuBackendContext* cpu_backend_context) {
+  FullyConnectedSparseWeight1xN<4>(
+      sparsity, params, input_shape, input_data, weights_shape, weights_data,
+      bias_shape, bias_data, output_shape, output_data, cpu_backend_context);
+}
+
+inline void FullyConnectedSparseWeight1x16(
+    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+    const RuntimeShape& input_shape, const float* input_data,
+    const RuntimeShape& weights_shape, const float* weights_data,
+    const RuntimeShape& bias_shape, const float* bias_data,
+    const RuntimeShape& output_shape, float* output_data,
+    CpuBackendContext* cpu_backend_context) {
+  FullyConnectedSparseWeight1xN<16>(
+      sparsity, params, input_shape, input_data, weights_shape, weights_data,
+      bias_shape, bias_data, output_shape, output_data, cpu_backend_context);
+}
+
+// Fully quantized version of the 1x16 block sparse kernel. The weights must be
+// symmetrically quantized. `per_channel_multiplier` and `per_channel_shift`
+// are optional and override the per-tensor requantization parameters in
+// `params` when set.
+inline void FullyConnectedSparseWeight1x16Impl(
+    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+    const int32_t* per_channel_multiplier, const int32_t* per_channel_shift,
+    const RuntimeShape& input_shape, const int8_t* input_data,
+    const RuntimeShape& weights_shape, const int8_t* weights_data,
+    const RuntimeShape& bias_shape, const int32_t* bias_data,
+    const RuntimeShape& output_shape, int8_t* output_data, int thread_start,
+    int thread_end) {
+  ruy::profiler::ScopeLabel label("FullyConnectedInt8");
+  ruy::profiler::ScopeLabel inner_label("1x16 Block Sparse");
+  TFLITE_DCHECK_EQ(params.weights_offset, 0);
+
+  const int input_dims_count = input_shape.DimensionsCount();
+  const int output_dims_count = output_shape.DimensionsCount();
+  const int weights_dims_count = weights_shape.DimensionsCount();
+  const int input_depth = MatchingDim(weights_shape, weights_dims_count - 1,
+                                      input_shape, input_dims_count - 1);
+  const int output_depth = MatchingDim(weights_shape, weights_dims_count - 2,
+                                       output_shape, output_dims_count - 1);
+  const int* w1_segments = sparsity.dim_metadata[1].array_segments->data;
+  const int* w1_indices = sparsity.dim_metadata[1].array_indices->data;
+
+  tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1x16(
+      weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
+      weights_shape.Dims(1), input_data + thread_start * input_depth,
+      bias_data, thread_end - thread_start, params.input_offset,
+      params.output_multiplier, params.output_shift, per_channel_multiplier,
+      per_channel_shift, params.output_offset, params.quantized_activation_min,
+      params.quantized_activation_max,
+      output_data + thread_start * output_depth);
+}
+
+struct FullyConnectedSparseWeight1x16Int8Task : cpu_backend_threadpool::Task {
+  FullyConnectedSparseWeight1x16Int8Task(
+      const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+      const int32_t* per_channel_multiplier, const int32_t* per_channel_shift,
+      const RuntimeShape& input_shape, const int8_t* input_data,
+      const RuntimeShape& weights_shape, const int8_t* weights_data,
+      const RuntimeShape& bias_shape, const int32_t* bias_data,
+      const RuntimeShape& output_shape, int8_t* output_data, int thread_start,
+      int thread_end)
+      : sparsity(sparsity),
+        params(params),
+        per_channel_multiplier(per_channel_multiplier),
+        per_channel_shift(per_channel_shift),
+        input_shape(input_shape),
+        input_data(input_data),
+        weights_shape(weights_shape),
+        weights_data(weights_data),
+        bias_shape(bias_shape),
+        bias_data(bias_data),
+        output_shape(output_shape),
+        output_data(output_data),
+        thread_start(thread_start),
+        thread_end(thread_end) {}
+
+  void Run() override {
+    FullyConnectedSparseWeight1x16Impl(
+        sparsity, params, per_channel_multiplier, per_channel_shift,
+        input_shape, input_data, weights_shape, weights_data, bias_shape,
+        bias_data, output_shape, output_data, thread_start, thread_end);
+  }
+
+ private:
+  const TfLiteSparsity& sparsity;
+  const FullyConnectedParams& params;
+  const int32_t* per_channel_multiplier;
+  const int32_t* per_channel_shift;
+  const RuntimeShape& input_shape;
+  const int8_t* input_data;
+  const RuntimeShape& weights_shape;
+  const int8_t* weights_data;
+  const RuntimeShape& bias_shape;
+  const int32_t* bias_data;
+  const RuntimeShape& output_shape;
+  int8_t* output_data;
+  int thread_start;
+  int thread_end;
+};
+
+// Like the float kernels, the work is sliced along the batch dimension.
+inline void FullyConnectedSparseWeight1x16(
+    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+    const int32_t* per_channel_multiplier, const int32_t* per_channel_shift,
+    const RuntimeShape& input_shape, const int8_t* input_data,
+    const RuntimeShape& weights_shape, const int8_t* weights_data,
+    const RuntimeShape& bias_shape, const int32_t* bias_data,
+    const RuntimeShape& output_shape, int8_t* output_data,
+    CpuBackendContext* cpu_backend_context) {
+  const int max_threads = cpu_backend_context->max_num_threads();
+  const int batches =
+      FlatSizeSkipDim(output_shape, output_shape.DimensionsCount() - 1);
+  const int thread_count = std::max(1, std::min(batches, max_threads));
+  if (thread_count == 1) {
+    return FullyConnectedSparseWeight1x16Impl(
+        sparsity, params, per_channel_multiplier, per_channel_shift,
+        input_shape, input_data, weights_shape, weights_data, bias_shape,
+        bias_data, output_shape, output_data, 0, batches);
+  }
+  std::vector<FullyConnectedSparseWeight1x16Int8Task> tasks;
+  tasks.reserve(thread_count);
+  int thread_start = 0;
+  for (int i = 0; i < thread_count; ++i) {
+    int thread_end = thread_start + batches / thread_count;
+    if (i < batches % thread_count) thread_end++;
+
+    tasks.emplace_back(sparsity, params, per_channel_multiplier,
+                       per_channel_shift, input_shape, input_data,
+                       weights_shape, weights_data, bias_shape, bias_data,
+                       output_shape, output_data, thread_start, thread_end);
+    thread_start = thread_end;
+  }
+  cpu_backend_threadpool::Execute(tasks.size(), tasks.data(),
+                                  cpu_backend_context);
+}
+
 }  // namespace optimized_ops
 }  // namespace tflite
 #endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_SPARSE_OPS_FULLY_CONNECTED_H_
@@ -22,12 +22,15 @@ limitations under the License.
 #include <smmintrin.h>  // SSE4.1
 #endif
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 
 #include "ruy/profiler/instrumentation.h"  // from @ruy
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
+#include "tensorflow/lite/kernels/internal/common.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
 
 namespace tflite {
@@ -285,6 +288,33 @@ void SseMatrixBatchVectorMultiplyAccumulate(
       per_channel_scale, input_offset, row_sums);
 }
 
+void SseMatrixBatchVectorMultiplyAccumulateGates(
+    const int8_t* input, const int32_t* bias, const int8_t* gate_weights,
+    const int32_t* multipliers, const int32_t* shifts, int32_t n_gates,
+    int32_t n_batch, int32_t n_input, int32_t n_output, int32_t* scratch,
+    int16_t* const* outputs, CpuBackendContext* context) {
+  SseCpuBackendGemm(input, bias, gate_weights, n_batch, n_input,
+                    n_gates * n_output, /*output_zp=*/0, scratch, context);
+
+  ruy::profiler::ScopeLabel label("GatesMultiplyQuantizedMultiplier");
+  const int32_t output_min = std::numeric_limits<int16_t>::min();
+  const int32_t output_max = std::numeric_limits<int16_t>::max();
+  // Each batch of scratch holds the accumulators of all gates back to back.
+  for (int batch = 0; batch < n_batch; ++batch) {
+    for (int gate = 0; gate < n_gates; ++gate) {
+      const int32_t* acc = scratch + (batch * n_gates + gate) * n_output;
+      int16_t* output = outputs[gate] + batch * n_output;
+      for (int i = 0; i < n_output; ++i) {
+        int32_t value = MultiplyByQuantizedMultiplier(
+            acc[i], multipliers[gate], shifts[gate]);
+        value += output[i];
+        value = std::min(std::max(value, output_min), output_max);
+        output[i] = static_cast<int16_t>(value);
+      }
+    }
+  }
+}
+
 namespace {
 
 // Implements sparse-matrix - vector multiply-accumulate.
@@ -415,6 +445,69 @@ void SseSparseMatrixBatchVectorMultiplyAccumulate(
   }  // for batch
 }
 
+void SseSparseMatrixBatchVectorMultiplyAccumulate1x16(
+    const int8_t* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const int8_t* __restrict__ vector, const int32_t* __restrict__ bias_vector,
+    int n_batch, const int32_t input_offset, const int32_t output_multiplier,
+    const int32_t output_shift, const int32_t* per_channel_multiplier,
+    const int32_t* per_channel_shift, const int32_t output_offset,
+    const int32_t output_activation_min, const int32_t output_activation_max,
+    int8_t* __restrict__ result) {
+  static constexpr int kBlockSize = 16;
+  TFLITE_DCHECK_EQ(m_cols % kBlockSize, 0);
+  const __m128i zeros = _mm_setzero_si128();
+  const __m128i input_offset_16x8 = _mm_set1_epi16(input_offset);
+
+  for (int batch = 0; batch < n_batch; ++batch) {
+    const int8_t* matrix_ptr = matrix;
+    for (int row = 0; row < m_rows; ++row) {
+      __m128i acc_32x4 = _mm_setzero_si128();
+      const int8_t* vector_in_batch = vector + batch * m_cols;
+
+      for (int i = segments[row]; i < segments[row + 1]; ++i) {
+        // One block is exactly one XMM register. Sign-extend both operands to
+        // int16 (SSSE3 has no pmovsxbw) and fold the input offset into the
+        // vector before the multiply-add; the sum cannot overflow int16.
+        const __m128i vector_8x16 =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                vector_in_batch + indices[i] * kBlockSize));
+        const __m128i matrix_8x16 =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(matrix_ptr));
+        const __m128i vector_sign = _mm_cmpgt_epi8(zeros, vector_8x16);
+        const __m128i matrix_sign = _mm_cmpgt_epi8(zeros, matrix_8x16);
+        const __m128i vector_lo_16x8 = _mm_add_epi16(
+            _mm_unpacklo_epi8(vector_8x16, vector_sign), input_offset_16x8);
+        const __m128i vector_hi_16x8 = _mm_add_epi16(
+            _mm_unpackhi_epi8(vector_8x16, vector_sign), input_offset_16x8);
+        const __m128i matrix_lo_16x8 =
+            _mm_unpacklo_epi8(matrix_8x16, matrix_sign);
+        const __m128i matrix_hi_16x8 =
+            _mm_unpackhi_epi8(matrix_8x16, matrix_sign);
+        acc_32x4 = _mm_add_epi32(
+            acc_32x4, _mm_madd_epi16(matrix_lo_16x8, vector_lo_16x8));
+        acc_32x4 = _mm_add_epi32(
+            acc_32x4, _mm_madd_epi16(matrix_hi_16x8, vector_hi_16x8));
+        matrix_ptr += kBlockSize;
+      }
+
+      int32_t dot_prod = ReduceInt32x4(acc_32x4);
+      if (bias_vector != nullptr) {
+        dot_prod += bias_vector[row];
+      }
+      dot_prod = MultiplyByQuantizedMultiplier(
+          dot_prod,
+          per_channel_multiplier ? per_channel_multiplier[row]
+                                 : output_multiplier,
+          per_channel_shift ? per_channel_shift[row] : output_shift);
+      dot_prod += output_offset;
+      result[batch * m_rows + row] =
+          static_cast<int8_t>(ActivationFunctionWithMinMax(
+              dot_prod, output_activation_min, output_activation_max));
+    }
+  }
+}
+
 void SseReductionSumVector(const int8_t* input_vector, int32_t* output_vector,
                            const int output_size, const int reduction_size) {
   static constexpr std::intptr_t kBlockSize = 16;
@@ -79,6 +79,30 @@ void SparseMatrixBatchVectorMultiplyAccumulate1x4(
                    segments, indices, m_rows, m_cols, vector, n_batch, result);
 }
 
+void SparseMatrixBatchVectorMultiplyAccumulate1x16(
+    const float* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const float* __restrict__ vector, int n_batch, float* __restrict__ result) {
+  NEON_OR_PORTABLE(SparseMatrixBatchVectorMultiplyAccumulate1x16, matrix,
+                   segments, indices, m_rows, m_cols, vector, n_batch, result);
+}
+
+void SparseMatrixBatchVectorMultiplyAccumulate1x16(
+    const int8_t* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const int8_t* __restrict__ vector, const int32_t* __restrict__ bias_vector,
+    int n_batch, const int32_t input_offset, const int32_t output_multiplier,
+    const int32_t output_shift, const int32_t* per_channel_multiplier,
+    const int32_t* per_channel_shift, const int32_t output_offset,
+    const int32_t output_activation_min, const int32_t output_activation_max,
+    int8_t* __restrict__ result) {
+  SSE_OR_PORTABLE(SparseMatrixBatchVectorMultiplyAccumulate1x16, matrix,
+                  segments, indices, m_rows, m_cols, vector, bias_vector,
+                  n_batch, input_offset, output_multiplier, output_shift,
+                  per_channel_multiplier, per_channel_shift, output_offset,
+                  output_activation_min, output_activation_max, result);
+}
+
 void SparseMatrixBatchVectorMultiplyAccumulate(
     const float* __restrict__ matrix, const uint8_t* __restrict__ ledger,
     int m_rows, int m_cols, const float* __restrict__ vector, int n_batch,
@@ -106,6 +130,16 @@ void MatrixBatchVectorMultiplyAccumulate(
       shift, n_batch, n_input, n_output, output_zp, scratch, output, context);
 }
 
+void MatrixBatchVectorMultiplyAccumulateGates(
+    const int8_t* input, const int32_t* bias, const int8_t* gate_weights,
+    const int32_t* multipliers, const int32_t* shifts, int32_t n_gates,
+    int32_t n_batch, int32_t n_input, int32_t n_output, int32_t* scratch,
+    int16_t* const* outputs, CpuBackendContext* context) {
+  SSE_OR_PORTABLE(MatrixBatchVectorMultiplyAccumulateGates, input, bias,
+                  gate_weights, multipliers, shifts, n_gates, n_batch, n_input,
+                  n_output, scratch, outputs, context);
+}
+
 void MatrixBatchVectorMultiplyAccumulate(
     const int8_t* input, const int32_t* input_zeropoint_times_weights,
     const int8_t* input_to_gate_weights, int32_t multiplier, int32_t shift,
@@ -106,6 +106,31 @@ void SparseMatrixBatchVectorMultiplyAccumulate1x4(
     const int32_t* __restrict__ indices, int m_rows, int m_cols,
     const float* __restrict__ vector, int n_batch, float* __restrict__ result);
 
+// Same as the function above, but with block pattern 1x16.
+// This function assumes that m_cols is a multiple of the block size (16 in
+// this case) so that there's no incomplete block.
+void SparseMatrixBatchVectorMultiplyAccumulate1x16(
+    const float* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const float* __restrict__ vector, int n_batch, float* __restrict__ result);
+
+// Same as the function above, but for fully quantized int8 matrices and
+// vectors. The int32 accumulators are offset by `bias_vector` (may be null),
+// requantized with `output_multiplier` and `output_shift` (or per row with
+// `per_channel_multiplier` and `per_channel_shift` when those are non-null),
+// shifted by `output_offset` and clamped to the activation range, so `result`
+// is overwritten with the final int8 outputs instead of accumulated into.
+// The matrix must be symmetrically quantized (zero point of 0).
+void SparseMatrixBatchVectorMultiplyAccumulate1x16(
+    const int8_t* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const int8_t* __restrict__ vector, const int32_t* __restrict__ bias_vector,
+    int n_batch, const int32_t input_offset, const int32_t output_multiplier,
+    const int32_t output_shift, const int32_t* per_channel_multiplier,
+    const int32_t* per_channel_shift, const int32_t output_offset,
+    const int32_t output_activation_min, const int32_t output_activation_max,
+    int8_t* __restrict__ result);
+
 // Same as the function above, but the matrix is stored in block compressed
 // sparse row format with block pattern 1x16 which consists of two arrays:
 //   1. A matrix array stores non-zero blocks of the matrix in row major.
@@ -231,6 +256,19 @@ void MatrixBatchVectorMultiplyAccumulate(
     int32_t n_batch, int32_t n_input, int32_t n_output, int32_t output_zp,
     int32_t* scratch, int16_t* output, CpuBackendContext* context);
 
+// Same as the function above, but for the weights of several gates stacked
+// row-wise into one [n_gates * n_output, n_input] matrix, multiplied by the
+// input with a single matrix multiplication. The result of gate g is
+// requantized with multipliers[g] and shifts[g] and accumulated into the
+// [n_batch, n_output] buffer outputs[g]. `bias` holds n_gates * n_output
+// entries stacked the same way, the output zero point is 0, and scratch must
+// hold n_batch * n_gates * n_output entries.
+void MatrixBatchVectorMultiplyAccumulateGates(
+    const int8_t* input, const int32_t* bias, const int8_t* gate_weights,
+    const int32_t* multipliers, const int32_t* shifts, int32_t n_gates,
+    int32_t n_batch, int32_t n_input, int32_t n_output, int32_t* scratch,
+    int16_t* const* outputs, CpuBackendContext* context);
+
 // Multiplies a matrix by a "batched" vector (i.e. a matrix with a batch
 // dimension composed by input vectors independent from each other). The result
 // of the multiplication is accumulated to the passed result buffer.
@@ -16,6 +16,10 @@ limitations under the License.
 
 #include <math.h>
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
@@ -409,6 +413,77 @@ TEST(uKernels, QuantMatrixBatchVectorMultiplyAccumulate8x8_16Test) {
   EXPECT_THAT(output, testing::ElementsAreArray(expected_output));
 }
 
+TEST(uKernels, QuantMatrixBatchVectorMultiplyAccumulateGates8x8_16Test) {
+  CpuBackendContext context;
+  const std::vector<int8_t> input = {
+      4,   -41, 5,   -41, 22,  17, -30, 24,  13,  -47, 18, 9,   -11, -30, 16,
+      -47, 12,  36,  -20, 27,  -3, 0,   -51, -31, 3,   -8, -38, 43,  23,  12,
+      11,  -23, -26, 23,  14,  -9, -44, 22,  21,  -30, 3,  -47, -26, -21, -24,
+      -44, 34,  -11, -23, -28, 26, -38, 19,  35,  9,   23, 6,   -42, -25, 28,
+  };
+  const std::vector<int32_t> input_zeropoint_times_weights = {
+      -620, -170, -395, 715, -1220, -1080, 1130, -260, -470,
+  };
+  const std::vector<int8_t> input_to_gate_weights = {
+      -10, -4,  -8,  16,  4,   -16, -1,  11,  1,   2,   -25, 19,  7,   9,   2,
+      -24, -2,  10,  -7,  7,   -5,  -2,  3,   4,   3,   -4,  -7,  -11, -13, -18,
+      11,  10,  12,  -9,  17,  -15, -5,  20,  -6,  -11, 2,   -6,  -18, 15,  4,
+      4,   -9,  -2,  -3,  -9,  -13, 17,  -21, 5,   3,   -12, 0,   -4,  9,   -5,
+      10,  -2,  8,   1,   -10, -6,  1,   -9,  10,  11,  -1,  -5,  4,   -7,  -4,
+      -4,  4,   12,  -7,  -5,  -9,  -19, 6,   -4,  12,  -17, -22, 0,   9,   -4,
+      -5,  5,   -8,  8,   3,   15,  -18, -18, 5,   3,   -12, 5,   -10, 7,   7,
+      -9,  17,  2,   -11, -25, 3,   19,  -6,  7,   1,   7,   5,   -3,  11,  3,
+      0,   -8,  8,   -2,  -2,  -12, 14,  -5,  7,   8,   16,  20,  -16, -5,  -5,
+      1,   -10, -6,  14,  10,  -12, 10,  -6,  5,   0,   3,   8,   -9,  -13, -2,
+      4,   4,   -16, -17, -9,  16,  -5,  14,  -9,  -5,  -12, 0,   17,  6,   -1,
+      16,  -20, 1,   -11, -1,  -10, -21, 13,  4,   -12, -7,  0,   -14, -6,  3,
+      -4,  6,   -18, -3,  -1,  14,  -8,  -6,  -15, 5,   12,  -3,  -10, 4,   6,
+      -5,  -20, 0,   3,   -3,  -7,  1,   2,   -10, 7,   -3,  6,   1,   -12, 6,
+      4,   -12, 2,   6,   -20, 0,   5,   23,  15,  14,  9,   8,   20,  -2,  9,
+      -8,  -8,  -7,  -4,  -8,  -9,  7,   -12, -2,  2,   1,   -14, 31,  4,   -14,
+      3,   10,  -18, -17, -1,  18,  1,   12,  0,   7,   -3,  -5,  8,   -9,  18,
+      17,  7,   -15, 3,   20,  4,   -8,  16,  6,   -3,  -3,  9,   -4,  -6,  4,
+  };
+  // The 9 weight rows are used as 3 gates of 3 rows each, with a different
+  // scale per gate.
+  constexpr int kNumGates = 3;
+  constexpr int kNumBatch = 2;
+  constexpr int kNumInput = 30;
+  constexpr int kNumOutput = 3;
+  const int32_t multipliers[kNumGates] = {2080364544, 1395864371, 1717986918};
+  const int32_t shifts[kNumGates] = {-2, -1, -3};
+
+  // Expected outputs come from one MatrixBatchVectorMultiplyAccumulate per
+  // gate, using each gate's slice of the weights and bias.
+  std::vector<std::vector<int16_t>> expected_outputs(kNumGates);
+  std::vector<std::vector<int16_t>> outputs(kNumGates);
+  std::vector<int32_t> scratch(kNumBatch * kNumGates * kNumOutput, 0);
+  for (int gate = 0; gate < kNumGates; ++gate) {
+    expected_outputs[gate] = {static_cast<int16_t>(gate), 7, -3, 11, 0, -20};
+    outputs[gate] = expected_outputs[gate];
+    std::vector<int8_t> gate_weights(
+        input_to_gate_weights.begin() + gate * kNumOutput * kNumInput,
+        input_to_gate_weights.begin() + (gate + 1) * kNumOutput * kNumInput);
+    MatrixBatchVectorMultiplyAccumulate(
+        input.data(), input_zeropoint_times_weights.data() + gate * kNumOutput,
+        gate_weights.data(), multipliers[gate], shifts[gate], kNumBatch,
+        kNumInput, kNumOutput, /*output_zp=*/0, scratch.data(),
+        expected_outputs[gate].data(), &context);
+  }
+
+  int16_t* output_ptrs[kNumGates] = {outputs[0].data(), outputs[1].data(),
+                                     outputs[2].data()};
+  MatrixBatchVectorMultiplyAccumulateGates(
+      input.data(), input_zeropoint_times_weights.data(),
+      input_to_gate_weights.data(), multipliers, shifts, kNumGates, kNumBatch,
+      kNumInput, kNumOutput, scratch.data(), output_ptrs, &context);
+
+  for (int gate = 0; gate < kNumGates; ++gate) {
+    EXPECT_THAT(outputs[gate],
+                testing::ElementsAreArray(expected_outputs[gate]));
+  }
+}
+
 TEST(uKernels, HybridMatrixBatchVectorMultiplyAccumulate8x8_16Test) {
   CpuBackendContext context;
   const std::vector<int8_t> input = {
@@ -1558,6 +1633,105 @@ TEST(uKernels, SparseMatrixBatchVectorMultiplyAccumulateTest) {
               ElementsAreArray(ArrayFloatNear(dense_output, 1e-4)));
 }
 
+// Builds a random [rows, cols] matrix where each 1x16 block is non-zero with
+// probability 1/2, together with its compressed values, segments and indices.
+template <typename T>
+void MakeRandom1x16BlockSparseMatrix(int rows, int cols, int seed,
+                                     std::vector<T>* dense,
+                                     std::vector<T>* values,
+                                     std::vector<int32_t>* segments,
+                                     std::vector<int32_t>* indices) {
+  std::minstd_rand random(seed);
+  dense->assign(rows * cols, 0);
+  segments->assign(1, 0);
+  for (int row = 0; row < rows; ++row) {
+    for (int block = 0; block < cols / 16; ++block) {
+      if (random() % 2 == 0) continue;
+      indices->push_back(block);
+      for (int c = 0; c < 16; ++c) {
+        const T value = static_cast<T>(static_cast<int>(random() % 255) - 127);
+        (*dense)[row * cols + block * 16 + c] = value;
+        values->push_back(value);
+      }
+    }
+    segments->push_back(indices->size());
+  }
+}
+
+TEST(uKernels, SparseMatrixBatchVectorMultiplyAccumulate1x16Test) {
+  const int kRow = 5;
+  const int kCol = 64;
+  const int kBatch = 3;
+  std::vector<float> dense, values;
+  std::vector<int32_t> segments, indices;
+  MakeRandom1x16BlockSparseMatrix(kRow, kCol, /*seed=*/1, &dense, &values,
+                                  &segments, &indices);
+  std::vector<float> vector(kBatch * kCol);
+  for (int i = 0; i < kBatch * kCol; ++i) {
+    vector[i] = (i % 7) * 0.25f - 0.75f;
+  }
+
+  std::vector<float> dense_output(kRow * kBatch, 1.0);
+  MatrixBatchVectorMultiplyAccumulate(dense.data(), kRow, kCol, vector.data(),
+                                      kBatch, dense_output.data());
+  std::vector<float> sparse_output(kRow * kBatch, 1.0);
+  SparseMatrixBatchVectorMultiplyAccumulate1x16(
+      values.data(), segments.data(), indices.data(), kRow, kCol,
+      vector.data(), kBatch, sparse_output.data());
+
+  EXPECT_THAT(sparse_output,
+              ElementsAreArray(ArrayFloatNear(dense_output, 1e-4)));
+}
+
+TEST(uKernels, SparseMatrixBatchVectorMultiplyAccumulate1x16Int8Test) {
+  const int kRow = 5;
+  const int kCol = 64;
+  const int kBatch = 3;
+  const int32_t kInputOffset = 7;
+  const int32_t kOutputOffset = -3;
+  std::vector<int8_t> dense, values;
+  std::vector<int32_t> segments, indices;
+  MakeRandom1x16BlockSparseMatrix(kRow, kCol, /*seed=*/2, &dense, &values,
+                                  &segments, &indices);
+  std::vector<int8_t> vector(kBatch * kCol);
+  for (int i = 0; i < kBatch * kCol; ++i) {
+    vector[i] = static_cast<int8_t>((i * 37) % 256 - 128);
+  }
+  const std::vector<int32_t> bias = {-300, 0, 25, 1000, -7};
+  const std::vector<int32_t> multipliers = {1 << 30, 1 << 29, 1 << 30,
+                                            3 << 28, 1 << 30};
+  const std::vector<int32_t> shifts = {-7, -6, -8, -7, -9};
+
+  for (const bool per_channel : {false, true}) {
+    std::vector<int8_t> expected(kRow * kBatch);
+    for (int batch = 0; batch < kBatch; ++batch) {
+      for (int row = 0; row < kRow; ++row) {
+        int32_t acc = bias[row];
+        for (int col = 0; col < kCol; ++col) {
+          acc += dense[row * kCol + col] *
+                 (vector[batch * kCol + col] + kInputOffset);
+        }
+        acc = MultiplyByQuantizedMultiplier(
+                  acc, per_channel ? multipliers[row] : multipliers[0],
+                  per_channel ? shifts[row] : shifts[0]) +
+              kOutputOffset;
+        expected[batch * kRow + row] =
+            static_cast<int8_t>(std::min(std::max(acc, -128), 127));
+      }
+    }
+
+    std::vector<int8_t> output(kRow * kBatch);
+    SparseMatrixBatchVectorMultiplyAccumulate1x16(
+        values.data(), segments.data(), indices.data(), kRow, kCol,
+        vector.data(), bias.data(), kBatch, kInputOffset, multipliers[0],
+        shifts[0], per_channel ? multipliers.data() : nullptr,
+        per_channel ? shifts.data() : nullptr, kOutputOffset,
+        /*output_activation_min=*/-128, /*output_activation_max=*/127,
+        output.data());
+    EXPECT_THAT(output, testing::ElementsAreArray(expected));
+  }
+}
+
 #ifdef __ANDROID__
 TEST(uKernels,
      SparseMatrixBatchVectorMultiplyAccumulateSymmetricQuantizedTest) {
@@ -1747,9 +1747,32 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
       PopulateQuantizedLstmParams8x8_16(context, node,
                                         &op_data->integer_lstm_param);
 
+      // Populate precomputed zp * weight.
+      TF_LITE_ENSURE_OK(context, PopulatePrecomputedZPTimesWeightsWithBias(
+                                     context, op_data, node));
+
+      // Stack the gate weights so that all gates are computed with one matmul
+      // per operand.
+      const TfLiteTensor* input_to_input_weights =
+          GetOptionalInputTensor(context, node, kInputToInputWeightsTensor);
+      const bool use_cifg = (input_to_input_weights == nullptr);
+      lstm_eval::PopulateFusedGatesInteger8x8_16(
+          input_to_input_weights,
+          GetInput(context, node, kInputToForgetWeightsTensor),
+          GetInput(context, node, kInputToCellWeightsTensor),
+          input_to_output_weights,
+          GetOptionalInputTensor(context, node, kRecurrentToInputWeightsTensor),
+          GetInput(context, node, kRecurrentToForgetWeightsTensor),
+          GetInput(context, node, kRecurrentToCellWeightsTensor),
+          recurrent_to_output_weights, &op_data->integer_lstm_param);
+      const int n_gates = use_cifg ? 3 : 4;
+      const bool use_fused_gates =
+          (op_data->integer_lstm_param.input_to_gates_weights != nullptr);
+
       // Allocate scratch buffer. Need 6 16bit buffer with size n_batch * n_cell
       // and 1 8bit buffer with size n_batch * n_cell. We also need 1 32 bit
-      // buffer with size n_batch * n_cell.
+      // buffer with size n_batch * n_cell, or n_batch * n_gates * n_cell when
+      // the gates are fused.
       //
       // Handle cifg case as well, which might save one buffer.
       for (int scratch_index = 0; scratch_index < 6; ++scratch_index) {
@@ -1766,21 +1789,20 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
           scratch_tensor->type = kTfLiteInt32;
         }
         scratch_tensor->allocation_type = kTfLiteArenaRw;
-        const int scratch_dimension[2] = {n_batch, n_cell};
+        const int scratch_width = (scratch_index == 5 && use_fused_gates)
+                                      ? n_gates * n_cell
+                                      : n_cell;
+        const int scratch_dimension[2] = {n_batch, scratch_width};
         if (!TfLiteIntArrayEqualsArray(scratch_tensor->dims, 2,
                                        scratch_dimension)) {
           TfLiteIntArray* scratch_buffer_size = TfLiteIntArrayCreate(2);
           scratch_buffer_size->data[0] = n_batch;
-          scratch_buffer_size->data[1] = n_cell;
+          scratch_buffer_size->data[1] = scratch_width;
           TF_LITE_ENSURE_OK(context,
                             context->ResizeTensor(context, scratch_tensor,
                                                   scratch_buffer_size));
         }
       }
-
-      // Populate precomputed zp * weight.
-      TF_LITE_ENSURE_OK(context, PopulatePrecomputedZPTimesWeightsWithBias(
-                                     context, op_data, node));
     } else {
       // Integer LSTM prepare function for 8x8->8.
       // This code path needs 12 intermediate tensors per Op.
@@ -495,6 +495,47 @@ void CalculateLstmOutputHybrid(
   }
 }
 
+// Applies the peephole connection, layer normalization and activation of an
+// int8x8_16 LSTM gate whose matmuls have been accumulated into `gate`.
+void FinishLstmGateInteger8x8_16(
+    const int16_t* cell_state, const int16_t* cell_to_gate_weights,
+    const int32_t cell_to_gate_scale_a, const int32_t cell_to_gate_scale_b,
+    const int16_t* layer_norm_coefficients, const int32_t* layer_norm_bias,
+    const int32_t layer_norm_input_scale_a,
+    const int32_t layer_norm_input_scale_b,
+    const int32_t layer_norm_variance_guard, const int n_batch,
+    const int n_output, const int n_cell,
+    const TfLiteFusedActivation activation, int16_t* gate) {
+  const bool use_peephole = (cell_to_gate_weights != nullptr);
+  const bool use_layer_norm = (layer_norm_coefficients != nullptr);
+
+  // For each batch and cell: compute cell_weight * cell_state (peephole LSTM)
+  if (use_peephole) {
+    tensor_utils::VectorBatchVectorCwiseProductAccumulate(
+        cell_to_gate_weights, n_output, cell_state, n_batch,
+        cell_to_gate_scale_a, cell_to_gate_scale_b, gate);
+  }
+  // Do layer normalization (if layer norm LSTM)
+  if (use_layer_norm) {
+    tensor_utils::ApplyLayerNorm(
+        gate, layer_norm_coefficients, layer_norm_bias,
+        layer_norm_input_scale_a, layer_norm_input_scale_b,
+        layer_norm_variance_guard, n_batch, n_cell, gate);
+  }
+  // Apply activation
+  switch (activation) {
+    case kTfLiteActSigmoid:
+      tensor_utils::ApplySigmoid(gate, n_batch, n_cell, gate);
+      break;
+    case kTfLiteActTanh:
+      tensor_utils::ApplyTanh(3, gate, n_batch, n_cell, gate);
+      break;
+    default:
+      // Only Sigmoid or Tanh is used.
+      TFLITE_ASSERT_FALSE;
+  }
+}
+
 // Calculates a single LSTM gate, int8x8_16 version.
 // Implements the same functionality as CalculateLstmGateFloat.
 void CalculateLstmGateInteger8x8_16(
@@ -524,9 +565,6 @@ void CalculateLstmGateInteger8x8_16(
     CpuBackendContext* context,
     // Scratch arrays
     int32_t* scratch5) {
-  const bool use_peephole = (cell_to_gate_weights != nullptr);
-  const bool use_layer_norm = (layer_norm_coefficients != nullptr);
-
   // Initialize scratch buffers with zeros. Note that unlike float and hybrid
   // versions, bias is only used in layer normalization.
   std::fill_n(gate, n_batch * n_cell, 0);
@@ -542,31 +580,40 @@ void CalculateLstmGateInteger8x8_16(
       output_state, recurrent_to_gate_bias, recurrent_to_gate_weights,
       recurrent_to_gate_scale_a, recurrent_to_gate_scale_b, n_batch, n_output,
       n_cell, 0, scratch5, gate, context);
-  // For each batch and cell: compute cell_weight * cell_state (peephole LSTM)
-  if (use_peephole) {
-    tensor_utils::VectorBatchVectorCwiseProductAccumulate(
-        cell_to_gate_weights, n_output, cell_state, n_batch,
-        cell_to_gate_scale_a, cell_to_gate_scale_b, gate);
-  }
-  // Do layer normalization (if layer norm LSTM)
-  if (use_layer_norm) {
-    tensor_utils::ApplyLayerNorm(
-        gate, layer_norm_coefficients, layer_norm_bias,
-        layer_norm_input_scale_a, layer_norm_input_scale_b,
-        layer_norm_variance_guard, n_batch, n_cell, gate);
-  }
-  // Apply activation
-  switch (activation) {
-    case kTfLiteActSigmoid:
-      tensor_utils::ApplySigmoid(gate, n_batch, n_cell, gate);
-      break;
-    case kTfLiteActTanh:
-      tensor_utils::ApplyTanh(3, gate, n_batch, n_cell, gate);
-      break;
-    default:
-      // Only Sigmoid or Tanh is used.
-      TFLITE_ASSERT_FALSE;
+  FinishLstmGateInteger8x8_16(
+      cell_state, cell_to_gate_weights, cell_to_gate_scale_a,
+      cell_to_gate_scale_b, layer_norm_coefficients, layer_norm_bias,
+      layer_norm_input_scale_a, layer_norm_input_scale_b,
+      layer_norm_variance_guard, n_batch, n_output, n_cell, activation, gate);
+}
+
+// Computes the input and recurrent matmuls of all gates of an int8x8_16 LSTM
+// step, with one matrix multiplication each over the stacked gate weights
+// (see IntegerLstmParameter::input_to_gates_weights). The gates are ordered
+// input (unless CIFG), forget, cell, output, and each gate is then completed
+// by FinishLstmGateInteger8x8_16.
+void CalculateLstmGateMatmulsInteger8x8_16(
+    const int8_t* input, const int8_t* input_to_gates_weights,
+    const int32_t* input_to_gates_bias, const int32_t* input_to_gates_scale_a,
+    const int32_t* input_to_gates_scale_b, const int8_t* output_state,
+    const int8_t* recurrent_to_gates_weights,
+    const int32_t* recurrent_to_gates_bias,
+    const int32_t* recurrent_to_gates_scale_a,
+    const int32_t* recurrent_to_gates_scale_b, int n_gates, int n_batch,
+    int n_input, int n_output, int n_cell, int16_t* const* gates,
+    CpuBackendContext* context, int32_t* scratch5) {
+  ruy::profiler::ScopeLabel label("LstmGateMatmulsInteger8x8_16");
+  for (int gate = 0; gate < n_gates; ++gate) {
+    std::fill_n(gates[gate], n_batch * n_cell, 0);
   }
+  tensor_utils::MatrixBatchVectorMultiplyAccumulateGates(
+      input, input_to_gates_bias, input_to_gates_weights,
+      input_to_gates_scale_a, input_to_gates_scale_b, n_gates, n_batch,
+      n_input, n_cell, scratch5, gates, context);
+  tensor_utils::MatrixBatchVectorMultiplyAccumulateGates(
+      output_state, recurrent_to_gates_bias, recurrent_to_gates_weights,
+      recurrent_to_gates_scale_a, recurrent_to_gates_scale_b, n_gates, n_batch,
+      n_output, n_cell, scratch5, gates, context);
 }
 
 // Updates the LSTM cell state, used by both integer LSTM versions.
@@ -1319,7 +1366,16 @@ inline void LstmStepHybrid(
 //   scratch3
 //   scratch4
 //   scratch5: this scratch buffer is created purely for optimizing the
-//              MatrixBatchVectorMultiplyAccumulate.
+//              MatrixBatchVectorMultiplyAccumulate. It holds
+//              n_gates * n_cell * n_batch entries when the gates are fused.
+//
+// Stacked gate weights and effective biases (see IntegerLstmParameter):
+//   input_to_gates_weights              - optional
+//   input_to_gates_effective_bias       - optional
+//   recurrent_to_gates_weights          - optional
+//   recurrent_to_gates_effective_bias   - optional
+// If present, the matmuls of all gates are computed with one matrix
+// multiplication per operand instead of one per gate.
 //
 // Outputs:
 //   output_state_ptr - size 'n_batch * n_output'
@@ -1385,7 +1441,11 @@ inline void LstmStepInteger8x8_16(
     const int32_t* recurrent_to_output_effective_bias,
     const int32_t* input_to_input_effective_bias,
     const int32_t* recurrent_to_input_effective_bias,
-    const int32_t* projection_effective_bias, int n_batch, int n_cell,
+    const int32_t* projection_effective_bias,
+    const int8_t* input_to_gates_weights,
+    const int32_t* input_to_gates_effective_bias,
+    const int8_t* recurrent_to_gates_weights,
+    const int32_t* recurrent_to_gates_effective_bias, int n_batch, int n_cell,
     int n_input, int n_output, int8_t* output_state_ptr,
     int32_t output_state_zp, int16_t* cell_state_ptr, int8_t* output_ptr,
     int16_t* scratch0, int16_t* scratch1, int16_t* scratch2, int16_t* scratch3,
@@ -1416,62 +1476,132 @@ inline void LstmStepInteger8x8_16(
   if (use_projection) {
     TFLITE_DCHECK(projection_effective_bias);
   }
-  if (!use_cifg) {
-    // Calculate the input gate. (If not CIFG.)
+  const bool use_fused_gates = (input_to_gates_weights != nullptr);
+  if (use_fused_gates) {
+    // The matmuls of all gates only read the input and the previous output
+    // state, so they are computed together before the gates are finished.
+    int16_t* gates[4] = {input_gate_scratch, forget_gate_scratch,
+                         cell_gate_scratch, output_gate_scratch};
+    const int32_t input_scale_a[4] = {
+        effective_input_to_input_scale_a, effective_input_to_forget_scale_a,
+        effective_input_to_cell_scale_a, effective_input_to_output_scale_a};
+    const int32_t input_scale_b[4] = {
+        effective_input_to_input_scale_b, effective_input_to_forget_scale_b,
+        effective_input_to_cell_scale_b, effective_input_to_output_scale_b};
+    const int32_t recurrent_scale_a[4] = {
+        effective_recurrent_to_input_scale_a,
+        effective_recurrent_to_forget_scale_a,
+        effective_recurrent_to_cell_scale_a,
+        effective_recurrent_to_output_scale_a};
+    const int32_t recurrent_scale_b[4] = {
+        effective_recurrent_to_input_scale_b,
+        effective_recurrent_to_forget_scale_b,
+        effective_recurrent_to_cell_scale_b,
+        effective_recurrent_to_output_scale_b};
+    // The stacked weights have no input gate in the CIFG case.
+    const int first_gate = use_cifg ? 1 : 0;
+    CalculateLstmGateMatmulsInteger8x8_16(
+        input_ptr, input_to_gates_weights, input_to_gates_effective_bias,
+        input_scale_a + first_gate, input_scale_b + first_gate,
+        output_state_ptr, recurrent_to_gates_weights,
+        recurrent_to_gates_effective_bias, recurrent_scale_a + first_gate,
+        recurrent_scale_b + first_gate, 4 - first_gate, n_batch, n_input,
+        n_output, n_cell, gates + first_gate, context, scratch5);
+    if (!use_cifg) {
+      FinishLstmGateInteger8x8_16(
+          cell_state_ptr, cell_to_input_weight_ptr,
+          effective_cell_to_input_scale_a, effective_cell_to_input_scale_b,
+          layer_norm_input_weight_ptr, input_gate_bias_ptr,
+          layer_norm_input_scale_a, layer_norm_input_scale_b,
+          input_variance_guard, n_batch, n_output, n_cell, kTfLiteActSigmoid,
+          input_gate_scratch);
+    }
+    FinishLstmGateInteger8x8_16(
+        cell_state_ptr, cell_to_forget_weight_ptr,
+        effective_cell_to_forget_scale_a, effective_cell_to_forget_scale_b,
+        layer_norm_forget_weight_ptr, forget_gate_bias_ptr,
+        layer_norm_forget_scale_a, layer_norm_forget_scale_b,
+        forget_variance_guard, n_batch, n_output, n_cell, kTfLiteActSigmoid,
+        forget_gate_scratch);
+    FinishLstmGateInteger8x8_16(
+        cell_state_ptr, /*cell_to_gate_weights=*/nullptr,
+        /*cell_to_gate_scale_a=*/0, /*cell_to_gate_scale_b=*/0,
+        layer_norm_cell_weight_ptr, cell_gate_bias_ptr,
+        layer_norm_cell_scale_a, layer_norm_cell_scale_b, cell_variance_guard,
+        n_batch, n_output, n_cell, kTfLiteActTanh, cell_gate_scratch);
+  } else {
+    if (!use_cifg) {
+      // Calculate the input gate. (If not CIFG.)
+      CalculateLstmGateInteger8x8_16(
+          input_ptr, input_to_input_weight_ptr, input_to_input_effective_bias,
+          effective_input_to_input_scale_a, effective_input_to_input_scale_b,
+          output_state_ptr, recurrent_to_input_weight_ptr,
+          recurrent_to_input_effective_bias,
+          effective_recurrent_to_input_scale_a,
+          effective_recurrent_to_input_scale_b, cell_state_ptr,
+          cell_to_input_weight_ptr, effective_cell_to_input_scale_a,
+          effective_cell_to_input_scale_b, layer_norm_input_weight_ptr,
+          input_gate_bias_ptr, layer_norm_input_scale_a,
+          layer_norm_input_scale_b, input_variance_guard, n_batch, n_input,
+          n_output, n_cell, kTfLiteActSigmoid, input_gate_scratch, context,
+          scratch5);
+    }
+    // Calculate the forget gate.
     CalculateLstmGateInteger8x8_16(
-        input_ptr, input_to_input_weight_ptr, input_to_input_effective_bias,
-        effective_input_to_input_scale_a, effective_input_to_input_scale_b,
-        output_state_ptr, recurrent_to_input_weight_ptr,
-        recurrent_to_input_effective_bias, effective_recurrent_to_input_scale_a,
-        effective_recurrent_to_input_scale_b, cell_state_ptr,
-        cell_to_input_weight_ptr, effective_cell_to_input_scale_a,
-        effective_cell_to_input_scale_b, layer_norm_input_weight_ptr,
-        input_gate_bias_ptr, layer_norm_input_scale_a, layer_norm_input_scale_b,
-        input_variance_guard, n_batch, n_input, n_output, n_cell,
-        kTfLiteActSigmoid, input_gate_scratch, context, scratch5);
+        input_ptr, input_to_forget_weight_ptr, input_to_forget_effective_bias,
+        effective_input_to_forget_scale_a, effective_input_to_forget_scale_b,
+        output_state_ptr, recurrent_to_forget_weight_ptr,
+        recurrent_to_forget_effective_bias,
+        effective_recurrent_to_forget_scale_a,
+        effective_recurrent_to_forget_scale_b, cell_state_ptr,
+        cell_to_forget_weight_ptr, effective_cell_to_forget_scale_a,
+        effective_cell_to_forget_scale_b, layer_norm_forget_weight_ptr,
+        forget_gate_bias_ptr, layer_norm_forget_scale_a,
+        layer_norm_forget_scale_b, forget_variance_guard, n_batch, n_input,
+        n_output, n_cell, kTfLiteActSigmoid, forget_gate_scratch, context,
+        scratch5);
+    // Calculate the cell update gate.
+    CalculateLstmGateInteger8x8_16(
+        input_ptr, input_to_cell_weight_ptr, input_to_cell_effective_bias,
+        effective_input_to_cell_scale_a, effective_input_to_cell_scale_b,
+        output_state_ptr, recurrent_to_cell_weight_ptr,
+        recurrent_to_cell_effective_bias, effective_recurrent_to_cell_scale_a,
+        effective_recurrent_to_cell_scale_b, cell_state_ptr,
+        /*cell_to_gate_weights=*/nullptr, /*cell_to_gate_scale_a=*/0,
+        /*cell_to_gate_scale_b=*/0, layer_norm_cell_weight_ptr,
+        cell_gate_bias_ptr, layer_norm_cell_scale_a, layer_norm_cell_scale_b,
+        cell_variance_guard, n_batch, n_input, n_output, n_cell, kTfLiteActTanh,
+        cell_gate_scratch, context, scratch5);
   }
-  // Calculate the forget gate.
-  CalculateLstmGateInteger8x8_16(
-      input_ptr, input_to_forget_weight_ptr, input_to_forget_effective_bias,
-      effective_input_to_forget_scale_a, effective_input_to_forget_scale_b,
-      output_state_ptr, recurrent_to_forget_weight_ptr,
-      recurrent_to_forget_effective_bias, effective_recurrent_to_forget_scale_a,
-      effective_recurrent_to_forget_scale_b, cell_state_ptr,
-      cell_to_forget_weight_ptr, effective_cell_to_forget_scale_a,
-      effective_cell_to_forget_scale_b, layer_norm_forget_weight_ptr,
-      forget_gate_bias_ptr, layer_norm_forget_scale_a,
-      layer_norm_forget_scale_b, forget_variance_guard, n_batch, n_input,
-      n_output, n_cell, kTfLiteActSigmoid, forget_gate_scratch, context,
-      scratch5);
-  // Calculate the cell update gate.
-  CalculateLstmGateInteger8x8_16(
-      input_ptr, input_to_cell_weight_ptr, input_to_cell_effective_bias,
-      effective_input_to_cell_scale_a, effective_input_to_cell_scale_b,
-      output_state_ptr, recurrent_to_cell_weight_ptr,
-      recurrent_to_cell_effective_bias, effective_recurrent_to_cell_scale_a,
-      effective_recurrent_to_cell_scale_b, cell_state_ptr,
-      /*cell_to_gate_weights=*/nullptr, /*cell_to_gate_scale_a=*/0,
-      /*cell_to_gate_scale_b=*/0, layer_norm_cell_weight_ptr,
-      cell_gate_bias_ptr, layer_norm_cell_scale_a, layer_norm_cell_scale_b,
-      cell_variance_guard, n_batch, n_input, n_output, n_cell, kTfLiteActTanh,
-      cell_gate_scratch, context, scratch5);
   // Update the cell state.
   UpdateLstmCellInteger(n_batch, n_cell, cell_state_ptr, cell_state_scale,
                         input_gate_scratch, forget_gate_scratch,
                         cell_gate_scratch, use_cifg, quantized_cell_clip);
-  // Calculate the output gate.
-  CalculateLstmGateInteger8x8_16(
-      input_ptr, input_to_output_weight_ptr, input_to_output_effective_bias,
-      effective_input_to_output_scale_a, effective_input_to_output_scale_b,
-      output_state_ptr, recurrent_to_output_weight_ptr,
-      recurrent_to_output_effective_bias, effective_recurrent_to_output_scale_a,
-      effective_recurrent_to_output_scale_b, cell_state_ptr,
-      cell_to_output_weight_ptr, effective_cell_to_output_scale_a,
-      effective_cell_to_output_scale_b, layer_norm_output_weight_ptr,
-      output_gate_bias_ptr, layer_norm_output_scale_a,
-      layer_norm_output_scale_b, output_variance_guard, n_batch, n_input,
-      n_output, n_cell, kTfLiteActSigmoid, output_gate_scratch, context,
-      scratch5);
+  if (use_fused_gates) {
+    // The output gate peephole reads the updated cell state.
+    FinishLstmGateInteger8x8_16(
+        cell_state_ptr, cell_to_output_weight_ptr,
+        effective_cell_to_output_scale_a, effective_cell_to_output_scale_b,
+        layer_norm_output_weight_ptr, output_gate_bias_ptr,
+        layer_norm_output_scale_a, layer_norm_output_scale_b,
+        output_variance_guard, n_batch, n_output, n_cell, kTfLiteActSigmoid,
+        output_gate_scratch);
+  } else {
+    // Calculate the output gate.
+    CalculateLstmGateInteger8x8_16(
+        input_ptr, input_to_output_weight_ptr, input_to_output_effective_bias,
+        effective_input_to_output_scale_a, effective_input_to_output_scale_b,
+        output_state_ptr, recurrent_to_output_weight_ptr,
+        recurrent_to_output_effective_bias,
+        effective_recurrent_to_output_scale_a,
+        effective_recurrent_to_output_scale_b, cell_state_ptr,
+        cell_to_output_weight_ptr, effective_cell_to_output_scale_a,
+        effective_cell_to_output_scale_b, layer_norm_output_weight_ptr,
+        output_gate_bias_ptr, layer_norm_output_scale_a,
+        layer_norm_output_scale_b, output_variance_guard, n_batch, n_input,
+        n_output, n_cell, kTfLiteActSigmoid, output_gate_scratch, context,
+        scratch5);
+  }
   // Update the output state.
   CalculateLstmOutputInteger8x8_16(
       n_batch, n_cell, n_output, cell_state_ptr, cell_state_scale,
@@ -2160,6 +2290,72 @@ TfLiteStatus EvalHybrid(
   return kTfLiteOk;
 }
 
+void PopulateFusedGatesInteger8x8_16(
+    const TfLiteTensor* input_to_input_weights,
+    const TfLiteTensor* input_to_forget_weights,
+    const TfLiteTensor* input_to_cell_weights,
+    const TfLiteTensor* input_to_output_weights,
+    const TfLiteTensor* recurrent_to_input_weights,
+    const TfLiteTensor* recurrent_to_forget_weights,
+    const TfLiteTensor* recurrent_to_cell_weights,
+    const TfLiteTensor* recurrent_to_output_weights,
+    IntegerLstmParameter* integer_lstm_param) {
+  const bool use_cifg = (input_to_input_weights == nullptr);
+  const TfLiteTensor* input_weights[] = {
+      input_to_input_weights, input_to_forget_weights, input_to_cell_weights,
+      input_to_output_weights};
+  const TfLiteTensor* recurrent_weights[] = {
+      recurrent_to_input_weights, recurrent_to_forget_weights,
+      recurrent_to_cell_weights, recurrent_to_output_weights};
+  const int32_t* input_biases[] = {
+      integer_lstm_param->input_to_input_effective_bias.get(),
+      integer_lstm_param->input_to_forget_effective_bias.get(),
+      integer_lstm_param->input_to_cell_effective_bias.get(),
+      integer_lstm_param->input_to_output_effective_bias.get()};
+  const int32_t* recurrent_biases[] = {
+      integer_lstm_param->recurrent_to_input_effective_bias.get(),
+      integer_lstm_param->recurrent_to_forget_effective_bias.get(),
+      integer_lstm_param->recurrent_to_cell_effective_bias.get(),
+      integer_lstm_param->recurrent_to_output_effective_bias.get()};
+  const int first_gate = use_cifg ? 1 : 0;
+  for (int gate = first_gate; gate < 4; ++gate) {
+    if (input_weights[gate]->allocation_type != kTfLiteMmapRo ||
+        recurrent_weights[gate]->allocation_type != kTfLiteMmapRo ||
+        input_biases[gate] == nullptr || recurrent_biases[gate] == nullptr) {
+      return;
+    }
+  }
+
+  const int n_gates = 4 - first_gate;
+  const int n_cell = input_to_output_weights->dims->data[0];
+  const int n_input = input_to_output_weights->dims->data[1];
+  const int n_output = recurrent_to_output_weights->dims->data[1];
+  integer_lstm_param->input_to_gates_weights.reset(
+      new int8_t[n_gates * n_cell * n_input]);
+  integer_lstm_param->input_to_gates_effective_bias.reset(
+      new int32_t[n_gates * n_cell]);
+  integer_lstm_param->recurrent_to_gates_weights.reset(
+      new int8_t[n_gates * n_cell * n_output]);
+  integer_lstm_param->recurrent_to_gates_effective_bias.reset(
+      new int32_t[n_gates * n_cell]);
+  for (int gate = first_gate; gate < 4; ++gate) {
+    const int index = gate - first_gate;
+    std::copy_n(GetTensorData<int8_t>(input_weights[gate]), n_cell * n_input,
+                integer_lstm_param->input_to_gates_weights.get() +
+                    index * n_cell * n_input);
+    std::copy_n(GetTensorData<int8_t>(recurrent_weights[gate]),
+                n_cell * n_output,
+                integer_lstm_param->recurrent_to_gates_weights.get() +
+                    index * n_cell * n_output);
+    std::copy_n(input_biases[gate], n_cell,
+                integer_lstm_param->input_to_gates_effective_bias.get() +
+                    index * n_cell);
+    std::copy_n(recurrent_biases[gate], n_cell,
+                integer_lstm_param->recurrent_to_gates_effective_bias.get() +
+                    index * n_cell);
+  }
+}
+
 TfLiteStatus EvalInteger8x8_16(
     const TfLiteTensor* input, const TfLiteTensor* input_to_input_weights,
     const TfLiteTensor* input_to_forget_weights,
@@ -2286,8 +2482,12 @@ TfLiteStatus EvalInteger8x8_16(
           integer_lstm_param->recurrent_to_output_effective_bias.get(),
           integer_lstm_param->input_to_input_effective_bias.get(),
           integer_lstm_param->recurrent_to_input_effective_bias.get(),
-          integer_lstm_param->projection_effective_bias.get(), n_batch, n_cell,
-          n_input, n_output, GetTensorData<int8_t>(output_state),
+          integer_lstm_param->projection_effective_bias.get(),
+          integer_lstm_param->input_to_gates_weights.get(),
+          integer_lstm_param->input_to_gates_effective_bias.get(),
+          integer_lstm_param->recurrent_to_gates_weights.get(),
+          integer_lstm_param->recurrent_to_gates_effective_bias.get(), n_batch,
+          n_cell, n_input, n_output, GetTensorData<int8_t>(output_state),
           output_state_zp, GetTensorData<int16_t>(cell_state), output_ptr,
           GetTensorData<int16_t>(scratch0), GetTensorData<int16_t>(scratch1),
           GetTensorData<int16_t>(scratch2), GetTensorData<int16_t>(scratch3),
@@ -2385,10 +2585,14 @@ TfLiteStatus EvalInteger8x8_16(
             integer_lstm_param->recurrent_to_output_effective_bias.get(),
             integer_lstm_param->input_to_input_effective_bias.get(),
             integer_lstm_param->recurrent_to_input_effective_bias.get(),
-            integer_lstm_param->projection_effective_bias.get(), /*n_batch=*/1,
-            n_cell, n_input, n_output, output_state_ptr, output_state_zp,
-            cell_state_ptr, output_ptr, GetTensorData<int16_t>(scratch0),
-            GetTensorData<int16_t>(scratch1), GetTensorData<int16_t>(scratch2),
+            integer_lstm_param->projection_effective_bias.get(),
+            integer_lstm_param->input_to_gates_weights.get(),
+            integer_lstm_param->input_to_gates_effective_bias.get(),
+            integer_lstm_param->recurrent_to_gates_weights.get(),
+            integer_lstm_param->recurrent_to_gates_effective_bias.get(),
+            /*n_batch=*/1, n_cell, n_input, n_output, output_state_ptr,
+            output_state_zp, cell_state_ptr, output_ptr,
+            GetTensorData<int16_t>(scratch0), GetTensorData<int16_t>(scratch1), GetTensorData<int16_t>(scratch2),
             GetTensorData<int16_t>(scratch3), GetTensorData<int8_t>(scratch4),
             GetTensorData<int32_t>(scratch5), context);
       }
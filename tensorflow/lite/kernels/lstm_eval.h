@@ -88,6 +88,16 @@ struct IntegerLstmParameter {
   std::unique_ptr<int32_t[]> recurrent_to_input_effective_bias;
   std::unique_ptr<int32_t[]> projection_effective_bias;
 
+  // Input-to-gate and recurrent-to-gate weights of all gates stacked row-wise
+  // in input (unless CIFG), forget, cell, output order, with the matching
+  // effective biases. Only set for the 8x8_16 kernel with constant weights,
+  // where they let EvalInteger8x8_16 compute all gate matmuls of a step with
+  // one matrix multiplication per operand.
+  std::unique_ptr<int8_t[]> input_to_gates_weights;
+  std::unique_ptr<int32_t[]> input_to_gates_effective_bias;
+  std::unique_ptr<int8_t[]> recurrent_to_gates_weights;
+  std::unique_ptr<int32_t[]> recurrent_to_gates_effective_bias;
+
   // Scale and zero point for intermediate tensors.
   // Used only in the 8x8_8 case.
   int32_t intermediate_scale_a[8];
@@ -195,6 +205,24 @@ TfLiteStatus EvalInteger8x8_16(
     TfLiteTensor* scratch3, TfLiteTensor* scratch4, TfLiteTensor* scratch5,
     CpuBackendContext* context);
 
+// Stacks the weights and effective biases of the gates of an 8x8_16 integer
+// LSTM into `integer_lstm_param` (see
+// IntegerLstmParameter::input_to_gates_weights). Must be called after the
+// per-gate effective biases are populated. Does nothing if any of the weights
+// is not constant. Once the gates are stacked, the 32 bit scratch buffer passed
+// to EvalInteger8x8_16 must hold n_gates * n_batch * n_cell values, where
+// n_gates is 3 with CIFG and 4 otherwise.
+void PopulateFusedGatesInteger8x8_16(
+    const TfLiteTensor* input_to_input_weights,
+    const TfLiteTensor* input_to_forget_weights,
+    const TfLiteTensor* input_to_cell_weights,
+    const TfLiteTensor* input_to_output_weights,
+    const TfLiteTensor* recurrent_to_input_weights,
+    const TfLiteTensor* recurrent_to_forget_weights,
+    const TfLiteTensor* recurrent_to_cell_weights,
+    const TfLiteTensor* recurrent_to_output_weights,
+    IntegerLstmParameter* integer_lstm_param);
+
 TfLiteStatus EvalInteger8x8_8(
     const TfLiteTensor* input, const TfLiteTensor* input_to_input_weights,
     const TfLiteTensor* input_to_forget_weights,
@@ -19,6 +19,20 @@ limitations under the License.
 
 namespace tflite {
 
+// The order in which a MemoryPlanner places tensors in the arena. Each tensor
+// goes into the best fitting gap left by the tensors placed before it.
+enum class MemoryPlanningStrategy {
+  // Tensors in non-increasing order of size.
+  kGreedyBySize,
+  // Tensors in non-increasing order of size times the number of nodes they
+  // are alive for.
+  kGreedyBySizeTimesLifetime,
+  // Tries the orders above and then moves the tensors that define the arena
+  // size to the front, keeping the order with the smallest arena. This costs
+  // more planning time in AllocateTensors().
+  kSmallestArena,
+};
+
 // A MemoryPlanner is responsible for planning and executing a number of
 // memory-related operations that are necessary in TF Lite.
 class MemoryPlanner {
@@ -59,6 +73,10 @@ class MemoryPlanner {
 
   // Returns true if the non-persistent memory is available.
   virtual bool HasNonPersistentMemory() = 0;
+
+  // Returns the number of bytes the current plan needs for non-persistent
+  // tensors.
+  virtual size_t GetNonPersistentArenaSize() = 0;
 };
 
 }  // namespace tflite
@@ -119,6 +119,75 @@ void EvalAdd(TfLiteContext* context, TfLiteNode* node, TfLiteAddParams* params,
 #undef TF_LITE_ADD
 }
 
+// Runs an int8 broadcast add whose broadcast pattern fits the fivefold loops
+// of reference_ops::BroadcastAddFivefold as arm_elementwise_add_s8 calls over
+// contiguous sections. Returns false, without computing anything, for other
+// broadcast patterns and for inner sections of a single element.
+bool BroadcastAddFivefoldInt8(const tflite::ArithmeticParams& unswitched_params,
+                              const int8_t* unswitched_input1_data,
+                              const int8_t* unswitched_input2_data,
+                              int8_t* output_data) {
+  const bool use_unswitched =
+      unswitched_params.broadcast_category ==
+      tflite::BroadcastableOpCategory::kFirstInputBroadcastsFast;
+  if (!use_unswitched &&
+      unswitched_params.broadcast_category !=
+          tflite::BroadcastableOpCategory::kSecondInputBroadcastsFast) {
+    return false;
+  }
+  const int y0 = unswitched_params.broadcast_shape[0];
+  const int y1 = unswitched_params.broadcast_shape[1];
+  const int y2 = unswitched_params.broadcast_shape[2];
+  const int y3 = unswitched_params.broadcast_shape[3];
+  const int y4 = unswitched_params.broadcast_shape[4];
+  if (y4 == 1) {
+    return false;
+  }
+
+  tflite::ArithmeticParams params = unswitched_params;
+  if (!use_unswitched) {
+    params.input1_offset = unswitched_params.input2_offset;
+    params.input1_multiplier = unswitched_params.input2_multiplier;
+    params.input1_shift = unswitched_params.input2_shift;
+    params.input2_offset = unswitched_params.input1_offset;
+    params.input2_multiplier = unswitched_params.input1_multiplier;
+    params.input2_shift = unswitched_params.input1_shift;
+  }
+  const int8_t* input1_data =
+      use_unswitched ? unswitched_input1_data : unswitched_input2_data;
+  const int8_t* input2_data =
+      use_unswitched ? unswitched_input2_data : unswitched_input1_data;
+
+  // Same traversal as reference_ops::BroadcastAddFivefold: input1 is
+  // broadcast over y3 and input2 over y1.
+  int8_t* output_data_ptr = output_data;
+  const int8_t* input1_data_ptr = input1_data;
+  const int8_t* input2_data_reset = input2_data;
+  for (int i0 = 0; i0 < y0; ++i0) {
+    const int8_t* input2_data_ptr = input2_data_reset;
+    for (int i1 = 0; i1 < y1; ++i1) {
+      input2_data_ptr = input2_data_reset;
+      for (int i2 = 0; i2 < y2; ++i2) {
+        for (int i3 = 0; i3 < y3; ++i3) {
+          arm_elementwise_add_s8(
+              input1_data_ptr, input2_data_ptr, params.input1_offset,
+              params.input1_multiplier, params.input1_shift,
+              params.input2_offset, params.input2_multiplier,
+              params.input2_shift, params.left_shift, output_data_ptr,
+              params.output_offset, params.output_multiplier,
+              params.output_shift, params.quantized_activation_min,
+              params.quantized_activation_max, y4);
+          input2_data_ptr += y4;
+          output_data_ptr += y4;
+        }
+        input1_data_ptr += y4;
+      }
+    }
+    input2_data_reset = input2_data_ptr;
+  }
+  return true;
+}
+
 TfLiteStatus EvalAddQuantized(TfLiteContext* context, TfLiteNode* node,
                               TfLiteAddParams* params, const OpData* data,
                               const TfLiteEvalTensor* input1,
@@ -150,7 +219,12 @@ TfLiteStatus EvalAddQuantized(TfLiteContext* context, TfLiteNode* node,
                tflite::micro::GetTensorData<dtype>(output));
     if (output->type == kTfLiteInt8) {
       if (need_broadcast) {
-        TF_LITE_ADD(reference_integer_ops, BroadcastAdd4DSlow, int8_t);
+        if (!BroadcastAddFivefoldInt8(
+                op_params, tflite::micro::GetTensorData<int8_t>(input1),
+                tflite::micro::GetTensorData<int8_t>(input2),
+                tflite::micro::GetTensorData<int8_t>(output))) {
+          TF_LITE_ADD(reference_integer_ops, BroadcastAdd4DSlow, int8_t);
+        }
       } else {
         arm_elementwise_add_s8(
             tflite::micro::GetTensorData<int8_t>(input1),
@@ -60,6 +60,8 @@ struct AllocationInfo {
 // requirement for SIMD extensions.
 constexpr int kBufferAlignment = 16;
 constexpr char kOfflineMemAllocMetadata[] = "OfflineMemoryAllocation";
+// Version, subgraph index and number of offsets precede the offline offsets.
+constexpr size_t kOfflinePlannerHeaderSize = 3;
 const TfLiteIntArray kZeroLengthIntArray = {};
 
 class MicroBuiltinDataAllocator : public BuiltinDataAllocator {
@@ -277,12 +279,16 @@ TfLiteStatus AllocationInfoBuilder::AddTensors(const SubGraph* subgraph,
 // the model. The following encoding applies:
 //
 // |  Offset |                            Value                                |
-// |    0    | Offline allocation format version – set to 0                    |
+// |    0    | Offline allocation format version – set to 1                    |
 // |    1    | Subgraph index to which this allocation applies                 |
 // |    2    | Number offsets following: n                                     |
 // |    3    | Arena byte offset of tensor #0 or -1 to allocate at runtime     |
 // |    4    | Arena byte offset of tensor #1 or -1 to allocate at runtime     |
 // | 3+(n-1) | Arena byte offset of tensor #(n-1) or -1 to allocate at runtime |
+//
+// Offline offsets are relative to the start of the non-persistent (head) arena
+// section. If every buffer that needs allocating has an offline offset, the
+// plan is committed as-is and the on-device memory planner is not run.
 TfLiteStatus AllocationInfoBuilder::GetOfflinePlannedOffsets(
     const Model* model, const int32_t** offline_planner_offsets) {
   if (model->metadata()) {
@@ -294,9 +300,24 @@ TfLiteStatus AllocationInfoBuilder::GetOfflinePlannedOffsets(
             model->buffers();
         auto* buffer = (*buffers)[metadata->buffer()];
         auto* array = buffer->data();
+        if (array == nullptr ||
+            array->size() < kOfflinePlannerHeaderSize * sizeof(uint32_t)) {
+          TF_LITE_REPORT_ERROR(reporter_,
+                               "Offline memory allocation metadata is too "
+                               "small to contain a header.\n");
+          return kTfLiteError;
+        }
         const uint32_t* metadata_buffer =
             reinterpret_cast<const uint32_t*>(array->data());
         const size_t nbr_tensors = static_cast<size_t>(metadata_buffer[2]);
+        if (array->size() <
+            (kOfflinePlannerHeaderSize + nbr_tensors) * sizeof(uint32_t)) {
+          TF_LITE_REPORT_ERROR(reporter_,
+                               "Offline memory allocation metadata holds "
+                               "fewer than %d offsets.\n",
+                               nbr_tensors);
+          return kTfLiteError;
+        }
         *offline_planner_offsets =
             reinterpret_cast<const int32_t*>(&metadata_buffer[3]);
 
@@ -307,6 +328,17 @@ TfLiteStatus AllocationInfoBuilder::GetOfflinePlannedOffsets(
                                nbr_tensors, tensor_count_);
           return kTfLiteError;
         }
+        for (size_t n = 0; n < nbr_tensors; ++n) {
+          const int32_t offset = (*offline_planner_offsets)[n];
+          if (offset != kOnlinePlannedBuffer &&
+              (offset < 0 || offset % kBufferAlignment != 0)) {
+            TF_LITE_REPORT_ERROR(reporter_,
+                                 "Offline offset %d of tensor %d is not a "
+                                 "non-negative multiple of %d.\n",
+                                 offset, n, kBufferAlignment);
+            return kTfLiteError;
+          }
+        }
       }
     }
   }
@@ -358,6 +390,60 @@ TfLiteStatus CreatePlan(ErrorReporter* error_reporter,
   return kTfLiteOk;
 }
 
+// Returns true if every buffer that needs allocating has an offline planned
+// offset, in which case the plan can be committed without a memory planner.
+bool IsFullyOfflinePlanned(const AllocationInfo* allocation_info,
+                           size_t allocation_info_size) {
+  for (size_t i = 0; i < allocation_info_size; ++i) {
+    const AllocationInfo* current = &allocation_info[i];
+    if (current->needs_allocating &&
+        current->offline_offset == kOnlinePlannedBuffer) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Sets buffer pointers straight from the offline planned offsets, verifying
+// that every buffer fits in `available_arena_size` bytes. The number of bytes
+// used by the plan is returned in `plan_size`.
+TfLiteStatus CommitOfflinePlan(ErrorReporter* error_reporter,
+                               uint8_t* starting_point,
+                               size_t available_arena_size,
+                               const AllocationInfo* allocation_info,
+                               size_t allocation_info_size,
+                               size_t* plan_size) {
+  size_t max_end = 0;
+  for (size_t i = 0; i < allocation_info_size; ++i) {
+    const AllocationInfo* current = &allocation_info[i];
+    if (!current->needs_allocating) {
+      continue;
+    }
+    const size_t offset = static_cast<size_t>(current->offline_offset);
+    const size_t end = offset + AlignSizeUp(current->bytes, kBufferAlignment);
+    if (end > available_arena_size) {
+      TF_LITE_REPORT_ERROR(
+          error_reporter,
+          "Offline planned buffer %d ends at %u but only %u bytes are "
+          "available in the arena.",
+          i, end, available_arena_size);
+      return kTfLiteError;
+    }
+    if (end > max_end) {
+      max_end = end;
+    }
+  }
+  for (size_t i = 0; i < allocation_info_size; ++i) {
+    const AllocationInfo* current = &allocation_info[i];
+    if (current->needs_allocating) {
+      *current->output_ptr =
+          reinterpret_cast<void*>(starting_point + current->offline_offset);
+    }
+  }
+  *plan_size = max_end;
+  return kTfLiteOk;
+}
+
 TfLiteStatus CommitPlan(ErrorReporter* error_reporter, MemoryPlanner* planner,
                         uint8_t* starting_point,
                         const AllocationInfo* allocation_info,
@@ -1067,6 +1153,19 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   TF_LITE_ENSURE_STATUS(builder.AddScratchBuffers(scratch_buffer_requests,
                                                   scratch_buffer_handles));
 
+  if (offline_planner_offsets != nullptr &&
+      IsFullyOfflinePlanned(allocation_info, allocation_info_count)) {
+    // The model carries a complete plan, so skip the on-device planner and
+    // the temp arena it would need. As with CommitPlan below, allocation_info
+    // is still read after the temp allocations have been reset.
+    memory_allocator_->ResetTempAllocations();
+    TF_LITE_ENSURE_STATUS(CommitOfflinePlan(
+        error_reporter_, memory_allocator_->GetHeadBuffer(),
+        memory_allocator_->GetAvailableMemory(kBufferAlignment),
+        allocation_info, allocation_info_count, &head_usage));
+    return UpdateHeadBufferUsage(head_usage);
+  }
+
   // Remaining arena size that memory planner can use for calculating offsets.
   size_t remaining_arena_size =
       memory_allocator_->GetAvailableMemory(kBufferAlignment);
@@ -1097,7 +1196,10 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
                                    memory_allocator_->GetHeadBuffer(),
                                    allocation_info, allocation_info_count));
   head_usage = planner.GetMaximumMemorySize();
+  return UpdateHeadBufferUsage(head_usage);
+}
 
+TfLiteStatus MicroAllocator::UpdateHeadBufferUsage(size_t head_usage) {
   // The head is used to store memory plans for one model at a time during the
   // model preparation stage, and is re-purposed to store scratch buffer handles
   // during model invocation. The head must be as large as the greater of the
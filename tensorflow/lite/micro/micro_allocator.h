@@ -171,13 +171,19 @@ class MicroAllocator {
   // This method only requests a buffer with a given size to be used after a
   // model has finished allocation via FinishModelAllocation(). All requested
   // buffers will be accessible by the out-param in that method.
-  TfLiteStatus RequestScratchBufferInArena(size_t bytes, int* buffer_idx);
+  virtual TfLiteStatus RequestScratchBufferInArena(size_t bytes,
+                                                   int* buffer_idx);
+
+  // Called once the kernel of the node with `node_id` has been initialized.
+  // Nothing needs to be done here, but subclasses can use it to attribute the
+  // persistent buffers allocated by the kernel to its node.
+  virtual void FinishInitNodeAllocations(int node_id) {}
 
   // Finish allocating a specific NodeAndRegistration prepare block (kernel
   // entry for a model) with a given node ID. This call ensures that any scratch
   // buffer requests and temporary allocations are handled and ready for the
   // next node prepare block.
-  TfLiteStatus FinishPrepareNodeAllocations(int node_id);
+  virtual TfLiteStatus FinishPrepareNodeAllocations(int node_id);
 
   // Returns the arena usage in bytes, only available after
   // `FinishModelAllocation`. Otherwise, it will return 0.
@@ -244,6 +250,10 @@ class MicroAllocator {
       TfLiteEvalTensor* eval_tensors,
       ScratchBufferHandle* scratch_buffer_handles);
 
+  // Grows the head section to hold a committed memory plan of `head_usage`
+  // bytes, if it is larger than any plan committed so far.
+  TfLiteStatus UpdateHeadBufferUsage(size_t head_usage);
+
   // Allocates an array of ScratchBufferHandle structs in the tail section for a
   // given number of handles.
   virtual TfLiteStatus AllocateScratchBufferHandles(
@@ -280,6 +280,7 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
       node->user_data =
           registration->init(&context_, init_data, init_data_size);
     }
+    allocator_.FinishInitNodeAllocations(/*node_id=*/i);
   }
 
   // Both AllocatePersistentBuffer and RequestScratchBufferInArena is
@@ -0,0 +1,212 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/micro_op_report.h"
+
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/micro/micro_time.h"
+
+namespace tflite {
+namespace {
+
+constexpr char kReportMagic[] = {'T', 'F', 'O', 'R'};
+constexpr uint8_t kReportVersion = 1;
+
+// Appends bytes to a fixed-size buffer, remembering whether any did not fit.
+class ReportWriter {
+ public:
+  ReportWriter(uint8_t* buffer, size_t size) : buffer_(buffer), size_(size) {}
+
+  void WriteByte(uint8_t value) {
+    if (offset_ < size_) {
+      buffer_[offset_] = value;
+    } else {
+      overflow_ = true;
+    }
+    ++offset_;
+  }
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      WriteByte(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    WriteByte(static_cast<uint8_t>(value));
+  }
+
+  size_t offset() const { return offset_; }
+  bool overflow() const { return overflow_; }
+
+ private:
+  uint8_t* buffer_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool overflow_ = false;
+};
+
+// Reads bytes from a report, remembering whether it was malformed.
+class ReportReader {
+ public:
+  ReportReader(const uint8_t* report, size_t size)
+      : report_(report), size_(size) {}
+
+  uint8_t ReadByte() {
+    if (offset_ >= size_) {
+      error_ = true;
+      return 0;
+    }
+    return report_[offset_++];
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && !error_; shift += 7) {
+      const uint8_t byte = ReadByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+    error_ = true;
+    return 0;
+  }
+
+  // Returns a pointer to the next `length` bytes, and skips them.
+  const char* ReadBytes(size_t length) {
+    if (length > size_ - offset_) {
+      error_ = true;
+      return nullptr;
+    }
+    const char* bytes = reinterpret_cast<const char*>(report_ + offset_);
+    offset_ += length;
+    return bytes;
+  }
+
+  bool error() const { return error_; }
+
+ private:
+  const uint8_t* report_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool error_ = false;
+};
+
+size_t StringLength(const char* string) {
+  size_t length = 0;
+  while (string[length] != '\0') ++length;
+  return length;
+}
+
+}  // namespace
+
+MicroOpProfiler::MicroOpProfiler(MicroOpReportEntry* entries,
+                                 size_t max_entries)
+    : entries_(entries), max_entries_(max_entries) {
+  Reset();
+}
+
+void MicroOpProfiler::Reset() {
+  for (size_t i = 0; i < max_entries_; ++i) {
+    entries_[i] = {};
+  }
+  num_entries_ = 0;
+  current_entry_ = nullptr;
+}
+
+uint32_t MicroOpProfiler::BeginEvent(const char* tag, EventType event_type,
+                                     int64_t event_metadata1,
+                                     int64_t event_metadata2) {
+  current_entry_ = nullptr;
+  if (event_type != EventType::OPERATOR_INVOKE_EVENT || event_metadata1 < 0 ||
+      static_cast<uint64_t>(event_metadata1) >= max_entries_) {
+    return 0;
+  }
+  TFLITE_DCHECK(tag != nullptr);
+  const size_t node_index = static_cast<size_t>(event_metadata1);
+  current_entry_ = &entries_[node_index];
+  current_entry_->name = tag;
+  if (node_index >= num_entries_) {
+    num_entries_ = node_index + 1;
+  }
+  start_time_ = GetCurrentTimeTicks();
+  return 0;
+}
+
+void MicroOpProfiler::EndEvent(uint32_t event_handle) {
+  if (current_entry_ == nullptr) return;
+  const int32_t end_time = GetCurrentTimeTicks();
+  ++current_entry_->invocations;
+  current_entry_->ticks += static_cast<uint32_t>(end_time - start_time_);
+  current_entry_ = nullptr;
+}
+
+TfLiteStatus WriteMicroOpReport(const MicroOpProfiler& profiler,
+                                const RecordingMicroAllocator* allocator,
+                                uint8_t* buffer, size_t buffer_size,
+                                size_t* bytes_written) {
+  ReportWriter writer(buffer, buffer_size);
+  for (char c : kReportMagic) {
+    writer.WriteByte(static_cast<uint8_t>(c));
+  }
+  writer.WriteByte(kReportVersion);
+  writer.WriteVarint(profiler.num_entries());
+
+  for (size_t i = 0; i < profiler.num_entries(); ++i) {
+    const MicroOpReportEntry& entry = profiler.entries()[i];
+    const size_t name_length =
+        entry.name == nullptr ? 0 : StringLength(entry.name);
+    writer.WriteVarint(name_length);
+    for (size_t j = 0; j < name_length; ++j) {
+      writer.WriteByte(static_cast<uint8_t>(entry.name[j]));
+    }
+    writer.WriteVarint(entry.invocations);
+    writer.WriteVarint(entry.ticks);
+
+    RecordedNodeAllocation node_allocation = {};
+    if (allocator != nullptr) {
+      node_allocation = allocator->GetRecordedNodeAllocation(i);
+    }
+    writer.WriteVarint(node_allocation.persistent_bytes);
+    writer.WriteVarint(node_allocation.scratch_bytes);
+  }
+
+  *bytes_written = writer.offset();
+  return writer.overflow() ? kTfLiteError : kTfLiteOk;
+}
+
+TfLiteStatus ReadMicroOpReport(const uint8_t* report, size_t report_size,
+                               MicroOpReportEntry* entries, size_t max_entries,
+                               size_t* num_entries) {
+  ReportReader reader(report, report_size);
+  for (char c : kReportMagic) {
+    if (reader.ReadByte() != static_cast<uint8_t>(c)) return kTfLiteError;
+  }
+  if (reader.ReadByte() != kReportVersion) return kTfLiteError;
+
+  const uint64_t count = reader.ReadVarint();
+  if (reader.error() || count > max_entries) return kTfLiteError;
+  for (size_t i = 0; i < count; ++i) {
+    MicroOpReportEntry& entry = entries[i];
+    entry.name_length = reader.ReadVarint();
+    entry.name = reader.ReadBytes(entry.name_length);
+    entry.invocations = reader.ReadVarint();
+    entry.ticks = reader.ReadVarint();
+    entry.persistent_bytes = reader.ReadVarint();
+    entry.scratch_bytes = reader.ReadVarint();
+    if (reader.error()) return kTfLiteError;
+  }
+  *num_entries = count;
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
@@ -0,0 +1,121 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_MICRO_OP_REPORT_H_
+#define TENSORFLOW_LITE_MICRO_MICRO_OP_REPORT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/api/profiler.h"
+#include "tensorflow/lite/micro/compatibility.h"
+#include "tensorflow/lite/micro/recording_micro_allocator.h"
+
+namespace tflite {
+
+// Invocation time and arena usage of a single node of a model.
+struct MicroOpReportEntry {
+  // Name of the operator, which is not null-terminated when decoded.
+  const char* name;
+  size_t name_length;
+  // Number of times the node was invoked, and the ticks (see micro_time.h)
+  // spent in those invocations.
+  uint32_t invocations;
+  uint64_t ticks;
+  // Arena usage of the node, see RecordedNodeAllocation.
+  size_t persistent_bytes;
+  size_t scratch_bytes;
+};
+
+// Profiler collecting the invocation count and ticks of each node into a
+// caller-provided array of entries, indexed by node. Nodes are profiled by the
+// MicroInterpreter in builds without NDEBUG only.
+//
+// Usage example:
+// MicroOpReportEntry entries[kMaxNodes];
+// MicroOpProfiler profiler(entries, kMaxNodes);
+// RecordedNodeAllocation node_allocations[kMaxNodes];
+// RecordingMicroAllocator* allocator =
+//     RecordingMicroAllocator::Create(arena, arena_size, error_reporter);
+// allocator->RecordNodeAllocations(node_allocations, kMaxNodes);
+// RecordingMicroInterpreter interpreter(model, op_resolver, allocator,
+//                                       error_reporter, &profiler);
+// interpreter.Invoke();
+// size_t report_size;
+// WriteMicroOpReport(profiler, allocator, buffer, buffer_size, &report_size);
+class MicroOpProfiler : public tflite::Profiler {
+ public:
+  // `entries` must hold `max_entries` entries and outlive the profiler. Nodes
+  // with an index past `max_entries` are not profiled.
+  MicroOpProfiler(MicroOpReportEntry* entries, size_t max_entries);
+  ~MicroOpProfiler() override = default;
+
+  // AddEvent is unused for Tf Micro.
+  void AddEvent(const char* tag, EventType event_type, uint64_t start,
+                uint64_t end, int64_t event_metadata1,
+                int64_t event_metadata2) override{};
+
+  // Only OPERATOR_INVOKE_EVENT events, whose event_metadata1 is the node
+  // index, are recorded. As in MicroProfiler, concurrent events are
+  // unsupported and the tag pointer must be valid until EndEvent is called.
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override;
+
+  void EndEvent(uint32_t event_handle) override;
+
+  // Clears all recorded invocations.
+  void Reset();
+
+  const MicroOpReportEntry* entries() const { return entries_; }
+
+  // One past the highest node index recorded so far.
+  size_t num_entries() const { return num_entries_; }
+
+ private:
+  MicroOpReportEntry* entries_;
+  size_t max_entries_;
+  size_t num_entries_ = 0;
+  // Entry of the event in progress, or nullptr.
+  MicroOpReportEntry* current_entry_ = nullptr;
+  int32_t start_time_ = 0;
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+};
+
+// Writes the entries of `profiler`, with the node arena usage recorded by
+// `allocator` if it is not null, into `buffer` in a compact binary format:
+//
+//   "TFOR", format version (1 byte), number of entries
+//   per entry: name length, name bytes, invocations, ticks,
+//              persistent bytes, scratch bytes
+//
+// where all numbers but the version are unsigned LEB128 varints. Returns an
+// error if `buffer_size` bytes are not enough for the report.
+TfLiteStatus WriteMicroOpReport(const MicroOpProfiler& profiler,
+                                const RecordingMicroAllocator* allocator,
+                                uint8_t* buffer, size_t buffer_size,
+                                size_t* bytes_written);
+
+// Decodes a report written by WriteMicroOpReport(), typically on the host,
+// into `entries`. Entry names point into `report`. Returns an error if the
+// report is malformed or has more than `max_entries` entries.
+TfLiteStatus ReadMicroOpReport(const uint8_t* report, size_t report_size,
+                               MicroOpReportEntry* entries, size_t max_entries,
+                               size_t* num_entries);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_MICRO_OP_REPORT_H_
@@ -0,0 +1,137 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/micro_op_report.h"
+
+#include "tensorflow/lite/micro/all_ops_resolver.h"
+#include "tensorflow/lite/micro/recording_micro_interpreter.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+#include "tensorflow/lite/micro/testing/test_conv_model.h"
+
+namespace {
+
+constexpr int kTestConvArenaSize = 1024 * 12;
+constexpr int kMaxNodes = 16;
+constexpr int kReportSize = 512;
+
+}  // namespace
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(TestReportRoundTrip) {
+  tflite::MicroOpReportEntry entries[2];
+  tflite::MicroOpProfiler profiler(entries, 2);
+  profiler.BeginEvent("CONV_2D",
+                      tflite::Profiler::EventType::OPERATOR_INVOKE_EVENT, 1,
+                      0);
+  profiler.EndEvent(0);
+  // Events other than operator invocations are ignored.
+  profiler.BeginEvent("other", tflite::Profiler::EventType::DEFAULT, 0, 0);
+  profiler.EndEvent(0);
+  TF_LITE_MICRO_EXPECT_EQ(profiler.num_entries(), static_cast<size_t>(2));
+
+  uint8_t report[kReportSize];
+  size_t report_size;
+  TF_LITE_MICRO_EXPECT_EQ(
+      tflite::WriteMicroOpReport(profiler, /*allocator=*/nullptr, report,
+                                 kReportSize, &report_size),
+      kTfLiteOk);
+
+  tflite::MicroOpReportEntry decoded[2];
+  size_t num_decoded;
+  TF_LITE_MICRO_EXPECT_EQ(tflite::ReadMicroOpReport(report, report_size,
+                                                    decoded, 2, &num_decoded),
+                          kTfLiteOk);
+  TF_LITE_MICRO_EXPECT_EQ(num_decoded, static_cast<size_t>(2));
+  TF_LITE_MICRO_EXPECT_EQ(decoded[0].name_length, static_cast<size_t>(0));
+  TF_LITE_MICRO_EXPECT_EQ(decoded[0].invocations, static_cast<uint32_t>(0));
+  TF_LITE_MICRO_EXPECT_EQ(decoded[1].name_length, static_cast<size_t>(7));
+  TF_LITE_MICRO_EXPECT_EQ(decoded[1].name[0], 'C');
+  TF_LITE_MICRO_EXPECT_EQ(decoded[1].name[6], 'D');
+  TF_LITE_MICRO_EXPECT_EQ(decoded[1].invocations, static_cast<uint32_t>(1));
+  TF_LITE_MICRO_EXPECT_EQ(decoded[1].ticks, entries[1].ticks);
+
+  // Truncated reports and too small buffers are rejected.
+  TF_LITE_MICRO_EXPECT_EQ(tflite::ReadMicroOpReport(report, report_size - 1,
+                                                    decoded, 2, &num_decoded),
+                          kTfLiteError);
+  TF_LITE_MICRO_EXPECT_EQ(tflite::ReadMicroOpReport(report, report_size,
+                                                    decoded, 1, &num_decoded),
+                          kTfLiteError);
+  TF_LITE_MICRO_EXPECT_EQ(
+      tflite::WriteMicroOpReport(profiler, /*allocator=*/nullptr, report,
+                                 report_size - 1, &report_size),
+      kTfLiteError);
+}
+
+TF_LITE_MICRO_TEST(TestReportsInvocationsAndArenaUsagePerNode) {
+  tflite::AllOpsResolver all_ops_resolver;
+  const tflite::Model* model = tflite::GetModel(kTestConvModelData);
+  uint8_t arena[kTestConvArenaSize];
+
+  tflite::MicroOpReportEntry entries[kMaxNodes];
+  tflite::MicroOpProfiler profiler(entries, kMaxNodes);
+  tflite::RecordedNodeAllocation node_allocations[kMaxNodes];
+  tflite::RecordingMicroAllocator* allocator =
+      tflite::RecordingMicroAllocator::Create(arena, kTestConvArenaSize,
+                                              micro_test::reporter);
+  allocator->RecordNodeAllocations(node_allocations, kMaxNodes);
+  tflite::RecordingMicroInterpreter interpreter(
+      model, all_ops_resolver, allocator, micro_test::reporter, &profiler);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.Invoke(), kTfLiteOk);
+
+  size_t persistent_bytes = 0;
+  for (int i = 0; i < kMaxNodes; ++i) {
+    persistent_bytes +=
+        allocator->GetRecordedNodeAllocation(i).persistent_bytes;
+  }
+  TF_LITE_MICRO_EXPECT_GT(persistent_bytes, static_cast<size_t>(0));
+  TF_LITE_MICRO_EXPECT_LE(
+      persistent_bytes,
+      allocator
+          ->GetRecordedAllocation(
+              tflite::RecordedAllocationType::kPersistentBufferData)
+          .requested_bytes);
+
+  uint8_t report[kReportSize];
+  size_t report_size;
+  TF_LITE_MICRO_EXPECT_EQ(tflite::WriteMicroOpReport(
+                              profiler, allocator, report, kReportSize,
+                              &report_size),
+                          kTfLiteOk);
+
+  tflite::MicroOpReportEntry decoded[kMaxNodes];
+  size_t num_decoded;
+  TF_LITE_MICRO_EXPECT_EQ(
+      tflite::ReadMicroOpReport(report, report_size, decoded, kMaxNodes,
+                                &num_decoded),
+      kTfLiteOk);
+  size_t decoded_persistent_bytes = 0;
+  for (size_t i = 0; i < num_decoded; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(decoded[i].invocations, static_cast<uint32_t>(1));
+    TF_LITE_MICRO_EXPECT_GT(decoded[i].name_length, static_cast<size_t>(0));
+    decoded_persistent_bytes += decoded[i].persistent_bytes;
+  }
+  // The interpreter only profiles operators in builds without NDEBUG.
+  if (num_decoded > 0) {
+    TF_LITE_MICRO_EXPECT_EQ(num_decoded,
+                            model->subgraphs()->Get(0)->operators()->size());
+    TF_LITE_MICRO_EXPECT_EQ(decoded_persistent_bytes, persistent_bytes);
+  }
+}
+
+TF_LITE_MICRO_TESTS_END
@@ -105,14 +105,66 @@ void RecordingMicroAllocator::PrintAllocations() const {
                           "Operator runtime data", "OpData structs");
 }
 
+void RecordingMicroAllocator::RecordNodeAllocations(
+    RecordedNodeAllocation* node_allocations, size_t num_node_allocations) {
+  node_allocations_ = node_allocations;
+  num_node_allocations_ = num_node_allocations;
+  for (size_t i = 0; i < num_node_allocations_; ++i) {
+    node_allocations_[i] = {};
+  }
+  pending_node_allocation_ = {};
+}
+
+RecordedNodeAllocation RecordingMicroAllocator::GetRecordedNodeAllocation(
+    int node_id) const {
+  if (node_id < 0 || static_cast<size_t>(node_id) >= num_node_allocations_) {
+    return RecordedNodeAllocation();
+  }
+  return node_allocations_[node_id];
+}
+
 void* RecordingMicroAllocator::AllocatePersistentBuffer(size_t bytes) {
   RecordedAllocation allocations = SnapshotAllocationUsage();
   void* buffer = MicroAllocator::AllocatePersistentBuffer(bytes);
   RecordAllocationUsage(allocations, recorded_persistent_buffer_data_);
 
+  if (buffer != nullptr) {
+    pending_node_allocation_.persistent_bytes += bytes;
+  }
   return buffer;
 }
 
+TfLiteStatus RecordingMicroAllocator::RequestScratchBufferInArena(
+    size_t bytes, int* buffer_idx) {
+  TfLiteStatus status =
+      MicroAllocator::RequestScratchBufferInArena(bytes, buffer_idx);
+  if (status == kTfLiteOk) {
+    pending_node_allocation_.scratch_bytes += bytes;
+  }
+  return status;
+}
+
+void RecordingMicroAllocator::FinishInitNodeAllocations(int node_id) {
+  MicroAllocator::FinishInitNodeAllocations(node_id);
+  RecordPendingNodeAllocation(node_id);
+}
+
+TfLiteStatus RecordingMicroAllocator::FinishPrepareNodeAllocations(
+    int node_id) {
+  RecordPendingNodeAllocation(node_id);
+  return MicroAllocator::FinishPrepareNodeAllocations(node_id);
+}
+
+void RecordingMicroAllocator::RecordPendingNodeAllocation(int node_id) {
+  if (node_id >= 0 && static_cast<size_t>(node_id) < num_node_allocations_) {
+    node_allocations_[node_id].persistent_bytes +=
+        pending_node_allocation_.persistent_bytes;
+    node_allocations_[node_id].scratch_bytes +=
+        pending_node_allocation_.scratch_bytes;
+  }
+  pending_node_allocation_ = {};
+}
+
 void RecordingMicroAllocator::PrintRecordedAllocation(
     RecordedAllocationType allocation_type, const char* allocation_name,
     const char* allocation_description) const {
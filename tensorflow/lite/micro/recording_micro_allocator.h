@@ -45,6 +45,14 @@ struct RecordedAllocation {
   size_t count;
 };
 
+// Arena usage attributed to a single node of a model: the bytes of the
+// persistent buffers its kernel allocated and of the scratch buffers it
+// requested while being initialized and prepared.
+struct RecordedNodeAllocation {
+  size_t persistent_bytes;
+  size_t scratch_bytes;
+};
+
 // Utility subclass of MicroAllocator that records all allocations
 // inside the arena. A summary of allocations can be logged through the
 // ErrorReporter by invoking LogAllocations(). This special allocator requires
@@ -68,7 +76,22 @@ class RecordingMicroAllocator : public MicroAllocator {
   // defined in RecordedAllocationType.
   void PrintAllocations() const;
 
+  // Records the arena usage of each node into `node_allocations`, which should
+  // hold one entry per node of the model and must outlive the allocator. The
+  // records live outside of the arena so that keeping them does not change the
+  // arena usage. Nodes beyond `num_node_allocations` are not recorded.
+  void RecordNodeAllocations(RecordedNodeAllocation* node_allocations,
+                             size_t num_node_allocations);
+
+  // Returns the recorded arena usage of the node with `node_id`, or zeros if
+  // it was not recorded.
+  RecordedNodeAllocation GetRecordedNodeAllocation(int node_id) const;
+
   void* AllocatePersistentBuffer(size_t bytes) override;
+  TfLiteStatus RequestScratchBufferInArena(size_t bytes,
+                                           int* buffer_idx) override;
+  void FinishInitNodeAllocations(int node_id) override;
+  TfLiteStatus FinishPrepareNodeAllocations(int node_id) override;
 
  protected:
   TfLiteStatus AllocateNodeAndRegistrations(
@@ -117,6 +140,13 @@ class RecordingMicroAllocator : public MicroAllocator {
   RecordedAllocation recorded_node_and_registration_array_data_ = {};
   RecordedAllocation recorded_op_data_ = {};
 
+  // Assigns the usage recorded since the previous node finished to `node_id`.
+  void RecordPendingNodeAllocation(int node_id);
+
+  RecordedNodeAllocation* node_allocations_ = nullptr;
+  size_t num_node_allocations_ = 0;
+  RecordedNodeAllocation pending_node_allocation_ = {};
+
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
 
@@ -37,19 +37,22 @@ class RecordingMicroInterpreter : public MicroInterpreter {
   RecordingMicroInterpreter(const Model* model,
                             const MicroOpResolver& op_resolver,
                             uint8_t* tensor_arena, size_t tensor_arena_size,
-                            ErrorReporter* error_reporter)
+                            ErrorReporter* error_reporter,
+                            tflite::Profiler* profiler = nullptr)
       : MicroInterpreter(model, op_resolver,
                          RecordingMicroAllocator::Create(
                              tensor_arena, tensor_arena_size, error_reporter),
-                         error_reporter),
+                         error_reporter, profiler),
         recording_micro_allocator_(
             static_cast<const RecordingMicroAllocator&>(allocator())) {}
 
   RecordingMicroInterpreter(const Model* model,
                             const MicroOpResolver& op_resolver,
                             RecordingMicroAllocator* allocator,
-                            ErrorReporter* error_reporter)
-      : MicroInterpreter(model, op_resolver, allocator, error_reporter),
+                            ErrorReporter* error_reporter,
+                            tflite::Profiler* profiler = nullptr)
+      : MicroInterpreter(model, op_resolver, allocator, error_reporter,
+                         profiler),
         recording_micro_allocator_(*allocator) {}
 
   const RecordingMicroAllocator& GetMicroAllocator() const {
@@ -232,6 +232,36 @@ TEST(BasicFlatBufferModel, TestModelInInterpreter) {
   }
 }
 
+// Make sure replicas of a model share its read-only tensors.
+TEST(BasicFlatBufferModel, TestModelInInterpreterReplicas) {
+  auto model = FlatBufferModel::BuildFromFile(
+      "tensorflow/lite/testdata/test_model.bin");
+  ASSERT_TRUE(model);
+  InterpreterBuilder builder(*model, TrivialResolver(&dummy_reg));
+  std::vector<std::unique_ptr<Interpreter>> interpreters;
+  ASSERT_EQ(builder(&interpreters, 3), kTfLiteOk);
+  ASSERT_EQ(interpreters.size(), 3);
+  for (const std::unique_ptr<Interpreter>& interpreter : interpreters) {
+    ASSERT_NE(interpreter, nullptr);
+    ASSERT_EQ(interpreter->tensors_size(), 4);
+    ASSERT_EQ(interpreter->nodes_size(), 2);
+    ASSERT_EQ(interpreter->tensor(0)->allocation_type, kTfLiteMmapRo);
+    EXPECT_EQ(interpreter->tensor(0)->data.raw,
+              interpreters[0]->tensor(0)->data.raw);
+    ASSERT_EQ(interpreter->tensor(1)->allocation_type, kTfLiteArenaRw);
+  }
+  EXPECT_NE(interpreters[0].get(), interpreters[1].get());
+  EXPECT_NE(interpreters[0]->tensor(1), interpreters[1]->tensor(1));
+
+  ASSERT_NE(builder(&interpreters, 0), kTfLiteOk);
+  EXPECT_TRUE(interpreters.empty());
+  ASSERT_NE(builder(nullptr, 1), kTfLiteOk);
+
+  InterpreterBuilder failing_builder(*model, TrivialResolver(nullptr));
+  ASSERT_NE(failing_builder(&interpreters, 2), kTfLiteOk);
+  EXPECT_TRUE(interpreters.empty());
+}
+
 // Test that loading a model with TensorFlow ops fails when the flex delegate is
 // not linked into the target.
 TEST(FlexModel, FailureWithoutFlexDelegate) {
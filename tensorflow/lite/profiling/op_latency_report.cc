@@ -0,0 +1,131 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/op_latency_report.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+std::string QuoteCSV(const std::string& value) {
+  std::string quoted = "\"";
+  for (char c : value) {
+    if (c == '"') quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+std::string QuoteJSON(const std::string& value) {
+  std::string quoted = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      quoted += ' ';
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+}  // namespace
+
+int64_t GetPercentile(const std::vector<int64_t>& sorted_values,
+                      double percentile) {
+  if (sorted_values.empty()) return 0;
+  const double rank = std::ceil(percentile / 100.0 * sorted_values.size());
+  const size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+  return sorted_values[std::min(index, sorted_values.size() - 1)];
+}
+
+void OpLatencyReport::AddSample(uint32_t subgraph_index,
+                                const std::string& name,
+                                const std::string& type, int64_t latency_us) {
+  OpSamples& op = ops_[{subgraph_index, name}];
+  if (op.type.empty()) op.type = type;
+  op.latencies_us.push_back(latency_us);
+}
+
+std::vector<OpLatencyReport::OpLatencyStats> OpLatencyReport::GetStats()
+    const {
+  std::vector<OpLatencyStats> stats;
+  stats.reserve(ops_.size());
+  for (const auto& op : ops_) {
+    std::vector<int64_t> sorted = op.second.latencies_us;
+    std::sort(sorted.begin(), sorted.end());
+    OpLatencyStats op_stats;
+    op_stats.subgraph_index = op.first.first;
+    op_stats.name = op.first.second;
+    op_stats.type = op.second.type;
+    op_stats.count = sorted.size();
+    op_stats.total_us = 0;
+    for (int64_t latency_us : sorted) op_stats.total_us += latency_us;
+    op_stats.avg_us = static_cast<double>(op_stats.total_us) / op_stats.count;
+    op_stats.min_us = sorted.front();
+    op_stats.p50_us = GetPercentile(sorted, 50);
+    op_stats.p90_us = GetPercentile(sorted, 90);
+    op_stats.p99_us = GetPercentile(sorted, 99);
+    op_stats.max_us = sorted.back();
+    stats.push_back(std::move(op_stats));
+  }
+  std::stable_sort(stats.begin(), stats.end(),
+                   [](const OpLatencyStats& a, const OpLatencyStats& b) {
+                     return a.total_us > b.total_us;
+                   });
+  return stats;
+}
+
+std::string OpLatencyReport::GetCSVString() const {
+  std::stringstream stream;
+  stream << "subgraph,node,type,count,total_us,avg_us,min_us,p50_us,p90_us,"
+            "p99_us,max_us"
+         << std::endl;
+  for (const auto& op : GetStats()) {
+    stream << op.subgraph_index << "," << QuoteCSV(op.name) << ","
+           << QuoteCSV(op.type) << "," << op.count << "," << op.total_us << ","
+           << op.avg_us << "," << op.min_us << "," << op.p50_us << ","
+           << op.p90_us << "," << op.p99_us << "," << op.max_us << std::endl;
+  }
+  return stream.str();
+}
+
+std::string OpLatencyReport::GetJSONString() const {
+  std::stringstream stream;
+  stream << "[";
+  bool first = true;
+  for (const auto& op : GetStats()) {
+    stream << (first ? "\n" : ",\n");
+    first = false;
+    stream << "  {\"subgraph\": " << op.subgraph_index
+           << ", \"node\": " << QuoteJSON(op.name)
+           << ", \"type\": " << QuoteJSON(op.type)
+           << ", \"count\": " << op.count << ", \"total_us\": " << op.total_us
+           << ", \"avg_us\": " << op.avg_us << ", \"min_us\": " << op.min_us
+           << ", \"p50_us\": " << op.p50_us << ", \"p90_us\": " << op.p90_us
+           << ", \"p99_us\": " << op.p99_us << ", \"max_us\": " << op.max_us
+           << "}";
+  }
+  stream << (first ? "]" : "\n]") << std::endl;
+  return stream.str();
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,78 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_OP_LATENCY_REPORT_H_
+#define TENSORFLOW_LITE_PROFILING_OP_LATENCY_REPORT_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tflite {
+namespace profiling {
+
+// Keeps every latency sample of every operator across runs, so that the
+// latency distribution of an op (and not only its average as reported by
+// tensorflow::StatsCalculator) can be examined.
+class OpLatencyReport {
+ public:
+  struct OpLatencyStats {
+    uint32_t subgraph_index;
+    std::string name;
+    std::string type;
+    int64_t count;
+    int64_t total_us;
+    double avg_us;
+    int64_t min_us;
+    int64_t p50_us;
+    int64_t p90_us;
+    int64_t p99_us;
+    int64_t max_us;
+  };
+
+  // Records one invocation of the op 'name' of 'type' in 'subgraph_index'.
+  void AddSample(uint32_t subgraph_index, const std::string& name,
+                 const std::string& type, int64_t latency_us);
+
+  bool HasSamples() const { return !ops_.empty(); }
+
+  // Returns the per-op stats sorted by descending total time, i.e. the ops
+  // that contribute most to the overall latency come first.
+  std::vector<OpLatencyStats> GetStats() const;
+
+  // Returns the stats of GetStats() as CSV with a header line.
+  std::string GetCSVString() const;
+
+  // Returns the stats of GetStats() as a JSON array of objects.
+  std::string GetJSONString() const;
+
+ private:
+  struct OpSamples {
+    std::string type;
+    std::vector<int64_t> latencies_us;
+  };
+  std::map<std::pair<uint32_t, std::string>, OpSamples> ops_;
+};
+
+// Returns the nearest-rank 'percentile' (in [0, 100]) of 'sorted_values',
+// which must be sorted in ascending order. Returns 0 if it is empty.
+int64_t GetPercentile(const std::vector<int64_t>& sorted_values,
+                      double percentile);
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_OP_LATENCY_REPORT_H_
@@ -0,0 +1,92 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/op_latency_report.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace profiling {
+
+namespace {
+
+using ::testing::HasSubstr;
+
+TEST(OpLatencyReportTest, Percentile) {
+  std::vector<int64_t> values;
+  for (int i = 1; i <= 100; ++i) values.push_back(i);
+  EXPECT_EQ(GetPercentile(values, 0), 1);
+  EXPECT_EQ(GetPercentile(values, 50), 50);
+  EXPECT_EQ(GetPercentile(values, 90), 90);
+  EXPECT_EQ(GetPercentile(values, 99), 99);
+  EXPECT_EQ(GetPercentile(values, 100), 100);
+  EXPECT_EQ(GetPercentile({7}, 99), 7);
+  EXPECT_EQ(GetPercentile({}, 50), 0);
+}
+
+TEST(OpLatencyReportTest, Empty) {
+  OpLatencyReport report;
+  EXPECT_FALSE(report.HasSamples());
+  EXPECT_TRUE(report.GetStats().empty());
+  EXPECT_EQ(report.GetJSONString(), "[]\n");
+}
+
+TEST(OpLatencyReportTest, StatsSortedByTotalTime) {
+  OpLatencyReport report;
+  // A cheap op with a long tail, and an op that is slower on average.
+  for (int i = 0; i < 99; ++i) report.AddSample(0, "add:0", "ADD", 10);
+  report.AddSample(0, "add:0", "ADD", 1000);
+  for (int i = 0; i < 100; ++i) report.AddSample(0, "conv:1", "CONV_2D", 50);
+  report.AddSample(1, "add:0", "ADD", 5);
+  ASSERT_TRUE(report.HasSamples());
+
+  auto stats = report.GetStats();
+  ASSERT_EQ(stats.size(), 3);
+  EXPECT_EQ(stats[0].name, "conv:1");
+  EXPECT_EQ(stats[0].total_us, 5000);
+  EXPECT_EQ(stats[1].name, "add:0");
+  EXPECT_EQ(stats[1].subgraph_index, 0);
+  EXPECT_EQ(stats[1].type, "ADD");
+  EXPECT_EQ(stats[1].count, 100);
+  EXPECT_EQ(stats[1].total_us, 1990);
+  EXPECT_FLOAT_EQ(stats[1].avg_us, 19.9);
+  EXPECT_EQ(stats[1].min_us, 10);
+  EXPECT_EQ(stats[1].p50_us, 10);
+  EXPECT_EQ(stats[1].p99_us, 10);
+  EXPECT_EQ(stats[1].max_us, 1000);
+  EXPECT_EQ(stats[2].subgraph_index, 1);
+  EXPECT_EQ(stats[2].count, 1);
+}
+
+TEST(OpLatencyReportTest, CSVAndJSON) {
+  OpLatencyReport report;
+  report.AddSample(0, "[a, \"b\"]:0", "ADD", 4);
+  report.AddSample(0, "[a, \"b\"]:0", "ADD", 6);
+
+  EXPECT_EQ(report.GetCSVString(),
+            "subgraph,node,type,count,total_us,avg_us,min_us,p50_us,p90_us,"
+            "p99_us,max_us\n"
+            "0,\"[a, \"\"b\"\"]:0\",\"ADD\",2,10,5,4,4,6,6,6\n");
+  const std::string json = report.GetJSONString();
+  EXPECT_THAT(json, HasSubstr("\"node\": \"[a, \\\"b\\\"]:0\""));
+  EXPECT_THAT(json, HasSubstr("\"p90_us\": 6"));
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
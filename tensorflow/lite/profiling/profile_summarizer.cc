@@ -156,6 +156,8 @@ void ProfileSummarizer::ProcessProfiles(
       stats_calculator->AddNodeStats(node_name_in_stats, type_in_stats,
                                      node_num, start_us, node_exec_time,
                                      0 /*memory */);
+      op_latency_report_.AddSample(subgraph_index, node_name_in_stats,
+                                   type_in_stats, node_exec_time);
     } else if (event->event_type ==
                Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT) {
       const std::string node_name(event->tag);
@@ -167,6 +169,8 @@ void ProfileSummarizer::ProcessProfiles(
       delegate_stats_calculator_->AddNodeStats(
           node_name_in_stats, "DelegateOpInvoke", node_num, start_us,
           node_exec_time, 0 /*memory */);
+      op_latency_report_.AddSample(subgraph_index, node_name_in_stats,
+                                   "DelegateOpInvoke", node_exec_time);
     } else {
       // TODO(b/139812778) consider use a different stats_calculator to record
       // non-op-invoke events so that these could be separated from
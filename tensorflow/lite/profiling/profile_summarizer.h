@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "tensorflow/core/util/stats_calculator.h"
 #include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/profiling/op_latency_report.h"
 #include "tensorflow/lite/profiling/profile_buffer.h"
 #include "tensorflow/lite/profiling/profile_summary_formatter.h"
 
@@ -54,6 +55,11 @@ class ProfileSummarizer {
 
   tensorflow::StatsCalculator* GetStatsCalculator(uint32_t subgraph_index);
 
+  // Returns the latency samples of every op invocation processed so far.
+  const OpLatencyReport& GetOpLatencyReport() const {
+    return op_latency_report_;
+  }
+
   bool HasProfiles() {
     for (auto& stats_calc : stats_calculator_map_) {
       auto subgraph_stats = stats_calc.second.get();
@@ -69,6 +75,8 @@ class ProfileSummarizer {
 
   std::unique_ptr<tensorflow::StatsCalculator> delegate_stats_calculator_;
 
+  OpLatencyReport op_latency_report_;
+
   // Summary formatter for customized output formats.
   std::shared_ptr<ProfileSummaryFormatter> summary_formatter_;
 };
@@ -148,6 +148,30 @@ TEST(ProfileSummarizerTest, InterpreterPlusProfilingDetails) {
       << output;
 }
 
+TEST(ProfileSummarizerTest, OpLatencyReportAcrossRuns) {
+  BufferedProfiler profiler(1024);
+  SimpleOpModel m;
+  m.Init(RegisterSimpleOpWithProfilingDetails);
+  auto interpreter = m.GetInterpreter();
+  interpreter->SetProfiler(&profiler);
+  ProfileSummarizer summarizer;
+  EXPECT_FALSE(summarizer.GetOpLatencyReport().HasSamples());
+  for (int run = 0; run < 3; ++run) {
+    profiler.Reset();
+    profiler.StartProfiling();
+    m.SetInputs(1, 2);
+    m.Invoke();
+    profiler.StopProfiling();
+    summarizer.ProcessProfiles(profiler.GetProfileEvents(), *interpreter);
+  }
+  auto stats = summarizer.GetOpLatencyReport().GetStats();
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats[0].subgraph_index, 0);
+  EXPECT_EQ(stats[0].type, "SimpleOpEval/Profile");
+  EXPECT_EQ(stats[0].count, 3);
+  EXPECT_LE(stats[0].p50_us, stats[0].p99_us);
+}
+
 // A simple test that performs `ADD` if condition is true, and `MUL` otherwise.
 // The computation is: `cond ? a + b : a * b`.
 class ProfileSummarizerIfOpTest : public subgraph_test_util::ControlFlowOpTest {
@@ -40,6 +40,9 @@ BenchmarkParams BenchmarkModel::DefaultParams() {
   params.AddParam("output_prefix", BenchmarkParam::Create<std::string>(""));
   params.AddParam("warmup_runs", BenchmarkParam::Create<int32_t>(1));
   params.AddParam("warmup_min_secs", BenchmarkParam::Create<float>(0.5f));
+  params.AddParam("warmup_max_cv", BenchmarkParam::Create<float>(-1.0f));
+  params.AddParam("warmup_stability_window",
+                  BenchmarkParam::Create<int32_t>(10));
   params.AddParam("verbose", BenchmarkParam::Create<bool>(false));
   return params;
 }
@@ -108,6 +111,15 @@ std::vector<Flag> BenchmarkModel::GetFlags() {
           "warmup_min_secs", &params_,
           "minimum number of seconds to rerun for, potentially making the "
           "actual number of warm-up runs to be greater than warmup_runs"),
+      CreateFlag<float>(
+          "warmup_max_cv", &params_,
+          "if positive, keep warming up (within max_secs) until the "
+          "coefficient of variation of the latencies of the last "
+          "warmup_stability_window warm-up runs is at most this value, so that "
+          "regular runs start once CPU frequency and thermal state settled"),
+      CreateFlag<int32_t>("warmup_stability_window", &params_,
+                          "number of most recent warm-up runs considered by "
+                          "warmup_max_cv"),
       CreateFlag<bool>("verbose", &params_,
                        "Whether to log parameters whose values are not set. "
                        "By default, only log those parameters that are set by "
@@ -134,6 +146,10 @@ void BenchmarkModel::LogParams() {
   LOG_BENCHMARK_PARAM(int32_t, "warmup_runs", "Min warmup runs", verbose);
   LOG_BENCHMARK_PARAM(float, "warmup_min_secs",
                       "Min warmup runs duration (seconds)", verbose);
+  LOG_BENCHMARK_PARAM(float, "warmup_max_cv",
+                      "Max warmup latency coefficient of variation", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "warmup_stability_window",
+                      "Warmup stability window (runs)", verbose);
 }
 
 TfLiteStatus BenchmarkModel::PrepareInputData() { return kTfLiteOk; }
@@ -157,8 +173,15 @@ Stat<int64_t> BenchmarkModel::Run(int min_num_times, float min_secs,
   double manual_inter_run_gap = 1.0 / run_frequency;
   // float doesn't have sufficient precision for storing this number
   double next_run_finish_time = now_us * 1e-6 + manual_inter_run_gap;
-  for (int run = 0; (run < min_num_times || now_us < min_finish_us) &&
-                    now_us <= max_finish_us;
+  // Warm-up runs optionally continue until the latency has settled.
+  const float max_cv =
+      run_type == WARMUP ? params_.Get<float>("warmup_max_cv") : -1.0f;
+  const int stability_window = params_.Get<int32_t>("warmup_stability_window");
+  std::vector<int64_t> latencies_us;
+  bool stable = max_cv <= 0;
+  int run = 0;
+  for (; (run < min_num_times || now_us < min_finish_us || !stable) &&
+         now_us <= max_finish_us;
        run++) {
     ResetInputsAndOutputs();
     listeners_.OnSingleRunStart(run_type);
@@ -168,6 +191,10 @@ Stat<int64_t> BenchmarkModel::Run(int min_num_times, float min_secs,
     listeners_.OnSingleRunEnd();
 
     run_stats.UpdateStat(end_us - start_us);
+    if (max_cv > 0) {
+      latencies_us.push_back(end_us - start_us);
+      stable = util::IsLatencyStable(latencies_us, stability_window, max_cv);
+    }
     if (run_frequency > 0) {
       inter_run_sleep_time =
           next_run_finish_time - profiling::time::NowMicros() * 1e-6;
@@ -182,6 +209,15 @@ Stat<int64_t> BenchmarkModel::Run(int min_num_times, float min_secs,
       *invoke_status = status;
     }
   }
+  if (max_cv > 0) {
+    if (stable) {
+      TFLITE_LOG(INFO) << "Warm-up latency stabilized after " << run
+                       << " runs.";
+    } else {
+      TFLITE_LOG(WARN) << "Warm-up latency did not stabilize within "
+                       << params_.Get<float>("max_secs") << " seconds.";
+    }
+  }
 
   std::stringstream stream;
   run_stats.OutputToStream(&stream);
@@ -373,6 +373,39 @@ TEST(BenchmarkTest, RunWithUseCaching) {
   EXPECT_EQ(kTfLiteOk, status);
 }
 
+TEST(BenchmarkTest, RunWithConcurrentInvocations) {
+  ASSERT_THAT(g_fp32_model_path, testing::NotNull());
+  TestBenchmark benchmark(CreateFp32Params());
+  ScopedCommandlineArgs scoped_argv({"--num_concurrent_invocations=3"});
+  auto status = benchmark.Run(scoped_argv.argc(), scoped_argv.argv());
+  EXPECT_EQ(kTfLiteOk, status);
+}
+
+TEST(BenchmarkTest, RunWithWarmupStabilityDetection) {
+  ASSERT_THAT(g_fp32_model_path, testing::NotNull());
+  BenchmarkParams params = CreateFp32Params();
+  params.Set<float>("warmup_max_cv", 0.5f);
+  params.Set<int32_t>("warmup_stability_window", 3);
+  TestBenchmark benchmark(std::move(params));
+  EXPECT_EQ(kTfLiteOk, benchmark.Run());
+}
+
+TEST(BenchmarkTest, WritesOpLatencyReport) {
+  ASSERT_THAT(g_fp32_model_path, testing::NotNull());
+  const std::string report_path = CreateFilePath("op_latency_report.json");
+  BenchmarkParams params = CreateFp32Params();
+  params.Set<bool>("enable_op_profiling", true);
+  params.Set<std::string>("op_latency_report_file", report_path);
+  TestBenchmark benchmark(std::move(params));
+  ASSERT_EQ(kTfLiteOk, benchmark.Run());
+
+  std::ifstream report_file(report_path);
+  ASSERT_TRUE(report_file.good());
+  const std::string report((std::istreambuf_iterator<char>(report_file)),
+                           std::istreambuf_iterator<char>());
+  EXPECT_THAT(report, testing::HasSubstr("\"p99_us\""));
+}
+
 class MaxDurationWorksTestListener : public BenchmarkListener {
   void OnBenchmarkEnd(const BenchmarkResults& results) override {
     const int64_t num_actual_runs = results.inference_time_us().count();
@@ -23,6 +23,7 @@ limitations under the License.
 #include <memory>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <unordered_set>
 #include <vector>
 
@@ -254,6 +255,10 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<int32_t>(1024));
   default_params.AddParam("profiling_output_csv_file",
                           BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("op_latency_report_file",
+                          BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("num_concurrent_invocations",
+                          BenchmarkParam::Create<int32_t>(1));
 
   for (const auto& delegate_provider :
        tools::GetRegisteredDelegateProviders()) {
@@ -280,6 +285,7 @@ BenchmarkTfLiteModel::~BenchmarkTfLiteModel() {
   // Destory the owned interpreter earlier than other objects (specially
   // 'owned_delegates_').
   interpreter_.reset();
+  concurrent_interpreters_.clear();
 }
 
 std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
@@ -314,7 +320,18 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
       CreateFlag<std::string>(
           "profiling_output_csv_file", &params_,
           "File path to export profile data as CSV, if not set "
-          "prints to stdout.")};
+          "prints to stdout."),
+      CreateFlag<std::string>(
+          "op_latency_report_file", &params_,
+          "File path to export the per-op latency percentiles (p50/p90/p99) "
+          "of the regular runs to, sorted by total time. Written as JSON if "
+          "the path ends with '.json' and as CSV otherwise. Requires "
+          "--enable_op_profiling=true."),
+      CreateFlag<int32_t>(
+          "num_concurrent_invocations", &params_,
+          "Number of interpreters built from the same model and invoked "
+          "concurrently from separate threads in every run, to measure "
+          "contention effects. Op profiling only covers the first one.")};
 
   flags.insert(flags.end(), specific_flags.begin(), specific_flags.end());
 
@@ -349,6 +366,10 @@ void BenchmarkTfLiteModel::LogParams() {
                       "Max profiling buffer entries", verbose);
   LOG_BENCHMARK_PARAM(std::string, "profiling_output_csv_file",
                       "CSV File to export profiling data to", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "op_latency_report_file",
+                      "File to export per-op latency percentiles to", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "num_concurrent_invocations",
+                      "Num concurrent invocations", verbose);
 
   for (const auto& delegate_provider :
        tools::GetRegisteredDelegateProviders()) {
@@ -362,6 +383,10 @@ TfLiteStatus BenchmarkTfLiteModel::ValidateParams() {
         << "Please specify the name of your TF Lite input file with --graph";
     return kTfLiteError;
   }
+  if (params_.Get<int32_t>("num_concurrent_invocations") < 1) {
+    TFLITE_LOG(ERROR) << "--num_concurrent_invocations must be at least 1";
+    return kTfLiteError;
+  }
 
   return PopulateInputLayerInfo(
       params_.Get<std::string>("input_layer"),
@@ -546,11 +571,19 @@ TfLiteStatus BenchmarkTfLiteModel::PrepareInputData() {
 }
 
 TfLiteStatus BenchmarkTfLiteModel::ResetInputsAndOutputs() {
-  auto interpreter_inputs = interpreter_->inputs();
+  TF_LITE_ENSURE_STATUS(ResetInputs(interpreter_.get()));
+  for (auto& interpreter : concurrent_interpreters_) {
+    TF_LITE_ENSURE_STATUS(ResetInputs(interpreter.get()));
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus BenchmarkTfLiteModel::ResetInputs(Interpreter* interpreter) {
+  auto interpreter_inputs = interpreter->inputs();
   // Set the values of the input tensors from inputs_data_.
   for (int j = 0; j < interpreter_inputs.size(); ++j) {
     int i = interpreter_inputs[j];
-    TfLiteTensor* t = interpreter_->tensor(i);
+    TfLiteTensor* t = interpreter->tensor(i);
     if (t->type == kTfLiteString) {
       if (inputs_data_[j].data) {
         static_cast<DynamicBuffer*>(inputs_data_[j].data.get())
@@ -696,12 +729,64 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
     return kTfLiteError;
   }
 
+  TF_LITE_ENSURE_STATUS(InitConcurrentInterpreters());
+
   ruy_profiling_listener_.reset(new RuyProfileListener());
   AddListener(ruy_profiling_listener_.get());
 
   return kTfLiteOk;
 }
 
+TfLiteStatus BenchmarkTfLiteModel::InitConcurrentInterpreters() {
+  concurrent_interpreters_.clear();
+  const int32_t num_invocations =
+      params_.Get<int32_t>("num_concurrent_invocations");
+  if (num_invocations <= 1) return kTfLiteOk;
+
+  auto resolver = GetOpResolver();
+  const int32_t num_threads = params_.Get<int32_t>("num_threads");
+  for (int n = 1; n < num_invocations; ++n) {
+    std::unique_ptr<Interpreter> interpreter;
+    tflite::InterpreterBuilder(*model_, *resolver)(&interpreter, num_threads);
+    if (!interpreter) {
+      TFLITE_LOG(ERROR) << "Failed to initialize a concurrent interpreter";
+      return kTfLiteError;
+    }
+    interpreter->SetAllowFp16PrecisionForFp32(params_.Get<bool>("allow_fp16"));
+    // Every interpreter gets its own delegate instances as delegates are
+    // generally not safe to share across concurrently invoked interpreters.
+    for (const auto& delegate_provider :
+         tools::GetRegisteredDelegateProviders()) {
+      auto delegate = delegate_provider->CreateTfLiteDelegate(params_);
+      if (delegate == nullptr) continue;
+      if (interpreter->ModifyGraphWithDelegate(delegate.get()) != kTfLiteOk) {
+        TFLITE_LOG(ERROR) << "Failed to apply " << delegate_provider->GetName()
+                          << " delegate to a concurrent interpreter.";
+        return kTfLiteError;
+      }
+      owned_delegates_.emplace_back(std::move(delegate));
+    }
+    // Use the input shapes the primary interpreter has been resized to.
+    for (int j = 0; j < interpreter_->inputs().size(); ++j) {
+      const TfLiteTensor* t = interpreter_->input_tensor(j);
+      if (t->type != kTfLiteString) {
+        interpreter->ResizeInputTensor(
+            interpreter->inputs()[j],
+            std::vector<int>(t->dims->data, t->dims->data + t->dims->size));
+      }
+    }
+    if (interpreter->AllocateTensors() != kTfLiteOk) {
+      TFLITE_LOG(ERROR) << "Failed to allocate tensors of a concurrent "
+                           "interpreter!";
+      return kTfLiteError;
+    }
+    concurrent_interpreters_.push_back(std::move(interpreter));
+  }
+  TFLITE_LOG(INFO) << "Invoking " << num_invocations
+                   << " interpreters concurrently in every run.";
+  return kTfLiteOk;
+}
+
 TfLiteStatus BenchmarkTfLiteModel::LoadModel() {
   std::string graph = params_.Get<std::string>("graph");
   model_ = tflite::FlatBufferModel::BuildFromFile(graph.c_str());
@@ -728,10 +813,29 @@ BenchmarkTfLiteModel::MayCreateProfilingListener() const {
       interpreter_.get(), params_.Get<int32_t>("max_profiling_buffer_entries"),
       params_.Get<std::string>("profiling_output_csv_file"),
       CreateProfileSummaryFormatter(
-          !params_.Get<std::string>("profiling_output_csv_file").empty())));
+          !params_.Get<std::string>("profiling_output_csv_file").empty()),
+      params_.Get<std::string>("op_latency_report_file")));
 }
 
-TfLiteStatus BenchmarkTfLiteModel::RunImpl() { return interpreter_->Invoke(); }
+TfLiteStatus BenchmarkTfLiteModel::RunImpl() {
+  if (concurrent_interpreters_.empty()) return interpreter_->Invoke();
+
+  std::vector<TfLiteStatus> statuses(concurrent_interpreters_.size(),
+                                     kTfLiteOk);
+  std::vector<std::thread> threads;
+  threads.reserve(concurrent_interpreters_.size());
+  for (int i = 0; i < concurrent_interpreters_.size(); ++i) {
+    threads.emplace_back([this, i, &statuses]() {
+      statuses[i] = concurrent_interpreters_[i]->Invoke();
+    });
+  }
+  TfLiteStatus status = interpreter_->Invoke();
+  for (auto& thread : threads) thread.join();
+  for (TfLiteStatus s : statuses) {
+    if (s != kTfLiteOk) status = s;
+  }
+  return status;
+}
 
 }  // namespace benchmark
 }  // namespace tflite
@@ -118,12 +118,20 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   InputTensorData LoadInputTensorData(const TfLiteTensor& t,
                                       const std::string& input_file_path);
 
+  // Copies 'inputs_data_' into the input tensors of 'interpreter'.
+  TfLiteStatus ResetInputs(Interpreter* interpreter);
+
+  // Builds the extra interpreters requested by --num_concurrent_invocations.
+  TfLiteStatus InitConcurrentInterpreters();
+
   std::vector<InputLayerInfo> inputs_;
   std::vector<InputTensorData> inputs_data_;
   std::unique_ptr<BenchmarkListener> profiling_listener_ = nullptr;
   std::unique_ptr<BenchmarkListener> ruy_profiling_listener_ = nullptr;
   std::mt19937 random_engine_;
   std::vector<Interpreter::TfLiteDelegatePtr> owned_delegates_;
+  // Invoked concurrently with 'interpreter_' in every run. Not profiled.
+  std::vector<std::unique_ptr<tflite::Interpreter>> concurrent_interpreters_;
   // Always TFLITE_LOG the benchmark result.
   BenchmarkLoggingListener log_output_;
 };
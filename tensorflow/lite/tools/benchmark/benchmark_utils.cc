@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/lite/tools/benchmark/benchmark_utils.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "tensorflow/lite/profiling/time.h"
 
 namespace tflite {
@@ -32,6 +35,23 @@ void SleepForSeconds(double sleep_seconds) {
       static_cast<uint64_t>(sleep_seconds * 1e6));
 }
 
+bool IsLatencyStable(const std::vector<int64_t>& latencies_us, int window,
+                     float max_cv) {
+  if (window <= 0 || latencies_us.size() < static_cast<size_t>(window)) {
+    return false;
+  }
+  double sum = 0.0;
+  double squared_sum = 0.0;
+  for (auto it = latencies_us.end() - window; it != latencies_us.end(); ++it) {
+    sum += *it;
+    squared_sum += static_cast<double>(*it) * *it;
+  }
+  const double mean = sum / window;
+  if (mean <= 0.0) return true;
+  const double variance = std::max(0.0, squared_sum / window - mean * mean);
+  return std::sqrt(variance) / mean <= max_cv;
+}
+
 }  // namespace util
 }  // namespace benchmark
 }  // namespace tflite
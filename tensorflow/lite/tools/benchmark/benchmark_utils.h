@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_UTILS_H_
 #define TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_UTILS_H_
 
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -28,6 +29,13 @@ namespace util {
 // simply return if 'sleep_seconds' is negative.
 void SleepForSeconds(double sleep_seconds);
 
+// Returns true if the coefficient of variation (i.e. stddev / mean) of the last
+// 'window' values of 'latencies_us' is at most 'max_cv'. Returns false if there
+// are fewer than 'window' values. Used to tell whether the latency has settled,
+// e.g. once CPU frequency scaling or thermal throttling reached a steady state.
+bool IsLatencyStable(const std::vector<int64_t>& latencies_us, int window,
+                     float max_cv);
+
 // Split the 'str' according to 'delim', and store each splitted element into
 // 'values'.
 template <typename T>
@@ -46,6 +46,15 @@ TEST(BenchmarkHelpersTest, SleepForSomeSeconds) {
   EXPECT_GT(end_ts - start_ts, 1900000);
 }
 
+TEST(BenchmarkHelpersTest, IsLatencyStable) {
+  // Too few samples to cover the window.
+  EXPECT_FALSE(util::IsLatencyStable({100, 100}, 3, 0.1f));
+  EXPECT_TRUE(util::IsLatencyStable({100, 100, 100}, 3, 0.1f));
+  // Only the last 'window' samples are considered.
+  EXPECT_TRUE(util::IsLatencyStable({500, 300, 100, 102, 98}, 3, 0.1f));
+  EXPECT_FALSE(util::IsLatencyStable({100, 102, 98, 300, 500}, 3, 0.1f));
+}
+
 TEST(BenchmarkHelpersTest, SplitAndParseFailed) {
   std::vector<int> results;
   const bool splitted = util::SplitAndParse("hello;world", ';', &results);
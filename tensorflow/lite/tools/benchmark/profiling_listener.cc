@@ -25,10 +25,12 @@ namespace benchmark {
 ProfilingListener::ProfilingListener(
     Interpreter* interpreter, uint32_t max_num_entries,
     const std::string& csv_file_path,
-    std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter)
+    std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter,
+    const std::string& op_latency_report_file_path)
     : run_summarizer_(summarizer_formatter),
       init_summarizer_(summarizer_formatter),
       csv_file_path_(csv_file_path),
+      op_latency_report_file_path_(op_latency_report_file_path),
       interpreter_(interpreter),
       profiler_(max_num_entries) {
   TFLITE_TOOLS_CHECK(interpreter);
@@ -80,6 +82,27 @@ void ProfilingListener::OnBenchmarkEnd(const BenchmarkResults& results) {
                 run_summarizer_.GetOutputString(),
                 output_stream == nullptr ? &TFLITE_LOG(INFO) : output_stream);
   }
+  WriteOpLatencyReport();
+}
+
+void ProfilingListener::WriteOpLatencyReport() {
+  const auto& report = run_summarizer_.GetOpLatencyReport();
+  if (op_latency_report_file_path_.empty() || !report.HasSamples()) return;
+  std::ofstream report_file(op_latency_report_file_path_);
+  if (!report_file.good()) {
+    TFLITE_LOG(ERROR) << "Failed to open the op latency report file "
+                      << op_latency_report_file_path_;
+    return;
+  }
+  const std::string json_suffix = ".json";
+  const bool as_json =
+      op_latency_report_file_path_.size() >= json_suffix.size() &&
+      op_latency_report_file_path_.compare(
+          op_latency_report_file_path_.size() - json_suffix.size(),
+          json_suffix.size(), json_suffix) == 0;
+  report_file << (as_json ? report.GetJSONString() : report.GetCSVString());
+  TFLITE_LOG(INFO) << "Wrote per-op latency percentiles to "
+                   << op_latency_report_file_path_;
 }
 
 void ProfilingListener::WriteOutput(const std::string& header,
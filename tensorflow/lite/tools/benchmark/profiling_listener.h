@@ -26,14 +26,18 @@ limitations under the License.
 namespace tflite {
 namespace benchmark {
 
-// Dumps profiling events if profiling is enabled.
+// Dumps profiling events if profiling is enabled. If
+// 'op_latency_report_file_path' is set, the per-op latency percentiles of the
+// regular runs are also written to it, as JSON if the path ends with ".json"
+// and as CSV otherwise.
 class ProfilingListener : public BenchmarkListener {
  public:
   ProfilingListener(
       Interpreter* interpreter, uint32_t max_num_entries,
       const std::string& csv_file_path = "",
       std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter =
-          std::make_shared<profiling::ProfileSummaryDefaultFormatter>());
+          std::make_shared<profiling::ProfileSummaryDefaultFormatter>(),
+      const std::string& op_latency_report_file_path = "");
 
   void OnBenchmarkStart(const BenchmarkParams& params) override;
 
@@ -47,10 +51,12 @@ class ProfilingListener : public BenchmarkListener {
   profiling::ProfileSummarizer run_summarizer_;
   profiling::ProfileSummarizer init_summarizer_;
   std::string csv_file_path_;
+  std::string op_latency_report_file_path_;
 
  private:
   void WriteOutput(const std::string& header, const string& data,
                    std::ostream* stream);
+  void WriteOpLatencyReport();
   Interpreter* interpreter_;
   profiling::BufferedProfiler profiler_;
 };
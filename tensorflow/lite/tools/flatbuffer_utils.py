@@ -29,6 +29,7 @@ import copy
 import os
 import random
 import re
+import struct
 
 import flatbuffers
 from tensorflow.lite.python import schema_py_generated as schema_fb
@@ -36,6 +37,29 @@ from tensorflow.python.platform import gfile
 
 _TFLITE_FILE_IDENTIFIER = b'TFL3'
 
+# Name and format version of the offline memory plan read by TFLite Micro's
+# MicroAllocator. See tensorflow/lite/micro/micro_allocator.cc.
+_OFFLINE_MEMORY_ALLOCATION_METADATA = 'OfflineMemoryAllocation'
+_OFFLINE_MEMORY_ALLOCATION_VERSION = 1
+_OFFLINE_MEMORY_ALLOCATION_ALIGNMENT = 16
+
+# Size in bytes of each schema_fb.TensorType, by enum value. STRING tensors
+# have no static size and can not be planned offline.
+_TENSOR_TYPE_SIZES = {
+    0: 4,  # FLOAT32
+    1: 2,  # FLOAT16
+    2: 4,  # INT32
+    3: 1,  # UINT8
+    4: 8,  # INT64
+    6: 1,  # BOOL
+    7: 2,  # INT16
+    8: 8,  # COMPLEX64
+    9: 1,  # INT8
+    10: 8,  # FLOAT64
+    11: 16,  # COMPLEX128
+    12: 8,  # UINT64
+}
+
 
 def convert_bytearray_to_object(model_bytearray):
   """Converts a tflite model from a bytearray to an object for parsing."""
@@ -159,6 +183,127 @@ def randomize_weights(model, random_seed=0):
       buffer_i_data[j] = random.randint(0, 255)
 
 
+def _tensor_lifetimes(subgraph):
+  """Returns [first_created, last_used] operator indices for each tensor.
+
+  This mirrors the lifetime rules of TFLite Micro's AllocationInfoBuilder: the
+  subgraph inputs live from the first operator and the subgraph outputs live
+  until the last one.
+  """
+  num_operators = len(subgraph.operators) if subgraph.operators else 0
+  lifetimes = [[-1, -1] for _ in subgraph.tensors]
+  for tensor_index in subgraph.inputs if subgraph.inputs is not None else []:
+    lifetimes[tensor_index][0] = 0
+  for tensor_index in subgraph.outputs if subgraph.outputs is not None else []:
+    lifetimes[tensor_index][1] = num_operators - 1
+  for i in range(num_operators):
+    operator = subgraph.operators[i]
+    for tensor_index in operator.inputs if operator.inputs is not None else []:
+      if tensor_index >= 0:
+        lifetimes[tensor_index][1] = max(lifetimes[tensor_index][1], i)
+    for tensor_index in (operator.outputs
+                         if operator.outputs is not None else []):
+      if lifetimes[tensor_index][0] == -1 or lifetimes[tensor_index][0] > i:
+        lifetimes[tensor_index][0] = i
+  for lifetime in lifetimes:
+    # Tensors only read by the graph are live from the first operator, and
+    # tensors not used at all are conservatively kept alive throughout.
+    if lifetime[0] == -1:
+      lifetime[0] = 0
+      if lifetime[1] == -1:
+        lifetime[1] = max(num_operators - 1, 0)
+  return lifetimes
+
+
+def _align_up(value, alignment):
+  return (value + alignment - 1) // alignment * alignment
+
+
+def add_offline_memory_plan(model):
+  """Computes an arena memory plan and embeds it in the model metadata.
+
+  TFLite Micro reads the plan from the 'OfflineMemoryAllocation' metadata and,
+  when every tensor that needs memory has an offset, skips the on-device
+  memory planner. Constant and variable tensors are allocated elsewhere by the
+  runtime and are marked with -1. Buffers requested by kernels at Prepare time
+  are always planned on the device, after the offline planned tensors.
+
+  Buffers are placed greedily, largest first, at the lowest 16-byte aligned
+  offset that does not overlap any already placed buffer with an overlapping
+  lifetime. Any previously embedded plan is replaced.
+
+  Args:
+    model: The model to which the memory plan is added. Only models with a
+      single subgraph are supported, as in TFLite Micro.
+
+  Raises:
+    ValueError: If the model has several subgraphs or a tensor that needs
+      memory has no static size.
+
+  Returns:
+    The number of bytes of arena needed by the plan.
+  """
+  if len(model.subgraphs) != 1:
+    raise ValueError('Only models with a single subgraph can have an offline '
+                     'memory plan.')
+  subgraph = model.subgraphs[0]
+  lifetimes = _tensor_lifetimes(subgraph)
+
+  offsets = [-1] * len(subgraph.tensors)
+  planned = []
+  for i, tensor in enumerate(subgraph.tensors):
+    buffer_data = model.buffers[tensor.buffer].data
+    has_data = buffer_data is not None and len(buffer_data) > 0
+    if has_data or tensor.isVariable:
+      continue
+    shape = tensor.shape if tensor.shape is not None else []
+    if tensor.type not in _TENSOR_TYPE_SIZES or any(d < 0 for d in shape):
+      raise ValueError('Tensor %d has no static size.' % i)
+    size = _TENSOR_TYPE_SIZES[tensor.type]
+    for dim in shape:
+      size *= dim
+    planned.append(
+        (_align_up(size, _OFFLINE_MEMORY_ALLOCATION_ALIGNMENT), i))
+
+  arena_size = 0
+  placed = []
+  for size, i in sorted(planned, key=lambda p: (-p[0], p[1])):
+    first_created, last_used = lifetimes[i]
+    # Buffers alive at the same time as this one, sorted by offset.
+    conflicts = sorted((offsets[j], other_size)
+                       for other_size, j in placed
+                       if lifetimes[j][0] <= last_used and
+                       first_created <= lifetimes[j][1])
+    offset = 0
+    for other_offset, other_size in conflicts:
+      if offset + size <= other_offset:
+        break
+      offset = max(offset, other_offset + other_size)
+    offsets[i] = offset
+    placed.append((size, i))
+    arena_size = max(arena_size, offset + size)
+
+  words = [_OFFLINE_MEMORY_ALLOCATION_VERSION, 0, len(offsets)] + offsets
+  plan_buffer = schema_fb.BufferT()
+  plan_buffer.data = list(struct.pack('<%di' % len(words), *words))
+
+  if model.metadata is None:
+    model.metadata = []
+  for metadata in model.metadata:
+    name = metadata.name
+    if isinstance(name, bytes):
+      name = name.decode('utf-8')
+    if name == _OFFLINE_MEMORY_ALLOCATION_METADATA:
+      model.buffers[metadata.buffer] = plan_buffer
+      return arena_size
+  metadata = schema_fb.MetadataT()
+  metadata.name = _OFFLINE_MEMORY_ALLOCATION_METADATA
+  metadata.buffer = len(model.buffers)
+  model.buffers.append(plan_buffer)
+  model.metadata.append(metadata)
+  return arena_size
+
+
 def xxd_output_to_bytes(input_cc_file):
   """Converts xxd output C++ source file to bytes (immutable).
 
@@ -19,6 +19,7 @@ from __future__ import print_function
 
 import copy
 import os
+import struct
 import subprocess
 
 from tensorflow.lite.tools import flatbuffer_utils
@@ -163,6 +164,43 @@ class RandomizeWeightsTest(test_util.TensorFlowTestCase):
       self.assertNotEqual(initial_buffer.data[j], final_buffer.data[j])
 
 
+class AddOfflineMemoryPlanTest(test_util.TensorFlowTestCase):
+
+  def _get_offline_plan(self, model):
+    for metadata in model.metadata:
+      if metadata.name == b'OfflineMemoryAllocation':
+        data = bytes(bytearray(model.buffers[metadata.buffer].data))
+        return list(struct.unpack('<%di' % (len(data) // 4), data))
+    return None
+
+  def testAddOfflineMemoryPlan(self):
+    # 1. SETUP
+    # Define the initial model
+    initial_model = test_utils.build_mock_model()
+    tmp_dir = self.get_temp_dir()
+    model_filename = os.path.join(tmp_dir, 'model.tflite')
+
+    # 2. INVOKE
+    # Invoke the add_offline_memory_plan function twice, the second plan
+    # replaces the first one.
+    arena_size = flatbuffer_utils.add_offline_memory_plan(initial_model)
+    num_buffers = len(initial_model.buffers)
+    flatbuffer_utils.add_offline_memory_plan(initial_model)
+    self.assertLen(initial_model.buffers, num_buffers)
+    flatbuffer_utils.write_model(initial_model, model_filename)
+    final_model = flatbuffer_utils.read_model(model_filename)
+
+    # 3. VALIDATE
+    # The input and output tensors (40 bytes each, aligned to 48) are both
+    # used by the only operator, so they can not share memory. The constant
+    # tensor is not planned.
+    self.assertEqual(arena_size, 96)
+    self.assertEqual(
+        self._get_offline_plan(final_model),
+        [1, 0, 3,  # header
+         0, -1, 48])
+
+
 class XxdOutputToBytesTest(test_util.TensorFlowTestCase):
 
   def testXxdOutputToBytes(self):
@@ -45,6 +45,7 @@ from tensorflow.python.ops import nn
 from tensorflow.python.ops import parsing_ops
 from tensorflow.python.ops import script_ops
 from tensorflow.python.ops import special_math_ops
+from tensorflow.python.ops import string_ops
 from tensorflow.python.platform import test
 
 
@@ -101,15 +102,18 @@ def _unary_real_test_combinations():
       ("Elu", nn.elu),
       ("Erf", math_ops.erf),
       ("Erfc", math_ops.erfc),
+      ("Erfinv", math_ops.erfinv),
       ("Exp", math_ops.exp),
       ("Expm1", math_ops.expm1),
       ("Floor", math_ops.floor),
       ("Inv", math_ops.inv),
       ("IsFinite", math_ops.is_finite),
       ("IsInf", math_ops.is_inf),
+      ("LeakyRelu", nn.leaky_relu),
       ("Lgamma", math_ops.lgamma),
       ("Log", math_ops.log),
       ("Log1p", math_ops.log1p),
+      ("Ndtri", math_ops.ndtri),
       ("Neg", math_ops.negative),
       ("Reciprocal", math_ops.reciprocal),
       ("Relu", nn.relu),
@@ -132,6 +136,28 @@ def _unary_real_test_combinations():
   return _generate_test_combinations(cases)
 
 
+def _unary_string_test_combinations():
+  cases = [
+      ("AsString", lambda x: string_ops.as_string(string_ops.string_length(x))),
+      ("DecodeBase64",
+       lambda x: string_ops.decode_base64(string_ops.encode_base64(x))),
+      ("EncodeBase64", string_ops.encode_base64),
+      ("StaticRegexFullMatch",
+       lambda x: string_ops.regex_full_match(x, "[0-9.]+")),
+      ("StaticRegexReplace", lambda x: string_ops.regex_replace(x, "1", "9")),
+      ("StringLength", string_ops.string_length),
+      ("StringLower", string_ops.string_lower),
+      ("StringStrip", string_ops.string_strip),
+      ("StringToHashBucketFast",
+       lambda x: string_ops.string_to_hash_bucket_fast(x, 10)),
+      ("StringToHashBucketStrong",
+       lambda x: string_ops.string_to_hash_bucket_strong(x, 10, [1, 2])),
+      ("StringToNumber", string_ops.string_to_number),
+      ("StringUpper", string_ops.string_upper),
+  ]
+  return _generate_test_combinations(cases)
+
+
 def _binary_bitwise_test_combinations():
   cases = [("BitwiseAnd", bitwise_ops.bitwise_and),
            ("BitwiseOr", bitwise_ops.bitwise_or),
@@ -176,6 +202,7 @@ def _binary_real_test_combinations():
       ("Minimum", math_ops.minimum),
       ("Mod", math_ops.mod),
       ("Mul", math_ops.multiply),
+      ("MulNoNan", math_ops.mul_no_nan),
       ("NotEqual", math_ops.not_equal),
       ("Polygamma", safe_polygamma),
       ("Pow", math_ops.pow),
@@ -183,6 +210,9 @@ def _binary_real_test_combinations():
       ("SquareDifference", math_ops.squared_difference),
       ("Sub", math_ops.subtract),
       ("TruncateMod", math_ops.truncate_mod),
+      ("Xdivy", math_ops.xdivy),
+      ("Xlog1py", math_ops.xlog1py),
+      ("Xlogy", math_ops.xlogy),
       ("Zeta", safe_zeta),
   ]
   return _generate_test_combinations(cases)
@@ -363,6 +393,15 @@ class MapVectorizationTest(test_base.DatasetTestBase, parameterized.TestCase):
     dataset_factory = lambda: dataset_ops.Dataset.from_tensor_slices(x)
     self._testOptimization(map_fn, dataset_factory, num_parallel_calls)
 
+  @combinations.generate(
+      combinations.times(test_base.default_test_combinations(),
+                         _unary_string_test_combinations(),
+                         combinations.combine(num_parallel_calls=[None, 12])))
+  def testUnaryStringOperations(self, map_fn, num_parallel_calls):
+    x = np.array([["1", "23", "4.5"], ["-6", "7e1", "0.25"]])
+    dataset_factory = lambda: dataset_ops.Dataset.from_tensor_slices(x)
+    self._testOptimization(map_fn, dataset_factory, num_parallel_calls)
+
   @combinations.generate(
       combinations.times(test_base.default_test_combinations(),
                          _binary_bitwise_test_combinations(),
@@ -847,6 +847,43 @@ class LegacySnapshotDatasetTest(
         snapshot.legacy_snapshot(tmpdir, compression=compression))
     self.assertDatasetProduces(dataset2, expected, assert_items_equal=True)
 
+  @combinations.generate(
+      combinations.times(
+          test_base.default_test_combinations(),
+          combinations.combine(compression=[
+              snapshot.COMPRESSION_NONE, snapshot.COMPRESSION_GZIP,
+              snapshot.COMPRESSION_SNAPPY
+          ])))
+  def testReadSnapshotBackAfterWriteWithCompressionThreads(self, compression):
+    self.setUpTFRecord()
+    filenames = self.test_filenames
+
+    expected = [
+        b"Record %d of file %d" % (r, f)  # pylint:disable=g-complex-comprehension
+        for f in range(0, 10)
+        for r in range(0, 10)
+    ]
+
+    tmpdir = self.snapshot_dir
+    dataset = core_readers._TFRecordDataset(filenames)
+    dataset = dataset.apply(
+        snapshot.legacy_snapshot(
+            tmpdir,
+            compression=compression,
+            num_writer_threads=2,
+            writer_buffer_size=4,
+            num_compression_threads=4))
+    self.assertDatasetProduces(dataset, expected)
+
+    # remove the original files and try to read the data back only from
+    # snapshot
+    self.removeTFRecords()
+
+    dataset2 = core_readers._TFRecordDataset(filenames)
+    dataset2 = dataset2.apply(
+        snapshot.legacy_snapshot(tmpdir, compression=compression))
+    self.assertDatasetProduces(dataset2, expected, assert_items_equal=True)
+
   @combinations.generate(test_base.default_test_combinations())
   def testSameFingerprintWithDifferentInitializationOrder(self):
     tmpdir = self.snapshot_dir
@@ -30,6 +30,7 @@ class _AutotuneAlgorithm(enum.Enum):
   """Controls what algorithm is used in the autotune implementation."""
   HILL_CLIMB = 0
   GRADIENT_DESCENT = 1
+  LEARNED = 2
 
 
 @tf_export("data.experimental.MapVectorizationOptions")
@@ -125,6 +126,15 @@ class OptimizationOptions(options.OptionsBase):
       "budget to use. Values greater than the available RAM in bytes may "
       "result in OOM. If None, defaults to half of the available RAM in bytes.")
 
+  decode_crop_and_resize_fusion = options.create_option(
+      name="decode_crop_and_resize_fusion",
+      ty=bool,
+      docstring=
+      "Whether to fuse `decode_and_crop_jpeg` followed by a bilinear resize "
+      "inside map transformations into a single op that decodes the JPEG at "
+      "a reduced DCT scale. The fused op does not produce bit-identical "
+      "results. If None, defaults to False.")
+
   filter_fusion = options.create_option(
       name="filter_fusion",
       ty=bool,
@@ -259,6 +269,7 @@ class OptimizationOptions(options.OptionsBase):
       result = MapVectorizationOptions()._graph_rewrites()  # pylint: disable=protected-access
 
     all_optimizations = [
+        "decode_crop_and_resize_fusion",
         "filter_fusion",
         "filter_with_random_uniform_fusion",
         "hoist_random_uniform",
@@ -51,7 +51,8 @@ class _LegacySnapshotDataset(dataset_ops.UnaryUnchangedStructureDataset):
                shuffle_on_read=None,
                shuffle_seed=None,
                mode=None,
-               snapshot_name=None):
+               snapshot_name=None,
+               num_compression_threads=None):
 
     self._compression = compression if compression is not None else ""
     self._reader_path_prefix = (
@@ -75,6 +76,8 @@ class _LegacySnapshotDataset(dataset_ops.UnaryUnchangedStructureDataset):
         shuffle_on_read if shuffle_on_read is not None else False)
     self._mode = (mode if mode is not None else "auto")
     self._snapshot_name = (snapshot_name if snapshot_name is not None else "")
+    self._num_compression_threads = (
+        num_compression_threads if num_compression_threads is not None else -1)
 
     self._seed, self._seed2 = random_seed.get_seed(shuffle_seed)
 
@@ -98,6 +101,7 @@ class _LegacySnapshotDataset(dataset_ops.UnaryUnchangedStructureDataset):
         seed2=self._seed2,
         mode=self._mode,
         snapshot_name=self._snapshot_name,
+        num_compression_threads=self._num_compression_threads,
         **self._flat_structure)
 
     super(_LegacySnapshotDataset, self).__init__(input_dataset, variant_tensor)
@@ -118,7 +122,8 @@ def legacy_snapshot(path,
                     shuffle_on_read=None,
                     shuffle_seed=None,
                     mode=None,
-                    snapshot_name=None):
+                    snapshot_name=None,
+                    num_compression_threads=None):
   """Writes to/reads from a snapshot of a dataset.
 
   This function attempts to determine whether a valid snapshot exists at the
@@ -167,6 +172,11 @@ def legacy_snapshot(path,
     snapshot_name: If set, use the supplied string as a named snapshot name
       instead of introspecting the data pipeline and automatically generating a
       unique identifier for the snapshot.
+    num_compression_threads: Number of threads that serialize and compress
+      elements ahead of the `num_writer_threads` writer threads, so that
+      compression can use more threads than there are files being written.
+      Defaults to 0, where each writer thread compresses the elements it
+      writes. GZIP compression is applied by the writer threads either way.
 
   Returns:
     A `Dataset` transformation function, which can be passed to
@@ -189,7 +199,8 @@ def legacy_snapshot(path,
         shuffle_on_read=shuffle_on_read,
         shuffle_seed=shuffle_seed,
         mode=mode,
-        snapshot_name=snapshot_name)
+        snapshot_name=snapshot_name,
+        num_compression_threads=num_compression_threads)
 
   return _apply_fn
 
@@ -3774,8 +3774,29 @@ class RangeDataset(DatasetSource):
 class CacheDataset(UnaryUnchangedStructureDataset):
   """A `Dataset` that caches elements of its input."""
 
-  def __init__(self, input_dataset, filename):
-    """See `Dataset.cache()` for details."""
+  def __init__(self,
+               input_dataset,
+               filename,
+               memory_budget=0,
+               spill_directory="",
+               shared=False):
+    """See `Dataset.cache()` for details.
+
+    Args:
+      input_dataset: The input dataset.
+      filename: A `tf.string` scalar `tf.Tensor`, the name of a directory on
+        the filesystem to use for caching elements. If it is empty, elements
+        are cached in memory.
+      memory_budget: (Optional.) The maximum number of bytes of cached
+        elements to keep in memory. Once exceeded, the least recently used
+        elements are spilled to a file in `spill_directory`. 0 means no
+        limit.
+      spill_directory: (Optional.) The directory for the spill file. Defaults
+        to a local temporary directory.
+      shared: (Optional.) Whether all iterators over datasets with the same
+        input graph share a single in-memory cache, so that its elements are
+        only produced and stored once per process.
+    """
     self._input_dataset = input_dataset
     self._filename = ops.convert_to_tensor(
         filename, dtype=dtypes.string, name="filename")
@@ -3784,8 +3805,14 @@ class CacheDataset(UnaryUnchangedStructureDataset):
           input_dataset._variant_tensor,  # pylint: disable=protected-access
           filename=self._filename,
           cache=gen_dataset_ops.dummy_memory_cache(),
+          memory_budget=memory_budget,
+          spill_directory=spill_directory,
+          shared=shared,
           **self._flat_structure)
     else:
+      if memory_budget or spill_directory or shared:
+        raise ValueError("`memory_budget`, `spill_directory` and `shared` are "
+                         "only supported in TF2 eager mode or in functions.")
       variant_tensor = gen_dataset_ops.cache_dataset(
           input_dataset._variant_tensor,  # pylint: disable=protected-access
           filename=self._filename,
@@ -3800,7 +3827,8 @@ class ShuffleDataset(UnaryUnchangedStructureDataset):
                input_dataset,
                buffer_size,
                seed=None,
-               reshuffle_each_iteration=None):
+               reshuffle_each_iteration=None,
+               fill_parallelism=0):
     """Randomly shuffles the elements of this dataset.
 
     Args:
@@ -3813,6 +3841,10 @@ class ShuffleDataset(UnaryUnchangedStructureDataset):
       reshuffle_each_iteration: (Optional.) A boolean, which if true indicates
         that the dataset should be pseudorandomly reshuffled each time it is
         iterated over. (Defaults to `True`.)
+      fill_parallelism: (Optional.) The number of concurrent input fetches
+        used to fill the shuffle buffer. Values greater than 1 speed up
+        filling large buffers at the cost of a nondeterministic shuffle
+        order. Only supported in TF2 eager mode or in functions.
 
     Returns:
       A `Dataset`.
@@ -3837,8 +3869,12 @@ class ShuffleDataset(UnaryUnchangedStructureDataset):
           seed2=self._seed2,
           seed_generator=gen_dataset_ops.dummy_seed_generator(),
           reshuffle_each_iteration=self._reshuffle_each_iteration,
+          fill_parallelism=fill_parallelism,
           **self._flat_structure)
     else:
+      if fill_parallelism:
+        raise ValueError("`fill_parallelism` is only supported in TF2 eager "
+                         "mode or in functions.")
       variant_tensor = gen_dataset_ops.shuffle_dataset(
           input_dataset._variant_tensor,  # pylint: disable=protected-access
           buffer_size=self._buffer_size,
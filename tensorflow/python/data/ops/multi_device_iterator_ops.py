@@ -223,6 +223,8 @@ class MultiDeviceIterator(object):
       dataset: The input dataset to be iterated over.
       devices: The list of devices to fetch data to.
       max_buffer_size: Maximum size of the host side per device buffer to keep.
+        If set to `tf.data.AUTOTUNE`, the buffer size is tuned dynamically
+        based on how often devices find their buffer empty.
       prefetch_buffer_size: if > 0, then we setup a buffer on each device to
         prefetch into.
       source_device: The host device to place the `dataset` on.  In order to
@@ -240,7 +242,8 @@ class MultiDeviceIterator(object):
     self._max_buffer_size = max_buffer_size
     self._prefetch_buffer_size = prefetch_buffer_size
 
-    if self._prefetch_buffer_size > self._max_buffer_size:
+    if (self._max_buffer_size != dataset_ops.AUTOTUNE and
+        self._prefetch_buffer_size > self._max_buffer_size):
       self._max_buffer_size = self._prefetch_buffer_size
 
     # Create the MultiDeviceIterator.
@@ -481,6 +484,8 @@ class OwnedMultiDeviceIterator(composite_tensor.CompositeTensor):
       dataset: The input dataset to be iterated over.
       devices: The list of devices to fetch data to.
       max_buffer_size: Maximum size of the host side per device buffer to keep.
+        If set to `tf.data.AUTOTUNE`, the buffer size is tuned dynamically
+        based on how often devices find their buffer empty.
       prefetch_buffer_size: if > 0, then we setup a buffer on each device to
         prefetch into.
       source_device: The host device to place the `dataset` on.  In order to
@@ -527,7 +532,8 @@ class OwnedMultiDeviceIterator(composite_tensor.CompositeTensor):
       self._source_device = source_device
       source_device_tensor = ops.convert_to_tensor(self._source_device)
 
-      if prefetch_buffer_size > max_buffer_size:
+      if (max_buffer_size != dataset_ops.AUTOTUNE and
+          prefetch_buffer_size > max_buffer_size):
         max_buffer_size = prefetch_buffer_size
 
       # Create the MultiDeviceIterator.
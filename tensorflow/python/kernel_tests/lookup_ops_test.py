@@ -3677,6 +3677,108 @@ class MutableHashTableOpTest(test.TestCase):
     self.assertTrue(inferred_shapes[1].is_compatible_with(actual_shapes[1]))
 
 
+class HashEmbeddingTest(test.TestCase):
+
+  @test_util.run_in_graph_and_eager_modes
+  def testLookupAdmitsAfterThreshold(self):
+    table = lookup_ops.HashEmbedding(
+        dtypes.int64,
+        embedding_dim=2,
+        default_value=[1.0, 2.0],
+        admission_threshold=2)
+    ids = constant_op.constant([[3, 4], [3, 5]], dtypes.int64)
+    output = table.lookup(ids)
+    self.assertAllEqual([2, 2, 2], output.get_shape())
+    self.assertAllEqual([[[1, 2], [1, 2]], [[1, 2], [1, 2]]],
+                        self.evaluate(output))
+    # Id 3 was looked up twice and was admitted.
+    self.assertAllEqual(1, self.evaluate(table.size()))
+
+    # Lookups outside of training do not admit ids.
+    self.evaluate(table.lookup([4, 4, 4], training=False))
+    self.assertAllEqual(1, self.evaluate(table.size()))
+    self.evaluate(table.lookup([4]))
+    self.assertAllEqual(2, self.evaluate(table.size()))
+
+  @test_util.run_in_graph_and_eager_modes
+  def testEvict(self):
+    table = lookup_ops.HashEmbedding(dtypes.int64, embedding_dim=1)
+    self.evaluate(table.lookup([1, 2, 2, 3, 3, 3]))
+    self.assertAllEqual(3, self.evaluate(table.size()))
+    self.assertAllEqual(1, self.evaluate(table.evict(2)))
+    self.assertAllEqual(2, self.evaluate(table.size()))
+    # Frequencies restart after an eviction.
+    self.evaluate(table.lookup([3]))
+    self.assertAllEqual(1, self.evaluate(table.evict(1)))
+    keys, _, _, frequencies = self.evaluate(table.export())
+    self.assertAllEqual([3], keys)
+    self.assertAllEqual([0], frequencies)
+
+  @test_util.run_in_graph_and_eager_modes
+  def testApplyAdagrad(self):
+    table = lookup_ops.HashEmbedding(
+        dtypes.int64, embedding_dim=2, slot_initial_values=[0.1])
+    self.evaluate(table.lookup([5]))
+    self.evaluate(
+        table.apply_adagrad(0.1, [[1.0, 2.0], [3.0, 4.0]], [5, 6]))
+    self.assertAllClose([[-0.0953462, -0.0987730]],
+                        self.evaluate(table.lookup([5], training=False)))
+    _, _, slots, _ = self.evaluate(table.export())
+    self.assertAllClose([[[1.1, 4.1]]], slots)
+    # The gradient of id 6, which has no row, is dropped.
+    self.assertAllEqual(1, self.evaluate(table.size()))
+
+  @test_util.run_in_graph_and_eager_modes
+  def testApplyFtrl(self):
+    table = lookup_ops.HashEmbedding(
+        dtypes.int64, embedding_dim=1, slot_initial_values=[0.1, 0.0])
+    self.evaluate(table.lookup([7]))
+    self.evaluate(
+        table.apply_ftrl(
+            3.0, [[-10.0]], [7], l1_regularization_strength=0.001))
+    # The same update as ApplyFtrl from zero on accum 0.1 and linear 0.
+    accum = 0.1 + 100.0
+    linear = -10.0
+    expected = (-0.001 - linear) / (np.sqrt(accum) / 3.0)
+    self.assertAllClose([[expected]],
+                        self.evaluate(table.lookup([7], training=False)))
+
+  def testApplyWithoutSlotsFails(self):
+    table = lookup_ops.HashEmbedding(dtypes.int64, embedding_dim=1)
+    with self.assertRaisesOpError("slots"):
+      self.evaluate(table.apply_adagrad(0.1, [[1.0]], [1]))
+
+  @test_util.run_in_graph_and_eager_modes
+  def testObjectSaveRestore(self):
+    save_dir = os.path.join(self.get_temp_dir(), "save_restore")
+    save_prefix = os.path.join(tempfile.mkdtemp(prefix=save_dir), "hash")
+
+    table = lookup_ops.HashEmbedding(
+        dtypes.int64, embedding_dim=2, slot_initial_values=[0.1], name="t1")
+    self.evaluate(table.lookup([1, 2, 2]))
+    self.evaluate(table.apply_adagrad(0.1, [[1.0, 1.0]], [2]))
+    expected = self.evaluate(table.lookup([1, 2], training=False))
+
+    checkpoint = trackable.Checkpoint(table=table)
+    save_path = checkpoint.save(save_prefix)
+    del table, checkpoint
+
+    table = lookup_ops.HashEmbedding(
+        dtypes.int64, embedding_dim=2, slot_initial_values=[0.1], name="t1")
+    self.evaluate(table.lookup([3]))
+    checkpoint = trackable.Checkpoint(table=table)
+    checkpoint.restore(save_path).run_restore_ops()
+
+    self.assertAllEqual(2, self.evaluate(table.size()))
+    self.assertAllClose(expected,
+                        self.evaluate(table.lookup([1, 2], training=False)))
+    keys, _, slots, frequencies = self.evaluate(table.export())
+    order = np.argsort(keys)
+    self.assertAllEqual([1, 2], keys[order])
+    self.assertAllEqual([1, 2], frequencies[order])
+    self.assertAllClose([[[0.1, 0.1]], [[1.1, 1.1]]], slots[order])
+
+
 class MutableHashTableBenchmark(test.Benchmark):
 
   def _create_table(self):
@@ -200,6 +200,30 @@ class SparseTensorDenseMatMulTest(test.TestCase):
         sparse_ops.sparse_tensor_dense_matmul(
             sparse_t, dense_t, adjoint_a=True))
 
+  @test_util.run_gpu_only
+  def testRepeatedIndicesOnGPU(self):
+    # Indices seen again are multiplied from a cached CSR copy of the sparse
+    # tensor, which must not depend on the order of the indices.
+    np.random.seed(127)  # Repeatable results
+    x = np.random.rand(50, 40).astype(np.float32)
+    x[x < 0.8] = 0  # Make it sparse
+    y = np.random.randn(40, 300).astype(np.float32)
+    for adjoint_a in [False, True]:
+      for adjoint_b in [False, True]:
+        a = x.T if adjoint_a else x
+        b = y.T if adjoint_b else y
+        indices = np.vstack(np.where(a)).astype(np.int64).T
+        indices = indices[np.random.permutation(len(indices))]
+        sparse_t = sparse_tensor.SparseTensor(indices, a[tuple(indices.T)],
+                                              a.shape)
+        for _ in range(3):
+          self.assertAllClose(
+              np.matmul(x, y),
+              sparse_ops.sparse_tensor_dense_matmul(
+                  sparse_t, b, adjoint_a=adjoint_a, adjoint_b=adjoint_b),
+              rtol=1e-4,
+              atol=1e-4)
+
   # Tests setting one dimension to be a high value.
   def _testLarge(self, np_dtype):
     r1 = np.random.randint(6000, 20000)
@@ -155,6 +155,18 @@ class TopKTest(test.TestCase):
     self._testMediumTopK(np.float32)
     self._testMediumTopK(np.float16)
 
+  def testLongRowTopK(self):
+    # Few rows this long are split into blocks that are selected separately.
+    np.random.seed(127)  # Repeatable results
+    for b in [1, 3]:
+      n = 300000
+      inputs = np.random.randint(0, 1000, size=(b, n)).astype(np.int32)
+      for k in [1, 20, 99, 300]:
+        indices = np.argsort(-inputs, axis=1, kind="stable")[:, :k]
+        values = -np.sort(-inputs, axis=1)[:, :k]
+        self._validateTopK(inputs, k, values, indices)
+        self._validateTopK(inputs, k, values, indices, sorted=False)
+
   def testStableSort(self):
     b = 5
     n = 500
@@ -15,11 +15,13 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "pybind11/pybind11.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/io/record_index.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
@@ -144,7 +146,12 @@ class PyRecordWriter {
         tensorflow::Env::Default()->NewWritableFile(filename, &file));
     auto writer =
         absl::make_unique<tensorflow::io::RecordWriter>(file.get(), options);
-    *out = new PyRecordWriter(std::move(file), std::move(writer));
+    // RecordWriter only keeps offsets of uncompressed records.
+    const bool build_index =
+        options.build_index &&
+        options.compression_type == tensorflow::io::RecordWriterOptions::NONE;
+    *out = new PyRecordWriter(filename, build_index, std::move(file),
+                              std::move(writer));
     return tensorflow::Status::OK();
   }
 
@@ -175,8 +182,12 @@ class PyRecordWriter {
   bool IsClosed() const { return file_ == nullptr && writer_ == nullptr; }
 
   tensorflow::Status Close() {
+    std::vector<tensorflow::uint64> record_offsets;
+    tensorflow::uint64 file_size = 0;
     if (writer_ != nullptr) {
       auto status = writer_->Close();
+      record_offsets = writer_->record_offsets();
+      file_size = writer_->bytes_written();
       writer_ = nullptr;
       if (!status.ok()) return status;
     }
@@ -184,15 +195,27 @@ class PyRecordWriter {
       auto status = file_->Close();
       file_ = nullptr;
       if (!status.ok()) return status;
+      if (build_index_) {
+        // The index is only written for a complete file.
+        return tensorflow::io::WriteRecordIndex(tensorflow::Env::Default(),
+                                                filename_, record_offsets,
+                                                file_size);
+      }
     }
     return tensorflow::Status::OK();
   }
 
  private:
-  PyRecordWriter(std::unique_ptr<tensorflow::WritableFile> file,
+  PyRecordWriter(const std::string& filename, bool build_index,
+                 std::unique_ptr<tensorflow::WritableFile> file,
                  std::unique_ptr<tensorflow::io::RecordWriter> writer)
-      : file_(std::move(file)), writer_(std::move(writer)) {}
+      : filename_(filename),
+        build_index_(build_index),
+        file_(std::move(file)),
+        writer_(std::move(writer)) {}
 
+  const std::string filename_;
+  const bool build_index_;
   std::unique_ptr<tensorflow::WritableFile> file_;
   std::unique_ptr<tensorflow::io::RecordWriter> writer_;
 
@@ -285,7 +308,10 @@ PYBIND11_MODULE(_pywrap_record_io, m) {
   py::class_<RecordWriterOptions>(m, "RecordWriterOptions")
       .def(py::init(&RecordWriterOptions::CreateRecordWriterOptions))
       .def_readonly("compression_type", &RecordWriterOptions::compression_type)
-      .def_readonly("zlib_options", &RecordWriterOptions::zlib_options);
+      .def_readonly("zlib_options", &RecordWriterOptions::zlib_options)
+      .def_readwrite("compression_threads",
+                     &RecordWriterOptions::compression_threads)
+      .def_readwrite("build_index", &RecordWriterOptions::build_index);
 
   using tensorflow::MaybeRaiseRegisteredFromStatus;
 
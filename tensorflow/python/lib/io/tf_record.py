@@ -57,7 +57,9 @@ class TFRecordOptions(object):
                compression_level=None,
                compression_method=None,
                mem_level=None,
-               compression_strategy=None):
+               compression_strategy=None,
+               compression_threads=None,
+               build_index=None):
     # pylint: disable=line-too-long
     """Creates a `TFRecordOptions` instance.
 
@@ -77,6 +79,13 @@ class TFRecordOptions(object):
       compression_method: compression method or `None`.
       mem_level: 1 to 9, or `None`.
       compression_strategy: strategy or `None`. Default: Z_DEFAULT_STRATEGY.
+      compression_threads: int or `None`. If greater than 1, the writer
+        compresses chunks of `input_buffer_size` bytes on this many threads.
+        The output is still a single zlib or gzip stream. Default: 1.
+      build_index: bool or `None`. If `True`, closing the writer of an
+        uncompressed file also writes a record index to "<path>.index", which
+        `tf.data.TFRecordDataset` uses to split the file for the tf.data
+        service. Default: `False`.
 
     Returns:
       A `TFRecordOptions` object.
@@ -97,6 +106,8 @@ class TFRecordOptions(object):
     self.compression_method = compression_method
     self.mem_level = mem_level
     self.compression_strategy = compression_strategy
+    self.compression_threads = compression_threads
+    self.build_index = build_index
 
   @classmethod
   def get_compression_type_string(cls, options):
@@ -146,6 +157,10 @@ class TFRecordOptions(object):
       options.zlib_options.mem_level = self.mem_level
     if self.compression_strategy is not None:
       options.zlib_options.compression_strategy = self.compression_strategy
+    if self.compression_threads is not None:
+      options.compression_threads = self.compression_threads
+    if self.build_index is not None:
+      options.build_index = self.build_index
     return options
 
 
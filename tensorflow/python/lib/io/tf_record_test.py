@@ -218,6 +218,15 @@ class TFRecordWriterTest(TFCompressionTestCase):
     ]
     self._AssertFilesEqual(uncompressed_files, files, True)
 
+  def testBuildIndex(self):
+    """Verify that a record index is written next to the file."""
+    records = [self._Record(0, i) for i in range(self._num_records)]
+    options = tf_record.TFRecordOptions(build_index=True)
+    fn = self._WriteRecordsToFile(records, "indexed.tfrecord", options)
+    # A header of three uint64, an offset per record and a crc.
+    self.assertEqual(
+        os.path.getsize(fn + ".index"), 8 * (3 + self._num_records) + 4)
+
   def testNoCompressionType(self):
     """test No Compression Type"""
     self.assertEqual(
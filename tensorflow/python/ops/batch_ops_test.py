@@ -351,6 +351,39 @@ class BatchOpsTest(test.TestCase):
       self.assertEqual(thread_results[0], [2])
       self.assertEqual(main_results[0], [3])
 
+  def testBatchFunctionOpWithLengthBuckets(self):
+    """Tests that batch_function pads inputs to their length bucket."""
+    if context.executing_eagerly():
+      return
+    with self.cached_session(use_gpu=True) as sess:
+
+      @function.Defun(dtypes.int32)
+      def computation(in_t):
+        return in_t + 1
+
+      inp = array_ops.placeholder(dtype=dtypes.int32, shape=[1, None])
+      result = gen_batch_ops.batch_function(
+          [inp],
+          num_batch_threads=1,
+          max_batch_size=10,
+          batch_timeout_micros=100000,
+          Tout=[dtypes.int32],
+          f=computation,
+          captured_tensors=computation.captured_inputs,
+          length_bucket_boundaries=[4, 8])
+      thread_results = []
+
+      def worker():
+        thread_results.extend(
+            sess.run([result], feed_dict={inp: [[1, 2]]}))
+
+      worker_thread = threading.Thread(target=worker)
+      worker_thread.start()
+      main_results = sess.run([result], feed_dict={inp: [[1, 2, 3, 4, 5]]})
+      worker_thread.join()
+      self.assertAllEqual(thread_results[0], [[2, 3, 1, 1]])
+      self.assertAllEqual(main_results[0], [[2, 3, 4, 5, 6, 1, 1, 1]])
+
   def testBatchFunctionOpWithCapturedInput(self):
     """Tests that batch_function op works with captured input."""
     if context.executing_eagerly():
@@ -28,7 +28,8 @@ def all_reduce(t,
                final_op='Id',
                subdiv_offsets=(0,),
                communication_hint='auto',
-               timeout=0):
+               timeout=0,
+               wire_compression='none'):
   """Reduces tensors collectively, across devices.
 
   Args:
@@ -45,11 +46,17 @@ def all_reduce(t,
       independent subdivision should begin.  Use [0] if no subdivision should
       be done.
     communication_hint: preferred collective communication.  The implementation
-      may fall back to another mechanism.  Options include `auto`, `ring`, and
-      `nccl`.
+      may fall back to another mechanism.  Options include `auto`, `ring`,
+      `hierarchical_ring`, and `nccl`.  `hierarchical_ring` reduces within
+      each task before reducing across tasks, and requires all tasks to have
+      the same number of devices.  With `auto` it is chosen for reductions of
+      at least 1 MiB over such tasks.
     timeout: a float. If set to a non zero, set a completion timeout to detect
       staleness.  If the timer goes off, a DeadlineExceededError is raised.  The
       timeout value in seconds. This feature is experimental.
+    wire_compression: one of `none`, `fp16` or `bf16`.  If not `none`, float
+      chunks are sent between devices in that precision and accumulated in
+      float.  Only supported by `ring` on CPU.  This feature is experimental.
 
   Returns:
     An Op implementing the distributed reduction.
@@ -68,7 +75,8 @@ def all_reduce(t,
       final_op=final_op,
       subdiv_offsets=subdiv_offsets,
       communication_hint=communication_hint.lower(),
-      timeout_seconds=timeout)
+      timeout_seconds=timeout,
+      wire_compression=wire_compression)
 
 
 def all_reduce_v2(t,
@@ -79,7 +87,8 @@ def all_reduce_v2(t,
                   final_op='Id',
                   communication_hint='auto',
                   timeout=0,
-                  ordering_token=None):
+                  ordering_token=None,
+                  wire_compression='none'):
   """Reduces tensors collectively, across devices.
 
   Args:
@@ -102,6 +111,9 @@ def all_reduce_v2(t,
     ordering_token: an optional resource tensor to pass to the op as inputs.
       They aren't used by the kernel but allow AutoControlDependency to order
       the collectives with control dependencies.
+    wire_compression: one of `none`, `fp16` or `bf16`.  If not `none`, float
+      chunks are sent between devices in that precision and accumulated in
+      float.  Only supported by `ring` on CPU.  This feature is experimental.
 
   Returns:
     An Op implementing the distributed reduction.
@@ -117,7 +129,8 @@ def all_reduce_v2(t,
       final_op=final_op,
       communication_hint=communication_hint.lower(),
       timeout_seconds=timeout,
-      ordering_token=ordering_token or [])
+      ordering_token=ordering_token or [],
+      wire_compression=wire_compression)
 
 
 def all_gather(t,
@@ -4247,6 +4247,61 @@ class JpegTest(test_util.TensorFlowTestCase):
           result = image_ops.decode_and_crop_jpeg(jpeg0, crop_window)
           self.evaluate(result)
 
+  def testDecodeCropAndResizeJpeg(self):
+    with self.cached_session():
+      base = "tensorflow/core/lib/jpeg/testdata"
+      jpeg0 = io_ops.read_file(os.path.join(base, "jpeg_merge_test1.jpg"))
+
+      crop_window = [16, 8, 224, 112]
+      # The first size is decoded at full scale and must match the unfused
+      # ops; the others are decoded at 1/2, 1/4 and 1/8 scale.
+      for size, max_error in [([150, 90], 0.), ([100, 50], 4.),
+                              ([50, 25], 8.), ([28, 14], 12.)]:
+        for half_pixel_centers in [False, True]:
+          image1 = gen_image_ops.resize_bilinear(
+              array_ops.expand_dims(
+                  image_ops.decode_and_crop_jpeg(jpeg0, crop_window), 0),
+              size,
+              half_pixel_centers=half_pixel_centers)[0]
+          image2 = gen_image_ops.decode_crop_and_resize_jpeg(
+              jpeg0, crop_window, size, half_pixel_centers=half_pixel_centers)
+          self.assertAllEqual(image1.get_shape().as_list(),
+                              image2.get_shape().as_list())
+          image1, image2 = self.evaluate([image1, image2])
+          if max_error == 0.:
+            self.assertAllClose(image1, image2, atol=1e-3)
+          else:
+            self.assertLess(np.abs(image1 - image2).mean(), max_error)
+
+  def testDecodeAndResizeJpegBatch(self):
+    with self.cached_session(use_gpu=True):
+      base = "tensorflow/core/lib/jpeg/testdata"
+      # Images of different sizes are resized to the same output size.
+      jpegs = array_ops.stack([
+          io_ops.read_file(os.path.join(base, "jpeg_merge_test1.jpg")),
+          image_ops.encode_jpeg(constant_op.constant(simple_color_ramp()))
+      ])
+      size = [40, 30]
+      for channels in [1, 3]:
+        for half_pixel_centers in [False, True]:
+          images1 = array_ops.stack([
+              gen_image_ops.resize_bilinear(
+                  array_ops.expand_dims(
+                      image_ops.decode_jpeg(jpegs[i], channels=channels), 0),
+                  size,
+                  half_pixel_centers=half_pixel_centers)[0] for i in range(2)
+          ])
+          images2 = gen_image_ops.decode_and_resize_jpeg_batch(
+              jpegs,
+              size,
+              channels=channels,
+              half_pixel_centers=half_pixel_centers)
+          self.assertAllEqual([2, 40, 30, channels],
+                              images2.get_shape().as_list())
+          images1, images2 = self.evaluate([images1, images2])
+          # nvjpeg's IDCT differs slightly from libjpeg's.
+          self.assertLess(np.abs(images1 - images2).mean(), 2.)
+
   def testSynthetic(self):
     with self.cached_session(use_gpu=True) as sess:
       # Encode it, then decode it, then encode it
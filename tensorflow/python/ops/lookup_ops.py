@@ -2268,6 +2268,264 @@ class DenseHashTable(LookupInterface):
                                                        restored_tensors[1])
 
 
+class HashEmbedding(LookupInterface):
+  """An embedding table keyed by integer ids with an unbounded vocabulary.
+
+  Rows are allocated on demand: an id gets a row once it has been looked up
+  `admission_threshold` times in training mode, and `evict` frees the rows of
+  ids that were looked up rarely since the previous eviction. Every row also
+  holds the optimizer slots of its embedding, so `apply_adagrad` and
+  `apply_ftrl` update embedding and slots in a single kernel.
+
+  Example usage:
+
+  ```python
+  table = HashEmbedding(dtypes.int64, embedding_dim=8, num_slots=1,
+                        slot_initial_values=[0.1])
+  with backprop.GradientTape() as tape:
+    embeddings = table.lookup(ids)
+    tape.watch(embeddings)
+    loss = model(embeddings)
+  grad = tape.gradient(loss, embeddings)
+  table.apply_adagrad(0.1, grad, ids)
+  ```
+  """
+
+  def __init__(self,
+               key_dtype,
+               embedding_dim,
+               value_dtype=dtypes.float32,
+               default_value=None,
+               slot_initial_values=(),
+               admission_threshold=1,
+               name="HashEmbedding",
+               checkpoint=True):
+    """Creates an empty `HashEmbedding` object.
+
+    Args:
+      key_dtype: the type of the ids, `int32` or `int64`.
+      embedding_dim: the size of each embedding.
+      value_dtype: the type of the embeddings, `float32` or `float64`.
+      default_value: The embedding of ids without a row and the initial value
+        of new rows. Defaults to zeros.
+      slot_initial_values: The initial value of each optimizer slot of a new
+        row. `apply_adagrad` needs one slot and `apply_ftrl` two.
+      admission_threshold: Number of lookups after which an id gets a row.
+      name: A name for the operation (optional).
+      checkpoint: if True, the contents of the table, including slots and
+        frequencies, are saved to and restored from checkpoints.
+
+    Returns:
+      A `HashEmbedding` object.
+    """
+    if default_value is None:
+      default_value = array_ops.zeros([embedding_dim], dtype=value_dtype)
+    self._default_value = ops.convert_to_tensor(
+        default_value, dtype=value_dtype)
+    self._embedding_dim = embedding_dim
+    self._slot_initial_values = list(slot_initial_values)
+    self._admission_threshold = admission_threshold
+    self._checkpoint = checkpoint
+    self._name = name
+
+    self._shared_name = None
+    if context.executing_eagerly():
+      self._shared_name = "table_%d" % (ops.uid(),)
+    super(HashEmbedding, self).__init__(key_dtype, value_dtype)
+
+    self._resource_handle = self._create_resource()
+    if checkpoint:
+      saveable = HashEmbedding._Saveable(self, name)
+      if not context.executing_eagerly():
+        ops.add_to_collection(ops.GraphKeys.SAVEABLE_OBJECTS, saveable)
+
+  def _create_resource(self):
+    use_node_name_sharing = self._checkpoint and self._shared_name is None
+    table_ref = gen_lookup_ops.hash_embedding_table(
+        shared_name=self._shared_name,
+        use_node_name_sharing=use_node_name_sharing,
+        key_dtype=self._key_dtype,
+        value_dtype=self._value_dtype,
+        embedding_dim=self._embedding_dim,
+        slot_initial_values=self._slot_initial_values,
+        admission_threshold=self._admission_threshold,
+        name=self._name)
+
+    if context.executing_eagerly():
+      self._table_name = None
+    else:
+      self._table_name = table_ref.op.name.split("/")[-1]
+    return table_ref
+
+  @property
+  def name(self):
+    return self._table_name
+
+  def size(self, name=None):
+    """Compute the number of rows in this table.
+
+    Args:
+      name: A name for the operation (optional).
+
+    Returns:
+      A scalar tensor containing the number of rows in this table.
+    """
+    with ops.name_scope(name, "%s_Size" % self.name, [self.resource_handle]):
+      with ops.colocate_with(self.resource_handle):
+        return gen_lookup_ops.lookup_table_size_v2(self.resource_handle)
+
+  def lookup(self, keys, training=True, name=None):
+    """Looks up the embeddings of `keys`.
+
+    Args:
+      keys: Ids to look up. Can be a tensor of any shape.
+      training: If True, the lookup counts towards the frequency of the ids
+        and admits new ids. Otherwise the table is not modified.
+      name: A name for the operation (optional).
+
+    Returns:
+      A tensor of shape `keys.shape + [embedding_dim]`.
+    """
+    with ops.name_scope(name, "%s_lookup" % self.name,
+                        (self.resource_handle, keys, self._default_value)):
+      keys = ops.convert_to_tensor(keys, dtype=self._key_dtype, name="keys")
+      with ops.colocate_with(self.resource_handle):
+        return gen_lookup_ops.hash_embedding_lookup(
+            self.resource_handle, keys, self._default_value,
+            count_frequency=training)
+
+  def _flatten_sparse_gradient(self, grad, indices):
+    grad = ops.convert_to_tensor(grad, dtype=self._value_dtype, name="grad")
+    indices = ops.convert_to_tensor(
+        indices, dtype=self._key_dtype, name="indices")
+    return (array_ops.reshape(grad, [-1, self._embedding_dim]),
+            array_ops.reshape(indices, [-1]))
+
+  def apply_adagrad(self, learning_rate, grad, indices, epsilon=1e-7,
+                    name=None):
+    """Applies an Adagrad update to the rows of `indices`.
+
+    The accumulator is slot 0 of the table.
+
+    Args:
+      learning_rate: A scalar learning rate.
+      grad: The gradient of the embeddings of `indices`, of shape
+        `indices.shape + [embedding_dim]`.
+      indices: The ids whose rows to update.
+      epsilon: A small constant for numerical stability.
+      name: A name for the operation (optional).
+
+    Returns:
+      The created Operation.
+    """
+    with ops.name_scope(name, "%s_apply_adagrad" % self.name,
+                        [self.resource_handle, grad, indices]):
+      grad, indices = self._flatten_sparse_gradient(grad, indices)
+      with ops.colocate_with(self.resource_handle):
+        return gen_lookup_ops.hash_embedding_sparse_apply_adagrad(
+            self.resource_handle,
+            math_ops.cast(learning_rate, self._value_dtype),
+            math_ops.cast(epsilon, self._value_dtype), grad, indices)
+
+  def apply_ftrl(self, learning_rate, grad, indices, learning_rate_power=-0.5,
+                 l1_regularization_strength=0.0,
+                 l2_regularization_strength=0.0, name=None):
+    """Applies an Ftrl-proximal update to the rows of `indices`.
+
+    The accumulator is slot 0 of the table and the linear term slot 1.
+
+    Args:
+      learning_rate: A scalar learning rate.
+      grad: The gradient of the embeddings of `indices`, of shape
+        `indices.shape + [embedding_dim]`.
+      indices: The ids whose rows to update.
+      learning_rate_power: A scalar that controls how the learning rate
+        decreases during training.
+      l1_regularization_strength: A scalar L1 regularization strength.
+      l2_regularization_strength: A scalar L2 regularization strength.
+      name: A name for the operation (optional).
+
+    Returns:
+      The created Operation.
+    """
+    with ops.name_scope(name, "%s_apply_ftrl" % self.name,
+                        [self.resource_handle, grad, indices]):
+      grad, indices = self._flatten_sparse_gradient(grad, indices)
+      with ops.colocate_with(self.resource_handle):
+        return gen_lookup_ops.hash_embedding_sparse_apply_ftrl(
+            self.resource_handle, grad, indices,
+            math_ops.cast(learning_rate, self._value_dtype),
+            math_ops.cast(l1_regularization_strength, self._value_dtype),
+            math_ops.cast(l2_regularization_strength, self._value_dtype),
+            math_ops.cast(learning_rate_power, self._value_dtype))
+
+  def evict(self, min_frequency, name=None):
+    """Frees the rows of ids looked up rarely since the previous eviction.
+
+    Args:
+      min_frequency: The minimum number of training lookups since the previous
+        eviction for a row to be kept.
+      name: A name for the operation (optional).
+
+    Returns:
+      A scalar tensor with the number of freed rows.
+    """
+    with ops.name_scope(name, "%s_evict" % self.name, [self.resource_handle]):
+      with ops.colocate_with(self.resource_handle):
+        return gen_lookup_ops.hash_embedding_evict(
+            self.resource_handle,
+            math_ops.cast(min_frequency, dtypes.int64))
+
+  def export(self, name=None):
+    """Returns the ids, embeddings, slots and frequencies of all rows.
+
+    Args:
+      name: A name for the operation (optional).
+
+    Returns:
+      A tuple of tensors `(keys, values, slots, frequencies)`.
+    """
+    with ops.name_scope(name, "%s_export" % self.name,
+                        [self.resource_handle]):
+      with ops.colocate_with(self.resource_handle):
+        return gen_lookup_ops.hash_embedding_export(
+            self.resource_handle, self._key_dtype, self._value_dtype)
+
+  def _gather_saveables_for_checkpoint(self):
+    """For object-based checkpointing."""
+    return {
+        "table":
+            functools.partial(
+                HashEmbedding._Saveable, table=self, name=self._name,
+                table_name=self._name)
+    }
+
+  class _Saveable(BaseSaverBuilder.SaveableObject):
+    """SaveableObject implementation for HashEmbedding."""
+
+    def __init__(self, table, name, table_name=None):
+      tensors = table.export()
+      specs = [
+          BaseSaverBuilder.SaveSpec(tensors[0], "", name + "-keys"),
+          BaseSaverBuilder.SaveSpec(tensors[1], "", name + "-values"),
+          BaseSaverBuilder.SaveSpec(tensors[2], "", name + "-slots"),
+          BaseSaverBuilder.SaveSpec(tensors[3], "", name + "-frequencies")
+      ]
+      self.table_name = table_name or name
+      # pylint: disable=protected-access
+      super(HashEmbedding._Saveable, self).__init__(table, specs, name)
+
+    def restore(self, restored_tensors, restored_shapes):
+      del restored_shapes  # unused
+      # pylint: disable=protected-access
+      with ops.name_scope("%s_table_restore" % self.table_name):
+        with ops.colocate_with(self.op.resource_handle):
+          return gen_lookup_ops.hash_embedding_import(self.op.resource_handle,
+                                                      *restored_tensors)
+
+
+ops.NotDifferentiable("HashEmbeddingLookup")
+ops.NotDifferentiable("HashEmbeddingExport")
 ops.NotDifferentiable("LookupTableFind")
 ops.NotDifferentiable("LookupTableFindV2")
 ops.NotDifferentiable("LookupTableInsert")
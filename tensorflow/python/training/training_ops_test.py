@@ -389,6 +389,52 @@ class TrainingOpsTest(TensorFlowTestCase):
       indices = np.array([0, 2]).astype(index_type)
       self._testTypesForSparseFtrlMultiplyLinearByLr(x, y, z, lr, grad, indices)
 
+  @test_util.run_v1_only("SparseApply ops return a ref, so they are not "
+                         "supported in eager mode.")
+  def testSparseApplyDeduplicateIndices(self):
+    for index_type in [np.int32, np.int64]:
+      x = np.array([np.arange(4), np.arange(4, 8), np.arange(8, 12)],
+                   dtype=np.float32)
+      y = np.ones((3, 4), dtype=np.float32)
+      z = np.zeros((3, 4), dtype=np.float32)
+      lr = np.array(0.5, dtype=np.float32)
+      grad = np.array([np.arange(4), np.full(4, 2.0), np.arange(4, 8)],
+                      dtype=np.float32)
+      indices = np.array([2, 0, 2]).astype(index_type)
+      # Summing the rows of duplicate indices gives the same update as the
+      # deduplicated op.
+      unique_grad = np.array([grad[1], grad[0] + grad[2]])
+      unique_indices = np.array([0, 2]).astype(index_type)
+
+      def apply_adagrad(grad, indices, **kwargs):
+        var = variables.VariableV1(x)
+        accum = variables.VariableV1(y)
+        self.evaluate(variables.global_variables_initializer())
+        self.evaluate(
+            training_ops.sparse_apply_adagrad(
+                var, accum, lr, grad,
+                constant_op.constant(indices, self._toType(index_type)),
+                **kwargs))
+        return self.evaluate([var, accum])
+
+      def apply_ftrl(grad, indices, **kwargs):
+        var = variables.VariableV1(x)
+        accum = variables.VariableV1(y)
+        linear = variables.VariableV1(z)
+        self.evaluate(variables.global_variables_initializer())
+        self.evaluate(
+            training_ops.sparse_apply_ftrl(
+                var, accum, linear, grad,
+                constant_op.constant(indices, self._toType(index_type)), lr,
+                0.1, 0.2, -0.5, **kwargs))
+        return self.evaluate([var, accum, linear])
+
+      with self.session(use_gpu=False):
+        for apply_fn in [apply_adagrad, apply_ftrl]:
+          self.assertAllClose(
+              apply_fn(unique_grad, unique_indices),
+              apply_fn(grad, indices, deduplicate_indices=True))
+
   @test_util.run_v1_only("ApplyAdam op returns a ref, so it is not "
                          "supported in eager mode.")
   def testApplyAdam(self):
@@ -116,6 +116,8 @@ enum class Epilogue {
   kReLU = 2,                      // Apply ReLU func point-wise to the results
   kBias = 4,                      // Add broadcasted bias vector to the results
   kBiasThenReLU = kBias | kReLU,  // Apply bias and then ReLU transform
+  kGELU = 32,                     // Apply GELU func point-wise to the results
+  kBiasThenGELU = kBias | kGELU,  // Apply bias and then GELU transform
 };
 
 // Converts a ComputationType to a string.
@@ -1470,11 +1472,11 @@ class BlasSupport {
   // Executes a blaslt matmul operation on the stream. If output_profile_result
   // is not nullptr, the operation is profiled, error messages are
   // suppressed, and output_profile_result->algorithm() is set to
-  // algorithm->index(). If epilogue was set to kBias or kBiasThenReLU when
-  // creating the plan, the bias argument here must refer to a valid device
-  // vector of length equal to the number of rows in matrix c. If epilogue was
-  // set to any other value then the bias argument here must be null. The bias
-  // vector is broadcast across the batch dimension.
+  // algorithm->index(). If epilogue was set to kBias, kBiasThenReLU or
+  // kBiasThenGELU when creating the plan, the bias argument here must refer to
+  // a valid device vector of length equal to the number of rows in matrix c.
+  // If epilogue was set to any other value then the bias argument here must be
+  // null. The bias vector is broadcast across the batch dimension.
   // Note that the data types of a and b (c and bias) must match the ab_type
   // (c_type) with which the plan was created, and the data types of alpha and
   // beta must match the data type of c.
@@ -470,7 +470,7 @@ cublasLtPointerMode_t CUBLASPointerMode(blas::PointerMode pointer_mode) {
       return CUBLASLT_POINTER_MODE_DEVICE;
   }
 }
-cublasLtEpilogue_t CUBLASEpilogue(blas::Epilogue epilogue) {
+port::StatusOr<cublasLtEpilogue_t> CUBLASEpilogue(blas::Epilogue epilogue) {
   switch (epilogue) {
     case blas::Epilogue::kDefault:
       return CUBLASLT_EPILOGUE_DEFAULT;
@@ -480,8 +480,23 @@ cublasLtEpilogue_t CUBLASEpilogue(blas::Epilogue epilogue) {
       return CUBLASLT_EPILOGUE_BIAS;
     case blas::Epilogue::kBiasThenReLU:
       return CUBLASLT_EPILOGUE_RELU_BIAS;
+#if CUDA_VERSION >= 11030
+    case blas::Epilogue::kGELU:
+      return CUBLASLT_EPILOGUE_GELU;
+    case blas::Epilogue::kBiasThenGELU:
+      return CUBLASLT_EPILOGUE_GELU_BIAS;
+#endif
+    default:
+      return port::Status(port::error::UNIMPLEMENTED,
+                          absl::StrCat("Unsupported cublasLt epilogue: ",
+                                       static_cast<int>(epilogue)));
   }
 }
+
+// Returns true if the epilogue reads a bias vector.
+bool EpilogueHasBias(blas::Epilogue epilogue) {
+  return static_cast<int>(epilogue) & static_cast<int>(blas::Epilogue::kBias);
+}
 #endif  // CUDA_VERSION >= 11000
 
 cudaDataType_t GetCUDADataType(blas::DataType ty) {
@@ -2358,6 +2373,25 @@ template <typename T>
 T inline GpuComplexValue(T v) {
   return v;
 }
+
+// Returns true and sets `stride` to the distance in elements between
+// consecutive matrices if the matrices in `ptrs` are evenly spaced in memory.
+template <typename T>
+bool GetUniformBatchStride(const std::vector<T *> &ptrs, int64 *stride) {
+  if (ptrs.size() < 2) return false;
+  const intptr_t step = reinterpret_cast<intptr_t>(ptrs[1]) -
+                        reinterpret_cast<intptr_t>(ptrs[0]);
+  if (step < 0 || step % sizeof(T) != 0) return false;
+  for (size_t i = 2; i < ptrs.size(); ++i) {
+    if (reinterpret_cast<intptr_t>(ptrs[i]) -
+            reinterpret_cast<intptr_t>(ptrs[i - 1]) !=
+        step) {
+      return false;
+    }
+  }
+  *stride = step / sizeof(T);
+  return true;
+}
 }  // namespace
 
 template <typename T, typename Scalar, typename FuncT>
@@ -2375,57 +2409,69 @@ port::Status CUDABlas::DoBlasGemmBatchedInternal(
     c_raw_ptrs.push_back(static_cast<T *>(c_ptrs_to_wrappers[i]->opaque()));
   }
 
+  // Evenly spaced matrices (including broadcast operands with a zero stride)
+  // don't need device-side pointer tables, so run them as a strided batch.
+  int64 stride_a, stride_b, stride_c;
+  if (GetUniformBatchStride(a_raw_ptrs, &stride_a) &&
+      GetUniformBatchStride(b_raw_ptrs, &stride_b) &&
+      GetUniformBatchStride(c_raw_ptrs, &stride_c) && stride_c != 0) {
+    if (DoBlasGemmStridedBatched(stream, transa, transb, m, n, k, alpha,
+                                 *a_ptrs_to_wrappers[0], lda, stride_a,
+                                 *b_ptrs_to_wrappers[0], ldb, stride_b, beta,
+                                 c_ptrs_to_wrappers[0], ldc, stride_c,
+                                 batch_count)) {
+      return port::Status::OK();
+    }
+    return port::Status(port::error::INTERNAL,
+                        "failed BLAS call, see log for details");
+  }
+
   typedef typename HalfAsFloat<typename GpuComplexT<T>::type>::type CUDA_T;
 
+  // Device-side copy of pointers to matrices. The a, b and c tables are packed
+  // into a single buffer so that they take one allocation and one copy.
   const size_t size = batch_count * sizeof(CUDA_T *);
-
-  // Device-side copy of pointers to matrices.
-  DeviceMemory<CUDA_T *> a;
-  DeviceMemory<CUDA_T *> b;
-  DeviceMemory<CUDA_T *> c;
-
-  // If temporary space is allocated for device-side copies of pointers to
-  // matrices, that temporary space should not be freed until this function
-  // returns. Although the values for these unique_ptrs are not set here, they
-  // are declared at this scope so they will be destroyed when the function
-  // returns.
+  std::vector<CUDA_T *> raw_ptrs;
+  raw_ptrs.reserve(3 * batch_count);
+  for (T *ptr : a_raw_ptrs) raw_ptrs.push_back(reinterpret_cast<CUDA_T *>(ptr));
+  for (T *ptr : b_raw_ptrs) raw_ptrs.push_back(reinterpret_cast<CUDA_T *>(ptr));
+  for (T *ptr : c_raw_ptrs) raw_ptrs.push_back(reinterpret_cast<CUDA_T *>(ptr));
+
+  DeviceMemory<CUDA_T *> ptr_tables;
+
+  // If temporary space is allocated for the device-side pointer tables, that
+  // temporary space should not be freed until this function returns. Although
+  // the value for this unique_ptr is not set here, it is declared at this
+  // scope so it will be destroyed when the function returns.
   //
-  // If a scratch allocator is provided, these pointers will not be used at all.
-  std::unique_ptr<TemporaryDeviceMemory<CUDA_T *>> a_temporary;
-  std::unique_ptr<TemporaryDeviceMemory<CUDA_T *>> b_temporary;
-  std::unique_ptr<TemporaryDeviceMemory<CUDA_T *>> c_temporary;
+  // If a scratch allocator is provided, this pointer will not be used at all.
+  std::unique_ptr<TemporaryDeviceMemory<CUDA_T *>> ptr_tables_temporary;
 
   // Decide how to allocate device-side copy of pointers to matrices based on
   // whether a scratch allocator was passed.
   if (scratch_allocator != nullptr) {
-    SE_ASSIGN_OR_RETURN(DeviceMemory<uint8> a_bytes,
-                        scratch_allocator->AllocateBytes(size));
-    SE_ASSIGN_OR_RETURN(DeviceMemory<uint8> b_bytes,
-                        scratch_allocator->AllocateBytes(size));
-    SE_ASSIGN_OR_RETURN(DeviceMemory<uint8> c_bytes,
-                        scratch_allocator->AllocateBytes(size));
-    a = DeviceMemory<CUDA_T *>(a_bytes);
-    b = DeviceMemory<CUDA_T *>(b_bytes);
-    c = DeviceMemory<CUDA_T *>(c_bytes);
+    SE_ASSIGN_OR_RETURN(DeviceMemory<uint8> ptr_tables_bytes,
+                        scratch_allocator->AllocateBytes(3 * size));
+    ptr_tables = DeviceMemory<CUDA_T *>(ptr_tables_bytes);
   } else {
-    SE_ASSIGN_OR_RETURN(a_temporary,
-                        stream->AllocateTemporaryArray<CUDA_T *>(batch_count));
-    SE_ASSIGN_OR_RETURN(b_temporary,
-                        stream->AllocateTemporaryArray<CUDA_T *>(batch_count));
-    SE_ASSIGN_OR_RETURN(c_temporary,
-                        stream->AllocateTemporaryArray<CUDA_T *>(batch_count));
-    a = DeviceMemory<CUDA_T *>(*a_temporary->mutable_device_memory());
-    b = DeviceMemory<CUDA_T *>(*b_temporary->mutable_device_memory());
-    c = DeviceMemory<CUDA_T *>(*c_temporary->mutable_device_memory());
-  }
-
-  if (!stream->ThenMemcpy(&a, a_raw_ptrs.data(), size).ok() ||
-      !stream->ThenMemcpy(&b, b_raw_ptrs.data(), size).ok() ||
-      !stream->ThenMemcpy(&c, c_raw_ptrs.data(), size).ok()) {
+    SE_ASSIGN_OR_RETURN(
+        ptr_tables_temporary,
+        stream->AllocateTemporaryArray<CUDA_T *>(3 * batch_count));
+    ptr_tables =
+        DeviceMemory<CUDA_T *>(*ptr_tables_temporary->mutable_device_memory());
+  }
+
+  if (!stream->ThenMemcpy(&ptr_tables, raw_ptrs.data(), 3 * size).ok()) {
     return port::Status(port::error::INTERNAL,
                         "failed to copy memory from host to device in "
                         "CUDABlas::DoBlasGemmBatched");
   }
+  CUDA_T **ptr_tables_base = GpuMemoryMutable(&ptr_tables);
+  auto a = DeviceMemory<CUDA_T *>::MakeFromByteSize(ptr_tables_base, size);
+  auto b = DeviceMemory<CUDA_T *>::MakeFromByteSize(
+      ptr_tables_base + batch_count, size);
+  auto c = DeviceMemory<CUDA_T *>::MakeFromByteSize(
+      ptr_tables_base + 2 * batch_count, size);
 
   cudaDataType_t data_type = CUDADataType<T>::type;
 
@@ -3194,8 +3240,10 @@ port::StatusOr<UniqueOpDesc> CreateCublasLtOperationDesc(
   UniqueOpDesc unique_desc(desc);
   SE_RETURN_IF_ERROR(SetCublasLtAttr(desc, CUBLASLT_MATMUL_DESC_POINTER_MODE,
                                      CUBLASPointerMode(pointer_mode)));
+  SE_ASSIGN_OR_RETURN(cublasLtEpilogue_t cublas_epilogue,
+                      CUBLASEpilogue(epilogue));
   SE_RETURN_IF_ERROR(SetCublasLtAttr(desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
-                                     CUBLASEpilogue(epilogue)));
+                                     cublas_epilogue));
   SE_RETURN_IF_ERROR(SetCublasLtAttr(desc, CUBLASLT_MATMUL_DESC_TRANSA,
                                      CUDABlasTranspose(transa)));
   SE_RETURN_IF_ERROR(SetCublasLtAttr(desc, CUBLASLT_MATMUL_DESC_TRANSB,
@@ -3552,9 +3600,7 @@ bool CUDABlas::DoBlasLtMatmulInternal(
                "pointer_mode for the given alpha/beta.";
     return false;
   }
-  if ((cuda_plan.params().epilogue == blas::Epilogue::kBias ||
-       cuda_plan.params().epilogue == blas::Epilogue::kBiasThenReLU) !=
-      (bias != nullptr)) {
+  if (EpilogueHasBias(cuda_plan.params().epilogue) != (bias != nullptr)) {
     VLOG(2) << "DoBlasLtMatmul returning false because plan has wrong "
                "epilogue for the given bias pointer.";
     return false;
@@ -398,6 +398,46 @@ class GpuDriver {
   // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__CTX.html#group__CUDA__CTX_1g7a54725f28d34b8c6299f0c6ca579616
   static bool SynchronizeContext(GpuContext* context);
 
+  // Stream capture and graphs were added to CUDA in 10.0
+#if CUDA_VERSION >= 10000
+
+  // Starts recording the work enqueued on stream into a graph instead of
+  // executing it, via cuStreamBeginCapture. Only the calling thread's use of
+  // the stream is captured.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__STREAM.html#group__CUDA__STREAM_1g767167da0bbf07157dc20b6c258a2143
+  static port::Status StreamBeginCapture(GpuContext* context,
+                                         GpuStreamHandle stream);
+
+  // Stops the capture started by StreamBeginCapture and returns the recorded
+  // graph via cuStreamEndCapture.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__STREAM.html#group__CUDA__STREAM_1g03dab8b2ba76b00718955177a929970c
+  static port::Status StreamEndCapture(GpuContext* context,
+                                       GpuStreamHandle stream,
+                                       GpuGraphHandle* graph);
+
+  // Creates an executable graph from graph via cuGraphInstantiate.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g433ae118a751c9f2087f53d7add7bc2c
+  static port::Status GraphInstantiate(GpuContext* context,
+                                       GpuGraphExecHandle* graph_exec,
+                                       GpuGraphHandle graph);
+
+  // Enqueues graph_exec onto stream via cuGraphLaunch.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g6b2dceb3901e71a390d2bd8b0491e471
+  static port::Status GraphLaunch(GpuContext* context,
+                                  GpuGraphExecHandle graph_exec,
+                                  GpuStreamHandle stream);
+
+  // Destroys graph via cuGraphDestroy.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g718cfd9681f078693d4be2426fd689c8
+  static void DestroyGraph(GpuContext* context, GpuGraphHandle graph);
+
+  // Destroys graph_exec via cuGraphExecDestroy.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1ga32ad4944cc5d408158207c978bc43a7
+  static void DestroyGraphExec(GpuContext* context,
+                               GpuGraphExecHandle graph_exec);
+
+#endif  // CUDA_VERSION >= 10000
+
   // Returns true if all stream tasks have completed at time of the call. Note
   // the potential for races around this call (if another thread adds work to
   // the stream immediately after this returns).
@@ -0,0 +1,80 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/stream_executor/gpu/gpu_graph.h"
+
+#include "absl/memory/memory.h"
+#include "tensorflow/stream_executor/gpu/gpu_stream.h"
+#include "tensorflow/stream_executor/lib/status_macros.h"
+#include "tensorflow/stream_executor/stream_executor_internal.h"
+#include "tensorflow/stream_executor/stream_executor_pimpl.h"
+
+namespace stream_executor {
+namespace gpu {
+
+#if GOOGLE_CUDA && CUDA_VERSION >= 10000
+
+GpuGraph::~GpuGraph() { GpuDriver::DestroyGraphExec(context_, graph_exec_); }
+
+/* static */ port::StatusOr<std::unique_ptr<GpuGraph>> GpuGraph::Capture(
+    Stream* stream, const std::function<port::Status()>& enqueue) {
+  auto* context = static_cast<GpuContext*>(
+      stream->parent()->implementation()->GpuContextHack());
+  GpuStreamHandle handle = AsGpuStreamValue(stream);
+  SE_RETURN_IF_ERROR(GpuDriver::StreamBeginCapture(context, handle));
+  port::Status enqueue_status = enqueue();
+  GpuGraphHandle graph = nullptr;
+  port::Status end_status =
+      GpuDriver::StreamEndCapture(context, handle, &graph);
+  if (enqueue_status.ok() && end_status.ok()) {
+    GpuGraphExecHandle graph_exec;
+    end_status = GpuDriver::GraphInstantiate(context, &graph_exec, graph);
+    GpuDriver::DestroyGraph(context, graph);
+    if (end_status.ok()) {
+      return absl::WrapUnique(new GpuGraph(context, graph_exec));
+    }
+    return end_status;
+  }
+  if (graph != nullptr) {
+    GpuDriver::DestroyGraph(context, graph);
+  }
+  SE_RETURN_IF_ERROR(enqueue_status);
+  return end_status;
+}
+
+port::Status GpuGraph::Launch(Stream* stream) const {
+  return GpuDriver::GraphLaunch(context_, graph_exec_,
+                                AsGpuStreamValue(stream));
+}
+
+#else  // GOOGLE_CUDA && CUDA_VERSION >= 10000
+
+GpuGraph::~GpuGraph() {}
+
+/* static */ port::StatusOr<std::unique_ptr<GpuGraph>> GpuGraph::Capture(
+    Stream* stream, const std::function<port::Status()>& enqueue) {
+  return port::UnimplementedError(
+      "GPU graphs are only supported with CUDA 10 and newer.");
+}
+
+port::Status GpuGraph::Launch(Stream* stream) const {
+  return port::UnimplementedError(
+      "GPU graphs are only supported with CUDA 10 and newer.");
+}
+
+#endif  // GOOGLE_CUDA && CUDA_VERSION >= 10000
+
+}  // namespace gpu
+}  // namespace stream_executor
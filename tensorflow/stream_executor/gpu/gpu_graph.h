@@ -0,0 +1,67 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Defines GpuGraph, a sequence of GPU work recorded once from a stream via
+// stream capture, which can then be launched repeatedly with a single call.
+
+#ifndef TENSORFLOW_STREAM_EXECUTOR_GPU_GPU_GRAPH_H_
+#define TENSORFLOW_STREAM_EXECUTOR_GPU_GPU_GRAPH_H_
+
+#include <functional>
+#include <memory>
+
+#include "tensorflow/stream_executor/gpu/gpu_driver.h"
+#include "tensorflow/stream_executor/gpu/gpu_types.h"
+#include "tensorflow/stream_executor/lib/status.h"
+#include "tensorflow/stream_executor/lib/statusor.h"
+#include "tensorflow/stream_executor/platform/port.h"
+#include "tensorflow/stream_executor/stream.h"
+
+namespace stream_executor {
+namespace gpu {
+
+// Wraps an executable CUDA graph. Only CUDA 10 and newer support graphs; on
+// other platforms Capture() returns an Unimplemented error.
+class GpuGraph {
+ public:
+  ~GpuGraph();
+
+  // Records the work that `enqueue` adds to `stream` into a graph, instead of
+  // executing it. All work enqueued onto `stream` until `enqueue` returns is
+  // recorded, whichever thread enqueues it. Calls that are illegal during
+  // capture, like synchronizing with the stream, fail when made from the
+  // calling thread.
+  static port::StatusOr<std::unique_ptr<GpuGraph>> Capture(
+      Stream* stream, const std::function<port::Status()>& enqueue);
+
+  // Enqueues the recorded work onto `stream`.
+  port::Status Launch(Stream* stream) const;
+
+ private:
+#if GOOGLE_CUDA && CUDA_VERSION >= 10000
+  GpuGraph(GpuContext* context, GpuGraphExecHandle graph_exec)
+      : context_(context), graph_exec_(graph_exec) {}
+
+  GpuContext* context_;
+  GpuGraphExecHandle graph_exec_;
+#endif  // GOOGLE_CUDA && CUDA_VERSION >= 10000
+
+  SE_DISALLOW_COPY_AND_ASSIGN(GpuGraph);
+};
+
+}  // namespace gpu
+}  // namespace stream_executor
+
+#endif  // TENSORFLOW_STREAM_EXECUTOR_GPU_GPU_GRAPH_H_
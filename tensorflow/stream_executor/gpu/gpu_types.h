@@ -77,6 +77,10 @@ using GpuSharedMemConfig = CUsharedconfig;
 using GpuComplexType = cuComplex;
 using GpuDoubleComplexType = cuDoubleComplex;
 using GpuRngHandle = curandGenerator_t;
+#if CUDA_VERSION >= 10000
+using GpuGraphHandle = CUgraph;
+using GpuGraphExecHandle = CUgraphExec;
+#endif
 
 #endif
 
@@ -105,6 +105,15 @@ port::StatusOr<void*> GetCurandDsoHandle() {
   return GetDsoHandle("curand", GetCurandVersion());
 }
 
+port::StatusOr<void*> GetNvjpegDsoHandle() {
+  // nvJPEG ships with the toolkit and is versioned by its major version only.
+  const string version = GetCudaVersion();
+  auto status_or_handle =
+      GetDsoHandle("nvjpeg", version.substr(0, version.find('.')));
+  if (status_or_handle.ok()) return status_or_handle;
+  return GetDsoHandle("nvjpeg", "");
+}
+
 port::StatusOr<void*> GetCuptiDsoHandle() {
   // Load specific version of CUPTI this is built.
   auto status_or_handle = GetDsoHandle("cupti", GetCudaVersion());
@@ -190,6 +199,11 @@ port::StatusOr<void*> GetCusparseDsoHandle() {
   return *result;
 }
 
+port::StatusOr<void*> GetNvjpegDsoHandle() {
+  static auto result = new auto(DsoLoader::GetNvjpegDsoHandle());
+  return *result;
+}
+
 port::StatusOr<void*> GetCuptiDsoHandle() {
   static auto result = new auto(DsoLoader::GetCuptiDsoHandle());
   return *result;